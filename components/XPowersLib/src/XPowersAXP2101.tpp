@@ -168,6 +168,15 @@ typedef enum {
     XPOWER_POWEROFF_SRC_UNKONW,                     //Unkonw
 } xpower_power_off_source_t;
 
+// ADC result block (0x34-0x3D) as readAdcBlock() returns it, raw
+typedef struct {
+    uint16_t batt_mv;
+    uint16_t ts_raw;
+    uint16_t vbus_mv;
+    uint16_t sys_mv;
+    uint16_t die_temp_raw;          // XPOWERS_AXP2101_CONVERSION() for degrees
+} xpowers_axp2101_adc_t;
+
 typedef enum {
     XPOWER_PWROK_DELAY_8MS,
     XPOWER_PWROK_DELAY_16MS,
@@ -243,9 +252,51 @@ public:
      */
     uint16_t status()
     {
-        uint16_t status1 = readRegister(XPOWERS_AXP2101_STATUS1) & 0x1F;
-        uint16_t status2 = readRegister(XPOWERS_AXP2101_STATUS2) & 0x1F;;
-        return (status1 << 8) | (status2);
+        uint8_t st[2];
+        if (!readStatusBlock(st)) {
+            return 0x1F1F;
+        }
+        return ((st[0] & 0x1F) << 8) | (st[1] & 0x1F);
+    }
+
+    /*
+     * Burst reads: STATUS1 / STATUS2 and the ADC result block in one
+     * transaction each, for callers that need several values at once
+     * (isVbusIn(), getBattVoltage() and the like cost one to four each)
+     */
+    bool readStatusBlock(uint8_t *st)
+    {
+        return readRegister(XPOWERS_AXP2101_STATUS1, st, 2) == 0;
+    }
+
+    bool readAdcBlock(xpowers_axp2101_adc_t *adc)
+    {
+        uint8_t raw[10];
+        if (readRegister(XPOWERS_AXP2101_ADC_DATA_RELUST0, raw, sizeof(raw)) != 0) {
+            return false;
+        }
+        adc->batt_mv = ((raw[0] & 0x1F) << 8) | raw[1];
+        adc->ts_raw = ((raw[2] & 0x3F) << 8) | raw[3];
+        adc->vbus_mv = ((raw[4] & 0x3F) << 8) | raw[5];
+        adc->sys_mv = ((raw[6] & 0x3F) << 8) | raw[7];
+        adc->die_temp_raw = ((raw[8] & 0x3F) << 8) | raw[9];
+        return true;
+    }
+
+    // Decoders for a readStatusBlock() result
+    static bool statusVbusIn(const uint8_t *st)
+    {
+        return (st[1] & _BV(3)) == 0 && (st[0] & _BV(5));
+    }
+
+    static bool statusBatteryConnect(const uint8_t *st)
+    {
+        return st[0] & _BV(3);
+    }
+
+    static bool statusCharging(const uint8_t *st)
+    {
+        return (st[1] >> 5) == 0x01;
     }
 
     bool isVbusGood(void)
@@ -306,7 +357,8 @@ public:
 
     bool isVbusIn(void)
     {
-        return getRegisterBit(XPOWERS_AXP2101_STATUS2, 3) == 0 && isVbusGood();
+        uint8_t st[2];
+        return readStatusBlock(st) && statusVbusIn(st);
     }
 
     xpowers_chg_status_t getChargerStatus(void)
@@ -2534,9 +2586,9 @@ public:
     */
     uint64_t getIrqStatus(void)
     {
-        statusRegister[0] = readRegister(XPOWERS_AXP2101_INTSTS1);
-        statusRegister[1] = readRegister(XPOWERS_AXP2101_INTSTS2);
-        statusRegister[2] = readRegister(XPOWERS_AXP2101_INTSTS3);
+        if (readRegister(XPOWERS_AXP2101_INTSTS1, statusRegister, XPOWERS_AXP2101_INTSTS_CNT) != 0) {
+            memset(statusRegister, 0, sizeof(statusRegister));
+        }
         return (uint32_t)(statusRegister[0] << 16) | (uint32_t)(statusRegister[1] << 8) | (uint32_t)(statusRegister[2]);
     }
 
@@ -2546,10 +2598,10 @@ public:
      */
     void clearIrqStatus()
     {
-        for (int i = 0; i < XPOWERS_AXP2101_INTSTS_CNT; i++) {
-            writeRegister(XPOWERS_AXP2101_INTSTS1 + i, 0xFF);
-            statusRegister[i] = 0;
-        }
+        uint8_t clear[XPOWERS_AXP2101_INTSTS_CNT];
+        memset(clear, 0xFF, sizeof(clear));
+        writeRegister(XPOWERS_AXP2101_INTSTS1, clear, XPOWERS_AXP2101_INTSTS_CNT);
+        memset(statusRegister, 0, sizeof(statusRegister));
     }
 
     /*
@@ -3020,6 +3072,18 @@ protected:
     {
         if (getChipID() == XPOWERS_AXP2101_CHIP_ID) {
             setChipModel(XPOWERS_AXP2101);
+            __burstRead = true;
+            // Configuration only the host writes; no self-clearing bits
+            setRegisterCacheable(XPOWERS_AXP2101_BATFET_CTRL, XPOWERS_AXP2101_INPUT_CUR_LIMIT_CTRL);
+            setRegisterCacheable(XPOWERS_AXP2101_LOW_BAT_WARN_SET, XPOWERS_AXP2101_LOW_BAT_WARN_SET);
+            setRegisterCacheable(XPOWERS_AXP2101_PWROFF_EN, XPOWERS_AXP2101_PWROK_SEQU_CTRL);
+            setRegisterCacheable(XPOWERS_AXP2101_IRQ_OFF_ON_LEVEL_CTRL, XPOWERS_AXP2101_FAST_PWRON_CTRL);
+            setRegisterCacheable(XPOWERS_AXP2101_ADC_CHANNEL_CTRL, XPOWERS_AXP2101_ADC_CHANNEL_CTRL);
+            setRegisterCacheable(XPOWERS_AXP2101_INTEN1, XPOWERS_AXP2101_INTEN3);
+            setRegisterCacheable(XPOWERS_AXP2101_TS_PIN_CTRL, XPOWERS_AXP2101_JIETA_SET2);
+            setRegisterCacheable(XPOWERS_AXP2101_IPRECHG_SET, XPOWERS_AXP2101_BTN_BAT_CHG_VOL_SET);
+            setRegisterCacheable(XPOWERS_AXP2101_DC_ONOFF_DVM_CTRL, XPOWERS_AXP2101_DC_VOL4_CTRL);
+            setRegisterCacheable(XPOWERS_AXP2101_LDO_ONOFF_CTRL0, XPOWERS_AXP2101_LDO_VOL8_CTRL);
             disableTSPinMeasure();      //Disable NTC temperature detection by default
             return true;
         }
@@ -40,6 +40,9 @@
 #include "esp_err.h"
 #include <cstring>
 #include "esp_idf_version.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #if (ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5,0,0)) && defined(CONFIG_XPOWERS_ESP_IDF_NEW_API)
 #include "driver/i2c_master.h"
 #else
@@ -54,6 +57,32 @@
 
 #define XPOWERSLIB_I2C_MASTER_SPEED            400000
 
+/*
+ * Register cache: single-register reads of the registers a chip marks
+ * cacheable (setRegisterCacheable) are answered from memory for up to
+ * XPOWERSLIB_REG_CACHE_TTL_MS after they were last read or written. Meant
+ * for configuration registers only the host changes; status, ADC and IRQ
+ * registers are never cached. Needs a millisecond clock (Arduino, ESP-IDF);
+ * elsewhere every read goes to the bus.
+ *
+ * On ESP-IDF a per-chip recursive mutex is held across each cache lookup or
+ * update and the bus transaction it belongs to, and across the
+ * read-modify-write bit helpers, so a read racing a write from another task
+ * cannot put a stale value back into the cache. On Arduino all access to
+ * one chip must come from one task.
+ */
+#ifndef XPOWERSLIB_REG_CACHE_TTL_MS
+#define XPOWERSLIB_REG_CACHE_TTL_MS            2000
+#endif
+#define XPOWERSLIB_REG_CACHE_SLOTS             16
+
+#if defined(ARDUINO)
+#define XPOWERSLIB_MILLIS()                    ((uint32_t)millis())
+#elif defined(ESP_PLATFORM)
+#define XPOWERSLIB_MILLIS()                    ((uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS))
+#define XPOWERSLIB_REG_LOCK
+#endif
+
 
 #ifdef _BV
 #undef _BV
@@ -141,6 +170,14 @@ class XPowersCommon
 
 public:
 
+    XPowersCommon()
+    {
+#ifdef XPOWERSLIB_REG_LOCK
+        // Static buffer: no heap, safe before the scheduler runs
+        __regLock = xSemaphoreCreateRecursiveMutexStatic(&__regLockBuf);
+#endif
+    }
+
 #if defined(ARDUINO)
     bool begin(TwoWire &w, uint8_t addr, int sda, int scl)
     {
@@ -282,13 +319,46 @@ public:
 
     int readRegister(uint8_t reg)
     {
+        RegLock lock(this);
+        int cached = cacheLookup(reg);
+        if (cached != -1) {
+            return cached;
+        }
         uint8_t val = 0;
-        return readRegister(reg, &val, 1) == -1 ? -1 : val;
+        if (readRegister(reg, &val, 1) == -1) {
+            return -1;
+        }
+        cacheStore(reg, val);
+        return val;
     }
 
     int writeRegister(uint8_t reg, uint8_t val)
     {
-        return writeRegister(reg, &val, 1);
+        RegLock lock(this);
+        int ret = writeRegister(reg, &val, 1);
+        if (ret == 0) {
+            cacheStore(reg, val);
+        }
+        return ret;
+    }
+
+    /*
+     * Register cache (see XPOWERSLIB_REG_CACHE_TTL_MS)
+     */
+    void setRegisterCacheable(uint8_t first, uint8_t last)
+    {
+        RegLock lock(this);
+        for (int reg = first; reg <= last; reg++) {
+            __cacheable[reg >> 3] |= (uint8_t)(1 << (reg & 7));
+        }
+    }
+
+    void invalidateRegisterCache()
+    {
+        RegLock lock(this);
+        for (int i = 0; i < XPOWERSLIB_REG_CACHE_SLOTS; i++) {
+            __cache[i].valid = false;
+        }
     }
 
     int readRegister(uint8_t reg, uint8_t *buf, uint8_t length)
@@ -335,6 +405,8 @@ public:
 
     int writeRegister(uint8_t reg, uint8_t *buf, uint8_t length)
     {
+        RegLock lock(this);
+        cacheForget(reg, length);
         if (thisWriteRegCallback) {
             return thisWriteRegCallback(__addr, reg, buf, length);
         }
@@ -382,6 +454,7 @@ public:
 
     bool inline clrRegisterBit(uint8_t registers, uint8_t bit)
     {
+        RegLock lock(this);
         int val = readRegister(registers);
         if (val == -1) {
             return false;
@@ -391,6 +464,7 @@ public:
 
     bool inline setRegisterBit(uint8_t registers, uint8_t bit)
     {
+        RegLock lock(this);
         int val = readRegister(registers);
         if (val == -1) {
             return false;
@@ -425,6 +499,10 @@ public:
 
     uint16_t inline readRegisterH6L8(uint8_t highReg, uint8_t lowReg)
     {
+        uint8_t pair[2];
+        if (readRegisterPair(highReg, lowReg, pair)) {
+            return ((pair[0] & 0x3F) << 8) | pair[1];
+        }
         int h6 = readRegister(highReg);
         int l8 = readRegister(lowReg);
         if (h6 == -1 || l8 == -1)return 0;
@@ -433,6 +511,10 @@ public:
 
     uint16_t inline readRegisterH5L8(uint8_t highReg, uint8_t lowReg)
     {
+        uint8_t pair[2];
+        if (readRegisterPair(highReg, lowReg, pair)) {
+            return ((pair[0] & 0x1F) << 8) | pair[1];
+        }
         int h5 = readRegister(highReg);
         int l8 = readRegister(lowReg);
         if (h5 == -1 || l8 == -1)return 0;
@@ -444,6 +526,97 @@ public:
      */
 protected:
 
+    /*
+     * Register lock (see XPOWERSLIB_REG_CACHE_TTL_MS): held for the scope,
+     * recursive so the single-register calls can nest in the bit helpers
+     */
+    struct RegLock {
+        explicit RegLock(XPowersCommon *c) : chip(c)
+        {
+#ifdef XPOWERSLIB_REG_LOCK
+            xSemaphoreTakeRecursive(chip->__regLock, portMAX_DELAY);
+#endif
+        }
+        ~RegLock()
+        {
+#ifdef XPOWERSLIB_REG_LOCK
+            xSemaphoreGiveRecursive(chip->__regLock);
+#endif
+        }
+        XPowersCommon *chip;
+    };
+
+    /*
+     * Both halves of a value in one transaction when the chip auto-increments
+     * (__burstRead) and they are adjacent; false to read them one by one
+     */
+    bool readRegisterPair(uint8_t highReg, uint8_t lowReg, uint8_t *pair)
+    {
+        if (!__burstRead || lowReg != highReg + 1) {
+            return false;
+        }
+        if (readRegister(highReg, pair, 2) == -1) {
+            pair[0] = pair[1] = 0;          // As the one-by-one path does on failure
+        }
+        return true;
+    }
+
+    int cacheLookup(uint8_t reg)
+    {
+#ifdef XPOWERSLIB_MILLIS
+        if (!(__cacheable[reg >> 3] & (1 << (reg & 7)))) {
+            return -1;
+        }
+        uint32_t now = XPOWERSLIB_MILLIS();
+        for (int i = 0; i < XPOWERSLIB_REG_CACHE_SLOTS; i++) {
+            if (__cache[i].valid && __cache[i].reg == reg) {
+                if (now - __cache[i].stamp < XPOWERSLIB_REG_CACHE_TTL_MS) {
+                    return __cache[i].val;
+                }
+                __cache[i].valid = false;
+                return -1;
+            }
+        }
+#endif
+        return -1;
+    }
+
+    void cacheStore(uint8_t reg, uint8_t val)
+    {
+#ifdef XPOWERSLIB_MILLIS
+        if (!(__cacheable[reg >> 3] & (1 << (reg & 7)))) {
+            return;
+        }
+        int slot = -1;
+        for (int i = 0; i < XPOWERSLIB_REG_CACHE_SLOTS; i++) {
+            if (__cache[i].valid && __cache[i].reg == reg) {
+                slot = i;
+                break;
+            }
+            if (slot == -1 && !__cache[i].valid) {
+                slot = i;
+            }
+        }
+        if (slot == -1) {
+            slot = __cacheNext;             // Full: replace round robin
+            __cacheNext = (__cacheNext + 1) % XPOWERSLIB_REG_CACHE_SLOTS;
+        }
+        __cache[slot].reg = reg;
+        __cache[slot].val = val;
+        __cache[slot].stamp = XPOWERSLIB_MILLIS();
+        __cache[slot].valid = true;
+#endif
+    }
+
+    void cacheForget(uint8_t reg, uint8_t length)
+    {
+        for (int i = 0; i < XPOWERSLIB_REG_CACHE_SLOTS; i++) {
+            if (__cache[i].valid && __cache[i].reg >= reg && __cache[i].reg < reg + length) {
+                __cache[i].valid = false;
+            }
+        }
+    }
+
     bool begin()
     {
 #if defined(ARDUINO)
@@ -516,4 +689,17 @@ protected:
     uint8_t     __addr                  = 0xFF;
     iic_fptr_t  thisReadRegCallback     = NULL;
     iic_fptr_t  thisWriteRegCallback    = NULL;
+    bool        __burstRead             = false;    // Multi-byte reads auto-increment
+    uint8_t     __cacheable[32]         = {0};      // One bit per register
+    struct {
+        uint32_t    stamp;
+        uint8_t     reg;
+        uint8_t     val;
+        bool        valid;
+    }           __cache[XPOWERSLIB_REG_CACHE_SLOTS] = {};
+    uint8_t     __cacheNext             = 0;
+#ifdef XPOWERSLIB_REG_LOCK
+    SemaphoreHandle_t   __regLock       = NULL;     // Cache and the transactions it covers
+    StaticSemaphore_t   __regLockBuf;
+#endif
 };
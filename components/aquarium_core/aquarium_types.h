@@ -0,0 +1,100 @@
+#ifndef __AQUARIUM_TYPES_H__
+#define __AQUARIUM_TYPES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// AQUARIUM TYPES - WHAT THE LIBRARY TAKES IN AND HANDS BACK
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Tank parameters, mood results and forecasts, and due reminders. The task
+// coordinator's messages (messages.h) carry them between tasks as they
+// are; nothing here depends on the message bus.
+
+// Tanks looked after (state/tank_registry.h); every per-tank table is this big
+#ifndef CONFIG_GOLDIE_TANK_COUNT
+#define CONFIG_GOLDIE_TANK_COUNT 1
+#endif
+#define TANK_MAX  CONFIG_GOLDIE_TANK_COUNT
+
+// Aquarium parameters for mood calculation
+typedef struct {
+    float ammonia_ppm;
+    float nitrite_ppm;
+    float nitrate_ppm;
+    float ph_level;
+    uint32_t last_feed_time;
+    uint32_t last_clean_time;
+    uint32_t planned_feed_interval;
+    uint32_t planned_water_change_interval;
+    uint16_t activity_pm;      // Moving share of the camera view, permille (fish_activity.h)
+    bool has_activity;         // activity_pm is a reading (false: no camera, or lights off)
+    int64_t origin_us;         // esp_timer time of the edit behind it, 0 = none (ui_latency.h)
+} aquarium_params_t;
+
+// Mood calculation result
+typedef struct {
+    int ammonia_score;
+    int nitrite_score;
+    int nitrate_score;
+    int ph_score;
+    int feed_score;
+    int clean_score;
+    int activity_score;        // 0, or -1 while the fish barely moves (never positive)
+    int total_score;
+    uint8_t category;  // 0=HAPPY, 1=SAD, 2=ANGRY
+    uint8_t tank;      // Whose parameters were scored
+    int64_t origin_us; // Carried over from the aquarium_params_t that caused it, 0 = timed rescore
+} mood_result_t;
+
+// Predicted mood from parameter trends (logic_task, MSG_TOPIC_MOOD_FORECAST)
+#define MOOD_FORECAST_NONE  UINT32_MAX   // Not expected within the horizon
+
+typedef struct {
+    uint32_t to_sad_s;         // Seconds until SAD or worse (0 = already)
+    uint32_t to_angry_s;       // Seconds until ANGRY (0 = already)
+    uint8_t  category;         // Current category
+    uint8_t  sad_factor;       // mood_factor_t that tips it to SAD (0xFF = none)
+    uint8_t  angry_factor;     // mood_factor_t that tips it to ANGRY (0xFF = none)
+    uint8_t  samples;          // Parameter samples in the trend window
+    float    slope_per_day[4]; // Ammonia, nitrite, nitrate, pH trend (units/day)
+    uint8_t  drift_mask;       // Water factors drifting unusually, bit per mood_factor_t (mood_drift.h)
+    int8_t   drift_z[4];       // Newest sample's z-score per water factor
+    uint32_t timestamp;        // Seconds since boot the forecast was made
+} mood_forecast_t;
+
+// Scheduled reminder that came due (reminders, MSG_TOPIC_REMINDER)
+typedef enum {
+    REMINDER_FEED = 0,         // A feed of the daily schedule
+    REMINDER_WATER_CHANGE,     // Water change interval ran out
+    REMINDER_MED_DOSE,         // Next dose of a medication course
+    REMINDER_RETEST,           // Test the water after a course
+    REMINDER_KIND_COUNT
+} reminder_kind_t;
+
+#define REMINDER_NAME_LEN  36  // med_db product name
+
+typedef struct {
+    uint8_t  kind;             // reminder_kind_t
+    uint8_t  slot;             // Feed schedule entry / course
+    uint8_t  hour;             // Feed: scheduled local time
+    uint8_t  minute;
+    uint8_t  dose;             // Dose: this one (2 = the first reminded) ...
+    uint8_t  doses;            // ... of the course's doses
+    uint8_t  tank;             // Feed / water change: whose schedule
+    uint32_t due;              // Seconds since boot it was due
+    uint32_t late_s;           // How late it fired (0 = on time)
+    char     name[REMINDER_NAME_LEN];  // Product of the course, "" otherwise
+} reminder_event_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __AQUARIUM_TYPES_H__
@@ -0,0 +1,663 @@
+#include "frame_codec.h"
+#include "pixel_kernels.h"
+#include "pixel_blit.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "frame_codec";
+
+// LVGL v8 lv_img_header_t packed into 32 bits: cf:5, always_zero:3, reserved:2, w:11, h:11
+#define LVGL_BIN_HEADER_SIZE 4
+static bool is_lvgl_bin_header(const uint8_t *p, uint16_t width, uint16_t height) {
+    uint32_t h = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    uint32_t cf = h & 0x1F;
+    uint32_t always_zero = (h >> 5) & 0x07;
+    uint32_t w = (h >> 10) & 0x7FF;
+    uint32_t hh = (h >> 21) & 0x7FF;
+    return always_zero == 0 && cf != 0 && w == width && hh == height;
+}
+
+extern "C" size_t frame_codec_decode_rle16(const uint8_t *src, size_t src_len,
+                                           uint8_t *dst, size_t dst_len) {
+    return px_decode_rle<px_src::rgb565, px_order::keep>(src, src_len, NULL, (uint16_t *)dst, dst_len / 2) * 2;
+}
+
+extern "C" size_t frame_codec_decode_idx8(const uint8_t *src, size_t src_len, const uint16_t *lut,
+                                          uint8_t *dst, size_t dst_len) {
+    // Bands start on a row: 2-byte aligned
+    return px_decode_rle<px_src::index8, px_order::keep>(src, src_len, lut, (uint16_t *)dst, dst_len / 2) * 2;
+}
+
+extern "C" void frame_codec_swap_rgb565(uint8_t *buf, size_t len) {
+    pixel_swap16(buf, buf, len);
+}
+
+// dst = src with the bytes of every pixel swapped, one pass over dst
+static void copy_swapped(uint8_t *dst, const uint8_t *src, size_t len) {
+    pixel_swap16(dst, src, len);
+}
+
+static const frame_codec_accel_t *accel = NULL;
+
+extern "C" void frame_codec_set_accel(const frame_codec_accel_t *table) {
+    accel = table;
+}
+
+static bool io_ready(void) {
+    return accel != NULL && accel->io_ready != NULL && accel->io_ready();
+}
+
+static bool split_ready(void) {
+    return accel != NULL && accel->split_ready != NULL && accel->split_ready();
+}
+
+static esp_err_t jpeg_load(FILE *f, const frame_container_header_t *hdr, uint8_t *dst, bool swap,
+                           uint16_t row_from, uint16_t row_to, frame_codec_info_t *info) {
+    if (accel == NULL || accel->jpeg_load == NULL) {
+        ESP_LOGE(TAG, "No JPEG decoder");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    return accel->jpeg_load(f, hdr, dst, swap, row_from, row_to, info);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// STREAMED LOADS (read-ahead hooks: chunk N+1 is read while chunk N is used)
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    uint8_t *dst;
+    size_t pos;
+    bool swap;
+} raw_stream_t;
+
+static bool raw_consume(void *ctx, const uint8_t *data, size_t len) {
+    raw_stream_t *s = (raw_stream_t *)ctx;
+    if (s->swap) {
+        copy_swapped(s->dst + s->pos, data, len);
+    } else {
+        memcpy(s->dst + s->pos, data, len);
+    }
+    s->pos += len;
+    return true;
+}
+
+/**
+ * @brief Decode band `band` (RLE16, or RLE8 through lut) into its rows of dst
+ */
+static bool decode_band(const frame_container_header_t *hdr, const uint16_t *lut, uint16_t band,
+                        const uint8_t *src, size_t len, uint8_t *dst, bool swap) {
+    size_t row_bytes = (size_t)hdr->width * 2;
+    size_t row = (size_t)band * hdr->band_rows;
+    size_t rows = hdr->band_rows;
+    if (row >= hdr->height) {
+        ESP_LOGE(TAG, "Band %u starts past row %u", band, hdr->height);
+        return false;
+    }
+    if (row + rows > hdr->height) {
+        rows = hdr->height - row;
+    }
+    size_t want = rows * row_bytes;
+    uint8_t *out = dst + row * row_bytes;
+    // The swap happens as the pixels are written (pixel_blit.h); an
+    // INDEXED8 palette is already in output order
+    size_t got;
+    if (lut != NULL) {
+        got = frame_codec_decode_idx8(src, len, lut, out, want);
+    } else if (swap) {
+        got = px_decode_rle<px_src::rgb565, px_order::swap>(src, len, NULL, (uint16_t *)out, want / 2) * 2;
+    } else {
+        got = frame_codec_decode_rle16(src, len, out, want);
+    }
+    if (got != want) {
+        ESP_LOGE(TAG, "Band %u decode failed", band);
+        return false;
+    }
+    return true;
+}
+
+static bool bands_valid(const frame_container_header_t *hdr, const uint32_t *offsets) {
+    for (uint16_t band = 0; band < hdr->band_count; band++) {
+        if (offsets[band + 1] < offsets[band] || offsets[band + 1] - offsets[band] > hdr->max_band_bytes) {
+            return false;
+        }
+    }
+    return true;
+}
+
+typedef struct {
+    const frame_container_header_t *hdr;
+    const uint32_t *offsets;
+    const uint16_t *lut;         // INDEXED8 palette (output order), NULL = RLE16
+    uint8_t *dst;
+    uint8_t *stage;              // Bands that straddle two chunks
+    size_t filled;               // Bytes of the current band in stage
+    uint16_t band;
+    bool swap;
+} rle_stream_t;
+
+static bool rle_decode_band(rle_stream_t *s, const uint8_t *src, size_t len) {
+    if (!decode_band(s->hdr, s->lut, s->band, src, len, s->dst, s->swap)) {
+        return false;
+    }
+    s->band++;
+    return true;
+}
+
+static bool rle_consume(void *ctx, const uint8_t *data, size_t len) {
+    rle_stream_t *s = (rle_stream_t *)ctx;
+    while (len > 0 && s->band < s->hdr->band_count) {
+        size_t band_len = s->offsets[s->band + 1] - s->offsets[s->band];
+        if (s->filled == 0 && len >= band_len) {
+            // Whole band inside this chunk: decode it from the bounce buffer
+            if (!rle_decode_band(s, data, band_len)) {
+                return false;
+            }
+            data += band_len;
+            len -= band_len;
+            continue;
+        }
+        size_t take = band_len - s->filled;
+        if (take > len) {
+            take = len;
+        }
+        memcpy(s->stage + s->filled, data, take);
+        s->filled += take;
+        data += take;
+        len -= take;
+        if (s->filled == band_len) {
+            s->filled = 0;
+            if (!rle_decode_band(s, s->stage, band_len)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TWO-CORE LOADS (split hooks: odd bands decoded on the helper's core)
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    const frame_container_header_t *hdr;
+    const uint16_t *lut;
+    uint8_t *dst;
+    bool swap;
+} split_band_t;
+
+static bool split_band(void *ctx, uint16_t band, const uint8_t *src, size_t len) {
+    split_band_t *s = (split_band_t *)ctx;
+    return decode_band(s->hdr, s->lut, band, src, len, s->dst, s->swap);
+}
+
+typedef struct {
+    uint8_t *buf;
+    size_t pos;
+} split_stream_t;
+
+static bool split_consume(void *ctx, const uint8_t *data, size_t len) {
+    split_stream_t *s = (split_stream_t *)ctx;
+    memcpy(s->buf + s->pos, data, len);
+    s->pos += len;
+    return accel->split_feed(s->pos);
+}
+
+static esp_err_t check_container(const frame_container_header_t *hdr) {
+    if (hdr->version != FRAME_CONTAINER_VERSION) {
+        ESP_LOGE(TAG, "Unsupported container version %u", hdr->version);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (hdr->band_rows == 0 || hdr->band_count == 0 ||
+        hdr->band_count != ((uint32_t)hdr->height + hdr->band_rows - 1) / hdr->band_rows) {
+        ESP_LOGE(TAG, "Bad band layout: %u bands x %u rows", hdr->band_count, hdr->band_rows);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t load_container(FILE *f, const frame_container_header_t *hdr,
+                                uint8_t *dst, size_t frame_bytes, bool swap, frame_codec_info_t *info) {
+    esp_err_t checked = check_container(hdr);
+    if (checked != ESP_OK) {
+        return checked;
+    }
+
+    size_t table_len = ((size_t)hdr->band_count + 1) * sizeof(uint32_t);
+    bool indexed = hdr->encoding == FRAME_ENCODING_INDEXED8;
+    size_t lut_len = indexed ? FRAME_PALETTE_SIZE * sizeof(uint16_t) : 0;
+
+    // Palette (INDEXED8) and offset table share one allocation
+    uint32_t *offsets = (uint32_t *)malloc(lut_len + table_len);
+    if (offsets == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    uint16_t *lut = indexed ? (uint16_t *)(offsets + hdr->band_count + 1) : NULL;
+    if ((indexed && fread(lut, 1, lut_len, f) != lut_len) || fread(offsets, 1, table_len, f) != table_len) {
+        free(offsets);
+        return ESP_FAIL;
+    }
+
+    esp_err_t ret = ESP_OK;
+    size_t total = 0;
+
+    swap = swap && !(hdr->flags & FRAME_FLAG_NATIVE_ORDER);
+    bool swapped = false;
+    if (indexed && swap) {
+        // The palette goes out in panel order: no pass over the pixels
+        frame_codec_swap_rgb565((uint8_t *)lut, lut_len);
+        swap = false;
+        swapped = true;
+    }
+    bool rle = hdr->encoding == FRAME_ENCODING_RLE16 || indexed;
+
+    split_band_t split = { hdr, lut, dst, swap };
+    uint8_t *split_buf = NULL;
+    if (rle && split_ready() && bands_valid(hdr, offsets)) {
+        // Offsets from the start of the payload: band b ends at offsets[b + 1]
+        uint32_t base = offsets[0];
+        for (uint16_t band = 0; band <= hdr->band_count; band++) {
+            offsets[band] -= base;
+        }
+        split_buf = accel->split_begin(hdr->band_count, offsets + 1, split_band, &split);
+    }
+
+    if (hdr->encoding == FRAME_ENCODING_RAW && io_ready()) {
+        // Bands are stored back to back: stream the payload, swapping each
+        // chunk as it is copied out of the bounce buffer
+        raw_stream_t stream = { dst, 0, swap };
+        ret = accel->io_stream(f, frame_bytes, raw_consume, &stream);
+        total = stream.pos;
+        swapped = swap;
+    } else if (hdr->encoding == FRAME_ENCODING_RAW) {
+        // Bands are stored back to back, read the whole payload in one go
+        total = fread(dst, 1, frame_bytes, f);
+        if (total != frame_bytes) {
+            ret = ESP_FAIL;
+        }
+    } else if (split_buf != NULL) {
+        // The whole payload lands in PSRAM; this task decodes the even
+        // bands as they arrive, the helper the odd ones
+        size_t payload = offsets[hdr->band_count];
+        size_t got;
+        if (io_ready()) {
+            split_stream_t stream = { split_buf, 0 };
+            ret = accel->io_stream(f, payload, split_consume, &stream);
+            got = stream.pos;
+        } else {
+            got = fread(split_buf, 1, payload, f);
+            ret = got == payload ? ESP_OK : ESP_FAIL;
+            accel->split_feed(got);
+        }
+        esp_err_t decoded = accel->split_finish(got);
+        if (ret == ESP_OK) {
+            ret = decoded;
+        }
+        total = payload;
+        swapped = swapped || swap;
+    } else if (rle && io_ready()) {
+        if (!bands_valid(hdr, offsets)) {
+            ret = ESP_ERR_INVALID_RESPONSE;
+        }
+        // Bands are decoded straight from the bounce buffer; only those
+        // split across two chunks are copied to the stage first
+        uint8_t *stage = NULL;
+        if (ret == ESP_OK) {
+            stage = (uint8_t *)heap_caps_malloc(hdr->max_band_bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            if (stage == NULL) {
+                ret = ESP_ERR_NO_MEM;
+            }
+        }
+        if (ret == ESP_OK) {
+            size_t payload = offsets[hdr->band_count] - offsets[0];
+            rle_stream_t stream = { hdr, offsets, lut, dst, stage, 0, 0, swap };
+            ret = accel->io_stream(f, payload, rle_consume, &stream);
+            if (ret == ESP_OK && stream.band != hdr->band_count) {
+                ret = ESP_ERR_INVALID_RESPONSE;
+            }
+            total = payload;
+            swapped = swapped || swap;
+        }
+        heap_caps_free(stage);
+    } else if (rle) {
+        // Staging buffer in internal RAM: one encoded band at a time
+        uint8_t *stage = (uint8_t *)heap_caps_malloc(hdr->max_band_bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (stage == NULL) {
+            stage = (uint8_t *)heap_caps_malloc(hdr->max_band_bytes, MALLOC_CAP_SPIRAM);
+        }
+        if (stage == NULL) {
+            free(offsets);
+            return ESP_ERR_NO_MEM;
+        }
+
+        for (uint16_t band = 0; band < hdr->band_count; band++) {
+            uint32_t len = offsets[band + 1] - offsets[band];
+            if (offsets[band + 1] < offsets[band] || len > hdr->max_band_bytes) {
+                ret = ESP_ERR_INVALID_RESPONSE;
+                break;
+            }
+            if (fread(stage, 1, len, f) != len) {
+                ret = ESP_FAIL;
+                break;
+            }
+            total += len;
+
+            if (!decode_band(hdr, lut, band, stage, len, dst, swap)) {
+                ret = ESP_ERR_INVALID_RESPONSE;
+                break;
+            }
+        }
+        heap_caps_free(stage);
+        swapped = swapped || swap;
+    } else {
+        ESP_LOGE(TAG, "Unknown encoding %u", hdr->encoding);
+        ret = ESP_ERR_NOT_SUPPORTED;
+    }
+
+    free(offsets);
+
+    if (ret == ESP_OK && swap && !swapped) {
+        frame_codec_swap_rgb565(dst, frame_bytes);
+    }
+    if (ret == ESP_OK && info != NULL) {
+        info->source = FRAME_SOURCE_CONTAINER;
+        info->encoding = hdr->encoding;
+        info->flags = hdr->flags;
+        info->bytes_read = total + lut_len;
+    }
+    return ret;
+}
+
+static size_t min_rows(size_t a, size_t b) {
+    return a < b ? a : b;
+}
+
+// Bands b0 .. b1-1 only, each read at its offset (no streaming)
+static esp_err_t load_container_bands(FILE *f, const frame_container_header_t *hdr, uint8_t *dst,
+                                      uint16_t b0, uint16_t b1, bool swap, frame_codec_info_t *info) {
+    esp_err_t ret = check_container(hdr);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    size_t row_bytes = (size_t)hdr->width * 2;
+    size_t table_len = ((size_t)hdr->band_count + 1) * sizeof(uint32_t);
+    bool indexed = hdr->encoding == FRAME_ENCODING_INDEXED8;
+    size_t lut_len = indexed ? FRAME_PALETTE_SIZE * sizeof(uint16_t) : 0;
+    long payload_start = (long)(sizeof(*hdr) + lut_len + table_len);
+
+    uint32_t *offsets = (uint32_t *)malloc(lut_len + table_len);
+    if (offsets == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    uint16_t *lut = indexed ? (uint16_t *)(offsets + hdr->band_count + 1) : NULL;
+    if ((indexed && fread(lut, 1, lut_len, f) != lut_len) || fread(offsets, 1, table_len, f) != table_len) {
+        free(offsets);
+        return ESP_FAIL;
+    }
+    swap = swap && !(hdr->flags & FRAME_FLAG_NATIVE_ORDER);
+    if (indexed && swap) {
+        frame_codec_swap_rgb565((uint8_t *)lut, lut_len);
+        swap = false;
+    }
+
+    size_t total = 0;
+    size_t row0 = (size_t)b0 * hdr->band_rows;
+    size_t row1 = min_rows((size_t)b1 * hdr->band_rows, hdr->height);
+    if (hdr->encoding == FRAME_ENCODING_RAW) {
+        // Rows back to back: one seek, one read
+        uint8_t *out = dst + row0 * row_bytes;
+        size_t len = (row1 - row0) * row_bytes;
+        if (fseek(f, payload_start + (long)(row0 * row_bytes), SEEK_SET) != 0 || fread(out, 1, len, f) != len) {
+            ret = ESP_FAIL;
+        } else if (swap) {
+            frame_codec_swap_rgb565(out, len);
+        }
+        total = len;
+    } else if (hdr->encoding == FRAME_ENCODING_RLE16 || indexed) {
+        uint8_t *stage = (uint8_t *)heap_caps_malloc(hdr->max_band_bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (stage == NULL) {
+            stage = (uint8_t *)heap_caps_malloc(hdr->max_band_bytes, MALLOC_CAP_SPIRAM);
+        }
+        if (stage == NULL || !bands_valid(hdr, offsets)) {
+            ret = stage == NULL ? ESP_ERR_NO_MEM : ESP_ERR_INVALID_RESPONSE;
+        }
+        for (uint16_t band = b0; band < b1 && ret == ESP_OK; band++) {
+            uint32_t len = offsets[band + 1] - offsets[band];
+            if (fseek(f, payload_start + (long)(offsets[band] - offsets[0]), SEEK_SET) != 0 ||
+                fread(stage, 1, len, f) != len) {
+                ret = ESP_FAIL;
+            } else if (!decode_band(hdr, lut, band, stage, len, dst, swap)) {
+                ret = ESP_ERR_INVALID_RESPONSE;
+            }
+            total += len;
+        }
+        heap_caps_free(stage);
+    } else {
+        ESP_LOGE(TAG, "Unknown encoding %u", hdr->encoding);
+        ret = ESP_ERR_NOT_SUPPORTED;
+    }
+    free(offsets);
+
+    if (ret == ESP_OK && info != NULL) {
+        info->source = FRAME_SOURCE_CONTAINER;
+        info->encoding = hdr->encoding;
+        info->flags = hdr->flags;
+        info->bytes_read = total + lut_len;
+    }
+    return ret;
+}
+
+extern "C" esp_err_t frame_codec_load_rows(FILE *f, uint8_t *dst, size_t dst_size,
+                                           uint16_t width, uint16_t height, bool swap,
+                                           uint16_t *row_from, uint16_t *row_to,
+                                           frame_codec_info_t *info) {
+    size_t row_bytes = (size_t)width * 2;
+    if (f == NULL || dst == NULL || dst_size < row_bytes * height ||
+        *row_from >= *row_to || *row_to > height) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    frame_container_header_t hdr;
+    size_t got = fread(&hdr, 1, sizeof(hdr), f);
+    if (got < LVGL_BIN_HEADER_SIZE) {
+        return ESP_FAIL;
+    }
+
+    if (got == sizeof(hdr) && hdr.magic == FRAME_CONTAINER_MAGIC) {
+        if (hdr.encoding == FRAME_ENCODING_DELTA) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        if (hdr.width != width || hdr.height != height) {
+            ESP_LOGE(TAG, "Frame is %ux%u, expected %ux%u", hdr.width, hdr.height, width, height);
+            return ESP_ERR_INVALID_SIZE;
+        }
+        if (hdr.encoding == FRAME_ENCODING_JPEG) {
+            // Decoded to the exact rows: the range out is the range in
+            return jpeg_load(f, &hdr, dst, swap, *row_from, *row_to, info);
+        }
+        if (hdr.band_rows == 0) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        uint16_t b0 = *row_from / hdr.band_rows;
+        uint16_t b1 = (uint16_t)((*row_to + hdr.band_rows - 1) / hdr.band_rows);
+        if (b1 > hdr.band_count) {
+            b1 = hdr.band_count;
+        }
+        esp_err_t ret = load_container_bands(f, &hdr, dst, b0, b1, swap, info);
+        if (ret == ESP_OK) {
+            *row_from = (uint16_t)(b0 * hdr.band_rows);
+            *row_to = (uint16_t)min_rows((size_t)b1 * hdr.band_rows, height);
+        }
+        return ret;
+    }
+
+    // Legacy dumps are raw rows after an optional 4-byte header
+    size_t skip = is_lvgl_bin_header((const uint8_t *)&hdr, width, height) ? LVGL_BIN_HEADER_SIZE : 0;
+    uint8_t *out = dst + (size_t)*row_from * row_bytes;
+    size_t len = (size_t)(*row_to - *row_from) * row_bytes;
+    if (fseek(f, (long)(skip + (size_t)*row_from * row_bytes), SEEK_SET) != 0 || fread(out, 1, len, f) != len) {
+        ESP_LOGE(TAG, "Legacy frame rows %u-%u incomplete", *row_from, *row_to);
+        return ESP_FAIL;
+    }
+    if (swap) {
+        frame_codec_swap_rgb565(out, len);
+    }
+    if (info != NULL) {
+        info->source = skip ? FRAME_SOURCE_LVGL_BIN : FRAME_SOURCE_RAW;
+        info->encoding = FRAME_ENCODING_RAW;
+        info->flags = 0;
+        info->bytes_read = len;
+    }
+    return ESP_OK;
+}
+
+extern "C" bool frame_codec_peek(FILE *f, frame_container_header_t *hdr) {
+    size_t got = fread(hdr, 1, sizeof(*hdr), f);
+    fseek(f, 0, SEEK_SET);
+    return got == sizeof(*hdr) && hdr->magic == FRAME_CONTAINER_MAGIC;
+}
+
+extern "C" esp_err_t frame_codec_apply_delta(FILE *f, uint8_t *dst, size_t dst_size,
+                                             uint16_t width, uint16_t height,
+                                             frame_dirty_t *dirty) {
+    frame_container_header_t hdr;
+    if (fread(&hdr, 1, sizeof(hdr), f) != sizeof(hdr) || hdr.magic != FRAME_CONTAINER_MAGIC ||
+        hdr.encoding != FRAME_ENCODING_DELTA) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (hdr.width != width || hdr.height != height || dst_size < (size_t)width * height * 2) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (hdr.band_count > FRAME_MAX_DIRTY_RECTS) {
+        ESP_LOGE(TAG, "Delta has %u rects (max %d)", hdr.band_count, FRAME_MAX_DIRTY_RECTS);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    frame_delta_rect_t rects[FRAME_MAX_DIRTY_RECTS];
+    size_t table_len = (size_t)hdr.band_count * sizeof(frame_delta_rect_t);
+    if (fread(rects, 1, table_len, f) != table_len) {
+        return ESP_FAIL;
+    }
+
+    size_t row_bytes = (size_t)width * 2;
+    size_t stage_len = hdr.max_band_bytes;
+    size_t max_rect_px = 0;
+    for (uint16_t i = 0; i < hdr.band_count; i++) {
+        const frame_delta_rect_t *r = &rects[i];
+        if ((uint32_t)r->x + r->w > width || (uint32_t)r->y + r->h > height || r->size > stage_len) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        if ((size_t)r->w * r->h > max_rect_px) {
+            max_rect_px = (size_t)r->w * r->h;
+        }
+    }
+
+    // Encoded bytes and the decoded rect share one allocation
+    uint8_t *stage = (uint8_t *)heap_caps_malloc(stage_len + max_rect_px * 2, MALLOC_CAP_SPIRAM);
+    if (stage == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    uint8_t *pixels = stage + stage_len;
+
+    esp_err_t ret = ESP_OK;
+    long payload_start = (long)(sizeof(hdr) + table_len);
+    for (uint16_t i = 0; i < hdr.band_count && ret == ESP_OK; i++) {
+        const frame_delta_rect_t *r = &rects[i];
+        size_t want = (size_t)r->w * r->h * 2;
+
+        if (fseek(f, payload_start + (long)r->offset, SEEK_SET) != 0 ||
+            fread(stage, 1, r->size, f) != r->size) {
+            ret = ESP_FAIL;
+        } else if (frame_codec_decode_rle16(stage, r->size, pixels, want) != want) {
+            ESP_LOGE(TAG, "Delta rect %u decode failed", i);
+            ret = ESP_ERR_INVALID_RESPONSE;
+        } else {
+            px_blit<0, px_order::keep>((uint16_t *)(dst + (size_t)r->y * row_bytes) + r->x, width,
+                                       (const uint16_t *)pixels, r->w, r->w, r->h);
+        }
+    }
+    heap_caps_free(stage);
+
+    if (ret == ESP_OK && dirty != NULL) {
+        dirty->full = false;
+        dirty->base_frame = hdr.base_frame;
+        dirty->count = (uint8_t)hdr.band_count;
+        for (uint16_t i = 0; i < hdr.band_count; i++) {
+            dirty->rects[i].x = rects[i].x;
+            dirty->rects[i].y = rects[i].y;
+            dirty->rects[i].w = rects[i].w;
+            dirty->rects[i].h = rects[i].h;
+        }
+    }
+    return ret;
+}
+
+extern "C" esp_err_t frame_codec_load(FILE *f, uint8_t *dst, size_t dst_size,
+                                      uint16_t width, uint16_t height, bool swap,
+                                      frame_codec_info_t *info) {
+    size_t frame_bytes = (size_t)width * height * 2;
+    if (f == NULL || dst == NULL || dst_size < frame_bytes) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    frame_container_header_t hdr;
+    size_t got = fread(&hdr, 1, sizeof(hdr), f);
+    if (got < LVGL_BIN_HEADER_SIZE) {
+        return ESP_FAIL;
+    }
+
+    if (got == sizeof(hdr) && hdr.magic == FRAME_CONTAINER_MAGIC) {
+        if (hdr.encoding == FRAME_ENCODING_DELTA) {
+            // Caller must resolve the base frame first (frame_codec_apply_delta)
+            return ESP_ERR_INVALID_STATE;
+        }
+        if (hdr.width != width || hdr.height != height) {
+            ESP_LOGE(TAG, "Frame is %ux%u, expected %ux%u", hdr.width, hdr.height, width, height);
+            return ESP_ERR_INVALID_SIZE;
+        }
+        if (hdr.encoding == FRAME_ENCODING_JPEG) {
+            return jpeg_load(f, &hdr, dst, swap, 0, height, info);
+        }
+        return load_container(f, &hdr, dst, frame_bytes, swap, info);
+    }
+
+    // Legacy path: the header bytes we just read are either an LVGL image
+    // header or already pixel data
+    const uint8_t *head = (const uint8_t *)&hdr;
+    frame_source_t source = FRAME_SOURCE_RAW;
+    size_t skip = 0;
+    if (is_lvgl_bin_header(head, width, height)) {
+        source = FRAME_SOURCE_LVGL_BIN;
+        skip = LVGL_BIN_HEADER_SIZE;
+    }
+
+    size_t carried = got - skip;
+    memcpy(dst, head + skip, carried);
+    size_t total;
+    if (io_ready()) {
+        raw_stream_t stream = { dst, carried, swap };
+        if (swap) {
+            frame_codec_swap_rgb565(dst, carried);
+        }
+        accel->io_stream(f, frame_bytes - carried, raw_consume, &stream);
+        total = stream.pos;
+    } else {
+        total = carried + fread(dst + carried, 1, frame_bytes - carried, f);
+        if (total == frame_bytes && swap) {
+            frame_codec_swap_rgb565(dst, frame_bytes);
+        }
+    }
+    if (total != frame_bytes) {
+        ESP_LOGE(TAG, "Legacy frame incomplete: got %zu bytes, expected %zu", total, frame_bytes);
+        return ESP_FAIL;
+    }
+
+    if (info != NULL) {
+        info->source = source;
+        info->encoding = FRAME_ENCODING_RAW;
+        info->flags = 0;
+        info->bytes_read = total;
+    }
+    return ESP_OK;
+}
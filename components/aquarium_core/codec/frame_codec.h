@@ -0,0 +1,242 @@
+#ifndef __FRAME_CODEC_H__
+#define __FRAME_CODEC_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// GFRM FRAME CONTAINER
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Layout (all fields little-endian):
+//   frame_container_header_t            32 bytes
+//   uint32_t band_offsets[band_count+1] offsets relative to payload start
+//   payload                             band_count encoded bands
+//
+// A band is `band_rows` full-width rows. Bands are encoded independently so
+// the decoder only needs a small staging buffer (max_band_bytes) and writes
+// pixels straight into the destination frame buffer.
+//
+// RLE16 packets (one control byte, count = (ctrl & 0x7F) + 1 pixels):
+//   ctrl & 0x80  -> run:     1 pixel follows, repeated `count` times
+//   otherwise    -> literal: `count` pixels follow
+//
+// INDEXED8 frames carry a uint16_t palette[FRAME_PALETTE_SIZE] (RGB565, in
+// panel order with FRAME_FLAG_NATIVE_ORDER) between the header and the
+// offset table; their bands are RLE8 - the RLE16 packets with one-byte
+// palette indices - expanded through the palette as they are decoded. The
+// encoder shares one palette across a mood's frames (tools/c_to_bin.py
+// --format indexed), so a frame is half the bytes of RGB565 before RLE and
+// the byte swap is 256 entries instead of every pixel.
+//
+// DELTA frames reuse the header with band_count = number of dirty rects and
+// base_frame = the frame the rects apply on top of. The offset table is
+// replaced by frame_delta_rect_t entries; each rect payload is RLE16 over
+// w*h pixels, row-major.
+//
+// JPEG frames are a single band holding a baseline JPEG (frame_jpeg.h,
+// through frame_codec_accel_t): a tenth of the RGB565 bytes, decoded an
+// MCU row at a time. Lossy, so they are keyframes only - no deltas are
+// taken against them.
+//
+// Timing: hold_ms is how long the frame stays on screen (0 = one period at
+// the animation frame rate) and FRAME_FLAG_LOOP_START marks the frame a
+// mood's loop returns to after its last frame; frames before it play once
+// when the mood is entered. Both apply to every encoding (anim_timeline.h).
+//
+// Files without the magic are treated as legacy dumps: either a 4-byte LVGL
+// image header followed by raw RGB565, or raw RGB565 only.
+
+#define FRAME_CONTAINER_MAGIC        0x4D524647u  // "GFRM"
+#define FRAME_CONTAINER_VERSION      1
+
+#define FRAME_ENCODING_RAW           0
+#define FRAME_ENCODING_RLE16         1
+#define FRAME_ENCODING_DELTA         2
+#define FRAME_ENCODING_INDEXED8      3
+#define FRAME_ENCODING_JPEG          4
+
+#define FRAME_PALETTE_SIZE           256
+
+#define FRAME_BASE_NONE              0xFFFF
+#define FRAME_MAX_DIRTY_RECTS        32
+
+// Header flags
+#define FRAME_FLAG_NATIVE_ORDER      0x0001  // Pixels already in panel byte order (LV_COLOR_16_SWAP)
+#define FRAME_FLAG_LOOP_START        0x0002  // The mood loops back to this frame
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint8_t  version;
+    uint8_t  encoding;         // FRAME_ENCODING_*
+    uint16_t flags;            // FRAME_FLAG_*
+    uint16_t width;
+    uint16_t height;
+    uint16_t band_rows;
+    uint16_t band_count;
+    uint32_t max_band_bytes;   // Largest encoded band, sizes the staging buffer
+    uint32_t payload_size;
+    uint16_t base_frame;       // DELTA only: 0-based frame index the rects patch
+    uint16_t hold_ms;          // Display time, 0 = default frame period
+    uint32_t reserved1;
+} frame_container_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t x, y, w, h;
+    uint32_t offset;           // Relative to payload start
+    uint32_t size;             // Encoded bytes
+} frame_delta_rect_t;
+
+typedef struct {
+    uint16_t x, y, w, h;
+} frame_rect_t;
+
+// Areas of a frame buffer that changed relative to the frame it was built on
+typedef struct {
+    bool full;                 // true = treat the whole frame as changed
+    uint16_t base_frame;       // Frame the rects are relative to (FRAME_BASE_NONE if full)
+    uint8_t count;
+    frame_rect_t rects[FRAME_MAX_DIRTY_RECTS];
+} frame_dirty_t;
+
+typedef enum {
+    FRAME_SOURCE_CONTAINER = 0,  // GFRM file
+    FRAME_SOURCE_LVGL_BIN,       // 4-byte LVGL header + raw pixels
+    FRAME_SOURCE_RAW,            // Raw pixels only
+} frame_source_t;
+
+typedef struct {
+    frame_source_t source;
+    uint8_t  encoding;
+    uint16_t flags;
+    size_t   bytes_read;         // Bytes pulled from the file (excluding header)
+} frame_codec_info_t;
+
+// ───────────────────────────────────────────────────────────────────────────
+// Load acceleration
+// ───────────────────────────────────────────────────────────────────────────
+//
+// The codec itself only reads and decodes on the calling task. The firmware
+// plugs in its read-ahead task, two-core band decode and JPEG decoder
+// (task_coordinator: codec/frame_io.h, frame_split.h, frame_jpeg.h) before
+// the first load; each ready() is asked per frame, so a stopped helper
+// falls back to the plain path. A NULL table or member is that path too,
+// except for JPEG frames, which then fail with ESP_ERR_NOT_SUPPORTED.
+
+typedef bool (*frame_codec_consume_cb_t)(void *ctx, const uint8_t *data, size_t len);
+typedef bool (*frame_codec_band_cb_t)(void *ctx, uint16_t band, const uint8_t *src, size_t len);
+
+typedef struct {
+    bool (*io_ready)(void);
+    esp_err_t (*io_stream)(FILE *f, size_t len, frame_codec_consume_cb_t cb, void *ctx);
+    bool (*split_ready)(void);
+    uint8_t *(*split_begin)(uint16_t band_count, const uint32_t *ends, frame_codec_band_cb_t cb, void *ctx);
+    bool (*split_feed)(size_t avail);
+    esp_err_t (*split_finish)(size_t avail);
+    esp_err_t (*jpeg_load)(FILE *f, const frame_container_header_t *hdr, uint8_t *dst, bool swap,
+                           uint16_t row_from, uint16_t row_to, frame_codec_info_t *info);
+} frame_codec_accel_t;
+
+/**
+ * @brief Install the load hooks (NULL = plain loads); the table is kept, not copied
+ */
+void frame_codec_set_accel(const frame_codec_accel_t *accel);
+
+/**
+ * @brief Load one frame from an open file into a full-frame pixel buffer
+ *
+ * Detects the file format and decodes band by band into `dst`. With
+ * the read-ahead hooks installed and running (frame_codec_set_accel), the
+ * file is streamed through bounce buffers so reading overlaps decoding and
+ * swapping; with the split hooks, RLE16 / INDEXED8 bands are shared with a
+ * helper, preferably on the other core. Without them it is plain fread()
+ * and one decode pass on the calling task.
+ *
+ * @param f        File opened in "rb" mode, positioned at offset 0
+ * @param dst      Destination buffer (width * height * 2 bytes)
+ * @param dst_size Size of dst in bytes
+ * @param width    Expected frame width
+ * @param height   Expected frame height
+ * @param swap     Byte-swap pixels into panel order unless the file carries
+ *                 FRAME_FLAG_NATIVE_ORDER; false = leave them as stored
+ * @param info     Optional, filled with format details on success
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE on dimension mismatch,
+ *         ESP_ERR_INVALID_STATE for DELTA frames (use frame_codec_apply_delta),
+ *         ESP_ERR_INVALID_RESPONSE on corrupt data, ESP_FAIL on read errors
+ */
+esp_err_t frame_codec_load(FILE *f, uint8_t *dst, size_t dst_size,
+                           uint16_t width, uint16_t height, bool swap,
+                           frame_codec_info_t *info);
+
+/**
+ * @brief Load only some rows of a frame (the part of it on screen)
+ *
+ * Like frame_codec_load(), but bands outside [*row_from, *row_to) are
+ * skipped with a seek instead of decoded. Always a plain read - no
+ * read-ahead or split decode; a band or two does not need them. The other
+ * rows of dst are left as they were.
+ *
+ * @param row_from In: first row wanted. Out: first row decoded
+ * @param row_to   In: row after the last wanted. Out: after the last decoded
+ *                 (whole bands, so the rows out cover the rows in)
+ * @return As frame_codec_load()
+ */
+esp_err_t frame_codec_load_rows(FILE *f, uint8_t *dst, size_t dst_size,
+                                uint16_t width, uint16_t height, bool swap,
+                                uint16_t *row_from, uint16_t *row_to,
+                                frame_codec_info_t *info);
+
+/**
+ * @brief Read the container header without consuming the file
+ *
+ * @return true if the file is a GFRM container (hdr filled, file rewound)
+ */
+bool frame_codec_peek(FILE *f, frame_container_header_t *hdr);
+
+/**
+ * @brief Apply a DELTA container on top of a buffer that holds its base frame
+ *
+ * @param f     File positioned at offset 0
+ * @param dst   Full-frame buffer that already contains hdr->base_frame
+ * @param dirty Filled with the rects that were rewritten
+ * @return ESP_OK, ESP_ERR_INVALID_ARG if the file is not a delta frame
+ */
+esp_err_t frame_codec_apply_delta(FILE *f, uint8_t *dst, size_t dst_size,
+                                  uint16_t width, uint16_t height,
+                                  frame_dirty_t *dirty);
+
+/**
+ * @brief Decode a single RLE16 band into dst
+ * @return Number of bytes written, or 0 if the band is malformed
+ */
+size_t frame_codec_decode_rle16(const uint8_t *src, size_t src_len,
+                                uint8_t *dst, size_t dst_len);
+
+/**
+ * @brief Decode a single RLE8 band of palette indices into RGB565 pixels
+ * @param lut FRAME_PALETTE_SIZE entries, already in the output byte order
+ * @return Number of bytes written to dst (2 per pixel), or 0 if the band is malformed
+ */
+size_t frame_codec_decode_idx8(const uint8_t *src, size_t src_len, const uint16_t *lut,
+                               uint8_t *dst, size_t dst_len);
+
+/**
+ * @brief Swap the two bytes of every RGB565 pixel in place
+ *
+ * pixel_swap16() (PIE on the S3); only needed for assets that do not carry
+ * FRAME_FLAG_NATIVE_ORDER.
+ */
+void frame_codec_swap_rgb565(uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,224 @@
+#include "gorilla.h"
+#include "esp_rom_crc.h"
+#include <string.h>
+#include <stddef.h>
+
+static_assert(sizeof(gorilla_block_t) == GORILLA_BLOCK_SIZE, "gorilla_block_t must be one sector");
+
+#define DATA_BYTES  sizeof(((gorilla_block_t *)0)->data)
+#define DATA_BITS   (DATA_BYTES * 8)
+#define NO_WINDOW   0xFF                // lead[]: no previous XOR window yet
+
+static inline uint32_t low_bits(uint32_t v, unsigned n)
+{
+    return n >= 32 ? v : v & ((1u << n) - 1);
+}
+
+/**
+ * @brief Write n (<= 32) bits MSB first into zeroed data
+ */
+static bool put(uint8_t *data, uint32_t *pos, uint32_t v, unsigned n)
+{
+    if (*pos + n > DATA_BITS) {
+        return false;
+    }
+    // Up to 32 bits at any bit offset span at most 5 bytes
+    uint64_t w = (uint64_t)low_bits(v, n) << (40 - (*pos & 7) - n);
+    uint32_t byte = *pos >> 3;
+    for (uint32_t i = 0; i < 5 && byte + i < DATA_BYTES; i++) {
+        data[byte + i] |= (uint8_t)(w >> (32 - 8 * i));
+    }
+    *pos += n;
+    return true;
+}
+
+static uint32_t get(const uint8_t *data, uint32_t *pos, unsigned n)
+{
+    uint32_t byte = *pos >> 3;
+    uint64_t w = 0;
+    for (uint32_t i = 0; i < 5; i++) {
+        w = (w << 8) | (byte + i < DATA_BYTES ? data[byte + i] : 0);
+    }
+    uint32_t v = low_bits((uint32_t)(w >> (40 - (*pos & 7) - n)), n);
+    *pos += n;
+    return v;
+}
+
+static inline uint32_t float_bits(float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    return v;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ENCODER
+// ═══════════════════════════════════════════════════════════════════════════
+
+static bool put_time(uint8_t *data, uint32_t *pos, int32_t dod)
+{
+    if (dod == 0) {
+        return put(data, pos, 0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+        return put(data, pos, 0x2, 2) && put(data, pos, (uint32_t)(dod + 63), 7);
+    } else if (dod >= -255 && dod <= 256) {
+        return put(data, pos, 0x6, 3) && put(data, pos, (uint32_t)(dod + 255), 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+        return put(data, pos, 0xE, 4) && put(data, pos, (uint32_t)(dod + 2047), 12);
+    }
+    return put(data, pos, 0xF, 4) && put(data, pos, (uint32_t)dod, 32);
+}
+
+static bool put_value(uint8_t *data, uint32_t *pos, gorilla_state_t *s, int i, uint32_t v)
+{
+    uint32_t x = v ^ s->v[i];
+    s->v[i] = v;
+    if (x == 0) {
+        return put(data, pos, 0, 1);
+    }
+    unsigned lead = (unsigned)__builtin_clz(x);
+    unsigned trail = (unsigned)__builtin_ctz(x);
+    if (s->lead[i] != NO_WINDOW && lead >= s->lead[i] && trail >= s->trail[i]) {
+        return put(data, pos, 0x2, 2) && put(data, pos, x >> s->trail[i], 32 - s->lead[i] - s->trail[i]);
+    }
+    unsigned len = 32 - lead - trail;
+    s->lead[i] = (uint8_t)lead;
+    s->trail[i] = (uint8_t)trail;
+    return put(data, pos, 0x3, 2) && put(data, pos, lead, 5) && put(data, pos, len - 1, 5) &&
+           put(data, pos, x >> trail, len);
+}
+
+extern "C" void gorilla_enc_init(gorilla_enc_t *e, gorilla_block_t *blk, uint8_t series)
+{
+    memset(blk, 0, sizeof(*blk));
+    blk->magic = GORILLA_MAGIC;
+    blk->series = series > GORILLA_MAX_SERIES ? GORILLA_MAX_SERIES : series;
+    e->blk = blk;
+    memset(&e->s, 0, sizeof(e->s));
+}
+
+extern "C" bool gorilla_enc_add(gorilla_enc_t *e, uint32_t t, const float *values)
+{
+    gorilla_block_t *b = e->blk;
+    if (b->count == UINT16_MAX) {
+        return false;
+    }
+    gorilla_state_t saved = e->s;
+    uint32_t pos = b->bits;
+    bool ok = true;
+    if (b->count == 0) {
+        b->t0 = t;
+        for (int i = 0; i < b->series; i++) {
+            e->s.v[i] = float_bits(values[i]);
+            e->s.lead[i] = NO_WINDOW;
+            ok = ok && put(b->data, &pos, e->s.v[i], 32);
+        }
+    } else {
+        int32_t delta = (int32_t)(t - e->s.t);
+        ok = put_time(b->data, &pos, (int32_t)((uint32_t)delta - (uint32_t)e->s.delta));
+        for (int i = 0; ok && i < b->series; i++) {
+            ok = put_value(b->data, &pos, &e->s, i, float_bits(values[i]));
+        }
+        e->s.delta = delta;
+    }
+    if (!ok) {
+        // Clear what was written of the sample: the block stays as it was
+        uint32_t byte = b->bits >> 3;
+        if (byte < DATA_BYTES) {
+            b->data[byte] &= (uint8_t)~(0xFFu >> (b->bits & 7));
+            memset(b->data + byte + 1, 0, DATA_BYTES - byte - 1);
+        }
+        e->s = saved;
+        return false;
+    }
+    e->s.t = t;
+    b->bits = (uint16_t)pos;
+    b->count++;
+    return true;
+}
+
+extern "C" void gorilla_block_finish(gorilla_block_t *blk, bool seal)
+{
+    if (seal) {
+        blk->flags |= GORILLA_SEALED;
+    }
+    blk->crc32 = esp_rom_crc32_le(0, (const uint8_t *)blk, offsetof(gorilla_block_t, crc32));
+}
+
+extern "C" bool gorilla_block_ok(const gorilla_block_t *blk)
+{
+    return blk->magic == GORILLA_MAGIC && blk->series >= 1 && blk->series <= GORILLA_MAX_SERIES &&
+           blk->bits <= DATA_BITS &&
+           blk->crc32 == esp_rom_crc32_le(0, (const uint8_t *)blk, offsetof(gorilla_block_t, crc32));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DECODER
+// ═══════════════════════════════════════════════════════════════════════════
+
+static int32_t get_time(const uint8_t *data, uint32_t *pos)
+{
+    if (get(data, pos, 1) == 0) {
+        return 0;
+    } else if (get(data, pos, 1) == 0) {
+        return (int32_t)get(data, pos, 7) - 63;
+    } else if (get(data, pos, 1) == 0) {
+        return (int32_t)get(data, pos, 9) - 255;
+    } else if (get(data, pos, 1) == 0) {
+        return (int32_t)get(data, pos, 12) - 2047;
+    }
+    return (int32_t)get(data, pos, 32);
+}
+
+static uint32_t get_value(const uint8_t *data, uint32_t *pos, gorilla_state_t *s, int i)
+{
+    if (get(data, pos, 1) == 0) {
+        return s->v[i];
+    }
+    if (get(data, pos, 1) == 0) {
+        unsigned len = 32 - s->lead[i] - s->trail[i];
+        s->v[i] ^= get(data, pos, len) << s->trail[i];
+        return s->v[i];
+    }
+    unsigned lead = get(data, pos, 5);
+    unsigned len = get(data, pos, 5) + 1;
+    unsigned trail = 32 - lead - len;
+    s->lead[i] = (uint8_t)lead;
+    s->trail[i] = (uint8_t)trail;
+    s->v[i] ^= (uint32_t)((uint64_t)get(data, pos, len) << trail);
+    return s->v[i];
+}
+
+extern "C" void gorilla_dec_init(gorilla_dec_t *d, const gorilla_block_t *blk)
+{
+    d->blk = blk;
+    memset(&d->s, 0, sizeof(d->s));
+    d->pos = 0;
+    d->left = blk->count;
+}
+
+extern "C" bool gorilla_dec_next(gorilla_dec_t *d, uint32_t *t, float *values)
+{
+    const gorilla_block_t *b = d->blk;
+    if (d->left == 0 || d->pos > b->bits) {
+        return false;
+    }
+    if (d->left == b->count) {
+        d->s.t = b->t0;
+        for (int i = 0; i < b->series; i++) {
+            d->s.v[i] = get(b->data, &d->pos, 32);
+        }
+    } else {
+        d->s.delta = (int32_t)((uint32_t)d->s.delta + (uint32_t)get_time(b->data, &d->pos));
+        d->s.t += (uint32_t)d->s.delta;
+        for (int i = 0; i < b->series; i++) {
+            get_value(b->data, &d->pos, &d->s, i);
+        }
+    }
+    d->left--;
+    *t = d->s.t;
+    for (int i = 0; i < b->series; i++) {
+        memcpy(&values[i], &d->s.v[i], sizeof(float));
+    }
+    return true;
+}
@@ -0,0 +1,114 @@
+#ifndef __GORILLA_H__
+#define __GORILLA_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// GORILLA TIME-SERIES BLOCKS
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// A block is one 512-byte sector holding samples of `series` float values
+// sharing a timestamp, as one bitstream (MSB first), the scheme of
+// Facebook's Gorilla TSDB with 32-bit floats:
+//
+// Timestamp: the first is t0 in the header; each one after it is coded as
+// the delta of its delta to the previous sample (0 before the second):
+//   '0'                 same spacing as before
+//   '10'   + 7 bits     -63..64
+//   '110'  + 9 bits     -255..256
+//   '1110' + 12 bits    -2047..2048
+//   '1111' + 32 bits    anything else
+//
+// Values: the first sample's are stored as is; after that each value is
+// XORed with the previous value of its series:
+//   '0'                 identical
+//   '10' + bits         the meaningful bits fit the previous window
+//                       (as many leading and trailing zeros or more)
+//   '11' + 5 bits leading zeros + 5 bits length - 1 + the meaningful bits
+//
+// A steady sensor at a fixed period costs ~1 bit of time and a few bits
+// per value instead of 4 + 4 * series bytes. The encoder never splits a
+// sample: a sample that does not fit leaves the block unchanged and the
+// caller starts the next one. Decoding streams sample by sample with a
+// few bytes of state, so a reader never holds more than one block.
+
+#define GORILLA_BLOCK_SIZE   512
+#define GORILLA_MAX_SERIES   4
+#define GORILLA_MAGIC        0x4C47    // "GL"
+#define GORILLA_SEALED       0x01      // flags: full, never written again
+
+typedef struct {
+    uint16_t magic;
+    uint8_t series;                     // Values per sample
+    uint8_t flags;
+    uint16_t count;                     // Samples in the block
+    uint16_t bits;                      // Bits of data[] used
+    uint32_t t0;                        // First timestamp
+    uint8_t data[GORILLA_BLOCK_SIZE - 16];
+    uint32_t crc32;                     // esp_rom_crc32_le over the fields above
+} gorilla_block_t;
+
+typedef struct {
+    uint32_t t;
+    int32_t delta;
+    uint32_t v[GORILLA_MAX_SERIES];
+    uint8_t lead[GORILLA_MAX_SERIES];
+    uint8_t trail[GORILLA_MAX_SERIES];
+} gorilla_state_t;
+
+typedef struct {
+    gorilla_block_t *blk;
+    gorilla_state_t s;
+} gorilla_enc_t;
+
+typedef struct {
+    const gorilla_block_t *blk;
+    gorilla_state_t s;
+    uint32_t pos;                       // Next bit
+    uint16_t left;                      // Samples not yet returned
+} gorilla_dec_t;
+
+/**
+ * @brief Start an empty block (zeroed) for samples of `series` values
+ */
+void gorilla_enc_init(gorilla_enc_t *e, gorilla_block_t *blk, uint8_t series);
+
+/**
+ * @brief Append a sample
+ * @return false if it does not fit: the block is unchanged, start the next
+ */
+bool gorilla_enc_add(gorilla_enc_t *e, uint32_t t, const float *values);
+
+/**
+ * @brief Fill in the CRC before the block is written (and set the seal)
+ */
+void gorilla_block_finish(gorilla_block_t *blk, bool seal);
+
+/**
+ * @brief Magic, series count, bit count and CRC are sane
+ */
+bool gorilla_block_ok(const gorilla_block_t *blk);
+
+/**
+ * @brief Decode a block from its first sample (the block must be ok)
+ */
+void gorilla_dec_init(gorilla_dec_t *d, const gorilla_block_t *blk);
+
+/**
+ * @brief Next sample
+ * @param values blk->series values
+ * @return false after the last one
+ */
+bool gorilla_dec_next(gorilla_dec_t *d, uint32_t *t, float *values);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __GORILLA_H__
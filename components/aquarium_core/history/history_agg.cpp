@@ -0,0 +1,297 @@
+#include "history_agg.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+static const char *TAG = "history_agg";
+
+#define MIN_LEAVES   64
+#define DAY_LEAVES   4096               // ~11 years
+#define MONTH_LEAVES 256                // ~21 years
+
+// One level: leaves cap..2*cap-1 are the buckets base..base+cap-1, node 1
+// the root, node n the aggregate of 2n and 2n+1
+typedef struct {
+    history_agg_t *node;                // PSRAM, 2 * cap
+    int32_t base;                       // Key of the first leaf
+    int32_t top;                        // Newest key added
+    int32_t floor;                      // Oldest key still complete (INT32_MIN until it slides)
+    uint32_t cap;                       // Leaves, a power of two
+    uint32_t max_cap;
+} tree_t;
+
+static tree_t trees[HISTORY_AGG_LEVELS];
+static SemaphoreHandle_t lock = NULL;
+
+static const char *const level_name[HISTORY_AGG_LEVELS] = { "hour", "day", "month" };
+
+static inline void agg_clear(history_agg_t *a)
+{
+    memset(a, 0, sizeof(*a));
+}
+
+static void agg_merge(history_agg_t *a, const history_agg_t *b)
+{
+    if (b->tests == 0) {
+        return;
+    }
+    for (int p = 0; p < HISTORY_STORE_PARAMS; p++) {
+        if (a->tests == 0 || b->min[p] < a->min[p]) a->min[p] = b->min[p];
+        if (a->tests == 0 || b->max[p] > a->max[p]) a->max[p] = b->max[p];
+        a->sum[p] += b->sum[p];
+    }
+    a->tests += b->tests;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SEGMENT TREES
+// ═══════════════════════════════════════════════════════════════════════════
+
+static inline void pull(tree_t *t, uint32_t n)
+{
+    t->node[n] = t->node[2 * n];
+    agg_merge(&t->node[n], &t->node[2 * n + 1]);
+}
+
+/**
+ * @brief Move a tree to cover base..base+cap-1, keeping the leaves that fit
+ */
+static bool reshape(tree_t *t, int32_t base, uint32_t cap)
+{
+    history_agg_t *node = (history_agg_t *)heap_caps_calloc(2 * cap, sizeof(history_agg_t), MALLOC_CAP_SPIRAM);
+    if (node == NULL) {
+        ESP_LOGE(TAG, "Out of PSRAM for %lu buckets", (unsigned long)cap);
+        return false;
+    }
+    for (uint32_t i = 0; t->node != NULL && i < t->cap; i++) {
+        int64_t at = (int64_t)t->base + i - base;
+        if (at >= 0 && at < (int64_t)cap) {
+            node[cap + at] = t->node[t->cap + i];
+        } else if (t->node[t->cap + i].tests > 0 && t->base + (int32_t)i < base) {
+            t->floor = base;            // Tests slid out
+        }
+    }
+    heap_caps_free(t->node);
+    t->node = node;
+    t->base = base;
+    t->cap = cap;
+    for (uint32_t n = cap - 1; n >= 1; n--) {
+        pull(t, n);
+    }
+    return true;
+}
+
+/**
+ * @brief Make room for a key: grow, or slide past the size limit
+ * @return false if the key is older than the window or out of memory
+ */
+static bool ensure(tree_t *t, int32_t key)
+{
+    if (t->node != NULL && key >= t->base && (int64_t)key - t->base < t->cap) {
+        return true;
+    }
+    if (key < t->floor) {
+        return false;
+    }
+    int64_t lo = key, hi = key;
+    if (t->node != NULL) {
+        lo = key < t->base ? key : t->base;
+        hi = key > t->top ? key : t->top;
+    }
+    uint32_t cap = t->cap ? t->cap : MIN_LEAVES;
+    while (cap < hi - lo + 1 && cap < t->max_cap) {
+        cap *= 2;
+    }
+    int64_t base = lo;
+    if (hi - lo + 1 > cap) {
+        // Full: keep the newest three quarters, room ahead for the rest
+        if (key <= hi - cap) {
+            return false;
+        }
+        base = hi - cap / 4 * 3 + 1;
+        if (key < base) {
+            base = key;
+        }
+    }
+    return reshape(t, (int32_t)base, cap);
+}
+
+static void add(tree_t *t, int32_t key, const history_agg_t *a)
+{
+    if (!ensure(t, key)) {
+        return;
+    }
+    if (t->node[1].tests == 0 || key > t->top) {
+        t->top = key;
+    }
+    uint32_t n = t->cap + (uint32_t)(key - t->base);
+    agg_merge(&t->node[n], a);
+    for (n /= 2; n >= 1; n /= 2) {
+        pull(t, n);
+    }
+}
+
+static void query(const tree_t *t, int32_t from, int32_t to, history_agg_t *out)
+{
+    agg_clear(out);
+    if (from < t->base) {
+        from = t->base;
+    }
+    if ((int64_t)to >= (int64_t)t->base + t->cap) {
+        to = t->base + (int32_t)t->cap - 1;
+    }
+    if (from > to) {
+        return;
+    }
+    // Bottom-up: the aggregate is order-free
+    uint32_t l = t->cap + (uint32_t)(from - t->base);
+    uint32_t r = t->cap + (uint32_t)(to - t->base) + 1;
+    for (; l < r; l /= 2, r /= 2) {
+        if (l & 1) agg_merge(out, &t->node[l++]);
+        if (r & 1) agg_merge(out, &t->node[--r]);
+    }
+}
+
+/**
+ * @brief Rightmost leaf <= to under node n (leaves lo..lo+width-1) above threshold
+ */
+static int64_t last_above(const tree_t *t, uint32_t n, uint32_t lo, uint32_t width, uint32_t to,
+                          int p, float threshold)
+{
+    const history_agg_t *a = &t->node[n];
+    if (lo > to || a->tests == 0 || !(a->max[p] > threshold)) {
+        return -1;
+    }
+    if (width == 1) {
+        return lo;
+    }
+    int64_t at = last_above(t, 2 * n + 1, lo + width / 2, width / 2, to, p, threshold);
+    return at >= 0 ? at : last_above(t, 2 * n, lo, width / 2, to, p, threshold);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// API
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void history_agg_init(void)
+{
+    if (lock != NULL) {
+        return;
+    }
+    lock = xSemaphoreCreateMutex();
+    uint32_t hours = CONFIG_GOLDIE_HISTORY_HOURLY_DAYS * 24 / 3 * 4;   // Slides keep 3/4
+    uint32_t cap = MIN_LEAVES;
+    while (cap < hours) {
+        cap *= 2;
+    }
+    const uint32_t max_cap[HISTORY_AGG_LEVELS] = { cap, DAY_LEAVES, MONTH_LEAVES };
+    for (int l = 0; l < HISTORY_AGG_LEVELS; l++) {
+        memset(&trees[l], 0, sizeof(trees[l]));
+        trees[l].floor = INT32_MIN;
+        trees[l].max_cap = max_cap[l];
+    }
+}
+
+extern "C" int32_t history_agg_key(history_agg_level_t level, time_t t)
+{
+    switch (level) {
+        case HISTORY_AGG_HOUR: return (int32_t)(t / 3600);
+        case HISTORY_AGG_DAY:  return history_day_of(t);
+        default:               return history_month_of(history_day_of(t));
+    }
+}
+
+extern "C" void history_agg_add_test(time_t timestamp, int32_t day, const float lo[HISTORY_STORE_PARAMS],
+                                     const float hi[HISTORY_STORE_PARAMS])
+{
+    if (lock == NULL) {
+        return;
+    }
+    history_agg_t a;
+    a.tests = 1;
+    for (int p = 0; p < HISTORY_STORE_PARAMS; p++) {
+        a.min[p] = lo[p];
+        a.max[p] = hi[p];
+        a.sum[p] = (lo[p] + hi[p]) * 0.5f;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    add(&trees[HISTORY_AGG_HOUR], (int32_t)(timestamp / 3600), &a);
+    add(&trees[HISTORY_AGG_DAY], day, &a);
+    add(&trees[HISTORY_AGG_MONTH], history_month_of(day), &a);
+    xSemaphoreGive(lock);
+}
+
+extern "C" void history_agg_add_rollup(const history_store_rollup_t *r)
+{
+    if (lock == NULL || r->count[HISTORY_PARAM] == 0) {
+        return;
+    }
+    history_agg_t a;
+    a.tests = r->count[HISTORY_PARAM];
+    for (int p = 0; p < HISTORY_STORE_PARAMS; p++) {
+        a.min[p] = r->min[p];
+        a.max[p] = r->max[p];
+        a.sum[p] = r->mean[p] * a.tests;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    add(&trees[HISTORY_AGG_DAY], r->day, &a);
+    add(&trees[HISTORY_AGG_MONTH], history_month_of(r->day), &a);
+    xSemaphoreGive(lock);
+}
+
+extern "C" bool history_agg_range(history_agg_level_t level, int32_t from, int32_t to, history_agg_t *out)
+{
+    agg_clear(out);
+    if (lock == NULL || level >= HISTORY_AGG_LEVELS) {
+        return false;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    const tree_t *t = &trees[level];
+    bool ok = t->node != NULL && from >= t->floor;
+    if (ok) {
+        query(t, from, to, out);
+    }
+    xSemaphoreGive(lock);
+    return ok;
+}
+
+extern "C" bool history_agg_last_above(history_agg_level_t level, int p, float threshold, int32_t to, int32_t *key)
+{
+    if (lock == NULL || level >= HISTORY_AGG_LEVELS || p < 0 || p >= HISTORY_STORE_PARAMS) {
+        return false;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    const tree_t *t = &trees[level];
+    int64_t at = -1;
+    if (t->node != NULL && to >= t->base) {
+        uint32_t last = (int64_t)to - t->base < t->cap ? (uint32_t)(to - t->base) : t->cap - 1;
+        at = last_above(t, 1, 0, t->cap, last, p, threshold);
+    }
+    if (at >= 0) {
+        *key = t->base + (int32_t)at;
+    }
+    xSemaphoreGive(lock);
+    return at >= 0;
+}
+
+extern "C" void history_agg_log_stats(void)
+{
+    if (lock == NULL) {
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (int l = 0; l < HISTORY_AGG_LEVELS; l++) {
+        const tree_t *t = &trees[l];
+        if (t->node == NULL) {
+            ESP_LOGI(TAG, "%-5s empty", level_name[l]);
+            continue;
+        }
+        ESP_LOGI(TAG, "%-5s %ld..%ld, %lu tests, %lu/%lu buckets (%u KB PSRAM)%s", level_name[l],
+                 (long)t->base, (long)t->top, (unsigned long)t->node[1].tests, (unsigned long)t->cap,
+                 (unsigned long)t->max_cap, (unsigned)(2 * t->cap * sizeof(history_agg_t) / 1024),
+                 t->floor != INT32_MIN ? ", slid" : "");
+    }
+    xSemaphoreGive(lock);
+}
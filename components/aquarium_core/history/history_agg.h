@@ -0,0 +1,101 @@
+#ifndef __HISTORY_AGG_H__
+#define __HISTORY_AGG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "history_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PARAMETER AGGREGATES - HOURLY / DAILY / MONTHLY RANGE INDEX
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Every water test in the store is also folded into three rollups of
+// min / max / sum / count per parameter (same order as the store's
+// rollups, pH as its low..high range):
+//
+//   hour    UTC hours since the epoch, the last
+//           CONFIG_GOLDIE_HISTORY_HOURLY_DAYS days (raw events only)
+//   day     local day numbers (history_event_t::day), raw and rolled up
+//   month   history_month_of() keys
+//
+// Each level is a segment tree in PSRAM over a contiguous range of keys
+// (leaves = buckets, every inner node the aggregate of its two halves),
+// so the aggregate of any range and the last bucket whose max is above a
+// threshold come back in O(log n), and adding a test is O(log n). A tree
+// doubles when the keys outgrow it; past its size limit it slides, and
+// the oldest quarter of its range drops out (queries before that return
+// false so the caller can read the SD store instead).
+//
+// Filled by history_store: daily rollups and raw events during its boot
+// pass, then every test as it is appended. Nothing is written to SD.
+// Queries from any task (one mutex, held for O(log n) work).
+
+#ifndef CONFIG_GOLDIE_HISTORY_HOURLY_DAYS
+#define CONFIG_GOLDIE_HISTORY_HOURLY_DAYS 31
+#endif
+
+typedef enum {
+    HISTORY_AGG_HOUR = 0,
+    HISTORY_AGG_DAY,
+    HISTORY_AGG_MONTH,
+    HISTORY_AGG_LEVELS
+} history_agg_level_t;
+
+typedef struct {
+    uint32_t tests;                     // Tests in the range, 0 = nothing below is set
+    float min[HISTORY_STORE_PARAMS];
+    float max[HISTORY_STORE_PARAMS];
+    float sum[HISTORY_STORE_PARAMS];    // Of each test's mid value: mean = sum / tests
+} history_agg_t;
+
+/**
+ * @brief Create the lock (history_store_init() calls it before loading)
+ */
+void history_agg_init(void);
+
+/**
+ * @brief Fold one parameter test into all three levels
+ * @param lo, hi Per parameter, equal except for the pH range
+ */
+void history_agg_add_test(time_t timestamp, int32_t day, const float lo[HISTORY_STORE_PARAMS],
+                          const float hi[HISTORY_STORE_PARAMS]);
+
+/**
+ * @brief Fold a compacted day (a daily.bin record) into the day and month levels
+ */
+void history_agg_add_rollup(const history_store_rollup_t *r);
+
+/**
+ * @brief Key of a time at a level (hour, local day or month)
+ */
+int32_t history_agg_key(history_agg_level_t level, time_t t);
+
+/**
+ * @brief Aggregate of the buckets from..to (keys, inclusive)
+ * @return false if the level is empty or from is older than it still
+ *         covers; true with out->tests == 0 if no test fell in the range
+ */
+bool history_agg_range(history_agg_level_t level, int32_t from, int32_t to, history_agg_t *out);
+
+/**
+ * @brief Last bucket at or before `to` in which param p went above threshold
+ *        ("days since ammonia was last nonzero": DAY, HISTORY_TREND_AMMONIA, 0)
+ * @return false if there is none in the range the level covers
+ */
+bool history_agg_last_above(history_agg_level_t level, int p, float threshold, int32_t to, int32_t *key);
+
+/**
+ * @brief Log each level's range and PSRAM use
+ */
+void history_agg_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,171 @@
+#include "history_index.h"
+#include <string.h>
+
+#define NO_EVENT 0xFF
+
+static_assert((HISTORY_BUCKETS & (HISTORY_BUCKETS - 1)) == 0, "HISTORY_BUCKETS must be a power of two");
+static_assert(HISTORY_DEPTH < NO_EVENT, "HISTORY_DEPTH too large for uint8_t links");
+
+typedef struct {
+    history_event_t event[HISTORY_DEPTH];
+    uint8_t bucket[HISTORY_BUCKETS];    // Newest event of each bucket
+    uint8_t head;                       // Next ring slot to write
+    uint8_t count;
+    bool bucket_init;
+} history_ring_t;
+
+static history_ring_t partitions[HISTORY_PARTITIONS][HISTORY_KIND_COUNT];
+static history_ring_t *rings = partitions[0];  // Rings of the selected partition
+static uint8_t selected = 0;
+
+static inline uint8_t bucket_of(int32_t day)
+{
+    return (uint8_t)((uint32_t)day & (HISTORY_BUCKETS - 1));
+}
+
+extern "C" int32_t history_civil_day(int year, int month, int mday)
+{
+    // Days from 1970-01-01 in the proleptic Gregorian calendar
+    year -= month <= 2;
+    int32_t era = (year >= 0 ? year : year - 399) / 400;
+    int32_t yoe = year - era * 400;
+    int32_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + mday - 1;
+    int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+extern "C" int32_t history_month_of(int32_t day)
+{
+    // Inverse of history_civil_day(), year and month only
+    int32_t z = day + 719468;
+    int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int32_t doe = z - era * 146097;
+    int32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int32_t mp = (5 * doy + 2) / 153;
+    int32_t month = mp < 10 ? mp + 3 : mp - 9;
+    int32_t year = yoe + era * 400 + (month <= 2);
+    return year * 12 + month - 1;
+}
+
+extern "C" int32_t history_day_of(time_t t)
+{
+    struct tm tm_buf;
+    localtime_r(&t, &tm_buf);
+    return history_civil_day(tm_buf.tm_year + 1900, tm_buf.tm_mon + 1, tm_buf.tm_mday);
+}
+
+extern "C" bool history_index_select(uint8_t partition)
+{
+    if (partition >= HISTORY_PARTITIONS) {
+        return false;
+    }
+    selected = partition;
+    rings = partitions[partition];
+    return true;
+}
+
+extern "C" uint8_t history_index_partition(void)
+{
+    return selected;
+}
+
+static void unlink_event(history_ring_t *r, uint8_t slot)
+{
+    uint8_t *link = &r->bucket[bucket_of(r->event[slot].day)];
+    while (*link != NO_EVENT) {
+        if (*link == slot) {
+            *link = r->event[slot].next;
+            return;
+        }
+        link = &r->event[*link].next;
+    }
+}
+
+extern "C" const history_event_t *history_index_add(history_kind_t kind, time_t timestamp,
+                                                    const float *values, size_t count)
+{
+    if (kind >= HISTORY_KIND_COUNT) {
+        return NULL;
+    }
+    history_ring_t *r = &rings[kind];
+    if (!r->bucket_init) {
+        memset(r->bucket, NO_EVENT, sizeof(r->bucket));
+        r->bucket_init = true;
+    }
+
+    uint8_t slot = r->head;
+    if (r->count == HISTORY_DEPTH) {
+        unlink_event(r, slot);
+    } else {
+        r->count++;
+    }
+    r->head = (uint8_t)((slot + 1) % HISTORY_DEPTH);
+
+    struct tm tm_buf;
+    localtime_r(&timestamp, &tm_buf);
+    history_event_t *ev = &r->event[slot];
+    memset(ev, 0, sizeof(*ev));
+    ev->timestamp = timestamp;
+    ev->day = history_civil_day(tm_buf.tm_year + 1900, tm_buf.tm_mon + 1, tm_buf.tm_mday);
+    ev->minute = (uint16_t)(tm_buf.tm_hour * 60 + tm_buf.tm_min);
+    ev->kind = (uint8_t)kind;
+    if (values != NULL) {
+        memcpy(ev->value, values, (count < HISTORY_VALUES ? count : HISTORY_VALUES) * sizeof(float));
+    }
+
+    // Newest first within the bucket
+    uint8_t *bucket = &r->bucket[bucket_of(ev->day)];
+    ev->next = *bucket;
+    *bucket = slot;
+    return ev;
+}
+
+static const history_event_t *scan(const history_ring_t *r, uint8_t slot, int32_t day)
+{
+    for (; slot != NO_EVENT; slot = r->event[slot].next) {
+        if (r->event[slot].day == day) {
+            return &r->event[slot];
+        }
+    }
+    return NULL;
+}
+
+extern "C" const history_event_t *history_first(history_kind_t kind, int32_t day)
+{
+    if (kind >= HISTORY_KIND_COUNT || !rings[kind].bucket_init) {
+        return NULL;
+    }
+    return scan(&rings[kind], rings[kind].bucket[bucket_of(day)], day);
+}
+
+extern "C" const history_event_t *history_next(const history_event_t *event)
+{
+    if (event == NULL || event->kind >= HISTORY_KIND_COUNT) {
+        return NULL;
+    }
+    return scan(&rings[event->kind], event->next, event->day);
+}
+
+extern "C" int history_count(history_kind_t kind, int32_t day)
+{
+    int n = 0;
+    for (const history_event_t *ev = history_first(kind, day); ev != NULL; ev = history_next(ev)) {
+        n++;
+    }
+    return n;
+}
+
+extern "C" const history_event_t *history_at(history_kind_t kind, size_t n)
+{
+    if (kind >= HISTORY_KIND_COUNT || n >= rings[kind].count) {
+        return NULL;
+    }
+    const history_ring_t *r = &rings[kind];
+    return &r->event[(r->head + HISTORY_DEPTH - 1 - n) % HISTORY_DEPTH];
+}
+
+extern "C" const history_event_t *history_latest(history_kind_t kind)
+{
+    return history_at(kind, 0);
+}
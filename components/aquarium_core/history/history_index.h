@@ -0,0 +1,134 @@
+#ifndef __HISTORY_INDEX_H__
+#define __HISTORY_INDEX_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <time.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ACTIVITY HISTORY INDEXED BY DAY
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Feed, water change and parameter events as they are logged, each kind in
+// a ring of the last HISTORY_DEPTH events (the same window as the dashboard
+// logs). On insert the local day number (days since 1970-01-01) and minute
+// of day are worked out once with localtime_r; the event is then linked
+// into a per-kind bucket chain keyed by day number.
+//
+// Calendar dots and the day history popup look a day up by number instead
+// of converting every logged timestamp for every day they draw: a lookup
+// walks only that day's bucket (days HISTORY_BUCKETS apart share one).
+//
+// Day numbers use the time zone in effect when the event was logged.
+//
+// Every tank has its own partition of rings (HISTORY_PARTITIONS, one per
+// CONFIG_GOLDIE_TANK_COUNT). history_index_select() only moves the pointer
+// every call below works on, so switching tanks costs nothing; the SD
+// store (history_store.h) follows partition 0, the first tank.
+// LVGL context only.
+
+#ifndef CONFIG_GOLDIE_TANK_COUNT
+#define CONFIG_GOLDIE_TANK_COUNT 1
+#endif
+
+#define HISTORY_DEPTH      7       // Events kept per kind
+#define HISTORY_BUCKETS    16      // Power of two, > HISTORY_DEPTH days
+#define HISTORY_VALUES     5
+#define HISTORY_PARTITIONS CONFIG_GOLDIE_TANK_COUNT
+
+typedef enum {
+    HISTORY_FEED = 0,
+    HISTORY_WATER,
+    HISTORY_PARAM,
+    HISTORY_KIND_COUNT
+} history_kind_t;
+
+// value[] of a HISTORY_PARAM event
+enum {
+    HISTORY_AMMONIA = 0,
+    HISTORY_NITRATE,
+    HISTORY_NITRITE,
+    HISTORY_LOW_PH,
+    HISTORY_HIGH_PH
+};
+
+typedef struct {
+    time_t timestamp;
+    int32_t day;                    // Local days since the epoch
+    uint16_t minute;                // Local minute of the day
+    uint8_t kind;                   // history_kind_t
+    uint8_t next;                   // Next event in the bucket (internal)
+    float value[HISTORY_VALUES];    // HISTORY_PARAM readings
+} history_event_t;
+
+/**
+ * @brief Local day number of a wall-clock time
+ */
+int32_t history_day_of(time_t t);
+
+/**
+ * @brief Day number of a calendar date (month 1-12, no time zone involved)
+ */
+int32_t history_civil_day(int year, int month, int mday);
+
+/**
+ * @brief Month of a day number: year * 12 + month - 1
+ */
+int32_t history_month_of(int32_t day);
+
+/**
+ * @brief Work on partition `partition` from now on (0 at boot)
+ * @return false if there is no such partition (the current one stays)
+ */
+bool history_index_select(uint8_t partition);
+
+/**
+ * @brief Partition in use
+ */
+uint8_t history_index_partition(void);
+
+/**
+ * @brief Record an event; the oldest one of its kind drops out when full
+ * @param values Up to HISTORY_VALUES values (NULL for none)
+ */
+const history_event_t *history_index_add(history_kind_t kind, time_t timestamp,
+                                         const float *values, size_t count);
+
+/**
+ * @brief Newest event of a day (NULL if none)
+ *
+ * Newest first, continue with history_next().
+ */
+const history_event_t *history_first(history_kind_t kind, int32_t day);
+
+/**
+ * @brief Next older event of the same kind and day (NULL at the end)
+ */
+const history_event_t *history_next(const history_event_t *event);
+
+/**
+ * @brief Events of one kind on a day
+ */
+int history_count(history_kind_t kind, int32_t day);
+
+/**
+ * @brief Most recently logged event of a kind (NULL if none yet)
+ */
+const history_event_t *history_latest(history_kind_t kind);
+
+/**
+ * @brief n-th newest event of a kind (0 = latest), NULL past the oldest
+ */
+const history_event_t *history_at(history_kind_t kind, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,765 @@
+#include "history_store.h"
+#include "history_trend.h"
+#include "history_agg.h"
+#include "io_sched.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_crc.h"
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <atomic>
+
+static const char *TAG = "history_store";
+
+// Files outlive firmware versions - pin the record layout
+static_assert(sizeof(history_store_event_t) == 32, "history_store_event_t must stay 32 bytes");
+static_assert(sizeof(history_store_rollup_t) == 64, "history_store_rollup_t must stay 64 bytes");
+
+// Day / month index: one entry per day with activity, sorted by day; each
+// month points at its first day entry and keeps the month's bitmaps
+typedef struct {
+    int32_t day;
+    uint8_t count[HISTORY_KIND_COUNT];
+    uint8_t mood;              // Worst category + 1, 0 = unknown
+} day_entry_t;
+
+typedef struct {
+    int32_t month;             // year * 12 + month - 1
+    uint32_t first;            // Index into days[]
+    history_month_t map;
+} month_entry_t;
+
+static char events_path[64];
+static char rollup_path[64];
+static char tmp_path[64];
+static io_sched_dev_t dev = IO_SCHED_SD;
+
+// Compaction records per maintenance slot (io_sched.h)
+#define COMPACT_SLICE  (IO_SCHED_SLICE_BYTES / sizeof(history_store_event_t))
+
+static day_entry_t *days = NULL;
+static size_t day_count = 0, day_cap = 0;
+static month_entry_t *months = NULL;
+static size_t month_count = 0, month_cap = 0;
+
+static bool ready = false;
+static int32_t rolled_through = INT32_MIN;   // Newest day in daily.bin
+static int32_t oldest_raw = INT32_MAX;       // Oldest day in events.bin
+
+// Export readers vs compaction (see history_store_reader_open)
+static std::atomic<int> readers(0);
+static std::atomic<bool> compacting(false);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DAY / MONTH INDEX
+// ═══════════════════════════════════════════════════════════════════════════
+
+static bool grow(void **buf, size_t *cap, size_t need, size_t elem)
+{
+    if (need <= *cap) {
+        return true;
+    }
+    size_t new_cap = *cap ? *cap * 2 : 64;
+    while (new_cap < need) {
+        new_cap *= 2;
+    }
+    void *p = heap_caps_realloc(*buf, new_cap * elem, MALLOC_CAP_SPIRAM);
+    if (p == NULL) {
+        ESP_LOGE(TAG, "Out of PSRAM for the history index (%zu entries)", new_cap);
+        return false;
+    }
+    *buf = p;
+    *cap = new_cap;
+    return true;
+}
+
+static bool push_month(int32_t month, uint32_t first)
+{
+    if (!grow((void **)&months, &month_cap, month_count + 1, sizeof(month_entry_t))) {
+        return false;
+    }
+    month_entry_t *m = &months[month_count++];
+    memset(m, 0, sizeof(*m));
+    memset(m->map.mood, HISTORY_MOOD_NONE, sizeof(m->map.mood));
+    m->month = month;
+    m->first = first;
+    return true;
+}
+
+static size_t find_month(int32_t month)
+{
+    size_t lo = 0, hi = month_count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (months[mid].month < month) lo = mid + 1; else hi = mid;
+    }
+    return (lo < month_count && months[lo].month == month) ? lo : month_count;
+}
+
+// Fold a day entry into its month's bitmaps
+static void mark(const day_entry_t *e)
+{
+    size_t mi = find_month(history_month_of(e->day));
+    if (mi == month_count) {
+        return;
+    }
+    history_month_t *map = &months[mi].map;
+    int32_t key = months[mi].month;
+    int bit = e->day - history_civil_day(key / 12, key % 12 + 1, 1);
+    uint32_t mask = 1u << bit;
+    if (e->count[HISTORY_FEED])  map->fed |= mask;
+    if (e->count[HISTORY_WATER]) map->water |= mask;
+    if (e->count[HISTORY_PARAM]) map->tested |= mask;
+    map->mood[bit] = e->mood ? (uint8_t)(e->mood - 1) : HISTORY_MOOD_NONE;
+}
+
+static void rebuild_months(void)
+{
+    month_count = 0;
+    for (size_t i = 0; i < day_count; i++) {
+        int32_t m = history_month_of(days[i].day);
+        if ((month_count == 0 || months[month_count - 1].month != m) && !push_month(m, (uint32_t)i)) {
+            return;
+        }
+    }
+    for (size_t i = 0; i < day_count; i++) {
+        mark(&days[i]);
+    }
+}
+
+// Entry of a day, created if needed (NULL when out of memory)
+static day_entry_t *entry_for(int32_t day)
+{
+    size_t pos = day_count;
+    if (day_count > 0 && day <= days[day_count - 1].day) {
+        size_t lo = 0, hi = day_count;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (days[mid].day < day) lo = mid + 1; else hi = mid;
+        }
+        if (days[lo].day == day) {
+            return &days[lo];
+        }
+        pos = lo;
+    }
+
+    if (!grow((void **)&days, &day_cap, day_count + 1, sizeof(day_entry_t))) {
+        return NULL;
+    }
+    if (pos < day_count) {
+        // Clock went backwards: rare, renumber the months
+        memmove(&days[pos + 1], &days[pos], (day_count - pos) * sizeof(day_entry_t));
+    }
+    memset(&days[pos], 0, sizeof(day_entry_t));
+    days[pos].day = day;
+    day_count++;
+
+    if (pos < day_count - 1) {
+        rebuild_months();
+    } else {
+        int32_t m = history_month_of(day);
+        if (month_count == 0 || months[month_count - 1].month != m) {
+            push_month(m, (uint32_t)pos);
+        }
+    }
+    return &days[pos];
+}
+
+static void add_count(day_entry_t *e, int kind, unsigned n)
+{
+    unsigned sum = e->count[kind] + n;
+    e->count[kind] = (uint8_t)(sum > UINT8_MAX ? UINT8_MAX : sum);
+}
+
+static void add_mood(day_entry_t *e, uint8_t stored)
+{
+    if (stored > e->mood) {
+        e->mood = stored;
+    }
+}
+
+extern "C" bool history_store_day_counts(int32_t day, uint8_t counts[HISTORY_KIND_COUNT])
+{
+    if (!ready || history_index_partition() != 0) {
+        return false;
+    }
+    memset(counts, 0, HISTORY_KIND_COUNT);
+
+    size_t mi = find_month(history_month_of(day));
+    if (mi == month_count) {
+        return true;
+    }
+    // At most 31 entries per month
+    for (size_t i = months[mi].first; i < day_count && days[i].day <= day; i++) {
+        if (days[i].day == day) {
+            memcpy(counts, days[i].count, HISTORY_KIND_COUNT);
+            break;
+        }
+    }
+    return true;
+}
+
+extern "C" int history_store_logged(history_kind_t kind, int32_t day)
+{
+    uint8_t counts[HISTORY_KIND_COUNT];
+    if (history_store_day_counts(day, counts)) {
+        return counts[kind];
+    }
+    return history_count(kind, day);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// RECORDS
+// ═══════════════════════════════════════════════════════════════════════════
+
+static inline uint16_t event_crc(const history_store_event_t *r)
+{
+    return esp_rom_crc16_le(0, (const uint8_t *)r, offsetof(history_store_event_t, crc16));
+}
+
+static inline uint32_t rollup_crc(const history_store_rollup_t *r)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)r, offsetof(history_store_rollup_t, crc32));
+}
+
+static inline bool event_ok(const history_store_event_t *r)
+{
+    return r->crc16 == event_crc(r) && (r->kind < HISTORY_KIND_COUNT || r->kind == HISTORY_STORE_KIND_MOOD);
+}
+
+// pH is logged as a low..high range
+static void param_range(const history_store_event_t *e, float lo[HISTORY_STORE_PARAMS], float hi[HISTORY_STORE_PARAMS])
+{
+    lo[0] = hi[0] = e->value[HISTORY_AMMONIA];
+    lo[1] = hi[1] = e->value[HISTORY_NITRATE];
+    lo[2] = hi[2] = e->value[HISTORY_NITRITE];
+    lo[3] = e->value[HISTORY_LOW_PH];
+    hi[3] = e->value[HISTORY_HIGH_PH];
+}
+
+static void agg_add(const history_store_event_t *e)
+{
+    float lo[HISTORY_STORE_PARAMS], hi[HISTORY_STORE_PARAMS];
+    param_range(e, lo, hi);
+    history_agg_add_test((time_t)e->timestamp, e->day, lo, hi);
+}
+
+typedef struct {
+    history_store_rollup_t r;
+    float sum[HISTORY_STORE_PARAMS];
+    uint16_t tests;
+    bool open;
+} rollup_acc_t;
+
+static void acc_add(rollup_acc_t *acc, const history_store_event_t *e)
+{
+    if (!acc->open) {
+        memset(acc, 0, sizeof(*acc));
+        acc->r.day = e->day;
+        acc->open = true;
+    }
+    if (e->kind == HISTORY_STORE_KIND_MOOD) {
+        uint8_t stored = (uint8_t)e->value[0] + 1;
+        if (stored > acc->r.mood) acc->r.mood = stored;
+        return;
+    }
+    acc->r.count[e->kind] = (uint8_t)(acc->r.count[e->kind] < UINT8_MAX ? acc->r.count[e->kind] + 1 : UINT8_MAX);
+    if (e->kind != HISTORY_PARAM) {
+        return;
+    }
+    float lo[HISTORY_STORE_PARAMS], hi[HISTORY_STORE_PARAMS];
+    param_range(e, lo, hi);
+    for (int p = 0; p < HISTORY_STORE_PARAMS; p++) {
+        if (acc->tests == 0 || lo[p] < acc->r.min[p]) acc->r.min[p] = lo[p];
+        if (acc->tests == 0 || hi[p] > acc->r.max[p]) acc->r.max[p] = hi[p];
+        acc->sum[p] += (lo[p] + hi[p]) * 0.5f;
+    }
+    acc->tests++;
+}
+
+static bool acc_flush(rollup_acc_t *acc, FILE *f)
+{
+    if (!acc->open) {
+        return true;
+    }
+    acc->open = false;
+    for (int p = 0; p < HISTORY_STORE_PARAMS && acc->tests > 0; p++) {
+        acc->r.mean[p] = acc->sum[p] / acc->tests;
+    }
+    acc->r.crc32 = rollup_crc(&acc->r);
+    if (acc->r.day > rolled_through) {
+        rolled_through = acc->r.day;
+    }
+    return fwrite(&acc->r, sizeof(acc->r), 1, f) == 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// COMPACTION
+// ═══════════════════════════════════════════════════════════════════════════
+
+static esp_err_t compact_files(int32_t today);
+
+/**
+ * @brief Compact unless an export reader has a file open (retried with
+ *        the next append)
+ */
+static esp_err_t compact(int32_t today)
+{
+    compacting = true;
+    if (readers > 0) {
+        compacting = false;
+        ESP_LOGI(TAG, "Compaction postponed - history export in progress");
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t err = compact_files(today);
+    compacting = false;
+    return err;
+}
+
+/**
+ * The pass is sliced: the card is handed on every COMPACT_SLICE records,
+ * so frame loads and log writes never wait for the whole file
+ */
+static esp_err_t compact_files(int32_t today)
+{
+    int32_t cutoff = today - HISTORY_STORE_RAW_DAYS;  // Older days roll up
+    io_sched_begin(dev, IO_SCHED_BACKGROUND, portMAX_DELAY);
+    FILE *in = fopen(events_path, "rb");
+    if (in == NULL) {
+        io_sched_end(dev, IO_SCHED_BACKGROUND);
+        return ESP_ERR_NOT_FOUND;
+    }
+    FILE *out = fopen(tmp_path, "wb");
+    FILE *roll = fopen(rollup_path, "ab");
+    if (out == NULL || roll == NULL) {
+        ESP_LOGE(TAG, "Compaction: cannot open output files (errno=%d)", errno);
+        fclose(in);
+        if (out) fclose(out);
+        if (roll) fclose(roll);
+        remove(tmp_path);
+        io_sched_end(dev, IO_SCHED_BACKGROUND);
+        return ESP_FAIL;
+    }
+
+    history_store_event_t rec;
+    rollup_acc_t acc = {};
+    uint32_t kept = 0, rolled = 0, dropped = 0;
+    int32_t new_oldest = INT32_MAX;
+    int32_t prior_rolled = rolled_through;    // acc_flush() advances rolled_through
+    bool ok = true;
+    uint32_t in_slice = 0;
+    while (ok && fread(&rec, sizeof(rec), 1, in) == 1) {
+        if (++in_slice == COMPACT_SLICE) {
+            in_slice = 0;
+            io_sched_end(dev, IO_SCHED_BACKGROUND);
+            io_sched_begin(dev, IO_SCHED_BACKGROUND, portMAX_DELAY);
+        }
+        if (!event_ok(&rec) || rec.day <= prior_rolled) {
+            dropped++;
+        } else if (rec.day >= cutoff) {
+            ok = fwrite(&rec, sizeof(rec), 1, out) == 1;
+            if (rec.day < new_oldest) new_oldest = rec.day;
+            kept++;
+        } else {
+            if (acc.open && acc.r.day != rec.day) {
+                ok = acc_flush(&acc, roll);
+            }
+            acc_add(&acc, &rec);
+            rolled++;
+        }
+    }
+    ok = ok && acc_flush(&acc, roll);
+    fclose(in);
+    ok = (fclose(roll) == 0) && ok;
+    ok = (fclose(out) == 0) && ok;
+    if (!ok) {
+        // Whatever rollups made it are authoritative for their days
+        ESP_LOGE(TAG, "Compaction write failed (errno=%d) - raw log left as is", errno);
+        remove(tmp_path);
+        io_sched_end(dev, IO_SCHED_BACKGROUND);
+        return ESP_FAIL;
+    }
+
+    // Rollups are durable: swap in the trimmed raw log
+    bool swapped = remove(events_path) == 0 && rename(tmp_path, events_path) == 0;
+    io_sched_end(dev, IO_SCHED_BACKGROUND);
+    if (!swapped) {
+        ESP_LOGE(TAG, "Compaction: cannot replace %s (errno=%d)", events_path, errno);
+        return ESP_FAIL;
+    }
+    oldest_raw = new_oldest;
+    ESP_LOGI(TAG, "Compacted: %lu events rolled up, %lu kept, %lu dropped",
+             (unsigned long)rolled, (unsigned long)kept, (unsigned long)dropped);
+    return ESP_OK;
+}
+
+static inline bool compaction_due(int32_t today)
+{
+    return oldest_raw != INT32_MAX &&
+           oldest_raw < today - HISTORY_STORE_RAW_DAYS - HISTORY_STORE_COMPACT_SLACK;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LOAD
+// ═══════════════════════════════════════════════════════════════════════════
+
+static bool load_rollups(void)
+{
+    FILE *f = fopen(rollup_path, "rb");
+    if (f == NULL) {
+        return errno == ENOENT;
+    }
+    history_store_rollup_t r;
+    uint32_t n = 0, bad = 0;
+    while (fread(&r, sizeof(r), 1, f) == 1) {
+        if (r.crc32 != rollup_crc(&r)) {
+            bad++;
+            continue;
+        }
+        day_entry_t *e = entry_for(r.day);
+        if (e == NULL) {
+            break;
+        }
+        for (int k = 0; k < HISTORY_KIND_COUNT; k++) {
+            add_count(e, k, r.count[k]);
+        }
+        add_mood(e, r.mood);
+        mark(e);
+        history_agg_add_rollup(&r);
+        if (r.day > rolled_through) {
+            rolled_through = r.day;
+        }
+        n++;
+    }
+    fclose(f);
+    if (n || bad) {
+        ESP_LOGI(TAG, "%lu daily rollups (%lu corrupt skipped)", (unsigned long)n, (unsigned long)bad);
+    }
+    return true;
+}
+
+static bool load_events(void)
+{
+    // A record cut short by a power loss is the only possible damage to an
+    // append-only file of fixed-size records
+    struct stat st;
+    if (stat(events_path, &st) == 0 && st.st_size % sizeof(history_store_event_t) != 0) {
+        off_t whole = st.st_size - st.st_size % sizeof(history_store_event_t);
+        ESP_LOGW(TAG, "Dropping a torn record at the end of %s", events_path);
+        if (truncate(events_path, whole) != 0) {
+            ESP_LOGE(TAG, "truncate failed (errno=%d) - store disabled", errno);
+            return false;
+        }
+    }
+
+    FILE *f = fopen(events_path, "rb");
+    if (f == NULL) {
+        return errno == ENOENT;
+    }
+
+    // Newest few of each kind go back into the in-RAM index
+    static history_store_event_t recent[HISTORY_KIND_COUNT][HISTORY_DEPTH];
+    uint32_t seen[HISTORY_KIND_COUNT] = {};
+    history_store_event_t rec;
+    uint32_t n = 0, bad = 0, stale = 0;
+    while (fread(&rec, sizeof(rec), 1, f) == 1) {
+        if (!event_ok(&rec)) {
+            bad++;
+            continue;
+        }
+        if (rec.day <= rolled_through) {
+            stale++;           // Already in a rollup (interrupted compaction)
+            continue;
+        }
+        day_entry_t *e = entry_for(rec.day);
+        if (e == NULL) {
+            break;
+        }
+        if (rec.day < oldest_raw) {
+            oldest_raw = rec.day;
+        }
+        n++;
+        if (rec.kind == HISTORY_STORE_KIND_MOOD) {
+            add_mood(e, (uint8_t)rec.value[0] + 1);
+            mark(e);
+            continue;
+        }
+        add_count(e, rec.kind, 1);
+        mark(e);
+        if (rec.kind == HISTORY_PARAM) {
+            agg_add(&rec);
+        }
+        recent[rec.kind][seen[rec.kind]++ % HISTORY_DEPTH] = rec;
+    }
+    fclose(f);
+
+    uint8_t partition = history_index_partition();
+    history_index_select(0);                    // The store is the first tank's
+    for (int k = 0; k < HISTORY_KIND_COUNT; k++) {
+        uint32_t first = seen[k] > HISTORY_DEPTH ? seen[k] - HISTORY_DEPTH : 0;
+        for (uint32_t i = first; i < seen[k]; i++) {
+            const history_store_event_t *r = &recent[k][i % HISTORY_DEPTH];
+            history_index_add((history_kind_t)k, (time_t)r->timestamp, r->value, HISTORY_VALUES);
+        }
+    }
+    history_index_select(partition);
+    ESP_LOGI(TAG, "%lu events loaded (%lu corrupt, %lu already rolled up)",
+             (unsigned long)n, (unsigned long)bad, (unsigned long)stale);
+    return true;
+}
+
+extern "C" esp_err_t history_store_init(const char *dir)
+{
+    if (ready) {
+        return ESP_OK;
+    }
+    snprintf(events_path, sizeof(events_path), "%s/events.bin", dir);
+    snprintf(rollup_path, sizeof(rollup_path), "%s/daily.bin", dir);
+    snprintf(tmp_path, sizeof(tmp_path), "%s/events.tmp", dir);
+    dev = io_sched_device_of(dir);
+
+    // Finish a compaction cut short between remove and rename; a leftover
+    // copy next to a live events.bin is incomplete
+    if (access(tmp_path, F_OK) == 0) {
+        if (access(events_path, F_OK) != 0) {
+            rename(tmp_path, events_path);
+        } else {
+            remove(tmp_path);
+        }
+    }
+
+    history_agg_init();
+    if (!load_rollups() || !load_events()) {
+        ESP_LOGE(TAG, "Cannot read history in %s (errno=%d) - history stays in RAM", dir, errno);
+        return ESP_FAIL;
+    }
+    ready = true;
+    ESP_LOGI(TAG, "✓ History store: %zu days indexed (%zu months), raw window %d days",
+             day_count, month_count, HISTORY_STORE_RAW_DAYS);
+
+    time_t now = time(NULL);
+    if (now >= HISTORY_STORE_MIN_VALID_TIME && compaction_due(history_day_of(now))) {
+        compact(history_day_of(now));
+    }
+    return ESP_OK;
+}
+
+static esp_err_t write_record(history_store_event_t *rec)
+{
+    if (compaction_due(rec->day)) {
+        compact(rec->day);
+    }
+    rec->crc16 = event_crc(rec);
+
+    io_sched_begin(dev, IO_SCHED_LOG, portMAX_DELAY);
+    FILE *f = fopen(events_path, "ab");
+    if (f == NULL) {
+        io_sched_end(dev, IO_SCHED_LOG);
+        ESP_LOGE(TAG, "Failed to open %s (errno=%d)", events_path, errno);
+        return ESP_FAIL;
+    }
+    bool ok = fwrite(rec, sizeof(*rec), 1, f) == 1;
+    ok = (fclose(f) == 0) && ok;
+    io_sched_end(dev, IO_SCHED_LOG);
+    if (!ok) {
+        ESP_LOGE(TAG, "Failed to append to %s (errno=%d)", events_path, errno);
+        return ESP_FAIL;
+    }
+    if (rec->day < oldest_raw) {
+        oldest_raw = rec->day;
+    }
+    return ESP_OK;
+}
+
+extern "C" esp_err_t history_store_append(const history_event_t *event)
+{
+    if (!ready || event == NULL || history_index_partition() != 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (event->timestamp < HISTORY_STORE_MIN_VALID_TIME) {
+        ESP_LOGW(TAG, "Clock not set yet - event kept in RAM only");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (event->day <= rolled_through) {
+        ESP_LOGW(TAG, "Event dated inside the rolled-up history - not persisted");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    history_store_event_t rec = {};
+    rec.timestamp = (uint32_t)event->timestamp;
+    rec.day = event->day;
+    memcpy(rec.value, event->value, sizeof(rec.value));
+    rec.kind = event->kind;
+    esp_err_t err = write_record(&rec);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    day_entry_t *e = entry_for(rec.day);
+    if (e != NULL) {
+        add_count(e, rec.kind, 1);
+        mark(e);
+    }
+    if (rec.kind == HISTORY_PARAM) {
+        agg_add(&rec);
+        history_trend_invalidate(rec.day);
+    }
+    return ESP_OK;
+}
+
+extern "C" void history_store_note_mood(time_t when, uint8_t category)
+{
+    if (!ready || when < HISTORY_STORE_MIN_VALID_TIME || category > 2) {
+        return;
+    }
+    int32_t day = history_day_of(when);
+    if (day <= rolled_through) {
+        return;
+    }
+    day_entry_t *e = entry_for(day);
+    if (e == NULL || e->mood >= category + 1) {
+        return;    // Not worse than what the day already had
+    }
+
+    history_store_event_t rec = {};
+    rec.timestamp = (uint32_t)when;
+    rec.day = day;
+    rec.value[0] = category;
+    rec.kind = HISTORY_STORE_KIND_MOOD;
+    if (write_record(&rec) == ESP_OK) {
+        // write_record() may compact, which leaves the index as is
+        e = entry_for(day);
+        if (e != NULL) {
+            add_mood(e, category + 1);
+            mark(e);
+        }
+    }
+}
+
+extern "C" bool history_store_month(int year, int month, history_month_t *out)
+{
+    if (!ready || history_index_partition() != 0) {
+        return false;
+    }
+    size_t mi = find_month(year * 12 + month - 1);
+    if (mi == month_count) {
+        memset(out, 0, sizeof(*out));
+        memset(out->mood, HISTORY_MOOD_NONE, sizeof(out->mood));
+        return true;
+    }
+    *out = months[mi].map;
+    return true;
+}
+
+extern "C" bool history_store_span(int32_t from_day, int32_t to_day, int32_t *first, int32_t *last)
+{
+    if (!ready || day_count == 0 || from_day > to_day) {
+        return false;
+    }
+    size_t lo = 0, hi = day_count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (days[mid].day < from_day) lo = mid + 1; else hi = mid;
+    }
+    if (lo == day_count || days[lo].day > to_day) {
+        return false;
+    }
+    *first = days[lo].day;
+    size_t end = lo;
+    hi = day_count;
+    while (end < hi) {
+        size_t mid = (end + hi) / 2;
+        if (days[mid].day <= to_day) end = mid + 1; else hi = mid;
+    }
+    *last = days[end - 1].day;
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// EXPORT READERS
+// ═══════════════════════════════════════════════════════════════════════════
+
+static inline int32_t record_day(const void *rec, bool rollups)
+{
+    return rollups ? ((const history_store_rollup_t *)rec)->day
+                   : ((const history_store_event_t *)rec)->day;
+}
+
+extern "C" esp_err_t history_store_reader_open(history_store_reader_t *r, bool rollups,
+                                               int32_t from_day, int32_t to_day)
+{
+    r->f = NULL;
+    readers++;
+    if (!ready || compacting) {
+        readers--;
+        return ESP_ERR_INVALID_STATE;
+    }
+    // Exports read in the background, one call per slot
+    io_sched_begin(dev, IO_SCHED_BACKGROUND, portMAX_DELAY);
+    FILE *f = fopen(rollups ? rollup_path : events_path, "rb");
+    if (f == NULL) {
+        int e = errno;
+        io_sched_end(dev, IO_SCHED_BACKGROUND);
+        readers--;
+        return e == ENOENT ? ESP_ERR_NOT_FOUND : ESP_FAIL;
+    }
+
+    // First record of from_day or later
+    size_t size = rollups ? sizeof(history_store_rollup_t) : sizeof(history_store_event_t);
+    union { history_store_event_t e; history_store_rollup_t r; } rec;
+    long count = 0;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        count = ftell(f) / (long)size;
+    }
+    long lo = 0, hi = count;
+    while (lo < hi) {
+        long mid = (lo + hi) / 2;
+        if (fseek(f, mid * (long)size, SEEK_SET) != 0 || fread(&rec, size, 1, f) != 1) {
+            hi = mid;
+            continue;
+        }
+        if (record_day(&rec, rollups) < from_day) lo = mid + 1; else hi = mid;
+    }
+    fseek(f, lo * (long)size, SEEK_SET);
+    io_sched_end(dev, IO_SCHED_BACKGROUND);
+
+    r->f = f;
+    r->rollups = rollups;
+    r->to_day = to_day;
+    return ESP_OK;
+}
+
+extern "C" bool history_store_reader_next(history_store_reader_t *r, void *out)
+{
+    if (r->f == NULL) {
+        return false;
+    }
+    size_t size = r->rollups ? sizeof(history_store_rollup_t) : sizeof(history_store_event_t);
+    bool found = false;
+    io_sched_begin(dev, IO_SCHED_BACKGROUND, portMAX_DELAY);
+    while (fread(out, size, 1, r->f) == 1) {
+        bool ok = r->rollups ? ((const history_store_rollup_t *)out)->crc32 ==
+                                   rollup_crc((const history_store_rollup_t *)out)
+                             : event_ok((const history_store_event_t *)out);
+        if (ok) {
+            found = record_day(out, r->rollups) <= r->to_day;
+            break;
+        }
+    }
+    io_sched_end(dev, IO_SCHED_BACKGROUND);
+    return found;
+}
+
+extern "C" void history_store_reader_close(history_store_reader_t *r)
+{
+    if (r->f != NULL) {
+        fclose(r->f);
+        r->f = NULL;
+        readers--;
+    }
+}
@@ -0,0 +1,162 @@
+#ifndef __HISTORY_STORE_H__
+#define __HISTORY_STORE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "esp_err.h"
+#include "history_index.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PERSISTENT ACTIVITY HISTORY ON SD
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Two append-only files of fixed-size binary records in the log directory:
+//   events.bin   history_store_event_t, every feed / water / parameter
+//                event of the last HISTORY_STORE_RAW_DAYS days
+//   daily.bin    history_store_rollup_t, one per older day: event counts,
+//                worst mood and min / max / mean of each water parameter
+//
+// Besides the activity events, events.bin holds a mood record whenever a
+// day's worst mood gets worse (at most three per day).
+//
+// history_store_init() reads both in one sequential pass at boot, builds
+// the day / month index (8 bytes per day with activity, PSRAM) and replays
+// the newest events of each kind into the history index, so the calendar
+// and popups survive a reboot. Every month in the index carries
+// precomputed bitmaps of fed / water-changed / tested days and the worst
+// mood of each day, kept current as events arrive, so a month renders
+// from history_store_month() without touching the day entries. Parameter
+// tests also go into the hourly / daily / monthly aggregate index
+// (history_agg.h) for range queries without a scan. A torn
+// record at the end of events.bin (power cut mid-write) is cut off.
+//
+// Compaction, once the oldest raw day is a week past the window, folds the
+// expired raw events into daily rollups: the rollups are appended first,
+// then events.bin is swapped for a rewritten copy. Raw events on or before
+// the last rolled-up day are ignored on load, so an interrupted compaction
+// never counts a day twice.
+//
+// Events logged before the clock is set (SNTP) are not persisted.
+// The store holds the first tank: with another history index partition
+// selected (history_index.h), appends are skipped and the day / month
+// lookups answer false, so the callers fall back to the in-RAM window.
+// history_store_note_mood() takes the first tank's mood whatever is selected.
+// LVGL context only (same as the CSV logs), except the readers below.
+//
+// Export readers stream either file from any task: opening one finds the
+// first record of the range by binary search on the file (records are
+// appended in day order), then reads it one record at a time. Compaction
+// waits while a reader is open, and a reader cannot open mid-compaction.
+
+#ifndef CONFIG_GOLDIE_HISTORY_RAW_DAYS
+#define CONFIG_GOLDIE_HISTORY_RAW_DAYS 90
+#endif
+
+#define HISTORY_STORE_RAW_DAYS       CONFIG_GOLDIE_HISTORY_RAW_DAYS
+#define HISTORY_STORE_COMPACT_SLACK  7          // Days past the window before compacting
+#define HISTORY_STORE_MIN_VALID_TIME 1577836800 // 2020-01-01: clock not set before this
+#define HISTORY_STORE_PARAMS         4          // Ammonia, nitrate, nitrite, pH
+#define HISTORY_STORE_KIND_MOOD      0x80       // Mood record: value[0] = category
+#define HISTORY_MOOD_NONE            0xFF
+
+typedef struct {
+    uint32_t timestamp;                 // Wall clock, seconds since the epoch
+    int32_t day;                        // history_event_t::day
+    float value[HISTORY_VALUES];
+    uint8_t kind;                       // history_kind_t or HISTORY_STORE_KIND_MOOD
+    uint8_t reserved;
+    uint16_t crc16;                     // esp_rom_crc16_le over the fields above
+} history_store_event_t;
+
+typedef struct {
+    int32_t day;
+    uint8_t count[HISTORY_KIND_COUNT];  // Events per kind
+    uint8_t mood;                       // Worst mood category + 1, 0 = unknown
+    float min[HISTORY_STORE_PARAMS];    // Parameter tests of the day
+    float max[HISTORY_STORE_PARAMS];
+    float mean[HISTORY_STORE_PARAMS];
+    uint32_t reserved1;
+    uint32_t crc32;                     // esp_rom_crc32_le over the fields above
+} history_store_rollup_t;
+
+// Activity of one calendar month: bit (d - 1) is day d
+typedef struct {
+    uint32_t fed;
+    uint32_t water;
+    uint32_t tested;                    // Parameter test logged
+    uint8_t mood[31];                   // Worst mood category, HISTORY_MOOD_NONE if unknown
+} history_month_t;
+
+/**
+ * @brief Load the store from `dir` (one pass) and replay recent events
+ * @return ESP_OK, or an error if the files cannot be read (store stays off)
+ */
+esp_err_t history_store_init(const char *dir);
+
+/**
+ * @brief Persist one event (compacts first when due)
+ */
+esp_err_t history_store_append(const history_event_t *event);
+
+/**
+ * @brief Events per kind on a day, raw and rolled up
+ * @return false if the store is not loaded (counts untouched)
+ */
+bool history_store_day_counts(int32_t day, uint8_t counts[HISTORY_KIND_COUNT]);
+
+/**
+ * @brief Logged events of a kind on a day
+ *
+ * The store counts every event; without it only the last HISTORY_DEPTH
+ * of each kind (history index) are known.
+ */
+int history_store_logged(history_kind_t kind, int32_t day);
+
+/**
+ * @brief Activity bitmaps and moods of a month (month 1-12)
+ * @return false if the store is not loaded; an empty month is all zero
+ */
+bool history_store_month(int year, int month, history_month_t *out);
+
+/**
+ * @brief Note the mood shown now; persisted when it is the day's worst so far
+ */
+void history_store_note_mood(time_t when, uint8_t category);
+
+typedef struct {
+    FILE *f;
+    bool rollups;                       // daily.bin, else events.bin
+    int32_t to_day;
+} history_store_reader_t;
+
+/**
+ * @brief First and last day with activity in [from_day, to_day] (index only)
+ * @return false if the store is not loaded or no day in range has any
+ */
+bool history_store_span(int32_t from_day, int32_t to_day, int32_t *first, int32_t *last);
+
+/**
+ * @brief Any task: open events.bin (or daily.bin) at the first record of from_day
+ * @return ESP_ERR_INVALID_STATE if the store is off or compacting right now
+ */
+esp_err_t history_store_reader_open(history_store_reader_t *r, bool rollups, int32_t from_day, int32_t to_day);
+
+/**
+ * @brief Next intact record up to to_day
+ * @param out history_store_event_t or history_store_rollup_t
+ * @return false at the end of the range
+ */
+bool history_store_reader_next(history_store_reader_t *r, void *out);
+
+void history_store_reader_close(history_store_reader_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
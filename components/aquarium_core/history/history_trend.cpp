@@ -0,0 +1,164 @@
+#include "history_trend.h"
+#include "history_agg.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+
+static const char *TAG = "history_trend";
+
+typedef struct {
+    history_trend_t *t;              // PSRAM, allocated on first use
+    uint32_t used;                   // LRU stamp, 0 = empty
+} trend_slot_t;
+
+static trend_slot_t cache[HISTORY_TREND_CACHE];
+static uint32_t stamp = 0;
+
+static inline uint16_t bucket_of(const history_trend_t *t, int32_t day)
+{
+    return (uint16_t)((int64_t)(day - t->from_day) * t->buckets / t->days);
+}
+
+static void add(history_trend_t *t, int32_t day, const float *lo, const float *hi)
+{
+    if (day < t->from_day || day >= t->from_day + t->days) {
+        return;
+    }
+    uint16_t b = bucket_of(t, day);
+    for (int p = 0; p < HISTORY_STORE_PARAMS; p++) {
+        if (!t->have[b] || lo[p] < t->min[p][b]) t->min[p][b] = lo[p];
+        if (!t->have[b] || hi[p] > t->max[p][b]) t->max[p][b] = hi[p];
+    }
+    t->have[b] = 1;
+    t->tests++;
+}
+
+/**
+ * @brief From the daily aggregate index, one range query per bucket
+ * @return false if the index does not cover the window
+ */
+static bool load_index(history_trend_t *t)
+{
+    history_agg_t a;
+    if (!history_agg_range(HISTORY_AGG_DAY, t->from_day, t->from_day, &a)) {
+        return false;
+    }
+    for (uint16_t b = 0; b < t->buckets; b++) {
+        int32_t first = history_trend_bucket_day(t, b);
+        int32_t last = b + 1 < t->buckets ? history_trend_bucket_day(t, b + 1) - 1 : t->from_day + t->days - 1;
+        if (!history_agg_range(HISTORY_AGG_DAY, first, last, &a) || a.tests == 0) {
+            continue;
+        }
+        for (int p = 0; p < HISTORY_STORE_PARAMS; p++) {
+            t->min[p][b] = a.min[p];
+            t->max[p][b] = a.max[p];
+        }
+        t->have[b] = 1;
+        t->tests += (uint16_t)a.tests;
+    }
+    return true;
+}
+
+/**
+ * @brief One pass: rollups for compacted days, raw events after the last
+ */
+static esp_err_t load(history_trend_t *t)
+{
+    if (load_index(t)) {
+        return ESP_OK;
+    }
+
+    int32_t to_day = t->from_day + t->days - 1;
+    int32_t rolled = INT32_MIN;
+    history_store_reader_t r;
+    esp_err_t err = history_store_reader_open(&r, true, t->from_day, to_day);
+    if (err == ESP_OK) {
+        history_store_rollup_t roll;
+        while (history_store_reader_next(&r, &roll)) {
+            rolled = roll.day;
+            if (roll.count[HISTORY_PARAM] > 0) {
+                add(t, roll.day, roll.min, roll.max);
+            }
+        }
+        history_store_reader_close(&r);
+    } else if (err != ESP_ERR_NOT_FOUND) {
+        return err;
+    }
+
+    err = history_store_reader_open(&r, false, t->from_day, to_day);
+    if (err == ESP_ERR_NOT_FOUND) {
+        return ESP_OK;
+    } else if (err != ESP_OK) {
+        return err;
+    }
+    history_store_event_t ev;
+    while (history_store_reader_next(&r, &ev)) {
+        if (ev.kind != HISTORY_PARAM || ev.day <= rolled) {
+            continue;                // Rolled-up days count once, from the rollup
+        }
+        // pH is logged as a low..high range, like the rollups
+        const float lo[HISTORY_STORE_PARAMS] = { ev.value[HISTORY_AMMONIA], ev.value[HISTORY_NITRATE],
+                                                 ev.value[HISTORY_NITRITE], ev.value[HISTORY_LOW_PH] };
+        const float hi[HISTORY_STORE_PARAMS] = { lo[0], lo[1], lo[2], ev.value[HISTORY_HIGH_PH] };
+        add(t, ev.day, lo, hi);
+    }
+    history_store_reader_close(&r);
+    return ESP_OK;
+}
+
+extern "C" const history_trend_t *history_trend_get(int32_t from_day, uint16_t days)
+{
+    if (days == 0 || history_index_partition() != 0) {
+        return NULL;                            // SD history is the first tank's
+    }
+    trend_slot_t *victim = &cache[0];
+    for (int i = 0; i < HISTORY_TREND_CACHE; i++) {
+        trend_slot_t *s = &cache[i];
+        if (s->used != 0 && s->t->from_day == from_day && s->t->days == days) {
+            s->used = ++stamp;
+            return s->t;
+        }
+        if (s->used < victim->used) {
+            victim = s;
+        }
+    }
+
+    if (victim->t == NULL) {
+        victim->t = (history_trend_t *)heap_caps_malloc(sizeof(history_trend_t), MALLOC_CAP_SPIRAM);
+        if (victim->t == NULL) {
+            ESP_LOGE(TAG, "Out of PSRAM for a trend window");
+            return NULL;
+        }
+    }
+    history_trend_t *t = victim->t;
+    memset(t, 0, sizeof(*t));
+    t->from_day = from_day;
+    t->days = days;
+    t->buckets = days < HISTORY_TREND_POINTS ? days : HISTORY_TREND_POINTS;
+    esp_err_t err = load(t);
+    if (err != ESP_OK) {
+        victim->used = 0;
+        ESP_LOGW(TAG, "Trend of %u days not loaded: %s", (unsigned)days, esp_err_to_name(err));
+        return NULL;
+    }
+    victim->used = ++stamp;
+    ESP_LOGD(TAG, "Trend %ld +%u days: %u tests in %u buckets", (long)from_day, (unsigned)days,
+             (unsigned)t->tests, (unsigned)t->buckets);
+    return t;
+}
+
+extern "C" int32_t history_trend_bucket_day(const history_trend_t *t, uint16_t bucket)
+{
+    // Smallest day whose bucket is `bucket`
+    return t->from_day + (int32_t)(((int64_t)bucket * t->days + t->buckets - 1) / t->buckets);
+}
+
+extern "C" void history_trend_invalidate(int32_t day)
+{
+    for (int i = 0; i < HISTORY_TREND_CACHE; i++) {
+        trend_slot_t *s = &cache[i];
+        if (s->used != 0 && day >= s->t->from_day && day < s->t->from_day + s->t->days) {
+            s->used = 0;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef __HISTORY_TREND_H__
+#define __HISTORY_TREND_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "history_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PARAMETER TRENDS - HISTORY DECIMATED TO A CHART'S WIDTH
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// A trend window is a range of days cut into at most HISTORY_TREND_POINTS
+// equal buckets (one day per bucket for short ranges). Each bucket keeps
+// the min and max of every water parameter tested in it, so a spike on
+// one day of a year still shows as a whisker in its bucket instead of
+// being averaged away.
+//
+// A window is filled from the daily aggregate index (history_agg.h), one
+// O(log n) range query per bucket; for days older than the index still
+// covers, in one pass over the store: daily rollups for the compacted
+// days (their min / max), raw events after them. The last
+// HISTORY_TREND_CACHE windows stay decimated in PSRAM, least recently
+// used out, so zooming back or panning to a window already seen costs
+// nothing. A parameter test logged into the store drops the cached windows
+// that cover its day.
+//
+// LVGL context only (same as the store's writer side).
+
+#define HISTORY_TREND_POINTS  120      // Buckets per window at most: ~4 px each on the chart
+#define HISTORY_TREND_CACHE   8        // Decimated windows kept
+
+// Parameter p of min[] / max[]: same order as history_store_rollup_t
+enum {
+    HISTORY_TREND_AMMONIA = 0,
+    HISTORY_TREND_NITRATE,
+    HISTORY_TREND_NITRITE,
+    HISTORY_TREND_PH,
+};
+
+typedef struct {
+    int32_t from_day;
+    uint16_t days;
+    uint16_t buckets;
+    uint16_t tests;                                           // Tests found in the window
+    uint8_t have[HISTORY_TREND_POINTS];                       // Bucket has a test
+    float min[HISTORY_STORE_PARAMS][HISTORY_TREND_POINTS];
+    float max[HISTORY_STORE_PARAMS][HISTORY_TREND_POINTS];
+} history_trend_t;
+
+/**
+ * @brief The decimated window of `days` days from from_day (cached)
+ * @return NULL if the store is not loaded or out of PSRAM
+ */
+const history_trend_t *history_trend_get(int32_t from_day, uint16_t days);
+
+/**
+ * @brief First day of a bucket
+ */
+int32_t history_trend_bucket_day(const history_trend_t *t, uint16_t bucket);
+
+/**
+ * @brief A test was logged on `day`: drop the windows that cover it
+ */
+void history_trend_invalidate(int32_t day);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
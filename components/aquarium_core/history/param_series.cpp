@@ -0,0 +1,269 @@
+#include "param_series.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static const char *TAG = "param_series";
+
+static char path[64];
+static SemaphoreHandle_t lock = NULL;
+
+// Open block: encoded here, rewritten at block open_index of the file
+static gorilla_block_t open_blk;
+static gorilla_enc_t enc;
+static uint32_t open_index = 0;
+static uint32_t last_t = 0;             // Newest sample, 0 = none
+static uint16_t unsynced = 0;
+
+static uint32_t appended = 0, dropped = 0;
+
+static bool write_block(uint32_t index, bool seal)
+{
+    gorilla_block_finish(&open_blk, seal);
+    FILE *f = fopen(path, "r+b");
+    if (f == NULL && errno == ENOENT) {
+        f = fopen(path, "w+b");
+    }
+    if (f == NULL) {
+        ESP_LOGE(TAG, "Cannot open %s (errno=%d)", path, errno);
+        return false;
+    }
+    bool ok = fseek(f, (long)index * GORILLA_BLOCK_SIZE, SEEK_SET) == 0 &&
+              fwrite(&open_blk, GORILLA_BLOCK_SIZE, 1, f) == 1;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        ESP_LOGE(TAG, "Block %lu not written (errno=%d)", (unsigned long)index, errno);
+    }
+    return ok;
+}
+
+static bool read_block(FILE *f, uint32_t index, gorilla_block_t *blk)
+{
+    return fseek(f, (long)index * GORILLA_BLOCK_SIZE, SEEK_SET) == 0 &&
+           fread(blk, GORILLA_BLOCK_SIZE, 1, f) == 1 && gorilla_block_ok(blk);
+}
+
+/**
+ * @brief Newest timestamp of an intact block
+ */
+static uint32_t block_last_t(const gorilla_block_t *blk)
+{
+    gorilla_dec_t d;
+    uint32_t t = 0;
+    float v[GORILLA_MAX_SERIES];
+    gorilla_dec_init(&d, blk);
+    while (gorilla_dec_next(&d, &t, v)) {
+    }
+    return t;
+}
+
+/**
+ * @brief Find where appends continue: re-encode an unsealed last block
+ */
+static void resume(FILE *f, uint32_t blocks)
+{
+    gorilla_enc_init(&enc, &open_blk, PARAM_SERIES_VALUES);
+    open_index = blocks;
+    if (blocks == 0) {
+        return;
+    }
+    static gorilla_block_t last;        // Init only
+    if (!read_block(f, blocks - 1, &last)) {
+        // Torn by a power cut: overwrite it, order by the block before
+        open_index = blocks - 1;
+        if (blocks >= 2 && read_block(f, blocks - 2, &last)) {
+            last_t = block_last_t(&last);
+        }
+        ESP_LOGW(TAG, "Last block corrupt - its samples are lost");
+        return;
+    }
+    last_t = block_last_t(&last);
+    if (last.flags & GORILLA_SEALED) {
+        return;
+    }
+    gorilla_dec_t d;
+    uint32_t t;
+    float v[GORILLA_MAX_SERIES];
+    gorilla_dec_init(&d, &last);
+    while (gorilla_dec_next(&d, &t, v)) {
+        gorilla_enc_add(&enc, t, v);
+    }
+    open_index = blocks - 1;
+}
+
+extern "C" esp_err_t param_series_init(const char *dir)
+{
+    if (lock != NULL) {
+        return ESP_OK;
+    }
+    snprintf(path, sizeof(path), "%s/series.bin", dir);
+
+    struct stat st;
+    uint32_t blocks = 0;
+    if (stat(path, &st) == 0) {
+        blocks = (uint32_t)(st.st_size / GORILLA_BLOCK_SIZE);
+        if (st.st_size % GORILLA_BLOCK_SIZE != 0 && truncate(path, (off_t)blocks * GORILLA_BLOCK_SIZE) != 0) {
+            ESP_LOGE(TAG, "truncate failed (errno=%d) - series off", errno);
+            return ESP_FAIL;
+        }
+    }
+    FILE *f = blocks ? fopen(path, "rb") : NULL;
+    if (blocks && f == NULL) {
+        ESP_LOGE(TAG, "Cannot read %s (errno=%d) - series off", path, errno);
+        return ESP_FAIL;
+    }
+    resume(f, blocks);
+    if (f) {
+        fclose(f);
+    }
+
+    lock = xSemaphoreCreateMutex();
+    ESP_LOGI(TAG, "✓ Parameter series: %lu blocks, %u samples in the open one",
+             (unsigned long)blocks, (unsigned)open_blk.count);
+    return ESP_OK;
+}
+
+extern "C" esp_err_t param_series_append(time_t t, const float value[PARAM_SERIES_VALUES])
+{
+    if (lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    esp_err_t err = ESP_OK;
+    if ((uint32_t)t < last_t) {
+        dropped++;
+        err = ESP_ERR_INVALID_ARG;
+    } else {
+        if (!gorilla_enc_add(&enc, (uint32_t)t, value)) {
+            // Full: seal it, the sample starts the next block
+            if (write_block(open_index, true)) {
+                open_index++;
+            }
+            gorilla_enc_init(&enc, &open_blk, PARAM_SERIES_VALUES);
+            gorilla_enc_add(&enc, (uint32_t)t, value);
+            unsynced = 0;
+        }
+        last_t = (uint32_t)t;
+        appended++;
+        if (++unsynced >= PARAM_SERIES_SYNC) {
+            unsynced = 0;
+            if (!write_block(open_index, false)) {
+                err = ESP_FAIL;
+            }
+        }
+    }
+    xSemaphoreGive(lock);
+    return err;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// READERS
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" esp_err_t param_series_reader_open(param_series_reader_t *r, time_t from, time_t to)
+{
+    memset(r, 0, sizeof(*r));
+    if (lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    r->from = from < 0 ? 0 : (uint32_t)from;
+    r->to = (uint32_t)to;
+
+    // Blocks sealed from here on are not part of this read
+    xSemaphoreTake(lock, portMAX_DELAY);
+    r->tail = open_blk;
+    r->end = open_index;
+    xSemaphoreGive(lock);
+
+    r->f = r->end ? fopen(path, "rb") : NULL;
+    if (r->f == NULL && r->tail.count == 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Last block starting at or before `from` (blocks are in time order)
+    uint32_t lo = 0, hi = r->end;
+    while (r->f != NULL && lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (!read_block(r->f, mid, &r->blk) || r->blk.t0 > r->from) hi = mid; else lo = mid + 1;
+    }
+    r->next = lo > 0 ? lo - 1 : 0;
+    if (r->f != NULL) {
+        fseek(r->f, (long)r->next * GORILLA_BLOCK_SIZE, SEEK_SET);
+    }
+    return ESP_OK;
+}
+
+extern "C" bool param_series_reader_next(param_series_reader_t *r, param_series_sample_t *out)
+{
+    while (true) {
+        while (r->in_block && gorilla_dec_next(&r->dec, &out->t, out->value)) {
+            if (out->t > r->to) {
+                r->next = r->end;          // Past the range: nothing later matches
+                r->tail_done = true;
+                r->in_block = false;
+                return false;
+            }
+            if (out->t >= r->from) {
+                return true;
+            }
+        }
+        r->in_block = false;
+
+        if (r->f != NULL && r->next < r->end) {
+            r->next++;
+            if (fread(&r->blk, GORILLA_BLOCK_SIZE, 1, r->f) != 1) {
+                r->next = r->end;
+                continue;
+            }
+            if (!gorilla_block_ok(&r->blk)) {
+                continue;
+            }
+        } else if (!r->tail_done) {
+            r->tail_done = true;
+            if (r->tail.count == 0) {
+                return false;
+            }
+            r->blk = r->tail;
+        } else {
+            return false;
+        }
+        if (r->blk.t0 > r->to) {
+            r->next = r->end;
+            r->tail_done = true;
+            return false;
+        }
+        gorilla_dec_init(&r->dec, &r->blk);
+        r->in_block = true;
+    }
+}
+
+extern "C" void param_series_reader_close(param_series_reader_t *r)
+{
+    if (r->f != NULL) {
+        fclose(r->f);
+        r->f = NULL;
+    }
+}
+
+extern "C" void param_series_log_stats(void)
+{
+    if (lock == NULL) {
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    uint32_t blocks = open_index + (open_blk.count > 0);
+    uint32_t open_count = open_blk.count;
+    uint32_t bits = open_blk.bits;
+    xSemaphoreGive(lock);
+    ESP_LOGI(TAG, "%lu blocks, %lu samples appended (%lu dropped)", (unsigned long)blocks,
+             (unsigned long)appended, (unsigned long)dropped);
+    if (open_count > 0) {
+        // Versus a raw timestamp + float per value
+        ESP_LOGI(TAG, "Open block: %lu samples, %.1f bytes per sample (%u raw)", (unsigned long)open_count,
+                 bits / 8.0 / open_count, (unsigned)sizeof(param_series_sample_t));
+    }
+}
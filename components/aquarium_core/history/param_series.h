@@ -0,0 +1,100 @@
+#ifndef __PARAM_SERIES_H__
+#define __PARAM_SERIES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+#include "esp_err.h"
+#include "codec/gorilla.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SENSOR PARAMETER TIME SERIES ON SD (GORILLA BLOCKS)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Probe readings at a fixed period (sensor_acq), one sample of
+// PARAM_SERIES_VALUES filtered values (ammonia, nitrite, nitrate, pH; NAN
+// for a parameter without a probe) per CONFIG_GOLDIE_SERIES_PERIOD_S.
+//
+// series.bin in the log directory is an array of 512-byte Gorilla blocks
+// (codec/gorilla.h: delta-of-delta timestamps, XOR floats), appended in
+// time order. The open block is encoded in RAM and rewritten whole at its
+// sector every PARAM_SERIES_SYNC samples; once full it is sealed and the
+// next one starts. A power cut loses at most the samples since the last
+// rewrite, and a torn block fails its CRC and is skipped. At init the last
+// block, if intact and not sealed, is decoded and re-encoded so appends
+// continue in it.
+//
+// A steady series packs ~750 samples into a block; filtered probe values,
+// whose low mantissa bits change every sample, still average ~9 bytes per
+// sample against 32 in the activity logs, so a year of minute data is
+// ~5 MB and a scan reads a third or less. Samples older than the last one
+// (clock stepped back) are dropped.
+//
+// Readers stream from any task: opening one finds the first block of the
+// range by binary search on the blocks' first timestamps and takes a copy
+// of the open block; each block is decoded sample by sample, so a reader
+// holds two blocks (~1 KB). Appends come from the sensor task (one mutex).
+
+#ifndef CONFIG_GOLDIE_SERIES_PERIOD_S
+#define CONFIG_GOLDIE_SERIES_PERIOD_S 60
+#endif
+
+#define PARAM_SERIES_VALUES  4
+#define PARAM_SERIES_SYNC    10          // Samples between rewrites of the open block
+
+typedef struct {
+    uint32_t t;                         // Wall clock, seconds since the epoch
+    float value[PARAM_SERIES_VALUES];
+} param_series_sample_t;
+
+typedef struct {
+    FILE *f;
+    uint32_t from, to;
+    uint32_t next;                      // Next block index in the file
+    uint32_t end;                       // Blocks to read from the file (the open one excluded)
+    bool tail_done;                     // Open block copy decoded
+    gorilla_dec_t dec;
+    bool in_block;
+    gorilla_block_t blk;                // Block being decoded
+    gorilla_block_t tail;               // Copy of the open block at open time
+} param_series_reader_t;
+
+/**
+ * @brief Open series.bin in `dir` and resume its open block
+ */
+esp_err_t param_series_init(const char *dir);
+
+/**
+ * @brief Append one sample (values in sensor order)
+ */
+esp_err_t param_series_append(time_t t, const float value[PARAM_SERIES_VALUES]);
+
+/**
+ * @brief Any task: stream the samples from..to (wall clock, inclusive)
+ * @return ESP_ERR_INVALID_STATE if the series is off, ESP_ERR_NOT_FOUND if empty
+ */
+esp_err_t param_series_reader_open(param_series_reader_t *r, time_t from, time_t to);
+
+/**
+ * @brief Next sample of the range
+ * @return false at the end of the range
+ */
+bool param_series_reader_next(param_series_reader_t *r, param_series_sample_t *out);
+
+void param_series_reader_close(param_series_reader_t *r);
+
+/**
+ * @brief Log blocks, samples and bytes per sample
+ */
+void param_series_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __PARAM_SERIES_H__
@@ -0,0 +1,320 @@
+#include "med_db.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "med_db";
+
+// The partition image is written by a host script - pin the layout
+static_assert(sizeof(med_product_t) == 96, "med_product_t layout changed - update make_med_partition.py");
+static_assert(sizeof(med_db_header_t) == 96, "med_db_header_t layout changed - update make_med_partition.py");
+
+struct med_unit_info_t {
+    const char *name;
+    float ml;
+};
+
+// Order of med_unit_t
+static constexpr med_unit_info_t units[MED_UNIT_COUNT] = {
+    { "ml",    1.0f },
+    { "tsp",   5.0f },
+    { "tbsp",  15.0f },
+    { "drops", 0.05f },
+    { "fl oz", 29.5735f },
+    { "cups",  236.588f },                  // US cup
+    { "g",     1.0f },
+};
+static_assert(units[MED_UNIT_G].ml == 1.0f && units[MED_UNIT_TBSP].ml == 3 * units[MED_UNIT_TSP].ml,
+              "unit table out of order");
+
+// Generic treatments, used without the partition. Sorted by folded name.
+static const med_product_t builtins[] = {
+    { "Anti-parasitic",    1.0f,   1.0f, MED_UNIT_ML, 1, 0, "Single dose, repeat after 48 hours if needed" },
+    { "Antibiotics",       250.0f, 1.0f, MED_UNIT_ML, 1, 0, "Dose every 24h for 5 days, remove carbon" },
+    { "Fungal Treatment",  2.5f,   1.0f, MED_UNIT_ML, 1, 0, "Treat every other day for 1 week" },
+    { "Ich Treatment",     5.0f,   1.0f, MED_UNIT_ML, 1, 0, "Daily for 3 days, then 25% water change" },
+    { "Water Conditioner", 2.0f,   1.0f, MED_UNIT_ML, 1, 0, "Use during water changes" },
+};
+
+static const med_product_t *records = NULL;
+static uint16_t bucket[MED_DB_BUCKETS + 1];    // Copied: the header's is packed, so unaligned
+static size_t record_count = 0;
+static esp_partition_mmap_handle_t map_handle;
+
+static inline uint8_t fold(uint8_t c)
+{
+    return (c >= 'A' && c <= 'Z') ? (uint8_t)(c - 'A' + 'a') : c;
+}
+
+extern "C" uint8_t med_db_bucket(uint8_t c)
+{
+    if (c < '0') return 0;
+    if (c <= '9') return (uint8_t)(1 + c - '0');
+    if (c < 'a') return 11;
+    if (c <= 'z') return (uint8_t)(12 + c - 'a');
+    return MED_DB_BUCKETS - 1;
+}
+
+/**
+ * @brief Compare a record name with the first len bytes of a folded key
+ * @return <0, 0 (name starts with the key) or >0
+ */
+static int name_cmp(const char *name, const char *key, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        uint8_t a = fold((uint8_t)name[i]);
+        uint8_t b = (uint8_t)key[i];
+        if (a != b) {
+            return (int)a - (int)b;         // A shorter name is less: NUL sorts first
+        }
+    }
+    return 0;
+}
+
+static int record_cmp(const med_product_t *a, const med_product_t *b)
+{
+    for (size_t i = 0; i < MED_DB_NAME_LEN; i++) {
+        uint8_t x = fold((uint8_t)a->name[i]);
+        uint8_t y = fold((uint8_t)b->name[i]);
+        if (x != y || x == 0) {
+            return (int)x - (int)y;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief First record of each bucket, from the sorted records
+ */
+static void build_buckets(const med_product_t *list, size_t count, uint16_t *out)
+{
+    size_t r = 0;
+    for (uint8_t b = 0; b < MED_DB_BUCKETS; b++) {
+        while (r < count && med_db_bucket(fold((uint8_t)list[r].name[0])) < b) {
+            r++;
+        }
+        out[b] = (uint16_t)r;
+    }
+    out[MED_DB_BUCKETS] = (uint16_t)count;
+}
+
+static bool image_ok(const med_db_header_t *hdr, const med_product_t *list)
+{
+    for (uint16_t i = 0; i < hdr->count; i++) {
+        const med_product_t *p = &list[i];
+        if (p->name[0] == '\0' || memchr(p->name, 0, MED_DB_NAME_LEN) == NULL ||
+            memchr(p->note, 0, MED_DB_NOTE_LEN) == NULL || p->unit >= MED_UNIT_COUNT ||
+            !(p->amount > 0.0f) || !(p->per_volume > 0.0f)) {
+            ESP_LOGE(TAG, "Product %d is malformed", i);
+            return false;
+        }
+        if (i > 0 && record_cmp(&list[i - 1], p) >= 0) {
+            ESP_LOGE(TAG, "Products out of order at %d ('%s')", i, p->name);
+            return false;
+        }
+    }
+    uint16_t expect[MED_DB_BUCKETS + 1];
+    build_buckets(list, hdr->count, expect);
+    if (memcmp(expect, hdr->bucket, sizeof(expect)) != 0) {
+        ESP_LOGE(TAG, "Prefix index does not match the products");
+        return false;
+    }
+    return true;
+}
+
+static void map_partition(void)
+{
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           ESP_PARTITION_SUBTYPE_ANY,
+                                                           MED_DB_PARTITION_LABEL);
+    if (part == NULL) {
+        ESP_LOGI(TAG, "No '%s' partition - built-in products only", MED_DB_PARTITION_LABEL);
+        return;
+    }
+    med_db_header_t hdr;
+    if (esp_partition_read(part, 0, &hdr, sizeof(hdr)) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read products partition header");
+        return;
+    }
+    if (hdr.magic != MED_DB_MAGIC || hdr.version != MED_DB_VERSION) {
+        ESP_LOGW(TAG, "Products partition not initialised (magic 0x%08lx) - flash it with make_med_partition.py",
+                 (unsigned long)hdr.magic);
+        return;
+    }
+    if (hdr.record_size != sizeof(med_product_t) || hdr.count == 0) {
+        ESP_LOGE(TAG, "Products partition mismatch: %d records of %d bytes, expected %d-byte records",
+                 hdr.count, hdr.record_size, (int)sizeof(med_product_t));
+        return;
+    }
+    size_t map_size = sizeof(hdr) + (size_t)hdr.count * sizeof(med_product_t);
+    if (map_size > part->size) {
+        ESP_LOGE(TAG, "Products partition too small: need %zu bytes, have %lu", map_size, (unsigned long)part->size);
+        return;
+    }
+
+    const void *ptr = NULL;
+    esp_err_t ret = esp_partition_mmap(part, 0, map_size, ESP_PARTITION_MMAP_DATA, &ptr, &map_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "esp_partition_mmap failed: %s", esp_err_to_name(ret));
+        return;
+    }
+
+    const med_db_header_t *mapped_hdr = (const med_db_header_t *)ptr;
+    const med_product_t *list = (const med_product_t *)(mapped_hdr + 1);
+    uint32_t crc = esp_rom_crc32_le(0, (const uint8_t *)list, map_size - sizeof(hdr));
+    if (crc != hdr.crc32) {
+        ESP_LOGE(TAG, "Products partition CRC mismatch (0x%08lx, header 0x%08lx) - ignoring it",
+                 (unsigned long)crc, (unsigned long)hdr.crc32);
+        esp_partition_munmap(map_handle);
+        return;
+    }
+    if (!image_ok(mapped_hdr, list)) {
+        ESP_LOGE(TAG, "Ignoring the products partition");
+        esp_partition_munmap(map_handle);
+        return;
+    }
+
+    records = list;
+    memcpy(bucket, mapped_hdr->bucket, sizeof(bucket));
+    record_count = hdr.count;
+    ESP_LOGI(TAG, "✓ Mapped %d products from '%s'", (int)record_count, MED_DB_PARTITION_LABEL);
+}
+
+extern "C" void med_db_init(void)
+{
+    static bool initialized = false;
+    if (initialized) {
+        return;
+    }
+    initialized = true;
+
+    map_partition();
+    if (records == NULL) {
+        records = builtins;
+        record_count = sizeof(builtins) / sizeof(builtins[0]);
+        build_buckets(builtins, record_count, bucket);
+    }
+}
+
+extern "C" size_t med_db_count(void)
+{
+    return record_count;
+}
+
+extern "C" const med_product_t *med_db_get(size_t index)
+{
+    return index < record_count ? &records[index] : NULL;
+}
+
+extern "C" size_t med_db_search(const char *prefix, size_t *first)
+{
+    char key[MED_DB_NAME_LEN];
+    size_t len = 0;
+    while (prefix != NULL && prefix[len] != '\0' && len < sizeof(key)) {
+        key[len] = (char)fold((uint8_t)prefix[len]);
+        len++;
+    }
+    *first = 0;
+    if (records == NULL) {
+        return 0;
+    }
+    if (len == 0) {
+        return record_count;
+    }
+
+    // The bucket of the first character bounds both searches
+    uint8_t b = med_db_bucket((uint8_t)key[0]);
+    size_t lo = bucket[b];
+    size_t hi = bucket[b + 1];
+    while (lo < hi) {                       // First name >= key
+        size_t mid = lo + (hi - lo) / 2;
+        if (name_cmp(records[mid].name, key, len) < 0) lo = mid + 1; else hi = mid;
+    }
+    size_t start = lo;
+    hi = bucket[b + 1];
+    while (lo < hi) {                       // First name past the key's prefix range
+        size_t mid = lo + (hi - lo) / 2;
+        if (name_cmp(records[mid].name, key, len) <= 0) lo = mid + 1; else hi = mid;
+    }
+    *first = start;
+    return lo - start;
+}
+
+extern "C" float med_unit_ml(med_unit_t unit)
+{
+    return unit < MED_UNIT_COUNT ? units[unit].ml : 1.0f;
+}
+
+extern "C" const char *med_unit_name(med_unit_t unit)
+{
+    return unit < MED_UNIT_COUNT ? units[unit].name : "?";
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DOSING NOTES
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief "<n> <unit>" or "<n><unit>" at p in seconds (hours, days, weeks), 0 if not
+ */
+static uint32_t note_duration(const char *p)
+{
+    char *end;
+    unsigned long n = strtoul(p, &end, 10);
+    if (end == p || n == 0 || n > 365) {
+        return 0;
+    }
+    while (*end == ' ') {
+        end++;
+    }
+    switch (*end) {
+        case 'h': return (uint32_t)n * 3600;
+        case 'd': return (uint32_t)n * 86400;
+        case 'w': return (uint32_t)n * 7 * 86400;
+        default:  return 0;
+    }
+}
+
+extern "C" bool med_db_note_course(const char *note, uint32_t *every_s, uint8_t *doses)
+{
+    char text[MED_DB_NOTE_LEN];
+    size_t i = 0;
+    for (; note[i] != '\0' && i < sizeof(text) - 1; i++) {
+        text[i] = (char)tolower((unsigned char)note[i]);
+    }
+    text[i] = '\0';
+
+    uint32_t every = 0;
+    uint32_t span = 0;
+    unsigned count = 0;
+    const char *p;
+    if (strstr(text, "every other day") != NULL) {
+        every = 2 * 86400;
+    } else if (strstr(text, "daily") != NULL || strstr(text, "every day") != NULL) {
+        every = 86400;
+    } else if ((p = strstr(text, "every ")) != NULL) {
+        every = note_duration(p + 6);
+    }
+    if ((p = strstr(text, "repeat after ")) != NULL) {
+        every = note_duration(p + 13);
+        count = 2;
+    }
+    if ((p = strstr(text, "for ")) != NULL) {
+        span = note_duration(p + 4);
+    }
+    if (every == 0) {
+        return false;
+    }
+    if (span != 0) {
+        count = (span + every - 1) / every;
+    }
+    if (count < 2 || count > UINT8_MAX) {
+        return false;
+    }
+    *every_s = every;
+    *doses = (uint8_t)count;
+    return true;
+}
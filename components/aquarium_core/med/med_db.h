@@ -0,0 +1,123 @@
+#ifndef __MED_DB_H__
+#define __MED_DB_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// MEDICATION PRODUCTS (MEMORY-MAPPED FLASH PARTITION)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Optional raw data partition labelled "meds" (partitions*.csv), written by
+// tools/make_med_partition.py:
+//   med_db_header_t                     96 bytes, with the prefix index
+//   count × med_product_t               96 bytes each, no padding
+//
+// Records are sorted by name, ASCII case folded. The header's bucket[]
+// gives the first record of each leading-character class
+// (med_db_bucket()), so a prefix search is one bucket lookup and two
+// binary searches inside it, straight on the mapped flash: nothing is
+// parsed or copied, and hundreds of products cost no RAM. The image is
+// checked once at map time (CRC, order, index); a bad one is ignored.
+//
+// Without the partition the built-in generic treatments are used, in the
+// same format. Any task.
+
+#define MED_DB_PARTITION_LABEL  "meds"
+#define MED_DB_MAGIC            0x44454D47u  // "GMED"
+#define MED_DB_VERSION          1
+#define MED_DB_NAME_LEN         36
+#define MED_DB_NOTE_LEN         48
+#define MED_DB_BUCKETS          39           // Below '0', 0-9, ':' to '`', a-z, above 'z'
+#define MED_LITRES_PER_GALLON   3.78541f     // US gallon
+
+typedef enum {
+    MED_UNIT_ML = 0,
+    MED_UNIT_TSP,
+    MED_UNIT_TBSP,
+    MED_UNIT_DROPS,
+    MED_UNIT_FL_OZ,
+    MED_UNIT_CUPS,
+    MED_UNIT_G,                              // Taken as 1 ml: water-like liquids
+    MED_UNIT_COUNT
+} med_unit_t;
+
+typedef struct __attribute__((packed)) {
+    char name[MED_DB_NAME_LEN];              // NUL-terminated
+    float amount;                            // Label dose: this much product...
+    float per_volume;                        // ...per this much water
+    uint8_t unit;                            // med_unit_t of amount
+    uint8_t per_gallons;                     // per_volume in US gallons, else litres
+    uint16_t reserved;
+    char note[MED_DB_NOTE_LEN];              // How to dose, "" = none
+} med_product_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint8_t  version;
+    uint8_t  reserved0;
+    uint16_t count;
+    uint16_t record_size;                    // sizeof(med_product_t)
+    uint16_t reserved1;
+    uint32_t crc32;                          // esp_rom_crc32_le(0, records, count × record_size)
+    uint16_t bucket[MED_DB_BUCKETS + 1];     // First record per bucket; [MED_DB_BUCKETS] = count
+} med_db_header_t;
+
+/**
+ * @brief Map the "meds" partition, or fall back to the built-ins
+ *
+ * Safe to call when the partition does not exist, and more than once.
+ */
+void med_db_init(void);
+
+/**
+ * @brief Number of products
+ */
+size_t med_db_count(void);
+
+/**
+ * @brief Product by index (name order), NULL past the end
+ */
+const med_product_t *med_db_get(size_t index);
+
+/**
+ * @brief Products whose name starts with prefix (case-insensitive)
+ *
+ * Matches are contiguous: med_db_get(*first) to med_db_get(*first + n - 1).
+ * An empty prefix matches every product.
+ *
+ * @return n, the number of matches
+ */
+size_t med_db_search(const char *prefix, size_t *first);
+
+/**
+ * @brief Index class of a folded leading character (monotonic in it)
+ */
+uint8_t med_db_bucket(uint8_t folded);
+
+/**
+ * @brief Millilitres in one unit / its short name ("ml", "tsp", ...)
+ */
+float med_unit_ml(med_unit_t unit);
+const char *med_unit_name(med_unit_t unit);
+
+/**
+ * @brief Repeat schedule of a dosing note, for the reminders
+ *
+ * Understands "daily", "every other day", "every 24h" / "every 2 days",
+ * "for 5 days" / "for 1 week" and "repeat after 48 hours" (two doses),
+ * case-insensitively. A course of N days gets ceil(N / interval) doses.
+ * @return false for a single dose or a note without a schedule
+ */
+bool med_db_note_course(const char *note, uint32_t *every_s, uint8_t *doses);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __MED_DB_H__
@@ -0,0 +1,200 @@
+#include "mood_advice.h"
+#include "mood_engine.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TEMPLATES
+// ═══════════════════════════════════════════════════════════════════════════
+// issue[]:  one %f (the display value) and one %s ("low" / "high")
+// action[]: one %s ("up" / "down"); shared literals are printed once
+
+static const char ACT_WATER_SOON[] = "Plan a 25%% water change";
+static const char ACT_WATER_TODAY[] = "Change 30-50%% of the water today";
+static const char ACT_WATER_NOW[] = "50%% water change NOW, no food for a day";
+
+typedef struct {
+    mood_factor_t factor;
+    const char *issue[2];      // Warning (-1), critical (-2)
+    const char *action[2];
+    float divisor;             // Raw value -> display unit
+} advice_template_t;
+
+static const advice_template_t TEMPLATES[] = {
+    { MOOD_FACTOR_AMMONIA,
+      { "Ammonia detected (%.2f ppm)", "AMMONIA TOXIC (%.2f ppm)!" },
+      { ACT_WATER_TODAY, ACT_WATER_NOW }, 1.0f },
+    { MOOD_FACTOR_NITRITE,
+      { "Nitrite detected (%.2f ppm)", "NITRITE TOXIC (%.2f ppm)!" },
+      { ACT_WATER_TODAY, ACT_WATER_NOW }, 1.0f },
+    { MOOD_FACTOR_PH,
+      { "pH %.1f (too %s)", "pH %.1f - DANGEROUSLY %s!" },
+      { "Check KH, bring pH %s slowly", "Bring pH %s now, 0.2 per day at most" }, 1.0f },
+    { MOOD_FACTOR_NITRATE,
+      { "Nitrate high (%.0f ppm)", "Nitrate very high (%.0f ppm)" },
+      { ACT_WATER_SOON, ACT_WATER_TODAY }, 1.0f },
+    { MOOD_FACTOR_FEED,
+      { "Fish hungry (%.0fh since feed)", "STARVING (%.0fh since feed)!" },
+      { "Feed soon", "Feed a small portion now" }, 3600.0f },
+    { MOOD_FACTOR_CLEAN,
+      { "Water change overdue (%.0f days)", "Water change badly overdue (%.0f days)!" },
+      { ACT_WATER_SOON, ACT_WATER_TODAY }, 86400.0f },
+};
+
+#define TEMPLATE_COUNT  (sizeof(TEMPLATES) / sizeof(TEMPLATES[0]))
+
+static int factor_score(const mood_result_t *r, mood_factor_t f)
+{
+    const int scores[MOOD_FACTOR_COUNT] = {
+        r->ammonia_score, r->nitrite_score, r->nitrate_score,
+        r->ph_score, r->feed_score, r->clean_score
+    };
+    return scores[f];
+}
+
+static float display_value(const aquarium_params_t *p, mood_factor_t f, uint32_t now)
+{
+    switch (f) {
+        case MOOD_FACTOR_AMMONIA: return p->ammonia_ppm;
+        case MOOD_FACTOR_NITRITE: return p->nitrite_ppm;
+        case MOOD_FACTOR_NITRATE: return p->nitrate_ppm;
+        case MOOD_FACTOR_PH:      return p->ph_level;
+        case MOOD_FACTOR_FEED:    return (float)(now - p->last_feed_time);
+        default:                  return (float)(now - p->last_clean_time);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// RENDERING
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    char *buf;
+    size_t len;
+    size_t used;
+} advice_out_t;
+
+static void out_printf(advice_out_t *o, const char *fmt, ...)
+{
+    if (o->used >= o->len - 1) {
+        return;
+    }
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(o->buf + o->used, o->len - o->used, fmt, ap);
+    va_end(ap);
+    if (n > 0) {
+        o->used += ((size_t)n < o->len - o->used) ? (size_t)n : o->len - o->used - 1;
+    }
+}
+
+/**
+ * @brief Time until a planned task is due, as "3h" / "2 days" / "now"
+ */
+static void out_due(advice_out_t *o, const char *what, uint32_t since_s, uint32_t interval_s)
+{
+    if (interval_s == 0) {
+        return;
+    }
+    if (since_s >= interval_s) {
+        out_printf(o, "%s due now.\n", what);
+        return;
+    }
+    uint32_t left = interval_s - since_s;
+    if (left >= 2 * 86400) {
+        out_printf(o, "%s in %lu days.\n", what, (unsigned long)(left / 86400));
+    } else {
+        out_printf(o, "%s in %luh.\n", what, (unsigned long)((left + 3599) / 3600));
+    }
+}
+
+/**
+ * @brief The dosage line of the medication note ("- Total Dosage: ...")
+ */
+static void out_med(advice_out_t *o, const char *note)
+{
+    if (note == NULL || note[0] == '\0') {
+        return;
+    }
+    const char *line = strstr(note, "Total Dosage:");
+    if (line == NULL) {
+        line = note;
+    }
+    size_t n = strcspn(line, "\n");
+    out_printf(o, "\nMedication: %.*s\n", (int)n, line);
+}
+
+extern "C" size_t mood_advice_format(const mood_result_t *r, const aquarium_params_t *p,
+                                     uint32_t now, const char *med_note, char *buf, size_t len)
+{
+    if (buf == NULL || len == 0) {
+        return 0;
+    }
+    buf[0] = '\0';
+    advice_out_t o = { buf, len, 0 };
+
+    // Worst first: up to MOOD_ADVICE_MAX_ISSUES of critical, then warning
+    const advice_template_t *picked[MOOD_ADVICE_MAX_ISSUES];
+    int level[MOOD_ADVICE_MAX_ISSUES];
+    size_t count = 0;
+    for (int sev = 1; sev >= 0; sev--) {
+        for (size_t i = 0; i < TEMPLATE_COUNT && count < MOOD_ADVICE_MAX_ISSUES; i++) {
+            int s = factor_score(r, TEMPLATES[i].factor);
+            if ((sev == 1 && s <= -2) || (sev == 0 && s == -1)) {
+                picked[count] = &TEMPLATES[i];
+                level[count] = sev;
+                count++;
+            }
+        }
+    }
+
+    if (count == 0) {
+        out_printf(&o, "Tank is healthy!\nAll parameters normal.\n");
+        out_due(&o, "Next feed", now - p->last_feed_time, p->planned_feed_interval);
+        out_due(&o, "Water change", now - p->last_clean_time, p->planned_water_change_interval * 86400u);
+        out_med(&o, med_note);
+        return o.used;
+    }
+
+    bool low_ph = p->ph_level < mood_engine_preset()->factor[MOOD_FACTOR_PH].low[0];
+    bool toxins = r->ammonia_score <= -1 || r->nitrite_score <= -1;
+
+    out_printf(&o, "%s\n", r->category == 2 ? "CRITICAL ISSUES:" : "ATTENTION NEEDED:");
+    for (size_t i = 0; i < count; i++) {
+        const advice_template_t *t = picked[i];
+        out_printf(&o, "• ");
+        out_printf(&o, t->issue[level[i]], (double)(display_value(p, t->factor, now) / t->divisor),
+                   low_ph ? "low" : "high");
+        out_printf(&o, "\n");
+    }
+
+    out_printf(&o, "\nRECOMMENDED ACTIONS:\n");
+    const char *given[MOOD_ADVICE_MAX_ISSUES];
+    size_t given_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        const char *act = picked[i]->action[level[i]];
+        if (picked[i]->factor == MOOD_FACTOR_FEED && toxins) {
+            act = "Feed sparingly until ammonia / nitrite are 0";   // Food feeds the ammonia
+        }
+        bool dup = false;
+        for (size_t j = 0; j < given_count && !dup; j++) {
+            dup = (given[j] == act);
+        }
+        // A stronger water change already covers a milder one
+        if (!dup && (act == ACT_WATER_SOON || act == ACT_WATER_TODAY)) {
+            for (size_t j = 0; j < given_count && !dup; j++) {
+                dup = (given[j] == ACT_WATER_NOW) || (act == ACT_WATER_SOON && given[j] == ACT_WATER_TODAY);
+            }
+        }
+        if (dup) {
+            continue;
+        }
+        given[given_count++] = act;
+        out_printf(&o, "→ ");
+        out_printf(&o, act, low_ph ? "up" : "down");
+        out_printf(&o, "\n");
+    }
+    out_med(&o, med_note);
+    return o.used;
+}
@@ -0,0 +1,51 @@
+#ifndef __MOOD_ADVICE_H__
+#define __MOOD_ADVICE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "aquarium_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LOCAL ADVICE (RULE-BASED, NO NETWORK)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Advice rendered on the device from the mood engine's factor scores, for
+// the AI screen while the model is being asked and whenever it cannot be.
+// Each factor has two compact templates (warning at -1, critical at -2):
+// an issue line with the reading and an action line. Critical issues are
+// listed before warnings, in the mood reason order (ammonia, nitrite, pH,
+// nitrate, feed, water change); actions shared by several factors (a water
+// change) are given once. A healthy tank gets a short all-clear with the
+// time to the next feed and water change.
+//
+//   ATTENTION NEEDED:
+//   • Ammonia detected (0.25 ppm)
+//   • Fish hungry (14h since feed)
+//
+//   RECOMMENDED ACTIONS:
+//   → Change 30-50% of the water today
+//   → Feed sparingly until ammonia / nitrite are 0
+//
+// Plain text (one line each, "• " / "→ " bullets); the caller adds any
+// status line.
+
+#define MOOD_ADVICE_MAX_ISSUES  4    // Lines listed, worst first
+
+/**
+ * @brief Render advice for a mood result
+ * @param med_note Latest dosage calculation (first line used), NULL / "" = none
+ * @return Length written (excluding the terminator)
+ */
+size_t mood_advice_format(const mood_result_t *result, const aquarium_params_t *params,
+                          uint32_t now, const char *med_note, char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
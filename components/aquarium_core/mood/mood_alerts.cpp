@@ -0,0 +1,174 @@
+#include "mood/mood_alerts.h"
+#include "mood/mood_engine.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "mood_alerts";
+
+// What NVS keeps: the state last notified and when each alert was raised
+typedef struct {
+    uint8_t notified[TANK_MAX];                 // Bit per mood_alert_kind_t: critical
+    uint32_t raised[TANK_MAX][MOOD_ALERT_COUNT]; // Wall clock of the last raise, 0 = never
+} alert_store_t;
+
+static alert_store_t store = {};
+static uint8_t scored[TANK_MAX];               // Bit per kind: critical in the latest result
+static uint8_t known = 0;                      // Bit per tank: a result since boot
+static uint8_t held[TANK_MAX];                 // Bit per kind: raise waiting out the cooldown
+
+static uint32_t stat_raised = 0;
+static uint32_t stat_cleared = 0;
+static uint32_t stat_held = 0;
+
+static const struct {
+    const char *name;
+    const char *raised_code;
+    const char *cleared_code;
+    mood_factor_t factor;
+} kinds[MOOD_ALERT_COUNT] = {
+    { "Ammonia", "ammonia_critical", "ammonia_cleared", MOOD_FACTOR_AMMONIA },
+    { "Nitrite", "nitrite_critical", "nitrite_cleared", MOOD_FACTOR_NITRITE },
+    { "pH",      "ph_critical",      "ph_cleared",      MOOD_FACTOR_PH },
+};
+
+static void store_save(void)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(MOOD_ALERT_NVS_NS, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, MOOD_ALERT_NVS_KEY, &store, sizeof(store));
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Alert state not saved: %s", esp_err_to_name(err));
+    }
+}
+
+extern "C" void mood_alerts_init(void)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(MOOD_ALERT_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+        return;
+    }
+    size_t len = sizeof(store);
+    // A different TANK_MAX changes the size: start from nothing notified
+    if (nvs_get_blob(nvs, MOOD_ALERT_NVS_KEY, &store, &len) != ESP_OK || len != sizeof(store)) {
+        memset(&store, 0, sizeof(store));
+    }
+    nvs_close(nvs);
+    for (int t = 0; t < TANK_MAX; t++) {
+        if (store.notified[t] != 0) {
+            ESP_LOGI(TAG, "Tank %d: alerts 0x%x standing since before the reboot", t + 1, store.notified[t]);
+        }
+    }
+}
+
+extern "C" void mood_alerts_update(const mood_result_t *result)
+{
+    if (result->tank >= TANK_MAX) {
+        return;
+    }
+    const mood_preset_t *preset = mood_engine_preset();
+    const int score[MOOD_ALERT_COUNT] = { result->ammonia_score, result->nitrite_score, result->ph_score };
+    uint8_t bits = 0;
+    for (int k = 0; k < MOOD_ALERT_COUNT; k++) {
+        if (score[k] <= preset->factor[kinds[k].factor].score[MOOD_BANDS]) {
+            bits |= 1u << k;
+        }
+    }
+    scored[result->tank] = bits;
+    known |= 1u << result->tank;
+}
+
+extern "C" bool mood_alerts_next(mood_alert_event_t *ev, uint32_t now)
+{
+    const uint32_t cooldown_s = CONFIG_GOLDIE_MOOD_ALERT_COOLDOWN_MIN * 60u;
+    for (int t = 0; t < TANK_MAX; t++) {
+        if (!(known & (1u << t))) {
+            continue;    // Nothing scored yet: the stored state stands
+        }
+        uint8_t due = scored[t] ^ store.notified[t];
+        for (int k = 0; k < MOOD_ALERT_COUNT; k++) {
+            if (!(due & (1u << k))) {
+                held[t] &= ~(1u << k);
+                continue;
+            }
+            bool critical = scored[t] & (1u << k);
+            uint32_t raised = store.raised[t][k];
+            // A clock behind the last raise (not set yet) waits as well
+            if (critical && raised != 0 && (now < raised || now - raised < cooldown_s)) {
+                if (!(held[t] & (1u << k))) {
+                    held[t] |= 1u << k;
+                    stat_held++;
+                    ESP_LOGI(TAG, "Tank %d: %s critical again within the cooldown - held back", t + 1,
+                             kinds[k].name);
+                }
+                continue;
+            }
+            ev->tank = (uint8_t)t;
+            ev->kind = (uint8_t)k;
+            ev->critical = critical;
+            return true;
+        }
+    }
+    return false;
+}
+
+extern "C" void mood_alerts_ack(const mood_alert_event_t *ev, uint32_t now)
+{
+    if (ev->tank >= TANK_MAX || ev->kind >= MOOD_ALERT_COUNT) {
+        return;
+    }
+    uint8_t bit = 1u << ev->kind;
+    if (ev->critical) {
+        store.notified[ev->tank] |= bit;
+        store.raised[ev->tank][ev->kind] = now;
+        stat_raised++;
+    } else {
+        store.notified[ev->tank] &= ~bit;
+        stat_cleared++;
+    }
+    held[ev->tank] &= ~bit;
+    store_save();
+}
+
+extern "C" const char *mood_alerts_code(const mood_alert_event_t *ev)
+{
+    if (ev->kind >= MOOD_ALERT_COUNT) {
+        return "";
+    }
+    return ev->critical ? kinds[ev->kind].raised_code : kinds[ev->kind].cleared_code;
+}
+
+extern "C" size_t mood_alerts_format(const mood_alert_event_t *ev, char *buf, size_t size)
+{
+    if (ev->kind >= MOOD_ALERT_COUNT || size == 0) {
+        return 0;
+    }
+    char tank[12] = "";
+    if (TANK_MAX > 1) {
+        snprintf(tank, sizeof(tank), "Tank %d: ", ev->tank + 1);
+    }
+    int n = snprintf(buf, size, "%s%s %s", tank, kinds[ev->kind].name,
+                     ev->critical ? "is critical" : "is out of the critical range");
+    if (n < 0) {
+        buf[0] = '\0';
+        return 0;
+    }
+    return (size_t)n < size ? (size_t)n : size - 1;
+}
+
+extern "C" void mood_alerts_log_stats(void)
+{
+    int standing = 0;
+    for (int t = 0; t < TANK_MAX; t++) {
+        standing += __builtin_popcount(store.notified[t]);
+    }
+    ESP_LOGI(TAG, "%d alert(s) standing; since boot %lu raised, %lu cleared, %lu held back by the cooldown",
+             standing, (unsigned long)stat_raised, (unsigned long)stat_cleared, (unsigned long)stat_held);
+}
@@ -0,0 +1,104 @@
+#ifndef __MOOD_ALERTS_H__
+#define __MOOD_ALERTS_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "aquarium_types.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// MOOD ALERTS - ONE EVENT WHEN A CRITICAL FACTOR STARTS, ONE WHEN IT ENDS
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Ammonia, nitrite and pH of every tank are watched in the mood results
+// (MSG_TOPIC_MOOD_RESULT): a factor is critical while its score is the
+// preset's worst band (outside every band, the same test as the audio
+// alerts). Each (tank, factor) alert keeps the state last notified; an
+// event is due whenever the scored state differs from it:
+//
+//   raised   critical now, notified clear - at most once per
+//            CONFIG_GOLDIE_MOOD_ALERT_COOLDOWN_MIN per alert, so a reading
+//            flapping around the limit does not flood the app
+//   cleared  clear now, notified critical - at once
+//
+// Nothing is queued: mood_alerts_next() derives the due event from the two
+// states, and only mood_alerts_ack() (after the push went out) moves the
+// notified state, so a failed push is retried and an alert that clears
+// before it was sent costs nothing. The notified states and the last raise
+// times are kept in NVS, so a reboot while an alert stands does not raise
+// it again, and one that cleared while the device was off is cleared.
+//
+// Telemetry worker only (no locks); mood_alerts_init() before the first
+// update.
+
+#ifndef CONFIG_GOLDIE_MOOD_ALERTS
+#define CONFIG_GOLDIE_MOOD_ALERTS 0
+#endif
+#ifndef CONFIG_GOLDIE_MOOD_ALERT_COOLDOWN_MIN
+#define CONFIG_GOLDIE_MOOD_ALERT_COOLDOWN_MIN 60
+#endif
+
+#define MOOD_ALERT_NVS_NS   "goldie_alert"
+#define MOOD_ALERT_NVS_KEY  "state"
+
+typedef enum {
+    MOOD_ALERT_AMMONIA = 0,
+    MOOD_ALERT_NITRITE,
+    MOOD_ALERT_PH,
+    MOOD_ALERT_COUNT
+} mood_alert_kind_t;
+
+typedef struct {
+    uint8_t tank;
+    uint8_t kind;              // mood_alert_kind_t
+    bool critical;             // true: raised, false: cleared
+} mood_alert_event_t;
+
+/**
+ * @brief Restore the notified states from NVS
+ */
+void mood_alerts_init(void);
+
+/**
+ * @brief Take the critical factors of one tank's result
+ */
+void mood_alerts_update(const mood_result_t *result);
+
+/**
+ * @brief The next event due (tanks with a result since boot only)
+ * @param now Wall clock, for the cooldown
+ * @return false if none
+ */
+bool mood_alerts_next(mood_alert_event_t *ev, uint32_t now);
+
+/**
+ * @brief The event went out: it becomes the notified state (NVS)
+ */
+void mood_alerts_ack(const mood_alert_event_t *ev, uint32_t now);
+
+/**
+ * @brief Event code, e.g. "ammonia_critical" / "ammonia_cleared"
+ */
+const char *mood_alerts_code(const mood_alert_event_t *ev);
+
+/**
+ * @brief One line for the notification ("Tank 2: Nitrite is critical")
+ * @return Length written
+ */
+size_t mood_alerts_format(const mood_alert_event_t *ev, char *buf, size_t size);
+
+/**
+ * @brief Log standing alerts and events sent / held back by the cooldown
+ */
+void mood_alerts_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __MOOD_ALERTS_H__
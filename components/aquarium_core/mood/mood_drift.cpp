@@ -0,0 +1,62 @@
+#include "mood_drift.h"
+#include "mood_engine.h"
+#include <math.h>
+
+// Smallest sigma per water factor: about a test kit's resolution
+static const float SIGMA_MIN[MOOD_TREND_FACTORS] = { 0.05f, 0.05f, 1.0f, 0.05f };
+
+extern "C" bool mood_drift_update(mood_drift_t *d, const mood_trend_t *tr)
+{
+    uint8_t before = d->mask;
+    int n = (int)tr->count - 1;                  // Window without the newest
+    if (n < MOOD_DRIFT_MIN_SAMPLES) {
+        return false;
+    }
+    uint8_t newest = (uint8_t)((tr->head + MOOD_TREND_WINDOW - 1) % MOOD_TREND_WINDOW);
+    uint8_t oldest = (uint8_t)((tr->head + MOOD_TREND_WINDOW - tr->count) % MOOD_TREND_WINDOW);
+
+    for (int f = 0; f < MOOD_TREND_FACTORS; f++) {
+        float latest = tr->v[newest][f];
+        double sum = 0.0, sum_sq = 0.0;
+        for (int i = 0; i < n; i++) {
+            float v = tr->v[(oldest + i) % MOOD_TREND_WINDOW][f];
+            sum += v;
+            sum_sq += (double)v * v;
+        }
+        double mean = sum / n;
+        double var = sum_sq / n - mean * mean;
+        float sigma = var > 0.0 ? (float)sqrt(var) : 0.0f;
+        if (sigma < SIGMA_MIN[f]) {
+            sigma = SIGMA_MIN[f];
+        }
+        float z = (latest - (float)mean) / sigma;
+        if (!isfinite(z)) {
+            continue;                            // No reading for this factor
+        }
+        d->z[f] = z;
+
+        // Only the harmful directions: rising nitrogen, pH either way
+        bool two_sided = f == MOOD_FACTOR_PH;
+        d->up[f] = fmaxf(0.0f, d->up[f] + z - MOOD_DRIFT_K);
+        d->down[f] = two_sided ? fmaxf(0.0f, d->down[f] - z - MOOD_DRIFT_K) : 0.0f;
+        float cusum = fmaxf(d->up[f], d->down[f]);
+        bool jump = z >= MOOD_DRIFT_Z_ALARM || (two_sided && z <= -MOOD_DRIFT_Z_ALARM);
+
+        uint8_t bit = (uint8_t)(1u << f);
+        if (jump || cusum >= MOOD_DRIFT_H) {
+            d->mask |= bit;
+        } else if (cusum < MOOD_DRIFT_H / 2) {
+            d->mask &= (uint8_t)~bit;
+        }
+    }
+    return d->mask != before;
+}
+
+extern "C" void mood_drift_apply(const mood_drift_t *d, mood_forecast_t *fc)
+{
+    fc->drift_mask = d->mask;
+    for (int f = 0; f < MOOD_TREND_FACTORS; f++) {
+        float z = roundf(d->z[f]);
+        fc->drift_z[f] = (int8_t)(z > 99.0f ? 99 : (z < -99.0f ? -99 : z));
+    }
+}
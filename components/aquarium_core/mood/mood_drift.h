@@ -0,0 +1,65 @@
+#ifndef __MOOD_DRIFT_H__
+#define __MOOD_DRIFT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "aquarium_types.h"
+#include "mood_trend.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PARAMETER DRIFT DETECTION
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// The mood bands only react once a reading crosses a threshold; a nitrate
+// climbing from 5 to 18 ppm in two days is "fine" all the way. After each
+// sample the logic task adds to the trend window (mood_trend.h), every
+// water factor's newest value is scored against the window before it:
+//
+//   z = (latest - mean) / max(stddev, MOOD_DRIFT_SIGMA_MIN)
+//
+// and folded into a one-sided CUSUM per harmful direction (up for the
+// nitrogen compounds, both ways for pH):
+//
+//   S = max(0, S + z - MOOD_DRIFT_K)
+//
+// A factor is drifting when |z| >= MOOD_DRIFT_Z_ALARM in a harmful
+// direction (a jump) or S >= MOOD_DRIFT_H (a steady climb, each step
+// small); it clears once S falls below half of that. The sigma floor is
+// about a test kit's resolution, so a steady tank's identical readings do
+// not make every small step an outlier.
+//
+// The window is MOOD_TREND_WINDOW samples, scored once per sample: a few
+// dozen float operations, nothing per tick.
+
+#define MOOD_DRIFT_MIN_SAMPLES  4          // Window before the newest sample
+#define MOOD_DRIFT_Z_ALARM      3.0f
+#define MOOD_DRIFT_K            0.5f       // CUSUM slack, in sigmas per sample
+#define MOOD_DRIFT_H            4.0f       // CUSUM alarm level
+
+typedef struct {
+    float z[MOOD_TREND_FACTORS];           // Newest sample's z-score (0 until scored)
+    float up[MOOD_TREND_FACTORS];          // CUSUM of rises
+    float down[MOOD_TREND_FACTORS];        // CUSUM of falls (pH only)
+    uint8_t mask;                          // Drifting factors, bit per mood_factor_t
+} mood_drift_t;
+
+/**
+ * @brief Score the newest sample of the window (right after mood_trend_add)
+ * @return true if the set of drifting factors changed
+ */
+bool mood_drift_update(mood_drift_t *drift, const mood_trend_t *trend);
+
+/**
+ * @brief Copy the drifting factors and their z-scores into a forecast
+ */
+void mood_drift_apply(const mood_drift_t *drift, mood_forecast_t *forecast);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
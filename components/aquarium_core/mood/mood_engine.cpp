@@ -0,0 +1,574 @@
+#include "mood_engine.h"
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════════════════
+// THRESHOLD TABLES (compile time)
+// ═══════════════════════════════════════════════════════════════════════════
+// Bands per factor: { ideal, acceptable, warning }. Anything outside the
+// warning band is critical.
+
+#ifndef CONFIG_GOLDIE_FISH_ACTIVITY_LOW_PM
+#define CONFIG_GOLDIE_FISH_ACTIVITY_LOW_PM 3
+#endif
+
+#define NL (-MOOD_NO_LIMIT)
+#define NH (MOOD_NO_LIMIT)
+
+// Ammonia / nitrite: only 0 ppm is safe, >= 0.5 ppm kills fish quickly
+static constexpr mood_band_table_t TOXIN_ZERO = {
+    { NL, NL, NL }, { 0.0f, 0.25f, 0.5f }, 0x0, 0x6, { 2, 0, -1, -2 }
+};
+
+// Feeding: 1x / 1.5x / 2x the planned interval (seconds)
+static constexpr mood_band_table_t FEED_INTERVAL = {
+    { NL, NL, NL }, { 1.0f, 1.5f, 2.0f }, 0x0, 0x0, { 2, 1, -1, -2 }
+};
+
+// Water change: 1x / 1.2x / 1.5x the planned interval (seconds)
+static constexpr mood_band_table_t CLEAN_INTERVAL = {
+    { NL, NL, NL }, { 1.0f, 1.2f, 1.5f }, 0x0, 0x0, { 2, 1, -1, -2 }
+};
+
+// Fish activity (permille of the view moving): lethargic below the limit.
+// Not part of a preset, so profiles in flash keep their layout
+static constexpr mood_band_table_t ACTIVITY_LOW = {
+    { (float)CONFIG_GOLDIE_FISH_ACTIVITY_LOW_PM, (float)CONFIG_GOLDIE_FISH_ACTIVITY_LOW_PM, NL },
+    { NH, NH, NH }, 0x0, 0x0, { 0, 0, -1, -1 }
+};
+
+static constexpr mood_preset_t PRESETS[] = {
+    {
+        // Typical freshwater community tank (pH 6.5-7.5, nitrate < 20 ppm)
+        "community", "goldfish",
+        {
+            TOXIN_ZERO,
+            TOXIN_ZERO,
+            { { NL, NL, NL }, { 20.0f, 40.0f, 80.0f }, 0x0, 0x7, { 2, 1, -1, -2 } },
+            { { 6.5f, 6.0f, 5.5f }, { 7.5f, 8.0f, 8.5f }, 0x0, 0x0, { 2, 1, -1, -2 } },
+            FEED_INTERVAL,
+            CLEAN_INTERVAL,
+        },
+        28800, 7, 0,
+    },
+    {
+        // Soft, acidic water (tetras, discus, rasboras): lower pH and nitrate
+        "soft_water", "tetra",
+        {
+            TOXIN_ZERO,
+            TOXIN_ZERO,
+            { { NL, NL, NL }, { 10.0f, 20.0f, 40.0f }, 0x0, 0x7, { 2, 1, -1, -2 } },
+            { { 6.0f, 5.5f, 5.0f }, { 7.0f, 7.5f, 8.0f }, 0x0, 0x0, { 2, 1, -1, -2 } },
+            FEED_INTERVAL,
+            CLEAN_INTERVAL,
+        },
+        28800, 7, 0,
+    },
+    {
+        // Hard, alkaline water (African cichlids, livebearers)
+        "hard_water", "cichlid",
+        {
+            TOXIN_ZERO,
+            TOXIN_ZERO,
+            { { NL, NL, NL }, { 20.0f, 40.0f, 80.0f }, 0x0, 0x7, { 2, 1, -1, -2 } },
+            { { 7.8f, 7.4f, 7.0f }, { 8.6f, 8.8f, 9.0f }, 0x0, 0x0, { 2, 1, -1, -2 } },
+            FEED_INTERVAL,
+            CLEAN_INTERVAL,
+        },
+        28800, 7, 0,
+    },
+};
+
+#undef NL
+#undef NH
+
+// Bands must nest (each one contains the previous) or the band count is
+// meaningless - reject a bad preset at build time. The same checks vet
+// profiles mapped from flash at run time, so they also refuse NaN limits
+// and scores outside -2..+2.
+static constexpr bool table_nested(const mood_band_table_t &t)
+{
+    for (int i = 0; i < MOOD_BANDS; i++) {
+        if (!(t.low[i] == t.low[i]) || !(t.high[i] == t.high[i])) {
+            return false;
+        }
+        if (i > 0 && (t.low[i] > t.low[i - 1] || t.high[i] < t.high[i - 1])) {
+            return false;
+        }
+    }
+    for (int i = 0; i <= MOOD_BANDS; i++) {
+        if (t.score[i] < -2 || t.score[i] > 2) {
+            return false;
+        }
+    }
+    return t.low[0] <= t.high[0];
+}
+
+static constexpr bool preset_valid(const mood_preset_t &p)
+{
+    for (int f = 0; f < MOOD_FACTOR_COUNT; f++) {
+        if (!table_nested(p.factor[f])) {
+            return false;
+        }
+    }
+    // Time factors only grow, so only their upper limits can be crossed
+    // (mood_engine_update() schedules wake-ups from those alone)
+    for (int f = MOOD_FACTOR_FEED; f <= MOOD_FACTOR_CLEAN; f++) {
+        if (p.factor[f].low[0] > 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(table_nested(ACTIVITY_LOW), "activity bands do not nest");
+static_assert(preset_valid(PRESETS[0]), "community preset bands do not nest");
+static_assert(preset_valid(PRESETS[1]), "soft_water preset bands do not nest");
+static_assert(preset_valid(PRESETS[2]), "hard_water preset bands do not nest");
+
+#if CONFIG_GOLDIE_MOOD_PRESET_SOFT_WATER
+#define MOOD_PRESET_INDEX 1
+#elif CONFIG_GOLDIE_MOOD_PRESET_HARD_WATER
+#define MOOD_PRESET_INDEX 2
+#else
+#define MOOD_PRESET_INDEX 0
+#endif
+
+static std::atomic<const mood_preset_t *> active_preset(&PRESETS[MOOD_PRESET_INDEX]);
+
+extern "C" const mood_preset_t *mood_engine_preset(void)
+{
+    return active_preset.load(std::memory_order_acquire);
+}
+
+extern "C" const mood_preset_t *mood_engine_builtin(size_t index)
+{
+    return index < sizeof(PRESETS) / sizeof(PRESETS[0]) ? &PRESETS[index] : NULL;
+}
+
+extern "C" size_t mood_engine_builtin_count(void)
+{
+    return sizeof(PRESETS) / sizeof(PRESETS[0]);
+}
+
+extern "C" bool mood_engine_preset_valid(const mood_preset_t *preset)
+{
+    return preset != NULL && preset_valid(*preset);
+}
+
+extern "C" bool mood_engine_set_preset(const mood_preset_t *preset)
+{
+    if (!mood_engine_preset_valid(preset)) {
+        return false;
+    }
+    active_preset.store(preset, std::memory_order_release);
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SCORING
+// ═══════════════════════════════════════════════════════════════════════════
+
+static inline int band_score(const mood_band_table_t *t, float v, float scale)
+{
+    // Bands nest, so the number of bands the value is outside of is the
+    // sum of independent comparisons - no ladder
+    int outside = 0;
+    for (int i = 0; i < MOOD_BANDS; i++) {
+        float lo = t->low[i] * scale;
+        float hi = t->high[i] * scale;
+        int low_eq = (t->low_incl >> i) & 1;
+        int high_eq = (t->high_incl >> i) & 1;
+        outside += (v < lo) | (low_eq & (v == lo)) | (v > hi) | (high_eq & (v == hi));
+    }
+    return t->score[outside];
+}
+
+extern "C" int mood_engine_score(mood_factor_t factor, float value, float scale)
+{
+    if (factor >= MOOD_FACTOR_COUNT) {
+        return 0;
+    }
+    return band_score(&mood_engine_preset()->factor[factor], value, scale);
+}
+
+static inline uint8_t category_of(int total, int worst)
+{
+    // Any critical factor forces ANGRY; any warning rules out HAPPY
+    if (worst <= -2) {
+        return 2;
+    }
+    if (worst >= 0 && total >= 6) {
+        return 0;
+    }
+    return (total >= 0) ? 1 : 2;
+}
+
+static inline int activity_score(const aquarium_params_t *p)
+{
+    return p->has_activity ? band_score(&ACTIVITY_LOW, (float)p->activity_pm, 1.0f) : 0;
+}
+
+static void set_category(mood_result_t *r)
+{
+    r->total_score = r->ammonia_score + r->nitrite_score + r->nitrate_score +
+                     r->ph_score + r->feed_score + r->clean_score + r->activity_score;
+
+    int worst = r->ammonia_score;
+    const int rest[] = { r->nitrite_score, r->nitrate_score, r->ph_score, r->feed_score, r->clean_score,
+                         r->activity_score };
+    for (int s : rest) {
+        worst = s < worst ? s : worst;
+    }
+    r->category = category_of(r->total_score, worst);
+}
+
+extern "C" mood_result_t mood_engine_evaluate(const aquarium_params_t *p, uint32_t now)
+{
+    const mood_band_table_t *t = mood_engine_preset()->factor;
+    mood_result_t r = {};
+
+    float since_feed = (float)(now - p->last_feed_time);
+    float since_clean = (float)(now - p->last_clean_time);
+
+    r.ammonia_score = band_score(&t[MOOD_FACTOR_AMMONIA], p->ammonia_ppm, 1.0f);
+    r.nitrite_score = band_score(&t[MOOD_FACTOR_NITRITE], p->nitrite_ppm, 1.0f);
+    r.nitrate_score = band_score(&t[MOOD_FACTOR_NITRATE], p->nitrate_ppm, 1.0f);
+    r.ph_score      = band_score(&t[MOOD_FACTOR_PH], p->ph_level, 1.0f);
+    r.feed_score    = band_score(&t[MOOD_FACTOR_FEED], since_feed, (float)p->planned_feed_interval);
+    r.clean_score   = band_score(&t[MOOD_FACTOR_CLEAN], since_clean,
+                                 (float)(p->planned_water_change_interval * 86400));
+    r.activity_score = activity_score(p);
+
+    set_category(&r);
+    return r;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BATCH EVALUATION
+// ═══════════════════════════════════════════════════════════════════════════
+// Column at a time: each pass runs one factor's table over contiguous
+// samples with the limits hoisted, accumulating total / worst per sample
+// in a small stack block. No per-sample struct, no branches on the value.
+
+#define MOOD_BATCH_BLOCK 32
+
+static void score_column(const mood_band_table_t *t, const float *v, float scale, size_t n,
+                         int8_t *total, int8_t *worst)
+{
+    for (size_t i = 0; i < n; i++) {
+        int s = band_score(t, v[i], scale);
+        total[i] += s;
+        worst[i] = s < worst[i] ? s : worst[i];
+    }
+}
+
+static void score_time_column(const mood_band_table_t *t, const uint32_t *since_s, float scale,
+                              size_t n, int8_t *total, int8_t *worst)
+{
+    if (since_s == NULL) {
+        // No history for this factor: count it as on schedule
+        for (size_t i = 0; i < n; i++) {
+            total[i] += t->score[0];
+        }
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        int s = band_score(t, (float)since_s[i], scale);
+        total[i] += s;
+        worst[i] = s < worst[i] ? s : worst[i];
+    }
+}
+
+extern "C" size_t mood_engine_evaluate_batch(const mood_batch_in_t *in, mood_batch_out_t *out)
+{
+    if (in == NULL || out == NULL || in->ammonia_ppm == NULL || in->nitrite_ppm == NULL ||
+        in->nitrate_ppm == NULL || in->ph_level == NULL) {
+        return 0;
+    }
+
+    const mood_band_table_t *t = mood_engine_preset()->factor;
+    float feed_scale = (float)in->planned_feed_interval;
+    float clean_scale = (float)(in->planned_water_change_interval * 86400);
+    int8_t total[MOOD_BATCH_BLOCK];
+    int8_t worst[MOOD_BATCH_BLOCK];
+
+    for (size_t base = 0; base < in->count; base += MOOD_BATCH_BLOCK) {
+        size_t n = in->count - base;
+        n = n < MOOD_BATCH_BLOCK ? n : MOOD_BATCH_BLOCK;
+        memset(total, 0, n);
+        memset(worst, 2, n);
+
+        score_column(&t[MOOD_FACTOR_AMMONIA], in->ammonia_ppm + base, 1.0f, n, total, worst);
+        score_column(&t[MOOD_FACTOR_NITRITE], in->nitrite_ppm + base, 1.0f, n, total, worst);
+        score_column(&t[MOOD_FACTOR_NITRATE], in->nitrate_ppm + base, 1.0f, n, total, worst);
+        score_column(&t[MOOD_FACTOR_PH], in->ph_level + base, 1.0f, n, total, worst);
+        score_time_column(&t[MOOD_FACTOR_FEED], in->since_feed_s ? in->since_feed_s + base : NULL,
+                          feed_scale, n, total, worst);
+        score_time_column(&t[MOOD_FACTOR_CLEAN], in->since_clean_s ? in->since_clean_s + base : NULL,
+                          clean_scale, n, total, worst);
+
+        for (size_t i = 0; i < n; i++) {
+            if (out->total) out->total[base + i] = total[i];
+            if (out->worst) out->worst[base + i] = worst[i];
+            if (out->category) out->category[base + i] = category_of(total[i], worst[i]);
+        }
+    }
+    return in->count;
+}
+
+extern "C" mood_result_t calculate_mood_scores(aquarium_params_t params, uint32_t current_time)
+{
+    return mood_engine_evaluate(&params, current_time);
+}
+
+extern "C" size_t calculate_mood_scores_batch(const mood_batch_in_t *in, mood_batch_out_t *out)
+{
+    return mood_engine_evaluate_batch(in, out);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INCREMENTAL EVALUATION
+// ═══════════════════════════════════════════════════════════════════════════
+
+static inline bool above_high(const mood_band_table_t *t, int band, float v, float scale)
+{
+    float hi = t->high[band] * scale;
+    return v > hi || (((t->high_incl >> band) & 1) && v == hi);
+}
+
+/**
+ * @brief When a time factor's score next drops (its value only grows)
+ *
+ * since_s stays an integer count of seconds, so the crossing is the first
+ * whole second above the next band's limit - found with the same float
+ * comparison band_score() uses, so both always agree.
+ */
+static uint32_t time_factor_due(const mood_band_table_t *t, uint32_t since_s, float scale, uint32_t now)
+{
+    for (int band = 0; band < MOOD_BANDS; band++) {
+        if (above_high(t, band, (float)since_s, scale)) {
+            continue;
+        }
+        float hi = t->high[band] * scale;
+        if (hi >= 4.0e9f) {
+            return MOOD_ENGINE_NEVER;
+        }
+        uint32_t s = hi > (float)since_s ? (uint32_t)hi : since_s;
+        while (!above_high(t, band, (float)s, scale)) {
+            s++;
+        }
+        uint32_t wait_s = s - since_s;
+        return (wait_s >= MOOD_ENGINE_NEVER - now) ? MOOD_ENGINE_NEVER : now + wait_s;
+    }
+    return MOOD_ENGINE_NEVER;  // Already critical - only new inputs can change it
+}
+
+extern "C" bool mood_engine_update(mood_engine_state_t *st, const aquarium_params_t *params, uint32_t now)
+{
+    const mood_preset_t *preset = mood_engine_preset();
+    const mood_band_table_t *t = preset->factor;
+    const aquarium_params_t *p = params ? params : &st->params;
+    const aquarium_params_t *old = &st->params;
+    bool all = !st->valid || st->preset != preset;
+    uint8_t dirty = 0;
+
+    if (all || p->ammonia_ppm != old->ammonia_ppm)  dirty |= 1 << MOOD_FACTOR_AMMONIA;
+    if (all || p->nitrite_ppm != old->nitrite_ppm)  dirty |= 1 << MOOD_FACTOR_NITRITE;
+    if (all || p->nitrate_ppm != old->nitrate_ppm)  dirty |= 1 << MOOD_FACTOR_NITRATE;
+    if (all || p->ph_level != old->ph_level)        dirty |= 1 << MOOD_FACTOR_PH;
+    if (all || p->last_feed_time != old->last_feed_time ||
+        p->planned_feed_interval != old->planned_feed_interval || now >= st->due[0]) {
+        dirty |= 1 << MOOD_FACTOR_FEED;
+    }
+    if (all || p->last_clean_time != old->last_clean_time ||
+        p->planned_water_change_interval != old->planned_water_change_interval || now >= st->due[1]) {
+        dirty |= 1 << MOOD_FACTOR_CLEAN;
+    }
+
+    mood_result_t r = st->result;
+    if (dirty & (1 << MOOD_FACTOR_AMMONIA)) r.ammonia_score = band_score(&t[MOOD_FACTOR_AMMONIA], p->ammonia_ppm, 1.0f);
+    if (dirty & (1 << MOOD_FACTOR_NITRITE)) r.nitrite_score = band_score(&t[MOOD_FACTOR_NITRITE], p->nitrite_ppm, 1.0f);
+    if (dirty & (1 << MOOD_FACTOR_NITRATE)) r.nitrate_score = band_score(&t[MOOD_FACTOR_NITRATE], p->nitrate_ppm, 1.0f);
+    if (dirty & (1 << MOOD_FACTOR_PH))      r.ph_score      = band_score(&t[MOOD_FACTOR_PH], p->ph_level, 1.0f);
+    if (dirty & (1 << MOOD_FACTOR_FEED)) {
+        float scale = (float)p->planned_feed_interval;
+        uint32_t since = now - p->last_feed_time;
+        r.feed_score = band_score(&t[MOOD_FACTOR_FEED], (float)since, scale);
+        st->due[0] = time_factor_due(&t[MOOD_FACTOR_FEED], since, scale, now);
+    }
+    if (dirty & (1 << MOOD_FACTOR_CLEAN)) {
+        float scale = (float)(p->planned_water_change_interval * 86400);
+        uint32_t since = now - p->last_clean_time;
+        r.clean_score = band_score(&t[MOOD_FACTOR_CLEAN], (float)since, scale);
+        st->due[1] = time_factor_due(&t[MOOD_FACTOR_CLEAN], since, scale, now);
+    }
+    r.activity_score = activity_score(p);      // One comparison: not worth a dirty bit
+    set_category(&r);
+
+    const mood_result_t *o = &st->result;
+    bool changed = all || r.category != o->category ||
+                   r.ammonia_score != o->ammonia_score || r.nitrite_score != o->nitrite_score ||
+                   r.nitrate_score != o->nitrate_score || r.ph_score != o->ph_score ||
+                   r.feed_score != o->feed_score || r.clean_score != o->clean_score ||
+                   r.activity_score != o->activity_score;
+    if (params) {
+        st->params = *params;
+    }
+    st->result = r;
+    st->valid = true;
+    st->preset = preset;
+    st->rescored = dirty;
+    st->next_change = st->due[0] < st->due[1] ? st->due[0] : st->due[1];
+    return changed;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// REASONS (built on demand)
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    mood_factor_t factor;
+    const char *critical;      // One %f: the factor's display value
+    const char *warning;
+    float divisor;             // Raw value -> display unit
+} mood_reason_t;
+
+// Reporting order: the first critical factor wins, warnings are listed in turn
+static const mood_reason_t REASONS[] = {
+    { MOOD_FACTOR_AMMONIA,
+      "🚨 CRITICAL: Ammonia %.2f ppm (TOXIC! Fish dying! Emergency water change needed!)",
+      "⚠️ Ammonia %.2f ppm (Detectable ammonia causing stress). ", 1.0f },
+    { MOOD_FACTOR_NITRITE,
+      "🚨 CRITICAL: Nitrite %.2f ppm (TOXIC! Severe oxygen deprivation! Water change NOW!)",
+      "⚠️ Nitrite %.2f ppm (Detectable nitrite causing gill damage). ", 1.0f },
+    { MOOD_FACTOR_PH,
+      "🚨 CRITICAL: pH %.1f (EXTREME! Lethal to fish! Adjust pH immediately!)",
+      "⚠️ pH %.1f (Approaching danger zone). ", 1.0f },
+    { MOOD_FACTOR_NITRATE,
+      "🚨 CRITICAL: Nitrate %.0f ppm (VERY HIGH! Severe waste buildup! Water change urgently needed!)",
+      "⚠️ Nitrate %.0f ppm (High waste buildup, needs water change). ", 1.0f },
+    { MOOD_FACTOR_FEED,
+      "🚨 CRITICAL: Not fed for %.1f hours (STARVING! Feed immediately!)",
+      "⚠️ Not fed for %.1f hours (Hungry, feed soon). ", 3600.0f },
+    { MOOD_FACTOR_CLEAN,
+      "🚨 CRITICAL: Water not changed for %.1f days (VERY OVERDUE! Poor water quality! Clean tank now!)",
+      "⚠️ Water not changed for %.1f days (Overdue, clean soon). ", 86400.0f },
+};
+
+static int result_score(const mood_result_t *r, mood_factor_t f)
+{
+    const int scores[MOOD_FACTOR_COUNT] = {
+        r->ammonia_score, r->nitrite_score, r->nitrate_score,
+        r->ph_score, r->feed_score, r->clean_score
+    };
+    return scores[f];
+}
+
+static float raw_value(const aquarium_params_t *p, mood_factor_t f, uint32_t now)
+{
+    switch (f) {
+        case MOOD_FACTOR_AMMONIA: return p->ammonia_ppm;
+        case MOOD_FACTOR_NITRITE: return p->nitrite_ppm;
+        case MOOD_FACTOR_NITRATE: return p->nitrate_ppm;
+        case MOOD_FACTOR_PH:      return p->ph_level;
+        case MOOD_FACTOR_FEED:    return (float)(now - p->last_feed_time);
+        default:                  return (float)(now - p->last_clean_time);
+    }
+}
+
+extern "C" size_t mood_engine_format_reason(const mood_result_t *r, const aquarium_params_t *p,
+                                            uint32_t now, char *buf, size_t len)
+{
+    if (buf == NULL || len == 0) {
+        return 0;
+    }
+    buf[0] = '\0';
+
+    for (const mood_reason_t &m : REASONS) {
+        if (result_score(r, m.factor) <= -2) {
+            int n = snprintf(buf, len, m.critical, raw_value(p, m.factor, now) / m.divisor);
+            return n < 0 ? 0 : ((size_t)n < len ? (size_t)n : len - 1);
+        }
+    }
+
+    size_t used = 0;
+    for (const mood_reason_t &m : REASONS) {
+        if (result_score(r, m.factor) <= -1 && used < len - 1) {
+            int n = snprintf(buf + used, len - used, m.warning, raw_value(p, m.factor, now) / m.divisor);
+            if (n > 0) {
+                used += ((size_t)n < len - used) ? (size_t)n : len - used - 1;
+            }
+        }
+    }
+    if (r->activity_score <= -1 && used < len - 1) {
+        int n = snprintf(buf + used, len - used,
+                         "⚠️ Barely moving (%.1f%% of the view, lethargic or unwell). ", p->activity_pm / 10.0f);
+        if (n > 0) {
+            used += ((size_t)n < len - used) ? (size_t)n : len - used - 1;
+        }
+    }
+    if (used > 0) {
+        return used;
+    }
+
+    const char *overall;
+    if (r->category == 0) {
+        overall = "😊 Everything is perfect! Water quality excellent, feeding on schedule, tank clean!";
+    } else if (r->category == 1) {
+        overall = "😐 Conditions are okay but could be better. Check parameters and schedules.";
+    } else {
+        overall = "😠 Multiple issues detected! Check water parameters, feeding, and cleaning schedules!";
+    }
+    strncpy(buf, overall, len - 1);
+    buf[len - 1] = '\0';
+    return strlen(buf);
+}
+
+// Latest evaluation, written by logic_task and read by the AI worker
+static portMUX_TYPE latest_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool latest_valid = false;
+static aquarium_params_t latest_params;
+static mood_result_t latest_result;
+static uint32_t latest_time = 0;
+
+extern "C" void mood_engine_set_latest(const aquarium_params_t *params, const mood_result_t *result, uint32_t now)
+{
+    portENTER_CRITICAL(&latest_lock);
+    latest_params = *params;
+    latest_result = *result;
+    latest_time = now;
+    latest_valid = true;
+    portEXIT_CRITICAL(&latest_lock);
+}
+
+extern "C" size_t mood_engine_latest_reason(char *buf, size_t len)
+{
+    if (buf == NULL || len == 0) {
+        return 0;
+    }
+    portENTER_CRITICAL(&latest_lock);
+    bool valid = latest_valid;
+    aquarium_params_t params = latest_params;
+    mood_result_t result = latest_result;
+    uint32_t now = latest_time;
+    portEXIT_CRITICAL(&latest_lock);
+
+    if (!valid) {
+        buf[0] = '\0';
+        return 0;
+    }
+    return mood_engine_format_reason(&result, &params, now, buf, len);
+}
+
+extern "C" bool mood_engine_latest_result(mood_result_t *out)
+{
+    portENTER_CRITICAL(&latest_lock);
+    bool valid = latest_valid;
+    *out = latest_result;
+    portEXIT_CRITICAL(&latest_lock);
+    return valid;
+}
@@ -0,0 +1,215 @@
+#ifndef __MOOD_ENGINE_H__
+#define __MOOD_ENGINE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "aquarium_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TABLE-DRIVEN MOOD SCORING
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Every factor is scored the same way: a band table holds three nested
+// bands (ideal, acceptable, warning) as low/high limits, and the score is
+// picked by how many bands the value falls outside of:
+//
+//   outside 0 bands -> score[0] (+2)    outside 2 bands -> score[2] (-1)
+//   outside 1 band  -> score[1]         outside 3 bands -> score[3] (-2)
+//
+// Limits of FEED / CLEAN are multiples of the user's planned interval
+// (scale); the other factors use absolute units. The tables are constexpr
+// and checked for nesting at compile time (mood_engine.cpp); the active
+// species preset is picked in menuconfig.
+//
+// Fish activity (camera, fish_activity.h) is scored alongside but is not a
+// preset factor: one fixed band, below CONFIG_GOLDIE_FISH_ACTIVITY_LOW_PM
+// it scores -1, otherwise 0. It can only take the mood down (a warning
+// rules out HAPPY) and never alone to ANGRY; without a reading it is 0, so
+// tanks without a camera score exactly as before.
+//
+// Reason strings are not built while scoring. mood_engine_format_reason()
+// renders one on demand (AI prompt, UI) from the scores and parameters.
+
+#define MOOD_BANDS     3
+#define MOOD_NO_LIMIT  3.0e38f   // Band has no limit on this side
+
+typedef enum {
+    MOOD_FACTOR_AMMONIA = 0,   // ppm
+    MOOD_FACTOR_NITRITE,       // ppm
+    MOOD_FACTOR_NITRATE,       // ppm
+    MOOD_FACTOR_PH,
+    MOOD_FACTOR_FEED,          // seconds since feed  / planned feed interval
+    MOOD_FACTOR_CLEAN,         // seconds since clean / planned change interval
+    MOOD_FACTOR_COUNT
+} mood_factor_t;
+
+typedef struct {
+    float low[MOOD_BANDS];     // Value below low[i] is outside band i
+    float high[MOOD_BANDS];    // Value above high[i] is outside band i
+    uint8_t low_incl;          // Bit i: a value equal to low[i] is outside too
+    uint8_t high_incl;         // Bit i: a value equal to high[i] is outside too
+    int8_t score[MOOD_BANDS + 1];
+} mood_band_table_t;
+
+#define MOOD_PRESET_NAME_LEN  24
+
+// Fixed layout: built-in presets and the records of the "profiles" flash
+// partition (mood_profiles.h) are the same struct, so a mapped profile is
+// used in place
+typedef struct {
+    char name[MOOD_PRESET_NAME_LEN];     // NUL-terminated, e.g. "community"
+    char species[MOOD_PRESET_NAME_LEN];  // Who Goldie is in the AI prompt
+    mood_band_table_t factor[MOOD_FACTOR_COUNT];
+    uint32_t feed_interval_s;            // Default planned feeding interval
+    uint16_t water_change_days;          // Default planned water change interval
+    uint16_t reserved;
+} mood_preset_t;
+
+/**
+ * @brief Thresholds in use (menuconfig preset until a profile is selected)
+ */
+const mood_preset_t *mood_engine_preset(void);
+
+/**
+ * @brief Built-in presets (compiled in), NULL past the end
+ */
+const mood_preset_t *mood_engine_builtin(size_t index);
+size_t mood_engine_builtin_count(void);
+
+/**
+ * @brief Check a preset's bands nest (what the built-ins get at compile time)
+ */
+bool mood_engine_preset_valid(const mood_preset_t *preset);
+
+/**
+ * @brief Switch thresholds - a pointer swap, safe from any task
+ *
+ * preset must stay valid forever (built-in or mapped flash). Incremental
+ * states rescore everything on their next update.
+ * @return false if preset is NULL or its bands do not nest
+ */
+bool mood_engine_set_preset(const mood_preset_t *preset);
+
+/**
+ * @brief Score one factor (-2 .. +2)
+ * @param scale Multiplier for the table limits (1 for absolute factors)
+ */
+int mood_engine_score(mood_factor_t factor, float value, float scale);
+
+/**
+ * @brief Score every factor and pick the mood category
+ *
+ * Pure: no globals, no logging, no string formatting.
+ */
+mood_result_t mood_engine_evaluate(const aquarium_params_t *params, uint32_t now);
+
+// ───────────────────────────────────────────────────────────────────────────
+// Batch evaluation
+// ───────────────────────────────────────────────────────────────────────────
+// Struct-of-arrays input for scoring many samples at once (replaying SD
+// parameter logs for the calendar or a mood history in the AI prompt).
+// Each factor is scored as one pass over its own array.
+
+typedef struct {
+    const float *ammonia_ppm;          // count samples each (required)
+    const float *nitrite_ppm;
+    const float *nitrate_ppm;
+    const float *ph_level;
+    const uint32_t *since_feed_s;      // Optional, NULL = feeding on schedule
+    const uint32_t *since_clean_s;     // Optional, NULL = water change on schedule
+    uint32_t planned_feed_interval;    // seconds
+    uint32_t planned_water_change_interval;  // days
+    size_t count;
+} mood_batch_in_t;
+
+typedef struct {
+    int8_t *total;                     // Optional, count entries each
+    int8_t *worst;                     // Lowest factor score (-2 = critical)
+    uint8_t *category;                 // 0=HAPPY, 1=SAD, 2=ANGRY
+} mood_batch_out_t;
+
+/**
+ * @brief Score count samples; same totals and categories as
+ *        mood_engine_evaluate() per sample
+ * @return Samples scored (0 if a required array is missing)
+ */
+size_t mood_engine_evaluate_batch(const mood_batch_in_t *in, mood_batch_out_t *out);
+
+/**
+ * @brief Calculate mood scores from parameters (by value)
+ *
+ * Same as mood_engine_evaluate(); the entry point the dashboard and the
+ * logic task have always used.
+ */
+mood_result_t calculate_mood_scores(aquarium_params_t params, uint32_t current_time);
+
+/**
+ * @brief Score many logged samples at once; same as mood_engine_evaluate_batch()
+ *
+ * Use it to colour calendar days or summarise mood history from SD logs.
+ */
+size_t calculate_mood_scores_batch(const mood_batch_in_t *in, mood_batch_out_t *out);
+
+// ───────────────────────────────────────────────────────────────────────────
+// Incremental evaluation
+// ───────────────────────────────────────────────────────────────────────────
+// Keeps the per-factor scores of the last evaluation and only rescores the
+// factors whose inputs changed. FEED / CLEAN scores also change as time
+// passes with the same inputs; the state records the exact time the next of
+// them crosses a band (next_change) so the caller can sleep until then
+// instead of re-evaluating blindly.
+
+#define MOOD_ENGINE_NEVER  UINT32_MAX
+
+typedef struct {
+    bool valid;                // Scores below describe params
+    const mood_preset_t *preset;  // Thresholds the scores were taken with
+    aquarium_params_t params;  // Inputs of the cached scores
+    mood_result_t result;
+    uint32_t due[2];           // FEED, CLEAN: time their score next changes
+    uint32_t next_change;      // min(due), MOOD_ENGINE_NEVER = stable
+    uint8_t rescored;          // Bit per mood_factor_t rescored by the last update
+} mood_engine_state_t;
+
+/**
+ * @brief Bring the cached result up to date
+ * @param params New inputs, or NULL if only time moved on
+ * @return true if any score or the category changed (always on the first call)
+ */
+bool mood_engine_update(mood_engine_state_t *state, const aquarium_params_t *params, uint32_t now);
+
+/**
+ * @brief Explain a result in one sentence (critical factor, warnings or
+ *        overall state)
+ * @return Length written (excluding the terminator)
+ */
+size_t mood_engine_format_reason(const mood_result_t *result, const aquarium_params_t *params,
+                                 uint32_t now, char *buf, size_t len);
+
+/**
+ * @brief Remember the latest evaluation (logic_task) for lazy reasons
+ */
+void mood_engine_set_latest(const aquarium_params_t *params, const mood_result_t *result, uint32_t now);
+
+/**
+ * @brief Reason for the latest evaluation, built now; any task
+ * @return Length written, 0 (empty string) before the first evaluation
+ */
+size_t mood_engine_latest_reason(char *buf, size_t len);
+
+/**
+ * @brief Scores of the latest evaluation; any task
+ * @return false before the first evaluation
+ */
+bool mood_engine_latest_result(mood_result_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
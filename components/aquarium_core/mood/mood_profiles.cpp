@@ -0,0 +1,164 @@
+#include "mood_profiles.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "nvs.h"
+#include <string.h>
+
+static const char *TAG = "mood_profiles";
+
+// The partition image is written by a host script - pin the layout
+static_assert(sizeof(mood_band_table_t) == 32, "mood_band_table_t layout changed - update make_profile_partition.py");
+static_assert(sizeof(mood_preset_t) == 248, "mood_preset_t layout changed - update make_profile_partition.py");
+static_assert(sizeof(mood_profiles_header_t) == 16, "mood_profiles_header_t must be 16 bytes");
+
+static const mood_preset_t *mapped = NULL;   // Records in flash
+static uint16_t mapped_count = 0;
+static esp_partition_mmap_handle_t map_handle;
+
+static bool record_ok(const mood_preset_t *p)
+{
+    return memchr(p->name, '\0', sizeof(p->name)) != NULL && p->name[0] != '\0' &&
+           memchr(p->species, '\0', sizeof(p->species)) != NULL &&
+           mood_engine_preset_valid(p);
+}
+
+static void map_partition(void)
+{
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           ESP_PARTITION_SUBTYPE_ANY,
+                                                           MOOD_PROFILES_PARTITION_LABEL);
+    if (part == NULL) {
+        ESP_LOGI(TAG, "No '%s' partition - built-in presets only", MOOD_PROFILES_PARTITION_LABEL);
+        return;
+    }
+
+    mood_profiles_header_t hdr;
+    if (esp_partition_read(part, 0, &hdr, sizeof(hdr)) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read profiles partition header");
+        return;
+    }
+    if (hdr.magic != MOOD_PROFILES_MAGIC || hdr.version != MOOD_PROFILES_VERSION) {
+        ESP_LOGW(TAG, "Profiles partition not initialised (magic 0x%08lx) - flash it with make_profile_partition.py",
+                 (unsigned long)hdr.magic);
+        return;
+    }
+    if (hdr.record_size != sizeof(mood_preset_t) || hdr.count == 0) {
+        ESP_LOGE(TAG, "Profiles partition mismatch: %d records of %d bytes, expected %d-byte records",
+                 hdr.count, hdr.record_size, (int)sizeof(mood_preset_t));
+        return;
+    }
+
+    size_t map_size = sizeof(hdr) + (size_t)hdr.count * sizeof(mood_preset_t);
+    if (map_size > part->size) {
+        ESP_LOGE(TAG, "Profiles partition too small: need %zu bytes, have %lu", map_size, (unsigned long)part->size);
+        return;
+    }
+
+    const void *ptr = NULL;
+    esp_err_t ret = esp_partition_mmap(part, 0, map_size, ESP_PARTITION_MMAP_DATA, &ptr, &map_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "esp_partition_mmap failed: %s", esp_err_to_name(ret));
+        return;
+    }
+
+    const uint8_t *records = (const uint8_t *)ptr + sizeof(hdr);
+    uint32_t crc = esp_rom_crc32_le(0, records, map_size - sizeof(hdr));
+    if (crc != hdr.crc32) {
+        ESP_LOGE(TAG, "Profiles partition CRC mismatch (0x%08lx, header 0x%08lx) - ignoring it",
+                 (unsigned long)crc, (unsigned long)hdr.crc32);
+        esp_partition_munmap(map_handle);
+        return;
+    }
+
+    const mood_preset_t *list = (const mood_preset_t *)records;
+    for (uint16_t i = 0; i < hdr.count; i++) {
+        if (!record_ok(&list[i])) {
+            ESP_LOGE(TAG, "Profile %d is malformed (name or bands) - ignoring the partition", i);
+            esp_partition_munmap(map_handle);
+            return;
+        }
+    }
+
+    mapped = list;
+    mapped_count = hdr.count;
+    ESP_LOGI(TAG, "✓ Mapped %d species profiles from '%s'", mapped_count, MOOD_PROFILES_PARTITION_LABEL);
+}
+
+extern "C" size_t mood_profiles_count(void)
+{
+    return mood_engine_builtin_count() + mapped_count;
+}
+
+extern "C" const mood_preset_t *mood_profiles_get(size_t index)
+{
+    size_t builtins = mood_engine_builtin_count();
+    if (index < builtins) {
+        return mood_engine_builtin(index);
+    }
+    index -= builtins;
+    return index < mapped_count ? &mapped[index] : NULL;
+}
+
+extern "C" const mood_preset_t *mood_profiles_find(const char *name)
+{
+    if (name == NULL) {
+        return NULL;
+    }
+    // Search from the end so a flashed profile overrides a built-in
+    for (size_t i = mood_profiles_count(); i-- > 0;) {
+        const mood_preset_t *p = mood_profiles_get(i);
+        if (strncmp(p->name, name, MOOD_PRESET_NAME_LEN) == 0) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+extern "C" bool mood_profiles_select(const char *name, bool persist)
+{
+    const mood_preset_t *p = mood_profiles_find(name);
+    if (p == NULL || !mood_engine_set_preset(p)) {
+        ESP_LOGW(TAG, "Unknown profile '%s'", name ? name : "(null)");
+        return false;
+    }
+    ESP_LOGI(TAG, "Profile '%s' (%s) active", p->name, p->species);
+
+    if (persist) {
+        nvs_handle_t nvs;
+        if (nvs_open(MOOD_PROFILES_NVS_NS, NVS_READWRITE, &nvs) != ESP_OK) {
+            ESP_LOGW(TAG, "NVS unavailable - profile applies until reboot");
+            return true;
+        }
+        if (nvs_set_str(nvs, MOOD_PROFILES_NVS_KEY, p->name) != ESP_OK || nvs_commit(nvs) != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to save profile choice");
+        }
+        nvs_close(nvs);
+    }
+    return true;
+}
+
+extern "C" void mood_profiles_init(void)
+{
+    static bool initialized = false;
+    if (initialized) {
+        return;
+    }
+    initialized = true;
+
+    map_partition();
+
+    char name[MOOD_PRESET_NAME_LEN];
+    size_t len = sizeof(name);
+    nvs_handle_t nvs;
+    if (nvs_open(MOOD_PROFILES_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+        ESP_LOGI(TAG, "Using preset '%s'", mood_engine_preset()->name);
+        return;
+    }
+    esp_err_t err = nvs_get_str(nvs, MOOD_PROFILES_NVS_KEY, name, &len);
+    nvs_close(nvs);
+
+    if (err != ESP_OK || !mood_profiles_select(name, false)) {
+        ESP_LOGI(TAG, "Using preset '%s'", mood_engine_preset()->name);
+    }
+}
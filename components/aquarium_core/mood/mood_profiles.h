@@ -0,0 +1,81 @@
+#ifndef __MOOD_PROFILES_H__
+#define __MOOD_PROFILES_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "mood_engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PER-SPECIES PROFILES (MEMORY-MAPPED FLASH PARTITION)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Optional raw data partition labelled "profiles" (partitions*.csv), written
+// by tools/make_profile_partition.py:
+//   mood_profiles_header_t              16 bytes
+//   count × mood_preset_t               248 bytes each, no padding
+//
+// The partition is mapped once through esp_partition_mmap() and each record
+// is used in place as a mood_preset_t - nothing is parsed or copied.
+// Selecting a profile is mood_engine_set_preset() on the mapped record.
+//
+// Profiles are listed after the built-in presets. The selection is kept in
+// NVS (namespace "goldie_mood", key "profile") and applied at boot; without
+// one the menuconfig preset stays active.
+
+#define MOOD_PROFILES_PARTITION_LABEL  "profiles"
+#define MOOD_PROFILES_MAGIC            0x46525047u  // "GPRF"
+#define MOOD_PROFILES_VERSION          1
+#define MOOD_PROFILES_NVS_NS           "goldie_mood"
+#define MOOD_PROFILES_NVS_KEY          "profile"
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint8_t  version;
+    uint8_t  reserved0;
+    uint16_t count;
+    uint16_t record_size;      // sizeof(mood_preset_t)
+    uint16_t reserved1;
+    uint32_t crc32;            // esp_rom_crc32_le(0, records, count × record_size)
+} mood_profiles_header_t;
+
+/**
+ * @brief Map the profiles partition and apply the saved selection
+ *
+ * Safe to call when the partition does not exist (built-ins only).
+ * Call before the first mood evaluation.
+ */
+void mood_profiles_init(void);
+
+/**
+ * @brief Built-in presets plus mapped profiles
+ */
+size_t mood_profiles_count(void);
+
+/**
+ * @brief Profile by index (built-ins first), NULL past the end
+ */
+const mood_preset_t *mood_profiles_get(size_t index);
+
+/**
+ * @brief Profile by name, NULL if unknown (a mapped profile shadows a
+ *        built-in of the same name)
+ */
+const mood_preset_t *mood_profiles_find(const char *name);
+
+/**
+ * @brief Make a profile the active thresholds
+ * @param persist Also remember it in NVS for the next boot
+ * @return false if no such profile
+ */
+bool mood_profiles_select(const char *name, bool persist);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
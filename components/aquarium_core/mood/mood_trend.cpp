@@ -0,0 +1,299 @@
+#include "mood_trend.h"
+#include "mood_engine.h"
+#include "freertos/FreeRTOS.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *const FACTOR_NAMES[MOOD_FACTOR_COUNT] = {
+    "ammonia", "nitrite", "nitrate", "pH", "feeding", "water change"
+};
+static const char *const FACTOR_UNITS[MOOD_TREND_FACTORS] = { "ppm", "ppm", "ppm", "" };
+
+static inline float water_value(const aquarium_params_t *p, int f)
+{
+    switch (f) {
+        case MOOD_FACTOR_AMMONIA: return p->ammonia_ppm;
+        case MOOD_FACTOR_NITRITE: return p->nitrite_ppm;
+        case MOOD_FACTOR_NITRATE: return p->nitrate_ppm;
+        default:                  return p->ph_level;
+    }
+}
+
+static inline void set_water_value(aquarium_params_t *p, int f, float v)
+{
+    switch (f) {
+        case MOOD_FACTOR_AMMONIA: p->ammonia_ppm = v; break;
+        case MOOD_FACTOR_NITRITE: p->nitrite_ppm = v; break;
+        case MOOD_FACTOR_NITRATE: p->nitrate_ppm = v; break;
+        default:                  p->ph_level = v; break;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ROLLING WINDOW
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void mood_trend_add(mood_trend_t *tr, const aquarium_params_t *p, uint32_t now)
+{
+    if (tr->count == 0) {
+        tr->base_t = now;
+        tr->sum_t = tr->sum_tt = 0.0;
+        for (int f = 0; f < MOOD_TREND_FACTORS; f++) {
+            tr->sum_v[f] = tr->sum_tv[f] = 0.0;
+            tr->ema[f] = water_value(p, f);
+        }
+    } else {
+        // Time-weighted EMA: a test taken a day later moves it further
+        // than one taken a minute later
+        uint8_t last = (uint8_t)((tr->head + MOOD_TREND_WINDOW - 1) % MOOD_TREND_WINDOW);
+        float dt = (float)(now - tr->t[last]);
+        float alpha = 1.0f - expf(-dt / (float)MOOD_TREND_EMA_TAU_S);
+        for (int f = 0; f < MOOD_TREND_FACTORS; f++) {
+            tr->ema[f] += alpha * (water_value(p, f) - tr->ema[f]);
+        }
+    }
+
+    // Full window: the oldest sample leaves the running sums
+    if (tr->count == MOOD_TREND_WINDOW) {
+        double t_old = (double)(tr->t[tr->head] - tr->base_t);
+        tr->sum_t -= t_old;
+        tr->sum_tt -= t_old * t_old;
+        for (int f = 0; f < MOOD_TREND_FACTORS; f++) {
+            tr->sum_v[f] -= tr->v[tr->head][f];
+            tr->sum_tv[f] -= t_old * tr->v[tr->head][f];
+        }
+    } else {
+        tr->count++;
+    }
+
+    double t_new = (double)(now - tr->base_t);
+    tr->t[tr->head] = now;
+    tr->sum_t += t_new;
+    tr->sum_tt += t_new * t_new;
+    for (int f = 0; f < MOOD_TREND_FACTORS; f++) {
+        float v = water_value(p, f);
+        tr->v[tr->head][f] = v;
+        tr->sum_v[f] += v;
+        tr->sum_tv[f] += t_new * v;
+    }
+    tr->head = (uint8_t)((tr->head + 1) % MOOD_TREND_WINDOW);
+}
+
+static float slope_per_s(const mood_trend_t *tr, int f)
+{
+    if (tr->count < MOOD_TREND_MIN_SAMPLES) {
+        return 0.0f;
+    }
+    double n = tr->count;
+    double den = n * tr->sum_tt - tr->sum_t * tr->sum_t;
+    if (den < 1.0) {
+        return 0.0f;  // All samples at (nearly) the same time
+    }
+    return (float)((n * tr->sum_tv[f] - tr->sum_t * tr->sum_v[f]) / den);
+}
+
+extern "C" bool mood_trend_stat(const mood_trend_t *tr, int f, mood_trend_stat_t *out)
+{
+    if (tr->count == 0 || f < 0 || f >= MOOD_TREND_FACTORS) {
+        return false;
+    }
+    uint8_t last = (uint8_t)((tr->head + MOOD_TREND_WINDOW - 1) % MOOD_TREND_WINDOW);
+    out->mean = (float)(tr->sum_v[f] / tr->count);
+    out->slope_per_day = slope_per_s(tr, f) * 86400.0f;
+    out->ema = tr->ema[f];
+    out->latest = tr->v[last][f];
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FORECAST
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    uint32_t dt;               // Seconds from now
+    uint8_t factor;
+} crossing_t;
+
+#define MAX_CROSSINGS (MOOD_FACTOR_COUNT * MOOD_BANDS)
+
+// Heading away from the ideal band (a value below it that rises is
+// recovering, not worsening)
+static inline bool worsening(const mood_band_table_t *t, float v, float slope)
+{
+    return (slope > 0.0f && t->high[0] < MOOD_NO_LIMIT && v >= t->low[0]) ||
+           (slope < 0.0f && t->low[0] > -MOOD_NO_LIMIT && v <= t->high[0]);
+}
+
+static void add_crossing(crossing_t *list, int *n, double dt, int factor)
+{
+    if (dt <= 0.0 || dt >= (double)MOOD_TREND_HORIZON_S || *n >= MAX_CROSSINGS) {
+        return;
+    }
+    // One second past the limit so inclusive edges are crossed too
+    list[(*n)++] = { (uint32_t)ceil(dt) + 1, (uint8_t)factor };
+}
+
+extern "C" mood_forecast_t mood_trend_forecast(const mood_trend_t *tr, const aquarium_params_t *p, uint32_t now)
+{
+    const mood_band_table_t *t = mood_engine_preset()->factor;
+    mood_forecast_t fc = {};
+    fc.to_sad_s = MOOD_FORECAST_NONE;
+    fc.to_angry_s = MOOD_FORECAST_NONE;
+    fc.sad_factor = 0xFF;
+    fc.angry_factor = 0xFF;
+    fc.samples = tr->count;
+    fc.timestamp = now;
+
+    mood_result_t cur = mood_engine_evaluate(p, now);
+    fc.category = cur.category;
+    if (cur.category >= 1) fc.to_sad_s = 0;
+    if (cur.category >= 2) fc.to_angry_s = 0;
+    if (cur.category >= 2) {
+        return fc;
+    }
+
+    // Every future band crossing: water factors along their slope (only
+    // the ones getting worse - improvement is not banked on), the feed and
+    // clean clocks exactly
+    float slope[MOOD_TREND_FACTORS];
+    bool moving[MOOD_TREND_FACTORS];
+    crossing_t list[MAX_CROSSINGS];
+    int n = 0;
+    for (int f = 0; f < MOOD_TREND_FACTORS; f++) {
+        slope[f] = slope_per_s(tr, f);
+        fc.slope_per_day[f] = slope[f] * 86400.0f;
+        float v = water_value(p, f);
+        moving[f] = worsening(&t[f], v, slope[f]);
+        for (int b = 0; moving[f] && b < MOOD_BANDS; b++) {
+            float limit = slope[f] > 0.0f ? t[f].high[b] : t[f].low[b];
+            add_crossing(list, &n, (limit - v) / slope[f], f);
+        }
+    }
+    const float scale[2] = { (float)p->planned_feed_interval,
+                             (float)(p->planned_water_change_interval * 86400) };
+    const uint32_t since[2] = { now - p->last_feed_time, now - p->last_clean_time };
+    for (int i = 0; i < 2; i++) {
+        int f = MOOD_FACTOR_FEED + i;
+        for (int b = 0; b < MOOD_BANDS; b++) {
+            add_crossing(list, &n, (double)t[f].high[b] * scale[i] - since[i], f);
+        }
+    }
+
+    // Walk the crossings in time order; scores only get worse along the
+    // way, so the first hit of each category is the answer
+    for (int i = 1; i < n; i++) {
+        crossing_t c = list[i];
+        int j = i - 1;
+        for (; j >= 0 && list[j].dt > c.dt; j--) {
+            list[j + 1] = list[j];
+        }
+        list[j + 1] = c;
+    }
+    for (int i = 0; i < n; i++) {
+        aquarium_params_t future = *p;
+        for (int f = 0; f < MOOD_TREND_FACTORS; f++) {
+            if (moving[f]) {
+                set_water_value(&future, f, water_value(p, f) + slope[f] * (float)list[i].dt);
+            }
+        }
+        mood_result_t r = mood_engine_evaluate(&future, now + list[i].dt);
+        if (r.category >= 1 && fc.to_sad_s == MOOD_FORECAST_NONE) {
+            fc.to_sad_s = list[i].dt;
+            fc.sad_factor = list[i].factor;
+        }
+        if (r.category >= 2) {
+            fc.to_angry_s = list[i].dt;
+            fc.angry_factor = list[i].factor;
+            break;
+        }
+    }
+    return fc;
+}
+
+static int format_duration(char *buf, size_t len, uint32_t s)
+{
+    if (s < 2 * 3600) {
+        return snprintf(buf, len, "%lu min", (unsigned long)((s + 59) / 60));
+    }
+    if (s < 48 * 3600) {
+        return snprintf(buf, len, "%.1f h", s / 3600.0f);
+    }
+    return snprintf(buf, len, "%.1f days", s / 86400.0f);
+}
+
+static int format_cause(char *buf, size_t len, const mood_forecast_t *fc, uint8_t factor)
+{
+    if (factor >= MOOD_FACTOR_COUNT) {
+        return snprintf(buf, len, "-");
+    }
+    if (factor < MOOD_TREND_FACTORS) {
+        float slope = fc->slope_per_day[factor];
+        return snprintf(buf, len, "%s %s %.2f%s%s/day", FACTOR_NAMES[factor],
+                        slope > 0.0f ? "rising" : "falling", fabsf(slope),
+                        FACTOR_UNITS[factor][0] ? " " : "", FACTOR_UNITS[factor]);
+    }
+    return snprintf(buf, len, "%s due", FACTOR_NAMES[factor]);
+}
+
+extern "C" size_t mood_trend_format_forecast(const mood_forecast_t *fc, char *buf, size_t len)
+{
+    if (buf == NULL || len == 0) {
+        return 0;
+    }
+    buf[0] = '\0';
+
+    char when[24], cause[64];
+    size_t used = 0;
+    if (fc->to_sad_s != MOOD_FORECAST_NONE && fc->to_sad_s > 0) {
+        format_duration(when, sizeof(when), fc->to_sad_s);
+        format_cause(cause, sizeof(cause), fc, fc->sad_factor);
+        int w = snprintf(buf, len, "⏳ Forecast: SAD in ~%s (%s)", when, cause);
+        used = w < 0 ? 0 : ((size_t)w < len ? (size_t)w : len - 1);
+    }
+    if (fc->to_angry_s != MOOD_FORECAST_NONE && fc->to_angry_s > 0 && used < len - 1) {
+        format_duration(when, sizeof(when), fc->to_angry_s);
+        format_cause(cause, sizeof(cause), fc, fc->angry_factor);
+        int w = snprintf(buf + used, len - used, "%sANGRY in ~%s (%s)",
+                         used ? ", " : "⏳ Forecast: ", when, cause);
+        if (w > 0) {
+            used += ((size_t)w < len - used) ? (size_t)w : len - used - 1;
+        }
+    }
+    // Drift below the thresholds (mood_drift.h): worth a word before any band
+    bool listed = false;
+    for (int f = 0; f < MOOD_TREND_FACTORS && used < len - 1; f++) {
+        if (fc->drift_mask & (1u << f)) {
+            int w = snprintf(buf + used, len - used, "%s%s %s unusually (z %+d)",
+                             listed ? ", " : (used ? "; Drift: " : "Drift: "), FACTOR_NAMES[f],
+                             fc->drift_z[f] < 0 ? "falling" : "rising", fc->drift_z[f]);
+            if (w > 0) {
+                used += ((size_t)w < len - used) ? (size_t)w : len - used - 1;
+            }
+            listed = true;
+        }
+    }
+    return used;
+}
+
+// Latest forecast, written by logic_task and read by the AI worker
+static portMUX_TYPE latest_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool latest_valid = false;
+static mood_forecast_t latest_forecast;
+
+extern "C" void mood_trend_set_latest(const mood_forecast_t *fc)
+{
+    portENTER_CRITICAL(&latest_lock);
+    latest_forecast = *fc;
+    latest_valid = true;
+    portEXIT_CRITICAL(&latest_lock);
+}
+
+extern "C" bool mood_trend_get_latest(mood_forecast_t *out)
+{
+    portENTER_CRITICAL(&latest_lock);
+    bool valid = latest_valid;
+    *out = latest_forecast;
+    portEXIT_CRITICAL(&latest_lock);
+    return valid;
+}
@@ -0,0 +1,92 @@
+#ifndef __MOOD_TREND_H__
+#define __MOOD_TREND_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "aquarium_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PARAMETER TRENDS AND PREDICTED MOOD
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// The logic task feeds every new water test (ammonia, nitrite, nitrate,
+// pH) into a fixed ring of the last MOOD_TREND_WINDOW samples. Per factor
+// it keeps, updated in O(1) per sample:
+//   - running sums for the window mean and least-squares slope
+//   - a time-weighted exponential moving average (time constant
+//     MOOD_TREND_EMA_TAU_S, so irregular test times weigh correctly)
+//
+// mood_trend_forecast() extrapolates the latest values along their slopes
+// (only factors that are getting worse) together with the clock-driven
+// feed / clean factors, and reports when the mood would reach SAD and
+// ANGRY within the horizon.
+
+#define MOOD_TREND_WINDOW         16
+#define MOOD_TREND_FACTORS        4        // Water factors (mood_factor_t 0..3)
+#define MOOD_TREND_MIN_SAMPLES    3        // Fewer: no slope, no extrapolation
+#define MOOD_TREND_EMA_TAU_S      86400    // EMA time constant (1 day)
+#define MOOD_TREND_HORIZON_S      (7 * 86400)
+
+typedef struct {
+    float mean;                // Window mean
+    float slope_per_day;       // Least-squares slope over the window
+    float ema;                 // Time-weighted moving average
+    float latest;
+} mood_trend_stat_t;
+
+typedef struct {
+    uint32_t t[MOOD_TREND_WINDOW];                    // Sample times (seconds since boot)
+    float v[MOOD_TREND_WINDOW][MOOD_TREND_FACTORS];
+    uint8_t head;              // Next slot to write
+    uint8_t count;
+    uint32_t base_t;           // Time origin of the running sums
+    double sum_t, sum_tt;      // Shared by all factors
+    double sum_v[MOOD_TREND_FACTORS], sum_tv[MOOD_TREND_FACTORS];
+    float ema[MOOD_TREND_FACTORS];
+} mood_trend_t;
+
+/**
+ * @brief Add a water test (only the four water factors are used)
+ */
+void mood_trend_add(mood_trend_t *trend, const aquarium_params_t *params, uint32_t now);
+
+/**
+ * @brief Window statistics of one water factor
+ * @return false if the window is empty or factor is not a water factor
+ */
+bool mood_trend_stat(const mood_trend_t *trend, int factor, mood_trend_stat_t *out);
+
+/**
+ * @brief Predict when the mood reaches SAD / ANGRY
+ * @param params Current inputs (the feed / clean clocks come from here)
+ */
+mood_forecast_t mood_trend_forecast(const mood_trend_t *trend, const aquarium_params_t *params, uint32_t now);
+
+/**
+ * @brief One-line early warning, drifting factors included ("" when
+ *        nothing is expected)
+ * @return Length written
+ */
+size_t mood_trend_format_forecast(const mood_forecast_t *forecast, char *buf, size_t len);
+
+/**
+ * @brief Remember the latest forecast (logic_task)
+ */
+void mood_trend_set_latest(const mood_forecast_t *forecast);
+
+/**
+ * @brief Copy the latest forecast; any task
+ * @return false before the first forecast
+ */
+bool mood_trend_get_latest(mood_forecast_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
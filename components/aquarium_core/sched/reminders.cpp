@@ -0,0 +1,434 @@
+#include "reminders.h"
+#include "timer_wheel.h"
+#include "med/med_db.h"
+#include "time_svc.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "reminders";
+
+static_assert(REMINDER_NAME_LEN == MED_DB_NAME_LEN, "a course carries a med_db product name");
+
+typedef struct {
+    timer_wheel_node_t node;            // First: the wheel hands this back
+    uint8_t kind;                       // reminder_kind_t
+    uint8_t slot;
+    uint8_t tank;                       // Feed / water change
+} entry_t;
+
+typedef struct {
+    entry_t dose;
+    entry_t retest;
+    char name[REMINDER_NAME_LEN];
+    uint32_t first;                     // Seconds since boot of dose 1
+    uint32_t every_s;
+    uint8_t doses;
+    uint8_t next;                       // Dose the pending timer is for
+} course_t;
+
+// NVS record of a course; dose times follow from first_wall
+typedef struct {
+    char name[REMINDER_NAME_LEN];
+    uint32_t first_wall;                // 0 = slot unused
+    uint32_t every_s;
+    uint8_t doses;
+    uint8_t reserved[3];
+} course_store_t;
+
+typedef struct {
+    uint8_t hour;
+    uint8_t minute;
+    bool enabled;
+} feed_time_t;
+
+static SemaphoreHandle_t lock = NULL;
+static reminders_sink_t sink = NULL;
+static esp_timer_handle_t wheel_timer = NULL;
+static timer_wheel_t wheel;
+static entry_t feed[TANK_MAX][REMINDER_FEED_SLOTS];
+static feed_time_t feed_time[TANK_MAX][REMINDER_FEED_SLOTS];
+static entry_t water[TANK_MAX];
+static course_t courses[REMINDER_COURSES];
+static bool courses_restored = false;
+static uint32_t fired[REMINDER_KIND_COUNT];
+
+/**
+ * @brief Seconds since boot of the next local hour:minute, 0 without a wall clock
+ */
+static uint32_t next_local(uint8_t hour, uint8_t minute)
+{
+    struct tm tm;
+    if (!time_svc_local(&tm)) {
+        return 0;
+    }
+    time_t now = mktime(&tm);
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_sec = 0;
+    tm.tm_isdst = -1;
+    time_t at = mktime(&tm);
+    if (at <= now) {
+        tm.tm_mday++;                   // mktime() normalises, across DST too
+        tm.tm_isdst = -1;
+        at = mktime(&tm);
+    }
+    return time_svc_wall_to_uptime(at);
+}
+
+/**
+ * @brief Arm the timer for the wheel's next expiry (lock held)
+ */
+static void arm(void)
+{
+    esp_timer_stop(wheel_timer);
+    uint32_t next = timer_wheel_next(&wheel);
+    if (next == UINT32_MAX) {
+        return;
+    }
+    int64_t delay_us = (int64_t)next * 1000000 - esp_timer_get_time();
+    esp_timer_start_once(wheel_timer, delay_us > 0 ? (uint64_t)delay_us : 0);
+}
+
+static void arm_feed(uint8_t tank, uint8_t slot)
+{
+    const feed_time_t *f = &feed_time[tank][slot];
+    uint32_t at = f->enabled ? next_local(f->hour, f->minute) : 0;
+    if (at != 0) {
+        timer_wheel_add(&wheel, &feed[tank][slot].node, at);
+    } else {
+        timer_wheel_cancel(&wheel, &feed[tank][slot].node);
+    }
+}
+
+static void arm_dose(course_t *c)
+{
+    timer_wheel_add(&wheel, &c->dose.node, c->first + (uint32_t)(c->next - 1) * c->every_s);
+}
+
+/**
+ * @brief Wheel callback: publish, then re-arm what repeats (lock held)
+ */
+static void on_fire(timer_wheel_node_t *node, void *arg)
+{
+    entry_t *e = (entry_t *)node;
+    uint32_t now = *(const uint32_t *)arg;
+    reminder_event_t ev = {};
+    ev.kind = e->kind;
+    ev.slot = e->slot;
+    ev.tank = e->tank;
+    ev.due = node->expires;
+    ev.late_s = now - node->expires;
+
+    switch (e->kind) {
+        case REMINDER_FEED:
+            ev.hour = feed_time[e->tank][e->slot].hour;
+            ev.minute = feed_time[e->tank][e->slot].minute;
+            arm_feed(e->tank, e->slot);
+            break;
+        case REMINDER_MED_DOSE: {
+            course_t *c = &courses[e->slot];
+            ev.dose = c->next;
+            ev.doses = c->doses;
+            memcpy(ev.name, c->name, sizeof(ev.name));
+            if (++c->next <= c->doses) {
+                arm_dose(c);
+            } else {
+                timer_wheel_add(&wheel, &c->retest.node,
+                                node->expires + (uint32_t)CONFIG_GOLDIE_RETEST_AFTER_H * 3600);
+            }
+            break;
+        }
+        case REMINDER_RETEST:
+            memcpy(ev.name, courses[e->slot].name, sizeof(ev.name));
+            break;
+        default:
+            break;
+    }
+    fired[e->kind]++;
+    char line[80];
+    reminders_format(&ev, line, sizeof(line));
+    ESP_LOGI(TAG, "%s%s", line, ev.late_s > 1 ? " (late)" : "");
+    if (sink != NULL) {
+        sink(&ev);
+    }
+}
+
+static void wheel_timer_cb(void *arg)
+{
+    xSemaphoreTake(lock, portMAX_DELAY);
+    uint32_t now = time_svc_uptime_s();
+    timer_wheel_advance(&wheel, now, on_fire, &now);
+    arm();
+    xSemaphoreGive(lock);
+}
+
+static void courses_save(void)
+{
+    course_store_t store[REMINDER_COURSES] = {};
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (int i = 0; i < REMINDER_COURSES; i++) {
+        const course_t *c = &courses[i];
+        if (c->doses == 0) {
+            continue;
+        }
+        memcpy(store[i].name, c->name, sizeof(store[i].name));
+        store[i].first_wall = (uint32_t)time_svc_uptime_to_wall(c->first);
+        store[i].every_s = c->every_s;
+        store[i].doses = c->doses;
+    }
+    xSemaphoreGive(lock);
+
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(REMINDER_NVS_NS, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, REMINDER_NVS_KEY, store, sizeof(store));
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Saving courses failed (%s) - they end with this boot", esp_err_to_name(err));
+    }
+}
+
+/**
+ * @brief Resume stored courses at their next dose (wall clock set)
+ */
+static void courses_restore(void)
+{
+    course_store_t store[REMINDER_COURSES];
+    size_t len = sizeof(store);
+    nvs_handle_t nvs;
+    if (nvs_open(REMINDER_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+        return;
+    }
+    esp_err_t err = nvs_get_blob(nvs, REMINDER_NVS_KEY, store, &len);
+    nvs_close(nvs);
+    if (err != ESP_OK || len != sizeof(store)) {
+        return;
+    }
+
+    uint32_t now = time_svc_uptime_s();
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (int i = 0; i < REMINDER_COURSES; i++) {
+        const course_store_t *s = &store[i];
+        course_t *c = &courses[i];
+        if (s->first_wall == 0 || s->every_s == 0 || s->doses < 2 || c->doses != 0) {
+            continue;
+        }
+        memcpy(c->name, s->name, sizeof(c->name));
+        c->name[sizeof(c->name) - 1] = '\0';
+        c->first = time_svc_wall_to_uptime((time_t)s->first_wall);
+        c->every_s = s->every_s;
+        c->doses = s->doses;
+        // Next dose still ahead; the re-test if only that is left
+        uint32_t since = now - c->first;
+        uint32_t next = since / c->every_s + 2;
+        if (next <= c->doses) {
+            c->next = (uint8_t)next;
+            arm_dose(c);
+            ESP_LOGI(TAG, "Course '%s' resumed at dose %u of %u", c->name, c->next, c->doses);
+            continue;
+        }
+        c->next = c->doses + 1;
+        uint32_t retest = c->first + (uint32_t)(c->doses - 1) * c->every_s + (uint32_t)CONFIG_GOLDIE_RETEST_AFTER_H * 3600;
+        if ((int32_t)(retest - now) > 0) {
+            timer_wheel_add(&wheel, &c->retest.node, retest);
+        }
+    }
+    arm();
+    xSemaphoreGive(lock);
+}
+
+extern "C" void reminders_init(reminders_sink_t on_due)
+{
+    if (lock != NULL) {
+        return;
+    }
+    sink = on_due;
+    lock = xSemaphoreCreateMutex();
+    const esp_timer_create_args_t args = {
+        .callback = wheel_timer_cb,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "reminders",
+        .skip_unhandled_events = true,
+    };
+    if (lock == NULL || esp_timer_create(&args, &wheel_timer) != ESP_OK) {
+        ESP_LOGE(TAG, "No lock / timer - reminders off");
+        if (lock != NULL) {
+            vSemaphoreDelete(lock);
+            lock = NULL;
+        }
+        return;
+    }
+
+    timer_wheel_init(&wheel, time_svc_uptime_s());
+    for (uint8_t t = 0; t < TANK_MAX; t++) {
+        for (uint8_t i = 0; i < REMINDER_FEED_SLOTS; i++) {
+            feed[t][i] = { {}, REMINDER_FEED, i, t };
+        }
+        water[t] = { {}, REMINDER_WATER_CHANGE, 0, t };
+    }
+    for (uint8_t i = 0; i < REMINDER_COURSES; i++) {
+        courses[i].dose = { {}, REMINDER_MED_DOSE, i, 0 };
+        courses[i].retest = { {}, REMINDER_RETEST, i, 0 };
+    }
+    if (time_svc_wall_valid()) {
+        courses_restored = true;
+        courses_restore();
+    }
+    ESP_LOGI(TAG, "Reminder wheel ready (%d levels x %u slots, 1 s ticks)", TIMER_WHEEL_LEVELS,
+             (unsigned)TIMER_WHEEL_SLOTS);
+}
+
+extern "C" void reminders_set_feed(uint8_t tank, uint8_t slot, bool enabled, uint8_t hour, uint8_t minute)
+{
+    if (lock == NULL || tank >= TANK_MAX || slot >= REMINDER_FEED_SLOTS) {
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    feed_time_t *f = &feed_time[tank][slot];
+    // Unchanged and armed: leave it (the dashboard re-sends on every edit)
+    if (f->enabled != enabled || f->hour != hour || f->minute != minute ||
+        enabled != timer_wheel_pending(&feed[tank][slot].node)) {
+        f->enabled = enabled;
+        f->hour = hour;
+        f->minute = minute;
+        arm_feed(tank, slot);
+        arm();
+    }
+    xSemaphoreGive(lock);
+}
+
+extern "C" void reminders_set_water_due(uint8_t tank, uint32_t due)
+{
+    if (lock == NULL || tank >= TANK_MAX) {
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    timer_wheel_node_t *node = &water[tank].node;
+    if (due == 0) {
+        timer_wheel_cancel(&wheel, node);
+    } else if (!timer_wheel_pending(node) || node->expires != due) {
+        // Only ahead of us: an overdue date was already reminded
+        if ((int32_t)(due - time_svc_uptime_s()) > 0) {
+            timer_wheel_add(&wheel, node, due);
+        } else {
+            timer_wheel_cancel(&wheel, node);
+        }
+    }
+    arm();
+    xSemaphoreGive(lock);
+}
+
+extern "C" bool reminders_start_course(const char *name, uint32_t every_s, uint8_t doses)
+{
+    if (lock == NULL || every_s == 0 || doses < 2) {
+        return false;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    course_t *c = NULL;
+    for (int i = 0; i < REMINDER_COURSES && c == NULL; i++) {
+        if (courses[i].doses != 0 && strncmp(courses[i].name, name, sizeof(courses[i].name) - 1) == 0) {
+            c = &courses[i];
+        }
+    }
+    for (int i = 0; i < REMINDER_COURSES && c == NULL; i++) {
+        if (!timer_wheel_pending(&courses[i].dose.node) && !timer_wheel_pending(&courses[i].retest.node)) {
+            c = &courses[i];
+        }
+    }
+    if (c == NULL) {
+        c = &courses[0];
+        for (int i = 1; i < REMINDER_COURSES; i++) {
+            if ((int32_t)(courses[i].first - c->first) < 0) {
+                c = &courses[i];
+            }
+        }
+        ESP_LOGW(TAG, "Course '%s' replaced by '%s'", c->name, name);
+    }
+    timer_wheel_cancel(&wheel, &c->retest.node);
+    snprintf(c->name, sizeof(c->name), "%s", name);
+    c->first = time_svc_uptime_s();
+    c->every_s = every_s;
+    c->doses = doses;
+    c->next = 2;
+    arm_dose(c);
+    arm();
+    xSemaphoreGive(lock);
+
+    ESP_LOGI(TAG, "Course '%s': %u doses, every %lu h", name, doses, (unsigned long)(every_s / 3600));
+    courses_save();
+    return true;
+}
+
+extern "C" void reminders_clock_changed(void)
+{
+    if (lock == NULL) {
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (uint8_t t = 0; t < TANK_MAX; t++) {
+        for (uint8_t i = 0; i < REMINDER_FEED_SLOTS; i++) {
+            arm_feed(t, i);
+        }
+    }
+    arm();
+    bool restore = !courses_restored && time_svc_wall_valid();
+    courses_restored = courses_restored || restore;
+    xSemaphoreGive(lock);
+    if (restore) {
+        courses_restore();
+    }
+}
+
+extern "C" size_t reminders_format(const reminder_event_t *ev, char *buf, size_t size)
+{
+    // Which tank, once there is more than one
+    char tank[12] = "";
+    if (TANK_MAX > 1) {
+        snprintf(tank, sizeof(tank), "Tank %u: ", ev->tank + 1);
+    }
+    int n;
+    switch (ev->kind) {
+        case REMINDER_FEED:
+            n = snprintf(buf, size, "%sFeeding time (%02u:%02u)", tank, ev->hour, ev->minute);
+            break;
+        case REMINDER_WATER_CHANGE:
+            n = snprintf(buf, size, "%sWater change due", tank);
+            break;
+        case REMINDER_MED_DOSE:
+            n = snprintf(buf, size, "Dose %u of %u: %s", ev->dose, ev->doses, ev->name);
+            break;
+        case REMINDER_RETEST:
+            n = snprintf(buf, size, "Re-test the water after %s", ev->name);
+            break;
+        default:
+            n = snprintf(buf, size, "Reminder");
+            break;
+    }
+    return n > 0 ? ((size_t)n < size ? (size_t)n : size - 1) : 0;
+}
+
+extern "C" void reminders_log_stats(void)
+{
+    if (lock == NULL) {
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    uint32_t pending = wheel.count;
+    uint32_t next = timer_wheel_next(&wheel);
+    xSemaphoreGive(lock);
+    uint32_t now = time_svc_uptime_s();
+    ESP_LOGI(TAG, "%lu pending, next in %ld s; fired: %lu feed, %lu water, %lu dose, %lu re-test",
+             (unsigned long)pending, next == UINT32_MAX ? -1L : (long)(int32_t)(next - now),
+             (unsigned long)fired[REMINDER_FEED], (unsigned long)fired[REMINDER_WATER_CHANGE],
+             (unsigned long)fired[REMINDER_MED_DOSE], (unsigned long)fired[REMINDER_RETEST]);
+}
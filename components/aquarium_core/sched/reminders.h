@@ -0,0 +1,101 @@
+#ifndef __REMINDERS_H__
+#define __REMINDERS_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "aquarium_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// REMINDERS - EVERY UPCOMING TANK EVENT IN ONE TIMER WHEEL
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Feeds of the daily schedule, the water change due date, the next dose of
+// each medication course and the water re-test after a course are timers
+// of one timer wheel (timer_wheel.h) in seconds since boot. One esp_timer
+// is armed for the wheel's next expiry, so nothing polls: at that instant
+// the wheel advances, and each reminder due is handed once to the sink
+// given to reminders_init(). The task coordinator's sink publishes it on
+// MSG_TOPIC_REMINDER (dashboard banner and mood re-evaluation, Blynk).
+//
+//   feed     every day at its local time, re-armed from the local clock
+//            after it fires (DST-safe); needs the wall clock
+//   water    once, at the last water change + the interval
+//   dose     dose 2..N of a course, every_s apart from the first; the
+//            last one arms the re-test CONFIG_GOLDIE_RETEST_AFTER_H later
+//
+// Feeds and the water change are kept per tank (TANK_MAX); the event says
+// whose it is.
+//
+// Setting a reminder again replaces it; each change is O(1). Courses are
+// kept in NVS (namespace "goldie_rem") as wall time and resume after a
+// reboot at their next dose; doses that fell due while the device was off
+// are not reminded. The owner re-sends the feed schedule and water date
+// whenever they change (the dashboard: with every state change).
+//
+// Any task. The sink runs on the esp_timer task with the wheel locked, so
+// it must not call back into reminders_*().
+
+#ifndef CONFIG_GOLDIE_RETEST_AFTER_H
+#define CONFIG_GOLDIE_RETEST_AFTER_H 24
+#endif
+
+#define REMINDER_FEED_SLOTS  6          // DASH_STATE_FEED_TIMES
+#define REMINDER_COURSES     2          // Medication courses at once
+#define REMINDER_NVS_NS      "goldie_rem"
+#define REMINDER_NVS_KEY     "courses"
+
+// Where a reminder goes once it is due
+typedef void (*reminders_sink_t)(const reminder_event_t *ev);
+
+/**
+ * @brief Create the wheel and its timer, restore stored courses
+ * @param sink Called with each reminder as it fires (NULL: only logged)
+ */
+void reminders_init(reminders_sink_t sink);
+
+/**
+ * @brief Set one feed of a tank's daily schedule (local time)
+ */
+void reminders_set_feed(uint8_t tank, uint8_t slot, bool enabled, uint8_t hour, uint8_t minute);
+
+/**
+ * @brief Set when a tank's next water change is due (seconds since boot, 0 = none)
+ */
+void reminders_set_water_due(uint8_t tank, uint32_t due);
+
+/**
+ * @brief Start a course whose first dose is given now
+ *
+ * A running course of the same product is restarted; with every slot
+ * taken, the one that started first is replaced.
+ * @return false if doses < 2 or every_s is 0
+ */
+bool reminders_start_course(const char *name, uint32_t every_s, uint8_t doses);
+
+/**
+ * @brief The wall clock was set or TZ changed: re-arm the feeds, and
+ *        restore stored courses if the clock was not set at init
+ */
+void reminders_clock_changed(void);
+
+/**
+ * @brief One line for a reminder ("Dose 2 of 5: Antibiotics")
+ * @return Length written
+ */
+size_t reminders_format(const reminder_event_t *ev, char *buf, size_t size);
+
+/**
+ * @brief Log pending reminders and how many fired
+ */
+void reminders_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __REMINDERS_H__
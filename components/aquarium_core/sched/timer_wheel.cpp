@@ -0,0 +1,192 @@
+#include "timer_wheel.h"
+
+#define SLOT_MASK  (TIMER_WHEEL_SLOTS - 1)
+
+static inline void list_init(timer_wheel_node_t *head)
+{
+    head->next = head;
+    head->prev = head;
+}
+
+static inline bool list_empty(const timer_wheel_node_t *head)
+{
+    return head->next == head;
+}
+
+static inline uint64_t rotr64(uint64_t v, unsigned n)
+{
+    return n ? (v >> n) | (v << (64 - n)) : v;
+}
+
+/**
+ * @brief Level / slot of a list head inside w->slot, -1 for the due list
+ */
+static inline int slot_of(const timer_wheel_t *w, const timer_wheel_node_t *head)
+{
+    ptrdiff_t i = head - &w->slot[0][0];
+    return i >= 0 && i < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS ? (int)i : -1;
+}
+
+static void unlink(timer_wheel_t *w, timer_wheel_node_t *node)
+{
+    timer_wheel_node_t *prev = node->prev;
+    node->prev->next = node->next;
+    node->next->prev = prev;
+    node->next = NULL;
+    node->prev = NULL;
+    w->count--;
+    // Emptied a slot: only its head is left, on both sides
+    if (prev->next == prev) {
+        int i = slot_of(w, prev);
+        if (i >= 0) {
+            w->occupied[i / TIMER_WHEEL_SLOTS] &= ~(1ull << (i % TIMER_WHEEL_SLOTS));
+        }
+    }
+}
+
+/**
+ * @brief Link a node into the slot its remaining time belongs to
+ */
+static void place(timer_wheel_t *w, timer_wheel_node_t *node)
+{
+    uint32_t delta = node->expires - w->now;
+    timer_wheel_node_t *head = &w->due;
+    if ((int32_t)delta > 0) {
+        if (delta >= TIMER_WHEEL_SPAN) {
+            delta = TIMER_WHEEL_SPAN - 1;   // Waits in the top level, re-placed on its cascade
+        }
+        int level = 0;
+        while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1u << (TIMER_WHEEL_BITS * (level + 1)))) {
+            level++;
+        }
+        unsigned idx = ((w->now + delta) >> (TIMER_WHEEL_BITS * level)) & SLOT_MASK;
+        head = &w->slot[level][idx];
+        w->occupied[level] |= 1ull << idx;
+    }
+    node->next = head;
+    node->prev = head->prev;
+    head->prev->next = node;
+    head->prev = node;
+    w->count++;
+}
+
+/**
+ * @brief Move a slot's timers down to the levels they now belong to
+ */
+static void cascade(timer_wheel_t *w, int level, unsigned idx)
+{
+    timer_wheel_node_t *head = &w->slot[level][idx];
+    timer_wheel_node_t list;
+    if (list_empty(head)) {
+        return;
+    }
+    list.next = head->next;
+    list.prev = head->prev;
+    list.next->prev = &list;
+    list.prev->next = &list;
+    list_init(head);
+    w->occupied[level] &= ~(1ull << idx);
+    while (!list_empty(&list)) {
+        timer_wheel_node_t *node = list.next;
+        list.next = node->next;
+        node->next->prev = &list;
+        w->count--;
+        place(w, node);
+    }
+}
+
+/**
+ * @brief Fire every node of a list (the list may be refilled meanwhile)
+ */
+static size_t fire_list(timer_wheel_t *w, timer_wheel_node_t *head, timer_wheel_fire_t fire, void *arg)
+{
+    size_t n = 0;
+    while (!list_empty(head)) {
+        timer_wheel_node_t *node = head->next;
+        unlink(w, node);
+        fire(node, arg);
+        n++;
+    }
+    return n;
+}
+
+extern "C" void timer_wheel_init(timer_wheel_t *w, uint32_t now)
+{
+    w->now = now;
+    w->count = 0;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        w->occupied[level] = 0;
+        for (unsigned i = 0; i < TIMER_WHEEL_SLOTS; i++) {
+            list_init(&w->slot[level][i]);
+        }
+    }
+    list_init(&w->due);
+}
+
+extern "C" void timer_wheel_add(timer_wheel_t *w, timer_wheel_node_t *node, uint32_t expires)
+{
+    if (timer_wheel_pending(node)) {
+        unlink(w, node);
+    }
+    node->expires = expires;
+    place(w, node);
+}
+
+extern "C" void timer_wheel_cancel(timer_wheel_t *w, timer_wheel_node_t *node)
+{
+    if (timer_wheel_pending(node)) {
+        unlink(w, node);
+    }
+}
+
+extern "C" size_t timer_wheel_advance(timer_wheel_t *w, uint32_t now, timer_wheel_fire_t fire, void *arg)
+{
+    size_t fired = fire_list(w, &w->due, fire, arg);
+    while ((int32_t)(now - w->now) > 0) {
+        // Jump to the next occupied level-0 slot, the next wrap or `now`
+        uint32_t t = w->now + 1;
+        unsigned idx = t & SLOT_MASK;
+        if (idx != 0) {
+            uint64_t ahead = w->occupied[0] >> idx;
+            uint32_t skip = ahead ? (uint32_t)__builtin_ctzll(ahead) : TIMER_WHEEL_SLOTS - idx;
+            uint32_t left = now - t;
+            t += skip < left ? skip : left;
+            idx = t & SLOT_MASK;
+        }
+        w->now = t;
+
+        // Wrapped: cascade the current slot of each level whose digit rolled over
+        for (int level = 1; idx == 0 && level < TIMER_WHEEL_LEVELS; level++) {
+            idx = (t >> (TIMER_WHEEL_BITS * level)) & SLOT_MASK;
+            cascade(w, level, idx);
+        }
+        fired += fire_list(w, &w->slot[0][t & SLOT_MASK], fire, arg);
+        fired += fire_list(w, &w->due, fire, arg);
+    }
+    return fired;
+}
+
+extern "C" uint32_t timer_wheel_next(const timer_wheel_t *w)
+{
+    if (!list_empty(&w->due)) {
+        return w->now;
+    }
+    uint32_t best = UINT32_MAX;
+    bool found = false;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if (w->occupied[level] == 0) {
+            continue;
+        }
+        // First occupied slot after the current one; a level-0 slot
+        // expires at its tick, a higher one cascades when its digit comes up
+        unsigned shift = TIMER_WHEEL_BITS * level;
+        uint32_t cur = w->now >> shift;
+        uint64_t rot = rotr64(w->occupied[level], (cur + 1) & SLOT_MASK);
+        uint32_t at = (cur + 1 + (uint32_t)__builtin_ctzll(rot)) << shift;
+        if (!found || (int32_t)(at - best) < 0) {
+            best = at;
+            found = true;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,102 @@
+#ifndef __TIMER_WHEEL_H__
+#define __TIMER_WHEEL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// HIERARCHICAL TIMER WHEEL (ONE-SECOND TICKS)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// TIMER_WHEEL_LEVELS wheels of TIMER_WHEEL_SLOTS slots; level L holds the
+// timers due within 64^(L+1) ticks, in the slot of their expiry's L-th
+// 6-bit digit:
+//
+//   level 0   < 64 s        one slot per second
+//   level 1   < 68 min      one slot per 64 s
+//   level 2   < 72 h        one slot per 68 min
+//   level 3   < 194 days    one slot per 72 h (later expiries wait here)
+//
+// A timer is an intrusive node in its slot's list, so add and cancel are
+// O(1) and the wheel allocates nothing. When the level-0 wheel wraps, the
+// level-1 slot now current is cascaded: its timers move down to the level
+// their remaining time belongs to (and so on up). A timer is cascaded at
+// most once per level before it expires.
+//
+// The wheel never reads a clock: timer_wheel_advance() moves it to the
+// caller's tick, jumping over empty level-0 slots with the occupancy
+// bitmap, and timer_wheel_next() says when to call it again. Ticks are
+// uint32_t and compared by difference. Not thread-safe; the owner locks.
+
+#define TIMER_WHEEL_BITS    6
+#define TIMER_WHEEL_SLOTS   (1u << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS  4
+#define TIMER_WHEEL_SPAN    (1u << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))  // Ticks the wheel can hold
+
+typedef struct timer_wheel_node {
+    struct timer_wheel_node *next;      // NULL: not in the wheel
+    struct timer_wheel_node *prev;
+    uint32_t expires;                   // Tick it fires at
+} timer_wheel_node_t;
+
+typedef struct {
+    uint32_t now;                       // Last tick advanced to
+    uint32_t count;                     // Timers in the wheel
+    uint64_t occupied[TIMER_WHEEL_LEVELS];  // Non-empty slots
+    timer_wheel_node_t slot[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];  // List heads
+    timer_wheel_node_t due;             // Added already expired: fire on the next advance
+} timer_wheel_t;
+
+typedef void (*timer_wheel_fire_t)(timer_wheel_node_t *node, void *arg);
+
+/**
+ * @brief Empty wheel at tick `now`
+ */
+void timer_wheel_init(timer_wheel_t *w, uint32_t now);
+
+/**
+ * @brief Schedule a node (re-schedules it if it is in the wheel)
+ *
+ * An expiry at or before the wheel's tick fires on the next advance.
+ */
+void timer_wheel_add(timer_wheel_t *w, timer_wheel_node_t *node, uint32_t expires);
+
+/**
+ * @brief Remove a node (nothing if it is not in the wheel)
+ */
+void timer_wheel_cancel(timer_wheel_t *w, timer_wheel_node_t *node);
+
+/**
+ * @brief true while the node is in the wheel
+ */
+static inline bool timer_wheel_pending(const timer_wheel_node_t *node)
+{
+    return node->next != NULL;
+}
+
+/**
+ * @brief Advance to tick `now`, calling fire for every node that expires
+ *
+ * Nodes are unlinked before fire is called, which may add them (or any
+ * other) again.
+ * @return Nodes fired
+ */
+size_t timer_wheel_advance(timer_wheel_t *w, uint32_t now, timer_wheel_fire_t fire, void *arg);
+
+/**
+ * @brief First tick at which an advance has work: an expiry, or the
+ *        cascade of a slot that holds one (then ask again after it)
+ * @return The wheel's tick if something is due, UINT32_MAX if empty
+ */
+uint32_t timer_wheel_next(const timer_wheel_t *w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TIMER_WHEEL_H__
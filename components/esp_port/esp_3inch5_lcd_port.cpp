@@ -10,6 +10,10 @@
 #include "esp_lcd_st7796.h"
 
 #include "esp_check.h"
+#include "hw_manifest.h"
+#include "esp_log.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -21,6 +25,8 @@
 
 #include <esp_attr.h>
 #include <esp_system.h>
+#include "sdkconfig.h"
+#include <atomic>
 
 #define EXAMPLE_SPI_HOST SPI2_HOST
 #define EXAMPLE_LCD_PIXEL_CLOCK_HZ (80 * 1000 * 1000)
@@ -33,8 +39,39 @@
 #define EXAMPLE_PIN_LCD_RST GPIO_NUM_NC
 #define EXAMPLE_PIN_LCD_BL GPIO_NUM_6
 
+#ifndef CONFIG_GOLDIE_LCD_TRANS_QUEUE_DEPTH
+#define CONFIG_GOLDIE_LCD_TRANS_QUEUE_DEPTH 16
+#endif
+#ifndef CONFIG_GOLDIE_LCD_MAX_TRANSFER_KB
+#define CONFIG_GOLDIE_LCD_MAX_TRANSFER_KB 32
+#endif
+
+// The SPI driver rounds the bus max_transfer_sz up to whole DMA descriptors
+// and esp_lcd splits color data by that rounded size, so the cap must be a
+// descriptor multiple or a chunk overshoots the 2^18-bit transaction limit
+#define LCD_DMA_DESC_BYTES 4092
+#define LCD_MAX_TRANSFER_BYTES ((CONFIG_GOLDIE_LCD_MAX_TRANSFER_KB * 1024 / LCD_DMA_DESC_BYTES) * LCD_DMA_DESC_BYTES)
+
+#ifndef CONFIG_GOLDIE_TOUCH_INT_GPIO
+#define CONFIG_GOLDIE_TOUCH_INT_GPIO -1
+#endif
+#ifndef CONFIG_GOLDIE_LCD_TE_GPIO
+#define CONFIG_GOLDIE_LCD_TE_GPIO -1
+#endif
+#ifndef CONFIG_GOLDIE_LCD_TE_EXPANDER_PIN
+#define CONFIG_GOLDIE_LCD_TE_EXPANDER_PIN -1
+#endif
+#ifndef CONFIG_GOLDIE_LCD_TE_WAIT_MS
+#define CONFIG_GOLDIE_LCD_TE_WAIT_MS 25
+#endif
+
+#define LCD_CMD_TEON        0x35
+#define LCD_TE_VBLANK_ONLY  0x00    // TEON parameter: TE high during vertical blanking
+
+// A wired INT line is serviced here (touch_int_isr), not by esp_lcd_touch
 #define EXAMPLE_PIN_TP_INT GPIO_NUM_NC
 #define EXAMPLE_PIN_TP_RST GPIO_NUM_NC
+#define TOUCH_FT6336_REG_G_MODE 0xA4     // 0: INT held low while touched
 
 #define LCD_BL_LEDC_TIMER LEDC_TIMER_1
 #define LCD_BL_LEDC_MODE LEDC_LOW_SPEED_MODE
@@ -58,10 +95,16 @@ void soft_reset_once(void)
     }
 }
 
-void esp_3inch5_display_port_init(esp_lcd_panel_io_handle_t *io_handle, esp_lcd_panel_handle_t *panel_handle, size_t max_transfer_sz)
+static esp_err_t display_init(esp_lcd_panel_io_handle_t *io_handle, esp_lcd_panel_handle_t *panel_handle, size_t max_transfer_sz)
 {
 
-    ESP_LOGI(TAG, "SPI BUS init");
+    // Larger flushes are sent as several back-to-back DMA transactions;
+    // only the last one raises on_color_trans_done
+    if (max_transfer_sz > LCD_MAX_TRANSFER_BYTES) {
+        max_transfer_sz = LCD_MAX_TRANSFER_BYTES;
+    }
+    ESP_LOGI(TAG, "SPI BUS init (%u-byte transactions, queue depth %d)",
+             (unsigned)max_transfer_sz, CONFIG_GOLDIE_LCD_TRANS_QUEUE_DEPTH);
     spi_bus_config_t buscfg = {};
     buscfg.sclk_io_num = EXAMPLE_PIN_LCD_SCLK;
     buscfg.mosi_io_num = EXAMPLE_PIN_LCD_MOSI;
@@ -70,7 +113,7 @@ void esp_3inch5_display_port_init(esp_lcd_panel_io_handle_t *io_handle, esp_lcd_
     buscfg.quadhd_io_num = -1;
     buscfg.max_transfer_sz = max_transfer_sz;
 
-    ESP_ERROR_CHECK(spi_bus_initialize(EXAMPLE_SPI_HOST, &buscfg, SPI_DMA_CH_AUTO));
+    ESP_RETURN_ON_ERROR(spi_bus_initialize(EXAMPLE_SPI_HOST, &buscfg, SPI_DMA_CH_AUTO), TAG, "spi bus");
     // soft_reset_once();
     ESP_LOGI(TAG, "Install panel IO");
     esp_lcd_panel_io_spi_config_t io_config = {};
@@ -78,13 +121,17 @@ void esp_3inch5_display_port_init(esp_lcd_panel_io_handle_t *io_handle, esp_lcd_
     io_config.dc_gpio_num = EXAMPLE_PIN_LCD_DC;
     io_config.spi_mode = 0;
     io_config.pclk_hz = EXAMPLE_LCD_PIXEL_CLOCK_HZ;
-    io_config.trans_queue_depth = 10;
+    io_config.trans_queue_depth = CONFIG_GOLDIE_LCD_TRANS_QUEUE_DEPTH;
+    // esp_lvgl_port registers its own on_color_trans_done when the display
+    // is added and calls lv_disp_flush_ready() from that ISR, so LVGL renders
+    // into the other draw buffer while this one is still on the bus
     io_config.on_color_trans_done = NULL;
     io_config.user_ctx = NULL;
     io_config.lcd_cmd_bits = 8;
     io_config.lcd_param_bits = 8;
     // Attach the LCD to the SPI bus
-    ESP_ERROR_CHECK(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)EXAMPLE_SPI_HOST, &io_config, io_handle));
+    ESP_RETURN_ON_ERROR(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)EXAMPLE_SPI_HOST, &io_config, io_handle), TAG,
+                        "panel io");
     soft_reset_once();
 
     esp_lcd_panel_dev_config_t panel_config = {};
@@ -93,16 +140,190 @@ void esp_3inch5_display_port_init(esp_lcd_panel_io_handle_t *io_handle, esp_lcd_
     panel_config.bits_per_pixel = 16;
 
     
-    esp_lcd_new_panel_st7796(*io_handle, &panel_config, panel_handle);
-    ESP_ERROR_CHECK(esp_lcd_panel_reset(*panel_handle));
-    ESP_ERROR_CHECK(esp_lcd_panel_init(*panel_handle));
-    ESP_ERROR_CHECK(esp_lcd_panel_invert_color(*panel_handle, true));
-    ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(*panel_handle, true));
-    
+    ESP_RETURN_ON_ERROR(esp_lcd_new_panel_st7796(*io_handle, &panel_config, panel_handle), TAG, "st7796");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_reset(*panel_handle), TAG, "reset");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_init(*panel_handle), TAG, "init");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_invert_color(*panel_handle, true), TAG, "invert");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_disp_on_off(*panel_handle, true), TAG, "on");
+    return ESP_OK;
+}
+
+esp_err_t esp_3inch5_display_port_init(esp_lcd_panel_io_handle_t *io_handle, esp_lcd_panel_handle_t *panel_handle, size_t max_transfer_sz)
+{
+    esp_err_t err = display_init(io_handle, panel_handle, max_transfer_sz);
+    hw_manifest_set(HW_DISPLAY, err == ESP_OK, 0);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Display init failed (%s)", esp_err_to_name(err));
+    }
+    return err;
+}
+
+static SemaphoreHandle_t te_sem = NULL;
+static esp_3inch5_te_read_t te_read = NULL;
+
+static void IRAM_ATTR te_isr(void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(te_sem, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+static bool te_gpio_init(gpio_num_t pin)
+{
+    te_sem = xSemaphoreCreateBinary();
+    if (te_sem == NULL) {
+        return false;
+    }
+    gpio_config_t io_conf = {};
+    io_conf.pin_bit_mask = 1ULL << pin;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.intr_type = GPIO_INTR_POSEDGE;
+    esp_err_t err = gpio_config(&io_conf);
+    if (err == ESP_OK) {
+        err = gpio_install_isr_service(0);
+        if (err == ESP_ERR_INVALID_STATE) {
+            err = ESP_OK;         // Already installed by another driver
+        }
+    }
+    if (err == ESP_OK) {
+        err = gpio_isr_handler_add(pin, te_isr, NULL);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "TE on GPIO %d failed (%s) - flushes unsynchronised", (int)pin, esp_err_to_name(err));
+        vSemaphoreDelete(te_sem);
+        te_sem = NULL;
+        return false;
+    }
+    return true;
+}
+
+void esp_3inch5_te_port_init(esp_lcd_panel_io_handle_t io, esp_3inch5_te_read_t expander_read)
+{
+    if (io == NULL || (CONFIG_GOLDIE_LCD_TE_GPIO < 0 && (CONFIG_GOLDIE_LCD_TE_EXPANDER_PIN < 0 || expander_read == NULL))) {
+        return;
+    }
+    uint8_t mode = LCD_TE_VBLANK_ONLY;
+    if (esp_lcd_panel_io_tx_param(io, LCD_CMD_TEON, &mode, 1) != ESP_OK) {
+        ESP_LOGW(TAG, "TEON not accepted - flushes unsynchronised");
+        return;
+    }
+    if (CONFIG_GOLDIE_LCD_TE_GPIO >= 0) {
+        if (te_gpio_init((gpio_num_t)CONFIG_GOLDIE_LCD_TE_GPIO)) {
+            ESP_LOGI(TAG, "TE on GPIO %d - full frames start at vblank", CONFIG_GOLDIE_LCD_TE_GPIO);
+        }
+        return;
+    }
+    te_read = expander_read;
+    ESP_LOGI(TAG, "TE on expander pin %d (polled) - full frames start at vblank", CONFIG_GOLDIE_LCD_TE_EXPANDER_PIN);
+}
+
+bool esp_3inch5_te_port_available(void)
+{
+    return te_sem != NULL || te_read != NULL;
+}
+
+bool esp_3inch5_te_port_wait(void)
+{
+    if (te_sem != NULL) {
+        xSemaphoreTake(te_sem, 0);          // An edge from an earlier refresh
+        return xSemaphoreTake(te_sem, pdMS_TO_TICKS(CONFIG_GOLDIE_LCD_TE_WAIT_MS)) == pdTRUE;
+    }
+    if (te_read == NULL) {
+        return false;
+    }
+    // Poll for the rising edge: one I2C read per sample
+    int64_t deadline = esp_timer_get_time() + CONFIG_GOLDIE_LCD_TE_WAIT_MS * 1000;
+    bool was_low = false;
+    bool high;
+    while (esp_timer_get_time() < deadline) {
+        if (!te_read(&high)) {
+            return false;
+        }
+        if (high && was_low) {
+            return true;
+        }
+        was_low = !high;
+    }
+    return false;
+}
+
+static std::atomic<bool> touch_int_pending(false);   // ISR sets, the touch read takes
+static SemaphoreHandle_t touch_int_sem = NULL;
+
+/**
+ * @brief INT went low: note it and disarm until the finger is lifted
+ *
+ * Level-triggered so the same setting also wakes light sleep; the line
+ * stays low for the whole touch, hence one shot per touch.
+ */
+static void touch_int_isr(void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    gpio_intr_disable((gpio_num_t)CONFIG_GOLDIE_TOUCH_INT_GPIO);
+    touch_int_pending.store(true, std::memory_order_release);
+    xSemaphoreGiveFromISR(touch_int_sem, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+static void touch_int_init(esp_lcd_panel_io_handle_t io)
+{
+    const gpio_num_t pin = (gpio_num_t)CONFIG_GOLDIE_TOUCH_INT_GPIO;
+    uint8_t mode = 0;
+    if (esp_lcd_panel_io_tx_param(io, TOUCH_FT6336_REG_G_MODE, &mode, 1) != ESP_OK) {
+        ESP_LOGW(TAG, "FT6336 interrupt mode not set - touch stays polled");
+        return;
+    }
+    touch_int_sem = xSemaphoreCreateBinary();
+    if (touch_int_sem == NULL) {
+        return;
+    }
+    gpio_config_t io_conf = {};
+    io_conf.pin_bit_mask = 1ULL << pin;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
+    io_conf.intr_type = GPIO_INTR_LOW_LEVEL;
+    esp_err_t err = gpio_config(&io_conf);
+    if (err == ESP_OK) {
+        err = gpio_install_isr_service(0);
+        if (err == ESP_ERR_INVALID_STATE) {
+            err = ESP_OK;         // Already installed by another driver
+        }
+    }
+    if (err == ESP_OK) {
+        err = gpio_isr_handler_add(pin, touch_int_isr, NULL);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Touch INT on GPIO %d failed (%s) - touch stays polled", (int)pin, esp_err_to_name(err));
+        vSemaphoreDelete(touch_int_sem);
+        touch_int_sem = NULL;
+        return;
+    }
+    // Only acted on while light sleep is enabled (idle mode)
+    gpio_wakeup_enable(pin, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    ESP_LOGI(TAG, "Touch INT on GPIO %d - panel read on touch only", (int)pin);
 }
 
-void esp_3inch5_touch_port_init(esp_lcd_touch_handle_t *touch_handle, i2c_master_bus_handle_t bus_handle, uint16_t xmax, uint16_t ymax, uint16_t rotation)
+esp_err_t esp_3inch5_touch_port_init(esp_lcd_touch_handle_t *touch_handle, i2c_master_bus_handle_t bus_handle, uint16_t xmax, uint16_t ymax, uint16_t rotation)
 {
+    *touch_handle = NULL;
+    if (hw_manifest_lacked(HW_TOUCH)) {
+        ESP_LOGI(TAG, "No touch controller before the reset - not probing");
+        hw_manifest_set(HW_TOUCH, false, 0);
+        return ESP_ERR_NOT_FOUND;
+    }
+    // Bounded: the driver's own reads wait for the bus without a limit
+    esp_err_t err = hw_manifest_probe_i2c(bus_handle, ESP_LCD_TOUCH_IO_I2C_FT6336_ADDRESS);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "No FT6336 (%s) - touch off", esp_err_to_name(err));
+        hw_manifest_set(HW_TOUCH, false, 0);
+        return err;
+    }
+
     esp_lcd_panel_io_handle_t touch_io_handle = NULL;
     esp_lcd_panel_io_i2c_config_t touch_io_config = {};
     touch_io_config.dev_addr = ESP_LCD_TOUCH_IO_I2C_FT6336_ADDRESS,
@@ -113,7 +334,7 @@ void esp_3inch5_touch_port_init(esp_lcd_touch_handle_t *touch_handle, i2c_master
     touch_io_config.scl_speed_hz = 400 * 1000;
 
     /* Touch IO handle */
-    ESP_ERROR_CHECK(esp_lcd_new_panel_io_i2c(bus_handle, &touch_io_config, &touch_io_handle));
+    err = esp_lcd_new_panel_io_i2c(bus_handle, &touch_io_config, &touch_io_handle);
     esp_lcd_touch_config_t tp_cfg = {};
     tp_cfg.x_max = xmax < ymax ? xmax : ymax;
     tp_cfg.y_max = xmax < ymax ? ymax : xmax;
@@ -145,7 +366,48 @@ void esp_3inch5_touch_port_init(esp_lcd_touch_handle_t *touch_handle, i2c_master
         tp_cfg.flags.mirror_y = 0;
     }
 
-    ESP_ERROR_CHECK(esp_lcd_touch_new_i2c_ft6336(touch_io_handle, &tp_cfg, touch_handle));
+    if (err == ESP_OK) {
+        err = esp_lcd_touch_new_i2c_ft6336(touch_io_handle, &tp_cfg, touch_handle);
+    }
+    hw_manifest_set(HW_TOUCH, err == ESP_OK, 0);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "FT6336 init failed (%s) - touch off", esp_err_to_name(err));
+        if (touch_io_handle != NULL) {
+            esp_lcd_panel_io_del(touch_io_handle);
+        }
+        *touch_handle = NULL;
+        return err;
+    }
+    if (CONFIG_GOLDIE_TOUCH_INT_GPIO >= 0) {
+        touch_int_init(touch_io_handle);
+    }
+    return ESP_OK;
+}
+
+bool esp_3inch5_touch_port_has_int(void)
+{
+    return touch_int_sem != NULL;
+}
+
+bool esp_3inch5_touch_port_take_int(void)
+{
+    return touch_int_pending.exchange(false, std::memory_order_acquire);
+}
+
+void esp_3inch5_touch_port_rearm_int(void)
+{
+    if (touch_int_sem != NULL) {
+        gpio_intr_enable((gpio_num_t)CONFIG_GOLDIE_TOUCH_INT_GPIO);
+    }
+}
+
+bool esp_3inch5_touch_port_wait_int(TickType_t wait)
+{
+    if (touch_int_sem == NULL) {
+        vTaskDelay(wait);
+        return false;
+    }
+    return xSemaphoreTake(touch_int_sem, wait) == pdTRUE;
 }
 
 void esp_3inch5_brightness_port_init(void)
@@ -156,7 +418,13 @@ void esp_3inch5_brightness_port_init(void)
     ledc_timer.timer_num = LCD_BL_LEDC_TIMER;
     ledc_timer.duty_resolution = LCD_BL_LEDC_DUTY_RES;
     ledc_timer.freq_hz = LCD_BL_LEDC_FREQUENCY; // Set output frequency at 5 kHz
+#if CONFIG_GOLDIE_IDLE_LIGHT_SLEEP
+    // The APB clock stops in light sleep; RC_FAST keeps the PWM (and the
+    // dimmed backlight) running through it
+    ledc_timer.clk_cfg = LEDC_USE_RC_FAST_CLK;
+#else
     ledc_timer.clk_cfg = LEDC_AUTO_CLK;
+#endif
     ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
 
     // Prepare and then apply the LEDC PWM channel configuration
@@ -168,6 +436,9 @@ void esp_3inch5_brightness_port_init(void)
     ledc_channel.gpio_num = EXAMPLE_PIN_LCD_BL;
     ledc_channel.duty = 0; // Set duty to 0%
     ledc_channel.hpoint = 0;
+#if CONFIG_GOLDIE_IDLE_LIGHT_SLEEP
+    ledc_channel.sleep_mode = LEDC_SLEEP_MODE_KEEP_ALIVE;
+#endif
     ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
 }
 
@@ -3,8 +3,35 @@
 #include "esp_lcd_touch_ft6336.h"
 #include "esp_lcd_st7796.h"
 #include "driver/i2c_master.h"
+#include "freertos/FreeRTOS.h"
+
+// Both record their part in hw_manifest.h (HW_DISPLAY, HW_TOUCH) and return
+// the failing step's error instead of aborting. Touch is probed first with
+// a bounded address probe and leaves *touch_handle NULL when the FT6336
+// does not answer - the UI runs without input then.
+esp_err_t esp_3inch5_display_port_init(esp_lcd_panel_io_handle_t *io_handle, esp_lcd_panel_handle_t *panel_handle, size_t max_transfer_sz);
+esp_err_t esp_3inch5_touch_port_init(esp_lcd_touch_handle_t *touch_handle, i2c_master_bus_handle_t bus_handle, uint16_t xmax, uint16_t ymax, uint16_t rotation);
+
+// Touch interrupt (CONFIG_GOLDIE_TOUCH_INT_GPIO): the FT6336 holds INT low
+// while touched. It fires once per touch; the reader skips the I2C read
+// until it has, keeps reading while the finger is down, and re-arms it on
+// the release. Without a wired line every call below is a no-op and the
+// reader polls as before.
+bool esp_3inch5_touch_port_has_int(void);
+bool esp_3inch5_touch_port_take_int(void);      // Fired since last asked (clears it)
+void esp_3inch5_touch_port_rearm_int(void);     // After reading a release
+bool esp_3inch5_touch_port_wait_int(TickType_t wait);   // Sleeps wait without a line
+
+// Tearing effect: the ST7796 raises TE at the start of each vertical
+// blanking period once TEON is sent. Wired to a GPIO (CONFIG_GOLDIE_LCD_TE_
+// GPIO) the edge wakes the waiter from an ISR; on an IO expander input
+// (CONFIG_GOLDIE_LCD_TE_EXPANDER_PIN) the caller's read function is polled
+// over I2C, coarser and busier. Without either every call below is a no-op
+// and flushes start whenever they are ready, as before.
+typedef bool (*esp_3inch5_te_read_t)(bool *high);     // Expander TE level; false on an I2C error
+void esp_3inch5_te_port_init(esp_lcd_panel_io_handle_t io, esp_3inch5_te_read_t expander_read);
+bool esp_3inch5_te_port_available(void);
+bool esp_3inch5_te_port_wait(void);             // Next vblank start; false on timeout / no line
 
-void esp_3inch5_display_port_init(esp_lcd_panel_io_handle_t *io_handle, esp_lcd_panel_handle_t *panel_handle, size_t max_transfer_sz);
-void esp_3inch5_touch_port_init(esp_lcd_touch_handle_t *touch_handle, i2c_master_bus_handle_t bus_handle, uint16_t xmax, uint16_t ymax, uint16_t rotation);
 void esp_3inch5_brightness_port_init(void);
 void esp_3inch5_brightness_port_set(uint8_t brightness);
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "esp_err.h"
 
 #include "driver/i2c_master.h"
+#include "hw_manifest.h"
+#include "i2c_sched.h"
 
 #define XPOWERS_CHIP_AXP2101
 #include "XPowersLib.h"
@@ -13,6 +15,11 @@ static const char *TAG = "AXP2101";
 XPowersPMU power;
 i2c_master_dev_handle_t i2c_device;
 
+static bool pmu_up = false;
+static portMUX_TYPE latest_lock = portMUX_INITIALIZER_UNLOCKED;
+static pmu_reading_t latest = {};
+static bool latest_valid = false;
+
 static esp_err_t i2c_init(i2c_master_bus_handle_t bus_handle)
 {
     i2c_device_config_t i2c_dev_conf = {};
@@ -34,7 +41,9 @@ static int pmu_register_read(uint8_t devAddr, uint8_t regAddr, uint8_t *data, ui
     {
         return ESP_FAIL;
     }
+    i2c_sched_begin(I2C_SCHED_PMU, portMAX_DELAY);   // Behind any touch read
     ret = i2c_master_transmit_receive(i2c_device, (const uint8_t *)&regAddr, 1, data, len, -1);
+    i2c_sched_end(I2C_SCHED_PMU);
     return ret == ESP_OK ? 0 : -1;
 }
 
@@ -54,13 +63,17 @@ static int pmu_register_write_byte(uint8_t devAddr, uint8_t regAddr, uint8_t *da
     write_buffer[0] = regAddr;
     memcpy(write_buffer + 1, data, len);
 
+    i2c_sched_begin(I2C_SCHED_PMU, portMAX_DELAY);
     ret = i2c_master_transmit(i2c_device, write_buffer, len + 1, -1);
+    i2c_sched_end(I2C_SCHED_PMU);
     free(write_buffer);
     return ret == ESP_OK ? 0 : -1;
 }
 
 esp_err_t esp_axp2101_port_init(i2c_master_bus_handle_t bus_handle)
 {
+    // After a warm reset the PMU kept its rails: program it, skip the readback dumps
+    bool verbose = !hw_manifest_had(HW_PMU, NULL);
     i2c_init(bus_handle);
     //* Implemented using read and write callback methods, applicable to other platforms
     ESP_LOGI(TAG, "Implemented using read and write callback methods");
@@ -71,6 +84,7 @@ esp_err_t esp_axp2101_port_init(i2c_master_bus_handle_t bus_handle)
     else
     {
         ESP_LOGE(TAG, "Init PMU FAILED!");
+        hw_manifest_set(HW_PMU, false, 0);
         return ESP_FAIL;
     }
 
@@ -175,26 +189,28 @@ esp_err_t esp_axp2101_port_init(i2c_master_bus_handle_t bus_handle)
     power.enableDLDO1();
     power.enableDLDO2();
 
-    printf("DCDC=======================================================================\n");
-    printf("DC1  : %s   Voltage:%u mV \n", power.isEnableDC1() ? "+" : "-", power.getDC1Voltage());
-    printf("DC2  : %s   Voltage:%u mV \n", power.isEnableDC2() ? "+" : "-", power.getDC2Voltage());
-    printf("DC3  : %s   Voltage:%u mV \n", power.isEnableDC3() ? "+" : "-", power.getDC3Voltage());
-    printf("DC4  : %s   Voltage:%u mV \n", power.isEnableDC4() ? "+" : "-", power.getDC4Voltage());
-    printf("DC5  : %s   Voltage:%u mV \n", power.isEnableDC5() ? "+" : "-", power.getDC5Voltage());
-    printf("ALDO=======================================================================\n");
-    printf("ALDO1: %s   Voltage:%u mV\n", power.isEnableALDO1() ? "+" : "-", power.getALDO1Voltage());
-    printf("ALDO2: %s   Voltage:%u mV\n", power.isEnableALDO2() ? "+" : "-", power.getALDO2Voltage());
-    printf("ALDO3: %s   Voltage:%u mV\n", power.isEnableALDO3() ? "+" : "-", power.getALDO3Voltage());
-    printf("ALDO4: %s   Voltage:%u mV\n", power.isEnableALDO4() ? "+" : "-", power.getALDO4Voltage());
-    printf("BLDO=======================================================================\n");
-    printf("BLDO1: %s   Voltage:%u mV\n", power.isEnableBLDO1() ? "+" : "-", power.getBLDO1Voltage());
-    printf("BLDO2: %s   Voltage:%u mV\n", power.isEnableBLDO2() ? "+" : "-", power.getBLDO2Voltage());
-    printf("CPUSLDO====================================================================\n");
-    printf("CPUSLDO: %s Voltage:%u mV\n", power.isEnableCPUSLDO() ? "+" : "-", power.getCPUSLDOVoltage());
-    printf("DLDO=======================================================================\n");
-    printf("DLDO1: %s   Voltage:%u mV\n", power.isEnableDLDO1() ? "+" : "-", power.getDLDO1Voltage());
-    printf("DLDO2: %s   Voltage:%u mV\n", power.isEnableDLDO2() ? "+" : "-", power.getDLDO2Voltage());
-    printf("===========================================================================\n");
+    if (verbose) {
+        printf("DCDC=======================================================================\n");
+        printf("DC1  : %s   Voltage:%u mV \n", power.isEnableDC1() ? "+" : "-", power.getDC1Voltage());
+        printf("DC2  : %s   Voltage:%u mV \n", power.isEnableDC2() ? "+" : "-", power.getDC2Voltage());
+        printf("DC3  : %s   Voltage:%u mV \n", power.isEnableDC3() ? "+" : "-", power.getDC3Voltage());
+        printf("DC4  : %s   Voltage:%u mV \n", power.isEnableDC4() ? "+" : "-", power.getDC4Voltage());
+        printf("DC5  : %s   Voltage:%u mV \n", power.isEnableDC5() ? "+" : "-", power.getDC5Voltage());
+        printf("ALDO=======================================================================\n");
+        printf("ALDO1: %s   Voltage:%u mV\n", power.isEnableALDO1() ? "+" : "-", power.getALDO1Voltage());
+        printf("ALDO2: %s   Voltage:%u mV\n", power.isEnableALDO2() ? "+" : "-", power.getALDO2Voltage());
+        printf("ALDO3: %s   Voltage:%u mV\n", power.isEnableALDO3() ? "+" : "-", power.getALDO3Voltage());
+        printf("ALDO4: %s   Voltage:%u mV\n", power.isEnableALDO4() ? "+" : "-", power.getALDO4Voltage());
+        printf("BLDO=======================================================================\n");
+        printf("BLDO1: %s   Voltage:%u mV\n", power.isEnableBLDO1() ? "+" : "-", power.getBLDO1Voltage());
+        printf("BLDO2: %s   Voltage:%u mV\n", power.isEnableBLDO2() ? "+" : "-", power.getBLDO2Voltage());
+        printf("CPUSLDO====================================================================\n");
+        printf("CPUSLDO: %s Voltage:%u mV\n", power.isEnableCPUSLDO() ? "+" : "-", power.getCPUSLDOVoltage());
+        printf("DLDO=======================================================================\n");
+        printf("DLDO1: %s   Voltage:%u mV\n", power.isEnableDLDO1() ? "+" : "-", power.getDLDO1Voltage());
+        printf("DLDO2: %s   Voltage:%u mV\n", power.isEnableDLDO2() ? "+" : "-", power.getDLDO2Voltage());
+        printf("===========================================================================\n");
+    }
 
     // Set the time of pressing the button to turn off
     power.setPowerKeyPressOffTime(XPOWERS_POWEROFF_4S);
@@ -241,32 +257,34 @@ esp_err_t esp_axp2101_port_init(i2c_master_bus_handle_t bus_handle)
 
     printf("===========================================================================\n");
 
-    bool en;
-
-    // DCDC 120%(130%) high voltage turn off PMIC function
-    en = power.getDCHighVoltagePowerDownEn();
-    printf("getDCHighVoltagePowerDownEn:");
-    printf(en ? "ENABLE\n" : "DISABLE\n");
-    // DCDC1 85% low voltage turn off PMIC function
-    en = power.getDC1LowVoltagePowerDownEn();
-    printf("getDC1LowVoltagePowerDownEn:");
-    printf(en ? "ENABLE\n" : "DISABLE\n");
-    // DCDC2 85% low voltage turn off PMIC function
-    en = power.getDC2LowVoltagePowerDownEn();
-    printf("getDC2LowVoltagePowerDownEn:");
-    printf(en ? "ENABLE\n" : "DISABLE\n");
-    // DCDC3 85% low voltage turn off PMIC function
-    en = power.getDC3LowVoltagePowerDownEn();
-    printf("getDC3LowVoltagePowerDownEn:");
-    printf(en ? "ENABLE\n" : "DISABLE\n");
-    // DCDC4 85% low voltage turn off PMIC function
-    en = power.getDC4LowVoltagePowerDownEn();
-    printf("getDC4LowVoltagePowerDownEn:");
-    printf(en ? "ENABLE\n" : "DISABLE\n");
-    // DCDC5 85% low voltage turn off PMIC function
-    en = power.getDC5LowVoltagePowerDownEn();
-    printf("getDC5LowVoltagePowerDownEn:");
-    printf(en ? "ENABLE\n" : "DISABLE\n");
+    if (verbose) {
+        bool en;
+
+        // DCDC 120%(130%) high voltage turn off PMIC function
+        en = power.getDCHighVoltagePowerDownEn();
+        printf("getDCHighVoltagePowerDownEn:");
+        printf(en ? "ENABLE\n" : "DISABLE\n");
+        // DCDC1 85% low voltage turn off PMIC function
+        en = power.getDC1LowVoltagePowerDownEn();
+        printf("getDC1LowVoltagePowerDownEn:");
+        printf(en ? "ENABLE\n" : "DISABLE\n");
+        // DCDC2 85% low voltage turn off PMIC function
+        en = power.getDC2LowVoltagePowerDownEn();
+        printf("getDC2LowVoltagePowerDownEn:");
+        printf(en ? "ENABLE\n" : "DISABLE\n");
+        // DCDC3 85% low voltage turn off PMIC function
+        en = power.getDC3LowVoltagePowerDownEn();
+        printf("getDC3LowVoltagePowerDownEn:");
+        printf(en ? "ENABLE\n" : "DISABLE\n");
+        // DCDC4 85% low voltage turn off PMIC function
+        en = power.getDC4LowVoltagePowerDownEn();
+        printf("getDC4LowVoltagePowerDownEn:");
+        printf(en ? "ENABLE\n" : "DISABLE\n");
+        // DCDC5 85% low voltage turn off PMIC function
+        en = power.getDC5LowVoltagePowerDownEn();
+        printf("getDC5LowVoltagePowerDownEn:");
+        printf(en ? "ENABLE\n" : "DISABLE\n");
+    }
 
     // power.setDCHighVoltagePowerDown(true);
     // power.setDC1LowVoltagePowerDown(true);
@@ -338,9 +356,60 @@ esp_err_t esp_axp2101_port_init(i2c_master_bus_handle_t bus_handle)
 
     // Set Button Battery charge voltage
     power.setButtonBatteryChargeVoltage(3300);
+    hw_manifest_set(HW_PMU, true, 0);
+    pmu_up = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_axp2101_port_read(pmu_reading_t *out)
+{
+    if (!pmu_up) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // Status and ADC blocks as one burst each, then the gauge: three
+    // transactions instead of a dozen single-register reads
+    uint8_t st[2];
+    if (!power.readStatusBlock(st)) {
+        return ESP_FAIL;
+    }
+    pmu_reading_t r = {};
+    r.vbus_in = XPowersPMU::statusVbusIn(st);
+    r.batt_present = XPowersPMU::statusBatteryConnect(st);
+    r.charging = r.batt_present && XPowersPMU::statusCharging(st);
+    if (r.vbus_in || r.batt_present) {
+        xpowers_axp2101_adc_t adc;
+        if (!power.readAdcBlock(&adc)) {
+            return ESP_FAIL;
+        }
+        r.vbus_mv = r.vbus_in ? adc.vbus_mv : 0;
+        r.batt_mv = r.batt_present ? adc.batt_mv : 0;
+    }
+    r.batt_pct = -1;
+    if (r.batt_present) {
+        int pct = power.readRegister(XPOWERS_AXP2101_BAT_PERCENT_DATA);
+        if (pct == -1) {
+            return ESP_FAIL;
+        }
+        r.batt_pct = (int8_t)pct;
+    }
+
+    portENTER_CRITICAL(&latest_lock);
+    latest = r;
+    latest_valid = true;
+    portEXIT_CRITICAL(&latest_lock);
+    *out = r;
     return ESP_OK;
 }
 
+bool esp_axp2101_port_latest(pmu_reading_t *out)
+{
+    portENTER_CRITICAL(&latest_lock);
+    bool valid = latest_valid;
+    *out = latest;
+    portEXIT_CRITICAL(&latest_lock);
+    return valid;
+}
+
 esp_err_t esp_axp2101_port_init1(i2c_master_bus_handle_t bus_handle)
 {
     i2c_init(bus_handle);
@@ -485,17 +554,23 @@ esp_err_t esp_axp2101_port_init1(i2c_master_bus_handle_t bus_handle)
     return ESP_OK;
 }
 
-void pmu_isr_handler(void)
+uint32_t pmu_isr_handler(void)
 {
+    uint32_t events = 0;
+    if (!pmu_up) {
+        return 0;
+    }
     // Get PMU Interrupt Status Register
     power.getIrqStatus();
 
     if (power.isDropWarningLevel2Irq())
     {
+        events |= PMU_EVT_LOW;
         ESP_LOGI(TAG, "isDropWarningLevel2");
     }
     if (power.isDropWarningLevel1Irq())
     {
+        events |= PMU_EVT_LOW;
         ESP_LOGI(TAG, "isDropWarningLevel1");
     }
     if (power.isGaugeWdtTimeoutIrq())
@@ -516,26 +591,32 @@ void pmu_isr_handler(void)
     }
     if (power.isVbusInsertIrq())
     {
+        events |= PMU_EVT_VBUS;
         ESP_LOGI(TAG, "isVbusInsert");
     }
     if (power.isVbusRemoveIrq())
     {
+        events |= PMU_EVT_VBUS;
         ESP_LOGI(TAG, "isVbusRemove");
     }
     if (power.isBatInsertIrq())
     {
+        events |= PMU_EVT_BATTERY;
         ESP_LOGI(TAG, "isBatInsert");
     }
     if (power.isBatRemoveIrq())
     {
+        events |= PMU_EVT_BATTERY;
         ESP_LOGI(TAG, "isBatRemove");
     }
     if (power.isPekeyShortPressIrq())
     {
+        events |= PMU_EVT_KEY;
         ESP_LOGI(TAG, "isPekeyShortPress");
     }
     if (power.isPekeyLongPressIrq())
     {
+        events |= PMU_EVT_KEY;
         ESP_LOGI(TAG, "isPekeyLongPress");
     }
     if (power.isPekeyNegativeIrq())
@@ -560,10 +641,12 @@ void pmu_isr_handler(void)
     }
     if (power.isBatChargeDoneIrq())
     {
+        events |= PMU_EVT_CHARGE;
         ESP_LOGI(TAG, "isBatChargeDone");
     }
     if (power.isBatChargeStartIrq())
     {
+        events |= PMU_EVT_CHARGE;
         ESP_LOGI(TAG, "isBatChargeStart");
     }
     if (power.isBatDieOverTemperatureIrq())
@@ -580,4 +663,5 @@ void pmu_isr_handler(void)
     }
     // Clear PMU Interrupt Status Register
     power.clearIrqStatus();
+    return events;
 }
@@ -8,5 +8,39 @@
 
 // extern XPowersPMU power;
 
+// Battery and supply state as one read (esp_axp2101_port_read)
+typedef struct {
+    uint16_t batt_mv;
+    uint16_t vbus_mv;
+    int8_t   batt_pct;          // Fuel gauge, -1 = no battery
+    bool     batt_present;
+    bool     charging;
+    bool     vbus_in;
+} pmu_reading_t;
+
+// What pmu_isr_handler() found, as far as the supply state goes
+#define PMU_EVT_VBUS     0x01   // Plugged in / unplugged
+#define PMU_EVT_BATTERY  0x02   // Inserted / removed
+#define PMU_EVT_CHARGE   0x04   // Charging started / done
+#define PMU_EVT_LOW      0x08   // Battery drop warning
+#define PMU_EVT_KEY      0x10   // Power key
+
 esp_err_t esp_axp2101_port_init(i2c_master_bus_handle_t bus_handle);
-void pmu_isr_handler(void);
\ No newline at end of file
+
+/**
+ * @brief Read the battery and supply state (three burst reads, PMU class)
+ * @return ESP_ERR_INVALID_STATE if the PMU did not come up
+ */
+esp_err_t esp_axp2101_port_read(pmu_reading_t *out);
+
+/**
+ * @brief The last esp_axp2101_port_read() result (no bus traffic)
+ * @return false before the first read
+ */
+bool esp_axp2101_port_latest(pmu_reading_t *out);
+
+/**
+ * @brief Read and clear the PMU interrupt status, log what happened
+ * @return PMU_EVT_* bits
+ */
+uint32_t pmu_isr_handler(void);
\ No newline at end of file
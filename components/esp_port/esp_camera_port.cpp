@@ -1,7 +1,15 @@
+#include "esp_camera_port.h"
+#include "i2c_sched.h"
+#include "hw_manifest.h"
+#include "pixel_kernels.h"
+#include "img_converters.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
 
-#include "esp_camera.h"
-#include "driver/i2c_master.h"
-
+static const char *TAG = "esp_camera_port";
 
 #define PWDN_GPIO_NUM -1
 #define RESET_GPIO_NUM -1
@@ -21,12 +29,41 @@
 #define HREF_GPIO_NUM 18
 #define PCLK_GPIO_NUM 41
 
+// Timer 1 / channel 0 drive the backlight (esp_3inch5_lcd_port.cpp)
 #define CAM_LEDC_TIMER      LEDC_TIMER_0
-#define CAM_LEDC_CHANNEL    LEDC_CHANNEL_0
+#define CAM_LEDC_CHANNEL    LEDC_CHANNEL_1
+
+#define CAM_SCCB_WAIT_MS    200
+#define CAM_SWITCH_FRAMES   3             // Old-size frames still in the buffers, plus one
+
+static bool camera_up = false;
+static framesize_t frame_size = CAMERA_FRAME_SIZE;   // What the sensor is set to
+static uint8_t *preview = NULL;           // PSRAM, CAMERA_PREVIEW_BYTES
+static uint8_t *decode_buf = NULL;        // Decoded into, then copied under the lock
+static SemaphoreHandle_t preview_lock = NULL;
+static uint32_t preview_seq = 0;
+
+// esp_jpg_decode()'s work buffer; created on first use, the camera may be absent
+static SemaphoreHandle_t jpeg_lock(void)
+{
+    static StaticSemaphore_t buf;
+    static SemaphoreHandle_t lock = xSemaphoreCreateMutexStatic(&buf);
+    return lock;
+}
+
+void esp_camera_port_jpeg_take(void)
+{
+    xSemaphoreTake(jpeg_lock(), portMAX_DELAY);
+}
+
+void esp_camera_port_jpeg_give(void)
+{
+    xSemaphoreGive(jpeg_lock());
+}
 
-void esp_camera_port_init(i2c_port_num_t i2c_port) 
+bool esp_camera_port_init(i2c_port_num_t i2c_port)
 {
-    camera_config_t config;
+    camera_config_t config = {};
     config.ledc_channel = CAM_LEDC_CHANNEL;
     config.ledc_timer = CAM_LEDC_TIMER;
     config.pin_d0 = Y2_GPIO_NUM;
@@ -41,28 +78,161 @@ void esp_camera_port_init(i2c_port_num_t i2c_port)
     config.pin_pclk = PCLK_GPIO_NUM;
     config.pin_vsync = VSYNC_GPIO_NUM;
     config.pin_href = HREF_GPIO_NUM;
-    config.pin_sccb_sda = -1;
+    config.pin_sccb_sda = -1;              // The bus is already up: share it
     config.pin_sccb_scl = -1;
-    config.sccb_i2c_port = 0;
+    config.sccb_i2c_port = i2c_port;
     config.pin_pwdn = PWDN_GPIO_NUM;
     config.pin_reset = RESET_GPIO_NUM;
     config.xclk_freq_hz = 20000000;
-    config.frame_size = FRAMESIZE_320X480;
-    config.pixel_format = PIXFORMAT_RGB565; // for streaming
-    // config.pixel_format = PIXFORMAT_RGB565; // for face detection/recognition
-    config.grab_mode = CAMERA_GRAB_WHEN_EMPTY;
+    config.frame_size = CAMERA_FRAME_SIZE;
+    config.pixel_format = PIXFORMAT_JPEG;  // Encoded by the sensor
+    config.grab_mode = CAMERA_GRAB_LATEST;
     config.fb_location = CAMERA_FB_IN_PSRAM;
-    config.jpeg_quality = 12;
-    config.fb_count = 1;
+    config.jpeg_quality = CAMERA_JPEG_QUALITY;
+    config.fb_count = 2;
 
+    if (hw_manifest_lacked(HW_CAMERA)) {
+        ESP_LOGI(TAG, "No camera before the reset - not probing");
+        hw_manifest_set(HW_CAMERA, false, 0);
+        return false;
+    }
+    preview_lock = xSemaphoreCreateMutex();
+    preview = (uint8_t *)heap_caps_calloc(1, CAMERA_PREVIEW_BYTES, MALLOC_CAP_SPIRAM);
+    decode_buf = (uint8_t *)heap_caps_malloc(CAMERA_PREVIEW_BYTES, MALLOC_CAP_SPIRAM);
+    if (preview_lock == NULL || preview == NULL || decode_buf == NULL) {
+        ESP_LOGE(TAG, "No memory for the preview - camera off");
+        return false;
+    }
+
+    // Probe and register setup run over SCCB on the shared bus
+    bool slot = i2c_sched_begin(I2C_SCHED_SENSOR, pdMS_TO_TICKS(CAM_SCCB_WAIT_MS));
     esp_err_t err = esp_camera_init(&config);
-    
+    sensor_t *s = (err == ESP_OK) ? esp_camera_sensor_get() : NULL;
+    if (s != NULL) {
+        s->set_vflip(s, 1);
+    }
+    if (slot) {
+        i2c_sched_end(I2C_SCHED_SENSOR);
+    }
+
+    if (err != ESP_OK || s == NULL) {
+        ESP_LOGW(TAG, "No camera (%s) - snapshots off", esp_err_to_name(err));
+        hw_manifest_set(HW_CAMERA, false, 0);
+        return false;
+    }
+    camera_up = true;
+    hw_manifest_set(HW_CAMERA, true, s->id.PID);
+    ESP_LOGI(TAG, "Camera PID 0x%04x: JPEG %dx%d quality %d, 2 buffers, latest frame", s->id.PID,
+             CAMERA_PREVIEW_W * 4, CAMERA_PREVIEW_H * 4, CAMERA_JPEG_QUALITY);
+    return true;
+}
+
+/**
+ * @brief The latest JPEG frame at size fs, switching the sensor first if needed
+ *
+ * After a switch the driver may still hold frames of the old size: those
+ * are dropped until one of the new size arrives.
+ */
+static camera_fb_t *grab(framesize_t fs, int width)
+{
+    if (!camera_up) {
+        return NULL;
+    }
+    if (frame_size != fs) {
+        if (!i2c_sched_begin(I2C_SCHED_SENSOR, pdMS_TO_TICKS(CAM_SCCB_WAIT_MS))) {
+            return NULL;
+        }
+        sensor_t *s = esp_camera_sensor_get();
+        int err = s->set_framesize(s, fs);
+        i2c_sched_end(I2C_SCHED_SENSOR);
+        if (err != 0) {
+            ESP_LOGW(TAG, "Frame size %d not taken", (int)fs);
+            return NULL;
+        }
+        frame_size = fs;
+    }
+    for (int i = 0; i < CAM_SWITCH_FRAMES; i++) {
+        camera_fb_t *fb = esp_camera_fb_get();
+        if (fb == NULL) {
+            return NULL;
+        }
+        if (fb->format == PIXFORMAT_JPEG && fb->width == width) {
+            return fb;
+        }
+        esp_camera_fb_return(fb);
+    }
+    return NULL;
+}
+
+camera_fb_t *esp_camera_port_capture(void)
+{
+    return grab(CAMERA_FRAME_SIZE, CAMERA_PREVIEW_W * 4);
+}
+
+camera_fb_t *esp_camera_port_capture_live(void)
+{
+    return grab(CAMERA_LIVE_SIZE, CAMERA_PREVIEW_W * 2);
+}
+
+bool esp_camera_port_preview_update(const camera_fb_t *fb)
+{
+    if (preview == NULL || fb == NULL) {
+        return false;
+    }
+    // Decoder-side scaling: the IDCT skips what the preview would throw away
+    jpg_scale_t scale;
+    if (fb->width == CAMERA_PREVIEW_W * 4 && fb->height == CAMERA_PREVIEW_H * 4) {
+        scale = JPG_SCALE_4X;
+    } else if (fb->width == CAMERA_PREVIEW_W * 2 && fb->height == CAMERA_PREVIEW_H * 2) {
+        scale = JPG_SCALE_2X;
+    } else {
+        return false;
+    }
+    esp_camera_port_jpeg_take();
+    bool decoded = jpg2rgb565(fb->buf, fb->len, decode_buf, scale);
+    esp_camera_port_jpeg_give();
+    if (!decoded) {
+        ESP_LOGW(TAG, "Preview decode failed (%u bytes)", (unsigned)fb->len);
+        return false;
+    }
+    // The decoder writes little endian; LVGL (LV_COLOR_16_SWAP) and the
+    // camera's own RGB565 are big endian
+    xSemaphoreTake(preview_lock, portMAX_DELAY);
+    pixel_swap16(preview, decode_buf, CAMERA_PREVIEW_BYTES);
+    preview_seq++;
+    xSemaphoreGive(preview_lock);
+    return true;
+}
 
-    if (err != ESP_OK)
-    {
-        printf("Camera init failed with error 0x%x", err);
-        return;
+bool esp_camera_port_gray(const camera_fb_t *fb, uint8_t *gray, uint8_t *mean)
+{
+    if (decode_buf == NULL || fb == NULL ||
+        fb->width != CAMERA_PREVIEW_W * 2 || fb->height != CAMERA_PREVIEW_H * 2) {
+        return false;
+    }
+    esp_camera_port_jpeg_take();
+    bool decoded = jpg2rgb565(fb->buf, fb->len, decode_buf, JPG_SCALE_2X);
+    esp_camera_port_jpeg_give();
+    if (!decoded) {
+        ESP_LOGW(TAG, "Gray decode failed (%u bytes)", (unsigned)fb->len);
+        return false;
+    }
+    // Native order straight from the decoder: no swap needed for luma
+    uint32_t sum = pixel_rgb565_to_gray(gray, (const uint16_t *)decode_buf, CAMERA_GRAY_BYTES);
+    if (mean != NULL) {
+        *mean = (uint8_t)(sum / CAMERA_GRAY_BYTES);
+    }
+    return true;
+}
+
+bool esp_camera_port_preview_copy(uint8_t *dst, uint32_t *seq)
+{
+    if (preview_lock == NULL || preview_seq == *seq) {
+        return false;
     }
-    sensor_t *s = esp_camera_sensor_get();
-    s->set_vflip(s, 1);
-}
\ No newline at end of file
+    xSemaphoreTake(preview_lock, portMAX_DELAY);
+    memcpy(dst, preview, CAMERA_PREVIEW_BYTES);
+    *seq = preview_seq;
+    xSemaphoreGive(preview_lock);
+    return true;
+}
@@ -1,6 +1,106 @@
 #pragma once
 
+#include <stdint.h>
+#include <stdbool.h>
 #include "esp_camera.h"
 #include "driver/i2c_master.h"
+#include "sdkconfig.h"
 
-void esp_camera_port_init(i2c_port_num_t i2c_port);
\ No newline at end of file
+#ifndef CONFIG_GOLDIE_CAMERA
+#define CONFIG_GOLDIE_CAMERA 0
+#endif
+
+// Camera - JPEG snapshots and a small preview of the last one
+//
+// The sensor encodes JPEG itself, so a VGA frame is ~20-40 KB of DMA and
+// PSRAM traffic instead of 600 KB of RGB565. Two frame buffers with
+// CAMERA_GRAB_LATEST keep the freshest frame ready: a capture returns a
+// frame at most one frame period old, with exposure already settled.
+//
+// esp_camera_port_preview_update() decodes a frame at 1/4 scale into a
+// CAMERA_PREVIEW_W x CAMERA_PREVIEW_H RGB565 preview (LVGL byte order),
+// which the camera tile and the AI attachment use without touching the
+// camera.
+//
+// Live frames for the tile come from esp_camera_port_capture_live(): the
+// sensor drops to CAMERA_LIVE_SIZE, a quarter of the JPEG bytes, and those
+// decode at 1/2 scale into the same preview. Either capture switches the
+// sensor back as needed, dropping the frames of the old size.
+//
+// esp_camera_port_gray() decodes a live frame the same way but into 8-bit
+// luma for frame analysis (fish_activity.h), leaving the preview alone. It
+// shares the decode buffer with esp_camera_port_preview_update(): both are
+// called from the task that captures.
+//
+// esp_jpg_decode() works in one static buffer: every decoder user (the
+// preview and luma decodes here, JPEG animation frames in frame_jpeg.h)
+// holds esp_camera_port_jpeg_take() around it.
+//
+// Without CONFIG_GOLDIE_CAMERA esp_camera_port.cpp is not built: the
+// camera never starts, and JPEG animation frames are the decoder's only
+// user, so the lock is a no-op.
+
+#define CAMERA_FRAME_SIZE      FRAMESIZE_VGA
+#define CAMERA_LIVE_SIZE       FRAMESIZE_QVGA
+#define CAMERA_JPEG_QUALITY    12         // 0-63, lower is better
+#define CAMERA_PREVIEW_W       160        // VGA / 4
+#define CAMERA_PREVIEW_H       120
+#define CAMERA_PREVIEW_BYTES   (CAMERA_PREVIEW_W * CAMERA_PREVIEW_H * 2)
+#define CAMERA_GRAY_BYTES      (CAMERA_PREVIEW_W * CAMERA_PREVIEW_H)
+
+#if CONFIG_GOLDIE_CAMERA
+
+/**
+ * @brief Start the camera in JPEG mode (SCCB over the shared I2C port)
+ * @return false if no sensor answers or it cannot do JPEG
+ */
+bool esp_camera_port_init(i2c_port_num_t i2c_port);
+
+/**
+ * @brief The latest full-size JPEG frame; hand it back with esp_camera_fb_return()
+ * @return NULL if the camera is off or no frame came
+ */
+camera_fb_t *esp_camera_port_capture(void);
+
+/**
+ * @brief The latest CAMERA_LIVE_SIZE JPEG frame, for the live preview
+ * @return NULL if the camera is off or no frame came
+ */
+camera_fb_t *esp_camera_port_capture_live(void);
+
+/**
+ * @brief Decode a full-size or live JPEG frame into the preview
+ */
+bool esp_camera_port_preview_update(const camera_fb_t *fb);
+
+/**
+ * @brief Decode a live frame into CAMERA_PREVIEW_W x CAMERA_PREVIEW_H luma
+ * @param gray CAMERA_GRAY_BYTES
+ * @param mean Mean brightness (0-255), NULL if not needed
+ */
+bool esp_camera_port_gray(const camera_fb_t *fb, uint8_t *gray, uint8_t *mean);
+
+/**
+ * @brief Copy the preview if it changed since *seq (updated)
+ * @param dst CAMERA_PREVIEW_BYTES
+ * @return false if there is nothing newer
+ */
+bool esp_camera_port_preview_copy(uint8_t *dst, uint32_t *seq);
+
+/**
+ * @brief Take / give the esp_jpg_decode() lock (any task, camera or not)
+ */
+void esp_camera_port_jpeg_take(void);
+void esp_camera_port_jpeg_give(void);
+
+#else
+// Built without the camera (esp_camera_port.cpp not compiled): no sensor
+static inline bool esp_camera_port_init(i2c_port_num_t i2c_port) { return false; }
+static inline camera_fb_t *esp_camera_port_capture(void) { return NULL; }
+static inline camera_fb_t *esp_camera_port_capture_live(void) { return NULL; }
+static inline bool esp_camera_port_preview_update(const camera_fb_t *fb) { return false; }
+static inline bool esp_camera_port_gray(const camera_fb_t *fb, uint8_t *gray, uint8_t *mean) { return false; }
+static inline bool esp_camera_port_preview_copy(uint8_t *dst, uint32_t *seq) { return false; }
+static inline void esp_camera_port_jpeg_take(void) {}
+static inline void esp_camera_port_jpeg_give(void) {}
+#endif // CONFIG_GOLDIE_CAMERA
@@ -1,3 +1,7 @@
+#include "esp_es8311_port.h"
+#include "i2c_sched.h"
+#include "hw_manifest.h"
+
 #include "esp_idf_version.h"
 
 #include "driver/i2s_std.h"
@@ -7,15 +11,15 @@
 #include "esp_codec_dev.h"
 #include "esp_codec_dev_defaults.h"
 
-
-#include "driver/i2c_master.h"
-
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 
 #include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_check.h"
 
+static const char *TAG = "esp_es8311_port";
 
 #define USE_IDF_I2C_MASTER
 
@@ -26,17 +30,21 @@
 #define I2S_DOUT_PIN 16 // 数据输出（录制）
 #define I2S_DIN_PIN 14  // 数据输入（播放）
 
-i2s_chan_handle_t tx_handle;
-i2s_chan_handle_t rx_handle;
-esp_codec_dev_handle_t output_dev;
-esp_codec_dev_handle_t input_dev;
+#define CODEC_SCCB_WAIT_MS  200
+#define PLAY_CHUNK_SAMPLES  1024      // Per write: the lock is never held for one long DMA wait
+
+static i2s_chan_handle_t tx_handle;
+static i2s_chan_handle_t rx_handle;
+static esp_codec_dev_handle_t output_dev;
+static esp_codec_dev_handle_t input_dev;
+static SemaphoreHandle_t codec_lock;
 
 static esp_err_t es8311_i2s_init(void)
 {
-    esp_err_t esp_err;
     i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_0, I2S_ROLE_MASTER);
+    chan_cfg.auto_clear = true;       // Silence, not the last DMA buffer on repeat, when idle
     i2s_std_config_t std_cfg = {};
-    std_cfg.clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(16000);
+    std_cfg.clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(ES8311_SAMPLE_RATE);
     std_cfg.slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG((i2s_data_bit_width_t)16, I2S_SLOT_MODE_STEREO);
 
     std_cfg.gpio_cfg.mclk = (gpio_num_t)I2S_MCK_PIN;
@@ -45,21 +53,20 @@ static esp_err_t es8311_i2s_init(void)
     std_cfg.gpio_cfg.dout = (gpio_num_t)I2S_DOUT_PIN;
     std_cfg.gpio_cfg.din = (gpio_num_t)I2S_DIN_PIN;
 
-    esp_err = i2s_new_channel(&chan_cfg, &tx_handle, &rx_handle);
-
-    esp_err = i2s_channel_init_std_mode(tx_handle, &std_cfg);
-
-    esp_err = i2s_channel_init_std_mode(rx_handle, &std_cfg);
+    ESP_RETURN_ON_ERROR(i2s_new_channel(&chan_cfg, &tx_handle, &rx_handle), TAG, "i2s channels");
+    ESP_RETURN_ON_ERROR(i2s_channel_init_std_mode(tx_handle, &std_cfg), TAG, "i2s tx");
+    ESP_RETURN_ON_ERROR(i2s_channel_init_std_mode(rx_handle, &std_cfg), TAG, "i2s rx");
     // For tx master using duplex mode
     i2s_channel_enable(tx_handle);
     i2s_channel_enable(rx_handle);
-
-    return esp_err;
+    return ESP_OK;
 }
 
-void esp_es8311_port_init(i2c_master_bus_handle_t bus_handle)
+/**
+ * @brief Codec register setup (caller holds an I2C slot)
+ */
+static esp_err_t es8311_codec_init(i2c_master_bus_handle_t bus_handle)
 {
-    es8311_i2s_init();
     audio_codec_i2s_cfg_t i2s_cfg = {
         .rx_handle = rx_handle,
         .tx_handle = tx_handle,
@@ -84,57 +91,142 @@ void esp_es8311_port_init(i2c_master_bus_handle_t bus_handle)
     es8311_cfg.hw_gain.codec_dac_voltage = 3.3;
 
     const audio_codec_if_t *codec_if = es8311_codec_new(&es8311_cfg);
+    if (data_if == NULL || ctrl_if == NULL || codec_if == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
 
-    static  esp_codec_dev_cfg_t dev_cfg = {
+    static esp_codec_dev_cfg_t dev_cfg = {
         .dev_type = ESP_CODEC_DEV_TYPE_OUT,
         .codec_if = codec_if,
         .data_if = data_if,
     };
     output_dev = esp_codec_dev_new(&dev_cfg);
-    assert(output_dev != NULL);
 
     dev_cfg.dev_type = ESP_CODEC_DEV_TYPE_IN;
     input_dev = esp_codec_dev_new(&dev_cfg);
-    assert(input_dev != NULL);
+    if (output_dev == NULL || input_dev == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
     esp_codec_set_disable_when_closed(output_dev, false);
     esp_codec_set_disable_when_closed(input_dev, false);
 
     esp_codec_dev_sample_info_t fs = {};
-    fs.sample_rate = 48000;
+    fs.sample_rate = ES8311_SAMPLE_RATE;
     fs.channel = 1;
     fs.bits_per_sample = 16;
     fs.channel_mask = 0;
     fs.mclk_multiple = 0;
 
-    esp_codec_dev_open(output_dev, &fs);
-    esp_codec_dev_open(input_dev, &fs);
+    if (esp_codec_dev_open(output_dev, &fs) != ESP_CODEC_DEV_OK ||
+        esp_codec_dev_open(input_dev, &fs) != ESP_CODEC_DEV_OK) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    esp_codec_dev_set_out_vol(output_dev, 0.0);
+    return ESP_OK;
 }
 
+esp_err_t esp_es8311_port_init(i2c_master_bus_handle_t bus_handle)
+{
+    if (hw_manifest_lacked(HW_CODEC)) {
+        ESP_LOGI(TAG, "No ES8311 before the reset - not probing");
+        hw_manifest_set(HW_CODEC, false, 0);
+        return ESP_ERR_NOT_FOUND;
+    }
+    // Bounded probe before I2S is set up for nothing (8-bit address form)
+    esp_err_t err = hw_manifest_probe_i2c(bus_handle, ES8311_CODEC_DEFAULT_ADDR >> 1);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "No ES8311 (%s) - audio off", esp_err_to_name(err));
+        hw_manifest_set(HW_CODEC, false, 0);
+        return err;
+    }
+    codec_lock = xSemaphoreCreateMutex();
+    if (codec_lock == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_RETURN_ON_ERROR(es8311_i2s_init(), TAG, "i2s");
+
+    if (!i2c_sched_begin(I2C_SCHED_SENSOR, pdMS_TO_TICKS(CODEC_SCCB_WAIT_MS))) {
+        return ESP_ERR_TIMEOUT;
+    }
+    err = es8311_codec_init(bus_handle);
+    i2c_sched_end(I2C_SCHED_SENSOR);
+    if (err != ESP_OK) {
+        output_dev = NULL;
+        input_dev = NULL;
+        ESP_LOGW(TAG, "No ES8311 (%s) - audio off", esp_err_to_name(err));
+        hw_manifest_set(HW_CODEC, false, 0);
+        return err;
+    }
+    hw_manifest_set(HW_CODEC, true, 0);
+    ESP_LOGI(TAG, "ES8311 up: %d Hz mono", ES8311_SAMPLE_RATE);
+    return ESP_OK;
+}
 
+static void set_out_vol(int volume)
+{
+    if (i2c_sched_begin(I2C_SCHED_SENSOR, pdMS_TO_TICKS(CODEC_SCCB_WAIT_MS))) {
+        esp_codec_dev_set_out_vol(output_dev, (float)volume);
+        i2c_sched_end(I2C_SCHED_SENSOR);
+    }
+}
+
+static void set_in_gain(float db)
+{
+    if (i2c_sched_begin(I2C_SCHED_SENSOR, pdMS_TO_TICKS(CODEC_SCCB_WAIT_MS))) {
+        esp_codec_dev_set_in_gain(input_dev, db);
+        i2c_sched_end(I2C_SCHED_SENSOR);
+    }
+}
+
+esp_err_t esp_es8311_port_play(const int16_t *pcm, size_t samples, int volume)
+{
+    if (output_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(codec_lock, portMAX_DELAY);
+    set_out_vol(volume);
+    esp_err_t err = ESP_OK;
+    for (size_t done = 0; done < samples && err == ESP_OK; done += PLAY_CHUNK_SAMPLES) {
+        size_t n = samples - done < PLAY_CHUNK_SAMPLES ? samples - done : PLAY_CHUNK_SAMPLES;
+        if (esp_codec_dev_write(output_dev, (void *)(pcm + done), (int)(n * sizeof(int16_t))) != ESP_CODEC_DEV_OK) {
+            err = ESP_FAIL;
+        }
+    }
+    set_out_vol(0);
+    xSemaphoreGive(codec_lock);
+    return err;
+}
 
 void esp_es8311_test(void)
 {
+    if (output_dev == NULL || input_dev == NULL) {
+        printf("ES8311 not initialised\n");
+        return;
+    }
     int err = 0;
     // 2 Sec
-    const int limit_size = 2 * 48000 * 1 * (16 >> 3);
+    const int limit_size = 2 * ES8311_SAMPLE_RATE * 1 * (16 >> 3);
 
     uint8_t *data = (uint8_t *)heap_caps_malloc(limit_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-    esp_codec_dev_set_in_gain(input_dev, 40.0);
+    if (data == NULL) {
+        return;
+    }
+    xSemaphoreTake(codec_lock, portMAX_DELAY);
+    set_in_gain(40.0);
     err = esp_codec_dev_read(input_dev, data, limit_size);
-    esp_codec_dev_set_in_gain(input_dev, 0.0);
+    set_in_gain(0.0);
+    xSemaphoreGive(codec_lock);
     
     if (err == ESP_CODEC_DEV_OK)
         printf("Read %d bytes\n", limit_size);
     else
         printf("Read error %d\n", err);
     
-    esp_codec_dev_set_out_vol(output_dev, 70.0);
-    err = esp_codec_dev_write(output_dev, data, limit_size);
-    esp_codec_dev_set_out_vol(output_dev, 0.0);
-    if (err == ESP_CODEC_DEV_OK)
+    err = esp_es8311_port_play((const int16_t *)data, limit_size / sizeof(int16_t), 70);
+    if (err == ESP_OK)
         printf("Write %d bytes\n", limit_size);
     else
         printf("Write error %d\n", err);
     
     heap_caps_free(data);
-}
\ No newline at end of file
+}
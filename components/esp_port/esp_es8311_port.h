@@ -1,8 +1,34 @@
 #pragma once
 
 #include <stdio.h>
+#include <stdint.h>
+#include "esp_err.h"
 #include "driver/i2c_master.h"
 
-void esp_es8311_port_init(i2c_master_bus_handle_t bus_handle);
-void esp_es8311_test(void);
+// ES8311 codec - speaker out and microphone in over I2S 0
+//
+// Both directions run at ES8311_SAMPLE_RATE, 16-bit mono. The I2S TX
+// channel sends silence whenever no data is queued (auto clear), so the
+// speaker is quiet between sounds without closing the codec. Register
+// access (init, volume) goes over the shared I2C bus in i2c_sched SENSOR
+// slots; PCM goes over I2S DMA only. Playback and the record test are
+// serialised by the port.
+
+#define ES8311_SAMPLE_RATE   16000
+
+/**
+ * @brief Bring up I2S and the codec
+ * @return ESP_ERR_NOT_FOUND if the codec does not answer
+ */
+esp_err_t esp_es8311_port_init(i2c_master_bus_handle_t bus_handle);
 
+/**
+ * @brief Play 16-bit mono PCM at ES8311_SAMPLE_RATE (blocks for its length)
+ * @param volume 0-100
+ */
+esp_err_t esp_es8311_port_play(const int16_t *pcm, size_t samples, int volume);
+
+/**
+ * @brief Record two seconds and play them back (system tile)
+ */
+void esp_es8311_test(void);
@@ -1,29 +1,182 @@
-
+#include "esp_pcf85063_port.h"
 #include "SensorPCF85063.hpp"
+#include "i2c_sched.h"
+#include "hw_manifest.h"
+#include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "driver/i2c_master.h"
+#include <string.h>
+
+static const char *TAG = "esp_pcf85063_port";
 
-SensorPCF85063 rtc;
+#define PCF85063_BUS_WAIT_MS  50
+#define PCF85063_OS_FLAG      0x80        // Seconds register: oscillator stopped
 
-void esp_pcf85063_port_init(i2c_master_bus_handle_t bus_handle)
+/**
+ * @brief The library's driver, with the raw register access it keeps protected
+ */
+class PortPCF85063 : public SensorPCF85063
 {
-    while (!rtc.begin(bus_handle, PCF85063_SLAVE_ADDRESS))
+public:
+    bool readTime(uint8_t buf[7])
+    {
+        return readRegister(PCF85063_SEC_REG, buf, 7) != DEV_WIRE_ERR;
+    }
+
+    bool writeTime(const uint8_t buf[7])
+    {
+        uint8_t copy[7];
+        memcpy(copy, buf, sizeof(copy));
+        return writeRegister(PCF85063_SEC_REG, copy, 7) != DEV_WIRE_ERR;
+    }
+
+    int readOffset()
     {
-        printf("Failed to find PCF8563 - check your wiring!\r\n");
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        return readRegister(PCF85063_OFFSET_REG);
     }
-    RTC_DateTime datetime = rtc.getDateTime();
 
-    if (datetime.year < 2025)
+    bool writeOffset(uint8_t val)
     {
-        datetime.year = 2025;
-        datetime.month = 1;
-        datetime.day = 1;
-        datetime.hour = 12;
-        datetime.minute = 0;
-        datetime.second = 0;
-        rtc.setDateTime(datetime.year, datetime.month, datetime.day, datetime.hour, datetime.minute, datetime.second);
-    }
-    rtc.start();
-}
\ No newline at end of file
+        return writeRegister(PCF85063_OFFSET_REG, val) != DEV_WIRE_ERR;
+    }
+};
+
+static PortPCF85063 rtc;
+static bool rtc_up = false;
+
+static inline uint8_t bcd2dec(uint8_t v)
+{
+    return (v >> 4) * 10 + (v & 0x0F);
+}
+
+static inline uint8_t dec2bcd(int v)
+{
+    return (uint8_t)(((v / 10) << 4) | (v % 10));
+}
+
+/**
+ * @brief Days since 1970-01-01 of a proleptic Gregorian date (no TZ involved)
+ */
+static int64_t days_from_civil(int y, int m, int d)
+{
+    y -= m <= 2;
+    const int era = y / 400;
+    const int yoe = y - era * 400;
+    const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return (int64_t)era * 146097 + doe - 719468;
+}
+
+bool esp_pcf85063_port_init(i2c_master_bus_handle_t bus_handle)
+{
+    if (hw_manifest_lacked(HW_RTC)) {
+        ESP_LOGI(TAG, "No PCF85063 before the reset - not probing");
+        hw_manifest_set(HW_RTC, false, 0);
+        return false;
+    }
+    for (int attempt = 0; attempt < PCF85063_PROBE_TRIES && !rtc_up; attempt++) {
+        if (attempt > 0) {
+            vTaskDelay(pdMS_TO_TICKS(PCF85063_PROBE_GAP_MS));
+        }
+        rtc_up = hw_manifest_probe_i2c(bus_handle, PCF85063_SLAVE_ADDRESS) == ESP_OK &&
+                 rtc.begin(bus_handle, PCF85063_SLAVE_ADDRESS);
+    }
+    if (!rtc_up) {
+        ESP_LOGW(TAG, "No PCF85063 after %d tries - RTC off", PCF85063_PROBE_TRIES);
+    }
+    hw_manifest_set(HW_RTC, rtc_up, 0);
+    return rtc_up;
+}
+
+esp_err_t esp_pcf85063_port_read(time_t *out)
+{
+    if (!rtc_up) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    uint8_t buf[7];
+    if (!i2c_sched_begin(I2C_SCHED_SENSOR, pdMS_TO_TICKS(PCF85063_BUS_WAIT_MS))) {
+        return ESP_ERR_TIMEOUT;
+    }
+    bool ok = rtc.readTime(buf);
+    i2c_sched_end(I2C_SCHED_SENSOR);
+    if (!ok) {
+        return ESP_FAIL;
+    }
+    if (buf[0] & PCF85063_OS_FLAG) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int sec = bcd2dec(buf[0] & 0x7F);
+    int min = bcd2dec(buf[1] & 0x7F);
+    int hour = bcd2dec(buf[2] & 0x3F);
+    int day = bcd2dec(buf[3] & 0x3F);
+    int month = bcd2dec(buf[5] & 0x1F);
+    int year = bcd2dec(buf[6]) + 2000;
+    if (year < PCF85063_YEAR_MIN || month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || min > 59 ||
+        sec > 59) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    *out = (time_t)(days_from_civil(year, month, day) * 86400 + hour * 3600 + min * 60 + sec);
+    return ESP_OK;
+}
+
+esp_err_t esp_pcf85063_port_write(time_t t)
+{
+    if (!rtc_up) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    if (tm.tm_year + 1900 < PCF85063_YEAR_MIN || tm.tm_year + 1900 > 2099) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint8_t buf[7];
+    buf[0] = dec2bcd(tm.tm_sec);              // OS flag cleared
+    buf[1] = dec2bcd(tm.tm_min);
+    buf[2] = dec2bcd(tm.tm_hour);
+    buf[3] = dec2bcd(tm.tm_mday);
+    buf[4] = (uint8_t)tm.tm_wday;
+    buf[5] = dec2bcd(tm.tm_mon + 1);
+    buf[6] = dec2bcd(tm.tm_year + 1900 - 2000);
+
+    if (!i2c_sched_begin(I2C_SCHED_SENSOR, pdMS_TO_TICKS(PCF85063_BUS_WAIT_MS))) {
+        return ESP_ERR_TIMEOUT;
+    }
+    bool ok = rtc.writeTime(buf);
+    i2c_sched_end(I2C_SCHED_SENSOR);
+    return ok ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_pcf85063_port_get_offset(int8_t *steps)
+{
+    if (!rtc_up) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (!i2c_sched_begin(I2C_SCHED_SENSOR, pdMS_TO_TICKS(PCF85063_BUS_WAIT_MS))) {
+        return ESP_ERR_TIMEOUT;
+    }
+    int val = rtc.readOffset();
+    i2c_sched_end(I2C_SCHED_SENSOR);
+    if (val == DEV_WIRE_ERR) {
+        return ESP_FAIL;
+    }
+    // Bit 7 selects the correction mode; bits 6..0 are two's complement
+    *steps = (int8_t)((val & 0x40) ? (val | 0x80) : (val & 0x7F));
+    return ESP_OK;
+}
+
+esp_err_t esp_pcf85063_port_set_offset(int8_t steps)
+{
+    if (!rtc_up) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (steps < PCF85063_OFFSET_MIN || steps > PCF85063_OFFSET_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!i2c_sched_begin(I2C_SCHED_SENSOR, pdMS_TO_TICKS(PCF85063_BUS_WAIT_MS))) {
+        return ESP_ERR_TIMEOUT;
+    }
+    bool ok = rtc.writeOffset((uint8_t)steps & 0x7F);    // Normal mode
+    i2c_sched_end(I2C_SCHED_SENSOR);
+    return ok ? ESP_OK : ESP_FAIL;
+}
@@ -1,8 +1,45 @@
 #pragma once
 
-#include "SensorPCF85063.hpp"
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "esp_err.h"
 #include "driver/i2c_master.h"
 
-extern SensorPCF85063 rtc;
+// PCF85063 real-time clock - UTC seconds in and out
+//
+// The RTC keeps UTC (like the system clock, TZ "UTC-0"). Its OS flag is
+// set when the backup supply dropped: the time is then unknown and reads
+// report ESP_ERR_INVALID_STATE until the next write clears it.
+//
+// The offset register trims the crystal in PCF85063_OFFSET_PPM steps
+// (normal mode, applied every two hours): positive values speed the clock
+// up, negative ones slow it down. Every call returns ESP_ERR_NOT_FOUND if
+// the probe found no RTC.
 
-void esp_pcf85063_port_init(i2c_master_bus_handle_t bus_handle);
\ No newline at end of file
+#define PCF85063_PROBE_TRIES    3
+#define PCF85063_PROBE_GAP_MS   20
+#define PCF85063_OFFSET_PPM     4.34f     // One offset step, normal mode
+#define PCF85063_OFFSET_MIN     (-64)
+#define PCF85063_OFFSET_MAX     63
+#define PCF85063_YEAR_MIN       2024      // Earlier is a clock that was never set
+
+/**
+ * @brief Probe the RTC and make sure it runs (24-hour mode)
+ * @return false if it does not answer
+ */
+bool esp_pcf85063_port_init(i2c_master_bus_handle_t bus_handle);
+
+/**
+ * @brief Read the RTC as a Unix time
+ * @return ESP_ERR_INVALID_STATE if it lost power or was never set
+ */
+esp_err_t esp_pcf85063_port_read(time_t *out);
+
+/**
+ * @brief Set the RTC (clears the OS flag)
+ */
+esp_err_t esp_pcf85063_port_write(time_t t);
+
+esp_err_t esp_pcf85063_port_get_offset(int8_t *steps);
+esp_err_t esp_pcf85063_port_set_offset(int8_t steps);
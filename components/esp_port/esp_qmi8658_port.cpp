@@ -1,110 +1,149 @@
-#include "driver/i2c_master.h"
-#include "SensorQMI8658.hpp"
+#include "esp_qmi8658_port.h"
+#include "i2c_sched.h"
+#include "hw_manifest.h"
+#include "driver/gpio.h"
+#include "esp_log.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 
+static const char *TAG = "esp_qmi8658_port";
 
+#define QMI8658_BATCH_MS     (QMI8658_BATCH_SAMPLES * 1000 / QMI8658_ODR_HZ)
+#define QMI8658_BUS_WAIT_MS  50       // A drain waits this long for its I2C slot
 
 SensorQMI8658 qmi;
-void esp_qmi8658_port_init(i2c_master_bus_handle_t bus_handle)
-{
-    while (!qmi.begin(bus_handle, QMI8658_L_SLAVE_ADDRESS))    {
-        printf("Failed to find QMI8658 - check your wiring!\r\n");
-        vTaskDelay(pdMS_TO_TICKS(1000));
-    }
-    /* Get chip id*/
-    printf("Device ID:");
-    printf(" %x\r\n",qmi.getChipID());
 
+static SemaphoreHandle_t watermark_sem = NULL;   // Given by the INT2 edge
+static portMUX_TYPE latest_lock = portMUX_INITIALIZER_UNLOCKED;
+static IMUdata latest_acc;
+static float latest_temp = 0.0f;
+static bool latest_valid = false;
 
-    if (qmi.selfTestAccel()) {
-        printf("Accelerometer self-test successful!\r\n");
-    } else {
-        printf("Accelerometer self-test failed!\r\n");
+static void watermark_isr(void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(watermark_sem, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
     }
+}
 
-    if (qmi.selfTestGyro()) {
-        printf("Gyroscope self-test successful!\r\n");
-    } else {
-        printf("Gyroscope self-test failed!\r\n");
+/**
+ * @brief INT2 on a GPIO: the FIFO watermark ends esp_qmi8658_port_wait_batch
+ *
+ * The line is high while the FIFO holds at least the watermark and drops
+ * once it is drained, so each batch is one rising edge.
+ */
+static void watermark_int_init(void)
+{
+    const gpio_num_t pin = (gpio_num_t)CONFIG_GOLDIE_IMU_INT_GPIO;
+    watermark_sem = xSemaphoreCreateBinary();
+    if (watermark_sem == NULL) {
+        return;
     }
+    gpio_config_t io_conf = {};
+    io_conf.pin_bit_mask = 1ULL << pin;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.intr_type = GPIO_INTR_POSEDGE;
+    esp_err_t err = gpio_config(&io_conf);
+    if (err == ESP_OK) {
+        err = gpio_install_isr_service(0);
+        if (err == ESP_ERR_INVALID_STATE) {
+            err = ESP_OK;         // Already installed by another driver
+        }
+    }
+    if (err == ESP_OK) {
+        err = gpio_isr_handler_add(pin, watermark_isr, NULL);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "IMU INT on GPIO %d failed (%s) - drained on a timer", (int)pin, esp_err_to_name(err));
+        vSemaphoreDelete(watermark_sem);
+        watermark_sem = NULL;
+    }
+}
 
+bool esp_qmi8658_port_init(i2c_master_bus_handle_t bus_handle)
+{
+    if (hw_manifest_lacked(HW_IMU)) {
+        ESP_LOGI(TAG, "No QMI8658 before the reset - not probing");
+        hw_manifest_set(HW_IMU, false, 0);
+        return false;
+    }
+    bool found = false;
+    for (int attempt = 0; attempt < QMI8658_PROBE_TRIES && !found; attempt++) {
+        if (attempt > 0) {
+            vTaskDelay(pdMS_TO_TICKS(QMI8658_PROBE_GAP_MS));
+        }
+        // The bounded address probe first: the driver's reads do not time out
+        found = hw_manifest_probe_i2c(bus_handle, QMI8658_L_SLAVE_ADDRESS) == ESP_OK &&
+                qmi.begin(bus_handle, QMI8658_L_SLAVE_ADDRESS);
+    }
+    if (!found) {
+        ESP_LOGW(TAG, "No QMI8658 after %d tries - IMU off", QMI8658_PROBE_TRIES);
+        hw_manifest_set(HW_IMU, false, 0);
+        return false;
+    }
 
-    qmi.configAccelerometer(
-        /*
-         * ACC_RANGE_2G
-         * ACC_RANGE_4G
-         * ACC_RANGE_8G
-         * ACC_RANGE_16G
-         * */
-        SensorQMI8658::ACC_RANGE_4G,
-        /*
-         * ACC_ODR_1000H
-         * ACC_ODR_500Hz
-         * ACC_ODR_250Hz
-         * ACC_ODR_125Hz
-         * ACC_ODR_62_5Hz
-         * ACC_ODR_31_25Hz
-         * ACC_ODR_LOWPOWER_128Hz
-         * ACC_ODR_LOWPOWER_21Hz
-         * ACC_ODR_LOWPOWER_11Hz
-         * ACC_ODR_LOWPOWER_3H
-        * */
-        SensorQMI8658::ACC_ODR_1000Hz,
-        /*
-        *  LPF_MODE_0     //2.66% of ODR
-        *  LPF_MODE_1     //3.63% of ODR
-        *  LPF_MODE_2     //5.39% of ODR
-        *  LPF_MODE_3     //13.37% of ODR
-        *  LPF_OFF        // OFF Low-Pass Fitter
-        * */
-        SensorQMI8658::LPF_MODE_0);
-
-
+    // Low-power mode needs the gyroscope off, which the gestures never use
+    qmi.disableGyroscope();
+    qmi.configAccelerometer(SensorQMI8658::ACC_RANGE_4G, SensorQMI8658::ACC_ODR_LOWPOWER_128Hz,
+                            SensorQMI8658::LPF_MODE_0);
+    bool use_int = CONFIG_GOLDIE_IMU_INT_GPIO >= 0;
+    if (qmi.configFIFO(SensorQMI8658::FIFO_MODE_STREAM, SensorQMI8658::FIFO_SAMPLES_64,
+                       use_int ? SensorQMI8658::INTERRUPT_PIN_2 : SensorQMI8658::INTERRUPT_PIN_DISABLE,
+                       QMI8658_BATCH_SAMPLES) != DEV_WIRE_NONE) {
+        ESP_LOGW(TAG, "QMI8658 FIFO setup failed - IMU off");
+        hw_manifest_set(HW_IMU, false, 0);
+        return false;
+    }
+    qmi.enableAccelerometer();
+    if (use_int) {
+        qmi.enableINT(SensorQMI8658::INTERRUPT_PIN_2);
+        watermark_int_init();
+    }
+    hw_manifest_set(HW_IMU, true, 0);
+    ESP_LOGI(TAG, "QMI8658 (id %x): accel %d Hz into the FIFO, drained every %d ms%s", qmi.getChipID(),
+             QMI8658_ODR_HZ, QMI8658_BATCH_MS, watermark_sem ? " on INT2" : "");
+    return true;
+}
 
+void esp_qmi8658_port_wait_batch(void)
+{
+    if (watermark_sem == NULL) {
+        vTaskDelay(pdMS_TO_TICKS(QMI8658_BATCH_MS));
+        return;
+    }
+    // A missed edge (drain skipped while the bus was busy) costs one period
+    xSemaphoreTake(watermark_sem, pdMS_TO_TICKS(2 * QMI8658_BATCH_MS));
+}
 
-    qmi.configGyroscope(
-        /*
-        * GYR_RANGE_16DPS
-        * GYR_RANGE_32DPS
-        * GYR_RANGE_64DPS
-        * GYR_RANGE_128DPS
-        * GYR_RANGE_256DPS
-        * GYR_RANGE_512DPS
-        * GYR_RANGE_1024DPS
-        * */
-        SensorQMI8658::GYR_RANGE_64DPS,
-        /*
-         * GYR_ODR_7174_4Hz
-         * GYR_ODR_3587_2Hz
-         * GYR_ODR_1793_6Hz
-         * GYR_ODR_896_8Hz
-         * GYR_ODR_448_4Hz
-         * GYR_ODR_224_2Hz
-         * GYR_ODR_112_1Hz
-         * GYR_ODR_56_05Hz
-         * GYR_ODR_28_025H
-         * */
-        SensorQMI8658::GYR_ODR_896_8Hz,
-        /*
-        *  LPF_MODE_0     //2.66% of ODR
-        *  LPF_MODE_1     //3.63% of ODR
-        *  LPF_MODE_2     //5.39% of ODR
-        *  LPF_MODE_3     //13.37% of ODR
-        *  LPF_OFF        // OFF Low-Pass Fitter
-        * */
-        SensorQMI8658::LPF_MODE_3);
+uint16_t esp_qmi8658_port_read_batch(IMUdata *acc, uint16_t max)
+{
+    if (!i2c_sched_begin(I2C_SCHED_SENSOR, pdMS_TO_TICKS(QMI8658_BUS_WAIT_MS))) {
+        return 0;                 // The FIFO keeps them for the next drain
+    }
+    uint16_t n = qmi.readFromFifo(acc, max, NULL, 0);
+    float temp = qmi.getTemperature_C();
+    i2c_sched_end(I2C_SCHED_SENSOR);
 
-    /*
-    * If both the accelerometer and gyroscope sensors are turned on at the same time,
-    * the output frequency will be based on the gyroscope output frequency.
-    * The example configuration is 896.8HZ output frequency,
-    * so the acceleration output frequency is also limited to 896.8HZ
-    * */
-    qmi.enableGyroscope();
-    qmi.enableAccelerometer();
+    if (n > 0) {
+        portENTER_CRITICAL(&latest_lock);
+        latest_acc = acc[n - 1];
+        latest_temp = temp;
+        latest_valid = true;
+        portEXIT_CRITICAL(&latest_lock);
+    }
+    return n;
+}
 
-    // Print register configuration information
-    qmi.dumpCtrlRegister();
-}
\ No newline at end of file
+bool esp_qmi8658_port_latest(IMUdata *acc, float *temp_c)
+{
+    portENTER_CRITICAL(&latest_lock);
+    bool valid = latest_valid;
+    *acc = latest_acc;
+    *temp_c = latest_temp;
+    portEXIT_CRITICAL(&latest_lock);
+    return valid;
+}
@@ -1,7 +1,49 @@
-#pragma once 
+#pragma once
 #include "driver/i2c_master.h"
+#include "freertos/FreeRTOS.h"
 #include "SensorQMI8658.hpp"
 
+// QMI8658 IMU - accelerometer only, batched through the chip's FIFO
+//
+// The accelerometer runs in its low-power 128 Hz mode (the gyroscope is
+// off: the gestures only need gravity and taps). Samples collect in a
+// QMI8658_FIFO_SAMPLES stream FIFO and are drained in one burst every
+// QMI8658_BATCH_SAMPLES: on the watermark interrupt when INT2 is wired to
+// CONFIG_GOLDIE_IMU_INT_GPIO, otherwise on a timer of the same period.
+// Drains run as I2C_SCHED_SENSOR slots (i2c_sched.h).
+
+#ifndef CONFIG_GOLDIE_IMU_INT_GPIO
+#define CONFIG_GOLDIE_IMU_INT_GPIO -1
+#endif
+
+#define QMI8658_ODR_HZ          128
+#define QMI8658_FIFO_SAMPLES    64     // FIFO depth: room for a late drain
+#define QMI8658_BATCH_SAMPLES   32     // Watermark: one drain per 250 ms
+#define QMI8658_PROBE_TRIES     3
+#define QMI8658_PROBE_GAP_MS    20
+
 extern SensorQMI8658 qmi;
 
-void esp_qmi8658_port_init(i2c_master_bus_handle_t bus_handle);
\ No newline at end of file
+/**
+ * @brief Probe and configure the IMU (gives up after QMI8658_PROBE_TRIES)
+ * @return false if the chip did not answer - nothing else here may be called
+ */
+bool esp_qmi8658_port_init(i2c_master_bus_handle_t bus_handle);
+
+/**
+ * @brief Wait until a batch should be ready (watermark interrupt or timer)
+ */
+void esp_qmi8658_port_wait_batch(void);
+
+/**
+ * @brief Burst-read everything in the FIFO
+ * @param acc Samples in g, oldest first
+ * @return Samples read (0 if the bus was busy or the FIFO empty)
+ */
+uint16_t esp_qmi8658_port_read_batch(IMUdata *acc, uint16_t max);
+
+/**
+ * @brief Newest sample and die temperature from the last drain (any task)
+ * @return false before the first drain
+ */
+bool esp_qmi8658_port_latest(IMUdata *acc, float *temp_c);
@@ -8,6 +8,11 @@
 
 #include "esp_check.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "sdkconfig.h"
+#include "hw_manifest.h"
+#include <fcntl.h>
 
 sdmmc_card_t *card = NULL;
 
@@ -25,52 +30,192 @@ uint64_t esp_sdcard_port_get_size(void)
     return sdcard_size;
 }
 
-void esp_sdcard_port_init(void)
+uint64_t esp_sdcard_port_get_free(void)
 {
-    esp_err_t ret;
-
-    // Options for mounting the filesystem.
-    // If format_if_mount_failed is set to true, SD card will be partitioned and
-    // formatted in case when mounting fails.
-    esp_vfs_fat_sdmmc_mount_config_t mount_config = {
-        .format_if_mount_failed = false,
-        .max_files = 5,
-        .allocation_unit_size = 16 * 1024};
-    const char mount_point[] = "/sdcard";
-    ESP_LOGI(TAG, "Initializing SD card");
+    uint64_t total = 0, free_bytes = 0;
+    if (card == NULL || esp_vfs_fat_info("/sdcard", &total, &free_bytes) != ESP_OK) {
+        return 0;
+    }
+    return free_bytes;
+}
 
-    // Use settings defined above to initialize SD card and mount FAT filesystem.
-    // Note: esp_vfs_fat_sdmmc/sdspi_mount is all-in-one convenience functions.
-    // Please check its source code and implement error recovery when developing
-    // production applications.
+#ifndef CONFIG_GOLDIE_SD_BUS_WIDTH
+#define CONFIG_GOLDIE_SD_BUS_WIDTH 1
+#endif
+#ifndef CONFIG_GOLDIE_SD_FREQ_KHZ
+#define CONFIG_GOLDIE_SD_FREQ_KHZ SDMMC_FREQ_HIGHSPEED
+#endif
+#ifndef CONFIG_GOLDIE_SD_PIN_D1
+#define CONFIG_GOLDIE_SD_PIN_D1 -1
+#endif
+#ifndef CONFIG_GOLDIE_SD_PIN_D2
+#define CONFIG_GOLDIE_SD_PIN_D2 -1
+#endif
+#ifndef CONFIG_GOLDIE_SD_PIN_D3
+#define CONFIG_GOLDIE_SD_PIN_D3 -1
+#endif
 
-    ESP_LOGI(TAG, "Using SDMMC peripheral");
+#define SD_SELFTEST_PATH   "/sdcard/.speedtest"
+#define SD_SELFTEST_BYTES  (512 * 1024)
+#define SD_SELFTEST_CHUNK  (16 * 1024)
 
+static esp_err_t sdcard_mount(const char *mount_point, const esp_vfs_fat_sdmmc_mount_config_t *mount_config,
+                              uint8_t width, int freq_khz)
+{
     // By default, SD card frequency is initialized to SDMMC_FREQ_DEFAULT (20MHz)
-    // For setting a specific frequency, use host.max_freq_khz (range 400kHz - 40MHz for SDMMC)
-    // Example: for fixed frequency of 10MHz, use host.max_freq_khz = 10000;
+    // host.max_freq_khz selects high speed (40MHz) where the card supports it
     sdmmc_host_t host = SDMMC_HOST_DEFAULT();
+    host.max_freq_khz = freq_khz;
 
     sdmmc_slot_config_t slot_config = SDMMC_SLOT_CONFIG_DEFAULT();
 
-    slot_config.width = 1;
+    slot_config.width = width;
 
     // On chips where the GPIOs used for SD card can be configured, set them in
     // the slot_config structure:
     slot_config.clk = EXAMPLE_PIN_SD_CLK;
     slot_config.cmd = EXAMPLE_PIN_SD_CMD;
     slot_config.d0 = EXAMPLE_PIN_SD_D0;
+    if (width == 4) {
+        slot_config.d1 = (gpio_num_t)CONFIG_GOLDIE_SD_PIN_D1;
+        slot_config.d2 = (gpio_num_t)CONFIG_GOLDIE_SD_PIN_D2;
+        slot_config.d3 = (gpio_num_t)CONFIG_GOLDIE_SD_PIN_D3;
+    }
 
     // Enable internal pullups on enabled pins. The internal pullups
     // are insufficient however, please make sure 10k external pullups are
     // connected on the bus. This is for debug / example purpose only.
     slot_config.flags |= SDMMC_SLOT_FLAG_INTERNAL_PULLUP;
 
-    ESP_LOGI(TAG, "Mounting filesystem");
-    ret = esp_vfs_fat_sdmmc_mount(mount_point, &host, &slot_config, &mount_config, &card);
+    ESP_LOGI(TAG, "Mounting filesystem (%d-bit, %d kHz)", width, freq_khz);
+    return esp_vfs_fat_sdmmc_mount(mount_point, &host, &slot_config, mount_config, &card);
+}
+
+/**
+ * @brief Write, then read back a scratch file and log the throughput
+ *
+ * Uses POSIX read/write with an internal DMA-capable buffer so the result
+ * reflects the bus and card, not stdio or PSRAM bounce copies.
+ */
+static void sdcard_self_test(void)
+{
+    uint8_t *buf = (uint8_t *)heap_caps_aligned_alloc(512, SD_SELFTEST_CHUNK, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (buf == NULL) {
+        ESP_LOGW(TAG, "Self-test skipped: no DMA memory");
+        return;
+    }
+    for (int i = 0; i < SD_SELFTEST_CHUNK; i++) {
+        buf[i] = (uint8_t)i;
+    }
+
+    int fd = open(SD_SELFTEST_PATH, O_WRONLY | O_CREAT | O_TRUNC);
+    if (fd < 0) {
+        ESP_LOGW(TAG, "Self-test skipped: cannot create %s", SD_SELFTEST_PATH);
+        heap_caps_free(buf);
+        return;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    size_t written = 0;
+    while (written < SD_SELFTEST_BYTES && write(fd, buf, SD_SELFTEST_CHUNK) == SD_SELFTEST_CHUNK) {
+        written += SD_SELFTEST_CHUNK;
+    }
+    fsync(fd);
+    int64_t write_us = esp_timer_get_time() - t0;
+    close(fd);
+
+    size_t read_bytes = 0;
+    int64_t read_us = 0;
+    fd = open(SD_SELFTEST_PATH, O_RDONLY);
+    if (fd >= 0) {
+        t0 = esp_timer_get_time();
+        ssize_t n;
+        while ((n = read(fd, buf, SD_SELFTEST_CHUNK)) > 0) {
+            read_bytes += n;
+        }
+        read_us = esp_timer_get_time() - t0;
+        close(fd);
+    }
+    unlink(SD_SELFTEST_PATH);
+    heap_caps_free(buf);
+
+    // bytes per microsecond == MB/s
+    ESP_LOGI(TAG, "Self-test: write %.2f MB/s, read %.2f MB/s (%u KB)",
+             write_us > 0 ? (double)written / write_us : 0.0,
+             read_us > 0 ? (double)read_bytes / read_us : 0.0,
+             (unsigned)(SD_SELFTEST_BYTES / 1024));
+}
+
+bool esp_sdcard_port_is_mounted(void)
+{
+    return card != NULL;
+}
+
+esp_err_t esp_sdcard_port_mount(void)
+{
+    esp_err_t ret = ESP_FAIL;
+    if (card != NULL) {
+        return ESP_OK;
+    }
+
+    // Options for mounting the filesystem.
+    // If format_if_mount_failed is set to true, SD card will be partitioned and
+    // formatted in case when mounting fails.
+    esp_vfs_fat_sdmmc_mount_config_t mount_config = {
+        .format_if_mount_failed = false,
+        .max_files = 5,
+        .allocation_unit_size = 16 * 1024};
+    const char mount_point[] = "/sdcard";
+    ESP_LOGI(TAG, "Initializing SD card");
+
+    // Use settings defined above to initialize SD card and mount FAT filesystem.
+    // Note: esp_vfs_fat_sdmmc/sdspi_mount is all-in-one convenience functions.
+    // Please check its source code and implement error recovery when developing
+    // production applications.
+
+    ESP_LOGI(TAG, "Using SDMMC peripheral");
 
+    // Try the configured bus first, then step down: 1-bit at the same clock,
+    // then 1-bit at the default 20 MHz. 4-bit needs D1-D3 wired (menuconfig).
+    // After a warm reset the mode that worked before goes first.
+    typedef struct { uint8_t width; int freq_khz; } sd_bus_mode_t;
+    sd_bus_mode_t modes[4];
+    size_t mode_count = 0;
+    uint32_t last_mode;
+    if (hw_manifest_had(HW_SD, &last_mode)) {
+        modes[mode_count++] = { (uint8_t)(last_mode >> 24), (int)(last_mode & 0xFFFFFF) };
+    }
+    modes[mode_count++] = { (uint8_t)CONFIG_GOLDIE_SD_BUS_WIDTH, CONFIG_GOLDIE_SD_FREQ_KHZ };
+    modes[mode_count++] = { 1, CONFIG_GOLDIE_SD_FREQ_KHZ };
+    modes[mode_count++] = { 1, SDMMC_FREQ_DEFAULT };
+
+    sd_bus_mode_t mounted = {};
+    for (size_t i = 0; i < mode_count; i++) {
+        bool tried = false;
+        for (size_t k = 0; k < i; k++) {
+            tried |= modes[k].width == modes[i].width && modes[k].freq_khz == modes[i].freq_khz;
+        }
+        if (tried) {
+            continue;
+        }
+        if (modes[i].width == 4 &&
+            (CONFIG_GOLDIE_SD_PIN_D1 < 0 || CONFIG_GOLDIE_SD_PIN_D2 < 0 || CONFIG_GOLDIE_SD_PIN_D3 < 0)) {
+            ESP_LOGW(TAG, "4-bit bus requested but D1-D3 pins are not set - using 1-bit");
+            continue;
+        }
+        ret = sdcard_mount(mount_point, &mount_config, modes[i].width, modes[i].freq_khz);
+        // A missing or unformatted card won't mount in any mode
+        if (ret == ESP_OK || ret == ESP_FAIL) {
+            mounted = modes[i];
+            break;
+        }
+        ESP_LOGW(TAG, "Probe failed (%s), falling back", esp_err_to_name(ret));
+    }
+
+    hw_manifest_set(HW_SD, ret == ESP_OK, ((uint32_t)mounted.width << 24) | (uint32_t)mounted.freq_khz);
     if (ret != ESP_OK)
     {
+        card = NULL;
         if (ret == ESP_FAIL)
         {
             ESP_LOGE(TAG, "Failed to mount filesystem. "
@@ -82,10 +227,31 @@ void esp_sdcard_port_init(void)
                           "Make sure SD card lines have pull-up resistors in place.",
                      esp_err_to_name(ret));
         }
-        return;
+        return ret;
     }
     ESP_LOGI(TAG, "Filesystem mounted");
+    return ESP_OK;
+}
+
+void esp_sdcard_port_init(void)
+{
+    if (hw_manifest_lacked(HW_SD)) {
+        // Each bus mode would time out again; the logger's remount probe
+        // (CONFIG_GOLDIE_SDLOG_REMOUNT_S) still finds a card inserted later
+        ESP_LOGI(TAG, "No card before the reset - not probing at boot");
+        hw_manifest_set(HW_SD, false, 0);
+        return;
+    }
+    if (esp_sdcard_port_mount() != ESP_OK) {
+        return;
+    }
 
     // Card has been initialized, print its properties
     sdmmc_card_print_info(stdout, card);
+
+#if CONFIG_GOLDIE_SD_SELFTEST
+    if (!hw_manifest_warm()) {
+        sdcard_self_test();    // Not again after a crash - the same card was fine
+    }
+#endif
 }
\ No newline at end of file
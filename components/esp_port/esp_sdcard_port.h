@@ -1,6 +1,18 @@
 #pragma once
 
 #include <stdio.h>
+#include <stdbool.h>
+#include "esp_err.h"
 
 void esp_sdcard_port_init(void);
-uint64_t esp_sdcard_port_get_size(void);
\ No newline at end of file
+uint64_t esp_sdcard_port_get_size(void);
+uint64_t esp_sdcard_port_get_free(void);   // Free bytes on the FAT volume, 0 if unmounted
+
+/**
+ * @brief Mount the card at /sdcard if it is not mounted yet
+ *
+ * Lets a card inserted after boot be picked up (the logger retries
+ * this). Blocks for the card probe, so not from the LVGL task.
+ */
+esp_err_t esp_sdcard_port_mount(void);
+bool esp_sdcard_port_is_mounted(void);
\ No newline at end of file
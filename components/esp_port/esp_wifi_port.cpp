@@ -8,6 +8,7 @@
 #include "esp_event.h"
 #include "esp_log.h"
 #include "nvs_flash.h"
+#include "wifi_scan.h"
 
 #include "lwip/err.h"
 #include "lwip/sys.h"
@@ -19,12 +20,9 @@
 */
 #define EXAMPLE_ESP_MAXIMUM_RETRY 5
 
-#define DEFAULT_SCAN_LIST_SIZE 10
-
 /* FreeRTOS event group to signal when we are connected*/
 static EventGroupHandle_t s_wifi_event_group;
 
-SemaphoreHandle_t wifi_scan_Semaphore = NULL;
 SemaphoreHandle_t wifi_connect_Semaphore = NULL;
 
 /* The event group allows multiple bits for each event, but we only care about two events:
@@ -58,13 +56,6 @@ static void event_handler(void *arg, esp_event_base_t event_base,
         }
         ESP_LOGI(TAG, "connect to the AP fail");
     }
-    else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_SCAN_DONE)
-    {
-        ESP_LOGI(TAG, "WiFi scan done!!!!!");
-        // 释放信号量
-        xSemaphoreGive(wifi_scan_Semaphore);
-    }
-
     else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP)
     {
         ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
@@ -86,44 +77,6 @@ static void event_handler(void *arg, esp_event_base_t event_base,
     }
 }
 
-/* Initialize Wi-Fi as sta and set scan method */
-bool esp_wifi_port_scan(wifi_ap_record_t *ap_info, uint16_t *scan_number, uint16_t scan_max_num)
-{
-    // uint16_t number = DEFAULT_SCAN_LIST_SIZE;
-    // wifi_ap_record_t ap_info[scan_max_num];
-    esp_err_t ret = ESP_OK;
-    // memset(ap_info, 0, sizeof(ap_info));
-
-    ret = esp_wifi_scan_start(NULL, false);
-    if (ESP_OK != ret)
-        goto scan_err;
-
-    // ESP_LOGI(TAG, "Max AP number ap_info can hold = %u", number);
-
-    if (xSemaphoreTake(wifi_scan_Semaphore, pdMS_TO_TICKS(5000)))
-    {
-        esp_wifi_scan_stop();
-        ESP_ERROR_CHECK(esp_wifi_scan_get_ap_num(scan_number));
-        ESP_ERROR_CHECK(esp_wifi_scan_get_ap_records(&scan_max_num, ap_info));
-        ESP_LOGI(TAG, "Total APs scanned = %u, actual AP number ap_info holds = %u", *scan_number, scan_max_num);
-        for (int i = 0; i < scan_max_num && i < *scan_number; i++)
-        {
-            ESP_LOGI(TAG, "SSID \t\t%s", ap_info[i].ssid);
-            // memcpy(infos[i].name, ap_info[i].ssid, strlen((char *)ap_info[i].ssid));
-            ESP_LOGI(TAG, "RSSI \t\t%d", ap_info[i].rssi);
-            // infos[i].rssi = ap_info[i].rssi;
-        }
-        if (*scan_number > scan_max_num)
-        {
-            *scan_number = scan_max_num;
-        }
-        return true;
-    }
-scan_err:
-    *scan_number = 0;
-    return false;
-}
-
 esp_err_t esp_wifi_port_disconnect(void)
 {
     return esp_wifi_disconnect();
@@ -183,7 +136,6 @@ void esp_wifi_port_init(const char *ssid, const char *pass)
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
 
     s_wifi_event_group = xEventGroupCreate();
-    wifi_scan_Semaphore = xSemaphoreCreateBinary();
     wifi_connect_Semaphore = xSemaphoreCreateBinary();
 
     esp_event_handler_instance_t instance_any_id;
@@ -198,6 +150,7 @@ void esp_wifi_port_init(const char *ssid, const char *pass)
                                                         &event_handler,
                                                         NULL,
                                                         &instance_got_ip));
+    ESP_ERROR_CHECK(wifi_scan_init());
     if (ssid != NULL && pass != NULL)
     {
         esp_wifi_port_sta_connect(ssid, pass);
@@ -2,9 +2,9 @@
 
 #include <stdio.h>
 #include "esp_wifi.h"
+#include "wifi_scan.h"    // Scans: wifi_scan_request() / wifi_scan_get()
 
 void esp_wifi_port_init(const char *ssid, const char *pass);
 void esp_wifi_port_get_ip(char *ip);
-bool esp_wifi_port_scan(wifi_ap_record_t *ap_info, uint16_t *scan_number, uint16_t scan_max_num);
 esp_err_t esp_wifi_port_disconnect(void);
 esp_err_t esp_wifi_port_connect(void);
\ No newline at end of file
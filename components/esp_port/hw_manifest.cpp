@@ -0,0 +1,139 @@
+#include "hw_manifest.h"
+#include "i2c_sched.h"
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "hw_manifest";
+
+#define HW_MANIFEST_MAGIC  0x4D574847u   // "GHWM"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t probed;                     // Bit per hw_part_t: init ran to a verdict
+    uint32_t found;                      // Bit per hw_part_t: and the part answered
+    uint32_t cfg[HW_PART_COUNT];
+    uint32_t crc32;
+} hw_manifest_t;
+
+static RTC_NOINIT_ATTR hw_manifest_t rtc_manifest;   // This boot, read back by the next
+static hw_manifest_t prev;                           // Previous boot, valid if warm
+static bool warm = false;
+static portMUX_TYPE manifest_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *const part_names[HW_PART_COUNT] = {
+    "expander", "pmu", "sd", "display", "touch", "rtc", "imu", "camera", "codec",
+};
+
+static uint32_t manifest_crc(const hw_manifest_t *m)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)m, offsetof(hw_manifest_t, crc32));
+}
+
+extern "C" void hw_manifest_begin(void)
+{
+    esp_reset_reason_t reason = esp_reset_reason();
+    bool warm_reset = reason == ESP_RST_SW || reason == ESP_RST_PANIC || reason == ESP_RST_INT_WDT ||
+                      reason == ESP_RST_TASK_WDT || reason == ESP_RST_WDT;
+    warm = warm_reset && rtc_manifest.magic == HW_MANIFEST_MAGIC &&
+           rtc_manifest.crc32 == manifest_crc(&rtc_manifest);
+    if (warm) {
+        prev = rtc_manifest;
+        ESP_LOGI(TAG, "Warm reset (reason %d): trusting last boot's hardware (found 0x%02lx of 0x%02lx)",
+                 (int)reason, (unsigned long)prev.found, (unsigned long)prev.probed);
+    } else {
+        memset(&prev, 0, sizeof(prev));
+    }
+
+    portENTER_CRITICAL(&manifest_lock);
+    memset(&rtc_manifest, 0, sizeof(rtc_manifest));
+    rtc_manifest.magic = HW_MANIFEST_MAGIC;
+    rtc_manifest.crc32 = manifest_crc(&rtc_manifest);
+    portEXIT_CRITICAL(&manifest_lock);
+}
+
+extern "C" bool hw_manifest_warm(void)
+{
+    return warm;
+}
+
+extern "C" bool hw_manifest_had(hw_part_t part, uint32_t *cfg)
+{
+    if (!warm || part >= HW_PART_COUNT || !(prev.found & (1u << part))) {
+        return false;
+    }
+    if (cfg != NULL) {
+        *cfg = prev.cfg[part];
+    }
+    return true;
+}
+
+extern "C" bool hw_manifest_lacked(hw_part_t part)
+{
+    uint32_t bit = 1u << part;
+    return warm && part < HW_PART_COUNT && (prev.probed & bit) && !(prev.found & bit);
+}
+
+extern "C" void hw_manifest_set(hw_part_t part, bool found, uint32_t cfg)
+{
+    if (part >= HW_PART_COUNT) {
+        return;
+    }
+    uint32_t bit = 1u << part;
+    portENTER_CRITICAL(&manifest_lock);
+    rtc_manifest.probed |= bit;
+    if (found) {
+        rtc_manifest.found |= bit;
+    } else {
+        rtc_manifest.found &= ~bit;
+    }
+    rtc_manifest.cfg[part] = cfg;
+    rtc_manifest.crc32 = manifest_crc(&rtc_manifest);
+    portEXIT_CRITICAL(&manifest_lock);
+}
+
+extern "C" hw_status_t hw_manifest_status(hw_part_t part)
+{
+    if (part >= HW_PART_COUNT) {
+        return HW_STATUS_PENDING;
+    }
+    uint32_t bit = 1u << part;
+    portENTER_CRITICAL(&manifest_lock);
+    uint32_t probed = rtc_manifest.probed;
+    uint32_t found = rtc_manifest.found;
+    portEXIT_CRITICAL(&manifest_lock);
+    if (!(probed & bit)) {
+        return HW_STATUS_PENDING;
+    }
+    return (found & bit) ? HW_STATUS_FOUND : HW_STATUS_MISSING;
+}
+
+extern "C" void hw_manifest_log(void)
+{
+    static const char *const verdicts[] = { "pending", "ok", "none" };
+    char line[160];
+    int len = 0;
+    for (int p = 0; p < HW_PART_COUNT && len < (int)sizeof(line); p++) {
+        len += snprintf(line + len, sizeof(line) - len, "%s%s %s", p ? ", " : "", part_names[p],
+                        verdicts[hw_manifest_status((hw_part_t)p)]);
+    }
+    ESP_LOGI(TAG, "Hardware: %s", line);
+}
+
+extern "C" esp_err_t hw_manifest_probe_i2c(i2c_master_bus_handle_t bus, uint16_t addr)
+{
+    if (bus == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!i2c_sched_begin(I2C_SCHED_SENSOR, pdMS_TO_TICKS(HW_PROBE_TIMEOUT_MS))) {
+        return ESP_ERR_TIMEOUT;
+    }
+    esp_err_t err = i2c_master_probe(bus, addr, HW_PROBE_TIMEOUT_MS);
+    i2c_sched_end(I2C_SCHED_SENSOR);
+    return err;
+}
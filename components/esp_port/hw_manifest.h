@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "driver/i2c_master.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Hardware manifest - what the last boot found, kept across warm resets
+//
+// Every boot records which peripherals came up and how (SD bus mode...)
+// in RTC memory that a reset does not clear (RTC_NOINIT_ATTR, CRC
+// checked). After a software, panic or watchdog reset the boards and
+// chips around the ESP32 stayed powered, so init can trust last boot's
+// manifest: no power-cycle delays, no bus-mode fallback ladders, no
+// self-tests - the device is back in service sooner after a crash. A
+// power-on, brownout or deep-sleep wake is a cold boot: everything is
+// probed as usual.
+//
+// It is also where the port inits report to: each records found / missing
+// for its part, whether it runs in the boot graph or in a feature's own
+// task, and hw_manifest_status() tells the rest of the firmware. No init
+// waits on a missing part longer than a bounded probe
+// (hw_manifest_probe_i2c, or the driver's own retry limit); one that was
+// missing before a warm reset is not probed again.
+
+typedef enum {
+    HW_IO_EXPANDER = 0,    // TCA9554, panel power
+    HW_PMU,                // AXP2101, rails configured
+    HW_SD,                 // cfg: bus width << 24 | clock kHz
+    HW_DISPLAY,            // ST7796 panel IO and init
+    HW_TOUCH,              // FT6336
+    HW_RTC,                // PCF85063
+    HW_IMU,                // QMI8658
+    HW_CAMERA,             // cfg: sensor PID
+    HW_CODEC,              // ES8311
+    HW_PART_COUNT
+} hw_part_t;
+
+typedef enum {
+    HW_STATUS_PENDING = 0, // Not probed (yet) this boot
+    HW_STATUS_FOUND,
+    HW_STATUS_MISSING,
+} hw_status_t;
+
+#define HW_PROBE_TIMEOUT_MS  50    // One address probe, bus wait included
+
+/**
+ * @brief Take over the previous boot's manifest and start a new one (first in app_main)
+ */
+void hw_manifest_begin(void);
+
+/**
+ * @brief true after a warm reset with a valid manifest
+ */
+bool hw_manifest_warm(void);
+
+/**
+ * @brief Part found on the previous boot (warm resets only, else false)
+ * @param cfg Optional, its recorded configuration
+ */
+bool hw_manifest_had(hw_part_t part, uint32_t *cfg);
+
+/**
+ * @brief Part probed on the previous boot and not found (warm resets only)
+ */
+bool hw_manifest_lacked(hw_part_t part);
+
+/**
+ * @brief Record the outcome of this boot's init of a part (any task)
+ */
+void hw_manifest_set(hw_part_t part, bool found, uint32_t cfg);
+
+/**
+ * @brief This boot's verdict on a part so far (any task)
+ */
+hw_status_t hw_manifest_status(hw_part_t part);
+
+/**
+ * @brief Log every part's status in one line
+ */
+void hw_manifest_log(void);
+
+/**
+ * @brief Check that a device acknowledges its address, within HW_PROBE_TIMEOUT_MS
+ * @return ESP_OK, ESP_ERR_NOT_FOUND (no ACK), ESP_ERR_TIMEOUT (bus stuck or busy)
+ */
+esp_err_t hw_manifest_probe_i2c(i2c_master_bus_handle_t bus, uint16_t addr);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,182 @@
+#include "i2c_sched.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+
+static const char *TAG = "i2c_sched";
+
+#define TOUCH_IDLE_BIT  BIT0      // Set while no touch read waits or runs
+
+static SemaphoreHandle_t bus = NULL;
+static EventGroupHandle_t events = NULL;
+static volatile uint32_t touch_waiting = 0;
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Under stats_lock
+static int64_t touch_last_us = 0;         // Start of the last touch read
+static uint32_t touch_period_us = 0;      // EMA of the poll interval
+static int64_t held_since_us = 0;         // Current holder's start
+static int64_t window_start_us = 0;
+static uint32_t window_busy[I2C_SCHED_CLASS_COUNT];
+static uint32_t window_wait_max[I2C_SCHED_CLASS_COUNT];
+static i2c_sched_stats_t published = {};
+
+/**
+ * @brief How long a lower class should stay off the bus for the next touch poll
+ * @return 0 if it may go now
+ */
+static int64_t touch_due_in_us(int64_t now)
+{
+    portENTER_CRITICAL(&stats_lock);
+    int64_t last = touch_last_us;
+    uint32_t period = touch_period_us;
+    portEXIT_CRITICAL(&stats_lock);
+    if (period == 0 || now - last > 2 * (int64_t)period) {
+        return 0;                 // No cadence (idle, or touch not polled)
+    }
+    int64_t next = last + period;
+    if (now < next - I2C_SCHED_GUARD_US || now > next + I2C_SCHED_GUARD_US) {
+        return 0;
+    }
+    return next + I2C_SCHED_GUARD_US - now;
+}
+
+/**
+ * @brief Charge the slot that ends now to its class; roll the window over
+ */
+static void account(i2c_sched_class_t cls, int64_t now)
+{
+    portENTER_CRITICAL(&stats_lock);
+    window_busy[cls] += (uint32_t)(now - held_since_us);
+    published.slots[cls]++;
+    if (now - window_start_us >= (int64_t)I2C_SCHED_WINDOW_MS * 1000) {
+        uint32_t span = (uint32_t)(now - window_start_us);
+        uint32_t total = 0;
+        for (int c = 0; c < I2C_SCHED_CLASS_COUNT; c++) {
+            published.busy_us[c] = window_busy[c];
+            published.wait_max_us[c] = window_wait_max[c];
+            total += window_busy[c];
+            window_busy[c] = 0;
+            window_wait_max[c] = 0;
+        }
+        published.util_pct = (uint8_t)((uint64_t)total * 100 / span);
+        published.touch_period_us = touch_period_us;
+        window_start_us = now;
+    }
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+static void note_acquired(i2c_sched_class_t cls, int64_t asked_us)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&stats_lock);
+    held_since_us = now;
+    uint32_t waited = (uint32_t)(now - asked_us);
+    if (waited > window_wait_max[cls]) {
+        window_wait_max[cls] = waited;
+    }
+    if (cls == I2C_SCHED_TOUCH) {
+        int64_t interval = now - touch_last_us;
+        if (touch_last_us != 0 && interval < I2C_SCHED_POLL_MAX_US) {
+            touch_period_us = touch_period_us == 0 ? (uint32_t)interval
+                            : (uint32_t)((touch_period_us * 7 + (uint32_t)interval) / 8);
+        }
+        touch_last_us = now;
+    }
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+extern "C" void i2c_sched_init(void)
+{
+    if (bus != NULL) {
+        return;
+    }
+    events = xEventGroupCreate();
+    bus = xSemaphoreCreateMutex();
+    if (events == NULL || bus == NULL) {
+        ESP_LOGE(TAG, "No memory - I2C callers go unscheduled");
+        if (events != NULL) {
+            vEventGroupDelete(events);
+            events = NULL;
+        }
+        if (bus != NULL) {
+            vSemaphoreDelete(bus);
+            bus = NULL;
+        }
+        return;
+    }
+    xEventGroupSetBits(events, TOUCH_IDLE_BIT);
+    window_start_us = esp_timer_get_time();
+    ESP_LOGI(TAG, "Shared I2C bus scheduled (touch first, %d us guard before polls)", I2C_SCHED_GUARD_US);
+}
+
+extern "C" bool i2c_sched_begin(i2c_sched_class_t cls, TickType_t wait)
+{
+    if (bus == NULL || cls >= I2C_SCHED_CLASS_COUNT) {
+        return true;
+    }
+    int64_t asked = esp_timer_get_time();
+
+    if (cls == I2C_SCHED_TOUCH) {
+        __atomic_add_fetch(&touch_waiting, 1, __ATOMIC_ACQ_REL);
+        xEventGroupClearBits(events, TOUCH_IDLE_BIT);
+        bool got = xSemaphoreTake(bus, wait) == pdTRUE;
+        if (__atomic_sub_fetch(&touch_waiting, 1, __ATOMIC_ACQ_REL) == 0 && !got) {
+            xEventGroupSetBits(events, TOUCH_IDLE_BIT);
+        }
+        if (got) {
+            note_acquired(cls, asked);
+        }
+        return got;
+    }
+
+    TickType_t start_tick = xTaskGetTickCount();
+    while (true) {
+        TickType_t spent = xTaskGetTickCount() - start_tick;
+        if (wait != portMAX_DELAY && spent > wait) {
+            return false;
+        }
+        TickType_t left = (wait == portMAX_DELAY) ? portMAX_DELAY : wait - spent;
+
+        int64_t due = touch_due_in_us(esp_timer_get_time());
+        if (__atomic_load_n(&touch_waiting, __ATOMIC_ACQUIRE) == 0 && due == 0) {
+            if (xSemaphoreTake(bus, left) != pdTRUE) {
+                return false;
+            }
+            if (__atomic_load_n(&touch_waiting, __ATOMIC_ACQUIRE) == 0) {
+                note_acquired(cls, asked);
+                return true;
+            }
+            xSemaphoreGive(bus);  // A touch read arrived meanwhile: it goes first
+            continue;
+        }
+        if (__atomic_load_n(&touch_waiting, __ATOMIC_ACQUIRE) > 0) {
+            xEventGroupWaitBits(events, TOUCH_IDLE_BIT, pdFALSE, pdFALSE, left);
+        } else {
+            // A poll is due: sit out the guard window (or until it has run)
+            TickType_t nap = pdMS_TO_TICKS(due / 1000) + 1;
+            vTaskDelay(wait != portMAX_DELAY && nap > left ? left : nap);
+        }
+    }
+}
+
+extern "C" void i2c_sched_end(i2c_sched_class_t cls)
+{
+    if (bus == NULL || cls >= I2C_SCHED_CLASS_COUNT) {
+        return;
+    }
+    account(cls, esp_timer_get_time());
+    xSemaphoreGive(bus);
+    if (cls == I2C_SCHED_TOUCH && __atomic_load_n(&touch_waiting, __ATOMIC_ACQUIRE) == 0) {
+        xEventGroupSetBits(events, TOUCH_IDLE_BIT);
+    }
+}
+
+extern "C" void i2c_sched_get_stats(i2c_sched_stats_t *out)
+{
+    portENTER_CRITICAL(&stats_lock);
+    *out = published;
+    portEXIT_CRITICAL(&stats_lock);
+}
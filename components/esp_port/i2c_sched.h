@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// I2C scheduler - who gets the shared bus (port 0) next
+//
+// Touch (FT6336), the PMU (AXP2101), the expander and any sensors share
+// one bus. The driver's own mutex serialises single transfers in arrival
+// order; a touch poll stuck behind a burst of PMU reads is input latency.
+// Callers bracket their transfers with i2c_sched_begin() / _end():
+//
+//   TOUCH   always next: a waiting touch read goes ahead of every
+//           lower-class caller that has not started yet
+//   PMU,    only in idle slots: not while a touch read waits, and not in
+//   SENSOR  the I2C_SCHED_GUARD_US before the next touch poll is due (the
+//           poll period is learnt from the reads). Several transfers
+//           inside one begin / end pair run back to back in one slot.
+//
+// The bus's busy time per class is accumulated, and utilisation is
+// computed over I2C_SCHED_WINDOW_MS windows (i2c_sched_get_stats).
+// Before i2c_sched_init() every call passes straight through.
+
+#define I2C_SCHED_GUARD_US     1500    // Keep clear of a touch poll due this soon
+#define I2C_SCHED_WINDOW_MS    1000    // Utilisation window
+#define I2C_SCHED_POLL_MAX_US  200000  // Slower touch reads: not a poll cadence
+
+typedef enum {
+    I2C_SCHED_TOUCH = 0,
+    I2C_SCHED_PMU,
+    I2C_SCHED_SENSOR,
+    I2C_SCHED_CLASS_COUNT
+} i2c_sched_class_t;
+
+typedef struct {
+    uint32_t slots[I2C_SCHED_CLASS_COUNT];          // begin / end pairs since boot
+    uint32_t busy_us[I2C_SCHED_CLASS_COUNT];        // Bus held, last full window
+    uint32_t wait_max_us[I2C_SCHED_CLASS_COUNT];    // Longest wait for the bus, last full window
+    uint8_t  util_pct;                              // Bus held, all classes, last full window
+    uint32_t touch_period_us;                       // Learnt poll period, 0 = none yet
+} i2c_sched_stats_t;
+
+/**
+ * @brief Start arbitrating (after the bus is created)
+ */
+void i2c_sched_init(void);
+
+/**
+ * @brief Wait for the bus on behalf of a class
+ * @return false if wait ran out (the caller must not touch the bus)
+ */
+bool i2c_sched_begin(i2c_sched_class_t cls, TickType_t wait);
+
+/**
+ * @brief Hand the bus on (after a successful begin)
+ */
+void i2c_sched_end(i2c_sched_class_t cls);
+
+void i2c_sched_get_stats(i2c_sched_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,227 @@
+#include "io_sched.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+
+static const char *TAG = "io_sched";
+
+// Bit c: no class-c caller waits or runs (FRAME and LOG only)
+#define IDLE_BIT(cls)   ((EventBits_t)1 << (cls))
+
+typedef struct {
+    SemaphoreHandle_t lock;
+    EventGroupHandle_t events;
+    volatile uint32_t waiting[IO_SCHED_CLASS_COUNT];
+    // Under stats_lock
+    int64_t frame_last_us;        // Start of the last frame load
+    uint32_t frame_period_us;     // EMA of the load interval
+    int64_t held_since_us;        // Current holder's start
+    int64_t window_start_us;
+    uint32_t window_busy[IO_SCHED_CLASS_COUNT];
+    uint32_t window_wait_max[IO_SCHED_CLASS_COUNT];
+    io_sched_stats_t published;
+} io_device_t;
+
+static io_device_t devices[IO_SCHED_DEV_COUNT];
+static const int64_t guard_us[IO_SCHED_DEV_COUNT] = {
+    IO_SCHED_SD_GUARD_MS * 1000,
+    IO_SCHED_FLASH_GUARD_MS * 1000,
+};
+static bool started = false;
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static inline uint32_t waiting_above(io_device_t *d, io_sched_class_t cls)
+{
+    uint32_t n = 0;
+    for (int c = 0; c < cls; c++) {
+        n += __atomic_load_n(&d->waiting[c], __ATOMIC_ACQUIRE);
+    }
+    return n;
+}
+
+/**
+ * @brief How long background work should stay off the device for the next frame load
+ * @return 0 if it may go now
+ */
+static int64_t frame_due_in_us(io_sched_dev_t dev, int64_t now)
+{
+    io_device_t *d = &devices[dev];
+    int64_t guard = guard_us[dev];
+    portENTER_CRITICAL(&stats_lock);
+    int64_t last = d->frame_last_us;
+    uint32_t period = d->frame_period_us;
+    portEXIT_CRITICAL(&stats_lock);
+    if (period == 0 || now - last > 2 * (int64_t)period) {
+        return 0;                 // No cadence (animation stopped, or frames from elsewhere)
+    }
+    int64_t next = last + period;
+    if (now < next - guard || now > next + guard) {
+        return 0;
+    }
+    return next + guard - now;
+}
+
+/**
+ * @brief Charge the slot that ends now to its class; roll the window over
+ */
+static void account(io_device_t *d, io_sched_class_t cls, int64_t now)
+{
+    portENTER_CRITICAL(&stats_lock);
+    d->window_busy[cls] += (uint32_t)(now - d->held_since_us);
+    d->published.slots[cls]++;
+    if (now - d->window_start_us >= (int64_t)IO_SCHED_WINDOW_MS * 1000) {
+        uint32_t span = (uint32_t)(now - d->window_start_us);
+        uint32_t total = 0;
+        for (int c = 0; c < IO_SCHED_CLASS_COUNT; c++) {
+            d->published.busy_us[c] = d->window_busy[c];
+            d->published.wait_max_us[c] = d->window_wait_max[c];
+            total += d->window_busy[c];
+            d->window_busy[c] = 0;
+            d->window_wait_max[c] = 0;
+        }
+        d->published.util_pct = (uint8_t)((uint64_t)total * 100 / span);
+        d->published.frame_period_us = d->frame_period_us;
+        d->window_start_us = now;
+    }
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+static void note_acquired(io_device_t *d, io_sched_class_t cls, int64_t asked_us)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&stats_lock);
+    d->held_since_us = now;
+    uint32_t waited = (uint32_t)(now - asked_us);
+    if (waited > d->window_wait_max[cls]) {
+        d->window_wait_max[cls] = waited;
+    }
+    if (cls == IO_SCHED_FRAME) {
+        // From the request, not the grant: a load that had to wait does
+        // not shift the cadence
+        int64_t interval = asked_us - d->frame_last_us;
+        if (d->frame_last_us != 0 && interval > 0 && interval < (int64_t)IO_SCHED_PERIOD_MAX_MS * 1000) {
+            d->frame_period_us = d->frame_period_us == 0 ? (uint32_t)interval
+                               : (uint32_t)((d->frame_period_us * 7 + (uint32_t)interval) / 8);
+        }
+        d->frame_last_us = asked_us;
+    }
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+extern "C" void io_sched_init(void)
+{
+    if (started) {
+        return;
+    }
+    for (int i = 0; i < IO_SCHED_DEV_COUNT; i++) {
+        io_device_t *d = &devices[i];
+        d->events = xEventGroupCreate();
+        d->lock = xSemaphoreCreateMutex();
+        if (d->events == NULL || d->lock == NULL) {
+            ESP_LOGE(TAG, "No memory - storage I/O goes unscheduled");
+            for (int j = 0; j <= i; j++) {
+                if (devices[j].events != NULL) {
+                    vEventGroupDelete(devices[j].events);
+                    devices[j].events = NULL;
+                }
+                if (devices[j].lock != NULL) {
+                    vSemaphoreDelete(devices[j].lock);
+                    devices[j].lock = NULL;
+                }
+            }
+            return;
+        }
+        xEventGroupSetBits(d->events, IDLE_BIT(IO_SCHED_FRAME) | IDLE_BIT(IO_SCHED_LOG));
+        d->window_start_us = esp_timer_get_time();
+    }
+    started = true;
+    ESP_LOGI(TAG, "SD card and flash I/O scheduled (frames first; %d / %d ms guard before loads)",
+             IO_SCHED_SD_GUARD_MS, IO_SCHED_FLASH_GUARD_MS);
+}
+
+extern "C" io_sched_dev_t io_sched_device_of(const char *path)
+{
+    return (path != NULL && strncmp(path, "/sdcard", 7) == 0) ? IO_SCHED_SD : IO_SCHED_FLASH;
+}
+
+extern "C" bool io_sched_begin(io_sched_dev_t dev, io_sched_class_t cls, TickType_t wait)
+{
+    if (!started || dev >= IO_SCHED_DEV_COUNT || cls >= IO_SCHED_CLASS_COUNT) {
+        return true;
+    }
+    io_device_t *d = &devices[dev];
+    int64_t asked = esp_timer_get_time();
+
+    if (cls != IO_SCHED_BACKGROUND) {
+        __atomic_add_fetch(&d->waiting[cls], 1, __ATOMIC_ACQ_REL);
+        xEventGroupClearBits(d->events, IDLE_BIT(cls));
+    }
+
+    bool got = false;
+    TickType_t start_tick = xTaskGetTickCount();
+    while (true) {
+        TickType_t spent = xTaskGetTickCount() - start_tick;
+        if (wait != portMAX_DELAY && spent > wait) {
+            break;
+        }
+        TickType_t left = (wait == portMAX_DELAY) ? portMAX_DELAY : wait - spent;
+
+        int64_t now = esp_timer_get_time();
+        int64_t due = (cls == IO_SCHED_BACKGROUND && now - asked < (int64_t)IO_SCHED_STARVE_MS * 1000)
+                    ? frame_due_in_us(dev, now) : 0;
+        if (waiting_above(d, cls) == 0 && due == 0) {
+            if (xSemaphoreTake(d->lock, left) != pdTRUE) {
+                break;
+            }
+            if (waiting_above(d, cls) == 0) {
+                got = true;
+                break;
+            }
+            xSemaphoreGive(d->lock);    // A higher class arrived meanwhile: it goes first
+            continue;
+        }
+        if (waiting_above(d, cls) > 0) {
+            EventBits_t above = IDLE_BIT(cls) - 1;
+            xEventGroupWaitBits(d->events, above, pdFALSE, pdTRUE, left);
+        } else {
+            // A frame load is due: sit out the guard (or until it has run)
+            TickType_t nap = pdMS_TO_TICKS(due / 1000) + 1;
+            vTaskDelay(wait != portMAX_DELAY && nap > left ? left : nap);
+        }
+    }
+
+    if (cls != IO_SCHED_BACKGROUND &&
+        __atomic_sub_fetch(&d->waiting[cls], 1, __ATOMIC_ACQ_REL) == 0 && !got) {
+        xEventGroupSetBits(d->events, IDLE_BIT(cls));
+    }
+    if (got) {
+        note_acquired(d, cls, asked);
+    }
+    return got;
+}
+
+extern "C" void io_sched_end(io_sched_dev_t dev, io_sched_class_t cls)
+{
+    if (!started || dev >= IO_SCHED_DEV_COUNT || cls >= IO_SCHED_CLASS_COUNT) {
+        return;
+    }
+    io_device_t *d = &devices[dev];
+    account(d, cls, esp_timer_get_time());
+    xSemaphoreGive(d->lock);
+    if (cls != IO_SCHED_BACKGROUND && __atomic_load_n(&d->waiting[cls], __ATOMIC_ACQUIRE) == 0) {
+        xEventGroupSetBits(d->events, IDLE_BIT(cls));
+    }
+}
+
+extern "C" void io_sched_get_stats(io_sched_dev_t dev, io_sched_stats_t *out)
+{
+    if (dev >= IO_SCHED_DEV_COUNT) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    portENTER_CRITICAL(&stats_lock);
+    *out = devices[dev].published;
+    portEXIT_CRITICAL(&stats_lock);
+}
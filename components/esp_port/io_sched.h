@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// I/O scheduler - who gets the SD card / the internal flash next
+//
+// Frame loads (storage_task), log writes (sd_logger, history_store,
+// log_flash) and maintenance (flash drain, compaction, snapshot files,
+// free-space cleanup, asset downloads) run on different tasks. FATFS and
+// the flash driver serialise them in arrival order: a frame read stuck
+// behind a compaction pass is a missed frame. Callers bracket their
+// accesses with io_sched_begin() / _end(), per device:
+//
+//   FRAME       always next: a waiting frame load goes ahead of every
+//               lower-class caller that has not started yet
+//   LOG         after waiting frame loads, ahead of maintenance
+//   BACKGROUND  only in idle slots: not while a frame or log caller
+//               waits, and not in the device's guard before the next
+//               frame load is due (the cadence is learnt from the loads).
+//               Large jobs take one slot per IO_SCHED_SLICE_BYTES (flash:
+//               per erase sector), so a frame waits at most one slice.
+//               After IO_SCHED_STARVE_MS of waiting the guard is ignored.
+//
+// Each device has its own lock, cadence and guard: an SD transfer does
+// not hold flash readers back, and the flash guard covers a sector
+// erase, which stalls every read of the chip. A caller may hold the SD
+// card and then take the flash (a log spilling to flash), never the other
+// way round, and never the same device twice.
+//
+// Before io_sched_init() every call passes straight through.
+
+#define IO_SCHED_SD_GUARD_MS       4       // A FAT cluster allocation + sector write
+#define IO_SCHED_FLASH_GUARD_MS    20      // Most of a 4 KB sector erase
+#define IO_SCHED_SLICE_BYTES       16384   // Background work per slot
+#define IO_SCHED_STARVE_MS         2000    // Background stops yielding to the guard
+#define IO_SCHED_WINDOW_MS         1000    // Utilisation window
+#define IO_SCHED_PERIOD_MAX_MS     1000    // Slower frame loads: not a cadence
+
+typedef enum {
+    IO_SCHED_SD = 0,
+    IO_SCHED_FLASH,
+    IO_SCHED_DEV_COUNT
+} io_sched_dev_t;
+
+typedef enum {
+    IO_SCHED_FRAME = 0,
+    IO_SCHED_LOG,
+    IO_SCHED_BACKGROUND,
+    IO_SCHED_CLASS_COUNT
+} io_sched_class_t;
+
+typedef struct {
+    uint32_t slots[IO_SCHED_CLASS_COUNT];           // begin / end pairs since boot
+    uint32_t busy_us[IO_SCHED_CLASS_COUNT];         // Device held, last full window
+    uint32_t wait_max_us[IO_SCHED_CLASS_COUNT];     // Longest wait for the device, last full window
+    uint8_t  util_pct;                              // Device held, all classes, last full window
+    uint32_t frame_period_us;                       // Learnt frame load period, 0 = none yet
+} io_sched_stats_t;
+
+/**
+ * @brief Start arbitrating (before the tasks doing I/O start)
+ */
+void io_sched_init(void);
+
+/**
+ * @brief Device a path lives on: IO_SCHED_SD under /sdcard, else the flash
+ */
+io_sched_dev_t io_sched_device_of(const char *path);
+
+/**
+ * @brief Wait for a device on behalf of a class
+ * @return false if wait ran out (the caller must not touch the device)
+ */
+bool io_sched_begin(io_sched_dev_t dev, io_sched_class_t cls, TickType_t wait);
+
+/**
+ * @brief Hand the device on (after a successful begin)
+ */
+void io_sched_end(io_sched_dev_t dev, io_sched_class_t cls);
+
+void io_sched_get_stats(io_sched_dev_t dev, io_sched_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
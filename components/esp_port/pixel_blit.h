@@ -0,0 +1,165 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "pixel_kernels.h"
+
+#ifndef __cplusplus
+#error "pixel_blit.h is C++ only; C callers use pixel_kernels.h"
+#endif
+
+// Pixel blit kernels specialised at compile time (C++ only)
+//
+// Each kernel is a template over what would otherwise be a per-pixel test:
+//
+//   px_order   the byte order out vs in (keep, or swap to LV_COLOR_16_SWAP
+//              / panel order)
+//   px_src     what a source pixel is: RGB565 bytes, or a palette index
+//   Rot        0 / 90 / 180 / 270 degrees clockwise
+//
+// The caller picks the instantiation once per band or rect (a switch on
+// the frame's flags), so the inner loops carry no branches and the swap is
+// fused into the pass that writes the pixels instead of a second pass over
+// the buffer. Frame width and height stay run-time arguments: frames carry
+// their own geometry, and a different panel only changes the arguments.
+//
+// Rotation on this board is done by the ST7796 (MADCTL, see main.cpp), so
+// the tree instantiates Rot 0 only; the other rotations are there for a
+// panel that cannot rotate its scan-out.
+
+enum class px_order : uint8_t { keep, swap };
+enum class px_src : uint8_t { rgb565, index8 };
+
+template <px_order O>
+static inline uint16_t px_out(uint16_t p)
+{
+    if constexpr (O == px_order::swap) {
+        return __builtin_bswap16(p);
+    } else {
+        return p;
+    }
+}
+
+/**
+ * @brief n copies of c (already in output order)
+ */
+static inline void px_fill(uint16_t *dst, uint16_t c, size_t n)
+{
+    if ((c >> 8) == (c & 0xFF)) {
+        memset(dst, c & 0xFF, n * 2);       // Black, white and greys
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = c;
+    }
+}
+
+/**
+ * @brief n RGB565 pixels from (unaligned) bytes
+ */
+template <px_order O>
+static inline void px_copy(uint16_t *dst, const uint8_t *src, size_t n)
+{
+    if constexpr (O == px_order::swap) {
+        pixel_swap16((uint8_t *)dst, src, n * 2);
+    } else {
+        memcpy(dst, src, n * 2);
+    }
+}
+
+/**
+ * @brief n pixels through a palette (entries already in output order)
+ */
+static inline void px_lookup(uint16_t *dst, const uint8_t *idx, const uint16_t *lut, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = lut[idx[i]];
+    }
+}
+
+/**
+ * @brief Decode one band of RLE packets (frame_codec.h) into pixels
+ *
+ * px_src::rgb565 is RLE16 (two bytes per pixel, little-endian);
+ * px_src::index8 is RLE8 through lut, which is in output order already, so
+ * O only applies to RGB565 sources.
+ * @return Pixels written, 0 if the band is malformed or overruns dst
+ */
+template <px_src S, px_order O>
+static inline size_t px_decode_rle(const uint8_t *src, size_t src_len, const uint16_t *lut,
+                                   uint16_t *dst, size_t pixels)
+{
+    constexpr size_t unit = S == px_src::rgb565 ? 2 : 1;   // Source bytes per pixel
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < src_len) {
+        uint8_t ctrl = src[in++];
+        size_t count = (size_t)(ctrl & 0x7F) + 1;
+        if (out + count > pixels) {
+            return 0;
+        }
+        if (ctrl & 0x80) {
+            if (in + unit > src_len) {
+                return 0;
+            }
+            uint16_t c;
+            if constexpr (S == px_src::rgb565) {
+                c = px_out<O>((uint16_t)(src[in] | (src[in + 1] << 8)));
+            } else {
+                c = lut[src[in]];
+            }
+            px_fill(dst + out, c, count);
+            in += unit;
+        } else {
+            if (in + count * unit > src_len) {
+                return 0;
+            }
+            if constexpr (S == px_src::rgb565) {
+                px_copy<O>(dst + out, src + in, count);
+            } else {
+                px_lookup(dst + out, src + in, lut, count);
+            }
+            in += count * unit;
+        }
+        out += count;
+    }
+    return out;
+}
+
+/**
+ * @brief Copy a w x h rect, rotated Rot degrees clockwise
+ *
+ * dst points at the top-left of the destination rect, which is w x h for
+ * 0 / 180 and h x w for 90 / 270. Strides are in pixels.
+ */
+template <int Rot, px_order O>
+static inline void px_blit(uint16_t *dst, size_t dst_stride, const uint16_t *src, size_t src_stride,
+                           uint16_t w, uint16_t h)
+{
+    static_assert(Rot == 0 || Rot == 90 || Rot == 180 || Rot == 270, "Rot is 0, 90, 180 or 270");
+    for (uint16_t y = 0; y < h; y++) {
+        const uint16_t *s = src + (size_t)y * src_stride;
+        if constexpr (Rot == 0) {
+            px_copy<O>(dst + (size_t)y * dst_stride, (const uint8_t *)s, w);
+        } else if constexpr (Rot == 180) {
+            uint16_t *d = dst + (size_t)(h - 1 - y) * dst_stride + (w - 1);
+            for (uint16_t x = 0; x < w; x++) {
+                d[-(ptrdiff_t)x] = px_out<O>(s[x]);
+            }
+        } else if constexpr (Rot == 90) {
+            // Source row y becomes destination column h - 1 - y
+            uint16_t *d = dst + (h - 1 - y);
+            for (uint16_t x = 0; x < w; x++) {
+                d[(size_t)x * dst_stride] = px_out<O>(s[x]);
+            }
+        } else {
+            // Source row y becomes destination column y, bottom to top
+            uint16_t *d = dst + (size_t)(w - 1) * dst_stride + y;
+            for (uint16_t x = 0; x < w; x++) {
+                d[-(ptrdiff_t)((size_t)x * dst_stride)] = px_out<O>(s[x]);
+            }
+        }
+    }
+}
@@ -0,0 +1,301 @@
+#include "pixel_kernels.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "pixel_kernels";
+
+#define BENCH_RUNS       16
+#define BENCH_DOWN_W     320             // Camera QVGA
+#define BENCH_DOWN_H     240
+#define RGB565_SPREAD    0x07E0F81Fu     // G in the top half, R and B in the bottom: headroom for sums
+#define LANES_LO         0x00FF00FFu     // Bytes 0 and 2 of a word, one per 16-bit lane
+#define LANE_GUARD       0x01000100u     // 256 per lane: a lane subtraction never borrows
+#define LANE_ONES        0x00010001u
+#define DIFF_FLUSH_WORDS 16384           // Lane counts grow by 2 per word: flush before 65535
+
+#if PIXEL_KERNELS_PIE
+extern "C" void pixel_swap16_pie(uint8_t *dst, const uint8_t *src, size_t blocks);
+#endif
+
+static inline uint32_t swap_word(uint32_t a)
+{
+    return ((a & 0x00FF00FFu) << 8) | ((a >> 8) & 0x00FF00FFu);
+}
+
+extern "C" void pixel_swap16_scalar(uint8_t *dst, const uint8_t *src, size_t len)
+{
+    if ((((uintptr_t)dst ^ (uintptr_t)src) & 0x3) != 0) {
+        // Words never line up: memcpy handles the shift, then swap in place
+        memcpy(dst, src, len);
+        src = dst;
+    }
+    size_t i = 0;
+    // Byte pairs up to a word boundary (frame buffers are normally aligned)
+    for (; i + 1 < len && ((uintptr_t)(src + i) & 0x3) != 0; i += 2) {
+        uint8_t t = src[i];
+        dst[i] = src[i + 1];
+        dst[i + 1] = t;
+    }
+    // Two pixels per word, unrolled to four words to keep PSRAM bursts long
+    const uint32_t *s = (const uint32_t *)(src + i);
+    uint32_t *d = (uint32_t *)(dst + i);
+    size_t words = (len - i) / 4;
+    size_t n = 0;
+    for (; n + 4 <= words; n += 4) {
+        uint32_t a = s[n], b = s[n + 1], c = s[n + 2], e = s[n + 3];
+        d[n]     = swap_word(a);
+        d[n + 1] = swap_word(b);
+        d[n + 2] = swap_word(c);
+        d[n + 3] = swap_word(e);
+    }
+    for (; n < words; n++) {
+        d[n] = swap_word(s[n]);
+    }
+    i += words * 4;
+    for (; i + 1 < len; i += 2) {
+        uint8_t t = src[i];
+        dst[i] = src[i + 1];
+        dst[i + 1] = t;
+    }
+}
+
+extern "C" void pixel_swap16(uint8_t *dst, const uint8_t *src, size_t len)
+{
+#if PIXEL_KERNELS_PIE
+    size_t head = (16 - ((uintptr_t)src & 0xF)) & 0xF;
+    if ((((uintptr_t)dst ^ (uintptr_t)src) & 0xF) == 0 && (head & 1) == 0 && len >= head + 16) {
+        size_t blocks = (len - head) / 16;
+        pixel_swap16_scalar(dst, src, head);
+        pixel_swap16_pie(dst + head, src + head, blocks);
+        size_t done = head + blocks * 16;
+        pixel_swap16_scalar(dst + done, src + done, len - done);
+        return;
+    }
+#endif
+    pixel_swap16_scalar(dst, src, len);
+}
+
+static inline uint8_t clamp_u8(int v)
+{
+    return v < 0 ? 0 : (v > 255 ? 255 : (uint8_t)v);
+}
+
+static inline uint16_t rgb565(int r, int g, int b)
+{
+    return (uint16_t)(((clamp_u8(r) & 0xF8) << 8) | ((clamp_u8(g) & 0xFC) << 3) | (clamp_u8(b) >> 3));
+}
+
+extern "C" void pixel_yuv422_to_rgb565(uint16_t *dst, const uint8_t *src, size_t pixels)
+{
+    // BT.601 limited range, 8.8 fixed point; U and V terms shared by the pair
+    for (size_t i = 0; i + 1 < pixels; i += 2, src += 4) {
+        int d = src[1] - 128;
+        int e = src[3] - 128;
+        int rv = 409 * e + 128;
+        int gv = -100 * d - 208 * e + 128;
+        int bv = 516 * d + 128;
+        int c0 = 298 * (src[0] - 16);
+        int c1 = 298 * (src[2] - 16);
+        dst[i]     = rgb565((c0 + rv) >> 8, (c0 + gv) >> 8, (c0 + bv) >> 8);
+        dst[i + 1] = rgb565((c1 + rv) >> 8, (c1 + gv) >> 8, (c1 + bv) >> 8);
+    }
+}
+
+extern "C" void pixel_rgb888_to_rgb565(uint16_t *dst, const uint8_t *src, size_t pixels, bool swap)
+{
+    for (size_t i = 0; i < pixels; i++, src += 3) {
+        uint16_t p = (uint16_t)(((src[0] & 0xF8) << 8) | ((src[1] & 0xFC) << 3) | (src[2] >> 3));
+        dst[i] = swap ? (uint16_t)((p << 8) | (p >> 8)) : p;
+    }
+}
+
+static inline uint32_t spread(uint16_t p)
+{
+    return ((uint32_t)p | ((uint32_t)p << 16)) & RGB565_SPREAD;
+}
+
+static inline uint16_t gather(uint32_t s)
+{
+    s &= RGB565_SPREAD;
+    return (uint16_t)(s | (s >> 16));
+}
+
+extern "C" void pixel_downscale2_rgb565(uint16_t *dst, const uint16_t *src, uint16_t w, uint16_t h)
+{
+    for (uint16_t y = 0; y + 1 < h; y += 2) {
+        const uint16_t *r0 = src + (size_t)y * w;
+        const uint16_t *r1 = r0 + w;
+        for (uint16_t x = 0; x + 1 < w; x += 2) {
+            // Four 7-bit field sums fit the spread word; +2 per field rounds
+            uint32_t sum = spread(r0[x]) + spread(r0[x + 1]) + spread(r1[x]) + spread(r1[x + 1]) + 0x00401002u;
+            *dst++ = gather(sum >> 2);
+        }
+    }
+}
+
+extern "C" void pixel_blend_rgb565(uint16_t *dst, const uint16_t *fg, const uint16_t *bg, size_t pixels,
+                                   uint8_t alpha)
+{
+    uint32_t a = (alpha + 4) >> 3;       // 0-32: the fields have 5 bits of headroom for the product
+    for (size_t i = 0; i < pixels; i++) {
+        uint32_t b = spread(bg[i]);
+        dst[i] = gather(b + (((spread(fg[i]) - b) * a) >> 5));
+    }
+}
+
+extern "C" void pixel_mask_fill_rgb565_swapped(uint16_t *dst, const uint8_t *mask, size_t pixels,
+                                               uint16_t color)
+{
+    uint32_t c = spread(color);
+    uint16_t solid = (uint16_t)((color << 8) | (color >> 8));
+    for (size_t i = 0; i < pixels; i++) {
+        uint32_t m = mask[i];
+        if (m == 0) {
+            continue;           // Most of a text box
+        }
+        if (m == 255) {
+            dst[i] = solid;
+            continue;
+        }
+        uint32_t a = (m + 4) >> 3;
+        uint16_t p = dst[i];
+        uint32_t b = spread((uint16_t)((p << 8) | (p >> 8)));
+        uint16_t out = gather(b + (((c - b) * a) >> 5));
+        dst[i] = (uint16_t)((out << 8) | (out >> 8));
+    }
+}
+
+extern "C" uint32_t pixel_rgb565_to_gray(uint8_t *dst, const uint16_t *src, size_t pixels)
+{
+    // 0.299 R + 0.587 G + 0.114 B with the 5/6-bit fields scaled to 8 bits, 8.8 fixed point
+    uint32_t sum = 0;
+    for (size_t i = 0; i < pixels; i++) {
+        uint32_t p = src[i];
+        uint32_t y = ((p >> 11) * 630 + ((p >> 5) & 0x3F) * 608 + (p & 0x1F) * 240 + 128) >> 8;
+        dst[i] = (uint8_t)y;
+        sum += y;
+    }
+    return sum;
+}
+
+/**
+ * @brief 1 in each 16-bit lane whose bytes differ by more than the threshold
+ * @param a, b One byte per lane (LANES_LO)
+ * @param bias (255 - threshold) per lane
+ */
+static inline uint32_t lanes_over(uint32_t a, uint32_t b, uint32_t bias)
+{
+    uint32_t ab = (a | LANE_GUARD) - b;                 // 256 + a - b
+    uint32_t ba = (b | LANE_GUARD) - a;                 // 256 + b - a
+    uint32_t ge = ((ab >> 8) & LANE_ONES) * 0xFFu;      // 0xFF in lanes where a >= b
+    uint32_t diff = ((ab & ge) | (ba & ~ge)) & LANES_LO;
+    return ((diff + bias) >> 8) & LANE_ONES;
+}
+
+extern "C" size_t pixel_diff_count_u8(const uint8_t *a, const uint8_t *b, size_t len, uint8_t threshold)
+{
+    size_t count = 0;
+    size_t i = 0;
+    for (; i < len && (((uintptr_t)(a + i) | (uintptr_t)(b + i)) & 0x3) != 0; i++) {
+        count += abs(a[i] - b[i]) > threshold;
+    }
+    if ((((uintptr_t)(a + i) | (uintptr_t)(b + i)) & 0x3) == 0) {
+        // Four pixels per word pair: bytes 0/2 and 1/3 in two lane passes
+        const uint32_t *wa = (const uint32_t *)(a + i);
+        const uint32_t *wb = (const uint32_t *)(b + i);
+        size_t words = (len - i) / 4;
+        uint32_t bias = (uint32_t)(0xFF - threshold) * LANE_ONES;
+        for (size_t n = 0; n < words;) {
+            size_t end = (words - n > DIFF_FLUSH_WORDS) ? n + DIFF_FLUSH_WORDS : words;
+            uint32_t lanes = 0;
+            for (; n < end; n++) {
+                uint32_t x = wa[n], y = wb[n];
+                lanes += lanes_over(x & LANES_LO, y & LANES_LO, bias);
+                lanes += lanes_over((x >> 8) & LANES_LO, (y >> 8) & LANES_LO, bias);
+            }
+            count += (lanes & 0xFFFF) + (lanes >> 16);
+        }
+        i += words * 4;
+    }
+    for (; i < len; i++) {
+        count += abs(a[i] - b[i]) > threshold;
+    }
+    return count;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BENCHMARK
+// ═══════════════════════════════════════════════════════════════════════════
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void report(const char *kernel, const char *path, size_t bytes, uint32_t *us)
+{
+    qsort(us, BENCH_RUNS, sizeof(us[0]), cmp_u32);
+    uint32_t p50 = us[(BENCH_RUNS - 1) / 2];
+    ESP_LOGI(TAG, "  %-10s %-6s %7u B  p50 %6lu  max %6lu us  %4lu MB/s", kernel, path, (unsigned)bytes,
+             (unsigned long)p50, (unsigned long)us[BENCH_RUNS - 1], (unsigned long)(p50 ? bytes / p50 : 0));
+}
+
+#define BENCH(kernel, path, bytes, call)                        \
+    do {                                                        \
+        uint32_t us[BENCH_RUNS];                                \
+        for (int r = 0; r < BENCH_RUNS; r++) {                  \
+            int64_t t0 = esp_timer_get_time();                  \
+            call;                                               \
+            us[r] = (uint32_t)(esp_timer_get_time() - t0);      \
+        }                                                       \
+        report(kernel, path, bytes, us);                        \
+    } while (0)
+
+extern "C" void pixel_kernels_bench(uint8_t *scratch, size_t len)
+{
+    if (scratch == NULL || len < 64) {
+        return;
+    }
+    for (size_t i = 0; i < len; i++) {
+        scratch[i] = (uint8_t)(i * 131 + (i >> 9));
+    }
+    ESP_LOGI(TAG, "Pixel kernels, %d runs each (%s):", BENCH_RUNS, PIXEL_KERNELS_PIE ? "PIE" : "no PIE");
+
+    size_t even = len & ~(size_t)1;
+    BENCH("swap16", "vector", even, pixel_swap16(scratch, scratch, even));
+    BENCH("swap16", "scalar", even, pixel_swap16_scalar(scratch, scratch, even));
+    BENCH("swap16", "copy", even / 2, pixel_swap16(scratch, scratch + even / 2, even / 2 & ~(size_t)1));
+
+    // YUYV in the first half, RGB565 out in the second: same size
+    size_t yuv_pixels = (len / 4) & ~(size_t)1;
+    uint16_t *half = (uint16_t *)(scratch + ((len / 2) & ~(size_t)3));
+    BENCH("yuv422", "scalar", yuv_pixels * 2, pixel_yuv422_to_rgb565(half, scratch, yuv_pixels));
+
+    // RGB888 in the first 3/5, RGB565 out in the last 2/5
+    size_t rgb_pixels = (len / 5) & ~(size_t)1;
+    BENCH("rgb888", "scalar", rgb_pixels * 3,
+          pixel_rgb888_to_rgb565((uint16_t *)(scratch + rgb_pixels * 3), scratch, rgb_pixels, true));
+
+    size_t down_src = (size_t)BENCH_DOWN_W * BENCH_DOWN_H * 2;
+    if (len >= down_src + down_src / 4) {
+        BENCH("downscale2", "scalar", down_src,
+              pixel_downscale2_rgb565((uint16_t *)(scratch + down_src), (const uint16_t *)scratch,
+                                      BENCH_DOWN_W, BENCH_DOWN_H));
+    }
+
+    size_t blend_pixels = len / 4;
+    uint16_t *fg = (uint16_t *)scratch;
+    uint16_t *bg = fg + blend_pixels;
+    BENCH("blend", "scalar", blend_pixels * 2, pixel_blend_rgb565(bg, fg, bg, blend_pixels, 96));
+    BENCH("mask_fill", "scalar", blend_pixels * 2,
+          pixel_mask_fill_rgb565_swapped(bg, (const uint8_t *)fg, blend_pixels, 0xFFFF));
+
+    size_t gray_pixels = len / 3;
+    BENCH("gray", "scalar", gray_pixels * 2,
+          pixel_rgb565_to_gray(scratch + gray_pixels * 2, (const uint16_t *)scratch, gray_pixels));
+    BENCH("diff_count", "scalar", len / 2, pixel_diff_count_u8(scratch, scratch + len / 2, len / 2, 12));
+}
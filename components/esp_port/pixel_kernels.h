@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Pixel kernels - the RGB565 inner loops of the frame loader and the camera
+//
+//   swap16      RGB565 byte order (file / decoder order <-> LVGL's
+//               LV_COLOR_16_SWAP order); in place when dst == src
+//   yuv422      YUYV to RGB565, native order
+//   downscale2  2x2 box average of RGB565, native order
+//   blend       dst = fg * alpha + bg * (1 - alpha), RGB565 native order
+//   mask_fill   dst = color * mask + dst * (1 - mask), per-pixel 8-bit mask,
+//               RGB565 panel (swapped) order - text baked into frames
+//   gray        RGB565 native order to 8-bit luma
+//   diff_count  pixels of two 8-bit frames that differ by more than a threshold
+//
+// On the ESP32-S3 swap16 runs on the PIE vector unit (pixel_kernels_pie.S),
+// 16 bytes per instruction group, for the 16-byte aligned middle of the
+// buffer; the ends, buffers of different alignment and other targets take
+// the scalar path (two pixels per 32-bit word), which stays callable as
+// pixel_swap16_scalar() for the benchmark and for checking the vector
+// path. The other kernels are scalar: blend and downscale spread a pixel's
+// channels over a 32-bit word so one add or multiply covers all three, and
+// diff_count compares four pixels per word pair in 16-bit lanes.
+//
+// pixel_kernels_bench() times each kernel, vector and scalar, on a
+// caller's PSRAM buffer (CONFIG_GOLDIE_FRAME_BENCHMARK).
+//
+// C++ callers that would branch per pixel on byte order, source format or
+// rotation use the compile-time specialised kernels in pixel_blit.h.
+
+#if CONFIG_IDF_TARGET_ESP32S3
+#define PIXEL_KERNELS_PIE 1
+#else
+#define PIXEL_KERNELS_PIE 0
+#endif
+
+/**
+ * @brief Byte-swap RGB565 pixels (len bytes, even); dst may equal src
+ */
+void pixel_swap16(uint8_t *dst, const uint8_t *src, size_t len);
+void pixel_swap16_scalar(uint8_t *dst, const uint8_t *src, size_t len);
+
+/**
+ * @brief YUYV (Y0 U Y1 V per pixel pair) to RGB565; pixels even
+ */
+void pixel_yuv422_to_rgb565(uint16_t *dst, const uint8_t *src, size_t pixels);
+
+/**
+ * @brief RGB888 (R G B bytes per pixel, tjpgd output) to RGB565
+ * @param swap Panel order (byte-swapped) instead of native
+ */
+void pixel_rgb888_to_rgb565(uint16_t *dst, const uint8_t *src, size_t pixels, bool swap);
+
+/**
+ * @brief 2x2 box average: dst is (w / 2) x (h / 2); w, h even
+ */
+void pixel_downscale2_rgb565(uint16_t *dst, const uint16_t *src, uint16_t w, uint16_t h);
+
+/**
+ * @brief Blend fg over bg into dst with a constant alpha (0-255); dst may equal either
+ */
+void pixel_blend_rgb565(uint16_t *dst, const uint16_t *fg, const uint16_t *bg, size_t pixels, uint8_t alpha);
+
+/**
+ * @brief Paint `color` through an 8-bit coverage mask onto panel-order
+ *        (byte-swapped) RGB565 pixels; color is native order
+ */
+void pixel_mask_fill_rgb565_swapped(uint16_t *dst, const uint8_t *mask, size_t pixels, uint16_t color);
+
+/**
+ * @brief BT.601 luma of RGB565 pixels
+ * @return Sum of the luma values (mean brightness = sum / pixels)
+ */
+uint32_t pixel_rgb565_to_gray(uint8_t *dst, const uint16_t *src, size_t pixels);
+
+/**
+ * @brief Count the pixels where |a - b| > threshold (8-bit frames of len bytes)
+ */
+size_t pixel_diff_count_u8(const uint8_t *a, const uint8_t *b, size_t len, uint8_t threshold);
+
+/**
+ * @brief Time every kernel and log n / p50 / max per row
+ * @param scratch PSRAM buffer the benchmark overwrites
+ */
+void pixel_kernels_bench(uint8_t *scratch, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,71 @@
+#include "time_svc.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+static portMUX_TYPE local_lock = portMUX_INITIALIZER_UNLOCKED;
+static time_t local_sec = -1;           // Second the cached struct tm is for
+static struct tm local_tm;
+
+extern "C" uint32_t time_svc_uptime_s(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+extern "C" int64_t time_svc_uptime_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+extern "C" time_t time_svc_wall(void)
+{
+    return time(NULL);
+}
+
+extern "C" bool time_svc_wall_valid(void)
+{
+    return time(NULL) >= TIME_SVC_WALL_VALID;
+}
+
+extern "C" bool time_svc_local(struct tm *out)
+{
+    time_t now = time(NULL);
+    portENTER_CRITICAL(&local_lock);
+    bool hit = now == local_sec;
+    if (hit) {
+        *out = local_tm;
+    }
+    portEXIT_CRITICAL(&local_lock);
+    if (!hit) {
+        localtime_r(&now, out);         // Outside the lock: it may take the TZ lock
+        portENTER_CRITICAL(&local_lock);
+        local_sec = now;
+        local_tm = *out;
+        portEXIT_CRITICAL(&local_lock);
+    }
+    return now >= TIME_SVC_WALL_VALID;
+}
+
+extern "C" time_t time_svc_boot_wall(void)
+{
+    time_t now = time(NULL);
+    return now >= TIME_SVC_WALL_VALID ? now - (time_t)time_svc_uptime_s() : 0;
+}
+
+extern "C" time_t time_svc_uptime_to_wall(uint32_t uptime_s)
+{
+    time_t boot = time_svc_boot_wall();
+    return boot != 0 ? boot + (time_t)uptime_s : 0;
+}
+
+extern "C" uint32_t time_svc_wall_to_uptime(time_t wall)
+{
+    time_t boot = time_svc_boot_wall();
+    return boot != 0 ? (uint32_t)(wall - boot) : time_svc_uptime_s();
+}
+
+extern "C" void time_svc_tz_changed(void)
+{
+    portENTER_CRITICAL(&local_lock);
+    local_sec = -1;
+    portEXIT_CRITICAL(&local_lock);
+}
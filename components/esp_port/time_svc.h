@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Time service - one place for "what time is it"
+//
+//   uptime   monotonic seconds / ms since boot (esp_timer): intervals,
+//            timeouts, rate limits, ages of in-memory state
+//   wall     UTC Unix time (system clock: RTC at boot, then SNTP); only
+//            meaningful once time_svc_wall_valid()
+//   local    broken-down local time, cached: localtime_r() runs at most
+//            once per wall-clock second however often it is asked for
+//
+// Uptime and wall time convert through the boot instant (wall time minus
+// uptime), so an age kept as uptime can be saved as wall time and restored
+// after a reboot. A clock step (SNTP, RTC) shows up in the next read; call
+// time_svc_tz_changed() after setting TZ.
+//
+// Any task.
+
+#define TIME_SVC_WALL_VALID  1577836800     // 2020-01-01: the clock was never set before this
+
+/**
+ * @brief Seconds since boot
+ */
+uint32_t time_svc_uptime_s(void);
+
+/**
+ * @brief Milliseconds since boot
+ */
+int64_t time_svc_uptime_ms(void);
+
+/**
+ * @brief UTC Unix time (may be 1970-based until the clock is set)
+ */
+time_t time_svc_wall(void);
+
+/**
+ * @brief true once the system clock has been set (RTC or SNTP)
+ */
+bool time_svc_wall_valid(void);
+
+/**
+ * @brief Current local time, from the per-second cache
+ * @return time_svc_wall_valid()
+ */
+bool time_svc_local(struct tm *out);
+
+/**
+ * @brief Wall time at boot, 0 while the clock is not set
+ */
+time_t time_svc_boot_wall(void);
+
+/**
+ * @brief Wall time of an uptime instant, 0 while the clock is not set
+ */
+time_t time_svc_uptime_to_wall(uint32_t uptime_s);
+
+/**
+ * @brief Uptime instant of a wall time (wraps for times before boot, so
+ *        "now - result" is still the age); now if the clock is not set
+ */
+uint32_t time_svc_wall_to_uptime(time_t wall);
+
+/**
+ * @brief Drop the cached local time (after setenv("TZ") / tzset())
+ */
+void time_svc_tz_changed(void);
+
+#ifdef __cplusplus
+}
+#endif
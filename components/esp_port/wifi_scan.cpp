@@ -0,0 +1,183 @@
+#include "wifi_scan.h"
+#include "esp_wifi.h"
+#include "esp_event.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include <string.h>
+
+static const char *TAG = "wifi_scan";
+
+static wifi_scan_ap_t cache[WIFI_SCAN_MAX_APS];
+static size_t cache_count = 0;
+static portMUX_TYPE cache_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static wifi_ap_record_t records[WIFI_SCAN_MAX_APS];    // Event loop task only
+static wifi_scan_listener_t listeners[WIFI_SCAN_LISTENERS];
+static volatile bool busy = false;
+static volatile uint32_t generation = 0;
+static int64_t done_us = 0;
+static bool initialized = false;
+
+/**
+ * @brief Fold one scan's records into the cache, drop the expired, sort
+ *        by signal (lock held)
+ */
+static void cache_merge(const wifi_ap_record_t *recs, uint16_t n, int64_t now)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        const wifi_ap_record_t *r = &recs[i];
+        wifi_scan_ap_t *slot = NULL;
+        for (size_t k = 0; k < cache_count; k++) {
+            if (memcmp(cache[k].bssid, r->bssid, 6) == 0) {
+                slot = &cache[k];
+                break;
+            }
+        }
+        if (slot == NULL) {
+            if (cache_count < WIFI_SCAN_MAX_APS) {
+                slot = &cache[cache_count++];
+            } else {
+                // Full: replace the oldest record
+                slot = &cache[0];
+                for (size_t k = 1; k < cache_count; k++) {
+                    if (cache[k].seen_us < slot->seen_us) {
+                        slot = &cache[k];
+                    }
+                }
+            }
+        }
+        memcpy(slot->ssid, r->ssid, sizeof(slot->ssid) - 1);
+        slot->ssid[sizeof(slot->ssid) - 1] = '\0';
+        memcpy(slot->bssid, r->bssid, 6);
+        slot->channel = r->primary;
+        slot->rssi = r->rssi;
+        slot->auth = r->authmode;
+        slot->seen_us = now;
+    }
+
+    size_t kept = 0;
+    for (size_t k = 0; k < cache_count; k++) {
+        if (now - cache[k].seen_us <= (int64_t)WIFI_SCAN_EXPIRE_S * 1000000) {
+            cache[kept++] = cache[k];
+        }
+    }
+    cache_count = kept;
+
+    for (size_t i = 1; i < cache_count; i++) {
+        wifi_scan_ap_t ap = cache[i];
+        size_t k = i;
+        for (; k > 0 && cache[k - 1].rssi < ap.rssi; k--) {
+            cache[k] = cache[k - 1];
+        }
+        cache[k] = ap;
+    }
+}
+
+static void scan_done_handler(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    const wifi_event_sta_scan_done_t *done = (const wifi_event_sta_scan_done_t *)data;
+    uint16_t n = WIFI_SCAN_MAX_APS;
+    if (done->status != 0 || esp_wifi_scan_get_ap_records(&n, records) != ESP_OK) {
+        n = 0;
+        esp_wifi_clear_ap_list();
+    }
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&cache_lock);
+    cache_merge(records, n, now);
+    done_us = now;
+    portEXIT_CRITICAL(&cache_lock);
+    busy = false;
+    generation = generation + 1;
+    ESP_LOGI(TAG, "Scan done: %u APs (%u cached)", (unsigned)n, (unsigned)cache_count);
+
+    for (int i = 0; i < WIFI_SCAN_LISTENERS && listeners[i] != NULL; i++) {
+        listeners[i]();
+    }
+}
+
+esp_err_t wifi_scan_init(void)
+{
+    if (initialized) {
+        return ESP_OK;
+    }
+    esp_err_t err = esp_event_handler_register(WIFI_EVENT, WIFI_EVENT_SCAN_DONE, scan_done_handler, NULL);
+    initialized = err == ESP_OK;
+    return err;
+}
+
+esp_err_t wifi_scan_request(bool passive)
+{
+    if (busy) {
+        return ESP_OK;
+    }
+    wifi_scan_config_t config = {};
+    config.show_hidden = false;
+    if (passive) {
+        config.scan_type = WIFI_SCAN_TYPE_PASSIVE;
+        config.scan_time.passive = WIFI_SCAN_PASSIVE_MS;
+    } else {
+        config.scan_type = WIFI_SCAN_TYPE_ACTIVE;
+        config.scan_time.active.min = 0;
+        config.scan_time.active.max = WIFI_SCAN_ACTIVE_MS;
+    }
+    busy = true;
+    esp_err_t err = esp_wifi_scan_start(&config, false);
+    if (err != ESP_OK) {
+        busy = false;
+        ESP_LOGD(TAG, "Scan not started: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+bool wifi_scan_busy(void)
+{
+    return busy;
+}
+
+uint32_t wifi_scan_generation(void)
+{
+    return generation;
+}
+
+int32_t wifi_scan_age_s(void)
+{
+    int64_t at = done_us;
+    return at != 0 ? (int32_t)((esp_timer_get_time() - at) / 1000000) : -1;
+}
+
+size_t wifi_scan_get(wifi_scan_ap_t *out, size_t max)
+{
+    portENTER_CRITICAL(&cache_lock);
+    size_t n = cache_count < max ? cache_count : max;
+    memcpy(out, cache, n * sizeof(cache[0]));
+    portEXIT_CRITICAL(&cache_lock);
+    return n;
+}
+
+bool wifi_scan_find(const char *ssid, uint32_t max_age_s, wifi_scan_ap_t *out)
+{
+    int64_t oldest = esp_timer_get_time() - (int64_t)max_age_s * 1000000;
+    bool found = false;
+    portENTER_CRITICAL(&cache_lock);
+    for (size_t k = 0; k < cache_count; k++) {    // Strongest first
+        if (cache[k].seen_us >= oldest && strcmp(cache[k].ssid, ssid) == 0) {
+            *out = cache[k];
+            found = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&cache_lock);
+    return found;
+}
+
+void wifi_scan_add_listener(wifi_scan_listener_t fn)
+{
+    for (int i = 0; i < WIFI_SCAN_LISTENERS; i++) {
+        if (listeners[i] == NULL || listeners[i] == fn) {
+            listeners[i] = fn;
+            return;
+        }
+    }
+    ESP_LOGE(TAG, "No room for a listener (WIFI_SCAN_LISTENERS=%d)", WIFI_SCAN_LISTENERS);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_wifi_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// WiFi scan service - background scans, one cache of what was seen
+//
+// wifi_scan_request() starts a scan and returns at once; the driver's
+// WIFI_EVENT_SCAN_DONE (default event loop) merges the records into the
+// cache and then calls the listeners. Nobody waits for a scan:
+//
+//   - the WiFi tile requests one (Scan button, or on show when the cache is
+//     older than WIFI_SCAN_FRESH_S) and redraws its list when
+//     wifi_scan_generation() moves
+//   - the reconnect logic (gemini_api.cpp) requests one when the cached AP
+//     is gone, and connects straight to the strongest AP of its SSID that a
+//     scan saw within WIFI_SCAN_FRESH_S instead of scanning all channels
+//
+// Each AP keeps the time it was last seen; records not seen for
+// WIFI_SCAN_EXPIRE_S drop out. Active scans dwell WIFI_SCAN_ACTIVE_MS per
+// channel, passive ones (no probe requests, for the background)
+// WIFI_SCAN_PASSIVE_MS. A request while a scan runs joins it; while the
+// station itself is connecting the driver refuses (ESP_ERR_WIFI_STATE).
+//
+// Any task; listeners run on the event loop task and must not block.
+
+#define WIFI_SCAN_MAX_APS      20
+#define WIFI_SCAN_FRESH_S      60
+#define WIFI_SCAN_EXPIRE_S     300
+#define WIFI_SCAN_ACTIVE_MS    120
+#define WIFI_SCAN_PASSIVE_MS   300
+#define WIFI_SCAN_LISTENERS    2
+
+typedef struct {
+    char ssid[33];
+    uint8_t bssid[6];
+    uint8_t channel;
+    int8_t rssi;
+    wifi_auth_mode_t auth;
+    int64_t seen_us;           // esp_timer time of the last scan that saw it
+} wifi_scan_ap_t;
+
+typedef void (*wifi_scan_listener_t)(void);
+
+/**
+ * @brief Hook WIFI_EVENT_SCAN_DONE (after esp_wifi_init() and the default
+ *        event loop; again is a no-op)
+ */
+esp_err_t wifi_scan_init(void);
+
+/**
+ * @brief Start a scan of all channels in the background
+ * @return ESP_OK if one is running now, else the driver's refusal
+ */
+esp_err_t wifi_scan_request(bool passive);
+
+/**
+ * @brief A scan is running
+ */
+bool wifi_scan_busy(void);
+
+/**
+ * @brief Completed scans so far (poll it to notice new results)
+ */
+uint32_t wifi_scan_generation(void);
+
+/**
+ * @brief Time since the last completed scan, -1 if none yet
+ */
+int32_t wifi_scan_age_s(void);
+
+/**
+ * @brief Copy the cached APs, strongest first
+ * @return Number copied
+ */
+size_t wifi_scan_get(wifi_scan_ap_t *out, size_t max);
+
+/**
+ * @brief Strongest AP of `ssid` seen within max_age_s
+ */
+bool wifi_scan_find(const char *ssid, uint32_t max_age_s, wifi_scan_ap_t *out);
+
+/**
+ * @brief Call `fn` after every completed scan (init time)
+ */
+void wifi_scan_add_listener(wifi_scan_listener_t fn);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,125 @@
+#include "anim_image.h"
+#include <string.h>
+
+#define MY_CLASS &anim_image_class
+
+static void anim_image_constructor(const lv_obj_class_t *class_p, lv_obj_t *obj);
+
+const lv_obj_class_t anim_image_class = {
+    .base_class = &lv_img_class,
+    .constructor_cb = anim_image_constructor,
+    .width_def = LV_SIZE_CONTENT,
+    .height_def = LV_SIZE_CONTENT,
+    .instance_size = sizeof(anim_image_t),
+};
+
+static void anim_image_constructor(const lv_obj_class_t *class_p, lv_obj_t *obj)
+{
+    LV_UNUSED(class_p);
+    anim_image_t *ai = (anim_image_t *)obj;
+
+    memset(ai->dsc, 0, sizeof(ai->dsc));
+    ai->active = 0;
+    ai->shown_frame = ANIM_IMAGE_NO_FRAME;
+    ai->full_updates = 0;
+    ai->partial_updates = 0;
+    ai->partial_pixels = 0;
+    ai->blit_updates = 0;
+}
+
+extern "C" lv_obj_t *anim_image_create(lv_obj_t *parent, uint16_t w, uint16_t h)
+{
+    lv_obj_t *obj = lv_obj_class_create_obj(MY_CLASS, parent);
+    lv_obj_class_init_obj(obj);
+
+    anim_image_t *ai = (anim_image_t *)obj;
+    for (int i = 0; i < 2; i++) {
+        ai->dsc[i].header.cf = LV_IMG_CF_TRUE_COLOR;
+        ai->dsc[i].header.w = w;
+        ai->dsc[i].header.h = h;
+        ai->dsc[i].data_size = (uint32_t)w * h * 2;
+        ai->dsc[i].data = NULL;
+    }
+    lv_obj_set_size(obj, w, h);  // Keep the layout stable before the first frame
+    return obj;
+}
+
+extern "C" bool anim_image_is_patch(lv_obj_t *obj, const frame_dirty_t *dirty)
+{
+    anim_image_t *ai = (anim_image_t *)obj;
+    return dirty != NULL && !dirty->full && ai->shown_frame != ANIM_IMAGE_NO_FRAME &&
+           dirty->base_frame == ai->shown_frame;
+}
+
+extern "C" void anim_image_set_frame(lv_obj_t *obj, uint16_t frame_id, const uint8_t *pixels,
+                                     const frame_dirty_t *dirty)
+{
+    anim_image_t *ai = (anim_image_t *)obj;
+
+    if (anim_image_is_patch(obj, dirty)) {
+        // Same descriptor, new pixels: drop its cache entry and repaint only
+        // what the decoder says changed
+        lv_img_dsc_t *dsc = &ai->dsc[ai->active];
+        dsc->data = pixels;
+        lv_img_cache_invalidate_src(dsc);
+
+        lv_area_t img_area;
+        lv_obj_get_coords(obj, &img_area);
+        for (uint8_t i = 0; i < dirty->count; i++) {
+            const frame_rect_t *r = &dirty->rects[i];
+            lv_area_t area = {
+                .x1 = (lv_coord_t)(img_area.x1 + r->x),
+                .y1 = (lv_coord_t)(img_area.y1 + r->y),
+                .x2 = (lv_coord_t)(img_area.x1 + r->x + r->w - 1),
+                .y2 = (lv_coord_t)(img_area.y1 + r->y + r->h - 1)
+            };
+            lv_obj_invalidate_area(obj, &area);
+            ai->partial_pixels += (uint32_t)r->w * r->h;
+        }
+        ai->partial_updates++;
+    } else {
+        // Full frame: flip descriptors so LVGL sees a "new" source
+        ai->active ^= 1;
+        ai->dsc[ai->active].data = pixels;
+        lv_img_set_src(obj, &ai->dsc[ai->active]);
+        ai->full_updates++;
+    }
+
+    ai->shown_frame = frame_id;
+}
+
+extern "C" void anim_image_set_frame_blitted(lv_obj_t *obj, uint16_t frame_id, const uint8_t *pixels,
+                                             const lv_area_t *redraw, uint8_t redraw_count)
+{
+    anim_image_t *ai = (anim_image_t *)obj;
+
+    // First frame ever: the widget has no source yet, so give it one (the
+    // full redraw this costs happens once)
+    if (lv_img_get_src(obj) == NULL) {
+        anim_image_set_frame(obj, frame_id, pixels, NULL);
+        return;
+    }
+
+    // The panel already shows these pixels: keep LVGL's copy of the
+    // truth in step without asking it to draw the image again
+    lv_img_dsc_t *dsc = &ai->dsc[ai->active];
+    dsc->data = pixels;
+    lv_img_cache_invalidate_src(dsc);
+
+    for (uint8_t i = 0; i < redraw_count; i++) {
+        lv_obj_invalidate_area(obj, &redraw[i]);
+    }
+
+    ai->shown_frame = frame_id;
+    ai->blit_updates++;
+}
+
+extern "C" void anim_image_reset(lv_obj_t *obj)
+{
+    ((anim_image_t *)obj)->shown_frame = ANIM_IMAGE_NO_FRAME;
+}
+
+extern "C" uint16_t anim_image_shown_frame(lv_obj_t *obj)
+{
+    return ((anim_image_t *)obj)->shown_frame;
+}
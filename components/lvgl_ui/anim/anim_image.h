@@ -0,0 +1,86 @@
+#ifndef __ANIM_IMAGE_H__
+#define __ANIM_IMAGE_H__
+
+#include <stdint.h>
+#include "lvgl.h"
+#include "codec/frame_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ANIMATION IMAGE WIDGET - lv_img SUBCLASS WITH DIRTY-RECT UPDATES
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Owns two RGB565 image descriptors. A full frame flips to the other
+// descriptor (LVGL only redraws an image when its source pointer changes)
+// and invalidates the whole widget. A frame whose dirty rects are relative
+// to the frame on screen keeps the descriptor, retargets it at the new
+// pixels and invalidates only those rects - LVGL then renders and flushes
+// just the changed areas.
+//
+// LVGL context only (like every lv_* call).
+
+#define ANIM_IMAGE_NO_FRAME  0xFFFF
+
+typedef struct {
+    lv_img_t img;                // Base object (must be first)
+    lv_img_dsc_t dsc[2];
+    uint8_t active;              // Index into dsc[] currently set as src
+    uint16_t shown_frame;        // Frame id on screen (ANIM_IMAGE_NO_FRAME = none)
+    uint32_t full_updates;
+    uint32_t partial_updates;
+    uint32_t partial_pixels;     // Pixels invalidated by partial updates
+    uint32_t blit_updates;       // Frames pushed to the panel outside LVGL
+} anim_image_t;
+
+extern const lv_obj_class_t anim_image_class;
+
+/**
+ * @brief Create an animation image of w × h RGB565 pixels
+ */
+lv_obj_t *anim_image_create(lv_obj_t *parent, uint16_t w, uint16_t h);
+
+/**
+ * @brief Show a frame
+ *
+ * @param frame_id Caller's frame number (matched against dirty->base_frame)
+ * @param pixels   w × h RGB565 pixels in panel byte order; must stay valid
+ *                 until the next call
+ * @param dirty    Changed rects relative to dirty->base_frame, or NULL for a
+ *                 full frame. Only used if base_frame is the frame on screen.
+ */
+void anim_image_set_frame(lv_obj_t *obj, uint16_t frame_id, const uint8_t *pixels,
+                          const frame_dirty_t *dirty);
+
+/**
+ * @brief true if anim_image_set_frame() would only repaint dirty rects
+ */
+bool anim_image_is_patch(lv_obj_t *obj, const frame_dirty_t *dirty);
+
+/**
+ * @brief Record a frame that was already written to the panel directly
+ *
+ * Retargets the descriptor without invalidating the image, so LVGL does
+ * not redraw it, and invalidates only `redraw` (screen coordinates) -
+ * the bands under overlay widgets that the blit left out.
+ */
+void anim_image_set_frame_blitted(lv_obj_t *obj, uint16_t frame_id, const uint8_t *pixels,
+                                  const lv_area_t *redraw, uint8_t redraw_count);
+
+/**
+ * @brief Forget the frame on screen so the next update is a full redraw
+ */
+void anim_image_reset(lv_obj_t *obj);
+
+/**
+ * @brief Frame id currently on screen (ANIM_IMAGE_NO_FRAME if none)
+ */
+uint16_t anim_image_shown_frame(lv_obj_t *obj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
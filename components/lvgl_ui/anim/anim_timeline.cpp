@@ -0,0 +1,86 @@
+#include "anim_timeline.h"
+#include "frame_backend.h"
+#include "codec/frame_codec.h"
+#include "esp_log.h"
+
+static const char *TAG = "anim_timeline";
+
+#define TIMELINE_FRAMES  (ANIM_TIMELINE_MOODS * ANIM_TIMELINE_FRAMES_PER_MOOD)
+
+typedef struct {
+    uint16_t hold_ms[TIMELINE_FRAMES];
+    uint8_t loop_start[ANIM_TIMELINE_MOODS];
+} timeline_t;
+
+// storage_task fills the table LVGL is not reading, then publishes it
+static timeline_t tables[2];
+static const timeline_t *published = NULL;
+
+extern "C" void anim_timeline_scan(void)
+{
+    const frame_backend_t *backend = frame_backend_active();
+    if (backend->open == NULL) {
+        __atomic_store_n(&published, (const timeline_t *)NULL, __ATOMIC_RELEASE);
+        ESP_LOGI(TAG, "%s frames carry no timing - fixed frame rate", backend->name);
+        return;
+    }
+
+    timeline_t *t = (__atomic_load_n(&published, __ATOMIC_RELAXED) == &tables[0]) ? &tables[1] : &tables[0];
+    uint16_t *hold_ms = t->hold_ms;
+    uint8_t *loop_start = t->loop_start;
+
+    uint8_t timed = 0;
+    for (uint8_t mood = 0; mood < ANIM_TIMELINE_MOODS; mood++) {
+        loop_start[mood] = 0;
+        uint32_t loop_ms = 0;
+        for (uint8_t i = 0; i < ANIM_TIMELINE_FRAMES_PER_MOOD; i++) {
+            uint8_t frame = mood * ANIM_TIMELINE_FRAMES_PER_MOOD + i;
+            char path[64];
+            frame_container_header_t hdr;
+            FILE *f = backend->open(frame, path, sizeof(path));
+            bool gfrm = f != NULL && frame_codec_peek(f, &hdr);
+            if (f != NULL) {
+                fclose(f);
+            }
+            hold_ms[frame] = gfrm ? hdr.hold_ms : 0;
+            if (gfrm && (hdr.flags & FRAME_FLAG_LOOP_START)) {
+                loop_start[mood] = i;       // Last marked frame wins
+            }
+            timed += hold_ms[frame] != 0;
+            loop_ms += hold_ms[frame];
+        }
+        if (loop_start[mood] != 0 || loop_ms != 0) {
+            ESP_LOGI(TAG, "Mood %u: loop from frame %u, %lu ms of explicit holds", mood, loop_start[mood] + 1,
+                     (unsigned long)loop_ms);
+        }
+    }
+    __atomic_store_n(&published, (const timeline_t *)t, __ATOMIC_RELEASE);
+    ESP_LOGI(TAG, "Timeline from %s: %u of %d frames with their own hold", backend->name, timed, TIMELINE_FRAMES);
+}
+
+extern "C" bool anim_timeline_ready(void)
+{
+    return __atomic_load_n(&published, __ATOMIC_ACQUIRE) != NULL;
+}
+
+extern "C" uint8_t anim_timeline_next(uint8_t mood, uint8_t frame)
+{
+    if (frame == ANIM_TIMELINE_ENTRY) {
+        return 0;
+    }
+    if (frame + 1 < ANIM_TIMELINE_FRAMES_PER_MOOD) {
+        return frame + 1;
+    }
+    const timeline_t *t = __atomic_load_n(&published, __ATOMIC_ACQUIRE);
+    return (mood < ANIM_TIMELINE_MOODS && t != NULL) ? t->loop_start[mood] : 0;
+}
+
+extern "C" int64_t anim_timeline_hold_us(uint8_t frame_index, int64_t period_us)
+{
+    const timeline_t *t = __atomic_load_n(&published, __ATOMIC_ACQUIRE);
+    if (frame_index >= TIMELINE_FRAMES || t == NULL) {
+        return period_us;
+    }
+    int64_t hold_us = (int64_t)t->hold_ms[frame_index] * 1000;
+    return hold_us > period_us ? hold_us : period_us;
+}
@@ -0,0 +1,63 @@
+#ifndef __ANIM_TIMELINE_H__
+#define __ANIM_TIMELINE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ANIMATION TIMELINE - PER-FRAME HOLDS AND MOOD LOOP POINTS
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// GFRM frames carry their own display time (hold_ms) and may mark the frame
+// a mood loops back to (FRAME_FLAG_LOOP_START, see frame_codec.h). A mood
+// with loop start 2 plays 0 1 once on entry, then 2 3 4 5 6 7 2 3 ...; a
+// frame that holds 2 s costs one load and one redraw where the fixed frame
+// rate would have spent twenty. Easing is expressed the same way: longer
+// holds at the ends of a motion, short ones through the middle.
+//
+// storage_task reads the 24 headers (anim_timeline_scan, at start and when
+// the frames change) and publishes the table; until then, and for frames
+// without a GFRM header (legacy dumps, the mapped frames partition), every
+// frame holds one period and each mood loops over all 8 frames - the
+// fixed-rate behaviour.
+
+#define ANIM_TIMELINE_MOODS            3
+#define ANIM_TIMELINE_FRAMES_PER_MOOD  8
+#define ANIM_TIMELINE_ENTRY            0xFF   // "Before frame 0": next is frame 0
+
+/**
+ * @brief Read every frame header from the active backend (storage_task)
+ *
+ * File backends only; a block backend gets the fixed-rate timeline. The
+ * previous table stays readable until the new one is published; a table
+ * is rewritten only two scans later.
+ */
+void anim_timeline_scan(void);
+
+/**
+ * @brief true once the scanned table is published
+ */
+bool anim_timeline_ready(void);
+
+/**
+ * @brief Local index (0-7) of the frame after `frame` in a mood's loop
+ * @param frame Local index, or ANIM_TIMELINE_ENTRY on entering the mood
+ */
+uint8_t anim_timeline_next(uint8_t mood, uint8_t frame);
+
+/**
+ * @brief How long an absolute frame (0-23) stays on screen
+ * @param period_us The current frame period; holds never go below it, so
+ *                  a lowered frame rate still slows every frame
+ */
+int64_t anim_timeline_hold_us(uint8_t frame_index, int64_t period_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
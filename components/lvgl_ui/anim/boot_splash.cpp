@@ -0,0 +1,59 @@
+#include "boot_splash.h"
+#include "frame_map.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+
+static const char *TAG = "boot_splash";
+
+#define LCD_CMD_NOP  0x00
+
+extern "C" bool boot_splash_show(esp_lcd_panel_handle_t panel, esp_lcd_panel_io_handle_t io, int width, int height)
+{
+#if CONFIG_GOLDIE_BOOT_SPLASH
+    if (panel == NULL || io == NULL) {
+        return false;
+    }
+    int64_t t0 = esp_timer_get_time();
+    const uint8_t *frame = frame_map_init(width, height, 1) ? frame_map_get(0) : NULL;
+
+    size_t band_bytes = (size_t)width * SPLASH_BAND_ROWS * 2;
+    uint8_t *band = (uint8_t *)heap_caps_malloc(band_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (band == NULL) {
+        ESP_LOGW(TAG, "No %u bytes of DMA RAM - no splash", (unsigned)band_bytes);
+        return false;
+    }
+    if (frame == NULL) {
+        memset(band, 0, band_bytes);
+    }
+
+    bool ok = true;
+    for (int y = 0; y < height && ok; y += SPLASH_BAND_ROWS) {
+        int rows = height - y < SPLASH_BAND_ROWS ? height - y : SPLASH_BAND_ROWS;
+        if (frame != NULL) {
+            memcpy(band, frame + (size_t)y * width * 2, (size_t)rows * width * 2);
+        }
+        ok = esp_lcd_panel_draw_bitmap(panel, 0, y, width, y + rows, band) == ESP_OK;
+        // Parameter commands wait for queued color data: the band is out
+        // before the buffer is refilled
+        esp_lcd_panel_io_tx_param(io, LCD_CMD_NOP, NULL, 0);
+    }
+    heap_caps_free(band);
+
+    if (!ok) {
+        ESP_LOGE(TAG, "draw_bitmap failed - no splash");
+        return false;
+    }
+    ESP_LOGI(TAG, "%s in %d ms", frame != NULL ? "Frame 0 from mapped flash" : "Panel cleared",
+             (int)((esp_timer_get_time() - t0) / 1000));
+    return frame != NULL;
+#else
+    (void)panel;
+    (void)io;
+    (void)width;
+    (void)height;
+    return false;
+#endif
+}
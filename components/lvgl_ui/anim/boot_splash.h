@@ -0,0 +1,39 @@
+#ifndef __BOOT_SPLASH_H__
+#define __BOOT_SPLASH_H__
+
+#include <stdbool.h>
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BOOT SPLASH (BEFORE LVGL)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Puts frame 0 of the memory-mapped frames partition (frame_map.h) on the
+// panel as soon as it is initialised, while the rest of the boot (LVGL,
+// dashboard, first frame request) still runs. SPI DMA cannot read mapped
+// flash, so the frame goes out in SPLASH_BAND_ROWS bands through one small
+// internal DMA buffer. Without the partition the panel is cleared to black
+// (the dashboard background) instead.
+//
+// The panel's scan rotation (MADCTL) must already match the dashboard's;
+// nothing else may use the panel bus until this returns.
+
+#define SPLASH_BAND_ROWS  16
+
+/**
+ * @brief Draw the splash (CONFIG_GOLDIE_BOOT_SPLASH, no-op otherwise)
+ * @param width, height Panel size in the dashboard's orientation
+ * @return true if frame 0 was shown, false if cleared or skipped
+ */
+bool boot_splash_show(esp_lcd_panel_handle_t panel, esp_lcd_panel_io_handle_t io, int width, int height);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,218 @@
+#include "frame_backend.h"
+#include "frame_map.h"
+#include "storage_fs.h"
+#include "asset_bundle.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include <errno.h>
+#include <sys/stat.h>
+
+static const char *TAG = "frame_backend";
+
+#ifndef CONFIG_GOLDIE_FRAME_SD_IO_KB
+#define CONFIG_GOLDIE_FRAME_SD_IO_KB 16
+#endif
+
+#define SD_SECTOR_SIZE   512
+#define SD_IO_BYTES      ((size_t)CONFIG_GOLDIE_FRAME_SD_IO_KB * 1024)
+
+// ═══════════════════════════════════════════════════════════════════════════
+// STORAGE PARTITION (SPIFFS OR LITTLEFS, FLAT OR PER-MOOD DIRECTORIES)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static bool spiffs_probe(void)
+{
+    char path[48];
+    struct stat st;
+    storage_fs_frame_path(0, path, sizeof(path));
+    return stat(path, &st) == 0;
+}
+
+static FILE *spiffs_open(uint8_t frame_num, char *path, size_t path_len)
+{
+    storage_fs_frame_path(frame_num, path, path_len);
+    return fopen(path, "rb");
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SD CARD (FATFS)
+// ═══════════════════════════════════════════════════════════════════════════
+// The SDMMC driver can only DMA into internal, word-aligned memory; reads
+// into PSRAM are bounced one sector at a time. Giving stdio an internal,
+// sector-aligned buffer makes every refill one multi-sector transfer.
+// storage_task keeps at most one frame file open, so one buffer is enough.
+
+static uint8_t *sd_io_buf = NULL;
+
+static bool sd_probe(void)
+{
+    struct stat st;
+    return stat("/sdcard/frames/frame1.bin", &st) == 0;
+}
+
+static FILE *sd_open(uint8_t frame_num, char *path, size_t path_len)
+{
+    snprintf(path, path_len, "/sdcard/frames/frame%d.bin", frame_num + 1);
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return NULL;
+    }
+
+    if (sd_io_buf == NULL) {
+        sd_io_buf = (uint8_t *)heap_caps_aligned_alloc(SD_SECTOR_SIZE, SD_IO_BYTES,
+                                                       MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (sd_io_buf == NULL) {
+            ESP_LOGW(TAG, "No internal DMA memory for SD read buffer - using stdio default");
+        }
+    }
+    if (sd_io_buf != NULL) {
+        setvbuf(f, (char *)sd_io_buf, _IOFBF, SD_IO_BYTES);
+    }
+    return f;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// RAW "frames" PARTITION (GMAP image, read instead of mapped)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static const esp_partition_t *frames_part = NULL;
+static frame_map_header_t part_hdr;
+
+static bool partition_probe(void)
+{
+    frames_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                           FRAME_MAP_PARTITION_LABEL);
+    if (frames_part == NULL ||
+        esp_partition_read(frames_part, 0, &part_hdr, sizeof(part_hdr)) != ESP_OK) {
+        return false;
+    }
+    return part_hdr.magic == FRAME_MAP_MAGIC && part_hdr.version == FRAME_MAP_VERSION &&
+           (part_hdr.flags & FRAME_MAP_FLAG_NATIVE) && part_hdr.frame_count > 0;
+}
+
+static esp_err_t partition_read(uint8_t frame_num, uint8_t *dst, size_t len)
+{
+    if (frames_part == NULL || frame_num >= part_hdr.frame_count || len > part_hdr.frame_stride) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    size_t offset = part_hdr.data_offset + (size_t)frame_num * part_hdr.frame_stride;
+    return esp_partition_read(frames_part, offset, dst, len);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ASSET BUNDLE (one file or partition, index read at boot)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static bool bundle_probe(void)
+{
+    return asset_bundle_entry(ASSET_FRAME_FIRST) != NULL && asset_bundle_verify(ASSET_FRAME_FIRST);
+}
+
+static FILE *bundle_open(uint8_t frame_num, char *path, size_t path_len)
+{
+    snprintf(path, path_len, "bundle:frame%d", frame_num + 1);
+    if (frame_num > ASSET_FRAME_LAST - ASSET_FRAME_FIRST) {
+        return NULL;
+    }
+    return asset_bundle_open((asset_id_t)(ASSET_FRAME_FIRST + frame_num));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SELECTION
+// ═══════════════════════════════════════════════════════════════════════════
+
+static const frame_backend_t backends[FRAME_BACKEND_COUNT] = {
+#if CONFIG_GOLDIE_STORAGE_FS_LITTLEFS
+    { "littlefs",  spiffs_probe,    spiffs_open, NULL },
+#else
+    { "spiffs",    spiffs_probe,    spiffs_open, NULL },
+#endif
+    { "sdcard",    sd_probe,        sd_open,     NULL },
+    { "partition", partition_probe, NULL,        partition_read },
+    { "bundle",    bundle_probe,    bundle_open, NULL },
+};
+
+static frame_backend_id_t active_id = FRAME_BACKEND_SPIFFS;
+
+extern "C" const frame_backend_t *frame_backend_active(void)
+{
+    return &backends[active_id];
+}
+
+extern "C" const frame_backend_t *frame_backend_get(frame_backend_id_t id)
+{
+    return id < FRAME_BACKEND_COUNT ? &backends[id] : NULL;
+}
+
+extern "C" frame_backend_id_t frame_backend_active_id(void)
+{
+    return active_id;
+}
+
+extern "C" io_sched_dev_t frame_backend_device(void)
+{
+    switch (active_id) {
+    case FRAME_BACKEND_SDCARD:
+        return IO_SCHED_SD;
+    case FRAME_BACKEND_BUNDLE:
+        return io_sched_device_of(asset_bundle_source());   // "partition" is flash too
+    default:
+        return IO_SCHED_FLASH;
+    }
+}
+
+extern "C" void frame_backend_set_active(frame_backend_id_t id)
+{
+    if (id < FRAME_BACKEND_COUNT) {
+        active_id = id;
+    }
+}
+
+extern "C" frame_backend_id_t frame_backend_select(bool (*load)(uint8_t frame_num, uint8_t *buffer),
+                                                   uint8_t *scratch)
+{
+    int64_t best_us = INT64_MAX;
+    frame_backend_id_t best = FRAME_BACKEND_SPIFFS;
+
+    ESP_LOGI(TAG, "Frame backend benchmark (frame 1, full load):");
+    for (int i = 0; i < FRAME_BACKEND_COUNT; i++) {
+        frame_backend_id_t id = (frame_backend_id_t)i;
+        if (!backends[id].probe()) {
+            ESP_LOGI(TAG, "  %-10s  no frames", backends[id].name);
+            continue;
+        }
+
+        frame_backend_set_active(id);
+        load(0, scratch);  // Warm caches / FAT chain lookups
+
+        int64_t t0 = esp_timer_get_time();
+        bool ok = load(0, scratch);
+        int64_t dt = esp_timer_get_time() - t0;
+
+        if (!ok) {
+            ESP_LOGW(TAG, "  %-10s  load FAILED", backends[id].name);
+            continue;
+        }
+        ESP_LOGI(TAG, "  %-10s  %6d ms/frame", backends[id].name, (int)(dt / 1000));
+        if (dt < best_us) {
+            best_us = dt;
+            best = id;
+        }
+    }
+
+#if defined(CONFIG_GOLDIE_FRAME_BACKEND_SPIFFS)
+    best = FRAME_BACKEND_SPIFFS;
+#elif defined(CONFIG_GOLDIE_FRAME_BACKEND_SDCARD)
+    best = FRAME_BACKEND_SDCARD;
+#elif defined(CONFIG_GOLDIE_FRAME_BACKEND_PARTITION)
+    best = FRAME_BACKEND_PARTITION;
+#elif defined(CONFIG_GOLDIE_FRAME_BACKEND_BUNDLE)
+    best = FRAME_BACKEND_BUNDLE;
+#endif
+
+    frame_backend_set_active(best);
+    ESP_LOGI(TAG, "✓ Frames load from %s", backends[best].name);
+    return best;
+}
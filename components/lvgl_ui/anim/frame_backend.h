@@ -0,0 +1,92 @@
+#ifndef __FRAME_BACKEND_H__
+#define __FRAME_BACKEND_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include "io_sched.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FRAME STORAGE BACKENDS - WHERE storage_task READS FRAMES FROM
+// ═══════════════════════════════════════════════════════════════════════════
+//
+//   SPIFFS     /spiffs/frameN.bin           any format frame_codec accepts;
+//                                           SPIFFS or LittleFS (storage_fs.h),
+//                                           or <mood>/frameN.bin
+//   SD card    /sdcard/frames/frameN.bin    same files; read through a
+//                                           DMA-capable, sector-aligned stdio
+//                                           buffer so FATFS issues multi-
+//                                           sector transfers straight into it
+//   Partition  raw "frames" partition       GMAP image (frame_map.h), read
+//                                           with esp_partition_read()
+//   Bundle     asset bundle frames          any frame_codec format, opened by
+//                                           index (asset_bundle.h): no path
+//                                           lookup per frame
+//
+// File backends return a FILE* and the loader decodes it as before.
+// Block backends fill a whole frame in panel byte order instead.
+// frame_backend_select() times one full frame load on every backend that
+// has frames and keeps the fastest (or the one forced in menuconfig).
+
+typedef enum {
+    FRAME_BACKEND_SPIFFS = 0,
+    FRAME_BACKEND_SDCARD,
+    FRAME_BACKEND_PARTITION,
+    FRAME_BACKEND_BUNDLE,
+    FRAME_BACKEND_COUNT
+} frame_backend_id_t;
+
+typedef struct {
+    const char *name;
+    bool (*probe)(void);                                              // Medium present and holds frame 1
+    FILE *(*open)(uint8_t frame_num, char *path, size_t path_len);    // File backends, else NULL
+    esp_err_t (*read)(uint8_t frame_num, uint8_t *dst, size_t len);   // Block backends, else NULL
+} frame_backend_t;
+
+/**
+ * @brief Benchmark the available backends and make the fastest one active
+ *
+ * @param load    Full-frame loader to time (decode + byte swap included)
+ * @param scratch Frame-sized buffer the benchmark may overwrite
+ * @return Selected backend (SPIFFS if nothing else has frames)
+ */
+frame_backend_id_t frame_backend_select(bool (*load)(uint8_t frame_num, uint8_t *buffer),
+                                        uint8_t *scratch);
+
+/**
+ * @brief Backend frame loads currently go through
+ */
+const frame_backend_t *frame_backend_active(void);
+
+/**
+ * @brief One backend's table entry (NULL if id is out of range)
+ */
+const frame_backend_t *frame_backend_get(frame_backend_id_t id);
+
+/**
+ * @brief Id of the backend frame loads currently go through
+ */
+frame_backend_id_t frame_backend_active_id(void);
+
+/**
+ * @brief Device the active backend reads (io_sched.h)
+ */
+io_sched_dev_t frame_backend_device(void);
+
+/**
+ * @brief Force a backend (used by the benchmark and for tests on hardware)
+ */
+void frame_backend_set_active(frame_backend_id_t id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
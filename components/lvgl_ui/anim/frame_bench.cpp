@@ -0,0 +1,210 @@
+#include "frame_bench.h"
+#include "frame_backend.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "frame_bench";
+
+#define BENCH_FILE_SLACK  4096          // Container header + band table beyond a raw frame
+
+typedef enum {
+    BENCH_FMT_RAW = 0,
+    BENCH_FMT_SWAPPED,
+    BENCH_FMT_RLE16,
+    BENCH_FMT_INDEXED,
+    BENCH_FMT_DELTA,
+    BENCH_FMT_JPEG,
+    BENCH_FMT_LEGACY,
+    BENCH_FMT_IMAGE,
+    BENCH_FMT_COUNT
+} bench_fmt_t;
+
+typedef enum {
+    BENCH_OPEN = 0,
+    BENCH_READ,
+    BENCH_DECODE,
+    BENCH_LOAD,
+    BENCH_PATCH,
+    BENCH_STAGE_COUNT
+} bench_stage_t;
+
+static const char *const fmt_names[BENCH_FMT_COUNT] = { "raw", "swapped", "rle16", "indexed", "delta", "jpeg", "legacy", "image" };
+static const char *const stage_names[BENCH_STAGE_COUNT] = { "open", "read", "decode", "load", "patch" };
+
+static std::atomic<bool> storage_done(false);
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+extern "C" void frame_bench_add(frame_bench_series_t *s, int64_t us)
+{
+    if (s->count < FRAME_BENCH_SAMPLES) {
+        s->us[s->count++] = us < 0 ? 0 : (uint32_t)us;
+    }
+}
+
+extern "C" void frame_bench_report(const char *backend, const char *format, const char *stage,
+                                   frame_bench_series_t *s)
+{
+    if (s->count == 0) {
+        return;
+    }
+    qsort(s->us, s->count, sizeof(s->us[0]), cmp_u32);
+    uint16_t n = s->count;
+    ESP_LOGI(TAG, "  %-10s %-8s %-7s n=%2u  p50 %7lu  p95 %7lu  max %7lu us", backend, format, stage, n,
+             (unsigned long)s->us[(n - 1) * 50 / 100], (unsigned long)s->us[(n - 1) * 95 / 100],
+             (unsigned long)s->us[n - 1]);
+}
+
+/**
+ * @brief Format of an open frame file (rewound by frame_codec_peek)
+ */
+static bench_fmt_t file_format(FILE *f)
+{
+    frame_container_header_t hdr;
+    if (!frame_codec_peek(f, &hdr)) {
+        return BENCH_FMT_LEGACY;
+    }
+    switch (hdr.encoding) {
+    case FRAME_ENCODING_RLE16:
+        return BENCH_FMT_RLE16;
+    case FRAME_ENCODING_INDEXED8:
+        return BENCH_FMT_INDEXED;
+    case FRAME_ENCODING_DELTA:
+        return BENCH_FMT_DELTA;
+    case FRAME_ENCODING_JPEG:
+        return BENCH_FMT_JPEG;
+    default:
+        return (hdr.flags & FRAME_FLAG_NATIVE_ORDER) ? BENCH_FMT_SWAPPED : BENCH_FMT_RAW;
+    }
+}
+
+static void bench_backend(frame_backend_id_t id, frame_bench_load_fn load, frame_bench_patch_fn patch,
+                          uint8_t *scratch, uint8_t *work, uint8_t *file_buf, size_t file_cap,
+                          uint16_t width, uint16_t height, frame_bench_series_t *set)
+{
+    const frame_backend_t *b = frame_backend_get(id);
+    size_t frame_bytes = (size_t)width * height * 2;
+    uint8_t scratch_frame = 0xFF;       // Frame scratch holds (0xFF = none)
+    frame_dirty_t dirty;
+
+    frame_backend_set_active(id);
+    load(0, work);                      // Warm caches / FAT chain lookups
+
+    for (uint8_t n = 0; n < FRAME_BENCH_FRAMES; n++) {
+        bench_fmt_t fmt = BENCH_FMT_IMAGE;
+        frame_bench_series_t *row;
+        int64_t t0;
+
+        if (b->open != NULL) {
+            char path[64];
+            t0 = esp_timer_get_time();
+            FILE *f = b->open(n, path, sizeof(path));
+            int64_t open_us = esp_timer_get_time() - t0;
+            if (f == NULL) {
+                continue;               // Not every medium holds every frame
+            }
+            fmt = file_format(f);
+            row = &set[fmt * BENCH_STAGE_COUNT];
+            frame_bench_add(&row[BENCH_OPEN], open_us);
+
+            t0 = esp_timer_get_time();
+            size_t len = fread(file_buf, 1, file_cap, f);
+            frame_bench_add(&row[BENCH_READ], esp_timer_get_time() - t0);
+            bool whole = feof(f) || fgetc(f) == EOF;
+            fclose(f);
+
+            FILE *m = whole ? fmemopen(file_buf, len, "rb") : NULL;
+            if (m != NULL) {
+                t0 = esp_timer_get_time();
+                esp_err_t err = fmt == BENCH_FMT_DELTA ?
+                                frame_codec_apply_delta(m, work, frame_bytes, width, height, &dirty) :
+                                frame_codec_load(m, work, frame_bytes, width, height, true, NULL);
+                int64_t dt = esp_timer_get_time() - t0;
+                fclose(m);
+                if (err == ESP_OK) {
+                    frame_bench_add(&row[BENCH_DECODE], dt);
+                }
+            }
+        } else {
+            row = &set[fmt * BENCH_STAGE_COUNT];
+            t0 = esp_timer_get_time();
+            if (b->read(n, work, frame_bytes) != ESP_OK) {
+                continue;
+            }
+            frame_bench_add(&row[BENCH_READ], esp_timer_get_time() - t0);
+        }
+
+        t0 = esp_timer_get_time();
+        bool ok = load(n, work);
+        if (ok) {
+            frame_bench_add(&row[BENCH_LOAD], esp_timer_get_time() - t0);
+        }
+
+        // Sequential loop: the buffer already holds the previous frame
+        if (scratch_frame != 0xFF && scratch_frame + 1 == n) {
+            t0 = esp_timer_get_time();
+            ok = patch(n, scratch, scratch_frame, NULL, 0xFF, &dirty);
+            if (ok) {
+                frame_bench_add(&row[BENCH_PATCH], esp_timer_get_time() - t0);
+            }
+        } else if (ok) {
+            memcpy(scratch, work, frame_bytes);
+        }
+        scratch_frame = ok ? n : 0xFF;
+    }
+
+    for (int fmt = 0; fmt < BENCH_FMT_COUNT; fmt++) {
+        for (int st = 0; st < BENCH_STAGE_COUNT; st++) {
+            frame_bench_report(b->name, fmt_names[fmt], stage_names[st], &set[fmt * BENCH_STAGE_COUNT + st]);
+        }
+    }
+}
+
+extern "C" void frame_bench_storage(frame_bench_load_fn load, frame_bench_patch_fn patch, uint8_t *scratch,
+                                    uint16_t width, uint16_t height)
+{
+    size_t frame_bytes = (size_t)width * height * 2;
+    size_t file_cap = frame_bytes + BENCH_FILE_SLACK;
+    size_t set_bytes = sizeof(frame_bench_series_t) * BENCH_FMT_COUNT * BENCH_STAGE_COUNT;
+    uint8_t *work = (uint8_t *)heap_caps_malloc(frame_bytes, MALLOC_CAP_SPIRAM);
+    uint8_t *file_buf = (uint8_t *)heap_caps_malloc(file_cap, MALLOC_CAP_SPIRAM);
+    frame_bench_series_t *set = (frame_bench_series_t *)heap_caps_malloc(set_bytes, MALLOC_CAP_SPIRAM);
+
+    if (scratch == NULL || work == NULL || file_buf == NULL || set == NULL) {
+        ESP_LOGW(TAG, "No PSRAM for the frame benchmark - skipped");
+    } else {
+        frame_backend_id_t active = frame_backend_active_id();
+        int64_t t0 = esp_timer_get_time();
+        ESP_LOGI(TAG, "Frame pipeline benchmark, %d frames per backend:", FRAME_BENCH_FRAMES);
+        for (int i = 0; i < FRAME_BACKEND_COUNT; i++) {
+            frame_backend_id_t id = (frame_backend_id_t)i;
+            if (!frame_backend_get(id)->probe()) {
+                ESP_LOGI(TAG, "  %-10s no frames", frame_backend_get(id)->name);
+                continue;
+            }
+            memset(set, 0, set_bytes);
+            bench_backend(id, load, patch, scratch, work, file_buf, file_cap, width, height, set);
+        }
+        frame_backend_set_active(active);
+        ESP_LOGI(TAG, "Storage side done in %d ms", (int)((esp_timer_get_time() - t0) / 1000));
+    }
+
+    heap_caps_free(set);
+    heap_caps_free(file_buf);
+    heap_caps_free(work);
+    storage_done = true;
+}
+
+extern "C" bool frame_bench_storage_done(void)
+{
+    return storage_done;
+}
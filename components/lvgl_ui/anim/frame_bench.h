@@ -0,0 +1,88 @@
+#ifndef __FRAME_BENCH_H__
+#define __FRAME_BENCH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "codec/frame_codec.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FRAME PIPELINE BENCHMARK (CONFIG_GOLDIE_FRAME_BENCHMARK)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Storage side, run once by storage_task after frame_backend_select(): for
+// every backend that holds frames, each of the FRAME_BENCH_FRAMES frames is
+// timed per stage and grouped by its file format:
+//
+//   open    backend open() (file backends)
+//   read    the whole file / partition image, no decode
+//   decode  the same bytes decoded from memory (fmemopen): copy + swap for
+//           raw, RLE16 for compressed, palette expansion for indexed,
+//           rect patching for delta
+//   load    load_frame_from_spiffs() end to end
+//   patch   load_frame_patch_from_spiffs() with the previous frame in the
+//           buffer - what storage_task does on a sequential loop
+//
+// Formats: raw (needs the byte swap), swapped (FRAME_FLAG_NATIVE_ORDER),
+// rle16, indexed (INDEXED8), delta, legacy (no GFRM header) and image
+// (partition backend).
+//
+// Display side, run by the dashboard once the storage side is done:
+// lv_img_set_src() to the last flushed band (render + SPI), and the direct
+// panel blit for comparison, from mapped flash when the frames partition
+// is present.
+//
+// Every row logs n, p50, p95 and max in µs. The animation stalls while it
+// runs (about a minute with SPIFFS): a diagnostics build option only.
+
+#ifndef CONFIG_GOLDIE_FRAME_BENCHMARK
+#define CONFIG_GOLDIE_FRAME_BENCHMARK 0
+#endif
+
+#define FRAME_BENCH_FRAMES   24
+#define FRAME_BENCH_SAMPLES  48        // Per series
+
+typedef struct {
+    uint16_t count;
+    uint32_t us[FRAME_BENCH_SAMPLES];
+} frame_bench_series_t;
+
+typedef bool (*frame_bench_load_fn)(uint8_t frame_num, uint8_t *buffer);
+typedef bool (*frame_bench_patch_fn)(uint8_t frame_num, uint8_t *buffer, uint8_t buffer_frame,
+                                     const uint8_t *ref_buffer, uint8_t ref_frame, frame_dirty_t *dirty);
+
+/**
+ * @brief Time every stage on every backend with frames (storage_task)
+ *
+ * The active backend is restored afterwards.
+ *
+ * @param scratch Frame-sized buffer the benchmark may overwrite
+ */
+void frame_bench_storage(frame_bench_load_fn load, frame_bench_patch_fn patch, uint8_t *scratch,
+                         uint16_t width, uint16_t height);
+
+/**
+ * @brief frame_bench_storage() has finished (any task)
+ */
+bool frame_bench_storage_done(void);
+
+/**
+ * @brief Record one sample (dropped once the series is full)
+ */
+void frame_bench_add(frame_bench_series_t *s, int64_t us);
+
+/**
+ * @brief Log n / p50 / p95 / max of a series (sorts it in place)
+ */
+void frame_bench_report(const char *backend, const char *format, const char *stage,
+                        frame_bench_series_t *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
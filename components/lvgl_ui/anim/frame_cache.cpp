@@ -0,0 +1,278 @@
+#include "frame_cache.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+
+static const char *TAG = "frame_cache";
+
+#ifndef CONFIG_GOLDIE_FRAME_CACHE_KB
+#define CONFIG_GOLDIE_FRAME_CACHE_KB 2560
+#endif
+#ifndef CONFIG_GOLDIE_FRAME_CACHE_PSRAM_RESERVE_KB
+#define CONFIG_GOLDIE_FRAME_CACHE_PSRAM_RESERVE_KB 1024
+#endif
+#ifndef CONFIG_GOLDIE_FRAME_PREFETCH_SLOTS
+#define CONFIG_GOLDIE_FRAME_PREFETCH_SLOTS 2
+#endif
+
+#define FRAME_CACHE_MAX_SLOTS 24   // One per frame is the most that can ever help
+#define FRAME_CACHE_NO_FRAME  0xFF
+#define FRAME_CACHE_FILLING   0xFE // Prefetch slot handed out, not yet valid
+
+typedef struct {
+    uint8_t *pixels;
+    uint8_t frame_index;           // FRAME_CACHE_NO_FRAME = slot unused
+    uint32_t last_use;             // LRU stamp
+    frame_dirty_t dirty;
+} cache_slot_t;
+
+static cache_slot_t slots[FRAME_CACHE_MAX_SLOTS];
+static cache_slot_t prefetch[CONFIG_GOLDIE_FRAME_PREFETCH_SLOTS > 0 ? CONFIG_GOLDIE_FRAME_PREFETCH_SLOTS : 1];
+static uint8_t slots_budget = 0;          // Kconfig budget in slots
+static uint8_t slots_max = 0;             // In use: the power profile's share of it
+static volatile uint8_t share_pct = 100;  // Set from any task, applied by the owner
+static uint8_t share_applied = 100;
+static size_t slot_bytes = 0;
+static uint32_t use_clock = 0;
+static frame_cache_stats_t stats = {};
+
+extern "C" uint8_t frame_cache_init(size_t frame_bytes)
+{
+    frame_cache_clear();
+    slot_bytes = frame_bytes;
+
+    size_t budget = (size_t)CONFIG_GOLDIE_FRAME_CACHE_KB * 1024;
+    size_t n = frame_bytes ? budget / frame_bytes : 0;
+    if (n > FRAME_CACHE_MAX_SLOTS) {
+        n = FRAME_CACHE_MAX_SLOTS;
+    }
+    slots_budget = (uint8_t)n;
+    share_applied = share_pct;
+    slots_max = (uint8_t)(slots_budget * share_applied / 100);
+    stats.slots_max = slots_max;
+
+    ESP_LOGI(TAG, "Frame cache: budget %d KB -> %d slot(s) of %zu bytes (PSRAM free %zu KB)",
+             CONFIG_GOLDIE_FRAME_CACHE_KB, slots_max, frame_bytes,
+             heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024);
+    return slots_max;
+}
+
+static bool psram_allows_slot(void)
+{
+    size_t reserve = (size_t)CONFIG_GOLDIE_FRAME_CACHE_PSRAM_RESERVE_KB * 1024;
+    return heap_caps_get_free_size(MALLOC_CAP_SPIRAM) >= slot_bytes + reserve;
+}
+
+extern "C" const uint8_t *frame_cache_get(uint8_t frame_index, frame_dirty_t *dirty)
+{
+    for (uint8_t i = 0; i < CONFIG_GOLDIE_FRAME_PREFETCH_SLOTS; i++) {
+        if (prefetch[i].pixels != NULL && prefetch[i].frame_index == frame_index) {
+            prefetch[i].last_use = ++use_clock;
+            stats.hits++;
+            stats.prefetch_hits++;
+            if (dirty) {
+                *dirty = prefetch[i].dirty;
+            }
+            return prefetch[i].pixels;
+        }
+    }
+    for (uint8_t i = 0; i < slots_max; i++) {
+        if (slots[i].pixels != NULL && slots[i].frame_index == frame_index) {
+            slots[i].last_use = ++use_clock;
+            stats.hits++;
+            if (dirty) {
+                *dirty = slots[i].dirty;
+            }
+            return slots[i].pixels;
+        }
+    }
+    stats.misses++;
+    return NULL;
+}
+
+// Pick a slot for a new frame: free slot, new allocation, or LRU victim
+static cache_slot_t *acquire_slot(void)
+{
+    cache_slot_t *victim = NULL;
+
+    for (uint8_t i = 0; i < slots_max; i++) {
+        cache_slot_t *s = &slots[i];
+        if (s->pixels != NULL && s->frame_index == FRAME_CACHE_NO_FRAME) {
+            return s;
+        }
+        if (s->pixels == NULL) {
+            if (psram_allows_slot()) {
+                s->pixels = (uint8_t *)heap_caps_malloc(slot_bytes, MALLOC_CAP_SPIRAM);
+                if (s->pixels != NULL) {
+                    stats.slots_allocated++;
+                    return s;
+                }
+            }
+            // PSRAM is tight - stop growing and recycle what we have
+            break;
+        }
+    }
+
+    for (uint8_t i = 0; i < slots_max; i++) {
+        cache_slot_t *s = &slots[i];
+        if (s->pixels != NULL && (victim == NULL || s->last_use < victim->last_use)) {
+            victim = s;
+        }
+    }
+    if (victim != NULL) {
+        stats.evictions++;
+    }
+    return victim;
+}
+
+/**
+ * @brief Follow a new share: free the slots above it
+ */
+static void apply_share(void)
+{
+    uint8_t pct = share_pct;
+    if (pct == share_applied) {
+        return;
+    }
+    share_applied = pct;
+    uint8_t n = (uint8_t)(slots_budget * pct / 100);
+    for (uint8_t i = n; i < slots_max; i++) {
+        if (slots[i].pixels != NULL) {
+            heap_caps_free(slots[i].pixels);
+            stats.slots_allocated--;
+        }
+        slots[i].pixels = NULL;
+        slots[i].frame_index = FRAME_CACHE_NO_FRAME;
+        slots[i].last_use = 0;
+    }
+    ESP_LOGI(TAG, "Frame cache: %d%% of the budget -> %d slot(s)", pct, n);
+    slots_max = n;
+    stats.slots_max = n;
+}
+
+extern "C" bool frame_cache_put(uint8_t frame_index, const uint8_t *pixels, const frame_dirty_t *dirty)
+{
+    apply_share();
+    if (slots_max == 0 || pixels == NULL) {
+        return false;
+    }
+
+    cache_slot_t *s = NULL;
+    for (uint8_t i = 0; i < slots_max; i++) {
+        if (slots[i].pixels != NULL && slots[i].frame_index == frame_index) {
+            s = &slots[i];
+            break;
+        }
+    }
+    if (s == NULL) {
+        s = acquire_slot();
+    }
+    if (s == NULL) {
+        return false;  // Streaming only
+    }
+
+    memcpy(s->pixels, pixels, slot_bytes);
+    s->frame_index = frame_index;
+    s->last_use = ++use_clock;
+    if (dirty) {
+        s->dirty = *dirty;
+    } else {
+        s->dirty.full = true;
+        s->dirty.base_frame = FRAME_BASE_NONE;
+        s->dirty.count = 0;
+    }
+    return true;
+}
+
+extern "C" uint8_t *frame_cache_prefetch_slot(uint8_t frame_index)
+{
+    if (CONFIG_GOLDIE_FRAME_PREFETCH_SLOTS == 0 || slot_bytes == 0) {
+        return NULL;
+    }
+
+    // Already resident (prefetched or in the playing loop)?
+    for (uint8_t i = 0; i < CONFIG_GOLDIE_FRAME_PREFETCH_SLOTS; i++) {
+        if (prefetch[i].pixels != NULL && prefetch[i].frame_index == frame_index) {
+            return NULL;
+        }
+    }
+    for (uint8_t i = 0; i < slots_max; i++) {
+        if (slots[i].pixels != NULL && slots[i].frame_index == frame_index) {
+            return NULL;
+        }
+    }
+
+    cache_slot_t *s = NULL;
+    for (uint8_t i = 0; i < CONFIG_GOLDIE_FRAME_PREFETCH_SLOTS; i++) {
+        cache_slot_t *p = &prefetch[i];
+        if (p->pixels == NULL || p->frame_index == FRAME_CACHE_NO_FRAME) {
+            s = p;
+            break;
+        }
+        if (s == NULL || p->last_use < s->last_use) {
+            s = p;
+        }
+    }
+
+    if (s->pixels == NULL) {
+        if (!psram_allows_slot()) {
+            return NULL;
+        }
+        s->pixels = (uint8_t *)heap_caps_malloc(slot_bytes, MALLOC_CAP_SPIRAM);
+        if (s->pixels == NULL) {
+            return NULL;
+        }
+    }
+
+    s->frame_index = FRAME_CACHE_FILLING;
+    s->last_use = ++use_clock;
+    return s->pixels;
+}
+
+extern "C" void frame_cache_commit_prefetch(uint8_t frame_index, bool ok)
+{
+    for (uint8_t i = 0; i < CONFIG_GOLDIE_FRAME_PREFETCH_SLOTS; i++) {
+        cache_slot_t *p = &prefetch[i];
+        if (p->pixels != NULL && p->frame_index == FRAME_CACHE_FILLING) {
+            p->frame_index = ok ? frame_index : FRAME_CACHE_NO_FRAME;
+            p->dirty.full = true;
+            p->dirty.base_frame = FRAME_BASE_NONE;
+            p->dirty.count = 0;
+            return;
+        }
+    }
+}
+
+extern "C" void frame_cache_set_share(uint8_t pct)
+{
+    share_pct = pct > 100 ? 100 : pct;
+}
+
+extern "C" void frame_cache_clear(void)
+{
+    for (uint8_t i = 0; i < FRAME_CACHE_MAX_SLOTS; i++) {
+        if (slots[i].pixels != NULL) {
+            heap_caps_free(slots[i].pixels);
+        }
+        slots[i].pixels = NULL;
+        slots[i].frame_index = FRAME_CACHE_NO_FRAME;
+        slots[i].last_use = 0;
+    }
+    for (uint8_t i = 0; i < CONFIG_GOLDIE_FRAME_PREFETCH_SLOTS; i++) {
+        if (prefetch[i].pixels != NULL) {
+            heap_caps_free(prefetch[i].pixels);
+        }
+        prefetch[i].pixels = NULL;
+        prefetch[i].frame_index = FRAME_CACHE_NO_FRAME;
+        prefetch[i].last_use = 0;
+    }
+    stats.slots_allocated = 0;
+}
+
+extern "C" void frame_cache_get_stats(frame_cache_stats_t *out)
+{
+    if (out) {
+        *out = stats;
+    }
+}
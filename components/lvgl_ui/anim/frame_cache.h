@@ -0,0 +1,90 @@
+#ifndef __FRAME_CACHE_H__
+#define __FRAME_CACHE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "codec/frame_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PSRAM FRAME CACHE (LRU)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Keeps decoded frames resident so the animation loop stops hitting flash
+// after its first pass. Slots are allocated lazily up to the Kconfig budget
+// (CONFIG_GOLDIE_FRAME_CACHE_KB); if PSRAM is tight the least recently used
+// frame is recycled, and with no slot at all the caller just streams. The
+// power profile (power_gov.h) may shrink the budget: frame_cache_set_share().
+//
+// NOT thread-safe: owned by storage_task (frame_cache_set_share: any task).
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t prefetch_hits;    // Hits served from a speculative slot
+    uint8_t  slots_allocated;
+    uint8_t  slots_max;
+} frame_cache_stats_t;
+
+/**
+ * @brief Set up the cache for frames of frame_bytes each
+ * @return Number of slots the budget allows (0 = caching disabled)
+ */
+uint8_t frame_cache_init(size_t frame_bytes);
+
+/**
+ * @brief Look up a frame
+ * @param dirty Optional, receives the dirty rects stored with the frame
+ * @return Cached pixels or NULL on miss. Valid until the next put/clear.
+ */
+const uint8_t *frame_cache_get(uint8_t frame_index, frame_dirty_t *dirty);
+
+/**
+ * @brief Store a copy of a decoded frame (evicts the LRU entry if full)
+ * @return true if the frame was cached
+ */
+bool frame_cache_put(uint8_t frame_index, const uint8_t *pixels, const frame_dirty_t *dirty);
+
+/**
+ * @brief Get a speculative slot to decode a prefetched frame into
+ *
+ * Prefetch slots (CONFIG_GOLDIE_FRAME_PREFETCH_SLOTS) live outside the LRU
+ * budget so speculation never evicts the loop that is playing. The oldest
+ * prefetch is replaced. Call frame_cache_commit_prefetch() once filled.
+ *
+ * @return Buffer to fill, or NULL if the frame is already cached or no slot
+ *         could be allocated
+ */
+uint8_t *frame_cache_prefetch_slot(uint8_t frame_index);
+
+/**
+ * @brief Mark a prefetch slot filled by frame_cache_prefetch_slot() valid
+ * @param ok false if decoding failed (slot is released)
+ */
+void frame_cache_commit_prefetch(uint8_t frame_index, bool ok);
+
+/**
+ * @brief Use pct% of the slot budget (any task)
+ *
+ * Slots above the new count are freed by the next put; growing back
+ * allocates lazily as usual.
+ */
+void frame_cache_set_share(uint8_t pct);
+
+/**
+ * @brief Drop all entries and free their PSRAM
+ */
+void frame_cache_clear(void);
+
+void frame_cache_get_stats(frame_cache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,180 @@
+#include "frame_load.h"
+#include "frame_backend.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+static const char *TAG = "frame_load";
+
+// Set to 1 if colors appear wrong (swaps byte order)
+#define SWAP_RGB565_BYTES 1  // Toggle if colors are wrong
+
+#define MAX_DELTA_CHAIN 8    // A mood category's frames
+
+// Only for file backends (frame_backend_active()->open != NULL)
+static FILE *open_frame_file(uint8_t frame_num, char *filepath, size_t len) {
+    FILE *f = frame_backend_active()->open(frame_num, filepath, len);
+    
+    ESP_LOGD(TAG, "[STORAGE] Opening file: %s", filepath);
+    
+    if (f == NULL) {
+        ESP_LOGE(TAG, "[STORAGE] ✗ fopen() FAILED for %s (errno=%d)", filepath, errno);
+    }
+    return f;
+}
+
+// Swap only the pixels a load actually wrote (whole frame or delta rects)
+static void swap_loaded_pixels(uint8_t *buffer, uint16_t flags, const frame_dirty_t *dirty) {
+#if SWAP_RGB565_BYTES
+    // Assets exported with FRAME_FLAG_NATIVE_ORDER are already in panel order
+    if (flags & FRAME_FLAG_NATIVE_ORDER) {
+        return;
+    }
+    if (dirty == NULL || dirty->full) {
+        frame_codec_swap_rgb565(buffer, ANIM_FRAME_BYTES);
+        return;
+    }
+    for (uint8_t i = 0; i < dirty->count; i++) {
+        const frame_rect_t *r = &dirty->rects[i];
+        for (uint16_t y = 0; y < r->h; y++) {
+            frame_codec_swap_rgb565(buffer + ((size_t)(r->y + y) * ANIM_FRAME_WIDTH + r->x) * 2, (size_t)r->w * 2);
+        }
+    }
+#endif
+}
+
+// Apply one delta file on top of a buffer that already holds its base frame
+static bool apply_frame_delta(FILE *f, const char *filepath, uint16_t flags, uint8_t *buffer, frame_dirty_t *dirty) {
+    esp_err_t err = frame_codec_apply_delta(f, buffer, ANIM_FRAME_BYTES, ANIM_FRAME_WIDTH, ANIM_FRAME_HEIGHT, dirty);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "[STORAGE] ✗ Delta apply FAILED for %s (%s)", filepath, esp_err_to_name(err));
+        return false;
+    }
+    swap_loaded_pixels(buffer, flags, dirty);
+    ESP_LOGD(TAG, "[STORAGE] Patched %d rect(s) from %s", dirty->count, filepath);
+    return true;
+}
+
+// Load of rows [*row_from, *row_to) of one frame (all rows: the streamed
+// full decode); delta frames are rebuilt from their keyframe. The rows
+// actually decoded come back, whole bands, at least the rows asked for
+static bool load_frame_rows(uint8_t frame_num, uint8_t *buffer, int depth, uint16_t *row_from, uint16_t *row_to) {
+    const frame_backend_t *backend = frame_backend_active();
+    if (backend->open == NULL) {
+        // Block backend: whole frame already in panel byte order
+        esp_err_t err = backend->read(frame_num, buffer, ANIM_FRAME_BYTES);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "[STORAGE] ✗ Frame %d read FAILED from %s (%s)", frame_num + 1,
+                     backend->name, esp_err_to_name(err));
+            return false;
+        }
+        *row_from = 0;
+        *row_to = ANIM_FRAME_HEIGHT;
+        return true;
+    }
+    bool all_rows = *row_from == 0 && *row_to == ANIM_FRAME_HEIGHT;
+    
+    char filepath[64];
+    FILE *f = open_frame_file(frame_num, filepath, sizeof(filepath));
+    if (f == NULL) {
+        return false;
+    }
+    
+    frame_container_header_t hdr;
+    if (frame_codec_peek(f, &hdr) && hdr.encoding == FRAME_ENCODING_DELTA) {
+        if (depth >= MAX_DELTA_CHAIN || hdr.base_frame >= ANIM_TOTAL_FRAMES || hdr.base_frame == frame_num) {
+            ESP_LOGE(TAG, "[STORAGE] ✗ Broken delta chain at %s (base=%u)", filepath, hdr.base_frame);
+            fclose(f);
+            return false;
+        }
+        fclose(f);
+        if (!load_frame_rows((uint8_t)hdr.base_frame, buffer, depth + 1, row_from, row_to)) {
+            return false;
+        }
+        f = open_frame_file(frame_num, filepath, sizeof(filepath));
+        if (f == NULL) {
+            return false;
+        }
+        frame_dirty_t dirty;
+        bool ok = apply_frame_delta(f, filepath, hdr.flags, buffer, &dirty);
+        fclose(f);
+        return ok;
+    }
+    
+    // GFRM containers are decoded band by band straight into the buffer,
+    // legacy raw/LVGL .bin dumps are read whole (header skipped if present)
+    frame_codec_info_t info;
+    esp_err_t err = all_rows ? frame_codec_load(f, buffer, ANIM_FRAME_BYTES, ANIM_FRAME_WIDTH, ANIM_FRAME_HEIGHT,
+                                                SWAP_RGB565_BYTES, &info)
+                             : frame_codec_load_rows(f, buffer, ANIM_FRAME_BYTES, ANIM_FRAME_WIDTH, ANIM_FRAME_HEIGHT,
+                                                     SWAP_RGB565_BYTES, row_from, row_to, &info);
+    fclose(f);
+    
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "[STORAGE] ✗ Frame load FAILED for %s (%s)", filepath, esp_err_to_name(err));
+        return false;
+    }
+    
+    ESP_LOGD(TAG, "[STORAGE] Read %zu bytes successfully (%s)", info.bytes_read,
+             info.source == FRAME_SOURCE_CONTAINER ? "gfrm" :
+             info.source == FRAME_SOURCE_LVGL_BIN ? "lvgl bin" : "raw");
+    
+    // Already in panel order: frame_codec swaps while it copies
+    return true;
+}
+
+static bool load_frame_full(uint8_t frame_num, uint8_t *buffer) {
+    uint16_t row_from = 0;
+    uint16_t row_to = ANIM_FRAME_HEIGHT;
+    return load_frame_rows(frame_num, buffer, 0, &row_from, &row_to);
+}
+
+extern "C" bool load_frame_from_spiffs(uint8_t frame_num, uint8_t *buffer) {
+    return load_frame_full(frame_num, buffer);
+}
+
+extern "C" bool load_frame_rows_from_spiffs(uint8_t frame_num, uint8_t *buffer, uint8_t buffer_frame,
+                                            const uint8_t *ref_buffer, uint8_t ref_frame,
+                                            uint16_t *row_from, uint16_t *row_to, frame_dirty_t *dirty) {
+    dirty->full = true;
+    dirty->base_frame = FRAME_BASE_NONE;
+    dirty->count = 0;
+    
+    if (frame_backend_active()->open == NULL) {
+        return load_frame_rows(frame_num, buffer, 0, row_from, row_to);  // No delta files on block backends
+    }
+    
+    char filepath[64];
+    FILE *f = open_frame_file(frame_num, filepath, sizeof(filepath));
+    if (f == NULL) {
+        return false;
+    }
+    
+    frame_container_header_t hdr;
+    bool is_delta = frame_codec_peek(f, &hdr) && hdr.encoding == FRAME_ENCODING_DELTA;
+    
+    if (is_delta && (hdr.base_frame == buffer_frame ||
+                     (ref_buffer != NULL && hdr.base_frame == ref_frame))) {
+        if (hdr.base_frame != buffer_frame) {
+            // Base is in the other (displayed) buffer - reading it concurrently is safe
+            size_t first = (size_t)*row_from * ANIM_FRAME_ROW_BYTES;
+            memcpy(buffer + first, ref_buffer + first, (size_t)(*row_to - *row_from) * ANIM_FRAME_ROW_BYTES);
+        }
+        bool ok = apply_frame_delta(f, filepath, hdr.flags, buffer, dirty);
+        fclose(f);
+        return ok;
+    }
+    
+    fclose(f);
+    return load_frame_rows(frame_num, buffer, 0, row_from, row_to);
+}
+
+extern "C" bool load_frame_patch_from_spiffs(uint8_t frame_num, uint8_t *buffer, uint8_t buffer_frame,
+                                             const uint8_t *ref_buffer, uint8_t ref_frame,
+                                             frame_dirty_t *dirty) {
+    uint16_t row_from = 0;
+    uint16_t row_to = ANIM_FRAME_HEIGHT;
+    return load_frame_rows_from_spiffs(frame_num, buffer, buffer_frame, ref_buffer, ref_frame,
+                                       &row_from, &row_to, dirty);
+}
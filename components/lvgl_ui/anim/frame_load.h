@@ -0,0 +1,67 @@
+#ifndef __FRAME_LOAD_H__
+#define __FRAME_LOAD_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "codec/frame_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FRAME LOADER - ONE ANIMATION FRAME FROM THE ACTIVE BACKEND INTO A BUFFER
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Opens frameN on the active storage backend (frame_backend.h) and decodes
+// it with frame_codec into a full-frame RGB565 buffer in panel byte order.
+// Delta frames are rebuilt from their keyframe, or patched on top of a
+// buffer that already holds it. A partly scrolled animation needs only
+// some rows; load_frame_rows_from_spiffs decodes just the bands that hold
+// them.
+//
+// Called from storage_task only (and the frame benchmark it runs).
+
+#define ANIM_FRAME_WIDTH     480
+#define ANIM_FRAME_HEIGHT    320
+#define ANIM_FRAME_ROW_BYTES (ANIM_FRAME_WIDTH * 2)                     // RGB565
+#define ANIM_FRAME_BYTES     (ANIM_FRAME_ROW_BYTES * ANIM_FRAME_HEIGHT)
+#define ANIM_TOTAL_FRAMES    24             // 3 mood categories x 8 frames
+
+#define FRAME_SLOT_EMPTY     0xFF           // Buffer content unknown / not a valid frame
+
+/**
+ * @brief Full load of one frame into buffer (ANIM_FRAME_BYTES)
+ */
+bool load_frame_from_spiffs(uint8_t frame_num, uint8_t *buffer);
+
+/**
+ * @brief Delta-aware frame load
+ *
+ * buffer_frame / ref_frame say which frame each buffer currently holds
+ * (FRAME_SLOT_EMPTY if unknown). If frame_num is a delta on top of one of
+ * them, only the dirty rects are decoded; dirty reports what changed so the
+ * LVGL side can invalidate just those areas. Anything else is a full load.
+ */
+bool load_frame_patch_from_spiffs(uint8_t frame_num, uint8_t *buffer, uint8_t buffer_frame,
+                                  const uint8_t *ref_buffer, uint8_t ref_frame,
+                                  frame_dirty_t *dirty);
+
+/**
+ * @brief Delta-aware load of the rows on screen
+ *
+ * As load_frame_patch_from_spiffs, but buffer_frame / ref_frame need only
+ * hold their frame in rows [*row_from, *row_to), and a load that is not a
+ * patch decodes just the bands holding those rows. The rows that are now
+ * valid come back in row_from / row_to: whole bands, at least those asked
+ * for.
+ */
+bool load_frame_rows_from_spiffs(uint8_t frame_num, uint8_t *buffer, uint8_t buffer_frame,
+                                 const uint8_t *ref_buffer, uint8_t ref_frame,
+                                 uint16_t *row_from, uint16_t *row_to, frame_dirty_t *dirty);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,86 @@
+#include "frame_map.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+
+static const char *TAG = "frame_map";
+
+static const uint8_t *map_base = NULL;
+static esp_partition_mmap_handle_t map_handle;
+static frame_map_header_t map_hdr;
+
+extern "C" bool frame_map_init(uint16_t width, uint16_t height, uint8_t frame_count)
+{
+    if (map_base != NULL) {
+        // Mapped earlier (boot splash): still check what this caller needs
+        if (map_hdr.width == width && map_hdr.height == height && map_hdr.frame_count >= frame_count) {
+            return true;
+        }
+        ESP_LOGE(TAG, "Frames partition mismatch: %dx%d × %d, expected %dx%d × %d",
+                 map_hdr.width, map_hdr.height, map_hdr.frame_count, width, height, frame_count);
+        esp_partition_munmap(map_handle);
+        map_base = NULL;
+        return false;
+    }
+
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           ESP_PARTITION_SUBTYPE_ANY,
+                                                           FRAME_MAP_PARTITION_LABEL);
+    if (part == NULL) {
+        ESP_LOGI(TAG, "No '%s' partition - frames stream from storage", FRAME_MAP_PARTITION_LABEL);
+        return false;
+    }
+
+    if (esp_partition_read(part, 0, &map_hdr, sizeof(map_hdr)) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read frames partition header");
+        return false;
+    }
+
+    size_t frame_bytes = (size_t)width * height * 2;
+    if (map_hdr.magic != FRAME_MAP_MAGIC || map_hdr.version != FRAME_MAP_VERSION) {
+        ESP_LOGW(TAG, "Frames partition not initialised (magic 0x%08lx) - flash it with make_frame_partition.py",
+                 (unsigned long)map_hdr.magic);
+        return false;
+    }
+    if (map_hdr.width != width || map_hdr.height != height ||
+        map_hdr.frame_count < frame_count || map_hdr.frame_stride < frame_bytes) {
+        ESP_LOGE(TAG, "Frames partition mismatch: %dx%d × %d (stride %lu), expected %dx%d × %d",
+                 map_hdr.width, map_hdr.height, map_hdr.frame_count, (unsigned long)map_hdr.frame_stride,
+                 width, height, frame_count);
+        return false;
+    }
+    if (!(map_hdr.flags & FRAME_MAP_FLAG_NATIVE)) {
+        ESP_LOGE(TAG, "Frames partition is not in panel byte order - rebuild with make_frame_partition.py");
+        return false;
+    }
+
+    size_t map_size = map_hdr.data_offset + (size_t)map_hdr.frame_count * map_hdr.frame_stride;
+    if (map_size > part->size) {
+        ESP_LOGE(TAG, "Frames partition too small: need %zu bytes, have %lu", map_size, (unsigned long)part->size);
+        return false;
+    }
+
+    const void *ptr = NULL;
+    esp_err_t ret = esp_partition_mmap(part, 0, map_size, ESP_PARTITION_MMAP_DATA, &ptr, &map_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "esp_partition_mmap failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+
+    map_base = (const uint8_t *)ptr;
+    ESP_LOGI(TAG, "✓ Mapped %d frames (%zu KB) from '%s' at %p - zero-copy display",
+             map_hdr.frame_count, map_size / 1024, FRAME_MAP_PARTITION_LABEL, map_base);
+    return true;
+}
+
+extern "C" bool frame_map_available(void)
+{
+    return map_base != NULL;
+}
+
+extern "C" const uint8_t *frame_map_get(uint8_t frame_index)
+{
+    if (map_base == NULL || frame_index >= map_hdr.frame_count) {
+        return NULL;
+    }
+    return map_base + map_hdr.data_offset + (size_t)frame_index * map_hdr.frame_stride;
+}
@@ -0,0 +1,67 @@
+#ifndef __FRAME_MAP_H__
+#define __FRAME_MAP_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// MEMORY-MAPPED FRAMES PARTITION (ZERO-COPY DISPLAY)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Optional raw data partition labelled "frames" (see partitions_frames.csv),
+// written by tools/make_frame_partition.py:
+//   frame_map_header_t                  32 bytes
+//   padding up to data_offset           (4 KB, keeps frames sector aligned)
+//   frame_count × frame_stride bytes    raw RGB565, panel byte order
+//
+// The partition is mapped once through esp_partition_mmap() and LVGL image
+// descriptors point straight into flash: no fread, no PSRAM frame buffers,
+// a frame switch is a pointer swap. Frames must carry FRAME_MAP_FLAG_NATIVE
+// because mapped flash cannot be byte-swapped in place.
+
+#define FRAME_MAP_PARTITION_LABEL   "frames"
+#define FRAME_MAP_MAGIC             0x50414D47u  // "GMAP"
+#define FRAME_MAP_VERSION           1
+#define FRAME_MAP_FLAG_NATIVE       0x0001       // Same meaning as FRAME_FLAG_NATIVE_ORDER
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint8_t  version;
+    uint8_t  reserved0;
+    uint16_t flags;            // FRAME_MAP_FLAG_*
+    uint16_t width;
+    uint16_t height;
+    uint16_t frame_count;
+    uint16_t reserved1;
+    uint32_t frame_stride;     // Bytes between consecutive frames
+    uint32_t data_offset;      // Offset of frame 0 from partition start
+    uint8_t  reserved2[8];
+} frame_map_header_t;
+
+/**
+ * @brief Find and map the frames partition
+ *
+ * Safe to call when the partition does not exist (returns false quietly).
+ * @return true if frames can be displayed straight from flash
+ */
+bool frame_map_init(uint16_t width, uint16_t height, uint8_t frame_count);
+
+/**
+ * @brief true once frame_map_init() succeeded
+ */
+bool frame_map_available(void);
+
+/**
+ * @brief Pointer to a mapped frame (0-based), NULL if not mapped
+ */
+const uint8_t *frame_map_get(uint8_t frame_index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
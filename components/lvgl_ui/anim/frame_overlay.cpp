@@ -0,0 +1,266 @@
+#include "frame_overlay.h"
+#include "frame_pool.h"
+#include "pixel_kernels.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+static const char *TAG = "frame_overlay";
+
+typedef struct {
+    uint16_t *under;           // Raw pixels under `box`, box.w per row (PSRAM)
+    frame_rect_t box;          // w == 0: slot not baked
+} slot_copy_t;
+
+// Published by the LVGL side, read by storage_task under `lock`
+static SemaphoreHandle_t lock = NULL;
+static uint8_t *mask = NULL;               // Text coverage, text.w per row (PSRAM)
+static frame_rect_t text = {};             // Where the mask goes; w == 0: no text
+static uint16_t text_color = 0xFFFF;       // RGB565 native order
+static uint16_t shadow_color = 0x0000;
+static uint32_t generation = 0;
+
+// storage_task only
+static slot_copy_t copies[FRAME_POOL_SLOTS];
+static uint32_t baked_generation = 0;      // Text of the last frame baked
+static frame_rect_t baked_box = {};
+
+static uint16_t frame_w = 0;
+static uint16_t frame_h = 0;
+static bool active = false;
+
+static uint16_t rgb565_native(lv_color_t c)
+{
+    return (uint16_t)((LV_COLOR_GET_R(c) << 11) | (LV_COLOR_GET_G(c) << 5) | LV_COLOR_GET_B(c));
+}
+
+// Text plus the shadow's extra row and column, clipped to the frame (lock held)
+static frame_rect_t overlay_box(void)
+{
+    frame_rect_t box = text;
+    if (box.w == 0) {
+        return box;
+    }
+    box.w = (uint16_t)LV_MIN(text.w + 1, frame_w - text.x);
+    box.h = (uint16_t)LV_MIN(text.h + 1, frame_h - text.y);
+    return box;
+}
+
+static frame_rect_t rect_union(const frame_rect_t *a, const frame_rect_t *b)
+{
+    if (a->w == 0) {
+        return *b;
+    }
+    if (b->w == 0) {
+        return *a;
+    }
+    uint16_t x0 = LV_MIN(a->x, b->x);
+    uint16_t y0 = LV_MIN(a->y, b->y);
+    uint16_t x1 = LV_MAX(a->x + a->w, b->x + b->w);
+    uint16_t y1 = LV_MAX(a->y + a->h, b->y + b->h);
+    frame_rect_t r = { x0, y0, (uint16_t)(x1 - x0), (uint16_t)(y1 - y0) };
+    return r;
+}
+
+extern "C" bool frame_overlay_init(uint16_t frame_width, uint16_t frame_height)
+{
+    if (!CONFIG_GOLDIE_FRAME_OVERLAY || active) {
+        return active;
+    }
+    lock = xSemaphoreCreateMutex();
+    mask = (uint8_t *)heap_caps_malloc(FRAME_OVERLAY_MAX_W * FRAME_OVERLAY_MAX_H, MALLOC_CAP_SPIRAM);
+    bool ok = lock != NULL && mask != NULL;
+    for (uint8_t i = 0; i < FRAME_POOL_SLOTS && ok; i++) {
+        copies[i].under = (uint16_t *)heap_caps_malloc(FRAME_OVERLAY_MAX_W * FRAME_OVERLAY_MAX_H * 2,
+                                                       MALLOC_CAP_SPIRAM);
+        copies[i].box.w = 0;
+        ok = copies[i].under != NULL;
+    }
+    if (!ok) {
+        ESP_LOGW(TAG, "No PSRAM for the overlay - the date stays a widget");
+        for (uint8_t i = 0; i < FRAME_POOL_SLOTS; i++) {
+            heap_caps_free(copies[i].under);
+            copies[i].under = NULL;
+        }
+        heap_caps_free(mask);
+        mask = NULL;
+        if (lock != NULL) {
+            vSemaphoreDelete(lock);
+            lock = NULL;
+        }
+        return false;
+    }
+    frame_w = frame_width;
+    frame_h = frame_height;
+    active = true;
+    ESP_LOGI(TAG, "Overlay baked into frames (%dx%d max, %d KB PSRAM)", FRAME_OVERLAY_MAX_W,
+             FRAME_OVERLAY_MAX_H, FRAME_OVERLAY_MAX_W * FRAME_OVERLAY_MAX_H * (1 + 2 * FRAME_POOL_SLOTS) / 1024);
+    return true;
+}
+
+extern "C" bool frame_overlay_active(void)
+{
+    return active;
+}
+
+extern "C" void frame_overlay_set_text(const char *str, const lv_font_t *font, lv_coord_t letter_space,
+                                       lv_coord_t x, lv_coord_t y, lv_color_t color, lv_color_t shadow)
+{
+    if (!active) {
+        return;
+    }
+    lv_point_t size;
+    lv_txt_get_size(&size, str, font, letter_space, 0, LV_COORD_MAX, LV_TEXT_FLAG_NONE);
+    lv_coord_t w = LV_MIN(size.x, FRAME_OVERLAY_MAX_W - 1);
+    lv_coord_t h = LV_MIN(size.y, FRAME_OVERLAY_MAX_H - 1);
+    if (x < 0 || y < 0 || x >= frame_w || y >= frame_h) {
+        w = 0;
+    }
+    w = LV_MIN(w, frame_w - x);
+    h = LV_MIN(h, frame_h - y);
+
+    // LVGL draws the text white on black into a scratch canvas: the
+    // brightness of each pixel is its coverage
+    lv_color_t *canvas_buf = NULL;
+    if (w > 0 && h > 0) {
+        canvas_buf = (lv_color_t *)heap_caps_malloc(LV_CANVAS_BUF_SIZE_TRUE_COLOR(w, h), MALLOC_CAP_SPIRAM);
+        if (canvas_buf == NULL) {
+            ESP_LOGW(TAG, "No PSRAM to render \"%s\" - frames keep the old text", str);
+            return;
+        }
+        lv_obj_t *canvas = lv_canvas_create(lv_layer_top());
+        lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+        lv_canvas_set_buffer(canvas, canvas_buf, w, h, LV_IMG_CF_TRUE_COLOR);
+        lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_COVER);
+        lv_draw_label_dsc_t dsc;
+        lv_draw_label_dsc_init(&dsc);
+        dsc.font = font;
+        dsc.color = lv_color_white();
+        dsc.letter_space = letter_space;
+        lv_canvas_draw_text(canvas, 0, 0, size.x, &dsc, str);    // Clipped, never wrapped
+        lv_obj_del(canvas);
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (canvas_buf != NULL) {
+        for (size_t i = 0; i < (size_t)w * h; i++) {
+            mask[i] = lv_color_brightness(canvas_buf[i]);
+        }
+        text.x = (uint16_t)x;
+        text.y = (uint16_t)y;
+        text.w = (uint16_t)w;
+        text.h = (uint16_t)h;
+    } else {
+        text.w = 0;
+    }
+    text_color = rgb565_native(color);
+    shadow_color = rgb565_native(shadow);
+    generation++;
+    xSemaphoreGive(lock);
+
+    heap_caps_free(canvas_buf);
+    ESP_LOGI(TAG, "\"%s\" baked from the next frame (%dx%d at %d,%d)", str, (int)w, (int)h, (int)x, (int)y);
+}
+
+extern "C" void frame_overlay_restore(uint8_t slot, uint8_t *pixels)
+{
+    if (!active || slot >= FRAME_POOL_SLOTS) {
+        return;
+    }
+    slot_copy_t *c = &copies[slot];
+    uint16_t *px = (uint16_t *)pixels;
+    for (uint16_t r = 0; r < c->box.h && c->box.w != 0; r++) {
+        memcpy(px + (size_t)(c->box.y + r) * frame_w + c->box.x, c->under + (size_t)r * c->box.w,
+               (size_t)c->box.w * 2);
+    }
+    c->box.w = 0;
+}
+
+extern "C" void frame_overlay_unbake(uint8_t src, uint8_t *pixels, const frame_dirty_t *dirty)
+{
+    if (!active || src >= FRAME_POOL_SLOTS || dirty->full) {
+        return;
+    }
+    const slot_copy_t *c = &copies[src];
+    uint16_t *px = (uint16_t *)pixels;
+    for (uint16_t r = 0; r < c->box.h && c->box.w != 0; r++) {
+        uint16_t y = c->box.y + r;
+        uint16_t end = c->box.x + c->box.w;
+        // Runs of the row outside every rect: the rects hold new raw pixels
+        for (uint16_t x = c->box.x; x < end; ) {
+            uint16_t run_end = end;
+            bool inside = false;
+            for (uint8_t i = 0; i < dirty->count; i++) {
+                const frame_rect_t *d = &dirty->rects[i];
+                if (y < d->y || y >= d->y + d->h || x >= d->x + d->w) {
+                    continue;
+                }
+                if (x >= d->x) {
+                    inside = true;
+                    x = d->x + d->w;
+                    break;
+                }
+                run_end = LV_MIN(run_end, d->x);
+            }
+            if (inside) {
+                continue;
+            }
+            memcpy(px + (size_t)y * frame_w + x, c->under + (size_t)r * c->box.w + (x - c->box.x),
+                   (size_t)(run_end - x) * 2);
+            x = run_end;
+        }
+    }
+}
+
+static void mark_dirty(frame_dirty_t *dirty, const frame_rect_t *area)
+{
+    if (dirty->full || area->w == 0) {
+        return;
+    }
+    if (dirty->count < FRAME_MAX_DIRTY_RECTS) {
+        dirty->rects[dirty->count++] = *area;
+    } else {
+        dirty->full = true;
+        dirty->base_frame = FRAME_BASE_NONE;
+        dirty->count = 0;
+    }
+}
+
+extern "C" void frame_overlay_bake(uint8_t slot, uint8_t *pixels, frame_dirty_t *dirty)
+{
+    if (!active || slot >= FRAME_POOL_SLOTS) {
+        return;
+    }
+    slot_copy_t *c = &copies[slot];
+    uint16_t *px = (uint16_t *)pixels;
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    frame_rect_t box = overlay_box();
+    for (uint16_t r = 0; r < box.h; r++) {
+        memcpy(c->under + (size_t)r * box.w, px + (size_t)(box.y + r) * frame_w + box.x, (size_t)box.w * 2);
+    }
+    c->box = box;
+
+    // Shadow one pixel down-right first, then the text over it
+    uint16_t shadow_w = (uint16_t)LV_MIN(text.w, box.w - 1);
+    for (uint16_t r = 0; r + 1 < box.h && r < text.h && shadow_w > 0; r++) {
+        pixel_mask_fill_rgb565_swapped(px + (size_t)(box.y + r + 1) * frame_w + box.x + 1,
+                                       mask + (size_t)r * text.w, shadow_w, shadow_color);
+    }
+    for (uint16_t r = 0; r < text.h && box.w != 0; r++) {
+        pixel_mask_fill_rgb565_swapped(px + (size_t)(box.y + r) * frame_w + box.x,
+                                       mask + (size_t)r * text.w, text.w, text_color);
+    }
+    uint32_t gen = generation;
+    xSemaphoreGive(lock);
+
+    // The frame on screen still shows the old text: repaint both boxes
+    if (gen != baked_generation) {
+        frame_rect_t area = rect_union(&baked_box, &box);
+        mark_dirty(dirty, &area);
+        baked_generation = gen;
+        baked_box = box;
+    }
+}
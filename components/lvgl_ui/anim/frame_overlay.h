@@ -0,0 +1,93 @@
+#ifndef __FRAME_OVERLAY_H__
+#define __FRAME_OVERLAY_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+#include "lvgl.h"
+#include "codec/frame_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FRAME OVERLAY - THE DATE BAKED INTO THE ANIMATION FRAMES
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// The date over the animation was two labels (text + a black shadow one
+// pixel down-right): every animation frame LVGL blended both over the
+// image on Core 0, and the rows they sit on could not take the direct
+// panel blit. Now the text is rasterised once per change into an 8-bit
+// coverage mask (LVGL context, frame_overlay_set_text) and storage_task
+// paints shadow and text into each frame it puts in a pool slot (Core 1),
+// so LVGL draws one opaque image and the labels stay hidden.
+//
+// The pixels under the box stay recoverable, because slots are also delta
+// bases and frames go to the PSRAM cache:
+//   - every slot keeps a copy of the raw pixels under its box; they go
+//     back (frame_overlay_restore) before the slot is refilled
+//   - frame_cache_put() sees the frame before it is baked
+//   - a delta applied on a copy of a baked slot takes the raw pixels
+//     outside its rects from that slot's copy (frame_overlay_unbake)
+// A new text marks its box (and the old one) dirty in the next frame.
+//
+// Mapped frames (frame_map.h) never pass through a slot: the labels stay
+// for them, frame_overlay_init() is not called.
+
+#ifndef CONFIG_GOLDIE_FRAME_OVERLAY
+#define CONFIG_GOLDIE_FRAME_OVERLAY 0
+#endif
+
+#define FRAME_OVERLAY_MAX_W   224     // Box incl. the shadow offset; text is clipped
+#define FRAME_OVERLAY_MAX_H   48
+
+/**
+ * @brief Allocate the mask and the per-slot copies (PSRAM)
+ *
+ * LVGL context, after frame_pool_init(). Until it succeeded every other
+ * call is a no-op and frame_overlay_active() is false.
+ * @return true if frames get the overlay
+ */
+bool frame_overlay_init(uint16_t frame_width, uint16_t frame_height);
+
+/**
+ * @brief true once frames are baked - the labels it replaces hide
+ */
+bool frame_overlay_active(void);
+
+/**
+ * @brief Rasterise the text baked from the next frame on (LVGL context)
+ *
+ * x/y are the text's top-left corner; the shadow goes at x+1/y+1. Frames
+ * already in slots keep the previous text.
+ */
+void frame_overlay_set_text(const char *text, const lv_font_t *font, lv_coord_t letter_space,
+                            lv_coord_t x, lv_coord_t y, lv_color_t color, lv_color_t shadow);
+
+/**
+ * @brief Put the raw pixels back under the slot's box (storage_task,
+ *        before the slot is refilled)
+ */
+void frame_overlay_restore(uint8_t slot, uint8_t *pixels);
+
+/**
+ * @brief `pixels` were copied from baked slot `src`, then patched by
+ *        `dirty`: make the rest of src's box raw again (storage_task,
+ *        before the frame is cached)
+ */
+void frame_overlay_unbake(uint8_t src, uint8_t *pixels, const frame_dirty_t *dirty);
+
+/**
+ * @brief Save the raw pixels under the box and paint the overlay
+ *        (storage_task, before the slot is posted)
+ * @param dirty Extended with the box when the text changed
+ */
+void frame_overlay_bake(uint8_t slot, uint8_t *pixels, frame_dirty_t *dirty);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
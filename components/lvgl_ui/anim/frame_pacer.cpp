@@ -0,0 +1,63 @@
+#include "frame_pacer.h"
+
+extern "C" void frame_pacer_init(frame_pacer_t *p, uint8_t fps, int64_t now_us)
+{
+    if (fps == 0) {
+        fps = 1;
+    }
+    p->period_us = 1000000LL / fps;
+    p->next_deadline_us = now_us + p->period_us;
+    p->presented = 0;
+    p->skipped = 0;
+    p->held = 0;
+}
+
+extern "C" void frame_pacer_set_fps(frame_pacer_t *p, uint8_t fps)
+{
+    if (fps == 0) {
+        fps = 1;
+    }
+    p->period_us = 1000000LL / fps;
+}
+
+extern "C" void frame_pacer_restart(frame_pacer_t *p, int64_t now_us)
+{
+    p->next_deadline_us = now_us;
+}
+
+extern "C" uint8_t frame_pacer_due(const frame_pacer_t *p, int64_t now_us)
+{
+    if (now_us < p->next_deadline_us) {
+        return 0;
+    }
+
+    int64_t due = 1 + (now_us - p->next_deadline_us) / p->period_us;
+    return due > FRAME_PACER_MAX_DUE ? FRAME_PACER_MAX_DUE : (uint8_t)due;
+}
+
+extern "C" void frame_pacer_presented(frame_pacer_t *p, uint8_t due, int64_t now_us)
+{
+    frame_pacer_presented_for(p, due, p->period_us, now_us);
+}
+
+extern "C" void frame_pacer_presented_for(frame_pacer_t *p, uint8_t due, int64_t hold_us, int64_t now_us)
+{
+    p->presented++;
+    if (due > 1) {
+        p->skipped += due - 1;
+    }
+
+    p->next_deadline_us += (int64_t)(due - 1) * p->period_us + hold_us;
+
+    // More than FRAME_PACER_MAX_DUE periods behind (long stall): resync
+    // instead of bursting through the backlog
+    if (p->next_deadline_us <= now_us) {
+        p->next_deadline_us = now_us + hold_us;
+    }
+}
+
+extern "C" void frame_pacer_hold(frame_pacer_t *p, int64_t now_us)
+{
+    p->held++;
+    p->next_deadline_us = now_us + p->period_us;
+}
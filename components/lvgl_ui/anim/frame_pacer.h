@@ -0,0 +1,90 @@
+#ifndef __FRAME_PACER_H__
+#define __FRAME_PACER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FRAME PACER - DEADLINE TRACKING FOR THE ANIMATION TIMER
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Every frame has a deadline one period after the previous one. The LVGL
+// timer polls faster than the frame rate and asks how many periods are due:
+//   0     -> nothing to do yet
+//   1     -> show the next frame
+//   n > 1 -> running late, show the newest ready frame and skip the rest
+// Deadlines advance by whole periods, so a slow frame never shifts the
+// schedule of the ones after it. A frame may hold longer than one period
+// (frame_pacer_presented_for, holds from anim_timeline.h); the deadline
+// after it moves by that hold instead. While the user touches or scrolls the
+// pacer is held and restarts one period after the input stops.
+
+#ifndef CONFIG_GOLDIE_ANIM_FPS
+#define CONFIG_GOLDIE_ANIM_FPS 10
+#endif
+
+#ifndef CONFIG_GOLDIE_ANIM_INPUT_HOLD_MS
+#define CONFIG_GOLDIE_ANIM_INPUT_HOLD_MS 300
+#endif
+
+#define FRAME_PACER_MAX_DUE   8    // Never skip more than one mood loop at once
+
+typedef struct {
+    int64_t period_us;
+    int64_t next_deadline_us;
+    uint32_t presented;          // Frames shown
+    uint32_t skipped;            // Deadlines passed over while late
+    uint32_t held;               // Deadlines deferred for user input
+} frame_pacer_t;
+
+/**
+ * @brief Start pacing at `fps`, first deadline one period from now
+ */
+void frame_pacer_init(frame_pacer_t *p, uint8_t fps, int64_t now_us);
+
+/**
+ * @brief Change the frame rate; counters and the next deadline are kept
+ */
+void frame_pacer_set_fps(frame_pacer_t *p, uint8_t fps);
+
+/**
+ * @brief Make the next frame due immediately (e.g. after a mood change)
+ */
+void frame_pacer_restart(frame_pacer_t *p, int64_t now_us);
+
+/**
+ * @brief Number of frame periods that have elapsed since the last deadline
+ * @return 0 if not due yet, otherwise 1..FRAME_PACER_MAX_DUE
+ */
+uint8_t frame_pacer_due(const frame_pacer_t *p, int64_t now_us);
+
+/**
+ * @brief Record that a frame was shown, consuming `due` periods
+ *
+ * Every period beyond the first counts as a skipped frame.
+ */
+void frame_pacer_presented(frame_pacer_t *p, uint8_t due, int64_t now_us);
+
+/**
+ * @brief Record that a frame was shown that stays up for `hold_us`
+ *
+ * Like frame_pacer_presented(); the skipped deadlines count one period
+ * each and the next deadline lands `hold_us` after the one that was met.
+ */
+void frame_pacer_presented_for(frame_pacer_t *p, uint8_t due, int64_t hold_us, int64_t now_us);
+
+/**
+ * @brief Defer the schedule while input is active
+ */
+void frame_pacer_hold(frame_pacer_t *p, int64_t now_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,88 @@
+#include "frame_pool.h"
+#include "task_coordinator.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+
+static const char *TAG = "frame_pool";
+
+static frame_pool_slot_t pool[FRAME_POOL_SLOTS];
+static size_t slot_bytes = 0;  // 0 = pool not in use (frames mapped from flash)
+
+static void reset_dirty(frame_pool_slot_t *slot)
+{
+    slot->dirty.full = true;
+    slot->dirty.base_frame = FRAME_BASE_NONE;
+    slot->dirty.count = 0;
+}
+
+extern "C" bool frame_pool_init(size_t frame_bytes)
+{
+    if (queue_anim_frame_free == NULL) {
+        ESP_LOGE(TAG, "Free queue missing - task_coordinator_init() must run first");
+        return false;
+    }
+
+    for (uint8_t i = 0; i < FRAME_POOL_SLOTS; i++) {
+        pool[i].pixels = (uint8_t *)heap_caps_malloc(frame_bytes, MALLOC_CAP_SPIRAM);
+        if (pool[i].pixels == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate frame slot %d in PSRAM", i);
+            return false;
+        }
+        reset_dirty(&pool[i]);
+    }
+    slot_bytes = frame_bytes;
+
+    for (uint8_t i = 0; i < FRAME_POOL_SLOTS; i++) {
+        frame_pool_release(i);
+    }
+
+    ESP_LOGI(TAG, "Allocated %d bytes × %d in PSRAM for the frame pool", (int)frame_bytes, FRAME_POOL_SLOTS);
+    return true;
+}
+
+extern "C" frame_pool_slot_t *frame_pool_slot(uint8_t slot)
+{
+    return slot < FRAME_POOL_SLOTS ? &pool[slot] : NULL;
+}
+
+extern "C" void frame_pool_release(uint8_t slot)
+{
+    if (slot >= FRAME_POOL_SLOTS) {
+        return;
+    }
+    // Queue is as deep as the pool, so this can never fail
+    xQueueSend(queue_anim_frame_free, &slot, 0);
+}
+
+extern "C" uint8_t frame_pool_trim(void)
+{
+    uint8_t slot;
+    uint8_t freed = 0;
+    while (xQueueReceive(queue_anim_frame_free, &slot, 0) == pdTRUE) {
+        if (slot < FRAME_POOL_SLOTS && pool[slot].pixels != NULL) {
+            heap_caps_free(pool[slot].pixels);
+            pool[slot].pixels = NULL;
+            freed++;
+        }
+    }
+    return freed;
+}
+
+extern "C" uint8_t frame_pool_restore(void)
+{
+    uint8_t restored = 0;
+    for (uint8_t i = 0; i < FRAME_POOL_SLOTS && slot_bytes > 0; i++) {
+        if (pool[i].pixels != NULL) {
+            continue;
+        }
+        pool[i].pixels = (uint8_t *)heap_caps_malloc(slot_bytes, MALLOC_CAP_SPIRAM);
+        if (pool[i].pixels == NULL) {
+            ESP_LOGW(TAG, "No PSRAM to restore frame slot %d - running with fewer slots", i);
+            continue;
+        }
+        reset_dirty(&pool[i]);
+        frame_pool_release(i);
+        restored++;
+    }
+    return restored;
+}
@@ -0,0 +1,76 @@
+#ifndef __FRAME_POOL_H__
+#define __FRAME_POOL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+#include "codec/frame_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FRAME BUFFER POOL - SHARED BETWEEN STORAGE TASK (WRITER) AND LVGL (READER)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Slot ownership moves through two FreeRTOS queues (task_coordinator.h):
+//   queue_anim_frame_free  : slot ids storage_task may fill     (LVGL -> storage)
+//   queue_anim_frame_ready : anim_frame_ready_msg_t, filled     (storage -> LVGL)
+//
+// Whoever holds a slot id owns its pixels and dirty info. The queues' own
+// locking gives the cross-core ordering the old volatile flags lacked: all
+// writes to a slot happen before its id is posted.
+
+#ifndef CONFIG_GOLDIE_FRAME_POOL_SLOTS
+#define CONFIG_GOLDIE_FRAME_POOL_SLOTS 3
+#endif
+
+#define FRAME_POOL_SLOTS     CONFIG_GOLDIE_FRAME_POOL_SLOTS
+#define FRAME_POOL_NO_SLOT   0xFF
+
+typedef struct {
+    uint8_t *pixels;          // Full RGB565 frame in PSRAM
+    frame_dirty_t dirty;      // What changed relative to dirty.base_frame
+} frame_pool_slot_t;
+
+/**
+ * @brief Allocate the pool buffers in PSRAM and hand every slot to storage_task
+ *
+ * Must run after task_coordinator_init() (needs the free queue).
+ * @return true if all slots were allocated
+ */
+bool frame_pool_init(size_t frame_bytes);
+
+/**
+ * @brief Access a slot by id (0 .. FRAME_POOL_SLOTS-1)
+ */
+frame_pool_slot_t *frame_pool_slot(uint8_t slot);
+
+/**
+ * @brief Return a slot to storage_task (non-blocking)
+ */
+void frame_pool_release(uint8_t slot);
+
+/**
+ * @brief Free the pixels of every slot currently on the free queue
+ *
+ * storage_task only, when it stops. Slots LVGL holds are untouched.
+ * @return Number of slots freed
+ */
+uint8_t frame_pool_trim(void);
+
+/**
+ * @brief Re-allocate slots freed by frame_pool_trim() and release them
+ *
+ * storage_task only, when it starts. No-op if the pool was never set up.
+ * @return Number of slots brought back
+ */
+uint8_t frame_pool_restore(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,103 @@
+#include "panel_blit.h"
+#include "esp_3inch5_lcd_port.h"
+#include "ui/ui_mirror.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lvgl.h"
+
+static const char *TAG = "panel_blit";
+
+#define PANEL_BLIT_WAIT_US  50000   // Give up if LVGL's flush takes longer
+#define LCD_CMD_NOP         0x00
+
+static esp_lcd_panel_handle_t blit_panel = NULL;
+static esp_lcd_panel_io_handle_t blit_io = NULL;
+
+// LVGL task only: armed by a full-frame redraw, taken by the next flush
+static bool sync_next_flush = false;
+static void (*prev_flush)(lv_disp_drv_t *, const lv_area_t *, lv_color_t *) = NULL;
+
+static void te_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    if (sync_next_flush) {
+        sync_next_flush = false;
+        esp_3inch5_te_port_wait();
+    }
+    prev_flush(drv, area, color_p);
+}
+
+extern "C" void panel_blit_init(esp_lcd_panel_handle_t panel, esp_lcd_panel_io_handle_t io)
+{
+    lv_disp_t *disp = lv_disp_get_default();
+    if (esp_3inch5_te_port_available() && disp != NULL && disp->driver->flush_cb != NULL && prev_flush == NULL) {
+        prev_flush = disp->driver->flush_cb;
+        disp->driver->flush_cb = te_flush;
+    }
+#if CONFIG_GOLDIE_ANIM_DIRECT_BLIT
+    blit_panel = panel;
+    blit_io = io;
+    ESP_LOGI(TAG, "Direct frame blit enabled");
+#else
+    (void)panel;
+    (void)io;
+#endif
+}
+
+extern "C" bool panel_blit_available(void)
+{
+    return blit_panel != NULL && blit_io != NULL;
+}
+
+extern "C" bool panel_blit_begin(void)
+{
+    if (!panel_blit_available()) {
+        return false;
+    }
+
+    lv_disp_t *disp = lv_disp_get_default();
+    if (disp == NULL) {
+        return false;
+    }
+
+    // LVGL's last area may still be on the bus
+    int64_t t0 = esp_timer_get_time();
+    while (disp->driver->draw_buf->flushing) {
+        if (esp_timer_get_time() - t0 > PANEL_BLIT_WAIT_US) {
+            ESP_LOGW(TAG, "LVGL flush still busy - skipping direct blit");
+            return false;
+        }
+    }
+    // A frame is a full-screen write: start it as the panel starts a refresh
+    if (esp_3inch5_te_port_available()) {
+        esp_3inch5_te_port_wait();
+    }
+    return true;
+}
+
+extern "C" void panel_blit_sync_next_flush(void)
+{
+    sync_next_flush = prev_flush != NULL;
+}
+
+extern "C" bool panel_blit_rows(const uint8_t *frame, int width, int y0, int y1)
+{
+    if (y1 <= y0) {
+        return true;
+    }
+    // esp_lcd splits the band into max_transfer_sz DMA transactions
+    const uint8_t *band = frame + (size_t)y0 * width * 2;
+    esp_err_t ret = esp_lcd_panel_draw_bitmap(blit_panel, 0, y0, width, y1, band);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "draw_bitmap failed (%s)", esp_err_to_name(ret));
+        return false;
+    }
+    ui_mirror_blit(frame, width, y0, y1);   // Bypassed flush_cb: the mirror needs the rows too
+    return true;
+}
+
+extern "C" void panel_blit_end(void)
+{
+    // Parameter commands wait for queued color data to drain first
+    esp_lcd_panel_io_tx_param(blit_io, LCD_CMD_NOP, NULL, 0);
+}
@@ -0,0 +1,69 @@
+#ifndef __PANEL_BLIT_H__
+#define __PANEL_BLIT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DIRECT-TO-PANEL FRAME BLIT
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Sends animation frame rows straight to the ST7796 with
+// esp_lcd_panel_draw_bitmap(), bypassing LVGL's render + 1/8-screen flush.
+// Frame rows are contiguous in memory, so any full-width band of a frame
+// can go out as one bitmap. Runs in the LVGL task between refreshes:
+//   panel_blit_begin()  wait until LVGL's last flush has finished
+//   panel_blit_rows()   queue one band (SPI DMA), any number of times
+//   panel_blit_end()    send a NOP - esp_lcd waits for queued color data
+// so the esp_lvgl_port "flush done" callback our transfers also fire can
+// never release a buffer LVGL is still flushing.
+//
+// With a tearing-effect line (esp_3inch5_lcd_port.h) panel_blit_begin()
+// also waits for the start of vertical blanking, and a full-frame redraw
+// that goes through LVGL instead (panel_blit_sync_next_flush) has its first
+// flush wait the same way. Partial UI flushes go out at once.
+
+/**
+ * @brief Hand the panel handles to the blitter (call after lv_port_init())
+ */
+void panel_blit_init(esp_lcd_panel_handle_t panel, esp_lcd_panel_io_handle_t io);
+
+/**
+ * @brief true once panel_blit_init() ran (and the feature is enabled)
+ */
+bool panel_blit_available(void);
+
+/**
+ * @brief Wait for LVGL's in-flight flush so the bus is ours, then for vblank
+ * @return false if the panel stayed busy (skip the blit this frame)
+ */
+bool panel_blit_begin(void);
+
+/**
+ * @brief Start LVGL's next flush at vblank (a full frame is being redrawn)
+ *
+ * No-op without a tearing-effect line.
+ */
+void panel_blit_sync_next_flush(void);
+
+/**
+ * @brief Queue rows [y0, y1) of a width-pixel-wide panel-order RGB565 frame
+ */
+bool panel_blit_rows(const uint8_t *frame, int width, int y0, int y1);
+
+/**
+ * @brief Wait for every queued band to reach the panel
+ */
+void panel_blit_end(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
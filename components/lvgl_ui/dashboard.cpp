@@ -5,49 +5,75 @@
 #include "esp_sntp.h"
 #include "messages.h"
 #include "task_coordinator.h"
+#include "queue_watch.h"
+#include "sd_logger.h"
+#include "evt_trace.h"
+#include "input_rec.h"
+#include "esp_lvgl_port.h"
+#include "time_svc.h"
 #include "gemini_api.h"
+#include "ai_chat.h"
+#include "boot_trace.h"
+#include "codec/frame_codec.h"
+#include "anim/frame_pool.h"
+#include "anim/frame_overlay.h"
+#include "anim/frame_pacer.h"
+#include "anim/anim_timeline.h"
+#include "anim/frame_map.h"
+#include "anim/frame_backend.h"
+#include "anim/anim_image.h"
+#include "anim/panel_blit.h"
+#include "anim/frame_bench.h"
+#include "anim/frame_load.h"
+#include "ui/static_layer.h"
+#include "ui/ui_stage.h"
+#include "ui/ui_fonts.h"
+#include "ui/ui_theme.h"
+#include "ui/text_pager.h"
+#include "ui/chat_view.h"
+#include "ui/day_clock.h"
+#include "ui/ui_inbox.h"
+#include "ui/ui_perf.h"
+#include "ui/ui_latency.h"
+#include "ui/ui_arena.h"
+#include "ui/ui_obj_track.h"
+#include "ui/ui_heap.h"
+#include "ui/render_bench.h"
+#include "ui/num_keypad.h"
+#include "ui/med_calc_view.h"
+#include "ui/history_view.h"
+#include "ui/calendar_view.h"
+#include "ui/log_popups.h"
+#include "mood/mood_engine.h"
+#include "mood/mood_trend.h"
+#include "mood/mood_advice.h"
+#include "mood/mood_profiles.h"
+#include "med/med_db.h"
+#include "sched/reminders.h"
+#include "history/history_index.h"
+#include "history/history_store.h"
+#include "history/history_agg.h"
+#include "history/param_series.h"
+#include "state/dash_state.h"
+#include "state/dash_store.h"
+#include "state/dash_log.h"
+#include "state/tank_registry.h"
 #include <stdio.h>
+#include <string.h>
 #include <errno.h>
 #include <time.h>
 #include <sys/time.h>
-#include <sys/stat.h>
 
 static const char *TAG = "dashboard";
 
-// Image buffer for loading from SD card
-#define FRAME_WIDTH 480
-#define FRAME_HEIGHT 320
-#define FRAME_SIZE (FRAME_WIDTH * FRAME_HEIGHT * 2)  // RGB565 = 2 bytes per pixel
-
-// CRITICAL FIX: Dual image descriptors for LVGL redraw triggering
-// LVGL only redraws when the source pointer changes, not just data contents
-// We alternate between these two descriptors to force redraws
-static lv_img_dsc_t anim_dsc_a = {
-    .header = {
-        .cf = LV_IMG_CF_TRUE_COLOR,
-        .always_zero = 0,
-        .reserved = 0,
-        .w = FRAME_WIDTH,
-        .h = FRAME_HEIGHT
-    },
-    .data_size = FRAME_SIZE,
-    .data = NULL
-};
-
-static lv_img_dsc_t anim_dsc_b = {
-    .header = {
-        .cf = LV_IMG_CF_TRUE_COLOR,
-        .always_zero = 0,
-        .reserved = 0,
-        .w = FRAME_WIDTH,
-        .h = FRAME_HEIGHT
-    },
-    .data_size = FRAME_SIZE,
-    .data = NULL
-};
+// Frame geometry and the loader storage_task reads frames with: anim/frame_load.h
+#define FRAME_WIDTH ANIM_FRAME_WIDTH
+#define FRAME_HEIGHT ANIM_FRAME_HEIGHT
+#define FRAME_SIZE ANIM_FRAME_BYTES  // RGB565 = 2 bytes per pixel
 
-// Track which descriptor is currently active (alternates on each frame)
-static lv_img_dsc_t *active_dsc = &anim_dsc_a;
+// The animation is an anim_image widget (anim/anim_image.h): it owns the two
+// alternating image descriptors LVGL needs to notice a new frame, and
+// repaints only the dirty rects of delta frames
 
 // Note: If colors appear wrong, the BIN files might need byte swapping
 // LVGL expects RGB565 in little-endian format
@@ -56,28 +82,33 @@ static lv_img_dsc_t *active_dsc = &anim_dsc_a;
 // FRAME BUFFER STATE - SHARED BETWEEN STORAGE TASK (WRITER) AND LVGL (READER)
 // ═══════════════════════════════════════════════════════════════════════════
 // 
-// WHY VOLATILE: Storage task (Core 1) writes, LVGL task (Core 0) reads.
-// Volatile ensures compiler doesn't cache these values across cores.
-// 
-// WHY NO MUTEX: Lock-free design using atomic flag pattern.
-// - storage_task sets frame_ready = true after loading
-// - LVGL task reads frame_ready, consumes buffer, sets frame_ready = false
-// - Only one writer, one reader = no race condition
+// Frames live in an N-slot PSRAM pool (anim/frame_pool.h). storage_task
+// fills free slots and posts them on queue_anim_frame_ready; the LVGL timer
+// displays them and hands the previously displayed slot back through
+// queue_anim_frame_free. Queue handoff orders the pixel writes before the
+// slot becomes visible on Core 0 - no volatile flags, no dropped requests.
 // 
-// Double buffer for PSRAM frame storage
-uint8_t *frame_buffer_a = NULL;  // PSRAM buffer A (307,200 bytes)
-uint8_t *frame_buffer_b = NULL;  // PSRAM buffer B (307,200 bytes)
-
-// Buffer state (volatile for cross-core visibility)
-volatile bool buffer_a_ready = false;          // true = frame loaded, ready to display
-volatile uint8_t buffer_a_frame_index = 0;     // Which frame is in buffer A (0-23)
-volatile bool buffer_b_ready = false;          // true = frame loaded, ready to display
-volatile uint8_t buffer_b_frame_index = 0;     // Which frame is in buffer B (0-23)
+static uint8_t displayed_slot = FRAME_POOL_NO_SLOT;  // Slot on screen (owned by LVGL)
+static uint8_t requests_in_flight = 0;               // Requested, not yet displayed
+static uint16_t displayed_row_from = 0;              // Rows of the displayed slot holding its frame
+static uint16_t displayed_row_to = FRAME_HEIGHT;
+static uint8_t last_requested_frame = 0;             // Local index (0-7) of newest request,
+                                                     // ANIM_TIMELINE_ENTRY = none yet
 
 // Current display state (ONLY modified by LVGL task)
 static uint8_t current_frame = 0;              // Current frame being displayed (0-7)
 static uint8_t current_category = 0;           // Current mood category (0=HAPPY, 1=SAD, 2=ANGRY)
-static uint32_t last_frame_update_time = 0;    // Timestamp of last frame change (seconds)
+static frame_pacer_t anim_pacer;               // Frame deadlines (anim/frame_pacer.h)
+
+// Poll a few times per frame period so timer jitter never costs a whole frame
+#define ANIM_TIMER_PERIOD_MS  (1000 / CONFIG_GOLDIE_ANIM_FPS / 4)
+
+// Direct blit: row bands LVGL still has to draw (overlay widgets)
+#define ANIM_BLIT_MAX_BANDS   8
+
+// Partly scrolled: frames are decoded for the rows on screen plus this
+// many above and below, so a short scroll stays inside the decoded rows
+#define ANIM_VIEW_MARGIN_ROWS 32
 
 // UI Objects - Main Screen
 static lv_obj_t *animation_img = NULL;
@@ -98,26 +129,40 @@ static lv_obj_t *panel_modal = NULL;
 
 // Weekly calendar day boxes (for updating dots)
 static lv_obj_t *week_day_boxes[7] = {NULL};
+static lv_obj_t *week_day_names[7] = {NULL};  // "MON" label of each box
+
+// Activity dots: a fixed pool per day box, created once and shown, hidden
+// and recoloured in place by refresh_weekly_calendar_dots()
+#define WEEK_FEED_DOTS 4
+typedef enum {
+    WEEK_DOT_HIDDEN = 0,
+    WEEK_DOT_SOLID,     // Activity logged
+    WEEK_DOT_HOLLOW,    // Activity planned, not logged
+} week_dot_state_t;
+static lv_obj_t *week_water_dots[7] = {NULL};
+static lv_obj_t *week_feed_dots[7][WEEK_FEED_DOTS] = {{NULL}};
+static uint8_t week_water_state[7] = {0};
+static uint8_t week_feed_state[7][WEEK_FEED_DOTS] = {{0}};
 
 // New calendar page buttons
 static lv_obj_t *btn_param_log = NULL;
 static lv_obj_t *btn_water_log = NULL;
 static lv_obj_t *btn_feed_log = NULL;
 
-// Pop-up modals
-static lv_obj_t *popup_param = NULL;
-static lv_obj_t *popup_water = NULL;
-static lv_obj_t *popup_feed = NULL;
-static lv_obj_t *popup_history = NULL;
-static lv_obj_t *popup_keypad = NULL;
-static lv_obj_t *popup_monthly_cal = NULL;
-
-// Monthly calendar state
-static int monthly_cal_display_month = 0;  // 0 = current month
-static int monthly_cal_display_year = 0;
-
-// Active input tracking
-static lv_obj_t *active_input_field = NULL;
+// Pop-up modals: the log popups, history, monthly calendar, dosage
+// calculator and keypad are views of their own in ui/ (log_popups.h,
+// history_view.h, calendar_view.h, med_calc_view.h, num_keypad.h) that
+// read the tank through dash_store and write it back through hooks
+static lv_obj_t *popup_chat = NULL;           // Ask Goldie
+
+// Heavy UI work is done in stages (ui/ui_stage.h): the touch handler does
+// what must show at once, the rest follows over the next LVGL ticks
+static ui_stage_t panel_stage;             // Side panel, built after the first frame
+static ui_stage_t week_dots_stage;         // Week strip recolour (owner-less)
+static int32_t week_dots_today;            // Day numbers of the refresh in progress
+static int32_t week_dots_last_water;
+static bool week_dots_have_water;
+static ui_stage_t param_save_stage;        // Parameter popup's Save, after the popup closed
 
 // Scroll container
 static lv_obj_t *scroll_container = NULL;
@@ -126,7 +171,8 @@ static lv_obj_t *scroll_container = NULL;
 static lv_obj_t *btn_home = NULL;
 
 // AI Assistant
-static lv_obj_t *ai_text_label = NULL;
+static lv_obj_t *ai_text_label = NULL;    // ai_pager.label once built
+static text_pager_t ai_pager;
 
 // Mood indicator
 static lv_obj_t *mood_face = NULL;
@@ -136,222 +182,113 @@ static lv_obj_t *mood_face = NULL;
 // ═════════════════════════════════════════════════════════════════════════════
 // No continuous animation timer - frames update at low frequency
 // This eliminates CPU congestion that causes LVGL scrolling lag
-static lv_timer_t *static_frame_timer = NULL;  // Checks every 10s for frame update
+static lv_timer_t *static_frame_timer = NULL;  // Polls the frame pacer every ANIM_TIMER_PERIOD_MS
 
 // Panel state
 static int current_dropdown_idx = 0;
 
+// Scroll throttling: while scroll_container moves, the animation holds its
+// frame and AI label / Blynk work waits, so scrolling gets the LVGL budget
+#define SCROLL_STALE_MS  1000   // No scroll event for this long = missed SCROLL_END
+#define DASHBOARD_SCROLL_STEP 120  // dashboard_scroll_step (tilt gesture), px
+#define REPLAY_LOCK_MS   200    // LVGL lock for a replayed parameter entry (input_rec.h)
+static bool ui_scrolling = false;
+static uint32_t ui_scroll_last_event = 0;     // lv_tick of the last scroll event
+static bool blynk_snapshot_deferred = false;  // Snapshot skipped during a scroll
+static bool ai_result_deferred = false;       // AI result left queued during a scroll
+static msg_bus_sub_t *ui_mood_sub = NULL;     // MSG_TOPIC_MOOD_RESULT -> mood_result_handler
+static msg_bus_sub_t *ui_ai_sub = NULL;       // MSG_TOPIC_AI_RESULT -> ai_result_handler
+static msg_bus_sub_t *ui_reminder_sub = NULL; // MSG_TOPIC_REMINDER -> reminder_handler
+static msg_bus_sub_t *ui_forecast_sub = NULL; // MSG_TOPIC_MOOD_FORECAST -> forecast_handler
+
+// Animation rate and snapshot period of the power profile (power_gov.h)
+static uint8_t anim_fps = CONFIG_GOLDIE_ANIM_FPS;
+static uint32_t blynk_period_ms = 30000;
+static lv_timer_t *blynk_timer = NULL;
+
+// Side panel (week strip, calendar card, log buttons) drawn from a PSRAM
+// snapshot while scrolling - see ui/static_layer.h
+#define STATIC_LAYER_CHECK_MS   500    // Idle check for a stale snapshot
+#define STATIC_LAYER_IDLE_MS    1000   // No touch for this long before re-rendering
+static static_layer_t panel_layer;
+static bool panel_layer_ready = false;
+
+// The side panel (470-790px) is off-screen at boot: only the animation
+// section is built in dashboard_init(); the panel follows in ui_stage steps
+// PANEL_BUILD_DELAY_MS after the first frame, or at once when scrolled into view
+#define PANEL_SECTION_Y         470
+#define PANEL_BUILD_DELAY_MS    500
+#define PANEL_BUILD_STEPS       10    // 7 day boxes, calendar card, buttons, snapshot
+static lv_obj_t *panel_bg = NULL;
+
+// Idle storage shutdown: once the animation has been scrolled away for
+// CONFIG_GOLDIE_STORAGE_IDLE_STOP_S, storage_task is stopped and hands its
+// PSRAM back; scrolling towards the animation starts it again
+#ifndef CONFIG_GOLDIE_STORAGE_IDLE_STOP_S
+#define CONFIG_GOLDIE_STORAGE_IDLE_STOP_S 300
+#endif
+#define STORAGE_IDLE_CHECK_MS   1000
+static lv_timer_t *storage_idle_timer = NULL;
+static bool anim_hidden = false;
+static uint32_t anim_hidden_since = 0;        // lv_tick when the animation left the screen
+static bool storage_parked = false;           // Stopped by storage_idle_timer_cb
+
+// Mood evaluation coalescing (evaluate_and_update_mood)
+#ifndef CONFIG_GOLDIE_MOOD_SETTLE_MS
+#define CONFIG_GOLDIE_MOOD_SETTLE_MS 150
+#endif
+#define MOOD_SETTLE_MAX_MS  (CONFIG_GOLDIE_MOOD_SETTLE_MS * 4)  // Flush a burst that never settles
+static lv_timer_t *mood_settle_timer = NULL;
+static bool mood_update_pending = false;
+static uint32_t mood_update_first = 0;        // lv_tick of the first change in the burst
+static int64_t mood_update_origin = 0;        // esp_timer time of the same, for ui_latency.h
+static uint32_t mood_updates_folded = 0;
+static uint32_t mood_settle_backoffs = 0;     // Extra windows waiting for logic_task (queue_watch.h)
+static uint8_t mood_dirty = 0;                // Tanks edited since the last send, bit per tank
+
 // AI assistant state
 static bool ai_initial_request_sent = false;  // Track if we've triggered AI after WiFi connects
 static uint32_t last_ai_update = 0;          // Timestamp of last successful AI response (for rate limiting)
+static bool ai_refresh_due = false;           // Timed mood change: ask past the interval
 
-// 7-day logging state (circular buffer)
+// 7-day logging state: the recent feed / water / parameter events live in
+// the history index (history/history_index.h), everything older on SD
+// (history/history_store.h)
 #define LOG_DAYS 7
+static_assert(HISTORY_DEPTH == LOG_DAYS, "history index must cover the same window as the logs");
+static_assert(TANK_LOG_DAYS == LOG_DAYS, "tank logs must cover the same window");
+static uint8_t current_day = 0;             // Current day index (0-6), moved by date_refresh()
 
-// Parameter log structure
-typedef struct {
-    time_t timestamp;
-    float ammonia;
-    float nitrate;
-    float nitrite;
-    float high_ph;
-    float low_ph;
-} param_log_t;
-
-// Water change log structure
-typedef struct {
-    time_t timestamp;
-    uint8_t interval_days;  // How often water should be changed
-} water_change_log_t;
-
-// Feed log structure
-typedef struct {
-    time_t timestamp;
-    uint8_t feeds_per_day;
-} feed_log_t;
-
-static param_log_t param_log[LOG_DAYS] = {};
-static water_change_log_t water_change_log[LOG_DAYS] = {};
-static feed_log_t feed_log_data[LOG_DAYS] = {};
-static uint32_t feed_log[LOG_DAYS] = {0};  // Feed button click counts per day (legacy)
-static uint32_t water_log[LOG_DAYS] = {0}; // Water button click counts per day (legacy)
-static uint8_t current_day = 0;             // Current day index (0-6)
-
-// Current feed schedule settings
-static uint8_t current_feeds_per_day = 2;  // Default: 2 feeds (morning + evening)
-static uint8_t current_water_interval_days = 7;  // Default: weekly water changes
-
-// Planned schedule storage
-#define MAX_FEED_TIMES 6
-typedef struct {
-    uint8_t hour;
-    uint8_t minute;
-    bool enabled;
-} feed_time_t;
-
-static feed_time_t planned_feed_times[MAX_FEED_TIMES] = {
-    {8, 0, true},   // 8:00 AM
-    {14, 0, true},  // 2:00 PM
-    {20, 0, true},  // 8:00 PM
-    {0, 0, false},  // Disabled
-    {0, 0, false},  // Disabled
-    {0, 0, false}   // Disabled
-};
-// static uint8_t planned_water_change_interval = 7;  // Days between water changes (OLD - replaced with seconds at line 209)
+// Feed schedule, intervals and logs are per tank (state/tank_registry.h)
+#define MAX_FEED_TIMES TANK_FEED_TIMES
 
 // ═════════════════════════════════════════════════════════════════════════════
 // MEDICATION CALCULATOR
 // ═════════════════════════════════════════════════════════════════════════════
 
-// Medication types
-typedef enum {
-    MED_ICH_TREATMENT = 0,
-    MED_FUNGAL_TREATMENT,
-    MED_ANTIBIOTICS,
-    MED_ANTI_PARASITIC,
-    MED_WATER_CONDITIONER,
-    MED_TYPE_COUNT
-} medication_type_t;
-
-// Medication dosage data structure
-typedef struct {
-    const char *name;
-    float dosage_per_gallon_ml;  // ml per gallon
-    float dosage_per_liter_ml;   // ml per liter
-    const char *instructions;
-} medication_data_t;
-
-// Pre-configured medication dosages (standard industry values)
-static const medication_data_t medication_database[MED_TYPE_COUNT] = {
-    {"Ich Treatment", 5.0, 1.32, "Treat daily for 3 days, then 25% water change"},
-    {"Fungal Treatment", 2.5, 0.66, "Treat every other day for 1 week"},
-    {"Antibiotics", 250.0, 66.0, "Dose every 24h for 5 days, remove carbon filter"},
-    {"Anti-parasitic", 1.0, 0.26, "Single dose, repeat after 48 hours if needed"},
-    {"Water Conditioner", 2.0, 0.53, "Use during water changes"}
-};
-
-// Calculator state - Universal dosage calculator
-typedef struct {
-    float product_amount;     // Amount of product (e.g., 5 ml)
-    float per_volume;         // Per X gallons/litres (e.g., 10)
-    float tank_size;          // Tank size
-    bool is_gallons;          // true = gallons, false = liters (for "Per" field)
-    bool tank_is_gallons;     // true = gallons, false = liters (for "Tank Size" field)
-    int unit_type;            // 0=ml, 1=tsp, 2=tbsp, 3=drops, 4=fl oz, 5=cups, 6=g
-    float calculated_dosage;
-    char result_text[256];
-} med_calculator_state_t;
-
-static med_calculator_state_t med_calc_state = {
-    .product_amount = 5.0,
-    .per_volume = 10.0,
-    .tank_size = 0.0,
-    .is_gallons = false,
-    .tank_is_gallons = false,
-    .unit_type = 0,  // Default to ml
-    .calculated_dosage = 0.0,
-    .result_text = {0}
-};
-
-// Calculator UI objects
+// The calculator popup is ui/med_calc_view.h; its result comes back
+// through med_calc_result_hook
 static lv_obj_t *btn_med_calc = NULL;          // Medication calculator button in calendar panel
-static lv_obj_t *popup_med_calc = NULL;        // Calculator popup
-static lv_obj_t *med_product_amount_input = NULL;  // Product amount input
-static lv_obj_t *med_unit_dropdown = NULL;     // Unit type selector (ml/tsp/tbsp/drops/fl oz/cups/g)
-static lv_obj_t *med_per_volume_input = NULL;  // Per X gallons/litres input
-static lv_obj_t *med_tank_size_input = NULL;   // Tank size input
-static lv_obj_t *med_unit_switch = NULL;       // Gallon/Liter toggle for "Per" field
-static lv_obj_t *med_tank_unit_switch = NULL;  // Gallon/Liter toggle for "Tank Size" field
-static lv_obj_t *med_result_label = NULL;      // Result display in popup
 static lv_obj_t *ai_med_result_label = NULL;   // Result display in AI screen
 
-// Latest calculation result (for AI integration) - exported for gemini_api
-char latest_med_calculation[512] = {0};
-
-// Latest mood reason (explains why mood is bad) - exported for gemini_api
-char latest_mood_reason[512] = {0};
+// Latest calculation result; the AI prompt gets it through dash_store
+static char latest_med_calculation[DASH_LIVE_MED_LEN] = {0};
 
 // Animation frame definitions
 #define FRAMES_PER_CATEGORY 8
 #define TOTAL_CATEGORIES 3
-#define TOTAL_FRAMES 24  // 3 categories × 8 frames
-
-// Set to 1 if colors appear wrong (swaps byte order)
-#define SWAP_RGB565_BYTES 1  // Toggle if colors are wrong
-
-// Function to load a frame from SPIFFS into specified buffer
-// STEP 3: Exported for storage_task (runs on Core 1, not in LVGL context)
-extern "C" bool load_frame_from_spiffs(uint8_t frame_num, uint8_t *buffer) {
-    char filepath[64];
-    snprintf(filepath, sizeof(filepath), "/spiffs/frame%d.bin", frame_num + 1);
-    
-    ESP_LOGI(TAG, "[STORAGE] Opening file: %s", filepath);
-    
-    FILE *f = fopen(filepath, "rb");
-    if (f == NULL) {
-        ESP_LOGE(TAG, "[STORAGE] ✗ fopen() FAILED for %s (errno=%d)", filepath, errno);
-        return false;
-    }
-    
-    ESP_LOGI(TAG, "[STORAGE] Reading %d bytes from %s...", FRAME_SIZE, filepath);
-    size_t bytes_read = fread(buffer, 1, FRAME_SIZE, f);
-    fclose(f);
-    
-    if (bytes_read != FRAME_SIZE) {
-        ESP_LOGE(TAG, "[STORAGE] ✗ fread() INCOMPLETE: got %zu bytes, expected %d", bytes_read, FRAME_SIZE);
-        return false;
-    }
-    
-    ESP_LOGI(TAG, "[STORAGE] Read %zu bytes successfully", bytes_read);
-    
-#if SWAP_RGB565_BYTES
-    // Swap bytes if colors are wrong (RGB565 endianness)
-    for (int i = 0; i < FRAME_SIZE; i += 2) {
-        uint8_t temp = buffer[i];
-        buffer[i] = buffer[i + 1];
-        buffer[i + 1] = temp;
-    }
-#endif
-    
-    return true;
-}
+#define TOTAL_FRAMES ANIM_TOTAL_FRAMES  // 3 categories × 8 frames
 
-// Aquarium Parameter Values - Nitrogen Cycle & Water Quality
-static float ammonia_ppm = 0.0f;         // Ammonia in ppm (MUST be 0)
-static float nitrite_ppm = 0.0f;         // Nitrite in ppm (MUST be 0)
-static float nitrate_ppm = 5.0f;         // Nitrate in ppm (<20 safe, <40 warning)
-static float ph_level = 7.0f;            // pH 0-14 (6.5-7.5 ideal for most freshwater)
-static uint32_t last_feed_time = 1;      // Timestamp of last feed
-static uint32_t last_clean_time = 1;     // Timestamp of last water change
-static uint32_t planned_water_change_interval = 7;       // User-set interval in DAYS (default 7 days)
-static uint32_t planned_feed_interval = 28800;           // User-set interval in SECONDS (default 8 hours)
+// Aquarium parameters, care times and mood live in the tank registry
+// (state/tank_registry.h); the dashboard shows and edits the tank on screen
+static tank_t *tank = NULL;              // Set by dashboard_init(), moved by dashboard_select_tank()
+static lv_obj_t *tank_label = NULL;      // "Tank 2" on the animation screen (TANK_MAX > 1 only)
 
 // STEP 5: AI advice cache for Blynk sync
-static char latest_ai_advice[512] = "System initializing...";
-
-// Thresholds based on aquarium research:
-// Ammonia: Most toxic, any amount is dangerous
-#define AMMONIA_SAFE 0.0f          // Only 0 ppm is safe
-#define AMMONIA_WARNING 0.25f      // Any detection is concerning
-#define AMMONIA_CRITICAL 0.5f      // Can kill fish quickly
-
-// Nitrite: Toxic, interferes with oxygen uptake
-#define NITRITE_SAFE 0.0f          // Only 0 ppm is safe
-#define NITRITE_WARNING 0.25f      // Problematic
-#define NITRITE_CRITICAL 0.5f      // Dangerous
-
-// Nitrate: Less toxic but builds up over time
-#define NITRATE_SAFE 20.0f         // <20 ppm is ideal
-#define NITRATE_WARNING 40.0f      // 20-40 ppm needs water change soon
-#define NITRATE_CRITICAL 80.0f     // >40 ppm is stressful, >80 dangerous
-
-// pH: Most freshwater fish thrive in 6.5-7.5
-#define PH_MIN_IDEAL 6.5f
-#define PH_MAX_IDEAL 7.5f
-#define PH_MIN_ACCEPTABLE 6.0f     // Acidic stress
-#define PH_MAX_ACCEPTABLE 8.0f     // Alkaline stress
-#define PH_CRITICAL_LOW 5.5f       // Dangerous
-#define PH_CRITICAL_HIGH 8.5f      // Dangerous
+static text_buf_t *latest_ai_advice = NULL;  // Held reference; NULL until the first advice
+
+// Water quality thresholds live in the mood engine's band tables
+// (mood/mood_engine.cpp), one preset per tank type
 
 // Panel dial parameters
 struct DialParam {
@@ -367,548 +304,524 @@ static DialParam dial_params[] = {
     {"Flow Rate", 0.0f, 1000.0f, 500.0f}
 };
 
-// Mood scoring structure
-typedef struct {
-    int ammonia_score;      // -2 to +2 (most critical)
-    int nitrite_score;      // -2 to +2 (very critical)
-    int nitrate_score;      // -2 to +2
-    int ph_score;           // -2 to +2
-    int feed_score;         // -2 to +2
-    int clean_score;        // -2 to +2
-    int total_score;        // Sum of all scores
-} mood_scores_t;
+static_assert(DASH_LIVE_DAYS == LOG_DAYS, "published logs must cover the same window");
+static_assert(DASH_LIVE_FEED_TIMES == MAX_FEED_TIMES, "published schedule must hold every feed time");
+
+/**
+ * @brief A tank's mood category (the animation's until its first result)
+ */
+static uint8_t tank_category(const tank_t *t)
+{
+    return t->mood_valid ? t->mood.category : current_category;
+}
+
+/**
+ * @brief Publish the tank state for other tasks (state/dash_store.h)
+ */
+static int enabled_feed_count(void)
+{
+    int feeds_count = 0;
+    for (int i = 0; i < MAX_FEED_TIMES; i++) {
+        if (tank->feed_times[i].enabled) feeds_count++;
+    }
+    return feeds_count;
+}
+
+static void dash_live_publish(void)
+{
+    dash_live_t live = {};
+    live.ammonia_ppm = tank->ammonia_ppm;
+    live.nitrite_ppm = tank->nitrite_ppm;
+    live.nitrate_ppm = tank->nitrate_ppm;
+    live.ph_level = tank->ph_level;
+    live.last_feed_time = tank->last_feed_time;
+    live.last_clean_time = tank->last_clean_time;
+    live.planned_feed_interval = tank->planned_feed_interval;
+    live.planned_water_change_interval = tank->planned_water_change_interval;
+    memcpy(live.feed_log, tank->feed_log, sizeof(live.feed_log));
+    memcpy(live.water_log, tank->water_log, sizeof(live.water_log));
+    for (int i = 0; i < MAX_FEED_TIMES; i++) {
+        const tank_feed_time_t *ft = &tank->feed_times[i];
+        live.feed_minute[i] = ft->enabled ? (uint16_t)(ft->hour * 60 + ft->minute) : DASH_LIVE_NO_FEED;
+    }
+    live.frames_presented = anim_pacer.presented;
+    live.frames_skipped = anim_pacer.skipped;
+    live.mood_total = (int16_t)tank->mood.total_score;
+    live.category = tank_category(tank);
+    live.anim_category = current_category;
+    live.current_day = current_day;
+    live.feeds_per_day = (uint8_t)enabled_feed_count();
+    live.tank = tank->id;
+    memcpy(live.med_calc, latest_med_calculation, sizeof(live.med_calc));
+    dash_store_publish(&live);
+}
+
+/**
+ * @brief Hand a tank's feed schedule and water change due date to the
+ *        reminder wheel (unchanged entries stay armed)
+ */
+static void sync_reminders(const tank_t *t)
+{
+    for (int i = 0; i < MAX_FEED_TIMES; i++) {
+        reminders_set_feed(t->id, i, t->feed_times[i].enabled, t->feed_times[i].hour,
+                           t->feed_times[i].minute);
+    }
+    reminders_set_water_due(t->id, t->last_clean_time + t->planned_water_change_interval * 86400);
+}
 
-static mood_scores_t current_mood_scores = {};
+/**
+ * @brief Tank state edited: save it (debounced), publish it, re-arm its reminders
+ */
+static void dash_state_changed(tank_t *t)
+{
+    dash_state_mark_dirty(t->id);
+    if (t == tank) {
+        dash_live_publish();
+    }
+    sync_reminders(t);
+}
 
 // Forward declarations
-static void show_monthly_calendar(void);
 static void panel_button_event_cb(lv_event_t *e);
 static void keyboard_event_cb(lv_event_t *e);
 static void close_numeric_input(void);
 static void update_panel_dial(float value, bool animate);
 static void refresh_weekly_calendar_dots(void);
-static void evaluate_and_update_mood(void);
+static void evaluate_and_update_mood(tank_t *t);
+static void set_tank_param(tank_t *t, uint8_t param, float value);
 static void update_ai_assistant(void);
-static void date_update_timer_cb(lv_timer_t *timer);
-static uint32_t get_current_time_seconds(void);
+static void close_popup(void);
+static void date_refresh(const struct tm *timeinfo, bool new_day);
+static void panel_section_ensure(void);
 static void main_button_event_cb(lv_event_t *e);
 static lv_color_t score_to_rgb_color(int score);
 static void update_button_colors(void);
+static void tank_label_refresh(void);
+static void tank_label_event_cb(lv_event_t *e);
 static void animation_init_timer_cb(lv_timer_t *timer);
 static void animation_timer_cb(lv_timer_t *timer);
-static void calculate_medication_dosage(void);
-static void show_med_calculator_popup(void);
-static void med_calc_close_event_cb(lv_event_t *e);
-static void med_calc_calculate_event_cb(lv_event_t *e);
-static void input_field_event_cb(lv_event_t *e);
-
-// ═══════════════════════════════════════════════════════════════════════════
-// SD Card Logging Functions
-// ═══════════════════════════════════════════════════════════════════════════
+static void request_frames_ahead(void);
+static void param_replay_sink(uint8_t param, const uint8_t *data, size_t len);
+static void activity_replay_sink(uint8_t valid, const uint8_t *data, size_t len);
 
-#define SD_LOG_DIR "/sdcard/logs"
+/**
+ * @brief One-shot timer to scroll to animation after UI is ready
+ */
+static void scroll_to_animation_cb(lv_timer_t *timer)
+{
+    if (scroll_container) {
+        lv_obj_scroll_to_y(scroll_container, 150, LV_ANIM_OFF);
+        ESP_LOGI(TAG, "Scrolled to animation view (Y=150)");
+    }
+    lv_timer_del(timer);  // Delete one-shot timer
+}
 
 /**
- * @brief Ensure log directory exists on SD card
+ * @brief true while scroll_container is being dragged, thrown or animated
  */
-static bool ensure_log_directory(void) {
-    struct stat st;
-    if (stat(SD_LOG_DIR, &st) == -1) {
-        if (mkdir(SD_LOG_DIR, 0700) == -1) {
-            ESP_LOGE(TAG, "Failed to create log directory: %s (errno=%d)", SD_LOG_DIR, errno);
-            return false;
+static bool ui_is_scrolling(void)
+{
+    if (ui_scrolling && lv_tick_elaps(ui_scroll_last_event) > SCROLL_STALE_MS) {
+        ui_scrolling = false;  // SCROLL_END never came - don't stay throttled
+        if (ai_result_deferred) {
+            ui_inbox_post(UI_MSG_AI_RESULT);
         }
-        ESP_LOGI(TAG, "Created log directory: %s", SD_LOG_DIR);
     }
-    return true;
+    return ui_scrolling;
 }
 
 /**
- * @brief Save medication calculation to SD card
+ * @brief true while a popup lives in (or over) the side panel
+ *
+ * Popups carry text areas with blinking cursors and keypads, so the panel
+ * is never swapped for its snapshot while one is open.
  */
-static void save_medication_to_sd(void) {
-    if (!ensure_log_directory()) return;
-    
-    time_t now = time(NULL);
-    struct tm timeinfo;
-    localtime_r(&now, &timeinfo);
-    
-    char filepath[128];
-    snprintf(filepath, sizeof(filepath), "%s/medication_%04d%02d%02d.csv",
-             SD_LOG_DIR, timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday);
-    
-    // Check if file exists to add header
-    bool file_exists = (access(filepath, F_OK) == 0);
-    
-    FILE *f = fopen(filepath, "a");
-    if (f == NULL) {
-        ESP_LOGE(TAG, "Failed to open medication log: %s (errno=%d)", filepath, errno);
-        return;
+static bool panel_popup_open(void)
+{
+    return log_popups_is_open() || history_view_is_open() || num_keypad_is_open() ||
+           calendar_view_is_open() || med_calc_view_is_open() || popup_chat;
+}
+
+/**
+ * @brief Logical screen on display, for the render / flush counters (ui_perf.h)
+ */
+static ui_perf_screen_t dashboard_perf_screen(void)
+{
+    if (calendar_view_is_open()) {
+        return UI_PERF_SCREEN_CALENDAR;
     }
-    
-    // Write header if new file
-    if (!file_exists) {
-        fprintf(f, "DateTime,ProductAmount,Unit,PerVolume,PerUnit,TankSize,TankUnit,DosageML,DosageTsp,DosageTbsp\n");
+    if (panel_popup_open()) {
+        return UI_PERF_SCREEN_POPUP;
     }
-    
-    // Write log entry
-    fprintf(f, "%04d-%02d-%02d %02d:%02d:%02d,%.2f,%s,%.2f,%s,%.2f,%s,%.2f,%.2f,%.2f\n",
-            timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
-            timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec,
-            med_calc_state.product_amount,
-            (med_calc_state.unit_type == 0) ? "ml" : 
-            (med_calc_state.unit_type == 1) ? "tsp" :
-            (med_calc_state.unit_type == 2) ? "tbsp" :
-            (med_calc_state.unit_type == 3) ? "drops" :
-            (med_calc_state.unit_type == 4) ? "fl oz" :
-            (med_calc_state.unit_type == 5) ? "cups" : "g",
-            med_calc_state.per_volume,
-            med_calc_state.is_gallons ? "gal" : "L",
-            med_calc_state.tank_size,
-            med_calc_state.tank_is_gallons ? "gal" : "L",
-            med_calc_state.calculated_dosage,
-            med_calc_state.calculated_dosage / 5.0f,
-            med_calc_state.calculated_dosage / 15.0f);
-    
-    fclose(f);
-    ESP_LOGI(TAG, "Medication log saved to SD: %s", filepath);
+    // The section under the middle of the view
+    lv_coord_t mid = (scroll_container ? lv_obj_get_scroll_y(scroll_container) : 0) + FRAME_HEIGHT / 2;
+    if (mid < FRAME_HEIGHT) {
+        return UI_PERF_SCREEN_ANIMATION;
+    }
+    return mid < PANEL_SECTION_Y ? UI_PERF_SCREEN_AI : UI_PERF_SCREEN_PANEL;
 }
 
 /**
- * @brief Save parameter log to SD card
+ * @brief Re-render the side panel snapshot once the UI has gone quiet
  */
-static void save_parameters_to_sd(float ammonia, float nitrate, float nitrite, float ph) {
-    if (!ensure_log_directory()) return;
-    
-   time_t now = time(NULL);
-    struct tm timeinfo;
-    localtime_r(&now, &timeinfo);
-    
-    char filepath[128];
-    snprintf(filepath, sizeof(filepath), "%s/parameters_%04d%02d%02d.csv",
-             SD_LOG_DIR, timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday);
-    
-    bool file_exists = (access(filepath, F_OK) == 0);
-    
-    FILE *f = fopen(filepath, "a");
-    if (f == NULL) {
-        ESP_LOGE(TAG, "Failed to open parameter log: %s (errno=%d)", filepath, errno);
-        return;
+static void panel_layer_timer_cb(lv_timer_t *timer)
+{
+    if (panel_layer.cached && !ui_is_scrolling()) {
+        static_layer_show_live(&panel_layer);  // SCROLL_END was missed
     }
-    
-    if (!file_exists) {
-        fprintf(f, "DateTime,Ammonia_ppm,Nitrate_ppm,Nitrite_ppm,pH\n");
+    if (panel_layer.valid || ui_is_scrolling() || panel_popup_open() ||
+        lv_disp_get_inactive_time(NULL) < STATIC_LAYER_IDLE_MS) {
+        return;
     }
-    
-    fprintf(f, "%04d-%02d-%02d %02d:%02d:%02d,%.3f,%.2f,%.3f,%.2f\n",
-            timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
-            timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec,
-            ammonia, nitrate, nitrite, ph);
-    
-    fclose(f);
-    ESP_LOGI(TAG, "Parameter log saved to SD: %s", filepath);
+    static_layer_rebuild(&panel_layer);
 }
 
 /**
- * @brief Save water change log to SD card
+ * @brief Stop storage_task while the animation stays off-screen, restart it on return
+ *
+ * Requests are non-blocking; frame requests queued meanwhile are served
+ * once storage_task is back.
  */
-static void save_water_change_to_sd(uint8_t interval_days) {
-    if (!ensure_log_directory()) return;
-    
-    time_t now = time(NULL);
-    struct tm timeinfo;
-    localtime_r(&now, &timeinfo);
-    
-    char filepath[128];
-    snprintf(filepath, sizeof(filepath), "%s/water_change_%04d%02d%02d.csv",
-             SD_LOG_DIR, timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday);
-    
-    bool file_exists = (access(filepath, F_OK) == 0);
+static void storage_idle_timer_cb(lv_timer_t *timer)
+{
+    bool hidden = lv_obj_get_scroll_y(scroll_container) >= FRAME_HEIGHT;
     
-    FILE *f = fopen(filepath, "a");
-    if (f == NULL) {
-        ESP_LOGE(TAG, "Failed to open water change log: %s (errno=%d)", filepath, errno);
+    if (!hidden) {
+        anim_hidden = false;
+        if (storage_parked && task_coordinator_start(TASK_ID_STORAGE) == ESP_OK) {
+            storage_parked = false;
+            ESP_LOGI(TAG, "[ANIM] Animation back on screen - storage task restarted");
+        }
         return;
     }
     
-    if (!file_exists) {
-        fprintf(f, "DateTime,PlannedIntervalDays\n");
+    if (!anim_hidden) {
+        anim_hidden = true;
+        anim_hidden_since = lv_tick_get();
+    } else if (!storage_parked &&
+               lv_tick_elaps(anim_hidden_since) >= (uint32_t)CONFIG_GOLDIE_STORAGE_IDLE_STOP_S * 1000) {
+        if (task_coordinator_stop(TASK_ID_STORAGE, 0) == ESP_OK) {
+            storage_parked = true;
+            ESP_LOGI(TAG, "[ANIM] Animation hidden for %ds - stopping storage task",
+                     CONFIG_GOLDIE_STORAGE_IDLE_STOP_S);
+        }
     }
-    
-    fprintf(f, "%04d-%02d-%02d %02d:%02d:%02d,%d\n",
-            timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
-            timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec,
-            interval_days);
-    
-    fclose(f);
-    ESP_LOGI(TAG, "Water change log saved to SD: %s", filepath);
 }
 
 /**
- * @brief Save feed log to SD card
+ * @brief Tracks scroll activity and flushes deferred work when it stops
  */
-static void save_feed_to_sd(uint8_t feeds_per_day) {
-    if (!ensure_log_directory()) return;
-    
-    time_t now = time(NULL);
-    struct tm timeinfo;
-    localtime_r(&now, &timeinfo);
-    
-    char filepath[128];
-    snprintf(filepath, sizeof(filepath), "%s/feed_%04d%02d%02d.csv",
-             SD_LOG_DIR, timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday);
-    
-    bool file_exists = (access(filepath, F_OK) == 0);
-    
-    FILE *f = fopen(filepath, "a");
-    if (f == NULL) {
-        ESP_LOGE(TAG, "Failed to open feed log: %s (errno=%d)", filepath, errno);
-        return;
+static void scroll_activity_event_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if (code == LV_EVENT_SCROLL_BEGIN || code == LV_EVENT_SCROLL) {
+        if ((panel_bg == NULL || ui_stage_busy(&panel_stage)) &&
+            lv_obj_get_scroll_y(scroll_container) + FRAME_HEIGHT > PANEL_SECTION_Y) {
+            panel_section_ensure();    // Side panel coming into view, still being built
+        }
+        if (storage_parked && storage_idle_timer) {
+            lv_timer_ready(storage_idle_timer);  // Restart as soon as the animation shows
+        }
+        if (!ui_scrolling && panel_layer_ready && !panel_popup_open()) {
+            static_layer_show_cached(&panel_layer);  // No-op if the snapshot is stale
+        }
+        ui_scrolling = true;
+        ui_scroll_last_event = lv_tick_get();
+    } else if (code == LV_EVENT_SCROLL_END) {
+        ui_scrolling = false;
+        if (panel_layer_ready) {
+            static_layer_show_live(&panel_layer);
+        }
+        // Deliver an AI result held back while scrolling; a skipped Blynk
+        // snapshot runs on the next timer pass
+        if (ai_result_deferred) {
+            ui_inbox_post(UI_MSG_AI_RESULT);
+        }
+        if (blynk_snapshot_deferred && blynk_timer) {
+            lv_timer_ready(blynk_timer);
+        }
+        ESP_LOGD(TAG, "[SCROLL] Ended at y=%d", (int)lv_obj_get_scroll_y(scroll_container));
     }
-    
-    if (!file_exists) {
-        fprintf(f, "DateTime,FeedsPerDay\n");
+}
+
+/**
+ * @brief Frame rows on screen (the animation scrolls with scroll_container)
+ * @return false if none - the animation is scrolled out of view
+ */
+static bool anim_view_rows(uint16_t *row_from, uint16_t *row_to)
+{
+    lv_coord_t top = scroll_container ? lv_obj_get_scroll_y(scroll_container) : 0;
+    lv_coord_t bottom = top + lv_disp_get_ver_res(NULL);
+    if (top >= FRAME_HEIGHT || bottom <= 0) {
+        return false;
     }
-    
-    fprintf(f, "%04d-%02d-%02d %02d:%02d:%02d,%d\n",
-            timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
-            timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec,
-            feeds_per_day);
-    
-    fclose(f);
-    ESP_LOGI(TAG, "Feed log saved to SD: %s", filepath);
+    *row_from = (uint16_t)LV_MAX(top, 0);
+    *row_to = (uint16_t)LV_MIN(bottom, FRAME_HEIGHT);
+    return true;
 }
 
 /**
- * @brief Pure function: Calculate mood scores from parameters
- * 
- * CRITICAL: Contains EXACT SAME logic as original evaluate_and_update_mood()
- * NO side effects, NO global access, NO logging, NO UI calls
- * 
- * Exported for use by logic_task in task_coordinator
+ * @brief true if rows [from, to) of a frame were decoded (row_to 0 = all)
+ */
+static bool anim_rows_cover(uint16_t have_from, uint16_t have_to, uint16_t from, uint16_t to)
+{
+    return have_to == 0 || (have_from <= from && have_to >= to);
+}
+
+/**
+ * @brief Queue frame requests until every non-displayed pool slot has work
  * 
- * @param params Input parameters (by value)
- * @param current_time Current time in seconds
- * @return mood_result_t with scores and category
- */
-extern "C" mood_result_t calculate_mood_scores(aquarium_params_t params, uint32_t current_time)
-{
-    mood_result_t result = {};
-    
-    uint32_t time_since_feed = current_time - params.last_feed_time;
-    uint32_t time_since_clean = current_time - params.last_clean_time;
-    
-    // Reset scores
-    result.ammonia_score = 0;
-    result.nitrite_score = 0;
-    result.nitrate_score = 0;
-    result.ph_score = 0;
-    result.feed_score = 0;
-    result.clean_score = 0;
-    
-    // 1. AMMONIA SCORING (Most Critical - ANY amount is dangerous)
-    if (params.ammonia_ppm <= AMMONIA_SAFE) {
-        result.ammonia_score = 2;  // Perfect - 0 ppm
-    } else if (params.ammonia_ppm < AMMONIA_WARNING) {
-        result.ammonia_score = 0;  // Detectable but low
-    } else if (params.ammonia_ppm < AMMONIA_CRITICAL) {
-        result.ammonia_score = -1; // Warning level - stress
-    } else {
-        result.ammonia_score = -2; // Critical - fish death imminent
+ * Read-ahead depth is FRAME_POOL_SLOTS - 1 (one slot is always on screen).
+ * Requests follow last_requested_frame through the current mood's loop
+ * (anim/anim_timeline.h: intro frames once, then from the loop start).
+ * Each asks only for the rows on screen (plus ANIM_VIEW_MARGIN_ROWS);
+ * nothing is requested while the animation is out of view.
+ */
+static void request_frames_ahead(void)
+{
+    uint16_t view_from, view_to;
+    if (!anim_view_rows(&view_from, &view_to)) {
+        return;
     }
-    
-    // 2. NITRITE SCORING (Very Critical - toxic to fish)
-    if (params.nitrite_ppm <= NITRITE_SAFE) {
-        result.nitrite_score = 2;  // Perfect - 0 ppm
-    } else if (params.nitrite_ppm < NITRITE_WARNING) {
-        result.nitrite_score = 0;  // Detectable but low
-    } else if (params.nitrite_ppm < NITRITE_CRITICAL) {
-        result.nitrite_score = -1; // Warning - gill damage
-    } else {
-        result.nitrite_score = -2; // Critical - severe stress
+    while (requests_in_flight < FRAME_POOL_SLOTS - 1) {
+        uint8_t next_local = anim_timeline_next(current_category, last_requested_frame);
+        anim_frame_request_msg_t request = {
+            .frame_index = (uint8_t)((current_category * FRAMES_PER_CATEGORY) + next_local),
+            .row_from = (uint16_t)LV_MAX(view_from - ANIM_VIEW_MARGIN_ROWS, 0),
+            .row_to = (uint16_t)LV_MIN(view_to + ANIM_VIEW_MARGIN_ROWS, FRAME_HEIGHT),
+        };
+        if (queue_watch_send(QUEUE_WATCH_FRAME_REQ, &request) != pdTRUE) {
+            ESP_LOGE(TAG, "[ANIM] Failed to request frame %d", request.frame_index);
+            return;
+        }
+        last_requested_frame = next_local;
+        requests_in_flight++;
+        EVT_TRACE_INSTANT("frame_req", request.frame_index);
+        ESP_LOGD(TAG, "[ANIM] Requested frame %d (%d in flight)", request.frame_index, requests_in_flight);
     }
-    
-    // 3. NITRATE SCORING (Less toxic but indicates waste buildup)
-    if (params.nitrate_ppm < NITRATE_SAFE) {
-        result.nitrate_score = 2;  // Perfect - under 20 ppm
-    } else if (params.nitrate_ppm < NITRATE_WARNING) {
-        result.nitrate_score = 1;  // Acceptable - 20-40 ppm
-    } else if (params.nitrate_ppm < NITRATE_CRITICAL) {
-        result.nitrate_score = -1; // Warning - needs water change
-    } else {
-        result.nitrate_score = -2; // Critical - over 80 ppm
+}
+
+/**
+ * @brief Merge an overlay's rows into the bands LVGL keeps
+ * @return false if the band list is full
+ */
+static bool add_blit_band(lv_area_t *bands, int *count, int max_bands, lv_coord_t y1, lv_coord_t y2)
+{
+    // Merge with every band the rows touch
+    int j = 0;
+    while (j < *count) {
+        if (bands[j].y1 <= y2 + 1 && y1 <= bands[j].y2 + 1) {
+            y1 = LV_MIN(y1, bands[j].y1);
+            y2 = LV_MAX(y2, bands[j].y2);
+            bands[j] = bands[--*count];
+            j = 0;
+            continue;
+        }
+        j++;
     }
-    
-    // 4. pH SCORING (Critical for fish health and stress)
-    if (params.ph_level >= PH_MIN_IDEAL && params.ph_level <= PH_MAX_IDEAL) {
-        result.ph_score = 2;  // Perfect - 6.5-7.5 range
-    } else if (params.ph_level >= PH_MIN_ACCEPTABLE && params.ph_level <= PH_MAX_ACCEPTABLE) {
-        result.ph_score = 1;  // Acceptable - 6.0-8.0 range
-    } else if (params.ph_level < PH_CRITICAL_LOW || params.ph_level > PH_CRITICAL_HIGH) {
-        result.ph_score = -2; // Critical - extreme pH kills fish
-    } else {
-        result.ph_score = -1; // Concerning - approaching danger zone
+    if (*count == max_bands) {
+        return false;
     }
-    
-    // 5. FEEDING SCORING (based on time since last feed)
-    float feed_warning_time = params.planned_feed_interval * 1.5f;   // 1.5x interval
-    float feed_critical_time = params.planned_feed_interval * 2.0f;  // 2x interval
-    
-    if (time_since_feed <= params.planned_feed_interval) {
-        result.feed_score = 2;  // Fed on schedule
-    } else if (time_since_feed <= feed_warning_time) {
-        result.feed_score = 1;  // Slightly overdue
-    } else if (time_since_feed <= feed_critical_time) {
-        result.feed_score = -1; // Hungry
-    } else {
-        result.feed_score = -2; // Starving
+    bands[*count].x1 = 0;
+    bands[*count].x2 = FRAME_WIDTH - 1;
+    bands[*count].y1 = y1;
+    bands[*count].y2 = y2;
+    (*count)++;
+    return true;
+}
+
+/**
+ * @brief Work out which frame rows LVGL must still draw after a direct blit
+ *
+ * Overlay widgets (date, mood face, FEED/CLEAN buttons) sit on top of the
+ * animation, so the rows they cover are left to LVGL and only the rest go
+ * straight to the panel. Rows are merged into full-width bands because a
+ * frame band is contiguous in memory and can be sent as one bitmap.
+ *
+ * @return Number of bands in `bands`, or -1 if the blit must not be used
+ *         (view scrolled, popup/overlay layer open, big widget on top)
+ */
+static int collect_blit_bands(lv_area_t *bands, int max_bands)
+{
+    const lv_area_t *img = &animation_img->coords;
+    if (img->x1 != 0 || img->y1 != 0 ||
+        lv_area_get_width(img) != FRAME_WIDTH || lv_area_get_height(img) != FRAME_HEIGHT) {
+        return -1;  // Scrolled: only part of the frame is on screen
+    }
+    lv_obj_t *perf_overlay = ui_perf_overlay_obj();
+    if (lv_obj_get_child_cnt(lv_scr_act()) != 1 || lv_obj_get_child_cnt(lv_layer_top()) != 0 ||
+        lv_obj_get_child_cnt(lv_layer_sys()) != (perf_overlay != NULL ? 1U : 0U)) {
+        return -1;  // Popups and message boxes live on these
+    }
+
+    int count = 0;
+    uint32_t child_cnt = lv_obj_get_child_cnt(scroll_container);
+    for (uint32_t i = 0; i < child_cnt; i++) {
+        lv_obj_t *child = lv_obj_get_child(scroll_container, i);
+        if (child == animation_img || lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) {
+            continue;
+        }
+
+        lv_area_t area;
+        lv_obj_get_coords(child, &area);
+        lv_area_increase(&area, lv_obj_get_ext_draw_size(child), lv_obj_get_ext_draw_size(child));
+        if (!_lv_area_intersect(&area, &area, img)) {
+            continue;
+        }
+        if (lv_area_get_size(&area) > (FRAME_WIDTH * FRAME_HEIGHT) / 4) {
+            return -1;  // Mostly covered anyway - let LVGL do it
+        }
+        if (!add_blit_band(bands, &count, max_bands, area.y1, area.y2)) {
+            return -1;
+        }
     }
-    
-    // 6. WATER CHANGE SCORING (affects all parameters over time)
-    float clean_warning_time = (params.planned_water_change_interval * 86400) * 1.2f;   // 20% over (days to seconds)
-    float clean_critical_time = (params.planned_water_change_interval * 86400) * 1.5f;  // 50% over (days to seconds)
-    
-    if (time_since_clean <= (params.planned_water_change_interval * 86400)) {
-        result.clean_score = 2;  // Clean water
-    } else if (time_since_clean <= clean_warning_time) {
-        result.clean_score = 1;  // Needs change soon
-    } else if (time_since_clean <= clean_critical_time) {
-        result.clean_score = -1; // Overdue
-    } else {
-        result.clean_score = -2; // Very overdue - poor water quality
-    }
-    
-    // Calculate total score with proper weighting
-    // Ammonia and Nitrite get counted first (most critical)
-    result.total_score = result.ammonia_score +
-                         result.nitrite_score +
-                         result.nitrate_score +
-                         result.ph_score +
-                         result.feed_score +
-                         result.clean_score;
-    
-    // ═══════════════════════════════════════════════════════════════════════════
-    // CRITICAL OVERRIDES - Single factors that force mood change (ALL 6 FACTORS)
-    // ═══════════════════════════════════════════════════════════════════════════
-    
-    // Build mood reason string (clear latest_mood_reason if mood is good)
-    latest_mood_reason[0] = '\0';
-    
-    // OVERRIDE 1: Critical ammonia (-2) = ANGRY (fish death imminent)
-    if (result.ammonia_score <= -2) {
-        result.category = 2;  // ANGRY - immediate danger
-        snprintf(latest_mood_reason, sizeof(latest_mood_reason),
-                 "🚨 CRITICAL: Ammonia %.2f ppm (TOXIC! Fish dying! Emergency water change needed!)",
-                 params.ammonia_ppm);
-        return result;
-    }
-    
-    // OVERRIDE 2: Critical nitrite (-2) = ANGRY (severe oxygen deprivation)
-    if (result.nitrite_score <= -2) {
-        result.category = 2;  // ANGRY - immediate danger
-        snprintf(latest_mood_reason, sizeof(latest_mood_reason),
-                 "🚨 CRITICAL: Nitrite %.2f ppm (TOXIC! Severe oxygen deprivation! Water change NOW!)",
-                 params.nitrite_ppm);
-        return result;
-    }
-    
-    // OVERRIDE 3: Critical pH (-2) = ANGRY (extreme pH is lethal)
-    if (result.ph_score <= -2) {
-        result.category = 2;  // ANGRY - immediate danger
-        snprintf(latest_mood_reason, sizeof(latest_mood_reason),
-                 "🚨 CRITICAL: pH %.1f (EXTREME! Lethal to fish! Adjust pH immediately!)",
-                 params.ph_level);
-        return result;
-    }
-    
-    // OVERRIDE 4: Critical nitrate (-2) = ANGRY (severe waste buildup)
-    if (result.nitrate_score <= -2) {
-        result.category = 2;  // ANGRY - immediate danger
-        snprintf(latest_mood_reason, sizeof(latest_mood_reason),
-                 "🚨 CRITICAL: Nitrate %.0f ppm (VERY HIGH! Severe waste buildup! Water change urgently needed!)",
-                 params.nitrate_ppm);
-        return result;
-    }
-    
-    // OVERRIDE 5: Critical feed (-2) = ANGRY (fish starving)
-    if (result.feed_score <= -2) {
-        result.category = 2;  // ANGRY - immediate danger
-        float hours_late = time_since_feed / 3600.0f;
-        snprintf(latest_mood_reason, sizeof(latest_mood_reason),
-                 "🚨 CRITICAL: Not fed for %.1f hours (STARVING! Feed immediately!)",
-                 hours_late);
-        return result;
-    }
-    
-    // OVERRIDE 6: Critical clean (-2) = ANGRY (water quality severely degraded)
-    if (result.clean_score <= -2) {
-        result.category = 2;  // ANGRY - immediate danger
-        float days_late = time_since_clean / 86400.0f;
-        snprintf(latest_mood_reason, sizeof(latest_mood_reason),
-                 "🚨 CRITICAL: Water not changed for %.1f days (VERY OVERDUE! Poor water quality! Clean tank now!)",
-                 days_late);
-        return result;
-    }
-    
-    // ═══════════════════════════════════════════════════════════════════════════
-    // WARNING OVERRIDES - Prevent HAPPY mood when problems are present
-    // ═══════════════════════════════════════════════════════════════════════════
-    
-    // Build warning reason (multiple warnings possible)
-    char warning_reasons[512] = {0};
-    int warning_count = 0;
-    
-    // Warning ammonia/nitrite (never happy with toxins)
-    if (result.ammonia_score <= -1) {
-        warning_count++;
-        snprintf(warning_reasons + strlen(warning_reasons), sizeof(warning_reasons) - strlen(warning_reasons),
-                 "⚠️ Ammonia %.2f ppm (Detectable ammonia causing stress). ",
-                 params.ammonia_ppm);
-    }
-    if (result.nitrite_score <= -1) {
-        warning_count++;
-        snprintf(warning_reasons + strlen(warning_reasons), sizeof(warning_reasons) - strlen(warning_reasons),
-                 "⚠️ Nitrite %.2f ppm (Detectable nitrite causing gill damage). ",
-                 params.nitrite_ppm);
-    }
-    
-    // Warning pH
-    if (result.ph_score <= -1) {
-        warning_count++;
-        snprintf(warning_reasons + strlen(warning_reasons), sizeof(warning_reasons) - strlen(warning_reasons),
-                 "⚠️ pH %.1f (Approaching danger zone). ",
-                 params.ph_level);
-    }
-    
-    // Warning nitrate
-    if (result.nitrate_score <= -1) {
-        warning_count++;
-        snprintf(warning_reasons + strlen(warning_reasons), sizeof(warning_reasons) - strlen(warning_reasons),
-                 "⚠️ Nitrate %.0f ppm (High waste buildup, needs water change). ",
-                 params.nitrate_ppm);
-    }
-    
-    // Warning feed
-    if (result.feed_score <= -1) {
-        warning_count++;
-        float hours_late = time_since_feed / 3600.0f;
-        snprintf(warning_reasons + strlen(warning_reasons), sizeof(warning_reasons) - strlen(warning_reasons),
-                 "⚠️ Not fed for %.1f hours (Hungry, feed soon). ",
-                 hours_late);
-    }
-    
-    // Warning clean
-    if (result.clean_score <= -1) {
-        warning_count++;
-        float days_late = time_since_clean / 86400.0f;
-        snprintf(warning_reasons + strlen(warning_reasons), sizeof(warning_reasons) - strlen(warning_reasons),
-                 "⚠️ Water not changed for %.1f days (Overdue, clean soon). ",
-                 days_late);
-    }
-    
-    // If any warnings exist, force at least SAD mood
-    if (warning_count > 0) {
-        strcpy(latest_mood_reason, warning_reasons);
-        if (result.total_score >= 0) {
-            result.category = 1;  // SAD - warning conditions present
-        } else {
-            result.category = 2;  // ANGRY - warning + other problems
+    if (perf_overlay != NULL && !add_blit_band(bands, &count, max_bands, perf_overlay->coords.y1,
+                                               perf_overlay->coords.y2)) {
+        return -1;
+    }
+
+    // Sort top to bottom for the blit loop (a handful of entries)
+    for (int i = 1; i < count; i++) {
+        for (int j = i; j > 0 && bands[j].y1 < bands[j - 1].y1; j--) {
+            lv_area_t tmp = bands[j];
+            bands[j] = bands[j - 1];
+            bands[j - 1] = tmp;
         }
-        return result;
-    }
-    
-    // ═══════════════════════════════════════════════════════════════════════════
-    // Normal mood determination (only if no critical or warning overrides)
-    // ═══════════════════════════════════════════════════════════════════════════
-    if (result.total_score >= 6) {
-        result.category = 0;  // ANIM_CATEGORY_HAPPY
-        snprintf(latest_mood_reason, sizeof(latest_mood_reason),
-                 "😊 Everything is perfect! Water quality excellent, feeding on schedule, tank clean!");
-    } else if (result.total_score >= 0) {
-        result.category = 1;  // ANIM_CATEGORY_SAD
-        snprintf(latest_mood_reason, sizeof(latest_mood_reason),
-                 "😐 Conditions are okay but could be better. Check parameters and schedules.");
-    } else {
-        result.category = 2;  // ANIM_CATEGORY_ANGRY
-        snprintf(latest_mood_reason, sizeof(latest_mood_reason),
-                 "😠 Multiple issues detected! Check water parameters, feeding, and cleaning schedules!");
     }
-    
-    return result;
+    return count;
 }
 
 /**
- * @brief Calculate next feed time based on feeds per day schedule
+ * @brief Put a frame on screen, straight to the panel when it pays off
+ *
+ * Patches (deltas on top of the frame shown) stay on the widget's
+ * dirty-rect path - they are already cheap. Full frames are blitted band
+ * by band around the overlays, and LVGL redraws only the overlay bands.
+ * Any reason not to blit falls back to a normal full invalidate.
  */
-static time_t get_next_feed_time(uint8_t feeds_per_day) {
-    time_t now = time(NULL);
-    struct tm timeinfo;
-    localtime_r(&now, &timeinfo);
-    
-    // Feed times based on feeds_per_day
-    int feed_hours[4][4] = {
-        {12, 0, 0, 0},        // 1 feed: 12:00 PM
-        {8, 18, 0, 0},        // 2 feeds: 8:00 AM, 6:00 PM
-        {7, 12, 19, 0},       // 3 feeds: 7:00 AM, 12:00 PM, 7:00 PM
-        {7, 11, 15, 19}       // 4 feeds: 7:00 AM, 11:00 AM, 3:00 PM, 7:00 PM
-    };
-    
-    int current_hour = timeinfo.tm_hour;
-    int schedule_idx = (feeds_per_day > 4) ? 3 : feeds_per_day - 1;
-    
-    // Find next feed time today
-    for (int i = 0; i < feeds_per_day && i < 4; i++) {
-        if (feed_hours[schedule_idx][i] > current_hour) {
-            timeinfo.tm_hour = feed_hours[schedule_idx][i];
-            timeinfo.tm_min = 0;
-            timeinfo.tm_sec = 0;
-            return mktime(&timeinfo);
+static void present_frame(uint16_t frame_id, const uint8_t *pixels, const frame_dirty_t *dirty)
+{
+    lv_area_t bands[ANIM_BLIT_MAX_BANDS];
+    int band_count = -1;
+
+    if (panel_blit_available() && !anim_image_is_patch(animation_img, dirty) &&
+        anim_image_shown_frame(animation_img) != ANIM_IMAGE_NO_FRAME) {
+        band_count = collect_blit_bands(bands, ANIM_BLIT_MAX_BANDS);
+    }
+    if (band_count < 0 || !panel_blit_begin()) {
+        if (!anim_image_is_patch(animation_img, dirty)) {
+            panel_blit_sync_next_flush();       // Whole image redrawn: start at vblank
+        }
+        anim_image_set_frame(animation_img, frame_id, pixels, dirty);
+        return;
+    }
+
+    bool ok = true;
+    int y = 0;
+    for (int i = 0; i <= band_count && ok; i++) {
+        int y_end = (i < band_count) ? bands[i].y1 : FRAME_HEIGHT;
+        ok = panel_blit_rows(pixels, FRAME_WIDTH, y, y_end);
+        if (i < band_count) {
+            y = bands[i].y2 + 1;
         }
     }
-    
-    // No more feeds today, return first feed tomorrow
-    timeinfo.tm_mday++;
-    timeinfo.tm_hour = feed_hours[schedule_idx][0];
-    timeinfo.tm_min = 0;
-    timeinfo.tm_sec = 0;
-    return mktime(&timeinfo);
+    panel_blit_end();
+
+    if (!ok) {
+        // Panel holds a mix of frames - repaint the lot through LVGL
+        panel_blit_sync_next_flush();
+        anim_image_set_frame(animation_img, frame_id, pixels, NULL);
+        return;
+    }
+    anim_image_set_frame_blitted(animation_img, frame_id, pixels, bands, (uint8_t)band_count);
 }
 
+#if CONFIG_GOLDIE_FRAME_BENCHMARK
 /**
- * @brief One-shot timer to scroll to animation after UI is ready
+ * @brief Display half of the frame benchmark (frame_bench.h), once storage's is done
+ *
+ * Times a full frame through lv_img_set_src() until the last band left the
+ * SPI bus, and the same frame as a direct panel blit. Frames come from
+ * mapped flash, else the pixels already on screen (a descriptor flip still
+ * makes LVGL redraw them).
  */
-static void scroll_to_animation_cb(lv_timer_t *timer)
+static void frame_bench_display_cb(lv_timer_t *timer)
 {
-    if (scroll_container) {
-        lv_obj_scroll_to_y(scroll_container, 150, LV_ANIM_OFF);
-        ESP_LOGI(TAG, "Scrolled to animation view (Y=150)");
+    const anim_image_t *ai = (const anim_image_t *)animation_img;
+    bool mapped = frame_map_available();
+    if (!frame_bench_storage_done() || (!mapped && ai->shown_frame == ANIM_IMAGE_NO_FRAME)) {
+        return;    // Poll again
     }
-    lv_timer_del(timer);  // Delete one-shot timer
+    lv_timer_del(timer);
+
+    frame_bench_series_t *s = (frame_bench_series_t *)heap_caps_calloc(2, sizeof(frame_bench_series_t),
+                                                                        MALLOC_CAP_SPIRAM);
+    if (s == NULL) {
+        return;
+    }
+    lv_disp_t *disp = lv_disp_get_default();
+    const uint8_t *shown = (const uint8_t *)ai->dsc[ai->active].data;
+    for (int i = 0; i < FRAME_BENCH_SAMPLES; i++) {
+        const uint8_t *pixels = mapped ? frame_map_get(i % TOTAL_FRAMES) : shown;
+        int64_t t0 = esp_timer_get_time();
+        anim_image_set_frame(animation_img, ANIM_IMAGE_NO_FRAME - 1 - i, pixels, NULL);
+        lv_refr_now(disp);
+        while (disp->driver->draw_buf->flushing && esp_timer_get_time() - t0 < 1000000) {
+        }
+        frame_bench_add(&s[0], esp_timer_get_time() - t0);
+
+        if (panel_blit_available()) {
+            t0 = esp_timer_get_time();
+            if (panel_blit_begin()) {
+                bool ok = panel_blit_rows(pixels, FRAME_WIDTH, 0, FRAME_HEIGHT);
+                panel_blit_end();
+                if (ok) {
+                    frame_bench_add(&s[1], esp_timer_get_time() - t0);
+                }
+            }
+        }
+    }
+    const char *source = mapped ? "mapped" : "psram";
+    frame_bench_report("display", source, "lv_img", &s[0]);
+    frame_bench_report("display", source, "blit", &s[1]);
+    heap_caps_free(s);
+
+    // The blits covered the overlays: redraw everything from the next frame
+    anim_image_reset(animation_img);
+    lv_obj_invalidate(lv_scr_act());
 }
+#endif
 
 /**
  * ═════════════════════════════════════════════════════════════════════════════
- * ONE-SHOT INITIALIZER: Create static frame timer after LVGL task is running
+ * ONE-SHOT INITIALIZER: Create paced frame timer after LVGL task is running
  * ═════════════════════════════════════════════════════════════════════════════
  * This ensures the frame update timer is created in the correct LVGL context.
  * 
- * CRITICAL CHANGE: Timer runs every 3 seconds (3000ms) NOT 83ms.
- * This is the KEY architectural change that eliminates scrolling lag.
+ * The timer polls at ANIM_TIMER_PERIOD_MS (a quarter frame) and the frame
+ * pacer decides when a frame is due, so LVGL timer jitter never costs a
+ * whole frame period.
  */
 static void animation_init_timer_cb(lv_timer_t *timer)
 {
-    ESP_LOGI(TAG, "★ Creating static frame timer (3-second intervals)");
-    static_frame_timer = lv_timer_create(animation_timer_cb, 3000, NULL);
+    ESP_LOGI(TAG, "★ Creating paced frame timer (%d FPS target)", anim_fps);
+    
+    // First frame deadline one period from now
+    frame_pacer_init(&anim_pacer, anim_fps, esp_timer_get_time());
+    
+    static_frame_timer = lv_timer_create(animation_timer_cb, ANIM_TIMER_PERIOD_MS, NULL);
     if (static_frame_timer) {
-        ESP_LOGI(TAG, "★ Static frame timer created - handle=%p", static_frame_timer);
+        ESP_LOGI(TAG, "★ Frame timer created - handle=%p", static_frame_timer);
         ESP_LOGI(TAG, "★ animation_img=%p", animation_img);
-        ESP_LOGI(TAG, "★ Frame update interval: 3 seconds (smooth scrolling enabled)");
+        ESP_LOGI(TAG, "★ Poll interval: %d ms, input hold: %d ms",
+                 ANIM_TIMER_PERIOD_MS, CONFIG_GOLDIE_ANIM_INPUT_HOLD_MS);
     } else {
-        ESP_LOGE(TAG, "Failed to create static frame timer!");
+        ESP_LOGE(TAG, "Failed to create frame timer!");
     }
-    
-    // Initialize timestamp for first frame update
-    last_frame_update_time = (uint32_t)(esp_timer_get_time() / 1000000);
+#if CONFIG_GOLDIE_FRAME_BENCHMARK
+    lv_timer_create(frame_bench_display_cb, 1000, NULL);
+#endif
     
     // Delete this one-shot initializer
     lv_timer_del(timer);
@@ -916,26 +829,27 @@ static void animation_init_timer_cb(lv_timer_t *timer)
 
 /**
  * ═════════════════════════════════════════════════════════════════════════════
- * STATIC FRAME TIMER CALLBACK - NON-BLOCKING LVGL TASK PATTERN
+ * PACED FRAME TIMER CALLBACK - NON-BLOCKING LVGL TASK PATTERN
  * ═════════════════════════════════════════════════════════════════════════════
  * 
  * CRITICAL DESIGN: This function NEVER blocks, waits, or accesses files.
- * It ONLY checks flags and swaps image pointers when frames are ready.
+ * It ONLY polls the ready queue and swaps image pointers when frames arrive.
  * 
- * WHY THIS PREVENTS LAG:
- * - Runs every 10 seconds (not 83ms like old animation)
- * - Never calls SPIFFS/SD functions
+ * WHY THIS DOESN'T LAG (at CONFIG_GOLDIE_ANIM_FPS):
+ * - Never calls SPIFFS/SD functions - frames come decoded from the pool
  * - Never waits on queues
- * - Just checks volatile flag and swaps pointer - < 1µs execution time
- * - LVGL can process touch/scroll events without I/O interference
+ * - Just polls queue_anim_frame_ready (0 ticks) and swaps pointer - < 100µs
+ * - Holds the animation while the user touches or scrolls
  * 
  * OPERATION:
- * 1. Check if 10 seconds have elapsed since last frame
- * 2. Check if next frame is ready in buffer (non-blocking flag check)
- * 3. If ready: swap lv_img_dsc_t pointer, consume buffer, request next frame
- * 4. If not ready: do nothing, try again next timer tick
+ * 1. Ask the frame pacer how many frame deadlines have passed
+ * 2. Take ready pool slots of the current mood, one per due deadline;
+ *    when late, only the newest is shown and the others are skipped
+ * 3. If ready: swap lv_img_dsc_t pointer, release old slot, request ahead
+ * 4. If not ready: do nothing, the deadline stays due for the next tick
  * 
- * Frame progression: 0 → 1 → 2 → 3 → 4 → 5 → 6 → 7 → 0 (loop)
+ * Frame progression: 0 → 1 → ... → 7 → loop start (0 unless the frames
+ * mark another, anim/anim_timeline.h); each frame stays up for its hold
  * On mood change: reset to 0
  */
 static void animation_timer_cb(lv_timer_t *timer)
@@ -945,112 +859,160 @@ static void animation_timer_cb(lv_timer_t *timer)
     
     if (!animation_img) {
         if (call_count == 1) {
-            ESP_LOGE(TAG, "Static frame timer: animation_img is NULL!");
+            ESP_LOGE(TAG, "Animation timer: animation_img is NULL!");
         }
         return;
     }
     
     // ═════════════════════════════════════════════════════════════════════════
-    // STEP 1: Check if 3 seconds have elapsed (NON-BLOCKING TIME CHECK)
+    // STEP 1: Check the frame deadline (NON-BLOCKING TIME CHECK)
     // ═════════════════════════════════════════════════════════════════════════
-    uint32_t now = (uint32_t)(esp_timer_get_time() / 1000000);  // Seconds since boot
-    uint32_t elapsed = now - last_frame_update_time;
+    int64_t now_us = esp_timer_get_time();
     
     // Log status every 3 seconds for debugging
-    if (call_count % 1 == 0) {
-        ESP_LOGI(TAG, "[STATIC] Timer tick %lu | frame=%d/%d cat=%d | elapsed=%lus | Buffers: A(ready=%d idx=%d) B(ready=%d idx=%d)",
-                 call_count, current_frame, 7, current_category, elapsed,
-                 buffer_a_ready, buffer_a_frame_index,
-                 buffer_b_ready, buffer_b_frame_index);
+    if (call_count % (3000 / ANIM_TIMER_PERIOD_MS) == 0) {
+        const anim_image_t *ai = (const anim_image_t *)animation_img;
+        ESP_LOGI(TAG, "[ANIM] frame=%d/%d cat=%d | shown=%lu skipped=%lu held=%lu | Pool: slot=%d ready=%d in_flight=%d",
+                 current_frame, 7, current_category,
+                 anim_pacer.presented, anim_pacer.skipped, anim_pacer.held,
+                 displayed_slot, (int)uxQueueMessagesWaiting(queue_anim_frame_ready), requests_in_flight);
+        ESP_LOGI(TAG, "[ANIM] redraws: %lu full, %lu partial (avg %lu px), %lu blitted",
+                 ai->full_updates, ai->partial_updates,
+                 ai->partial_updates ? ai->partial_pixels / ai->partial_updates : 0,
+                 ai->blit_updates);
+    }
+    
+    // Frame counts for other tasks, once a second is plenty for metrics
+    if (call_count % (1000 / ANIM_TIMER_PERIOD_MS) == 0) {
+        dash_live_publish();
+    }
+    
+    uint8_t due = frame_pacer_due(&anim_pacer, now_us);
+    if (due == 0) {
+        // Not time yet - do nothing
+        return;
     }
     
-    // Only update frame every 3 seconds (not continuous animation)
-    if (elapsed < 3) {
-        // Not time yet - do nothing (this is the KEY to preventing lag)
+    // Yield to touch and scroll: LVGL gets the whole frame budget while the
+    // user interacts (or a scroll animation runs), the animation resumes one
+    // period after input stops
+    if (ui_is_scrolling() || lv_disp_get_inactive_time(NULL) < CONFIG_GOLDIE_ANIM_INPUT_HOLD_MS) {
+        frame_pacer_hold(&anim_pacer, now_us);
         return;
     }
     
-    // ═════════════════════════════════════════════════════════════════════════
-    // STEP 2: Calculate next frame index (0-7, loops back to 0)
-    // ═════════════════════════════════════════════════════════════════════════
-    uint8_t next_frame_local = (current_frame + 1) % 8;  // 0-7 loop
-    uint8_t next_abs_frame = (current_category * 8) + next_frame_local;
+    // Scrolled out of view: nothing is loaded or drawn until it is back
+    uint16_t view_from, view_to;
+    if (!anim_view_rows(&view_from, &view_to)) {
+        frame_pacer_hold(&anim_pacer, now_us);
+        return;
+    }
+    
+    if (frame_map_available()) {
+        // Zero-copy: every frame is already addressable in mapped flash, so
+        // a late tick simply advances past the deadlines it missed
+        for (uint8_t i = 0; i < due; i++) {
+            current_frame = anim_timeline_next(current_category, current_frame);
+        }
+        uint8_t abs_frame = (current_category * FRAMES_PER_CATEGORY) + current_frame;
+        present_frame(abs_frame, frame_map_get(abs_frame), NULL);
+        frame_pacer_presented_for(&anim_pacer, due, anim_timeline_hold_us(abs_frame, anim_pacer.period_us),
+                                  now_us);
+        return;
+    }
     
     // ═════════════════════════════════════════════════════════════════════════
-    // STEP 3: Check if next frame is READY (NON-BLOCKING FLAG CHECK)
+    // STEP 2: Take the next ready slot(s) of the current mood (NON-BLOCKING)
     // ═════════════════════════════════════════════════════════════════════════
-    // This is LOCK-FREE - just read a volatile bool (< 1µs)
-    bool frame_ready = false;
-    uint8_t *display_buffer = NULL;
-    uint8_t buffer_used = 0;
-    
-    if (buffer_a_ready && buffer_a_frame_index == next_abs_frame) {
-        display_buffer = frame_buffer_a;
-        frame_ready = true;
-        buffer_used = 0;
-    } else if (buffer_b_ready && buffer_b_frame_index == next_abs_frame) {
-        display_buffer = frame_buffer_b;
-        frame_ready = true;
-        buffer_used = 1;
-    }
-    
-    if (!frame_ready) {
-        // Frame not loaded yet - skip this update (acceptable with 3s interval)
-        ESP_LOGW(TAG, "[STATIC] Frame %d not ready, will retry in 3s", next_abs_frame);
-        // IMPORTANT: Do NOT reset last_frame_update_time - will retry next tick
+    // Frames from a previous mood are handed straight back to the pool. When
+    // several deadlines are due, older ready frames are skipped so the loop
+    // catches up instead of stalling. Every pool slot holds a complete frame,
+    // so a skipped delta only costs a full-frame invalidate.
+    anim_frame_ready_msg_t ready;
+    anim_frame_ready_msg_t msg;
+    uint8_t taken = 0;
+    
+    while (taken < due && xQueueReceive(queue_anim_frame_ready, &msg, 0) == pdTRUE) {
+        EVT_TRACE_INSTANT("frame_recv", msg.frame_index);
+        bool current_mood = (msg.frame_index / FRAMES_PER_CATEGORY == current_category);
+        if (current_mood && requests_in_flight > 0) {
+            requests_in_flight--;
+        }
+        if (msg.buffer_slot == FRAME_POOL_NO_SLOT) {
+            // Load failed in storage_task - the request is answered, slot already returned
+            continue;
+        }
+        if (!current_mood) {
+            ESP_LOGD(TAG, "[ANIM] Dropping stale frame %d (slot %d)", msg.frame_index, msg.buffer_slot);
+            frame_pool_release(msg.buffer_slot);
+            continue;
+        }
+        if (!anim_rows_cover(msg.row_from, msg.row_to, view_from, view_to)) {
+            // Decoded for a view scrolled away since: the request is redone
+            ESP_LOGD(TAG, "[ANIM] Dropping frame %d (rows %u-%u, view %u-%u)", msg.frame_index,
+                     msg.row_from, msg.row_to, view_from, view_to);
+            frame_pool_release(msg.buffer_slot);
+            continue;
+        }
+        if (taken > 0) {
+            ESP_LOGD(TAG, "[ANIM] Late - skipping frame %d", ready.frame_index);
+            frame_pool_release(ready.buffer_slot);
+        }
+        ready = msg;
+        taken++;
+    }
+    
+    if (taken == 0) {
+        request_frames_ahead();  // Replace any requests that failed
+        
+        // Frame not loaded yet - deadline stays due, retry next tick
+        ESP_LOGD(TAG, "[ANIM] Frame %d not ready (%d deadline(s) due)",
+                 (current_category * 8) + anim_timeline_next(current_category, current_frame), due);
         return;
     }
     
     // ═════════════════════════════════════════════════════════════════════════
-    // STEP 4: FRAME IS READY - Update display (3 critical sub-steps)
+    // STEP 3: FRAME IS READY - Update display
     // ═════════════════════════════════════════════════════════════════════════
+    frame_pool_slot_t *slot = frame_pool_slot(ready.buffer_slot);
+    uint8_t *display_buffer = slot->pixels;
+    const frame_dirty_t *dirty = &slot->dirty;
     
-    ESP_LOGI(TAG, "[STATIC] Frame %d ready in buffer_%c - updating display",
-             next_abs_frame, (buffer_used == 0 ? 'A' : 'B'));
+    // Sub-step 3A: ADVANCE FRAME INDEX AND SCHEDULE
+    bool have_shown = (displayed_slot != FRAME_POOL_NO_SLOT);
+    current_frame = ready.frame_index % FRAMES_PER_CATEGORY;
+    frame_pacer_presented_for(&anim_pacer, due, anim_timeline_hold_us(ready.frame_index, anim_pacer.period_us),
+                              now_us);
     
-    // Sub-step 4A: CONSUME BUFFER (mark as free for storage_task)
-    if (buffer_used == 0) {
-        buffer_a_ready = false;
-    } else {
-        buffer_b_ready = false;
+    // Sub-step 3B: SHOW NEW BUFFER - the widget repaints only the dirty
+    // rects when they are relative to the frame on screen; full frames go
+    // straight to the panel when nothing covers the animation. A scroll
+    // revealed rows the frame on screen was not decoded for: repaint all
+    // of it (LVGL clips the invalidation to the rows on screen)
+    if (!anim_rows_cover(displayed_row_from, displayed_row_to, view_from, view_to)) {
+        anim_image_reset(animation_img);
     }
+    present_frame(ready.frame_index, display_buffer, dirty);
+    displayed_row_from = ready.row_from;
+    displayed_row_to = ready.row_to;
     
-    // Sub-step 4B: ADVANCE FRAME INDEX
-    current_frame = next_frame_local;
-    last_frame_update_time = now;  // Reset timer
-    
-    // Sub-step 4C: SWAP IMAGE DESCRIPTOR (force LVGL redraw)
-    // Alternate between two descriptors so LVGL sees a "new" pointer
-    active_dsc = (active_dsc == &anim_dsc_a) ? &anim_dsc_b : &anim_dsc_a;
-    active_dsc->data = display_buffer;
-    lv_img_set_src(animation_img, active_dsc);
+    // Sub-step 3C: RETURN PREVIOUS SLOT - LVGL renders from the new buffer
+    // from here on, so storage_task may overwrite the old one
+    if (have_shown) {
+        frame_pool_release(displayed_slot);
+    }
+    displayed_slot = ready.buffer_slot;
     
-    ESP_LOGI(TAG, "[STATIC] ✓ DISPLAYED frame=%d (dsc=%p)", current_frame, active_dsc);
+    ESP_LOGD(TAG, "[ANIM] ✓ DISPLAYED frame=%d slot=%d", current_frame, displayed_slot);
     
     // ═════════════════════════════════════════════════════════════════════════
-    // STEP 5: REQUEST NEXT FRAME from storage_task (NON-BLOCKING QUEUE SEND)
+    // STEP 4: KEEP THE POOL BUSY - request frames ahead (NON-BLOCKING)
     // ═════════════════════════════════════════════════════════════════════════
-    uint8_t preload_frame_local = (current_frame + 1) % 8;
-    uint8_t preload_abs_frame = (current_category * 8) + preload_frame_local;
-    
-    anim_frame_request_msg_t request = { .frame_index = preload_abs_frame };
-    if (xQueueOverwrite(queue_anim_frame_request, &request) != pdTRUE) {
-        ESP_LOGE(TAG, "[STATIC] Failed to request frame %d", preload_abs_frame);
-    } else {
-        ESP_LOGI(TAG, "[STATIC] Requested frame %d for next update", preload_abs_frame);
-    }
+    request_frames_ahead();
     
     // Done! Function took < 100µs - no I/O blocking whatsoever
 }
 
-/**
- * @brief Get current system time in seconds (from boot)
- */
-static uint32_t get_current_time_seconds(void)
-{
-    return (uint32_t)(esp_timer_get_time() / 1000000);  // Convert microseconds to seconds
-}
-
 /**
  * @brief Map mood score to RGB color gradient
  * @param score Score from -2 (critical/red) to +2 (perfect/green)
@@ -1058,63 +1020,121 @@ static uint32_t get_current_time_seconds(void)
  */
 static lv_color_t score_to_rgb_color(int score)
 {
-    // Score mapping with aesthetically pleasing colors
-    switch(score) {
-        case 2:  return lv_color_hex(0x4CAF50);  // Soft Green (perfect)
-        case 1:  return lv_color_hex(0x8BC34A);  // Light Green (good)
-        case 0:  return lv_color_hex(0xFFC107);  // Amber (acceptable)
-        case -1: return lv_color_hex(0xFF9800);  // Soft Orange (concerning)
-        case -2: return lv_color_hex(0xF44336);  // Soft Red (critical)
-        default: return lv_color_hex(0xFFC107);  // Amber (fallback)
+    // Score mapping with aesthetically pleasing colors, converted once
+    static lv_color_t palette[5];
+    static bool palette_ready = false;
+    if (!palette_ready) {
+        palette[0] = lv_color_hex(0xF44336);  // Soft Red (critical)
+        palette[1] = lv_color_hex(0xFF9800);  // Soft Orange (concerning)
+        palette[2] = lv_color_hex(0xFFC107);  // Amber (acceptable)
+        palette[3] = lv_color_hex(0x8BC34A);  // Light Green (good)
+        palette[4] = lv_color_hex(0x4CAF50);  // Soft Green (perfect)
+        palette_ready = true;
+    }
+    if (score < -2 || score > 2) {
+        score = 0;                             // Amber (fallback)
+    }
+    return palette[score + 2];
+}
+
+/**
+ * @brief Recolour one score button if its score changed since the last apply
+ */
+static void apply_button_score(lv_obj_t *btn, int8_t *applied, int score)
+{
+    if (btn == NULL || *applied == score) {
+        return;                                // Same colour: no style write, no redraw
     }
+    *applied = (int8_t)score;
+    lv_obj_set_style_bg_color(btn, score_to_rgb_color(score), LV_PART_MAIN);
 }
 
 /**
  * @brief Update button colors based on current mood scores
+ *
+ * Diffed against the scores last applied, so a mood result that leaves a
+ * button's score alone does not invalidate it.
  */
 static void update_button_colors(void)
 {
-    if (btn_feed_main) {
-        lv_color_t feed_color = score_to_rgb_color(current_mood_scores.feed_score);
-        lv_obj_set_style_bg_color(btn_feed_main, feed_color, LV_PART_MAIN);
-    }
-    
-    if (btn_water_main) {
-        lv_color_t clean_color = score_to_rgb_color(current_mood_scores.clean_score);
-        lv_obj_set_style_bg_color(btn_water_main, clean_color, LV_PART_MAIN);
+    static int8_t feed_applied = INT8_MIN;     // Nothing applied yet
+    static int8_t clean_applied = INT8_MIN;
+    apply_button_score(btn_feed_main, &feed_applied, tank->mood.feed_score);
+    apply_button_score(btn_water_main, &clean_applied, tank->mood.clean_score);
+}
+
+/**
+ * @brief Message bus notify: wake the LVGL task for a dashboard subscription
+ * 
+ * Runs in the publishing task; arg is the ui_msg_type_t to post.
+ */
+static void ui_bus_notify(void *arg)
+{
+    ui_inbox_post((ui_msg_type_t)(uintptr_t)arg);
+}
+
+/**
+ * @brief Publish the snapshot on the next timer tick instead of in up to
+ *        a whole period, so LAN live clients (lan_live.h) see a change at once
+ */
+static void snapshot_soon(void)
+{
+    if (blynk_timer) {
+        lv_timer_ready(blynk_timer);
     }
 }
 
 /**
- * @brief LVGL timer callback: Receive mood calculation results from logic_task
+ * @brief UI inbox handler: Receive mood calculation results from logic_task
  * 
- * STEP 2: Polls queue_mood_result every 50ms to apply results from background calculation
+ * STEP 2: Runs when a MSG_TOPIC_MOOD_RESULT delivery posts
+ * UI_MSG_MOOD_RESULT and drains the dashboard's mood subscription.
  * Maintains EXACT SAME behavior as original evaluate_and_update_mood()
  */
-static void mood_result_handler(lv_timer_t *timer)
+static void mood_result_handler(void)
 {
-    mood_result_t result;
+    const msg_bus_msg_t *msg;
     
-    // Non-blocking receive (0 ticks timeout)
-    if (xQueueReceive(queue_mood_result, &result, 0) == pdTRUE) {
-        // Apply results to global state (EXACT SAME as Step 1)
-        current_mood_scores.ammonia_score = result.ammonia_score;
-        current_mood_scores.nitrite_score = result.nitrite_score;
-        current_mood_scores.nitrate_score = result.nitrate_score;
-        current_mood_scores.ph_score = result.ph_score;
-        current_mood_scores.feed_score = result.feed_score;
-        current_mood_scores.clean_score = result.clean_score;
-        current_mood_scores.total_score = result.total_score;
+    // Posts are merged, so take everything queued (0 ticks timeout)
+    while ((msg = msg_bus_receive(ui_mood_sub, 0)) != NULL) {
+        mood_result_t result = *MSG_BUS_PAYLOAD(msg, mood_result_t);
+        msg_bus_release(msg);
+        
+        tank_t *t = tank_get(result.tank);
+        if (t == NULL) {
+            continue;
+        }
+        
+        // Apply results to the tank's state
+        uint8_t old_category = tank_category(t);
+        t->mood = result;
+        t->mood_valid = true;
         
         uint8_t new_category = result.category;  // 0=HAPPY, 1=SAD, 2=ANGRY
         
-        // Update mood if changed (EXACT SAME as Step 1)
-        if (new_category != current_category) {
-            ESP_LOGI(TAG, "Mood changed: %s -> %s (Score: %d)",
-                     current_category == 0 ? "HAPPY" : (current_category == 1 ? "SAD" : "ANGRY"),
+        if (new_category != old_category) {
+            ESP_LOGI(TAG, "Tank %u mood changed: %s -> %s (Score: %d)", (unsigned)t->id + 1,
+                     old_category == 0 ? "HAPPY" : (old_category == 1 ? "SAD" : "ANGRY"),
                      new_category == 0 ? "HAPPY" : (new_category == 1 ? "SAD" : "ANGRY"),
                      result.total_score);
-            dashboard_set_animation_category(new_category);
+            
+            // The clock moved the mood (an edit asks on its own): fresh
+            // advice now, usually prefetched into the cache before the
+            // crossing (logic_task), so no API call and no wait
+            if (t == tank && result.origin_us == 0) {
+                ai_refresh_due = true;
+            }
+        }
+        
+        // The animation shows the worst tank
+        uint8_t worst = tank_registry_worst();
+        if (worst != current_category) {
+            dashboard_set_animation_category(worst);
+        }
+        
+        // Day's worst mood for the monthly calendar (the SD history is tank 0's)
+        if (t->id == 0) {
+            history_store_note_mood(time(NULL), new_category);
         }
         
         // Log detailed mood analysis (EXACT SAME as Step 1)
@@ -1127,78 +1147,543 @@ static void mood_result_handler(lv_timer_t *timer)
                  result.clean_score,
                  result.total_score);
         
-        // Update button colors based on new scores (EXACT SAME as Step 1)
-        update_button_colors();
+        snapshot_soon();
+        
+        // Applied; on screen once the next refresh finishes
+        ui_latency_record(UI_LATENCY_PARAM_TO_MOOD, result.origin_us);
+        ui_latency_arm_screen(UI_LATENCY_PARAM_TO_SCREEN, result.origin_us);
+    }
+    
+    // Button colours once for the whole batch, from the tank on screen
+    update_button_colors();
+    dash_live_publish();
+    if (ai_refresh_due) {
+        ai_refresh_due = false;
+        last_ai_update = 0;
+        update_ai_assistant();
     }
 }
 
 /**
- * STEP 4: AI Result Handler
+ * @brief Replace the advice kept for Blynk sync (takes over the reference)
  * 
- * Polls queue_ai_result for AI advice from wifi_task.
- * Updates ai_text_label when result arrives.
- * STEP 5: Also caches advice for Blynk sync.
+ * The label must already show something else when the old buffer may be
+ * its static text.
+ */
+static void set_latest_ai_advice(text_buf_t *advice)
+{
+    text_buf_t *old = latest_ai_advice;
+    latest_ai_advice = advice;
+    text_buf_unref(old);
+}
+
+// Reminder banner: on the top layer while shown, tap to dismiss
+#define REMINDER_BANNER_MS  15000
+static lv_obj_t *reminder_banner = NULL;
+static lv_timer_t *reminder_banner_timer = NULL;
+
+static void reminder_banner_close(void)
+{
+    if (reminder_banner_timer != NULL) {
+        lv_timer_del(reminder_banner_timer);
+        reminder_banner_timer = NULL;
+    }
+    if (reminder_banner != NULL) {
+        lv_obj_del(reminder_banner);
+        reminder_banner = NULL;
+    }
+}
+
+static void reminder_banner_timer_cb(lv_timer_t *timer)
+{
+    reminder_banner_timer = NULL;   // One-shot: LVGL deletes it
+    reminder_banner_close();
+}
+
+static void reminder_banner_event_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+        reminder_banner_close();
+    }
+}
+
+/**
+ * @brief Show a reminder line at the top of the screen (a newer one replaces it)
+ * @param symbol LV_SYMBOL_* in front of the text
+ */
+static void show_reminder_banner(const char *symbol, const char *text)
+{
+    if (reminder_banner == NULL) {
+        reminder_banner = lv_label_create(lv_layer_top());
+        lv_obj_add_style(reminder_banner, ui_style(UI_STYLE_POPUP), 0);
+        lv_obj_add_style(reminder_banner, ui_style(UI_STYLE_TITLE), 0);
+        lv_obj_set_width(reminder_banner, lv_pct(90));
+        lv_obj_set_style_pad_all(reminder_banner, 10, 0);
+        lv_obj_set_style_text_align(reminder_banner, LV_TEXT_ALIGN_CENTER, 0);
+        lv_obj_align(reminder_banner, LV_ALIGN_TOP_MID, 0, 8);
+        lv_obj_add_flag(reminder_banner, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_event_cb(reminder_banner, reminder_banner_event_cb, LV_EVENT_CLICKED, NULL);
+    }
+    lv_label_set_text_fmt(reminder_banner, "%s %s", symbol, text);
+    if (reminder_banner_timer != NULL) {
+        lv_timer_reset(reminder_banner_timer);
+    } else {
+        reminder_banner_timer = lv_timer_create(reminder_banner_timer_cb, REMINDER_BANNER_MS, NULL);
+        lv_timer_set_repeat_count(reminder_banner_timer, 1);
+    }
+}
+
+/**
+ * @brief Reminders that came due: banner, and a fresh mood for the feed /
+ *        water change ones (their schedule scores move with them)
+ */
+static void reminder_handler(void)
+{
+    const msg_bus_msg_t *msg;
+    uint32_t rescore = 0;                   // Bit per tank
+    while ((msg = msg_bus_receive(ui_reminder_sub, 0)) != NULL) {
+        reminder_event_t ev = *MSG_BUS_PAYLOAD(msg, reminder_event_t);
+        msg_bus_release(msg);
+
+        char line[80];
+        reminders_format(&ev, line, sizeof(line));
+        show_reminder_banner(LV_SYMBOL_BELL, line);
+        if ((ev.kind == REMINDER_FEED || ev.kind == REMINDER_WATER_CHANGE) && ev.tank < TANK_MAX) {
+            rescore |= 1u << ev.tank;
+        }
+    }
+    for (uint8_t i = 0; i < TANK_MAX; i++) {
+        if (rescore & (1u << i)) {
+            evaluate_and_update_mood(tank_get(i));
+        }
+    }
+}
+
+/**
+ * @brief New forecast: a factor that just started drifting gets the banner
+ *        (the forecast line itself goes to Blynk and the AI prompt)
+ */
+static void forecast_handler(void)
+{
+    static uint8_t drift_shown = 0;
+    const msg_bus_msg_t *msg = msg_bus_receive(ui_forecast_sub, 0);
+    if (msg == NULL) {
+        return;
+    }
+    mood_forecast_t fc = *MSG_BUS_PAYLOAD(msg, mood_forecast_t);
+    msg_bus_release(msg);
+    
+    uint8_t onset = fc.drift_mask & (uint8_t)~drift_shown;
+    drift_shown = fc.drift_mask;
+    if (onset != 0) {
+        fc.to_sad_s = fc.to_angry_s = MOOD_FORECAST_NONE;   // Just the drift part
+        fc.drift_mask = onset;
+        char line[160];
+        if (mood_trend_format_forecast(&fc, line, sizeof(line)) > 0) {
+            show_reminder_banner(LV_SYMBOL_WARNING, line);
+        }
+    }
+}
+
+extern "C" void dashboard_set_pacing(uint8_t fps, uint32_t snapshot_period_ms)
+{
+    if (fps == 0 || fps > CONFIG_GOLDIE_ANIM_FPS) {
+        fps = CONFIG_GOLDIE_ANIM_FPS;    // The timer polls for this rate at most
+    }
+    if (fps != anim_fps && static_frame_timer != NULL) {
+        frame_pacer_set_fps(&anim_pacer, fps);
+    }
+    anim_fps = fps;
+    blynk_period_ms = snapshot_period_ms;
+    if (blynk_timer != NULL) {
+        lv_timer_set_period(blynk_timer, blynk_period_ms);
+    }
+}
+
+/**
+ * STEP 4: WiFi State Handler
+ * 
+ * Runs when the telemetry worker posts UI_MSG_WIFI_STATE. Sends the initial AI
+ * request once WiFi is up (again, after a failed request).
  */
-static void ai_result_handler(lv_timer_t *timer)
+static void wifi_state_handler(void)
 {
-    // Check if WiFi just became ready and we haven't sent initial AI request
     if (!ai_initial_request_sent && gemini_is_wifi_connected()) {
         ESP_LOGI(TAG, "WiFi is ready - triggering initial AI assistant request");
         ai_initial_request_sent = true;
         update_ai_assistant();
     }
+}
+
+/**
+ * @brief Show on-device advice on the AI screen (mood scores + dosage)
+ * 
+ * Instant and offline: shown while the model is asked, kept when it
+ * cannot answer. A streamed or final model reply replaces it.
+ * 
+ * @param status Last line (request state), NULL = none
+ * @return The text shown (valid until the next call)
+ */
+static const char *show_local_advice(const char *status)
+{
+    static char local_advice[640];
+    mood_result_t result = tank->mood;
+    result.category = tank_category(tank);
+    aquarium_params_t params = {
+        .ammonia_ppm = tank->ammonia_ppm,
+        .nitrite_ppm = tank->nitrite_ppm,
+        .nitrate_ppm = tank->nitrate_ppm,
+        .ph_level = tank->ph_level,
+        .last_feed_time = tank->last_feed_time,
+        .last_clean_time = tank->last_clean_time,
+        .planned_feed_interval = tank->planned_feed_interval,
+        .planned_water_change_interval = tank->planned_water_change_interval
+    };
+    bool issues = result.ammonia_score < 0 || result.nitrite_score < 0 || result.nitrate_score < 0 ||
+                  result.ph_score < 0 || result.feed_score < 0 || result.clean_score < 0;
+
+    int n = snprintf(local_advice, sizeof(local_advice), "%s ", issues ? LV_SYMBOL_WARNING : LV_SYMBOL_OK);
+    size_t used = (n > 0) ? (size_t)n : 0;
+    used += mood_advice_format(&result, &params, time_svc_uptime_s(), latest_med_calculation,
+                               local_advice + used, sizeof(local_advice) - used);
+    if (status && used < sizeof(local_advice) - 1) {
+        snprintf(local_advice + used, sizeof(local_advice) - used, "\n%s", status);
+    }
+    if (ai_text_label) {
+        text_pager_set(&ai_pager, local_advice, false);
+    }
+    return local_advice;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ASK GOLDIE - CHAT WITH THE FISH
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// A question typed on the on-screen keyboard goes into the conversation
+// ring (ai_chat.h) and its number to the AI worker, which answers it with
+// the recent turns as context. The answer streams into a pending bubble
+// of the chat view (ui/chat_view.h) and lands in the ring; the view reads
+// the turns from there. One question at a time; the advice requests wait
+// while one is out, so they cannot overwrite it in the request queue.
+
+static lv_obj_t *chat_view = NULL;
+static lv_obj_t *chat_input = NULL;
+static bool chat_waiting = false;             // A question is with the AI worker
+static uint32_t chat_sent_at = 0;             // Uptime it was sent
+#define CHAT_ANSWER_WAIT_S  150               // Past the AI worker's deadline: lost
+
+/**
+ * @brief A question is out and may still be answered
+ */
+static bool chat_busy(void)
+{
+    if (chat_waiting && time_svc_uptime_s() - chat_sent_at > CHAT_ANSWER_WAIT_S) {
+        chat_waiting = false;
+    }
+    return chat_waiting;
+}
+
+static bool chat_fill_cb(uint32_t id, bool *mine, char *buf, size_t size, void *user)
+{
+    ai_chat_role_t role = AI_CHAT_GOLDIE;
+    bool held = ai_chat_get(id, &role, buf, size);
+    *mine = role == AI_CHAT_OWNER;
+    return held;
+}
+
+static void chat_show_turns(void)
+{
+    uint32_t first, end;
+    ai_chat_span(&first, &end);
+    chat_view_set_range(chat_view, first, end);
+}
+
+static void chat_send(void)
+{
+    const char *question = lv_textarea_get_text(chat_input);
+    while (*question == ' ') {
+        question++;
+    }
+    if (chat_busy() || *question == '\0') {
+        return;
+    }
+    uint32_t seq = ai_chat_add(AI_CHAT_OWNER, question);
+    if (seq == 0) {
+        chat_view_set_pending(chat_view, "(No memory for a conversation)");
+        return;
+    }
+    lv_textarea_set_text(chat_input, "");
+    chat_show_turns();
+    chat_view_set_pending(chat_view, LV_SYMBOL_REFRESH " ...");
+    
+    ai_request_msg_t request = {};
+    request.timestamp = time_svc_uptime_s();
+    request.chat_seq = seq;
+    queue_watch_overwrite(QUEUE_WATCH_AI_REQ, &request);   // A chat question outranks advice
+    chat_waiting = true;
+    chat_sent_at = request.timestamp;
+}
+
+static void chat_event_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    if (code == LV_EVENT_READY) {
+        chat_send();
+    } else if (code == LV_EVENT_CANCEL) {
+        lv_obj_del(popup_chat);
+    }
+}
+
+static void chat_delete_cb(lv_event_t *e)
+{
+    popup_chat = NULL;
+    chat_view = NULL;
+    chat_input = NULL;
+}
+
+/**
+ * @brief Ask Goldie popup: conversation, question line, keyboard
+ */
+static void show_chat_popup(void)
+{
+    close_popup();
+    
+    // No arena: the bubbles are relabelled for as long as the popup is open
+    popup_chat = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(popup_chat, 480, 320);
+    lv_obj_set_pos(popup_chat, 0, 0);
+    lv_obj_set_style_bg_color(popup_chat, lv_color_hex(0x1a1a1a), 0);
+    lv_obj_set_style_border_width(popup_chat, 2, 0);
+    lv_obj_set_style_border_color(popup_chat, lv_palette_main(LV_PALETTE_CYAN), 0);
+    lv_obj_set_style_radius(popup_chat, 0, 0);
+    lv_obj_set_style_pad_all(popup_chat, 0, 0);
+    lv_obj_clear_flag(popup_chat, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_event_cb(popup_chat, chat_delete_cb, LV_EVENT_DELETE, NULL);
+    
+    lv_obj_t *title = lv_label_create(popup_chat);
+    lv_label_set_text(title, "Ask Goldie");
+    lv_obj_add_style(title, ui_style(UI_STYLE_TITLE), 0);
+    lv_obj_set_style_text_color(title, lv_palette_main(LV_PALETTE_CYAN), 0);
+    lv_obj_set_pos(title, 10, 6);
+    
+    lv_obj_t *btn_new = lv_btn_create(popup_chat);
+    lv_obj_set_size(btn_new, 70, 26);
+    lv_obj_set_pos(btn_new, 320, 2);
+    lv_obj_t *lbl = lv_label_create(btn_new);
+    lv_label_set_text(lbl, "New");
+    lv_obj_center(lbl);
+    lv_obj_add_event_cb(btn_new, [](lv_event_t *e) {
+        if (chat_busy()) return;
+        ai_chat_clear();
+        chat_view_set_pending(chat_view, NULL);
+        chat_show_turns();
+    }, LV_EVENT_CLICKED, NULL);
+    
+    lv_obj_t *btn_close = lv_btn_create(popup_chat);
+    lv_obj_set_size(btn_close, 70, 26);
+    lv_obj_set_pos(btn_close, 400, 2);
+    lbl = lv_label_create(btn_close);
+    lv_label_set_text(lbl, LV_SYMBOL_CLOSE);
+    lv_obj_center(lbl);
+    lv_obj_add_event_cb(btn_close, [](lv_event_t *e) {
+        lv_obj_del(popup_chat);
+    }, LV_EVENT_CLICKED, NULL);
     
-    ai_result_msg_t result;
+    chat_view = chat_view_create(popup_chat, chat_fill_cb, NULL);
+    lv_obj_set_size(chat_view, 476, 118);
+    lv_obj_set_pos(chat_view, 2, 30);
+    lv_obj_set_style_bg_opa(chat_view, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(chat_view, 0, 0);
+    lv_obj_set_style_pad_all(chat_view, 4, 0);
+    
+    chat_input = lv_textarea_create(popup_chat);
+    lv_obj_set_size(chat_input, 460, 38);
+    lv_obj_set_pos(chat_input, 10, 150);
+    lv_textarea_set_one_line(chat_input, true);
+    lv_textarea_set_max_length(chat_input, AI_CHAT_INPUT_MAX - 1);
+    lv_textarea_set_placeholder_text(chat_input, "Ask Goldie something...");
+    
+    lv_obj_t *kb = lv_keyboard_create(popup_chat);
+    lv_obj_set_size(kb, 476, 128);
+    lv_obj_align(kb, LV_ALIGN_BOTTOM_MID, 0, -2);
+    lv_keyboard_set_mode(kb, LV_KEYBOARD_MODE_TEXT_LOWER);
+    lv_keyboard_set_textarea(kb, chat_input);
+    lv_obj_add_event_cb(kb, chat_event_cb, LV_EVENT_READY, NULL);
+    lv_obj_add_event_cb(kb, chat_event_cb, LV_EVENT_CANCEL, NULL);
+    
+    chat_show_turns();
+    if (chat_busy()) {
+        chat_view_set_pending(chat_view, LV_SYMBOL_REFRESH " ...");
+    }
+}
+
+/**
+ * @brief Ask Goldie reply (streamed or final) from the AI worker
+ */
+static void chat_result(const ai_result_msg_t &result)
+{
+    if (!result.partial) {
+        chat_waiting = false;
+    }
+    if (!chat_view) {
+        return;             // Closed meanwhile: the answer is in the ring
+    }
+    if (result.partial) {
+        chat_view_set_pending(chat_view, text_buf_str(result.advice));
+    } else if (result.success) {
+        chat_view_set_pending(chat_view, NULL);
+        chat_show_turns();
+    } else {
+        const char *why = text_buf_str(result.advice);
+        chat_view_set_pending(chat_view, why[0] != '\0' ? why : "(Goldie could not answer - try again)");
+    }
+}
+
+/**
+ * STEP 4: AI Result Handler
+ * 
+ * Runs when a MSG_TOPIC_AI_RESULT delivery posts UI_MSG_AI_RESULT and
+ * takes the advice from the dashboard's latest-only AI subscription.
+ * Updates the AI pager when result arrives; unchanged advice costs no
+ * re-layout.
+ * STEP 5: Also caches advice for Blynk sync.
+ */
+static void ai_result_handler(void)
+{
+    // A relabel mid-scroll costs a text re-layout and redraw - the result
+    // stays queued and SCROLL_END re-posts it
+    if (ui_is_scrolling()) {
+        ai_result_deferred = true;
+        return;
+    }
+    ai_result_deferred = false;
     
     // Non-blocking receive (0 ticks timeout)
-    if (xQueueReceive(queue_ai_result, &result, 0) == pdTRUE) {
-        if (!ai_text_label) return;
+    const msg_bus_msg_t *msg = msg_bus_receive(ui_ai_sub, 0);
+    if (msg) {
+        const ai_result_msg_t &result = *MSG_BUS_PAYLOAD(msg, ai_result_msg_t);
+        if (result.chat) {
+            chat_result(result);
+            msg_bus_release(msg);
+            return;
+        }
+        if (!ai_text_label) {
+            msg_bus_release(msg);
+            return;
+        }
         
-        if (result.success) {
-            // Display AI advice
-            lv_label_set_text(ai_text_label, result.advice);
-            // STEP 5: Cache advice for Blynk sync
-            snprintf(latest_ai_advice, sizeof(latest_ai_advice), "%s", result.advice);
+        if (result.partial) {
+            // Streamed reply so far: copied into the pager, so the buffer
+            // goes back to the pool with the message; the reader's page stays
+            text_pager_set(&ai_pager, text_buf_str(result.advice), true);
+        } else if (result.success) {
+            // Display AI advice (a repeat of the shown text is skipped) and
+            // keep its one-line summary (the advice without one) as the
+            // latest advice for Blynk sync (STEP 5)
+            text_pager_set(&ai_pager, text_buf_str(result.advice), false);
+            set_latest_ai_advice(text_buf_ref(result.summary ? result.summary : result.advice));
             ESP_LOGI(TAG, "AI advice received and displayed");
             // Update timestamp only on SUCCESS to enable failed request retries
-            last_ai_update = get_current_time_seconds();
+            last_ai_update = time_svc_uptime_s();
         } else {
-            // Fallback if API fails (but tank is healthy)
-            const char *fallback = LV_SYMBOL_OK " Tank is healthy!\n\n"
-                "All parameters normal.\n"
-                "Continue regular maintenance.\n\n"
-                "(AI offline - WiFi issue)";
-            lv_label_set_text(ai_text_label, fallback);
+            // Model unreachable: advice worked out on the device, from the
+            // same scores the mood is drawn from
+            const char *fallback = show_local_advice("(AI offline)");
             // STEP 5: Cache fallback for Blynk sync
-            snprintf(latest_ai_advice, sizeof(latest_ai_advice), "%s", fallback);
-            ESP_LOGW(TAG, "AI request failed, showing fallback");
+            set_latest_ai_advice(text_buf_from_str(fallback));
+            ESP_LOGW(TAG, "AI request failed, showing local advice");
             // Reset flag to allow retry when system becomes fully ready
             ai_initial_request_sent = false;
         }
+        if (!result.partial) {
+            snapshot_soon();
+        }
+        msg_bus_release(msg);
     }
 }
 
 /**
- * @brief Timer callback to update date display every 10 minutes
- * Updates both animation screen date AND calendar panel date
+ * @brief Date text baked into pooled frames, where date_label would draw it
  */
-static void date_update_timer_cb(lv_timer_t *timer)
+static void date_overlay_set(const char *text)
 {
-    time_t now;
-    time(&now);
-    struct tm timeinfo;
-    localtime_r(&now, &timeinfo);
-    
-    // Only update if time is synced (year should be >= 2024)
-    if (timeinfo.tm_year < (2024 - 1900)) {
-        ESP_LOGW(TAG, "Date update skipped - time not synced yet");
-        return;
+    if (frame_overlay_active() && date_label != NULL) {
+        frame_overlay_set_text(text, ui_font(UI_FONT_32), lv_obj_get_style_text_letter_space(date_label, 0),
+                               lv_obj_get_x(date_label), lv_obj_get_y(date_label),
+                               lv_obj_get_style_text_color(date_label, 0), lv_color_black());
+    }
+}
+
+/**
+ * @brief Calendar card of the side panel (no-op until the panel is built)
+ */
+static void update_panel_date(const struct tm *timeinfo)
+{
+    if (panel_day_label && panel_date_label && panel_month_label) {
+        const char *days[] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
+        const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+        
+        lv_label_set_text(panel_day_label, days[timeinfo->tm_wday]);
+        
+        char date_str[8];
+        snprintf(date_str, sizeof(date_str), "%d", timeinfo->tm_mday);
+        lv_label_set_text(panel_date_label, date_str);
+        
+        char month_str[16];
+        snprintf(month_str, sizeof(month_str), "%s %d", months[timeinfo->tm_mon], 1900 + timeinfo->tm_year);
+        lv_label_set_text(panel_month_label, month_str);
+        static_layer_invalidate(&panel_layer);
+    }
+}
+
+/**
+ * @brief Day strip for today: names and tap dates of the boxes, dots
+ */
+static void week_strip_roll(const struct tm *timeinfo)
+{
+    static const char *day_names[] = {"SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT"};
+    time_t now = mktime((struct tm *)timeinfo);
+    for (int i = 0; i < 7; i++) {
+        if (!week_day_boxes[i] || !week_day_names[i]) continue;
+        lv_label_set_text_static(week_day_names[i], day_names[(timeinfo->tm_wday + 7 + i - 3) % 7]);
+        lv_obj_set_user_data(week_day_boxes[i], (void *)(intptr_t)(now + (i - 3) * 86400));
+    }
+    refresh_weekly_calendar_dots();
+}
+
+/**
+ * @brief Day clock callback (ui/day_clock.h): at local midnight, and when
+ *        the clock is set or re-synced. Updates both animation screen date
+ *        AND calendar panel date; a new day also rolls the week strip and
+ *        the legacy per-day counters.
+ */
+static void date_refresh(const struct tm *timeinfo, bool new_day)
+{
+    time_t now = mktime((struct tm *)timeinfo);
+    
+    // State restored before the clock was set: shift the last feed / water
+    // change back by the time the device was off (unless logged since)
+    for (uint8_t i = 0; i < TANK_MAX; i++) {
+        tank_t *t = tank_get(i);
+        if (t->saved_wall == 0) {
+            continue;
+        }
+        uint32_t boot_wall = (uint32_t)now - time_svc_uptime_s();
+        if (boot_wall > t->saved_wall) {
+            uint32_t off_s = boot_wall - t->saved_wall;
+            if (t->last_feed_time == t->restored_feed) t->last_feed_time -= off_s;
+            if (t->last_clean_time == t->restored_clean) t->last_clean_time -= off_s;
+            ESP_LOGI(TAG, "Restored state: device was off for %lu min", (unsigned long)(off_s / 60));
+            sync_reminders(t);
+            evaluate_and_update_mood(t);
+        }
+        t->saved_wall = 0;
     }
     
     // Update animation screen date (top-left corner)
     if (date_label && date_shadow) {
         char date_str[16];
-        strftime(date_str, sizeof(date_str), "%d %b", &timeinfo);
+        strftime(date_str, sizeof(date_str), "%d %b", timeinfo);
         
         // Convert to uppercase
         for (int i = 0; date_str[i]; i++) {
@@ -1207,65 +1692,77 @@ static void date_update_timer_cb(lv_timer_t *timer)
         
         lv_label_set_text(date_shadow, date_str);
         lv_label_set_text(date_label, date_str);
+        date_overlay_set(date_str);
     }
     
     // Update calendar panel date (synchronized update)
-    if (panel_day_label && panel_date_label && panel_month_label) {
-        const char *days[] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
-        const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
-        
-        lv_label_set_text(panel_day_label, days[timeinfo.tm_wday]);
-        
-        char date_str[8];
-        snprintf(date_str, sizeof(date_str), "%d", timeinfo.tm_mday);
-        lv_label_set_text(panel_date_label, date_str);
-        
-        char month_str[16];
-        snprintf(month_str, sizeof(month_str), "%s %d", months[timeinfo.tm_mon], 1900 + timeinfo.tm_year);
-        lv_label_set_text(panel_month_label, month_str);
+    update_panel_date(timeinfo);
+    
+    if (new_day) {
+        uint8_t day_index = timeinfo->tm_yday % LOG_DAYS;
+        if (day_index != current_day) {
+            // The slot last held the counts of LOG_DAYS days ago
+            for (uint8_t i = 0; i < TANK_MAX; i++) {
+                tank_get(i)->feed_log[day_index] = 0;
+                tank_get(i)->water_log[day_index] = 0;
+            }
+            current_day = day_index;
+            dash_live_publish();
+        }
+        week_strip_roll(timeinfo);
     }
     
-    ESP_LOGI(TAG, "Date displays updated (animation + calendar)");
+    ESP_LOGI(TAG, "Date displays updated (animation + calendar)%s", new_day ? ", new day" : "");
 }
 
 /**
  * STEP 5: Blynk Snapshot Publisher
  * 
- * Timer callback (30s interval) that creates a snapshot of current
- * aquarium state and sends it to wifi_task for Blynk cloud sync.
+ * Timer callback (30s interval, longer on battery: dashboard_set_pacing) that
+ * creates a snapshot of current aquarium state and sends it to the telemetry
+ * worker for Blynk cloud sync.
  * 
- * Uses xQueueOverwrite - only latest snapshot needed, older ones can be discarded.
+ * The telemetry worker subscribes latest-only - older snapshots are discarded.
  */
 static void blynk_snapshot_publisher(lv_timer_t *timer)
 {
+    if (ui_is_scrolling()) {
+        blynk_snapshot_deferred = true;  // Sent from the SCROLL_END handler
+        return;
+    }
+    blynk_snapshot_deferred = false;
+    
     blynk_sync_msg_t snapshot;
     
     // Get current time
-    uint32_t current_time = get_current_time_seconds();
+    uint32_t current_time = time_svc_uptime_s();
     
-    // Copy water parameters (snapshot - no LVGL lock needed)
-    snapshot.ammonia_ppm = ammonia_ppm;
-    snapshot.nitrite_ppm = nitrite_ppm;
-    snapshot.nitrate_ppm = nitrate_ppm;
-    snapshot.ph_level = ph_level;
+    // One consistent copy of the published state (state/dash_store.h)
+    dash_live_t live;
+    dash_store_read(&live);
+    snapshot.ammonia_ppm = live.ammonia_ppm;
+    snapshot.nitrite_ppm = live.nitrite_ppm;
+    snapshot.nitrate_ppm = live.nitrate_ppm;
+    snapshot.ph_level = live.ph_level;
     
     // Calculate time since feed/clean (in requested units)
-    float hours_since_feed = (current_time - last_feed_time) / 3600.0f;
-    float days_since_clean = (current_time - last_clean_time) / 86400.0f;
+    float hours_since_feed = (current_time - live.last_feed_time) / 3600.0f;
+    float days_since_clean = (current_time - live.last_clean_time) / 86400.0f;
     snapshot.feed_hours = hours_since_feed;
     snapshot.clean_days = days_since_clean;
+    snapshot.timestamp = current_time;
     
     // Build mood string based on current category
     const char *mood_str = "HAPPY";
-    if (current_category == 1) mood_str = "SAD";       // 1 = SAD
-    else if (current_category == 2) mood_str = "ANGRY";  // 2 = ANGRY
+    if (live.category == 1) mood_str = "SAD";       // 1 = SAD
+    else if (live.category == 2) mood_str = "ANGRY";  // 2 = ANGRY
     snprintf(snapshot.mood, sizeof(snapshot.mood), "%s", mood_str);
     
-    // Copy latest AI advice
-    snprintf(snapshot.ai_advice, sizeof(snapshot.ai_advice), "%s", latest_ai_advice);
+    // Share the latest AI advice (reference, not a copy - the bus drops it)
+    snapshot.ai_advice = text_buf_ref(latest_ai_advice);
     
-    // Send to wifi_task (non-blocking overwrite - only latest snapshot matters)
-    if (xQueueOverwrite(queue_blynk_sync, &snapshot) == pdTRUE) {
+    // Send to the telemetry worker (latest-only - only latest snapshot matters)
+    if (msg_bus_publish(MSG_TOPIC_BLYNK_SYNC, &snapshot, sizeof(snapshot)) == ESP_OK) {
         ESP_LOGI(TAG, "Blynk snapshot sent (Mood=%s, Feed=%.1fh, Clean=%.1fd)", 
                  mood_str, hours_since_feed, days_since_clean);
     } else {
@@ -1274,7 +1771,7 @@ static void blynk_snapshot_publisher(lv_timer_t *timer)
 }
 
 /**
- * @brief Evaluate all parameters and determine mood
+ * @brief Send all parameters to logic_task, which determines the mood
  * 
  * Realistic Aquarium Mood Scoring System based on Nitrogen Cycle
  * 
@@ -1294,25 +1791,111 @@ static void blynk_snapshot_publisher(lv_timer_t *timer)
  * - SAD (1):    Total score 0-5   (Some warnings, no critical issues)
  * - ANGRY (2):  Total score < 0   (Critical water quality issues)
  */
-static void evaluate_and_update_mood(void)
+static void send_params_to_logic(int64_t origin_us)
 {
     // STEP 2: Send parameters to logic_task for calculation
-    // Gather parameters into struct
-    aquarium_params_t params = {
-        .ammonia_ppm = ammonia_ppm,
-        .nitrite_ppm = nitrite_ppm,
-        .nitrate_ppm = nitrate_ppm,
-        .ph_level = ph_level,
-        .last_feed_time = last_feed_time,
-        .last_clean_time = last_clean_time,
-        .planned_feed_interval = planned_feed_interval,
-        .planned_water_change_interval = planned_water_change_interval
-    };
+    // Gather every tank into one message; the edited ones are marked dirty
+    tank_params_msg_t msg = {};
+    for (uint8_t i = 0; i < TANK_MAX; i++) {
+        const tank_t *t = tank_get(i);
+        aquarium_params_t *params = &msg.tank[i];
+        params->ammonia_ppm = t->ammonia_ppm;
+        params->nitrite_ppm = t->nitrite_ppm;
+        params->nitrate_ppm = t->nitrate_ppm;
+        params->ph_level = t->ph_level;
+        params->last_feed_time = t->last_feed_time;
+        params->last_clean_time = t->last_clean_time;
+        params->planned_feed_interval = t->planned_feed_interval;
+        params->planned_water_change_interval = t->planned_water_change_interval;
+        params->activity_pm = t->activity_pm;
+        params->has_activity = t->has_activity;
+        params->origin_us = (mood_dirty & (1u << i)) ? origin_us : 0;
+    }
+    msg.dirty = mood_dirty;
+    msg.active = tank->id;
+    mood_dirty = 0;
+
+    // A message logic_task has not taken yet may mark other tanks dirty:
+    // keep those marks (and their edit times) in the one that replaces it
+    tank_params_msg_t pending;
+    if (queue_watch_reclaim(QUEUE_WATCH_PARAM, &pending) == pdTRUE) {
+        for (uint8_t i = 0; i < TANK_MAX; i++) {
+            if ((pending.dirty & (1u << i)) && !(msg.dirty & (1u << i))) {
+                msg.tank[i].origin_us = pending.tank[i].origin_us;
+            }
+        }
+        msg.dirty |= pending.dirty;
+    }
+    
+    // 1-deep mailbox: replaces a snapshot logic_task has not taken yet,
+    // so it can never overflow and always holds the newest state
+    queue_watch_overwrite(QUEUE_WATCH_PARAM, &msg);
+    
+    // Result will be received by mood_result_handler() via the UI inbox
+}
+
+/**
+ * @brief Settle window elapsed - send the current parameters once
+ */
+static void mood_settle_timer_cb(lv_timer_t *timer)
+{
+    // logic_task has not taken the last snapshot (or just lost one to a
+    // newer): give it another window to catch up, within the burst limit
+    if (queue_watch_busy(QUEUE_WATCH_PARAM) && lv_tick_elaps(mood_update_first) < MOOD_SETTLE_MAX_MS) {
+        mood_settle_backoffs++;
+        return;
+    }
+    lv_timer_pause(timer);
+    mood_update_pending = false;
+    if (mood_updates_folded > 1 || mood_settle_backoffs > 0) {
+        ESP_LOGD(TAG, "[MOOD] %lu parameter updates folded into one evaluation (%lu windows held back)",
+                 (unsigned long)mood_updates_folded, (unsigned long)mood_settle_backoffs);
+    }
+    mood_updates_folded = 0;
+    mood_settle_backoffs = 0;
+    send_params_to_logic(mood_update_origin);
+}
+
+/**
+ * @brief Schedule a mood evaluation for a tank's current parameters
+ *
+ * Every change restarts the CONFIG_GOLDIE_MOOD_SETTLE_MS window, so entering
+ * ammonia, nitrite, nitrate and pH in a row costs one evaluation, one queue
+ * round-trip and one button recolour. The snapshot is taken when the window
+ * closes, so the final state is always the one sent; a burst that never
+ * settles is still flushed after MOOD_SETTLE_MAX_MS. While the mailbox is
+ * under backpressure (logic_task behind) windows keep extending up to that
+ * limit, so a slow consumer gets fewer, fuller snapshots.
+ */
+static void evaluate_and_update_mood(tank_t *t)
+{
+    mood_dirty |= (uint8_t)(1u << t->id);
+    if (CONFIG_GOLDIE_MOOD_SETTLE_MS == 0) {
+        send_params_to_logic(esp_timer_get_time());
+        return;
+    }
+    if (mood_settle_timer == NULL) {
+        mood_settle_timer = lv_timer_create(mood_settle_timer_cb, CONFIG_GOLDIE_MOOD_SETTLE_MS, NULL);
+        if (mood_settle_timer == NULL) {
+            send_params_to_logic(esp_timer_get_time());
+            return;
+        }
+        lv_timer_pause(mood_settle_timer);
+    }
     
-    // Send to logic_task (non-blocking)
-    xQueueSend(queue_param_update, &params, 0);
+    if (!mood_update_pending) {
+        mood_update_pending = true;
+        mood_update_first = lv_tick_get();
+        mood_update_origin = esp_timer_get_time();
+    }
+    mood_updates_folded++;
     
-    // Result will be received by mood_result_handler() timer callback
+    if (lv_tick_elaps(mood_update_first) >= MOOD_SETTLE_MAX_MS) {
+        lv_timer_ready(mood_settle_timer);
+    } else {
+        lv_timer_reset(mood_settle_timer);
+    }
+    lv_timer_resume(mood_settle_timer);
 }
 
 /**
@@ -1327,128 +1910,32 @@ static void update_ai_assistant(void)
         return;
     }
     
-    uint32_t current_time = get_current_time_seconds();
-    ESP_LOGI(TAG, "AI update: current_time=%lu, mood=%d", current_time, current_category);
-    uint32_t time_since_feed = current_time - last_feed_time;
-    uint32_t time_since_clean = current_time - last_clean_time;
+    uint32_t current_time = time_svc_uptime_s();
+    uint8_t category = tank_category(tank);
+    ESP_LOGI(TAG, "AI update: current_time=%lu, tank=%u, mood=%d", current_time, (unsigned)tank->id + 1, category);
+    uint32_t time_since_feed = current_time - tank->last_feed_time;
+    uint32_t time_since_clean = current_time - tank->last_clean_time;
     
     // Convert to hours/days for display
     float hours_since_feed = time_since_feed / 3600.0f;
     float days_since_clean = time_since_clean / 86400.0f;
     
-    // Check if mood is SAD or ANGRY - provide immediate local feedback (NO RATE LIMIT)
-    if (current_category == 1 || current_category == 2) {  // 1=SAD, 2=ANGRY
-        char local_advice[512] = "";
-        bool has_issues = false;
-        
-        if (current_category == 2) {  // 2 = ANGRY
-            strcat(local_advice, LV_SYMBOL_WARNING " CRITICAL ISSUES:\n");
-        } else {
-            strcat(local_advice, LV_SYMBOL_WARNING " ATTENTION NEEDED:\n");
-        }
-        
-        // Check ammonia (most critical)
-        if (current_mood_scores.ammonia_score < 0) {
-            if (ammonia_ppm >= AMMONIA_CRITICAL) {
-                strcat(local_advice, "• AMMONIA TOXIC (");
-            } else {
-                strcat(local_advice, "• Ammonia detected (");
-            }
-            char temp[32];
-            snprintf(temp, sizeof(temp), "%.2f ppm)!\n", ammonia_ppm);
-            strcat(local_advice, temp);
-            has_issues = true;
-        }
-        
-        // Check nitrite
-        if (current_mood_scores.nitrite_score < 0) {
-            if (nitrite_ppm >= NITRITE_CRITICAL) {
-                strcat(local_advice, "• NITRITE TOXIC (");
-            } else {
-                strcat(local_advice, "• Nitrite detected (");
-            }
-            char temp[32];
-            snprintf(temp, sizeof(temp), "%.2f ppm)!\n", nitrite_ppm);
-            strcat(local_advice, temp);
-            has_issues = true;
-        }
-        
-        // Check nitrate
-        if (current_mood_scores.nitrate_score < 0) {
-            if (nitrate_ppm >= NITRATE_CRITICAL) {
-                strcat(local_advice, "• Nitrate very high (");
-            } else {
-                strcat(local_advice, "• Nitrate high (");
-            }
-            char temp[32];
-            snprintf(temp, sizeof(temp), "%.0f ppm)\n", nitrate_ppm);
-            strcat(local_advice, temp);
-            has_issues = true;
-        }
-        
-        // Check pH
-        if (current_mood_scores.ph_score < 0) {
-            if (ph_level < PH_CRITICAL_LOW) {
-                strcat(local_advice, "• pH TOO LOW (");
-            } else if (ph_level > PH_CRITICAL_HIGH) {
-                strcat(local_advice, "• pH TOO HIGH (");
-            } else if (ph_level < PH_MIN_IDEAL) {
-                strcat(local_advice, "• pH too acidic (");
-            } else {
-                strcat(local_advice, "• pH too alkaline (");
-            }
-            char temp[32];
-            snprintf(temp, sizeof(temp), "%.1f)\n", ph_level);
-            strcat(local_advice, temp);
-            has_issues = true;
-        }
-        
-        // Check feeding
-        if (current_mood_scores.feed_score <= -1) {
-            char temp[64];
-            snprintf(temp, sizeof(temp), "• Fish hungry (%.0fh since feed)\n", hours_since_feed);
-            strcat(local_advice, temp);
-            has_issues = true;
-        }
-        
-        // Check water change
-        if (current_mood_scores.clean_score <= -1) {
-            char temp[64];
-            snprintf(temp, sizeof(temp), "• Water change overdue (%.0f days)\n", days_since_clean);
-            strcat(local_advice, temp);
-            has_issues = true;
-        }
-        
-        // Add recommendations
-        if (has_issues) {
-            strcat(local_advice, "\nRECOMMENDED ACTIONS:\n");
-            if (current_mood_scores.ammonia_score < 0 || current_mood_scores.nitrite_score < 0) {
-                strcat(local_advice, "→ 50% water change NOW\n");
-                strcat(local_advice, "→ Stop feeding temporarily\n");
-            } else if (current_mood_scores.nitrate_score < 0) {
-                strcat(local_advice, "→ Perform water change\n");
-            }
-            if (current_mood_scores.ph_score < 0) {
-                strcat(local_advice, "→ Check pH and adjust\n");
-            }
-            if (current_mood_scores.feed_score <= -1) {
-                strcat(local_advice, "→ Feed fish now\n");
-            }
-        }
-        
-        lv_label_set_text(ai_text_label, local_advice);
-        ESP_LOGI(TAG, "AI Assistant: Showing emergency local analysis");
-        return;  // Don't call API when showing urgent local advice
+    // SAD or ANGRY: on-device advice right away (NO RATE LIMIT); the
+    // model's reply replaces it if a request goes out below
+    bool unhealthy = (category == 1 || category == 2);  // 1=SAD, 2=ANGRY
+    if (unhealthy) {
+        show_local_advice(NULL);
+        ESP_LOGI(TAG, "AI Assistant: Showing local analysis");
     }
     
-    // HAPPY mood - Rate limit API calls to avoid quota exhaustion
+    // Rate limit API calls to avoid quota exhaustion
     const uint32_t AI_UPDATE_INTERVAL = 300; // 5 minutes between API calls
     
-    ESP_LOGI(TAG, "HAPPY mood detected - checking rate limit (last=%lu, interval=%lu)", 
+    ESP_LOGI(TAG, "Checking AI rate limit (last=%lu, interval=%lu)", 
              last_ai_update, AI_UPDATE_INTERVAL);
     
     if (last_ai_update > 0 && (current_time - last_ai_update) < AI_UPDATE_INTERVAL) {
-        // Too soon since last API call, keep showing previous advice
+        // Too soon since last API call, keep showing previous (or local) advice
         ESP_LOGW(TAG, "AI API call skipped (rate limited - wait %lu more seconds)", 
                  AI_UPDATE_INTERVAL - (current_time - last_ai_update));
         return;
@@ -1456,242 +1943,206 @@ static void update_ai_assistant(void)
     
     ESP_LOGI(TAG, "Rate limit passed - proceeding with AI request");
     
+    // A chat question is out: the request queue holds one, do not replace it
+    if (chat_busy()) {
+        ESP_LOGI(TAG, "AI request deferred - Ask Goldie is waiting for an answer");
+        return;
+    }
+    
     // STEP 4: Check WiFi status before sending request (avoid rate-limiting failed boot requests)
     if (!gemini_is_wifi_connected()) {
         ESP_LOGW(TAG, "WiFi not ready yet - skipping AI request (will retry when parameters change)");
-        lv_label_set_text(ai_text_label, 
-            LV_SYMBOL_OK " Tank is healthy!\n\n"
-            "All parameters normal.\n"
-            "Continue regular maintenance.\n\n"
-            "(Waiting for WiFi...)");
+        show_local_advice("(Waiting for WiFi...)");
         return;  // Don't set last_ai_update - allow immediate retry when WiFi is ready
     }
     
-    // STEP 5: Send AI request to wifi_task (non-blocking)
-    // Show loading message immediately
-    lv_label_set_text(ai_text_label, LV_SYMBOL_REFRESH " Consulting AI...");
+    // STEP 5: Send AI request to the AI worker (non-blocking)
+    // Local advice immediately - perceived latency zero, correct offline
+    show_local_advice(LV_SYMBOL_REFRESH " Consulting AI...");
     
     // Count enabled feeds
-    int feeds_count = 0;
-    for (int i = 0; i < MAX_FEED_TIMES; i++) {
-        if (planned_feed_times[i].enabled) feeds_count++;
-    }
+    int feeds_count = enabled_feed_count();
     
     // Package parameters into request message
     ai_request_msg_t request = {
-        .ammonia_ppm = ammonia_ppm,
-        .nitrite_ppm = nitrite_ppm,
-        .nitrate_ppm = nitrate_ppm,
+        .ammonia_ppm = tank->ammonia_ppm,
+        .nitrite_ppm = tank->nitrite_ppm,
+        .nitrate_ppm = tank->nitrate_ppm,
         .hours_since_feed = hours_since_feed,
         .days_since_clean = days_since_clean,
         .feeds_per_day = feeds_count,
-        .water_change_interval = (int)planned_water_change_interval,
+        .water_change_interval = (int)tank->planned_water_change_interval,
         .timestamp = current_time
     };
     
-    // Send to wifi_task (non-blocking with overwrite for latest request)
-    if (xQueueOverwrite(queue_ai_request, &request) == pdTRUE) {
+    // Send to the AI worker (non-blocking with overwrite for latest request)
+    if (queue_watch_overwrite(QUEUE_WATCH_AI_REQ, &request) == pdTRUE) {
         // Note: last_ai_update is set in ai_result_handler() on success only
-        ESP_LOGI(TAG, "AI request sent to wifi_task (WiFi is ready)");
+        ESP_LOGI(TAG, "AI request sent to AI worker (WiFi is ready)");
     } else {
         ESP_LOGW(TAG, "AI request queue full");
-        // Fallback if queue fails (but tank is healthy)
-        lv_label_set_text(ai_text_label, 
-            LV_SYMBOL_OK " Tank is healthy!\n\n"
-            "All parameters normal.\n"
-            "Continue regular maintenance.\n\n"
-            "(AI busy)");
+        show_local_advice("(AI busy)");
     }
-    // Result will be received by ai_result_handler() timer callback
+    // Result will be received by ai_result_handler() via the UI inbox
 }
 
 /**
- * @brief Refresh weekly calendar activity dots
+ * @brief Create one hidden activity dot inside a day box
  */
-static void refresh_weekly_calendar_dots(void) {
-    time_t now_time = time(NULL);
-    struct tm now_tm;
-    localtime_r(&now_time, &now_tm);
-    
-    // Calculate today's start (midnight)
-    struct tm today_tm = now_tm;
-    today_tm.tm_hour = 0;
-    today_tm.tm_min = 0;
-    today_tm.tm_sec = 0;
-    time_t today_start = mktime(&today_tm);
+static lv_obj_t *create_week_dot(lv_obj_t *day_box, ui_style_id_t look)
+{
+    lv_obj_t *dot = ui_theme_dot(day_box, 6, look);
+    lv_obj_clear_flag(dot, LV_OBJ_FLAG_CLICKABLE);  // Taps go to the day box
+    lv_obj_add_flag(dot, LV_OBJ_FLAG_HIDDEN);
+    return dot;
+}
+
+/**
+ * @brief Build the dot pool of day box `i` (once, from dashboard_init)
+ */
+static void create_week_dot_pool(int i)
+{
+    week_water_dots[i] = create_week_dot(week_day_boxes[i], UI_STYLE_DOT_WATER);
+    week_water_state[i] = WEEK_DOT_HIDDEN;
+    for (int j = 0; j < WEEK_FEED_DOTS; j++) {
+        week_feed_dots[i][j] = create_week_dot(week_day_boxes[i], UI_STYLE_DOT_FEED);
+        week_feed_state[i][j] = WEEK_DOT_HIDDEN;
+    }
+}
+
+/**
+ * @brief Put a pooled dot into `state`; touches LVGL only if it changed
+ */
+static void set_week_dot(lv_obj_t *dot, uint8_t *cur_state, week_dot_state_t state,
+                         ui_style_id_t solid, ui_style_id_t planned)
+{
+    if (*cur_state == state) {
+        return;
+    }
+    *cur_state = state;
     
-    for (int i = 0; i < 7; i++) {
-        if (!week_day_boxes[i]) continue;
-        
-        // Calculate this day's date
-        time_t day_time = now_time + ((i - 3) * 86400);
-        struct tm day_tm;
-        localtime_r(&day_time, &day_tm);
-        int log_index = day_tm.tm_yday % LOG_DAYS;
-        
-        // Delete all child objects (dots and day name) except the first one (day name)
-        uint32_t child_count = lv_obj_get_child_cnt(week_day_boxes[i]);
-        while (child_count > 1) {
-            lv_obj_del(lv_obj_get_child(week_day_boxes[i], child_count - 1));
-            child_count--;
-        }
-        
-        // Recreate dots
-        int day_width = 55;
-        int day_height = 60;
-        
-        // Check if water change is planned for this day
-        bool water_planned = false;
-        bool water_done = false;
-        
-        // Check if water was actually done on this specific day
-        for (int j = 0; j < LOG_DAYS; j++) {
-            if (water_change_log[j].timestamp == 0) continue;
-            struct tm water_tm_buf;
-            struct tm *water_tm = localtime_r(&water_change_log[j].timestamp, &water_tm_buf);
-            if (water_tm->tm_yday == day_tm.tm_yday && water_tm->tm_year == day_tm.tm_year) {
-                water_done = true;
-                break;
-            }
-        }
-        
-        // Find the most recent water change
-        time_t last_water_change_time = 0;
-        for (int j = 0; j < LOG_DAYS; j++) {
-            if (water_change_log[j].timestamp > last_water_change_time) {
-                last_water_change_time = water_change_log[j].timestamp;
-            }
-        }
-        
-        // If we have a water change schedule, check if one is due on THIS SPECIFIC day
-        if (planned_water_change_interval > 0) {
-            if (last_water_change_time > 0) {
-                // Calculate the next due date
-                struct tm last_change_tm;
-                localtime_r(&last_water_change_time, &last_change_tm);
-                last_change_tm.tm_hour = 0;
-                last_change_tm.tm_min = 0;
-                last_change_tm.tm_sec = 0;
-                time_t last_change_day = mktime(&last_change_tm);
-                
-                // Calculate next due date
-                time_t next_due_date = last_change_day + (planned_water_change_interval * 86400);
-                
-                // Normalize day_time to start of day for comparison
-                struct tm day_start_tm = day_tm;
-                day_start_tm.tm_hour = 0;
-                day_start_tm.tm_min = 0;
-                day_start_tm.tm_sec = 0;
-                time_t day_start = mktime(&day_start_tm);
-                
-                // Show hollow circle only on the exact next due date, or on today if overdue
-                if (day_start == next_due_date) {
-                    // Exact due date - show hollow circle
-                    water_planned = true;
-                } else if (day_start == today_start && today_start > next_due_date) {
-                    // Today and overdue - show hollow circle on today only
-                    water_planned = true;
-                }
-            } else if (day_time >= today_start) {
-                // No water change recorded yet, show on today only
-                struct tm today_tm = now_tm;
-                today_tm.tm_hour = 0;
-                today_tm.tm_min = 0;
-                today_tm.tm_sec = 0;
-                time_t today = mktime(&today_tm);
-                
-                struct tm day_start_tm = day_tm;
-                day_start_tm.tm_hour = 0;
-                day_start_tm.tm_min = 0;
-                day_start_tm.tm_sec = 0;
-                time_t day_start = mktime(&day_start_tm);
-                
-                if (day_start == today) {
-                    water_planned = true;
-                }
-            }
-        }
-        
-        // Draw water dot/circle - centered horizontally at bottom
-        if (water_done) {
-            // Solid blue dot - water change was done
-            ESP_LOGI(TAG, "Creating solid water dot for day %d", i);
-            lv_obj_t *water_dot = lv_obj_create(week_day_boxes[i]);
-            lv_obj_set_size(water_dot, 6, 6);
-            lv_obj_set_pos(water_dot, (day_width - 40) / 2, 25);
-            lv_obj_set_style_bg_color(water_dot, lv_palette_main(LV_PALETTE_CYAN), 0);
-            lv_obj_set_style_bg_opa(water_dot, LV_OPA_COVER, 0);
-            lv_obj_set_style_border_width(water_dot, 0, 0);
-            lv_obj_set_style_radius(water_dot, LV_RADIUS_CIRCLE, 0);
-            lv_obj_set_style_pad_all(water_dot, 0, 0);
-            lv_obj_clear_flag(water_dot, LV_OBJ_FLAG_SCROLLABLE);
-        } else if (water_planned) {
-            // Hollow blue circle - water change is planned but not done
-            ESP_LOGI(TAG, "Creating hollow water circle for day %d", i);
-            lv_obj_t *water_dot = lv_obj_create(week_day_boxes[i]);
-            lv_obj_set_size(water_dot, 6, 6);
-            lv_obj_set_pos(water_dot, (day_width - 40) / 2, 25);
-            lv_obj_set_style_bg_opa(water_dot, LV_OPA_TRANSP, 0);  // Transparent background
-            lv_obj_set_style_border_color(water_dot, lv_palette_main(LV_PALETTE_CYAN), 0);
-            lv_obj_set_style_border_width(water_dot, 1, 0);  // 1px border
-            lv_obj_set_style_radius(water_dot, LV_RADIUS_CIRCLE, 0);
-            lv_obj_set_style_pad_all(water_dot, 0, 0);
-            lv_obj_clear_flag(water_dot, LV_OBJ_FLAG_SCROLLABLE);
+    if (state == WEEK_DOT_HIDDEN) {
+        lv_obj_add_flag(dot, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    // Swap the shared look: no local style entries on pooled dots
+    bool is_solid = (state == WEEK_DOT_SOLID);
+    lv_obj_remove_style(dot, ui_style(is_solid ? planned : solid), 0);
+    lv_obj_add_style(dot, ui_style(is_solid ? solid : planned), 0);
+    lv_obj_clear_flag(dot, LV_OBJ_FLAG_HIDDEN);
+}
+
+/**
+ * @brief Log a feed / water / parameter event: in-RAM index + SD store
+ */
+static void record_event(history_kind_t kind, time_t when, const float *values, size_t count)
+{
+    const history_event_t *ev = history_index_add(kind, when, values, count);
+    if (ev) {
+        history_store_append(ev);
+    }
+}
+
+/**
+ * @brief Week strip step: day `step` (0..6), then the layer invalidate
+ *
+ * Allocation-free: every day box owns a fixed dot pool (create_week_dot_pool)
+ * and only dots whose state changed are touched.
+ */
+static void week_dots_step(uint16_t step, void *user)
+{
+    if (step == 0) {
+        // One time zone conversion for the whole strip: days are numbers
+        week_dots_today = history_day_of(time(NULL));
+        const history_event_t *last_water = history_latest(HISTORY_WATER);
+        week_dots_have_water = last_water != NULL;
+        week_dots_last_water = last_water ? last_water->day : 0;
+    }
+    if (step >= 7) {
+        static_layer_invalidate(&panel_layer);  // Week strip changed
+        uint32_t objs = 0;
+        for (int d = 0; d < 7; d++) {
+            objs += ui_obj_track_count(week_day_boxes[d]);
         }
-        
-        // Check planned feeds for this day
-        int planned_feed_count = 0;
-        for (int j = 0; j < MAX_FEED_TIMES; j++) {
-            if (planned_feed_times[j].enabled) {
-                planned_feed_count++;
-            }
+        ui_obj_track_check("week dots", objs);  // Pooled: must never grow
+        return;
+    }
+    
+    int i = step;
+    int32_t today = week_dots_today;
+    if (!week_day_boxes[i]) return;
+    
+    // This day's number
+    int32_t day = today + (i - 3);
+    
+    if (!week_water_dots[i]) return;
+    
+    int day_width = 55;
+    
+    // Check if water was actually done on this specific day
+    bool water_done = history_store_logged(HISTORY_WATER, day) > 0;
+    
+    // If we have a water change schedule, check if one is due on THIS SPECIFIC day
+    bool water_planned = false;
+    if (tank->planned_water_change_interval > 0) {
+        if (week_dots_have_water) {
+            // Show hollow circle only on the exact next due date, or on today if overdue
+            int32_t next_due_day = week_dots_last_water + (int32_t)tank->planned_water_change_interval;
+            water_planned = (day == next_due_day) || (day == today && today > next_due_day);
+        } else {
+            // No water change recorded yet, show on today only
+            water_planned = (day == today);
         }
-        
-        // Count actual logged feeds for this day
-        int logged_feed_count = 0;
-        for (int j = 0; j < LOG_DAYS; j++) {
-            if (feed_log_data[j].timestamp == 0) continue;
-            struct tm feed_tm_buf;
-            struct tm *feed_tm = localtime_r(&feed_log_data[j].timestamp, &feed_tm_buf);
-            if (feed_tm->tm_yday == day_tm.tm_yday && feed_tm->tm_year == day_tm.tm_year) {
-                logged_feed_count++;
-            }
+    }
+    
+    // Water dot/circle - centered horizontally at bottom
+    lv_obj_set_pos(week_water_dots[i], (day_width - 40) / 2, 25);
+    set_week_dot(week_water_dots[i], &week_water_state[i],
+                 water_done ? WEEK_DOT_SOLID : (water_planned ? WEEK_DOT_HOLLOW : WEEK_DOT_HIDDEN),
+                 UI_STYLE_DOT_WATER, UI_STYLE_DOT_WATER_PLAN);
+    
+    // Check planned feeds for this day
+    int planned_feed_count = 0;
+    for (int j = 0; j < MAX_FEED_TIMES; j++) {
+        if (tank->feed_times[j].enabled) {
+            planned_feed_count++;
         }
-        
-        // Red feed dots/circles - arranged horizontally at top
-        int total_feeds_to_show = (logged_feed_count > planned_feed_count) ? logged_feed_count : planned_feed_count;
-        if (total_feeds_to_show > 4) total_feeds_to_show = 4;
-        
-        if (total_feeds_to_show > 0) {
-            // Calculate total width and center the row
-            int total_dots_width = (total_feeds_to_show * 6) + ((total_feeds_to_show - 1) * 2);
-            int start_x = (day_width - total_dots_width) / 2 - 17.375;
-            ESP_LOGI(TAG, "Feed dots day %d: planned=%d, logged=%d, showing=%d", i, planned_feed_count, logged_feed_count, total_feeds_to_show);
-            
-            for (int j = 0; j < total_feeds_to_show; j++) {
-                lv_obj_t *feed_dot = lv_obj_create(week_day_boxes[i]);
-                lv_obj_set_size(feed_dot, 6, 6);
-                lv_obj_set_pos(feed_dot, start_x + (j * 8), -5);
-                
-                if (j < logged_feed_count) {
-                    // Solid red dot - feed was logged
-                    lv_obj_set_style_bg_color(feed_dot, lv_palette_main(LV_PALETTE_RED), 0);
-                    lv_obj_set_style_bg_opa(feed_dot, LV_OPA_COVER, 0);
-                    lv_obj_set_style_border_width(feed_dot, 0, 0);
-                } else {
-                    // Hollow red circle - feed is planned but not logged
-                    lv_obj_set_style_bg_opa(feed_dot, LV_OPA_TRANSP, 0);  // Transparent background
-                    lv_obj_set_style_border_color(feed_dot, lv_palette_main(LV_PALETTE_RED), 0);
-                    lv_obj_set_style_border_width(feed_dot, 1, 0);  // 1px border
-                }
-                lv_obj_set_style_radius(feed_dot, LV_RADIUS_CIRCLE, 0);
-                lv_obj_set_style_pad_all(feed_dot, 0, 0);
-                lv_obj_clear_flag(feed_dot, LV_OBJ_FLAG_SCROLLABLE);
-            }
+    }
+    
+    // Count actual logged feeds for this day
+    int logged_feed_count = history_store_logged(HISTORY_FEED, day);
+    
+    // Red feed dots/circles - arranged horizontally at top
+    int total_feeds_to_show = (logged_feed_count > planned_feed_count) ? logged_feed_count : planned_feed_count;
+    if (total_feeds_to_show > 4) total_feeds_to_show = 4;
+    
+    // Calculate total width and center the row
+    int total_dots_width = (total_feeds_to_show * 6) + ((total_feeds_to_show - 1) * 2);
+    int start_x = (day_width - total_dots_width) / 2 - 17.375;
+    if (total_feeds_to_show > 0) {
+        ESP_LOGD(TAG, "Feed dots day %d: planned=%d, logged=%d, showing=%d", i, planned_feed_count, logged_feed_count, total_feeds_to_show);
+    }
+    
+    for (int j = 0; j < WEEK_FEED_DOTS; j++) {
+        week_dot_state_t state = WEEK_DOT_HIDDEN;
+        if (j < total_feeds_to_show) {
+            state = (j < logged_feed_count) ? WEEK_DOT_SOLID : WEEK_DOT_HOLLOW;
+            lv_obj_set_pos(week_feed_dots[i][j], start_x + (j * 8), -5);
         }
+        set_week_dot(week_feed_dots[i][j], &week_feed_state[i][j], state,
+                     UI_STYLE_DOT_FEED, UI_STYLE_DOT_FEED_PLAN);
     }
 }
 
+/**
+ * @brief Refresh weekly calendar activity dots, one day per step between frames
+ *
+ * Called again while a refresh is pending, it starts over from the first day.
+ */
+static void refresh_weekly_calendar_dots(void) {
+    ui_stage_start(&week_dots_stage, "week dots", NULL, 8, week_dots_step, NULL, 0);
+}
+
 /**
  * @brief Main screen button event handler (Feed/Water buttons)
  */
@@ -1704,28 +2155,27 @@ static void main_button_event_cb(lv_event_t *e)
         // Get current day index based on day-of-year
         time_t now = time(NULL);
         struct tm now_tm;
-        localtime_r(&now, &now_tm);
+        time_svc_local(&now_tm);
         int today_index = now_tm.tm_yday % LOG_DAYS;
         
         if (btn == btn_feed_main) {
             // Log feed event with timestamp
-            feed_log[today_index]++;
-            last_feed_time = get_current_time_seconds();
+            tank->feed_log[today_index]++;
+            tank->last_feed_time = time_svc_uptime_s();
+            dash_state_changed(tank);
             
-            // Save to feed_log_data with timestamp
-            for (int i = LOG_DAYS - 1; i > 0; i--) {
-                feed_log_data[i] = feed_log_data[i - 1];
-            }
-            feed_log_data[0].timestamp = time(NULL);
-            feed_log_data[0].feeds_per_day = 1;  // 1 click
+            // Record the feed event with timestamp
+            record_event(HISTORY_FEED, now, NULL, 0);
             
-            ESP_LOGI(TAG, "Feed logged - Day index %d: %lu feeds", today_index, feed_log[today_index]);
+            ESP_LOGI(TAG, "Feed logged - Day index %d: %lu feeds", today_index, tank->feed_log[today_index]);
             
-            // Save to SD card
-            save_feed_to_sd(feed_log_data[0].feeds_per_day);
+            // Save to SD card (the SD logs are the first tank's)
+            if (tank->id == 0) {
+                dash_log_feed(1);  // 1 click
+            }
             
             // Re-evaluate mood and update button colors
-            evaluate_and_update_mood();
+            evaluate_and_update_mood(tank);
             update_ai_assistant();
             
             // Refresh weekly calendar dots
@@ -1733,23 +2183,22 @@ static void main_button_event_cb(lv_event_t *e)
             
         } else if (btn == btn_water_main) {
             // Log water cleaning event with timestamp
-            water_log[today_index]++;
-            last_clean_time = get_current_time_seconds();
+            tank->water_log[today_index]++;
+            tank->last_clean_time = time_svc_uptime_s();
+            dash_state_changed(tank);
             
-            // Save to water_change_log with timestamp
-            for (int i = LOG_DAYS - 1; i > 0; i--) {
-                water_change_log[i] = water_change_log[i - 1];
-            }
-            water_change_log[0].timestamp = time(NULL);
-            water_change_log[0].interval_days = 1;  // 1 click
+            // Record the water change event with timestamp
+            record_event(HISTORY_WATER, now, NULL, 0);
             
-            ESP_LOGI(TAG, "Water cleaned - Day index %d: %lu cleanings", today_index, water_log[today_index]);
+            ESP_LOGI(TAG, "Water cleaned - Day index %d: %lu cleanings", today_index, tank->water_log[today_index]);
             
-            // Save to SD card
-            save_water_change_to_sd(water_change_log[0].interval_days);
+            // Save to SD card (the SD logs are the first tank's)
+            if (tank->id == 0) {
+                dash_log_water_change(1);  // 1 click
+            }
             
             // Re-evaluate mood and update button colors
-            evaluate_and_update_mood();
+            evaluate_and_update_mood(tank);
             update_ai_assistant();
             
             // Refresh weekly calendar dots
@@ -1762,1547 +2211,704 @@ static void main_button_event_cb(lv_event_t *e)
  * @brief Close any active popup
  */
 static void close_popup(void) {
-    if (popup_param) { lv_obj_del(popup_param); popup_param = NULL; }
-    if (popup_water) { lv_obj_del(popup_water); popup_water = NULL; }
-    if (popup_feed) { lv_obj_del(popup_feed); popup_feed = NULL; }
-    if (popup_history) { lv_obj_del(popup_history); popup_history = NULL; }
-    if (popup_keypad) { lv_obj_del(popup_keypad); popup_keypad = NULL; }
-    if (popup_monthly_cal) { lv_obj_del(popup_monthly_cal); popup_monthly_cal = NULL; }
-    if (popup_med_calc) { lv_obj_del(popup_med_calc); popup_med_calc = NULL; }
-    active_input_field = NULL;
+    num_keypad_close();
+    log_popups_close();
+    history_view_close();
+    calendar_view_close();
+    med_calc_view_close();
+    if (popup_chat) { lv_obj_del(popup_chat); }   // DELETE handler clears the pointers
+    static_layer_invalidate(&panel_layer);  // Popups may have changed panel data
+    log_popups_kick();                      // Replace the spare an open popup used
 }
 
+// ═════════════════════════════════════════════════════════════════════════════
+// VIEW HOOKS - THE POPUPS IN ui/ EDIT THE SHOWN TANK ONLY THROUGH THESE
+// ═════════════════════════════════════════════════════════════════════════════
+
 /**
- * @brief Calculate medication dosage based on current state
+ * @brief Dosage result (ui/med_calc_view.h): AI context and AI screen
  */
-static void calculate_medication_dosage(void) {
-    // Get input values
-    const char *amount_text = lv_textarea_get_text(med_product_amount_input);
-    const char *per_volume_text = lv_textarea_get_text(med_per_volume_input);
-    const char *tank_size_text = lv_textarea_get_text(med_tank_size_input);
-    
-    med_calc_state.product_amount = atof(amount_text);
-    med_calc_state.per_volume = atof(per_volume_text);
-    med_calc_state.tank_size = atof(tank_size_text);
-    med_calc_state.unit_type = lv_dropdown_get_selected(med_unit_dropdown);
-    
-    // Validate inputs
-    if (med_calc_state.product_amount <= 0 || med_calc_state.per_volume <= 0 || med_calc_state.tank_size <= 0) {
-        lv_label_set_text(med_result_label, "❌ Invalid input!\nAll values must be positive numbers.");
-        return;
-    }
-    
-    // Get unit strings
-    const char *unit_names[] = {"ml", "tsp", "tbsp", "drops", "fl oz", "cups", "g"};
-    const char *per_unit_str = med_calc_state.is_gallons ? "gal" : "L";
-    const char *tank_unit_str = med_calc_state.tank_is_gallons ? "gal" : "L";
-    const char *dose_unit = unit_names[med_calc_state.unit_type];
-    
-    // Convert product amount to ml for calculation
-    float product_amount_ml = med_calc_state.product_amount;
-    switch (med_calc_state.unit_type) {
-        case 0: break;                              // ml - no conversion
-        case 1: product_amount_ml *= 5.0; break;    // tsp to ml
-        case 2: product_amount_ml *= 15.0; break;   // tbsp to ml
-        case 3: product_amount_ml *= 0.05; break;   // drops to ml (1 drop ≈ 0.05ml)
-        case 4: product_amount_ml *= 29.5735; break; // fl oz to ml
-        case 5: product_amount_ml *= 236.588; break; // cups to ml (US cup)
-        case 6: product_amount_ml *= 1.0; break;    // grams to ml (assuming 1:1 for liquids)
-        default: break;
-    }
-    
-    // Convert volumes to same unit (liters) for calculation
-    float per_volume_l = med_calc_state.per_volume;
-    if (med_calc_state.is_gallons) per_volume_l *= 3.78541;  // gallons to liters
-    
-    float tank_size_l = med_calc_state.tank_size;
-    if (med_calc_state.tank_is_gallons) tank_size_l *= 3.78541;  // gallons to liters
-    
-    // Universal formula: (tank_size / per_volume) * product_amount
-    float dosage_ml = (tank_size_l / per_volume_l) * product_amount_ml;
-    med_calc_state.calculated_dosage = dosage_ml;
-    
-    // Calculate alternative measurements
-    float dosage_tsp = dosage_ml / 5.0;
-    float dosage_tbsp = dosage_ml / 15.0;
-    float dosage_drops = dosage_ml / 0.05;
-    float dosage_floz = dosage_ml / 29.5735;
-    
-    // Format result text
-    snprintf(med_calc_state.result_text, sizeof(med_calc_state.result_text),
-             "✅ Total Dosage for %.1f %s tank:\n\n"
-             "Based on: %.1f %s per %.1f %s\n\n"
-             "Add to tank:\n"
-             "🧪 %.2f ml\n"
-             "🥄 %.2f tsp\n"
-             "🥄 %.2f tbsp\n"
-             "💧 %.0f drops\n"
-             "🧴 %.2f fl oz",
-             med_calc_state.tank_size, tank_unit_str,
-             med_calc_state.product_amount, dose_unit, med_calc_state.per_volume, per_unit_str,
-             dosage_ml, dosage_tsp, dosage_tbsp, dosage_drops, dosage_floz);
-    
-    // Update result label in popup
-    lv_label_set_text(med_result_label, med_calc_state.result_text);
-    
+static void med_calc_result_hook(const char *context, const char *summary)
+{
     // Store for AI integration
-    snprintf(latest_med_calculation, sizeof(latest_med_calculation),
-             "UNIVERSAL DOSAGE CALCULATION:\n"
-             "- Product: %.1f %s per %.1f %s\n"
-             "- Tank Size: %.1f %s\n"
-             "- Total Dosage: %.2f ml (%.2f tsp)\n",
-             med_calc_state.product_amount, dose_unit, med_calc_state.per_volume, per_unit_str,
-             med_calc_state.tank_size, tank_unit_str,
-             dosage_ml, dosage_tsp);
-    
+    snprintf(latest_med_calculation, sizeof(latest_med_calculation), "%s", context);
+    dash_live_publish();
+
     // Update AI screen display if it exists
     if (ai_med_result_label) {
-        char ai_display[256];
-        snprintf(ai_display, sizeof(ai_display),
-                 "💊 Dosage Calc: %.1f%s/%.1f%s\n"
-                 "Tank %.1f%s → Add %.2f ml",
-                 med_calc_state.product_amount, dose_unit, med_calc_state.per_volume, per_unit_str,
-                 med_calc_state.tank_size, tank_unit_str, dosage_ml);
-        lv_label_set_text(ai_med_result_label, ai_display);
+        lv_label_set_text(ai_med_result_label, summary);
     }
+}
+
+static const med_calc_view_hooks_t med_calc_hooks = {
+    .result = med_calc_result_hook,
+    .advise = update_ai_assistant,
+};
+
+/**
+ * @brief Save parameter log entry
+ */
+static struct {
+    tank_t *tank;                          // The tank the popup was for
+    float ammonia, nitrate, nitrite, ph;
+} param_save;
+
+/**
+ * @brief Parameter save step: the four values, the history entry, the SD log
+ */
+static void param_save_step(uint16_t step, void *user)
+{
+    static const uint8_t params[4] = {
+        DASHBOARD_PARAM_AMMONIA, DASHBOARD_PARAM_NITRATE, DASHBOARD_PARAM_NITRITE, DASHBOARD_PARAM_PH
+    };
+    const float values[4] = { param_save.ammonia, param_save.nitrate, param_save.nitrite, param_save.ph };
     
-    ESP_LOGI(TAG, "Universal dosage calculated: %.1f %s per %.1f %s for %.1f %s = %.2f ml",
-             med_calc_state.product_amount, dose_unit, med_calc_state.per_volume, per_unit_str,
-             med_calc_state.tank_size, tank_unit_str, dosage_ml);
+    if (step < 4) {
+        // Typed, so a replay repeats them from the touches
+        set_tank_param(param_save.tank, params[step], values[step]);
+    } else if (step == 4) {
+        // Record the new entry (most recent)
+        const float param_values[HISTORY_VALUES] = {values[0], values[1], values[2], values[3], values[3]};
+        record_event(HISTORY_PARAM, time(NULL), param_values, HISTORY_VALUES);
+        
+        ESP_LOGI(TAG, "Parameters saved: NH3=%.2f, NO3=%.1f, NO2=%.2f, pH=%.1f",
+                values[0], values[1], values[2], values[3]);
+    } else if (param_save.tank->id == 0) {
+        // Save to SD card (the SD logs are the first tank's)
+        dash_log_parameters(values[0], values[1], values[2], values[3]);
+    }
+}
+
+/**
+ * @brief Parameter popup's Save (ui/log_popups.h): NH3, NO3, NO2, pH
+ */
+static void log_save_params_hook(const float values[4])
+{
+    // A save still in progress lands first: its values are the older ones
+    ui_stage_flush(&param_save_stage);
     
-    // Save to SD card
-    save_medication_to_sd();
+    param_save.tank = tank;
+    param_save.ammonia = values[0];
+    param_save.nitrate = values[1];
+    param_save.nitrite = values[2];
+    param_save.ph = values[3];
     
-    // Trigger AI update with new medication context
-    update_ai_assistant();
+    // The popup goes in this frame; the dashboard updates and the logging follow
+    ui_stage_start(&param_save_stage, "param save", NULL, 6, param_save_step, NULL, 0);
 }
 
 /**
- * @brief Close calculator popup event callback
+ * @brief Water popup's Save Schedule: change interval in days (1-365)
  */
-static void med_calc_close_event_cb(lv_event_t *e) {
-    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
-        if (popup_med_calc) {
-            lv_obj_del(popup_med_calc);
-            popup_med_calc = NULL;
-        }
+static void log_water_interval_hook(uint32_t interval)
+{
+    tank->planned_water_change_interval = interval;
+    tank->water_interval_days = interval;
+    dash_state_changed(tank);
+    ESP_LOGI(TAG, "Water change interval updated: %lu days", (unsigned long)tank->planned_water_change_interval);
+
+    // Save to SD card (the SD logs are the first tank's)
+    if (tank->id == 0) {
+        dash_log_water_change(interval);
     }
+
+    // Refresh calendar dots to update hollow circles
+    refresh_weekly_calendar_dots();
 }
 
 /**
- * @brief Calculate button event callback
+ * @brief Feed popup's Set Schedule: spread the feeds over the day
  */
-static void med_calc_calculate_event_cb(lv_event_t *e) {
-    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
-        calculate_medication_dosage();
+static void log_feed_schedule_hook(int num_feeds)
+{
+    if (num_feeds < 1) num_feeds = 1;
+    if (num_feeds > MAX_FEED_TIMES) num_feeds = MAX_FEED_TIMES;
+
+    // Configure feed times based on number
+    // Define all time arrays outside the loop
+    const uint8_t times_1[] = {12};
+    const uint8_t times_2[] = {8, 20};
+    const uint8_t times_3[] = {8, 14, 20};
+    const uint8_t times_4[] = {7, 12, 17, 22};
+    const uint8_t times_5[] = {6, 10, 14, 18, 22};
+    const uint8_t times_6[] = {6, 9, 12, 15, 18, 21};
+
+    for (int i = 0; i < MAX_FEED_TIMES; i++) {
+        if (i < num_feeds) {
+            // Select the appropriate time based on number of feeds
+            if (num_feeds == 1) {
+                tank->feed_times[i].hour = times_1[i];
+            } else if (num_feeds == 2) {
+                tank->feed_times[i].hour = times_2[i];
+            } else if (num_feeds == 3) {
+                tank->feed_times[i].hour = times_3[i];
+            } else if (num_feeds == 4) {
+                tank->feed_times[i].hour = times_4[i];
+            } else if (num_feeds == 5) {
+                tank->feed_times[i].hour = times_5[i];
+            } else if (num_feeds == 6) {
+                tank->feed_times[i].hour = times_6[i];
+            }
+            tank->feed_times[i].minute = 0;
+            tank->feed_times[i].enabled = true;
+        } else {
+            tank->feed_times[i].enabled = false;
+        }
     }
+
+    tank->feeds_per_day = num_feeds;
+    dash_state_changed(tank);
+    ESP_LOGI(TAG, "Feed schedule updated: %d feeds per day", num_feeds);
+    // Refresh calendar dots to update hollow circles
+    refresh_weekly_calendar_dots();
 }
 
 /**
- * @brief Unit toggle switch event callback for "Per" field
+ * @brief Feed popup's Save: log a feed now
  */
-static void med_unit_switch_event_cb(lv_event_t *e) {
-    if (lv_event_get_code(e) == LV_EVENT_VALUE_CHANGED) {
-        lv_obj_t *sw = lv_event_get_target(e);
-        med_calc_state.is_gallons = lv_obj_has_state(sw, LV_STATE_CHECKED);
-        ESP_LOGI(TAG, "Per field unit switched to: %s", med_calc_state.is_gallons ? "Gallons" : "Liters");
+static void log_feed_hook(void)
+{
+    // Record the new entry (most recent)
+    time_t now = time(NULL);
+    record_event(HISTORY_FEED, now, NULL, 0);
+    tank->feeds_per_day = 2;  // TODO: Read from input field
+    dash_state_changed(tank);
+
+    ESP_LOGI(TAG, "Feeds per day saved: %d (timestamp: %ld)", 
+             tank->feeds_per_day, (long)now);
+
+    // Save to SD card (the SD logs are the first tank's)
+    if (tank->id == 0) {
+        dash_log_feed(tank->feeds_per_day);
     }
+
+    evaluate_and_update_mood(tank);
 }
 
 /**
- * @brief Tank unit toggle switch event callback
+ * @brief Log popups are built ahead only while the panel is idle
  */
-static void med_tank_unit_switch_event_cb(lv_event_t *e) {
-    if (lv_event_get_code(e) == LV_EVENT_VALUE_CHANGED) {
-        lv_obj_t *sw = lv_event_get_target(e);
-        med_calc_state.tank_is_gallons = lv_obj_has_state(sw, LV_STATE_CHECKED);
-        ESP_LOGI(TAG, "Tank size unit switched to: %s", med_calc_state.tank_is_gallons ? "Gallons" : "Liters");
-    }
+static bool log_popups_busy_hook(void)
+{
+    return ui_stage_busy(&panel_stage) || panel_popup_open() || ui_is_scrolling();
 }
 
+static const log_popups_hooks_t log_popup_hooks = {
+    .save_params = log_save_params_hook,
+    .set_water_interval = log_water_interval_hook,
+    .set_feed_schedule = log_feed_schedule_hook,
+    .log_feed = log_feed_hook,
+    .close = close_popup,
+    .busy = log_popups_busy_hook,
+};
+
 /**
- * @brief Medication type dropdown event callback
+ * @brief Calendar page button event callbacks
  */
-// Removed - no longer needed for Universal calculator
-// static void med_type_dropdown_event_cb(lv_event_t *e) {
-//     if (lv_event_get_code(e) == LV_EVENT_VALUE_CHANGED) {
-//         lv_obj_t *dropdown = lv_event_get_target(e);
-//         med_calc_state.med_type = (medication_type_t)lv_dropdown_get_selected(dropdown);
-//         ESP_LOGI(TAG, "Medication type changed to: %s",
-//                  medication_database[med_calc_state.med_type].name);
-//     }
-// }
+static void calendar_button_event_cb(lv_event_t *e) {
+    lv_obj_t *btn = lv_event_get_target(e);
+    
+    if (lv_event_get_code(e) != LV_EVENT_CLICKED) return;
+    
+    if (btn == btn_param_log) {
+        if (history_view_is_open()) return;  // The release after a long-press opened diagnostics
+        log_popups_open(LOG_POPUP_PARAM);
+    } else if (btn == btn_water_log) {
+        log_popups_open(LOG_POPUP_WATER);
+    } else if (btn == btn_feed_log) {
+        log_popups_open(LOG_POPUP_FEED);
+    } else if (btn == btn_med_calc) {
+        ESP_LOGI(TAG, "Med Calc button clicked - opening popup");
+        close_popup();
+        med_calc_view_open(scroll_container);
+    }
+}
 
 /**
- * @brief Show medication calculator popup
+ * @brief Gesture event handler for swipe detection
  */
 /**
- * @brief Show medication calculator popup
+ * @brief Panel button event handler
  */
-static void show_med_calculator_popup(void) {
-    // Close any existing popups
-    close_popup();
-    
-    // Create full-screen popup overlay
-    popup_med_calc = lv_obj_create(scroll_container);
-    lv_obj_set_size(popup_med_calc, 440, 300);
-    lv_obj_set_pos(popup_med_calc, 20, 490);  // Y=490 (calendar panel area)
-    lv_obj_set_style_bg_color(popup_med_calc, lv_color_hex(0x1a1a1a), 0);
-    lv_obj_set_style_border_width(popup_med_calc, 3, 0);
-    lv_obj_set_style_border_color(popup_med_calc, lv_palette_main(LV_PALETTE_BLUE), 0);
-    lv_obj_set_style_radius(popup_med_calc, 10, 0);
-    lv_obj_set_scrollbar_mode(popup_med_calc, LV_SCROLLBAR_MODE_AUTO);  // Enable scrollbar
-    lv_obj_set_scroll_dir(popup_med_calc, LV_DIR_VER);  // Vertical scrolling
-    
-    // Title
-    lv_obj_t *title = lv_label_create(popup_med_calc);
-    lv_label_set_text(title, "💊 Universal Dosage Calculator");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_16, 0);
-    lv_obj_set_style_text_color(title, lv_palette_main(LV_PALETTE_BLUE), 0);
-    lv_obj_set_pos(title, 10, 8);
-    
-    // Row 1: Amount of Product
-    lv_obj_t *amount_label = lv_label_create(popup_med_calc);
-    lv_label_set_text(amount_label, "Amount:");
-    lv_obj_set_style_text_color(amount_label, lv_color_white(), 0);
-    lv_obj_set_pos(amount_label, 20, 45);
-    
-    med_product_amount_input = lv_textarea_create(popup_med_calc);
-    lv_obj_set_size(med_product_amount_input, 80, 35);
-    lv_obj_set_pos(med_product_amount_input, 100, 40);
-    lv_textarea_set_one_line(med_product_amount_input, true);
-    lv_textarea_set_text(med_product_amount_input, "5");
-    lv_obj_add_event_cb(med_product_amount_input, input_field_event_cb, LV_EVENT_CLICKED, NULL);
-    
-    // Unit dropdown (ml, tsp, tbsp, drops, fl oz, cups, g)
-    med_unit_dropdown = lv_dropdown_create(popup_med_calc);
-    lv_obj_set_size(med_unit_dropdown, 80, 35);
-    lv_obj_set_pos(med_unit_dropdown, 195, 40);
-    lv_dropdown_set_options(med_unit_dropdown, "ml\ntsp\ntbsp\ndrops\nfl oz\ncups\ng");
-    
-    // Row 2: Per X gallons/litres
-    lv_obj_t *per_label = lv_label_create(popup_med_calc);
-    lv_label_set_text(per_label, "Per:");
-    lv_obj_set_style_text_color(per_label, lv_color_white(), 0);
-    lv_obj_set_pos(per_label, 20, 90);
-    
-    med_per_volume_input = lv_textarea_create(popup_med_calc);
-    lv_obj_set_size(med_per_volume_input, 80, 35);
-    lv_obj_set_pos(med_per_volume_input, 100, 85);
-    lv_textarea_set_one_line(med_per_volume_input, true);
-    lv_textarea_set_text(med_per_volume_input, "10");
-    lv_obj_add_event_cb(med_per_volume_input, input_field_event_cb, LV_EVENT_CLICKED, NULL);
-    
-    // Unit toggle (L/Gal)
-    lv_obj_t *unit_label_l = lv_label_create(popup_med_calc);
-    lv_label_set_text(unit_label_l, "L");
-    lv_obj_set_style_text_color(unit_label_l, lv_color_white(), 0);
-    lv_obj_set_pos(unit_label_l, 195, 92);
-    
-    med_unit_switch = lv_switch_create(popup_med_calc);
-    lv_obj_set_pos(med_unit_switch, 220, 88);
-    lv_obj_add_event_cb(med_unit_switch, med_unit_switch_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
-    
-    lv_obj_t *unit_label_g = lv_label_create(popup_med_calc);
-    lv_label_set_text(unit_label_g, "Gal");
-    lv_obj_set_style_text_color(unit_label_g, lv_color_white(), 0);
-    lv_obj_set_pos(unit_label_g, 275, 92);
-    
-    // Row 3: Tank Size with L/Gal toggle
-    lv_obj_t *tank_label = lv_label_create(popup_med_calc);
-    lv_label_set_text(tank_label, "Tank Size:");
-    lv_obj_set_style_text_color(tank_label, lv_color_white(), 0);
-    lv_obj_set_pos(tank_label, 20, 135);
-    
-    med_tank_size_input = lv_textarea_create(popup_med_calc);
-    lv_obj_set_size(med_tank_size_input, 80, 35);
-    lv_obj_set_pos(med_tank_size_input, 120, 130);
-    lv_textarea_set_one_line(med_tank_size_input, true);
-    lv_textarea_set_text(med_tank_size_input, "50");
-    lv_obj_add_event_cb(med_tank_size_input, input_field_event_cb, LV_EVENT_CLICKED, NULL);
-    
-    // Tank Size Unit toggle (L/Gal)
-    lv_obj_t *tank_unit_label_l = lv_label_create(popup_med_calc);
-    lv_label_set_text(tank_unit_label_l, "L");
-    lv_obj_set_style_text_color(tank_unit_label_l, lv_color_white(), 0);
-    lv_obj_set_pos(tank_unit_label_l, 215, 137);
-    
-    med_tank_unit_switch = lv_switch_create(popup_med_calc);
-    lv_obj_set_pos(med_tank_unit_switch, 240, 133);
-    lv_obj_add_event_cb(med_tank_unit_switch, med_tank_unit_switch_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
-    
-    lv_obj_t *tank_unit_label_g = lv_label_create(popup_med_calc);
-    lv_label_set_text(tank_unit_label_g, "Gal");
-    lv_obj_set_style_text_color(tank_unit_label_g, lv_color_white(), 0);
-    lv_obj_set_pos(tank_unit_label_g, 295, 137);
-    
-    // Calculate button
-    lv_obj_t *btn_calc = lv_btn_create(popup_med_calc);
-    lv_obj_set_size(btn_calc, 120, 40);
-    lv_obj_set_pos(btn_calc, 20, 185);
-    lv_obj_set_style_bg_color(btn_calc, lv_color_hex(0x00aa00), 0);
-    lv_obj_add_event_cb(btn_calc, med_calc_calculate_event_cb, LV_EVENT_CLICKED, NULL);
-    lv_obj_t *calc_lbl = lv_label_create(btn_calc);
-    lv_label_set_text(calc_lbl, "Calculate");
-    lv_obj_center(calc_lbl);
-    
-    // Close button - moved next to Calculate button
-    lv_obj_t *btn_close = lv_btn_create(popup_med_calc);
-    lv_obj_set_size(btn_close, 80, 40);
-    lv_obj_set_pos(btn_close, 155, 185);
-    lv_obj_set_style_bg_color(btn_close, lv_color_hex(0xff0000), 0);
-    lv_obj_add_event_cb(btn_close, med_calc_close_event_cb, LV_EVENT_CLICKED, NULL);
-    lv_obj_t *close_lbl = lv_label_create(btn_close);
-    lv_label_set_text(close_lbl, "Close");
-    lv_obj_center(close_lbl);
-    
-    // Result display - positioned below buttons, extends beyond viewport to enable scrolling
-    med_result_label = lv_label_create(popup_med_calc);
-    lv_obj_set_size(med_result_label, 400, 200);
-    lv_obj_set_pos(med_result_label, 20, 240);
-    lv_label_set_long_mode(med_result_label, LV_LABEL_LONG_WRAP);
-    lv_obj_set_style_text_color(med_result_label, lv_color_hex(0x00ff00), 0);
-    lv_label_set_text(med_result_label, "Enter values and click Calculate.");
-    
-    ESP_LOGI(TAG, "Universal dosage calculator popup opened on calendar page");
-}
-
-/**
- * @brief Decimal keypad button event callback
- */
-static void keypad_event_cb(lv_event_t *e) {
+static void panel_button_event_cb(lv_event_t *e)
+{
     lv_event_code_t code = lv_event_get_code(e);
-    if (code != LV_EVENT_CLICKED) return;
-    
     lv_obj_t *btn = lv_event_get_target(e);
-    const char *txt = lv_btnmatrix_get_btn_text(btn, lv_btnmatrix_get_selected_btn(btn));
-    
-    if (!active_input_field) return;
     
-    // Get the display textarea from keypad container
-    lv_obj_t *keypad_cont = lv_obj_get_parent(btn);
-    lv_obj_t *display = (lv_obj_t *)lv_obj_get_user_data(keypad_cont);
-    
-    if (strcmp(txt, "OK") == 0) {
-        // Copy display value to input field and close
-        if (display) {
-            const char *val = lv_textarea_get_text(display);
-            lv_textarea_set_text(active_input_field, val);
-        }
-        if (popup_keypad) { lv_obj_del(popup_keypad); popup_keypad = NULL; }
-        active_input_field = NULL;
-    } else if (strcmp(txt, "DEL") == 0) {
-        if (display) lv_textarea_del_char(display);
-    } else if (strcmp(txt, "CLR") == 0) {
-        if (display) lv_textarea_set_text(display, "0");
-    } else {
-        // Add digit/decimal to display
-        if (display) {
-            const char *current = lv_textarea_get_text(display);
-            if (strcmp(current, "0") == 0) {
-                // Replace leading zero
-                lv_textarea_set_text(display, txt);
-            } else {
-                lv_textarea_add_text(display, txt);
-            }
+    if (code == LV_EVENT_CLICKED) {
+        if (btn == btn_home) {
+            // Scroll back to top (animation section)
+            lv_obj_scroll_to_y(scroll_container, 0, LV_ANIM_ON);
+            ESP_LOGI(TAG, "Scrolling back to home (top)");
         }
     }
 }
 
 /**
- * @brief Show decimal keypad for input field
+ * @brief Keyboard event handler
  */
-static void show_keypad(lv_obj_t *input_field) {
-    if (popup_keypad) return;
-    active_input_field = input_field;
-    
-    // Clear the input field when keypad opens (replace instead of append)
-    lv_textarea_set_text(active_input_field, "");
+static void keyboard_event_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    lv_obj_t *kb = lv_event_get_target(e);
     
-    // Check if input field is inside medication calculator popup
-    bool is_med_calc_input = false;
-    lv_obj_t *parent = lv_obj_get_parent(input_field);
-    while (parent != NULL) {
-        if (parent == popup_med_calc) {
-            is_med_calc_input = true;
-            break;
+    if (code == LV_EVENT_READY || code == LV_EVENT_CANCEL) {
+        if (code == LV_EVENT_READY && panel_textarea) {
+            // Get entered value
+            const char *txt = lv_textarea_get_text(panel_textarea);
+            float value = atof(txt);
+            
+            // Validate range
+            DialParam &param = dial_params[current_dropdown_idx];
+            if (value < param.min_val) value = param.min_val;
+            if (value > param.max_val) value = param.max_val;
+            
+            // Update parameter and animate dial
+            param.current_val = value;
+            update_panel_dial(value, true);
+            
+            ESP_LOGI(TAG, "Parameter '%s' set to %.2f", param.name, value);
         }
-        parent = lv_obj_get_parent(parent);
+        
+        close_numeric_input();
     }
-    
-    // Create keypad in appropriate container
-    if (is_med_calc_input && popup_med_calc) {
-        // Create keypad inside medication calculator popup
-        popup_keypad = lv_obj_create(popup_med_calc);
-        lv_obj_set_size(popup_keypad, 440, 300);  // Match popup_med_calc size
-        lv_obj_set_pos(popup_keypad, 0, 0);  // Fill entire popup
-    } else {
-        // Create keypad inside panel_content (for other inputs)
-        popup_keypad = lv_obj_create(panel_content);
-        lv_obj_set_size(popup_keypad, 440, 280);  // Match panel_content size
-        lv_obj_set_pos(popup_keypad, 0, 0);  // Fill entire panel_content
-    }
-    
-    lv_obj_set_style_bg_color(popup_keypad, lv_color_black(), 0);
-    lv_obj_set_style_bg_opa(popup_keypad, LV_OPA_80, 0);
-    lv_obj_set_style_border_width(popup_keypad, 0, 0);
-    lv_obj_clear_flag(popup_keypad, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_set_style_pad_all(popup_keypad, 0, 0);  // Remove padding
-    
-    lv_obj_t *keypad_cont = lv_obj_create(popup_keypad);
-    lv_obj_set_size(keypad_cont, 300, 260);
-    lv_obj_set_pos(keypad_cont, 70, 20);  // Centered: (440-300)/2=70, (300-260)/2=20
-    lv_obj_set_style_bg_color(keypad_cont, lv_color_hex(0x2a2a2a), 0);
-    
-    // Add display area at top showing current value
-    lv_obj_t *display = lv_textarea_create(keypad_cont);
-    lv_obj_set_size(display, 280, 40);
-    lv_obj_set_pos(display, 10, 5);
-    lv_textarea_set_text(display, "0");
-    lv_textarea_set_one_line(display, true);
-    lv_obj_set_style_text_font(display, &lv_font_montserrat_20, 0);
-    lv_obj_set_style_text_align(display, LV_TEXT_ALIGN_RIGHT, 0);
-    lv_obj_clear_flag(display, LV_OBJ_FLAG_CLICKABLE);  // Read-only display
-    lv_obj_set_user_data(keypad_cont, display);  // Store display reference
-    
-    static const char *keypad_map[] = {
-        "1", "2", "3", "\n",
-        "4", "5", "6", "\n",
-        "7", "8", "9", "\n",
-        ".", "0", "DEL", "\n",
-        "CLR", "OK", ""
-    };
-    
-    lv_obj_t *btnm = lv_btnmatrix_create(keypad_cont);
-    lv_btnmatrix_set_map(btnm, keypad_map);
-    lv_obj_set_size(btnm, 280, 200);
-    lv_obj_set_pos(btnm, 10, 50);
-    lv_obj_add_event_cb(btnm, keypad_event_cb, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_move_foreground(popup_keypad);
 }
 
 /**
- * @brief Input field click event - shows keypad
+ * @brief Update panel dial value with optional animation
  */
-static void input_field_event_cb(lv_event_t *e) {
-    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
-        show_keypad(lv_event_get_target(e));
-    }
+static void update_panel_dial(float value, bool animate)
+{
+    // Since we removed the meter, just log the value update
+    DialParam &param = dial_params[current_dropdown_idx];
+    ESP_LOGI(TAG, "Parameter '%s' updated to %.2f", param.name, value);
 }
 
+
 /**
- * @brief Save parameter log entry
+ * @brief Close numeric input modal
  */
-static void save_param_log_cb(lv_event_t *e) {
-    // Read values from input fields (5 fields: NH3, NO3, NO2, pH, pH_unused)
-    lv_obj_t *inputs[5];
-    int input_idx = 0;
-    
-    // Find all textarea children in popup_param
-    uint32_t child_count = lv_obj_get_child_cnt(popup_param);
-    for (uint32_t i = 0; i < child_count && input_idx < 5; i++) {
-        lv_obj_t *child = lv_obj_get_child(popup_param, i);
-        if (lv_obj_check_type(child, &lv_textarea_class)) {
-            inputs[input_idx++] = child;
-        }
-    }
-    
-    if (input_idx == 5) {
-        // Read values from textareas
-        float ammonia_val = atof(lv_textarea_get_text(inputs[0]));
-        float nitrate_val = atof(lv_textarea_get_text(inputs[1]));
-        float nitrite_val = atof(lv_textarea_get_text(inputs[2]));
-        float ph_val = atof(lv_textarea_get_text(inputs[3]));
-        
-        // Update dashboard with new values
-        dashboard_update_ammonia(ammonia_val);
-        dashboard_update_nitrate(nitrate_val);
-        dashboard_update_nitrite(nitrite_val);
-        dashboard_update_ph(ph_val);
-        
-        // Shift existing log entries down
-        for (int i = LOG_DAYS - 1; i > 0; i--) {
-            param_log[i] = param_log[i - 1];
-        }
-        
-        // Save new entry at index 0 (most recent)
-        param_log[0].timestamp = time(NULL);
-        param_log[0].ammonia = ammonia_val;
-        param_log[0].nitrate = nitrate_val;
-        param_log[0].nitrite = nitrite_val;
-        param_log[0].high_ph = ph_val;
-        param_log[0].low_ph = ph_val;
-        
-        ESP_LOGI(TAG, "Parameters saved: NH3=%.2f, NO3=%.1f, NO2=%.2f, pH=%.1f",
-                ammonia_val, nitrate_val, nitrite_val, ph_val);
-        
-        // Save to SD card
-        save_parameters_to_sd(ammonia_val, nitrate_val, nitrite_val, ph_val);
+static void close_numeric_input(void)
+{
+    if (panel_modal) {
+        lv_obj_del(panel_modal);
+        panel_modal = NULL;
+        panel_keyboard = NULL;
+        panel_textarea = NULL;
     }
-    
-    close_popup();
 }
 
 /**
- * @brief Show day history popup - all activities for a specific day
+ * @brief Create a circular button for Feed/Water actions
  */
-static void show_day_history(time_t target_date) {
-    if (popup_history) return;
-    
-    popup_history = lv_obj_create(panel_content);
-    lv_obj_set_size(popup_history, 450, 400);
-    lv_obj_center(popup_history);
-    lv_obj_set_style_bg_color(popup_history, lv_color_hex(0x1a1a1a), 0);
-    
-    // Get target day info
-    struct tm target_tm;
-    localtime_r(&target_date, &target_tm);
-    int target_day = target_tm.tm_yday;
-    int target_year = target_tm.tm_year;
+static lv_obj_t* create_circular_button(lv_obj_t *parent, const char *label_text, 
+                                        lv_align_t align, lv_coord_t x_ofs, lv_coord_t y_ofs)
+{
+    // Create circular button
+    lv_obj_t *btn = lv_btn_create(parent);
+    lv_obj_set_size(btn, 72, 72);
+    lv_obj_align(btn, align, x_ofs, y_ofs);
+    lv_obj_add_style(btn, ui_style(UI_STYLE_ROUND_BTN), LV_PART_MAIN);
     
-    char title_text[64];
-    strftime(title_text, sizeof(title_text), "Activity - %d %b %Y", &target_tm);
-    lv_obj_t *title = lv_label_create(popup_history);
-    lv_label_set_text(title, title_text);
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_16, 0);
-    lv_obj_set_style_text_color(title, lv_color_white(), 0);
-    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
-    
-    // Section 1: Activity Log (Left side)
-    lv_obj_t *section1_title = lv_label_create(popup_history);
-    lv_label_set_text(section1_title, "Activity Log");
-    lv_obj_set_style_text_font(section1_title, &lv_font_montserrat_14, 0);
-    lv_obj_set_style_text_color(section1_title, lv_palette_main(LV_PALETTE_CYAN), 0);
-    lv_obj_set_pos(section1_title, 10, 50);
-    
-    lv_obj_t *list = lv_list_create(popup_history);
-    lv_obj_set_size(list, 210, 125);
-    lv_obj_set_pos(list, 10, 75);
-    
-    // Show all activities for this day
-    bool has_activity = false;
-    
-    // Check feed log - search all entries for matching day
-    for (int i = 0; i < LOG_DAYS; i++) {
-        if (feed_log_data[i].timestamp == 0) continue;
-        struct tm feed_tm_buf;
-        struct tm *feed_tm = localtime_r(&feed_log_data[i].timestamp, &feed_tm_buf);
-        if (feed_tm->tm_yday == target_day && feed_tm->tm_year == target_year) {
-            char entry[128];
-            snprintf(entry, sizeof(entry), "%02d:%02d - Fed",
-                     feed_tm->tm_hour, feed_tm->tm_min);
-            lv_list_add_text(list, entry);
-            has_activity = true;
-        }
-    }
-    
-    // Check water log - search all entries for matching day
-    for (int i = 0; i < LOG_DAYS; i++) {
-        if (water_change_log[i].timestamp == 0) continue;
-        struct tm water_tm_buf;
-        struct tm *water_tm = localtime_r(&water_change_log[i].timestamp, &water_tm_buf);
-        if (water_tm->tm_yday == target_day && water_tm->tm_year == target_year) {
-            char entry[128];
-            snprintf(entry, sizeof(entry), "%02d:%02d - Water change",
-                     water_tm->tm_hour, water_tm->tm_min);
-            lv_list_add_text(list, entry);
-            has_activity = true;
-        }
-    }
-    
-    // Check parameter log - search all entries for matching day
-    for (int i = 0; i < LOG_DAYS; i++) {
-        if (param_log[i].timestamp == 0) continue;
-        struct tm param_tm_buf;
-        struct tm *param_tm = localtime_r(&param_log[i].timestamp, &param_tm_buf);
-        if (param_tm->tm_yday == target_day && param_tm->tm_year == target_year) {
-            char entry[256];
-            snprintf(entry, sizeof(entry), 
-                     "%02d:%02d - Parameters: NH3:%.2f NO3:%.2f NO2:%.2f pH:%.1f-%.1f",
-                     param_tm->tm_hour, param_tm->tm_min,
-                     param_log[i].ammonia, param_log[i].nitrate, param_log[i].nitrite,
-                     param_log[i].low_ph, param_log[i].high_ph);
-            lv_list_add_text(list, entry);
-            has_activity = true;
-        }
-    }
+    // Add label
+    lv_obj_t *label = lv_label_create(btn);
+    lv_label_set_text(label, label_text);
+    lv_obj_add_style(label, ui_style(UI_STYLE_ROUND_BTN_LABEL), LV_PART_MAIN);
+    lv_obj_center(label);
     
-    if (!has_activity) {
-        lv_list_add_text(list, "No activity recorded for this day");
+    return btn;
+}
+
+void dashboard_set_panel(esp_lcd_panel_handle_t panel, esp_lcd_panel_io_handle_t io)
+{
+    panel_blit_init(panel, io);
+}
+
+void dashboard_set_idle(bool idle)
+{
+    if (static_frame_timer == NULL) {
+        return;
     }
-    
-    // Section 2: Planned Activity (Right side - only show for today and future days)
-    time_t now = time(NULL);
-    struct tm now_tm;
-    localtime_r(&now, &now_tm);
-    now_tm.tm_hour = 0;
-    now_tm.tm_min = 0;
-    now_tm.tm_sec = 0;
-    time_t today_start = mktime(&now_tm);
-    
-    // Only show planned activity for today or future dates
-    if (target_date >= today_start) {
-        lv_obj_t *section2_title = lv_label_create(popup_history);
-        lv_label_set_text(section2_title, "Planned Activity");
-        lv_obj_set_style_text_font(section2_title, &lv_font_montserrat_14, 0);
-        lv_obj_set_style_text_color(section2_title, lv_palette_main(LV_PALETTE_ORANGE), 0);
-        lv_obj_set_pos(section2_title, 230, 50);
-        
-        lv_obj_t *plan_list = lv_list_create(popup_history);
-        lv_obj_set_size(plan_list, 210, 125);
-        lv_obj_set_pos(plan_list, 230, 75);
-        
-        // Show feed schedule from stored configuration
-        lv_list_add_text(plan_list, "Feed Schedule:");
-        bool has_feed_schedule = false;
-        for (int i = 0; i < MAX_FEED_TIMES; i++) {
-            if (planned_feed_times[i].enabled) {
-                char feed_entry[64];
-                snprintf(feed_entry, sizeof(feed_entry), "  %02d:%02d - Feed time", 
-                         planned_feed_times[i].hour, planned_feed_times[i].minute);
-                lv_list_add_text(plan_list, feed_entry);
-                has_feed_schedule = true;
-            }
-        }
-        if (!has_feed_schedule) {
-            lv_list_add_text(plan_list, "  No feed schedule configured");
-        }
-        
-        // Show water change schedule based on most recent change and planned interval
-        // Find the most recent water change
-        time_t last_water_change_time = 0;
-        for (int i = 0; i < LOG_DAYS; i++) {
-            if (water_change_log[i].timestamp > last_water_change_time) {
-                last_water_change_time = water_change_log[i].timestamp;
-            }
-        }
-        
-        lv_list_add_text(plan_list, "");
-        if (planned_water_change_interval > 0) {
-            if (last_water_change_time > 0) {
-                // Calculate next due date
-                struct tm last_change_tm;
-                localtime_r(&last_water_change_time, &last_change_tm);
-                last_change_tm.tm_hour = 0;
-                last_change_tm.tm_min = 0;
-                last_change_tm.tm_sec = 0;
-                time_t last_change_day = mktime(&last_change_tm);
-                time_t next_due_date = last_change_day + (planned_water_change_interval * 86400);
-                
-                // Normalize target_date to start of day
-                struct tm target_day_tm = target_tm;
-                target_day_tm.tm_hour = 0;
-                target_day_tm.tm_min = 0;
-                target_day_tm.tm_sec = 0;
-                time_t target_day_start = mktime(&target_day_tm);
-                
-                if (target_day_start == next_due_date) {
-                    lv_list_add_text(plan_list, "Water change scheduled today");
-                } else {
-                    int days_diff = (next_due_date - target_day_start) / 86400;
-                    if (days_diff > 0) {
-                        char clean_info[64];
-                        snprintf(clean_info, sizeof(clean_info), "Next water change in %d days", days_diff);
-                        lv_list_add_text(plan_list, clean_info);
-                    } else if (days_diff < 0) {
-                        char clean_info[64];
-                        snprintf(clean_info, sizeof(clean_info), "Water change overdue by %d days", -days_diff);
-                        lv_list_add_text(plan_list, clean_info);
-                    }
-                }
-            } else {
-                // No water change recorded yet
-                lv_list_add_text(plan_list, "Water change scheduled");
-            }
-        } else {
-            lv_list_add_text(plan_list, "No water change schedule");
-        }
+    if (idle) {
+        lv_timer_pause(static_frame_timer);
+    } else {
+        // Carry on from the current frame instead of catching up the idle time
+        frame_pacer_restart(&anim_pacer, esp_timer_get_time());
+        lv_timer_resume(static_frame_timer);
     }
-    
-    lv_obj_t *btn_close = lv_btn_create(popup_history);
-    lv_obj_set_size(btn_close, 100, 40);
-    lv_obj_align(btn_close, LV_ALIGN_BOTTOM_MID, 0, -80);
-    lv_obj_t *label = lv_label_create(btn_close);
-    lv_label_set_text(label, "Close");
-    lv_obj_center(label);
-    lv_obj_add_event_cb(btn_close, [](lv_event_t *e) {
-        if (popup_history) { lv_obj_del(popup_history); popup_history = NULL; }
-    }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_move_foreground(popup_history);
 }
 
-/**
- * @brief Show parameter log history
- */
-static void show_param_history_cb(lv_event_t *e) {
-    if (popup_history) return;
-    
-    popup_history = lv_obj_create(panel_content);
-    lv_obj_set_size(popup_history, 450, 300);
-    lv_obj_center(popup_history);
-    lv_obj_set_style_bg_color(popup_history, lv_color_hex(0x1a1a1a), 0);
-    
-    lv_obj_t *title = lv_label_create(popup_history);
-    lv_label_set_text(title, "Parameter History (7 Days)");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_16, 0);
-    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
-    
-    lv_obj_t *list = lv_list_create(popup_history);
-    lv_obj_set_size(list, 430, 220);
-    lv_obj_align(list, LV_ALIGN_TOP_MID, 0, 40);
-    
-    for (int i = 0; i < LOG_DAYS; i++) {
-        if (param_log[i].timestamp == 0) continue;
-        
-        char entry[256];
-        struct tm *timeinfo = localtime(&param_log[i].timestamp);
-        snprintf(entry, sizeof(entry), 
-                 "%02d/%02d %02d:%02d - NH3:%.2f NO3:%.2f NO2:%.2f pH:%.1f-%.1f",
-                 timeinfo->tm_mon + 1, timeinfo->tm_mday,
-                 timeinfo->tm_hour, timeinfo->tm_min,
-                 param_log[i].ammonia, param_log[i].nitrate, param_log[i].nitrite,
-                 param_log[i].low_ph, param_log[i].high_ph);
-        lv_list_add_text(list, entry);
-    }
-    
-    lv_obj_t *btn_close = lv_btn_create(popup_history);
-    lv_obj_set_size(btn_close, 100, 40);
-    lv_obj_align(btn_close, LV_ALIGN_BOTTOM_MID, 0, -10);
-    lv_obj_t *label = lv_label_create(btn_close);
-    lv_label_set_text(label, "Close");
-    lv_obj_center(label);
-    lv_obj_add_event_cb(btn_close, [](lv_event_t *e) {
-        if (popup_history) { lv_obj_del(popup_history); popup_history = NULL; }
-    }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_move_foreground(popup_history);
+void dashboard_scroll_step(int dir)
+{
+    if (scroll_container == NULL || dir == 0 || panel_popup_open()) {
+        return;
+    }
+    // lv_obj_scroll_by moves the content: a negative y reveals what is below
+    lv_obj_scroll_by_bounded(scroll_container, 0, dir > 0 ? -DASHBOARD_SCROLL_STEP : DASHBOARD_SCROLL_STEP, LV_ANIM_ON);
 }
 
 /**
- * @brief Show water change log history
+ * @brief Take the feeding / water change defaults of a species profile
  */
-static void show_water_history_cb(lv_event_t *e) {
-    if (popup_history) return;
-    
-    popup_history = lv_obj_create(panel_content);
-    lv_obj_set_size(popup_history, 450, 300);
-    lv_obj_center(popup_history);
-    lv_obj_set_style_bg_color(popup_history, lv_color_hex(0x1a1a1a), 0);
-    
-    lv_obj_t *title = lv_label_create(popup_history);
-    lv_label_set_text(title, "Water Button History (7 Days)");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_16, 0);
-    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
-    
-    lv_obj_t *list = lv_list_create(popup_history);
-    lv_obj_set_size(list, 430, 220);
-    lv_obj_align(list, LV_ALIGN_TOP_MID, 0, 40);
-    
-    for (int i = 0; i < LOG_DAYS; i++) {
-        if (water_change_log[i].timestamp == 0) continue;
-        
-        char entry[128];
-        struct tm *timeinfo = localtime(&water_change_log[i].timestamp);
-        snprintf(entry, sizeof(entry), "%02d/%02d %02d:%02d - Water button click",
-                 timeinfo->tm_mon + 1, timeinfo->tm_mday,
-                 timeinfo->tm_hour, timeinfo->tm_min);
-        lv_list_add_text(list, entry);
-    }
-    
-    lv_obj_t *btn_close = lv_btn_create(popup_history);
-    lv_obj_set_size(btn_close, 100, 40);
-    lv_obj_align(btn_close, LV_ALIGN_BOTTOM_MID, 0, -10);
-    lv_obj_t *label = lv_label_create(btn_close);
-    lv_label_set_text(label, "Close");
-    lv_obj_center(label);
-    lv_obj_add_event_cb(btn_close, [](lv_event_t *e) {
-        if (popup_history) { lv_obj_del(popup_history); popup_history = NULL; }
-    }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_move_foreground(popup_history);
+static void apply_profile_defaults(tank_t *t, const mood_preset_t *profile)
+{
+    if (profile->feed_interval_s > 0) {
+        t->planned_feed_interval = profile->feed_interval_s;
+    }
+    if (profile->water_change_days > 0) {
+        t->planned_water_change_interval = profile->water_change_days;
+    }
+    ESP_LOGI(TAG, "Profile '%s': feed every %lu min, water change every %lu days",
+             profile->name, (unsigned long)(t->planned_feed_interval / 60),
+             (unsigned long)t->planned_water_change_interval);
 }
 
 /**
- * @brief Show feed log history
+ * @brief dash_state collect callback: everything that survives a reboot
  */
-static void show_feed_history_cb(lv_event_t *e) {
-    if (popup_history) return;
-    
-    popup_history = lv_obj_create(panel_content);
-    lv_obj_set_size(popup_history, 450, 300);
-    lv_obj_center(popup_history);
-    lv_obj_set_style_bg_color(popup_history, lv_color_hex(0x1a1a1a), 0);
-    
-    lv_obj_t *title = lv_label_create(popup_history);
-    lv_label_set_text(title, "Feed Button History (7 Days)");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_16, 0);
-    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
-    
-    lv_obj_t *list = lv_list_create(popup_history);
-    lv_obj_set_size(list, 430, 220);
-    lv_obj_align(list, LV_ALIGN_TOP_MID, 0, 40);
-    
-    for (int i = 0; i < LOG_DAYS; i++) {
-        if (feed_log_data[i].timestamp == 0) continue;
-        
-        char entry[128];
-        struct tm *timeinfo = localtime(&feed_log_data[i].timestamp);
-        snprintf(entry, sizeof(entry), "%02d/%02d %02d:%02d - Feed button click",
-                 timeinfo->tm_mon + 1, timeinfo->tm_mday,
-                 timeinfo->tm_hour, timeinfo->tm_min);
-        lv_list_add_text(list, entry);
-    }
-    
-    lv_obj_t *btn_close = lv_btn_create(popup_history);
-    lv_obj_set_size(btn_close, 100, 40);
-    lv_obj_align(btn_close, LV_ALIGN_BOTTOM_MID, 0, -10);
-    lv_obj_t *label = lv_label_create(btn_close);
-    lv_label_set_text(label, "Close");
-    lv_obj_center(label);
-    lv_obj_add_event_cb(btn_close, [](lv_event_t *e) {
-        if (popup_history) { lv_obj_del(popup_history); popup_history = NULL; }
-    }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_move_foreground(popup_history);
+static void collect_dash_state(uint8_t id, dash_state_t *out)
+{
+    const tank_t *t = tank_get(id);
+    uint32_t current_time = time_svc_uptime_s();
+    time_t wall = time(NULL);
+    out->ammonia_ppm = t->ammonia_ppm;
+    out->nitrite_ppm = t->nitrite_ppm;
+    out->nitrate_ppm = t->nitrate_ppm;
+    out->ph_level = t->ph_level;
+    out->saved_wall = (wall >= HISTORY_STORE_MIN_VALID_TIME) ? (uint32_t)wall : 0;
+    out->feed_age_s = current_time - t->last_feed_time;
+    out->clean_age_s = current_time - t->last_clean_time;
+    out->planned_feed_interval = t->planned_feed_interval;
+    out->planned_water_change_interval = t->planned_water_change_interval;
+    out->feeds_per_day = t->feeds_per_day;
+    out->water_interval_days = t->water_interval_days;
+    for (int i = 0; i < MAX_FEED_TIMES; i++) {
+        out->feed_times[i].hour = t->feed_times[i].hour;
+        out->feed_times[i].minute = t->feed_times[i].minute;
+        out->feed_times[i].enabled = t->feed_times[i].enabled;
+    }
 }
 
 /**
- * @brief Create and show monthly calendar popup
+ * @brief Apply the state saved before the last reboot (one NVS read)
+ *
+ * Ages become uptime timestamps; the off time is added now if the clock
+ * is set, otherwise from date_refresh() once it is.
  */
-static void show_monthly_calendar(void) {
-    if (popup_monthly_cal) {
-        lv_obj_del(popup_monthly_cal);
-        popup_monthly_cal = NULL;
+static void restore_dash_state(tank_t *t)
+{
+    dash_state_t st;
+    if (!dash_state_load(t->id, &st)) {
+        ESP_LOGI(TAG, "No saved state of tank %u - using defaults", (unsigned)t->id + 1);
+        return;
     }
-    
-    time_t now_time = time(NULL);
-    struct tm now_tm;
-    localtime_r(&now_time, &now_tm);
-    
-    if (monthly_cal_display_month == 0) {
-        monthly_cal_display_month = now_tm.tm_mon + 1;
-        monthly_cal_display_year = now_tm.tm_year + 1900;
-    }
-    
-    popup_monthly_cal = lv_obj_create(lv_scr_act());
-    lv_obj_set_size(popup_monthly_cal, 480, 320);
-    lv_obj_set_pos(popup_monthly_cal, 0, 0);
-    lv_obj_set_style_bg_color(popup_monthly_cal, lv_color_hex(0x000000), 0);
-    lv_obj_set_style_bg_opa(popup_monthly_cal, LV_OPA_90, 0);
-    lv_obj_set_style_shadow_width(popup_monthly_cal, 0, 0);
-    lv_obj_clear_flag(popup_monthly_cal, LV_OBJ_FLAG_SCROLLABLE);
-    
-    lv_obj_t *cal_container = lv_obj_create(popup_monthly_cal);
-    lv_obj_set_size(cal_container, 460, 300);
-    lv_obj_center(cal_container);
-    lv_obj_set_style_bg_color(cal_container, lv_color_hex(0x1a1a1a), 0);
-    lv_obj_set_style_border_color(cal_container, lv_palette_main(LV_PALETTE_BLUE), 0);
-    lv_obj_set_style_border_width(cal_container, 2, 0);
-    lv_obj_set_style_radius(cal_container, 10, 0);
-    lv_obj_set_style_shadow_width(cal_container, 0, 0);
-    lv_obj_clear_flag(cal_container, LV_OBJ_FLAG_SCROLLABLE);
-    
-    lv_obj_t *title_cont = lv_obj_create(cal_container);
-    lv_obj_set_size(title_cont, 440, 40);
-    lv_obj_set_pos(title_cont, 10, 5);
-    lv_obj_set_style_bg_opa(title_cont, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_border_width(title_cont, 0, 0);
-    lv_obj_clear_flag(title_cont, LV_OBJ_FLAG_SCROLLABLE);
-    
-    lv_obj_t *btn_prev = lv_btn_create(title_cont);
-    lv_obj_set_size(btn_prev, 35, 35);
-    lv_obj_align(btn_prev, LV_ALIGN_LEFT_MID, 0, 0);
-    lv_obj_set_style_bg_color(btn_prev, lv_color_hex(0x333333), 0);
-    lv_obj_add_event_cb(btn_prev, [](lv_event_t *e) {
-        if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
-            monthly_cal_display_month--;
-            if (monthly_cal_display_month < 1) {
-                monthly_cal_display_month = 12;
-                monthly_cal_display_year--;
-            }
-            // show_monthly_calendar();  // Disabled
-        }
-    }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *prev_label = lv_label_create(btn_prev);
-    lv_label_set_text(prev_label, LV_SYMBOL_LEFT);
-    lv_obj_center(prev_label);
-    
-    lv_obj_t *title_label = lv_label_create(title_cont);
-    const char *month_names[] = {"", "January", "February", "March", "April", "May", "June",
-                                  "July", "August", "September", "October", "November", "December"};
-    char title_text[50];
-    snprintf(title_text, sizeof(title_text), "%s %d", 
-             month_names[monthly_cal_display_month], monthly_cal_display_year);
-    lv_label_set_text(title_label, title_text);
-    lv_obj_set_style_text_font(title_label, &lv_font_montserrat_20, 0);
-    lv_obj_set_style_text_color(title_label, lv_color_white(), 0);
-    lv_obj_align(title_label, LV_ALIGN_CENTER, 0, 0);
-    
-    lv_obj_t *btn_next = lv_btn_create(title_cont);
-    lv_obj_set_size(btn_next, 35, 35);
-    lv_obj_align(btn_next, LV_ALIGN_RIGHT_MID, 0, 0);
-    lv_obj_set_style_bg_color(btn_next, lv_color_hex(0x333333), 0);
-    lv_obj_add_event_cb(btn_next, [](lv_event_t *e) {
-        if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
-            monthly_cal_display_month++;
-            if (monthly_cal_display_month > 12) {
-                monthly_cal_display_month = 1;
-                monthly_cal_display_year++;
-            }
-            // show_monthly_calendar();  // Disabled
-        }
-    }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *next_label = lv_label_create(btn_next);
-    lv_label_set_text(next_label, LV_SYMBOL_RIGHT);
-    lv_obj_center(next_label);
-    
-    const char *day_headers[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
-    int header_y = 50;
-    int cell_width = 60;
-    int cell_height = 38;
-    
-    for (int i = 0; i < 7; i++) {
-        lv_obj_t *header = lv_label_create(cal_container);
-        lv_label_set_text(header, day_headers[i]);
-        lv_obj_set_pos(header, 15 + (i * cell_width), header_y);
-        lv_obj_set_style_text_font(header, &lv_font_montserrat_12, 0);
-        lv_obj_set_style_text_color(header, lv_palette_main(LV_PALETTE_BLUE), 0);
+    t->ammonia_ppm = st.ammonia_ppm;
+    t->nitrite_ppm = st.nitrite_ppm;
+    t->nitrate_ppm = st.nitrate_ppm;
+    t->ph_level = st.ph_level;
+    if (st.planned_feed_interval > 0) t->planned_feed_interval = st.planned_feed_interval;
+    if (st.planned_water_change_interval > 0) t->planned_water_change_interval = st.planned_water_change_interval;
+    if (st.feeds_per_day > 0) t->feeds_per_day = st.feeds_per_day;
+    if (st.water_interval_days > 0) t->water_interval_days = st.water_interval_days;
+    for (int i = 0; i < MAX_FEED_TIMES; i++) {
+        t->feed_times[i].hour = st.feed_times[i].hour % 24;
+        t->feed_times[i].minute = st.feed_times[i].minute % 60;
+        t->feed_times[i].enabled = st.feed_times[i].enabled != 0;
+    }
+
+    uint32_t off_s = 0;
+    time_t wall = time(NULL);
+    if (st.saved_wall != 0 && wall >= HISTORY_STORE_MIN_VALID_TIME && (uint32_t)wall > st.saved_wall) {
+        off_s = (uint32_t)wall - st.saved_wall;
+    } else if (st.saved_wall != 0) {
+        t->saved_wall = st.saved_wall;  // Corrected once the clock is set
+    }
+    // Unsigned wrap-around: "now - last_*" stays the age even before uptime reaches it
+    uint32_t current_time = time_svc_uptime_s();
+    t->last_feed_time = current_time - (st.feed_age_s + off_s);
+    t->last_clean_time = current_time - (st.clean_age_s + off_s);
+    t->restored_feed = t->last_feed_time;
+    t->restored_clean = t->last_clean_time;
+
+    ESP_LOGI(TAG, "Tank %u state restored: fed %.1fh, water changed %.1fd ago", (unsigned)t->id + 1,
+             (st.feed_age_s + off_s) / 3600.0f, (st.clean_age_s + off_s) / 86400.0f);
+}
+
+bool dashboard_set_profile(const char *name)
+{
+    if (!mood_profiles_select(name, true)) {
+        return false;
     }
-    
-    struct tm first_day = {};
-    first_day.tm_year = monthly_cal_display_year - 1900;
-    first_day.tm_mon = monthly_cal_display_month - 1;
-    first_day.tm_mday = 1;
-    mktime(&first_day);
-    
-    int first_weekday = first_day.tm_wday;
-    
-    struct tm last_day = first_day;
-    last_day.tm_mon++;
-    last_day.tm_mday = 0;
-    mktime(&last_day);
-    int days_in_month = last_day.tm_mday;
-    
-    time_t today_time = time(NULL);
-    struct tm today_tm;
-    localtime_r(&today_time, &today_tm);
-    
-    int grid_y = header_y + 25;
-    int day_num = 1;
-    
-    for (int row = 0; row < 6 && day_num <= days_in_month; row++) {
-        // Yield to other tasks every row to prevent watchdog timeout
-        vTaskDelay(pdMS_TO_TICKS(1));
-        
-        for (int col = 0; col < 7; col++) {
-            if (row == 0 && col < first_weekday) continue;
-            if (day_num > days_in_month) break;
-            
-            lv_obj_t *day_cell = lv_obj_create(cal_container);
-            lv_obj_set_size(day_cell, cell_width - 5, cell_height - 3);
-            lv_obj_set_pos(day_cell, 10 + (col * cell_width), grid_y + (row * cell_height));
-            
-            bool is_today = (day_num == today_tm.tm_mday && 
-                           monthly_cal_display_month == today_tm.tm_mon + 1 &&
-                           monthly_cal_display_year == today_tm.tm_year + 1900);
-            
-            if (is_today) {
-                lv_obj_set_style_bg_color(day_cell, lv_color_hex(0x004080), 0);
-                lv_obj_set_style_border_color(day_cell, lv_palette_main(LV_PALETTE_BLUE), 0);
-                lv_obj_set_style_border_width(day_cell, 2, 0);
-            } else {
-                lv_obj_set_style_bg_color(day_cell, lv_color_hex(0x2a2a2a), 0);
-                lv_obj_set_style_border_color(day_cell, lv_color_hex(0x4a4a4a), 0);
-                lv_obj_set_style_border_width(day_cell, 1, 0);
-            }
-            lv_obj_set_style_radius(day_cell, 3, 0);
-            lv_obj_set_style_shadow_width(day_cell, 0, 0);
-            lv_obj_clear_flag(day_cell, LV_OBJ_FLAG_SCROLLABLE);
-            
-            lv_obj_t *day_label = lv_label_create(day_cell);
-            char day_text[4];
-            snprintf(day_text, sizeof(day_text), "%d", day_num);
-            lv_label_set_text(day_label, day_text);
-            lv_obj_set_style_text_font(day_label, &lv_font_montserrat_12, 0);
-            lv_obj_set_style_text_color(day_label, lv_color_white(), 0);
-            lv_obj_align(day_label, LV_ALIGN_TOP_MID, 0, 2);
-            
-            struct tm this_day = {};
-            this_day.tm_year = monthly_cal_display_year - 1900;
-            this_day.tm_mon = monthly_cal_display_month - 1;
-            this_day.tm_mday = day_num;
-            time_t day_timestamp = mktime(&this_day);
-            
-            struct tm day_tm;
-            localtime_r(&day_timestamp, &day_tm);
-            
-            bool water_done = false;
-            for (int j = 0; j < LOG_DAYS; j++) {
-                if (water_change_log[j].timestamp == 0) continue;
-                struct tm water_tm_buf;
-                struct tm *water_tm = localtime_r(&water_change_log[j].timestamp, &water_tm_buf);
-                if (water_tm->tm_yday == day_tm.tm_yday && water_tm->tm_year == day_tm.tm_year) {
-                    water_done = true;
-                    break;
-                }
-            }
-            
-            bool water_planned = false;
-            if (planned_water_change_interval > 0) {
-                time_t last_water_change_time = 0;
-                for (int j = 0; j < LOG_DAYS; j++) {
-                    if (water_change_log[j].timestamp > last_water_change_time) {
-                        last_water_change_time = water_change_log[j].timestamp;
-                    }
-                }
-                
-                if (last_water_change_time > 0) {
-                    struct tm last_change_tm;
-                    localtime_r(&last_water_change_time, &last_change_tm);
-                    last_change_tm.tm_hour = 0;
-                    last_change_tm.tm_min = 0;
-                    last_change_tm.tm_sec = 0;
-                    time_t last_change_day = mktime(&last_change_tm);
-                    time_t next_due_date = last_change_day + (planned_water_change_interval * 86400);
-                    
-                    struct tm day_start_tm = day_tm;
-                    day_start_tm.tm_hour = 0;
-                    day_start_tm.tm_min = 0;
-                    day_start_tm.tm_sec = 0;
-                    time_t day_start = mktime(&day_start_tm);
-                    
-                    struct tm today_start_tm = today_tm;
-                    today_start_tm.tm_hour = 0;
-                    today_start_tm.tm_min = 0;
-                    today_start_tm.tm_sec = 0;
-                    time_t today_start = mktime(&today_start_tm);
-                    
-                    if (day_start == next_due_date || (day_start == today_start && today_start > next_due_date)) {
-                        water_planned = true;
-                    }
-                }
-            }
-            
-            if (water_done) {
-                lv_obj_t *water_dot = lv_obj_create(day_cell);
-                lv_obj_set_size(water_dot, 5, 5);
-                lv_obj_align(water_dot, LV_ALIGN_BOTTOM_MID, 0, -2);
-                lv_obj_set_style_bg_color(water_dot, lv_palette_main(LV_PALETTE_CYAN), 0);
-                lv_obj_set_style_bg_opa(water_dot, LV_OPA_COVER, 0);
-                lv_obj_set_style_border_width(water_dot, 0, 0);
-                lv_obj_set_style_radius(water_dot, LV_RADIUS_CIRCLE, 0);
-                lv_obj_clear_flag(water_dot, LV_OBJ_FLAG_SCROLLABLE);
-            } else if (water_planned) {
-                lv_obj_t *water_dot = lv_obj_create(day_cell);
-                lv_obj_set_size(water_dot, 5, 5);
-                lv_obj_align(water_dot, LV_ALIGN_BOTTOM_MID, 0, -2);
-                lv_obj_set_style_bg_opa(water_dot, LV_OPA_TRANSP, 0);
-                lv_obj_set_style_border_color(water_dot, lv_palette_main(LV_PALETTE_CYAN), 0);
-                lv_obj_set_style_border_width(water_dot, 1, 0);
-                lv_obj_set_style_radius(water_dot, LV_RADIUS_CIRCLE, 0);
-                lv_obj_clear_flag(water_dot, LV_OBJ_FLAG_SCROLLABLE);
-            }
-            
-            int planned_feed_count = 0;
-            for (int j = 0; j < MAX_FEED_TIMES; j++) {
-                if (planned_feed_times[j].enabled) {
-                    planned_feed_count++;
-                }
-            }
-            
-            int logged_feed_count = 0;
-            for (int j = 0; j < LOG_DAYS; j++) {
-                if (feed_log_data[j].timestamp == 0) continue;
-                struct tm feed_tm_buf;
-                struct tm *feed_tm = localtime_r(&feed_log_data[j].timestamp, &feed_tm_buf);
-                if (feed_tm->tm_yday == day_tm.tm_yday && feed_tm->tm_year == day_tm.tm_year) {
-                    logged_feed_count++;
-                }
-            }
-            
-            int total_feeds = (logged_feed_count > planned_feed_count) ? logged_feed_count : planned_feed_count;
-            if (total_feeds > 3) total_feeds = 3;
-            
-            if (total_feeds > 0) {
-                int dot_spacing = 7;
-                int total_width = (total_feeds * 5) + ((total_feeds - 1) * 2);
-                int start_x = (cell_width - 5 - total_width) / 2;
-                
-                for (int j = 0; j < total_feeds; j++) {
-                    lv_obj_t *feed_dot = lv_obj_create(day_cell);
-                    lv_obj_set_size(feed_dot, 5, 5);
-                    lv_obj_set_pos(feed_dot, start_x + (j * dot_spacing), 17);
-                    
-                    if (j < logged_feed_count) {
-                        lv_obj_set_style_bg_color(feed_dot, lv_palette_main(LV_PALETTE_RED), 0);
-                        lv_obj_set_style_bg_opa(feed_dot, LV_OPA_COVER, 0);
-                        lv_obj_set_style_border_width(feed_dot, 0, 0);
-                    } else {
-                        lv_obj_set_style_bg_opa(feed_dot, LV_OPA_TRANSP, 0);
-                        lv_obj_set_style_border_color(feed_dot, lv_palette_main(LV_PALETTE_RED), 0);
-                        lv_obj_set_style_border_width(feed_dot, 1, 0);
-                    }
-                    lv_obj_set_style_radius(feed_dot, LV_RADIUS_CIRCLE, 0);
-                    lv_obj_clear_flag(feed_dot, LV_OBJ_FLAG_SCROLLABLE);
-                }
-            }
-            
-            lv_obj_add_flag(day_cell, LV_OBJ_FLAG_CLICKABLE);
-            lv_obj_set_user_data(day_cell, (void*)(intptr_t)day_timestamp);
-            lv_obj_add_event_cb(day_cell, [](lv_event_t *e) {
-                if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
-                    time_t day_ts = (time_t)(intptr_t)lv_obj_get_user_data(lv_event_get_target(e));
-                    show_day_history(day_ts);
-                }
-            }, LV_EVENT_CLICKED, NULL);
-            
-            day_num++;
-        }
+    // The profile is the device's: every tank takes its care intervals
+    for (uint8_t i = 0; i < TANK_MAX; i++) {
+        apply_profile_defaults(tank_get(i), mood_engine_preset());
+        dash_state_changed(tank_get(i));
+        evaluate_and_update_mood(tank_get(i));
     }
-    
-    lv_obj_t *close_btn = lv_btn_create(cal_container);
-    lv_obj_set_size(close_btn, 60, 30);
-    lv_obj_align(close_btn, LV_ALIGN_BOTTOM_MID, 0, -5);
-    lv_obj_set_style_bg_color(close_btn, lv_color_hex(0x555555), 0);
-    lv_obj_add_event_cb(close_btn, [](lv_event_t *e) {
-        if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
-            if (popup_monthly_cal) {
-                lv_obj_del(popup_monthly_cal);
-                popup_monthly_cal = NULL;
-            }
-        }
-    }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *close_label = lv_label_create(close_btn);
-    lv_label_set_text(close_label, "Close");
-    lv_obj_set_style_text_color(close_label, lv_color_white(), 0);
-    lv_obj_center(close_label);
+    refresh_weekly_calendar_dots();
+    return true;
 }
 
+// Side panel layout (panel_content coordinates)
+#define WEEK_Y              10
+#define WEEK_HEIGHT         60
+#define WEEK_DAY_WIDTH      55
+#define WEEK_DAY_SPACING    5
+#define PANEL_CONTENT_WIDTH 405    // Usable content area
+#define CALENDAR_Y          (WEEK_Y + WEEK_HEIGHT + 15)
+
 /**
- * @brief Create parameter log popup with 5 input fields
+ * @brief One day box of the 7-day week strip (current day in the middle, index 3)
  */
-static void create_param_popup(void) {
-    if (popup_param) return;
-    
-    popup_param = lv_obj_create(panel_content);
-    lv_obj_set_size(popup_param, 460, 310);
-    lv_obj_center(popup_param);
-    lv_obj_set_style_bg_color(popup_param, lv_color_hex(0x1a1a3a), 0);
-    lv_obj_set_style_border_color(popup_param, lv_palette_main(LV_PALETTE_BLUE), 0);
-    lv_obj_set_style_border_width(popup_param, 2, 0);
-    
-    lv_obj_t *title = lv_label_create(popup_param);
-    lv_label_set_text(title, LV_SYMBOL_EDIT " Parameter Log");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_16, 0);
-    lv_obj_set_style_text_color(title, lv_color_white(), 0);
-    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
-    
-    const char *param_names[] = {"Ammonia (ppm)", "Nitrate (ppm)", "Nitrite (ppm)", "pH", "pH (unused)"};
-    // Load current dashboard values (not from log history)
-    float latest_values[] = {
-        ammonia_ppm,     // Current ammonia value
-        nitrate_ppm,     // Current nitrate value
-        nitrite_ppm,     // Current nitrite value
-        ph_level,        // Current pH value
-        ph_level         // Placeholder (only one pH field needed)
-    };
-    
-    for (int i = 0; i < 5; i++) {
-        lv_obj_t *label = lv_label_create(popup_param);
-        lv_label_set_text(label, param_names[i]);
-        lv_obj_set_style_text_color(label, lv_color_white(), 0);
-        lv_obj_align(label, LV_ALIGN_TOP_LEFT, 20, 50 + i * 38);
-        
-        lv_obj_t *input = lv_textarea_create(popup_param);
-        lv_obj_set_size(input, 100, 32);
-        lv_obj_align(input, LV_ALIGN_TOP_RIGHT, -20, 45 + i * 38);
-        lv_textarea_set_one_line(input, true);
-        
-        // Set to latest saved value or 0.0 if no data
-        char val_str[16];
-        snprintf(val_str, sizeof(val_str), "%.2f", latest_values[i]);
-        lv_textarea_set_text(input, val_str);
-        
-        lv_obj_add_event_cb(input, input_field_event_cb, LV_EVENT_CLICKED, NULL);
-    }
-    
-    lv_obj_t *btn_hist = lv_btn_create(popup_param);
-    lv_obj_set_size(btn_hist, 80, 40);
-    lv_obj_align(btn_hist, LV_ALIGN_BOTTOM_LEFT, 20, -10);
-    lv_obj_t *label_hist = lv_label_create(btn_hist);
-    lv_label_set_text(label_hist, "History");
-    lv_obj_center(label_hist);
-    lv_obj_add_event_cb(btn_hist, show_param_history_cb, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *btn_save = lv_btn_create(popup_param);
-    lv_obj_set_size(btn_save, 100, 40);
-    lv_obj_align(btn_save, LV_ALIGN_BOTTOM_MID, 0, -10);
-    lv_obj_t *label_save = lv_label_create(btn_save);
-    lv_label_set_text(label_save, "Save");
-    lv_obj_center(label_save);
-    lv_obj_add_event_cb(btn_save, save_param_log_cb, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *btn_close = lv_btn_create(popup_param);
-    lv_obj_set_size(btn_close, 100, 40);
-    lv_obj_align(btn_close, LV_ALIGN_BOTTOM_RIGHT, -20, -10);
-    lv_obj_t *label_close = lv_label_create(btn_close);
-    lv_label_set_text(label_close, "Close");
-    lv_obj_center(label_close);
-    lv_obj_add_event_cb(btn_close, [](lv_event_t *e) { close_popup(); }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_move_foreground(popup_param);
-}
-
-/**
- * @brief Create water change log popup
- */
-static void create_water_popup(void) {
-    if (popup_water) return;
-    
-    popup_water = lv_obj_create(panel_content);
-    lv_obj_set_size(popup_water, 400, 220);
-    lv_obj_center(popup_water);
-    lv_obj_set_style_bg_color(popup_water, lv_color_hex(0x1a1a3a), 0);
-    lv_obj_set_style_border_color(popup_water, lv_palette_main(LV_PALETTE_CYAN), 0);
-    lv_obj_set_style_border_width(popup_water, 2, 0);
-    
-    lv_obj_t *title = lv_label_create(popup_water);
-    lv_label_set_text(title, LV_SYMBOL_REFRESH " Water Change Log");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_16, 0);
-    lv_obj_set_style_text_color(title, lv_color_white(), 0);
-    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
-    
-    lv_obj_t *label = lv_label_create(popup_water);
-    lv_label_set_text(label, "Change water every (days):");
-    lv_obj_set_style_text_color(label, lv_color_white(), 0);
-    lv_obj_set_pos(label, 20, 60);
-    
-    lv_obj_t *input = lv_textarea_create(popup_water);
-    lv_obj_set_size(input, 80, 35);
-    lv_obj_set_pos(input, 280, 55);
-    lv_textarea_set_one_line(input, true);
-    
-    // Set to current planned interval
-    char val_str[16];
-    snprintf(val_str, sizeof(val_str), "%lu", (unsigned long)planned_water_change_interval);
-    lv_textarea_set_text(input, val_str);
-    
-    lv_obj_add_event_cb(input, input_field_event_cb, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *btn_hist = lv_btn_create(popup_water);
-    lv_obj_set_size(btn_hist, 80, 40);
-    lv_obj_align(btn_hist, LV_ALIGN_BOTTOM_LEFT, 20, -15);
-    lv_obj_t *label_hist = lv_label_create(btn_hist);
-    lv_label_set_text(label_hist, "History");
-    lv_obj_center(label_hist);
-    lv_obj_add_event_cb(btn_hist, show_water_history_cb, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *btn_save = lv_btn_create(popup_water);
-    lv_obj_set_size(btn_save, 120, 40);
-    lv_obj_align(btn_save, LV_ALIGN_BOTTOM_MID, 0, -15);
-    lv_obj_t *label_save = lv_label_create(btn_save);
-    lv_label_set_text(label_save, "Save Schedule");
-    lv_obj_center(label_save);
-    lv_obj_add_event_cb(btn_save, [](lv_event_t *e) {
-        lv_obj_t *popup = lv_event_get_current_target(e);
-        lv_obj_t *input = lv_obj_get_child(lv_obj_get_parent(popup), -4);
-        const char *text = lv_textarea_get_text(input);
-        int interval = atoi(text);
-        if (interval > 0 && interval <= 365) {
-            planned_water_change_interval = interval;
-            current_water_interval_days = interval;
-            ESP_LOGI(TAG, "Water change interval updated: %lu days", (unsigned long)planned_water_change_interval);
-            
-            // Save to SD card
-            save_water_change_to_sd(interval);
-            
-            // Refresh calendar dots to update hollow circles
-            refresh_weekly_calendar_dots();
+static void panel_build_day(int i)
+{
+    int total_week_width = (7 * WEEK_DAY_WIDTH) + (6 * WEEK_DAY_SPACING);  // 7 days + 6 gaps = 415px
+    int week_start_x = (PANEL_CONTENT_WIDTH - total_week_width) / 2;        // Center in content area
+    
+    // Calculate date for this day (3 days before to 3 days after)
+    time_t day_time = time(NULL) + ((i - 3) * 86400);
+    struct tm day_tm;
+    localtime_r(&day_time, &day_tm);
+    
+    // Create day box
+    lv_obj_t *day_box = lv_obj_create(panel_content);
+    week_day_boxes[i] = day_box;  // Store reference
+    lv_obj_set_size(day_box, WEEK_DAY_WIDTH, WEEK_HEIGHT);
+    lv_obj_set_pos(day_box, week_start_x + (i * (WEEK_DAY_WIDTH + WEEK_DAY_SPACING)), WEEK_Y);
+    
+    // Highlight current day with different color
+    if (i == 3) {
+        lv_obj_set_style_bg_color(day_box, lv_color_hex(0x3a4a5a), 0);  // Steel blue
+        lv_obj_set_style_border_color(day_box, lv_palette_main(LV_PALETTE_LIGHT_BLUE), 0);
+    } else {
+        lv_obj_set_style_bg_color(day_box, lv_color_hex(0x2a2a2a), 0);
+        lv_obj_set_style_border_color(day_box, lv_color_hex(0x4a4a4a), 0);
+    }
+    lv_obj_set_style_border_width(day_box, 2, 0);
+    lv_obj_set_style_radius(day_box, 5, 0);
+    lv_obj_clear_flag(day_box, LV_OBJ_FLAG_SCROLLABLE);
+    
+    // Day name (e.g., "MON")
+    static const char *day_names[] = {"SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT"};
+    lv_obj_t *day_name = lv_label_create(day_box);
+    week_day_names[i] = day_name;
+    lv_label_set_text_static(day_name, day_names[day_tm.tm_wday]);
+    lv_obj_set_style_text_font(day_name, ui_font(UI_FONT_12), 0);
+    lv_obj_add_style(day_name, ui_style(UI_STYLE_TEXT), 0);
+    lv_obj_align(day_name, LV_ALIGN_CENTER, 0, 0);
+    
+    // Activity dots are pooled - refresh_weekly_calendar_dots() fills them in
+    create_week_dot_pool(i);
+    
+    // Make clickable - store day timestamp in user data
+    lv_obj_add_flag(day_box, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_user_data(day_box, (void*)(intptr_t)day_time);
+    lv_obj_add_event_cb(day_box, [](lv_event_t *e) {
+        if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+            time_t day_timestamp = (time_t)(intptr_t)lv_obj_get_user_data(lv_event_get_target(e));
+            history_view_show_day(day_timestamp);
         }
-        close_popup(); 
     }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *btn_close = lv_btn_create(popup_water);
-    lv_obj_set_size(btn_close, 100, 40);
-    lv_obj_align(btn_close, LV_ALIGN_BOTTOM_RIGHT, -20, -15);
-    lv_obj_t *label_close = lv_label_create(btn_close);
-    lv_label_set_text(label_close, "Close");
-    lv_obj_center(label_close);
-    lv_obj_add_event_cb(btn_close, [](lv_event_t *e) { close_popup(); }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_move_foreground(popup_water);
 }
 
 /**
- * @brief Create feed log popup
+ * @brief Calendar card: day name, date number, month/year
  */
-static void create_feed_popup(void) {
-    if (popup_feed) return;
-    
-    popup_feed = lv_obj_create(panel_content);
-    lv_obj_set_size(popup_feed, 400, 320);
-    lv_obj_center(popup_feed);
-    lv_obj_set_style_bg_color(popup_feed, lv_color_hex(0x1a1a3a), 0);
-    lv_obj_set_style_border_color(popup_feed, lv_palette_main(LV_PALETTE_GREEN), 0);
-    lv_obj_set_style_border_width(popup_feed, 2, 0);
-    
-    lv_obj_t *title = lv_label_create(popup_feed);
-    lv_label_set_text(title, LV_SYMBOL_IMAGE " Feed Management");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_16, 0);
-    lv_obj_set_style_text_color(title, lv_color_white(), 0);
-    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
+static void panel_build_calendar(void)
+{
+    // Create calendar container
+    panel_calendar = lv_obj_create(panel_content);
+    lv_obj_set_size(panel_calendar, 150, 130);
+    lv_obj_set_pos(panel_calendar, 20, CALENDAR_Y);
+    lv_obj_set_style_bg_color(panel_calendar, lv_color_hex(0x1a1a1a), LV_PART_MAIN);
+    lv_obj_set_style_border_width(panel_calendar, 2, LV_PART_MAIN);
+    lv_obj_set_style_border_color(panel_calendar, lv_palette_main(LV_PALETTE_BLUE), LV_PART_MAIN);
+    lv_obj_set_style_radius(panel_calendar, 10, LV_PART_MAIN);
+    lv_obj_clear_flag(panel_calendar, LV_OBJ_FLAG_SCROLLABLE);
     
-    // Schedule section
-    lv_obj_t *schedule_label = lv_label_create(popup_feed);
-    lv_label_set_text(schedule_label, "Planned Schedule:");
-    lv_obj_set_style_text_color(schedule_label, lv_palette_main(LV_PALETTE_ORANGE), 0);
-    lv_obj_set_pos(schedule_label, 20, 45);
+    // Day name label (e.g., "Monday")
+    panel_day_label = lv_label_create(panel_calendar);
+    lv_obj_set_style_text_font(panel_day_label, ui_font(UI_FONT_16), LV_PART_MAIN);
+    lv_obj_set_style_text_color(panel_day_label, lv_palette_main(LV_PALETTE_BLUE), LV_PART_MAIN);
+    lv_label_set_text(panel_day_label, "---");
+    lv_obj_align(panel_day_label, LV_ALIGN_TOP_MID, 0, 10);
     
-    // Number of feeds input
-    lv_obj_t *feeds_label = lv_label_create(popup_feed);
-    lv_label_set_text(feeds_label, "Feeds per day:");
-    lv_obj_set_style_text_color(feeds_label, lv_color_white(), 0);
-    lv_obj_set_pos(feeds_label, 20, 75);
+    // Date number label (e.g., "23")
+    panel_date_label = lv_label_create(panel_calendar);
+    lv_obj_set_style_text_font(panel_date_label, ui_font(UI_FONT_32), LV_PART_MAIN);
+    lv_obj_set_style_text_color(panel_date_label, lv_color_white(), LV_PART_MAIN);
+    lv_label_set_text(panel_date_label, "--");
+    lv_obj_align(panel_date_label, LV_ALIGN_CENTER, 0, 5);
     
-    lv_obj_t *feeds_input = lv_textarea_create(popup_feed);
-    lv_obj_set_size(feeds_input, 60, 35);
-    lv_obj_set_pos(feeds_input, 150, 70);
-    lv_textarea_set_one_line(feeds_input, true);
+    // Month/Year label (e.g., "Dec 2025")
+    panel_month_label = lv_label_create(panel_calendar);
+    lv_obj_set_style_text_font(panel_month_label, ui_font(UI_FONT_14), LV_PART_MAIN);
+    lv_obj_set_style_text_color(panel_month_label, lv_palette_main(LV_PALETTE_GREY), LV_PART_MAIN);
+    lv_label_set_text(panel_month_label, "--- ----");
+    lv_obj_align(panel_month_label, LV_ALIGN_BOTTOM_MID, 0, -10);
     
-    // Count currently enabled feeds
-    int active_feeds = 0;
-    for (int i = 0; i < MAX_FEED_TIMES; i++) {
-        if (planned_feed_times[i].enabled) active_feeds++;
-    }
-    if (active_feeds == 0) active_feeds = 3; // Default
-    
-    char feeds_str[8];
-    snprintf(feeds_str, sizeof(feeds_str), "%d", active_feeds);
-    lv_textarea_set_text(feeds_input, feeds_str);
-    lv_obj_add_event_cb(feeds_input, input_field_event_cb, LV_EVENT_CLICKED, NULL);
-    
-    // Configure times button
-    lv_obj_t *btn_config = lv_btn_create(popup_feed);
-    lv_obj_set_size(btn_config, 150, 40);
-    lv_obj_set_pos(btn_config, 225, 70);
-    lv_obj_t *label_config = lv_label_create(btn_config);
-    lv_label_set_text(label_config, "Set Schedule");
-    lv_obj_center(label_config);
-    lv_obj_add_event_cb(btn_config, [](lv_event_t *e) {
-        lv_obj_t *input = (lv_obj_t *)lv_event_get_user_data(e);
-        const char *text = lv_textarea_get_text(input);
-        int num_feeds = atoi(text);
-        
-        if (num_feeds < 1) num_feeds = 1;
-        if (num_feeds > MAX_FEED_TIMES) num_feeds = MAX_FEED_TIMES;
-        
-        // Configure feed times based on number
-        // Define all time arrays outside the loop
-        const uint8_t times_1[] = {12};
-        const uint8_t times_2[] = {8, 20};
-        const uint8_t times_3[] = {8, 14, 20};
-        const uint8_t times_4[] = {7, 12, 17, 22};
-        const uint8_t times_5[] = {6, 10, 14, 18, 22};
-        const uint8_t times_6[] = {6, 9, 12, 15, 18, 21};
-        
-        for (int i = 0; i < MAX_FEED_TIMES; i++) {
-            if (i < num_feeds) {
-                // Select the appropriate time based on number of feeds
-                if (num_feeds == 1) {
-                    planned_feed_times[i].hour = times_1[i];
-                } else if (num_feeds == 2) {
-                    planned_feed_times[i].hour = times_2[i];
-                } else if (num_feeds == 3) {
-                    planned_feed_times[i].hour = times_3[i];
-                } else if (num_feeds == 4) {
-                    planned_feed_times[i].hour = times_4[i];
-                } else if (num_feeds == 5) {
-                    planned_feed_times[i].hour = times_5[i];
-                } else if (num_feeds == 6) {
-                    planned_feed_times[i].hour = times_6[i];
-                }
-                planned_feed_times[i].minute = 0;
-                planned_feed_times[i].enabled = true;
-            } else {
-                planned_feed_times[i].enabled = false;
-            }
-        }
-        
-        current_feeds_per_day = num_feeds;
-        ESP_LOGI(TAG, "Feed schedule updated: %d feeds per day", num_feeds);
-        // Refresh calendar dots to update hollow circles
-        refresh_weekly_calendar_dots();
-        close_popup();
-    }, LV_EVENT_CLICKED, feeds_input);
-    
-    lv_obj_t *btn_hist = lv_btn_create(popup_feed);
-    lv_obj_set_size(btn_hist, 80, 40);
-    lv_obj_align(btn_hist, LV_ALIGN_BOTTOM_LEFT, 20, -15);
-    lv_obj_t *label_hist = lv_label_create(btn_hist);
-    lv_label_set_text(label_hist, "History");
-    lv_obj_center(label_hist);
-    lv_obj_add_event_cb(btn_hist, show_feed_history_cb, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_t *btn_save = lv_btn_create(popup_feed);
-    lv_obj_set_size(btn_save, 100, 40);
-    lv_obj_align(btn_save, LV_ALIGN_BOTTOM_MID, 0, -15);
-    lv_obj_t *label_save = lv_label_create(btn_save);
-    lv_label_set_text(label_save, "Save");
-    lv_obj_center(label_save);
-    lv_obj_add_event_cb(btn_save, [](lv_event_t *e) {
-        // Shift existing entries down
-        for (int i = LOG_DAYS - 1; i > 0; i--) {
-            feed_log_data[i] = feed_log_data[i - 1];
+    // Tap opens the monthly calendar on the current month
+    lv_obj_add_flag(panel_calendar, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(panel_calendar, [](lv_event_t *e) {
+        if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+            calendar_view_open();
         }
-        
-        // Save new entry at index 0 (most recent)
-        feed_log_data[0].timestamp = time(NULL);
-        feed_log_data[0].feeds_per_day = 2;  // TODO: Read from input field
-        current_feeds_per_day = 2;
-        
-        ESP_LOGI(TAG, "Feeds per day saved: %d (timestamp: %ld)", 
-                 feed_log_data[0].feeds_per_day, feed_log_data[0].timestamp);
-        
-        // Save to SD card
-        save_feed_to_sd(feed_log_data[0].feeds_per_day);
-        
-        evaluate_and_update_mood();
-        close_popup();
     }, LV_EVENT_CLICKED, NULL);
     
-    lv_obj_t *btn_close = lv_btn_create(popup_feed);
-    lv_obj_set_size(btn_close, 100, 40);
-    lv_obj_align(btn_close, LV_ALIGN_BOTTOM_RIGHT, -20, -15);
-    lv_obj_t *label_close = lv_label_create(btn_close);
-    lv_label_set_text(label_close, "Close");
-    lv_obj_center(label_close);
-    lv_obj_add_event_cb(btn_close, [](lv_event_t *e) { close_popup(); }, LV_EVENT_CLICKED, NULL);
-    
-    lv_obj_move_foreground(popup_feed);
-}
-
-/**
- * @brief Calendar page button event callbacks
- */
-static void calendar_button_event_cb(lv_event_t *e) {
-    lv_obj_t *btn = lv_event_get_target(e);
-    
-    if (lv_event_get_code(e) != LV_EVENT_CLICKED) return;
-    
-    if (btn == btn_param_log) {
-        create_param_popup();
-    } else if (btn == btn_water_log) {
-        create_water_popup();
-    } else if (btn == btn_feed_log) {
-        create_feed_popup();
-    } else if (btn == btn_med_calc) {
-        ESP_LOGI(TAG, "Med Calc button clicked - opening popup");
-        show_med_calculator_popup();
+    // The clock may have been set before the card existed
+    struct tm now_tm;
+    if (time_svc_local(&now_tm) && now_tm.tm_year >= (2024 - 1900)) {
+        update_panel_date(&now_tm);
     }
 }
 
 /**
- * @brief Gesture event handler for swipe detection
- */
-/**
- * @brief Panel button event handler
+ * @brief Log buttons (Parameters, Water Change, Feed) and the med calculator
  */
-static void panel_button_event_cb(lv_event_t *e)
+static void panel_build_buttons(void)
 {
-    lv_event_code_t code = lv_event_get_code(e);
-    lv_obj_t *btn = lv_event_get_target(e);
+    // Vertical on the right side
+    int btn_x = 240;  // Right side position
+    int btn_start_y = CALENDAR_Y + 0;  // Start below calendar
+    int btn_spacing = 55;  // Vertical spacing between buttons
     
-    if (code == LV_EVENT_CLICKED) {
-        if (btn == btn_home) {
-            // Scroll back to top (animation section)
-            lv_obj_scroll_to_y(scroll_container, 0, LV_ANIM_ON);
-            ESP_LOGI(TAG, "Scrolling back to home (top)");
-        }
-    }
+    btn_param_log = lv_btn_create(panel_content);
+    lv_obj_set_size(btn_param_log, 100, 45);
+    lv_obj_set_pos(btn_param_log, btn_x, btn_start_y);
+    lv_obj_t *label1 = lv_label_create(btn_param_log);
+    lv_label_set_text(label1, "Parameters");
+    lv_obj_center(label1);
+    lv_obj_add_event_cb(btn_param_log, calendar_button_event_cb, LV_EVENT_CLICKED, NULL);
+    lv_obj_add_event_cb(btn_param_log, [](lv_event_t *e) {
+        history_view_show_diagnostics();
+    }, LV_EVENT_LONG_PRESSED, NULL);
+
+    btn_water_log = lv_btn_create(panel_content);
+    lv_obj_set_size(btn_water_log, 100, 45);
+    lv_obj_set_pos(btn_water_log, btn_x, btn_start_y + btn_spacing);
+    lv_obj_t *label2 = lv_label_create(btn_water_log);
+    lv_label_set_text(label2, "Water");
+    lv_obj_center(label2);
+    lv_obj_add_event_cb(btn_water_log, calendar_button_event_cb, LV_EVENT_CLICKED, NULL);
+
+    btn_feed_log = lv_btn_create(panel_content);
+    lv_obj_set_size(btn_feed_log, 100, 45);
+    lv_obj_set_pos(btn_feed_log, btn_x, btn_start_y + btn_spacing * 2);
+    lv_obj_t *label3 = lv_label_create(btn_feed_log);
+    lv_label_set_text(label3, "Feed");
+    lv_obj_center(label3);
+    lv_obj_add_event_cb(btn_feed_log, calendar_button_event_cb, LV_EVENT_CLICKED, NULL);
+
+    // Add Medication Calculator button - vertical tall button to the right of all 3 buttons
+    int med_calc_height = btn_spacing * 2 + 45;  // Spans all 3 buttons (Parameters, Water, Feed)
+    btn_med_calc = lv_btn_create(panel_content);
+    lv_obj_set_size(btn_med_calc, 38, med_calc_height);  // Narrow width, tall height
+    lv_obj_set_pos(btn_med_calc, btn_x + 105, btn_start_y);  // To the right with 5px gap
+    lv_obj_set_style_bg_color(btn_med_calc, lv_palette_main(LV_PALETTE_BLUE), 0);
+    lv_obj_t *label4 = lv_label_create(btn_med_calc);
+    lv_label_set_text(label4, "M\ne\nd\n\nC\na\nl\nc");  // Vertical text with breaks
+    lv_obj_set_style_text_align(label4, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_center(label4);
+    lv_obj_add_event_cb(btn_med_calc, calendar_button_event_cb, LV_EVENT_CLICKED, NULL);
 }
 
-/**
- * @brief Keyboard event handler
- */
-static void keyboard_event_cb(lv_event_t *e)
+static void panel_build_step(uint16_t step, void *user)
 {
-    lv_event_code_t code = lv_event_get_code(e);
-    lv_obj_t *kb = lv_event_get_target(e);
-    
-    if (code == LV_EVENT_READY || code == LV_EVENT_CANCEL) {
-        if (code == LV_EVENT_READY && panel_textarea) {
-            // Get entered value
-            const char *txt = lv_textarea_get_text(panel_textarea);
-            float value = atof(txt);
-            
-            // Validate range
-            DialParam &param = dial_params[current_dropdown_idx];
-            if (value < param.min_val) value = param.min_val;
-            if (value > param.max_val) value = param.max_val;
-            
-            // Update parameter and animate dial
-            param.current_val = value;
-            update_panel_dial(value, true);
-            
-            ESP_LOGI(TAG, "Parameter '%s' set to %.2f", param.name, value);
+    if (step < 7) {
+        panel_build_day(step);
+        if (step == 6) {
+            // Refresh calendar dots to show planned activities (hollow circles)
+            refresh_weekly_calendar_dots();
         }
-        
-        close_numeric_input();
+    } else if (step == 7) {
+        panel_build_calendar();
+    } else if (step == 8) {
+        panel_build_buttons();
+    } else {
+#if CONFIG_GOLDIE_UI_STATIC_LAYERS
+        // Panel chrome is rendered once into PSRAM and reused while scrolling;
+        // the first snapshot is taken after boot settles (panel_layer_timer_cb)
+        panel_layer_ready = static_layer_init(&panel_layer, panel_bg);
+        if (panel_layer_ready) {
+            lv_timer_create(panel_layer_timer_cb, STATIC_LAYER_CHECK_MS, NULL);
+        }
+#endif
+        // Opening the panel makes a log popup the likely next tap
+        log_popups_kick();
+        ui_obj_track_init();                // Whole dashboard is up: start counting
     }
 }
 
 /**
- * @brief Update panel dial value with optional animation
+ * @brief Panel background and content area; the rest is staged
  */
-static void update_panel_dial(float value, bool animate)
+static void panel_section_start(void)
 {
-    // Since we removed the meter, just log the value update
-    DialParam &param = dial_params[current_dropdown_idx];
-    ESP_LOGI(TAG, "Parameter '%s' updated to %.2f", param.name, value);
+    if (panel_bg != NULL) {
+        return;
+    }
+    int64_t build_t0 = esp_timer_get_time();
+    
+    // Create panel background
+    panel_bg = lv_obj_create(scroll_container);
+    lv_obj_set_size(panel_bg, 480, 320);
+    lv_obj_set_pos(panel_bg, 0, PANEL_SECTION_Y);  // 320 + 150 = 470
+    lv_obj_set_style_bg_color(panel_bg, lv_color_hex(0x1a1a1a), LV_PART_MAIN);
+    lv_obj_set_style_border_width(panel_bg, 0, LV_PART_MAIN);
+    lv_obj_clear_flag(panel_bg, LV_OBJ_FLAG_SCROLLABLE);
+    
+    // Create panel container for landscape content
+    panel_content = lv_obj_create(panel_bg);
+    lv_obj_set_size(panel_content, 440, 280);
+    lv_obj_set_pos(panel_content, 0, 0);  // Top-left corner
+    lv_obj_set_style_bg_color(panel_content, lv_color_hex(0x2a2a2a), LV_PART_MAIN);
+    lv_obj_set_style_border_width(panel_content, 2, LV_PART_MAIN);
+    lv_obj_set_style_border_color(panel_content, lv_palette_main(LV_PALETTE_BLUE), LV_PART_MAIN);
+    lv_obj_clear_flag(panel_content, LV_OBJ_FLAG_SCROLLABLE);
+    
+    // The log popups and histories open over the panel's content
+    history_view_set_host(panel_content);
+    log_popups_init(panel_content, &log_popup_hooks);
+    
+    ui_stage_start(&panel_stage, "Side panel", panel_bg, PANEL_BUILD_STEPS,
+                   panel_build_step, NULL, esp_timer_get_time() - build_t0);
 }
 
-
 /**
- * @brief Close numeric input modal
+ * @brief The panel is (about to be) on screen: finish it now
  */
-static void close_numeric_input(void)
+static void panel_section_ensure(void)
 {
-    if (panel_modal) {
-        lv_obj_del(panel_modal);
-        panel_modal = NULL;
-        panel_keyboard = NULL;
-        panel_textarea = NULL;
-    }
+    panel_section_start();
+    ui_stage_flush(&panel_stage);
+}
+
+static void panel_build_timer_cb(lv_timer_t *timer)
+{
+    panel_section_start();
 }
 
 /**
- * @brief Create a circular button for Feed/Water actions
+ * @brief Render benchmark scenes (render_bench.h): animation, AI section, side panel
  */
-static lv_obj_t* create_circular_button(lv_obj_t *parent, const char *label_text, 
-                                        lv_align_t align, lv_coord_t x_ofs, lv_coord_t y_ofs)
+static bool render_bench_scene(int scene)
 {
-    // Create circular button
-    lv_obj_t *btn = lv_btn_create(parent);
-    lv_obj_set_size(btn, 72, 72);
-    lv_obj_align(btn, align, x_ofs, y_ofs);
-    lv_obj_set_style_radius(btn, LV_RADIUS_CIRCLE, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(btn, lv_color_hex(0xFFFF00), LV_PART_MAIN);  // Default yellow
-    lv_obj_set_style_shadow_width(btn, 10, LV_PART_MAIN);
-    lv_obj_set_style_shadow_spread(btn, 2, LV_PART_MAIN);
-    
-    // Add label
-    lv_obj_t *label = lv_label_create(btn);
-    lv_label_set_text(label, label_text);
-    lv_obj_set_style_text_font(label, &lv_font_montserrat_16, LV_PART_MAIN);
-    lv_obj_set_style_text_color(label, lv_color_black(), LV_PART_MAIN);
-    lv_obj_center(label);
+    static const lv_coord_t scroll_y[] = { 0, PANEL_SECTION_Y - FRAME_HEIGHT / 2, PANEL_SECTION_Y };
+    static lv_coord_t restore_y = 0;
     
-    return btn;
+    if (scene == RENDER_BENCH_SCENE_END) {
+        lv_obj_scroll_to_y(scroll_container, restore_y, LV_ANIM_OFF);
+        return true;
+    }
+    if (scene >= (int)(sizeof(scroll_y) / sizeof(scroll_y[0]))) {
+        return false;
+    }
+    if (scene == 0) {
+        restore_y = lv_obj_get_scroll_y(scroll_container);
+        panel_section_ensure();
+    }
+    lv_obj_scroll_to_y(scroll_container, scroll_y[scene], LV_ANIM_OFF);
+    return true;
 }
 
 /**
@@ -3312,20 +2918,50 @@ void dashboard_init(void)
 {
     ESP_LOGI(TAG, "Initializing IoT Dashboard");
     
-    // Initialize timestamps to current time
-    uint32_t current_time = get_current_time_seconds();
-    last_feed_time = current_time;
-    last_clean_time = current_time;
+    // Every tank starts fed and cleaned now; the first one is on screen
+    tank_registry_init(time_svc_uptime_s());
+    tank = tank_get(0);
+    latest_ai_advice = text_buf_from_str("System initializing...");
+    
+    // Species profile before the first mood evaluation: thresholds come
+    // from it, and so do the schedule defaults
+    mood_profiles_init();
+    for (uint8_t i = 0; i < TANK_MAX; i++) {
+        apply_profile_defaults(tank_get(i), mood_engine_preset());
+    }
+    
+    // Dosage calculator products: mapped in place, no RAM copy
+    med_db_init();
+    med_calc_view_init(&med_calc_hooks);
+    
+    // Saved parameters, schedule and last events override the defaults,
+    // so the first mood evaluation already uses them
+    for (uint8_t i = 0; i < TANK_MAX; i++) {
+        restore_dash_state(tank_get(i));
+        sync_reminders(tank_get(i));
+    }
+    dial_params[1].current_val = tank->ph_level;
+    dash_state_init(collect_dash_state);
+    dash_live_publish();
     
-    // Allocate double buffers in PSRAM for smooth animation
-    frame_buffer_a = (uint8_t *)heap_caps_malloc(FRAME_SIZE, MALLOC_CAP_SPIRAM);
-    frame_buffer_b = (uint8_t *)heap_caps_malloc(FRAME_SIZE, MALLOC_CAP_SPIRAM);
+    // Activity logs are written by the sd_logger worker; history is
+    // read from SD (one pass) before the calendar is drawn
+    sd_logger_init(DASH_LOG_DIR);
+    if (dash_log_dir_ensure()) {
+        history_store_init(DASH_LOG_DIR);
+    }
     
-    if (frame_buffer_a == NULL || frame_buffer_b == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate frame buffers in PSRAM!");
+    // Prefer the memory-mapped frames partition (zero-copy, no PSRAM buffers);
+    // otherwise allocate the frame pool in PSRAM (slots go to storage_task)
+    bool frames_mapped = frame_map_init(FRAME_WIDTH, FRAME_HEIGHT, TOTAL_FRAMES);
+    if (!frames_mapped && !frame_pool_init(FRAME_SIZE)) {
+        ESP_LOGE(TAG, "Failed to allocate frame pool in PSRAM!");
         return;
     }
-    ESP_LOGI(TAG, "Allocated %d bytes × 2 in PSRAM for double buffering", FRAME_SIZE);
+    // Pooled frames carry the date themselves (the labels below hide)
+    if (!frames_mapped) {
+        frame_overlay_init(FRAME_WIDTH, FRAME_HEIGHT);
+    }
     
     // ═══════════════════════════════════════════════════════════════════════
     // CRITICAL: NO SPIFFS ACCESS ALLOWED IN LVGL CONTEXT
@@ -3334,11 +2970,20 @@ void dashboard_init(void)
     // LVGL callbacks NEVER open/read files or block on I/O
     ESP_LOGI(TAG, "✓ LVGL context is I/O-free - all file loading in storage_task");
     
-    // Perform initial mood evaluation
-    evaluate_and_update_mood();
+    // Perform initial mood evaluation (all tanks, one message)
+    for (uint8_t i = 0; i < TANK_MAX; i++) {
+        evaluate_and_update_mood(tank_get(i));
+    }
+    
+    // Fonts before any widget; widgets without an explicit font (AI text,
+    // lists) inherit the cached 14px font from the screen
+    ui_fonts_init();
+    ui_theme_init();
+    ui_arena_init();
     
     lv_obj_t *scr = lv_scr_act();
     lv_obj_set_style_bg_color(scr, lv_color_hex(0x000000), LV_PART_MAIN);
+    lv_obj_set_style_text_font(scr, ui_font(UI_FONT_14), LV_PART_MAIN);
     
     // Create a scrollable container that's taller than the screen (landscape: 480×790 total)
     // Layout: Animation+Gauges (0-320px) + AI Assistant (320-470px) + Panel (470-790px)
@@ -3350,77 +2995,67 @@ void dashboard_init(void)
     lv_obj_set_style_pad_all(scroll_container, 0, LV_PART_MAIN);
     lv_obj_set_scroll_dir(scroll_container, LV_DIR_VER);  // Vertical scrolling only
     lv_obj_set_scrollbar_mode(scroll_container, LV_SCROLLBAR_MODE_OFF);  // Hide scrollbar
+    lv_obj_add_event_cb(scroll_container, scroll_activity_event_cb, LV_EVENT_ALL, NULL);
     
     // ===== ANIMATION + GAUGES SECTION (0-320px) - HOME VIEW =====
     
     // Create animation image widget
-    animation_img = lv_img_create(scroll_container);
+    animation_img = anim_image_create(scroll_container, FRAME_WIDTH, FRAME_HEIGHT);
     lv_obj_set_pos(animation_img, 0, 0);  // Y=0 for home view
     
-    // STEP 3: Request initial frames from storage_task (non-blocking)
-    buffer_a_ready = false;
-    buffer_b_ready = false;
-    
-    // Request initial frame 0 from storage_task
-    ESP_LOGI(TAG, "[INIT] Requesting frame 0 for initial display");
-    anim_frame_request_msg_t request = { .frame_index = 0 };
-    xQueueOverwrite(queue_anim_frame_request, &request);
-    
-    // Wait briefly for frame 0 to load (initial display)
-    // Polling is acceptable here during one-time init
-    ESP_LOGI(TAG, "[INIT] Waiting for frame 0 to load...");
-    for (int i = 0; i < 100 && !buffer_a_ready && !buffer_b_ready; i++) {
-        vTaskDelay(pdMS_TO_TICKS(10));  // Max 1 second wait
-    }
-    
-    // Display frame 0 if ready (use anim_dsc_a for initial frame)
-    if (buffer_a_ready && buffer_a_frame_index == 0) {
-        anim_dsc_a.data = frame_buffer_a;
-        active_dsc = &anim_dsc_a;
-        lv_img_set_src(animation_img, active_dsc);
-        ESP_LOGI(TAG, "[INIT] ✓ Frame 0 displayed from buffer_a");
-        
-        // Now request frame 1 for the timer callback
-        ESP_LOGI(TAG, "[INIT] Requesting frame 1 for animation start");
-        request.frame_index = 1;
-        xQueueOverwrite(queue_anim_frame_request, &request);
-        
-    } else if (buffer_b_ready && buffer_b_frame_index == 0) {
-        anim_dsc_a.data = frame_buffer_b;
-        active_dsc = &anim_dsc_a;
-        lv_img_set_src(animation_img, active_dsc);
-        ESP_LOGI(TAG, "[INIT] ✓ Frame 0 displayed from buffer_b");
-        
-        // Now request frame 1 for the timer callback
-        ESP_LOGI(TAG, "[INIT] Requesting frame 1 for animation start");
-        request.frame_index = 1;
-        xQueueOverwrite(queue_anim_frame_request, &request);
-        
+    if (frames_mapped) {
+        // STEP 3 (zero-copy): point the descriptor straight at flash
+        current_frame = 0;
+        anim_image_set_frame(animation_img, current_category * FRAMES_PER_CATEGORY,
+                             frame_map_get(current_category * FRAMES_PER_CATEGORY), NULL);
+        ESP_LOGI(TAG, "[INIT] ✓ Frame 0 displayed from mapped flash");
     } else {
-        // Fallback: frame 0 not ready yet
-        anim_dsc_a.data = frame_buffer_a;
-        active_dsc = &anim_dsc_a;
-        lv_img_set_src(animation_img, active_dsc);
-        ESP_LOGW(TAG, "[INIT] ⚠ Frame 0 not ready, using placeholder");
+        // STEP 3: Request initial frame 0 of the current mood from storage_task
+        // (replaces anything the initial mood evaluation already queued)
+        ESP_LOGI(TAG, "[INIT] Requesting frame 0 for initial display");
+        xQueueReset(queue_anim_frame_request);
+        anim_frame_request_msg_t request = { .frame_index = (uint8_t)(current_category * FRAMES_PER_CATEGORY) };
+        queue_watch_send(QUEUE_WATCH_FRAME_REQ, &request);
+        requests_in_flight = 0;
+        last_requested_frame = 0;
+        
+        // Wait briefly for frame 0 to load (initial display)
+        // Blocking is acceptable here during one-time init
+        ESP_LOGI(TAG, "[INIT] Waiting for frame 0 to load...");
+        anim_frame_ready_msg_t ready;
+        
+        bool answered = (xQueueReceive(queue_anim_frame_ready, &ready, pdMS_TO_TICKS(1000)) == pdTRUE);
+        
+        if (answered && ready.buffer_slot != FRAME_POOL_NO_SLOT) {
+            anim_image_set_frame(animation_img, ready.frame_index, frame_pool_slot(ready.buffer_slot)->pixels, NULL);
+            displayed_slot = ready.buffer_slot;
+            displayed_row_from = ready.row_from;
+            displayed_row_to = ready.row_to;
+            current_frame = ready.frame_index % FRAMES_PER_CATEGORY;
+            ESP_LOGI(TAG, "[INIT] ✓ Frame 0 displayed from slot %d", ready.buffer_slot);
+        } else {
+            // Fallback: frame 0 not ready yet - the timer picks it up later,
+            // the widget stays black until then
+            requests_in_flight = answered ? 0 : 1;
+            ESP_LOGW(TAG, "[INIT] ⚠ Frame 0 not ready, showing blank frame");
+        }
         
-        // Still request frame 1 for when timer starts
-        ESP_LOGI(TAG, "[INIT] Requesting frame 1 anyway");
-        request.frame_index = 1;
-        xQueueOverwrite(queue_anim_frame_request, &request);
+        // Fill the rest of the pool for the timer callback
+        request_frames_ahead();
     }
     
     // Mood face icon next to animation
     mood_face = lv_label_create(scroll_container);
     lv_label_set_text(mood_face, LV_SYMBOL_OK);  // Default happy
     lv_obj_set_pos(mood_face, 390, 10);
-    lv_obj_set_style_text_font(mood_face, &lv_font_montserrat_32, 0);
+    lv_obj_set_style_text_font(mood_face, ui_font(UI_FONT_32), 0);
     lv_obj_set_style_text_color(mood_face, lv_palette_main(LV_PALETTE_GREEN), 0);
     
     // Date label shadow/outline (black text behind main label)
     date_shadow = lv_label_create(scroll_container);  // Use global static variable
     lv_label_set_text(date_shadow, "01 JAN");  // Default, will be updated
     lv_obj_set_pos(date_shadow, 16, 11);  // Offset by 1px down and right
-    lv_obj_set_style_text_font(date_shadow, &lv_font_montserrat_32, 0);
+    lv_obj_set_style_text_font(date_shadow, ui_font(UI_FONT_32), 0);
     lv_obj_set_style_text_color(date_shadow, lv_color_black(), 0);  // Black shadow
     lv_obj_set_style_bg_opa(date_shadow, LV_OPA_TRANSP, 0);  // No background
     lv_obj_set_style_text_letter_space(date_shadow, 1, 0);
@@ -3429,12 +3064,29 @@ void dashboard_init(void)
     date_label = lv_label_create(scroll_container);
     lv_label_set_text(date_label, "01 JAN");  // Default, updated when WiFi connects
     lv_obj_set_pos(date_label, 15, 10);  // Top-left corner
-    lv_obj_set_style_text_font(date_label, &lv_font_montserrat_32, 0);
-    lv_obj_set_style_text_color(date_label, lv_color_white(), 0);
+    lv_obj_set_style_text_font(date_label, ui_font(UI_FONT_32), 0);
+    lv_obj_add_style(date_label, ui_style(UI_STYLE_TEXT), 0);
     lv_obj_set_style_bg_opa(date_label, LV_OPA_TRANSP, 0);  // No background
     lv_obj_set_style_text_letter_space(date_label, 1, 0);  // Slight letter spacing for cleaner look
+    if (frame_overlay_active()) {
+        lv_obj_add_flag(date_shadow, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(date_label, LV_OBJ_FLAG_HIDDEN);
+        date_overlay_set(lv_label_get_text(date_label));
+    }
     
-    // Note: Date will be updated by date_update_timer_cb when WiFi connects and time syncs
+    // Note: Date will be updated by date_refresh (day clock) once the clock is set
+    
+    // Tank on screen, under the date; tap for the next one
+    if (TANK_MAX > 1) {
+        tank_label = lv_label_create(scroll_container);
+        lv_obj_set_pos(tank_label, 15, 50);
+        lv_obj_set_style_text_font(tank_label, ui_font(UI_FONT_14), 0);
+        lv_obj_add_style(tank_label, ui_style(UI_STYLE_TEXT), 0);
+        lv_obj_add_flag(tank_label, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_set_ext_click_area(tank_label, 12);
+        lv_obj_add_event_cb(tank_label, tank_label_event_cb, LV_EVENT_CLICKED, NULL);
+        tank_label_refresh();
+    }
     
     // ===== AI ASSISTANT SECTION (320-470px) - SCROLL DOWN TO VIEW =====
     
@@ -3450,17 +3102,33 @@ void dashboard_init(void)
     // AI Assistant title
     lv_obj_t *ai_title = lv_label_create(ai_bg);
     lv_label_set_text(ai_title, LV_SYMBOL_WIFI " AI Assistant");
-    lv_obj_set_style_text_font(ai_title, &lv_font_montserrat_16, 0);
+    lv_obj_set_style_text_font(ai_title, ui_font(UI_FONT_16), 0);
     lv_obj_set_style_text_color(ai_title, lv_palette_main(LV_PALETTE_CYAN), 0);
     lv_obj_set_pos(ai_title, 10, 10);
     
+    // Ask Goldie (chat popup), only with an AI client to answer it
+    if (CONFIG_GOLDIE_AI) {
+        lv_obj_t *btn_ask = lv_btn_create(ai_bg);
+        lv_obj_set_size(btn_ask, 90, 28);
+        lv_obj_set_pos(btn_ask, 365, 2);
+        lv_obj_set_style_bg_color(btn_ask, lv_palette_darken(LV_PALETTE_CYAN, 3), 0);
+        lv_obj_t *ask_label = lv_label_create(btn_ask);
+        lv_label_set_text(ask_label, LV_SYMBOL_KEYBOARD " Ask");
+        lv_obj_center(ask_label);
+        lv_obj_add_event_cb(btn_ask, [](lv_event_t *e) {
+            show_chat_popup();
+        }, LV_EVENT_CLICKED, NULL);
+    }
+    
     // AI advice/status text area
-    ai_text_label = lv_label_create(ai_bg);
-    lv_label_set_text(ai_text_label, "System initializing...\nAnalyzing aquarium parameters...");
-    lv_obj_set_size(ai_text_label, 465, 60);
-    lv_obj_set_pos(ai_text_label, 0, 35);
-    lv_obj_set_style_text_color(ai_text_label, lv_color_white(), 0);
-    lv_label_set_long_mode(ai_text_label, LV_LABEL_LONG_WRAP);
+    // Long advice pages (tap for the next page) instead of laying out
+    // text the box clips
+    if (text_pager_init(&ai_pager, ai_bg, 0, 35, 465, 60, TEXT_BUF_CAPACITY)) {
+        ai_text_label = ai_pager.label;
+        lv_obj_add_style(ai_text_label, ui_style(UI_STYLE_TEXT), 0);
+        lv_obj_set_style_text_color(ai_pager.indicator, lv_palette_main(LV_PALETTE_CYAN), 0);
+        text_pager_set(&ai_pager, "System initializing...\nAnalyzing aquarium parameters...", false);
+    }
     
     // Medication calculator result display in AI section
     ai_med_result_label = lv_label_create(ai_bg);
@@ -3482,213 +3150,23 @@ void dashboard_init(void)
     lv_obj_move_foreground(btn_water_main);
     
     // ===== PANEL SECTION (470-790px) =====
-    
-    // Create panel background
-    lv_obj_t *panel_bg = lv_obj_create(scroll_container);
-    lv_obj_set_size(panel_bg, 480, 320);
-    lv_obj_set_pos(panel_bg, 0, 470);  // 320 + 150 = 470
-    lv_obj_set_style_bg_color(panel_bg, lv_color_hex(0x1a1a1a), LV_PART_MAIN);
-    lv_obj_set_style_border_width(panel_bg, 0, LV_PART_MAIN);
-    lv_obj_clear_flag(panel_bg, LV_OBJ_FLAG_SCROLLABLE);
-    
-    // Create panel container for landscape content
-    panel_content = lv_obj_create(panel_bg);
-    lv_obj_set_size(panel_content, 440, 280);
-    lv_obj_set_pos(panel_content, 0, 0);  // Top-left corner
-    lv_obj_set_style_bg_color(panel_content, lv_color_hex(0x2a2a2a), LV_PART_MAIN);
-    lv_obj_set_style_border_width(panel_content, 2, LV_PART_MAIN);
-    lv_obj_set_style_border_color(panel_content, lv_palette_main(LV_PALETTE_BLUE), LV_PART_MAIN);
-    lv_obj_clear_flag(panel_content, LV_OBJ_FLAG_SCROLLABLE);
-    
-    // Create 7-day week calendar at the top (replacing Home button)
-    int week_y = 10;
-    int week_height = 60;
-    int day_width = 55;
-    int day_spacing = 5;
-    int total_week_width = (7 * day_width) + (6 * day_spacing);  // 7 days + 6 gaps = 415px
-    int content_width = 405;  // Usable content area
-    int week_start_x = (content_width - total_week_width) / 2;  // Center in content area
-    
-    // Get current time
-    time_t now_time = time(NULL);
-    struct tm now_tm;
-    localtime_r(&now_time, &now_tm);
-    
-    // Create 7 day boxes (current day in middle, index 3)
-    for (int i = 0; i < 7; i++) {
-        // Calculate date for this day (3 days before to 3 days after)
-        time_t day_time = now_time + ((i - 3) * 86400);
-        struct tm day_tm;
-        localtime_r(&day_time, &day_tm);
-        
-        // Create day box
-        lv_obj_t *day_box = lv_obj_create(panel_content);
-        week_day_boxes[i] = day_box;  // Store reference
-        lv_obj_set_size(day_box, day_width, week_height);
-        lv_obj_set_pos(day_box, week_start_x + (i * (day_width + day_spacing)), week_y);
-        
-        // Highlight current day with different color
-        if (i == 3) {
-            lv_obj_set_style_bg_color(day_box, lv_color_hex(0x3a4a5a), 0);  // Steel blue
-            lv_obj_set_style_border_color(day_box, lv_palette_main(LV_PALETTE_LIGHT_BLUE), 0);
-        } else {
-            lv_obj_set_style_bg_color(day_box, lv_color_hex(0x2a2a2a), 0);
-            lv_obj_set_style_border_color(day_box, lv_color_hex(0x4a4a4a), 0);
-        }
-        lv_obj_set_style_border_width(day_box, 2, 0);
-        lv_obj_set_style_radius(day_box, 5, 0);
-        lv_obj_clear_flag(day_box, LV_OBJ_FLAG_SCROLLABLE);
-        
-        // Day name (e.g., "MON")
-        const char *day_names[] = {"SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT"};
-        lv_obj_t *day_name = lv_label_create(day_box);
-        lv_label_set_text(day_name, day_names[day_tm.tm_wday]);
-        lv_obj_set_style_text_font(day_name, &lv_font_montserrat_12, 0);
-        lv_obj_set_style_text_color(day_name, lv_color_white(), 0);
-        lv_obj_align(day_name, LV_ALIGN_CENTER, 0, 0);
-        
-        // Calculate log index for this day using day-of-year
-        int log_index = day_tm.tm_yday % LOG_DAYS;
-        
-        // Blue water dot - centered horizontally at bottom
-        if (water_log[log_index] > 0) {
-            lv_obj_t *water_dot = lv_obj_create(day_box);
-            lv_obj_set_size(water_dot, 6, 6);
-            lv_obj_set_pos(water_dot, (day_width - 6) / 2, 38);  // Below day name, above bottom
-            lv_obj_set_style_bg_color(water_dot, lv_palette_main(LV_PALETTE_CYAN), 0);
-            lv_obj_set_style_bg_opa(water_dot, LV_OPA_COVER, 0);
-            lv_obj_set_style_border_width(water_dot, 0, 0);
-            lv_obj_set_style_radius(water_dot, LV_RADIUS_CIRCLE, 0);
-            lv_obj_set_style_pad_all(water_dot, 0, 0);
-            lv_obj_clear_flag(water_dot, LV_OBJ_FLAG_SCROLLABLE);
-        }
-        
-        // Red feed dots - arranged horizontally at top
-        uint32_t feed_count = feed_log[log_index];
-        if (feed_count > 4) feed_count = 4;  // Max 4 dots
-        if (feed_count > 0) {
-            // Calculate total width and center the row (same centering approach as blue dot)
-            int total_dots_width = (feed_count * 6) + ((feed_count - 1) * 2);  // dots + 2px gaps
-            int start_x = (day_width - total_dots_width) / 2;
-            for (uint32_t j = 0; j < feed_count; j++) {
-                lv_obj_t *feed_dot = lv_obj_create(day_box);
-                lv_obj_set_size(feed_dot, 6, 6);
-                lv_obj_set_pos(feed_dot, start_x + (j * 8), 3);  // Use start_x for proper centering
-                lv_obj_set_style_bg_color(feed_dot, lv_palette_main(LV_PALETTE_RED), 0);
-                lv_obj_set_style_border_width(feed_dot, 0, 0);
-                lv_obj_set_style_radius(feed_dot, LV_RADIUS_CIRCLE, 0);
-            }
-        }
-        
-        // Make clickable - store day timestamp in user data
-        lv_obj_add_flag(day_box, LV_OBJ_FLAG_CLICKABLE);
-        lv_obj_set_user_data(day_box, (void*)(intptr_t)day_time);
-        lv_obj_add_event_cb(day_box, [](lv_event_t *e) {
-            if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
-                time_t day_timestamp = (time_t)(intptr_t)lv_obj_get_user_data(lv_event_get_target(e));
-                show_day_history(day_timestamp);
-            }
-        }, LV_EVENT_CLICKED, NULL);
+    // Built after the first frame (panel_build_timer_cb) or when scrolled into view
+    lv_timer_t *panel_timer = lv_timer_create(panel_build_timer_cb, PANEL_BUILD_DELAY_MS, NULL);
+    if (panel_timer) {
+        lv_timer_set_repeat_count(panel_timer, 1);
+    } else {
+        panel_section_ensure();
     }
     
-    // Refresh calendar dots to show planned activities (hollow circles)
-    refresh_weekly_calendar_dots();
-    
-    // Update calendar_y position for elements below
-    int calendar_y = week_y + week_height + 15;
-    
-    // Create calendar container
-    panel_calendar = lv_obj_create(panel_content);
-    lv_obj_set_size(panel_calendar, 150, 130);
-    lv_obj_set_pos(panel_calendar, 20, calendar_y);
-    lv_obj_set_style_bg_color(panel_calendar, lv_color_hex(0x1a1a1a), LV_PART_MAIN);
-    lv_obj_set_style_border_width(panel_calendar, 2, LV_PART_MAIN);
-    lv_obj_set_style_border_color(panel_calendar, lv_palette_main(LV_PALETTE_BLUE), LV_PART_MAIN);
-    lv_obj_set_style_radius(panel_calendar, 10, LV_PART_MAIN);
-    lv_obj_clear_flag(panel_calendar, LV_OBJ_FLAG_SCROLLABLE);
-    
-    // Day name label (e.g., "Monday")
-    panel_day_label = lv_label_create(panel_calendar);
-    lv_obj_set_style_text_font(panel_day_label, &lv_font_montserrat_16, LV_PART_MAIN);
-    lv_obj_set_style_text_color(panel_day_label, lv_palette_main(LV_PALETTE_BLUE), LV_PART_MAIN);
-    lv_label_set_text(panel_day_label, "---");
-    lv_obj_align(panel_day_label, LV_ALIGN_TOP_MID, 0, 10);
-    
-    // Date number label (e.g., "23")
-    panel_date_label = lv_label_create(panel_calendar);
-    lv_obj_set_style_text_font(panel_date_label, &lv_font_montserrat_32, LV_PART_MAIN);
-    lv_obj_set_style_text_color(panel_date_label, lv_color_white(), LV_PART_MAIN);
-    lv_label_set_text(panel_date_label, "--");
-    lv_obj_align(panel_date_label, LV_ALIGN_CENTER, 0, 5);
-    
-    // Month/Year label (e.g., "Dec 2025")
-    panel_month_label = lv_label_create(panel_calendar);
-    lv_obj_set_style_text_font(panel_month_label, &lv_font_montserrat_14, LV_PART_MAIN);
-    lv_obj_set_style_text_color(panel_month_label, lv_palette_main(LV_PALETTE_GREY), LV_PART_MAIN);
-    lv_label_set_text(panel_month_label, "--- ----");
-    lv_obj_align(panel_month_label, LV_ALIGN_BOTTOM_MID, 0, -10);
-    
-    // Monthly calendar disabled
-    // lv_obj_add_flag(panel_calendar, LV_OBJ_FLAG_CLICKABLE);
-    // lv_obj_add_event_cb(panel_calendar, [](lv_event_t *e) {
-    //     if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
-    //         time_t now = time(NULL);
-    //         struct tm now_tm;
-    //         localtime_r(&now, &now_tm);
-    //         monthly_cal_display_month = now_tm.tm_mon + 1;
-    //         monthly_cal_display_year = now_tm.tm_year + 1900;
-    //         show_monthly_calendar();
-    //     }
-    // }, LV_EVENT_CLICKED, NULL);
-    
-    // Create 3 buttons for log systems (Parameters, Water Change, Feed) - vertical on right side
-    int btn_x = 240;  // Right side position
-    int btn_start_y = calendar_y + 0;  // Start below calendar
-    int btn_spacing = 55;  // Vertical spacing between buttons
-    
-    btn_param_log = lv_btn_create(panel_content);
-    lv_obj_set_size(btn_param_log, 100, 45);
-    lv_obj_set_pos(btn_param_log, btn_x, btn_start_y);
-    lv_obj_t *label1 = lv_label_create(btn_param_log);
-    lv_label_set_text(label1, "Parameters");
-    lv_obj_center(label1);
-    lv_obj_add_event_cb(btn_param_log, calendar_button_event_cb, LV_EVENT_CLICKED, NULL);
-
-    btn_water_log = lv_btn_create(panel_content);
-    lv_obj_set_size(btn_water_log, 100, 45);
-    lv_obj_set_pos(btn_water_log, btn_x, btn_start_y + btn_spacing);
-    lv_obj_t *label2 = lv_label_create(btn_water_log);
-    lv_label_set_text(label2, "Water");
-    lv_obj_center(label2);
-    lv_obj_add_event_cb(btn_water_log, calendar_button_event_cb, LV_EVENT_CLICKED, NULL);
-
-    btn_feed_log = lv_btn_create(panel_content);
-    lv_obj_set_size(btn_feed_log, 100, 45);
-    lv_obj_set_pos(btn_feed_log, btn_x, btn_start_y + btn_spacing * 2);
-    lv_obj_t *label3 = lv_label_create(btn_feed_log);
-    lv_label_set_text(label3, "Feed");
-    lv_obj_center(label3);
-    lv_obj_add_event_cb(btn_feed_log, calendar_button_event_cb, LV_EVENT_CLICKED, NULL);
-
-    // Add Medication Calculator button - vertical tall button to the right of all 3 buttons
-    int med_calc_height = btn_spacing * 2 + 45;  // Spans all 3 buttons (Parameters, Water, Feed)
-    btn_med_calc = lv_btn_create(panel_content);
-    lv_obj_set_size(btn_med_calc, 38, med_calc_height);  // Narrow width, tall height
-    lv_obj_set_pos(btn_med_calc, btn_x + 105, btn_start_y);  // To the right with 5px gap
-    lv_obj_set_style_bg_color(btn_med_calc, lv_palette_main(LV_PALETTE_BLUE), 0);
-    lv_obj_t *label4 = lv_label_create(btn_med_calc);
-    lv_label_set_text(label4, "M\ne\nd\n\nC\na\nl\nc");  // Vertical text with breaks
-    lv_obj_set_style_text_align(label4, LV_TEXT_ALIGN_CENTER, 0);
-    lv_obj_center(label4);
-    lv_obj_add_event_cb(btn_med_calc, calendar_button_event_cb, LV_EVENT_CLICKED, NULL);
-    
-    ESP_LOGI(TAG, "Scrollable dashboard with animation and panel created successfully");
+    ESP_LOGI(TAG, "Scrollable dashboard with animation created successfully");
+    ui_perf_set_screen_fn(dashboard_perf_screen);
+    render_bench_init(lv_disp_get_default(), render_bench_scene);
     
     // Initialize water quality values to ideal ranges (Happy mood - cycled tank)
-    dashboard_update_ammonia(0.0f);   // Ammonia: 0 ppm (must be 0)
-    dashboard_update_nitrite(0.0f);   // Nitrite: 0 ppm (must be 0)
-    dashboard_update_nitrate(10.0f);  // Nitrate: 10 ppm (safe level)
-    dashboard_update_ph(7.0f);        // pH: 7.0 (neutral, ideal)
+    set_tank_param(tank, DASHBOARD_PARAM_AMMONIA, 0.0f);   // Ammonia: 0 ppm (must be 0)
+    set_tank_param(tank, DASHBOARD_PARAM_NITRITE, 0.0f);   // Nitrite: 0 ppm (must be 0)
+    set_tank_param(tank, DASHBOARD_PARAM_NITRATE, 10.0f);  // Nitrate: 10 ppm (safe level)
+    set_tank_param(tank, DASHBOARD_PARAM_PH, 7.0f);        // pH: 7.0 (neutral, ideal)
     
     // CRITICAL FIX: Create animation timer from LVGL context using one-shot initializer
     // Ensures timer is registered after LVGL task is fully running
@@ -3700,43 +3178,128 @@ void dashboard_init(void)
         ESP_LOGI(TAG, "Animation initialization timer created - will fire in 100ms");
     }
     
-    // STEP 2: Start mood result handler (checks queue every 50ms for <100ms latency)
-    lv_timer_create(mood_result_handler, 50, NULL);
-    
-    // STEP 4: Start AI result handler (checks queue every 100ms for AI responses)
-    lv_timer_create(ai_result_handler, 100, NULL);
-    
-    // STEP 5: Start Blynk snapshot publisher (updates every 30 seconds)
-    lv_timer_create(blynk_snapshot_publisher, 30000, NULL);
-    
-    // Date update timer (updates every 10 minutes)
-    lv_timer_create(date_update_timer_cb, 600000, NULL);
+    // STEP 2/4: Mood, AI and WiFi results arrive through the UI inbox -
+    // the LVGL task is only woken when a background task posts one
+    input_rec_set_sink(INPUT_REC_PARAM, param_replay_sink);
+    input_rec_set_sink(INPUT_REC_ACTIVITY, activity_replay_sink);
+    ui_inbox_subscribe(UI_MSG_MOOD_RESULT, mood_result_handler);
+    ui_inbox_subscribe(UI_MSG_AI_RESULT, ai_result_handler);
+    ui_inbox_subscribe(UI_MSG_WIFI_STATE, wifi_state_handler);
+    ui_inbox_subscribe(UI_MSG_TIME_CHANGED, day_clock_resync);
+    ui_inbox_subscribe(UI_MSG_REMINDER, reminder_handler);
+    ui_inbox_subscribe(UI_MSG_MOOD_FORECAST, forecast_handler);
+    ui_inbox_init();
+    ui_mood_sub = msg_bus_subscribe("dashboard", MSG_TOPIC_MOOD_RESULT, TANK_MAX + 1, 0,
+                                    ui_bus_notify, (void *)(uintptr_t)UI_MSG_MOOD_RESULT);
+    ui_ai_sub = msg_bus_subscribe("dashboard", MSG_TOPIC_AI_RESULT, 1, MSG_SUB_LATEST,
+                                  ui_bus_notify, (void *)(uintptr_t)UI_MSG_AI_RESULT);
+    ui_reminder_sub = msg_bus_subscribe("dashboard", MSG_TOPIC_REMINDER, 4, 0,
+                                        ui_bus_notify, (void *)(uintptr_t)UI_MSG_REMINDER);
+    ui_forecast_sub = msg_bus_subscribe("dashboard", MSG_TOPIC_MOOD_FORECAST, 1, MSG_SUB_LATEST,
+                                        ui_bus_notify, (void *)(uintptr_t)UI_MSG_MOOD_FORECAST);
+    
+    // STEP 5: Start Blynk snapshot publisher (every 30 s; the power profile may stretch it)
+    blynk_timer = lv_timer_create(blynk_snapshot_publisher, blynk_period_ms, NULL);
+    
+    // Park storage_task while the animation is scrolled away (pool mode only)
+    if (!frame_map_available() && CONFIG_GOLDIE_STORAGE_IDLE_STOP_S > 0) {
+        storage_idle_timer = lv_timer_create(storage_idle_timer_cb, STORAGE_IDLE_CHECK_MS, NULL);
+    }
+    
+    // Date labels, week strip and day rollover: at local midnight and when
+    // the clock changes (dashboard_update_calendar), no polling in between
+    day_clock_start(date_refresh);
     
     // Initialize AI assistant
     update_ai_assistant();
     
     ESP_LOGI(TAG, "Dashboard initialized successfully - Animation section is default view");
-    ESP_LOGI(TAG, "Animation enabled - cycling through 8 C array frames at 12 FPS");
+    ESP_LOGI(TAG, "Animation enabled - cycling through 8 frames per mood at %d FPS", CONFIG_GOLDIE_ANIM_FPS);
     ESP_LOGI(TAG, "Swipe right from left edge to open side panel, swipe down to see AI Assistant");
 }
 
 /**
  * @brief Open the side panel with slide animation
  */
+/**
+ * @brief Set one water parameter of a tank and re-score it
+ * @param param 0 ammonia, 1 nitrite, 2 nitrate, 3 pH (dashboard.h)
+ */
+static void set_tank_param(tank_t *t, uint8_t param, float value)
+{
+    static const float max_val[DASHBOARD_PARAM_COUNT] = { 5.0f, 5.0f, 200.0f, 14.0f };  // Display caps
+    float *field[DASHBOARD_PARAM_COUNT] = { &t->ammonia_ppm, &t->nitrite_ppm, &t->nitrate_ppm, &t->ph_level };
+    if (param >= DASHBOARD_PARAM_COUNT) {
+        return;
+    }
+    if (value < 0.0f) value = 0.0f;
+    if (value > max_val[param]) value = max_val[param];
+    
+    bool changed = *field[param] != value;
+    *field[param] = value;
+    if (changed) dash_state_changed(t);
+    if (param == DASHBOARD_PARAM_PH) {
+        if (t == tank) {
+            dial_params[1].current_val = value;  // Update pH calibration dial
+        }
+        ESP_LOGI(TAG, "Tank %u pH updated: %.2f", (unsigned)t->id + 1, value);
+    }
+    
+    // Re-evaluate mood when a parameter changes; the advice is the shown tank's
+    evaluate_and_update_mood(t);
+    if (t == tank) {
+        update_ai_assistant();
+    }
+}
+
+/**
+ * @brief A parameter from outside the UI (probes, web API, ESP-NOW): recorded
+ *        for replay, and ignored while a replay supplies them (input_rec.h)
+ */
+static void external_param(tank_t *t, uint8_t param, float value)
+{
+    if (!input_rec_live(INPUT_REC_PARAM)) {
+        return;
+    }
+    uint8_t rec[1 + sizeof(float)] = {t->id};
+    memcpy(&rec[1], &value, sizeof(value));
+    input_rec_put(INPUT_REC_PARAM, param, rec, sizeof(rec));
+    set_tank_param(t, param, value);
+}
+
+static void param_replay_sink(uint8_t param, const uint8_t *data, size_t len)
+{
+    float value;
+    if (len != 1 + sizeof(value)) {
+        return;
+    }
+    memcpy(&value, &data[1], sizeof(value));
+    if (lvgl_port_lock(REPLAY_LOCK_MS)) {
+        dashboard_update_tank_param(data[0], param, value);
+        lvgl_port_unlock();
+    }
+}
+
+static void activity_replay_sink(uint8_t valid, const uint8_t *data, size_t len)
+{
+    uint16_t permille;
+    if (len != sizeof(permille)) {
+        return;
+    }
+    memcpy(&permille, data, sizeof(permille));
+    if (lvgl_port_lock(REPLAY_LOCK_MS)) {
+        dashboard_update_activity(valid != 0, permille);
+        lvgl_port_unlock();
+    }
+}
+
 /**
  * @brief Update ammonia level (ppm)
  * @param value Ammonia in ppm (0 is ideal, >0.5 is critical)
  */
 void dashboard_update_ammonia(float value)
 {
-    if (value < 0.0f) value = 0.0f;
-    if (value > 5.0f) value = 5.0f;  // Cap at reasonable max for display
-    
-    ammonia_ppm = value;
-    
-    // Re-evaluate mood when ammonia changes
-    evaluate_and_update_mood();
-    update_ai_assistant();
+    external_param(tank, DASHBOARD_PARAM_AMMONIA, value);
 }
 
 /**
@@ -3745,14 +3308,7 @@ void dashboard_update_ammonia(float value)
  */
 void dashboard_update_nitrite(float value)
 {
-    if (value < 0.0f) value = 0.0f;
-    if (value > 5.0f) value = 5.0f;  // Cap at reasonable max for display
-    
-    nitrite_ppm = value;
-    
-    // Re-evaluate mood when nitrite changes
-    evaluate_and_update_mood();
-    update_ai_assistant();
+    external_param(tank, DASHBOARD_PARAM_NITRITE, value);
 }
 
 /**
@@ -3761,14 +3317,7 @@ void dashboard_update_nitrite(float value)
  */
 void dashboard_update_nitrate(float value)
 {
-    if (value < 0.0f) value = 0.0f;
-    if (value > 200.0f) value = 200.0f;  // Cap at reasonable max for display
-    
-    nitrate_ppm = value;
-    
-    // Re-evaluate mood when nitrate changes
-    evaluate_and_update_mood();
-    update_ai_assistant();
+    external_param(tank, DASHBOARD_PARAM_NITRATE, value);
 }
 
 /**
@@ -3777,17 +3326,85 @@ void dashboard_update_nitrate(float value)
  */
 void dashboard_update_ph(float value)
 {
-    if (value < 0.0f) value = 0.0f;
-    if (value > 14.0f) value = 14.0f;
-    
-    ph_level = value;
-    dial_params[1].current_val = value;  // Update pH calibration dial
+    external_param(tank, DASHBOARD_PARAM_PH, value);
+}
+
+void dashboard_update_tank_param(uint8_t id, uint8_t param, float value)
+{
+    tank_t *t = tank_get(id);
+    if (t != NULL) {
+        external_param(t, param, value);
+    }
+}
+
+/**
+ * @brief Update fish activity from the camera (it watches the first tank)
+ * @param valid false while there is no reading (lights off, camera gone)
+ * @param permille Share of the view moving
+ */
+void dashboard_update_activity(bool valid, uint16_t permille)
+{
+    tank_t *t = tank_get(0);
+    if (!input_rec_live(INPUT_REC_ACTIVITY) ||
+        (valid == t->has_activity && (!valid || permille == t->activity_pm))) {
+        return;
+    }
+    input_rec_put(INPUT_REC_ACTIVITY, valid ? 1 : 0, &permille, sizeof(permille));
+    t->has_activity = valid;
+    t->activity_pm = valid ? permille : 0;
+    evaluate_and_update_mood(t);
+}
+
+/**
+ * @brief "TANK 2" on the animation screen
+ */
+static void tank_label_refresh(void)
+{
+    if (tank_label != NULL) {
+        lv_label_set_text_fmt(tank_label, LV_SYMBOL_LOOP " TANK %u", (unsigned)tank->id + 1);
+    }
+}
+
+/**
+ * @brief Tank label tapped: show the next tank
+ */
+static void tank_label_event_cb(lv_event_t *e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+        dashboard_select_tank((uint8_t)((tank->id + 1) % TANK_MAX));
+    }
+}
+
+bool dashboard_select_tank(uint8_t id)
+{
+    tank_t *t = tank_get(id);
+    if (t == NULL) {
+        return false;
+    }
+    if (t == tank) {
+        return true;
+    }
+    // Popups show the old tank's values; nothing else is rebuilt
+    close_popup();
+    tank = t;
+    history_index_select(id);
+    dial_params[1].current_val = tank->ph_level;
+    ESP_LOGI(TAG, "Tank %u on screen", (unsigned)id + 1);
     
-    ESP_LOGI(TAG, "pH updated: %.2f", ph_level);
+    tank_label_refresh();
+    update_button_colors();
+    refresh_weekly_calendar_dots();
+    dash_live_publish();
+    show_local_advice(NULL);
     
-    // Re-evaluate mood when pH changes
-    evaluate_and_update_mood();
-    update_ai_assistant();
+    // logic_task follows the shown tank (AI advice, mood reason); no re-score
+    send_params_to_logic(0);
+    return true;
+}
+
+uint8_t dashboard_tank(void)
+{
+    return tank->id;
 }
 
 /**
@@ -3796,7 +3413,9 @@ void dashboard_update_ph(float value)
 uint32_t dashboard_get_feed_log(uint8_t day)
 {
     if (day >= LOG_DAYS) return 0;
-    return feed_log[day];
+    dash_live_t live;
+    dash_store_read(&live);
+    return live.feed_log[day];
 }
 
 /**
@@ -3805,7 +3424,9 @@ uint32_t dashboard_get_feed_log(uint8_t day)
 uint32_t dashboard_get_water_log(uint8_t day)
 {
     if (day >= LOG_DAYS) return 0;
-    return water_log[day];
+    dash_live_t live;
+    dash_store_read(&live);
+    return live.water_log[day];
 }
 
 /**
@@ -3819,13 +3440,13 @@ void dashboard_print_logs(void)
     
     ESP_LOGI(TAG, "Feed Logs (last 7 days):");
     for (int i = 0; i < LOG_DAYS; i++) {
-        ESP_LOGI(TAG, "  Day %d: %lu feeds", i, feed_log[i]);
+        ESP_LOGI(TAG, "  Day %d: %lu feeds", i, tank->feed_log[i]);
     }
     ESP_LOGI(TAG, "");
     
     ESP_LOGI(TAG, "Water Cleaning Logs (last 7 days):");
     for (int i = 0; i < LOG_DAYS; i++) {
-        ESP_LOGI(TAG, "  Day %d: %lu cleanings", i, water_log[i]);
+        ESP_LOGI(TAG, "  Day %d: %lu cleanings", i, tank->water_log[i]);
     }
     ESP_LOGI(TAG, "");
     
@@ -3837,6 +3458,17 @@ void dashboard_print_logs(void)
                  dial_params[i].min_val,
                  dial_params[i].max_val);
     }
+    ESP_LOGI(TAG, "");
+    ui_fonts_log_stats();
+    ui_heap_log_stats();
+    ui_inbox_log_stats();
+    reminders_log_stats();
+    history_agg_log_stats();
+    param_series_log_stats();
+    msg_bus_log_stats();
+    queue_watch_log_stats();
+    text_buf_log_stats();
+    boot_trace_dump();
     ESP_LOGI(TAG, "==========================");
 }
 
@@ -3868,32 +3500,37 @@ void dashboard_set_animation_category(uint8_t category)
     // STEP 1: Reset frame index to 0 (start of new emotion sequence)
     // ═════════════════════════════════════════════════════════════════════════
     current_category = category;
-    current_frame = 0;
+    // Park before the first frame so the next timer advance lands on frame 0
+    // (not the loop start), which is the frame requested below (often
+    // already prefetched)
+    current_frame = ANIM_TIMELINE_ENTRY;
+    
+    // Make the next deadline due now so the first frame shows immediately
+    frame_pacer_restart(&anim_pacer, esp_timer_get_time());
     
-    // Reset frame update timer so first frame shows immediately
-    last_frame_update_time = (uint32_t)(esp_timer_get_time() / 1000000) - 3;  // Force immediate update
+    if (frame_map_available()) {
+        // Zero-copy frames: the next timer tick points straight at frame 0
+        return;
+    }
     
     // ═════════════════════════════════════════════════════════════════════════
-    // STEP 2: Invalidate old buffers (they contain wrong emotion frames)
+    // STEP 2: Drop pending requests (they are for the old emotion)
     // ═════════════════════════════════════════════════════════════════════════
-    buffer_a_ready = false;
-    buffer_b_ready = false;
+    // Frames already decoded for the old emotion still arrive on the ready
+    // queue; animation_timer_cb hands those slots straight back to the pool.
+    xQueueReset(queue_anim_frame_request);
+    requests_in_flight = 0;
+    last_requested_frame = ANIM_TIMELINE_ENTRY;
     
     // ═════════════════════════════════════════════════════════════════════════
-    // STEP 3: Request frame 0 of new emotion (NON-BLOCKING queue send)
+    // STEP 3: Request frames 0.. of new emotion (NON-BLOCKING queue send)
     // ═════════════════════════════════════════════════════════════════════════
-    uint8_t abs_frame = category * 8;  // Each emotion has 8 frames
-    
-    anim_frame_request_msg_t request = { .frame_index = abs_frame };
-    if (xQueueOverwrite(queue_anim_frame_request, &request) != pdTRUE) {
-        ESP_LOGE(TAG, "Failed to request frame 0 of new emotion");
-    } else {
-        ESP_LOGI(TAG, "Requested frame 0 of %s emotion (abs_frame=%d)",
-                 category == 0 ? "HAPPY" : (category == 1 ? "SAD" : "ANGRY"), abs_frame);
-    }
+    request_frames_ahead();
+    ESP_LOGI(TAG, "Requested frame 0 of %s emotion (abs_frame=%d)",
+             category == 0 ? "HAPPY" : (category == 1 ? "SAD" : "ANGRY"), category * 8);
     
     // Note: Display will update when storage_task finishes loading frame 0
-    // static_frame_timer_cb will detect buffer_ready flag and swap pointer
+    // animation_timer_cb picks it off queue_anim_frame_ready and swaps pointer
 }
 
 /**
@@ -3901,9 +3538,10 @@ void dashboard_set_animation_category(uint8_t category)
  */
 void dashboard_update_calendar(void)
 {
-    // Call the shared date update function to sync both displays
-    date_update_timer_cb(NULL);
-    ESP_LOGI(TAG, "Calendar synchronized via date timer");
+    // Any task: the day clock re-syncs in LVGL context; feed reminders
+    // move to the new local time at once
+    reminders_clock_changed();
+    ui_inbox_post(UI_MSG_TIME_CHANGED);
 }
 
 /**
@@ -3912,7 +3550,17 @@ void dashboard_update_calendar(void)
  */
 uint8_t dashboard_get_animation_category(void)
 {
-    return (uint8_t)current_category;
+    dash_live_t live;
+    dash_store_read(&live);
+    return live.anim_category;
+}
+
+void dashboard_get_anim_counts(uint32_t *presented, uint32_t *skipped)
+{
+    dash_live_t live;
+    dash_store_read(&live);
+    *presented = live.frames_presented;
+    *skipped = live.frames_skipped;
 }
 
 /**
@@ -3921,11 +3569,12 @@ uint8_t dashboard_get_animation_category(void)
  */
 void dashboard_simulate_feed_time(float hours_ago)
 {
-    uint32_t current_time = get_current_time_seconds();
-    last_feed_time = current_time - (uint32_t)(hours_ago * 3600.0f);
+    uint32_t current_time = time_svc_uptime_s();
+    tank->last_feed_time = current_time - (uint32_t)(hours_ago * 3600.0f);
+    dash_state_changed(tank);
     
     // Re-evaluate mood and update button colors
-    evaluate_and_update_mood();
+    evaluate_and_update_mood(tank);
 }
 
 /**
@@ -3934,10 +3583,11 @@ void dashboard_simulate_feed_time(float hours_ago)
  */
 void dashboard_simulate_clean_time(float days_ago)
 {
-    uint32_t current_time = get_current_time_seconds();
-    last_clean_time = current_time - (uint32_t)(days_ago * 86400.0f);
+    uint32_t current_time = time_svc_uptime_s();
+    tank->last_clean_time = current_time - (uint32_t)(days_ago * 86400.0f);
+    dash_state_changed(tank);
     
     // Re-evaluate mood and update button colors
-    evaluate_and_update_mood();
+    evaluate_and_update_mood(tank);
 }
 
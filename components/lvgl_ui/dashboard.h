@@ -3,6 +3,9 @@
 
 #include <stdio.h>
 #include "lvgl.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "mood/mood_engine.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -13,6 +16,35 @@ extern "C" {
  */
 void dashboard_init(void);
 
+/**
+ * @brief Give the dashboard the LCD handles for direct animation blits
+ *
+ * Optional - without it every frame goes through LVGL. Call after the
+ * LVGL display is registered (esp_lvgl_port owns the same handles).
+ */
+void dashboard_set_panel(esp_lcd_panel_handle_t panel, esp_lcd_panel_io_handle_t io);
+
+/**
+ * @brief Pause the animation while the device idles, resume it on wake
+ *
+ * Called by the idle manager (power_idle.h) with the LVGL lock held.
+ */
+void dashboard_set_idle(bool idle);
+
+/**
+ * @brief Animation rate and Blynk snapshot period of the power profile
+ *
+ * Called by the power governor (power_gov.h) with the LVGL lock held; fps
+ * is capped at CONFIG_GOLDIE_ANIM_FPS.
+ */
+void dashboard_set_pacing(uint8_t fps, uint32_t snapshot_period_ms);
+
+/**
+ * @brief Scroll the dashboard by one step (LVGL lock held)
+ * @param dir >0 down the page, <0 back up
+ */
+void dashboard_scroll_step(int dir);
+
 /**
  * @brief Update ammonia level (ppm)
  * @param value Ammonia in ppm (0 is ideal, >0.5 is critical)
@@ -37,15 +69,55 @@ void dashboard_update_nitrate(float value);
  */
 void dashboard_update_ph(float value);
 
+// Water parameters of dashboard_update_tank_param() (sensor_param_t order)
+typedef enum {
+    DASHBOARD_PARAM_AMMONIA = 0,
+    DASHBOARD_PARAM_NITRITE,
+    DASHBOARD_PARAM_NITRATE,
+    DASHBOARD_PARAM_PH,
+    DASHBOARD_PARAM_COUNT
+} dashboard_param_t;
+
+/**
+ * @brief Update a water parameter of one tank, shown or not
+ *
+ * The dashboard_update_ammonia() ... _ph() setters above edit the tank on
+ * screen; probes that belong to a tank use this. All of them, and
+ * dashboard_update_activity(), are recorded by the input recorder and
+ * ignored while it replays a recording (input_rec.h).
+ * @param tank 0 .. TANK_MAX-1 (state/tank_registry.h)
+ * @param param dashboard_param_t
+ */
+void dashboard_update_tank_param(uint8_t tank, uint8_t param, float value);
+
 /**
- * @brief Get feed log for a specific day
+ * @brief Show another tank: its parameters, schedule, week and advice
+ *        (LVGL lock held; the tank label on the animation screen cycles them)
+ * @return false if there is no such tank
+ */
+bool dashboard_select_tank(uint8_t tank);
+
+/**
+ * @brief Tank on screen (LVGL lock held)
+ */
+uint8_t dashboard_tank(void);
+
+/**
+ * @brief Update fish activity from the camera (fish_activity.h) - the first tank's
+ * @param valid false while there is no reading (lights off, camera gone)
+ * @param permille Share of the view moving
+ */
+void dashboard_update_activity(bool valid, uint16_t permille);
+
+/**
+ * @brief Get feed log for a specific day (any task)
  * @param day Day index (0-6 for last 7 days)
  * @return Number of feed events
  */
 uint32_t dashboard_get_feed_log(uint8_t day);
 
 /**
- * @brief Get water cleaning log for a specific day
+ * @brief Get water cleaning log for a specific day (any task)
  * @param day Day index (0-6 for last 7 days)
  * @return Number of water cleaning events
  */
@@ -63,13 +135,22 @@ void dashboard_print_logs(void);
 void dashboard_set_animation_category(uint8_t category);
 
 /**
- * @brief Get current animation category
+ * @brief Get current animation category (any task)
  * @return Current category (0=Happy, 1=Sad, 2=Angry)
  */
 uint8_t dashboard_get_animation_category(void);
 
 /**
- * @brief Update calendar display with current date/time
+ * @brief Animation frames shown and deadlines skipped while late, since boot
+ * (any task; published once a second, state/dash_store.h)
+ */
+void dashboard_get_anim_counts(uint32_t *presented, uint32_t *skipped);
+
+/**
+ * @brief The wall clock was set or re-synced, or TZ changed (any task)
+ *
+ * Date labels and the week strip follow at once; otherwise they change
+ * only at local midnight.
  */
 void dashboard_update_calendar(void);
 
@@ -86,16 +167,21 @@ void dashboard_simulate_feed_time(float hours_ago);
 void dashboard_simulate_clean_time(float days_ago);
 
 /**
- * @brief Latest medication calculation result (for AI integration)
- * External access to medication calculator data
+ * @brief Switch the tank's species profile (mood/mood_profiles.h)
+ *
+ * Swaps the mood thresholds, takes the profile's feeding and water change
+ * defaults, saves the choice for the next boot and re-evaluates the mood.
+ * Call from the LVGL task (or with the LVGL lock held).
+ * @param name Built-in preset or flashed profile name
+ * @return false if no such profile
  */
-extern char latest_med_calculation[512];
+bool dashboard_set_profile(const char *name);
 
-/**
- * @brief Latest mood reason explanation (for AI integration)
- * External access to mood evaluation reasons
- */
-extern char latest_mood_reason[512];
+// Latest medication calculation (for AI integration): dash_live_t.med_calc
+// in state/dash_store.h
+
+// Latest mood reason (for AI integration): built on demand by
+// mood_engine_latest_reason() in mood/mood_engine.h
 
 #ifdef __cplusplus
 }
@@ -1,4 +1,5 @@
 #include "lvgl_ui.h"
+#include "sdkconfig.h"
 #include "tileview/system_tile.h"
 #include "tileview/qmi8658_tile.h"
 #include "tileview/rgb_tile.h"
@@ -6,6 +7,7 @@
 #include "tileview/camera_tile.h"
 #include "tileview/axp2101_tile.h"
 #include "tileview/wifi_tile.h"
+#include "tileview/diag_tile.h"
 void lvgl_ui_init(void)
 {
     lv_obj_t *tileview = lv_tileview_create(lv_scr_act());
@@ -27,11 +29,17 @@ void lvgl_ui_init(void)
     lv_obj_t *qmi8658_tile = lv_tileview_add_tile(tileview, 3, 0, LV_DIR_LEFT | LV_DIR_RIGHT);
     qmi8658_tile_init(qmi8658_tile);
 
-    lv_obj_t *camera_tile = lv_tileview_add_tile(tileview, 4, 0, LV_DIR_LEFT | LV_DIR_RIGHT);
+    uint8_t col = 4;                    // The camera tile only with CONFIG_GOLDIE_CAMERA
+#if CONFIG_GOLDIE_CAMERA
+    lv_obj_t *camera_tile = lv_tileview_add_tile(tileview, col++, 0, LV_DIR_LEFT | LV_DIR_RIGHT);
     camera_tile_init(camera_tile);
+#endif
 
-    lv_obj_t *wifi_tile = lv_tileview_add_tile(tileview, 5, 0, LV_DIR_LEFT | LV_DIR_RIGHT);
+    lv_obj_t *wifi_tile = lv_tileview_add_tile(tileview, col++, 0, LV_DIR_LEFT | LV_DIR_RIGHT);
     wifi_tile_init(wifi_tile);
+
+    lv_obj_t *diag_tile = lv_tileview_add_tile(tileview, col, 0, LV_DIR_LEFT);
+    diag_tile_init(diag_tile);
     
 
 }
\ No newline at end of file
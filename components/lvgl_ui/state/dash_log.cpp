@@ -0,0 +1,48 @@
+#include "dash_log.h"
+#include "sd_logger.h"
+#include "esp_log.h"
+#include <errno.h>
+#include <time.h>
+#include <sys/stat.h>
+
+static const char *TAG = "dash_log";
+
+extern "C" bool dash_log_dir_ensure(void)
+{
+    struct stat st;
+    if (stat(DASH_LOG_DIR, &st) == -1) {
+        if (mkdir(DASH_LOG_DIR, 0700) == -1) {
+            ESP_LOGE(TAG, "Failed to create log directory: %s (errno=%d)", DASH_LOG_DIR, errno);
+            return false;
+        }
+        ESP_LOGI(TAG, "Created log directory: %s", DASH_LOG_DIR);
+    }
+    return true;
+}
+
+extern "C" void dash_log_medication(const dash_log_med_t *med)
+{
+    const float values[] = { med->product_amount, med->per_volume, med->tank_size, med->dosage_ml };
+    uint8_t flags = (uint8_t)(med->unit_type & SD_LOG_MED_UNIT_MASK);
+    if (med->per_gallons) flags |= SD_LOG_MED_PER_GALLONS;
+    if (med->tank_gallons) flags |= SD_LOG_MED_TANK_GALLONS;
+    sd_logger_log(SD_LOG_MEDICATION, time(NULL), flags, values, 4);
+}
+
+extern "C" void dash_log_parameters(float ammonia, float nitrate, float nitrite, float ph)
+{
+    const float values[] = { ammonia, nitrate, nitrite, ph };
+    sd_logger_log(SD_LOG_PARAMETERS, time(NULL), 0, values, 4);
+}
+
+extern "C" void dash_log_water_change(uint8_t interval_days)
+{
+    const float value = interval_days;
+    sd_logger_log(SD_LOG_WATER_CHANGE, time(NULL), 0, &value, 1);
+}
+
+extern "C" void dash_log_feed(uint8_t feeds_per_day)
+{
+    const float value = feeds_per_day;
+    sd_logger_log(SD_LOG_FEED, time(NULL), 0, &value, 1);
+}
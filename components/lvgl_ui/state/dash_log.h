@@ -0,0 +1,48 @@
+#ifndef __DASH_LOG_H__
+#define __DASH_LOG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DASHBOARD ACTIVITY LOG (SD)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Feed, water change, parameter and dosage records of the dashboard. Each
+// call only queues a record (sd_logger_log, no card access in LVGL
+// context); the sd_logger worker appends them to <name>_YYYYMMDD.bin in
+// sector blocks and tools/sdlog_to_csv.py turns those into CSV.
+// dash_log_dir_ensure() runs once at init and creates DASH_LOG_DIR.
+
+#define DASH_LOG_DIR  "/sdcard/logs"
+
+typedef struct {
+    float product_amount;               // Product per per_volume
+    float per_volume;
+    float tank_size;
+    float dosage_ml;
+    uint8_t unit_type;                  // SD_LOG_MED_UNIT_MASK
+    bool per_gallons;
+    bool tank_gallons;
+} dash_log_med_t;
+
+/**
+ * @brief Create the log directory if needed
+ * @return false when the card has none and it cannot be made
+ */
+bool dash_log_dir_ensure(void);
+
+void dash_log_medication(const dash_log_med_t *med);
+void dash_log_parameters(float ammonia, float nitrate, float nitrite, float ph);
+void dash_log_water_change(uint8_t interval_days);
+void dash_log_feed(uint8_t feeds_per_day);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __DASH_LOG_H__
@@ -0,0 +1,124 @@
+#include "dash_state.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "lvgl.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "dash_state";
+
+static dash_state_collect_cb_t collect_cb = NULL;
+static lv_timer_t *save_timer = NULL;
+static uint32_t dirty = 0;              // Bit per tank
+
+/**
+ * @brief NVS key of a tank's blob ("state", "state1", ...)
+ */
+static void key_for(uint8_t tank, char *key, size_t len)
+{
+    if (tank == 0) {
+        snprintf(key, len, "%s", DASH_STATE_NVS_KEY);
+    } else {
+        snprintf(key, len, "%s%u", DASH_STATE_NVS_KEY, (unsigned)tank);
+    }
+}
+
+extern "C" bool dash_state_load(uint8_t tank, dash_state_t *out)
+{
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    key_for(tank, key, sizeof(key));
+    nvs_handle_t nvs;
+    if (nvs_open(DASH_STATE_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
+    }
+    size_t len = sizeof(*out);
+    esp_err_t err = nvs_get_blob(nvs, key, out, &len);
+    nvs_close(nvs);
+
+    if (err != ESP_OK) {
+        if (err != ESP_ERR_NVS_NOT_FOUND) {
+            ESP_LOGW(TAG, "Reading state failed: %s", esp_err_to_name(err));
+        }
+        return false;
+    }
+    if (len != sizeof(*out) || out->version != DASH_STATE_VERSION || out->size != sizeof(*out)) {
+        ESP_LOGW(TAG, "Stored %s is version %u (%u bytes), expected %d - using defaults",
+                 key, (unsigned)out->version, (unsigned)len, DASH_STATE_VERSION);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Write one tank's state
+ */
+static esp_err_t save_tank(nvs_handle_t nvs, uint8_t tank)
+{
+    dash_state_t state;
+    memset(&state, 0, sizeof(state));
+    collect_cb(tank, &state);
+    state.version = DASH_STATE_VERSION;
+    state.size = sizeof(state);
+
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    key_for(tank, key, sizeof(key));
+    return nvs_set_blob(nvs, key, &state, sizeof(state));
+}
+
+/**
+ * @brief Edits have settled - write each changed tank once
+ */
+static void save_timer_cb(lv_timer_t *timer)
+{
+    lv_timer_pause(timer);
+    if (collect_cb == NULL || dirty == 0) {
+        return;
+    }
+
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(DASH_STATE_NVS_NS, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "NVS unavailable (%s) - state applies until reboot", esp_err_to_name(err));
+        return;
+    }
+    uint32_t saved = dirty;
+    for (uint8_t t = 0; t < 32 && err == ESP_OK; t++) {
+        if ((saved & (1u << t)) != 0) {
+            err = save_tank(nvs, t);
+        }
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Saving state failed: %s", esp_err_to_name(err));
+        return;                         // Stays dirty: the next edit tries again
+    }
+    dirty = 0;
+    ESP_LOGI(TAG, "State saved (tanks 0x%02x, %u bytes each)", (unsigned)saved, (unsigned)sizeof(dash_state_t));
+}
+
+extern "C" void dash_state_init(dash_state_collect_cb_t collect)
+{
+    collect_cb = collect;
+    if (save_timer == NULL) {
+        save_timer = lv_timer_create(save_timer_cb, DASH_STATE_SAVE_MS, NULL);
+        if (save_timer == NULL) {
+            ESP_LOGE(TAG, "No timer - state is not saved");
+            return;
+        }
+        lv_timer_pause(save_timer);
+    }
+}
+
+extern "C" void dash_state_mark_dirty(uint8_t tank)
+{
+    if (save_timer == NULL || tank >= 32) {
+        return;
+    }
+    dirty |= 1u << tank;
+    lv_timer_reset(save_timer);
+    lv_timer_resume(save_timer);
+}
@@ -0,0 +1,89 @@
+#ifndef __DASH_STATE_H__
+#define __DASH_STATE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DASHBOARD STATE IN NVS (ONE VERSIONED BLOB)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Latest water parameters, feed schedule, intervals and the last feed /
+// water change, kept in NVS (namespace "goldie_dash", key "state") as one
+// dash_state_t. dash_state_load() is a single nvs_get_blob() at boot; a
+// blob of another version or size is ignored and the defaults stay.
+// Every tank (tank_registry.h) has its own blob: tank 0 keeps "state", so
+// a single-tank device reads what it always did, the others "state1"...
+//
+// Changes only set a dirty bit for the tank: dash_state_mark_dirty()
+// (re)arms an LVGL timer, and once nothing has changed for
+// DASH_STATE_SAVE_MS the owner's collect callback fills a fresh
+// dash_state_t for each dirty tank, which is written. A burst of edits
+// costs one NVS write per tank touched; nothing is written while idle.
+//
+// The last feed / water change are stored as ages at `saved_wall`; with
+// the clock set at boot the time the device was off is added on restore.
+// LVGL context only.
+
+#ifndef CONFIG_GOLDIE_STATE_SAVE_MS
+#define CONFIG_GOLDIE_STATE_SAVE_MS 5000
+#endif
+
+#define DASH_STATE_NVS_NS      "goldie_dash"
+#define DASH_STATE_NVS_KEY     "state"
+#define DASH_STATE_VERSION     1
+#define DASH_STATE_SAVE_MS     CONFIG_GOLDIE_STATE_SAVE_MS
+#define DASH_STATE_FEED_TIMES  6
+
+typedef struct {
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t enabled;
+    uint8_t reserved;
+} dash_state_feed_time_t;
+
+typedef struct {
+    uint16_t version;                   // DASH_STATE_VERSION
+    uint16_t size;                      // sizeof(dash_state_t)
+    float ammonia_ppm;
+    float nitrite_ppm;
+    float nitrate_ppm;
+    float ph_level;
+    uint32_t saved_wall;                // Wall clock of the save, 0 = clock not set
+    uint32_t feed_age_s;                // Since the last feed, at saved_wall
+    uint32_t clean_age_s;               // Since the last water change, at saved_wall
+    uint32_t planned_feed_interval;     // Seconds
+    uint32_t planned_water_change_interval;  // Days
+    uint8_t feeds_per_day;
+    uint8_t water_interval_days;
+    uint16_t reserved;
+    dash_state_feed_time_t feed_times[DASH_STATE_FEED_TIMES];
+} dash_state_t;
+
+typedef void (*dash_state_collect_cb_t)(uint8_t tank, dash_state_t *out);
+
+/**
+ * @brief Read the stored state of a tank (one NVS read)
+ * @return false if there is none, or it has another version / size
+ */
+bool dash_state_load(uint8_t tank, dash_state_t *out);
+
+/**
+ * @brief Register the callback that fills a dash_state_t for a save
+ */
+void dash_state_init(dash_state_collect_cb_t collect);
+
+/**
+ * @brief Something persisted of the tank changed - save once edits have settled
+ */
+void dash_state_mark_dirty(uint8_t tank);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,32 @@
+#include "dash_store.h"
+#include <string.h>
+
+// Two copies: a publish writes the one readers were not sent to, then
+// bumps seq, which selects it (seq & 1). A reader that started on the old
+// copy only has to retry if a second publish began overwriting it.
+static dash_live_t live[2];
+static uint32_t seq = 0;                    // 0 = nothing published yet
+
+extern "C" void dash_store_publish(const dash_live_t *src)
+{
+    uint32_t s = __atomic_load_n(&seq, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);    // Readers see seq moved before the copy changes
+    memcpy(&live[(s + 1) & 1], src, sizeof(*src));
+    __atomic_store_n(&seq, s + 1, __ATOMIC_RELEASE);
+}
+
+extern "C" uint32_t dash_store_read(dash_live_t *out)
+{
+    while (true) {
+        uint32_t s = __atomic_load_n(&seq, __ATOMIC_ACQUIRE);
+        if (s == 0) {
+            memset(out, 0, sizeof(*out));
+            return 0;
+        }
+        memcpy(out, &live[s & 1], sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);    // The copy completes before the re-check
+        if (__atomic_load_n(&seq, __ATOMIC_RELAXED) == s) {
+            return s;
+        }
+    }
+}
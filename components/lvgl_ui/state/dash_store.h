@@ -0,0 +1,75 @@
+#ifndef __DASH_STORE_H__
+#define __DASH_STORE_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DASHBOARD LIVE STATE (ONE WRITER, LOCK-FREE READERS)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// The dashboard owns the tank state - parameters, feed / water change
+// times and logs, mood, animation counts and the latest dosage
+// calculation - and edits it in LVGL context only. After each change it
+// publishes a copy here as one dash_live_t; other tasks (device API, AI
+// worker, soak test) read that copy instead of the dashboard's statics,
+// without lvgl_port_lock, and so do the views in ui/ (log popups,
+// calendar, history). With several tanks (tank_registry.h) the copy is of
+// the tank on screen.
+//
+// Two copies and a version counter (a double-buffered seqlock): a publish
+// fills the copy readers are not using, then bumps the version, which
+// selects it. dash_store_read() copies the selected one and retries only
+// if the version moved meanwhile - a second publish overlapping the copy.
+// Neither side ever waits on the other, so a low-priority writer
+// preempted mid-publish cannot stall a reader.
+//
+// dash_store_publish(): LVGL context only. dash_store_read(): any task.
+
+#define DASH_LIVE_DAYS     7                // The week of feed / water logs
+#define DASH_LIVE_MED_LEN  256              // Latest dosage calculation, for the AI prompt
+#define DASH_LIVE_FEED_TIMES 6             // Planned feed times (DASH_STATE_FEED_TIMES)
+#define DASH_LIVE_NO_FEED  0xFFFF           // feed_minute of a disabled feed time
+
+typedef struct {
+    float ammonia_ppm;
+    float nitrite_ppm;
+    float nitrate_ppm;
+    float ph_level;
+    uint32_t last_feed_time;                // Seconds, time_svc_uptime_s()
+    uint32_t last_clean_time;
+    uint32_t planned_feed_interval;         // Seconds
+    uint32_t planned_water_change_interval; // Days
+    uint32_t feed_log[DASH_LIVE_DAYS];      // Clicks per day, by tm_yday % 7
+    uint32_t water_log[DASH_LIVE_DAYS];
+    uint16_t feed_minute[DASH_LIVE_FEED_TIMES]; // Planned feed times, minute of the day
+    uint32_t frames_presented;              // Animation frames since boot
+    uint32_t frames_skipped;
+    int16_t mood_total;                     // Sum of the factor scores
+    uint8_t category;                       // 0=Happy, 1=Sad, 2=Angry
+    uint8_t anim_category;                  // Animation's: the worst tank
+    uint8_t current_day;                    // Today's log slot
+    uint8_t feeds_per_day;                  // Enabled planned feed times
+    uint8_t tank;                           // Whose state this is (tank_registry.h)
+    char med_calc[DASH_LIVE_MED_LEN];       // "" until the calculator was used
+} dash_live_t;
+
+/**
+ * @brief Replace the published state (LVGL context only)
+ */
+void dash_store_publish(const dash_live_t *live);
+
+/**
+ * @brief Copy the latest published state (any task, never blocks)
+ * @return Version of the copy (grows with each publish), 0 = nothing published yet (out zeroed)
+ */
+uint32_t dash_store_read(dash_live_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __DASH_STORE_H__
@@ -0,0 +1,47 @@
+#include "tank_registry.h"
+#include <string.h>
+
+static tank_t tanks[TANK_MAX];
+
+static const tank_feed_time_t DEFAULT_FEEDS[TANK_FEED_TIMES] = {
+    {8, 0, true},   // 8:00 AM
+    {14, 0, true},  // 2:00 PM
+    {20, 0, true},  // 8:00 PM
+    {0, 0, false},
+    {0, 0, false},
+    {0, 0, false},
+};
+
+extern "C" void tank_registry_init(uint32_t now)
+{
+    for (uint8_t i = 0; i < TANK_MAX; i++) {
+        tank_t *t = &tanks[i];
+        memset(t, 0, sizeof(*t));
+        t->id = i;
+        t->nitrate_ppm = 5.0f;
+        t->ph_level = 7.0f;
+        t->last_feed_time = now;
+        t->last_clean_time = now;
+        t->planned_feed_interval = 28800;         // 8 hours
+        t->planned_water_change_interval = 7;
+        t->feeds_per_day = 2;
+        t->water_interval_days = 7;
+        memcpy(t->feed_times, DEFAULT_FEEDS, sizeof(t->feed_times));
+    }
+}
+
+extern "C" tank_t *tank_get(uint8_t id)
+{
+    return id < TANK_MAX ? &tanks[id] : NULL;
+}
+
+extern "C" uint8_t tank_registry_worst(void)
+{
+    uint8_t worst = 0;
+    for (const tank_t &t : tanks) {
+        if (t.mood_valid && t.mood.category > worst) {
+            worst = t.mood.category;
+        }
+    }
+    return worst;
+}
@@ -0,0 +1,90 @@
+#ifndef __TANK_REGISTRY_H__
+#define __TANK_REGISTRY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "messages.h"
+#include "state/dash_state.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TANK REGISTRY (PER-TANK DASHBOARD STATE)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Everything the dashboard knows about one tank - water parameters, feed /
+// water change times, schedule, intervals, the week's logs and the latest
+// mood from logic_task - is one tank_t. The registry is a static array of
+// TANK_MAX (CONFIG_GOLDIE_TANK_COUNT) of them: no allocation, and memory
+// grows by sizeof(tank_t) per tank.
+//
+// The dashboard works on the tank on screen through one pointer; switching
+// tanks moves the pointer (and the history index partition, which is kept
+// per tank too) and refreshes what shows it - nothing is rebuilt. Each tank
+// is saved in NVS on its own (dash_state.h) and has its own mood engine
+// instance in logic_task; the animation shows the worst tank's mood.
+//
+// Wired probes, the camera and the SD history belong to tank 0.
+// LVGL context only.
+
+#define TANK_FEED_TIMES  DASH_STATE_FEED_TIMES
+#define TANK_LOG_DAYS    7
+
+typedef struct {
+    uint8_t hour;
+    uint8_t minute;
+    bool enabled;
+} tank_feed_time_t;
+
+typedef struct {
+    uint8_t id;                           // Index in the registry
+    // Water (mood inputs)
+    float ammonia_ppm;                    // ppm (MUST be 0)
+    float nitrite_ppm;                    // ppm (MUST be 0)
+    float nitrate_ppm;                    // ppm (<20 safe, <40 warning)
+    float ph_level;                       // 0-14 (6.5-7.5 ideal for most freshwater)
+    uint16_t activity_pm;                 // Camera activity, permille moving (not persisted)
+    bool has_activity;                    // activity_pm is a current reading
+    // Care
+    uint32_t last_feed_time;              // Uptime of the last feed
+    uint32_t last_clean_time;             // Uptime of the last water change
+    uint32_t planned_feed_interval;       // Seconds
+    uint32_t planned_water_change_interval;  // Days
+    uint8_t feeds_per_day;
+    uint8_t water_interval_days;
+    tank_feed_time_t feed_times[TANK_FEED_TIMES];
+    uint32_t feed_log[TANK_LOG_DAYS];     // Feed clicks per day, by tm_yday % 7 (legacy)
+    uint32_t water_log[TANK_LOG_DAYS];
+    // Mood (logic_task)
+    mood_result_t mood;
+    bool mood_valid;                      // A result has arrived
+    // Restored with the clock not set yet: the off time is added once it is
+    uint32_t saved_wall;                  // 0 = nothing to correct
+    uint32_t restored_feed;
+    uint32_t restored_clean;
+} tank_t;
+
+/**
+ * @brief Give every tank the defaults (3 feeds, weekly water change, ideal water)
+ * @param now time_svc_uptime_s() for the last feed / water change
+ */
+void tank_registry_init(uint32_t now);
+
+/**
+ * @brief Tank `id` (always valid storage)
+ * @return NULL if id >= TANK_MAX
+ */
+tank_t *tank_get(uint8_t id);
+
+/**
+ * @brief Worst mood category among the tanks with a result (0 before any)
+ */
+uint8_t tank_registry_worst(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TANK_REGISTRY_H__
@@ -1,9 +1,9 @@
 
 #include "axp2101_tile.h"
+#include "ui/ui_fonts.h"
 static lv_obj_t *list;
 
-#define XPOWERS_CHIP_AXP2101
-#include "XPowersLib.h"
+#include "esp_axp2101_port.h"
 
 extern XPowersPMU power;
 
@@ -22,20 +22,19 @@ lv_obj_t *label_bldo2_voltage;
 
 
 
+// The power monitor's last reading: no PMU traffic from the UI
 static void axp2101_time_cb(lv_timer_t *timer)
 {
-    lv_label_set_text(label_charging, power.isCharging() ? "YES" : "NO");
-    lv_label_set_text(label_battery_connect, power.isBatteryConnect() ?  "YES" : "NO");
-    lv_label_set_text(label_vbus_in, power.isVbusIn() ?  "YES" : "NO");
-    lv_label_set_text_fmt(label_battery_percent, "%d %%", power.getBatteryPercent());
-    lv_label_set_text_fmt(label_battery_voltage, "%d mV", power.getBattVoltage());
-    lv_label_set_text_fmt(label_vbus_voltage, "%d mV", power.getVbusVoltage());
-    lv_label_set_text_fmt(label_system_voltage, "%d mV", power.getSystemVoltage());
-    lv_label_set_text_fmt(label_dc1_voltage, "%d mV", power.getDC1Voltage());
-    lv_label_set_text_fmt(label_aldo1_voltage, "%d mV", power.getALDO1Voltage());
-    lv_label_set_text_fmt(label_bldo1_voltage, "%d mV", power.getBLDO1Voltage());
-    lv_label_set_text_fmt(label_bldo2_voltage, "%d mV", power.getBLDO2Voltage());
-    
+    pmu_reading_t r;
+    if (!esp_axp2101_port_latest(&r)) {
+        return;
+    }
+    lv_label_set_text(label_charging, r.charging ? "YES" : "NO");
+    lv_label_set_text(label_battery_connect, r.batt_present ?  "YES" : "NO");
+    lv_label_set_text(label_vbus_in, r.vbus_in ?  "YES" : "NO");
+    lv_label_set_text_fmt(label_battery_percent, "%d %%", r.batt_pct);
+    lv_label_set_text_fmt(label_battery_voltage, "%d mV", r.batt_mv);
+    lv_label_set_text_fmt(label_vbus_voltage, "%d mV", r.vbus_mv);
 }
 
 void axp2101_tile_init(lv_obj_t *parent) 
@@ -43,7 +42,7 @@ void axp2101_tile_init(lv_obj_t *parent)
     /*Create a list*/
     list = lv_list_create(parent);
     lv_obj_t *lable =  lv_label_create(parent);
-    lv_obj_set_style_text_font(lable, &lv_font_montserrat_20, LV_PART_MAIN);
+    lv_obj_set_style_text_font(lable, ui_font(UI_FONT_20), LV_PART_MAIN);
     lv_label_set_text(lable, "AXP2101");
     lv_obj_align(lable, LV_ALIGN_TOP_MID, 0, 3);
 
@@ -54,27 +53,27 @@ void axp2101_tile_init(lv_obj_t *parent)
 
     list_item = lv_list_add_btn(list, NULL, "isCharging");
     label_charging = lv_label_create(list_item);
-    lv_label_set_text(label_charging, power.isCharging() ? "YES" : "NO");
+    lv_label_set_text(label_charging, "----");
 
     list_item = lv_list_add_btn(list, NULL, "isBatteryConnect");
     label_battery_connect = lv_label_create(list_item);
-    lv_label_set_text(label_battery_connect, power.isBatteryConnect() ?  "YES" : "NO");
+    lv_label_set_text(label_battery_connect, "----");
 
     list_item = lv_list_add_btn(list, NULL, "isVbusIn");
     label_vbus_in = lv_label_create(list_item);
-    lv_label_set_text(label_vbus_in, power.isVbusIn() ?  "YES" : "NO");
+    lv_label_set_text(label_vbus_in, "----");
 
     list_item = lv_list_add_btn(list, NULL, "BatteryPercent");
     label_battery_percent = lv_label_create(list_item);
-    lv_label_set_text_fmt(label_battery_percent, "%d %%", power.getBatteryPercent());
+    lv_label_set_text(label_battery_percent, "----");
 
     list_item = lv_list_add_btn(list, NULL, "BatteryVoltage");
     label_battery_voltage = lv_label_create(list_item);
-    lv_label_set_text_fmt(label_battery_voltage, "%d mV", power.getBattVoltage());
+    lv_label_set_text(label_battery_voltage, "----");
     
     list_item = lv_list_add_btn(list, NULL, "VbusVoltage");
     label_vbus_voltage = lv_label_create(list_item);
-    lv_label_set_text_fmt(label_vbus_voltage, "%d mV", power.getVbusVoltage());
+    lv_label_set_text(label_vbus_voltage, "----");
 
     list_item = lv_list_add_btn(list, NULL, "SystemVoltage");
     label_system_voltage = lv_label_create(list_item);
@@ -97,5 +96,6 @@ void axp2101_tile_init(lv_obj_t *parent)
     lv_label_set_text_fmt(label_bldo2_voltage, "%d mV", power.getBLDO2Voltage());
 
 
+    // Rails are set once at boot and read once above; the rest is cached
     lv_timer_create(axp2101_time_cb, 1000, NULL);
 }
\ No newline at end of file
@@ -1,52 +1,68 @@
-
 #include "camera_tile.h"
-#include "esp_camera.h"
-
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-#include "freertos/semphr.h"
-
-#include "esp_lvgl_port.h"
+#include "esp_camera_port.h"
+#include "esp_heap_caps.h"
+#include "sdkconfig.h"
+#if CONFIG_GOLDIE_SNAPSHOT
+#include "snapshot.h"
+#define CAMERA_TILE_REFRESH_MS  (1000 / CONFIG_GOLDIE_SNAPSHOT_LIVE_FPS)
+#else
+#define CAMERA_TILE_REFRESH_MS  1000
+#endif
 
 lv_obj_t *cam_ing;
 
-void camera_task(void *arg)
-{
-    camera_fb_t *pic;
-    lv_img_dsc_t img_dsc;
-    img_dsc.header.always_zero = 0;
-    img_dsc.header.w = 320;
-    img_dsc.header.h = 480;
-    img_dsc.data_size = 320 * 480 * 2;
-    img_dsc.header.cf = LV_IMG_CF_TRUE_COLOR;
-    img_dsc.data = NULL;
-    while (1)
-    {
-        pic = esp_camera_fb_get();
+static lv_obj_t *cam_tile;
+static lv_img_dsc_t img_dsc;
+static uint8_t *img_buf = NULL;
+static uint32_t shown_seq = 0;
+static bool live = false;
 
-        if (NULL != pic)
-        {
-            // printf("pic->len = %d\n", pic->len);
-            img_dsc.data = pic->buf;
-            if (lvgl_port_lock(0))
-            {
-                lv_img_set_src(cam_ing, &img_dsc);
-                lvgl_port_unlock();
-            }
-        }
-        esp_camera_fb_return(pic);
+/**
+ * @brief Whether the tile is on screen (its tileview shown, and the active tile)
+ */
+static bool tile_visible(void)
+{
+    if (lv_obj_get_screen(cam_tile) != lv_scr_act()) {
+        return false;
+    }
+    lv_obj_t *tv = lv_obj_get_parent(cam_tile);
+    if (tv != NULL && lv_obj_check_type(tv, &lv_tileview_class)) {
+        return lv_tileview_get_tile_act(tv) == cam_tile;
+    }
+    return true;
+}
 
-        vTaskDelay(pdMS_TO_TICKS(1));
+// Live frames while on screen, none off it; the tile never grabs frames itself
+static void camera_refresh_cb(lv_timer_t *timer)
+{
+    bool visible = tile_visible();
+    if (visible != live) {
+        live = visible;
+#if CONFIG_GOLDIE_SNAPSHOT
+        snapshot_live(live);
+#endif
+    }
+    if (live && esp_camera_port_preview_copy(img_buf, &shown_seq)) {
+        lv_img_set_src(cam_ing, &img_dsc);
+        lv_obj_invalidate(cam_ing);
     }
 }
 
 void camera_tile_init(lv_obj_t *parent)
 {
+    cam_tile = parent;
     cam_ing = lv_img_create(parent);
-    lv_obj_set_size(cam_ing, lv_pct(100), lv_pct(100));
-    sensor_t *s = esp_camera_sensor_get();
-    if (s != NULL)
-    {
-        xTaskCreatePinnedToCore(camera_task, "camera_task", 1024 * 10, NULL, 1, NULL, 1);
+    lv_obj_center(cam_ing);
+    img_buf = (uint8_t *)heap_caps_calloc(1, CAMERA_PREVIEW_BYTES, MALLOC_CAP_SPIRAM);
+    if (img_buf == NULL) {
+        return;
     }
-}
\ No newline at end of file
+    img_dsc.header.always_zero = 0;
+    img_dsc.header.w = CAMERA_PREVIEW_W;
+    img_dsc.header.h = CAMERA_PREVIEW_H;
+    img_dsc.data_size = CAMERA_PREVIEW_BYTES;
+    img_dsc.header.cf = LV_IMG_CF_TRUE_COLOR;
+    img_dsc.data = img_buf;
+    lv_img_set_zoom(cam_ing, 512);   // 2x: 320x240 on screen
+    lv_timer_create(camera_refresh_cb, CAMERA_TILE_REFRESH_MS, NULL);
+}
@@ -0,0 +1,301 @@
+#include "diag_tile.h"
+#include "ui/ui_fonts.h"
+#include "ui/ui_latency.h"
+#include "ui/ui_heap.h"
+#include "dashboard.h"
+#include "anim/frame_cache.h"
+#include "task_coordinator.h"
+#include "task_monitor.h"
+#include "job_watch.h"
+#include "i2c_sched.h"
+#include "http_pool.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "esp_heap_caps.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+    lv_obj_t *tile;
+    lv_obj_t *tasks;                 // Table: task, CPU, stack
+    lv_obj_t *chart;
+    lv_chart_series_t *internal;     // Free internal RAM, % of total
+    lv_chart_series_t *psram;        // Free PSRAM, % of total
+    lv_obj_t *info;
+    lv_timer_t *timer;
+    uint32_t task_sample;            // task_monitor sample on the table
+} diag_view_t;
+
+/**
+ * @brief Whether the tile is on screen (the active tile of its tileview)
+ */
+static bool tile_active(lv_obj_t *tile)
+{
+    lv_obj_t *tv = lv_obj_get_parent(tile);
+    if (tv != NULL && lv_obj_check_type(tv, &lv_tileview_class)) {
+        return lv_tileview_get_tile_act(tv) == tile;
+    }
+    return true;
+}
+
+static void view_delete_cb(lv_event_t *e)
+{
+    diag_view_t *v = (diag_view_t *)lv_event_get_user_data(e);
+    lv_timer_del(v->timer);
+    free(v);
+}
+
+static uint8_t free_pct(uint32_t caps)
+{
+    size_t total = heap_caps_get_total_size(caps);
+    return total ? (uint8_t)(heap_caps_get_free_size(caps) * 100 / total) : 0;
+}
+
+static void queue_depth(char *buf, size_t len, const char *name, QueueHandle_t q)
+{
+    if (q == NULL) {
+        snprintf(buf, len, "%s -", name);
+        return;
+    }
+    UBaseType_t used = uxQueueMessagesWaiting(q);
+    snprintf(buf, len, "%s %u/%u", name, (unsigned)used, (unsigned)(used + uxQueueSpacesAvailable(q)));
+}
+
+static void update_tasks(diag_view_t *v)
+{
+    task_monitor_snapshot_t snap;
+    if (!task_monitor_get(&snap) || snap.samples == v->task_sample) {
+        return;
+    }
+    v->task_sample = snap.samples;
+    uint16_t row = 1;
+    for (int i = 0; i < TASK_ID_COUNT; i++) {
+        const task_monitor_entry_t *t = &snap.tasks[i];
+        if (!t->alive) {
+            continue;
+        }
+        lv_table_set_cell_value(v->tasks, row, 0, t->name);
+        if (t->cpu_pct >= 0) {
+            lv_table_set_cell_value_fmt(v->tasks, row, 1, "%d%%", t->cpu_pct);
+        } else {
+            lv_table_set_cell_value(v->tasks, row, 1, "-");
+        }
+        lv_table_set_cell_value_fmt(v->tasks, row, 2, "%u%%", (unsigned)t->stack_used_pct);
+        row++;
+    }
+    if (snap.core_busy_pct[0] >= 0) {
+        lv_table_set_cell_value(v->tasks, row, 0, "cores");
+        lv_table_set_cell_value_fmt(v->tasks, row, 1, "%d%%", snap.core_busy_pct[0]);
+        lv_table_set_cell_value_fmt(v->tasks, row, 2, "%d%%", snap.core_busy_pct[1]);
+        row++;
+    }
+    lv_table_set_row_cnt(v->tasks, row);
+}
+
+static void update_info(diag_view_t *v)
+{
+    frame_cache_stats_t cs;
+    frame_cache_get_stats(&cs);
+    uint32_t lookups = cs.hits + cs.misses;
+    uint32_t presented = 0;
+    uint32_t skipped = 0;
+    dashboard_get_anim_counts(&presented, &skipped);
+
+    char q[5][24];
+    queue_depth(q[0], sizeof(q[0]), "req", queue_anim_frame_request);
+    queue_depth(q[1], sizeof(q[1]), "ready", queue_anim_frame_ready);
+    queue_depth(q[2], sizeof(q[2]), "free", queue_anim_frame_free);
+    queue_depth(q[3], sizeof(q[3]), "ai", queue_ai_request);
+    queue_depth(q[4], sizeof(q[4]), "param", queue_param_update);
+
+    i2c_sched_stats_t i2c;
+    i2c_sched_get_stats(&i2c);
+
+    char net[2][64];
+    const task_id_t net_tasks[2] = { TASK_ID_AI, TASK_ID_TELEMETRY };
+    const char *const net_names[2] = { "AI", "Blynk" };
+    for (int i = 0; i < 2; i++) {
+        job_watch_stats_t js;
+        if (job_watch_get(net_tasks[i], &js) && js.runs > 0) {
+            snprintf(net[i], sizeof(net[i]), "%s last %lu ms, worst %lu ms (%lu, %lu late)", net_names[i],
+                     (unsigned long)js.last_ms, (unsigned long)js.worst_ms, (unsigned long)js.runs,
+                     (unsigned long)js.overruns);
+        } else {
+            snprintf(net[i], sizeof(net[i]), "%s no requests yet", net_names[i]);
+        }
+    }
+
+    ui_heap_stats_t lv_int, lv_psram, lv_sys;
+    ui_heap_get_stats(UI_HEAP_INTERNAL, &lv_int);
+    ui_heap_get_stats(UI_HEAP_PSRAM, &lv_psram);
+    ui_heap_get_stats(UI_HEAP_SYSTEM, &lv_sys);
+
+    lv_label_set_text_fmt(v->info,
+                          "Frames: cache %lu%% of %lu (%lu prefetched), %u/%u slots\n"
+                          "  shown %lu, skipped %lu\n"
+                          "Queues: %s  %s  %s\n  %s  %s\n"
+                          "Heap: int %lu KB (block %lu), psram %lu KB (block %lu)\n"
+                          "LVGL: int %lu/%lu KB, psram %lu/%lu KB, sys %lu KB\n"
+                          "I2C: %u%% busy, touch wait max %lu us\n"
+                          "%s\n%s",
+                          (unsigned long)(lookups ? cs.hits * 100 / lookups : 0), (unsigned long)lookups,
+                          (unsigned long)cs.prefetch_hits, (unsigned)cs.slots_allocated, (unsigned)cs.slots_max,
+                          (unsigned long)presented, (unsigned long)skipped,
+                          q[0], q[1], q[2], q[3], q[4],
+                          (unsigned long)(heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT) / 1024),
+                          (unsigned long)(heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT) / 1024),
+                          (unsigned long)(heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024),
+                          (unsigned long)(heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM) / 1024),
+                          (unsigned long)(lv_int.used / 1024), (unsigned long)(lv_int.size / 1024),
+                          (unsigned long)(lv_psram.used / 1024), (unsigned long)(lv_psram.size / 1024),
+                          (unsigned long)(lv_sys.used / 1024),
+                          (unsigned)i2c.util_pct, (unsigned long)i2c.wait_max_us[I2C_SCHED_TOUCH],
+                          net[0], net[1]);
+}
+
+static void diag_timer_cb(lv_timer_t *timer)
+{
+    diag_view_t *v = (diag_view_t *)timer->user_data;
+
+    // The graph keeps sampling while another tile is shown; off screen the
+    // chart's invalidation is clipped away
+    lv_chart_set_next_value(v->chart, v->internal, free_pct(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    lv_chart_set_next_value(v->chart, v->psram, free_pct(MALLOC_CAP_SPIRAM));
+    if (!tile_active(v->tile)) {
+        return;
+    }
+    update_tasks(v);
+    update_info(v);
+}
+
+void diag_tile_init(lv_obj_t *parent)
+{
+    diag_view_t *v = (diag_view_t *)calloc(1, sizeof(diag_view_t));
+    if (v == NULL) {
+        return;
+    }
+    v->tile = parent;
+
+    lv_obj_t *title = lv_label_create(parent);
+    lv_obj_set_style_text_font(title, ui_font(UI_FONT_20), LV_PART_MAIN);
+    lv_label_set_text(title, "Diagnostics");
+    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 3);
+
+    // Tasks on the left
+    v->tasks = lv_table_create(parent);
+    lv_obj_set_style_text_font(v->tasks, ui_font(UI_FONT_12), LV_PART_ITEMS);
+    lv_obj_set_style_pad_all(v->tasks, 2, LV_PART_ITEMS);
+    lv_table_set_col_cnt(v->tasks, 3);
+    lv_table_set_col_width(v->tasks, 0, 90);
+    lv_table_set_col_width(v->tasks, 1, 55);
+    lv_table_set_col_width(v->tasks, 2, 55);
+    lv_table_set_cell_value(v->tasks, 0, 0, "Task");
+    lv_table_set_cell_value(v->tasks, 0, 1, "CPU");
+    lv_table_set_cell_value(v->tasks, 0, 2, "Stack");
+    lv_table_set_cell_value(v->tasks, 1, 0, "sampling...");
+    lv_obj_set_size(v->tasks, 210, 290);
+    lv_obj_align(v->tasks, LV_ALIGN_TOP_LEFT, 2, 30);
+
+    // Heap graph and the rest on the right
+    v->chart = lv_chart_create(parent);
+    lv_obj_set_size(v->chart, 220, 100);
+    lv_obj_align(v->chart, LV_ALIGN_TOP_RIGHT, -2, 30);
+    lv_chart_set_type(v->chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_range(v->chart, LV_CHART_AXIS_PRIMARY_Y, 0, 100);
+    lv_chart_set_point_count(v->chart, DIAG_TILE_POINTS);
+    lv_chart_set_div_line_count(v->chart, 3, 0);
+    lv_obj_set_style_size(v->chart, 0, LV_PART_INDICATOR);     // No point markers
+    v->internal = lv_chart_add_series(v->chart, lv_palette_main(LV_PALETTE_GREEN), LV_CHART_AXIS_PRIMARY_Y);
+    v->psram = lv_chart_add_series(v->chart, lv_palette_main(LV_PALETTE_BLUE), LV_CHART_AXIS_PRIMARY_Y);
+    lv_chart_set_all_value(v->chart, v->internal, LV_CHART_POINT_NONE);
+    lv_chart_set_all_value(v->chart, v->psram, LV_CHART_POINT_NONE);
+
+    lv_obj_t *legend = lv_label_create(parent);
+    lv_obj_set_style_text_font(legend, ui_font(UI_FONT_12), LV_PART_MAIN);
+    lv_label_set_recolor(legend, true);
+    lv_label_set_text(legend, "free %: #4caf50 internal#  #2196f3 psram#");
+    lv_obj_align_to(legend, v->chart, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 2);
+
+    v->info = lv_label_create(parent);
+    lv_obj_set_width(v->info, 230);
+    lv_obj_set_style_text_font(v->info, ui_font(UI_FONT_12), LV_PART_MAIN);
+    lv_label_set_text(v->info, "");
+    lv_obj_align_to(v->info, legend, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 4);
+
+    v->timer = lv_timer_create(diag_timer_cb, DIAG_TILE_REFRESH_MS, v);
+    lv_obj_add_event_cb(parent, view_delete_cb, LV_EVENT_DELETE, v);
+    diag_timer_cb(v->timer);
+}
+
+typedef size_t (*text_format_fn)(char *buf, size_t len);
+
+typedef struct {
+    lv_obj_t *text;
+    lv_timer_t *timer;
+    text_format_fn format;
+} text_view_t;
+
+static void text_timer_cb(lv_timer_t *timer)
+{
+    text_view_t *v = (text_view_t *)timer->user_data;
+    if (!tile_active(lv_obj_get_parent(lv_obj_get_parent(v->text)))) {
+        return;
+    }
+    char *buf = (char *)heap_caps_malloc(DIAG_LATENCY_TEXT_MAX, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (buf == NULL) {
+        return;
+    }
+    v->format(buf, DIAG_LATENCY_TEXT_MAX);
+    lv_label_set_text(v->text, buf);
+    heap_caps_free(buf);
+}
+
+static void text_delete_cb(lv_event_t *e)
+{
+    text_view_t *v = (text_view_t *)lv_event_get_user_data(e);
+    lv_timer_del(v->timer);
+    free(v);
+}
+
+/**
+ * @brief A titled, scrolling text tile filled by `format`
+ */
+static void text_tile_init(lv_obj_t *parent, const char *title_text, text_format_fn format)
+{
+    text_view_t *v = (text_view_t *)calloc(1, sizeof(text_view_t));
+    if (v == NULL) {
+        return;
+    }
+    v->format = format;
+
+    lv_obj_t *title = lv_label_create(parent);
+    lv_obj_set_style_text_font(title, ui_font(UI_FONT_20), LV_PART_MAIN);
+    lv_label_set_text(title, title_text);
+    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 3);
+
+    // Scrolls when the text outgrows the tile
+    lv_obj_t *body = lv_obj_create(parent);
+    lv_obj_set_size(body, lv_pct(95), lv_pct(85));
+    lv_obj_align(body, LV_ALIGN_TOP_MID, 0, 30);
+    lv_obj_set_style_bg_opa(body, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(body, 0, 0);
+    v->text = lv_label_create(body);
+    lv_obj_set_width(v->text, lv_pct(100));
+    lv_obj_set_style_text_font(v->text, ui_font(UI_FONT_12), LV_PART_MAIN);
+    lv_label_set_text(v->text, "");
+
+    v->timer = lv_timer_create(text_timer_cb, DIAG_TILE_REFRESH_MS, v);
+    lv_obj_add_event_cb(parent, text_delete_cb, LV_EVENT_DELETE, v);
+    text_timer_cb(v->timer);
+}
+
+void diag_latency_tile_init(lv_obj_t *parent)
+{
+    text_tile_init(parent, "Latency", ui_latency_format);
+}
+
+void diag_net_tile_init(lv_obj_t *parent)
+{
+    text_tile_init(parent, "Network", http_pool_format_phases);
+}
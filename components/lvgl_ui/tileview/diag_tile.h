@@ -0,0 +1,42 @@
+#ifndef __DIAG_TILE_H__
+#define __DIAG_TILE_H__
+
+#include "../lvgl_ui.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Diagnostics tiles - field triage without a serial cable
+//
+//   diag_tile_init          task CPU share and stack use (task_monitor.h),
+//                           a heap / PSRAM free graph, LVGL heap pool use
+//                           (ui_heap.h), frame cache hit rate and skipped
+//                           frames, pipeline queue depths, and
+//                           the last / worst AI and Blynk request times
+//                           (job_watch.h)
+//   diag_latency_tile_init  end-to-end latency histograms (ui_latency.h)
+//   diag_net_tile_init      per-host HTTP phase percentiles: DNS, connect +
+//                           TLS, time to first byte, body (http_pool.h)
+//
+// Each tile refreshes every DIAG_TILE_REFRESH_MS, and only while it is the
+// tileview's active tile; its timer goes with the tile, so a closed view
+// costs nothing. The heap graph starts when the tile is created.
+
+#define DIAG_TILE_REFRESH_MS   2000
+#define DIAG_TILE_POINTS       60      // Heap graph: 2 minutes at the refresh rate
+#define DIAG_LATENCY_TEXT_MAX  3072    // Text buffer of the latency and network tiles
+
+void diag_tile_init(lv_obj_t *parent);
+void diag_latency_tile_init(lv_obj_t *parent);
+void diag_net_tile_init(lv_obj_t *parent);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+
+#endif
@@ -1,4 +1,5 @@
 #include "system_tile.h"
+#include "ui/ui_fonts.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -9,10 +10,12 @@
 #include "driver/temperature_sensor.h"
 #include "esp_private/esp_clk.h"
 
-#include "esp_pcf85063_port.h"
 #include "esp_sdcard_port.h"
 #include "esp_es8311_port.h"
 #include "esp_3inch5_lcd_port.h"
+#include "task_monitor.h"
+#include "time_svc.h"
+#include <time.h>
 
 SemaphoreHandle_t es8311_test_semaphore;
 temperature_sensor_handle_t temp_sensor = NULL;
@@ -28,6 +31,7 @@ lv_obj_t *label_psram;
 lv_obj_t *label_chip_temp;
 lv_obj_t *label_chip_freq;
 lv_obj_t *label_sd;
+lv_obj_t *label_tasks;
 
 
 static void slider_event_cb(lv_event_t *e)
@@ -52,14 +56,35 @@ static void system_time_cb(lv_timer_t *timer)
 {
     char str[20];
     float tsens_out;
-    RTC_DateTime datetime = rtc.getDateTime();
+    // The system clock: set from the RTC at boot, kept by SNTP
+    struct tm datetime;
+    time_svc_local(&datetime);
 
-    lv_label_set_text_fmt(label_date, "%04d-%02d-%02d", datetime.year, datetime.month, datetime.day);
-    lv_label_set_text_fmt(label_time, "%02d:%02d:%02d", datetime.hour, datetime.minute, datetime.second);
+    lv_label_set_text_fmt(label_date, "%04d-%02d-%02d", datetime.tm_year + 1900, datetime.tm_mon + 1, datetime.tm_mday);
+    lv_label_set_text_fmt(label_time, "%02d:%02d:%02d", datetime.tm_hour, datetime.tm_min, datetime.tm_sec);
 
     temperature_sensor_get_celsius(temp_sensor, &tsens_out);
     sprintf(str, "%.2f degrees C", tsens_out);
     lv_label_set_text(label_chip_temp, str);
+
+    // Task monitor: the task closest to its stack limit, and core load
+    static uint32_t shown_sample = 0;
+    task_monitor_snapshot_t snap;
+    if (task_monitor_get(&snap) && snap.samples != shown_sample) {
+        shown_sample = snap.samples;
+        const task_monitor_entry_t *worst = NULL;
+        for (int i = 0; i < TASK_ID_COUNT; i++) {
+            if (snap.tasks[i].alive && (!worst || snap.tasks[i].stack_used_pct > worst->stack_used_pct)) {
+                worst = &snap.tasks[i];
+            }
+        }
+        if (worst && snap.core_busy_pct[1] >= 0) {
+            lv_label_set_text_fmt(label_tasks, "%s %u%% | C0 %d%% C1 %d%%", worst->name,
+                                  (unsigned)worst->stack_used_pct, snap.core_busy_pct[0], snap.core_busy_pct[1]);
+        } else if (worst) {
+            lv_label_set_text_fmt(label_tasks, "%s %u%% stack", worst->name, (unsigned)worst->stack_used_pct);
+        }
+    }
 }
 
 static void lvgl_es8311_test_task(void *arg)
@@ -119,7 +144,7 @@ void system_tile_init(lv_obj_t *parent)
     /*Create a list*/
     lv_obj_t *list = lv_list_create(parent);
     lv_obj_t *lable = lv_label_create(parent);
-    lv_obj_set_style_text_font(lable, &lv_font_montserrat_20, LV_PART_MAIN);
+    lv_obj_set_style_text_font(lable, ui_font(UI_FONT_20), LV_PART_MAIN);
     lv_label_set_text(lable, "System");
     lv_obj_align(lable, LV_ALIGN_TOP_MID, 0, 3);
 
@@ -182,6 +207,10 @@ void system_tile_init(lv_obj_t *parent)
     list_item = lv_list_add_btn(list, NULL, "Time");
     label_time = lv_label_create(list_item);
     lv_label_set_text(label_time, "12:00:00");
+
+    list_item = lv_list_add_btn(list, NULL, "Tasks");
+    label_tasks = lv_label_create(list_item);
+    lv_label_set_text(label_tasks, "sampling...");
     system_init();
     lv_timer_create(system_time_cb, 1000, NULL);
 }
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "trend_tile.h"
+#include "ui/ui_fonts.h"
+#include "history/history_trend.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef struct {
+    const char *name;
+    const char *unit;
+    int scale;                       // Chart units per unit
+    int decimals;
+} trend_param_t;
+
+// Cycle order; index is the history_trend parameter
+static const trend_param_t params[HISTORY_STORE_PARAMS] = {
+    { "Ammonia", "ppm", 100, 2 },
+    { "Nitrate", "ppm", 10,  1 },
+    { "Nitrite", "ppm", 100, 2 },
+    { "pH",      "",    10,  1 },
+};
+static const uint16_t zooms[] = { 7, 30, 90, 365 };
+#define TREND_ZOOMS  (sizeof(zooms) / sizeof(zooms[0]))
+
+typedef struct {
+    lv_obj_t *chart;
+    lv_chart_series_t *hi;
+    lv_chart_series_t *lo;
+    lv_obj_t *header;
+    lv_obj_t *range;
+    lv_coord_t hi_y[HISTORY_TREND_POINTS];
+    lv_coord_t lo_y[HISTORY_TREND_POINTS];
+    int32_t end_day;                 // Last day shown
+    uint8_t zoom;
+    uint8_t param;
+} trend_view_t;
+
+static void view_delete_cb(lv_event_t *e)
+{
+    free(lv_event_get_user_data(e));
+}
+
+static void day_text(int32_t day, char *buf, size_t size)
+{
+    time_t t = (time_t)day * 86400 + 43200;   // Noon UTC: the same date in any zone
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    strftime(buf, size, "%d %b %y", &tm);
+}
+
+static void trend_show(trend_view_t *v)
+{
+    const trend_param_t *p = &params[v->param];
+    uint16_t days = zooms[v->zoom];
+    int32_t from = v->end_day - days + 1;
+    char from_s[16], to_s[16];
+    day_text(from, from_s, sizeof(from_s));
+    day_text(v->end_day, to_s, sizeof(to_s));
+    lv_label_set_text_fmt(v->header, "%s - %u days, %s to %s", p->name, (unsigned)days, from_s, to_s);
+
+    const history_trend_t *t = history_trend_get(from, days);
+    if (t == NULL || t->tests == 0) {
+        lv_chart_set_point_count(v->chart, 2);
+        lv_chart_set_all_value(v->chart, v->hi, LV_CHART_POINT_NONE);
+        lv_chart_set_all_value(v->chart, v->lo, LV_CHART_POINT_NONE);
+        lv_label_set_text(v->range, t == NULL ? "No history on the SD card" : "No tests in this range");
+        return;
+    }
+
+    float lo = 0.0f, hi = 0.0f;
+    bool any = false;
+    for (uint16_t b = 0; b < t->buckets; b++) {
+        if (!t->have[b]) {
+            v->hi_y[b] = LV_CHART_POINT_NONE;
+            v->lo_y[b] = LV_CHART_POINT_NONE;
+            continue;
+        }
+        float bl = t->min[v->param][b];
+        float bh = t->max[v->param][b];
+        v->hi_y[b] = (lv_coord_t)(bh * p->scale + 0.5f);
+        v->lo_y[b] = (lv_coord_t)(bl * p->scale + 0.5f);
+        if (!any || bl < lo) lo = bl;
+        if (!any || bh > hi) hi = bh;
+        any = true;
+    }
+    // A flat series still gets some height, and both ends a margin
+    lv_coord_t y0 = (lv_coord_t)(lo * p->scale);
+    lv_coord_t y1 = (lv_coord_t)(hi * p->scale + 0.999f);
+    lv_coord_t pad = (y1 - y0) / 10 + 1;
+    lv_chart_set_range(v->chart, LV_CHART_AXIS_PRIMARY_Y, y0 > pad ? y0 - pad : 0, y1 + pad);
+
+    lv_chart_set_point_count(v->chart, t->buckets);
+    lv_chart_set_ext_y_array(v->chart, v->hi, v->hi_y);
+    lv_chart_set_ext_y_array(v->chart, v->lo, v->lo_y);
+    lv_chart_refresh(v->chart);
+    lv_label_set_text_fmt(v->range, "%u tests, %.*f - %.*f %s", (unsigned)t->tests, p->decimals, lo,
+                          p->decimals, hi, p->unit);
+}
+
+static void pan_cb(lv_event_t *e)
+{
+    lv_obj_t *btn = lv_event_get_target(e);
+    trend_view_t *v = (trend_view_t *)lv_obj_get_user_data(lv_obj_get_parent(btn));
+    int dir = (int)(intptr_t)lv_event_get_user_data(e);
+    int32_t today = history_day_of(time(NULL));
+    v->end_day += dir * (zooms[v->zoom] / 2);
+    if (v->end_day > today) {
+        v->end_day = today;
+    }
+    trend_show(v);
+}
+
+static void zoom_cb(lv_event_t *e)
+{
+    trend_view_t *v = (trend_view_t *)lv_event_get_user_data(e);
+    v->zoom = (uint8_t)((v->zoom + 1) % TREND_ZOOMS);
+    trend_show(v);
+}
+
+static void param_cb(lv_event_t *e)
+{
+    trend_view_t *v = (trend_view_t *)lv_event_get_user_data(e);
+    v->param = (uint8_t)((v->param + 1) % HISTORY_STORE_PARAMS);
+    trend_show(v);
+}
+
+static lv_obj_t *add_button(lv_obj_t *row, const char *text, lv_event_cb_t cb, void *user)
+{
+    lv_obj_t *btn = lv_btn_create(row);
+    lv_obj_set_size(btn, 90, 36);
+    lv_obj_t *label = lv_label_create(btn);
+    lv_label_set_text(label, text);
+    lv_obj_center(label);
+    lv_obj_add_event_cb(btn, cb, LV_EVENT_CLICKED, user);
+    return btn;
+}
+
+void trend_view_init(lv_obj_t *parent)
+{
+    trend_view_t *v = (trend_view_t *)calloc(1, sizeof(trend_view_t));
+    if (v == NULL) {
+        return;
+    }
+    v->end_day = history_day_of(time(NULL));
+    v->zoom = 1;                     // 30 days
+
+    v->header = lv_label_create(parent);
+    lv_obj_set_style_text_font(v->header, ui_font(UI_FONT_14), LV_PART_MAIN);
+    lv_obj_align(v->header, LV_ALIGN_TOP_MID, 0, 0);
+
+    v->chart = lv_chart_create(parent);
+    lv_obj_set_size(v->chart, TREND_VIEW_W, TREND_CHART_H);
+    lv_obj_align(v->chart, LV_ALIGN_TOP_MID, 0, 22);
+    lv_chart_set_type(v->chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_div_line_count(v->chart, 5, 0);
+    lv_obj_set_style_size(v->chart, 0, LV_PART_INDICATOR);     // No point markers
+    v->hi = lv_chart_add_series(v->chart, lv_palette_main(LV_PALETTE_RED), LV_CHART_AXIS_PRIMARY_Y);
+    v->lo = lv_chart_add_series(v->chart, lv_palette_main(LV_PALETTE_BLUE), LV_CHART_AXIS_PRIMARY_Y);
+    lv_obj_add_event_cb(v->chart, view_delete_cb, LV_EVENT_DELETE, v);
+
+    v->range = lv_label_create(parent);
+    lv_obj_set_style_text_font(v->range, ui_font(UI_FONT_12), LV_PART_MAIN);
+    lv_obj_align_to(v->range, v->chart, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 2);
+
+    // Pan buttons find the view through the row
+    lv_obj_t *row = lv_obj_create(parent);
+    lv_obj_remove_style_all(row);
+    lv_obj_set_size(row, TREND_VIEW_W, 40);
+    lv_obj_align_to(row, v->range, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 4);
+    lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(row, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_user_data(row, v);
+    add_button(row, LV_SYMBOL_LEFT, pan_cb, (void *)(intptr_t)-1);
+    add_button(row, "Param", param_cb, v);
+    add_button(row, "Zoom", zoom_cb, v);
+    add_button(row, LV_SYMBOL_RIGHT, pan_cb, (void *)(intptr_t)1);
+
+    trend_show(v);
+}
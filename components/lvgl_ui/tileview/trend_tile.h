@@ -0,0 +1,35 @@
+#ifndef __TREND_TILE_H__
+#define __TREND_TILE_H__
+
+#include "../lvgl_ui.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Parameter trend - ammonia, nitrite, nitrate or pH over days to a year
+//
+// One lv_chart line pair per view: the highest and the lowest reading of
+// each bucket of a history_trend window (history/history_trend.h), so the
+// band between them is the spread of the tests. Buttons cycle the
+// parameter and the zoom (TREND_ZOOMS) and pan by half a window; the
+// window's buckets come from the trend cache, so going back to a zoom or
+// a window already shown reads nothing from SD.
+//
+// The chart shows the store's series through lv_chart_set_ext_y_array, so
+// a redraw copies no points.
+
+#define TREND_VIEW_W     440
+#define TREND_CHART_H    210
+
+void trend_view_init(lv_obj_t *parent);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+
+#endif
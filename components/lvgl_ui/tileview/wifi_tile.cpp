@@ -1,47 +1,69 @@
 
 #include "wifi_tile.h"
-
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-
-#include "esp_lvgl_port.h"
+#include "ui/ui_fonts.h"
 
 #include "esp_wifi_port.h"
+#include "wifi_scan.h"
 
 static lv_obj_t *list;
 lv_obj_t *lable_wifi_ip;
 
 #define LIST_BTN_LEN_MAX 20
-lv_obj_t *list_btns[LIST_BTN_LEN_MAX];
-uint16_t list_item_count = 0;
+#define WIFI_TILE_REFRESH_MS 1000
 
 bool g_wifi_enable = true;
 
-SemaphoreHandle_t wifi_scanf_semaphore;
+static uint32_t list_generation = 0;    // wifi_scan generation on the list
+static uint32_t auto_scan_ms = 0;       // lv_tick of the last background scan request
+
+/**
+ * @brief Whether the tile is on screen (the active tile of its tileview)
+ */
+static bool tile_active(lv_obj_t *tile)
+{
+    lv_obj_t *tv = lv_obj_get_parent(tile);
+    if (tv != NULL && lv_obj_check_type(tv, &lv_tileview_class)) {
+        return lv_tileview_get_tile_act(tv) == tile;
+    }
+    return true;
+}
+
+static void list_note(const char *text)
+{
+    lv_obj_clean(list);
+    lv_list_add_btn(list, NULL, text);
+}
+
+/**
+ * @brief Refill the list from the scan cache, strongest first
+ */
+static void list_fill(void)
+{
+    static wifi_scan_ap_t aps[LIST_BTN_LEN_MAX];
+    size_t n = wifi_scan_get(aps, LIST_BTN_LEN_MAX);
+    lv_obj_clean(list);
+    if (n == 0) {
+        lv_list_add_btn(list, NULL, "No networks found");
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        lv_obj_t *btn = lv_list_add_btn(list, NULL, aps[i].ssid[0] ? aps[i].ssid : "(hidden)");
+        lv_obj_t *label = lv_label_create(btn);
+        lv_label_set_text_fmt(label, "%d db  ch %u", aps[i].rssi, (unsigned)aps[i].channel);
+    }
+}
 
 static void btn_wifi_scan_event_handler(lv_event_t *e)
 {
     lv_event_code_t code = lv_event_get_code(e);
-    // lv_obj_t *obj = lv_event_get_target(e);
     if (code == LV_EVENT_CLICKED && g_wifi_enable)
     {
-        for (int i = 0; i < list_item_count; i++)
-        {
-            lv_obj_del(list_btns[i]);
+        esp_err_t err = wifi_scan_request(false);
+        if (err == ESP_OK) {
+            list_note("WiFi scanning underway!");
+        } else {
+            list_note(err == ESP_ERR_WIFI_STATE ? "WiFi busy connecting - try again" : "Scan unavailable");
         }
-        list_item_count = 0;
-        list_btns[0] = lv_list_add_btn(list, NULL, "WiFi scanning underway!");
-
-        xSemaphoreGive(wifi_scanf_semaphore);
-        // app_wifi_scan((void*)wifi_infos, &list_item_count, 20);
-        // for (int i = 0; i < list_item_count && i < LIST_BTN_LEN_MAX; i++)
-        // {
-        //     list_btns[i] = lv_list_add_btn(list, NULL, wifi_infos[i].name);
-        //     label = lv_label_create(list_btns[i]);
-        //     lv_label_set_text_fmt(label, "%d db", wifi_infos[i].rssi);
-        //     list_item_count++;
-        //     // lv_list_get_btn_index();
-        // }
     }
 }
 
@@ -59,65 +81,55 @@ static void sw_wifi_event_handler(lv_event_t *e)
         else
         {
             g_wifi_enable = false;
-            for (int i = 0; i < list_item_count; i++)
-            {
-                lv_obj_del(list_btns[i]);
-            }
-            list_item_count = 0;
+            lv_obj_clean(list);
             esp_wifi_port_disconnect();
         }
     }
 }
 
-static void lvgl_wifi_task(void *arg)
+/**
+ * @brief IP label, and the list when a scan finished (never waits on one)
+ */
+static void wifi_timer_cb(lv_timer_t *timer)
 {
-    char str[50] = {0};
+    lv_obj_t *tile = (lv_obj_t *)timer->user_data;
+    if (!tile_active(tile)) {
+        return;
+    }
     char str_wifi_ip[32] = {0};
-    lv_obj_t *label;
-    wifi_ap_record_t ap_info[LIST_BTN_LEN_MAX];
-
-    while (1)
-    {
-        if (xSemaphoreTake(wifi_scanf_semaphore, pdMS_TO_TICKS(1000)) == pdTRUE)
-        {
-            printf("wifi_scanf!!\r\n");
-            memset(ap_info, 0, sizeof(ap_info));
-            if (esp_wifi_port_scan(ap_info, &list_item_count, LIST_BTN_LEN_MAX))
-            {
-                lv_obj_del(list_btns[0]);
-                if (lvgl_port_lock(0))
-                {
-                    for (int i = 0; i < list_item_count && i < LIST_BTN_LEN_MAX; i++)
-                    {
-                        list_btns[i] = lv_list_add_btn(list, NULL, (char *)ap_info[i].ssid);
-                        label = lv_label_create(list_btns[i]);
-                        lv_label_set_text_fmt(label, "%d db", ap_info[i].rssi);
-                    }
-                    lvgl_port_unlock();
-                }
-            }
-        }
-
-        esp_wifi_port_get_ip(str_wifi_ip);
-        sprintf(str, "IP: %s", str_wifi_ip);
+    esp_wifi_port_get_ip(str_wifi_ip);
+    lv_label_set_text_fmt(lable_wifi_ip, "IP: %s", str_wifi_ip);
 
-        if (lvgl_port_lock(0))
-        {
-            lv_label_set_text(lable_wifi_ip, str);
-            lvgl_port_unlock();
+    if (!g_wifi_enable) {
+        return;
+    }
+    uint32_t gen = wifi_scan_generation();
+    if (gen != list_generation) {
+        list_generation = gen;
+        list_fill();
+    } else if (!wifi_scan_busy() && (auto_scan_ms == 0 || lv_tick_elaps(auto_scan_ms) > WIFI_SCAN_FRESH_S * 1000)) {
+        // Shown with old or no results: a quiet background scan, the list
+        // stays until it lands
+        int32_t age = wifi_scan_age_s();
+        if (age < 0 || age > WIFI_SCAN_FRESH_S) {
+            auto_scan_ms = lv_tick_get() | 1;
+            wifi_scan_request(true);
         }
     }
 }
 
+static void wifi_tile_delete_cb(lv_event_t *e)
+{
+    lv_timer_del((lv_timer_t *)lv_event_get_user_data(e));
+}
+
 void wifi_tile_init(lv_obj_t *parent)
 {
     /*Create a list*/
     list = lv_list_create(parent);
 
-    wifi_scanf_semaphore = xSemaphoreCreateBinary();
-
     lv_obj_t *lable = lv_label_create(parent);
-    lv_obj_set_style_text_font(lable, &lv_font_montserrat_20, LV_PART_MAIN);
+    lv_obj_set_style_text_font(lable, ui_font(UI_FONT_20), LV_PART_MAIN);
     lv_label_set_text(lable, "WiFi");
     lv_obj_align(lable, LV_ALIGN_TOP_MID, 0, 3);
 
@@ -141,5 +153,7 @@ void wifi_tile_init(lv_obj_t *parent)
     lv_obj_set_size(list, lv_pct(95), lv_pct(85));
     lv_obj_align(list, LV_ALIGN_TOP_MID, 0, 50);
 
-    xTaskCreate(lvgl_wifi_task, "lvgl_wifi_task", 1024 * 10, NULL, 0, NULL);
-}
\ No newline at end of file
+    // Scans run in wifi_scan.h's background; the timer only reads results
+    lv_timer_t *timer = lv_timer_create(wifi_timer_cb, WIFI_TILE_REFRESH_MS, parent);
+    lv_obj_add_event_cb(parent, wifi_tile_delete_cb, LV_EVENT_DELETE, timer);
+}
@@ -0,0 +1,304 @@
+#include "calendar_view.h"
+#include "history_view.h"
+#include "ui_stage.h"
+#include "ui_theme.h"
+#include "ui_fonts.h"
+#include "ui_arena.h"
+#include "ui_obj_track.h"
+#include "state/dash_store.h"
+#include "history/history_store.h"
+#include "time_svc.h"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <time.h>
+
+#define MONTHLY_CAL_CELL_W 60
+#define MONTHLY_CAL_CELL_H 38
+
+typedef struct {
+    lv_obj_t *container;                   // Day grid (emptied on month switch)
+    lv_obj_t *title;
+    int first_weekday;
+    int32_t first_day;                     // Day number of the 1st
+    int32_t today_day;                     // history_day_of(now)
+    int32_t water_due_day;                 // Next water change, -1 = none planned
+    int planned_feeds;                     // Enabled feed times (dash_store)
+    bool have_map;                         // map valid (history store loaded)
+    history_month_t map;
+} monthly_cal_build_t;
+
+static lv_obj_t *popup_monthly_cal = NULL;
+static int monthly_cal_display_month = 0;
+static int monthly_cal_display_year = 0;
+static monthly_cal_build_t monthly_cal_build;
+static ui_stage_t monthly_cal_stage;
+
+/**
+ * @brief Staged build of one monthly calendar day cell (ui/ui_stage.h)
+ */
+static void monthly_cal_build_day(uint16_t step, void *user)
+{
+    monthly_cal_build_t *mc = (monthly_cal_build_t *)user;
+    int day_num = step + 1;
+    int row = (mc->first_weekday + step) / 7;
+    int col = (mc->first_weekday + step) % 7;
+
+    int32_t day = mc->first_day + step;
+    uint32_t day_bit = 1u << step;
+
+    lv_obj_t *day_cell = lv_obj_create(mc->container);
+    lv_obj_set_size(day_cell, MONTHLY_CAL_CELL_W - 5, MONTHLY_CAL_CELL_H - 3);
+    lv_obj_set_pos(day_cell, 10 + (col * MONTHLY_CAL_CELL_W), row * MONTHLY_CAL_CELL_H);
+
+    bool is_today = (day == mc->today_day);
+
+    lv_obj_add_style(day_cell, ui_style(UI_STYLE_CAL_DAY), 0);
+    if (is_today) {
+        lv_obj_add_style(day_cell, ui_style(UI_STYLE_CAL_TODAY), 0);
+    }
+    lv_obj_clear_flag(day_cell, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t *day_label = lv_label_create(day_cell);
+    char day_text[4];
+    snprintf(day_text, sizeof(day_text), "%d", day_num);
+    lv_label_set_text(day_label, day_text);
+    lv_obj_set_style_text_font(day_label, ui_font(UI_FONT_12), 0);
+    // Day number tinted with the day's worst mood
+    uint8_t mood = mc->have_map ? mc->map.mood[step] : HISTORY_MOOD_NONE;
+    lv_obj_set_style_text_color(day_label,
+                                mood == 0 ? lv_palette_lighten(LV_PALETTE_GREEN, 2) :
+                                mood == 1 ? lv_palette_lighten(LV_PALETTE_AMBER, 1) :
+                                mood == 2 ? lv_palette_lighten(LV_PALETTE_RED, 1) : lv_color_white(), 0);
+    lv_obj_align(day_label, LV_ALIGN_TOP_MID, 0, 2);
+
+    // Parameter test logged: small corner dot
+    if (mc->have_map && (mc->map.tested & day_bit)) {
+        lv_obj_t *test_dot = ui_theme_dot(day_cell, 4, UI_STYLE_DOT_TEST);
+        lv_obj_align(test_dot, LV_ALIGN_TOP_RIGHT, 2, -2);
+    }
+
+    bool water_done = mc->have_map ? (mc->map.water & day_bit) != 0 : history_first(HISTORY_WATER, day) != NULL;
+    bool water_planned = mc->water_due_day >= 0 &&
+                         (day == mc->water_due_day || (day == mc->today_day && mc->today_day > mc->water_due_day));
+
+    if (water_done || water_planned) {
+        lv_obj_t *water_dot = ui_theme_dot(day_cell, 5, water_done ? UI_STYLE_DOT_WATER : UI_STYLE_DOT_WATER_PLAN);
+        lv_obj_align(water_dot, LV_ALIGN_BOTTOM_MID, 0, -2);
+    }
+
+    // Feed count only for days the bitmap marks as fed
+    int logged_feed_count = (!mc->have_map || (mc->map.fed & day_bit)) ? history_store_logged(HISTORY_FEED, day) : 0;
+
+    int total_feeds = (logged_feed_count > mc->planned_feeds) ? logged_feed_count : mc->planned_feeds;
+    if (total_feeds > 3) total_feeds = 3;
+
+    if (total_feeds > 0) {
+        int dot_spacing = 7;
+        int total_width = (total_feeds * 5) + ((total_feeds - 1) * 2);
+        int start_x = (MONTHLY_CAL_CELL_W - 5 - total_width) / 2;
+
+        for (int j = 0; j < total_feeds; j++) {
+            lv_obj_t *feed_dot = ui_theme_dot(day_cell, 5,
+                                              j < logged_feed_count ? UI_STYLE_DOT_FEED : UI_STYLE_DOT_FEED_PLAN);
+            lv_obj_set_pos(feed_dot, start_x + (j * dot_spacing), 17);
+        }
+    }
+
+    struct tm this_day = {};
+    this_day.tm_year = monthly_cal_display_year - 1900;
+    this_day.tm_mon = monthly_cal_display_month - 1;
+    this_day.tm_mday = day_num;
+    time_t day_timestamp = mktime(&this_day);  // Handed to the history popup on click
+
+    lv_obj_add_flag(day_cell, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_user_data(day_cell, (void*)(intptr_t)day_timestamp);
+    lv_obj_add_event_cb(day_cell, [](lv_event_t *e) {
+        if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+            time_t day_ts = (time_t)(intptr_t)lv_obj_get_user_data(lv_event_get_target(e));
+            history_view_show_day(day_ts);
+        }
+    }, LV_EVENT_CLICKED, NULL);
+}
+
+/**
+ * @brief Fill the open monthly calendar with the displayed month
+ *
+ * Only the day grid is rebuilt. Its dots and moods come from the history
+ * store's month bitmaps in one lookup, so switching months is instant.
+ */
+static void monthly_cal_show_month(int64_t build_t0)
+{
+    static const char *month_names[] = {"", "January", "February", "March", "April", "May", "June",
+                                        "July", "August", "September", "October", "November", "December"};
+    monthly_cal_build_t *mc = &monthly_cal_build;
+    int year = monthly_cal_display_year;
+    int month = monthly_cal_display_month;
+
+    char title_text[50];
+    snprintf(title_text, sizeof(title_text), "%s %d", month_names[month], year);
+    lv_label_set_text(mc->title, title_text);
+
+    // Restarting the stage drops cells still pending for the old month
+    ui_stage_cancel(&monthly_cal_stage);
+    lv_obj_clean(mc->container);
+
+    int32_t first = history_civil_day(year, month, 1);
+    int32_t next = (month == 12) ? history_civil_day(year + 1, 1, 1) : history_civil_day(year, month + 1, 1);
+    mc->first_day = first;
+    mc->first_weekday = (int)(((first + 4) % 7 + 7) % 7);  // 1970-01-01 was a Thursday
+    mc->today_day = history_day_of(time(NULL));
+    mc->have_map = history_store_month(year, month, &mc->map);
+
+    // The shown tank's plan, once for the whole month
+    dash_live_t live;
+    dash_store_read(&live);
+    const history_event_t *last_water = history_latest(HISTORY_WATER);
+    mc->water_due_day = (live.planned_water_change_interval > 0 && last_water)
+                        ? last_water->day + (int32_t)live.planned_water_change_interval : -1;
+    mc->planned_feeds = 0;
+    for (int i = 0; i < DASH_LIVE_FEED_TIMES; i++) {
+        if (live.feed_minute[i] != DASH_LIVE_NO_FEED) {
+            mc->planned_feeds++;
+        }
+    }
+
+    // Day cells (up to 31 objects with dots each) fill in over the next ticks
+    ui_stage_start(&monthly_cal_stage, "Monthly calendar", popup_monthly_cal, (uint16_t)(next - first),
+                   monthly_cal_build_day, mc, esp_timer_get_time() - build_t0);
+}
+
+extern "C" void calendar_view_open(void)
+{
+    int64_t build_t0 = esp_timer_get_time();
+    calendar_view_close();
+
+    struct tm now_tm;
+    time_svc_local(&now_tm);
+    monthly_cal_display_month = now_tm.tm_mon + 1;
+    monthly_cal_display_year = now_tm.tm_year + 1900;
+
+    popup_monthly_cal = lv_obj_create(lv_scr_act());
+    ui_obj_track_popup(popup_monthly_cal, "calendar");
+    ui_arena_scope arena(popup_monthly_cal);   // The rest of the build: popup arena
+    lv_obj_set_size(popup_monthly_cal, 480, 320);
+    lv_obj_set_pos(popup_monthly_cal, 0, 0);
+    lv_obj_set_style_bg_color(popup_monthly_cal, lv_color_hex(0x000000), 0);
+    lv_obj_set_style_bg_opa(popup_monthly_cal, LV_OPA_90, 0);
+    lv_obj_set_style_shadow_width(popup_monthly_cal, 0, 0);
+    lv_obj_clear_flag(popup_monthly_cal, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_event_cb(popup_monthly_cal, [](lv_event_t *e) { popup_monthly_cal = NULL; }, LV_EVENT_DELETE, NULL);
+
+    lv_obj_t *cal_container = lv_obj_create(popup_monthly_cal);
+    lv_obj_set_size(cal_container, 460, 300);
+    lv_obj_center(cal_container);
+    lv_obj_set_style_bg_color(cal_container, lv_color_hex(0x1a1a1a), 0);
+    lv_obj_set_style_border_color(cal_container, lv_palette_main(LV_PALETTE_BLUE), 0);
+    lv_obj_set_style_border_width(cal_container, 2, 0);
+    lv_obj_set_style_radius(cal_container, 10, 0);
+    lv_obj_set_style_shadow_width(cal_container, 0, 0);
+    lv_obj_clear_flag(cal_container, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t *title_cont = lv_obj_create(cal_container);
+    lv_obj_set_size(title_cont, 440, 40);
+    lv_obj_set_pos(title_cont, 10, 5);
+    lv_obj_set_style_bg_opa(title_cont, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(title_cont, 0, 0);
+    lv_obj_clear_flag(title_cont, LV_OBJ_FLAG_SCROLLABLE);
+
+    lv_obj_t *btn_prev = lv_btn_create(title_cont);
+    lv_obj_set_size(btn_prev, 35, 35);
+    lv_obj_align(btn_prev, LV_ALIGN_LEFT_MID, 0, 0);
+    lv_obj_set_style_bg_color(btn_prev, lv_color_hex(0x333333), 0);
+    lv_obj_add_event_cb(btn_prev, [](lv_event_t *e) {
+        if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+            monthly_cal_display_month--;
+            if (monthly_cal_display_month < 1) {
+                monthly_cal_display_month = 12;
+                monthly_cal_display_year--;
+            }
+            monthly_cal_show_month(esp_timer_get_time());
+        }
+    }, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_t *prev_label = lv_label_create(btn_prev);
+    lv_label_set_text(prev_label, LV_SYMBOL_LEFT);
+    lv_obj_center(prev_label);
+
+    lv_obj_t *title_label = lv_label_create(title_cont);
+    monthly_cal_build.title = title_label;
+    lv_obj_set_style_text_font(title_label, ui_font(UI_FONT_20), 0);
+    lv_obj_add_style(title_label, ui_style(UI_STYLE_TEXT), 0);
+    lv_obj_align(title_label, LV_ALIGN_CENTER, 0, 0);
+
+    lv_obj_t *btn_next = lv_btn_create(title_cont);
+    lv_obj_set_size(btn_next, 35, 35);
+    lv_obj_align(btn_next, LV_ALIGN_RIGHT_MID, 0, 0);
+    lv_obj_set_style_bg_color(btn_next, lv_color_hex(0x333333), 0);
+    lv_obj_add_event_cb(btn_next, [](lv_event_t *e) {
+        if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+            monthly_cal_display_month++;
+            if (monthly_cal_display_month > 12) {
+                monthly_cal_display_month = 1;
+                monthly_cal_display_year++;
+            }
+            monthly_cal_show_month(esp_timer_get_time());
+        }
+    }, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_t *next_label = lv_label_create(btn_next);
+    lv_label_set_text(next_label, LV_SYMBOL_RIGHT);
+    lv_obj_center(next_label);
+
+    const char *day_headers[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+    int header_y = 50;
+
+    for (int i = 0; i < 7; i++) {
+        lv_obj_t *header = lv_label_create(cal_container);
+        lv_label_set_text(header, day_headers[i]);
+        lv_obj_set_pos(header, 15 + (i * MONTHLY_CAL_CELL_W), header_y);
+        lv_obj_set_style_text_font(header, ui_font(UI_FONT_12), 0);
+        lv_obj_set_style_text_color(header, lv_palette_main(LV_PALETTE_BLUE), 0);
+    }
+
+    // Day cells live in their own container so a month switch only
+    // rebuilds the grid
+    lv_obj_t *grid = lv_obj_create(cal_container);
+    lv_obj_set_size(grid, 440, 6 * MONTHLY_CAL_CELL_H);
+    lv_obj_set_pos(grid, 0, header_y + 25);
+    lv_obj_set_style_bg_opa(grid, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(grid, 0, 0);
+    lv_obj_set_style_pad_all(grid, 0, 0);
+    lv_obj_set_style_shadow_width(grid, 0, 0);
+    lv_obj_clear_flag(grid, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_clear_flag(grid, LV_OBJ_FLAG_CLICKABLE);
+    monthly_cal_build.container = grid;
+
+    lv_obj_t *close_btn = lv_btn_create(cal_container);
+    lv_obj_set_size(close_btn, 60, 30);
+    lv_obj_align(close_btn, LV_ALIGN_BOTTOM_MID, 0, -5);
+    lv_obj_set_style_bg_color(close_btn, lv_color_hex(0x555555), 0);
+    lv_obj_add_event_cb(close_btn, [](lv_event_t *e) {
+        if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+            calendar_view_close();
+        }
+    }, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_t *close_label = lv_label_create(close_btn);
+    lv_label_set_text(close_label, "Close");
+    lv_obj_add_style(close_label, ui_style(UI_STYLE_TEXT), 0);
+    lv_obj_center(close_label);
+
+    monthly_cal_show_month(build_t0);
+}
+
+extern "C" void calendar_view_close(void)
+{
+    if (popup_monthly_cal) {
+        lv_obj_del(popup_monthly_cal);   // DELETE handler clears the pointer
+    }
+}
+
+extern "C" bool calendar_view_is_open(void)
+{
+    return popup_monthly_cal != NULL;
+}
@@ -0,0 +1,47 @@
+#ifndef __CALENDAR_VIEW_H__
+#define __CALENDAR_VIEW_H__
+
+#include <stdbool.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// MONTHLY CALENDAR - A MONTH OF FEEDS, WATER CHANGES, TESTS AND MOODS
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Full-screen month grid opened from the side panel's calendar card. Each
+// day cell shows its number tinted with the day's worst mood, a dot for a
+// parameter test, one for a water change (hollow: due) and up to three
+// for feeds (hollow: planned, not logged); tapping a day opens its
+// history (history_view.h).
+//
+// Moods and activity come from the history store's month bitmaps in one
+// lookup (history/history_store.h), the plan from dash_store, so
+// switching months reads no day entries. Only the grid is rebuilt, one
+// cell per step (ui/ui_stage.h).
+//
+// LVGL context only.
+
+/**
+ * @brief Open the calendar on the current month
+ */
+void calendar_view_open(void);
+
+/**
+ * @brief Close the calendar, if open
+ */
+void calendar_view_close(void);
+
+/**
+ * @brief true while the calendar is shown
+ */
+bool calendar_view_is_open(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
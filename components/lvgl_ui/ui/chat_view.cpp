@@ -0,0 +1,256 @@
+#include "chat_view.h"
+#include "ui_theme.h"
+
+#define CHAT_TEXT_MAX   1024
+#define CHAT_GAP        6              // Between bubbles
+#define CHAT_PAD        6              // Inside a bubble
+#define CHAT_WIDTH_PCT  80             // Widest bubble, of the view width
+#define CHAT_MINE_BG    0x1f4f7a
+#define CHAT_GOLDIE_BG  0x2a2a4a
+#define NO_MSG          UINT32_MAX
+
+typedef struct {
+    lv_obj_t *spacer;
+    lv_obj_t *bubble[CHAT_VIEW_POOL];
+    uint32_t bound[CHAT_VIEW_POOL];       // Message each bubble shows, NO_MSG for none
+    lv_obj_t *pending;                    // Streamed reply, NULL for none
+    lv_coord_t pending_h;
+    uint32_t first, end;
+    uint32_t m_id[CHAT_VIEW_ROWS];        // Message measured in each slot (id % CHAT_VIEW_ROWS)
+    lv_coord_t m_w[CHAT_VIEW_ROWS];       // Its bubble size
+    lv_coord_t m_h[CHAT_VIEW_ROWS];
+    bool m_mine[CHAT_VIEW_ROWS];
+    lv_coord_t y[CHAT_VIEW_ROWS + 1];     // Top of each message in range, then the bottom
+    lv_coord_t view_w;
+    lv_coord_t max_w;
+    chat_view_fill_cb_t fill;
+    void *user;
+} chat_view_t;
+
+static char text[CHAT_TEXT_MAX];          // LVGL context only
+
+static void bubble_style(lv_obj_t *label)
+{
+    lv_obj_add_style(label, ui_style(UI_STYLE_TEXT), 0);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_WRAP);
+    lv_obj_set_style_bg_opa(label, LV_OPA_COVER, 0);
+    lv_obj_set_style_radius(label, 8, 0);
+    lv_obj_set_style_pad_all(label, CHAT_PAD, 0);
+    lv_obj_clear_flag(label, LV_OBJ_FLAG_CLICKABLE);
+}
+
+/**
+ * @brief Bubble size of a text at most max_w wide (no label involved)
+ */
+static void measure(chat_view_t *cv, const char *s, lv_coord_t *w, lv_coord_t *h)
+{
+    lv_obj_t *ref = cv->bubble[0];
+    lv_point_t size;
+    lv_txt_get_size(&size, s, lv_obj_get_style_text_font(ref, LV_PART_MAIN),
+                    lv_obj_get_style_text_letter_space(ref, LV_PART_MAIN),
+                    lv_obj_get_style_text_line_space(ref, LV_PART_MAIN),
+                    cv->max_w - 2 * CHAT_PAD, LV_TEXT_FLAG_NONE);
+    *w = size.x + 2 * CHAT_PAD;
+    *h = size.y + 2 * CHAT_PAD;
+}
+
+static void place(chat_view_t *cv, lv_obj_t *label, bool mine, lv_coord_t w, lv_coord_t h, lv_coord_t y)
+{
+    lv_obj_set_size(label, w, h);
+    lv_obj_set_pos(label, mine ? cv->view_w - w : 0, y);
+    lv_obj_set_style_bg_color(label, lv_color_hex(mine ? CHAT_MINE_BG : CHAT_GOLDIE_BG), 0);
+}
+
+/**
+ * @brief Message tops from the measured heights; new messages are measured
+ */
+static void layout(chat_view_t *cv)
+{
+    cv->y[0] = 0;
+    for (uint32_t id = cv->first; id < cv->end; id++) {
+        uint32_t i = id - cv->first;
+        uint32_t slot = id % CHAT_VIEW_ROWS;
+        if (cv->m_id[slot] != id) {
+            text[0] = '\0';
+            bool mine = false;
+            cv->fill(id, &mine, text, sizeof(text), cv->user);
+            measure(cv, text, &cv->m_w[slot], &cv->m_h[slot]);
+            cv->m_mine[slot] = mine;
+            cv->m_id[slot] = id;
+        }
+        cv->y[i + 1] = cv->y[i] + cv->m_h[slot] + CHAT_GAP;
+    }
+    lv_coord_t bottom = cv->y[cv->end - cv->first];
+    if (cv->pending) {
+        lv_obj_set_y(cv->pending, bottom);
+    }
+    lv_obj_set_height(cv->spacer, bottom + cv->pending_h);
+}
+
+/**
+ * @brief Bind the bubbles to the messages in view; untouched if already bound
+ */
+static void refresh(lv_obj_t *obj, chat_view_t *cv)
+{
+    lv_coord_t top = lv_obj_get_scroll_y(obj);
+    lv_coord_t bottom = top + lv_obj_get_content_height(obj);
+    auto in_view = [&](uint32_t id) {
+        return id >= cv->first && id < cv->end &&
+               cv->y[id - cv->first + 1] > top && cv->y[id - cv->first] < bottom;
+    };
+    for (int b = 0; b < CHAT_VIEW_POOL; b++) {
+        if (cv->bound[b] != NO_MSG && !in_view(cv->bound[b])) {
+            lv_obj_add_flag(cv->bubble[b], LV_OBJ_FLAG_HIDDEN);
+            cv->bound[b] = NO_MSG;
+        }
+    }
+    for (uint32_t id = cv->first; id < cv->end; id++) {
+        if (!in_view(id)) {
+            continue;
+        }
+        int free_b = -1;
+        bool shown = false;
+        for (int b = 0; b < CHAT_VIEW_POOL && !shown; b++) {
+            shown = cv->bound[b] == id;
+            if (free_b < 0 && cv->bound[b] == NO_MSG) {
+                free_b = b;
+            }
+        }
+        if (shown || free_b < 0) {
+            continue;
+        }
+        uint32_t slot = id % CHAT_VIEW_ROWS;
+        text[0] = '\0';
+        bool mine = false;
+        cv->fill(id, &mine, text, sizeof(text), cv->user);
+        lv_obj_t *label = cv->bubble[free_b];
+        lv_label_set_text(label, text);
+        place(cv, label, cv->m_mine[slot], cv->m_w[slot], cv->m_h[slot], cv->y[id - cv->first]);
+        lv_obj_clear_flag(label, LV_OBJ_FLAG_HIDDEN);
+        cv->bound[free_b] = id;
+    }
+}
+
+/**
+ * @brief Reader at the bottom (or nothing to scroll): stay there
+ */
+static bool at_bottom(lv_obj_t *obj)
+{
+    return lv_obj_get_scroll_bottom(obj) <= CHAT_GAP;
+}
+
+static void follow_bottom(lv_obj_t *obj, chat_view_t *cv, bool follow)
+{
+    lv_obj_update_layout(obj);
+    if (follow && lv_obj_get_scroll_bottom(obj) > 0) {
+        lv_obj_scroll_to_y(obj, lv_obj_get_scroll_y(obj) + lv_obj_get_scroll_bottom(obj), LV_ANIM_OFF);
+    }
+    refresh(obj, cv);
+}
+
+static void chat_view_event_cb(lv_event_t *e)
+{
+    lv_obj_t *obj = lv_event_get_target(e);
+    chat_view_t *cv = (chat_view_t *)lv_obj_get_user_data(obj);
+    if (cv == NULL) {
+        return;
+    }
+    if (lv_event_get_code(e) == LV_EVENT_DELETE) {
+        lv_obj_set_user_data(obj, NULL);
+        lv_mem_free(cv);
+    } else {
+        refresh(obj, cv);
+    }
+}
+
+extern "C" lv_obj_t *chat_view_create(lv_obj_t *parent, chat_view_fill_cb_t fill, void *user)
+{
+    chat_view_t *cv = (chat_view_t *)lv_mem_alloc(sizeof(chat_view_t));
+    if (cv == NULL) {
+        return NULL;
+    }
+    lv_memset_00(cv, sizeof(*cv));
+    cv->fill = fill;
+    cv->user = user;
+    for (int i = 0; i < CHAT_VIEW_ROWS; i++) {
+        cv->m_id[i] = NO_MSG;
+    }
+
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_set_user_data(obj, cv);
+    lv_obj_set_scroll_dir(obj, LV_DIR_VER);
+    lv_obj_add_event_cb(obj, chat_view_event_cb, LV_EVENT_SCROLL, NULL);
+    lv_obj_add_event_cb(obj, chat_view_event_cb, LV_EVENT_DELETE, NULL);
+
+    // Gives the content the height of every message; bubbles move over it
+    cv->spacer = lv_obj_create(obj);
+    lv_obj_remove_style_all(cv->spacer);
+    lv_obj_clear_flag(cv->spacer, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_size(cv->spacer, 1, 0);
+
+    for (int b = 0; b < CHAT_VIEW_POOL; b++) {
+        cv->bubble[b] = lv_label_create(obj);
+        bubble_style(cv->bubble[b]);
+        lv_obj_add_flag(cv->bubble[b], LV_OBJ_FLAG_HIDDEN);
+        cv->bound[b] = NO_MSG;
+    }
+    return obj;
+}
+
+extern "C" void chat_view_set_range(lv_obj_t *view, uint32_t first, uint32_t end)
+{
+    chat_view_t *cv = (chat_view_t *)lv_obj_get_user_data(view);
+    if (cv == NULL) {
+        return;
+    }
+    if (cv->max_w == 0) {
+        // Bubble width once the view has its final size
+        lv_obj_update_layout(view);
+        cv->view_w = lv_obj_get_content_width(view);
+        cv->max_w = cv->view_w * CHAT_WIDTH_PCT / 100;
+    }
+    if (end - first > CHAT_VIEW_ROWS) {
+        first = end - CHAT_VIEW_ROWS;
+    }
+    bool follow = at_bottom(view);
+    cv->first = first;
+    cv->end = end;
+    // Tops move when old messages leave: rebind what is in view (a few
+    // labels; the heights stay measured)
+    for (int b = 0; b < CHAT_VIEW_POOL; b++) {
+        if (cv->bound[b] != NO_MSG) {
+            lv_obj_add_flag(cv->bubble[b], LV_OBJ_FLAG_HIDDEN);
+            cv->bound[b] = NO_MSG;
+        }
+    }
+    layout(cv);
+    follow_bottom(view, cv, follow);
+}
+
+extern "C" void chat_view_set_pending(lv_obj_t *view, const char *s)
+{
+    chat_view_t *cv = (chat_view_t *)lv_obj_get_user_data(view);
+    if (cv == NULL || cv->max_w == 0) {
+        return;
+    }
+    bool follow = at_bottom(view);
+    if (s == NULL) {
+        if (cv->pending) {
+            lv_obj_del(cv->pending);
+            cv->pending = NULL;
+        }
+        cv->pending_h = 0;
+    } else {
+        if (cv->pending == NULL) {
+            cv->pending = lv_label_create(view);
+            bubble_style(cv->pending);
+        }
+        lv_coord_t w, h;
+        measure(cv, s, &w, &h);
+        lv_label_set_text(cv->pending, s);
+        place(cv, cv->pending, false, w, h, cv->y[cv->end - cv->first]);
+        cv->pending_h = h + CHAT_GAP;
+    }
+    lv_obj_set_height(cv->spacer, cv->y[cv->end - cv->first] + cv->pending_h);
+    follow_bottom(view, cv, follow);
+}
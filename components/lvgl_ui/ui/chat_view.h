@@ -0,0 +1,63 @@
+#ifndef __CHAT_VIEW_H__
+#define __CHAT_VIEW_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// CHAT VIEW - A SCROLLING CONVERSATION THAT RECYCLES ITS BUBBLES
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Like row_list, but for messages of any height: each message is measured
+// once (lv_txt_get_size at the bubble width, no label layout) when it
+// first enters the range, and its height is kept by id. A spacer gives the
+// container the height of all of them; the CHAT_VIEW_POOL bubbles (wrapped
+// labels) are bound to the messages in view and rebound on scroll, the
+// text fetched through the fill callback.
+//
+// The reply being streamed is a pending bubble below the last message:
+// updating it re-measures and relabels that bubble alone, so the cost of a
+// streamed chunk does not grow with the conversation. The view follows the
+// bottom while the reader is there.
+//
+// Owner messages sit on the right, the others on the left. The view frees
+// its state with the object. LVGL context only.
+
+#define CHAT_VIEW_ROWS  32             // Newest messages in range at most
+#define CHAT_VIEW_POOL  8              // Bubbles at most (messages in view)
+
+/**
+ * @brief Write message `id` into buf (NUL-terminated)
+ * @param mine Set true for the owner's messages
+ * @return false if it no longer exists (shown empty)
+ */
+typedef bool (*chat_view_fill_cb_t)(uint32_t id, bool *mine, char *buf, size_t size, void *user);
+
+/**
+ * @brief Create an empty view; size and place it, then chat_view_set_range()
+ */
+lv_obj_t *chat_view_create(lv_obj_t *parent, chat_view_fill_cb_t fill, void *user);
+
+/**
+ * @brief Show messages [first, end) (the newest CHAT_VIEW_ROWS); messages
+ *        measured before keep their height
+ */
+void chat_view_set_range(lv_obj_t *view, uint32_t first, uint32_t end);
+
+/**
+ * @brief Show (or update) the pending bubble under the last message
+ * @param text NULL removes it
+ */
+void chat_view_set_pending(lv_obj_t *view, const char *text);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,73 @@
+#include "day_clock.h"
+#include "lvgl.h"
+#include "esp_log.h"
+#include "time_svc.h"
+#include <stdint.h>
+
+static const char *TAG = "day_clock";
+
+static lv_timer_t *timer = NULL;
+static day_clock_cb_t callback = NULL;
+static int32_t shown_day = -1;           // tm_year * 512 + tm_yday of the last callback
+
+/**
+ * @brief Check the date, call back if it changed (or forced), re-arm
+ */
+static void day_clock_check(bool force)
+{
+    time_t now = time(NULL);
+    if (now < DAY_CLOCK_VALID_TIME) {
+        lv_timer_pause(timer);           // Until day_clock_resync()
+        ESP_LOGD(TAG, "Clock not set - day changes not tracked yet");
+        return;
+    }
+    struct tm tm;
+    time_svc_local(&tm);
+    int32_t day = tm.tm_year * 512 + tm.tm_yday;
+    bool new_day = day != shown_day;
+    shown_day = day;
+    if (new_day || force) {
+        callback(&tm, new_day);
+    }
+
+    struct tm next = tm;
+    next.tm_mday++;
+    next.tm_hour = 0;
+    next.tm_min = 0;
+    next.tm_sec = 0;
+    next.tm_isdst = -1;
+    time_t midnight = mktime(&next);
+    int64_t wait_ms = (int64_t)(midnight - now) * 1000 + DAY_CLOCK_LATE_MS;
+    if (wait_ms <= 0 || wait_ms > DAY_CLOCK_MAX_WAIT_MS) {
+        wait_ms = DAY_CLOCK_MAX_WAIT_MS;
+    }
+    lv_timer_set_period(timer, (uint32_t)wait_ms);
+    lv_timer_reset(timer);
+    lv_timer_resume(timer);
+}
+
+static void day_clock_timer_cb(lv_timer_t *t)
+{
+    day_clock_check(false);
+}
+
+extern "C" bool day_clock_start(day_clock_cb_t cb)
+{
+    if (timer != NULL || cb == NULL) {
+        return timer != NULL;
+    }
+    timer = lv_timer_create(day_clock_timer_cb, DAY_CLOCK_MAX_WAIT_MS, NULL);
+    if (timer == NULL) {
+        return false;
+    }
+    callback = cb;
+    day_clock_check(true);
+    return true;
+}
+
+extern "C" void day_clock_resync(void)
+{
+    if (timer != NULL) {
+        day_clock_check(true);
+    }
+}
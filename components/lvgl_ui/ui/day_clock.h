@@ -0,0 +1,53 @@
+#ifndef __DAY_CLOCK_H__
+#define __DAY_CLOCK_H__
+
+#include <stdbool.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DAY CLOCK - WALL-CLOCK DAY CHANGES WITHOUT POLLING
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// One LVGL timer armed for just after the next local midnight, worked out
+// from the wall clock with mktime (so DST days are 23 or 25 hours). It
+// fires the callback with new_day set when the local date changed, then
+// re-arms itself.
+//
+// LVGL timers run on the tick, not the wall clock, so a wait is never
+// longer than DAY_CLOCK_MAX_WAIT_MS: a long wait is re-measured a few
+// times and the last one lands on midnight. Those checks cost a
+// localtime_r and nothing else.
+//
+// A jump of the clock (SNTP sync, RTC restore) or a TZ change moves
+// midnight: day_clock_resync() calls the callback at once (new_day only
+// if the date changed) and re-arms. While the clock is not set (before
+// DAY_CLOCK_VALID_TIME) nothing fires; the first resync after it is set
+// does.
+//
+// LVGL context only.
+
+#define DAY_CLOCK_VALID_TIME   1704067200         // 2024-01-01: the clock is set
+#define DAY_CLOCK_MAX_WAIT_MS  (60 * 60 * 1000)   // Re-measure at least hourly
+#define DAY_CLOCK_LATE_MS      500                // Land just after midnight, not just before
+
+typedef void (*day_clock_cb_t)(const struct tm *now, bool new_day);
+
+/**
+ * @brief Start the clock; calls cb now if the wall clock is set
+ */
+bool day_clock_start(day_clock_cb_t cb);
+
+/**
+ * @brief The wall clock or time zone changed: call cb now and re-arm
+ */
+void day_clock_resync(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,352 @@
+#include "history_view.h"
+#include "row_list.h"
+#include "ui_stage.h"
+#include "ui_theme.h"
+#include "ui_fonts.h"
+#include "ui_arena.h"
+#include "ui_obj_track.h"
+#include "ui_latency.h"
+#include "state/dash_store.h"
+#include "tileview/diag_tile.h"
+#include "tileview/trend_tile.h"
+#include "esp_timer.h"
+#include <stdio.h>
+
+#define HISTORY_ROW_H         40   // History popup row (row_list): two lines at full width
+#define HISTORY_ROW_H_NARROW  72   // Day popup column: a parameter entry wraps to four
+
+static lv_obj_t *host = NULL;
+static lv_obj_t *popup_history = NULL;     // Cleared by history_delete_cb
+static ui_stage_t day_stage;
+static int32_t day_history_day = 0;        // Day number shown by the day popup being built
+
+static void history_delete_cb(lv_event_t *e)
+{
+    popup_history = NULL;
+}
+
+static void history_close_event_cb(lv_event_t *e)
+{
+    history_view_close();
+}
+
+/**
+ * @brief Popup root in the host, tracked and cleared on delete
+ */
+static lv_obj_t *history_popup_create(lv_coord_t w, lv_coord_t h)
+{
+    popup_history = lv_obj_create(host);
+    ui_obj_track_popup(popup_history, "history");
+    lv_obj_set_size(popup_history, w, h);
+    lv_obj_center(popup_history);
+    lv_obj_add_style(popup_history, ui_style(UI_STYLE_POPUP), 0);
+    lv_obj_add_event_cb(popup_history, history_delete_cb, LV_EVENT_DELETE, NULL);
+    return popup_history;
+}
+
+/**
+ * @brief Close button of a history popup
+ */
+static void history_close_button(lv_align_t align, lv_coord_t y_ofs)
+{
+    lv_obj_t *btn_close = lv_btn_create(popup_history);
+    lv_obj_set_size(btn_close, 100, 40);
+    lv_obj_align(btn_close, align, 0, y_ofs);
+    lv_obj_t *label = lv_label_create(btn_close);
+    lv_label_set_text(label, "Close");
+    lv_obj_center(label);
+    lv_obj_add_event_cb(btn_close, history_close_event_cb, LV_EVENT_CLICKED, NULL);
+}
+
+/**
+ * @brief Row text of a history event (time prefix: day-only or date and time)
+ */
+static void format_history_row(const history_event_t *ev, bool with_date, char *buf, size_t size)
+{
+    int n;
+    if (with_date) {
+        struct tm tm;
+        localtime_r(&ev->timestamp, &tm);
+        n = snprintf(buf, size, "%02d/%02d %02d:%02d - ", tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min);
+    } else {
+        n = snprintf(buf, size, "%02d:%02d - ", ev->minute / 60, ev->minute % 60);
+    }
+    if (n < 0 || (size_t)n >= size) {
+        return;
+    }
+    switch (ev->kind) {
+    case HISTORY_FEED:
+        snprintf(buf + n, size - n, with_date ? "Feed button click" : "Fed");
+        break;
+    case HISTORY_WATER:
+        snprintf(buf + n, size - n, with_date ? "Water button click" : "Water change");
+        break;
+    default:
+        snprintf(buf + n, size - n, "%sNH3:%.2f NO3:%.2f NO2:%.2f pH:%.1f-%.1f",
+                 with_date ? "" : "Parameters: ",
+                 ev->value[HISTORY_AMMONIA], ev->value[HISTORY_NITRATE], ev->value[HISTORY_NITRITE],
+                 ev->value[HISTORY_LOW_PH], ev->value[HISTORY_HIGH_PH]);
+        break;
+    }
+}
+
+/**
+ * @brief Row list fill: the day's feeds, then water changes, then tests
+ */
+static void day_history_fill(uint32_t row, char *buf, size_t size, void *user)
+{
+    static const history_kind_t order[] = { HISTORY_FEED, HISTORY_WATER, HISTORY_PARAM };
+    for (history_kind_t kind : order) {
+        for (const history_event_t *ev = history_first(kind, day_history_day); ev; ev = history_next(ev)) {
+            if (row-- == 0) {
+                format_history_row(ev, false, buf, size);
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Row list fill: n-th newest event of the kind in user
+ */
+static void kind_history_fill(uint32_t row, char *buf, size_t size, void *user)
+{
+    const history_event_t *ev = history_at((history_kind_t)(uintptr_t)user, row);
+    if (ev) {
+        format_history_row(ev, true, buf, size);
+    }
+}
+
+/**
+ * @brief Staged build of the day history popup: activity log, then plans
+ */
+static void day_history_build_step(uint16_t step, void *user)
+{
+    if (!popup_history) return;
+    int32_t target_day = day_history_day;
+
+    if (step == 0) {
+        // Section 1: Activity Log (Left side)
+        lv_obj_t *section1_title = lv_label_create(popup_history);
+        lv_label_set_text(section1_title, "Activity Log");
+        lv_obj_set_style_text_font(section1_title, ui_font(UI_FONT_14), 0);
+        lv_obj_set_style_text_color(section1_title, lv_palette_main(LV_PALETTE_CYAN), 0);
+        lv_obj_set_pos(section1_title, 10, 50);
+
+        // Feed, water and parameter events of this day only; rows are
+        // recycled, so a busy day costs no more objects than a quiet one
+        uint32_t events = history_count(HISTORY_FEED, target_day) + history_count(HISTORY_WATER, target_day) +
+                          history_count(HISTORY_PARAM, target_day);
+        if (events == 0) {
+            lv_obj_t *list = lv_list_create(popup_history);
+            lv_obj_set_size(list, 210, 125);
+            lv_obj_set_pos(list, 10, 75);
+            lv_list_add_text(list, "No activity recorded for this day");
+            return;
+        }
+        lv_obj_t *list = row_list_create(popup_history, HISTORY_ROW_H_NARROW, day_history_fill, NULL);
+        if (list) {
+            lv_obj_set_size(list, 210, 125);
+            lv_obj_set_pos(list, 10, 75);
+            row_list_set_count(list, events);
+        }
+        return;
+    }
+
+    // Section 2: Planned Activity (Right side - only show for today and future days)
+    int32_t today = history_day_of(time(NULL));
+    if (target_day < today) {
+        return;
+    }
+    dash_live_t live;
+    dash_store_read(&live);
+
+    lv_obj_t *section2_title = lv_label_create(popup_history);
+    lv_label_set_text(section2_title, "Planned Activity");
+    lv_obj_set_style_text_font(section2_title, ui_font(UI_FONT_14), 0);
+    lv_obj_set_style_text_color(section2_title, lv_palette_main(LV_PALETTE_ORANGE), 0);
+    lv_obj_set_pos(section2_title, 230, 50);
+
+    lv_obj_t *plan_list = lv_list_create(popup_history);
+    lv_obj_set_size(plan_list, 210, 125);
+    lv_obj_set_pos(plan_list, 230, 75);
+
+    // The shown tank's feed schedule
+    lv_list_add_text(plan_list, "Feed Schedule:");
+    bool has_feed_schedule = false;
+    for (int i = 0; i < DASH_LIVE_FEED_TIMES; i++) {
+        uint16_t minute = live.feed_minute[i];
+        if (minute != DASH_LIVE_NO_FEED) {
+            char feed_entry[64];
+            snprintf(feed_entry, sizeof(feed_entry), "  %02d:%02d - Feed time", minute / 60, minute % 60);
+            lv_list_add_text(plan_list, feed_entry);
+            has_feed_schedule = true;
+        }
+    }
+    if (!has_feed_schedule) {
+        lv_list_add_text(plan_list, "  No feed schedule configured");
+    }
+
+    // Show water change schedule based on most recent change and planned interval
+    const history_event_t *last_water = history_latest(HISTORY_WATER);
+
+    lv_list_add_text(plan_list, "");
+    if (live.planned_water_change_interval > 0) {
+        if (last_water) {
+            // Calculate next due date
+            int32_t next_due_day = last_water->day + (int32_t)live.planned_water_change_interval;
+            int days_diff = next_due_day - target_day;
+
+            if (days_diff == 0) {
+                lv_list_add_text(plan_list, "Water change scheduled today");
+            } else if (days_diff > 0) {
+                char clean_info[64];
+                snprintf(clean_info, sizeof(clean_info), "Next water change in %d days", days_diff);
+                lv_list_add_text(plan_list, clean_info);
+            } else {
+                char clean_info[64];
+                snprintf(clean_info, sizeof(clean_info), "Water change overdue by %d days", -days_diff);
+                lv_list_add_text(plan_list, clean_info);
+            }
+        } else {
+            // No water change recorded yet
+            lv_list_add_text(plan_list, "Water change scheduled");
+        }
+    } else {
+        lv_list_add_text(plan_list, "No water change schedule");
+    }
+}
+
+extern "C" void history_view_set_host(lv_obj_t *obj)
+{
+    host = obj;
+}
+
+extern "C" void history_view_show_day(time_t target_date)
+{
+    if (popup_history || !host) return;
+    int64_t build_t0 = esp_timer_get_time();
+
+    history_popup_create(450, 400);
+    ui_arena_scope arena(popup_history);   // The rest of the build: popup arena
+
+    // Get target day info
+    struct tm target_tm;
+    localtime_r(&target_date, &target_tm);
+    day_history_day = history_civil_day(target_tm.tm_year + 1900, target_tm.tm_mon + 1, target_tm.tm_mday);
+
+    char title_text[64];
+    strftime(title_text, sizeof(title_text), "Activity - %d %b %Y", &target_tm);
+    lv_obj_t *title = lv_label_create(popup_history);
+    lv_label_set_text(title, title_text);
+    lv_obj_add_style(title, ui_style(UI_STYLE_TITLE), 0);
+    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
+
+    history_close_button(LV_ALIGN_BOTTOM_MID, -80);
+    lv_obj_move_foreground(popup_history);
+
+    // Activity log and planned activity lists fill in over the next ticks
+    ui_stage_start(&day_stage, "Day history", popup_history, 2,
+                   day_history_build_step, NULL, esp_timer_get_time() - build_t0);
+}
+
+extern "C" void history_view_show_kind(history_kind_t kind)
+{
+    static const char *titles[HISTORY_KIND_COUNT] = {
+        "Feed Button History (7 Days)",         // HISTORY_FEED
+        "Water Button History (7 Days)",        // HISTORY_WATER
+        "Parameter History (7 Days)",           // HISTORY_PARAM
+    };
+    if (popup_history || !host) return;
+
+    history_popup_create(450, 300);
+    ui_arena_scope arena(popup_history);   // The rest of the build: popup arena
+
+    lv_obj_t *title = lv_label_create(popup_history);
+    lv_label_set_text(title, titles[kind]);
+    lv_obj_add_style(title, ui_style(UI_STYLE_TITLE), 0);
+    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
+
+    lv_obj_t *list = row_list_create(popup_history, HISTORY_ROW_H, kind_history_fill, (void *)(uintptr_t)kind);
+    if (list) {
+        lv_obj_set_size(list, 430, 220);
+        lv_obj_align(list, LV_ALIGN_TOP_MID, 0, 40);
+        size_t count = 0;
+        while (history_at(kind, count) != NULL) {
+            count++;
+        }
+        row_list_set_count(list, count);
+    }
+
+    if (kind == HISTORY_PARAM) {
+        lv_obj_t *btn_trend = lv_btn_create(popup_history);
+        lv_obj_set_size(btn_trend, 100, 40);
+        lv_obj_align(btn_trend, LV_ALIGN_BOTTOM_LEFT, 10, -10);
+        lv_obj_t *trend_label = lv_label_create(btn_trend);
+        lv_label_set_text(trend_label, "Trend");
+        lv_obj_center(trend_label);
+        lv_obj_add_event_cb(btn_trend, [](lv_event_t *e) { history_view_show_trend(); }, LV_EVENT_CLICKED, NULL);
+    }
+
+    history_close_button(LV_ALIGN_BOTTOM_MID, -10);
+    lv_obj_move_foreground(popup_history);
+}
+
+extern "C" void history_view_show_trend(void)
+{
+    if (!host) return;
+    if (popup_history) {
+        lv_obj_del(popup_history);      // Replaces the list it was opened from
+    }
+    int64_t build_t0 = esp_timer_get_time();
+
+    history_popup_create(470, 380);
+    lv_obj_add_style(popup_history, ui_style(UI_STYLE_TEXT), 0);
+    lv_obj_clear_flag(popup_history, LV_OBJ_FLAG_SCROLLABLE);
+
+    trend_view_init(popup_history);
+
+    history_close_button(LV_ALIGN_BOTTOM_MID, 0);
+    lv_obj_move_foreground(popup_history);
+    // First window comes from SD (later ones mostly from the trend cache)
+    ui_stage_note_stall("Trend", esp_timer_get_time() - build_t0);
+}
+
+extern "C" void history_view_show_diagnostics(void)
+{
+    if (popup_history || !host) return;
+
+    history_popup_create(460, 420);
+    lv_obj_set_style_pad_all(popup_history, 0, 0);
+    lv_obj_clear_flag(popup_history, LV_OBJ_FLAG_SCROLLABLE);
+
+    // Swipe between tiles; each refreshes only while shown
+    lv_obj_t *tiles = lv_tileview_create(popup_history);
+    lv_obj_set_size(tiles, lv_pct(100), 360);
+    lv_obj_align(tiles, LV_ALIGN_TOP_MID, 0, 0);
+    lv_obj_set_style_bg_opa(tiles, LV_OPA_TRANSP, 0);
+    uint8_t col = 0;
+    lv_obj_t *tile = lv_tileview_add_tile(tiles, col++, 0, LV_DIR_RIGHT);
+    diag_tile_init(tile);
+#if CONFIG_GOLDIE_UI_LATENCY
+    tile = lv_tileview_add_tile(tiles, col++, 0, LV_DIR_HOR);
+    diag_latency_tile_init(tile);
+#endif
+    tile = lv_tileview_add_tile(tiles, col++, 0, LV_DIR_LEFT);
+    diag_net_tile_init(tile);
+
+    history_close_button(LV_ALIGN_BOTTOM_MID, -10);
+    lv_obj_move_foreground(popup_history);
+}
+
+extern "C" void history_view_close(void)
+{
+    if (popup_history) {
+        lv_obj_del(popup_history);      // DELETE handler clears the pointer
+    }
+}
+
+extern "C" bool history_view_is_open(void)
+{
+    return popup_history != NULL;
+}
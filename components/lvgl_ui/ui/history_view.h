@@ -0,0 +1,73 @@
+#ifndef __HISTORY_VIEW_H__
+#define __HISTORY_VIEW_H__
+
+#include <stdbool.h>
+#include <time.h>
+#include "lvgl.h"
+#include "history/history_index.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// HISTORY VIEWS - A DAY'S ACTIVITY, THE LOGS OF A KIND, TREND, DIAGNOSTICS
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// The popups over the side panel that look back: the activity of one day
+// (a week strip box or a monthly calendar cell) next to what is planned
+// for it, the last week's events of one kind (a log popup's History),
+// the parameter trend chart and the diagnostics tiles (long-press
+// Parameters).
+//
+// Events come from the history index (history/history_index.h); the
+// plan - feed times, water change interval - from dash_store, so the
+// views hold no tank state and write nothing. Lists are row_lists and the
+// day popup is built in stages, so a busy week costs no more objects or
+// frame time than a quiet one.
+//
+// One history popup at a time: opening another while one is shown is a
+// no-op (the trend chart replaces the list it was opened from).
+//
+// LVGL context only.
+
+/**
+ * @brief Set the object the popups open in (the side panel's content)
+ */
+void history_view_set_host(lv_obj_t *host);
+
+/**
+ * @brief Activity and plan of the local day containing `day`
+ */
+void history_view_show_day(time_t day);
+
+/**
+ * @brief Newest events of a kind (HISTORY_PARAM adds the Trend button)
+ */
+void history_view_show_kind(history_kind_t kind);
+
+/**
+ * @brief Parameter trend chart (tileview/trend_tile.h)
+ */
+void history_view_show_trend(void);
+
+/**
+ * @brief Diagnostics tiles (tileview/diag_tile.h)
+ */
+void history_view_show_diagnostics(void);
+
+/**
+ * @brief Close the history popup shown, if any
+ */
+void history_view_close(void);
+
+/**
+ * @brief true while a history popup is shown
+ */
+bool history_view_is_open(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
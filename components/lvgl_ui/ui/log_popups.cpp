@@ -0,0 +1,452 @@
+#include "log_popups.h"
+#include "history_view.h"
+#include "num_keypad.h"
+#include "ui_stage.h"
+#include "ui_theme.h"
+#include "ui_heap.h"
+#include "state/dash_store.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char *TAG = "log_popups";
+
+#ifndef CONFIG_GOLDIE_UI_PREBUILD_KB
+#define CONFIG_GOLDIE_UI_PREBUILD_KB 32
+#endif
+#define PREBUILD_CHECK_MS       250
+#define PREBUILD_IDLE_MS        300    // No touch for this long before building one
+
+// Keypad over the host's content area
+#define LOG_KEYPAD_W            440
+#define LOG_KEYPAD_H            280
+
+static lv_obj_t *host = NULL;
+static log_popups_hooks_t hooks;
+
+/**
+ * @brief Input field click: the keypad, over the panel
+ */
+static void input_field_event_cb(lv_event_t *e) {
+    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+        num_keypad_show(lv_event_get_target(e), host, LOG_KEYPAD_W, LOG_KEYPAD_H);
+    }
+}
+
+static void close_event_cb(lv_event_t *e) {
+    hooks.close();
+}
+
+/**
+ * @brief Close button, bottom right
+ */
+static void add_close_button(lv_obj_t *root, lv_coord_t y_ofs)
+{
+    lv_obj_t *btn_close = lv_btn_create(root);
+    lv_obj_set_size(btn_close, 100, 40);
+    lv_obj_align(btn_close, LV_ALIGN_BOTTOM_RIGHT, -20, y_ofs);
+    lv_obj_t *label_close = lv_label_create(btn_close);
+    lv_label_set_text(label_close, "Close");
+    lv_obj_center(label_close);
+    lv_obj_add_event_cb(btn_close, close_event_cb, LV_EVENT_CLICKED, NULL);
+}
+
+/**
+ * @brief History button, bottom left: the newest events of `kind`
+ */
+static void add_history_button(lv_obj_t *root, lv_coord_t y_ofs, history_kind_t kind)
+{
+    lv_obj_t *btn_hist = lv_btn_create(root);
+    lv_obj_set_size(btn_hist, 80, 40);
+    lv_obj_align(btn_hist, LV_ALIGN_BOTTOM_LEFT, 20, y_ofs);
+    lv_obj_t *label_hist = lv_label_create(btn_hist);
+    lv_label_set_text(label_hist, "History");
+    lv_obj_center(label_hist);
+    lv_obj_add_event_cb(btn_hist, [](lv_event_t *e) {
+        history_view_show_kind((history_kind_t)(uintptr_t)lv_event_get_user_data(e));
+    }, LV_EVENT_CLICKED, (void *)(uintptr_t)kind);
+}
+
+/**
+ * @brief Parameter Save: the four values to the dashboard, then close
+ */
+static void save_param_log_cb(lv_event_t *e) {
+    // Read values from input fields (5 fields: NH3, NO3, NO2, pH, pH_unused)
+    lv_obj_t *popup = (lv_obj_t *)lv_event_get_user_data(e);
+    lv_obj_t *inputs[5];
+    int input_idx = 0;
+
+    // Find all textarea children in the popup
+    uint32_t child_count = lv_obj_get_child_cnt(popup);
+    for (uint32_t i = 0; i < child_count && input_idx < 5; i++) {
+        lv_obj_t *child = lv_obj_get_child(popup, i);
+        if (lv_obj_check_type(child, &lv_textarea_class)) {
+            inputs[input_idx++] = child;
+        }
+    }
+
+    if (input_idx == 5) {
+        const float values[4] = {
+            (float)atof(lv_textarea_get_text(inputs[0])),
+            (float)atof(lv_textarea_get_text(inputs[1])),
+            (float)atof(lv_textarea_get_text(inputs[2])),
+            (float)atof(lv_textarea_get_text(inputs[3])),
+        };
+        hooks.save_params(values);
+    }
+    hooks.close();
+}
+
+/**
+ * @brief Build the parameter log popup with 5 input fields (values: param_popup_fill)
+ */
+static lv_obj_t *build_param_popup(void) {
+    lv_obj_t *root = lv_obj_create(host);
+    lv_obj_set_size(root, 460, 310);
+    lv_obj_center(root);
+    lv_obj_add_style(root, ui_style(UI_STYLE_POPUP_LOG), 0);
+    lv_obj_set_style_border_color(root, lv_palette_main(LV_PALETTE_BLUE), 0);
+
+    lv_obj_t *title = lv_label_create(root);
+    lv_label_set_text(title, LV_SYMBOL_EDIT " Parameter Log");
+    lv_obj_add_style(title, ui_style(UI_STYLE_TITLE), 0);
+    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
+
+    const char *param_names[] = {"Ammonia (ppm)", "Nitrate (ppm)", "Nitrite (ppm)", "pH", "pH (unused)"};
+
+    for (int i = 0; i < 5; i++) {
+        lv_obj_t *label = lv_label_create(root);
+        lv_label_set_text(label, param_names[i]);
+        lv_obj_add_style(label, ui_style(UI_STYLE_TEXT), 0);
+        lv_obj_align(label, LV_ALIGN_TOP_LEFT, 20, 50 + i * 38);
+
+        lv_obj_t *input = lv_textarea_create(root);
+        lv_obj_set_size(input, 100, 32);
+        lv_obj_align(input, LV_ALIGN_TOP_RIGHT, -20, 45 + i * 38);
+        lv_textarea_set_one_line(input, true);
+        lv_obj_add_event_cb(input, input_field_event_cb, LV_EVENT_CLICKED, NULL);
+    }
+
+    add_history_button(root, -10, HISTORY_PARAM);
+
+    lv_obj_t *btn_save = lv_btn_create(root);
+    lv_obj_set_size(btn_save, 100, 40);
+    lv_obj_align(btn_save, LV_ALIGN_BOTTOM_MID, 0, -10);
+    lv_obj_t *label_save = lv_label_create(btn_save);
+    lv_label_set_text(label_save, "Save");
+    lv_obj_center(label_save);
+    lv_obj_add_event_cb(btn_save, save_param_log_cb, LV_EVENT_CLICKED, root);
+
+    add_close_button(root, -10);
+    return root;
+}
+
+/**
+ * @brief Load the shown tank's current values (not from log history)
+ */
+static void param_popup_fill(lv_obj_t *popup, const dash_live_t *live)
+{
+    float latest_values[] = {
+        live->ammonia_ppm,     // Current ammonia value
+        live->nitrate_ppm,     // Current nitrate value
+        live->nitrite_ppm,     // Current nitrite value
+        live->ph_level,        // Current pH value
+        live->ph_level         // Placeholder (only one pH field needed)
+    };
+    int input_idx = 0;
+    uint32_t child_count = lv_obj_get_child_cnt(popup);
+    for (uint32_t i = 0; i < child_count && input_idx < 5; i++) {
+        lv_obj_t *child = lv_obj_get_child(popup, i);
+        if (lv_obj_check_type(child, &lv_textarea_class)) {
+            char val_str[16];
+            snprintf(val_str, sizeof(val_str), "%.2f", latest_values[input_idx++]);
+            lv_textarea_set_text(child, val_str);
+        }
+    }
+}
+
+/**
+ * @brief Build the water change log popup (interval: water_popup_fill)
+ */
+static lv_obj_t *build_water_popup(void) {
+    lv_obj_t *root = lv_obj_create(host);
+    lv_obj_set_size(root, 400, 220);
+    lv_obj_center(root);
+    lv_obj_add_style(root, ui_style(UI_STYLE_POPUP_LOG), 0);
+    lv_obj_set_style_border_color(root, lv_palette_main(LV_PALETTE_CYAN), 0);
+
+    lv_obj_t *title = lv_label_create(root);
+    lv_label_set_text(title, LV_SYMBOL_REFRESH " Water Change Log");
+    lv_obj_add_style(title, ui_style(UI_STYLE_TITLE), 0);
+    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
+
+    lv_obj_t *label = lv_label_create(root);
+    lv_label_set_text(label, "Change water every (days):");
+    lv_obj_add_style(label, ui_style(UI_STYLE_TEXT), 0);
+    lv_obj_set_pos(label, 20, 60);
+
+    lv_obj_t *input = lv_textarea_create(root);
+    lv_obj_set_size(input, 80, 35);
+    lv_obj_set_pos(input, 280, 55);
+    lv_textarea_set_one_line(input, true);
+    lv_obj_add_event_cb(input, input_field_event_cb, LV_EVENT_CLICKED, NULL);
+
+    add_history_button(root, -15, HISTORY_WATER);
+
+    lv_obj_t *btn_save = lv_btn_create(root);
+    lv_obj_set_size(btn_save, 120, 40);
+    lv_obj_align(btn_save, LV_ALIGN_BOTTOM_MID, 0, -15);
+    lv_obj_t *label_save = lv_label_create(btn_save);
+    lv_label_set_text(label_save, "Save Schedule");
+    lv_obj_center(label_save);
+    lv_obj_add_event_cb(btn_save, [](lv_event_t *e) {
+        lv_obj_t *input = (lv_obj_t *)lv_event_get_user_data(e);
+        int interval = atoi(lv_textarea_get_text(input));
+        if (interval > 0 && interval <= 365) {
+            hooks.set_water_interval((uint32_t)interval);
+        }
+        hooks.close();
+    }, LV_EVENT_CLICKED, input);
+
+    add_close_button(root, -15);
+    return root;
+}
+
+/**
+ * @brief Set the input to the shown tank's planned interval
+ */
+static void water_popup_fill(lv_obj_t *popup, const dash_live_t *live)
+{
+    char val_str[16];
+    snprintf(val_str, sizeof(val_str), "%lu", (unsigned long)live->planned_water_change_interval);
+    lv_textarea_set_text(lv_obj_get_child(popup, 2), val_str);   // Title, label, input
+}
+
+/**
+ * @brief Build the feed log popup (feed count: feed_popup_fill)
+ */
+static lv_obj_t *build_feed_popup(void) {
+    lv_obj_t *root = lv_obj_create(host);
+    lv_obj_set_size(root, 400, 320);
+    lv_obj_center(root);
+    lv_obj_add_style(root, ui_style(UI_STYLE_POPUP_LOG), 0);
+    lv_obj_set_style_border_color(root, lv_palette_main(LV_PALETTE_GREEN), 0);
+
+    lv_obj_t *title = lv_label_create(root);
+    lv_label_set_text(title, LV_SYMBOL_IMAGE " Feed Management");
+    lv_obj_add_style(title, ui_style(UI_STYLE_TITLE), 0);
+    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
+
+    // Schedule section
+    lv_obj_t *schedule_label = lv_label_create(root);
+    lv_label_set_text(schedule_label, "Planned Schedule:");
+    lv_obj_set_style_text_color(schedule_label, lv_palette_main(LV_PALETTE_ORANGE), 0);
+    lv_obj_set_pos(schedule_label, 20, 45);
+
+    // Number of feeds input
+    lv_obj_t *feeds_label = lv_label_create(root);
+    lv_label_set_text(feeds_label, "Feeds per day:");
+    lv_obj_add_style(feeds_label, ui_style(UI_STYLE_TEXT), 0);
+    lv_obj_set_pos(feeds_label, 20, 75);
+
+    lv_obj_t *feeds_input = lv_textarea_create(root);
+    lv_obj_set_size(feeds_input, 60, 35);
+    lv_obj_set_pos(feeds_input, 150, 70);
+    lv_textarea_set_one_line(feeds_input, true);
+    lv_obj_add_event_cb(feeds_input, input_field_event_cb, LV_EVENT_CLICKED, NULL);
+
+    // Configure times button
+    lv_obj_t *btn_config = lv_btn_create(root);
+    lv_obj_set_size(btn_config, 150, 40);
+    lv_obj_set_pos(btn_config, 225, 70);
+    lv_obj_t *label_config = lv_label_create(btn_config);
+    lv_label_set_text(label_config, "Set Schedule");
+    lv_obj_center(label_config);
+    lv_obj_add_event_cb(btn_config, [](lv_event_t *e) {
+        lv_obj_t *input = (lv_obj_t *)lv_event_get_user_data(e);
+        hooks.set_feed_schedule(atoi(lv_textarea_get_text(input)));
+        hooks.close();
+    }, LV_EVENT_CLICKED, feeds_input);
+
+    add_history_button(root, -15, HISTORY_FEED);
+
+    lv_obj_t *btn_save = lv_btn_create(root);
+    lv_obj_set_size(btn_save, 100, 40);
+    lv_obj_align(btn_save, LV_ALIGN_BOTTOM_MID, 0, -15);
+    lv_obj_t *label_save = lv_label_create(btn_save);
+    lv_label_set_text(label_save, "Save");
+    lv_obj_center(label_save);
+    lv_obj_add_event_cb(btn_save, [](lv_event_t *e) {
+        hooks.log_feed();
+        hooks.close();
+    }, LV_EVENT_CLICKED, NULL);
+
+    add_close_button(root, -15);
+    return root;
+}
+
+/**
+ * @brief Set the input to the shown tank's enabled feed count
+ */
+static void feed_popup_fill(lv_obj_t *popup, const dash_live_t *live)
+{
+    // Count currently enabled feeds
+    int active_feeds = 0;
+    for (int i = 0; i < DASH_LIVE_FEED_TIMES; i++) {
+        if (live->feed_minute[i] != DASH_LIVE_NO_FEED) active_feeds++;
+    }
+    if (active_feeds == 0) active_feeds = 3; // Default
+
+    char feeds_str[8];
+    snprintf(feeds_str, sizeof(feeds_str), "%d", active_feeds);
+    lv_textarea_set_text(lv_obj_get_child(popup, 3), feeds_str);   // Title, two labels, input
+}
+
+typedef struct {
+    const char *name;
+    lv_obj_t *(*build)(void);            // Hidden-ready tree, no tank values
+    void (*fill)(lv_obj_t *popup, const dash_live_t *live);  // The shown tank's values, at open
+    lv_obj_t *open;                      // The popup while on screen
+    lv_obj_t *spare;                     // Pre-built, hidden in the host
+    size_t bytes;                        // LVGL heap taken by its last pre-build
+    bool too_big;                        // Alone over the budget: never pre-built
+    uint16_t opens;                      // Taps so far (the prediction)
+    uint16_t hits;                       // Of those, served from the spare
+} popup_prebuild_t;
+
+static popup_prebuild_t log_popups[LOG_POPUP_COUNT] = {
+    { "Parameter log popup", build_param_popup, param_popup_fill },
+    { "Water log popup", build_water_popup, water_popup_fill },
+    { "Feed log popup", build_feed_popup, feed_popup_fill },
+};
+static size_t prebuild_bytes = 0;        // Held by the spares
+static lv_timer_t *prebuild_timer = NULL;
+
+/**
+ * @brief Bytes allocated across the LVGL heap's pools
+ */
+static size_t lv_heap_used(void)
+{
+    size_t used = 0;
+    for (int i = 0; i < UI_HEAP_POOL_COUNT; i++) {
+        ui_heap_stats_t st;
+        ui_heap_get_stats((ui_heap_pool_t)i, &st);
+        used += st.used;
+    }
+    return used;
+}
+
+/**
+ * @brief Next popup worth building ahead: most often opened first, within the budget
+ */
+static popup_prebuild_t *prebuild_pick(void)
+{
+    popup_prebuild_t *best = NULL;
+    for (int i = 0; i < LOG_POPUP_COUNT; i++) {
+        popup_prebuild_t *pb = &log_popups[i];
+        if (pb->spare || pb->open || pb->too_big) continue;
+        if (pb->bytes && prebuild_bytes + pb->bytes > (size_t)CONFIG_GOLDIE_UI_PREBUILD_KB * 1024) continue;
+        if (!best || pb->opens > best->opens) best = pb;   // Ties: table order (Parameters first)
+    }
+    return best;
+}
+
+/**
+ * @brief Build one likely-next popup, hidden, once the UI is idle
+ */
+static void prebuild_timer_cb(lv_timer_t *timer)
+{
+    if (host == NULL || hooks.busy() || lv_disp_get_inactive_time(NULL) < PREBUILD_IDLE_MS) {
+        return;
+    }
+    popup_prebuild_t *pb = prebuild_pick();
+    if (pb == NULL) {
+        lv_timer_pause(timer);           // Everything that fits is built
+        return;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    size_t heap0 = lv_heap_used();
+    lv_obj_t *popup = pb->build();
+    lv_obj_add_flag(popup, LV_OBJ_FLAG_HIDDEN);
+    size_t used = lv_heap_used();
+    pb->bytes = used > heap0 ? used - heap0 : 0;
+
+    if (prebuild_bytes + pb->bytes > (size_t)CONFIG_GOLDIE_UI_PREBUILD_KB * 1024) {
+        lv_obj_del(popup);               // First build told us its size: it does not fit
+        pb->too_big = pb->bytes > (size_t)CONFIG_GOLDIE_UI_PREBUILD_KB * 1024;
+        ESP_LOGD(TAG, "%s: %u bytes, over the pre-build budget", pb->name, (unsigned)pb->bytes);
+        return;
+    }
+    pb->spare = popup;
+    prebuild_bytes += pb->bytes;
+    ESP_LOGD(TAG, "%s pre-built: %u bytes in %d us (%u KB of %d KB)", pb->name, (unsigned)pb->bytes,
+             (int)(esp_timer_get_time() - t0), (unsigned)(prebuild_bytes / 1024), CONFIG_GOLDIE_UI_PREBUILD_KB);
+}
+
+extern "C" void log_popups_init(lv_obj_t *obj, const log_popups_hooks_t *h)
+{
+    host = obj;
+    hooks = *h;
+}
+
+extern "C" void log_popups_open(log_popup_t which)
+{
+    popup_prebuild_t *pb = &log_popups[which];
+    if (pb->open || host == NULL) return;
+    int64_t build_t0 = esp_timer_get_time();
+
+    lv_obj_t *popup = pb->spare;
+    bool prebuilt = popup != NULL;
+    pb->spare = NULL;
+    if (prebuilt) {
+        prebuild_bytes -= pb->bytes;
+        pb->hits++;
+    } else {
+        popup = pb->build();
+    }
+    pb->opens++;
+    pb->open = popup;
+    dash_live_t live;
+    dash_store_read(&live);
+    pb->fill(popup, &live);
+    lv_obj_clear_flag(popup, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_move_foreground(popup);
+    ui_stage_note_stall(pb->name, esp_timer_get_time() - build_t0);  // Small enough to build in one go
+    ESP_LOGD(TAG, "%s opened %s (%u of %u opens pre-built)", pb->name, prebuilt ? "pre-built" : "cold",
+             pb->hits, pb->opens);
+}
+
+extern "C" void log_popups_close(void)
+{
+    for (int i = 0; i < LOG_POPUP_COUNT; i++) {
+        if (log_popups[i].open) {
+            lv_obj_del(log_popups[i].open);
+            log_popups[i].open = NULL;
+        }
+    }
+}
+
+extern "C" bool log_popups_is_open(void)
+{
+    for (int i = 0; i < LOG_POPUP_COUNT; i++) {
+        if (log_popups[i].open) {
+            return true;
+        }
+    }
+    return false;
+}
+
+extern "C" void log_popups_kick(void)
+{
+    if (CONFIG_GOLDIE_UI_PREBUILD_KB == 0) {
+        return;
+    }
+    if (prebuild_timer == NULL) {
+        prebuild_timer = lv_timer_create(prebuild_timer_cb, PREBUILD_CHECK_MS, NULL);
+    } else {
+        lv_timer_resume(prebuild_timer);
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef __LOG_POPUPS_H__
+#define __LOG_POPUPS_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LOG POPUPS - PARAMETERS, WATER CHANGE AND FEED ENTRY, BUILT AHEAD
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// The three small popups behind the side panel's log buttons. A popup's
+// tree holds no tank values: it is built once (`build`) and filled from
+// dash_store when shown (`fill`), so while the UI is idle the likeliest
+// next one - most opened first - is built ahead, hidden, and a tap only
+// fills and shows it. The spares share CONFIG_GOLDIE_UI_PREBUILD_KB of
+// LVGL heap; a popup whose first build alone is over it is never built
+// ahead.
+//
+// The popups write nothing themselves: Save hands the entered values to
+// the dashboard through the hooks, which owns the tank state, and then
+// calls `close`. History opens history_view.h.
+//
+// LVGL context only.
+
+typedef enum {
+    LOG_POPUP_PARAM = 0,
+    LOG_POPUP_WATER,
+    LOG_POPUP_FEED,
+    LOG_POPUP_COUNT
+} log_popup_t;
+
+typedef struct {
+    /** Parameter Save: ammonia, nitrate, nitrite, pH */
+    void (*save_params)(const float values[4]);
+    /** Water Save Schedule: a change every `days` (1-365) */
+    void (*set_water_interval)(uint32_t days);
+    /** Feed Set Schedule: feeds per day as typed (unclamped) */
+    void (*set_feed_schedule)(int feeds);
+    /** Feed Save: log a feed now */
+    void (*log_feed)(void);
+    /** After Close or a save: close every popup (calls log_popups_close) */
+    void (*close)(void);
+    /** true while building ahead would get in the way (scrolling, panel build, popup open) */
+    bool (*busy)(void);
+} log_popups_hooks_t;
+
+/**
+ * @brief Set the object the popups open in (the side panel's content) and the hooks (copied)
+ */
+void log_popups_init(lv_obj_t *host, const log_popups_hooks_t *hooks);
+
+/**
+ * @brief Show a popup filled with the shown tank's values; no-op while it is open
+ */
+void log_popups_open(log_popup_t which);
+
+/**
+ * @brief Delete the open popups (spares stay)
+ */
+void log_popups_close(void);
+
+/**
+ * @brief true while one of the popups is shown
+ */
+bool log_popups_is_open(void);
+
+/**
+ * @brief Refill the spares on the next idle passes (panel built, a popup closed)
+ */
+void log_popups_kick(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,603 @@
+#include "med_calc_view.h"
+#include "num_keypad.h"
+#include "ui_stage.h"
+#include "ui_theme.h"
+#include "ui_fonts.h"
+#include "ui_arena.h"
+#include "ui_obj_track.h"
+#include "state/dash_log.h"
+#include "med/med_db.h"
+#include "sched/reminders.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "med_calc";
+
+#define MED_CALC_W  440
+#define MED_CALC_H  300
+
+// Calculator state - Universal dosage calculator
+typedef struct {
+    float product_amount;     // Amount of product (e.g., 5 ml)
+    float per_volume;         // Per X gallons/litres (e.g., 10)
+    float tank_size;          // Tank size
+    bool is_gallons;          // true = gallons, false = liters (for "Per" field)
+    bool tank_is_gallons;     // true = gallons, false = liters (for "Tank Size" field)
+    int unit_type;            // med_unit_t: ml, tsp, tbsp, drops, fl oz, cups, g
+    float calculated_dosage;
+    char result_text[320];
+    char product[MED_DB_NAME_LEN];  // Picked from the product search, "" = typed in
+    uint32_t course_every_s;  // Repeat schedule of the product's note (med_db_note_course)
+    uint8_t course_doses;     // 0 = single dose / no schedule
+} med_calculator_state_t;
+
+static med_calculator_state_t med_calc_state = {
+    .product_amount = 5.0,
+    .per_volume = 10.0,
+    .tank_size = 0.0,
+    .is_gallons = false,
+    .tank_is_gallons = false,
+    .unit_type = 0,  // Default to ml
+    .calculated_dosage = 0.0,
+    .result_text = {0},
+    .product = {0},
+    .course_every_s = 0,
+    .course_doses = 0
+};
+
+static med_calc_view_hooks_t hooks;
+
+// Calculator UI objects (cleared by med_calc_delete_cb)
+static lv_obj_t *popup_med_calc = NULL;        // Calculator popup
+static lv_obj_t *med_product_amount_input = NULL;  // Product amount input
+static lv_obj_t *med_unit_dropdown = NULL;     // Unit type selector (ml/tsp/tbsp/drops/fl oz/cups/g)
+static lv_obj_t *med_per_volume_input = NULL;  // Per X gallons/litres input
+static lv_obj_t *med_tank_size_input = NULL;   // Tank size input
+static lv_obj_t *med_unit_switch = NULL;       // Gallon/Liter toggle for "Per" field
+static lv_obj_t *med_tank_unit_switch = NULL;  // Gallon/Liter toggle for "Tank Size" field
+static lv_obj_t *med_result_label = NULL;      // Result display in popup
+static lv_obj_t *popup_med_search = NULL;      // Product search over the calculator
+
+#define MED_SEARCH_ROWS  3                     // Matches shown; typing narrows the rest
+static lv_obj_t *med_search_rows[MED_SEARCH_ROWS];
+static lv_obj_t *med_search_more = NULL;       // "+N more" under the rows
+static size_t med_search_first = 0;            // med_db index of the first row
+
+static ui_stage_t build_stage;                 // Input rows and buttons, into the popup
+static ui_stage_t save_stage;                  // Dosage result: hooks, SD log, AI update
+
+/**
+ * @brief Dosage result step: hooks (AI context, AI screen), SD log, AI update
+ *
+ * Reads med_calc_state, so a new calculation flushes the previous one first.
+ */
+static void med_calc_save_step(uint16_t step, void *user)
+{
+    const char *per_unit_str = med_calc_state.is_gallons ? "gal" : "L";
+    const char *tank_unit_str = med_calc_state.tank_is_gallons ? "gal" : "L";
+    const char *dose_unit = med_unit_name((med_unit_t)med_calc_state.unit_type);
+    float dosage_ml = med_calc_state.calculated_dosage;
+
+    if (step == 0) {
+        if (hooks.result == NULL) {
+            return;
+        }
+        // Context for the AI prompt
+        char context[256];
+        snprintf(context, sizeof(context),
+                 "UNIVERSAL DOSAGE CALCULATION:\n"
+                 "- Product: %s%s%.1f %s per %.1f %s\n"
+                 "- Tank Size: %.1f %s\n"
+                 "- Total Dosage: %.2f ml (%.2f tsp)\n",
+                 med_calc_state.product, med_calc_state.product[0] ? ", " : "",
+                 med_calc_state.product_amount, dose_unit, med_calc_state.per_volume, per_unit_str,
+                 med_calc_state.tank_size, tank_unit_str,
+                 dosage_ml, dosage_ml / med_unit_ml(MED_UNIT_TSP));
+
+        // Summary for the AI screen
+        char summary[256];
+        snprintf(summary, sizeof(summary),
+                 "💊 Dosage Calc: %.1f%s/%.1f%s\n"
+                 "Tank %.1f%s → Add %.2f ml",
+                 med_calc_state.product_amount, dose_unit, med_calc_state.per_volume, per_unit_str,
+                 med_calc_state.tank_size, tank_unit_str, dosage_ml);
+        hooks.result(context, summary);
+    } else if (step == 1) {
+        // Save to SD card
+        const dash_log_med_t med = {
+            .product_amount = med_calc_state.product_amount,
+            .per_volume = med_calc_state.per_volume,
+            .tank_size = med_calc_state.tank_size,
+            .dosage_ml = med_calc_state.calculated_dosage,
+            .unit_type = (uint8_t)med_calc_state.unit_type,
+            .per_gallons = med_calc_state.is_gallons,
+            .tank_gallons = med_calc_state.tank_is_gallons,
+        };
+        dash_log_medication(&med);
+    } else if (hooks.advise) {
+        // Trigger AI update with new medication context
+        hooks.advise();
+    }
+}
+
+/**
+ * @brief Calculate medication dosage based on current state
+ */
+static void calculate_medication_dosage(void) {
+    // The previous result's logging reads med_calc_state: finish it first
+    ui_stage_flush(&save_stage);
+
+    // Get input values
+    const char *amount_text = lv_textarea_get_text(med_product_amount_input);
+    const char *per_volume_text = lv_textarea_get_text(med_per_volume_input);
+    const char *tank_size_text = lv_textarea_get_text(med_tank_size_input);
+
+    med_calc_state.product_amount = atof(amount_text);
+    med_calc_state.per_volume = atof(per_volume_text);
+    med_calc_state.tank_size = atof(tank_size_text);
+    med_calc_state.unit_type = lv_dropdown_get_selected(med_unit_dropdown);
+
+    // Validate inputs
+    if (med_calc_state.product_amount <= 0 || med_calc_state.per_volume <= 0 || med_calc_state.tank_size <= 0) {
+        lv_label_set_text(med_result_label, "❌ Invalid input!\nAll values must be positive numbers.");
+        return;
+    }
+
+    // Get unit strings
+    const char *per_unit_str = med_calc_state.is_gallons ? "gal" : "L";
+    const char *tank_unit_str = med_calc_state.tank_is_gallons ? "gal" : "L";
+    const char *dose_unit = med_unit_name((med_unit_t)med_calc_state.unit_type);
+
+    // Convert product amount to ml for calculation
+    float product_amount_ml = med_calc_state.product_amount * med_unit_ml((med_unit_t)med_calc_state.unit_type);
+
+    // Convert volumes to same unit (liters) for calculation
+    float per_volume_l = med_calc_state.per_volume;
+    if (med_calc_state.is_gallons) per_volume_l *= MED_LITRES_PER_GALLON;
+
+    float tank_size_l = med_calc_state.tank_size;
+    if (med_calc_state.tank_is_gallons) tank_size_l *= MED_LITRES_PER_GALLON;
+
+    // Universal formula: (tank_size / per_volume) * product_amount
+    float dosage_ml = (tank_size_l / per_volume_l) * product_amount_ml;
+    med_calc_state.calculated_dosage = dosage_ml;
+
+    // Calculate alternative measurements
+    float dosage_tsp = dosage_ml / med_unit_ml(MED_UNIT_TSP);
+    float dosage_tbsp = dosage_ml / med_unit_ml(MED_UNIT_TBSP);
+    float dosage_drops = dosage_ml / med_unit_ml(MED_UNIT_DROPS);
+    float dosage_floz = dosage_ml / med_unit_ml(MED_UNIT_FL_OZ);
+
+    // Format result text
+    snprintf(med_calc_state.result_text, sizeof(med_calc_state.result_text),
+             "✅ Total Dosage for %.1f %s tank:\n\n"
+             "Based on: %.1f %s per %.1f %s\n\n"
+             "Add to tank:\n"
+             "🧪 %.2f ml\n"
+             "🥄 %.2f tsp\n"
+             "🥄 %.2f tbsp\n"
+             "💧 %.0f drops\n"
+             "🧴 %.2f fl oz",
+             med_calc_state.tank_size, tank_unit_str,
+             med_calc_state.product_amount, dose_unit, med_calc_state.per_volume, per_unit_str,
+             dosage_ml, dosage_tsp, dosage_tbsp, dosage_drops, dosage_floz);
+
+    // A product with a repeat schedule: this is dose 1, the rest are reminded
+    if (med_calc_state.course_doses > 0 &&
+        reminders_start_course(med_calc_state.product, med_calc_state.course_every_s, med_calc_state.course_doses)) {
+        size_t len = strlen(med_calc_state.result_text);
+        snprintf(med_calc_state.result_text + len, sizeof(med_calc_state.result_text) - len,
+                 "\n\n" LV_SYMBOL_BELL " Dose 1 of %u - next reminder in %lu h",
+                 med_calc_state.course_doses, (unsigned long)(med_calc_state.course_every_s / 3600));
+    }
+
+    // Update result label in popup
+    lv_label_set_text(med_result_label, med_calc_state.result_text);
+
+    ESP_LOGI(TAG, "Universal dosage calculated: %.1f %s per %.1f %s for %.1f %s = %.2f ml",
+             med_calc_state.product_amount, dose_unit, med_calc_state.per_volume, per_unit_str,
+             med_calc_state.tank_size, tank_unit_str, dosage_ml);
+
+    // The result shows this frame; AI context and logging follow between frames
+    ui_stage_start(&save_stage, "dosage save", NULL, 3, med_calc_save_step, NULL, 0);
+}
+
+/**
+ * @brief Close calculator popup event callback
+ */
+static void med_calc_close_event_cb(lv_event_t *e) {
+    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+        med_calc_view_close();
+    }
+}
+
+/**
+ * @brief Calculate button event callback
+ */
+static void med_calc_calculate_event_cb(lv_event_t *e) {
+    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+        calculate_medication_dosage();
+    }
+}
+
+/**
+ * @brief Unit toggle switch event callback for "Per" field
+ */
+static void med_unit_switch_event_cb(lv_event_t *e) {
+    if (lv_event_get_code(e) == LV_EVENT_VALUE_CHANGED) {
+        lv_obj_t *sw = lv_event_get_target(e);
+        med_calc_state.is_gallons = lv_obj_has_state(sw, LV_STATE_CHECKED);
+        ESP_LOGI(TAG, "Per field unit switched to: %s", med_calc_state.is_gallons ? "Gallons" : "Liters");
+    }
+}
+
+/**
+ * @brief Tank unit toggle switch event callback
+ */
+static void med_tank_unit_switch_event_cb(lv_event_t *e) {
+    if (lv_event_get_code(e) == LV_EVENT_VALUE_CHANGED) {
+        lv_obj_t *sw = lv_event_get_target(e);
+        med_calc_state.tank_is_gallons = lv_obj_has_state(sw, LV_STATE_CHECKED);
+        ESP_LOGI(TAG, "Tank size unit switched to: %s", med_calc_state.tank_is_gallons ? "Gallons" : "Liters");
+    }
+}
+
+/**
+ * @brief Input field click: the keypad, over the calculator
+ */
+static void med_input_event_cb(lv_event_t *e) {
+    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+        lv_obj_t *field = lv_event_get_target(e);
+        if (field == med_product_amount_input || field == med_per_volume_input) {
+            med_calc_state.product[0] = '\0';  // Typed in: no longer the product's label dose
+            med_calc_state.course_doses = 0;
+        }
+        num_keypad_show(field, popup_med_calc, MED_CALC_W, MED_CALC_H);
+    }
+}
+
+/**
+ * @brief Fill the calculator from a product's label dose
+ */
+static void med_search_apply(const med_product_t *p)
+{
+    char num[16];
+    snprintf(num, sizeof(num), "%g", p->amount);
+    lv_textarea_set_text(med_product_amount_input, num);
+    snprintf(num, sizeof(num), "%g", p->per_volume);
+    lv_textarea_set_text(med_per_volume_input, num);
+    lv_dropdown_set_selected(med_unit_dropdown, p->unit);
+    med_calc_state.is_gallons = p->per_gallons != 0;
+    if (med_calc_state.is_gallons) {
+        lv_obj_add_state(med_unit_switch, LV_STATE_CHECKED);
+    } else {
+        lv_obj_clear_state(med_unit_switch, LV_STATE_CHECKED);
+    }
+    snprintf(med_calc_state.product, sizeof(med_calc_state.product), "%s", p->name);
+    if (!med_db_note_course(p->note, &med_calc_state.course_every_s, &med_calc_state.course_doses)) {
+        med_calc_state.course_doses = 0;
+    }
+    lv_label_set_text_fmt(med_result_label, "%s\n%s\n\nSet the tank size and click Calculate.",
+                          p->name, p->note);
+    ESP_LOGI(TAG, "Dosage calculator: product '%s'", p->name);
+}
+
+/**
+ * @brief Show the first matches of the typed prefix (runs per keystroke)
+ */
+static void med_search_refresh(void)
+{
+    const char *prefix = lv_textarea_get_text(lv_obj_get_child(popup_med_search, 0));
+    size_t matches = med_db_search(prefix, &med_search_first);
+    for (int i = 0; i < MED_SEARCH_ROWS; i++) {
+        const med_product_t *p = (size_t)i < matches ? med_db_get(med_search_first + i) : NULL;
+        if (p == NULL) {
+            lv_obj_add_flag(med_search_rows[i], LV_OBJ_FLAG_HIDDEN);
+            continue;
+        }
+        lv_label_set_text(lv_obj_get_child(med_search_rows[i], 0), p->name);
+        lv_obj_clear_flag(med_search_rows[i], LV_OBJ_FLAG_HIDDEN);
+    }
+    if (matches > MED_SEARCH_ROWS) {
+        lv_label_set_text_fmt(med_search_more, "+%u more", (unsigned)(matches - MED_SEARCH_ROWS));
+    } else {
+        lv_label_set_text(med_search_more, matches == 0 ? "No match" : "");
+    }
+}
+
+static void med_search_close(void)
+{
+    if (popup_med_search) {
+        lv_obj_del(popup_med_search);   // DELETE handler clears the pointers
+    }
+}
+
+static void med_search_event_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    if (code == LV_EVENT_VALUE_CHANGED) {
+        med_search_refresh();
+    } else if (code == LV_EVENT_READY || code == LV_EVENT_CANCEL) {
+        // Enter takes the first match
+        const med_product_t *p = med_db_get(med_search_first);
+        if (code == LV_EVENT_READY && p != NULL && !lv_obj_has_flag(med_search_rows[0], LV_OBJ_FLAG_HIDDEN)) {
+            med_search_apply(p);
+        }
+        med_search_close();
+    }
+}
+
+static void med_search_row_event_cb(lv_event_t *e)
+{
+    size_t row = (size_t)(uintptr_t)lv_event_get_user_data(e);
+    const med_product_t *p = med_db_get(med_search_first + row);
+    if (p != NULL) {
+        med_search_apply(p);
+    }
+    med_search_close();
+}
+
+static void med_search_delete_cb(lv_event_t *e)
+{
+    popup_med_search = NULL;
+    med_search_more = NULL;
+    memset(med_search_rows, 0, sizeof(med_search_rows));
+}
+
+/**
+ * @brief Product search over the calculator: typed prefix, first matches, keyboard
+ */
+static void med_search_open_event_cb(lv_event_t *e)
+{
+    if (!popup_med_calc || popup_med_search) return;
+
+    popup_med_search = lv_obj_create(popup_med_calc);
+    lv_obj_set_size(popup_med_search, MED_CALC_W, MED_CALC_H);  // Match popup_med_calc size
+    lv_obj_set_pos(popup_med_search, 0, 0);
+    lv_obj_set_style_bg_color(popup_med_search, lv_color_hex(0x1a1a1a), 0);
+    lv_obj_set_style_border_width(popup_med_search, 0, 0);
+    lv_obj_set_style_pad_all(popup_med_search, 0, 0);
+    lv_obj_clear_flag(popup_med_search, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_event_cb(popup_med_search, med_search_delete_cb, LV_EVENT_DELETE, NULL);
+
+    // Child 0: the search text (med_search_refresh reads it)
+    lv_obj_t *input = lv_textarea_create(popup_med_search);
+    lv_obj_set_size(input, 420, 38);
+    lv_obj_set_pos(input, 10, 5);
+    lv_textarea_set_one_line(input, true);
+    lv_textarea_set_placeholder_text(input, "Product name...");
+    lv_obj_add_event_cb(input, med_search_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
+
+    for (int i = 0; i < MED_SEARCH_ROWS; i++) {
+        med_search_rows[i] = lv_btn_create(popup_med_search);
+        lv_obj_set_size(med_search_rows[i], 330, 32);
+        lv_obj_set_pos(med_search_rows[i], 10, 48 + i * 36);
+        lv_obj_add_event_cb(med_search_rows[i], med_search_row_event_cb, LV_EVENT_CLICKED, (void *)(uintptr_t)i);
+        lv_obj_t *lbl = lv_label_create(med_search_rows[i]);
+        lv_label_set_long_mode(lbl, LV_LABEL_LONG_DOT);
+        lv_obj_set_width(lbl, 310);
+        lv_obj_align(lbl, LV_ALIGN_LEFT_MID, 0, 0);
+    }
+    med_search_more = lv_label_create(popup_med_search);
+    lv_obj_add_style(med_search_more, ui_style(UI_STYLE_TEXT), 0);
+    lv_obj_set_pos(med_search_more, 350, 56);
+
+    lv_obj_t *kb = lv_keyboard_create(popup_med_search);
+    lv_obj_set_size(kb, MED_CALC_W, 150);
+    lv_obj_align(kb, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_keyboard_set_mode(kb, LV_KEYBOARD_MODE_TEXT_LOWER);
+    lv_keyboard_set_textarea(kb, input);
+    lv_obj_add_event_cb(kb, med_search_event_cb, LV_EVENT_READY, NULL);
+    lv_obj_add_event_cb(kb, med_search_event_cb, LV_EVENT_CANCEL, NULL);
+
+    med_search_refresh();
+    lv_obj_move_foreground(popup_med_search);
+}
+
+/**
+ * @brief Staged build of the dosage calculator: one input row per step,
+ *        then the buttons (Calculate only exists once every input does)
+ */
+static void med_calc_build_step(uint16_t step, void *user)
+{
+    if (!popup_med_calc) return;
+
+    switch (step) {
+    case 0: {
+        // Row 1: Amount of Product
+        lv_obj_t *amount_label = lv_label_create(popup_med_calc);
+        lv_label_set_text(amount_label, "Amount:");
+        lv_obj_add_style(amount_label, ui_style(UI_STYLE_TEXT), 0);
+        lv_obj_set_pos(amount_label, 20, 45);
+
+        med_product_amount_input = lv_textarea_create(popup_med_calc);
+        lv_obj_set_size(med_product_amount_input, 80, 35);
+        lv_obj_set_pos(med_product_amount_input, 100, 40);
+        lv_textarea_set_one_line(med_product_amount_input, true);
+        lv_textarea_set_text(med_product_amount_input, "5");
+        lv_obj_add_event_cb(med_product_amount_input, med_input_event_cb, LV_EVENT_CLICKED, NULL);
+
+        // Unit dropdown (ml, tsp, tbsp, drops, fl oz, cups, g)
+        med_unit_dropdown = lv_dropdown_create(popup_med_calc);
+        lv_obj_set_size(med_unit_dropdown, 80, 35);
+        lv_obj_set_pos(med_unit_dropdown, 195, 40);
+        lv_dropdown_clear_options(med_unit_dropdown);
+        for (int u = 0; u < MED_UNIT_COUNT; u++) {
+            lv_dropdown_add_option(med_unit_dropdown, med_unit_name((med_unit_t)u), LV_DROPDOWN_POS_LAST);
+        }
+
+        break;
+    }
+
+    case 1: {
+        // Row 2: Per X gallons/litres
+        lv_obj_t *per_label = lv_label_create(popup_med_calc);
+        lv_label_set_text(per_label, "Per:");
+        lv_obj_add_style(per_label, ui_style(UI_STYLE_TEXT), 0);
+        lv_obj_set_pos(per_label, 20, 90);
+
+        med_per_volume_input = lv_textarea_create(popup_med_calc);
+        lv_obj_set_size(med_per_volume_input, 80, 35);
+        lv_obj_set_pos(med_per_volume_input, 100, 85);
+        lv_textarea_set_one_line(med_per_volume_input, true);
+        lv_textarea_set_text(med_per_volume_input, "10");
+        lv_obj_add_event_cb(med_per_volume_input, med_input_event_cb, LV_EVENT_CLICKED, NULL);
+
+        // Unit toggle (L/Gal)
+        lv_obj_t *unit_label_l = lv_label_create(popup_med_calc);
+        lv_label_set_text(unit_label_l, "L");
+        lv_obj_add_style(unit_label_l, ui_style(UI_STYLE_TEXT), 0);
+        lv_obj_set_pos(unit_label_l, 195, 92);
+
+        med_unit_switch = lv_switch_create(popup_med_calc);
+        lv_obj_set_pos(med_unit_switch, 220, 88);
+        lv_obj_add_event_cb(med_unit_switch, med_unit_switch_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
+
+        lv_obj_t *unit_label_g = lv_label_create(popup_med_calc);
+        lv_label_set_text(unit_label_g, "Gal");
+        lv_obj_add_style(unit_label_g, ui_style(UI_STYLE_TEXT), 0);
+        lv_obj_set_pos(unit_label_g, 275, 92);
+
+        break;
+    }
+
+    case 2: {
+        // Row 3: Tank Size with L/Gal toggle
+        lv_obj_t *tank_label = lv_label_create(popup_med_calc);
+        lv_label_set_text(tank_label, "Tank Size:");
+        lv_obj_add_style(tank_label, ui_style(UI_STYLE_TEXT), 0);
+        lv_obj_set_pos(tank_label, 20, 135);
+
+        med_tank_size_input = lv_textarea_create(popup_med_calc);
+        lv_obj_set_size(med_tank_size_input, 80, 35);
+        lv_obj_set_pos(med_tank_size_input, 120, 130);
+        lv_textarea_set_one_line(med_tank_size_input, true);
+        lv_textarea_set_text(med_tank_size_input, "50");
+        lv_obj_add_event_cb(med_tank_size_input, med_input_event_cb, LV_EVENT_CLICKED, NULL);
+
+        // Tank Size Unit toggle (L/Gal)
+        lv_obj_t *tank_unit_label_l = lv_label_create(popup_med_calc);
+        lv_label_set_text(tank_unit_label_l, "L");
+        lv_obj_add_style(tank_unit_label_l, ui_style(UI_STYLE_TEXT), 0);
+        lv_obj_set_pos(tank_unit_label_l, 215, 137);
+
+        med_tank_unit_switch = lv_switch_create(popup_med_calc);
+        lv_obj_set_pos(med_tank_unit_switch, 240, 133);
+        lv_obj_add_event_cb(med_tank_unit_switch, med_tank_unit_switch_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
+
+        lv_obj_t *tank_unit_label_g = lv_label_create(popup_med_calc);
+        lv_label_set_text(tank_unit_label_g, "Gal");
+        lv_obj_add_style(tank_unit_label_g, ui_style(UI_STYLE_TEXT), 0);
+        lv_obj_set_pos(tank_unit_label_g, 295, 137);
+
+        break;
+    }
+
+    default: {
+        // Calculate button
+        lv_obj_t *btn_calc = lv_btn_create(popup_med_calc);
+        lv_obj_set_size(btn_calc, 120, 40);
+        lv_obj_set_pos(btn_calc, 20, 185);
+        lv_obj_set_style_bg_color(btn_calc, lv_color_hex(0x00aa00), 0);
+        lv_obj_add_event_cb(btn_calc, med_calc_calculate_event_cb, LV_EVENT_CLICKED, NULL);
+        lv_obj_t *calc_lbl = lv_label_create(btn_calc);
+        lv_label_set_text(calc_lbl, "Calculate");
+        lv_obj_center(calc_lbl);
+
+        // Close button - moved next to Calculate button
+        lv_obj_t *btn_close = lv_btn_create(popup_med_calc);
+        lv_obj_set_size(btn_close, 80, 40);
+        lv_obj_set_pos(btn_close, 155, 185);
+        lv_obj_set_style_bg_color(btn_close, lv_color_hex(0xff0000), 0);
+        lv_obj_add_event_cb(btn_close, med_calc_close_event_cb, LV_EVENT_CLICKED, NULL);
+        lv_obj_t *close_lbl = lv_label_create(btn_close);
+        lv_label_set_text(close_lbl, "Close");
+        lv_obj_center(close_lbl);
+
+        // Product search fills the dose from the label of a known product
+        lv_obj_t *btn_products = lv_btn_create(popup_med_calc);
+        lv_obj_set_size(btn_products, 110, 40);
+        lv_obj_set_pos(btn_products, 250, 185);
+        lv_obj_add_event_cb(btn_products, med_search_open_event_cb, LV_EVENT_CLICKED, NULL);
+        lv_obj_t *products_lbl = lv_label_create(btn_products);
+        lv_label_set_text(products_lbl, LV_SYMBOL_LIST " Products");
+        lv_obj_center(products_lbl);
+
+        // Result display - positioned below buttons, extends beyond viewport to enable scrolling
+        med_result_label = lv_label_create(popup_med_calc);
+        lv_obj_set_size(med_result_label, 400, 200);
+        lv_obj_set_pos(med_result_label, 20, 240);
+        lv_label_set_long_mode(med_result_label, LV_LABEL_LONG_WRAP);
+        lv_obj_set_style_text_color(med_result_label, lv_color_hex(0x00ff00), 0);
+        lv_label_set_text(med_result_label, "Enter values and click Calculate.");
+
+        ESP_LOGI(TAG, "Universal dosage calculator popup opened on calendar page");
+        break;
+    }
+    }
+}
+
+/**
+ * @brief Popup deleted (Close, or every popup closed): forget its objects
+ */
+static void med_calc_delete_cb(lv_event_t *e)
+{
+    popup_med_calc = NULL;
+    med_product_amount_input = NULL;
+    med_unit_dropdown = NULL;
+    med_per_volume_input = NULL;
+    med_tank_size_input = NULL;
+    med_unit_switch = NULL;
+    med_tank_unit_switch = NULL;
+    med_result_label = NULL;
+}
+
+extern "C" void med_calc_view_init(const med_calc_view_hooks_t *h)
+{
+    hooks = *h;
+}
+
+extern "C" void med_calc_view_open(lv_obj_t *parent)
+{
+    if (popup_med_calc) return;
+    int64_t build_t0 = esp_timer_get_time();
+
+    popup_med_calc = lv_obj_create(parent);
+    ui_obj_track_popup(popup_med_calc, "med calc");
+    ui_arena_scope arena(popup_med_calc);   // The rest of the build: popup arena
+    lv_obj_set_size(popup_med_calc, MED_CALC_W, MED_CALC_H);
+    lv_obj_set_pos(popup_med_calc, 20, 490);  // Y=490 (calendar panel area)
+    lv_obj_set_style_bg_color(popup_med_calc, lv_color_hex(0x1a1a1a), 0);
+    lv_obj_set_style_border_width(popup_med_calc, 3, 0);
+    lv_obj_set_style_border_color(popup_med_calc, lv_palette_main(LV_PALETTE_BLUE), 0);
+    lv_obj_set_style_radius(popup_med_calc, 10, 0);
+    lv_obj_set_scrollbar_mode(popup_med_calc, LV_SCROLLBAR_MODE_AUTO);  // Enable scrollbar
+    lv_obj_set_scroll_dir(popup_med_calc, LV_DIR_VER);  // Vertical scrolling
+    lv_obj_add_event_cb(popup_med_calc, med_calc_delete_cb, LV_EVENT_DELETE, NULL);
+
+    // Title
+    lv_obj_t *title = lv_label_create(popup_med_calc);
+    lv_label_set_text(title, "💊 Universal Dosage Calculator");
+    lv_obj_set_style_text_font(title, ui_font(UI_FONT_16), 0);
+    lv_obj_set_style_text_color(title, lv_palette_main(LV_PALETTE_BLUE), 0);
+    lv_obj_set_pos(title, 10, 8);
+
+    // Input rows and buttons fill in over the next ticks
+    ui_stage_start(&build_stage, "Med calculator", popup_med_calc, 4,
+                   med_calc_build_step, NULL, esp_timer_get_time() - build_t0);
+}
+
+extern "C" void med_calc_view_close(void)
+{
+    if (popup_med_calc) {
+        lv_obj_del(popup_med_calc);   // DELETE handler clears the pointers
+    }
+}
+
+extern "C" bool med_calc_view_is_open(void)
+{
+    return popup_med_calc != NULL;
+}
@@ -0,0 +1,60 @@
+#ifndef __MED_CALC_VIEW_H__
+#define __MED_CALC_VIEW_H__
+
+#include <stdbool.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DOSAGE CALCULATOR - PRODUCT DOSE SCALED TO THE TANK, PRODUCT SEARCH
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// The "Med Calc" popup: a label dose (amount and unit per volume) and the
+// tank size give the total dose in ml and the other units. The product
+// search (med/med_db.h) fills the label dose in; a product whose note has
+// a repeat schedule starts a reminder course (sched/reminders.h).
+//
+// The view owns its inputs and the last calculation, nothing of the
+// tank's: the result goes to the dashboard through the hooks, which keeps
+// it as the AI prompt's context and publishes it (dash_live_t.med_calc).
+// The result shows at once; the hooks, the SD log and the AI update
+// follow on the next ticks (ui/ui_stage.h).
+//
+// LVGL context only.
+
+typedef struct {
+    /** New result: the AI prompt's context and a one-line summary */
+    void (*result)(const char *context, const char *summary);
+    /** After the SD log: ask the AI about the new dose */
+    void (*advise)(void);
+} med_calc_view_hooks_t;
+
+/**
+ * @brief Set the hooks (copied); call before the first open
+ */
+void med_calc_view_init(const med_calc_view_hooks_t *hooks);
+
+/**
+ * @brief Open the calculator in `parent`; the caller closes other popups first
+ */
+void med_calc_view_open(lv_obj_t *parent);
+
+/**
+ * @brief Close the calculator (and its search and keypad); a result still
+ *        being saved is kept
+ */
+void med_calc_view_close(void);
+
+/**
+ * @brief true while the calculator is shown
+ */
+bool med_calc_view_is_open(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
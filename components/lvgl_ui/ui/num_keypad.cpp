@@ -0,0 +1,122 @@
+#include "num_keypad.h"
+#include "ui_fonts.h"
+#include <string.h>
+
+#define KEYPAD_W  300
+#define KEYPAD_H  260
+
+static lv_obj_t *popup_keypad = NULL;      // Dim layer over the host, the keypad on it
+static lv_obj_t *active_input_field = NULL;
+
+/**
+ * @brief Decimal keypad button event callback
+ */
+static void keypad_event_cb(lv_event_t *e) {
+    lv_event_code_t code = lv_event_get_code(e);
+    if (code != LV_EVENT_CLICKED) return;
+
+    lv_obj_t *btn = lv_event_get_target(e);
+    const char *txt = lv_btnmatrix_get_btn_text(btn, lv_btnmatrix_get_selected_btn(btn));
+
+    if (!active_input_field || !txt) return;
+
+    // Get the display textarea from keypad container
+    lv_obj_t *keypad_cont = lv_obj_get_parent(btn);
+    lv_obj_t *display = (lv_obj_t *)lv_obj_get_user_data(keypad_cont);
+
+    if (strcmp(txt, "OK") == 0) {
+        // Copy display value to input field and close
+        if (display) {
+            const char *val = lv_textarea_get_text(display);
+            lv_textarea_set_text(active_input_field, val);
+        }
+        num_keypad_close();
+    } else if (strcmp(txt, "DEL") == 0) {
+        if (display) lv_textarea_del_char(display);
+    } else if (strcmp(txt, "CLR") == 0) {
+        if (display) lv_textarea_set_text(display, "0");
+    } else {
+        // Add digit/decimal to display
+        if (display) {
+            const char *current = lv_textarea_get_text(display);
+            if (strcmp(current, "0") == 0) {
+                // Replace leading zero
+                lv_textarea_set_text(display, txt);
+            } else {
+                lv_textarea_add_text(display, txt);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Keypad deleted, by OK or with its host popup
+ */
+static void keypad_delete_cb(lv_event_t *e)
+{
+    popup_keypad = NULL;
+    active_input_field = NULL;
+}
+
+extern "C" void num_keypad_show(lv_obj_t *field, lv_obj_t *host, lv_coord_t w, lv_coord_t h)
+{
+    if (popup_keypad) return;
+    active_input_field = field;
+
+    // Clear the input field when keypad opens (replace instead of append)
+    lv_textarea_set_text(active_input_field, "");
+
+    popup_keypad = lv_obj_create(host);
+    lv_obj_set_size(popup_keypad, w, h);
+    lv_obj_set_pos(popup_keypad, 0, 0);  // Fill the host's content area
+    lv_obj_set_style_bg_color(popup_keypad, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(popup_keypad, LV_OPA_80, 0);
+    lv_obj_set_style_border_width(popup_keypad, 0, 0);
+    lv_obj_clear_flag(popup_keypad, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_style_pad_all(popup_keypad, 0, 0);  // Remove padding
+    lv_obj_add_event_cb(popup_keypad, keypad_delete_cb, LV_EVENT_DELETE, NULL);
+
+    lv_obj_t *keypad_cont = lv_obj_create(popup_keypad);
+    lv_obj_set_size(keypad_cont, KEYPAD_W, KEYPAD_H);
+    lv_obj_set_pos(keypad_cont, (w - KEYPAD_W) / 2, 20);
+    lv_obj_set_style_bg_color(keypad_cont, lv_color_hex(0x2a2a2a), 0);
+
+    // Add display area at top showing current value
+    lv_obj_t *display = lv_textarea_create(keypad_cont);
+    lv_obj_set_size(display, 280, 40);
+    lv_obj_set_pos(display, 10, 5);
+    lv_textarea_set_text(display, "0");
+    lv_textarea_set_one_line(display, true);
+    lv_obj_set_style_text_font(display, ui_font(UI_FONT_20), 0);
+    lv_obj_set_style_text_align(display, LV_TEXT_ALIGN_RIGHT, 0);
+    lv_obj_clear_flag(display, LV_OBJ_FLAG_CLICKABLE);  // Read-only display
+    lv_obj_set_user_data(keypad_cont, display);  // Store display reference
+
+    static const char *keypad_map[] = {
+        "1", "2", "3", "\n",
+        "4", "5", "6", "\n",
+        "7", "8", "9", "\n",
+        ".", "0", "DEL", "\n",
+        "CLR", "OK", ""
+    };
+
+    lv_obj_t *btnm = lv_btnmatrix_create(keypad_cont);
+    lv_btnmatrix_set_map(btnm, keypad_map);
+    lv_obj_set_size(btnm, 280, 200);
+    lv_obj_set_pos(btnm, 10, 50);
+    lv_obj_add_event_cb(btnm, keypad_event_cb, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_move_foreground(popup_keypad);
+}
+
+extern "C" void num_keypad_close(void)
+{
+    if (popup_keypad) {
+        lv_obj_del(popup_keypad);   // DELETE handler clears the pointers
+    }
+}
+
+extern "C" bool num_keypad_is_open(void)
+{
+    return popup_keypad != NULL;
+}
@@ -0,0 +1,42 @@
+#ifndef __NUM_KEYPAD_H__
+#define __NUM_KEYPAD_H__
+
+#include <stdbool.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// NUMERIC KEYPAD - DECIMAL ENTRY FOR THE POPUPS' TEXT AREAS
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// One keypad at a time, laid over the popup that asked for it (the log
+// popups' panel, the dosage calculator). It edits a display of its own
+// and writes the field only on OK, so a cancelled entry - the host popup
+// closed - leaves the field as it was, emptied. The keypad goes with its
+// host. LVGL context only.
+
+/**
+ * @brief Show the keypad for `field` over `host` (w x h, its content area)
+ *
+ * Empties the field; OK writes the entered number. No-op while open.
+ */
+void num_keypad_show(lv_obj_t *field, lv_obj_t *host, lv_coord_t w, lv_coord_t h);
+
+/**
+ * @brief Close the keypad without writing the field
+ */
+void num_keypad_close(void);
+
+/**
+ * @brief true while the keypad is shown
+ */
+bool num_keypad_is_open(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
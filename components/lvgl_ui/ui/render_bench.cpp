@@ -0,0 +1,358 @@
+#include "render_bench.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "nvs.h"
+#include <string.h>
+
+static const char *TAG = "render_bench";
+
+#ifndef CONFIG_GOLDIE_DISPLAY_DMA_BUFFERS
+#define CONFIG_GOLDIE_DISPLAY_DMA_BUFFERS 0
+#endif
+#ifndef CONFIG_GOLDIE_DISPLAY_DMA_RESERVE_KB
+#define CONFIG_GOLDIE_DISPLAY_DMA_RESERVE_KB 96
+#endif
+#ifndef CONFIG_GOLDIE_DISPLAY_DMA_MAX_LINES
+#define CONFIG_GOLDIE_DISPLAY_DMA_MAX_LINES 40
+#endif
+
+#define RENDER_CFG_NVS_NS       "goldie_render"
+#define RENDER_CFG_NVS_KEY      "cfg"
+#define RENDER_CFG_VERSION      1
+#define RENDER_BENCH_BOOT_MS    5000    // After boot, before the first pass
+#define RENDER_BENCH_PASS_MS    200     // Between candidates
+#define RENDER_BENCH_IDLE_MS    1000    // No touch for this long before a pass
+#define RENDER_BENCH_FLUSH_US   1000000 // Longest wait for the last flush
+
+typedef struct {
+    uint8_t mode;
+    bool internal;
+    uint16_t lines;                     // 0: screen height
+} candidate_t;
+
+static const candidate_t candidates[] = {
+    { RENDER_MODE_PARTIAL, true,  20 },
+    { RENDER_MODE_PARTIAL, true,  40 },
+    { RENDER_MODE_PARTIAL, true,  80 },
+    { RENDER_MODE_PARTIAL, false, 40 },  // 1/8 screen, the original setup
+    { RENDER_MODE_PARTIAL, false, 160 },
+    { RENDER_MODE_FULL,    false, 0 },
+    { RENDER_MODE_DIRECT,  false, 0 },
+};
+#define CANDIDATE_COUNT (sizeof(candidates) / sizeof(candidates[0]))
+
+static lv_disp_t *bench_disp = NULL;
+static render_bench_scene_cb_t bench_scene = NULL;
+static lv_timer_t *bench_timer = NULL;
+static int bench_next = -1;             // Candidate of the next pass, -1: idle
+static uint32_t bench_score[CANDIDATE_COUNT];   // 0: skipped
+
+static void (*direct_inner)(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p) = NULL;
+
+extern "C" const char *render_mode_name(uint8_t mode)
+{
+    switch (mode) {
+    case RENDER_MODE_PARTIAL: return "partial";
+    case RENDER_MODE_FULL:    return "full refresh";
+    case RENDER_MODE_DIRECT:  return "direct";
+    default:                  return "?";
+    }
+}
+
+extern "C" bool render_cfg_load(uint16_t hres, uint16_t vres, render_cfg_t *out)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(RENDER_CFG_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
+    }
+    size_t len = sizeof(*out);
+    esp_err_t err = nvs_get_blob(nvs, RENDER_CFG_NVS_KEY, out, &len);
+    nvs_close(nvs);
+    if (err != ESP_OK) {
+        return false;
+    }
+    if (len != sizeof(*out) || out->version != RENDER_CFG_VERSION || out->mode >= RENDER_MODE_COUNT ||
+        out->hres != hres || out->vres != vres || out->lines == 0 || out->lines > vres) {
+        ESP_LOGW(TAG, "Stored render setup does not match this screen / firmware - using the default");
+        return false;
+    }
+    if (out->mode == RENDER_MODE_DIRECT && CONFIG_GOLDIE_ANIM_DIRECT_BLIT) {
+        ESP_LOGW(TAG, "Stored direct mode conflicts with direct animation blits - using the default");
+        return false;
+    }
+    return true;
+}
+
+static bool render_cfg_save(const render_cfg_t *cfg)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(RENDER_CFG_NVS_NS, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, RENDER_CFG_NVS_KEY, cfg, sizeof(*cfg));
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Saving the render setup failed: %s", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Direct mode: one full-width band over every area of this refresh
+ *
+ * LVGL hands each area over with the whole screen as its area; only the
+ * last one is sent. Its rows are contiguous in the screen-sized buffer.
+ */
+static void direct_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    if (!lv_disp_flush_is_last(drv)) {
+        lv_disp_flush_ready(drv);
+        return;
+    }
+    lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+    lv_coord_t y1 = LV_COORD_MAX;
+    lv_coord_t y2 = -1;
+    for (uint16_t i = 0; disp != NULL && i < disp->inv_p; i++) {
+        if (disp->inv_area_joined[i]) {
+            continue;
+        }
+        if (disp->inv_areas[i].y1 < y1) y1 = disp->inv_areas[i].y1;
+        if (disp->inv_areas[i].y2 > y2) y2 = disp->inv_areas[i].y2;
+    }
+    if (y1 < area->y1) y1 = area->y1;
+    if (y2 > area->y2) y2 = area->y2;
+    if (y2 < y1) {
+        lv_disp_flush_ready(drv);
+        return;
+    }
+    lv_area_t band = { area->x1, y1, area->x2, y2 };
+    direct_inner(drv, &band, color_p + (size_t)(y1 - area->y1) * lv_area_get_width(area));
+}
+
+static void direct_attach(lv_disp_drv_t *drv, bool on)
+{
+    if (on && drv->flush_cb != direct_flush) {
+        direct_inner = drv->flush_cb;
+        drv->flush_cb = direct_flush;
+    } else if (!on && drv->flush_cb == direct_flush) {
+        drv->flush_cb = direct_inner;
+    }
+}
+
+extern "C" void render_cfg_attach(lv_disp_t *disp)
+{
+    if (disp == NULL || disp->driver->flush_cb == NULL || !disp->driver->direct_mode) {
+        return;
+    }
+    direct_attach(disp->driver, true);
+    ESP_LOGI(TAG, "Direct mode: changed rows sent as one band per refresh");
+}
+
+static void wait_flushed(lv_disp_t *disp, int64_t t0)
+{
+    while (disp->driver->draw_buf->flushing && esp_timer_get_time() - t0 < RENDER_BENCH_FLUSH_US) {
+    }
+}
+
+/**
+ * @brief Every scene, full and small redraws
+ * @return Total µs until each last flush was done
+ */
+static uint32_t run_scenes(lv_disp_t *disp)
+{
+    lv_coord_t w = lv_disp_get_hor_res(disp);
+    lv_coord_t h = lv_disp_get_ver_res(disp);
+    lv_area_t small = { (lv_coord_t)((w - RENDER_BENCH_SMALL_W) / 2), (lv_coord_t)((h - RENDER_BENCH_SMALL_H) / 2),
+                        (lv_coord_t)((w + RENDER_BENCH_SMALL_W) / 2 - 1), (lv_coord_t)((h + RENDER_BENCH_SMALL_H) / 2 - 1) };
+    int64_t total = 0;
+    for (int scene = 0; bench_scene(scene); scene++) {
+        lv_refr_now(disp);              // Scroll and layout settle, not timed
+        wait_flushed(disp, esp_timer_get_time());
+        for (int i = 0; i < 2 * RENDER_BENCH_REPS; i++) {
+            int64_t t0 = esp_timer_get_time();
+            if (i < RENDER_BENCH_REPS) {
+                lv_obj_invalidate(lv_scr_act());
+            } else {
+                _lv_inv_area(disp, &small);
+            }
+            lv_refr_now(disp);
+            wait_flushed(disp, t0);
+            total += esp_timer_get_time() - t0;
+        }
+    }
+    bench_scene(RENDER_BENCH_SCENE_END);
+    return (uint32_t)total;
+}
+
+static void *alloc_buf(size_t bytes, bool internal)
+{
+    return internal ? heap_caps_malloc(bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL)
+                    : heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+}
+
+/**
+ * @brief Swap candidate `c` into the driver, time the scenes, swap back
+ * @return Its total time, 0 if it could not be set up
+ */
+static uint32_t bench_candidate(const candidate_t *c)
+{
+    lv_disp_t *disp = bench_disp;
+    lv_disp_drv_t *drv = disp->driver;
+    lv_coord_t w = lv_disp_get_hor_res(disp);
+    lv_coord_t h = lv_disp_get_ver_res(disp);
+    uint16_t lines = c->lines ? c->lines : (uint16_t)h;
+    if (lines > h || (c->mode == RENDER_MODE_DIRECT && CONFIG_GOLDIE_ANIM_DIRECT_BLIT)) {
+        return 0;
+    }
+    if (c->internal) {
+        size_t free_dma = heap_caps_get_free_size(MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        size_t need = 2 * (size_t)lines * w * sizeof(lv_color_t);
+        if (!CONFIG_GOLDIE_DISPLAY_DMA_BUFFERS || lines > CONFIG_GOLDIE_DISPLAY_DMA_MAX_LINES ||
+            free_dma < need + (size_t)CONFIG_GOLDIE_DISPLAY_DMA_RESERVE_KB * 1024) {
+            return 0;
+        }
+    }
+
+    size_t px = (size_t)lines * w;
+    void *buf1 = alloc_buf(px * sizeof(lv_color_t), c->internal);
+    void *buf2 = c->mode == RENDER_MODE_DIRECT ? NULL : alloc_buf(px * sizeof(lv_color_t), c->internal);
+    if (buf1 == NULL || (buf2 == NULL && c->mode != RENDER_MODE_DIRECT)) {
+        heap_caps_free(buf1);
+        heap_caps_free(buf2);
+        return 0;
+    }
+
+    wait_flushed(disp, esp_timer_get_time());
+    lv_disp_draw_buf_t *boot_buf = drv->draw_buf;
+    bool boot_full = drv->full_refresh;
+    bool boot_direct = drv->direct_mode;
+    static lv_disp_draw_buf_t bench_buf;
+    lv_disp_draw_buf_init(&bench_buf, buf1, buf2, (uint32_t)px);
+    drv->draw_buf = &bench_buf;
+    drv->full_refresh = c->mode == RENDER_MODE_FULL;
+    drv->direct_mode = c->mode == RENDER_MODE_DIRECT;
+    direct_attach(drv, drv->direct_mode);
+    lv_disp_drv_update(disp, drv);
+
+    uint32_t score = run_scenes(disp);
+
+    wait_flushed(disp, esp_timer_get_time());
+    direct_attach(drv, boot_direct);
+    drv->draw_buf = boot_buf;
+    drv->full_refresh = boot_full;
+    drv->direct_mode = boot_direct;
+    lv_disp_drv_update(disp, drv);      // Invalidates: the boot setup redraws everything
+    heap_caps_free(buf1);
+    heap_caps_free(buf2);
+    return score;
+}
+
+static void bench_finish(void)
+{
+    lv_disp_t *disp = bench_disp;
+    int best = -1;
+    for (int i = 0; i < (int)CANDIDATE_COUNT; i++) {
+        const candidate_t *c = &candidates[i];
+        if (bench_score[i] == 0) {
+            ESP_LOGI(TAG, "  %-12s %-8s %3u lines: skipped", render_mode_name(c->mode),
+                     c->internal ? "internal" : "psram", c->lines ? c->lines : (unsigned)lv_disp_get_ver_res(disp));
+            continue;
+        }
+        ESP_LOGI(TAG, "  %-12s %-8s %3u lines: %6lu us", render_mode_name(c->mode),
+                 c->internal ? "internal" : "psram", c->lines ? c->lines : (unsigned)lv_disp_get_ver_res(disp),
+                 (unsigned long)bench_score[i]);
+        if (best < 0 || bench_score[i] < bench_score[best]) {
+            best = i;
+        }
+    }
+    bench_next = -1;
+    if (best < 0) {
+        ESP_LOGW(TAG, "No candidate could be set up - keeping the default");
+        return;
+    }
+
+    render_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.version = RENDER_CFG_VERSION;
+    cfg.mode = candidates[best].mode;
+    cfg.internal = candidates[best].internal;
+    cfg.hres = (uint16_t)lv_disp_get_hor_res(disp);
+    cfg.vres = (uint16_t)lv_disp_get_ver_res(disp);
+    cfg.lines = candidates[best].lines ? candidates[best].lines : cfg.vres;
+    cfg.score_us = bench_score[best];
+    if (render_cfg_save(&cfg)) {
+        ESP_LOGI(TAG, "Fastest: %s, %s buffers of %u lines - used from the next boot",
+                 render_mode_name(cfg.mode), cfg.internal ? "internal" : "psram", cfg.lines);
+    }
+}
+
+/**
+ * @brief One candidate per pass, while nobody touches the screen
+ */
+static void bench_timer_cb(lv_timer_t *timer)
+{
+    if (bench_next < 0) {
+        lv_timer_pause(timer);
+        return;
+    }
+    lv_timer_set_period(timer, RENDER_BENCH_PASS_MS);
+    if (lv_disp_get_inactive_time(bench_disp) < RENDER_BENCH_IDLE_MS) {
+        return;
+    }
+    if (bench_next == 0) {
+        ESP_LOGI(TAG, "Render benchmark: %d candidates, %d reps per scene", (int)CANDIDATE_COUNT, RENDER_BENCH_REPS);
+    }
+    bench_score[bench_next] = bench_candidate(&candidates[bench_next]);
+    if (++bench_next == (int)CANDIDATE_COUNT) {
+        bench_finish();
+        lv_timer_pause(timer);
+    }
+}
+
+extern "C" void render_bench_request(void)
+{
+    if (bench_disp == NULL || bench_next >= 0) {
+        return;
+    }
+    if (bench_timer == NULL) {
+        bench_timer = lv_timer_create(bench_timer_cb, RENDER_BENCH_PASS_MS, NULL);
+        if (bench_timer == NULL) {
+            return;
+        }
+    }
+    memset(bench_score, 0, sizeof(bench_score));
+    bench_next = 0;
+    lv_timer_resume(bench_timer);
+}
+
+extern "C" bool render_bench_running(void)
+{
+    return bench_next >= 0;
+}
+
+extern "C" void render_bench_init(lv_disp_t *disp, render_bench_scene_cb_t scene)
+{
+    if (disp == NULL || scene == NULL) {
+        return;
+    }
+    bench_disp = disp;
+    bench_scene = scene;
+
+    render_cfg_t cfg;
+    if (render_cfg_load((uint16_t)lv_disp_get_hor_res(disp), (uint16_t)lv_disp_get_ver_res(disp), &cfg)) {
+        ESP_LOGI(TAG, "Render setup: %s, %s buffers of %u lines (benchmarked %lu us)", render_mode_name(cfg.mode),
+                 cfg.internal ? "internal" : "psram", cfg.lines, (unsigned long)cfg.score_us);
+        return;
+    }
+    if (CONFIG_GOLDIE_RENDER_BENCH) {
+        render_bench_request();
+        if (bench_timer != NULL) {
+            lv_timer_set_period(bench_timer, RENDER_BENCH_BOOT_MS);   // Let boot settle first
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef __RENDER_BENCH_H__
+#define __RENDER_BENCH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// RENDER MODE BENCHMARK - PICK THE DRAW BUFFER SETUP THIS BOARD RENDERS FASTEST
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Each candidate (partial rendering with internal DMA buffers of several
+// heights, partial with PSRAM buffers, full refresh, direct mode) is
+// swapped into the running display driver in turn, one candidate per
+// LVGL timer pass. It renders each dashboard scene (a scroll position the
+// dashboard sets up through the scene callback) RENDER_BENCH_REPS times
+// fully invalidated and RENDER_BENCH_REPS times with one label-sized
+// area invalidated, each timed until the last flush left the SPI bus. The
+// display goes back to its boot setup between passes, so touch and the
+// animation keep running.
+//
+// The candidate with the lowest total time wins, among those whose
+// buffers could be allocated. The winner is stored in NVS and read by
+// lv_port_init() on the next boot: render_cfg_load(). Candidates that need
+// more internal RAM than is free (above CONFIG_GOLDIE_DISPLAY_DMA_RESERVE_KB)
+// are skipped, and at boot a stored internal height that no longer fits
+// falls back to the sized default.
+//
+// The SPI panel has no frame buffer of its own to point LVGL at, so direct
+// mode renders into one full-screen PSRAM buffer and render_cfg_attach()
+// sends one full-width band per refresh, covering every area that changed.
+// Direct animation blits (CONFIG_GOLDIE_ANIM_DIRECT_BLIT) bypass that
+// buffer, so the band would resend stale animation pixels: direct mode is
+// only a candidate without them.
+//
+// With CONFIG_GOLDIE_RENDER_BENCH it runs once, a few seconds after boot,
+// when NVS holds no result for this screen; render_bench_request() (the
+// "render_bench" key of /api/config) runs it again on demand. The screen
+// jumps between the scenes for a few seconds while it runs.
+//
+// render_cfg_load(): any task. The rest: LVGL context.
+
+#ifndef CONFIG_GOLDIE_RENDER_BENCH
+#define CONFIG_GOLDIE_RENDER_BENCH 0
+#endif
+#ifndef CONFIG_GOLDIE_ANIM_DIRECT_BLIT
+#define CONFIG_GOLDIE_ANIM_DIRECT_BLIT 0
+#endif
+
+#define RENDER_BENCH_REPS       4       // Per scene and workload
+#define RENDER_BENCH_SMALL_W    120     // The label-sized update
+#define RENDER_BENCH_SMALL_H    40
+#define RENDER_BENCH_SCENE_END  (-1)    // Scene callback: restore what scene 0 changed
+
+typedef enum {
+    RENDER_MODE_PARTIAL = 0,            // Dirty areas rendered into 2 buffers of `lines` rows
+    RENDER_MODE_FULL,                   // Whole screen rendered and sent every refresh
+    RENDER_MODE_DIRECT,                 // One screen-sized buffer, dirty rows sent
+    RENDER_MODE_COUNT
+} render_mode_t;
+
+typedef struct {
+    uint8_t version;
+    uint8_t mode;                       // render_mode_t
+    uint8_t internal;                   // Buffers in internal DMA RAM, else PSRAM
+    uint8_t reserved;
+    uint16_t hres;                      // Screen it was measured on
+    uint16_t vres;
+    uint16_t lines;                     // Buffer height (full / direct: vres)
+    uint32_t score_us;                  // Its time for the whole scene set
+} render_cfg_t;
+
+/**
+ * @brief Set up scene `scene` (0, 1, ...) for rendering
+ * @return false past the last scene; RENDER_BENCH_SCENE_END restores the view
+ */
+typedef bool (*render_bench_scene_cb_t)(int scene);
+
+/**
+ * @brief The stored winner for a hres x vres screen
+ * @return false if none (or stored for another screen / firmware layout)
+ */
+bool render_cfg_load(uint16_t hres, uint16_t vres, render_cfg_t *out);
+
+const char *render_mode_name(uint8_t mode);
+
+/**
+ * @brief In direct mode, wrap flush_cb to send the changed rows as one band
+ *
+ * After every other flush wrapper (ui_perf, ui_mirror): they see the band.
+ */
+void render_cfg_attach(lv_disp_t *disp);
+
+/**
+ * @brief Register the dashboard's scenes; schedules the boot run if NVS has no result
+ */
+void render_bench_init(lv_disp_t *disp, render_bench_scene_cb_t scene);
+
+/**
+ * @brief Run the benchmark from the next idle LVGL pass
+ */
+void render_bench_request(void);
+
+bool render_bench_running(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,116 @@
+#include "row_list.h"
+
+#define ROW_TEXT_MAX  256
+
+typedef struct {
+    lv_obj_t *spacer;
+    lv_obj_t *rows[ROW_LIST_POOL];
+    int32_t bound[ROW_LIST_POOL];    // Row each label shows, -1 for none
+    uint8_t pool;                    // Labels in use
+    uint32_t count;
+    lv_coord_t row_h;
+    row_list_fill_cb_t fill;
+    void *user;
+} row_list_t;
+
+/**
+ * @brief Bind the labels to the rows in view; untouched if already bound
+ */
+static void row_list_refresh(lv_obj_t *obj, row_list_t *rl)
+{
+    lv_coord_t top = lv_obj_get_scroll_y(obj);
+    uint32_t first = top > 0 ? (uint32_t)(top / rl->row_h) : 0;
+    for (uint32_t row = first; row < first + rl->pool; row++) {
+        uint8_t slot = row % rl->pool;   // A row keeps its label while in view
+        lv_obj_t *label = rl->rows[slot];
+        if (row >= rl->count) {
+            if (rl->bound[slot] >= 0) {
+                lv_obj_add_flag(label, LV_OBJ_FLAG_HIDDEN);
+                rl->bound[slot] = -1;
+            }
+            continue;
+        }
+        if (rl->bound[slot] == (int32_t)row) {
+            continue;
+        }
+        char text[ROW_TEXT_MAX];
+        text[0] = '\0';
+        rl->fill(row, text, sizeof(text), rl->user);
+        lv_label_set_text(label, text);
+        lv_obj_set_y(label, (lv_coord_t)(row * rl->row_h));
+        lv_obj_clear_flag(label, LV_OBJ_FLAG_HIDDEN);
+        rl->bound[slot] = (int32_t)row;
+    }
+}
+
+static void row_list_event_cb(lv_event_t *e)
+{
+    lv_obj_t *obj = lv_event_get_target(e);
+    row_list_t *rl = (row_list_t *)lv_obj_get_user_data(obj);
+    if (rl == NULL) {
+        return;
+    }
+    if (lv_event_get_code(e) == LV_EVENT_DELETE) {
+        lv_obj_set_user_data(obj, NULL);
+        lv_mem_free(rl);
+    } else {
+        row_list_refresh(obj, rl);
+    }
+}
+
+extern "C" lv_obj_t *row_list_create(lv_obj_t *parent, lv_coord_t row_h, row_list_fill_cb_t fill, void *user)
+{
+    row_list_t *rl = (row_list_t *)lv_mem_alloc(sizeof(row_list_t));
+    if (rl == NULL) {
+        return NULL;
+    }
+    lv_memset_00(rl, sizeof(*rl));
+    rl->row_h = row_h > 0 ? row_h : 1;
+    rl->fill = fill;
+    rl->user = user;
+
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_set_user_data(obj, rl);
+    lv_obj_set_scroll_dir(obj, LV_DIR_VER);
+    lv_obj_add_event_cb(obj, row_list_event_cb, LV_EVENT_SCROLL, NULL);
+    lv_obj_add_event_cb(obj, row_list_event_cb, LV_EVENT_DELETE, NULL);
+
+    // Gives the content the height of every row; labels move over it
+    rl->spacer = lv_obj_create(obj);
+    lv_obj_remove_style_all(rl->spacer);
+    lv_obj_clear_flag(rl->spacer, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_size(rl->spacer, 1, 0);
+    return obj;
+}
+
+extern "C" void row_list_set_count(lv_obj_t *list, uint32_t count)
+{
+    row_list_t *rl = (row_list_t *)lv_obj_get_user_data(list);
+    if (rl == NULL) {
+        return;
+    }
+    if (rl->pool == 0) {
+        // Pool sized once the list has its final size
+        lv_obj_update_layout(list);
+        lv_coord_t view = lv_obj_get_content_height(list);
+        uint32_t pool = view / rl->row_h + 2;
+        rl->pool = (uint8_t)(pool < ROW_LIST_POOL ? pool : ROW_LIST_POOL);
+        lv_coord_t w = lv_obj_get_content_width(list);
+        for (uint8_t i = 0; i < rl->pool; i++) {
+            lv_obj_t *label = lv_label_create(list);
+            lv_obj_set_size(label, w, rl->row_h);
+            lv_label_set_long_mode(label, LV_LABEL_LONG_WRAP);
+            lv_obj_add_flag(label, LV_OBJ_FLAG_HIDDEN);
+            rl->rows[i] = label;
+            rl->bound[i] = -1;
+        }
+    }
+    uint32_t max_rows = LV_COORD_MAX / rl->row_h;
+    rl->count = count < max_rows ? count : max_rows;
+    for (uint8_t i = 0; i < rl->pool; i++) {
+        rl->bound[i] = -1;               // Entries may have moved: refill all
+        lv_obj_add_flag(rl->rows[i], LV_OBJ_FLAG_HIDDEN);
+    }
+    lv_obj_set_height(rl->spacer, (lv_coord_t)(rl->count * rl->row_h));
+    row_list_refresh(list, rl);
+}
@@ -0,0 +1,53 @@
+#ifndef __ROW_LIST_H__
+#define __ROW_LIST_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ROW LIST - A SCROLLING TEXT LIST THAT RECYCLES ITS ROWS
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// lv_list_add_text() makes one label per entry, so a long history is
+// hundreds of objects to create, lay out and free. A row list has one
+// fixed-height label per visible row (plus one for the row half scrolled
+// in) whatever the entry count: a spacer gives the container the height
+// of all rows, and on scroll the labels that left the view are moved to
+// the rows that came in and refilled through the fill callback.
+//
+// Rows are cut to row_h (wrapped text beyond it is clipped); callers pick
+// a height that fits their longest entry. The scroll height is an
+// lv_coord_t, so a list shows at most LV_COORD_MAX / row_h rows: put the
+// newest first. The fill callback runs only for
+// rows coming into view, so it may look entries up one at a time.
+//
+// The list frees its state with the object. LVGL context only.
+
+#define ROW_LIST_POOL  16             // Labels at most: visible rows + 1
+
+/**
+ * @brief Write the text of `row` into buf (NUL-terminated)
+ */
+typedef void (*row_list_fill_cb_t)(uint32_t row, char *buf, size_t size, void *user);
+
+/**
+ * @brief Create an empty list; size and place it, then row_list_set_count()
+ */
+lv_obj_t *row_list_create(lv_obj_t *parent, lv_coord_t row_h, row_list_fill_cb_t fill, void *user);
+
+/**
+ * @brief Set the number of rows and refill the visible ones
+ */
+void row_list_set_count(lv_obj_t *list, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,94 @@
+#include "static_layer.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include <string.h>
+
+static const char *TAG = "static_layer";
+
+extern "C" bool static_layer_init(static_layer_t *layer, lv_obj_t *root)
+{
+    memset(layer, 0, sizeof(*layer));
+    if (root == NULL) {
+        return false;
+    }
+
+    lv_obj_update_layout(root);
+    uint32_t size = lv_snapshot_buf_size_needed(root, LV_IMG_CF_TRUE_COLOR);
+    uint8_t *buf = (uint8_t *)heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (buf == NULL) {
+        ESP_LOGW(TAG, "No PSRAM for a %lu-byte snapshot - layer stays live", (unsigned long)size);
+        return false;
+    }
+
+    // The snapshot covers the root plus its extra draw area (shadows)
+    lv_coord_t ext = lv_obj_get_ext_draw_size(root);
+    lv_obj_t *img = lv_img_create(lv_obj_get_parent(root));
+    lv_obj_set_pos(img, lv_obj_get_x(root) - ext, lv_obj_get_y(root) - ext);
+    lv_obj_add_flag(img, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_flag(img, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_move_to_index(img, lv_obj_get_index(root));  // Root is now drawn above it
+
+    layer->root = root;
+    layer->img = img;
+    layer->buf = buf;
+    layer->buf_size = size;
+    ESP_LOGI(TAG, "Static layer ready (%lu KB PSRAM)", (unsigned long)(size / 1024));
+    return true;
+}
+
+extern "C" bool static_layer_rebuild(static_layer_t *layer)
+{
+    if (layer->buf == NULL || layer->cached) {
+        return false;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    layer->valid = true;  // Set first: an invalidate racing the render wins
+    if (lv_snapshot_take_to_buf(layer->root, LV_IMG_CF_TRUE_COLOR, &layer->dsc,
+                                layer->buf, layer->buf_size) != LV_RES_OK) {
+        ESP_LOGW(TAG, "Snapshot failed");
+        layer->valid = false;
+        return false;
+    }
+
+    // Same buffer every time: drop any cached decode, then point at it
+    lv_img_cache_invalidate_src(&layer->dsc);
+    lv_img_set_src(layer->img, &layer->dsc);
+    layer->builds++;
+    ESP_LOGD(TAG, "Snapshot #%lu rendered in %d ms", (unsigned long)layer->builds,
+             (int)((esp_timer_get_time() - t0) / 1000));
+    return true;
+}
+
+extern "C" void static_layer_invalidate(static_layer_t *layer)
+{
+    layer->valid = false;
+}
+
+extern "C" bool static_layer_show_cached(static_layer_t *layer)
+{
+    if (layer->cached) {
+        return true;
+    }
+    if (layer->buf == NULL || !layer->valid) {
+        return false;
+    }
+
+    lv_obj_clear_flag(layer->img, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_set_style_opa(layer->root, LV_OPA_TRANSP, LV_PART_MAIN);  // LVGL skips the subtree
+    layer->cached = true;
+    layer->uses++;
+    return true;
+}
+
+extern "C" void static_layer_show_live(static_layer_t *layer)
+{
+    if (!layer->cached) {
+        return;
+    }
+
+    lv_obj_set_style_opa(layer->root, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_add_flag(layer->img, LV_OBJ_FLAG_HIDDEN);
+    layer->cached = false;
+}
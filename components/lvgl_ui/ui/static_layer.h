@@ -0,0 +1,71 @@
+#ifndef __STATIC_LAYER_H__
+#define __STATIC_LAYER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// STATIC LAYER - PRE-RENDERED SNAPSHOT OF A WIDGET SUBTREE
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Renders a subtree (root + every child, with its shadows, radii and
+// borders) once into a PSRAM image with lv_snapshot and places that image
+// just below the root. In "cached" mode the root is set fully transparent,
+// which makes LVGL skip drawing the whole subtree, and the image is shown
+// instead - one image blit per area rather than dozens of styled objects.
+// The subtree stays in place and clickable in both modes.
+//
+// The snapshot is only valid until the subtree changes: callers mark it
+// stale with static_layer_invalidate() and rebuild it when the UI is idle.
+//
+// LVGL context only, except static_layer_invalidate() (flag only).
+
+typedef struct {
+    lv_obj_t *root;              // Live subtree
+    lv_obj_t *img;               // Snapshot stand-in, sibling just below root
+    lv_img_dsc_t dsc;
+    uint8_t *buf;                // PSRAM pixel buffer
+    uint32_t buf_size;
+    volatile bool valid;         // Snapshot matches the live subtree
+    bool cached;                 // Snapshot on screen, root not drawn
+    uint32_t builds;
+    uint32_t uses;               // Times cached mode was entered
+} static_layer_t;
+
+/**
+ * @brief Allocate the snapshot buffer and create the stand-in image
+ * @return false if PSRAM is short (the layer stays unused, root stays live)
+ */
+bool static_layer_init(static_layer_t *layer, lv_obj_t *root);
+
+/**
+ * @brief Re-render the root subtree into the snapshot (root must be live)
+ */
+bool static_layer_rebuild(static_layer_t *layer);
+
+/**
+ * @brief Mark the snapshot stale after the subtree's content changed
+ */
+void static_layer_invalidate(static_layer_t *layer);
+
+/**
+ * @brief Draw the snapshot instead of the subtree
+ * @return false if there is no valid snapshot (root stays live)
+ */
+bool static_layer_show_cached(static_layer_t *layer);
+
+/**
+ * @brief Draw the live subtree again
+ */
+void static_layer_show_live(static_layer_t *layer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
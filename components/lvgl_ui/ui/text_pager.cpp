@@ -0,0 +1,140 @@
+#include "text_pager.h"
+#include "esp_heap_caps.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t hash_text(const char *s, size_t *len)
+{
+    uint32_t h = 2166136261u;            // FNV-1a
+    size_t n = 0;
+    for (; s[n] != '\0'; n++) {
+        h = (h ^ (uint8_t)s[n]) * 16777619u;
+    }
+    *len = n;
+    return h;
+}
+
+static void show_page(text_pager_t *tp)
+{
+    uint16_t from = tp->page_start[tp->page];
+    uint16_t to = tp->page_start[tp->page + 1];
+    if (to > from && tp->text[to - 1] == '\n') {
+        to--;                            // The break itself starts no line
+    }
+    char saved = tp->text[to];
+    tp->text[to] = '\0';
+    lv_label_set_text(tp->label, tp->text + from);
+    tp->text[to] = saved;
+
+    if (tp->pages > 1) {
+        lv_label_set_text_fmt(tp->indicator, "%u/%u", (unsigned)tp->page + 1, (unsigned)tp->pages);
+        lv_obj_clear_flag(tp->indicator, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(tp->indicator, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+/**
+ * @brief Split the text into pages of as many lines as fit the box
+ */
+static void paginate(text_pager_t *tp)
+{
+    const lv_font_t *font = lv_obj_get_style_text_font(tp->label, LV_PART_MAIN);
+    lv_coord_t letter = lv_obj_get_style_text_letter_space(tp->label, LV_PART_MAIN);
+    lv_coord_t line_h = lv_font_get_line_height(font) + lv_obj_get_style_text_line_space(tp->label, LV_PART_MAIN);
+    int per_page = line_h > 0 ? tp->h / line_h : 1;
+    if (per_page < 1) {
+        per_page = 1;
+    }
+
+    uint32_t pos = 0;
+    int lines = 0;
+    tp->pages = 0;
+    tp->page_start[0] = 0;
+    while (tp->text[pos] != '\0') {
+        if (lines == per_page) {
+            if (tp->pages + 1 == TEXT_PAGER_MAX_PAGES) {
+                break;                   // The rest is not shown
+            }
+            tp->page_start[++tp->pages] = (uint16_t)pos;
+            lines = 0;
+        }
+        uint32_t n = _lv_txt_get_next_line(tp->text + pos, font, letter, tp->w, NULL, LV_TEXT_FLAG_NONE);
+        if (n == 0) {
+            break;
+        }
+        pos += n;
+        lines++;
+    }
+    tp->page_start[++tp->pages] = (uint16_t)pos;
+}
+
+static void next_page_cb(lv_event_t *e)
+{
+    text_pager_t *tp = (text_pager_t *)lv_event_get_user_data(e);
+    if (tp->pages > 1) {
+        tp->page = (uint8_t)((tp->page + 1) % tp->pages);
+        show_page(tp);
+    }
+}
+
+extern "C" bool text_pager_init(text_pager_t *tp, lv_obj_t *parent, lv_coord_t x, lv_coord_t y,
+                                lv_coord_t w, lv_coord_t h, size_t capacity)
+{
+    memset(tp, 0, sizeof(*tp));
+    tp->text = (char *)heap_caps_malloc(capacity, MALLOC_CAP_SPIRAM);
+    if (tp->text == NULL) {
+        tp->text = (char *)heap_caps_malloc(capacity, MALLOC_CAP_DEFAULT);
+    }
+    if (tp->text == NULL || capacity > UINT16_MAX) {
+        return false;
+    }
+    tp->text[0] = '\0';
+    tp->capacity = capacity;
+    tp->w = w;
+    tp->h = h;
+    tp->pages = 1;
+
+    tp->label = lv_label_create(parent);
+    lv_label_set_text_static(tp->label, "");
+    lv_obj_set_size(tp->label, w, h);
+    lv_obj_set_pos(tp->label, x, y);
+    lv_label_set_long_mode(tp->label, LV_LABEL_LONG_WRAP);
+    lv_obj_add_flag(tp->label, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(tp->label, next_page_cb, LV_EVENT_CLICKED, tp);
+
+    tp->indicator = lv_label_create(parent);
+    lv_obj_align_to(tp->indicator, tp->label, LV_ALIGN_OUT_TOP_RIGHT, -10, -4);
+    lv_obj_add_flag(tp->indicator, LV_OBJ_FLAG_HIDDEN);
+    return true;
+}
+
+extern "C" bool text_pager_set(text_pager_t *tp, const char *text, bool keep_page)
+{
+    if (tp->text == NULL) {
+        return false;
+    }
+    size_t len;
+    uint32_t hash = hash_text(text, &len);
+    if (len >= tp->capacity) {
+        len = tp->capacity - 1;
+    }
+    if (hash == tp->hash && len == tp->len && memcmp(text, tp->text, len) == 0) {
+        return false;                    // Same advice again: nothing to lay out
+    }
+    memcpy(tp->text, text, len);
+    tp->text[len] = '\0';
+    tp->hash = hash;
+    tp->len = len;
+
+    uint8_t page = tp->page;
+    paginate(tp);
+    tp->page = (keep_page && page < tp->pages) ? page : 0;
+    show_page(tp);
+    return true;
+}
+
+extern "C" const char *text_pager_text(const text_pager_t *tp)
+{
+    return tp->text != NULL ? tp->text : "";
+}
@@ -0,0 +1,70 @@
+#ifndef __TEXT_PAGER_H__
+#define __TEXT_PAGER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TEXT PAGER - LONG TEXT IN A FIXED BOX, ONE PAGE LAID OUT AT A TIME
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// A wrapped label re-shapes and re-lays out its whole text on every
+// lv_label_set_text(), even when the text did not change and most of it is
+// clipped below the box. The pager keeps the full text itself and gives
+// the label only the lines of the current page:
+//
+//   - text_pager_set() hashes the text first and returns without touching
+//     LVGL when it is the one already shown
+//   - new text is split into pages once (line breaks measured with the
+//     label's font, no label layout) and the label gets one page
+//   - a tap on the text shows the next page; "2/3" in the corner says
+//     where the reader is, hidden for one-page text
+//
+// LVGL context only.
+
+#define TEXT_PAGER_MAX_PAGES  16
+
+typedef struct {
+    lv_obj_t *label;
+    lv_obj_t *indicator;
+    char *text;                  // Full text (PSRAM), capacity bytes
+    size_t capacity;
+    uint32_t hash;
+    size_t len;
+    lv_coord_t w;
+    lv_coord_t h;
+    uint16_t page_start[TEXT_PAGER_MAX_PAGES + 1];
+    uint8_t pages;
+    uint8_t page;
+} text_pager_t;
+
+/**
+ * @brief Create the page label (w x h at x, y) and its indicator in parent
+ * @param capacity Longest text kept, with the NUL; longer text is cut
+ */
+bool text_pager_init(text_pager_t *tp, lv_obj_t *parent, lv_coord_t x, lv_coord_t y,
+                     lv_coord_t w, lv_coord_t h, size_t capacity);
+
+/**
+ * @brief Show text; no LVGL work when it is unchanged
+ * @param keep_page Stay on the current page if it still exists (streamed text)
+ * @return true if the text changed
+ */
+bool text_pager_set(text_pager_t *tp, const char *text, bool keep_page);
+
+/**
+ * @brief Full text currently shown ("" before the first set)
+ */
+const char *text_pager_text(const text_pager_t *tp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
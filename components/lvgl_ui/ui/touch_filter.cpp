@@ -0,0 +1,141 @@
+#include "touch_filter.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <math.h>
+#include <stdlib.h>
+
+static const char *TAG = "touch_filter";
+
+typedef struct {
+    float x;                            // Filtered position
+    float dx;                           // Filtered speed, px/s
+} euro_axis_t;
+
+// LVGL task only
+static void (*prev_read)(lv_indev_drv_t *drv, lv_indev_data_t *data) = NULL;
+static bool down = false;
+static int64_t last_us = 0;             // Time of the last accepted sample
+static euro_axis_t ax, ay;
+static lv_point_t last_raw;             // Last accepted raw point
+static lv_point_t last_out;             // Last point given to LVGL
+static lv_point_t suspect;              // Jump waiting for the next sample
+static bool has_suspect = false;
+static uint8_t accepted = 0;            // Samples in this stroke (saturates)
+
+static inline float smoothing(float cutoff_hz, float dt)
+{
+    float tau = 1.0f / (2.0f * (float)M_PI * cutoff_hz);
+    return 1.0f / (1.0f + tau / dt);
+}
+
+static void euro_step(euro_axis_t *a, float raw, float dt)
+{
+    float dx = (raw - a->x) / dt;
+    a->dx += smoothing(TOUCH_FILTER_DCUTOFF_HZ, dt) * (dx - a->dx);
+    float cutoff = TOUCH_FILTER_MIN_CUTOFF_HZ + TOUCH_FILTER_BETA * fabsf(a->dx);
+    a->x += smoothing(cutoff, dt) * (raw - a->x);
+}
+
+static lv_coord_t predicted(const euro_axis_t *a, lv_coord_t max)
+{
+    float x = a->x;
+    if (accepted >= 3) {                // Speed estimate has settled
+        float ahead = a->dx * (CONFIG_GOLDIE_TOUCH_PREDICT_MS / 1000.0f);
+        if (ahead > TOUCH_FILTER_PREDICT_MAX_PX) {
+            ahead = TOUCH_FILTER_PREDICT_MAX_PX;
+        } else if (ahead < -TOUCH_FILTER_PREDICT_MAX_PX) {
+            ahead = -TOUCH_FILTER_PREDICT_MAX_PX;
+        }
+        x += ahead;
+    }
+    lv_coord_t c = (lv_coord_t)lroundf(x);
+    return c < 0 ? 0 : (c > max ? max : c);
+}
+
+static bool is_jump(const lv_point_t *a, const lv_point_t *b)
+{
+    return abs(a->x - b->x) > TOUCH_FILTER_JUMP_PX || abs(a->y - b->y) > TOUCH_FILTER_JUMP_PX;
+}
+
+static void stroke_start(const lv_point_t *p, int64_t now)
+{
+    ax = (euro_axis_t){(float)p->x, 0.0f};
+    ay = (euro_axis_t){(float)p->y, 0.0f};
+    last_raw = *p;
+    last_out = *p;
+    last_us = now;
+    has_suspect = false;
+    accepted = 1;
+}
+
+static void filter_touch_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
+{
+    prev_read(drv, data);
+    if (data->state != LV_INDEV_STATE_PRESSED) {
+        if (down) {
+            data->point = last_out;     // No jump on release: the throw is what LVGL last saw
+            down = false;
+        }
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+    lv_point_t raw = data->point;
+    if (!down) {
+        down = true;
+        stroke_start(&raw, now);        // Taps land on the raw point
+        return;
+    }
+
+    if (has_suspect) {
+        has_suspect = false;
+        if (!is_jump(&raw, &suspect)) {
+            stroke_start(&raw, now);    // Confirmed: the finger is over there now
+            data->point = raw;
+            return;
+        }
+        // Otherwise the jump was a glitch; raw is checked against the track
+    }
+    if (is_jump(&raw, &last_raw)) {
+        suspect = raw;
+        has_suspect = true;
+        data->point = last_out;
+        return;
+    }
+
+    float dt = (float)(now - last_us) / 1e6f;
+    if (dt < 0.001f) {
+        dt = 0.001f;
+    }
+    euro_step(&ax, (float)raw.x, dt);
+    euro_step(&ay, (float)raw.y, dt);
+    last_raw = raw;
+    last_us = now;
+    if (accepted < UINT8_MAX) {
+        accepted++;
+    }
+
+    lv_point_t out;
+    out.x = predicted(&ax, lv_disp_get_hor_res(drv->disp) - 1);
+    out.y = predicted(&ay, lv_disp_get_ver_res(drv->disp) - 1);
+    if (fabsf(ax.dx) < TOUCH_FILTER_STILL_PX_S && fabsf(ay.dx) < TOUCH_FILTER_STILL_PX_S &&
+        abs(out.x - last_out.x) <= 1 && abs(out.y - last_out.y) <= 1) {
+        out = last_out;                 // Resting finger: no scroll, no refresh
+    }
+    data->point = out;
+    last_out = out;
+}
+
+extern "C" void touch_filter_init(lv_indev_t *indev)
+{
+    if (!CONFIG_GOLDIE_TOUCH_FILTER || prev_read != NULL) {
+        return;
+    }
+    if (indev == NULL) {
+        ESP_LOGW(TAG, "No touch input - filter off");
+        return;
+    }
+    prev_read = indev->driver->read_cb;
+    indev->driver->read_cb = filter_touch_read;
+    ESP_LOGI(TAG, "Touch filter on, %d ms prediction", CONFIG_GOLDIE_TOUCH_PREDICT_MS);
+}
@@ -0,0 +1,71 @@
+#ifndef __TOUCH_FILTER_H__
+#define __TOUCH_FILTER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TOUCH FILTER - OUTLIER REJECTION, ONE-EURO SMOOTHING, SHORT PREDICTION
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// The FT6336 is read at LVGL's indev period (CONFIG_LV_INDEV_DEF_READ_PERIOD)
+// and its raw points jitter by a pixel or two at rest and now and then jump
+// far off for one sample. Each of those moves the scroll container and
+// costs a refresh. The touch indev's read_cb is wrapped (chained to the one
+// installed before, power_idle's included) and every pressed point goes
+// through three stages:
+//
+//   outlier    a sample more than TOUCH_FILTER_JUMP_PX from the last one is
+//              held back; the next sample decides - back near the track, it
+//              was a glitch and is dropped; near the jump, the finger really
+//              moved (or a second finger took over) and the stroke restarts
+//              there
+//   one-euro   per-axis low-pass whose cutoff rises with speed: heavy
+//              smoothing while the finger rests or creeps, almost none
+//              during a fast drag, so jitter is gone without drag lag
+//              (Casiez et al., CHI 2012)
+//   predict    the filtered position is pushed ahead by its own velocity
+//              times CONFIG_GOLDIE_TOUCH_PREDICT_MS (at most
+//              TOUCH_FILTER_PREDICT_MAX_PX), which makes up for the read
+//              period and the render behind it
+//
+// While the finger is nearly still, moves of one pixel are not reported at
+// all. A press starts on the raw point (taps and clicks land where they
+// should, with no smoothing lag) and the release reports the last point
+// given to LVGL, so the throw of a fling is the filtered velocity.
+//
+// Without CONFIG_GOLDIE_TOUCH_FILTER nothing is hooked. LVGL context only.
+
+#ifndef CONFIG_GOLDIE_TOUCH_FILTER
+#define CONFIG_GOLDIE_TOUCH_FILTER 0
+#endif
+#ifndef CONFIG_GOLDIE_TOUCH_PREDICT_MS
+#define CONFIG_GOLDIE_TOUCH_PREDICT_MS 16
+#endif
+
+#define TOUCH_FILTER_MIN_CUTOFF_HZ   1.0f    // Cutoff at rest
+#define TOUCH_FILTER_BETA            0.007f  // Cutoff added per px/s of speed
+#define TOUCH_FILTER_DCUTOFF_HZ      1.0f    // Cutoff of the speed estimate
+#define TOUCH_FILTER_JUMP_PX         96      // One-sample move taken as an outlier
+#define TOUCH_FILTER_PREDICT_MAX_PX  24
+#define TOUCH_FILTER_STILL_PX_S      60.0f   // Below this, 1 px moves are held
+
+/**
+ * @brief Wrap the touch indev's read_cb (LVGL lock held; no-op if disabled)
+ *
+ * Install after anything else that wraps the same read_cb, so this sees
+ * what they decided (e.g. power_idle swallowing the waking touch).
+ */
+void touch_filter_init(lv_indev_t *indev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
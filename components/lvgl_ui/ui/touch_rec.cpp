@@ -0,0 +1,83 @@
+#include "touch_rec.h"
+#include "input_rec.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include <string.h>
+
+static const char *TAG = "touch_rec";
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    bool pressed;
+} touch_sample_t;
+
+// LVGL task only
+static void (*prev_read)(lv_indev_drv_t *drv, lv_indev_data_t *data) = NULL;
+static touch_sample_t last = {};
+static QueueHandle_t replayed = NULL;   // touch_sample_t, filled by the replayer
+
+static void rec_touch_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
+{
+    prev_read(drv, data);
+    if (input_rec_replaying(INPUT_REC_TOUCH)) {
+        touch_sample_t s;
+        if (xQueueReceive(replayed, &s, 0) == pdTRUE) {
+            last = s;
+        }
+        data->point.x = last.x;
+        data->point.y = last.y;
+        data->state = last.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+        data->continue_reading = false;
+        return;
+    }
+
+    bool pressed = data->state == LV_INDEV_STATE_PRESSED;
+    if (pressed == last.pressed && (!pressed || (data->point.x == last.x && data->point.y == last.y))) {
+        return;
+    }
+    last.x = (int16_t)data->point.x;
+    last.y = (int16_t)data->point.y;
+    last.pressed = pressed;
+    const int16_t xy[2] = {last.x, last.y};
+    input_rec_put(INPUT_REC_TOUCH, pressed ? 1 : 0, xy, sizeof(xy));
+}
+
+/**
+ * @brief Replayer: queue one recorded sample for the next read
+ */
+static void touch_replay_sink(uint8_t pressed, const uint8_t *data, size_t len)
+{
+    touch_sample_t s;
+    int16_t xy[2];
+    if (len != sizeof(xy)) {
+        return;
+    }
+    memcpy(xy, data, sizeof(xy));
+    s.x = xy[0];
+    s.y = xy[1];
+    s.pressed = pressed != 0;
+    if (xQueueSend(replayed, &s, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "Replayed touch dropped - LVGL is not reading");
+    }
+}
+
+extern "C" void touch_rec_init(lv_indev_t *indev)
+{
+    if (!CONFIG_GOLDIE_INPUT_REC || prev_read != NULL) {
+        return;
+    }
+    if (indev == NULL) {
+        ESP_LOGW(TAG, "No touch input - touches not recorded");
+        return;
+    }
+    replayed = xQueueCreate(TOUCH_REC_QUEUE, sizeof(touch_sample_t));
+    if (replayed == NULL) {
+        ESP_LOGE(TAG, "No replay queue - touches not recorded");
+        return;
+    }
+    prev_read = indev->driver->read_cb;
+    indev->driver->read_cb = rec_touch_read;
+    input_rec_set_sink(INPUT_REC_TOUCH, touch_replay_sink);
+}
@@ -0,0 +1,42 @@
+#ifndef __TOUCH_REC_H__
+#define __TOUCH_REC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TOUCH RECORDING - TOUCH SAMPLES FOR THE INPUT RECORDER
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Wraps the touch indev's read_cb (chained like touch_filter.h) for the
+// input recorder (input_rec.h). Recording, each read that changes the
+// pressed state or the point is stored as INPUT_REC_TOUCH; a finger at
+// rest and an idle panel cost nothing. Replaying, the panel is still read
+// (power_idle keeps seeing real touches) but LVGL gets the recorded
+// samples instead, one per read in recorded order, holding the last one
+// between them.
+//
+// Install after power_idle and before touch_filter_init(): the recording
+// holds what the filter gets, so a replay runs the filter again.
+//
+// Without CONFIG_GOLDIE_INPUT_REC nothing is hooked. LVGL context only
+// (the replay sink queues samples from the replayer).
+
+#define TOUCH_REC_QUEUE  32             // Replayed samples waiting for a read
+
+/**
+ * @brief Wrap the touch indev's read_cb and register the replay sink
+ *        (LVGL lock held; no-op without an indev)
+ */
+void touch_rec_init(lv_indev_t *indev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
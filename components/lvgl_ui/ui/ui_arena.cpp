@@ -0,0 +1,235 @@
+#include "ui_arena.h"
+#include "ui_heap.h"
+#include "lvgl.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include <stdint.h>
+#include <string.h>
+
+static const char *TAG = "ui_arena";
+
+#define POOL_BLOCKS_MAX  64             // Kconfig range: 1024 KB
+#define HDR_SIZE         8              // Allocation size, keeps 8-byte alignment
+#define NO_BLOCK         -1
+
+struct ui_arena {
+    struct _lv_obj_t *root;             // NULL: free slot
+    int8_t head;                        // Block chain, allocation goes to tail
+    int8_t tail;
+    uint8_t blocks;
+    bool releasing;                     // Root deleted, blocks go back next pass
+    uint32_t used;                      // Bytes in the tail block
+    uint32_t bytes;                     // Requested bytes, for the log
+};
+
+// LVGL lock holder only
+static uint8_t *pool = NULL;
+static uint8_t pool_blocks = 0;
+static int8_t next_block[POOL_BLOCKS_MAX];
+static int8_t block_owner[POOL_BLOCKS_MAX];   // Index into arenas[]
+static int8_t free_head = NO_BLOCK;
+static ui_arena_t arenas[UI_ARENA_MAX];
+static ui_arena_t *scope_stack[UI_ARENA_MAX + 2];   // NULL entries: heap
+static uint8_t scope_depth = 0;
+
+static inline bool in_pool(const void *p)
+{
+    return pool != NULL && (const uint8_t *)p >= pool &&
+           (const uint8_t *)p < pool + (size_t)pool_blocks * UI_ARENA_BLOCK_SIZE;
+}
+
+static inline ui_arena_t *current(void)
+{
+    if (scope_depth == 0 || scope_depth > sizeof(scope_stack) / sizeof(scope_stack[0])) {
+        return NULL;
+    }
+    ui_arena_t *arena = scope_stack[scope_depth - 1];
+    return (arena != NULL && !arena->releasing) ? arena : NULL;   // Root deleted inside the scope
+}
+
+static void push(ui_arena_t *arena)
+{
+    if (scope_depth < sizeof(scope_stack) / sizeof(scope_stack[0])) {
+        scope_stack[scope_depth] = arena;
+    }
+    scope_depth++;                      // Too deep: counted, allocations use the heap
+}
+
+static void pop(void)
+{
+    if (scope_depth > 0) {
+        scope_depth--;
+    }
+}
+
+static void *arena_alloc(ui_arena_t *arena, size_t size)
+{
+    size_t need = HDR_SIZE + ((size + 7) & ~(size_t)7);
+    if (need > UI_ARENA_BLOCK_SIZE) {
+        return NULL;
+    }
+    if (arena->tail == NO_BLOCK || arena->used + need > UI_ARENA_BLOCK_SIZE) {
+        if (free_head == NO_BLOCK) {
+            return NULL;
+        }
+        int8_t b = free_head;
+        free_head = next_block[b];
+        next_block[b] = NO_BLOCK;
+        block_owner[b] = (int8_t)(arena - arenas);
+        if (arena->tail == NO_BLOCK) {
+            arena->head = b;
+        } else {
+            next_block[arena->tail] = b;
+        }
+        arena->tail = b;
+        arena->used = 0;
+        arena->blocks++;
+    }
+    uint8_t *p = pool + (size_t)arena->tail * UI_ARENA_BLOCK_SIZE + arena->used;
+    *(uint32_t *)p = (uint32_t)size;
+    arena->used += need;
+    arena->bytes += size;
+    return p + HDR_SIZE;
+}
+
+static void arena_release(void *user)
+{
+    ui_arena_t *arena = (ui_arena_t *)user;
+    ESP_LOGD(TAG, "Released %lu bytes in %u blocks", (unsigned long)arena->bytes, arena->blocks);
+    if (arena->head != NO_BLOCK) {
+        next_block[arena->tail] = free_head;    // Whole chain back in one step
+        free_head = arena->head;
+    }
+    memset(arena, 0, sizeof(*arena));
+    arena->head = arena->tail = NO_BLOCK;
+}
+
+static void root_deleted_cb(lv_event_t *e)
+{
+    ui_arena_t *arena = (ui_arena_t *)lv_event_get_user_data(e);
+    if (arena->root != lv_event_get_target(e) || arena->releasing) {
+        return;
+    }
+    // The children are deleted after this event; their memory stays valid
+    // until the release runs on the next pass
+    arena->releasing = true;
+    push(NULL);
+    bool queued = lv_async_call(arena_release, arena) == LV_RES_OK;
+    pop();
+    if (!queued) {
+        ESP_LOGE(TAG, "Cannot queue release - %u blocks lost", arena->blocks);
+    }
+}
+
+extern "C" void ui_arena_init(void)
+{
+    if (pool != NULL || CONFIG_GOLDIE_UI_ARENA_KB == 0) {
+        return;
+    }
+    size_t blocks = (size_t)CONFIG_GOLDIE_UI_ARENA_KB * 1024 / UI_ARENA_BLOCK_SIZE;
+    if (blocks > POOL_BLOCKS_MAX) {
+        blocks = POOL_BLOCKS_MAX;
+    }
+    pool = (uint8_t *)heap_caps_malloc(blocks * UI_ARENA_BLOCK_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (pool == NULL) {
+        ESP_LOGW(TAG, "No PSRAM for popup arenas - popups allocate from the heap");
+        return;
+    }
+    pool_blocks = (uint8_t)blocks;
+    for (uint8_t b = 0; b < pool_blocks; b++) {
+        next_block[b] = (b + 1 < pool_blocks) ? (int8_t)(b + 1) : NO_BLOCK;
+    }
+    free_head = 0;
+    for (ui_arena_t &a : arenas) {
+        a.head = a.tail = NO_BLOCK;
+    }
+    ESP_LOGI(TAG, "Popup arenas: %u KB PSRAM in %u blocks", (unsigned)(blocks * UI_ARENA_BLOCK_SIZE / 1024),
+             pool_blocks);
+}
+
+extern "C" ui_arena_t *ui_arena_begin(struct _lv_obj_t *root)
+{
+    ui_arena_t *arena = NULL;
+    if (pool != NULL && root != NULL) {
+        arena = ui_arena_of(root);
+        for (ui_arena_t &a : arenas) {
+            if (arena == NULL && a.root == NULL && !a.releasing) {
+                arena = &a;
+                arena->root = root;
+                lv_obj_add_event_cb(root, root_deleted_cb, LV_EVENT_DELETE, arena);
+            }
+        }
+        if (arena == NULL) {
+            ESP_LOGW(TAG, "All %d arenas in use - popup on the heap", UI_ARENA_MAX);
+        }
+    }
+    push(arena);
+    return arena;
+}
+
+extern "C" void ui_arena_end(ui_arena_t *arena)
+{
+    (void)arena;
+    pop();
+}
+
+extern "C" ui_arena_t *ui_arena_of(const struct _lv_obj_t *root)
+{
+    if (root == NULL) {
+        return NULL;
+    }
+    for (ui_arena_t &a : arenas) {
+        if (a.root == root && !a.releasing) {
+            return &a;
+        }
+    }
+    return NULL;
+}
+
+extern "C" void ui_arena_resume(ui_arena_t *arena)
+{
+    push(arena != NULL && arena->root != NULL && !arena->releasing ? arena : NULL);
+}
+
+extern "C" void *ui_arena_lv_alloc(size_t size)
+{
+    ui_arena_t *arena = current();
+    if (arena != NULL) {
+        void *p = arena_alloc(arena, size);
+        if (p != NULL) {
+            return p;
+        }
+    }
+    return ui_heap_alloc(size);
+}
+
+extern "C" void ui_arena_lv_free(void *p)
+{
+    if (!in_pool(p)) {
+        ui_heap_free(p);
+    }
+}
+
+extern "C" void *ui_arena_lv_realloc(void *p, size_t size)
+{
+    if (p == NULL) {
+        return ui_arena_lv_alloc(size);
+    }
+    if (!in_pool(p)) {
+        return ui_heap_realloc(p, size);
+    }
+    uint32_t old_size = *(const uint32_t *)((const uint8_t *)p - HDR_SIZE);
+    if (size <= old_size) {
+        return p;
+    }
+    size_t block = (size_t)((const uint8_t *)p - pool) / UI_ARENA_BLOCK_SIZE;
+    void *q = arena_alloc(&arenas[block_owner[block]], size);
+    if (q == NULL) {
+        q = ui_heap_alloc(size);
+        if (q == NULL) {
+            return NULL;
+        }
+    }
+    memcpy(q, p, old_size);
+    return q;
+}
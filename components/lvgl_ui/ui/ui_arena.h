@@ -0,0 +1,108 @@
+#ifndef __UI_ARENA_H__
+#define __UI_ARENA_H__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// POPUP ARENAS - ONE PSRAM BUMP ALLOCATOR PER POPUP, FREED AS A WHOLE
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// LVGL allocates through the hooks below (LV_MEM_CUSTOM, wired up in the
+// project CMakeLists.txt). Outside an arena scope they go to the LVGL
+// heap's size-class pools (ui_heap.h). A popup builder opens a scope
+// right after creating the popup's root object:
+//
+//   popup_history = lv_obj_create(panel_content);
+//   ui_arena_scope arena(popup_history);
+//   ... children, labels, styles local to them ...
+//
+// and everything LVGL allocates until the scope ends (objects, their style
+// and event arrays, label text) is bumped from UI_ARENA_BLOCK_SIZE blocks
+// of one PSRAM pool. free() of such a pointer does nothing; realloc() to a
+// larger size bumps a new copy in the same arena. Build steps a ui_stage
+// runs for the root (ui_stage.h) are inside the arena too. When the root is
+// deleted, by whatever path, its blocks go back to the pool in one step on
+// the next LVGL pass; repeated open / close never touches the general
+// heap's free lists.
+//
+// The scope covers construction only, so nothing inside it may allocate
+// what outlives the popup: no shared lv_style_t set up lazily, no timers or
+// animations on other objects, no lv_refr_now(). realloc() of a pointer
+// keeps it where it was, so growing a heap array (the parent's child list,
+// an outside label's text) stays on the heap. An allocation the arena
+// cannot take (pool used up, bigger than a block) falls back to the LVGL
+// heap and is freed normally.
+//
+// With CONFIG_GOLDIE_UI_ARENA_KB 0, or without PSRAM, scopes do nothing.
+// LVGL context only (the hooks: any task holding the LVGL lock).
+
+#ifndef CONFIG_GOLDIE_UI_ARENA_KB
+#define CONFIG_GOLDIE_UI_ARENA_KB 256
+#endif
+
+#define UI_ARENA_BLOCK_SIZE  (16 * 1024)
+#define UI_ARENA_MAX         4          // Open popup, nested ones, ones awaiting release
+
+// This header is also LVGL's LV_MEM_CUSTOM_INCLUDE, so it does not pull
+// in lvgl.h; the root is a struct _lv_obj_t (lv_obj_t).
+struct _lv_obj_t;
+typedef struct ui_arena ui_arena_t;
+
+/**
+ * @brief Reserve the PSRAM pool (LVGL context, before the first popup)
+ */
+void ui_arena_init(void);
+
+/**
+ * @brief Start an arena for a popup root and make it current
+ *
+ * The root itself must already exist (it is on the heap, so its parent's
+ * child list is too). Scopes nest; the innermost is current.
+ * @return NULL when no arena is free (allocations stay on the heap)
+ */
+ui_arena_t *ui_arena_begin(struct _lv_obj_t *root);
+
+/**
+ * @brief End the current scope (the arena lives on until root is deleted)
+ */
+void ui_arena_end(ui_arena_t *arena);
+
+/**
+ * @brief The arena bound to root, NULL if none
+ */
+ui_arena_t *ui_arena_of(const struct _lv_obj_t *root);
+
+/**
+ * @brief Make an existing arena current again (ui_stage steps)
+ */
+void ui_arena_resume(ui_arena_t *arena);
+
+// LV_MEM_CUSTOM_ALLOC / _FREE / _REALLOC
+void *ui_arena_lv_alloc(size_t size);
+void ui_arena_lv_free(void *p);
+void *ui_arena_lv_realloc(void *p, size_t size);
+
+#ifdef __cplusplus
+}
+
+/**
+ * @brief ui_arena_begin() .. ui_arena_end() over a C++ block
+ */
+class ui_arena_scope {
+public:
+    explicit ui_arena_scope(struct _lv_obj_t *root) : arena_(ui_arena_begin(root)) {}
+    ~ui_arena_scope() { ui_arena_end(arena_); }
+    ui_arena_scope(const ui_arena_scope &) = delete;
+    ui_arena_scope &operator=(const ui_arena_scope &) = delete;
+
+private:
+    ui_arena_t *arena_;
+};
+#endif
+
+#endif
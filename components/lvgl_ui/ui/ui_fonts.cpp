@@ -0,0 +1,156 @@
+#include "ui_fonts.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+
+static const char *TAG = "ui_fonts";
+
+#ifndef CONFIG_GOLDIE_UI_GLYPH_CACHE_KB
+#define CONFIG_GOLDIE_UI_GLYPH_CACHE_KB 64
+#endif
+
+#define GLYPH_SLOTS      1024   // Hash slots (power of two) shared by all fonts
+#define GLYPH_EMPTY      0
+
+#if CONFIG_GOLDIE_UI_SUBSET_FONTS
+// Generated by tools/subset_fonts.py
+LV_FONT_DECLARE(goldie_montserrat_12);
+LV_FONT_DECLARE(goldie_montserrat_14);
+LV_FONT_DECLARE(goldie_montserrat_16);
+LV_FONT_DECLARE(goldie_montserrat_20);
+LV_FONT_DECLARE(goldie_montserrat_32);
+static const lv_font_t *const base_fonts[UI_FONT_COUNT] = {
+    &goldie_montserrat_12, &goldie_montserrat_14, &goldie_montserrat_16,
+    &goldie_montserrat_20, &goldie_montserrat_32,
+};
+#else
+static const lv_font_t *const base_fonts[UI_FONT_COUNT] = {
+    &lv_font_montserrat_12, &lv_font_montserrat_14, &lv_font_montserrat_16,
+    &lv_font_montserrat_20, &lv_font_montserrat_32,
+};
+#endif
+
+static const lv_font_t *fonts[UI_FONT_COUNT];
+
+#if CONFIG_GOLDIE_UI_GLYPH_CACHE
+typedef struct {
+    uint32_t key;                // (font id + 1) << 24 | code point, 0 = empty
+    const uint8_t *bitmap;
+} glyph_slot_t;
+
+static lv_font_t cached_fonts[UI_FONT_COUNT];  // Copies of base_fonts with our bitmap hook
+static glyph_slot_t *glyph_slots = NULL;
+static uint8_t *glyph_arena = NULL;
+static size_t arena_size = 0;
+static size_t arena_used = 0;
+static uint32_t glyph_hits = 0;
+static uint32_t glyph_misses = 0;
+static uint32_t glyph_uncached = 0;             // Misses that found the arena full
+static uint32_t glyph_count = 0;                // Occupied slots
+
+static const uint8_t *cached_glyph_bitmap(const lv_font_t *font, uint32_t letter)
+{
+    ui_font_id_t id = (ui_font_id_t)(uintptr_t)font->user_data;
+    const lv_font_t *base = base_fonts[id];
+    uint32_t key = ((uint32_t)(id + 1) << 24) | (letter & 0xFFFFFF);
+
+    uint32_t h = (letter * 2654435761u + id) & (GLYPH_SLOTS - 1);
+    while (glyph_slots[h].key != GLYPH_EMPTY) {
+        if (glyph_slots[h].key == key) {
+            glyph_hits++;
+            return glyph_slots[h].bitmap;
+        }
+        h = (h + 1) & (GLYPH_SLOTS - 1);
+    }
+
+    glyph_misses++;
+    const uint8_t *src = base->get_glyph_bitmap(base, letter);
+    lv_font_glyph_dsc_t g;
+    if (src == NULL || !base->get_glyph_dsc(base, &g, letter, 0)) {
+        return src;
+    }
+
+    // Plain fmt_txt bitmaps are packed without row padding
+    size_t size = ((size_t)g.box_w * g.box_h * g.bpp + 7) / 8;
+    if (size == 0 || arena_used + size > arena_size || glyph_count >= GLYPH_SLOTS * 3 / 4) {
+        glyph_uncached++;
+        return src;  // Arena or table full: serve from flash
+    }
+
+    uint8_t *copy = glyph_arena + arena_used;
+    memcpy(copy, src, size);
+    arena_used += size;
+    glyph_slots[h].key = key;
+    glyph_slots[h].bitmap = copy;
+    glyph_count++;
+    return copy;
+}
+
+static bool cacheable(const lv_font_t *base)
+{
+    // Only plain (uncompressed) bitmaps: a compressed font returns a shared
+    // decompression buffer whose layout differs
+    if (base->get_glyph_bitmap != lv_font_get_bitmap_fmt_txt) {
+        return false;
+    }
+    const lv_font_fmt_txt_dsc_t *dsc = (const lv_font_fmt_txt_dsc_t *)base->dsc;
+    return dsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN;
+}
+#endif
+
+extern "C" void ui_fonts_init(void)
+{
+    for (int i = 0; i < UI_FONT_COUNT; i++) {
+        fonts[i] = base_fonts[i];
+    }
+
+#if CONFIG_GOLDIE_UI_GLYPH_CACHE
+    arena_size = (size_t)CONFIG_GOLDIE_UI_GLYPH_CACHE_KB * 1024;
+    glyph_slots = (glyph_slot_t *)heap_caps_calloc(GLYPH_SLOTS, sizeof(glyph_slot_t),
+                                                   MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    glyph_arena = (uint8_t *)heap_caps_malloc(arena_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (glyph_slots == NULL || glyph_arena == NULL) {
+        ESP_LOGW(TAG, "No PSRAM for the glyph cache - drawing glyphs from flash");
+        heap_caps_free(glyph_slots);
+        heap_caps_free(glyph_arena);
+        glyph_slots = NULL;
+        glyph_arena = NULL;
+        return;
+    }
+
+    for (int i = 0; i < UI_FONT_COUNT; i++) {
+        if (!cacheable(base_fonts[i])) {
+            continue;
+        }
+        cached_fonts[i] = *base_fonts[i];
+        cached_fonts[i].get_glyph_bitmap = cached_glyph_bitmap;
+        cached_fonts[i].user_data = (void *)(uintptr_t)i;
+        fonts[i] = &cached_fonts[i];
+    }
+    ESP_LOGI(TAG, "Glyph cache: %u KB PSRAM arena, %d slots", (unsigned)(arena_size / 1024), GLYPH_SLOTS);
+#endif
+}
+
+extern "C" const lv_font_t *ui_font(ui_font_id_t id)
+{
+    if (id >= UI_FONT_COUNT) {
+        id = UI_FONT_14;
+    }
+    return fonts[id] ? fonts[id] : base_fonts[id];
+}
+
+extern "C" void ui_fonts_log_stats(void)
+{
+#if CONFIG_GOLDIE_UI_GLYPH_CACHE
+    if (glyph_arena == NULL) {
+        return;
+    }
+    uint32_t lookups = glyph_hits + glyph_misses;
+    ESP_LOGI(TAG, "Glyph cache: %lu glyphs, %lu hits / %lu misses (%lu%% hit), %u/%u KB used, %lu uncached",
+             (unsigned long)glyph_count, (unsigned long)glyph_hits, (unsigned long)glyph_misses,
+             (unsigned long)(lookups ? (uint64_t)glyph_hits * 100 / lookups : 0),
+             (unsigned)(arena_used / 1024), (unsigned)(arena_size / 1024),
+             (unsigned long)glyph_uncached);
+#endif
+}
@@ -0,0 +1,58 @@
+#ifndef __UI_FONTS_H__
+#define __UI_FONTS_H__
+
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DASHBOARD FONTS - ONE ACCESSOR, OPTIONAL GLYPH CACHE AND SUBSET FONTS
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// The dashboard asks for fonts by size through ui_font() instead of naming
+// lv_font_montserrat_N directly, so the font source is a build option:
+//   - built-in LVGL Montserrat (default)
+//   - subset fonts generated by tools/subset_fonts.py into
+//     components/lvgl_ui/fonts/ (CONFIG_GOLDIE_UI_SUBSET_FONTS): printable
+//     ASCII plus only the LV_SYMBOL_* glyphs the sources use
+//
+// With CONFIG_GOLDIE_UI_GLYPH_CACHE each font is wrapped so glyph bitmaps
+// are copied out of flash into a PSRAM arena on first use. Flash is shared
+// with the animation frame reads, so re-laying out the AI text or a
+// history list no longer pulls every glyph through the flash cache again.
+// Hit/miss counters are logged with ui_fonts_log_stats().
+//
+// LVGL context only.
+
+typedef enum {
+    UI_FONT_12 = 0,
+    UI_FONT_14,
+    UI_FONT_16,
+    UI_FONT_20,
+    UI_FONT_32,
+    UI_FONT_COUNT
+} ui_font_id_t;
+
+/**
+ * @brief Build the font table (call once before creating any widgets)
+ */
+void ui_fonts_init(void);
+
+/**
+ * @brief Font for one of the dashboard's text sizes
+ */
+const lv_font_t *ui_font(ui_font_id_t id);
+
+/**
+ * @brief Log glyph cache hits, misses and arena use
+ */
+void ui_fonts_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
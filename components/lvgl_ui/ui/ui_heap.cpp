@@ -0,0 +1,212 @@
+#include "ui_heap.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "multi_heap.h"
+#include "freertos/FreeRTOS.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "ui_heap";
+
+typedef struct {
+    const char *name;
+    multi_heap_handle_t heap;           // NULL: pool off, class spills
+    uint8_t *start;
+    size_t size;
+    portMUX_TYPE lock;                  // multi_heap's own lock
+    uint32_t spills;
+} pool_t;
+
+static pool_t pools[2] = {
+    {"internal", NULL, NULL, 0, portMUX_INITIALIZER_UNLOCKED, 0},
+    {"psram", NULL, NULL, 0, portMUX_INITIALIZER_UNLOCKED, 0},
+};
+static bool pools_ready = false;
+
+// System heap: spills, and everything if both pools are off
+static portMUX_TYPE system_lock = portMUX_INITIALIZER_UNLOCKED;
+static size_t system_used = 0;
+static size_t system_peak = 0;
+static uint32_t system_blocks = 0;
+
+static void pool_create(pool_t *pool, size_t kb, uint32_t caps)
+{
+    if (kb == 0) {
+        return;
+    }
+    pool->start = (uint8_t *)heap_caps_malloc(kb * 1024, caps);
+    if (pool->start != NULL) {
+        pool->heap = multi_heap_register(pool->start, kb * 1024);
+    }
+    if (pool->heap == NULL) {
+        ESP_LOGW(TAG, "No %u KB for the %s pool - its class uses the system heap", (unsigned)kb, pool->name);
+        heap_caps_free(pool->start);
+        pool->start = NULL;
+        return;
+    }
+    pool->size = kb * 1024;
+    multi_heap_set_lock(pool->heap, &pool->lock);
+}
+
+// First LVGL allocation (lv_init, before any other task uses LVGL)
+static void pools_init(void)
+{
+    pools_ready = true;
+    pool_create(&pools[UI_HEAP_INTERNAL], CONFIG_GOLDIE_LV_HEAP_INTERNAL_KB, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    pool_create(&pools[UI_HEAP_PSRAM], CONFIG_GOLDIE_LV_HEAP_PSRAM_KB, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    ESP_LOGI(TAG, "LVGL heap: %u KB internal (blocks up to %d bytes), %u KB PSRAM",
+             (unsigned)(pools[UI_HEAP_INTERNAL].size / 1024), CONFIG_GOLDIE_LV_HEAP_SMALL_MAX,
+             (unsigned)(pools[UI_HEAP_PSRAM].size / 1024));
+}
+
+static pool_t *pool_of(const void *p)
+{
+    for (pool_t &pool : pools) {
+        if (pool.heap != NULL && (const uint8_t *)p >= pool.start && (const uint8_t *)p < pool.start + pool.size) {
+            return &pool;
+        }
+    }
+    return NULL;
+}
+
+static void system_count(void *p, bool add)
+{
+    if (p == NULL) {
+        return;
+    }
+    size_t n = heap_caps_get_allocated_size(p);
+    portENTER_CRITICAL(&system_lock);
+    if (add) {
+        system_used += n;
+        system_blocks++;
+        if (system_used > system_peak) {
+            system_peak = system_used;
+        }
+    } else {
+        system_used -= n;
+        system_blocks--;
+    }
+    portEXIT_CRITICAL(&system_lock);
+}
+
+static void *system_alloc(size_t size)
+{
+    // Large blocks stay out of internal RAM here too
+    void *p = size > CONFIG_GOLDIE_LV_HEAP_SMALL_MAX ? heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+                                                      : NULL;
+    if (p == NULL) {
+        p = malloc(size);
+    }
+    system_count(p, true);
+    return p;
+}
+
+extern "C" void *ui_heap_alloc(size_t size)
+{
+    if (!pools_ready) {
+        pools_init();
+    }
+    bool small = size <= CONFIG_GOLDIE_LV_HEAP_SMALL_MAX;
+    pool_t *pool = &pools[small ? UI_HEAP_INTERNAL : UI_HEAP_PSRAM];
+    void *p = pool->heap ? multi_heap_malloc(pool->heap, size) : NULL;
+    if (p != NULL) {
+        return p;
+    }
+    __atomic_add_fetch(&pool->spills, 1, __ATOMIC_RELAXED);
+    if (small && pools[UI_HEAP_PSRAM].heap != NULL) {
+        p = multi_heap_malloc(pools[UI_HEAP_PSRAM].heap, size);
+        if (p != NULL) {
+            return p;
+        }
+    }
+    return system_alloc(size);
+}
+
+extern "C" void ui_heap_free(void *p)
+{
+    if (p == NULL) {
+        return;
+    }
+    pool_t *pool = pool_of(p);
+    if (pool != NULL) {
+        multi_heap_free(pool->heap, p);
+        return;
+    }
+    system_count(p, false);
+    free(p);
+}
+
+extern "C" void *ui_heap_realloc(void *p, size_t size)
+{
+    if (p == NULL) {
+        return ui_heap_alloc(size);
+    }
+    pool_t *pool = pool_of(p);
+    if (pool == NULL) {
+        system_count(p, false);
+        void *q = realloc(p, size);
+        system_count(q != NULL ? q : p, true);
+        return q;
+    }
+
+    // Grown out of the small class: over to PSRAM rather than in place
+    if (!(pool == &pools[UI_HEAP_INTERNAL] && size > CONFIG_GOLDIE_LV_HEAP_SMALL_MAX)) {
+        void *q = multi_heap_realloc(pool->heap, p, size);
+        if (q != NULL) {
+            return q;
+        }
+    }
+    void *q = ui_heap_alloc(size);
+    if (q == NULL) {
+        return NULL;
+    }
+    size_t old_size = multi_heap_get_allocated_size(pool->heap, p);
+    memcpy(q, p, old_size < size ? old_size : size);
+    multi_heap_free(pool->heap, p);
+    return q;
+}
+
+extern "C" void ui_heap_get_stats(ui_heap_pool_t which, ui_heap_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (which == UI_HEAP_SYSTEM) {
+        portENTER_CRITICAL(&system_lock);
+        out->used = system_used;
+        out->peak = system_peak;
+        out->blocks = system_blocks;
+        portEXIT_CRITICAL(&system_lock);
+        return;
+    }
+    if (which >= UI_HEAP_POOL_COUNT) {
+        return;
+    }
+    const pool_t *pool = &pools[which];
+    out->spills = __atomic_load_n(&pool->spills, __ATOMIC_RELAXED);
+    if (pool->heap == NULL) {
+        return;
+    }
+    multi_heap_info_t info;
+    multi_heap_get_info(pool->heap, &info);
+    out->size = pool->size;
+    out->used = pool->size - info.total_free_bytes;
+    out->peak = pool->size - info.minimum_free_bytes;
+    out->largest_free = info.largest_free_block;
+    out->blocks = info.allocated_blocks;
+}
+
+extern "C" void ui_heap_log_stats(void)
+{
+    static const char *const names[UI_HEAP_POOL_COUNT] = {"internal", "psram", "system"};
+    for (int i = 0; i < UI_HEAP_POOL_COUNT; i++) {
+        ui_heap_stats_t s;
+        ui_heap_get_stats((ui_heap_pool_t)i, &s);
+        if (i == UI_HEAP_SYSTEM) {
+            ESP_LOGI(TAG, "LVGL heap %s: %u KB in %lu blocks (peak %u KB)", names[i], (unsigned)(s.used / 1024),
+                     (unsigned long)s.blocks, (unsigned)(s.peak / 1024));
+        } else {
+            ESP_LOGI(TAG, "LVGL heap %s: %u/%u KB in %lu blocks (peak %u KB, largest free %u KB), %lu spilled",
+                     names[i], (unsigned)(s.used / 1024), (unsigned)(s.size / 1024), (unsigned long)s.blocks,
+                     (unsigned)(s.peak / 1024), (unsigned)(s.largest_free / 1024), (unsigned long)s.spills);
+        }
+    }
+}
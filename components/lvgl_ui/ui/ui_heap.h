@@ -0,0 +1,84 @@
+#ifndef __UI_HEAP_H__
+#define __UI_HEAP_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LVGL HEAP - SIZE-CLASS POOLS IN INTERNAL RAM AND PSRAM
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Whatever LVGL allocates outside a popup arena (ui_arena.h, whose hooks
+// are LVGL's LV_MEM_CUSTOM allocator) ends up here, in one of two TLSF
+// pools (ESP-IDF multi_heap) carved out at the first allocation:
+//
+//   internal  up to CONFIG_GOLDIE_LV_HEAP_SMALL_MAX bytes: object structs,
+//             spec_attr, style and event arrays, short label text - what
+//             every refresh and event walks
+//   psram     larger: long text, chart points, image cache and decoder
+//             buffers, lv_mem_buf scratch
+//
+// A small block whose pool is full (or configured to 0 KB) spills to the
+// PSRAM pool, then to the system heap; a large one never takes internal
+// RAM and spills to the system heap's PSRAM. Spills are counted per
+// class. realloc() moves a block from the internal pool to PSRAM once it
+// outgrows the small class, and leaves a shrinking PSRAM block where it
+// is. Popups no longer compete with Wi-Fi and the tasks for internal RAM:
+// a large one fills the PSRAM pool, the internal pool only ever holds
+// small blocks.
+//
+// Usage per pool (plus what went to the system heap) is logged with the
+// status report and shown on the diagnostics tile.
+//
+// Any task holding the LVGL lock; each pool has its own spinlock.
+
+#ifndef CONFIG_GOLDIE_LV_HEAP_INTERNAL_KB
+#define CONFIG_GOLDIE_LV_HEAP_INTERNAL_KB 48
+#endif
+#ifndef CONFIG_GOLDIE_LV_HEAP_PSRAM_KB
+#define CONFIG_GOLDIE_LV_HEAP_PSRAM_KB 1024
+#endif
+#ifndef CONFIG_GOLDIE_LV_HEAP_SMALL_MAX
+#define CONFIG_GOLDIE_LV_HEAP_SMALL_MAX 256
+#endif
+
+typedef enum {
+    UI_HEAP_INTERNAL = 0,
+    UI_HEAP_PSRAM,
+    UI_HEAP_SYSTEM,                     // Spills and allocations before the pools
+    UI_HEAP_POOL_COUNT
+} ui_heap_pool_t;
+
+typedef struct {
+    size_t size;                        // Pool size, 0 if off (system: 0)
+    size_t used;                        // Bytes allocated now, overhead included
+    size_t peak;                        // Most ever allocated at once
+    size_t largest_free;                // Biggest block that would fit now
+    uint32_t blocks;                    // Live allocations
+    uint32_t spills;                    // Allocations this class sent elsewhere
+} ui_heap_stats_t;
+
+void *ui_heap_alloc(size_t size);
+void ui_heap_free(void *p);
+void *ui_heap_realloc(void *p, size_t size);
+
+/**
+ * @brief Usage of one pool (any task)
+ */
+void ui_heap_get_stats(ui_heap_pool_t pool, ui_heap_stats_t *out);
+
+/**
+ * @brief One log line per pool
+ */
+void ui_heap_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,98 @@
+#include "ui_inbox.h"
+#include "lvgl.h"
+#include "esp_lvgl_port.h"
+#include "esp_log.h"
+#include "input_rec.h"
+
+static const char *TAG = "ui_inbox";
+
+static lv_timer_t *inbox_timer = NULL;
+static ui_inbox_handler_t handlers[UI_MSG_COUNT];
+static volatile uint32_t pending = 0;     // Bit per ui_msg_type_t
+static volatile uint32_t posts = 0;
+static uint32_t wakes = 0;                // Timer runs that found work
+
+// Posts with no bus message behind them: recorded for replay (input_rec.h)
+#define RECORDED_POSTS ((1u << UI_MSG_WIFI_STATE) | (1u << UI_MSG_TIME_CHANGED))
+
+static void inbox_timer_cb(lv_timer_t *timer)
+{
+    // Pause first, then take the bits: a post that lands in between resumes
+    // the timer again, so nothing is lost (worst case one empty run)
+    lv_timer_pause(timer);
+    uint32_t bits = __atomic_exchange_n(&pending, 0, __ATOMIC_ACQ_REL);
+    if (bits == 0) {
+        return;
+    }
+    wakes++;
+    for (int i = 0; i < UI_MSG_COUNT; i++) {
+        if ((bits & (1u << i)) && handlers[i]) {
+            handlers[i]();
+        }
+    }
+}
+
+static void inbox_replay_sink(uint8_t type, const uint8_t *data, size_t len)
+{
+    if (type < UI_MSG_COUNT && (RECORDED_POSTS & (1u << type))) {
+        ui_inbox_post((ui_msg_type_t)type);
+    }
+}
+
+extern "C" bool ui_inbox_init(void)
+{
+    if (inbox_timer) {
+        return true;
+    }
+    inbox_timer = lv_timer_create(inbox_timer_cb, 0, NULL);
+    if (!inbox_timer) {
+        ESP_LOGE(TAG, "Failed to create inbox timer");
+        return false;
+    }
+    input_rec_set_sink(INPUT_REC_INBOX, inbox_replay_sink);
+
+    // Start paused; results posted before init are delivered on the first pass
+    lv_timer_pause(inbox_timer);
+    if (pending != 0) {
+        lv_timer_resume(inbox_timer);
+    }
+    ESP_LOGI(TAG, "UI inbox ready (event-driven, no result polling)");
+    return true;
+}
+
+extern "C" void ui_inbox_subscribe(ui_msg_type_t type, ui_inbox_handler_t handler)
+{
+    if (type < UI_MSG_COUNT) {
+        handlers[type] = handler;
+    }
+}
+
+extern "C" void ui_inbox_post(ui_msg_type_t type)
+{
+    if (type >= UI_MSG_COUNT) {
+        return;
+    }
+    if (RECORDED_POSTS & (1u << type)) {
+        if (!input_rec_live(INPUT_REC_INBOX)) {
+            return;                        // A replay stands in for the network and the clock
+        }
+        input_rec_put(INPUT_REC_INBOX, (uint8_t)type, NULL, 0);
+    }
+    __atomic_fetch_or(&pending, 1u << type, __ATOMIC_ACQ_REL);
+    __atomic_fetch_add(&posts, 1, __ATOMIC_RELAXED);
+
+    lv_timer_t *timer = inbox_timer;
+    if (timer) {
+        // lv_timer_resume() only clears the timer's paused flag, so it is
+        // safe without the LVGL lock; the wake makes the port task run
+        // lv_timer_handler() now instead of after its current sleep
+        lv_timer_resume(timer);
+        lvgl_port_task_wake(LVGL_PORT_EVENT_USER, NULL);
+    }
+}
+
+extern "C" void ui_inbox_log_stats(void)
+{
+    ESP_LOGI(TAG, "UI inbox: %lu posts, %lu LVGL wakes",
+             (unsigned long)posts, (unsigned long)wakes);
+}
@@ -0,0 +1,68 @@
+#ifndef __UI_INBOX_H__
+#define __UI_INBOX_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// UI INBOX - WAKE THE LVGL TASK ONLY WHEN A BACKGROUND RESULT ARRIVES
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Background tasks hand their payload over through the message bus or a
+// typed queue, then ui_inbox_post(type) is called (for bus topics from the
+// subscription's notify). The post sets the type's pending bit, un-pauses a
+// single LVGL timer and wakes the esp_lvgl_port task. In LVGL context that
+// timer pauses itself again, takes the pending bits and calls each
+// subscribed handler once, so the handler drains its own queue.
+//
+// An idle dashboard therefore has no result pollers: nothing runs in LVGL
+// for these messages until one is posted.
+//
+// ui_inbox_post() is safe from any task (not ISRs); everything else is
+// LVGL context only.
+
+typedef enum {
+    UI_MSG_MOOD_RESULT = 0,  // logic_task -> MSG_TOPIC_MOOD_RESULT
+    UI_MSG_AI_RESULT,        // ai_worker -> MSG_TOPIC_AI_RESULT
+    UI_MSG_WIFI_STATE,       // telemetry: gemini_is_wifi_connected() changed
+    UI_MSG_POWER_STATUS,     // power_monitor -> MSG_TOPIC_POWER_STATUS (power_gov)
+    UI_MSG_TIME_CHANGED,     // wall clock set / re-synced or TZ changed (dashboard_update_calendar)
+    UI_MSG_REMINDER,         // reminders -> MSG_TOPIC_REMINDER
+    UI_MSG_MOOD_FORECAST,    // logic_task -> MSG_TOPIC_MOOD_FORECAST (drift warnings)
+    UI_MSG_COUNT
+} ui_msg_type_t;
+
+typedef void (*ui_inbox_handler_t)(void);
+
+/**
+ * @brief Create the inbox timer (paused). Call from LVGL context.
+ */
+bool ui_inbox_init(void);
+
+/**
+ * @brief Set the handler called when `type` is posted
+ */
+void ui_inbox_subscribe(ui_msg_type_t type, ui_inbox_handler_t handler);
+
+/**
+ * @brief Mark `type` pending and wake the LVGL task
+ *
+ * Posts of the same type before the LVGL task runs are merged into one
+ * handler call; the handler must drain everything its queue holds.
+ */
+void ui_inbox_post(ui_msg_type_t type);
+
+/**
+ * @brief Log post / wake counters
+ */
+void ui_inbox_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
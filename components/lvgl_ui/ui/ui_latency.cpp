@@ -0,0 +1,176 @@
+#include "ui_latency.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "ui_latency";
+
+static const char *const path_names[UI_LATENCY_PATH_COUNT] = {
+    "touch>screen", "param>logic", "param>mood", "param>screen",
+};
+
+// Recorded from the LVGL and logic tasks, read from any task
+static portMUX_TYPE latency_lock = portMUX_INITIALIZER_UNLOCKED;
+static ui_latency_hist_t hist[UI_LATENCY_PATH_COUNT];
+static bool running = false;
+
+// LVGL task only
+static int64_t armed[UI_LATENCY_PATH_COUNT];   // Origin waiting for a refresh (0 = none)
+static void (*prev_monitor)(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px) = NULL;
+
+static uint8_t bucket_of(uint32_t us)
+{
+    uint32_t ms = us / 1000;
+    uint8_t b = 0;
+    while (ms != 0 && b < UI_LATENCY_BUCKETS - 1) {
+        ms >>= 1;
+        b++;
+    }
+    return b;
+}
+
+static void add_sample(ui_latency_path_t path, uint32_t us)
+{
+    portENTER_CRITICAL(&latency_lock);
+    ui_latency_hist_t *h = &hist[path];
+    h->count++;
+    h->sum_us += us;
+    if (us > h->max_us) {
+        h->max_us = us;
+    }
+    h->bucket[bucket_of(us)]++;
+    portEXIT_CRITICAL(&latency_lock);
+}
+
+static void latency_monitor(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px)
+{
+    int64_t now = esp_timer_get_time();
+    for (int p = 0; p < UI_LATENCY_PATH_COUNT; p++) {
+        if (armed[p] == 0) {
+            continue;
+        }
+        int64_t us = now - armed[p];
+        armed[p] = 0;
+        if (us >= 0 && us <= (int64_t)UI_LATENCY_ARM_MAX_MS * 1000) {
+            add_sample((ui_latency_path_t)p, (uint32_t)us);
+        }
+    }
+    if (prev_monitor) {
+        prev_monitor(drv, time_ms, px);
+    }
+}
+
+extern "C" void ui_latency_record(ui_latency_path_t path, int64_t origin_us)
+{
+    if (!running || origin_us == 0 || path >= UI_LATENCY_PATH_COUNT) {
+        return;
+    }
+    int64_t us = esp_timer_get_time() - origin_us;
+    add_sample(path, us < 0 ? 0 : (uint32_t)(us > UINT32_MAX ? UINT32_MAX : us));
+}
+
+extern "C" void ui_latency_arm_screen(ui_latency_path_t path, int64_t origin_us)
+{
+    if (running && origin_us != 0 && path < UI_LATENCY_PATH_COUNT) {
+        armed[path] = origin_us;
+    }
+}
+
+extern "C" bool ui_latency_get(ui_latency_path_t path, ui_latency_hist_t *out)
+{
+    if (!running || path >= UI_LATENCY_PATH_COUNT) {
+        return false;
+    }
+    portENTER_CRITICAL(&latency_lock);
+    *out = hist[path];
+    portEXIT_CRITICAL(&latency_lock);
+    return true;
+}
+
+extern "C" uint32_t ui_latency_percentile_ms(const ui_latency_hist_t *h, uint8_t pct)
+{
+    if (h->count == 0) {
+        return 0;
+    }
+    uint32_t target = (uint32_t)(((uint64_t)h->count * pct + 99) / 100);
+    uint32_t seen = 0;
+    for (int b = 0; b < UI_LATENCY_BUCKETS; b++) {
+        seen += h->bucket[b];
+        if (seen >= target) {
+            // The last bucket is open-ended; its bound is the worst seen
+            return b < UI_LATENCY_BUCKETS - 1 ? (1u << b) : h->max_us / 1000;
+        }
+    }
+    return h->max_us / 1000;
+}
+
+extern "C" const char *ui_latency_path_name(ui_latency_path_t path)
+{
+    return path < UI_LATENCY_PATH_COUNT ? path_names[path] : "?";
+}
+
+extern "C" size_t ui_latency_format(char *buf, size_t len)
+{
+    size_t pos = 0;
+    if (len == 0) {
+        return 0;
+    }
+    buf[0] = '\0';
+    for (int p = 0; p < UI_LATENCY_PATH_COUNT && pos < len; p++) {
+        ui_latency_hist_t h;
+        if (!ui_latency_get((ui_latency_path_t)p, &h)) {
+            return (size_t)snprintf(buf, len, "Latency tracking off (CONFIG_GOLDIE_UI_LATENCY)");
+        }
+        int n;
+        if (h.count == 0) {
+            n = snprintf(buf + pos, len - pos, "%s: no samples\n", path_names[p]);
+        } else {
+            n = snprintf(buf + pos, len - pos, "%s: n=%lu avg %lu ms, p50 <%lu p95 <%lu, max %lu ms\n",
+                         path_names[p], (unsigned long)h.count, (unsigned long)(h.sum_us / h.count / 1000),
+                         (unsigned long)ui_latency_percentile_ms(&h, 50),
+                         (unsigned long)ui_latency_percentile_ms(&h, 95), (unsigned long)(h.max_us / 1000));
+        }
+        pos += n > 0 ? (size_t)n : 0;
+
+        uint32_t peak = 0;
+        for (int b = 0; b < UI_LATENCY_BUCKETS; b++) {
+            peak = h.bucket[b] > peak ? h.bucket[b] : peak;
+        }
+        for (int b = 0; b < UI_LATENCY_BUCKETS && peak != 0 && pos < len; b++) {
+            if (h.bucket[b] == 0) {
+                continue;
+            }
+            char bar[21];
+            int w = (int)((uint64_t)h.bucket[b] * 20 / peak);
+            w = w < 1 ? 1 : w;
+            memset(bar, '#', w);
+            bar[w] = '\0';
+            if (b < UI_LATENCY_BUCKETS - 1) {
+                n = snprintf(buf + pos, len - pos, "  <%5lu ms %-20s %lu\n", (unsigned long)(1u << b), bar,
+                             (unsigned long)h.bucket[b]);
+            } else {
+                n = snprintf(buf + pos, len - pos, "  >=%4lu ms %-20s %lu\n", (unsigned long)(1u << (b - 1)), bar,
+                             (unsigned long)h.bucket[b]);
+            }
+            pos += n > 0 ? (size_t)n : 0;
+        }
+    }
+    return pos < len ? pos : len - 1;
+}
+
+extern "C" void ui_latency_init(lv_disp_t *disp)
+{
+    if (!CONFIG_GOLDIE_UI_LATENCY || running) {
+        return;
+    }
+    if (disp == NULL) {
+        ESP_LOGW(TAG, "No display - latency tracking off");
+        return;
+    }
+    prev_monitor = disp->driver->monitor_cb;
+    disp->driver->monitor_cb = latency_monitor;
+    running = true;
+    ESP_LOGI(TAG, "End-to-end latency tracking on");
+}
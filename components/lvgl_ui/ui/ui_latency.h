@@ -0,0 +1,106 @@
+#ifndef __UI_LATENCY_H__
+#define __UI_LATENCY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// END-TO-END UI LATENCY - ORIGIN TIMESTAMP TO WHAT THE USER SEES
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Messages on the mood path carry the esp_timer time of the edit that
+// started them (origin_us in aquarium_params_t and mood_result_t):
+//
+//   edit (keypad Save, feed / clean button)   dashboard: first change of a
+//     -> queue_param_update                   settle burst stamps origin_us
+//     -> logic_task takes it                  PARAM_TO_LOGIC
+//     -> MSG_TOPIC_MOOD_RESULT -> UI inbox
+//     -> button colours / category applied    PARAM_TO_MOOD
+//     -> first LVGL refresh finished after    PARAM_TO_SCREEN
+//
+//   touch press (indev read)
+//     -> first LVGL refresh finished after    TOUCH_TO_SCREEN
+//
+// The *_TO_SCREEN paths end in the display's monitor_cb (hooked here,
+// chained to whatever was installed before). A mark that no refresh
+// picks up within UI_LATENCY_ARM_MAX_MS (nothing on screen changed) is
+// dropped rather than counted.
+//
+// Each path keeps a power-of-two histogram in ms plus count, mean and
+// max, shown on the latency tile of the diagnostics view (long-press
+// Parameters, tileview/diag_tile.h). Without CONFIG_GOLDIE_UI_LATENCY
+// nothing is recorded.
+
+#ifndef CONFIG_GOLDIE_UI_LATENCY
+#define CONFIG_GOLDIE_UI_LATENCY 0
+#endif
+
+#define UI_LATENCY_BUCKETS      14     // [0,1) [1,2) [2,4) ... [4096,inf) ms
+#define UI_LATENCY_ARM_MAX_MS   2000
+
+typedef enum {
+    UI_LATENCY_TOUCH_TO_SCREEN = 0,
+    UI_LATENCY_PARAM_TO_LOGIC,
+    UI_LATENCY_PARAM_TO_MOOD,
+    UI_LATENCY_PARAM_TO_SCREEN,
+    UI_LATENCY_PATH_COUNT
+} ui_latency_path_t;
+
+typedef struct {
+    uint32_t count;
+    uint64_t sum_us;
+    uint32_t max_us;
+    uint32_t bucket[UI_LATENCY_BUCKETS];
+} ui_latency_hist_t;
+
+/**
+ * @brief Hook the display's monitor_cb (LVGL lock held; no-op if disabled)
+ */
+void ui_latency_init(lv_disp_t *disp);
+
+/**
+ * @brief Count now - origin_us on a path (any task; origin 0 is ignored)
+ */
+void ui_latency_record(ui_latency_path_t path, int64_t origin_us);
+
+/**
+ * @brief End a path at the next finished refresh (LVGL context)
+ *
+ * A newer mark on the same path replaces one not yet picked up.
+ */
+void ui_latency_arm_screen(ui_latency_path_t path, int64_t origin_us);
+
+/**
+ * @brief Copy one path's histogram
+ * @return false if latency tracking is off
+ */
+bool ui_latency_get(ui_latency_path_t path, ui_latency_hist_t *out);
+
+/**
+ * @brief Upper bound (ms) of the bucket holding the pct-th percentile, 0 if empty
+ */
+uint32_t ui_latency_percentile_ms(const ui_latency_hist_t *h, uint8_t pct);
+
+/**
+ * @brief Short name of a path ("touch>screen", "param>logic", ...)
+ */
+const char *ui_latency_path_name(ui_latency_path_t path);
+
+/**
+ * @brief All paths as text: one summary line and one bar row per bucket in use
+ * @return Characters written
+ */
+size_t ui_latency_format(char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,259 @@
+#include "ui_mirror.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include <string.h>
+#include <atomic>
+
+static const char *TAG = "ui_mirror";
+
+static void (*prev_flush)(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p) = NULL;
+static uint16_t *shadow = NULL;             // Screen as last flushed, PSRAM
+static int16_t shadow_w = 0;
+static int16_t shadow_h = 0;
+static std::atomic<bool> active(false);
+
+// Dirty list: written by the LVGL task, taken by the streamer
+static portMUX_TYPE mirror_lock = portMUX_INITIALIZER_UNLOCKED;
+static ui_mirror_rect_t dirty[UI_MIRROR_RECTS];
+static int dirty_count = 0;
+
+// Injected pointer
+static lv_indev_drv_t touch_drv;
+static int16_t touch_x = 0;
+static int16_t touch_y = 0;
+static bool touch_pressed = false;
+
+static int32_t rect_area(const ui_mirror_rect_t *r)
+{
+    return (int32_t)r->w * r->h;
+}
+
+/**
+ * @brief Grow `into` to also cover `r`
+ */
+static void rect_union(ui_mirror_rect_t *into, const ui_mirror_rect_t *r)
+{
+    int16_t x0 = into->x < r->x ? into->x : r->x;
+    int16_t y0 = into->y < r->y ? into->y : r->y;
+    int16_t x1 = (into->x + into->w) > (r->x + r->w) ? (into->x + into->w) : (r->x + r->w);
+    int16_t y1 = (into->y + into->h) > (r->y + r->h) ? (into->y + into->h) : (r->y + r->h);
+    into->x = x0;
+    into->y = y0;
+    into->w = x1 - x0;
+    into->h = y1 - y0;
+}
+
+/**
+ * @brief Extra area a union would cover that neither rectangle does (0 = they overlap well)
+ */
+static int32_t union_cost(const ui_mirror_rect_t *a, const ui_mirror_rect_t *b)
+{
+    ui_mirror_rect_t u = *a;
+    rect_union(&u, b);
+    return rect_area(&u) - rect_area(a) - rect_area(b);
+}
+
+extern "C" void ui_mirror_mark(const ui_mirror_rect_t *rect)
+{
+    if (rect->w <= 0 || rect->h <= 0) {
+        return;
+    }
+    portENTER_CRITICAL(&mirror_lock);
+    int best = -1;
+    int32_t best_cost = INT32_MAX;
+    for (int i = 0; i < dirty_count; i++) {
+        int32_t cost = union_cost(&dirty[i], rect);
+        if (cost < best_cost) {
+            best_cost = cost;
+            best = i;
+        }
+    }
+    if (best >= 0 && (best_cost <= 0 || dirty_count == UI_MIRROR_RECTS)) {
+        rect_union(&dirty[best], rect);     // Touching, overlapping, or the list is full
+    } else {
+        dirty[dirty_count++] = *rect;
+    }
+    portEXIT_CRITICAL(&mirror_lock);
+}
+
+/**
+ * @brief Copy a flushed area into the shadow, then mark it
+ */
+static void copy_area(int x0, int y0, int x1, int y1, const uint16_t *src, int src_stride)
+{
+    // Clip to the screen; src stays aligned to the original area
+    int cx0 = x0 < 0 ? 0 : x0;
+    int cy0 = y0 < 0 ? 0 : y0;
+    int cx1 = x1 >= shadow_w ? shadow_w - 1 : x1;
+    int cy1 = y1 >= shadow_h ? shadow_h - 1 : y1;
+    if (cx1 < cx0 || cy1 < cy0) {
+        return;
+    }
+    size_t row_bytes = (size_t)(cx1 - cx0 + 1) * 2;
+    for (int y = cy0; y <= cy1; y++) {
+        memcpy(&shadow[(size_t)y * shadow_w + cx0], &src[(size_t)(y - y0) * src_stride + (cx0 - x0)], row_bytes);
+    }
+    ui_mirror_rect_t r = { (int16_t)cx0, (int16_t)cy0, (int16_t)(cx1 - cx0 + 1), (int16_t)(cy1 - cy0 + 1) };
+    ui_mirror_mark(&r);
+}
+
+static void mirror_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    // Before the hand-off: the buffer is LVGL's until flush-ready
+    if (active.load(std::memory_order_relaxed) && shadow != NULL) {
+        copy_area(area->x1, area->y1, area->x2, area->y2, (const uint16_t *)color_p, area->x2 - area->x1 + 1);
+    }
+    prev_flush(drv, area, color_p);
+}
+
+extern "C" void ui_mirror_blit(const uint8_t *frame, int width, int y0, int y1)
+{
+    if (!active.load(std::memory_order_relaxed) || shadow == NULL || y1 <= y0) {
+        return;
+    }
+    const uint16_t *rows = (const uint16_t *)frame + (size_t)y0 * width;
+    copy_area(0, y0, width - 1, y1 - 1, rows, width);
+}
+
+static void touch_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
+{
+    portENTER_CRITICAL(&mirror_lock);
+    data->point.x = touch_x;
+    data->point.y = touch_y;
+    data->state = touch_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    portEXIT_CRITICAL(&mirror_lock);
+}
+
+extern "C" void ui_mirror_touch(int16_t x, int16_t y, bool pressed)
+{
+    if (!CONFIG_GOLDIE_MIRROR_TOUCH) {
+        return;
+    }
+    portENTER_CRITICAL(&mirror_lock);
+    touch_x = x < 0 ? 0 : (x >= shadow_w ? shadow_w - 1 : x);
+    touch_y = y < 0 ? 0 : (y >= shadow_h ? shadow_h - 1 : y);
+    touch_pressed = pressed;
+    portEXIT_CRITICAL(&mirror_lock);
+}
+
+extern "C" void ui_mirror_set_active(bool on)
+{
+    if (shadow == NULL) {
+        return;
+    }
+    if (!on) {
+        portENTER_CRITICAL(&mirror_lock);
+        dirty_count = 0;
+        touch_pressed = false;              // A viewer that left holds nothing down
+        portEXIT_CRITICAL(&mirror_lock);
+    }
+    active = on;
+}
+
+extern "C" bool ui_mirror_active(void)
+{
+    return active;
+}
+
+extern "C" void ui_mirror_invalidate(void)
+{
+    // Every layer, so the redraw is full-screen even over popups
+    lv_obj_invalidate(lv_scr_act());
+    lv_obj_invalidate(lv_layer_top());
+    lv_obj_invalidate(lv_layer_sys());
+}
+
+extern "C" int ui_mirror_take(ui_mirror_rect_t *rects, int max)
+{
+    portENTER_CRITICAL(&mirror_lock);
+    int n = dirty_count < max ? dirty_count : max;
+    memcpy(rects, dirty, (size_t)n * sizeof(rects[0]));
+    memmove(dirty, dirty + n, (size_t)(dirty_count - n) * sizeof(dirty[0]));
+    dirty_count -= n;
+    portEXIT_CRITICAL(&mirror_lock);
+    return n;
+}
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+extern "C" size_t ui_mirror_encode(ui_mirror_rect_t *rect, uint8_t *out, size_t cap)
+{
+    if (shadow == NULL || rect->w <= 0 || rect->h <= 0) {
+        return 0;
+    }
+    const size_t row_max = (size_t)rect->w * 3;     // Every pixel its own run
+    size_t used = UI_MIRROR_RECT_HDR;
+    int16_t rows = 0;
+    while (rows < rect->h && used + row_max <= cap) {
+        const uint16_t *px = &shadow[(size_t)(rect->y + rows) * shadow_w + rect->x];
+        int x = 0;
+        while (x < rect->w) {
+            uint16_t c = px[x];
+            int run = 1;
+            while (x + run < rect->w && run < 256 && px[x + run] == c) {
+                run++;
+            }
+            out[used] = (uint8_t)(run - 1);
+            put_u16(&out[used + 1], c);
+            used += 3;
+            x += run;
+        }
+        rows++;
+    }
+    if (rows == 0) {
+        return 0;
+    }
+    put_u16(&out[0], (uint16_t)rect->x);
+    put_u16(&out[2], (uint16_t)rect->y);
+    put_u16(&out[4], (uint16_t)rect->w);
+    put_u16(&out[6], (uint16_t)rows);
+    rect->y += rows;
+    rect->h -= rows;
+    return used;
+}
+
+extern "C" void ui_mirror_size(int16_t *w, int16_t *h)
+{
+    *w = shadow_w;
+    *h = shadow_h;
+}
+
+extern "C" void ui_mirror_init(lv_disp_t *disp)
+{
+    if (!CONFIG_GOLDIE_SCREEN_MIRROR || shadow != NULL) {
+        return;
+    }
+    if (disp == NULL || disp->driver->flush_cb == NULL) {
+        ESP_LOGW(TAG, "No display - screen mirror off");
+        return;
+    }
+    lv_disp_drv_t *drv = disp->driver;
+    int16_t w = (int16_t)lv_disp_get_hor_res(disp);
+    int16_t h = (int16_t)lv_disp_get_ver_res(disp);
+    shadow = (uint16_t *)heap_caps_calloc((size_t)w * h, sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+    if (shadow == NULL) {
+        ESP_LOGW(TAG, "No PSRAM for the %dx%d shadow - screen mirror off", w, h);
+        return;
+    }
+    shadow_w = w;
+    shadow_h = h;
+    prev_flush = drv->flush_cb;
+    drv->flush_cb = mirror_flush;
+
+    if (CONFIG_GOLDIE_MIRROR_TOUCH) {
+        lv_indev_drv_init(&touch_drv);
+        touch_drv.type = LV_INDEV_TYPE_POINTER;
+        touch_drv.read_cb = touch_read;
+        touch_drv.disp = disp;
+        if (lv_indev_drv_register(&touch_drv) == NULL) {
+            ESP_LOGW(TAG, "Virtual pointer not registered - no remote touch");
+        }
+    }
+    ESP_LOGI(TAG, "Screen mirror ready (%dx%d shadow in PSRAM%s)", w, h,
+             CONFIG_GOLDIE_MIRROR_TOUCH ? ", remote touch" : "");
+}
@@ -0,0 +1,125 @@
+#ifndef __UI_MIRROR_H__
+#define __UI_MIRROR_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SCREEN MIRROR - FLUSHED RECTANGLES FOR A REMOTE VIEWER
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// With CONFIG_GOLDIE_SCREEN_MIRROR the display's flush_cb is wrapped
+// (chained like ui_perf.h): while a viewer is attached, each band LVGL
+// flushes is copied into a PSRAM shadow of the screen and its rectangle
+// added to a short dirty list; the direct animation blits (panel_blit.h)
+// report their rows the same way. The copy is a memcpy per band - nothing
+// is encoded or sent in the LVGL task.
+//
+// The streamer (main/screen_mirror.h) takes the dirty list at its own
+// rate, RLE-encodes those rectangles from the shadow and sends them; a
+// rectangle flushed again before it is taken is simply sent once, newest
+// pixels. With nobody attached the wrapper is one flag test.
+//
+// Encoded rectangle (little endian):
+//   u16 x, y, w, h      rows of this chunk (a big rectangle is cut into
+//                       row bands that fit the send buffer)
+//   runs                u8 count-1 (1..256 pixels), u16 RGB565 as flushed
+//                       (byte-swapped with LV_COLOR_16_SWAP, panel order)
+// Runs never cross rows.
+//
+// With CONFIG_GOLDIE_MIRROR_TOUCH a virtual pointer device feeds injected
+// presses to LVGL alongside the touch panel, for remote control and
+// scripted UI tests.
+//
+// ui_mirror_init() / ui_mirror_invalidate(): LVGL context. The rest: any task.
+
+#ifndef CONFIG_GOLDIE_SCREEN_MIRROR
+#define CONFIG_GOLDIE_SCREEN_MIRROR 0
+#endif
+#ifndef CONFIG_GOLDIE_MIRROR_TOUCH
+#define CONFIG_GOLDIE_MIRROR_TOUCH 0
+#endif
+
+#define UI_MIRROR_RECTS      8          // Dirty list; more are merged into the nearest
+#define UI_MIRROR_RECT_HDR   8          // x, y, w, h
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+} ui_mirror_rect_t;
+
+/**
+ * @brief Wrap the display's flush_cb and, with touch, add the virtual pointer
+ *        (after ui_perf_init(), LVGL lock held)
+ *
+ * No-op without CONFIG_GOLDIE_SCREEN_MIRROR.
+ */
+void ui_mirror_init(lv_disp_t *disp);
+
+/**
+ * @brief Start or stop copying flushes (the streamer, as viewers come and go)
+ */
+void ui_mirror_set_active(bool active);
+
+/**
+ * @brief Copying flushes
+ */
+bool ui_mirror_active(void);
+
+/**
+ * @brief Redraw the whole screen so a new viewer gets every pixel (LVGL lock held)
+ */
+void ui_mirror_invalidate(void);
+
+/**
+ * @brief Rows [y0, y1) of a full-width frame went to the panel directly (panel_blit.h)
+ */
+void ui_mirror_blit(const uint8_t *frame, int width, int y0, int y1);
+
+/**
+ * @brief Take the dirty rectangles and clear the list
+ * @return Number written to rects
+ */
+int ui_mirror_take(ui_mirror_rect_t *rects, int max);
+
+/**
+ * @brief Put a rectangle back (not sent this round)
+ */
+void ui_mirror_mark(const ui_mirror_rect_t *rect);
+
+/**
+ * @brief RLE-encode rows of a rectangle from the shadow
+ *
+ * Encodes whole rows from rect->y on while they fit, then moves rect->y /
+ * rect->h past them; the caller sends the chunk and calls again until
+ * rect->h is 0.
+ * @return Bytes written, 0 if not even one row fits (or no shadow)
+ */
+size_t ui_mirror_encode(ui_mirror_rect_t *rect, uint8_t *out, size_t cap);
+
+/**
+ * @brief Screen size of the shadow (0 x 0 before init)
+ */
+void ui_mirror_size(int16_t *w, int16_t *h);
+
+/**
+ * @brief Injected pointer state, read by LVGL on its next input poll
+ *
+ * Without CONFIG_GOLDIE_MIRROR_TOUCH it is ignored.
+ */
+void ui_mirror_touch(int16_t x, int16_t y, bool pressed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,308 @@
+#include "ui_obj_track.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include <string.h>
+
+static const char *TAG = "ui_obj_track";
+
+typedef struct {
+    const char *name;                   // NULL: free slot
+    uint32_t last;                      // Rebuilds: tree size at the previous check
+    uint32_t peak;                      // Largest popup / rebuilt tree
+    uint16_t runs;                      // Opens or checks
+    uint16_t grew;
+} track_name_t;
+
+typedef enum {
+    POPUP_FREE = 0,
+    POPUP_OPEN,
+    POPUP_CLOSED,                       // Root deleted, screen counted next pass
+} popup_state_t;
+
+typedef struct {
+    lv_obj_t *root;
+    lv_obj_t *screen;
+    track_name_t *name;
+    uint32_t baseline;                  // Screen without tracked popups, at open
+    popup_state_t state;
+} track_popup_t;
+
+// Read from any task
+static portMUX_TYPE track_lock = portMUX_INITIALIZER_UNLOCKED;
+static ui_obj_track_stats_t stats;
+
+// LVGL task only
+static track_name_t names[UI_OBJ_TRACK_NAMES];
+static track_popup_t popups[UI_OBJ_TRACK_OPEN];
+static lv_timer_t *check_timer = NULL;  // Paused until a tracked root is deleted
+static uint32_t log_elapsed_ms = 0;
+static uint32_t settle_ms = 0;
+static uint32_t creep_high = 0;         // Idle count above which creep is flagged
+
+static uint32_t count_tree(const lv_obj_t *obj, uint16_t depth, uint16_t *depth_max)
+{
+    if (depth > *depth_max) {
+        *depth_max = depth;
+    }
+    uint32_t n = 1;
+    uint32_t children = lv_obj_get_child_cnt(obj);
+    for (uint32_t i = 0; i < children; i++) {
+        n += count_tree(lv_obj_get_child(obj, (int32_t)i), (uint16_t)(depth + 1), depth_max);
+    }
+    return n;
+}
+
+static track_name_t *name_slot(const char *name)
+{
+    track_name_t *free_slot = NULL;
+    for (track_name_t &t : names) {
+        if (t.name == name || (t.name != NULL && strcmp(t.name, name) == 0)) {
+            return &t;
+        }
+        if (t.name == NULL && free_slot == NULL) {
+            free_slot = &t;
+        }
+    }
+    if (free_slot == NULL) {
+        ESP_LOGW(TAG, "All %d names in use - %s not tracked", UI_OBJ_TRACK_NAMES, name);
+        return NULL;
+    }
+    free_slot->name = name;
+    return free_slot;
+}
+
+static void note_growth(void)
+{
+    portENTER_CRITICAL(&track_lock);
+    stats.grew++;
+    portEXIT_CRITICAL(&track_lock);
+}
+
+/**
+ * @brief Screen's objects outside the tracked popups still open on it
+ */
+static uint32_t screen_rest(lv_obj_t *screen)
+{
+    uint16_t depth = 0;
+    uint32_t n = count_tree(screen, 0, &depth);
+    for (const track_popup_t &p : popups) {
+        if (p.state == POPUP_OPEN && p.screen == screen) {
+            uint32_t own = count_tree(p.root, 0, &depth);
+            n = n > own ? n - own : 0;
+        }
+    }
+    return n;
+}
+
+static bool any_popup_open(void)
+{
+    for (const track_popup_t &p : popups) {
+        if (p.state == POPUP_OPEN) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void popup_deleted_cb(lv_event_t *e)
+{
+    track_popup_t *p = (track_popup_t *)lv_event_get_user_data(e);
+    if (p->root != lv_event_get_target(e) || p->state != POPUP_OPEN) {
+        return;
+    }
+    // Children are deleted after this event: the popup's own tree is still whole
+    uint16_t depth = 0;
+    uint32_t own = count_tree(p->root, 0, &depth);
+    if (own > p->name->peak) {
+        p->name->peak = own;
+    }
+    p->state = POPUP_CLOSED;
+    p->root = NULL;
+    lv_timer_resume(check_timer);
+    lv_timer_ready(check_timer);
+}
+
+/**
+ * @brief After tracked roots were deleted: compare their screens with the open-time counts
+ */
+static void check_timer_cb(lv_timer_t *timer)
+{
+    for (track_popup_t &p : popups) {
+        if (p.state != POPUP_CLOSED) {
+            continue;
+        }
+        p.state = POPUP_FREE;
+        if (!lv_obj_is_valid(p.screen)) {
+            continue;                   // Screen went with it
+        }
+        uint32_t now = screen_rest(p.screen);
+        if (now > p.baseline) {
+            p.name->grew++;
+            note_growth();
+            ESP_LOGW(TAG, "%s closed: screen has %lu objects more than when it opened "
+                     "(%u of %u closes left objects)", p.name->name, (unsigned long)(now - p.baseline),
+                     p.name->grew, p.name->runs);
+        }
+    }
+    lv_timer_pause(timer);
+}
+
+static void sample_timer_cb(lv_timer_t *timer)
+{
+    lv_disp_t *disp = lv_disp_get_default();
+    if (disp == NULL) {
+        return;
+    }
+    uint16_t depth = 0;
+    uint32_t live = count_tree(lv_disp_get_layer_top(disp), 0, &depth) +
+                    count_tree(lv_disp_get_layer_sys(disp), 0, &depth);
+    for (uint32_t i = 0; i < disp->screen_cnt; i++) {
+        live += count_tree(disp->screens[i], 0, &depth);
+    }
+
+    // Idle base: the first sample with no tracked popup open once the idle
+    // time work (pre-built popups) has settled
+    bool idle = !any_popup_open();
+    bool creep = false;
+    uint32_t idle_base;
+    portENTER_CRITICAL(&track_lock);
+    stats.live = live;
+    if (live > stats.worst) {
+        stats.worst = live;
+    }
+    if (depth > stats.depth_max) {
+        stats.depth_max = depth;
+    }
+    if (idle && stats.idle_base == 0 && settle_ms >= UI_OBJ_TRACK_SETTLE_MS) {
+        stats.idle_base = live;
+        creep_high = live + UI_OBJ_TRACK_CREEP - 1;
+    } else if (idle && stats.idle_base != 0 && live > creep_high) {
+        stats.creep++;
+        creep = true;
+        creep_high = live;              // Flag each new high once
+    }
+    idle_base = stats.idle_base;
+    portEXIT_CRITICAL(&track_lock);
+    if (creep) {
+        ESP_LOGW(TAG, "%lu objects with no popup open, %lu more than after boot", (unsigned long)live,
+                 (unsigned long)(live - idle_base));
+    }
+    if (settle_ms < UI_OBJ_TRACK_SETTLE_MS) {
+        settle_ms += UI_OBJ_TRACK_SAMPLE_MS;
+    }
+
+    log_elapsed_ms += UI_OBJ_TRACK_SAMPLE_MS;
+    if (CONFIG_GOLDIE_UI_OBJ_TRACK_LOG_S > 0 && log_elapsed_ms >= CONFIG_GOLDIE_UI_OBJ_TRACK_LOG_S * 1000U) {
+        log_elapsed_ms = 0;
+        ui_obj_track_log();
+    }
+}
+
+extern "C" void ui_obj_track_init(void)
+{
+    if (!CONFIG_GOLDIE_UI_OBJ_TRACK || check_timer != NULL) {
+        return;
+    }
+    check_timer = lv_timer_create(check_timer_cb, 0, NULL);
+    lv_timer_pause(check_timer);
+    lv_timer_create(sample_timer_cb, UI_OBJ_TRACK_SAMPLE_MS, NULL);
+    sample_timer_cb(NULL);
+    ESP_LOGI(TAG, "Object tracker on: %lu objects (log every %d s)", (unsigned long)stats.live,
+             CONFIG_GOLDIE_UI_OBJ_TRACK_LOG_S);
+}
+
+extern "C" void ui_obj_track_popup(lv_obj_t *root, const char *name)
+{
+    if (check_timer == NULL || root == NULL) {
+        return;
+    }
+    track_name_t *t = name_slot(name);
+    track_popup_t *p = NULL;
+    for (track_popup_t &slot : popups) {
+        if (slot.state == POPUP_FREE) {
+            p = &slot;
+            break;
+        }
+    }
+    if (t == NULL || p == NULL) {
+        if (p == NULL) {
+            ESP_LOGW(TAG, "%d popups tracked already - %s not tracked", UI_OBJ_TRACK_OPEN, name);
+        }
+        return;
+    }
+    p->root = root;
+    p->screen = lv_obj_get_screen(root);
+    p->name = t;
+    p->state = POPUP_OPEN;
+    p->baseline = screen_rest(p->screen);
+    t->runs++;
+    lv_obj_add_event_cb(root, popup_deleted_cb, LV_EVENT_DELETE, p);
+}
+
+extern "C" uint32_t ui_obj_track_count(const lv_obj_t *root)
+{
+    if (check_timer == NULL || root == NULL) {
+        return 0;
+    }
+    uint16_t depth = 0;
+    return count_tree(root, 0, &depth);
+}
+
+extern "C" void ui_obj_track_check(const char *name, uint32_t count)
+{
+    if (check_timer == NULL || count == 0) {
+        return;
+    }
+    track_name_t *t = name_slot(name);
+    if (t == NULL) {
+        return;
+    }
+    if (t->runs > 0 && count > t->last) {
+        t->grew++;
+        note_growth();
+        ESP_LOGW(TAG, "%s rebuilt with %lu objects more (%lu now, %u of %u rebuilds grew)", name,
+                 (unsigned long)(count - t->last), (unsigned long)count, t->grew, t->runs);
+    }
+    t->last = count;
+    if (count > t->peak) {
+        t->peak = count;
+    }
+    t->runs++;
+}
+
+extern "C" void ui_obj_track_log(void)
+{
+    lv_disp_t *disp = lv_disp_get_default();
+    if (check_timer == NULL || disp == NULL) {
+        return;
+    }
+    ui_obj_track_stats_t s;
+    ui_obj_track_get(&s);
+    for (uint32_t i = 0; i < disp->screen_cnt; i++) {
+        ESP_LOGI(TAG, "screen %lu%s: %lu objects", (unsigned long)i,
+                 disp->screens[i] == disp->act_scr ? " (active)" : "",
+                 (unsigned long)ui_obj_track_count(disp->screens[i]));
+    }
+    ESP_LOGI(TAG, "top layer %lu, sys layer %lu; %lu live, worst %lu, idle base %lu, depth %u, "
+             "%u growths, %u creep samples", (unsigned long)ui_obj_track_count(lv_disp_get_layer_top(disp)),
+             (unsigned long)ui_obj_track_count(lv_disp_get_layer_sys(disp)), (unsigned long)s.live,
+             (unsigned long)s.worst, (unsigned long)s.idle_base, s.depth_max, s.grew, s.creep);
+    for (const track_name_t &t : names) {
+        if (t.name != NULL) {
+            ESP_LOGI(TAG, "  %-12s peak %5lu objects, %u runs, %u grew", t.name, (unsigned long)t.peak, t.runs,
+                     t.grew);
+        }
+    }
+}
+
+extern "C" bool ui_obj_track_get(ui_obj_track_stats_t *out)
+{
+    if (!CONFIG_GOLDIE_UI_OBJ_TRACK) {
+        memset(out, 0, sizeof(*out));
+        return false;
+    }
+    portENTER_CRITICAL(&track_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&track_lock);
+    return true;
+}
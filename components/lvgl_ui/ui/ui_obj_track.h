@@ -0,0 +1,110 @@
+#ifndef __UI_OBJ_TRACK_H__
+#define __UI_OBJ_TRACK_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LVGL OBJECT TRACKER - LIVE OBJECTS PER SCREEN, POPUP LEAKS, WORST TREE
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Every refresh, scroll and event walks the object tree, so objects that
+// are created on each open or rebuild and never deleted make the whole UI
+// slower over time without any single step looking slow. With
+// CONFIG_GOLDIE_UI_OBJ_TRACK:
+//
+//   popups   ui_obj_track_popup() right after a popup's root is created
+//            takes its screen's object count (without the root). When the
+//            root is deleted the popup's own tree size is recorded, and on
+//            the next LVGL pass the screen is counted again: anything
+//            above the open-time count was left behind while the popup was
+//            up. The screen also holds live content (chat bubbles, a
+//            rebuilt list), so one growth is a hint; the same popup growing
+//            close after close is a leak.
+//   rebuilds ui_obj_track_check() after an in-place rebuild (the week
+//            strip's dots) compares the rebuilt tree with the previous one;
+//            a pooled rebuild must not grow.
+//   sampler  every UI_OBJ_TRACK_SAMPLE_MS each screen, the top and the
+//            system layer are counted. The largest total and deepest
+//            nesting seen are kept. The first count with no tracked popup
+//            open after UI_OBJ_TRACK_SETTLE_MS (pre-built popups are in by
+//            then) is the idle base; an idle count UI_OBJ_TRACK_CREEP or
+//            more above it is flagged as creep, once per new high.
+//
+// Growth is logged as a warning as it is seen; the per-root counts go to
+// the log every CONFIG_GOLDIE_UI_OBJ_TRACK_LOG_S. The counters are in
+// ui_obj_track_get() (soak test report).
+//
+// Counting walks the tree (a few hundred objects, well under a
+// millisecond), so it is a debug option. Without it every call returns at
+// once and the counts stay 0.
+//
+// LVGL context only, except ui_obj_track_get() (any task).
+
+#ifndef CONFIG_GOLDIE_UI_OBJ_TRACK
+#define CONFIG_GOLDIE_UI_OBJ_TRACK 0
+#endif
+#ifndef CONFIG_GOLDIE_UI_OBJ_TRACK_LOG_S
+#define CONFIG_GOLDIE_UI_OBJ_TRACK_LOG_S 300
+#endif
+
+#define UI_OBJ_TRACK_SAMPLE_MS  2000
+#define UI_OBJ_TRACK_SETTLE_MS  30000  // After init, before the idle base is taken
+#define UI_OBJ_TRACK_CREEP      16     // Idle objects above the base that are flagged
+#define UI_OBJ_TRACK_NAMES      8      // Distinct popups / rebuilds tracked
+#define UI_OBJ_TRACK_OPEN       4      // Tracked popups alive at once
+
+typedef struct {
+    uint32_t live;                  // Objects at the last sample, all roots
+    uint32_t worst;                 // Largest sampled total since boot
+    uint32_t idle_base;             // Settled total with no tracked popup open
+    uint16_t depth_max;             // Deepest nesting seen (screen = 0)
+    uint16_t grew;                  // Popup closes / rebuilds that left objects
+    uint16_t creep;                 // New idle highs flagged above idle_base
+} ui_obj_track_stats_t;
+
+/**
+ * @brief Start the sampler (once the dashboard and its panel are built)
+ */
+void ui_obj_track_init(void);
+
+/**
+ * @brief Track a popup from its creation to its deletion
+ *
+ * Call right after the root's lv_obj_create(); name must be a literal.
+ */
+void ui_obj_track_popup(lv_obj_t *root, const char *name);
+
+/**
+ * @brief Objects in root's tree, root included (0 when tracking is off)
+ */
+uint32_t ui_obj_track_count(const lv_obj_t *root);
+
+/**
+ * @brief Record a rebuilt tree's size; flags growth over the previous check
+ * @param count ui_obj_track_count() of what was rebuilt
+ */
+void ui_obj_track_check(const char *name, uint32_t count);
+
+/**
+ * @brief Log every root's count and each tracked name's peak and growths
+ */
+void ui_obj_track_log(void);
+
+/**
+ * @brief Counters since boot (any task)
+ * @return false when tracking is off
+ */
+bool ui_obj_track_get(ui_obj_track_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __UI_OBJ_TRACK_H__
@@ -0,0 +1,328 @@
+#include "ui_perf.h"
+#include "ui_fonts.h"
+#include "evt_trace.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "ui_perf";
+
+static const char *const screen_names[UI_PERF_SCREEN_COUNT] = { "animation", "ai", "panel", "calendar", "popup" };
+
+// Written from the LVGL task and the flush-ready ISR, read from any task
+static portMUX_TYPE perf_lock = portMUX_INITIALIZER_UNLOCKED;
+static ui_perf_stats_t stats[UI_PERF_SCREEN_COUNT];
+static int64_t flush_t0 = 0;                 // Band on the bus since (0 = none)
+static ui_perf_screen_t flush_screen = UI_PERF_SCREEN_ANIMATION;
+static bool running = false;
+
+// LVGL task only
+static void (*prev_render_start)(lv_disp_drv_t *drv) = NULL;
+static void (*prev_wait)(lv_disp_drv_t *drv) = NULL;
+static void (*prev_flush)(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p) = NULL;
+static void (*prev_monitor)(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px) = NULL;
+static ui_perf_screen_fn screen_fn = NULL;
+static ui_perf_screen_t cur_screen = UI_PERF_SCREEN_ANIMATION;
+static int64_t refresh_t0 = 0;
+static int64_t wait_t0 = 0;                  // Spinning on a flush since (0 = not)
+static int64_t refresh_wait_us = 0;
+static lv_obj_t *overlay = NULL;
+
+// Overlay window (totals at the previous overlay update)
+static ui_perf_stats_t window_prev;
+static int64_t window_t0 = 0;
+
+extern "C" const char *ui_perf_screen_name(ui_perf_screen_t screen)
+{
+    return screen < UI_PERF_SCREEN_COUNT ? screen_names[screen] : "?";
+}
+
+static void end_wait(int64_t now)
+{
+    if (wait_t0 != 0) {
+        EVT_TRACE_COMPLETE("lv_wait", wait_t0, (uint32_t)(now - wait_t0));
+        refresh_wait_us += now - wait_t0;
+        wait_t0 = 0;
+    }
+}
+
+static void perf_render_start(lv_disp_drv_t *drv)
+{
+    refresh_t0 = esp_timer_get_time();
+    refresh_wait_us = 0;
+    wait_t0 = 0;
+    cur_screen = ui_perf_screen();
+    EVT_TRACE_BEGIN("lv_refresh");
+    if (prev_render_start) {
+        prev_render_start(drv);
+    }
+}
+
+static void perf_wait(lv_disp_drv_t *drv)
+{
+    // Called over and over while LVGL spins; the next flush or the end of
+    // the refresh closes the wait
+    if (wait_t0 == 0) {
+        wait_t0 = esp_timer_get_time();
+    }
+    if (prev_wait) {
+        prev_wait(drv);
+    }
+}
+
+static void perf_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    int64_t now = esp_timer_get_time();
+    end_wait(now);
+    portENTER_CRITICAL(&perf_lock);
+    flush_t0 = now;
+    flush_screen = cur_screen;
+    portEXIT_CRITICAL(&perf_lock);
+    prev_flush(drv, area, color_p);
+}
+
+/**
+ * @brief Panel IO transfer done (ISR) - stands in for esp_lvgl_port's callback
+ *
+ * Also fires for the direct animation blits (panel_blit.h); those find no
+ * band in flight and are not counted.
+ */
+static bool perf_flush_ready(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&perf_lock);
+    if (flush_t0 != 0) {
+        ui_perf_stats_t *s = &stats[flush_screen];
+        uint32_t us = (uint32_t)(now - flush_t0);
+        s->flushes++;
+        s->flush_us += us;
+        if (us > s->flush_max_us) {
+            s->flush_max_us = us;
+        }
+        EVT_TRACE_COMPLETE("lcd_flush", flush_t0, us);
+        flush_t0 = 0;
+    }
+    portEXIT_CRITICAL_ISR(&perf_lock);
+    lv_disp_flush_ready((lv_disp_drv_t *)user_ctx);
+    return false;
+}
+
+static void perf_monitor(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px)
+{
+    int64_t now = esp_timer_get_time();
+    end_wait(now);
+    int64_t refresh_us = refresh_t0 != 0 ? now - refresh_t0 : (int64_t)time_ms * 1000;
+    uint32_t render_us = (uint32_t)(refresh_us > refresh_wait_us ? refresh_us - refresh_wait_us : 0);
+
+    portENTER_CRITICAL(&perf_lock);
+    ui_perf_stats_t *s = &stats[cur_screen];
+    s->refreshes++;
+    s->pixels += px;
+    s->render_us += render_us;
+    s->wait_us += (uint64_t)refresh_wait_us;
+    if (render_us > s->render_max_us) {
+        s->render_max_us = render_us;
+    }
+    if (refresh_us > UI_PERF_SLOW_US) {
+        s->slow++;
+    }
+    portEXIT_CRITICAL(&perf_lock);
+    refresh_t0 = 0;
+    EVT_TRACE_END("lv_refresh");
+
+    if (prev_monitor) {
+        prev_monitor(drv, time_ms, px);
+    }
+}
+
+/**
+ * @brief Sum of every screen's counters
+ */
+static void stats_total(ui_perf_stats_t *total)
+{
+    memset(total, 0, sizeof(*total));
+    portENTER_CRITICAL(&perf_lock);
+    for (int i = 0; i < UI_PERF_SCREEN_COUNT; i++) {
+        total->refreshes += stats[i].refreshes;
+        total->pixels += stats[i].pixels;
+        total->render_us += stats[i].render_us;
+        total->wait_us += stats[i].wait_us;
+        total->flushes += stats[i].flushes;
+        total->flush_us += stats[i].flush_us;
+    }
+    portEXIT_CRITICAL(&perf_lock);
+}
+
+/**
+ * @brief Busy share of each core since the previous call, -1 = unavailable
+ */
+static void core_load(int8_t load[2])
+{
+    load[0] = load[1] = -1;
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    static configRUN_TIME_COUNTER_TYPE prev_idle[2];
+    static configRUN_TIME_COUNTER_TYPE prev_total;
+    configRUN_TIME_COUNTER_TYPE total = portGET_RUN_TIME_COUNTER_VALUE();
+    configRUN_TIME_COUNTER_TYPE elapsed = total - prev_total;
+    for (int c = 0; c < portNUM_PROCESSORS && c < 2; c++) {
+        configRUN_TIME_COUNTER_TYPE idle = ulTaskGetRunTimeCounter(xTaskGetIdleTaskHandleForCore(c));
+        if (prev_total != 0 && elapsed != 0) {
+            uint32_t idle_pct = (uint32_t)((uint64_t)(idle - prev_idle[c]) * 100 / elapsed);
+            load[c] = (int8_t)(idle_pct > 100 ? 0 : 100 - idle_pct);
+        }
+        prev_idle[c] = idle;
+    }
+    prev_total = total;
+#endif
+}
+
+static void overlay_timer_cb(lv_timer_t *timer)
+{
+    ui_perf_stats_t now_total;
+    stats_total(&now_total);
+    int64_t now = esp_timer_get_time();
+    int64_t window_us = now - window_t0;
+    uint32_t refreshes = now_total.refreshes - window_prev.refreshes;
+    uint32_t flushes = now_total.flushes - window_prev.flushes;
+    uint32_t render_us = refreshes ? (uint32_t)((now_total.render_us - window_prev.render_us) / refreshes) : 0;
+    uint32_t flush_us = refreshes ? (uint32_t)((now_total.flush_us - window_prev.flush_us) / refreshes) : 0;
+    uint32_t fps10 = window_us > 0 ? (uint32_t)((uint64_t)refreshes * 10000000 / window_us) : 0;
+    window_prev = now_total;
+    window_t0 = now;
+
+    if (overlay == NULL) {
+        return;
+    }
+    int8_t load[2];
+    core_load(load);
+    char cpu[24] = "cpu n/a";
+    if (load[0] >= 0) {
+        snprintf(cpu, sizeof(cpu), "cpu %d/%d%%", load[0], load[1] < 0 ? 0 : load[1]);
+    }
+    lv_label_set_text_fmt(overlay, "%lu.%lu fps  r %lu.%lu  f %lu.%lu ms/%lu\n%s  %s",
+                          (unsigned long)(fps10 / 10), (unsigned long)(fps10 % 10),
+                          (unsigned long)(render_us / 1000), (unsigned long)(render_us / 100 % 10),
+                          (unsigned long)(flush_us / 1000), (unsigned long)(flush_us / 100 % 10),
+                          (unsigned long)flushes, cpu, ui_perf_screen_name(cur_screen));
+}
+
+static void log_timer_cb(lv_timer_t *timer)
+{
+    ui_perf_log();
+}
+
+extern "C" void ui_perf_overlay_show(bool show)
+{
+    if (!CONFIG_GOLDIE_UI_PERF || !running || show == (overlay != NULL)) {
+        return;
+    }
+    if (!show) {
+        lv_obj_del(overlay);
+        overlay = NULL;
+        return;
+    }
+    overlay = lv_label_create(lv_layer_sys());
+    lv_obj_set_style_text_font(overlay, ui_font(UI_FONT_12), 0);
+    lv_obj_set_style_text_color(overlay, lv_color_white(), 0);
+    lv_obj_set_style_bg_color(overlay, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(overlay, LV_OPA_70, 0);
+    lv_obj_set_style_pad_all(overlay, 3, 0);
+    lv_obj_clear_flag(overlay, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_align(overlay, LV_ALIGN_TOP_RIGHT, 0, 0);
+    lv_label_set_text(overlay, "ui_perf");
+    lv_obj_update_layout(overlay);           // Coordinates for the blit bands right away
+}
+
+extern "C" bool ui_perf_overlay_visible(void)
+{
+    return overlay != NULL;
+}
+
+extern "C" lv_obj_t *ui_perf_overlay_obj(void)
+{
+    return overlay;
+}
+
+extern "C" void ui_perf_set_screen_fn(ui_perf_screen_fn fn)
+{
+    screen_fn = fn;
+}
+
+extern "C" ui_perf_screen_t ui_perf_screen(void)
+{
+    return screen_fn ? screen_fn() : UI_PERF_SCREEN_ANIMATION;
+}
+
+extern "C" bool ui_perf_get(ui_perf_screen_t screen, ui_perf_stats_t *out)
+{
+    if (!running || screen >= UI_PERF_SCREEN_COUNT) {
+        return false;
+    }
+    portENTER_CRITICAL(&perf_lock);
+    *out = stats[screen];
+    portEXIT_CRITICAL(&perf_lock);
+    return true;
+}
+
+extern "C" void ui_perf_log(void)
+{
+    ui_perf_stats_t s;
+    for (int i = 0; i < UI_PERF_SCREEN_COUNT; i++) {
+        if (!ui_perf_get((ui_perf_screen_t)i, &s) || s.refreshes == 0) {
+            continue;
+        }
+        ESP_LOGI(TAG, "%-9s %6lu refr (%lu slow), %5lu kpx/refr, render avg %5lu max %6lu us, "
+                 "bus wait avg %5lu us, flush avg %5lu max %6lu us (%lu)",
+                 screen_names[i], (unsigned long)s.refreshes, (unsigned long)s.slow,
+                 (unsigned long)(s.pixels / s.refreshes / 1000), (unsigned long)(s.render_us / s.refreshes),
+                 (unsigned long)s.render_max_us, (unsigned long)(s.wait_us / s.refreshes),
+                 (unsigned long)(s.flushes ? s.flush_us / s.flushes : 0), (unsigned long)s.flush_max_us,
+                 (unsigned long)s.flushes);
+    }
+}
+
+extern "C" void ui_perf_init(lv_disp_t *disp, esp_lcd_panel_io_handle_t io)
+{
+    // The trace (evt_trace.h) takes its refresh and flush spans from the same hooks
+    if (!(CONFIG_GOLDIE_UI_PERF || CONFIG_GOLDIE_EVT_TRACE) || running) {
+        return;
+    }
+    if (disp == NULL || io == NULL || disp->driver->flush_cb == NULL) {
+        ESP_LOGW(TAG, "No display - UI counters off");
+        return;
+    }
+    lv_disp_drv_t *drv = disp->driver;
+
+    // Same user_ctx as esp_lvgl_port: the driver lv_disp_flush_ready() takes
+    esp_lcd_panel_io_callbacks_t cbs = {};
+    cbs.on_color_trans_done = perf_flush_ready;
+    if (esp_lcd_panel_io_register_event_callbacks(io, &cbs, drv) != ESP_OK) {
+        ESP_LOGW(TAG, "Panel IO callback not replaced - UI counters off");
+        return;
+    }
+    prev_render_start = drv->render_start_cb;
+    prev_wait = drv->wait_cb;
+    prev_flush = drv->flush_cb;
+    prev_monitor = drv->monitor_cb;
+    drv->render_start_cb = perf_render_start;
+    drv->wait_cb = perf_wait;
+    drv->flush_cb = perf_flush;
+    drv->monitor_cb = perf_monitor;
+    running = true;
+
+    if (!CONFIG_GOLDIE_UI_PERF) {
+        ESP_LOGI(TAG, "Display hooked for the event trace");
+        return;
+    }
+    window_t0 = esp_timer_get_time();
+    lv_timer_create(overlay_timer_cb, UI_PERF_OVERLAY_MS, NULL);
+    if (CONFIG_GOLDIE_UI_PERF_LOG_S > 0) {
+        lv_timer_create(log_timer_cb, CONFIG_GOLDIE_UI_PERF_LOG_S * 1000, NULL);
+    }
+    ui_perf_overlay_show(CONFIG_GOLDIE_UI_PERF_OVERLAY);
+    ESP_LOGI(TAG, "UI counters on (overlay %s, log every %d s)", CONFIG_GOLDIE_UI_PERF_OVERLAY ? "shown" : "hidden",
+             CONFIG_GOLDIE_UI_PERF_LOG_S);
+}
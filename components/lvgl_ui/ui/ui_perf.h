@@ -0,0 +1,136 @@
+#ifndef __UI_PERF_H__
+#define __UI_PERF_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl.h"
+#include "esp_lcd_panel_io.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// UI PERFORMANCE COUNTERS - RENDER / FLUSH TIME PER LOGICAL SCREEN
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// With CONFIG_GOLDIE_UI_PERF the display driver's callbacks are wrapped:
+//
+//   render_start_cb  a refresh begins; the screen it counts for is taken
+//                    from the classifier (dashboard: scroll position and
+//                    open popups)
+//   wait_cb          LVGL spins on a flush still on the bus (both draw
+//                    buffers in use) - subtracted from the render time
+//   flush_cb         a band goes to esp_lcd (async SPI DMA)
+//   on_color_trans_done  the band has left the bus: the panel IO's ISR
+//                    callback is taken over from esp_lvgl_port and calls
+//                    lv_disp_flush_ready() just as the port's does
+//   monitor_cb       the refresh is done
+//
+// Per screen: refreshes, pixels, CPU render time (refresh minus waits),
+// bus time per flush, and refreshes slower than UI_PERF_SLOW_US. A small
+// overlay on the system layer shows FPS, render and flush time, core load
+// (when FreeRTOS run time stats are enabled) and the current screen, and
+// can be toggled at run time (device API). The overlay redraws itself
+// every UI_PERF_OVERLAY_MS, which shows up as a small refresh of its own;
+// the direct animation blit leaves its rows to LVGL.
+//
+// With CONFIG_GOLDIE_EVT_TRACE the same hooks also record lv_refresh,
+// lv_wait and lcd_flush spans into the event trace (evt_trace.h), with or
+// without the counters' overlay and log.
+//
+// Without either option nothing is hooked and the queries report no data.
+//
+// LVGL context only, except ui_perf_get() (any task).
+
+#ifndef CONFIG_GOLDIE_UI_PERF
+#define CONFIG_GOLDIE_UI_PERF 0
+#endif
+#ifndef CONFIG_GOLDIE_UI_PERF_OVERLAY
+#define CONFIG_GOLDIE_UI_PERF_OVERLAY 0
+#endif
+#ifndef CONFIG_GOLDIE_UI_PERF_LOG_S
+#define CONFIG_GOLDIE_UI_PERF_LOG_S 0
+#endif
+
+#define UI_PERF_OVERLAY_MS  500
+#define UI_PERF_SLOW_US     33333      // Refresh longer than a 30 FPS frame
+
+typedef enum {
+    UI_PERF_SCREEN_ANIMATION = 0,      // Home view, animation + buttons
+    UI_PERF_SCREEN_AI,                 // AI assistant strip
+    UI_PERF_SCREEN_PANEL,              // Side panel (parameters, week strip)
+    UI_PERF_SCREEN_CALENDAR,           // Monthly calendar popup
+    UI_PERF_SCREEN_POPUP,              // Any other popup or keypad
+    UI_PERF_SCREEN_COUNT
+} ui_perf_screen_t;
+
+typedef struct {
+    uint32_t refreshes;
+    uint32_t slow;                     // Refreshes over UI_PERF_SLOW_US
+    uint64_t pixels;
+    uint64_t render_us;                // Sum; CPU time, flush waits excluded
+    uint32_t render_max_us;
+    uint64_t wait_us;                  // Sum of time blocked on the bus
+    uint32_t flushes;
+    uint64_t flush_us;                 // Sum of flush_cb to flush-ready
+    uint32_t flush_max_us;
+} ui_perf_stats_t;
+
+typedef ui_perf_screen_t (*ui_perf_screen_fn)(void);
+
+/**
+ * @brief Hook the display and its panel IO (after lv_port_init, LVGL lock held)
+ *
+ * No-op without CONFIG_GOLDIE_UI_PERF or CONFIG_GOLDIE_EVT_TRACE.
+ */
+void ui_perf_init(lv_disp_t *disp, esp_lcd_panel_io_handle_t io);
+
+/**
+ * @brief Tell the counters which logical screen is showing (default: animation)
+ */
+void ui_perf_set_screen_fn(ui_perf_screen_fn fn);
+
+/**
+ * @brief Logical screen showing now (what the classifier answers)
+ */
+ui_perf_screen_t ui_perf_screen(void);
+
+/**
+ * @brief Show or hide the overlay
+ */
+void ui_perf_overlay_show(bool show);
+
+/**
+ * @brief Overlay currently shown
+ */
+bool ui_perf_overlay_visible(void);
+
+/**
+ * @brief The overlay object while shown, else NULL (it lives on lv_layer_sys())
+ */
+lv_obj_t *ui_perf_overlay_obj(void);
+
+/**
+ * @brief Copy one screen's counters since boot
+ * @return false if the counters are not running
+ */
+bool ui_perf_get(ui_perf_screen_t screen, ui_perf_stats_t *out);
+
+/**
+ * @brief Short name of a screen ("animation", "ai", "panel", ...)
+ */
+const char *ui_perf_screen_name(ui_perf_screen_t screen);
+
+/**
+ * @brief Log one line per screen that was refreshed
+ */
+void ui_perf_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
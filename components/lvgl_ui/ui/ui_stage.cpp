@@ -0,0 +1,222 @@
+#include "ui_stage.h"
+#include "ui_arena.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "ui_stage";
+
+#ifndef CONFIG_GOLDIE_UI_FRAME_BUDGET_US
+#define CONFIG_GOLDIE_UI_FRAME_BUDGET_US 4000
+#endif
+
+static int64_t worst_stall_us = 0;
+static const char *worst_stall_name = "";
+
+// Pending stages, served head first; a stage that ran goes to the tail
+static ui_stage_t *queue_head = NULL;
+static ui_stage_t *queue_tail = NULL;
+static lv_timer_t *sched_timer = NULL;   // Paused while the queue is empty
+static uint32_t pass_count = 0;
+
+extern "C" void ui_stage_note_stall(const char *name, int64_t us)
+{
+    if (us > worst_stall_us) {
+        worst_stall_us = us;
+        worst_stall_name = name;
+    }
+    ESP_LOGD(TAG, "%s: %d us (worst %d us, %s)", name, (int)us, (int)worst_stall_us, worst_stall_name);
+}
+
+extern "C" int64_t ui_stage_worst_stall_us(void)
+{
+    return worst_stall_us;
+}
+
+static void queue_push(ui_stage_t *st)
+{
+    st->link = NULL;
+    if (queue_tail != NULL) {
+        queue_tail->link = st;
+    } else {
+        queue_head = st;
+    }
+    queue_tail = st;
+}
+
+static void queue_remove(ui_stage_t *st)
+{
+    ui_stage_t *prev = NULL;
+    for (ui_stage_t *s = queue_head; s != NULL; prev = s, s = s->link) {
+        if (s == st) {
+            if (prev != NULL) {
+                prev->link = s->link;
+            } else {
+                queue_head = s->link;
+            }
+            if (queue_tail == s) {
+                queue_tail = prev;
+            }
+            s->link = NULL;
+            return;
+        }
+    }
+}
+
+static void ui_stage_finish(ui_stage_t *st, bool completed)
+{
+    if (st->active) {
+        queue_remove(st);
+        st->active = false;
+        st->gen++;
+    }
+    if (queue_head == NULL && sched_timer != NULL) {
+        lv_timer_pause(sched_timer);
+    }
+    ui_stage_note_stall(st->name, st->longest_us);
+    if (completed) {
+        ESP_LOGI(TAG, "%s built: %u steps over %u ticks, longest stall %d ms (worst since boot %d ms)",
+                 st->name, st->count, st->ticks, (int)(st->longest_us / 1000),
+                 (int)(worst_stall_us / 1000));
+    } else {
+        ESP_LOGD(TAG, "%s build cancelled at step %u/%u", st->name, st->next, st->count);
+    }
+    st->owner = NULL;
+}
+
+/**
+ * @brief Run one step of `st` and charge its time to the current pass
+ */
+static void run_step(ui_stage_t *st)
+{
+    if (st->pass != pass_count) {
+        st->pass = pass_count;
+        st->pass_us = 0;
+        st->ticks++;
+    }
+    uint8_t gen = st->gen;
+    int64_t t0 = esp_timer_get_time();
+    ui_arena_resume(ui_arena_of(st->owner));
+    st->step(st->next++, st->user);
+    ui_arena_end(NULL);
+    if (st->gen != gen) {
+        return;                          // Restarted or cancelled by its own step
+    }
+    st->pass_us += esp_timer_get_time() - t0;
+    if (st->pass_us > st->longest_us) {
+        st->longest_us = st->pass_us;
+    }
+    if (st->next >= st->count) {
+        ui_stage_finish(st, true);
+    }
+}
+
+static void ui_stage_timer_cb(lv_timer_t *timer)
+{
+    pass_count++;
+    int64_t t0 = esp_timer_get_time();
+
+    // A step from each stage in turn: one long popup build does not hold
+    // back the small jobs queued behind it
+    do {
+        ui_stage_t *st = queue_head;
+        if (st == NULL) {
+            break;
+        }
+        queue_head = st->link;
+        if (queue_head == NULL) {
+            queue_tail = NULL;
+        }
+        queue_push(st);
+        run_step(st);
+    } while (esp_timer_get_time() - t0 < CONFIG_GOLDIE_UI_FRAME_BUDGET_US);
+}
+
+static void ui_stage_owner_deleted_cb(lv_event_t *e)
+{
+    ui_stage_t *st = (ui_stage_t *)lv_event_get_user_data(e);
+    if (st->owner == lv_event_get_target(e) && st->active) {
+        ui_stage_finish(st, false);
+    }
+}
+
+extern "C" bool ui_stage_start(ui_stage_t *st, const char *name, lv_obj_t *owner, uint16_t count,
+                               ui_stage_step_cb_t step, void *user, int64_t skeleton_us)
+{
+    ui_stage_cancel(st);
+
+    st->name = name;
+    st->owner = owner;
+    st->step = step;
+    st->user = user;
+    st->next = 0;
+    st->count = count;
+    st->ticks = 0;
+    st->pass = pass_count - 1;
+    st->pass_us = 0;
+    st->longest_us = skeleton_us;
+
+    if (count == 0) {
+        ui_stage_finish(st, true);
+        return true;
+    }
+
+    if (sched_timer == NULL) {
+        sched_timer = lv_timer_create(ui_stage_timer_cb, 0, NULL);  // Every lv_timer_handler pass
+    }
+    if (sched_timer == NULL) {
+        ESP_LOGE(TAG, "%s: no timer - running synchronously", name);
+        int64_t t0 = esp_timer_get_time();
+        ui_arena_resume(ui_arena_of(owner));
+        while (st->next < count) {
+            step(st->next++, user);
+        }
+        ui_arena_end(NULL);
+        st->longest_us += esp_timer_get_time() - t0;
+        ui_stage_finish(st, true);
+        return false;
+    }
+    st->active = true;
+    st->gen++;
+    queue_push(st);
+    lv_timer_resume(sched_timer);
+    if (owner != NULL) {
+        lv_obj_add_event_cb(owner, ui_stage_owner_deleted_cb, LV_EVENT_DELETE, st);
+    }
+    return true;
+}
+
+extern "C" void ui_stage_cancel(ui_stage_t *st)
+{
+    if (st->active) {
+        ui_stage_finish(st, false);
+    }
+}
+
+extern "C" void ui_stage_flush(ui_stage_t *st)
+{
+    if (!st->active) {
+        return;
+    }
+    uint8_t gen = st->gen;
+    int64_t t0 = esp_timer_get_time();
+    ui_arena_resume(ui_arena_of(st->owner));
+    while (st->gen == gen && st->next < st->count) {
+        st->step(st->next++, st->user);
+    }
+    ui_arena_end(NULL);
+    if (st->gen != gen) {
+        return;
+    }
+    int64_t spent = esp_timer_get_time() - t0;
+    if (spent > st->longest_us) {
+        st->longest_us = spent;
+    }
+    st->ticks++;
+    ui_stage_finish(st, true);
+}
+
+extern "C" bool ui_stage_busy(const ui_stage_t *st)
+{
+    return st->active;
+}
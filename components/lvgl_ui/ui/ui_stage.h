@@ -0,0 +1,93 @@
+#ifndef __UI_STAGE_H__
+#define __UI_STAGE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// STAGED UI WORK - SPLIT HEAVY UI WORK ACROSS LVGL TICKS, PER-FRAME BUDGET
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// A touch handler does only what must show at once (a popup's skeleton,
+// the values it read) and hands the rest to a stage: `step(i)` for
+// i = 0..count-1, run on the following ticks. One LVGL timer serves every
+// pending stage, a step from each in turn, until the pass has used
+// CONFIG_GOLDIE_UI_FRAME_BUDGET_US (at least one step per pass). LVGL
+// renders and reads touch between passes, so however much work one touch
+// queues, no frame waits for more than the budget plus one step.
+//
+// A stage may be bound to an owner object: deleting the owner (closing
+// the popup mid-build) cancels the remaining steps, and steps run in the
+// owner's popup arena, if it has one (ui_arena.h). Without an owner
+// (NULL) the steps always run to the end; work that must not be lost
+// (a save) is flushed before its stage is started again.
+//
+// Every stage reports its longest single stall; the worst since boot is
+// kept for the status log. Synchronous builders report theirs with
+// ui_stage_note_stall().
+//
+// LVGL context only.
+
+typedef void (*ui_stage_step_cb_t)(uint16_t step, void *user);
+
+typedef struct ui_stage {
+    const char *name;
+    lv_obj_t *owner;             // NULL: not cancelled by a delete, no arena
+    ui_stage_step_cb_t step;
+    void *user;
+    uint16_t next;
+    uint16_t count;
+    uint16_t ticks;              // Passes it ran in
+    bool active;
+    uint8_t gen;                 // Bumped by every start / finish
+    uint32_t pass;               // Last pass it ran in
+    int64_t pass_us;             // Its steps' time in that pass
+    int64_t longest_us;          // Longest pass share (or skeleton) of this build
+    struct ui_stage *link;       // Scheduler queue
+} ui_stage_t;
+
+/**
+ * @brief Queue `count` steps (into `owner`, or NULL) for the following ticks
+ *
+ * Cancels a build still running on the same stage first. Safe from inside
+ * another stage's step.
+ * @param skeleton_us Time the caller already spent on the skeleton
+ */
+bool ui_stage_start(ui_stage_t *st, const char *name, lv_obj_t *owner, uint16_t count,
+                    ui_stage_step_cb_t step, void *user, int64_t skeleton_us);
+
+/**
+ * @brief Stop a stage; steps not yet run are dropped
+ */
+void ui_stage_cancel(ui_stage_t *st);
+
+/**
+ * @brief Run the steps not yet run now (the result must show this frame)
+ */
+void ui_stage_flush(ui_stage_t *st);
+
+/**
+ * @brief true while steps are still pending
+ */
+bool ui_stage_busy(const ui_stage_t *st);
+
+/**
+ * @brief Record a synchronous build's stall in the since-boot maximum
+ */
+void ui_stage_note_stall(const char *name, int64_t us);
+
+/**
+ * @brief Longest single UI build stall since boot (µs)
+ */
+int64_t ui_stage_worst_stall_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,86 @@
+#include "ui_theme.h"
+#include "ui_fonts.h"
+
+static lv_style_t styles[UI_STYLE_COUNT];
+static bool ready = false;
+
+static void solid_dot(lv_style_t *s, lv_color_t color)
+{
+    lv_style_set_bg_color(s, color);
+    lv_style_set_bg_opa(s, LV_OPA_COVER);
+    lv_style_set_border_width(s, 0);
+}
+
+static void ring_dot(lv_style_t *s, lv_color_t color)
+{
+    lv_style_set_bg_opa(s, LV_OPA_TRANSP);
+    lv_style_set_border_color(s, color);
+    lv_style_set_border_width(s, 1);
+}
+
+extern "C" void ui_theme_init(void)
+{
+    if (ready) {
+        return;
+    }
+    for (int i = 0; i < UI_STYLE_COUNT; i++) {
+        lv_style_init(&styles[i]);
+    }
+
+    lv_style_set_bg_color(&styles[UI_STYLE_POPUP], lv_color_hex(0x1a1a1a));
+
+    lv_style_set_bg_color(&styles[UI_STYLE_POPUP_LOG], lv_color_hex(0x1a1a3a));
+    lv_style_set_border_width(&styles[UI_STYLE_POPUP_LOG], 2);
+
+    lv_style_set_text_font(&styles[UI_STYLE_TITLE], ui_font(UI_FONT_16));
+    lv_style_set_text_color(&styles[UI_STYLE_TITLE], lv_color_white());
+
+    lv_style_set_text_color(&styles[UI_STYLE_TEXT], lv_color_white());
+
+    lv_style_t *s = &styles[UI_STYLE_ROUND_BTN];
+    lv_style_set_radius(s, LV_RADIUS_CIRCLE);
+    lv_style_set_bg_color(s, lv_color_hex(0xFFFF00));   // Default yellow
+    lv_style_set_shadow_width(s, 10);
+    lv_style_set_shadow_spread(s, 2);
+
+    lv_style_set_text_font(&styles[UI_STYLE_ROUND_BTN_LABEL], ui_font(UI_FONT_16));
+    lv_style_set_text_color(&styles[UI_STYLE_ROUND_BTN_LABEL], lv_color_black());
+
+    s = &styles[UI_STYLE_CAL_DAY];
+    lv_style_set_bg_color(s, lv_color_hex(0x2a2a2a));
+    lv_style_set_border_color(s, lv_color_hex(0x4a4a4a));
+    lv_style_set_border_width(s, 1);
+    lv_style_set_radius(s, 3);
+    lv_style_set_shadow_width(s, 0);
+
+    s = &styles[UI_STYLE_CAL_TODAY];
+    lv_style_set_bg_color(s, lv_color_hex(0x004080));
+    lv_style_set_border_color(s, lv_palette_main(LV_PALETTE_BLUE));
+    lv_style_set_border_width(s, 2);
+
+    s = &styles[UI_STYLE_DOT];
+    lv_style_set_radius(s, LV_RADIUS_CIRCLE);
+    lv_style_set_pad_all(s, 0);
+
+    solid_dot(&styles[UI_STYLE_DOT_TEST], lv_palette_main(LV_PALETTE_LIGHT_GREEN));
+    solid_dot(&styles[UI_STYLE_DOT_WATER], lv_palette_main(LV_PALETTE_CYAN));
+    ring_dot(&styles[UI_STYLE_DOT_WATER_PLAN], lv_palette_main(LV_PALETTE_CYAN));
+    solid_dot(&styles[UI_STYLE_DOT_FEED], lv_palette_main(LV_PALETTE_RED));
+    ring_dot(&styles[UI_STYLE_DOT_FEED_PLAN], lv_palette_main(LV_PALETTE_RED));
+    ready = true;
+}
+
+extern "C" lv_style_t *ui_style(ui_style_id_t id)
+{
+    return &styles[id < UI_STYLE_COUNT ? id : UI_STYLE_TEXT];
+}
+
+extern "C" lv_obj_t *ui_theme_dot(lv_obj_t *parent, lv_coord_t size, ui_style_id_t look)
+{
+    lv_obj_t *dot = lv_obj_create(parent);
+    lv_obj_set_size(dot, size, size);
+    lv_obj_add_style(dot, &styles[UI_STYLE_DOT], 0);
+    lv_obj_add_style(dot, &styles[look], 0);
+    lv_obj_clear_flag(dot, LV_OBJ_FLAG_SCROLLABLE);
+    return dot;
+}
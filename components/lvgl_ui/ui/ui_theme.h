@@ -0,0 +1,66 @@
+#ifndef __UI_THEME_H__
+#define __UI_THEME_H__
+
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SHARED STYLES - ONE lv_style_t PER RECURRING LOOK
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// lv_obj_set_style_*() gives every object its own local style and one
+// property entry per call, allocated from the LVGL heap. The looks the
+// dashboard repeats - popups, their titles, the FEED / CLEAN buttons,
+// calendar cells and activity dots - are static styles here instead:
+// objects only hold a pointer to them (lv_obj_add_style), and a redraw
+// resolves a property from a few shared styles rather than a long local
+// list per object.
+//
+// Objects still set local styles for what is theirs alone (an accent
+// border colour, a mood tint). The styles must never be changed after
+// objects use them, or every user has to be refreshed
+// (lv_obj_report_style_change).
+//
+// LVGL context only; ui_theme_init() after ui_fonts_init().
+
+typedef enum {
+    UI_STYLE_POPUP = 0,        // Dark popup body (history, diagnostics)
+    UI_STYLE_POPUP_LOG,        // Log popup body with a 2 px border (accent colour set per popup)
+    UI_STYLE_TITLE,            // Popup title: 16 px, white
+    UI_STYLE_TEXT,             // White body text
+    UI_STYLE_ROUND_BTN,        // FEED / CLEAN circular button (colour changes with the schedule)
+    UI_STYLE_ROUND_BTN_LABEL,  // Its 16 px black label
+    UI_STYLE_CAL_DAY,          // Month calendar day cell
+    UI_STYLE_CAL_TODAY,        // Today's cell, on top of UI_STYLE_CAL_DAY
+    UI_STYLE_DOT,              // Activity dot: circle, no padding, not scrollable
+    UI_STYLE_DOT_TEST,         // Parameter test logged (solid)
+    UI_STYLE_DOT_WATER,        // Water change logged (solid)
+    UI_STYLE_DOT_WATER_PLAN,   // Water change planned (ring)
+    UI_STYLE_DOT_FEED,         // Feed logged (solid)
+    UI_STYLE_DOT_FEED_PLAN,    // Feed planned (ring)
+    UI_STYLE_COUNT
+} ui_style_id_t;
+
+/**
+ * @brief Build the styles (once, before any widget uses them)
+ */
+void ui_theme_init(void);
+
+/**
+ * @brief Shared style for lv_obj_add_style()
+ */
+lv_style_t *ui_style(ui_style_id_t id);
+
+/**
+ * @brief A dot: UI_STYLE_DOT plus one of the UI_STYLE_DOT_* looks
+ */
+lv_obj_t *ui_theme_dot(lv_obj_t *parent, lv_coord_t size, ui_style_id_t look);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
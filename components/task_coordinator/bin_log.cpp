@@ -0,0 +1,171 @@
+#include "bin_log.h"
+#include "task_layout.h"
+#include "task_monitor.h"
+#include "esp_timer.h"
+#include "esp_app_desc.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/ringbuf.h"
+#include "driver/usb_serial_jtag.h"
+#include <atomic>
+#include <string.h>
+
+static const char *TAG = "bin_log";
+
+static RingbufHandle_t ring = NULL;
+static std::atomic<uint32_t> dropped{0};      // Since boot
+
+BinLogRecord::BinLogRecord(uint8_t level, const char *tag, const char *fmt) : len_(sizeof(bin_log_hdr_t)), full_(false)
+{
+    bin_log_hdr_t *h = (bin_log_hdr_t *)buf_;
+    h->sync = BIN_LOG_SYNC;
+    h->len = 0;
+    h->level = (uint8_t)(level | (xPortGetCoreID() << 7));
+    h->reserved = 0;
+    h->time_us = (uint32_t)esp_timer_get_time();
+    h->fmt = (uint32_t)(uintptr_t)fmt;
+    h->tag = (uint32_t)(uintptr_t)tag;
+}
+
+void BinLogRecord::bytes(const void *p, size_t n)
+{
+    if (full_ || len_ + n > sizeof(buf_)) {
+        full_ = true;                           // The decoder shows the missing arguments as "?"
+        return;
+    }
+    memcpy(buf_ + len_, p, n);
+    len_ += n;
+}
+
+void BinLogRecord::str(const char *s)
+{
+    if (s == NULL) {
+        s = "(null)";
+    }
+    size_t n = strnlen(s, BIN_LOG_MAX_STR);
+    if (!full_ && len_ + 1 + n > sizeof(buf_) && len_ + 1 < sizeof(buf_)) {
+        n = sizeof(buf_) - len_ - 1;            // Cut to fit
+    }
+    uint8_t n8 = (uint8_t)n;
+    bytes(&n8, 1);
+    bytes(s, n);
+}
+
+void BinLogRecord::commit()
+{
+    ((bin_log_hdr_t *)buf_)->len = (uint8_t)(len_ - sizeof(bin_log_hdr_t));
+    bin_log_commit(buf_, len_);
+}
+
+extern "C" void bin_log_commit(const uint8_t *rec, size_t len)
+{
+    if (ring == NULL) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // Byte buffer sends copy all of it or nothing, so records never interleave
+    BaseType_t ok;
+    if (xPortInIsrContext()) {
+        BaseType_t woken = pdFALSE;
+        ok = xRingbufferSendFromISR(ring, rec, len, &woken);
+        if (woken) {
+            portYIELD_FROM_ISR();
+        }
+    } else {
+        ok = xRingbufferSend(ring, rec, len, 0);
+    }
+    if (ok != pdTRUE) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+extern "C" uint32_t bin_log_dropped(void)
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Control record straight to the port (drain task only)
+ */
+static void send_ctl(bin_log_ctl_t kind, const void *payload, size_t n)
+{
+    uint8_t rec[sizeof(bin_log_hdr_t) + 1 + 32];
+    bin_log_hdr_t *h = (bin_log_hdr_t *)rec;
+    h->sync = BIN_LOG_SYNC;
+    h->len = (uint8_t)(1 + n);
+    h->level = (uint8_t)ESP_LOG_INFO;
+    h->reserved = 0;
+    h->time_us = (uint32_t)esp_timer_get_time();
+    h->fmt = 0;
+    h->tag = 0;
+    rec[sizeof(bin_log_hdr_t)] = (uint8_t)kind;
+    memcpy(rec + sizeof(bin_log_hdr_t) + 1, payload, n);
+    usb_serial_jtag_write_bytes(rec, sizeof(bin_log_hdr_t) + 1 + n, pdMS_TO_TICKS(BIN_LOG_TX_MS));
+}
+
+static void bin_log_task(void *arg)
+{
+    bool connected = false;
+    uint32_t reported = 0;
+    while (true) {
+        if (!usb_serial_jtag_is_connected()) {
+            connected = false;                  // Records wait in the ring
+            vTaskDelay(pdMS_TO_TICKS(BIN_LOG_HOST_POLL_MS));
+            continue;
+        }
+        if (!connected) {
+            connected = true;
+            // Lets the decoder check it was given this build's ELF
+            send_ctl(BIN_LOG_CTL_START, esp_app_get_description()->app_elf_sha256, 32);
+        }
+        uint32_t lost = dropped.load(std::memory_order_relaxed);
+        if (lost != reported) {
+            uint32_t delta = lost - reported;
+            send_ctl(BIN_LOG_CTL_DROPPED, &delta, sizeof(delta));
+            reported = lost;
+        }
+
+        size_t n = 0;
+        uint8_t *data = (uint8_t *)xRingbufferReceiveUpTo(ring, &n, pdMS_TO_TICKS(BIN_LOG_HOST_POLL_MS), BIN_LOG_CHUNK);
+        if (data == NULL) {
+            continue;
+        }
+        // A short write cuts a record; the decoder resyncs on the next header
+        usb_serial_jtag_write_bytes(data, n, pdMS_TO_TICKS(BIN_LOG_TX_MS));
+        vRingbufferReturnItem(ring, data);
+    }
+}
+
+extern "C" bool bin_log_init(void)
+{
+    if (!CONFIG_GOLDIE_BIN_LOG) {
+        return false;
+    }
+    if (ring != NULL) {
+        return true;
+    }
+    usb_serial_jtag_driver_config_t usb = USB_SERIAL_JTAG_DRIVER_CONFIG_DEFAULT();
+    usb.tx_buffer_size = BIN_LOG_CHUNK * 2;
+    esp_err_t err = usb_serial_jtag_driver_install(&usb);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "USB Serial/JTAG driver failed (%s) - binary log off", esp_err_to_name(err));
+        return false;
+    }
+    ring = xRingbufferCreateWithCaps((size_t)CONFIG_GOLDIE_BIN_LOG_RING_KB * 1024, RINGBUF_TYPE_BYTEBUF,
+                                     MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (ring == NULL) {
+        ESP_LOGE(TAG, "No memory for the %d KB ring - binary log off", CONFIG_GOLDIE_BIN_LOG_RING_KB);
+        return false;
+    }
+    TaskHandle_t task = NULL;
+    if (task_layout_create(TASK_ID_BIN_LOG, bin_log_task, NULL, &task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create the drain task - binary log off");
+        vRingbufferDeleteWithCaps(ring);
+        ring = NULL;
+        return false;
+    }
+    task_monitor_register(TASK_ID_BIN_LOG, task);
+    ESP_LOGI(TAG, "Binary log on USB Serial/JTAG: %d KB ring, levels up to %d (tools/bin_log_decode.py)",
+             CONFIG_GOLDIE_BIN_LOG_RING_KB, CONFIG_GOLDIE_BIN_LOG_LEVEL);
+    return true;
+}
@@ -0,0 +1,171 @@
+#ifndef BIN_LOG_H
+#define BIN_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+/**
+ * Binary Log - printf-style records over USB Serial/JTAG, expanded on the host
+ *
+ * BLOGE / BLOGW / BLOGI / BLOGD / BLOGV take the arguments of ESP_LOGx, but
+ * nothing is formatted on the device. A record is a 16-byte header
+ *
+ *   sync 0xB7, argument bytes, level | core << 7, reserved, esp_timer µs
+ *   (low 32 bits), address of the format string, address of the tag
+ *
+ * followed by the arguments as the compiler typed them: integers, enums
+ * and pointers as 4 bytes (8 for 64-bit integers), floating point as an
+ * 8-byte double, strings as a length byte and up to BIN_LOG_MAX_STR bytes.
+ * Both strings stay in the app image's rodata; tools/bin_log_decode.py
+ * reads them from the firmware ELF and prints the line ESP_LOGx would have.
+ *
+ * Recording is a copy into a ring of CONFIG_GOLDIE_BIN_LOG_RING_KB internal
+ * RAM (any task or ISR, never blocks; a full ring drops the record and
+ * counts it). A drain task sends the ring over the USB Serial/JTAG port -
+ * the console stays on the UART - while a host has the port open, and
+ * reports dropped records in-band so the decoder can show the gap. Until a
+ * host connects the ring keeps the oldest records.
+ *
+ * Records above CONFIG_GOLDIE_BIN_LOG_LEVEL compile away. Without
+ * CONFIG_GOLDIE_BIN_LOG the macros are ESP_LOGx, so a call site reads the
+ * same either way. The format must be a string literal.
+ *
+ * Control records have format address 0; their first argument byte is a
+ * bin_log_ctl_t.
+ */
+
+#ifndef CONFIG_GOLDIE_BIN_LOG
+#define CONFIG_GOLDIE_BIN_LOG 0
+#endif
+#ifndef CONFIG_GOLDIE_BIN_LOG_RING_KB
+#define CONFIG_GOLDIE_BIN_LOG_RING_KB 8
+#endif
+#ifndef CONFIG_GOLDIE_BIN_LOG_LEVEL
+#define CONFIG_GOLDIE_BIN_LOG_LEVEL 4
+#endif
+
+#define BIN_LOG_SYNC          0xB7
+#define BIN_LOG_MAX_ARGS      64      // Argument bytes per record (more are cut)
+#define BIN_LOG_MAX_STR       32      // Bytes kept of a %s argument
+#define BIN_LOG_CHUNK         512     // Bytes handed to the USB driver at once
+#define BIN_LOG_HOST_POLL_MS  200     // Check for a host while none is connected
+#define BIN_LOG_TX_MS         50      // USB write timeout; the rest is dropped
+
+typedef struct __attribute__((packed)) {
+    uint8_t sync;                     // BIN_LOG_SYNC
+    uint8_t len;                      // Argument bytes after the header
+    uint8_t level;                    // esp_log_level_t, bit 7: core
+    uint8_t reserved;
+    uint32_t time_us;
+    uint32_t fmt;                     // Format string address, 0 = control record
+    uint32_t tag;                     // Tag string address
+} bin_log_hdr_t;
+
+typedef enum {
+    BIN_LOG_CTL_START = 1,            // + 32-byte SHA-256 of the app ELF
+    BIN_LOG_CTL_DROPPED,              // + u32 records dropped since the last one
+} bin_log_ctl_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocate the ring, install the USB Serial/JTAG driver, start draining
+ * @return false if disabled or out of memory (records are then dropped)
+ */
+bool bin_log_init(void);
+
+/**
+ * @brief Queue one encoded record (header + arguments); any task or ISR
+ */
+void bin_log_commit(const uint8_t *rec, size_t len);
+
+/**
+ * @brief Records dropped since boot (ring full or not initialised)
+ */
+uint32_t bin_log_dropped(void);
+
+#ifdef __cplusplus
+}
+
+#include <stdio.h>
+#include <type_traits>
+
+/**
+ * Builds one record on the caller's stack; the argument encoding follows
+ * the C++ type, which the decoder matches against the conversion.
+ */
+class BinLogRecord {
+public:
+    BinLogRecord(uint8_t level, const char *tag, const char *fmt);
+
+    template <typename T>
+    void put(T v)
+    {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_floating_point_v<U>) {
+            double d = (double)v;
+            bytes(&d, sizeof(d));
+        } else if constexpr (std::is_same_v<U, const char *> || std::is_same_v<U, char *>) {
+            str(v);
+        } else if constexpr (std::is_pointer_v<U> || std::is_null_pointer_v<U>) {
+            uint32_t u = (uint32_t)(uintptr_t)v;
+            bytes(&u, sizeof(u));
+        } else if constexpr (sizeof(U) <= 4) {
+            uint32_t u = (uint32_t)v;           // Sign-extended, as printf's int
+            bytes(&u, sizeof(u));
+        } else {
+            uint64_t u = (uint64_t)v;
+            bytes(&u, sizeof(u));
+        }
+    }
+
+    void commit();
+
+private:
+    void bytes(const void *p, size_t n);
+    void str(const char *s);
+
+    uint8_t buf_[sizeof(bin_log_hdr_t) + BIN_LOG_MAX_ARGS];
+    size_t len_;
+    bool full_;                         // An argument did not fit: the rest are left out
+};
+
+template <typename... Args>
+inline void bin_log_write(uint8_t level, const char *tag, const char *fmt, Args... args)
+{
+    BinLogRecord rec(level, tag, fmt);
+    (rec.put(args), ...);
+    rec.commit();
+}
+
+#if CONFIG_GOLDIE_BIN_LOG
+#define BIN_LOG_AT(level, tag, fmt, ...)                                       \
+    do {                                                                       \
+        if (false) {                                                           \
+            printf("" fmt, ##__VA_ARGS__);  /* -Wformat checks, no code */     \
+        }                                                                      \
+        if ((level) <= CONFIG_GOLDIE_BIN_LOG_LEVEL) {                          \
+            bin_log_write((level), (tag), "" fmt, ##__VA_ARGS__);              \
+        }                                                                      \
+    } while (0)
+#define BLOGE(tag, fmt, ...) BIN_LOG_AT(ESP_LOG_ERROR, tag, fmt, ##__VA_ARGS__)
+#define BLOGW(tag, fmt, ...) BIN_LOG_AT(ESP_LOG_WARN, tag, fmt, ##__VA_ARGS__)
+#define BLOGI(tag, fmt, ...) BIN_LOG_AT(ESP_LOG_INFO, tag, fmt, ##__VA_ARGS__)
+#define BLOGD(tag, fmt, ...) BIN_LOG_AT(ESP_LOG_DEBUG, tag, fmt, ##__VA_ARGS__)
+#define BLOGV(tag, fmt, ...) BIN_LOG_AT(ESP_LOG_VERBOSE, tag, fmt, ##__VA_ARGS__)
+#else
+#define BLOGE(tag, fmt, ...) ESP_LOGE(tag, fmt, ##__VA_ARGS__)
+#define BLOGW(tag, fmt, ...) ESP_LOGW(tag, fmt, ##__VA_ARGS__)
+#define BLOGI(tag, fmt, ...) ESP_LOGI(tag, fmt, ##__VA_ARGS__)
+#define BLOGD(tag, fmt, ...) ESP_LOGD(tag, fmt, ##__VA_ARGS__)
+#define BLOGV(tag, fmt, ...) ESP_LOGV(tag, fmt, ##__VA_ARGS__)
+#endif
+
+#endif // __cplusplus
+
+#endif // BIN_LOG_H
@@ -0,0 +1,242 @@
+#include "blackbox.h"
+#include "task_layout.h"
+#include "esp_sdcard_port.h"
+#include "io_sched.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if CONFIG_ESP_COREDUMP_ENABLE_TO_FLASH
+#include "esp_core_dump.h"
+#include "esp_flash.h"
+#endif
+
+static const char *TAG = "blackbox";
+
+#define BLACKBOX_MAGIC      0x58424247u   // "GBBX"
+#define BLACKBOX_NO_TASK    0xFF
+#define BLACKBOX_COPY_CHUNK 4096          // Core dump copy buffer
+
+typedef struct {
+    uint32_t ms;               // Uptime
+    uint8_t  kind;             // blackbox_kind_t, written last
+    uint8_t  task;
+    uint16_t a;
+    uint32_t b;
+    char     tag[BLACKBOX_TAG_LEN];
+} blackbox_event_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t boot;             // Counts warm boots; restarts at power-on
+    uint32_t head;             // Events ever taken; slot = head % EVENTS
+    blackbox_event_t ev[CONFIG_GOLDIE_BLACKBOX_EVENTS];
+} blackbox_ring_t;
+
+static RTC_NOINIT_ATTR blackbox_ring_t rtc_ring;
+static blackbox_ring_t *prev = NULL;          // Previous boot's ring, until flushed
+static esp_reset_reason_t prev_reason = ESP_RST_UNKNOWN;
+static bool flushed = false;
+
+static const char *kind_names[BLACKBOX_KIND_COUNT] = { "-", "BOOT", "JOB", "LATE", "MOOD", "HEAP" };
+
+/**
+ * @brief One event as a line of text, oldest-first order is the caller's
+ */
+static int format_event(char *line, size_t len, const blackbox_event_t *e)
+{
+    const char *task = e->task < TASK_ID_COUNT ? task_layout_get((task_id_t)e->task)->name : "-";
+    char tag[BLACKBOX_TAG_LEN + 1];
+    memcpy(tag, e->tag, BLACKBOX_TAG_LEN);
+    tag[BLACKBOX_TAG_LEN] = '\0';
+    int n = snprintf(line, len, "%7lu.%03lu %-4s ", (unsigned long)(e->ms / 1000),
+                     (unsigned long)(e->ms % 1000), kind_names[e->kind]);
+    if (n < 0 || (size_t)n >= len) {
+        return n;
+    }
+    switch (e->kind) {
+    case BLACKBOX_BOOT:
+        return n + snprintf(line + n, len - n, "reset reason %u, boot %lu", e->a, (unsigned long)e->b);
+    case BLACKBOX_JOB:
+        return n + snprintf(line + n, len - n, "%s/%s %lu ms (deadline %u)%s", task, tag,
+                            (unsigned long)e->b, e->a, e->b > e->a ? " LATE" : "");
+    case BLACKBOX_LATE:
+        return n + snprintf(line + n, len - n, "%s/%s still running after %lu ms (deadline %u)",
+                            task, tag, (unsigned long)e->b, e->a);
+    case BLACKBOX_MOOD:
+        return n + snprintf(line + n, len - n, "category %u -> %lu", e->a, (unsigned long)e->b);
+    case BLACKBOX_HEAP:
+        return n + snprintf(line + n, len - n, "internal %u KB, psram %lu KB (largest %lu KB)", e->a,
+                            (unsigned long)(e->b >> 16), (unsigned long)(e->b & 0xFFFF));
+    default:
+        return n;
+    }
+}
+
+/**
+ * @brief Visit the valid events of a ring, oldest first
+ */
+template <typename F>
+static void for_each_event(const blackbox_ring_t *r, uint32_t last_n, F visit)
+{
+    uint32_t count = r->head < CONFIG_GOLDIE_BLACKBOX_EVENTS ? r->head : CONFIG_GOLDIE_BLACKBOX_EVENTS;
+    if (last_n < count) {
+        count = last_n;
+    }
+    for (uint32_t seq = r->head - count; seq != r->head; seq++) {
+        const blackbox_event_t *e = &r->ev[seq % CONFIG_GOLDIE_BLACKBOX_EVENTS];
+        if (e->kind != BLACKBOX_NONE && e->kind < BLACKBOX_KIND_COUNT) {
+            visit(e);
+        }
+    }
+}
+
+void blackbox_begin(void)
+{
+    if (!CONFIG_GOLDIE_BLACKBOX) {
+        return;
+    }
+    esp_reset_reason_t reason = esp_reset_reason();
+    bool cold = reason == ESP_RST_POWERON || reason == ESP_RST_BROWNOUT || reason == ESP_RST_DEEPSLEEP;
+    uint32_t boot = 0;
+    if (!cold && rtc_ring.magic == BLACKBOX_MAGIC && rtc_ring.head > 0) {
+        boot = rtc_ring.boot + 1;
+        // Internal RAM: PSRAM may not be up yet, and the copy is gone once flushed
+        prev = (blackbox_ring_t *)heap_caps_malloc(sizeof(blackbox_ring_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (prev != NULL) {
+            *prev = rtc_ring;
+            prev_reason = reason;
+            ESP_LOGW(TAG, "Reset (reason %d) after %lu events - last ones:", (int)reason, (unsigned long)prev->head);
+            for_each_event(prev, BLACKBOX_TAIL_LOGGED, [](const blackbox_event_t *e) {
+                char line[112];
+                format_event(line, sizeof(line), e);
+                ESP_LOGW(TAG, "  %s", line);
+            });
+        }
+    }
+
+    memset(&rtc_ring, 0, sizeof(rtc_ring));
+    rtc_ring.boot = boot;
+    rtc_ring.magic = BLACKBOX_MAGIC;
+    blackbox_record(BLACKBOX_BOOT, BLACKBOX_NO_TASK, NULL, (uint16_t)reason, boot);
+}
+
+void blackbox_record(blackbox_kind_t kind, uint8_t task, const char *tag, uint16_t a, uint32_t b)
+{
+    if (!CONFIG_GOLDIE_BLACKBOX || rtc_ring.magic != BLACKBOX_MAGIC) {
+        return;
+    }
+    uint32_t seq = __atomic_fetch_add(&rtc_ring.head, 1, __ATOMIC_RELAXED);
+    blackbox_event_t *e = &rtc_ring.ev[seq % CONFIG_GOLDIE_BLACKBOX_EVENTS];
+    e->kind = BLACKBOX_NONE;
+    e->ms = (uint32_t)(esp_timer_get_time() / 1000);
+    e->task = task;
+    e->a = a;
+    e->b = b;
+    if (tag != NULL) {
+        strncpy(e->tag, tag, BLACKBOX_TAG_LEN);
+    } else {
+        e->tag[0] = '\0';
+    }
+    __atomic_store_n(&e->kind, (uint8_t)kind, __ATOMIC_RELEASE);
+}
+
+#if CONFIG_ESP_COREDUMP_ENABLE_TO_FLASH
+/**
+ * @brief Move the core dump from flash to SD (raw image, for
+ *        espcoredump.py info_corefile -t raw)
+ * @return Bytes copied, 0 without a dump
+ */
+static size_t copy_core_dump(const char *path)
+{
+    size_t addr = 0;
+    size_t size = 0;
+    if (esp_core_dump_image_check() != ESP_OK || esp_core_dump_image_get(&addr, &size) != ESP_OK || size == 0) {
+        return 0;
+    }
+    uint8_t *buf = (uint8_t *)heap_caps_malloc(BLACKBOX_COPY_CHUNK, MALLOC_CAP_DEFAULT);
+    FILE *f = buf ? fopen(path, "wb") : NULL;
+    if (f == NULL) {
+        free(buf);
+        ESP_LOGW(TAG, "Core dump (%u bytes) not copied to %s", (unsigned)size, path);
+        return 0;
+    }
+    size_t done = 0;
+    while (done < size) {
+        size_t n = size - done < BLACKBOX_COPY_CHUNK ? size - done : BLACKBOX_COPY_CHUNK;
+        // A chunk per maintenance slot on both devices (SD first, io_sched.h)
+        io_sched_begin(IO_SCHED_SD, IO_SCHED_BACKGROUND, portMAX_DELAY);
+        io_sched_begin(IO_SCHED_FLASH, IO_SCHED_BACKGROUND, portMAX_DELAY);
+        bool ok = esp_flash_read(NULL, buf, addr + done, n) == ESP_OK;
+        io_sched_end(IO_SCHED_FLASH, IO_SCHED_BACKGROUND);
+        ok = ok && fwrite(buf, 1, n, f) == n;
+        io_sched_end(IO_SCHED_SD, IO_SCHED_BACKGROUND);
+        if (!ok) {
+            break;
+        }
+        done += n;
+    }
+    fclose(f);
+    free(buf);
+    if (done != size) {
+        return 0;
+    }
+    // Copied: erase it, or the next warm reset would pair it again
+    io_sched_begin(IO_SCHED_FLASH, IO_SCHED_BACKGROUND, portMAX_DELAY);
+    esp_core_dump_image_erase();
+    io_sched_end(IO_SCHED_FLASH, IO_SCHED_BACKGROUND);
+    return size;
+}
+#endif
+
+void blackbox_flush(void)
+{
+    if (flushed || prev == NULL) {
+        return;
+    }
+    flushed = true;
+    if (!esp_sdcard_port_is_mounted()) {
+        ESP_LOGW(TAG, "No SD card - previous boot's black box dropped");
+        free(prev);
+        prev = NULL;
+        return;
+    }
+
+    char core_path[32];
+    size_t core_bytes = 0;
+#if CONFIG_ESP_COREDUMP_ENABLE_TO_FLASH
+    snprintf(core_path, sizeof(core_path), "/sdcard/core%04lu.bin", (unsigned long)(prev->boot % 10000));
+    core_bytes = copy_core_dump(core_path);
+#else
+    core_path[0] = '\0';
+#endif
+
+    io_sched_begin(IO_SCHED_SD, IO_SCHED_BACKGROUND, portMAX_DELAY);
+    FILE *f = fopen(BLACKBOX_LOG_PATH, "a");
+    if (f == NULL) {
+        ESP_LOGW(TAG, "Cannot open %s - previous boot's black box dropped", BLACKBOX_LOG_PATH);
+    } else {
+        fprintf(f, "=== boot %lu ended by reset reason %d after %lu events",
+                (unsigned long)prev->boot, (int)prev_reason, (unsigned long)prev->head);
+        if (core_bytes > 0) {
+            fprintf(f, ", core dump %s (%u bytes)", core_path, (unsigned)core_bytes);
+        }
+        fputc('\n', f);
+        for_each_event(prev, CONFIG_GOLDIE_BLACKBOX_EVENTS, [f](const blackbox_event_t *e) {
+            char line[112];
+            format_event(line, sizeof(line), e);
+            fprintf(f, "%s\n", line);
+        });
+        fclose(f);
+        ESP_LOGI(TAG, "Previous boot's black box appended to %s%s%s", BLACKBOX_LOG_PATH,
+                 core_bytes > 0 ? ", core dump in " : "", core_bytes > 0 ? core_path : "");
+    }
+    io_sched_end(IO_SCHED_SD, IO_SCHED_BACKGROUND);
+    free(prev);
+    prev = NULL;
+}
@@ -0,0 +1,86 @@
+#ifndef BLACKBOX_H
+#define BLACKBOX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Black Box - the last seconds before a reset, kept in RTC slow memory
+ *
+ * A ring of small high-level events lives in RTC_NOINIT memory, which
+ * software, panic and watchdog resets leave alone:
+ *
+ *   BOOT      reset reason of the boot that started the ring
+ *   JOB       a watched job finished (job_watch.h): frame loads, Groq /
+ *             Blynk calls, WiFi bring-up, mood evaluation... with its
+ *             time and deadline
+ *   LATE      a job still running past its deadline - the last of these
+ *             before a task watchdog reset names the stalled job
+ *   MOOD      the mood category changed
+ *   HEAP      free internal / PSRAM and the largest PSRAM block, on the
+ *             task monitor cadence (heap_watch.h)
+ *
+ * Writers take a slot with one atomic add, so any task on either core can
+ * record without a lock.
+ *
+ * blackbox_begin() (first thing in app_main) takes over what the previous
+ * boot left, logs its tail and starts a fresh ring. The SD logger worker
+ * then calls blackbox_flush(): the old ring is appended to
+ * BLACKBOX_LOG_PATH under a header with the reset reason, and with a core
+ * dump in flash (CONFIG_ESP_COREDUMP_ENABLE_TO_FLASH) the dump is copied
+ * next to it as /sdcard/coreNNNN.bin (then erased from flash), NNNN being
+ * the boot number in both.
+ * RTC_NOINIT memory is not part of the dump image; sharing the boot
+ * number is what ties the two together.
+ */
+
+#ifndef CONFIG_GOLDIE_BLACKBOX
+#define CONFIG_GOLDIE_BLACKBOX 0
+#endif
+#ifndef CONFIG_GOLDIE_BLACKBOX_EVENTS
+#define CONFIG_GOLDIE_BLACKBOX_EVENTS 128
+#endif
+
+#define BLACKBOX_LOG_PATH     "/sdcard/blackbox.log"
+#define BLACKBOX_TAIL_LOGGED  8        // Events of the old ring echoed at boot
+#define BLACKBOX_TAG_LEN      12
+
+typedef enum {
+    BLACKBOX_NONE = 0,
+    BLACKBOX_BOOT,             // a = reset reason, b = boot number
+    BLACKBOX_JOB,              // task, tag = job, a = deadline ms, b = ms taken
+    BLACKBOX_LATE,             // task, tag = job, a = deadline ms, b = ms so far
+    BLACKBOX_MOOD,             // a = old category, b = new category
+    BLACKBOX_HEAP,             // a = internal KB, b = PSRAM KB << 16 | largest PSRAM block KB
+    BLACKBOX_KIND_COUNT
+} blackbox_kind_t;
+
+/**
+ * @brief Take over the previous boot's ring and start this boot's
+ */
+void blackbox_begin(void);
+
+/**
+ * @brief Record one event (any task)
+ * @param task task_id_t, or 0xFF for none
+ * @param tag  NULL or a name, cut to BLACKBOX_TAG_LEN
+ */
+void blackbox_record(blackbox_kind_t kind, uint8_t task, const char *tag, uint16_t a, uint32_t b);
+
+/**
+ * @brief Write the previous boot's ring (and core dump) to SD, once
+ *
+ * Needs the card; a boot without one keeps nothing.
+ */
+void blackbox_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLACKBOX_H
@@ -0,0 +1,183 @@
+#include "co_exec.h"
+#include "task_layout.h"
+#include "task_monitor.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/task.h"
+#include <stdlib.h>
+
+static const char *TAG = "co_exec";
+
+static TaskHandle_t exec_task = NULL;
+static QueueHandle_t inbox = NULL;          // Spawned handles (void *)
+static CoWait *waits = NULL;                // Executor task only
+
+void CoTask::promise_type::unhandled_exception() noexcept
+{
+    abort();                                // Built without exceptions: unreachable
+}
+
+void *CoTask::promise_type::operator new(size_t size) noexcept
+{
+    return heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+void CoTask::promise_type::operator delete(void *ptr) noexcept
+{
+    heap_caps_free(ptr);
+}
+
+bool CoWait::await_suspend(std::coroutine_handle<> h) noexcept
+{
+    if (ready != nullptr && ready(this)) {
+        return false;
+    }
+    if (timeout == 0) {
+        timed_out = true;
+        return false;
+    }
+    handle = h;
+    since = xTaskGetTickCount();
+    next = waits;
+    waits = this;
+    return true;
+}
+
+bool CoBits::check(CoWait *wait)
+{
+    CoBits *w = static_cast<CoBits *>(wait);
+    EventBits_t now = xEventGroupGetBits(w->group);
+    if (w->all ? (now & w->bits) == w->bits : (now & w->bits) != 0) {
+        w->seen = now;
+        return true;
+    }
+    return false;
+}
+
+bool CoReceive::check(CoWait *wait)
+{
+    CoReceive *w = static_cast<CoReceive *>(wait);
+    return xQueueReceive(w->queue, w->out, 0) == pdTRUE;
+}
+
+bool CoSignal::Wait::check(CoWait *wait)
+{
+    return static_cast<Wait *>(wait)->signal->pending_.exchange(false, std::memory_order_acq_rel);
+}
+
+void CoSignal::give()
+{
+    pending_.store(true, std::memory_order_release);
+    co_exec_wake();
+}
+
+void CoSignal::give_from_isr(BaseType_t *woken)
+{
+    pending_.store(true, std::memory_order_release);
+    if (exec_task != NULL) {
+        vTaskNotifyGiveFromISR(exec_task, woken);
+    }
+}
+
+/**
+ * @brief Resume every wait that is ready or timed out
+ * @return Ticks until the executor must look again
+ */
+static TickType_t run_waits(void)
+{
+    // Detached first: coroutines resumed here queue their next wait on a fresh list
+    CoWait *list = waits;
+    waits = NULL;
+    TickType_t now = xTaskGetTickCount();
+    while (list != NULL) {
+        CoWait *w = list;
+        list = w->next;                     // w is gone once its coroutine resumes
+        bool ready = w->ready != nullptr && w->ready(w);
+        bool expired = !ready && w->timeout != portMAX_DELAY && now - w->since >= w->timeout;
+        if (ready || expired) {
+            w->timed_out = expired;
+            w->handle.resume();
+        } else {
+            w->next = waits;
+            waits = w;
+        }
+    }
+
+    TickType_t sleep = portMAX_DELAY;
+    now = xTaskGetTickCount();
+    for (CoWait *w = waits; w != NULL; w = w->next) {
+        if (w->timeout != portMAX_DELAY) {
+            TickType_t spent = now - w->since;
+            TickType_t left = spent >= w->timeout ? 0 : w->timeout - spent;
+            if (left < sleep) {
+                sleep = left;
+            }
+        }
+        if (w->polled && pdMS_TO_TICKS(CO_EXEC_POLL_MS) < sleep) {
+            sleep = pdMS_TO_TICKS(CO_EXEC_POLL_MS);
+        }
+    }
+    return sleep;
+}
+
+static void co_exec_loop(void *arg)
+{
+    while (true) {
+        void *spawned = NULL;
+        while (xQueueReceive(inbox, &spawned, 0) == pdTRUE) {
+            std::coroutine_handle<>::from_address(spawned).resume();
+        }
+        TickType_t sleep = run_waits();
+        if (uxQueueMessagesWaiting(inbox) == 0) {
+            ulTaskNotifyTake(pdTRUE, sleep);
+        }
+    }
+}
+
+bool co_exec_start(void)
+{
+    if (exec_task != NULL) {
+        return true;
+    }
+    inbox = xQueueCreate(CO_EXEC_SPAWN_DEPTH, sizeof(void *));
+    if (inbox == NULL) {
+        ESP_LOGE(TAG, "No memory for the spawn queue");
+        return false;
+    }
+    if (task_layout_create(TASK_ID_CO_EXEC, co_exec_loop, NULL, &exec_task) != pdPASS) {
+        exec_task = NULL;
+        vQueueDelete(inbox);
+        inbox = NULL;
+        ESP_LOGE(TAG, "Failed to create the coroutine executor");
+        return false;
+    }
+    task_monitor_register(TASK_ID_CO_EXEC, exec_task);
+    return true;
+}
+
+bool co_exec_spawn(CoTask task)
+{
+    if (!task.valid()) {
+        ESP_LOGE(TAG, "No memory for a coroutine frame");
+        return false;
+    }
+    if (exec_task == NULL) {
+        ESP_LOGE(TAG, "Spawn before co_exec_start()");
+        return false;                       // ~CoTask frees the frame
+    }
+    void *address = task.handle_.address();
+    if (xQueueSend(inbox, &address, 0) != pdTRUE) {
+        ESP_LOGE(TAG, "Spawn queue full");
+        return false;
+    }
+    task.handle_ = {};                      // The executor owns it now
+    xTaskNotifyGive(exec_task);
+    return true;
+}
+
+void co_exec_wake(void)
+{
+    if (exec_task != NULL) {
+        xTaskNotifyGive(exec_task);
+    }
+}
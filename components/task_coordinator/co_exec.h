@@ -0,0 +1,197 @@
+#ifndef CO_EXEC_H
+#define CO_EXEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <coroutine>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/event_groups.h"
+
+/**
+ * Coroutine Executor - several slow event-driven flows on one task
+ *
+ * Flows that spend nearly all their time waiting (network events, PMU
+ * interrupts, periodic re-reads) need a task each as blocking loops, and
+ * a stack each sized for the deepest call they ever make. As C++20
+ * coroutines they share one task (TASK_ID_CO_EXEC) and its stack: a
+ * suspended coroutine keeps only its frame (the locals that live across a
+ * co_await, in internal RAM), not a stack.
+ *
+ *   static CoTask power_loop()
+ *   {
+ *       while (true) {
+ *           co_await co_delay(30000);
+ *           ...
+ *       }
+ *   }
+ *   co_exec_spawn(power_loop());
+ *
+ * Awaitables: co_delay(), co_bits() (event group bits), co_receive()
+ * (queue item) and CoSignal::wait() (a flag given from a task or an ISR),
+ * each with a timeout. A signal wakes the executor at once; event bits and
+ * queues have no wake hook of their own: their producer calls
+ * co_exec_wake() after setting the bits / sending, and while a coroutine
+ * waits on one the executor also re-checks every CO_EXEC_POLL_MS for
+ * producers that do not.
+ *
+ * Cooperative: a coroutine runs until its next co_await, so anything
+ * between two suspension points (an HTTP request, an I2C read) delays
+ * every other flow. Keep those calls bounded (job_watch them under
+ * TASK_ID_CO_EXEC); long transfers belong on their own task.
+ *
+ * Coroutines only run on the executor task. co_exec_spawn() may be called
+ * from any task once co_exec_start() has run.
+ */
+
+#define CO_EXEC_SPAWN_DEPTH   4     // Spawns waiting for the executor
+#define CO_EXEC_POLL_MS       250   // Re-check of bits / queues someone waits on
+
+/**
+ * Fire-and-forget coroutine: created suspended, started by co_exec_spawn(),
+ * frame freed when it returns
+ */
+class CoTask {
+public:
+    struct promise_type {
+        CoTask get_return_object() noexcept
+        {
+            return CoTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        static CoTask get_return_object_on_allocation_failure() noexcept { return CoTask({}); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept;
+
+        // Frames come from internal RAM; NULL ends in
+        // get_return_object_on_allocation_failure()
+        static void *operator new(size_t size) noexcept;
+        static void operator delete(void *ptr) noexcept;
+    };
+
+    CoTask(CoTask &&other) noexcept : handle_(other.handle_) { other.handle_ = {}; }
+    CoTask(const CoTask &) = delete;
+    CoTask &operator=(const CoTask &) = delete;
+    ~CoTask()
+    {
+        if (handle_) {
+            handle_.destroy();      // Never spawned
+        }
+    }
+
+    bool valid() const { return (bool)handle_; }
+
+private:
+    explicit CoTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    std::coroutine_handle<promise_type> handle_;
+
+    friend bool co_exec_spawn(CoTask task);
+};
+
+/**
+ * Common part of the awaitables: lives in the suspended coroutine's frame
+ * and is linked into the executor's wait list
+ */
+struct CoWait {
+    typedef bool (*ready_fn_t)(CoWait *wait);
+
+    ready_fn_t ready;               // NULL: only the timeout ends it
+    bool polled;                    // Nothing wakes the executor when ready() turns true
+    TickType_t timeout;             // portMAX_DELAY: none
+    TickType_t since;
+    bool timed_out;
+    std::coroutine_handle<> handle;
+    CoWait *next;
+
+    CoWait(ready_fn_t ready_fn, bool is_polled, TickType_t wait_ticks)
+        : ready(ready_fn), polled(is_polled), timeout(wait_ticks), since(0), timed_out(false), handle(), next(nullptr) {}
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> h) noexcept;   // false: already ready / timed out
+};
+
+struct CoDelay : CoWait {
+    explicit CoDelay(TickType_t ticks) : CoWait(nullptr, false, ticks) {}
+    void await_resume() const noexcept {}
+};
+
+struct CoBits : CoWait {
+    EventGroupHandle_t group;
+    EventBits_t bits;
+    bool all;
+    EventBits_t seen;
+
+    CoBits(EventGroupHandle_t g, EventBits_t b, bool wait_all, TickType_t ticks)
+        : CoWait(check, true, ticks), group(g), bits(b), all(wait_all), seen(0) {}
+    // Like xEventGroupWaitBits(): the group's bits at wake-up, bits are not cleared
+    EventBits_t await_resume() noexcept { return timed_out ? xEventGroupGetBits(group) : seen; }
+
+private:
+    static bool check(CoWait *wait);
+};
+
+struct CoReceive : CoWait {
+    QueueHandle_t queue;
+    void *out;
+
+    CoReceive(QueueHandle_t q, void *item, TickType_t ticks) : CoWait(check, true, ticks), queue(q), out(item) {}
+    bool await_resume() const noexcept { return !timed_out; }
+
+private:
+    static bool check(CoWait *wait);
+};
+
+/**
+ * Wake-up flag for one waiting coroutine; give() from a task or give_from_isr()
+ * from an interrupt. Gives while nobody waits are kept (once).
+ */
+class CoSignal {
+public:
+    CoSignal() : pending_(false) {}
+    void give();
+    void give_from_isr(BaseType_t *woken);
+
+    struct Wait : CoWait {
+        CoSignal *signal;
+        Wait(CoSignal *s, TickType_t ticks) : CoWait(check, false, ticks), signal(s) {}
+        bool await_resume() const noexcept { return !timed_out; }
+
+    private:
+        static bool check(CoWait *wait);
+    };
+    // co_await sig.wait(ticks): true if given, false on timeout
+    Wait wait(TickType_t ticks) { return Wait(this, ticks); }
+
+private:
+    std::atomic<bool> pending_;
+};
+
+inline CoDelay co_delay(uint32_t ms) { return CoDelay(pdMS_TO_TICKS(ms)); }
+inline CoBits co_bits(EventGroupHandle_t group, EventBits_t bits, bool all, TickType_t ticks)
+{
+    return CoBits(group, bits, all, ticks);
+}
+inline CoReceive co_receive(QueueHandle_t queue, void *out, TickType_t ticks) { return CoReceive(queue, out, ticks); }
+
+/**
+ * @brief Create the executor task from the task layout
+ * @return false if it could not be created (co_exec_spawn() then fails)
+ */
+bool co_exec_start(void);
+
+/**
+ * @brief Hand a coroutine to the executor; it starts on the executor's next pass
+ * @return false without executor, frame memory or spawn slot (the coroutine is dropped)
+ */
+bool co_exec_spawn(CoTask task);
+
+/**
+ * @brief Re-check every wait now (after changing bits or a queue a coroutine may wait on)
+ *
+ * Any task; a no-op before co_exec_start().
+ */
+void co_exec_wake(void);
+
+#endif // CO_EXEC_H
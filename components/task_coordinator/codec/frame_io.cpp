@@ -0,0 +1,184 @@
+#include "frame_io.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "evt_trace.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "frame_io";
+
+#define FRAME_IO_ALIGN    512     // SD sector: FATFS reads whole sectors by DMA
+#define FRAME_IO_STOP_MS  1000
+
+typedef struct {
+    FILE *f;                      // NULL = exit
+    uint8_t *buf;
+    size_t len;
+    size_t got;
+} frame_io_req_t;
+
+static uint8_t *bounce[2] = { NULL, NULL };
+static TaskHandle_t reader = NULL;
+static SemaphoreHandle_t req_sem = NULL;    // Caller -> reader: req is filled
+static SemaphoreHandle_t done_sem = NULL;   // Reader -> caller: req.got is valid
+static frame_io_req_t req;
+
+static void reader_task(void *arg)
+{
+    while (true) {
+        xSemaphoreTake(req_sem, portMAX_DELAY);
+        if (req.f == NULL) {
+            break;
+        }
+        int64_t t0 = EVT_TRACE_NOW();
+        req.got = fread(req.buf, 1, req.len, req.f);
+        EVT_TRACE_COMPLETE("io_read", t0, (uint32_t)(EVT_TRACE_NOW() - t0));
+        xSemaphoreGive(done_sem);
+    }
+    xSemaphoreGive(done_sem);
+    vTaskDelete(NULL);
+}
+
+extern "C" bool frame_io_start(int core, UBaseType_t prio, uint32_t stack, TaskHandle_t *handle)
+{
+    if (handle != NULL) {
+        *handle = NULL;
+    }
+    if (req_sem == NULL) {
+        req_sem = xSemaphoreCreateBinary();
+        done_sem = xSemaphoreCreateBinary();
+        if (req_sem == NULL || done_sem == NULL) {
+            ESP_LOGE(TAG, "No memory for semaphores");
+            return false;
+        }
+    }
+    for (int i = 0; i < 2; i++) {
+        if (bounce[i] == NULL) {
+            bounce[i] = (uint8_t *)heap_caps_aligned_alloc(FRAME_IO_ALIGN, FRAME_IO_CHUNK,
+                                                           MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        }
+    }
+    if (bounce[0] == NULL || bounce[1] == NULL) {
+        ESP_LOGW(TAG, "No internal DMA memory for 2 x %u KB bounce buffers - reads are not overlapped",
+                 (unsigned)(FRAME_IO_CHUNK / 1024));
+        if (bounce[0] == NULL) {
+            bounce[0] = bounce[1];
+            bounce[1] = NULL;
+        }
+        return false;
+    }
+
+    if (reader == NULL) {
+        BaseType_t ok = xTaskCreatePinnedToCore(reader_task, "frame_io", stack, NULL, prio, &reader,
+                                                core < 0 ? tskNO_AFFINITY : core);
+        if (ok != pdPASS) {
+            reader = NULL;
+            ESP_LOGW(TAG, "Reader task not created - reads are not overlapped");
+            return false;
+        }
+    }
+    if (handle != NULL) {
+        *handle = reader;
+    }
+    ESP_LOGI(TAG, "Overlapped frame reads: 2 x %u KB internal buffers", (unsigned)(FRAME_IO_CHUNK / 1024));
+    return true;
+}
+
+extern "C" void frame_io_stop(void)
+{
+    if (reader != NULL) {
+        req.f = NULL;
+        xSemaphoreGive(req_sem);
+        if (xSemaphoreTake(done_sem, pdMS_TO_TICKS(FRAME_IO_STOP_MS)) != pdTRUE) {
+            // Still inside fread(): leaking the buffers beats freeing them under it
+            ESP_LOGE(TAG, "Reader did not stop - keeping its buffers");
+            return;
+        }
+        reader = NULL;
+    }
+    for (int i = 0; i < 2; i++) {
+        heap_caps_free(bounce[i]);
+        bounce[i] = NULL;
+    }
+}
+
+extern "C" bool frame_io_ready(void)
+{
+    return bounce[0] != NULL;
+}
+
+/**
+ * @brief Hand the next read to the reader task
+ */
+static void submit(FILE *f, uint8_t *buf, size_t len)
+{
+    req.f = f;
+    req.buf = buf;
+    req.len = len;
+    req.got = 0;
+    xSemaphoreGive(req_sem);
+}
+
+extern "C" esp_err_t frame_io_stream(FILE *f, size_t len, frame_io_consume_cb_t cb, void *ctx)
+{
+    if (bounce[0] == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (len == 0) {
+        return ESP_OK;
+    }
+
+    if (reader == NULL) {
+        // No reader task: same chunking, one buffer, no overlap
+        while (len > 0) {
+            size_t want = len < FRAME_IO_CHUNK ? len : FRAME_IO_CHUNK;
+            int64_t t0 = EVT_TRACE_NOW();
+            size_t got = fread(bounce[0], 1, want, f);
+            int64_t t1 = EVT_TRACE_NOW();
+            EVT_TRACE_COMPLETE("io_read", t0, (uint32_t)(t1 - t0));
+            bool taken = got == 0 || cb(ctx, bounce[0], got);
+            EVT_TRACE_COMPLETE("io_decode", t1, (uint32_t)(EVT_TRACE_NOW() - t1));
+            if (!taken) {
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            if (got != want) {
+                return ESP_FAIL;
+            }
+            len -= got;
+        }
+        return ESP_OK;
+    }
+
+    int cur = 0;
+    size_t pending = len < FRAME_IO_CHUNK ? len : FRAME_IO_CHUNK;   // Read in flight
+    size_t queued = pending;
+    submit(f, bounce[cur], pending);
+
+    esp_err_t ret = ESP_OK;
+    while (true) {
+        xSemaphoreTake(done_sem, portMAX_DELAY);
+        size_t got = req.got;
+        bool short_read = (got != pending);
+        bool more = !short_read && ret == ESP_OK && queued < len;
+        if (more) {
+            // Start chunk N+1 before touching chunk N
+            pending = (len - queued) < FRAME_IO_CHUNK ? (len - queued) : FRAME_IO_CHUNK;
+            queued += pending;
+            submit(f, bounce[cur ^ 1], pending);
+        }
+        if (ret == ESP_OK && got > 0) {
+            int64_t t0 = EVT_TRACE_NOW();
+            if (!cb(ctx, bounce[cur], got)) {
+                ret = ESP_ERR_INVALID_RESPONSE;   // The read in flight is still collected
+            }
+            EVT_TRACE_COMPLETE("io_decode", t0, (uint32_t)(EVT_TRACE_NOW() - t0));
+        }
+        if (ret == ESP_OK && short_read) {
+            ret = ESP_FAIL;
+        }
+        if (!more) {
+            break;
+        }
+        cur ^= 1;
+    }
+    return ret;
+}
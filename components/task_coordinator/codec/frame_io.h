@@ -0,0 +1,76 @@
+#ifndef __FRAME_IO_H__
+#define __FRAME_IO_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PIPELINED FRAME FILE READS (TWO INTERNAL BOUNCE BUFFERS)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// A reader task fills one FRAME_IO_CHUNK bounce buffer with fread() while
+// the caller (storage_task) decodes / byte-swaps the other into PSRAM:
+//
+//   reader:  [read 0][read 1][read 2][read 3]
+//   caller:          [use 0 ][use 1 ][use 2 ][use 3]
+//
+// The buffers are internal, DMA-capable and sector aligned, so SDMMC reads
+// land in them by DMA (no driver bouncing) and the reader sleeps while the
+// caller works. SPI flash reads (SPIFFS / LittleFS) keep the CPU busy and
+// overlap less, but still gain from swapping while copying to PSRAM
+// instead of a second pass over the whole frame.
+//
+// The reader should run on the caller's core one priority above it, so a
+// read starts as soon as it is submitted. One user at a time (storage_task).
+
+#ifndef CONFIG_GOLDIE_FRAME_IO_CHUNK_KB
+#define CONFIG_GOLDIE_FRAME_IO_CHUNK_KB 16
+#endif
+
+#define FRAME_IO_CHUNK  ((size_t)CONFIG_GOLDIE_FRAME_IO_CHUNK_KB * 1024)
+
+/**
+ * @brief Consume one chunk, in file order (runs while the next one is read)
+ * @return false to abort the stream
+ */
+typedef bool (*frame_io_consume_cb_t)(void *ctx, const uint8_t *data, size_t len);
+
+/**
+ * @brief Allocate the bounce buffers and start the reader task
+ * @param handle Optional, receives the reader task (for the task monitor)
+ * @return false if memory or the task is missing (frame_io_stream() then
+ *         reads synchronously through one buffer, or fails without any)
+ */
+bool frame_io_start(int core, UBaseType_t prio, uint32_t stack, TaskHandle_t *handle);
+
+/**
+ * @brief Stop the reader task and free both buffers
+ */
+void frame_io_stop(void);
+
+/**
+ * @brief Bounce buffers are allocated (the stream path is usable)
+ */
+bool frame_io_ready(void);
+
+/**
+ * @brief Read len bytes from the current position of f, chunk by chunk
+ * @return ESP_OK, ESP_FAIL on a short read, ESP_ERR_INVALID_RESPONSE if the
+ *         callback aborted, ESP_ERR_INVALID_STATE if not started
+ */
+esp_err_t frame_io_stream(FILE *f, size_t len, frame_io_consume_cb_t cb, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
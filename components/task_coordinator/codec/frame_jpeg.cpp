@@ -0,0 +1,148 @@
+#include "codec/frame_jpeg.h"
+#include "esp_camera_port.h"
+#include "esp_jpg_decode.h"
+#include "pixel_kernels.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+
+static const char *TAG = "frame_jpeg";
+
+typedef struct {
+    FILE *f;
+    uint8_t *dst;
+    uint16_t *band;            // FRAME_JPEG_MAX_MCU_ROWS full rows (internal RAM), NULL: straight to dst
+    uint16_t width;
+    uint16_t height;
+    uint16_t row_from;
+    uint16_t row_to;
+    bool swap;
+    bool bad_size;
+    bool bad_layout;
+    bool read_failed;
+    bool done;                 // Stopped below row_to on purpose
+    size_t bytes_read;
+} jpeg_job_t;
+
+static size_t jpeg_read(void *arg, size_t index, uint8_t *buf, size_t len)
+{
+    jpeg_job_t *job = (jpeg_job_t *)arg;
+    size_t got = len;
+    if (buf == NULL) {
+        // tjpgd skips the segments it has no use for
+        if (fseek(job->f, (long)len, SEEK_CUR) != 0) {
+            got = 0;
+        }
+    } else {
+        got = fread(buf, 1, len, job->f);
+    }
+    if (got == 0) {
+        job->read_failed = true;
+    }
+    job->bytes_read += got;
+    return got;
+}
+
+// One MCU block: RGB888, w * h pixels row-major. Blocks come left to right,
+// an MCU row at a time; data == NULL marks the start (image size) and end.
+static bool jpeg_write(void *arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data)
+{
+    jpeg_job_t *job = (jpeg_job_t *)arg;
+    if (data == NULL) {
+        if (x == 0 && y == 0 && (w != job->width || h != job->height)) {
+            job->bad_size = true;
+        }
+        return true;
+    }
+    if (job->bad_size) {
+        return false;
+    }
+    if (y >= job->row_to) {
+        job->done = true;
+        return false;
+    }
+    if (h > FRAME_JPEG_MAX_MCU_ROWS || x + w > job->width || y + h > job->height) {
+        job->bad_layout = true;
+        return false;
+    }
+    if (y + h <= job->row_from) {
+        return true;           // Above the range: decoded, not converted
+    }
+
+    uint16_t r0 = (uint16_t)(y < job->row_from ? job->row_from - y : 0);
+    uint16_t r1 = (uint16_t)(y + h > job->row_to ? job->row_to - y : h);
+    uint16_t *rows = job->band != NULL ? job->band : (uint16_t *)job->dst + (size_t)y * job->width;
+    for (uint16_t r = r0; r < r1; r++) {
+        pixel_rgb888_to_rgb565(rows + (size_t)r * job->width + x, data + (size_t)r * w * 3, w, job->swap);
+    }
+    if (job->band != NULL && x + w == job->width) {
+        // MCU row complete: one sequential copy into PSRAM
+        memcpy(job->dst + ((size_t)(y + r0) * job->width) * 2, job->band + (size_t)r0 * job->width,
+               (size_t)(r1 - r0) * job->width * 2);
+    }
+    return true;
+}
+
+extern "C" esp_err_t frame_jpeg_load(FILE *f, const frame_container_header_t *hdr, uint8_t *dst, bool swap,
+                                     uint16_t row_from, uint16_t row_to, frame_codec_info_t *info)
+{
+    uint32_t offsets[2];
+    if (hdr->band_count != 1) {
+        ESP_LOGE(TAG, "JPEG frame with %u bands", hdr->band_count);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    if (fread(offsets, 1, sizeof(offsets), f) != sizeof(offsets)) {
+        return ESP_FAIL;
+    }
+    if (offsets[1] <= offsets[0] || offsets[1] > hdr->payload_size) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    if (offsets[0] != 0 && fseek(f, (long)offsets[0], SEEK_CUR) != 0) {
+        return ESP_FAIL;
+    }
+
+    // A row range ends the decode through the writer, which esp_jpg_decode
+    // logs as an error: real failures are logged here
+    static bool quiet = false;
+    if (!quiet) {
+        esp_log_level_set("esp_jpg_decode", ESP_LOG_NONE);
+        quiet = true;
+    }
+
+    jpeg_job_t job = {};
+    job.f = f;
+    job.dst = dst;
+    job.width = hdr->width;
+    job.height = hdr->height;
+    job.row_from = row_from;
+    job.row_to = row_to;
+    job.swap = swap;
+    job.band = (uint16_t *)heap_caps_malloc((size_t)hdr->width * FRAME_JPEG_MAX_MCU_ROWS * 2,
+                                            MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+
+    esp_camera_port_jpeg_take();
+    esp_err_t err = esp_jpg_decode(offsets[1] - offsets[0], JPG_SCALE_NONE, jpeg_read, jpeg_write, &job);
+    esp_camera_port_jpeg_give();
+    heap_caps_free(job.band);
+
+    if (job.bad_size) {
+        ESP_LOGE(TAG, "JPEG is not %ux%u", hdr->width, hdr->height);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (err != ESP_OK && !job.done) {
+        ESP_LOGE(TAG, "JPEG frame %s after %u bytes", job.read_failed ? "read failed" : "does not decode",
+                 (unsigned)job.bytes_read);
+        return job.read_failed ? ESP_FAIL : ESP_ERR_INVALID_RESPONSE;
+    }
+    if (job.bad_layout) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    if (info != NULL) {
+        info->source = FRAME_SOURCE_CONTAINER;
+        info->encoding = hdr->encoding;
+        info->flags = hdr->flags;
+        info->bytes_read = job.bytes_read;
+    }
+    return ESP_OK;
+}
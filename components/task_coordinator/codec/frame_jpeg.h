@@ -0,0 +1,58 @@
+#ifndef __FRAME_JPEG_H__
+#define __FRAME_JPEG_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "esp_err.h"
+#include "codec/frame_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// JPEG FRAMES - BASELINE JPEG IN A GFRM CONTAINER
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// A JPEG container (FRAME_ENCODING_JPEG) is one band of the whole frame:
+// the offset table is {0, jpeg bytes} and the payload a baseline JPEG,
+// 20-40 KB where RGB565 is 300 KB. It is decoded with the ROM tjpgd
+// (esp_jpg_decode) one MCU row (8 or 16 pixel rows) at a time: each row is
+// converted to RGB565 into a band buffer in internal RAM and copied into
+// the frame buffer once complete, so PSRAM only sees whole-row writes.
+// The panel still gets the frame from its pool slot (the direct blit or
+// LVGL), which overlays, scrolling and partial redraws need.
+//
+// A row range stops the decode after the MCU row holding the last wanted
+// row; the rows above it have to be decoded (a JPEG is one entropy coded
+// stream), only their conversion is skipped.
+//
+// The decoder's work buffer is static: calls hold
+// esp_camera_port_jpeg_take() against the camera preview.
+
+#define FRAME_JPEG_MAX_MCU_ROWS   16      // 4:2:0 subsampling; 4:4:4 / 4:2:2 use 8
+
+/**
+ * @brief Decode the JPEG payload of a container into `dst`
+ *
+ * @param f        Positioned right after the container header
+ * @param hdr      Header, encoding FRAME_ENCODING_JPEG
+ * @param dst      Full-frame buffer (hdr->width * hdr->height * 2 bytes)
+ * @param swap     Panel byte order (LV_COLOR_16_SWAP) instead of native
+ * @param row_from First row wanted
+ * @param row_to   Row after the last wanted; exactly these rows are written
+ * @param info     Optional, filled on success
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE if the JPEG is not the header's
+ *         size, ESP_ERR_INVALID_RESPONSE if it does not decode, ESP_FAIL
+ *         on read errors
+ */
+esp_err_t frame_jpeg_load(FILE *f, const frame_container_header_t *hdr, uint8_t *dst, bool swap,
+                          uint16_t row_from, uint16_t row_to, frame_codec_info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
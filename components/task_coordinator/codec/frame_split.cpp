@@ -0,0 +1,203 @@
+#include "frame_split.h"
+#include "job_pool.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "evt_trace.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "frame_split";
+
+#define SPLIT_ACTIVE    0x80000000u   // state: a frame is open to the helper;
+                                      // the low bits count helper entries
+
+typedef struct {
+    uint16_t band_count;
+    const uint32_t *ends;
+    frame_split_band_cb_t cb;
+    void *ctx;
+    size_t avail;                     // Payload bytes present (release / acquire)
+    bool failed;
+    uint16_t next_own;                // Caller: next even band to try
+} split_job_t;
+
+static bool started = false;
+static SemaphoreHandle_t idle_sem = NULL;   // Helper -> caller: left a closed frame
+static bool helper_queued = false;          // A helper job waits in the pool
+static uint32_t state = 0;
+static split_job_t job;
+static uint8_t *claim = NULL;               // One byte per band: 1 = taken
+static uint16_t claim_len = 0;
+static uint8_t *payload = NULL;             // PSRAM
+static size_t payload_len = 0;
+
+static bool take_band(uint16_t b)
+{
+    return __atomic_exchange_n(&claim[b], 1, __ATOMIC_ACQ_REL) == 0;
+}
+
+static void run_band(uint16_t b)
+{
+    size_t start = b == 0 ? 0 : job.ends[b - 1];
+    if (__atomic_load_n(&job.failed, __ATOMIC_RELAXED) ||
+        !job.cb(job.ctx, b, payload + start, job.ends[b] - start)) {
+        __atomic_store_n(&job.failed, true, __ATOMIC_RELAXED);
+    }
+}
+
+static bool helper_enter(void)
+{
+    uint32_t s = __atomic_load_n(&state, __ATOMIC_ACQUIRE);
+    do {
+        if (!(s & SPLIT_ACTIVE)) {
+            return false;
+        }
+    } while (!__atomic_compare_exchange_n(&state, &s, s + 1, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+    return true;
+}
+
+static void helper_leave(void)
+{
+    if (__atomic_sub_fetch(&state, 1, __ATOMIC_ACQ_REL) == 0) {
+        xSemaphoreGive(idle_sem);             // The caller closed the frame meanwhile
+    }
+}
+
+// One pass over the odd bands present; a feed with more data queues the next
+static void helper_job(void *arg)
+{
+    // Cleared first: a feed from here on queues another pass
+    __atomic_store_n(&helper_queued, false, __ATOMIC_RELEASE);
+    if (!helper_enter()) {
+        return;                               // Queued for a frame already finished
+    }
+    for (uint16_t b = 1; b < job.band_count; b += 2) {
+        if (__atomic_load_n(&claim[b], __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+        if (__atomic_load_n(&job.avail, __ATOMIC_ACQUIRE) < job.ends[b]) {
+            break;                            // The next feed queues us again
+        }
+        if (take_band(b)) {
+            int64_t t0 = EVT_TRACE_NOW();
+            run_band(b);
+            EVT_TRACE_COMPLETE("split_band", t0, (uint32_t)(EVT_TRACE_NOW() - t0));
+        }
+    }
+    helper_leave();
+}
+
+static void queue_helper(void)
+{
+    if (__atomic_exchange_n(&helper_queued, true, __ATOMIC_ACQ_REL)) {
+        return;
+    }
+    // Preferably on the core the caller is not on; either worker may take it
+    if (!job_pool_submit(helper_job, NULL, JOB_POOL_HIGH, 1 - (int)xPortGetCoreID())) {
+        __atomic_store_n(&helper_queued, false, __ATOMIC_RELEASE);   // Pool full: the caller finishes alone
+    }
+}
+
+extern "C" bool frame_split_start(void)
+{
+    if (idle_sem == NULL) {
+        idle_sem = xSemaphoreCreateBinary();
+        if (idle_sem == NULL) {
+            ESP_LOGE(TAG, "No memory for semaphore");
+            return false;
+        }
+    }
+    if (!job_pool_ready()) {
+        ESP_LOGW(TAG, "No job pool - frames decode on one core");
+        return false;
+    }
+    started = true;
+    ESP_LOGI(TAG, "Two-core band decode through the job pool");
+    return true;
+}
+
+extern "C" void frame_split_stop(void)
+{
+    // Only called between frames: a helper job still queued finds the frame
+    // closed and leaves without touching the buffers
+    started = false;
+    heap_caps_free(payload);
+    payload = NULL;
+    payload_len = 0;
+    heap_caps_free(claim);
+    claim = NULL;
+    claim_len = 0;
+}
+
+extern "C" bool frame_split_ready(void)
+{
+    return started && job_pool_ready();
+}
+
+extern "C" uint8_t *frame_split_begin(uint16_t band_count, const uint32_t *ends, frame_split_band_cb_t cb,
+                                      void *ctx)
+{
+    if (!frame_split_ready() || band_count == 0) {
+        return NULL;
+    }
+    size_t need = ends[band_count - 1];
+    if (need > payload_len) {
+        // Grown to the largest frame seen; the old contents do not matter
+        heap_caps_free(payload);
+        payload = (uint8_t *)heap_caps_malloc(need, MALLOC_CAP_SPIRAM);
+        payload_len = payload != NULL ? need : 0;
+    }
+    if (band_count > claim_len) {
+        heap_caps_free(claim);
+        claim = (uint8_t *)heap_caps_malloc(band_count, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        claim_len = claim != NULL ? band_count : 0;
+    }
+    if (payload == NULL || claim == NULL) {
+        return NULL;
+    }
+    for (uint16_t b = 0; b < band_count; b++) {
+        claim[b] = 0;
+    }
+    job.band_count = band_count;
+    job.ends = ends;
+    job.cb = cb;
+    job.ctx = ctx;
+    job.avail = 0;
+    job.failed = false;
+    job.next_own = 0;
+    __atomic_store_n(&state, SPLIT_ACTIVE, __ATOMIC_RELEASE);
+    return payload;
+}
+
+extern "C" bool frame_split_feed(size_t avail)
+{
+    __atomic_store_n(&job.avail, avail, __ATOMIC_RELEASE);
+    queue_helper();
+    while (job.next_own < job.band_count && job.ends[job.next_own] <= avail) {
+        if (take_band(job.next_own)) {
+            run_band(job.next_own);
+        }
+        job.next_own += 2;
+    }
+    return !__atomic_load_n(&job.failed, __ATOMIC_RELAXED);
+}
+
+extern "C" esp_err_t frame_split_finish(size_t avail)
+{
+    __atomic_store_n(&job.avail, avail, __ATOMIC_RELEASE);
+    // Everything the helper has not started, in either half, is ours now
+    for (uint16_t b = 0; b < job.band_count; b++) {
+        if (take_band(b)) {
+            if (job.ends[b] <= avail) {
+                run_band(b);
+            } else {
+                __atomic_store_n(&job.failed, true, __ATOMIC_RELAXED);
+            }
+        }
+    }
+    uint32_t s = __atomic_fetch_and(&state, ~SPLIT_ACTIVE, __ATOMIC_ACQ_REL);
+    if ((s & ~SPLIT_ACTIVE) != 0) {
+        // The helper is inside its last band: its pixels are ours after this
+        xSemaphoreTake(idle_sem, portMAX_DELAY);
+    }
+    return __atomic_load_n(&job.failed, __ATOMIC_ACQUIRE) ? ESP_ERR_INVALID_RESPONSE : ESP_OK;
+}
@@ -0,0 +1,85 @@
+#ifndef __FRAME_SPLIT_H__
+#define __FRAME_SPLIT_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// TWO-CORE BAND DECODE (RLE16 / INDEXED8 CONTAINERS)
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// GFRM bands are independent RLE streams, so one frame can be decoded by two
+// cores. The caller (storage_task, Core 1) copies the payload into a PSRAM
+// buffer as frame_io delivers it and decodes the even bands as they arrive;
+// a helper job in the job pool (task_coordinator/job_pool.h), queued for the
+// other core, decodes the odd ones:
+//
+//   reader:  [read 0][read 1][read 2][read 3]
+//   caller:          [b0 b2 ][b4    ][b6 b8 ][...]
+//   helper:            [b1 b3 ][b5 b7 ][...]
+//
+// Each feed queues one helper pass over the odd bands present (at most one
+// waits in the pool). The workers run below LVGL, so the helper only takes
+// time the UI leaves; when Core 0 is busy, the Core 1 worker may steal the
+// pass while storage_task waits for the reader. When it falls behind, frame_split_finish() has
+// the caller claim every band the helper has not started; the caller then
+// waits at most for the band the helper is decoding.
+//
+// One user at a time (storage_task), like frame_io.
+
+/**
+ * @brief Decode one band from the payload buffer
+ * @return false if the band is corrupt
+ */
+typedef bool (*frame_split_band_cb_t)(void *ctx, uint16_t band, const uint8_t *src, size_t len);
+
+/**
+ * @brief Enable two-core decode (after job_pool_start())
+ * @return false without the job pool (frame_split_ready() stays false)
+ */
+bool frame_split_start(void);
+
+/**
+ * @brief Disable two-core decode and free the payload buffer (between frames)
+ */
+void frame_split_stop(void);
+
+/**
+ * @brief Started and the job pool is running (frame_split_begin() is usable)
+ */
+bool frame_split_ready(void);
+
+/**
+ * @brief Start a frame: bands [ends[b - 1], ends[b]) of the payload buffer
+ * @param ends  Payload offset where each band ends (band_count entries,
+ *              ascending); must stay valid until frame_split_finish()
+ * @return The PSRAM payload buffer (at least ends[band_count - 1] bytes),
+ *         NULL without memory or helper (decode serially)
+ */
+uint8_t *frame_split_begin(uint16_t band_count, const uint32_t *ends, frame_split_band_cb_t cb, void *ctx);
+
+/**
+ * @brief Payload bytes [0, avail) are in the buffer: decode the caller's
+ *        bands that are complete and queue the helper for its own
+ * @return false once any band has failed
+ */
+bool frame_split_feed(size_t avail);
+
+/**
+ * @brief Decode what is left on the caller and wait for the helper
+ * @param avail Payload bytes present; bands past it count as failed
+ * @return ESP_OK, or ESP_ERR_INVALID_RESPONSE if a band failed or was missing
+ */
+esp_err_t frame_split_finish(size_t avail);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
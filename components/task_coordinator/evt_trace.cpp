@@ -0,0 +1,234 @@
+#include "evt_trace.h"
+#include "esp_sdcard_port.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_cpu.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "evt_trace";
+
+#define TID_ISR    0xFE
+#define TID_OTHER  0xFF            // Task table full
+#define TRACE_PID  1
+
+typedef struct {
+    uint32_t ts;                   // esp_timer µs, low 32 bits
+    const char *name;
+    uint32_t arg;
+    uint8_t ph;
+    uint8_t tid;
+    uint8_t core;
+    uint8_t reserved;
+} evt_t;
+
+static_assert(sizeof(evt_t) == 16, "trace events should stay 16 bytes");
+
+typedef struct {
+    TaskHandle_t handle;
+    char name[configMAX_TASK_NAME_LEN];
+} evt_task_t;
+
+static evt_t *ring = NULL;
+static std::atomic<uint32_t> head(0);          // Events ever recorded
+static std::atomic<bool> recording(false);
+static evt_task_t tasks[EVT_TRACE_MAX_TASKS];
+static std::atomic<uint32_t> task_count(0);
+static portMUX_TYPE task_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Small id of the calling task, named on first use
+ */
+static uint8_t current_tid(void)
+{
+    if (xPortInIsrContext()) {
+        return TID_ISR;
+    }
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    uint32_t n = task_count.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < n; i++) {
+        if (tasks[i].handle == self) {
+            return (uint8_t)i;
+        }
+    }
+
+    uint8_t tid = TID_OTHER;
+    portENTER_CRITICAL(&task_lock);
+    n = task_count.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < n && tid == TID_OTHER; i++) {
+        if (tasks[i].handle == self) {
+            tid = (uint8_t)i;
+        }
+    }
+    if (tid == TID_OTHER && n < EVT_TRACE_MAX_TASKS) {
+        tasks[n].handle = self;
+        strncpy(tasks[n].name, pcTaskGetName(self), sizeof(tasks[n].name) - 1);
+        task_count.store(n + 1, std::memory_order_release);
+        tid = (uint8_t)n;
+    }
+    portEXIT_CRITICAL(&task_lock);
+    return tid;
+}
+
+static void put(const char *name, evt_trace_phase_t ph, uint32_t ts, uint32_t arg)
+{
+    if (!recording.load(std::memory_order_relaxed)) {
+        return;
+    }
+    evt_t *e = &ring[head.fetch_add(1, std::memory_order_relaxed) % CONFIG_GOLDIE_EVT_TRACE_EVENTS];
+    e->ts = ts;
+    e->name = name;
+    e->arg = arg;
+    e->ph = (uint8_t)ph;
+    e->tid = current_tid();
+    e->core = (uint8_t)esp_cpu_get_core_id();
+}
+
+void evt_trace_record(const char *name, evt_trace_phase_t ph, uint32_t arg)
+{
+    put(name, ph, (uint32_t)esp_timer_get_time(), arg);
+}
+
+void evt_trace_complete(const char *name, int64_t start_us, uint32_t dur_us)
+{
+    put(name, EVT_TRACE_PH_COMPLETE, (uint32_t)start_us, dur_us);
+}
+
+/**
+ * @brief µs as decimal without 64-bit printf support
+ */
+static int format_us(char *buf, size_t len, uint64_t us)
+{
+    uint32_t s = (uint32_t)(us / 1000000);
+    uint32_t frac = (uint32_t)(us % 1000000);
+    return s ? snprintf(buf, len, "%lu%06lu", (unsigned long)s, (unsigned long)frac)
+             : snprintf(buf, len, "%lu", (unsigned long)frac);
+}
+
+static int format_event(char *line, size_t len, const evt_t *e, uint64_t ts, bool first)
+{
+    char ts_text[24];
+    format_us(ts_text, sizeof(ts_text), ts);
+    const char *sep = first ? "" : ",\n";
+    int tid = e->tid == TID_ISR ? EVT_TRACE_MAX_TASKS : e->tid == TID_OTHER ? EVT_TRACE_MAX_TASKS + 1 : e->tid;
+
+    switch (e->ph) {
+    case EVT_TRACE_PH_COUNTER:
+        return snprintf(line, len, "%s{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%s,\"pid\":%d,\"args\":{\"value\":%lu}}",
+                        sep, e->name, ts_text, TRACE_PID, (unsigned long)e->arg);
+    case EVT_TRACE_PH_INSTANT:
+        return snprintf(line, len, "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%s,\"pid\":%d,\"tid\":%d,"
+                        "\"args\":{\"v\":%lu,\"core\":%u}}",
+                        sep, e->name, ts_text, TRACE_PID, tid, (unsigned long)e->arg, e->core);
+    case EVT_TRACE_PH_COMPLETE:
+        return snprintf(line, len, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%s,\"dur\":%lu,\"pid\":%d,\"tid\":%d,"
+                        "\"args\":{\"core\":%u}}",
+                        sep, e->name, ts_text, (unsigned long)e->arg, TRACE_PID, tid, e->core);
+    default:
+        return snprintf(line, len, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%s,\"pid\":%d,\"tid\":%d,"
+                        "\"args\":{\"core\":%u}}",
+                        sep, e->name, e->ph, ts_text, TRACE_PID, tid, e->core);
+    }
+}
+
+bool evt_trace_dump(evt_trace_write_fn write, void *ctx)
+{
+    if (ring == NULL) {
+        return false;
+    }
+    recording.store(false);
+    vTaskDelay(pdMS_TO_TICKS(10));             // Let writers that already passed the check finish
+
+    uint32_t end = head.load();
+    uint32_t count = end < CONFIG_GOLDIE_EVT_TRACE_EVENTS ? end : CONFIG_GOLDIE_EVT_TRACE_EVENTS;
+    char line[224];
+    bool ok = write(ctx, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", 40);
+
+    // Track names first (metadata events)
+    bool first = true;
+    uint32_t n = task_count.load();
+    for (uint32_t i = 0; ok && i < n + 2; i++) {
+        const char *name = i < n ? tasks[i].name : i == n ? "isr" : "other";
+        int tid = i < n ? (int)i : EVT_TRACE_MAX_TASKS + (int)(i - n);
+        int len = snprintf(line, sizeof(line), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+                           "\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", TRACE_PID, tid, name);
+        ok = write(ctx, line, (size_t)len);
+        first = false;
+    }
+
+    // Unwrap the 32-bit timestamps in ring order (cores may be a few µs out of order)
+    uint64_t epoch = 0;
+    uint32_t prev = 0;
+    for (uint32_t i = end - count; ok && i != end; i++) {
+        const evt_t *e = &ring[i % CONFIG_GOLDIE_EVT_TRACE_EVENTS];
+        if (e->name == NULL) {
+            continue;
+        }
+        if (i != end - count && e->ts < prev && prev - e->ts > 0x80000000u) {
+            epoch += 0x100000000ull;
+        }
+        prev = e->ts;
+        int len = format_event(line, sizeof(line), e, epoch + e->ts, false);
+        if (len > 0) {
+            ok = write(ctx, line, (size_t)len < sizeof(line) ? (size_t)len : sizeof(line) - 1);
+        }
+    }
+    if (ok) {
+        ok = write(ctx, "\n]}\n", 4);
+    }
+
+    recording.store(true);
+    ESP_LOGI(TAG, "Dumped %lu events (%lu recorded since start)%s", (unsigned long)count, (unsigned long)end,
+             ok ? "" : " - sink failed");
+    return ok;
+}
+
+static bool write_file(void *ctx, const char *data, size_t len)
+{
+    return fwrite(data, 1, len, (FILE *)ctx) == len;
+}
+
+/**
+ * @brief One dump CONFIG_GOLDIE_EVT_TRACE_DUMP_S after start, to SD or serial
+ */
+static void dump_task(void *arg)
+{
+    vTaskDelay(pdMS_TO_TICKS((uint32_t)CONFIG_GOLDIE_EVT_TRACE_DUMP_S * 1000));
+    FILE *f = esp_sdcard_port_is_mounted() ? fopen(EVT_TRACE_DUMP_PATH, "w") : NULL;
+    if (f != NULL) {
+        evt_trace_dump(write_file, f);
+        fclose(f);
+        ESP_LOGI(TAG, "Trace written to %s", EVT_TRACE_DUMP_PATH);
+    } else {
+        ESP_LOGI(TAG, "No SD card - trace JSON follows on the console");
+        printf("\n=== EVT TRACE BEGIN ===\n");
+        evt_trace_dump(write_file, stdout);
+        printf("=== EVT TRACE END ===\n");
+        fflush(stdout);
+    }
+    vTaskDelete(NULL);
+}
+
+void evt_trace_init(void)
+{
+    if (!CONFIG_GOLDIE_EVT_TRACE || ring != NULL) {
+        return;
+    }
+    ring = (evt_t *)heap_caps_calloc(CONFIG_GOLDIE_EVT_TRACE_EVENTS, sizeof(evt_t), MALLOC_CAP_SPIRAM);
+    if (ring == NULL) {
+        ESP_LOGW(TAG, "No PSRAM for %d trace events - tracing off", CONFIG_GOLDIE_EVT_TRACE_EVENTS);
+        return;
+    }
+    recording.store(true);
+    ESP_LOGI(TAG, "Tracing into %d events (%d KB PSRAM)", CONFIG_GOLDIE_EVT_TRACE_EVENTS,
+             (int)(CONFIG_GOLDIE_EVT_TRACE_EVENTS * sizeof(evt_t) / 1024));
+
+    if (CONFIG_GOLDIE_EVT_TRACE_DUMP_S > 0 &&
+        xTaskCreate(dump_task, "evt_dump", EVT_TRACE_DUMP_STACK, NULL, 1, NULL) != pdPASS) {
+        ESP_LOGW(TAG, "No dump task - use GET /api/trace");
+    }
+}
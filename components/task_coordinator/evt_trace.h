@@ -0,0 +1,114 @@
+#ifndef EVT_TRACE_H
+#define EVT_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Event Trace - cross-core timeline in Chrome / Perfetto trace format
+ *
+ * A PSRAM ring of CONFIG_GOLDIE_EVT_TRACE_EVENTS fixed 16-byte events
+ * (µs timestamp, static name, phase, task, core, one argument). Recording
+ * is one atomic index bump and a store, from any task or ISR; the oldest
+ * events are overwritten.
+ *
+ *   EVT_TRACE_BEGIN / END    span on the calling task (must nest per task)
+ *   EVT_TRACE_INSTANT        point event with a value (queue send/receive,
+ *                            touch)
+ *   EVT_TRACE_COUNTER        process-wide counter track
+ *   EVT_TRACE_COMPLETE       span with an explicit start, e.g. closed from
+ *                            an ISR (LCD flush); take the start with
+ *                            EVT_TRACE_NOW(), which is 0 when tracing is off
+ *
+ * Instrumented: every coordinator job (job_watch.h: frame loads, mood
+ * evaluation, Groq and Blynk HTTP calls), frame_io reads and decodes,
+ * msg_bus publish / receive, the animation frame request / ready queues,
+ * LVGL refreshes and LCD flushes (ui_perf.h) and touch press / release.
+ *
+ * evt_trace_dump() writes the ring as Trace Event Format JSON, which
+ * ui.perfetto.dev and chrome://tracing open directly. Recording pauses
+ * while dumping. The dump goes to:
+ *   - /sdcard/trace.json (or the serial console without a card) once,
+ *     CONFIG_GOLDIE_EVT_TRACE_DUMP_S after start
+ *   - GET /api/trace on the device API, any time
+ *
+ * Without CONFIG_GOLDIE_EVT_TRACE the macros compile to nothing.
+ */
+
+#ifndef CONFIG_GOLDIE_EVT_TRACE
+#define CONFIG_GOLDIE_EVT_TRACE 0
+#endif
+#ifndef CONFIG_GOLDIE_EVT_TRACE_EVENTS
+#define CONFIG_GOLDIE_EVT_TRACE_EVENTS 8192
+#endif
+#ifndef CONFIG_GOLDIE_EVT_TRACE_DUMP_S
+#define CONFIG_GOLDIE_EVT_TRACE_DUMP_S 0
+#endif
+
+#define EVT_TRACE_MAX_TASKS   32        // Distinct tasks named in a dump
+#define EVT_TRACE_DUMP_PATH   "/sdcard/trace.json"
+#define EVT_TRACE_DUMP_STACK  4096
+
+typedef enum {
+    EVT_TRACE_PH_BEGIN = 'B',
+    EVT_TRACE_PH_END = 'E',
+    EVT_TRACE_PH_INSTANT = 'i',
+    EVT_TRACE_PH_COUNTER = 'C',
+    EVT_TRACE_PH_COMPLETE = 'X',
+} evt_trace_phase_t;
+
+/**
+ * @brief Sink for evt_trace_dump() (false = stop writing)
+ */
+typedef bool (*evt_trace_write_fn)(void *ctx, const char *data, size_t len);
+
+/**
+ * @brief Allocate the ring and start recording (no-op if disabled)
+ */
+void evt_trace_init(void);
+
+/**
+ * @brief Record one event; `name` must be a static string
+ * @param arg Instant / counter value, or the duration in µs of a COMPLETE event
+ */
+void evt_trace_record(const char *name, evt_trace_phase_t ph, uint32_t arg);
+
+/**
+ * @brief Record a span that started at start_us (esp_timer time), ISR-safe
+ */
+void evt_trace_complete(const char *name, int64_t start_us, uint32_t dur_us);
+
+/**
+ * @brief Write the ring as Trace Event Format JSON, oldest event first
+ * @return false if the sink failed or tracing is off
+ */
+bool evt_trace_dump(evt_trace_write_fn write, void *ctx);
+
+#if CONFIG_GOLDIE_EVT_TRACE
+#include "esp_timer.h"
+#define EVT_TRACE_NOW()                  esp_timer_get_time()
+#define EVT_TRACE_BEGIN(name)            evt_trace_record((name), EVT_TRACE_PH_BEGIN, 0)
+#define EVT_TRACE_END(name)              evt_trace_record((name), EVT_TRACE_PH_END, 0)
+#define EVT_TRACE_INSTANT(name, v)       evt_trace_record((name), EVT_TRACE_PH_INSTANT, (uint32_t)(v))
+#define EVT_TRACE_COUNTER(name, v)       evt_trace_record((name), EVT_TRACE_PH_COUNTER, (uint32_t)(v))
+#define EVT_TRACE_COMPLETE(name, t0, d)  evt_trace_complete((name), (t0), (d))
+#else
+#define EVT_TRACE_NOW()                  ((int64_t)0)
+#define EVT_TRACE_BEGIN(name)            ((void)0)
+#define EVT_TRACE_END(name)              ((void)0)
+#define EVT_TRACE_INSTANT(name, v)       ((void)0)
+#define EVT_TRACE_COUNTER(name, v)       ((void)0)
+#define EVT_TRACE_COMPLETE(name, t0, d)  ((void)sizeof((t0) + (d)))   // Keeps t0 "used", evaluates nothing
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EVT_TRACE_H
@@ -0,0 +1,232 @@
+#include "heap_watch.h"
+#include "blackbox.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#if CONFIG_HEAP_TRACING_STANDALONE
+#include "esp_heap_trace.h"
+#include "time_svc.h"
+#endif
+
+static const char *TAG = "heap_watch";
+
+static const uint32_t region_caps[HEAP_WATCH_REGION_COUNT] = {
+    MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT,
+    MALLOC_CAP_SPIRAM,
+};
+static const char *const region_names[HEAP_WATCH_REGION_COUNT] = { "internal", "psram" };
+
+typedef struct {
+    uint32_t uptime_s;
+    uint32_t psram_largest;
+} heap_watch_point_t;
+
+static heap_watch_snapshot_t latest;
+static portMUX_TYPE watch_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Monitor task only
+static heap_watch_point_t history[HEAP_WATCH_HISTORY];
+static uint32_t history_count = 0;
+static uint32_t psram_low_since_s = 0;
+static bool eta_warned = false;
+
+#if CONFIG_HEAP_TRACING_STANDALONE
+#define HEAP_TRACE_ACTIVE (CONFIG_GOLDIE_HEAP_TRACE_WINDOW_S > 0)
+
+typedef struct {
+    void *site;                // Caller of the allocation
+    void *parent;              // Its caller, when the tracer keeps two frames
+    uint32_t bytes;
+    uint32_t blocks;
+} heap_watch_site_t;
+
+static heap_trace_record_t *trace_records = NULL;
+static uint32_t trace_started_s = 0;
+static bool tracing = false;
+static bool trace_off = false;             // No record buffer - gave up
+
+static void trace_start(uint32_t now_s)
+{
+    if (trace_records == NULL) {
+        // Allocated before tracing starts, so the tracer never sees it
+        trace_records = (heap_trace_record_t *)heap_caps_calloc(CONFIG_GOLDIE_HEAP_TRACE_RECORDS,
+                                                                sizeof(heap_trace_record_t),
+                                                                MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (trace_records == NULL ||
+            heap_trace_init_standalone(trace_records, CONFIG_GOLDIE_HEAP_TRACE_RECORDS) != ESP_OK) {
+            ESP_LOGW(TAG, "No room for %d trace records - allocation tracing off",
+                     CONFIG_GOLDIE_HEAP_TRACE_RECORDS);
+            heap_caps_free(trace_records);
+            trace_records = NULL;
+            trace_off = true;
+            return;
+        }
+    }
+    tracing = heap_trace_start(HEAP_TRACE_LEAKS) == ESP_OK;
+    trace_started_s = now_s;
+}
+
+/**
+ * @brief Stop the window and log the sites holding the most memory from it
+ */
+static void trace_report(uint32_t now_s)
+{
+    heap_trace_stop();
+    tracing = false;
+
+    static heap_watch_site_t sites[HEAP_WATCH_TOP_CALLERS * 4];
+    size_t site_count = 0;
+    uint32_t untracked = 0;
+    size_t count = heap_trace_get_count();
+    heap_trace_record_t rec;
+    for (size_t i = 0; i < count; i++) {
+        if (heap_trace_get(i, &rec) != ESP_OK || rec.address == NULL) {
+            continue;
+        }
+#if CONFIG_HEAP_TRACING_STACK_DEPTH > 0
+        void *site = rec.alloc_stack[0];
+        void *parent = CONFIG_HEAP_TRACING_STACK_DEPTH > 1 ? rec.alloc_stack[1] : NULL;
+#else
+        void *site = NULL;
+        void *parent = NULL;
+#endif
+        size_t s = 0;
+        while (s < site_count && sites[s].site != site) {
+            s++;
+        }
+        if (s == site_count) {
+            if (site_count == sizeof(sites) / sizeof(sites[0])) {
+                untracked += rec.size;
+                continue;
+            }
+            sites[site_count++] = { site, parent, 0, 0 };
+        }
+        sites[s].bytes += rec.size;
+        sites[s].blocks++;
+    }
+
+    ESP_LOGI(TAG, "Still allocated from the last %lu s: %u blocks%s", (unsigned long)(now_s - trace_started_s),
+             (unsigned)count, count >= CONFIG_GOLDIE_HEAP_TRACE_RECORDS ? " (record buffer full)" : "");
+    for (int n = 0; n < HEAP_WATCH_TOP_CALLERS; n++) {
+        size_t best = site_count;
+        for (size_t s = 0; s < site_count; s++) {
+            if (sites[s].blocks != 0 && (best == site_count || sites[s].bytes > sites[best].bytes)) {
+                best = s;
+            }
+        }
+        if (best == site_count) {
+            break;
+        }
+        ESP_LOGI(TAG, "  %7lu bytes in %4lu blocks  from %p (via %p)", (unsigned long)sites[best].bytes,
+                 (unsigned long)sites[best].blocks, sites[best].site, sites[best].parent);
+        sites[best].blocks = 0;
+    }
+    if (untracked) {
+        ESP_LOGI(TAG, "  %7lu bytes from further sites", (unsigned long)untracked);
+    }
+}
+#endif
+
+/**
+ * @brief Warn on a low largest PSRAM block, now or projected from the trend
+ */
+static void check_psram(heap_watch_snapshot_t *snap)
+{
+    const heap_watch_region_stats_t *ps = &snap->region[HEAP_WATCH_PSRAM];
+    const uint32_t min_bytes = (uint32_t)CONFIG_GOLDIE_HEAP_WATCH_PSRAM_MIN_KB * 1024;
+    snap->psram_eta_h = -1;
+
+    if (ps->largest < min_bytes) {
+        if (psram_low_since_s == 0) {
+            psram_low_since_s = snap->uptime_s ? snap->uptime_s : 1;
+            ESP_LOGW(TAG, "Largest PSRAM block %lu KB (of %lu KB free) is below %d KB - "
+                     "frame allocations may fail", (unsigned long)(ps->largest / 1024),
+                     (unsigned long)(ps->free / 1024), CONFIG_GOLDIE_HEAP_WATCH_PSRAM_MIN_KB);
+        }
+    } else {
+        if (psram_low_since_s != 0) {
+            ESP_LOGI(TAG, "Largest PSRAM block back at %lu KB", (unsigned long)(ps->largest / 1024));
+        }
+        psram_low_since_s = 0;
+
+        // Straight line from the oldest kept sample to this one
+        const heap_watch_point_t *old = &history[history_count < HEAP_WATCH_HISTORY ? 0 :
+                                                 history_count % HEAP_WATCH_HISTORY];
+        uint32_t dt = snap->uptime_s - old->uptime_s;
+        if (history_count >= 2 && dt > 0 && old->psram_largest > ps->largest) {
+            uint64_t eta_s = (uint64_t)(ps->largest - min_bytes) * dt / (old->psram_largest - ps->largest);
+            if (eta_s < (uint64_t)HEAP_WATCH_HORIZON_H * 3600) {
+                snap->psram_eta_h = (int32_t)(eta_s / 3600);
+            }
+        }
+        if (snap->psram_eta_h >= 0 && !eta_warned) {
+            ESP_LOGW(TAG, "Largest PSRAM block shrank %lu -> %lu KB in %lu min: below %d KB in ~%ld h",
+                     (unsigned long)(old->psram_largest / 1024), (unsigned long)(ps->largest / 1024),
+                     (unsigned long)(dt / 60), CONFIG_GOLDIE_HEAP_WATCH_PSRAM_MIN_KB, (long)snap->psram_eta_h);
+        }
+        eta_warned = snap->psram_eta_h >= 0;
+    }
+    snap->psram_low_since_s = psram_low_since_s;
+}
+
+void heap_watch_sample(void)
+{
+    heap_watch_snapshot_t snap;
+    portENTER_CRITICAL(&watch_lock);
+    snap = latest;
+    portEXIT_CRITICAL(&watch_lock);
+
+    snap.samples++;
+    snap.uptime_s = time_svc_uptime_s();
+    ESP_LOGI(TAG, "Heap (sample %lu, up %lu min):", (unsigned long)snap.samples, (unsigned long)(snap.uptime_s / 60));
+    for (int r = 0; r < HEAP_WATCH_REGION_COUNT; r++) {
+        heap_watch_region_stats_t *s = &snap.region[r];
+        s->free = (uint32_t)heap_caps_get_free_size(region_caps[r]);
+        s->largest = (uint32_t)heap_caps_get_largest_free_block(region_caps[r]);
+        s->min_free = (uint32_t)heap_caps_get_minimum_free_size(region_caps[r]);
+        s->frag_pct = s->free ? (uint8_t)(100 - (uint64_t)s->largest * 100 / s->free) : 0;
+        if (r == HEAP_WATCH_PSRAM && heap_caps_get_total_size(region_caps[r]) == 0) {
+            continue;              // No PSRAM on this board
+        }
+        ESP_LOGI(TAG, "  %-8s free %6lu KB, largest block %6lu KB (%2u%% fragmented), min free %6lu KB",
+                 region_names[r], (unsigned long)(s->free / 1024), (unsigned long)(s->largest / 1024),
+                 (unsigned)s->frag_pct, (unsigned long)(s->min_free / 1024));
+    }
+
+    heap_watch_region_stats_t *in = &snap.region[HEAP_WATCH_INTERNAL];
+    heap_watch_region_stats_t *ps = &snap.region[HEAP_WATCH_PSRAM];
+    blackbox_record(BLACKBOX_HEAP, 0xFF, NULL, (uint16_t)(in->free / 1024),
+                    ((ps->free / 1024) & 0xFFFF) << 16 | ((ps->largest / 1024) & 0xFFFF));
+
+    if (heap_caps_get_total_size(MALLOC_CAP_SPIRAM) != 0) {
+        check_psram(&snap);
+        history[history_count % HEAP_WATCH_HISTORY] = { snap.uptime_s, snap.region[HEAP_WATCH_PSRAM].largest };
+        history_count++;
+    } else {
+        snap.psram_eta_h = -1;
+    }
+
+#if CONFIG_HEAP_TRACING_STANDALONE
+    if (HEAP_TRACE_ACTIVE) {
+        if (tracing && snap.uptime_s - trace_started_s >= (uint32_t)CONFIG_GOLDIE_HEAP_TRACE_WINDOW_S) {
+            trace_report(snap.uptime_s);
+        }
+        if (!tracing && !trace_off) {
+            trace_start(snap.uptime_s);
+        }
+    }
+#endif
+
+    portENTER_CRITICAL(&watch_lock);
+    latest = snap;
+    portEXIT_CRITICAL(&watch_lock);
+}
+
+bool heap_watch_get(heap_watch_snapshot_t *out)
+{
+    portENTER_CRITICAL(&watch_lock);
+    *out = latest;
+    portEXIT_CRITICAL(&watch_lock);
+    return out->samples > 0;
+}
@@ -0,0 +1,86 @@
+#ifndef HEAP_WATCH_H
+#define HEAP_WATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Heap Watch - free memory and fragmentation over long uptimes
+ *
+ * Sampled by the task monitor (task_monitor.h, same period): free bytes,
+ * largest free block and the all-time minimum for internal RAM and PSRAM.
+ * The last HEAP_WATCH_HISTORY samples are kept to see fragmentation
+ * creep in (LVGL object churn, cJSON per AI reply, an HTTP client per
+ * Blynk push).
+ *
+ *   - When the largest PSRAM block drops below
+ *     CONFIG_GOLDIE_HEAP_WATCH_PSRAM_MIN_KB (a 300 KB animation frame plus
+ *     headroom) a warning is logged, once per crossing.
+ *   - While it is still above, the decline of the largest block across
+ *     the kept samples is extrapolated; a crossing projected within
+ *     HEAP_WATCH_HORIZON_H hours is warned about ahead of time.
+ *   - With CONFIG_GOLDIE_HEAP_TRACE_WINDOW_S (needs the standalone heap
+ *     tracer, CONFIG_HEAP_TRACING_STANDALONE) allocations are traced in
+ *     leak mode over each window; what is still allocated at the end is
+ *     summed per calling site and the top HEAP_WATCH_TOP_CALLERS logged.
+ *     Windows end on a monitor sample, so they round up to its period.
+ */
+
+#ifndef CONFIG_GOLDIE_HEAP_WATCH_PSRAM_MIN_KB
+#define CONFIG_GOLDIE_HEAP_WATCH_PSRAM_MIN_KB 320
+#endif
+#ifndef CONFIG_GOLDIE_HEAP_TRACE_WINDOW_S
+#define CONFIG_GOLDIE_HEAP_TRACE_WINDOW_S 0
+#endif
+#ifndef CONFIG_GOLDIE_HEAP_TRACE_RECORDS
+#define CONFIG_GOLDIE_HEAP_TRACE_RECORDS 300
+#endif
+
+#define HEAP_WATCH_HISTORY      48     // Samples kept for the trend
+#define HEAP_WATCH_HORIZON_H    24     // Warn this far ahead of a projected crossing
+#define HEAP_WATCH_TOP_CALLERS  8
+
+typedef enum {
+    HEAP_WATCH_INTERNAL = 0,
+    HEAP_WATCH_PSRAM,
+    HEAP_WATCH_REGION_COUNT
+} heap_watch_region_t;
+
+typedef struct {
+    uint32_t free;             // Bytes
+    uint32_t largest;          // Largest free block
+    uint32_t min_free;         // Lowest free since boot
+    uint8_t  frag_pct;         // 100 - largest * 100 / free
+} heap_watch_region_stats_t;
+
+typedef struct {
+    uint32_t samples;
+    uint32_t uptime_s;         // Of the latest sample
+    heap_watch_region_stats_t region[HEAP_WATCH_REGION_COUNT];
+    uint32_t psram_low_since_s;   // Uptime the largest block went low (0 = not low)
+    int32_t  psram_eta_h;         // Projected hours to a crossing, -1 = none
+} heap_watch_snapshot_t;
+
+/**
+ * @brief Sample, check the thresholds and close a trace window if one is due
+ *
+ * Called by the task monitor each period; the first call starts tracing.
+ */
+void heap_watch_sample(void);
+
+/**
+ * @brief Copy the latest sample
+ * @return false if nothing was sampled yet
+ */
+bool heap_watch_get(heap_watch_snapshot_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HEAP_WATCH_H
@@ -0,0 +1,349 @@
+#include "input_rec.h"
+#include "esp_sdcard_port.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static const char *TAG = "input_rec";
+
+#define REC_VERSION  1
+
+typedef enum {
+    MODE_OFF = 0,
+    MODE_RECORD,
+    MODE_REPLAY,
+} rec_mode_t;
+
+typedef struct {
+    char magic[4];                 // "GREC"
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t wall_start;           // time(NULL) at input_rec_init()
+    uint32_t reserved2;
+} rec_header_t;
+
+typedef struct {
+    uint32_t ms;                   // Since the start of the recording
+    uint8_t kind;                  // input_rec_kind_t
+    uint8_t sub;
+    uint16_t len;
+} rec_event_t;
+
+static_assert(sizeof(rec_header_t) == 16, "recording header should stay 16 bytes");
+static_assert(sizeof(rec_event_t) == 8, "event header should stay 8 bytes");
+static_assert(INPUT_REC_RING > 2 * (sizeof(rec_event_t) + INPUT_REC_EVENT_MAX), "ring too small for the largest event");
+
+static std::atomic<uint8_t> mode(MODE_OFF);
+static int64_t t0_us = 0;
+static input_rec_sink_t sinks[INPUT_REC_KIND_COUNT];
+
+// Recording: bytes ever written / taken, under ring_lock
+static uint8_t *ring = NULL;
+static size_t ring_head = 0;
+static size_t ring_tail = 0;
+static portMUX_TYPE ring_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t recorded = 0;
+static uint32_t dropped = 0;
+static FILE *rec_file = NULL;
+
+// Replay: the next event, read ahead
+static FILE *replay_file = NULL;
+static TaskHandle_t replayer = NULL;
+static rec_event_t next_evt;
+static uint8_t *next_data = NULL;  // INPUT_REC_EVENT_MAX
+static uint32_t replayed = 0;
+static uint32_t late_max_ms = 0;
+static uint64_t late_sum_ms = 0;
+
+static uint32_t now_ms(void)
+{
+    return (uint32_t)((esp_timer_get_time() - t0_us) / 1000);
+}
+
+/**
+ * @brief Append to the ring (ring_lock held, room checked)
+ */
+static void ring_write(const void *data, size_t len)
+{
+    size_t pos = ring_head % INPUT_REC_RING;
+    size_t first = len < INPUT_REC_RING - pos ? len : INPUT_REC_RING - pos;
+    memcpy(&ring[pos], data, first);
+    memcpy(ring, (const uint8_t *)data + first, len - first);
+    ring_head += len;
+}
+
+void input_rec_put_parts(input_rec_kind_t kind, uint8_t sub, const input_rec_part_t *parts, size_t count)
+{
+    if (mode.load(std::memory_order_relaxed) != MODE_RECORD) {
+        return;
+    }
+    size_t len = 0;
+    for (size_t i = 0; i < count; i++) {
+        len += parts[i].len;
+    }
+    if (len > INPUT_REC_EVENT_MAX) {
+        portENTER_CRITICAL(&ring_lock);
+        dropped++;
+        portEXIT_CRITICAL(&ring_lock);
+        return;
+    }
+    rec_event_t e = {now_ms(), (uint8_t)kind, sub, (uint16_t)len};
+
+    portENTER_CRITICAL(&ring_lock);
+    if (INPUT_REC_RING - (ring_head - ring_tail) >= sizeof(e) + len) {
+        ring_write(&e, sizeof(e));
+        for (size_t i = 0; i < count; i++) {
+            ring_write(parts[i].data, parts[i].len);
+        }
+        recorded++;
+    } else {
+        dropped++;
+    }
+    portEXIT_CRITICAL(&ring_lock);
+}
+
+void input_rec_put(input_rec_kind_t kind, uint8_t sub, const void *data, size_t len)
+{
+    const input_rec_part_t part = {data, len};
+    input_rec_put_parts(kind, sub, &part, 1);
+}
+
+bool input_rec_recording(void)
+{
+    return mode.load(std::memory_order_relaxed) == MODE_RECORD;
+}
+
+bool input_rec_replaying(input_rec_kind_t kind)
+{
+    return mode.load(std::memory_order_relaxed) == MODE_REPLAY && kind < INPUT_REC_KIND_COUNT &&
+           sinks[kind] != NULL;
+}
+
+bool input_rec_live(input_rec_kind_t kind)
+{
+    return !input_rec_replaying(kind) || xTaskGetCurrentTaskHandle() == replayer;
+}
+
+void input_rec_set_sink(input_rec_kind_t kind, input_rec_sink_t sink)
+{
+    if (kind < INPUT_REC_KIND_COUNT) {
+        sinks[kind] = sink;
+    }
+}
+
+/**
+ * @brief Write what the ring holds to the file
+ * @return false on a write error
+ */
+static bool drain(void)
+{
+    uint8_t chunk[512];
+    for (;;) {
+        portENTER_CRITICAL(&ring_lock);
+        size_t len = ring_head - ring_tail;
+        if (len > sizeof(chunk)) {
+            len = sizeof(chunk);
+        }
+        size_t pos = ring_tail % INPUT_REC_RING;
+        size_t first = len < INPUT_REC_RING - pos ? len : INPUT_REC_RING - pos;
+        memcpy(chunk, &ring[pos], first);
+        memcpy(chunk + first, ring, len - first);
+        ring_tail += len;
+        portEXIT_CRITICAL(&ring_lock);
+        if (len == 0) {
+            return fflush(rec_file) == 0;
+        }
+        if (fwrite(chunk, 1, len, rec_file) != len) {
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Recorder: wall clock marks, ring to SD every INPUT_REC_FLUSH_MS
+ */
+static void record_task(void *arg)
+{
+    uint32_t last_wall = 0;
+    int64_t last_sync = esp_timer_get_time();
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(INPUT_REC_FLUSH_MS));
+        uint32_t wall = (uint32_t)time(NULL);
+        if (wall != last_wall) {
+            input_rec_put(INPUT_REC_TICK, 0, &wall, sizeof(wall));
+            last_wall = wall;
+        }
+        if (!drain()) {
+            ESP_LOGW(TAG, "Write to %s failed - recording stopped", INPUT_REC_PATH);
+            break;
+        }
+        int64_t now = esp_timer_get_time();
+        if (now - last_sync >= (int64_t)INPUT_REC_SYNC_MS * 1000) {
+            fsync(fileno(rec_file));
+            last_sync = now;
+        }
+    }
+    mode.store(MODE_OFF);
+    fclose(rec_file);
+    rec_file = NULL;
+    input_rec_log_stats();
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Read the next event of the replay
+ */
+static bool read_next(void)
+{
+    return fread(&next_evt, sizeof(next_evt), 1, replay_file) == 1 && next_evt.len <= INPUT_REC_EVENT_MAX &&
+           fread(next_data, 1, next_evt.len, replay_file) == next_evt.len;
+}
+
+static void replay_end(void)
+{
+    mode.store(MODE_OFF);
+    fclose(replay_file);
+    replay_file = NULL;
+    heap_caps_free(next_data);
+    next_data = NULL;
+    ESP_LOGI(TAG, "Replay done: %lu events, %lu ms late on average, %lu ms at most - live inputs back",
+             (unsigned long)replayed, (unsigned long)(replayed ? late_sum_ms / replayed : 0),
+             (unsigned long)late_max_ms);
+}
+
+bool input_rec_replay_open(const char *path)
+{
+    if (mode.load() != MODE_OFF) {
+        return false;
+    }
+    replay_file = fopen(path, "rb");
+    if (replay_file == NULL) {
+        ESP_LOGW(TAG, "Cannot open %s", path);
+        return false;
+    }
+    rec_header_t hdr;
+    next_data = (uint8_t *)heap_caps_malloc(INPUT_REC_EVENT_MAX, MALLOC_CAP_SPIRAM);
+    if (fread(&hdr, sizeof(hdr), 1, replay_file) != 1 || memcmp(hdr.magic, "GREC", 4) != 0 ||
+        hdr.version != REC_VERSION || next_data == NULL || !read_next()) {
+        ESP_LOGW(TAG, "%s is not a recording (or empty) - no replay", path);
+        fclose(replay_file);
+        replay_file = NULL;
+        heap_caps_free(next_data);
+        next_data = NULL;
+        return false;
+    }
+    t0_us = esp_timer_get_time();
+    replayed = 0;
+    late_max_ms = 0;
+    late_sum_ms = 0;
+    mode.store(MODE_REPLAY);
+    time_t start = (time_t)hdr.wall_start;
+    struct tm tm;
+    char when[24];
+    localtime_r(&start, &tm);
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &tm);
+    ESP_LOGI(TAG, "Replaying %s (recorded from %s)", path, when);
+    return true;
+}
+
+uint32_t input_rec_replay_poll(void)
+{
+    if (mode.load() != MODE_REPLAY) {
+        return INPUT_REC_DONE;
+    }
+    replayer = xTaskGetCurrentTaskHandle();
+    for (;;) {
+        uint32_t now = now_ms();
+        if (next_evt.ms > now) {
+            return next_evt.ms - now;
+        }
+        uint32_t late = now - next_evt.ms;
+        late_sum_ms += late;
+        if (late > late_max_ms) {
+            late_max_ms = late;
+        }
+        if (next_evt.kind < INPUT_REC_KIND_COUNT && sinks[next_evt.kind] != NULL) {
+            sinks[next_evt.kind](next_evt.sub, next_data, next_evt.len);
+        }
+        replayed++;
+        if (!read_next()) {
+            replay_end();
+            return INPUT_REC_DONE;
+        }
+    }
+}
+
+static void replay_task(void *arg)
+{
+    uint32_t wait;
+    while ((wait = input_rec_replay_poll()) != INPUT_REC_DONE) {
+        TickType_t ticks = pdMS_TO_TICKS(wait);
+        vTaskDelay(ticks > 0 ? ticks : 1);
+    }
+    vTaskDelete(NULL);
+}
+
+void input_rec_init(void)
+{
+    if (!CONFIG_GOLDIE_INPUT_REC || mode.load() != MODE_OFF || ring != NULL) {
+        return;
+    }
+    if (!esp_sdcard_port_is_mounted()) {
+        ESP_LOGW(TAG, "No SD card - input recorder off");
+        return;
+    }
+    if (access(INPUT_REC_REPLAY_PATH, F_OK) == 0) {
+        if (input_rec_replay_open(INPUT_REC_REPLAY_PATH) &&
+            xTaskCreate(replay_task, "input_replay", INPUT_REC_STACK, NULL, 5, NULL) != pdPASS) {
+            ESP_LOGE(TAG, "No replay task");
+            replay_end();
+        }
+        return;                    // A replay run records nothing
+    }
+
+    ring = (uint8_t *)heap_caps_malloc(INPUT_REC_RING, MALLOC_CAP_SPIRAM);
+    if (ring == NULL) {
+        ESP_LOGW(TAG, "No PSRAM for the %d KB ring - input recorder off", CONFIG_GOLDIE_INPUT_REC_KB);
+        return;
+    }
+    remove(INPUT_REC_PREV_PATH);
+    rename(INPUT_REC_PATH, INPUT_REC_PREV_PATH);
+    rec_file = fopen(INPUT_REC_PATH, "wb");
+    const rec_header_t hdr = {{'G', 'R', 'E', 'C'}, REC_VERSION, 0, (uint32_t)time(NULL), 0};
+    if (rec_file == NULL || fwrite(&hdr, sizeof(hdr), 1, rec_file) != 1) {
+        ESP_LOGW(TAG, "Cannot create %s - input recorder off", INPUT_REC_PATH);
+        if (rec_file != NULL) {
+            fclose(rec_file);
+            rec_file = NULL;
+        }
+        return;
+    }
+    t0_us = esp_timer_get_time();
+    mode.store(MODE_RECORD);
+    if (xTaskCreate(record_task, "input_rec", INPUT_REC_STACK, NULL, 1, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "No recorder task - input recorder off");
+        mode.store(MODE_OFF);
+        fclose(rec_file);
+        rec_file = NULL;
+        return;
+    }
+    ESP_LOGI(TAG, "Recording inputs to %s (%d KB ring); copy one to %s to replay it", INPUT_REC_PATH,
+             CONFIG_GOLDIE_INPUT_REC_KB, INPUT_REC_REPLAY_PATH);
+}
+
+void input_rec_log_stats(void)
+{
+    portENTER_CRITICAL(&ring_lock);
+    uint32_t rec = recorded;
+    uint32_t drop = dropped;
+    portEXIT_CRITICAL(&ring_lock);
+    ESP_LOGI(TAG, "Input recorder: %lu events recorded, %lu dropped, %lu replayed", (unsigned long)rec,
+             (unsigned long)drop, (unsigned long)replayed);
+}
@@ -0,0 +1,157 @@
+#ifndef INPUT_REC_H
+#define INPUT_REC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Input Recorder - deterministic record / replay of what drives the UI
+ *
+ * Timing-dependent slowdowns ("scroll lags after the AI reply lands") only
+ * show with the same inputs at the same moments. Everything reaching the
+ * UI from outside is recorded with its time since input_rec_init(), and
+ * can be fed back with the same timing on the bench or in the PC
+ * simulator (tools/sim --replay).
+ *
+ * Each input is recorded by the module it enters through, which also
+ * registers the sink that re-injects it:
+ *   INPUT_REC_TOUCH     touch samples as the filter gets them (touch_rec.h)
+ *   INPUT_REC_PARAM     parameter entries through the dashboard API
+ *                       (probes, web API, ESP-NOW nodes, soak test)
+ *   INPUT_REC_ACTIVITY  fish activity readings (camera)
+ *   INPUT_REC_BUS       AI results, power status, reminders (msg_bus.h)
+ *   INPUT_REC_INBOX     WiFi state and clock change posts (ui_inbox.h)
+ *   INPUT_REC_TICK      wall clock once a second, to place events in time
+ * Mood results and forecasts are not recorded: the replayed parameters
+ * produce them again. Entries typed on the keypad come back through the
+ * replayed touches.
+ *
+ * Recording: input_rec_put() appends the event to a PSRAM byte ring under
+ * a spinlock (any task, never blocks; a full ring drops the event and
+ * counts it). The input_rec task writes the ring to INPUT_REC_PATH every
+ * INPUT_REC_FLUSH_MS; the previous boot's file is kept as
+ * INPUT_REC_PREV_PATH, so a slowdown seen in the field survives a reboot.
+ *
+ * Replay: copy a recording to INPUT_REC_REPLAY_PATH and reboot. Instead of
+ * recording, the replayer hands each event to its kind's sink at its
+ * recorded offset. Meanwhile live inputs of the replayed kinds are dropped
+ * (input_rec_live()), so only the recording drives the UI; at the end the
+ * replayer logs how late it delivered and live inputs resume. The WiFi
+ * state handler still reads the live connection - the post is replayed,
+ * not the network.
+ *
+ * File (little endian): 16-byte header {"GREC", u16 version, u16 0,
+ * u32 wall clock at start, u32 0}, then events {u32 ms since start,
+ * u8 kind, u8 sub, u16 len, len bytes of payload}.
+ *
+ * Without CONFIG_GOLDIE_INPUT_REC nothing is recorded or replayed on the
+ * device; the simulator replays through input_rec_replay_open() / _poll().
+ */
+
+#ifndef CONFIG_GOLDIE_INPUT_REC
+#define CONFIG_GOLDIE_INPUT_REC 0
+#endif
+#ifndef CONFIG_GOLDIE_INPUT_REC_KB
+#define CONFIG_GOLDIE_INPUT_REC_KB 32
+#endif
+
+#define INPUT_REC_PATH         "/sdcard/input.rec"
+#define INPUT_REC_PREV_PATH    "/sdcard/input_prev.rec"
+#define INPUT_REC_REPLAY_PATH  "/sdcard/replay.rec"
+#define INPUT_REC_RING         (CONFIG_GOLDIE_INPUT_REC_KB * 1024)
+#define INPUT_REC_EVENT_MAX    2560     // Largest payload (an AI result with both texts)
+#define INPUT_REC_FLUSH_MS     500
+#define INPUT_REC_SYNC_MS      5000     // fsync: a power cut loses at most this much
+#define INPUT_REC_STACK        4096
+#define INPUT_REC_DONE         UINT32_MAX
+
+typedef enum {
+    INPUT_REC_TOUCH = 0,       // sub: pressed; i16 x, i16 y
+    INPUT_REC_PARAM,           // sub: dashboard_param_t; u8 tank, f32 value
+    INPUT_REC_ACTIVITY,        // sub: valid; u16 permille
+    INPUT_REC_BUS,             // sub: msg_topic_t; payload or its codec's encoding
+    INPUT_REC_INBOX,           // sub: ui_msg_type_t; no payload
+    INPUT_REC_TICK,            // sub: 0; u32 wall clock (s)
+    INPUT_REC_KIND_COUNT
+} input_rec_kind_t;
+
+/**
+ * @brief Replays one event (replayer context: the input_rec task, or the
+ *        simulator's loop - take the LVGL lock where needed)
+ */
+typedef void (*input_rec_sink_t)(uint8_t sub, const uint8_t *data, size_t len);
+
+/**
+ * @brief One piece of an event's payload (input_rec_put_parts)
+ */
+typedef struct {
+    const void *data;
+    size_t len;
+} input_rec_part_t;
+
+/**
+ * @brief Start recording, or replaying INPUT_REC_REPLAY_PATH if it exists
+ *
+ * Call once the SD card is mounted and every sink is registered; event
+ * times count from here. No-op without CONFIG_GOLDIE_INPUT_REC.
+ */
+void input_rec_init(void);
+
+/**
+ * @brief Set the sink that replays `kind` (init time)
+ */
+void input_rec_set_sink(input_rec_kind_t kind, input_rec_sink_t sink);
+
+/**
+ * @brief Record one event (any task; no-op unless recording)
+ */
+void input_rec_put(input_rec_kind_t kind, uint8_t sub, const void *data, size_t len);
+
+/**
+ * @brief Record one event whose payload is gathered from `count` parts
+ */
+void input_rec_put_parts(input_rec_kind_t kind, uint8_t sub, const input_rec_part_t *parts, size_t count);
+
+/**
+ * @brief Recording now (lets callers skip building a payload)
+ */
+bool input_rec_recording(void);
+
+/**
+ * @brief A replay of `kind` is running
+ */
+bool input_rec_replaying(input_rec_kind_t kind);
+
+/**
+ * @brief false for a live input of `kind` that a running replay stands in
+ *        for (true for the replayer's own calls) - drop it
+ */
+bool input_rec_live(input_rec_kind_t kind);
+
+/**
+ * @brief Open a recording for replay; its times count from now
+ */
+bool input_rec_replay_open(const char *path);
+
+/**
+ * @brief Hand every due event to its sink (the caller becomes the replayer)
+ * @return ms until the next event, or INPUT_REC_DONE at the end
+ */
+uint32_t input_rec_replay_poll(void);
+
+/**
+ * @brief Log event / drop counts
+ */
+void input_rec_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INPUT_REC_H
@@ -0,0 +1,193 @@
+#include "job_pool.h"
+#include "task_layout.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "job_pool";
+
+typedef struct {
+    job_pool_fn_t fn;
+    void *arg;
+} job_t;
+
+// Ring used as a deque: the owner pushes and pops at `bottom`, thieves
+// take at `top`. Short critical sections under the worker's spinlock;
+// jobs are coarse (a band, a block), so the lock is never the bottleneck.
+typedef struct {
+    job_t jobs[JOB_POOL_DEPTH];
+    uint32_t top;
+    uint32_t bottom;
+} deque_t;
+
+typedef struct {
+    TaskHandle_t task;
+    portMUX_TYPE lock;
+    deque_t dq[JOB_POOL_PRIO_COUNT];
+    volatile bool idle;              // Asleep, waiting for a notification
+    uint32_t run;
+    uint32_t stolen;
+} worker_t;
+
+static worker_t workers[2] = {
+    { NULL, portMUX_INITIALIZER_UNLOCKED, {}, false, 0, 0 },
+    { NULL, portMUX_INITIALIZER_UNLOCKED, {}, false, 0, 0 },
+};
+static const task_id_t worker_ids[2] = { TASK_ID_JOBS_0, TASK_ID_JOBS_1 };
+static bool started = false;
+static uint32_t rejected = 0;
+static uint8_t depth_max = 0;
+
+static bool take(worker_t *w, job_pool_prio_t prio, bool steal, job_t *out)
+{
+    deque_t *d = &w->dq[prio];
+    bool got = false;
+    portENTER_CRITICAL(&w->lock);
+    if (d->bottom != d->top) {
+        if (steal) {
+            *out = d->jobs[d->top % JOB_POOL_DEPTH];
+            d->top++;
+        } else {
+            d->bottom--;
+            *out = d->jobs[d->bottom % JOB_POOL_DEPTH];
+        }
+        got = true;
+    }
+    portEXIT_CRITICAL(&w->lock);
+    return got;
+}
+
+/**
+ * @brief Next job for worker `self`: HIGH before LOW, own deque before the other's
+ * @return false if both cores have nothing queued
+ */
+static bool next_job(int self, job_t *out, bool *was_stolen)
+{
+    for (int p = 0; p < JOB_POOL_PRIO_COUNT; p++) {
+        if (take(&workers[self], (job_pool_prio_t)p, false, out)) {
+            *was_stolen = false;
+            return true;
+        }
+        if (take(&workers[1 - self], (job_pool_prio_t)p, true, out)) {
+            *was_stolen = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void worker_task(void *arg)
+{
+    int self = (int)(intptr_t)arg;
+    worker_t *w = &workers[self];
+    while (true) {
+        job_t job;
+        bool was_stolen;
+        if (!next_job(self, &job, &was_stolen)) {
+            // Idle before the last look: a submit after it sees the flag and wakes us
+            w->idle = true;
+            if (!next_job(self, &job, &was_stolen)) {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                w->idle = false;
+                continue;
+            }
+            w->idle = false;
+        }
+        job.fn(job.arg);
+        w->run++;
+        if (was_stolen) {
+            w->stolen++;
+        }
+    }
+}
+
+extern "C" bool job_pool_start(TaskHandle_t handles[2])
+{
+    if (started) {
+        if (handles != NULL) {
+            handles[0] = workers[0].task;
+            handles[1] = workers[1].task;
+        }
+        return true;
+    }
+    const task_layout_t *lvgl = task_layout_get(TASK_ID_LVGL);
+    for (int i = 0; i < 2; i++) {
+        const task_layout_t *t = task_layout_get(worker_ids[i]);
+        UBaseType_t prio = t->prio;
+        if (t->core != 1 && prio >= lvgl->prio) {
+            prio = lvgl->prio > 1 ? lvgl->prio - 1 : 1;
+            ESP_LOGW(TAG, "%s may run on core 0: priority %u -> %u (below LVGL)", t->name,
+                     (unsigned)t->prio, (unsigned)prio);
+        }
+        if (xTaskCreatePinnedToCore(worker_task, t->name, t->stack, (void *)(intptr_t)i, prio,
+                                    &workers[i].task, t->core < 0 ? tskNO_AFFINITY : t->core) != pdPASS) {
+            workers[i].task = NULL;
+            ESP_LOGW(TAG, "%s not created", t->name);
+        }
+    }
+    if (handles != NULL) {
+        handles[0] = workers[0].task;
+        handles[1] = workers[1].task;
+    }
+    started = workers[0].task != NULL || workers[1].task != NULL;
+    if (started) {
+        ESP_LOGI(TAG, "Job workers: %s, %s", workers[0].task ? "core 0" : "-", workers[1].task ? "core 1" : "-");
+    }
+    return started;
+}
+
+extern "C" bool job_pool_ready(void)
+{
+    return started;
+}
+
+extern "C" bool job_pool_submit(job_pool_fn_t fn, void *arg, job_pool_prio_t prio, int core)
+{
+    if (!started || fn == NULL || prio >= JOB_POOL_PRIO_COUNT) {
+        __atomic_add_fetch(&rejected, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    int target = (core == 0 || core == 1) ? core : (int)xPortGetCoreID();
+    if (workers[target].task == NULL) {
+        target = 1 - target;
+    }
+    worker_t *w = &workers[target];
+    deque_t *d = &w->dq[prio];
+
+    bool queued = false;
+    uint32_t depth = 0;
+    portENTER_CRITICAL(&w->lock);
+    depth = d->bottom - d->top;
+    if (depth < JOB_POOL_DEPTH) {
+        d->jobs[d->bottom % JOB_POOL_DEPTH] = { fn, arg };
+        d->bottom++;
+        depth++;
+        queued = true;
+    }
+    portEXIT_CRITICAL(&w->lock);
+    if (!queued) {
+        __atomic_add_fetch(&rejected, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    if (depth > depth_max) {
+        depth_max = (uint8_t)depth;   // Statistic: a lost update is harmless
+    }
+
+    // The owner, and the other worker if it sleeps: whoever gets there first
+    xTaskNotifyGive(w->task);
+    worker_t *other = &workers[1 - target];
+    if (other->task != NULL && other->idle) {
+        xTaskNotifyGive(other->task);
+    }
+    return true;
+}
+
+extern "C" void job_pool_get_stats(job_pool_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    for (int i = 0; i < 2; i++) {
+        out->run[i] = workers[i].run;
+        out->stolen[i] = workers[i].stolen;
+    }
+    out->rejected = __atomic_load_n(&rejected, __ATOMIC_RELAXED);
+    out->depth_max = depth_max;
+}
@@ -0,0 +1,85 @@
+#ifndef JOB_POOL_H
+#define JOB_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Job Pool - CPU-bound background work on both cores' idle time
+ *
+ * One worker task per core (Task layout -> Job worker core 0 / core 1),
+ * both at background priority: the core 0 worker is always kept below
+ * LVGL, the core 1 worker below the coordinator tasks, so a job only runs
+ * in time nothing interactive wants. Work that a dedicated task would
+ * otherwise do alone (band decode, encoders, batch scoring) is cut into
+ * jobs and submitted here.
+ *
+ * Each worker owns a deque per priority. A job goes to the deque of the
+ * core named by its affinity hint (JOB_POOL_ANY_CORE: the submitting
+ * core's); the owner runs its newest job first (still warm in cache), an
+ * idle worker steals the other's oldest one. HIGH jobs on either deque go
+ * before any LOW job. The hint is a preference, not a pin: a job waits for
+ * its core only while that core's worker is busy and the other one has
+ * work of its own.
+ *
+ * Jobs run to completion and must not block for long (a worker blocked is
+ * a core's idle time lost to every other job); they must not wait on
+ * other jobs. Submission never blocks: a full deque returns false and the
+ * caller runs the work itself.
+ *
+ * Any task may submit; before job_pool_start() (or if it failed) every
+ * submission returns false.
+ */
+
+#define JOB_POOL_DEPTH      16      // Jobs per deque (per core and priority)
+#define JOB_POOL_ANY_CORE   -1
+
+typedef void (*job_pool_fn_t)(void *arg);
+
+typedef enum {
+    JOB_POOL_HIGH = 0,      // Someone waits for the result (a frame being decoded)
+    JOB_POOL_LOW,           // Nobody waits: maintenance, precomputation
+    JOB_POOL_PRIO_COUNT
+} job_pool_prio_t;
+
+typedef struct {
+    uint32_t run[2];                 // Jobs run by each core's worker
+    uint32_t stolen[2];              // Of those, taken from the other core's deques
+    uint32_t rejected;               // Submissions refused (deque full / not started)
+    uint8_t  depth_max;              // Deepest deque seen
+} job_pool_stats_t;
+
+/**
+ * @brief Create the two workers from the task layout
+ *
+ * A worker that could run on core 0 is moved below the LVGL priority.
+ * @param handles Optional, receives both workers (for the task monitor)
+ * @return false if no worker could be created
+ */
+bool job_pool_start(TaskHandle_t handles[2]);
+
+/**
+ * @brief Workers are running (job_pool_submit() can succeed)
+ */
+bool job_pool_ready(void);
+
+/**
+ * @brief Queue fn(arg)
+ * @param core 0 / 1: the core it should preferably run on, or JOB_POOL_ANY_CORE
+ * @return false if not queued (the caller runs it, or drops it)
+ */
+bool job_pool_submit(job_pool_fn_t fn, void *arg, job_pool_prio_t prio, int core);
+
+void job_pool_get_stats(job_pool_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JOB_POOL_H
@@ -0,0 +1,261 @@
+#include "job_watch.h"
+#include "evt_trace.h"
+#include "metrics.h"
+#include "blackbox.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <stdio.h>
+
+#if CONFIG_ESP_TASK_WDT_EN && CONFIG_GOLDIE_JOB_WATCH_WDT
+#include "esp_task_wdt.h"
+#define JOB_WATCH_USE_WDT 1
+#else
+#define JOB_WATCH_USE_WDT 0
+#endif
+
+#if CONFIG_GOLDIE_PM_DFS
+#include "esp_pm.h"
+#endif
+
+static const char *TAG = "job_watch";
+
+typedef struct {
+    job_watch_stats_t stats;
+    int64_t start_us;
+    bool reported;             // Already logged as late while still running
+} job_slot_t;
+
+static job_slot_t slots[TASK_ID_COUNT];
+static metric_t *job_ms[TASK_ID_COUNT];   // goldie_job_duration_ms{task=...}
+static portMUX_TYPE watch_lock = portMUX_INITIALIZER_UNLOCKED;
+static esp_timer_handle_t check_timer = NULL;
+
+#if JOB_WATCH_USE_WDT
+static esp_task_wdt_user_handle_t wdt_user = NULL;
+static bool wdt_starved = false;
+#endif
+
+#if CONFIG_GOLDIE_PM_DFS
+static esp_pm_lock_handle_t job_boost = NULL;   // Full CPU clock while any job runs
+#endif
+
+static void job_boost_set(bool on)
+{
+#if CONFIG_GOLDIE_PM_DFS
+    if (job_boost != NULL) {
+        if (on) {
+            esp_pm_lock_acquire(job_boost);
+        } else {
+            esp_pm_lock_release(job_boost);
+        }
+    }
+#else
+    (void)on;
+#endif
+}
+
+void job_watch_begin(task_id_t id, const char *job, uint32_t deadline_ms)
+{
+    if (id >= TASK_ID_COUNT) {
+        return;
+    }
+    portENTER_CRITICAL(&watch_lock);
+    job_slot_t *s = &slots[id];
+    bool was_active = s->stats.active;
+    s->stats.job = job;
+    s->stats.deadline_ms = deadline_ms;
+    s->stats.active = true;
+    s->start_us = esp_timer_get_time();
+    s->reported = false;
+    portEXIT_CRITICAL(&watch_lock);
+    if (!was_active) {
+        job_boost_set(true);
+    }
+}
+
+uint32_t job_watch_end(task_id_t id)
+{
+    if (id >= TASK_ID_COUNT) {
+        return 0;
+    }
+    int64_t now = esp_timer_get_time();
+    uint32_t elapsed = 0;
+    uint32_t over = 0;
+    uint32_t deadline = 0;
+    const char *job = NULL;
+    int64_t start_us = 0;
+    bool was_active = false;
+
+    portENTER_CRITICAL(&watch_lock);
+    job_slot_t *s = &slots[id];
+    if (s->stats.active) {
+        was_active = true;
+        elapsed = (uint32_t)((now - s->start_us) / 1000);
+        deadline = s->stats.deadline_ms;
+        job = s->stats.job;
+        start_us = s->start_us;
+        s->stats.active = false;
+        s->stats.runs++;
+        s->stats.last_ms = elapsed;
+        if (elapsed > s->stats.worst_ms) {
+            s->stats.worst_ms = elapsed;
+        }
+        if (elapsed > deadline) {
+            over = elapsed - deadline;
+            s->stats.overruns++;
+            if (over > s->stats.worst_over_ms) {
+                s->stats.worst_over_ms = over;
+                s->stats.worst_job = job;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&watch_lock);
+    if (was_active) {
+        job_boost_set(false);
+        metrics_observe(job_ms[id], elapsed);
+        blackbox_record(BLACKBOX_JOB, (uint8_t)id, job, (uint16_t)(deadline > 0xFFFF ? 0xFFFF : deadline), elapsed);
+        EVT_TRACE_COMPLETE(job, start_us, (uint32_t)(now - start_us));
+    }
+
+    if (over > 0) {
+        ESP_LOGW(TAG, "[JOB] OVERRUN %s/%s: %lu ms (deadline %lu ms, +%lu ms)",
+                 task_layout_get(id)->name, job, (unsigned long)elapsed,
+                 (unsigned long)deadline, (unsigned long)over);
+    }
+    return elapsed;
+}
+
+bool job_watch_get(task_id_t id, job_watch_stats_t *out)
+{
+    if (id >= TASK_ID_COUNT) {
+        return false;
+    }
+    portENTER_CRITICAL(&watch_lock);
+    *out = slots[id].stats;
+    portEXIT_CRITICAL(&watch_lock);
+    return out->job != NULL;
+}
+
+void job_watch_log_report(void)
+{
+    for (int id = 0; id < TASK_ID_COUNT; id++) {
+        job_watch_stats_t st;
+        if (!job_watch_get((task_id_t)id, &st)) {
+            continue;
+        }
+        if (st.overruns > 0) {
+            ESP_LOGW(TAG, "  %-13s %5lu jobs, %lu late, last %lu ms, worst %lu ms, worst overrun +%lu ms (%s)",
+                     task_layout_get((task_id_t)id)->name, (unsigned long)st.runs,
+                     (unsigned long)st.overruns, (unsigned long)st.last_ms,
+                     (unsigned long)st.worst_ms, (unsigned long)st.worst_over_ms, st.worst_job);
+        } else {
+            ESP_LOGI(TAG, "  %-13s %5lu jobs, all on time, last %lu ms, worst %lu ms",
+                     task_layout_get((task_id_t)id)->name, (unsigned long)st.runs,
+                     (unsigned long)st.last_ms, (unsigned long)st.worst_ms);
+        }
+    }
+}
+
+/**
+ * @brief Periodic check of the jobs still running (esp_timer task)
+ */
+static void check_cb(void *arg)
+{
+    int64_t now = esp_timer_get_time();
+    bool stalled = false;
+
+    for (int id = 0; id < TASK_ID_COUNT; id++) {
+        bool report = false;
+        uint32_t elapsed = 0;
+        uint32_t deadline = 0;
+        const char *job = NULL;
+
+        portENTER_CRITICAL(&watch_lock);
+        job_slot_t *s = &slots[id];
+        if (s->stats.active) {
+            elapsed = (uint32_t)((now - s->start_us) / 1000);
+            deadline = s->stats.deadline_ms;
+            job = s->stats.job;
+            if (elapsed > deadline && !s->reported) {
+                s->reported = true;
+                report = true;
+            }
+            if (elapsed > deadline * CONFIG_GOLDIE_JOB_WATCH_WDT_FACTOR) {
+                stalled = true;
+            }
+        }
+        portEXIT_CRITICAL(&watch_lock);
+
+        if (report) {
+            blackbox_record(BLACKBOX_LATE, (uint8_t)id, job, (uint16_t)(deadline > 0xFFFF ? 0xFFFF : deadline), elapsed);
+            ESP_LOGW(TAG, "[JOB] %s/%s still running after %lu ms (deadline %lu ms)",
+                     task_layout_get((task_id_t)id)->name, job,
+                     (unsigned long)elapsed, (unsigned long)deadline);
+        }
+    }
+
+#if JOB_WATCH_USE_WDT
+    if (wdt_user == NULL) {
+        return;
+    }
+    if (!stalled) {
+        esp_task_wdt_reset_user(wdt_user);
+        wdt_starved = false;
+    } else if (!wdt_starved) {
+        wdt_starved = true;
+        ESP_LOGE(TAG, "[JOB] A job is past %dx its deadline - no longer feeding the task watchdog",
+                 CONFIG_GOLDIE_JOB_WATCH_WDT_FACTOR);
+    }
+#else
+    (void)stalled;
+#endif
+}
+
+void job_watch_init(void)
+{
+    if (check_timer != NULL) {
+        return;
+    }
+
+    for (int id = 0; id < TASK_ID_COUNT; id++) {
+        char labels[METRICS_LABELS_MAX];
+        snprintf(labels, sizeof(labels), "task=\"%s\"", task_layout_get((task_id_t)id)->name);
+        job_ms[id] = metrics_histogram("goldie_job_duration_ms", labels, "Watched job run time per task (ms)");
+    }
+
+#if CONFIG_GOLDIE_PM_DFS
+    if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "jobs", &job_boost) != ESP_OK) {
+        job_boost = NULL;
+        ESP_LOGW(TAG, "No PM lock - jobs run at whatever clock the UI leaves");
+    }
+#endif
+
+    const esp_timer_create_args_t args = {
+        .callback = check_cb,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "job_watch",
+        .skip_unhandled_events = true,
+    };
+    if (esp_timer_create(&args, &check_timer) != ESP_OK ||
+        esp_timer_start_periodic(check_timer, JOB_WATCH_CHECK_MS * 1000) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to start the job deadline checker - overruns are only reported at job end");
+        return;
+    }
+
+#if JOB_WATCH_USE_WDT
+    esp_err_t err = esp_task_wdt_add_user("goldie_jobs", &wdt_user);
+    if (err != ESP_OK) {
+        wdt_user = NULL;
+        ESP_LOGW(TAG, "Task watchdog user not registered (%s) - deadlines are logged only",
+                 esp_err_to_name(err));
+    } else {
+        ESP_LOGI(TAG, "Job deadlines armed (task watchdog trips past %dx a deadline)",
+                 CONFIG_GOLDIE_JOB_WATCH_WDT_FACTOR);
+    }
+#else
+    ESP_LOGI(TAG, "Job deadlines armed (logging only)");
+#endif
+}
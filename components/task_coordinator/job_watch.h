@@ -0,0 +1,83 @@
+#ifndef JOB_WATCH_H
+#define JOB_WATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "task_layout.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Job Watch - run-time deadlines for coordinator jobs
+ *
+ * Every unit of work a coordinator task runs (mood evaluation, frame load,
+ * Groq query, Blynk push, WiFi bring-up) is bracketed by job_watch_begin()
+ * / job_watch_end() with the deadline it is expected to meet. One job per
+ * task can be active at a time.
+ *
+ *   - A job that finishes late logs an OVERRUN report (job, time, deadline,
+ *     by how much) and counts towards its task's overrun stats.
+ *   - A checker (esp_timer, every JOB_WATCH_CHECK_MS) reports a job that is
+ *     still running past its deadline, so a stall shows up while it
+ *     happens and not only once it ends.
+ *   - With CONFIG_GOLDIE_JOB_WATCH_WDT the checker is a task watchdog user
+ *     and stops feeding it once a job runs past
+ *     CONFIG_GOLDIE_JOB_WATCH_WDT_FACTOR x its deadline: slow I/O only
+ *     logs, a real stall trips the TWDT (backtrace, or panic if configured).
+ *   - With CONFIG_GOLDIE_PM_DFS a running job holds a CPU_FREQ_MAX PM lock:
+ *     between jobs the power manager may drop the clock.
+ */
+
+#ifndef CONFIG_GOLDIE_JOB_WATCH_WDT_FACTOR
+#define CONFIG_GOLDIE_JOB_WATCH_WDT_FACTOR 3
+#endif
+
+#define JOB_WATCH_CHECK_MS  500
+
+typedef struct {
+    const char *job;           // Current or last job (NULL = none yet)
+    bool     active;
+    uint32_t deadline_ms;      // Of the current or last job
+    uint32_t runs;
+    uint32_t overruns;
+    uint32_t last_ms;          // Duration of the last finished job
+    uint32_t worst_ms;         // Longest job since boot
+    uint32_t worst_over_ms;    // Largest overrun since boot
+    const char *worst_job;     // Job that overran by worst_over_ms
+} job_watch_stats_t;
+
+/**
+ * @brief Start the deadline checker (and register the watchdog user)
+ */
+void job_watch_init(void);
+
+/**
+ * @brief A task starts a job that should finish within deadline_ms
+ * @param job Static string, e.g. "groq_query"
+ */
+void job_watch_begin(task_id_t id, const char *job, uint32_t deadline_ms);
+
+/**
+ * @brief The task's current job finished
+ * @return Elapsed time in ms (0 if no job was active)
+ */
+uint32_t job_watch_end(task_id_t id);
+
+/**
+ * @brief Copy one task's job stats
+ * @return false if the task never ran a watched job
+ */
+bool job_watch_get(task_id_t id, job_watch_stats_t *out);
+
+/**
+ * @brief Log one line per task that ran watched jobs
+ */
+void job_watch_log_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JOB_WATCH_H
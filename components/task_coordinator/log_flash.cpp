@@ -0,0 +1,325 @@
+#include "log_flash.h"
+#include "io_sched.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include <string.h>
+
+static const char *TAG = "log_flash";
+
+#define LOG_FLASH_MAGIC        0x4C464C47   // "GLFL"
+#define LOG_FLASH_SUBTYPE      0x42
+#define LOG_FLASH_DRAINED      0x0000       // `reserved` once copied to SD
+#define LOG_FLASH_WAITING      0xFFFF       // `reserved` as written
+#define CHUNK_SLOTS            16           // Read granularity (512 bytes)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;                  // Increments with every sector started
+    uint8_t reserved[20];
+    uint32_t crc32;                // Over the fields above
+} log_flash_header_t;
+
+static_assert(sizeof(log_flash_header_t) == sizeof(sd_log_disk_record_t), "Header fills slot 0");
+static_assert(LOG_FLASH_SLOTS % CHUNK_SLOTS == 0, "Chunks must tile a sector");
+
+static const esp_partition_t *part = NULL;
+static uint16_t sectors = 0;
+static uint32_t sector_seq[LOG_FLASH_MAX_SECTORS];      // 0 = no valid header
+static uint8_t sector_waiting[LOG_FLASH_MAX_SECTORS];   // Records not yet drained
+static uint16_t head_sector, head_slot;                 // Next slot to write
+static uint32_t head_seq = 0;
+static uint16_t cur_sector, cur_slot;                   // Oldest record that may wait
+static size_t waiting = 0;
+static uint32_t lost = 0;
+
+// Last log_flash_peek()
+static uint32_t picked_off[SD_LOGGER_RING];
+static uint16_t picked_sector[SD_LOGGER_RING];
+static size_t picked_n = 0;
+static uint16_t peek_end_sector, peek_end_slot;
+
+// One 512-byte read serves 16 slots
+static sd_log_disk_record_t chunk[CHUNK_SLOTS];
+static int32_t chunk_off = -1;
+
+static inline uint32_t slot_off(uint16_t sector, uint16_t slot)
+{
+    return (uint32_t)sector * LOG_FLASH_SECTOR_SIZE + (uint32_t)slot * sizeof(sd_log_disk_record_t);
+}
+
+// CRC of a record as written (reserved still 0xFFFF)
+static uint32_t record_crc(const sd_log_disk_record_t *r)
+{
+    sd_log_disk_record_t tmp = *r;
+    tmp.reserved = LOG_FLASH_WAITING;
+    return esp_rom_crc32_le(0, (const uint8_t *)&tmp, offsetof(sd_log_disk_record_t, crc32));
+}
+
+static inline uint32_t header_crc(const log_flash_header_t *h)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)h, offsetof(log_flash_header_t, crc32));
+}
+
+static bool slot_erased(const sd_log_disk_record_t *r)
+{
+    const uint8_t *p = (const uint8_t *)r;
+    for (size_t i = 0; i < sizeof(*r); i++) {
+        if (p[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static inline bool slot_waiting(const sd_log_disk_record_t *r)
+{
+    return r->reserved == LOG_FLASH_WAITING && r->type > SD_LOG_NONE && r->type < SD_LOG_TYPE_COUNT &&
+           r->crc32 == record_crc(r);
+}
+
+static const sd_log_disk_record_t *read_slot(uint16_t sector, uint16_t slot)
+{
+    uint32_t off = slot_off(sector, (uint16_t)(slot - slot % CHUNK_SLOTS));
+    if ((int32_t)off != chunk_off) {
+        if (esp_partition_read(part, off, chunk, sizeof(chunk)) != ESP_OK) {
+            chunk_off = -1;
+            return NULL;
+        }
+        chunk_off = (int32_t)off;
+    }
+    return &chunk[slot % CHUNK_SLOTS];
+}
+
+/**
+ * @brief Scan one sector: waiting records and (for the head) the first free slot
+ */
+static void scan_sector(uint16_t s)
+{
+    uint16_t last_used = 0;
+    for (uint16_t slot = 1; slot < LOG_FLASH_SLOTS; slot++) {
+        const sd_log_disk_record_t *r = read_slot(s, slot);
+        if (r == NULL) {
+            return;
+        }
+        if (!slot_erased(r)) {
+            last_used = slot;
+        }
+        if (slot_waiting(r)) {
+            sector_waiting[s]++;
+            waiting++;
+        }
+    }
+    if (s == head_sector) {
+        head_slot = (uint16_t)(last_used + 1);
+    }
+}
+
+extern "C" esp_err_t log_flash_init(void)
+{
+    part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)LOG_FLASH_SUBTYPE,
+                                    LOG_FLASH_PARTITION_LABEL);
+    if (part == NULL) {
+        ESP_LOGI(TAG, "No '%s' partition - records are dropped without an SD card", LOG_FLASH_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+    sectors = (uint16_t)(part->size / LOG_FLASH_SECTOR_SIZE);
+    if (sectors > LOG_FLASH_MAX_SECTORS) {
+        sectors = LOG_FLASH_MAX_SECTORS;
+    }
+    if (sectors < 2) {
+        ESP_LOGE(TAG, "'%s' partition too small", LOG_FLASH_PARTITION_LABEL);
+        part = NULL;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // Head = sector with the newest header; empty partition: the first
+    // append starts sector 0
+    head_sector = (uint16_t)(sectors - 1);
+    head_slot = LOG_FLASH_SLOTS;
+    for (uint16_t s = 0; s < sectors; s++) {
+        log_flash_header_t h;
+        sector_seq[s] = 0;
+        sector_waiting[s] = 0;
+        if (esp_partition_read(part, slot_off(s, 0), &h, sizeof(h)) == ESP_OK &&
+            h.magic == LOG_FLASH_MAGIC && h.crc32 == header_crc(&h) && h.seq != 0) {
+            sector_seq[s] = h.seq;
+            if (h.seq > head_seq) {
+                head_seq = h.seq;
+                head_sector = s;
+            }
+        }
+    }
+    for (uint16_t s = 0; s < sectors; s++) {
+        if (sector_seq[s] != 0) {
+            scan_sector(s);
+        }
+    }
+
+    // Oldest sector still holding records, in write order after the head
+    cur_sector = head_sector;
+    cur_slot = head_slot;
+    for (uint16_t i = 1; i <= sectors && waiting > 0; i++) {
+        uint16_t s = (uint16_t)((head_sector + i) % sectors);
+        if (sector_waiting[s] > 0) {
+            cur_sector = s;
+            cur_slot = 1;
+            break;
+        }
+    }
+
+    ESP_LOGI(TAG, "'%s': %u sectors, %u record(s) waiting for SD", LOG_FLASH_PARTITION_LABEL,
+             (unsigned)sectors, (unsigned)waiting);
+    return ESP_OK;
+}
+
+extern "C" bool log_flash_ready(void)
+{
+    return part != NULL;
+}
+
+/**
+ * @brief Start the next sector: erase it and write its header
+ */
+static bool advance_head(void)
+{
+    uint16_t next = (uint16_t)((head_sector + 1) % sectors);
+    if (sector_waiting[next] > 0) {
+        lost += sector_waiting[next];
+        waiting -= sector_waiting[next];
+        ESP_LOGW(TAG, "Log full - %u oldest record(s) overwritten (%lu lost since boot)",
+                 (unsigned)sector_waiting[next], (unsigned long)lost);
+        sector_waiting[next] = 0;
+    }
+    if (cur_sector == next) {
+        cur_sector = (uint16_t)((next + 1) % sectors);
+        cur_slot = 1;
+    }
+
+    chunk_off = -1;
+    if (esp_partition_erase_range(part, slot_off(next, 0), LOG_FLASH_SECTOR_SIZE) != ESP_OK) {
+        ESP_LOGE(TAG, "Erasing sector %u failed", (unsigned)next);
+        return false;
+    }
+    log_flash_header_t h;
+    memset(&h, 0xFF, sizeof(h));
+    h.magic = LOG_FLASH_MAGIC;
+    h.seq = ++head_seq;
+    h.crc32 = header_crc(&h);
+    if (esp_partition_write(part, slot_off(next, 0), &h, sizeof(h)) != ESP_OK) {
+        ESP_LOGE(TAG, "Writing sector %u header failed", (unsigned)next);
+        return false;
+    }
+    sector_seq[next] = h.seq;
+    head_sector = next;
+    head_slot = 1;
+    if (waiting == 0) {
+        cur_sector = head_sector;
+        cur_slot = head_slot;
+    }
+    return true;
+}
+
+extern "C" bool log_flash_append(const sd_log_disk_record_t *rec)
+{
+    if (part == NULL) {
+        return false;
+    }
+    // A user's record: ahead of maintenance, behind a frame load from flash
+    io_sched_begin(IO_SCHED_FLASH, IO_SCHED_LOG, portMAX_DELAY);
+    if (head_slot >= LOG_FLASH_SLOTS && !advance_head()) {
+        io_sched_end(IO_SCHED_FLASH, IO_SCHED_LOG);
+        return false;
+    }
+    sd_log_disk_record_t r = *rec;
+    r.reserved = LOG_FLASH_WAITING;
+    r.crc32 = record_crc(&r);
+    chunk_off = -1;
+    uint16_t slot = head_slot++;  // A failed write leaves a slot that is skipped
+    esp_err_t err = esp_partition_write(part, slot_off(head_sector, slot), &r, sizeof(r));
+    io_sched_end(IO_SCHED_FLASH, IO_SCHED_LOG);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Writing record failed");
+        return false;
+    }
+    sector_waiting[head_sector]++;
+    waiting++;
+    return true;
+}
+
+extern "C" size_t log_flash_pending(void)
+{
+    return waiting;
+}
+
+extern "C" size_t log_flash_peek(sd_log_disk_record_t *out, size_t max)
+{
+    picked_n = 0;
+    if (part == NULL || waiting == 0) {
+        return 0;
+    }
+    if (max > SD_LOGGER_RING) {
+        max = SD_LOGGER_RING;
+    }
+
+    uint16_t s = cur_sector, slot = cur_slot;
+    bool first = true;
+    while (picked_n < max && !(s == head_sector && slot >= head_slot)) {
+        if (slot >= LOG_FLASH_SLOTS || sector_waiting[s] == 0) {
+            if (s == head_sector) {
+                break;
+            }
+            s = (uint16_t)((s + 1) % sectors);
+            slot = 1;
+            continue;
+        }
+        const sd_log_disk_record_t *r = read_slot(s, slot);
+        if (r == NULL) {
+            break;
+        }
+        if (slot_waiting(r)) {
+            if (first) {
+                cur_sector = s;  // Skip the drained part next time
+                cur_slot = slot;
+                first = false;
+            }
+            out[picked_n] = *r;
+            out[picked_n].reserved = 0;
+            picked_off[picked_n] = slot_off(s, slot);
+            picked_sector[picked_n] = s;
+            picked_n++;
+        }
+        slot++;
+    }
+    peek_end_sector = s;
+    peek_end_slot = slot;
+    return picked_n;
+}
+
+extern "C" void log_flash_mark_drained(void)
+{
+    const uint16_t drained = LOG_FLASH_DRAINED;
+    bool all = true;
+    chunk_off = -1;
+    io_sched_begin(IO_SCHED_FLASH, IO_SCHED_BACKGROUND, portMAX_DELAY);
+    for (size_t i = 0; i < picked_n; i++) {
+        // A sector overwritten since the peek has nothing left to mark
+        if (sector_waiting[picked_sector[i]] == 0) {
+            continue;
+        }
+        if (esp_partition_write(part, picked_off[i] + offsetof(sd_log_disk_record_t, reserved),
+                                &drained, sizeof(drained)) != ESP_OK) {
+            ESP_LOGW(TAG, "Marking record drained failed - it will be copied again");
+            all = false;
+            continue;
+        }
+        sector_waiting[picked_sector[i]]--;
+        waiting--;
+    }
+    io_sched_end(IO_SCHED_FLASH, IO_SCHED_BACKGROUND);
+    picked_n = 0;
+    if (all) {
+        cur_sector = peek_end_sector;
+        cur_slot = peek_end_slot;
+    }
+}
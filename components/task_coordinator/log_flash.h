@@ -0,0 +1,77 @@
+#ifndef LOG_FLASH_H
+#define LOG_FLASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "sd_logger.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Log Flash - fallback store for SD logger records without a card
+ *
+ * A raw data partition labelled "logflash" (partitions*.csv), no
+ * filesystem: 4 KB sectors used as a circular log. Slot 0 of a sector is
+ * a header (magic, sequence number, CRC), slots 1-127 hold
+ * sd_log_disk_record_t exactly as they go to SD. Records are appended at
+ * the head; a full sector moves the head to the next one, which is erased
+ * first, so every sector takes its turn and erases spread evenly over the
+ * partition. When the head catches up with records still waiting, the
+ * oldest sector's records are lost (counted).
+ *
+ * A record's `reserved` field is written as 0xFFFF (the CRC covers that
+ * value) and programmed to 0 once the record has been copied to SD - a
+ * 1 -> 0 bit change needs no erase, so draining costs no wear.
+ *
+ * log_flash_init() finds the head and the oldest waiting record in one
+ * scan. Worker side (sd_logger task) only.
+ */
+
+#define LOG_FLASH_PARTITION_LABEL  "logflash"
+#define LOG_FLASH_SECTOR_SIZE      4096
+#define LOG_FLASH_SLOTS            (LOG_FLASH_SECTOR_SIZE / sizeof(sd_log_disk_record_t))
+#define LOG_FLASH_MAX_SECTORS      64      // Larger partitions use the first 256 KB
+
+/**
+ * @brief Find the partition and scan it
+ * @return ESP_OK, ESP_ERR_NOT_FOUND without a "logflash" partition
+ */
+esp_err_t log_flash_init(void);
+
+/**
+ * @brief true once log_flash_init() has found the partition
+ */
+bool log_flash_ready(void);
+
+/**
+ * @brief Append one record (crc32 is computed here)
+ */
+bool log_flash_append(const sd_log_disk_record_t *rec);
+
+/**
+ * @brief Records not yet copied to SD
+ */
+size_t log_flash_pending(void);
+
+/**
+ * @brief Copy up to `max` of the oldest waiting records to `out`
+ *
+ * They stay waiting until log_flash_mark_drained(); reading again
+ * before that returns the same records.
+ */
+size_t log_flash_peek(sd_log_disk_record_t *out, size_t max);
+
+/**
+ * @brief The records of the last log_flash_peek() are safely on SD
+ */
+void log_flash_mark_drained(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOG_FLASH_H
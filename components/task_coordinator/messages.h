@@ -3,6 +3,8 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "text_buf.h"
+#include "aquarium_types.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -12,42 +14,47 @@ extern "C" {
  * STEP 2: Real message types for mood calculation
  * 
  * CONSTRAINT: No bulk data in queues (metadata only)
- * These structures contain parameter values, not bulk image data
+ * These structures contain parameter values, not bulk image data.
+ * The parameters, mood results and reminders aquarium_core computes are
+ * its own types (aquarium_types.h) and travel here as they are.
  */
 
-// Aquarium parameters for mood calculation
+// Every tank's parameters in one mailbox item (LVGL -> logic), so a newer
+// state of one tank never drops the pending state of another
 typedef struct {
-    float ammonia_ppm;
-    float nitrite_ppm;
-    float nitrate_ppm;
-    float ph_level;
-    uint32_t last_feed_time;
-    uint32_t last_clean_time;
-    uint32_t planned_feed_interval;
-    uint32_t planned_water_change_interval;
-} aquarium_params_t;
+    aquarium_params_t tank[TANK_MAX];
+    uint8_t dirty;             // Bit per tank edited since the last send
+    uint8_t active;            // Tank on screen (AI advice and reason follow it)
+} tank_params_msg_t;
+
+// Battery and supply state (power_monitor, MSG_TOPIC_POWER_STATUS)
+#define POWER_FLAG_BATTERY   0x01   // Battery connected
+#define POWER_FLAG_CHARGING  0x02
+#define POWER_FLAG_VBUS      0x04   // USB power present
 
-// Mood calculation result
 typedef struct {
-    int ammonia_score;
-    int nitrite_score;
-    int nitrate_score;
-    int ph_score;
-    int feed_score;
-    int clean_score;
-    int total_score;
-    uint8_t category;  // 0=HAPPY, 1=SAD, 2=ANGRY
-} mood_result_t;
+    uint16_t batt_mv;
+    uint16_t vbus_mv;
+    int8_t   batt_pct;         // Fuel gauge, -1 = no battery
+    uint8_t  flags;            // POWER_FLAG_*
+    uint32_t timestamp;        // Seconds since boot of the reading
+} power_status_t;
 
-// Placeholder: Animation frame request (index only)
+// Animation frame request. Rows [row_from, row_to) are the part of the
+// animation on screen; row_to = 0 asks for the whole frame
 typedef struct {
     uint8_t frame_index;   // Absolute frame number (0-23)
+    uint16_t row_from;
+    uint16_t row_to;
 } anim_frame_request_msg_t;
 
-// Placeholder: Animation frame ready notification (index only)
+// Animation frame ready notification; only rows [row_from, row_to) of the
+// slot belong to the frame (row_to = 0: all of them)
 typedef struct {
     uint8_t frame_index;   // Which frame is ready
     uint8_t buffer_slot;   // Which pool buffer contains it
+    uint16_t row_from;
+    uint16_t row_to;
 } anim_frame_ready_msg_t;
 
 // STEP 4: AI request (parameters for cloud query)
@@ -60,12 +67,17 @@ typedef struct {
     int feeds_per_day;
     int water_change_interval;
     uint32_t timestamp;  // For rate limiting
+    uint32_t prefetch_at;  // 0 = for the screen; else prefetch the advice of this uptime (logic_task)
+    uint32_t chat_seq;     // 0 = advice; else answer this owner turn (ai_chat.h, "Ask Goldie")
 } ai_request_msg_t;
 
 // STEP 4: AI result (advice text)
 typedef struct {
     bool success;
-    char advice[512];  // AI response text
+    bool partial;          // Streamed reply so far; the final result follows
+    bool chat;             // Ask Goldie answer (a final one is also in ai_chat.h)
+    text_buf_t *advice;    // AI response text (owned by the message, may be NULL)
+    text_buf_t *summary;   // One-line summary of it for Blynk (owned by the message, may be NULL)
 } ai_result_msg_t;
 
 // STEP 5: Blynk sync data (snapshot of current state)
@@ -77,9 +89,16 @@ typedef struct {
     float feed_hours;      // Hours since last feed
     float clean_days;      // Days since last clean
     char mood[16];         // "HAPPY", "SAD", or "ANGRY"
-    char ai_advice[512];   // Latest AI advice text
+    text_buf_t *ai_advice; // Latest AI advice text (owned by the message, may be NULL)
+    uint32_t timestamp;    // Seconds since boot, for the telemetry job deadline
 } blynk_sync_msg_t;
 
+// Task monitor sample (stack / CPU summary for Blynk)
+typedef struct {
+    text_buf_t *summary;       // "logic_task 30% ... | C0 35% C1 12%" (owned by the message)
+    uint8_t worst_stack_pct;   // Highest stack use of any task
+} task_stats_msg_t;
+
 #ifdef __cplusplus
 }
 #endif
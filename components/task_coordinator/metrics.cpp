@@ -0,0 +1,223 @@
+#include "metrics.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "metrics";
+
+#define METRICS_HIST_MAX  16      // Histograms among the METRICS_MAX entries
+#define METRICS_LINE_MAX  256
+
+typedef enum {
+    METRIC_COUNTER = 0,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM,
+} metric_type_t;
+
+typedef struct {
+    uint32_t bucket[METRICS_HIST_BUCKETS + 1];   // Last = above 2^(BUCKETS-1)
+    uint64_t sum;
+} metric_hist_t;
+
+struct metric {
+    const char *name;
+    const char *help;
+    metric_type_t type;
+    int32_t value;                 // Counter (as uint32) / gauge
+    metric_hist_t *hist;
+    char labels[METRICS_LABELS_MAX];
+};
+
+static metric_t table[METRICS_MAX];
+static metric_hist_t hists[METRICS_HIST_MAX];
+static uint8_t metric_count = 0;   // Entries below this are complete
+static uint8_t hist_count = 0;
+static portMUX_TYPE register_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static metric_t *metric_register(const char *name, const char *labels, const char *help, metric_type_t type)
+{
+    if (labels == NULL) {
+        labels = "";
+    }
+    metric_t *m = NULL;
+    bool full = false;
+    portENTER_CRITICAL(&register_lock);
+    for (uint8_t i = 0; i < metric_count; i++) {
+        if (strcmp(table[i].name, name) == 0 && strncmp(table[i].labels, labels, METRICS_LABELS_MAX - 1) == 0) {
+            m = &table[i];
+            break;
+        }
+    }
+    if (m == NULL) {
+        if (metric_count >= METRICS_MAX || (type == METRIC_HISTOGRAM && hist_count >= METRICS_HIST_MAX)) {
+            full = true;
+        } else {
+            m = &table[metric_count];
+            m->name = name;
+            m->help = help;
+            m->type = type;
+            m->value = 0;
+            m->hist = (type == METRIC_HISTOGRAM) ? &hists[hist_count++] : NULL;
+            strlcpy(m->labels, labels, sizeof(m->labels));
+            // Readers take the count with acquire: the entry is filled first
+            __atomic_store_n(&metric_count, (uint8_t)(metric_count + 1), __ATOMIC_RELEASE);
+        }
+    }
+    portEXIT_CRITICAL(&register_lock);
+    if (full) {
+        ESP_LOGW(TAG, "Metrics table full - %s{%s} not recorded", name, labels);
+    }
+    return m;
+}
+
+metric_t *metrics_counter(const char *name, const char *labels, const char *help)
+{
+    return metric_register(name, labels, help, METRIC_COUNTER);
+}
+
+metric_t *metrics_gauge(const char *name, const char *labels, const char *help)
+{
+    return metric_register(name, labels, help, METRIC_GAUGE);
+}
+
+metric_t *metrics_histogram(const char *name, const char *labels, const char *help)
+{
+    return metric_register(name, labels, help, METRIC_HISTOGRAM);
+}
+
+void metrics_inc(metric_t *m, uint32_t n)
+{
+    if (m != NULL) {
+        __atomic_fetch_add(&m->value, (int32_t)n, __ATOMIC_RELAXED);
+    }
+}
+
+void metrics_add(metric_t *m, int32_t delta)
+{
+    if (m != NULL) {
+        __atomic_fetch_add(&m->value, delta, __ATOMIC_RELAXED);
+    }
+}
+
+void metrics_set(metric_t *m, int32_t value)
+{
+    if (m != NULL) {
+        __atomic_store_n(&m->value, value, __ATOMIC_RELAXED);
+    }
+}
+
+void metrics_observe(metric_t *m, uint32_t value)
+{
+    if (m == NULL || m->hist == NULL) {
+        return;
+    }
+    // Smallest b with value <= 2^b
+    uint32_t b = (value <= 1) ? 0 : 32 - __builtin_clz(value - 1);
+    if (b > METRICS_HIST_BUCKETS) {
+        b = METRICS_HIST_BUCKETS;
+    }
+    __atomic_fetch_add(&m->hist->bucket[b], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&m->hist->sum, (uint64_t)value, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief uint64 as decimal without %llu
+ */
+static int format_u64(char *buf, size_t len, uint64_t v)
+{
+    uint32_t hi = (uint32_t)(v / 1000000000ULL);
+    uint32_t lo = (uint32_t)(v % 1000000000ULL);
+    return hi ? snprintf(buf, len, "%lu%09lu", (unsigned long)hi, (unsigned long)lo)
+              : snprintf(buf, len, "%lu", (unsigned long)lo);
+}
+
+static bool emit(metrics_write_fn write, void *ctx, const char *line, int len)
+{
+    if (len <= 0) {
+        return true;
+    }
+    if (len >= METRICS_LINE_MAX) {
+        len = METRICS_LINE_MAX - 1;
+    }
+    return write(ctx, line, (size_t)len);
+}
+
+static bool export_one(const metric_t *m, metrics_write_fn write, void *ctx)
+{
+    char line[METRICS_LINE_MAX];
+    const char *open = m->labels[0] ? "{" : "";
+    const char *close = m->labels[0] ? "}" : "";
+    int len;
+
+    if (m->type != METRIC_HISTOGRAM) {
+        int32_t v = __atomic_load_n(&m->value, __ATOMIC_RELAXED);
+        if (m->type == METRIC_COUNTER) {
+            len = snprintf(line, sizeof(line), "%s%s%s%s %lu\n", m->name, open, m->labels, close, (unsigned long)(uint32_t)v);
+        } else {
+            len = snprintf(line, sizeof(line), "%s%s%s%s %ld\n", m->name, open, m->labels, close, (long)v);
+        }
+        return emit(write, ctx, line, len);
+    }
+
+    // Copy first: counts keep moving while the lines go out
+    metric_hist_t h;
+    for (int b = 0; b <= METRICS_HIST_BUCKETS; b++) {
+        h.bucket[b] = __atomic_load_n(&m->hist->bucket[b], __ATOMIC_RELAXED);
+    }
+    h.sum = __atomic_load_n(&m->hist->sum, __ATOMIC_RELAXED);
+
+    const char *sep = m->labels[0] ? "," : "";
+    uint32_t cumulative = 0;
+    for (int b = 0; b <= METRICS_HIST_BUCKETS; b++) {
+        cumulative += h.bucket[b];
+        char le[12];
+        if (b < METRICS_HIST_BUCKETS) {
+            snprintf(le, sizeof(le), "%lu", (unsigned long)(1UL << b));
+        } else {
+            strcpy(le, "+Inf");
+        }
+        len = snprintf(line, sizeof(line), "%s_bucket{%s%sle=\"%s\"} %lu\n",
+                       m->name, m->labels, sep, le, (unsigned long)cumulative);
+        if (!emit(write, ctx, line, len)) {
+            return false;
+        }
+    }
+    char sum_text[24];
+    format_u64(sum_text, sizeof(sum_text), h.sum);
+    // _count is the +Inf bucket, as the format requires
+    len = snprintf(line, sizeof(line), "%s_sum%s%s%s %s\n%s_count%s%s%s %lu\n",
+                   m->name, open, m->labels, close, sum_text,
+                   m->name, open, m->labels, close, (unsigned long)cumulative);
+    return emit(write, ctx, line, len);
+}
+
+bool metrics_export(metrics_write_fn write, void *ctx)
+{
+    static const char *type_names[] = { "counter", "gauge", "histogram" };
+    uint8_t count = __atomic_load_n(&metric_count, __ATOMIC_ACQUIRE);
+    char line[METRICS_LINE_MAX];
+
+    for (uint8_t i = 0; i < count; i++) {
+        // One family per name: the first entry writes the header and the
+        // rest of the series that share its name
+        bool seen = false;
+        for (uint8_t j = 0; j < i && !seen; j++) {
+            seen = strcmp(table[j].name, table[i].name) == 0;
+        }
+        if (seen) {
+            continue;
+        }
+        int len = snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s %s\n",
+                           table[i].name, table[i].help, table[i].name, type_names[table[i].type]);
+        if (!emit(write, ctx, line, len)) {
+            return false;
+        }
+        for (uint8_t j = i; j < count; j++) {
+            if (strcmp(table[j].name, table[i].name) == 0 && !export_one(&table[j], write, ctx)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
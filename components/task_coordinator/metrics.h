@@ -0,0 +1,85 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Metrics - fixed-memory counters, gauges and histograms for scraping
+ *
+ * A subsystem registers its metrics once (any task, usually at init) and
+ * keeps the handle; updates are single atomic operations, so any task on
+ * either core, or an ISR, can count without a lock. Registration looks the
+ * name + labels up first, so registering twice returns the same metric.
+ *
+ *   counter    monotonic count (metrics_inc), or a mirror of a count kept
+ *              elsewhere (metrics_set)
+ *   gauge      current value (metrics_set / metrics_add)
+ *   histogram  METRICS_HIST_BUCKETS power-of-two buckets: bucket b holds
+ *              values <= 2^b, the last one everything above; plus the
+ *              sum and count
+ *
+ * metrics_export() writes every metric in the Prometheus text format
+ * (0.0.4), one HELP / TYPE header per name, so a scraper can compare the
+ * same series across units. GET /metrics serves it (device_api.h).
+ *
+ * The table holds METRICS_MAX entries; past that a registration returns
+ * NULL, which every update accepts as a no-op.
+ */
+
+#define METRICS_MAX           64
+#define METRICS_HIST_BUCKETS  16      // le 1, 2, 4 ... 32768, then +Inf
+#define METRICS_LABELS_MAX    32      // `key="value"` text, copied
+
+typedef struct metric metric_t;
+
+/**
+ * @brief Sink for metrics_export() (false = stop writing)
+ */
+typedef bool (*metrics_write_fn)(void *ctx, const char *data, size_t len);
+
+/**
+ * @param name   Static string, e.g. "goldie_frames_loaded_total"
+ * @param labels NULL or e.g. "task=\"ai\"" (copied)
+ * @param help   Static string, one line
+ */
+metric_t *metrics_counter(const char *name, const char *labels, const char *help);
+metric_t *metrics_gauge(const char *name, const char *labels, const char *help);
+metric_t *metrics_histogram(const char *name, const char *labels, const char *help);
+
+/**
+ * @brief Add n to a counter (or gauge)
+ */
+void metrics_inc(metric_t *m, uint32_t n);
+
+/**
+ * @brief Add a signed delta to a gauge
+ */
+void metrics_add(metric_t *m, int32_t delta);
+
+/**
+ * @brief Set a gauge, or a counter mirrored from another monotonic count
+ */
+void metrics_set(metric_t *m, int32_t value);
+
+/**
+ * @brief Count one histogram observation
+ */
+void metrics_observe(metric_t *m, uint32_t value);
+
+/**
+ * @brief Write all metrics as Prometheus text
+ * @return false if the sink stopped the export
+ */
+bool metrics_export(metrics_write_fn write, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // METRICS_H
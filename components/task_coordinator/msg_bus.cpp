@@ -0,0 +1,267 @@
+#include "msg_bus.h"
+#include "messages.h"
+#include "evt_trace.h"
+#include "input_rec.h"
+#include "metrics.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "msg_bus";
+
+struct msg_bus_sub {
+    const char *name;
+    msg_topic_t topic;
+    uint8_t flags;
+    QueueHandle_t queue;        // uint8_t slot ids
+    msg_bus_notify_t notify;
+    void *arg;
+    uint32_t delivered;
+    uint32_t dropped;
+};
+
+static msg_bus_msg_t pool[MSG_BUS_POOL_SLOTS];
+static QueueHandle_t free_slots = NULL;        // uint8_t slot ids
+static msg_bus_sub_t subs[MSG_BUS_MAX_SUBS];
+static volatile uint8_t sub_count = 0;
+static portMUX_TYPE sub_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t publish_seq = 0;
+static uint32_t pool_empty = 0;
+static msg_bus_release_hook_t release_hooks[MSG_TOPIC_COUNT];
+static msg_bus_rec_encode_t rec_encoders[MSG_TOPIC_COUNT];
+static msg_bus_rec_decode_t rec_decoders[MSG_TOPIC_COUNT];
+static metric_t *m_published = NULL;
+static metric_t *m_dropped = NULL;
+
+static_assert(sizeof(mood_result_t) <= MSG_BUS_PAYLOAD_MAX, "mood_result_t too large for the bus");
+static_assert(sizeof(ai_result_msg_t) <= MSG_BUS_PAYLOAD_MAX, "ai_result_msg_t too large for the bus");
+static_assert(sizeof(blynk_sync_msg_t) <= MSG_BUS_PAYLOAD_MAX, "blynk_sync_msg_t too large for the bus");
+static_assert(sizeof(task_stats_msg_t) <= MSG_BUS_PAYLOAD_MAX, "task_stats_msg_t too large for the bus");
+
+// Inputs from outside (network, PMU, clock) - recorded and replayed by
+// input_rec.h; mood results and forecasts follow from the replayed parameters
+#define RECORDED_TOPICS ((1u << MSG_TOPIC_AI_RESULT) | (1u << MSG_TOPIC_POWER_STATUS) | (1u << MSG_TOPIC_REMINDER))
+
+static void slot_unref(msg_bus_msg_t *msg)
+{
+    if (__atomic_sub_fetch(&msg->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        if (release_hooks[msg->topic]) {
+            release_hooks[msg->topic](msg->data);
+        }
+        uint8_t slot = msg->slot;
+        xQueueSend(free_slots, &slot, 0);
+    }
+}
+
+/**
+ * @brief Replays a recorded publish (input_rec.h replayer)
+ */
+static void bus_replay_sink(uint8_t topic, const uint8_t *data, size_t len)
+{
+    uint32_t payload[(MSG_BUS_PAYLOAD_MAX + 3) / 4];
+    if (topic >= MSG_TOPIC_COUNT) {
+        return;
+    }
+    if (rec_decoders[topic]) {
+        len = rec_decoders[topic](data, len, payload);
+    } else if (len <= MSG_BUS_PAYLOAD_MAX) {
+        memcpy(payload, data, len);
+    } else {
+        len = 0;
+    }
+    if (len > 0) {
+        msg_bus_publish((msg_topic_t)topic, payload, len);
+    }
+}
+
+esp_err_t msg_bus_init(void)
+{
+    if (free_slots) {
+        return ESP_OK;
+    }
+    free_slots = xQueueCreate(MSG_BUS_POOL_SLOTS, sizeof(uint8_t));
+    if (!free_slots) {
+        ESP_LOGE(TAG, "Failed to create slot free list");
+        return ESP_ERR_NO_MEM;
+    }
+    for (uint8_t i = 0; i < MSG_BUS_POOL_SLOTS; i++) {
+        pool[i].slot = i;
+        xQueueSend(free_slots, &i, 0);
+    }
+    m_published = metrics_counter("goldie_bus_published_total", NULL, "Messages published on the bus");
+    m_dropped = metrics_counter("goldie_bus_dropped_total", NULL, "Messages lost to a full pool or subscriber queue");
+    input_rec_set_sink(INPUT_REC_BUS, bus_replay_sink);
+    ESP_LOGI(TAG, "Message bus ready (%d slots x %d bytes, %d topics)",
+             MSG_BUS_POOL_SLOTS, MSG_BUS_PAYLOAD_MAX, MSG_TOPIC_COUNT);
+    return ESP_OK;
+}
+
+void msg_bus_set_release_hook(msg_topic_t topic, msg_bus_release_hook_t hook)
+{
+    if (topic < MSG_TOPIC_COUNT) {
+        release_hooks[topic] = hook;
+    }
+}
+
+void msg_bus_set_rec_codec(msg_topic_t topic, msg_bus_rec_encode_t encode, msg_bus_rec_decode_t decode)
+{
+    if (topic < MSG_TOPIC_COUNT) {
+        rec_encoders[topic] = encode;
+        rec_decoders[topic] = decode;
+    }
+}
+
+msg_bus_sub_t *msg_bus_subscribe(const char *name, msg_topic_t topic, uint8_t depth,
+                                 uint8_t flags, msg_bus_notify_t notify, void *arg)
+{
+    if (!free_slots || topic >= MSG_TOPIC_COUNT || depth == 0) {
+        ESP_LOGE(TAG, "Cannot subscribe %s to topic %d", name, (int)topic);
+        return NULL;
+    }
+    QueueHandle_t queue = xQueueCreate(depth, sizeof(uint8_t));
+    if (!queue) {
+        ESP_LOGE(TAG, "No memory for %s subscription queue", name);
+        return NULL;
+    }
+
+    msg_bus_sub_t *sub = NULL;
+    portENTER_CRITICAL(&sub_lock);
+    if (sub_count < MSG_BUS_MAX_SUBS) {
+        sub = &subs[sub_count];
+        sub->name = name;
+        sub->topic = topic;
+        sub->flags = flags;
+        sub->queue = queue;
+        sub->notify = notify;
+        sub->arg = arg;
+        sub->delivered = 0;
+        sub->dropped = 0;
+        sub_count = sub_count + 1;  // Publishers only see the entry once it is complete
+    }
+    portEXIT_CRITICAL(&sub_lock);
+
+    if (!sub) {
+        ESP_LOGE(TAG, "Subscriber table full (%d) - %s not added", MSG_BUS_MAX_SUBS, name);
+        vQueueDelete(queue);
+        return NULL;
+    }
+    ESP_LOGI(TAG, "%s subscribed to topic %d (depth %d%s)", name, (int)topic, depth,
+             (flags & MSG_SUB_LATEST) ? ", latest only" : "");
+    return sub;
+}
+
+esp_err_t msg_bus_publish(msg_topic_t topic, const void *data, size_t len)
+{
+    if (len > MSG_BUS_PAYLOAD_MAX || topic >= MSG_TOPIC_COUNT) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (!free_slots) {
+        if (release_hooks[topic]) release_hooks[topic](data);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (RECORDED_TOPICS & (1u << topic)) {
+        if (!input_rec_live(INPUT_REC_BUS)) {
+            if (release_hooks[topic]) release_hooks[topic](data);
+            return ESP_OK;                 // A replay stands in for this source
+        }
+        if (input_rec_recording()) {
+            if (rec_encoders[topic]) {
+                rec_encoders[topic](topic, data);
+            } else {
+                input_rec_put(INPUT_REC_BUS, (uint8_t)topic, data, len);
+            }
+        }
+    }
+
+    uint8_t count = sub_count;
+    uint32_t readers = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (subs[i].topic == topic) {
+            readers++;
+        }
+    }
+    if (readers == 0) {
+        if (release_hooks[topic]) release_hooks[topic](data);
+        return ESP_OK;
+    }
+
+    uint8_t slot;
+    if (xQueueReceive(free_slots, &slot, 0) != pdTRUE) {
+        metrics_inc(m_dropped, 1);
+        if ((pool_empty++ % 16) == 0) {
+            ESP_LOGW(TAG, "Slot pool exhausted - topic %d message dropped (%lu total)",
+                     (int)topic, (unsigned long)pool_empty);
+        }
+        if (release_hooks[topic]) release_hooks[topic](data);
+        return ESP_ERR_NO_MEM;
+    }
+
+    msg_bus_msg_t *msg = &pool[slot];
+    msg->topic = (uint8_t)topic;
+    msg->len = (uint16_t)len;
+    msg->seq = __atomic_add_fetch(&publish_seq, 1, __ATOMIC_RELAXED);
+    metrics_inc(m_published, 1);
+    memcpy(msg->data, data, len);
+    // Hold one extra reference while fanning out so an early release
+    // cannot recycle the slot under us
+    msg->refs = readers + 1;
+    EVT_TRACE_INSTANT("bus_pub", ((uint32_t)topic << 24) | (msg->seq & 0xFFFFFF));
+
+    for (uint8_t i = 0; i < count; i++) {
+        msg_bus_sub_t *sub = &subs[i];
+        if (sub->topic != topic) {
+            continue;
+        }
+        bool queued = (xQueueSend(sub->queue, &slot, 0) == pdTRUE);
+        if (!queued && (sub->flags & MSG_SUB_LATEST)) {
+            uint8_t old;
+            if (xQueueReceive(sub->queue, &old, 0) == pdTRUE) {
+                slot_unref(&pool[old]);
+                sub->dropped++;
+                metrics_inc(m_dropped, 1);
+            }
+            queued = (xQueueSend(sub->queue, &slot, 0) == pdTRUE);
+        }
+        if (!queued) {
+            sub->dropped++;
+            metrics_inc(m_dropped, 1);
+            slot_unref(msg);
+            continue;
+        }
+        sub->delivered++;
+        if (sub->notify) {
+            sub->notify(sub->arg);
+        }
+    }
+    slot_unref(msg);
+    return ESP_OK;
+}
+
+const msg_bus_msg_t *msg_bus_receive(msg_bus_sub_t *sub, TickType_t wait)
+{
+    uint8_t slot;
+    if (!sub || xQueueReceive(sub->queue, &slot, wait) != pdTRUE) {
+        return NULL;
+    }
+    EVT_TRACE_INSTANT("bus_recv", ((uint32_t)pool[slot].topic << 24) | (pool[slot].seq & 0xFFFFFF));
+    return &pool[slot];
+}
+
+void msg_bus_release(const msg_bus_msg_t *msg)
+{
+    if (msg) {
+        slot_unref(&pool[msg->slot]);
+    }
+}
+
+void msg_bus_log_stats(void)
+{
+    ESP_LOGI(TAG, "Bus: %lu published, %d/%d slots free, %lu pool-empty drops",
+             (unsigned long)publish_seq, (int)(free_slots ? uxQueueMessagesWaiting(free_slots) : 0),
+             MSG_BUS_POOL_SLOTS, (unsigned long)pool_empty);
+    uint8_t count = sub_count;
+    for (uint8_t i = 0; i < count; i++) {
+        ESP_LOGI(TAG, "  %-12s topic %d: %lu delivered, %lu dropped, %d queued",
+                 subs[i].name, subs[i].topic, (unsigned long)subs[i].delivered,
+                 (unsigned long)subs[i].dropped, (int)uxQueueMessagesWaiting(subs[i].queue));
+    }
+}
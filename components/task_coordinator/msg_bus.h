@@ -0,0 +1,147 @@
+#ifndef MSG_BUS_H
+#define MSG_BUS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Message Bus - typed publish/subscribe between tasks
+ * 
+ * A publisher copies its payload once into a pooled slot; every subscriber
+ * of the topic gets a reference to that slot through its own FreeRTOS
+ * queue of slot ids. The slot returns to the pool when the last subscriber
+ * calls msg_bus_release(), so one mood result can feed the UI, cloud sync
+ * and logging without a copy per consumer.
+ * 
+ * Subscriptions are created at init time (before the first publish) and
+ * never removed. Payload types stay in messages.h.
+ * 
+ * Topics fed from outside the device's own logic (AI results, power
+ * status, reminders) are recorded by the input recorder (input_rec.h);
+ * while it replays them, live publishes on those topics are dropped.
+ */
+
+typedef enum {
+    MSG_TOPIC_MOOD_RESULT = 0,  // mood_result_t   (logic_task)
+    MSG_TOPIC_AI_RESULT,        // ai_result_msg_t (ai_worker)
+    MSG_TOPIC_BLYNK_SYNC,       // blynk_sync_msg_t (dashboard)
+    MSG_TOPIC_TASK_STATS,       // task_stats_msg_t (task_monitor)
+    MSG_TOPIC_MOOD_FORECAST,    // mood_forecast_t (logic_task)
+    MSG_TOPIC_POWER_STATUS,     // power_status_t (power_monitor)
+    MSG_TOPIC_REMINDER,         // reminder_event_t (reminders)
+    MSG_TOPIC_COUNT
+} msg_topic_t;
+
+#define MSG_BUS_POOL_SLOTS    8     // Messages in flight across all topics
+#define MSG_BUS_PAYLOAD_MAX   64    // Largest payload; long text travels as a text_buf_t handle
+#define MSG_BUS_MAX_SUBS      16
+
+// Subscription flags
+#define MSG_SUB_LATEST        0x01  // Full queue: drop the oldest message instead of the new one
+
+typedef struct {
+    uint8_t  topic;             // msg_topic_t
+    uint8_t  slot;
+    uint16_t len;
+    uint32_t seq;               // Per-bus publish counter
+    volatile uint32_t refs;     // Subscribers still holding the slot
+    uint32_t data[(MSG_BUS_PAYLOAD_MAX + 3) / 4];
+} msg_bus_msg_t;
+
+// Typed view of a message payload
+#define MSG_BUS_PAYLOAD(msg, type) ((const type *)(msg)->data)
+
+/**
+ * Called from the publishing task after a message is queued for a
+ * subscriber (e.g. to wake the LVGL task). Keep it short.
+ */
+typedef void (*msg_bus_notify_t)(void *arg);
+
+/**
+ * Called once per published payload when the bus is done with it: after
+ * the last subscriber released it, or straight away if nobody received
+ * it. Lets payloads own resources (text_buf_t handles) - a publish always
+ * hands the payload's references to the bus.
+ */
+typedef void (*msg_bus_release_hook_t)(const void *payload);
+
+/**
+ * Record a payload that holds handles (text_buf_t) as plain bytes with
+ * input_rec_put_parts(INPUT_REC_BUS, topic, ...), and rebuild it on replay
+ * into `payload` (MSG_BUS_PAYLOAD_MAX bytes), returning its length or 0 to
+ * skip it. Topics without a codec are recorded as their payload bytes.
+ */
+typedef void (*msg_bus_rec_encode_t)(msg_topic_t topic, const void *payload);
+typedef size_t (*msg_bus_rec_decode_t)(const uint8_t *data, size_t len, void *payload);
+
+typedef struct msg_bus_sub msg_bus_sub_t;
+
+/**
+ * @brief Create the slot pool (called by task_coordinator_init)
+ */
+esp_err_t msg_bus_init(void);
+
+/**
+ * @brief Set the release hook of a topic (init time, before publishing)
+ */
+void msg_bus_set_release_hook(msg_topic_t topic, msg_bus_release_hook_t hook);
+
+/**
+ * @brief Set how a recorded topic's payload is stored (init time)
+ */
+void msg_bus_set_rec_codec(msg_topic_t topic, msg_bus_rec_encode_t encode, msg_bus_rec_decode_t decode);
+
+/**
+ * @brief Subscribe to one topic
+ * 
+ * @param name   For logs
+ * @param topic  Topic to receive
+ * @param depth  Messages this subscriber may hold before drops
+ * @param flags  MSG_SUB_*
+ * @param notify Optional, called after each delivery
+ * @return Subscription, or NULL if the bus is not initialised or full
+ */
+msg_bus_sub_t *msg_bus_subscribe(const char *name, msg_topic_t topic, uint8_t depth,
+                                 uint8_t flags, msg_bus_notify_t notify, void *arg);
+
+/**
+ * @brief Publish a payload to every subscriber of `topic` (never blocks)
+ * 
+ * The payload is copied; resources it references belong to the bus from
+ * here on, whatever the result (see msg_bus_release_hook_t).
+ * 
+ * @return ESP_OK (also with no subscribers), ESP_ERR_INVALID_SIZE if the
+ *         payload exceeds MSG_BUS_PAYLOAD_MAX, ESP_ERR_NO_MEM if the pool
+ *         is exhausted
+ */
+esp_err_t msg_bus_publish(msg_topic_t topic, const void *data, size_t len);
+
+/**
+ * @brief Take the next message for a subscription
+ * 
+ * @return Message (call msg_bus_release when done) or NULL on timeout
+ */
+const msg_bus_msg_t *msg_bus_receive(msg_bus_sub_t *sub, TickType_t wait);
+
+/**
+ * @brief Drop a reference taken with msg_bus_receive
+ */
+void msg_bus_release(const msg_bus_msg_t *msg);
+
+/**
+ * @brief Log publish / delivery / drop counters
+ */
+void msg_bus_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MSG_BUS_H
@@ -0,0 +1,120 @@
+#include "net_sched.h"
+#include "gemini_api.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <atomic>
+
+static const char *TAG = "net_sched";
+
+#if CONFIG_GOLDIE_NET_POWER_SAVE && CONFIG_GOLDIE_NET_WINDOW_S > 0
+#define NET_SCHED_POWER_SAVE 1
+#else
+#define NET_SCHED_POWER_SAVE 0
+#endif
+
+static portMUX_TYPE sched_lock = portMUX_INITIALIZER_UNLOCKED;
+static int64_t window_end_us = 0;          // Window open until then
+static int64_t next_window_us = 0;         // Next scheduled opening
+static int interactive = 0;                // Requests in flight
+static std::atomic<bool> open_now(true);
+static bool radio_awake = true;            // WIFI_PS_NONE set (poll side)
+static int64_t opened_us = 0;
+static int64_t awake_total_us = 0;
+static int64_t next_sntp_us = 0;
+
+static inline bool window_open_at(int64_t now)
+{
+    return CONFIG_GOLDIE_NET_WINDOW_S == 0 || interactive > 0 || now < window_end_us;
+}
+
+static void extend_window(int64_t now)
+{
+    int64_t end = now + (int64_t)NET_SCHED_HOLD_MS * 1000;
+    if (end > window_end_us) {
+        window_end_us = end;
+    }
+}
+
+void net_sched_init(void)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&sched_lock);
+    extend_window(now);                    // Boot: anything waiting goes out
+    next_window_us = now + (int64_t)CONFIG_GOLDIE_NET_WINDOW_S * 1000000;
+    portEXIT_CRITICAL(&sched_lock);
+    next_sntp_us = now + (int64_t)NET_SCHED_SNTP_S * 1000000;
+    opened_us = now;
+    ESP_LOGI(TAG, "Radio windows every %d s%s", CONFIG_GOLDIE_NET_WINDOW_S,
+             NET_SCHED_POWER_SAVE ? ", modem sleep in between" : "");
+}
+
+void net_sched_poll(void)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&sched_lock);
+    if (CONFIG_GOLDIE_NET_WINDOW_S > 0 && now >= next_window_us) {
+        extend_window(now);
+        while (next_window_us <= now) {
+            next_window_us += (int64_t)CONFIG_GOLDIE_NET_WINDOW_S * 1000000;
+        }
+    }
+    bool open = window_open_at(now);
+    portEXIT_CRITICAL(&sched_lock);
+    open_now = open;
+
+    if (open && !radio_awake) {
+        radio_awake = true;
+        opened_us = now;
+        if (NET_SCHED_POWER_SAVE) {
+            gemini_wifi_power_save(false);
+        }
+    } else if (!open && radio_awake) {
+        radio_awake = false;
+        awake_total_us += now - opened_us;
+        if (NET_SCHED_POWER_SAVE) {
+            gemini_wifi_power_save(true);
+        }
+        ESP_LOGD(TAG, "Window closed after %lld ms (radio awake %d%% since boot)",
+                 (long long)((now - opened_us) / 1000), (int)(awake_total_us * 100 / (now > 0 ? now : 1)));
+    }
+
+    if (open && now >= next_sntp_us && gemini_is_wifi_connected()) {
+        next_sntp_us = now + (int64_t)NET_SCHED_SNTP_S * 1000000;
+        gemini_time_resync();
+    }
+}
+
+bool net_sched_window_open(void)
+{
+    return open_now;
+}
+
+void net_sched_touch(void)
+{
+    portENTER_CRITICAL(&sched_lock);
+    extend_window(esp_timer_get_time());
+    portEXIT_CRITICAL(&sched_lock);
+}
+
+void net_sched_interactive_begin(void)
+{
+    portENTER_CRITICAL(&sched_lock);
+    interactive++;
+    portEXIT_CRITICAL(&sched_lock);
+    open_now = true;
+    // Straight to full power: the telemetry worker may only poll a second later
+    if (NET_SCHED_POWER_SAVE) {
+        gemini_wifi_power_save(false);
+    }
+}
+
+void net_sched_interactive_end(void)
+{
+    portENTER_CRITICAL(&sched_lock);
+    if (interactive > 0) {
+        interactive--;
+    }
+    extend_window(esp_timer_get_time());
+    portEXIT_CRITICAL(&sched_lock);
+}
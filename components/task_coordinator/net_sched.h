@@ -0,0 +1,79 @@
+#ifndef NET_SCHED_H
+#define NET_SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Net Sched - shared radio-on windows for background network traffic
+ *
+ * Background jobs (Blynk snapshots, task stats, mood forecast, backlog
+ * backfill, SNTP) no longer wake the radio on their own timers. A window
+ * opens every CONFIG_GOLDIE_NET_WINDOW_S and stays open while jobs run,
+ * plus NET_SCHED_HOLD_MS after the last one; the telemetry worker only
+ * takes its messages while a window is open. Messages arriving in between
+ * wait in their latest-only subscriptions, so several snapshots coalesce
+ * into the newest one. SNTP is re-synced from a window every
+ * NET_SCHED_SNTP_S instead of on lwIP's own schedule.
+ *
+ * Interactive traffic (an AI query after a parameter edit) is never held
+ * back: net_sched_interactive_begin() opens a window at once, and the
+ * telemetry worker uses it for whatever is waiting.
+ *
+ * With CONFIG_GOLDIE_NET_POWER_SAVE the station runs WIFI_PS_MIN_MODEM
+ * (modem sleeps between DTIM beacons) while no window is open and
+ * WIFI_PS_NONE inside one. CONFIG_GOLDIE_NET_WINDOW_S = 0 keeps a window
+ * open permanently: jobs run as soon as they arrive and power save stays
+ * off, as before.
+ *
+ * net_sched_poll() runs on the telemetry worker; the interactive calls
+ * may come from any task.
+ */
+
+#ifndef CONFIG_GOLDIE_NET_WINDOW_S
+#define CONFIG_GOLDIE_NET_WINDOW_S 60
+#endif
+
+#define NET_SCHED_HOLD_MS   3000              // Window stays open after the last job
+#define NET_SCHED_SNTP_S    (6 * 3600)        // SNTP re-sync from a window
+
+/**
+ * @brief Set up the lock and the first window (at once)
+ */
+void net_sched_init(void);
+
+/**
+ * @brief Open / close windows on schedule, switch power save, SNTP due
+ */
+void net_sched_poll(void);
+
+/**
+ * @brief true while background traffic may use the radio
+ */
+bool net_sched_window_open(void);
+
+/**
+ * @brief A background job ran: keep the window open NET_SCHED_HOLD_MS more
+ */
+void net_sched_touch(void);
+
+/**
+ * @brief Interactive request starts: open a window now, radio fully awake
+ */
+void net_sched_interactive_begin(void);
+
+/**
+ * @brief Interactive request done: the window closes after the hold time
+ */
+void net_sched_interactive_end(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NET_SCHED_H
@@ -0,0 +1,158 @@
+#include "queue_watch.h"
+#include "metrics.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <atomic>
+#include <stdio.h>
+
+static const char *TAG = "queue_watch";
+
+typedef struct {
+    const char *name;
+    QueueHandle_t queue;
+    uint8_t depth;
+    std::atomic<uint32_t> sent;
+    std::atomic<uint32_t> dropped;
+    std::atomic<uint32_t> overwritten;
+    std::atomic<uint8_t> high_water;
+    std::atomic<uint32_t> loss_ms;     // Time of the last loss (0 = none yet)
+    metric_t *m_dropped;
+    metric_t *m_overwritten;
+} channel_t;
+
+static channel_t channels[QUEUE_WATCH_COUNT];
+
+static inline uint32_t now_ms(void)
+{
+    uint32_t ms = (uint32_t)(esp_timer_get_time() / 1000);
+    return ms ? ms : 1;
+}
+
+static void note_depth(channel_t *c)
+{
+    uint8_t waiting = (uint8_t)uxQueueMessagesWaiting(c->queue);
+    uint8_t seen = c->high_water.load(std::memory_order_relaxed);
+    while (waiting > seen && !c->high_water.compare_exchange_weak(seen, waiting, std::memory_order_relaxed)) {
+    }
+}
+
+static void note_loss(channel_t *c, bool overwrite)
+{
+    if (overwrite) {
+        c->overwritten.fetch_add(1, std::memory_order_relaxed);
+        metrics_inc(c->m_overwritten, 1);
+    } else {
+        c->dropped.fetch_add(1, std::memory_order_relaxed);
+        metrics_inc(c->m_dropped, 1);
+    }
+    c->loss_ms.store(now_ms(), std::memory_order_relaxed);
+}
+
+void queue_watch_register(queue_watch_id_t id, const char *name, QueueHandle_t queue, uint8_t depth)
+{
+    if (id >= QUEUE_WATCH_COUNT || queue == NULL) {
+        return;
+    }
+    channel_t *c = &channels[id];
+    c->name = name;
+    c->depth = depth;
+    char labels[METRICS_LABELS_MAX];
+    snprintf(labels, sizeof(labels), "queue=\"%s\"", name);
+    c->m_dropped = metrics_counter("goldie_queue_dropped_total", labels, "Messages refused by a full queue");
+    c->m_overwritten = metrics_counter("goldie_queue_overwritten_total", labels,
+                                       "Unread messages replaced by a newer one");
+    c->queue = queue;
+}
+
+BaseType_t queue_watch_send(queue_watch_id_t id, const void *item)
+{
+    channel_t *c = &channels[id];
+    if (c->queue == NULL) {
+        return pdFALSE;
+    }
+    if (xQueueSend(c->queue, item, 0) != pdTRUE) {
+        note_loss(c, false);
+        return pdFALSE;
+    }
+    c->sent.fetch_add(1, std::memory_order_relaxed);
+    note_depth(c);
+    return pdTRUE;
+}
+
+BaseType_t queue_watch_overwrite(queue_watch_id_t id, const void *item)
+{
+    channel_t *c = &channels[id];
+    if (c->queue == NULL) {
+        return pdFALSE;
+    }
+    // The consumer may take the old message in between: then one overwrite
+    // too many is counted, never one too few
+    if (uxQueueMessagesWaiting(c->queue) > 0) {
+        note_loss(c, true);
+    }
+    BaseType_t ok = xQueueOverwrite(c->queue, item);
+    c->sent.fetch_add(1, std::memory_order_relaxed);
+    note_depth(c);
+    return ok;
+}
+
+BaseType_t queue_watch_reclaim(queue_watch_id_t id, void *item)
+{
+    channel_t *c = &channels[id];
+    if (c->queue == NULL || xQueueReceive(c->queue, item, 0) != pdTRUE) {
+        return pdFALSE;
+    }
+    note_loss(c, true);
+    return pdTRUE;
+}
+
+uint8_t queue_watch_pressure(queue_watch_id_t id)
+{
+    const channel_t *c = &channels[id];
+    if (c->queue == NULL || c->depth == 0) {
+        return 0;
+    }
+    uint32_t fill = (uint32_t)uxQueueMessagesWaiting(c->queue) * 100 / c->depth;
+    uint32_t loss = 0;
+    uint32_t at = c->loss_ms.load(std::memory_order_relaxed);
+    if (at != 0) {
+        uint32_t halvings = (now_ms() - at) / QUEUE_WATCH_DECAY_MS;
+        loss = halvings < 8 ? 100u >> halvings : 0;
+    }
+    uint32_t p = fill > loss ? fill : loss;
+    return (uint8_t)(p > 100 ? 100 : p);
+}
+
+bool queue_watch_get(queue_watch_id_t id, queue_watch_stats_t *out)
+{
+    if (id >= QUEUE_WATCH_COUNT || channels[id].queue == NULL) {
+        return false;
+    }
+    const channel_t *c = &channels[id];
+    out->sent = c->sent.load(std::memory_order_relaxed);
+    out->dropped = c->dropped.load(std::memory_order_relaxed);
+    out->overwritten = c->overwritten.load(std::memory_order_relaxed);
+    out->depth = c->depth;
+    out->high_water = c->high_water.load(std::memory_order_relaxed);
+    out->waiting = (uint8_t)uxQueueMessagesWaiting(c->queue);
+    out->pressure = queue_watch_pressure(id);
+    return true;
+}
+
+const char *queue_watch_name(queue_watch_id_t id)
+{
+    return id < QUEUE_WATCH_COUNT && channels[id].name ? channels[id].name : "?";
+}
+
+void queue_watch_log_stats(void)
+{
+    for (int i = 0; i < QUEUE_WATCH_COUNT; i++) {
+        queue_watch_stats_t s;
+        if (!queue_watch_get((queue_watch_id_t)i, &s)) {
+            continue;
+        }
+        ESP_LOGI(TAG, "%-12s %lu sent, %lu dropped, %lu overwritten, %u/%u waiting (high water %u), pressure %u%%",
+                 queue_watch_name((queue_watch_id_t)i), (unsigned long)s.sent, (unsigned long)s.dropped,
+                 (unsigned long)s.overwritten, s.waiting, s.depth, s.high_water, s.pressure);
+    }
+}
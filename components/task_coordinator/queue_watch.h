@@ -0,0 +1,109 @@
+#ifndef QUEUE_WATCH_H
+#define QUEUE_WATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Queue Watch - depth, loss and backpressure of the coordinator's queues
+ *
+ * The point-to-point queues between the LVGL, logic, storage and AI tasks
+ * are one to FRAME_POOL_SLOTS deep and never block the sender, so a full
+ * queue loses the message (send) or the one waiting in it (overwrite,
+ * mailboxes). Producers send through these wrappers instead of calling
+ * xQueueSend(..., 0) / xQueueOverwrite() directly; per channel they count
+ *
+ *   sent         messages queued
+ *   dropped      sends refused by a full queue
+ *   overwritten  unread messages replaced (overwrite or reclaim)
+ *   high water   most messages waiting at once, against the depth
+ *
+ * and queue_watch_pressure() gives the producer a 0-100 backpressure
+ * signal: the queue's fill now, or recent loss - 100 at a drop or
+ * overwrite, halving every QUEUE_WATCH_DECAY_MS - whichever is higher.
+ * At QUEUE_WATCH_BUSY_PCT or more a producer that can wait (the mood
+ * settle window, speculative prefetches) holds back instead of feeding a
+ * consumer that is not keeping up.
+ *
+ * Dropped / overwritten counts are also Prometheus counters
+ * (goldie_queue_dropped_total / goldie_queue_overwritten_total, label
+ * queue="<name>"). Receivers keep using xQueueReceive on the handle.
+ *
+ * Any task; the counters are atomic.
+ */
+
+#define QUEUE_WATCH_BUSY_PCT   50
+#define QUEUE_WATCH_DECAY_MS   1000    // Loss pressure halves per interval
+
+typedef enum {
+    QUEUE_WATCH_PARAM = 0,     // queue_param_update mailbox (LVGL -> logic)
+    QUEUE_WATCH_FRAME_REQ,     // queue_anim_frame_request (LVGL -> storage)
+    QUEUE_WATCH_FRAME_READY,   // queue_anim_frame_ready (storage -> LVGL)
+    QUEUE_WATCH_PREFETCH,      // queue_anim_prefetch (logic -> storage)
+    QUEUE_WATCH_AI_REQ,        // queue_ai_request (LVGL / logic -> AI)
+    QUEUE_WATCH_COUNT
+} queue_watch_id_t;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t dropped;
+    uint32_t overwritten;
+    uint8_t depth;
+    uint8_t high_water;
+    uint8_t waiting;           // Messages in the queue now
+    uint8_t pressure;          // queue_watch_pressure() now
+} queue_watch_stats_t;
+
+/**
+ * @brief Attach a channel to its queue (task_coordinator_init)
+ */
+void queue_watch_register(queue_watch_id_t id, const char *name, QueueHandle_t queue, uint8_t depth);
+
+/**
+ * @brief xQueueSend(queue, item, 0), counted
+ * @return pdTRUE if queued, pdFALSE if the queue was full (dropped)
+ */
+BaseType_t queue_watch_send(queue_watch_id_t id, const void *item);
+
+/**
+ * @brief xQueueOverwrite on a 1-deep mailbox; counts the message it replaced
+ */
+BaseType_t queue_watch_overwrite(queue_watch_id_t id, const void *item);
+
+/**
+ * @brief Take back an unread message to merge it into its replacement
+ *
+ * Counted as overwritten. pdFALSE if the consumer already took it.
+ */
+BaseType_t queue_watch_reclaim(queue_watch_id_t id, void *item);
+
+/**
+ * @brief Backpressure 0-100 (fill now or decaying recent loss)
+ */
+uint8_t queue_watch_pressure(queue_watch_id_t id);
+
+static inline bool queue_watch_busy(queue_watch_id_t id)
+{
+    return queue_watch_pressure(id) >= QUEUE_WATCH_BUSY_PCT;
+}
+
+bool queue_watch_get(queue_watch_id_t id, queue_watch_stats_t *out);
+
+const char *queue_watch_name(queue_watch_id_t id);
+
+/**
+ * @brief Log every channel's counters
+ */
+void queue_watch_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // QUEUE_WATCH_H
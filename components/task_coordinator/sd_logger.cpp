@@ -0,0 +1,902 @@
+#include "sd_logger.h"
+#include "log_flash.h"
+#include "blackbox.h"
+#include "spsc_ring.h"
+#include "job_watch.h"
+#include "io_sched.h"
+#include "esp_sdcard_port.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_rom_crc.h"
+#include "freertos/stream_buffer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <atomic>
+
+static const char *TAG = "sd_logger";
+
+#define JOB_RUN_SDLOG_MS  2000   // A batch of sector writes to a few files on FAT
+#define JOB_RUN_SDFILE_MS 3000   // One streamed file (a snapshot: tens of KB)
+#define FILE_POLL_MS      100    // Stream waits: failures and the end are noticed this fast
+
+static_assert(SD_LOGGER_BATCH <= SD_LOGGER_RING, "SD logger batch larger than its ring");
+static_assert(sizeof(sd_log_disk_record_t) == 32, "sd_log_disk_record_t must stay 32 bytes");
+static_assert(SD_LOG_BLOCK_SIZE % sizeof(sd_log_disk_record_t) == 0, "Records must tile a block");
+
+// File name of each sd_log_type_t (tools/sdlog_to_csv.py uses the same)
+static const char *const LOG_NAMES[SD_LOG_TYPE_COUNT] = {
+    NULL, "medication", "parameters", "water_change", "feed"
+};
+
+static SpscRing<sd_log_record_t, SD_LOGGER_RING> ring;
+static std::atomic<TaskHandle_t> consumer(NULL);
+static char log_dir[64] = "";
+
+static std::atomic<uint32_t> stat_queued(0);
+static std::atomic<uint32_t> stat_written(0);
+static std::atomic<uint32_t> stat_dropped(0);
+static std::atomic<uint32_t> stat_batches(0);
+static std::atomic<uint32_t> stat_recovered(0);
+static std::atomic<uint32_t> stat_to_flash(0);
+static std::atomic<uint32_t> stat_drained(0);
+static std::atomic<uint32_t> stat_free_kb(0);
+static std::atomic<uint32_t> stat_deleted(0);
+static std::atomic<uint32_t> write_hist[SD_LOGGER_LAT_BUCKETS];   // Block writes by log2(us)
+static std::atomic<uint32_t> stat_files(0);
+static std::atomic<uint32_t> stat_files_dropped(0);
+
+// One streamed file in flight (sd_logger_file_begin), from any task
+enum { FILE_FREE = 0, FILE_CLAIMED, FILE_OPEN, FILE_ENDED };
+static std::atomic<int> file_state(FILE_FREE);
+static std::atomic<bool> file_failed(false);   // Either side: the rest is discarded
+static std::atomic<bool> file_keep(false);
+static char file_name[32];
+static StreamBufferHandle_t file_stream = NULL;
+static StaticStreamBuffer_t file_stream_ctl;
+static uint8_t file_stream_buf[SD_LOGGER_FILE_BUF + 1];
+static uint8_t file_chunk[SD_LOG_BLOCK_SIZE * 2];   // Worker: one fwrite per receive
+
+// Worker side only
+static sd_log_record_t batch[SD_LOGGER_RING];
+static sd_log_disk_record_t drain_buf[SD_LOGGER_RING];
+static bool dir_ready = false;
+static bool flash_checked = false;
+static bool draining = false;      // Writing records that came from flash
+static uint32_t last_mount_ms = 0;
+static uint32_t last_health_ms = 0;
+
+static inline uint32_t now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static inline uint32_t record_crc(const sd_log_disk_record_t *r)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)r, offsetof(sd_log_disk_record_t, crc32));
+}
+
+extern "C" void sd_logger_init(const char *dir)
+{
+    snprintf(log_dir, sizeof(log_dir), "%s", dir);
+    dir_ready = false;
+    if (file_stream == NULL) {
+        file_stream = xStreamBufferCreateStatic(SD_LOGGER_FILE_BUF, 1, file_stream_buf, &file_stream_ctl);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PRODUCER (LVGL task)
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" bool sd_logger_log(sd_log_type_t type, time_t when, uint8_t flags, const float *values, size_t count)
+{
+    if (type <= SD_LOG_NONE || type >= SD_LOG_TYPE_COUNT) {
+        return false;
+    }
+    sd_log_record_t item = {};
+    item.rec.timestamp = (uint32_t)when;
+    item.rec.type = (uint8_t)type;
+    item.rec.flags = flags;
+    if (values != NULL) {
+        memcpy(item.rec.value, values, (count < SD_LOGGER_VALUES ? count : SD_LOGGER_VALUES) * sizeof(float));
+    }
+    item.queued_ms = now_ms();
+
+    if (!ring.push(item)) {
+        stat_dropped++;
+        ESP_LOGW(TAG, "Queue full - %s record dropped", LOG_NAMES[type]);
+        return false;
+    }
+    stat_queued++;
+
+    // A full batch is written right away; a partial one waits for the
+    // worker's deadline check
+    TaskHandle_t task = consumer.load();
+    if (task != NULL && ring.size() >= SD_LOGGER_BATCH) {
+        xTaskNotifyGive(task);
+    }
+    return true;
+}
+
+extern "C" bool sd_logger_file_begin(const char *name)
+{
+    int expected = FILE_FREE;
+    if (file_stream == NULL || !file_state.compare_exchange_strong(expected, FILE_CLAIMED)) {
+        stat_files_dropped++;
+        return false;
+    }
+    snprintf(file_name, sizeof(file_name), "%s", name);
+    xStreamBufferReset(file_stream);       // Nobody blocked on it while free
+    file_failed.store(false);
+    file_keep.store(false);
+    file_state.store(FILE_OPEN);
+
+    TaskHandle_t task = consumer.load();
+    if (task != NULL) {
+        xTaskNotifyGive(task);
+    }
+    return true;
+}
+
+extern "C" bool sd_logger_file_write(const void *data, size_t len, uint32_t timeout_ms)
+{
+    if (file_state.load() != FILE_OPEN) {
+        return false;
+    }
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t start = now_ms();
+    while (len > 0 && !file_failed.load()) {
+        uint32_t waited = now_ms() - start;
+        if (waited >= timeout_ms) {
+            ESP_LOGW(TAG, "%s: worker not draining - file given up", file_name);
+            file_failed.store(true);
+            break;
+        }
+        // Short waits, so a failure on the worker side is seen
+        uint32_t wait = timeout_ms - waited < FILE_POLL_MS ? timeout_ms - waited : FILE_POLL_MS;
+        size_t n = xStreamBufferSend(file_stream, p, len, pdMS_TO_TICKS(wait) + 1);
+        p += n;
+        len -= n;
+    }
+    return len == 0 && !file_failed.load();
+}
+
+extern "C" void sd_logger_file_end(bool keep)
+{
+    if (file_state.load() != FILE_OPEN) {
+        return;                            // The worker gave it up already
+    }
+    file_keep.store(keep);
+    file_state.store(FILE_ENDED);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// WORKER
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void sd_logger_attach(TaskHandle_t task)
+{
+    consumer.store(task);
+}
+
+static bool ensure_dir(void)
+{
+    if (dir_ready) {
+        return true;
+    }
+    if (log_dir[0] == '\0') {
+        ESP_LOGE(TAG, "No log directory set");
+        return false;
+    }
+    struct stat st;
+    if (stat(log_dir, &st) == -1) {
+        if (mkdir(log_dir, 0700) == -1) {
+            ESP_LOGE(TAG, "Failed to create log directory: %s (errno=%d)", log_dir, errno);
+            return false;
+        }
+        ESP_LOGI(TAG, "Created log directory: %s", log_dir);
+    }
+    dir_ready = true;
+    return true;
+}
+
+/**
+ * @brief SD usable: the card is mounted (a missing one is probed again
+ *        every SD_LOGGER_REMOUNT_MS) and the log directory exists
+ */
+static bool sd_available(void)
+{
+    if (dir_ready) {
+        return true;
+    }
+    if (!esp_sdcard_port_is_mounted()) {
+        uint32_t now = now_ms();
+        if (SD_LOGGER_REMOUNT_MS == 0 ||
+            (last_mount_ms != 0 && now - last_mount_ms < SD_LOGGER_REMOUNT_MS)) {
+            return false;
+        }
+        last_mount_ms = now ? now : 1;
+        if (esp_sdcard_port_mount() != ESP_OK) {
+            return false;
+        }
+        ESP_LOGI(TAG, "SD card mounted - %u record(s) in flash to copy", (unsigned)log_flash_pending());
+    }
+    return ensure_dir();
+}
+
+/**
+ * @brief A record that could not go to SD: keep it in internal flash
+ *
+ * While draining, the record is still in flash and is copied again later.
+ */
+static void spill(const sd_log_disk_record_t *rec)
+{
+    if (draining) {
+        return;
+    }
+    if (log_flash_append(rec)) {
+        stat_to_flash++;
+    } else {
+        stat_dropped++;
+    }
+}
+
+static inline int32_t day_key(const struct tm *tm)
+{
+    return tm->tm_year * 1000 + tm->tm_yday;
+}
+
+/**
+ * @return Day of the file (day_key)
+ */
+static int32_t file_path(const sd_log_disk_record_t *rec, char *path, size_t len)
+{
+    time_t t = (time_t)rec->timestamp;
+    struct tm timeinfo;
+    localtime_r(&t, &timeinfo);
+    snprintf(path, len, "%s/%s_%04d%02d%02d.bin", log_dir, LOG_NAMES[rec->type],
+             timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday);
+    return day_key(&timeinfo);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// FILE HANDLE CACHE (worker side)
+// ═══════════════════════════════════════════════════════════════════════════
+// Today's files stay open between batches, each with its current block in
+// RAM: an append fills the block, a batch writes it back as one sector.
+// A record for another day of the same log rolls that log's handle over.
+
+typedef struct {
+    FILE *f;                       // NULL = free
+    uint8_t type;
+    char path[96];
+    int32_t day;                   // day_key of the file
+    uint32_t used_ms;              // LRU when all handles are taken
+    uint32_t block_no;             // Block being filled
+    uint8_t used;                  // Records in it
+    uint8_t fresh;                 // Of those, not yet written to the file
+    bool unsynced;                 // Written since the last fsync
+    uint32_t alloc_blocks;         // File length in blocks (pre-allocated ahead)
+    sd_log_disk_record_t block[SD_LOG_BLOCK_RECORDS];
+} log_handle_t;
+
+static log_handle_t handles[SD_LOGGER_OPEN_FILES];
+static uint32_t last_sync_ms = 0;
+
+/**
+ * @brief Write the current block at its sector-aligned offset
+ * @return false on a write error (handle closed)
+ */
+static bool block_write(log_handle_t *h);
+
+static void handle_close(log_handle_t *h)
+{
+    if (h->f == NULL) {
+        return;
+    }
+    if (h->fresh > 0 && !block_write(h)) {
+        return;  // Already closed
+    }
+    if (fclose(h->f) != 0) {
+        ESP_LOGW(TAG, "Closing %s failed (errno=%d)", h->path, errno);
+    }
+    h->f = NULL;
+    h->unsynced = false;
+}
+
+/**
+ * @brief Extend the file with zeroed blocks past the one about to be written
+ *
+ * One FAT allocation per SD_LOGGER_PREALLOC_BLOCKS instead of one per
+ * cluster as the file creeps forward; a failure only means the block
+ * write extends the file itself.
+ */
+static void handle_extend(log_handle_t *h)
+{
+    static const uint8_t zero[SD_LOG_BLOCK_SIZE] = {};
+    uint32_t target = h->block_no + SD_LOGGER_PREALLOC_BLOCKS;
+    if (SD_LOGGER_PREALLOC_BLOCKS == 0 ||
+        fseek(h->f, (long)h->alloc_blocks * SD_LOG_BLOCK_SIZE, SEEK_SET) != 0) {
+        return;
+    }
+    while (h->alloc_blocks < target && fwrite(zero, sizeof(zero), 1, h->f) == 1) {
+        h->alloc_blocks++;
+    }
+}
+
+static void note_write_time(int64_t us)
+{
+    int bucket = 0;
+    while (bucket < SD_LOGGER_LAT_BUCKETS - 1 && us >= (1LL << (bucket + 1))) {
+        bucket++;
+    }
+    write_hist[bucket]++;
+}
+
+static bool block_write(log_handle_t *h)
+{
+    if (h->block_no >= h->alloc_blocks) {
+        handle_extend(h);
+    }
+    int64_t t0 = esp_timer_get_time();
+    if (fseek(h->f, (long)h->block_no * SD_LOG_BLOCK_SIZE, SEEK_SET) != 0 ||
+        fwrite(h->block, SD_LOG_BLOCK_SIZE, 1, h->f) != 1 || fflush(h->f) != 0) {
+        ESP_LOGE(TAG, "Writing %s block %lu failed (errno=%d) - reopening",
+                 h->path, (unsigned long)h->block_no, errno);
+        for (size_t i = h->used - h->fresh; i < h->used; i++) {
+            spill(&h->block[i]);
+        }
+        fclose(h->f);
+        h->f = NULL;
+        h->fresh = 0;
+        h->unsynced = false;
+        dir_ready = false;  // Card may have gone; check again next time
+        return false;
+    }
+    note_write_time(esp_timer_get_time() - t0);
+    if (h->block_no >= h->alloc_blocks) {
+        h->alloc_blocks = h->block_no + 1;
+    }
+    stat_written += h->fresh;
+    h->fresh = 0;
+    h->unsynced = true;
+    if (h->used == SD_LOG_BLOCK_RECORDS) {
+        h->block_no++;
+        h->used = 0;
+        memset(h->block, 0, sizeof(h->block));
+    }
+    return true;
+}
+
+/**
+ * @brief Recovery: load the last block in use of an existing file
+ *
+ * Blocks are filled in order, so the first one starting with an empty
+ * slot ends the records (pre-allocated blocks are zero). Appends continue
+ * after the last intact record; a torn tail (bad CRC) is overwritten by
+ * the next block write.
+ */
+static void handle_recover(log_handle_t *h)
+{
+    memset(h->block, 0, sizeof(h->block));
+    h->block_no = 0;
+    h->used = 0;
+    h->alloc_blocks = 0;
+
+    if (fseek(h->f, 0, SEEK_END) != 0) {
+        return;
+    }
+    long size = ftell(h->f);
+    if (size <= 0) {
+        return;
+    }
+    h->alloc_blocks = (uint32_t)((size + SD_LOG_BLOCK_SIZE - 1) / SD_LOG_BLOCK_SIZE);
+
+    uint32_t in_use = 0;
+    while (in_use < h->alloc_blocks) {
+        sd_log_disk_record_t first;
+        if (fseek(h->f, (long)in_use * SD_LOG_BLOCK_SIZE, SEEK_SET) != 0 ||
+            fread(&first, sizeof(first), 1, h->f) != 1 || first.type == SD_LOG_NONE) {
+            break;
+        }
+        in_use++;
+    }
+    if (in_use == 0) {
+        return;
+    }
+    h->block_no = in_use - 1;
+    fseek(h->f, (long)h->block_no * SD_LOG_BLOCK_SIZE, SEEK_SET);
+    size_t got = fread(h->block, 1, sizeof(h->block), h->f);
+    memset((uint8_t *)h->block + got, 0, sizeof(h->block) - got);
+
+    while (h->used < SD_LOG_BLOCK_RECORDS && h->block[h->used].type == h->type &&
+           h->block[h->used].crc32 == record_crc(&h->block[h->used])) {
+        h->used++;
+    }
+    uint8_t torn = 0;
+    for (size_t i = h->used; i < SD_LOG_BLOCK_RECORDS; i++) {
+        if (h->block[i].type != SD_LOG_NONE) {
+            torn++;
+        }
+    }
+    memset(&h->block[h->used], 0, (SD_LOG_BLOCK_RECORDS - h->used) * sizeof(h->block[0]));
+    if (torn > 0) {
+        stat_recovered += torn;
+        ESP_LOGW(TAG, "%s: %u torn record(s) after block %lu record %u cut off",
+                 h->path, (unsigned)torn, (unsigned long)h->block_no, (unsigned)h->used);
+    }
+    if (h->used == SD_LOG_BLOCK_RECORDS) {
+        h->block_no++;
+        h->used = 0;
+        memset(h->block, 0, sizeof(h->block));
+    }
+}
+
+static log_handle_t *handle_get(const sd_log_disk_record_t *rec, uint32_t now)
+{
+    char path[sizeof(handles[0].path)];
+    int32_t day = file_path(rec, path, sizeof(path));
+
+    log_handle_t *slot = NULL;
+    for (int i = 0; i < SD_LOGGER_OPEN_FILES; i++) {
+        log_handle_t *h = &handles[i];
+        if (h->f != NULL && h->type == rec->type) {
+            if (strcmp(h->path, path) == 0) {
+                h->used_ms = now;
+                return h;
+            }
+            handle_close(h);  // New day: roll over
+            slot = h;
+            break;
+        }
+        if (slot == NULL || (slot->f != NULL && (h->f == NULL || h->used_ms < slot->used_ms))) {
+            slot = h;
+        }
+    }
+    handle_close(slot);
+
+    // r+ keeps what the file holds; FAT has no sparse blocks, so seeking
+    // to a block offset inside the file is all an append needs
+    FILE *f = fopen(path, "r+b");
+    if (f == NULL) {
+        f = fopen(path, "w+b");
+    }
+    if (f == NULL) {
+        ESP_LOGE(TAG, "Failed to open %s (errno=%d)", path, errno);
+        dir_ready = false;
+        return NULL;
+    }
+    slot->f = f;
+    slot->type = rec->type;
+    snprintf(slot->path, sizeof(slot->path), "%s", path);
+    slot->day = day;
+    slot->used_ms = now;
+    slot->fresh = 0;
+    slot->unsynced = false;
+    handle_recover(slot);
+    return slot;
+}
+
+/**
+ * Write back partly filled blocks; fsync (FAT entry update) at most every
+ * SD_LOGGER_SYNC_MS, or now if `force`
+ * @return false if a write or fsync failed
+ */
+static bool handles_sync(uint32_t now, bool force)
+{
+    bool ok = true;
+    bool sync = force || (now - last_sync_ms >= SD_LOGGER_SYNC_MS);
+    for (int i = 0; i < SD_LOGGER_OPEN_FILES; i++) {
+        log_handle_t *h = &handles[i];
+        if (h->f == NULL) {
+            continue;
+        }
+        if (h->fresh > 0 && !block_write(h)) {
+            ok = false;
+            continue;
+        }
+        if (sync && h->unsynced) {
+            if (fsync(fileno(h->f)) != 0) {
+                ESP_LOGE(TAG, "fsync of %s failed (errno=%d)", h->path, errno);
+                ok = false;
+                continue;
+            }
+            h->unsynced = false;
+        }
+    }
+    if (sync) {
+        last_sync_ms = now;
+    }
+    return ok;
+}
+
+/**
+ * @brief Add one record to its file's block (written when the block fills)
+ */
+static void sd_append(sd_log_disk_record_t *rec, uint32_t now)
+{
+    log_handle_t *h = handle_get(rec, now);
+    if (h == NULL) {
+        spill(rec);
+        return;
+    }
+    rec->crc32 = record_crc(rec);
+    h->block[h->used++] = *rec;
+    h->fresh++;
+    if (h->used == SD_LOG_BLOCK_RECORDS) {
+        block_write(h);
+    }
+}
+
+/**
+ * @brief Copy the oldest records kept in flash to SD
+ *
+ * They are marked drained in flash only once written and fsynced; after
+ * a failure (or a power cut in between) the chunk is copied again.
+ */
+static void drain_flash(void)
+{
+    size_t n = log_flash_peek(drain_buf, SD_LOGGER_RING);
+    if (n == 0) {
+        return;
+    }
+    job_watch_begin(TASK_ID_SDLOG, "sd_log_drain", JOB_RUN_SDLOG_MS);
+    // One chunk is one maintenance slot (a few KB)
+    io_sched_begin(IO_SCHED_SD, IO_SCHED_BACKGROUND, portMAX_DELAY);
+    uint32_t now = now_ms();
+    draining = true;
+    for (size_t i = 0; i < n; i++) {
+        sd_append(&drain_buf[i], now);
+    }
+    bool ok = handles_sync(now, true) && dir_ready;
+    draining = false;
+    io_sched_end(IO_SCHED_SD, IO_SCHED_BACKGROUND);
+    job_watch_end(TASK_ID_SDLOG);
+
+    if (ok) {
+        log_flash_mark_drained();
+        stat_drained += n;
+        if (log_flash_pending() == 0) {
+            ESP_LOGI(TAG, "Records kept in flash are all on SD now");
+        }
+    }
+}
+
+extern "C" void sd_logger_flush(void)
+{
+    size_t n = 0;
+    while (n < SD_LOGGER_RING && ring.pop(batch[n])) {
+        n++;
+    }
+    if (n == 0) {
+        return;
+    }
+    // No card: the batch goes to internal flash (the mount probe may block
+    // for a while, so it runs before the job deadline starts)
+    if (!sd_available()) {
+        for (size_t i = 0; i < n; i++) {
+            spill(&batch[i].rec);
+        }
+        stat_batches++;
+        return;
+    }
+    job_watch_begin(TASK_ID_SDLOG, "sd_log_flush", JOB_RUN_SDLOG_MS);
+    io_sched_begin(IO_SCHED_SD, IO_SCHED_LOG, portMAX_DELAY);
+
+    uint32_t now = now_ms();
+    for (size_t i = 0; i < n; i++) {
+        sd_append(&batch[i].rec, now);
+    }
+    // Partly filled blocks go out now too: one sector write per file
+    handles_sync(now, false);
+
+    io_sched_end(IO_SCHED_SD, IO_SCHED_LOG);
+    job_watch_end(TASK_ID_SDLOG);
+    stat_batches++;
+    ESP_LOGD(TAG, "Batch of %u log record(s) written", (unsigned)n);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// MAINTENANCE (worker, idle)
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Write the streamed file as it arrives, until it ends or stalls
+ *
+ * Without a card, or after a write error, the rest is received and
+ * discarded so the producer is never left blocked.
+ */
+static void stream_file(void)
+{
+    char path[sizeof(handles[0].path)];
+    FILE *f = NULL;
+    if (sd_available()) {
+        io_sched_begin(IO_SCHED_SD, IO_SCHED_BACKGROUND, portMAX_DELAY);
+        snprintf(path, sizeof(path), "%s/" SD_LOGGER_FILE_DIR, log_dir);
+        struct stat st;
+        if (stat(path, &st) == -1 && mkdir(path, 0700) == -1) {
+            ESP_LOGE(TAG, "Failed to create %s (errno=%d)", path, errno);
+        } else {
+            snprintf(path, sizeof(path), "%s/" SD_LOGGER_FILE_DIR "/%s", log_dir, file_name);
+            f = fopen(path, "wb");
+        }
+        io_sched_end(IO_SCHED_SD, IO_SCHED_BACKGROUND);
+    }
+    if (f == NULL) {
+        file_failed.store(true);
+    }
+
+    job_watch_begin(TASK_ID_SDLOG, "sdlog_file", JOB_RUN_SDFILE_MS);
+    int64_t start = esp_timer_get_time();
+    uint32_t last_ms = now_ms();
+    size_t total = 0;
+    bool ended = false;
+    while (true) {
+        size_t n = xStreamBufferReceive(file_stream, file_chunk, sizeof(file_chunk), pdMS_TO_TICKS(FILE_POLL_MS));
+        if (n > 0) {
+            last_ms = now_ms();
+            total += n;
+            // One maintenance slot per chunk: frame loads go in between
+            if (f != NULL && !file_failed.load()) {
+                io_sched_begin(IO_SCHED_SD, IO_SCHED_BACKGROUND, portMAX_DELAY);
+                if (fwrite(file_chunk, 1, n, f) != n) {
+                    file_failed.store(true);
+                }
+                io_sched_end(IO_SCHED_SD, IO_SCHED_BACKGROUND);
+            }
+        } else if (file_state.load() == FILE_ENDED) {
+            // Sent before the end, after the receive timed out
+            if (xStreamBufferIsEmpty(file_stream)) {
+                ended = true;
+                break;
+            }
+        } else if (now_ms() - last_ms >= SD_LOGGER_FILE_STALL_MS) {
+            ESP_LOGW(TAG, "%s: no data for %d ms - file given up", file_name, SD_LOGGER_FILE_STALL_MS);
+            file_failed.store(true);
+            break;
+        }
+    }
+    bool ok = ended && file_keep.load() && !file_failed.load();
+    if (f != NULL) {
+        io_sched_begin(IO_SCHED_SD, IO_SCHED_BACKGROUND, portMAX_DELAY);
+        ok = (fclose(f) == 0) && ok;
+        if (!ok) {
+            remove(path);
+        }
+        io_sched_end(IO_SCHED_SD, IO_SCHED_BACKGROUND);
+    }
+    job_watch_end(TASK_ID_SDLOG);
+
+    if (ok) {
+        stat_files++;
+        ESP_LOGD(TAG, "Wrote %s (%u bytes, %lld ms)", path, (unsigned)total,
+                 (long long)((esp_timer_get_time() - start) / 1000));
+    } else {
+        stat_files_dropped++;
+        if (f != NULL && ended && file_keep.load()) {
+            ESP_LOGW(TAG, "Writing %s failed (errno=%d)", path, errno);
+        }
+    }
+    file_state.store(FILE_FREE);
+}
+
+/**
+ * @brief Oldest file in the SD_LOGGER_FILE_DIR directory (names sort by time)
+ * @return false if there is none
+ */
+static bool oldest_file(char *path, size_t len)
+{
+    char dir_path[sizeof(handles[0].path)];
+    snprintf(dir_path, sizeof(dir_path), "%s/" SD_LOGGER_FILE_DIR, log_dir);
+    DIR *dir = opendir(dir_path);
+    if (dir == NULL) {
+        return false;
+    }
+    char best[32] = "";
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL) {
+        if (ent->d_type == DT_REG && strlen(ent->d_name) < sizeof(best) &&
+            (best[0] == '\0' || strcmp(ent->d_name, best) < 0)) {
+            snprintf(best, sizeof(best), "%s", ent->d_name);
+        }
+    }
+    closedir(dir);
+    if (best[0] == '\0') {
+        return false;
+    }
+    snprintf(path, len, "%s/%s", dir_path, best);
+    return true;
+}
+
+/**
+ * @brief Oldest "<name>_YYYYMMDD.bin" in the log directory that is neither
+ *        open nor today's
+ * @return false if there is none
+ */
+static bool oldest_log(char *path, size_t len)
+{
+    DIR *dir = opendir(log_dir);
+    if (dir == NULL) {
+        return false;
+    }
+    time_t t = time(NULL);
+    struct tm timeinfo;
+    localtime_r(&t, &timeinfo);
+    unsigned today = (unsigned)((timeinfo.tm_year + 1900) * 10000 + (timeinfo.tm_mon + 1) * 100 + timeinfo.tm_mday);
+
+    char best[32] = "";
+    uint32_t best_date = UINT32_MAX;
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL) {
+        // Only the logger's own files; history_store's live here too
+        size_t n = strlen(ent->d_name);
+        unsigned date;
+        if (n < 14 || n >= sizeof(best) || strcmp(ent->d_name + n - 4, ".bin") != 0 ||
+            ent->d_name[n - 13] != '_' || sscanf(ent->d_name + n - 12, "%8u", &date) != 1) {
+            continue;
+        }
+        if (date < best_date && date < today) {
+            char candidate[sizeof(handles[0].path)];
+            snprintf(candidate, sizeof(candidate), "%s/%s", log_dir, ent->d_name);
+            bool open = false;
+            for (int i = 0; i < SD_LOGGER_OPEN_FILES; i++) {
+                open = open || (handles[i].f != NULL && strcmp(handles[i].path, candidate) == 0);
+            }
+            if (!open) {
+                best_date = date;
+                snprintf(best, sizeof(best), "%s", ent->d_name);
+            }
+        }
+    }
+    closedir(dir);
+    if (best[0] == '\0') {
+        return false;
+    }
+    snprintf(path, len, "%s/%s", log_dir, best);
+    return true;
+}
+
+/**
+ * @brief Free space check; deletes the oldest logs while below the minimum
+ */
+static void health_check(void)
+{
+    // The free count can scan the FAT: a maintenance slot of its own
+    io_sched_begin(IO_SCHED_SD, IO_SCHED_BACKGROUND, portMAX_DELAY);
+    uint32_t free_kb = (uint32_t)(esp_sdcard_port_get_free() / 1024);
+    io_sched_end(IO_SCHED_SD, IO_SCHED_BACKGROUND);
+    stat_free_kb = free_kb;
+    if (free_kb == 0 || free_kb >= SD_LOGGER_MIN_FREE_KB) {
+        return;
+    }
+
+    ESP_LOGW(TAG, "SD card low on space (%lu KB free) - deleting the oldest files", (unsigned long)free_kb);
+    char path[sizeof(handles[0].path)];
+    // Snapshots go first: the logs are the record of the tank. One file
+    // per maintenance slot
+    for (int i = 0; i < 16 && free_kb < SD_LOGGER_MIN_FREE_KB; i++) {
+        io_sched_begin(IO_SCHED_SD, IO_SCHED_BACKGROUND, portMAX_DELAY);
+        bool found = oldest_file(path, sizeof(path)) || oldest_log(path, sizeof(path));
+        bool deleted = found && remove(path) == 0;
+        if (deleted) {
+            free_kb = (uint32_t)(esp_sdcard_port_get_free() / 1024);
+        }
+        io_sched_end(IO_SCHED_SD, IO_SCHED_BACKGROUND);
+        if (!found) {
+            break;
+        }
+        if (!deleted) {
+            ESP_LOGE(TAG, "Deleting %s failed (errno=%d)", path, errno);
+            break;
+        }
+        stat_deleted++;
+        ESP_LOGI(TAG, "Deleted %s", path);
+    }
+    stat_free_kb = free_kb;
+}
+
+extern "C" void sd_logger_close(void)
+{
+    sd_logger_flush();
+    io_sched_begin(IO_SCHED_SD, IO_SCHED_LOG, portMAX_DELAY);
+    handles_sync(now_ms(), true);
+    for (int i = 0; i < SD_LOGGER_OPEN_FILES; i++) {
+        handle_close(&handles[i]);
+    }
+    io_sched_end(IO_SCHED_SD, IO_SCHED_LOG);
+}
+
+extern "C" void sd_logger_run(uint32_t max_wait_ms)
+{
+    // Partition scan on the worker, not in dashboard_init()
+    if (!flash_checked) {
+        flash_checked = true;
+        log_flash_init();
+        blackbox_flush();      // Previous boot's last events, once per boot
+    }
+
+    const sd_log_record_t *oldest = ring.peek();
+    uint32_t wait_ms = max_wait_ms;
+    if (oldest != NULL) {
+        uint32_t age = now_ms() - oldest->queued_ms;
+        if (ring.size() >= SD_LOGGER_BATCH || age >= SD_LOGGER_FLUSH_MS) {
+            sd_logger_flush();
+            return;
+        }
+        if (SD_LOGGER_FLUSH_MS - age < wait_ms) {
+            wait_ms = SD_LOGGER_FLUSH_MS - age;
+        }
+    } else {
+        // Idle: blocks written since the last fsync reach the FAT on time,
+        // and yesterday's files are closed once the day is over
+        io_sched_begin(IO_SCHED_SD, IO_SCHED_LOG, portMAX_DELAY);
+        handles_sync(now_ms(), false);
+        time_t t = time(NULL);
+        struct tm timeinfo;
+        localtime_r(&t, &timeinfo);
+        for (int i = 0; i < SD_LOGGER_OPEN_FILES; i++) {
+            if (handles[i].f != NULL && handles[i].day < day_key(&timeinfo)) {
+                handles_sync(now_ms(), true);
+                handle_close(&handles[i]);
+            }
+        }
+        io_sched_end(IO_SCHED_SD, IO_SCHED_LOG);
+        if (file_state.load() >= FILE_OPEN) {
+            stream_file();
+        }
+        if (dir_ready && now_ms() - last_health_ms >= SD_LOGGER_HEALTH_MS) {
+            last_health_ms = now_ms();
+            health_check();
+        }
+        // Records kept while there was no card: one chunk per pass, new
+        // records go first
+        if (log_flash_pending() > 0 && sd_available()) {
+            drain_flash();
+            if (log_flash_pending() > 0) {
+                wait_ms = 0;
+            }
+        }
+    }
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait_ms) + 1);
+}
+
+extern "C" void sd_logger_get_stats(sd_logger_stats_t *out)
+{
+    out->queued = stat_queued;
+    out->written = stat_written;
+    out->dropped = stat_dropped;
+    out->batches = stat_batches;
+    out->recovered = stat_recovered;
+    out->to_flash = stat_to_flash;
+    out->drained = stat_drained;
+    out->free_kb = stat_free_kb;
+    out->deleted_files = stat_deleted;
+    out->files_written = stat_files;
+    out->files_dropped = stat_files_dropped;
+
+    // Percentiles from the histogram, as the upper bound of their bucket
+    uint32_t hist[SD_LOGGER_LAT_BUCKETS];
+    uint32_t total = 0;
+    for (int i = 0; i < SD_LOGGER_LAT_BUCKETS; i++) {
+        hist[i] = write_hist[i];
+        total += hist[i];
+    }
+    out->write_p50_us = 0;
+    out->write_p99_us = 0;
+    uint32_t seen = 0;
+    for (int i = 0; i < SD_LOGGER_LAT_BUCKETS && total > 0; i++) {
+        seen += hist[i];
+        if (out->write_p50_us == 0 && (uint64_t)seen * 2 >= total) {
+            out->write_p50_us = 1u << (i + 1);
+        }
+        if ((uint64_t)seen * 100 >= (uint64_t)total * 99) {
+            out->write_p99_us = 1u << (i + 1);
+            break;
+        }
+    }
+}
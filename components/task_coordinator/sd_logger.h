@@ -0,0 +1,221 @@
+#ifndef SD_LOGGER_H
+#define SD_LOGGER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * SD Logger - activity log records written off the LVGL task
+ *
+ * A touch handler hands its values to sd_logger_log(), which copies them
+ * into a fixed-size record on an SPSC ring and returns: no formatting,
+ * stat, fopen or card access on the caller's side, and it never blocks.
+ * The sd_logger worker leaves the records on the ring until
+ * SD_LOGGER_BATCH are pending or the oldest has waited SD_LOGGER_FLUSH_MS,
+ * then appends the whole batch to the daily files
+ * ("<dir>/<name>_YYYYMMDD.bin", name from the record type).
+ *
+ * File format: 512-byte blocks of 16 sd_log_disk_record_t, each with its
+ * own CRC32. A block is only ever written whole at its sector-aligned
+ * offset; the last one is rewritten as it fills, unused slots are zero.
+ * A power cut can therefore only tear that one block, and reading stops
+ * at its first bad CRC. When a file is opened (first record of the day,
+ * or after a reboot) its last block is scanned and appends continue after
+ * the last intact record. tools/sdlog_to_csv.py exports the files to the
+ * CSV layout the firmware used to write.
+ *
+ * The worker keeps today's files open (up to SD_LOGGER_OPEN_FILES), so a
+ * batch is one sector write per file instead of a directory lookup plus
+ * dir-entry update per row. fsync, which commits the FAT and the file
+ * size, runs at most every SD_LOGGER_SYNC_MS. A record for a new day rolls
+ * its log over, and handles of past days are closed once the worker is
+ * idle after midnight.
+ *
+ * Maintenance (worker, while idle): a file is extended by
+ * SD_LOGGER_PREALLOC_BLOCKS zeroed blocks whenever appends reach its end,
+ * so a day's records go into clusters allocated together and most block
+ * writes change neither the FAT nor the file size (recovery finds the
+ * first zero block). Every SD_LOGGER_HEALTH_MS the free space is read;
+ * below SD_LOGGER_MIN_FREE_KB the oldest daily files are deleted (never
+ * an open one). Block write times go into a log2 histogram for the
+ * p50 / p99 in the stats.
+ *
+ * Without a card (none at boot, or a write fails) records go to the
+ * "logflash" partition instead (log_flash.h). The worker probes for a
+ * card every SD_LOGGER_REMOUNT_MS; once one is mounted it copies the kept
+ * records to their daily files in chunks while idle, and marks them
+ * drained in flash after the fsync. A power cut between the two copies a
+ * chunk twice; a card pulled while mounted is noticed by its first
+ * failing write.
+ *
+ * Single producer: sd_logger_log() is called from the LVGL task only.
+ * A full ring (card stalled or worker stopped) drops the record and counts
+ * it; records queued while the worker is stopped are written after a
+ * restart.
+ *
+ * Whole files (camera snapshots) are streamed: sd_logger_file_begin(),
+ * any number of sd_logger_file_write(), sd_logger_file_end(). The writes
+ * go through a SD_LOGGER_FILE_BUF stream buffer that the worker empties
+ * into "<dir>/snap/<name>" once the records are out, so a file of any
+ * size costs that much RAM and the producer never holds a copy; it blocks
+ * while the buffer is full. One file in flight, from any task. Files are
+ * not kept in flash without a card (the writes fail), a file that was not
+ * ended with keep = true is deleted, and they are the first to be deleted
+ * when the card runs low on space.
+ */
+
+#ifndef CONFIG_GOLDIE_SDLOG_BATCH
+#define CONFIG_GOLDIE_SDLOG_BATCH 8
+#endif
+#ifndef CONFIG_GOLDIE_SDLOG_FLUSH_MS
+#define CONFIG_GOLDIE_SDLOG_FLUSH_MS 2000
+#endif
+#ifndef CONFIG_GOLDIE_SDLOG_SYNC_MS
+#define CONFIG_GOLDIE_SDLOG_SYNC_MS 10000
+#endif
+#ifndef CONFIG_GOLDIE_SDLOG_REMOUNT_S
+#define CONFIG_GOLDIE_SDLOG_REMOUNT_S 30
+#endif
+#ifndef CONFIG_GOLDIE_SDLOG_PREALLOC_KB
+#define CONFIG_GOLDIE_SDLOG_PREALLOC_KB 16
+#endif
+#ifndef CONFIG_GOLDIE_SDLOG_MIN_FREE_MB
+#define CONFIG_GOLDIE_SDLOG_MIN_FREE_MB 16
+#endif
+
+#define SD_LOGGER_RING       32    // Records in flight, power of two
+#define SD_LOGGER_BATCH      CONFIG_GOLDIE_SDLOG_BATCH
+#define SD_LOGGER_FLUSH_MS   CONFIG_GOLDIE_SDLOG_FLUSH_MS
+#define SD_LOGGER_SYNC_MS    CONFIG_GOLDIE_SDLOG_SYNC_MS
+#define SD_LOGGER_REMOUNT_MS (CONFIG_GOLDIE_SDLOG_REMOUNT_S * 1000u)
+#define SD_LOGGER_PREALLOC_BLOCKS (CONFIG_GOLDIE_SDLOG_PREALLOC_KB * 1024 / SD_LOG_BLOCK_SIZE)
+#define SD_LOGGER_MIN_FREE_KB (CONFIG_GOLDIE_SDLOG_MIN_FREE_MB * 1024u)
+#define SD_LOGGER_HEALTH_MS  60000
+#define SD_LOGGER_LAT_BUCKETS 20   // log2 of the write time in us: 1 us .. 0.5 s+
+#define SD_LOGGER_OPEN_FILES 4     // One per log type
+#define SD_LOGGER_VALUES     5
+#define SD_LOGGER_FILE_DIR   "snap" // sd_logger_file_begin() files, under the log directory
+#define SD_LOGGER_FILE_BUF   4096  // Stream buffer between a file's producer and the worker
+#define SD_LOGGER_FILE_STALL_MS 5000 // No write or end for this long: the worker gives the file up
+#define SD_LOG_BLOCK_SIZE    512   // One SD sector
+#define SD_LOG_BLOCK_RECORDS (SD_LOG_BLOCK_SIZE / sizeof(sd_log_disk_record_t))
+
+typedef enum {
+    SD_LOG_NONE = 0,               // Unused slot of a block
+    SD_LOG_MEDICATION,             // amount, per volume, tank size, dosage ml + flags
+    SD_LOG_PARAMETERS,             // ammonia, nitrate, nitrite, pH (ppm)
+    SD_LOG_WATER_CHANGE,           // planned interval (days)
+    SD_LOG_FEED,                   // feeds per day
+    SD_LOG_TYPE_COUNT
+} sd_log_type_t;
+
+// flags of SD_LOG_MEDICATION
+#define SD_LOG_MED_UNIT_MASK     0x07  // Product unit: ml, tsp, tbsp, drops, fl oz, cups, g
+#define SD_LOG_MED_PER_GALLONS   0x08  // Dose is per gallon (else per litre)
+#define SD_LOG_MED_TANK_GALLONS  0x10  // Tank size in gallons
+
+// On-disk record (little endian, no padding)
+typedef struct {
+    uint32_t timestamp;            // Wall clock, seconds since the epoch
+    uint8_t type;                  // sd_log_type_t
+    uint8_t flags;
+    uint16_t reserved;
+    float value[SD_LOGGER_VALUES];
+    uint32_t crc32;                // esp_rom_crc32_le(0, ...) over the fields above
+} sd_log_disk_record_t;
+
+// Ring entry
+typedef struct {
+    sd_log_disk_record_t rec;      // crc32 is filled in by the worker
+    uint32_t queued_ms;            // Enqueue time (esp_timer), for the flush deadline
+} sd_log_record_t;
+
+typedef struct {
+    uint32_t queued;
+    uint32_t written;
+    uint32_t dropped;              // Ring full, or neither SD nor flash writable
+    uint32_t batches;
+    uint32_t recovered;            // Torn records found at the end of a file
+    uint32_t to_flash;             // Kept in internal flash without a card
+    uint32_t drained;              // Copied from flash to SD since
+    uint32_t free_kb;              // At the last health check, 0 = unknown
+    uint32_t deleted_files;        // Oldest logs removed for space
+    uint32_t files_written;        // sd_logger_file_begin() .. end(true)
+    uint32_t files_dropped;        // One still in flight, no card, a write error or end(false)
+    uint32_t write_p50_us;         // Block write time (bucket upper bound)
+    uint32_t write_p99_us;
+} sd_logger_stats_t;
+
+/**
+ * @brief Set the log directory (created on the first write if missing)
+ */
+void sd_logger_init(const char *dir);
+
+/**
+ * @brief Queue one record
+ * @param when   Wall clock of the record; it goes to that day's file
+ * @param values Up to SD_LOGGER_VALUES values, the rest are zero
+ * @return false if the record was dropped (ring full or bad type)
+ */
+bool sd_logger_log(sd_log_type_t type, time_t when, uint8_t flags, const float *values, size_t count);
+
+/**
+ * @brief Start streaming a file (any task)
+ * @param name File name under SD_LOGGER_FILE_DIR
+ * @return false if the previous file is still being written
+ */
+bool sd_logger_file_begin(const char *name);
+
+/**
+ * @brief Append to the file started by sd_logger_file_begin()
+ *
+ * Blocks while the stream buffer is full, up to timeout_ms in all.
+ * @return false once the file has failed (no card, write error, timeout):
+ *         end it with keep = false
+ */
+bool sd_logger_file_write(const void *data, size_t len, uint32_t timeout_ms);
+
+/**
+ * @brief Finish the file; the worker closes it once the buffer is empty
+ * @param keep false: delete what was written (the producer failed)
+ */
+void sd_logger_file_end(bool keep);
+
+/**
+ * @brief Worker: register (or with NULL, unregister) the task that drains the ring
+ */
+void sd_logger_attach(TaskHandle_t consumer);
+
+/**
+ * @brief Worker: wait up to max_wait_ms for a batch to become due and write it
+ */
+void sd_logger_run(uint32_t max_wait_ms);
+
+/**
+ * @brief Worker: write everything queued now
+ */
+void sd_logger_flush(void);
+
+/**
+ * @brief Worker: write everything queued, fsync and close all files (before stopping)
+ */
+void sd_logger_close(void);
+
+/**
+ * @brief Counters since boot
+ */
+void sd_logger_get_stats(sd_logger_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SD_LOGGER_H
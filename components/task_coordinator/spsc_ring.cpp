@@ -0,0 +1,120 @@
+#include "spsc_ring.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "spsc_ring";
+
+#define SPSC_BENCH_ITEMS  20000
+#define SPSC_BENCH_DEPTH  64
+#define SPSC_BENCH_MIX    2654435761u   // Payload = seq * MIX, checked on arrival
+
+typedef struct {
+    uint32_t seq;
+    uint32_t value;
+} bench_item_t;
+
+typedef struct {
+    bool use_ring;
+    int64_t elapsed_us;                // First to last item on the consumer
+    uint32_t errors;                   // Out-of-order or torn items
+} bench_run_t;
+
+static SpscRing<bench_item_t, SPSC_BENCH_DEPTH> bench_ring;
+static QueueHandle_t bench_queue = NULL;
+static SemaphoreHandle_t bench_done = NULL;
+
+static void bench_producer(void *arg)
+{
+    bench_run_t *run = (bench_run_t *)arg;
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);  // Go once the consumer exists
+    for (uint32_t i = 0; i < SPSC_BENCH_ITEMS; i++) {
+        bench_item_t item = { i, i * SPSC_BENCH_MIX };
+        if (run->use_ring) {
+            while (!bench_ring.push(item)) {
+                // Full: the consumer on the other core drains it
+            }
+        } else {
+            xQueueSend(bench_queue, &item, portMAX_DELAY);
+        }
+    }
+    xSemaphoreGive(bench_done);
+    vTaskDelete(NULL);
+}
+
+static void bench_consumer(void *arg)
+{
+    bench_run_t *run = (bench_run_t *)arg;
+    bench_item_t item;
+    int64_t t0 = 0;
+    for (uint32_t i = 0; i < SPSC_BENCH_ITEMS; i++) {
+        if (run->use_ring) {
+            while (!bench_ring.pop(item)) {
+            }
+        } else {
+            xQueueReceive(bench_queue, &item, portMAX_DELAY);
+        }
+        if (i == 0) {
+            t0 = esp_timer_get_time();
+        }
+        if (item.seq != i || item.value != i * SPSC_BENCH_MIX) {
+            run->errors++;
+        }
+    }
+    run->elapsed_us = esp_timer_get_time() - t0;
+    xSemaphoreGive(bench_done);
+    vTaskDelete(NULL);
+}
+
+static bool bench_run(bench_run_t *run)
+{
+    // The producer waits for a notification, so a failed consumer create
+    // leaves nothing spinning
+    TaskHandle_t producer = NULL;
+    if (xTaskCreatePinnedToCore(bench_producer, "spsc_prod", 3072, run, 1, &producer, 0) != pdPASS) {
+        ESP_LOGW(TAG, "Benchmark skipped - no memory for its tasks");
+        return false;
+    }
+    if (xTaskCreatePinnedToCore(bench_consumer, "spsc_cons", 3072, run, 1, NULL, 1) != pdPASS) {
+        vTaskDelete(producer);
+        ESP_LOGW(TAG, "Benchmark skipped - no memory for its tasks");
+        return false;
+    }
+    xTaskNotifyGive(producer);
+    xSemaphoreTake(bench_done, portMAX_DELAY);
+    xSemaphoreTake(bench_done, portMAX_DELAY);
+    return true;
+}
+
+void spsc_ring_benchmark(void)
+{
+    bench_queue = xQueueCreate(SPSC_BENCH_DEPTH, sizeof(bench_item_t));
+    bench_done = xSemaphoreCreateCounting(2, 0);
+    if (!bench_queue || !bench_done) {
+        ESP_LOGW(TAG, "Benchmark skipped - out of memory");
+        return;
+    }
+
+    bench_run_t ring = { .use_ring = true, .elapsed_us = 0, .errors = 0 };
+    bench_run_t queue = { .use_ring = false, .elapsed_us = 0, .errors = 0 };
+    if (bench_run(&ring) && bench_run(&queue)) {
+        uint32_t ring_ns = (uint32_t)(ring.elapsed_us * 1000 / SPSC_BENCH_ITEMS);
+        uint32_t queue_ns = (uint32_t)(queue.elapsed_us * 1000 / SPSC_BENCH_ITEMS);
+        ESP_LOGI(TAG, "[SPSC] %d items C0->C1, depth %d: ring %lu ns/item, xQueue %lu ns/item (%.1fx)",
+                 SPSC_BENCH_ITEMS, SPSC_BENCH_DEPTH, (unsigned long)ring_ns, (unsigned long)queue_ns,
+                 ring_ns ? (float)queue_ns / ring_ns : 0.0f);
+        if (ring.errors || queue.errors) {
+            ESP_LOGE(TAG, "[SPSC] Ordering errors: ring %lu, xQueue %lu",
+                     (unsigned long)ring.errors, (unsigned long)queue.errors);
+        }
+    }
+
+    // Only reached once both tasks of every started run have finished
+    vQueueDelete(bench_queue);
+    vSemaphoreDelete(bench_done);
+    bench_queue = NULL;
+    bench_done = NULL;
+}
@@ -0,0 +1,128 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <type_traits>
+
+/**
+ * SPSC Ring - lock-free single-producer / single-consumer ring buffer
+ *
+ * For streams that cross cores at a high rate (sensor samples, log records,
+ * slot ids) where a FreeRTOS queue's critical section and copy-in/copy-out
+ * cost more than the payload. Exactly one task may call push() and exactly
+ * one task may call pop(); neither call blocks. Pair it with a task
+ * notification or an LVGL wake if the consumer should sleep while empty.
+ *
+ * Memory ordering: the producer writes the element, then publishes head
+ * with release; the consumer reads head with acquire before touching the
+ * element (and the mirror for tail), so an element is never seen half
+ * written on the other core. `volatile` gives no such guarantee.
+ *
+ * head and tail sit on separate cache lines so the two cores do not
+ * invalidate each other's line on every operation (64 bytes covers the
+ * largest ESP32-S3 data cache line setting). Each side also keeps a cached
+ * copy of the other index and only re-reads it when the ring looks
+ * full/empty.
+ *
+ * Capacity N must be a power of two; all N slots are usable.
+ */
+
+#define SPSC_RING_CACHE_LINE 64
+
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing elements are copied by value");
+
+public:
+    SpscRing() : head_(0), tail_cache_(0), tail_(0), head_cache_(0) {}
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    /**
+     * @brief Producer: append one element
+     * @return false if the ring is full (nothing written)
+     */
+    bool push(const T &item)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_cache_ >= N) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head - tail_cache_ >= N) {
+                return false;
+            }
+        }
+        slots_[head & (N - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer: take the oldest element
+     * @return false if the ring is empty (item untouched)
+     */
+    bool pop(T &item)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_cache_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail == head_cache_) {
+                return false;
+            }
+        }
+        item = slots_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer: look at the oldest element without taking it
+     * @return NULL if empty; valid until the next pop()
+     */
+    const T *peek()
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_cache_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail == head_cache_) {
+                return NULL;
+            }
+        }
+        return &slots_[tail & (N - 1)];
+    }
+
+    /**
+     * @brief Elements queued (exact from either side for its own view,
+     *        a snapshot from anywhere else)
+     */
+    size_t size() const
+    {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    // Producer line: head + its view of tail
+    alignas(SPSC_RING_CACHE_LINE) std::atomic<size_t> head_;
+    size_t tail_cache_;
+    // Consumer line: tail + its view of head
+    alignas(SPSC_RING_CACHE_LINE) std::atomic<size_t> tail_;
+    size_t head_cache_;
+    alignas(SPSC_RING_CACHE_LINE) T slots_[N];
+};
+
+/**
+ * @brief Cross-core microbenchmark: SpscRing vs xQueueSend/xQueueReceive
+ *
+ * Streams SPSC_BENCH_ITEMS 8-byte items from Core 0 to Core 1 through
+ * both, checks every sequence number and logs ns per item. Blocks the
+ * caller for a few hundred ms; runs once from task_coordinator_init()
+ * when CONFIG_GOLDIE_SPSC_BENCHMARK is enabled.
+ */
+void spsc_ring_benchmark(void);
+
+#endif // SPSC_RING_H
@@ -2,144 +2,711 @@
 #include "messages.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
 #include <stdio.h>
 
 // STABILIZATION FIX: Include proper headers instead of manual extern declarations
 #include "gemini_api.h"
+#include "ai_provider.h"
+#include "ai_chat.h"
 #include "blynk_integration.h"
+#include "blynk_config.h"
+#include "history_export.h"
+#include "lan_live.h"
+#include "screen_mirror.h"
+#include "device_api.h"
+#include "http_pool.h"
+#include "dns_cache.h"
+#include "history_sync.h"
+#include "power_gov.h"
+#include "boot_trace.h"
 #include "wifi_config.h"  // For WIFI_SSID in diagnostic logs
+#include "codec/frame_codec.h"
+#include "anim/frame_cache.h"
+#include "anim/frame_pool.h"
+#include "anim/frame_map.h"
+#include "anim/frame_overlay.h"
+#include "anim/frame_backend.h"
+#include "anim/frame_load.h"
+#include "anim/anim_timeline.h"
+#include "asset_bundle.h"
+#include "codec/frame_io.h"
+#include "codec/frame_split.h"
+#include "codec/frame_jpeg.h"
+#include "anim/frame_bench.h"
+#include "pixel_kernels.h"
+#include "time_svc.h"
+#include "mood/mood_engine.h"
+#include "mood/mood_trend.h"
+#include "mood/mood_drift.h"
+#include "sched/reminders.h"
+#include "mood/mood_alerts.h"
+#include "dashboard.h"
+#include "ui/ui_inbox.h"
+#include "ui/ui_latency.h"
+#include "task_layout.h"
+#include "task_monitor.h"
+#include "job_watch.h"
+#include "queue_watch.h"
+#include "evt_trace.h"
+#include "input_rec.h"
+#include "metrics.h"
+#include "blackbox.h"
+#include "spsc_ring.h"
+#include "sd_logger.h"
+#include "telemetry_backlog.h"
+#include "net_sched.h"
+#include "job_pool.h"
+#include "co_exec.h"
+#include "bin_log.h"
+#if CONFIG_GOLDIE_ESPNOW_HUB
+#include "espnow_hub.h"
+#endif
+#if CONFIG_GOLDIE_RTC
+#include "rtc_clock.h"
+#endif
+#include <string.h>
+#include <time.h>
+#include <atomic>
 
 static const char *TAG = "task_coordinator";
 
-// STABILIZATION: Global state flags for fail-safe operation
-static volatile bool wifi_initialized = false;
-static volatile bool blynk_initialized = false;
+// STABILIZATION: Global state flags for fail-safe operation (written by
+// bg_wifi_init, read by the workers on either core - atomics, not volatile)
+static std::atomic<bool> wifi_initialized(false);
+static std::atomic<bool> blynk_initialized(false);
 
-// External function from dashboard.cpp (mood calculation)
-extern "C" {
-    mood_result_t calculate_mood_scores(aquarium_params_t params, uint32_t current_time);
-}
-
-// External dashboard calendar update
-extern "C" {
-    void dashboard_update_calendar(void);
-}
+// Run-time deadline of each coordinator job (job_watch.h). Finishing later
+// is reported as an overrun; running far past it trips the task watchdog.
+#define JOB_RUN_WIFI_INIT_MS   2000    // Driver + netif setup (connecting is event-driven)
+#define JOB_RUN_BLYNK_INIT_MS  6000    // One HTTP call (5 s timeout)
+#define JOB_RUN_RTC_SYNC_MS    1500    // Up to 1 s to a second boundary + RTC I/O
+#define JOB_RUN_MOOD_MS        50      // Pure computation + bus publish
+#define JOB_RUN_FRAME_MS       500     // Cache copy or SPIFFS read + decode of one frame
+#define JOB_RUN_PREFETCH_MS    800     // Full frame decode into a speculative slot
+#define JOB_RUN_GROQ_MS        15000   // 10 s HTTP timeout + TLS handshake
+#define JOB_RUN_BLYNK_MS       6000    // One batched HTTP call (5 s timeout)
+#define JOB_RUN_BLYNK_STATS_MS 6000    // One HTTP call (5 s timeout)
+#define JOB_RUN_BLYNK_FORECAST_MS 6000 // One HTTP call (5 s timeout)
+#define JOB_RUN_BLYNK_REMINDER_MS 6000 // One HTTP call (5 s timeout)
+#define JOB_RUN_BLYNK_ALERT_MS 6000    // One HTTP call (5 s timeout)
+#define JOB_RUN_BACKFILL_MS    (TELEMETRY_BACKLOG_VALUES * 6000)  // One HTTP call per pin
+#define JOB_RUN_HISTORY_SYNC_MS (HISTORY_SYNC_STEP_CHUNKS * (HISTORY_SYNC_TIMEOUT_MS + 2000) + 2000)  // Chunks + batch build
 
-// STEP 3: External access to frame buffers and state from dashboard.cpp
-extern uint8_t *frame_buffer_a;
-extern uint8_t *frame_buffer_b;
-extern volatile bool buffer_a_ready;
-extern volatile uint8_t buffer_a_frame_index;
-extern volatile bool buffer_b_ready;
-extern volatile uint8_t buffer_b_frame_index;
+#define NET_CONNECT_WARN_MS    30000   // No IP this long: report offline (still waiting)
 
-// External SPIFFS loading function from dashboard.cpp
-extern "C" bool load_frame_from_spiffs(uint8_t frame_num, uint8_t *buffer);
-
-// Time utility (duplicated from dashboard.cpp - no LVGL dependency)
-static uint32_t get_current_time_seconds(void)
-{
-    return (uint32_t)(esp_timer_get_time() / 1000000);
-}
+#ifndef CONFIG_GOLDIE_AI_PREFETCH_LEAD_S
+#define CONFIG_GOLDIE_AI_PREFETCH_LEAD_S 0      // Only with CONFIG_GOLDIE_AI
+#endif
 
 /**
- * Background WiFi Init Task - STABILIZATION FIX
+ * Background WiFi Init - STABILIZATION FIX
  * 
- * Initializes WiFi asynchronously on Core 1 to avoid blocking app_main.
- * Once WiFi connects, initializes Blynk and calendar, then deletes itself.
+ * A coroutine on the executor task (co_exec.h). Starts WiFi on Core 1
+ * without blocking app_main, then runs the connection state machine: it
+ * waits on the gemini_net_events() group and starts each dependent the
+ * moment its event fires.
+ *   NET_EVENT_CHANGED      -> dashboard told (UI_MSG_WIFI_STATE); first
+ *                             lease: Blynk (NET_EVENT_BLYNK_READY), the
+ *                             history export and the LAN live dashboard
+ *   NET_EVENT_TIME_SYNCED  -> calendar updated
+ *   NET_EVENT_TIME_FRESH   -> RTC brought in line (every SNTP sync)
  * 
- * FAIL-SAFE: If WiFi fails, system continues in OFFLINE mode indefinitely.
+ * FAIL-SAFE: If WiFi never connects, system continues in OFFLINE mode
+ * and goes online whenever a lease arrives.
  */
-static void background_wifi_init_task(void *pvParameters)
+static CoTask background_wifi_init(void)
 {
-    ESP_LOGI(TAG, "★═══════════════════════════════════════════════════════════★");
-    ESP_LOGI(TAG, "★  Background WiFi Initialization Started (Core %d)        ★", xPortGetCoreID());
-    ESP_LOGI(TAG, "★═══════════════════════════════════════════════════════════★");
+    BLOGI(TAG, "Background WiFi initialization started (core %d)", xPortGetCoreID());
     
     // Give UI time to start (1 second delay)
-    vTaskDelay(pdMS_TO_TICKS(1000));
+    co_await co_delay(1000);
     
-    ESP_LOGI(TAG, "► Attempting WiFi connection to '%s'...", WIFI_SSID);
+    BLOGI(TAG, "Attempting WiFi connection to '%s'", WIFI_SSID);
+    job_watch_begin(TASK_ID_CO_EXEC, "wifi_start", JOB_RUN_WIFI_INIT_MS);
     bool wifi_ok = gemini_init_wifi();
+    job_watch_end(TASK_ID_CO_EXEC);
+    EventGroupHandle_t net = gemini_net_events();
     
-    if (wifi_ok) {
-        ESP_LOGI(TAG, "★═══════════════════════════════════════════════════════════★");
-        ESP_LOGI(TAG, "★  ✓ WiFi CONNECTED Successfully!                         ★");
-        ESP_LOGI(TAG, "★  Network: %s                                            ★", WIFI_SSID);
-        ESP_LOGI(TAG, "★  Groq AI: READY (llama-3.3-70b-versatile)              ★");
-        ESP_LOGI(TAG, "★═══════════════════════════════════════════════════════════★");
-        wifi_initialized = true;
+    if (!wifi_ok || net == NULL) {
+        BLOGE(TAG, "WiFi start failed - staying in OFFLINE mode");
+        co_return;
+    }
+#if CONFIG_GOLDIE_ESPNOW_HUB
+    espnow_hub_start();      // Sensor nodes need the radio up, not the lease (espnow_hub.h)
+#endif
+    
+    int64_t start_us = esp_timer_get_time();
+    bool online_once = false;
+    bool time_done = false;
+    bool offline_reported = false;
+    while (true) {
+        // Event-driven: the timeout only exists for the one-off offline report
+        EventBits_t wait_for = NET_EVENT_CHANGED | NET_EVENT_TIME_FRESH | (time_done ? 0 : NET_EVENT_TIME_SYNCED);
+        TickType_t timeout = (online_once || offline_reported) ? portMAX_DELAY : pdMS_TO_TICKS(NET_CONNECT_WARN_MS);
+        EventBits_t bits = co_await co_bits(net, wait_for, false, timeout);
         
-        // Update calendar with current time
-        dashboard_update_calendar();
+        if (bits & NET_EVENT_CHANGED) {
+            xEventGroupClearBits(net, NET_EVENT_CHANGED);
+            bool online = (bits & NET_EVENT_IP) != 0;
+            wifi_initialized = online;
+            ui_inbox_post(UI_MSG_WIFI_STATE);   // Dashboard reacts to (re)connects
+            
+            if (online && !online_once) {
+                online_once = true;
+                boot_trace_mark("wifi ip");
+                BLOGI(TAG, "WiFi connected to %s after %lu ms - AI ready", WIFI_SSID,
+                      (unsigned long)((esp_timer_get_time() - start_us) / 1000));
+                
+#if CONFIG_GOLDIE_BLYNK
+                // Initialize Blynk (graceful failure)
+                job_watch_begin(TASK_ID_CO_EXEC, "blynk_init", JOB_RUN_BLYNK_INIT_MS);
+                bool blynk_ok = blynk_init();
+                job_watch_end(TASK_ID_CO_EXEC);
+                if (blynk_ok) {
+                    ESP_LOGI(TAG, "✓ Blynk initialized - mobile dashboard active");
+                    blynk_initialized = true;
+                    xEventGroupSetBits(net, NET_EVENT_BLYNK_READY);
+                } else {
+                    ESP_LOGW(TAG, "✗ Blynk init failed - mobile dashboard unavailable");
+                }
+#endif
+                
+#if CONFIG_GOLDIE_HISTORY_EXPORT
+                if (!history_export_start()) {
+                    ESP_LOGW(TAG, "✗ History export unavailable");
+                }
+#endif
+#if CONFIG_GOLDIE_LAN_LIVE
+                if (!lan_live_start()) {
+                    ESP_LOGW(TAG, "✗ LAN live dashboard unavailable");
+                }
+#endif
+#if CONFIG_GOLDIE_SCREEN_MIRROR
+                if (!screen_mirror_start()) {
+                    ESP_LOGW(TAG, "✗ Screen mirror unavailable");
+                }
+#endif
+#if CONFIG_GOLDIE_DEVICE_API
+                if (!device_api_start()) {
+                    ESP_LOGW(TAG, "✗ Device API unavailable");
+                }
+#endif
+                
+                ESP_LOGI(TAG, "System now ONLINE - AI Assistant ready");
+            }
+        }
         
-        // Initialize Blynk (graceful failure)
-        if (blynk_init()) {
-            ESP_LOGI(TAG, "✓ Blynk initialized - mobile dashboard active");
-            blynk_initialized = true;
-        } else {
-            ESP_LOGW(TAG, "✗ Blynk init failed - mobile dashboard unavailable");
+        if (!time_done && (bits & NET_EVENT_TIME_SYNCED)) {
+            time_done = true;
+            boot_trace_mark("time synced");
+            struct tm timeinfo;
+            char strftime_buf[64];
+            time_svc_local(&timeinfo);
+            strftime(strftime_buf, sizeof(strftime_buf), "%c", &timeinfo);
+            ESP_LOGI(TAG, "Time synchronized: %s (%lu ms after start)", strftime_buf,
+                     (unsigned long)((esp_timer_get_time() - start_us) / 1000));
+            
+            // Update calendar with current time
+            dashboard_update_calendar();
         }
         
-        ESP_LOGI(TAG, "System now ONLINE - AI Assistant ready");
-    } else {
-        ESP_LOGE(TAG, "★═══════════════════════════════════════════════════════════★");
-        ESP_LOGE(TAG, "★  ✗ WiFi CONNECTION FAILED!                              ★");
-        ESP_LOGE(TAG, "★  Network: %s                                            ★", WIFI_SSID);
-        ESP_LOGE(TAG, "★  System will remain in OFFLINE mode                     ★");
-        ESP_LOGE(TAG, "★  Check: SSID, password, router settings                 ★");
-        ESP_LOGE(TAG, "★═══════════════════════════════════════════════════════════★");
-        wifi_initialized = false;
-        blynk_initialized = false;
-    }
-    
-    // Task complete - delete self
-    ESP_LOGI(TAG, "Background WiFi init task completed (status: %s), deleting self", 
-             wifi_initialized ? "SUCCESS" : "FAILED");
+        if (bits & NET_EVENT_TIME_FRESH) {
+            xEventGroupClearBits(net, NET_EVENT_TIME_FRESH);
+            dashboard_update_calendar();   // A re-sync may move midnight
+#if CONFIG_GOLDIE_RTC
+            job_watch_begin(TASK_ID_CO_EXEC, "rtc_sync", JOB_RUN_RTC_SYNC_MS);
+            rtc_clock_sync();   // The RTC keeps SNTP time across power cuts
+            job_watch_end(TASK_ID_CO_EXEC);
+#endif
+        }
+        
+        if (!online_once && !offline_reported && (bits & wait_for) == 0) {
+            offline_reported = true;
+            BLOGE(TAG, "No IP from %s after %d s - OFFLINE until a lease arrives (check SSID, password, router)",
+                  WIFI_SSID, NET_CONNECT_WARN_MS / 1000);
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// WORKER LIFECYCLE (start / stop / restart)
+// ═══════════════════════════════════════════════════════════════════════════
+// Each managed worker polls worker_should_stop() at least once per
+// WORKER_STOP_POLL_MS (its queue waits are bounded by it) and leaves through
+// worker_exit(). lifecycle_lock serialises handle changes between callers
+// and the exiting worker.
+#define WORKER_STOP_POLL_MS  1000
+
+typedef struct {
+    TaskFunction_t fn;
+    TaskHandle_t handle;             // NULL = stopped
+    std::atomic<bool> stop_requested;
+    bool restart_pending;            // start() arrived while stopping
+    SemaphoreHandle_t exited;        // Given once the worker has cleaned up
+} worker_slot_t;
+
+static worker_slot_t workers[TASK_ID_COUNT];
+static SemaphoreHandle_t lifecycle_lock = NULL;
+
+static bool worker_managed(task_id_t id)
+{
+    return id == TASK_ID_LOGIC || id == TASK_ID_STORAGE ||
+           id == TASK_ID_TELEMETRY || id == TASK_ID_AI || id == TASK_ID_SDLOG;
+}
+
+static inline bool worker_should_stop(task_id_t id)
+{
+    return workers[id].stop_requested;
+}
+
+// Caller holds lifecycle_lock
+static esp_err_t worker_spawn(task_id_t id)
+{
+    worker_slot_t *w = &workers[id];
+    w->stop_requested = false;
+    xSemaphoreTake(w->exited, 0);  // Drop a stale exit signal
+    
+    if (task_layout_create(id, w->fn, NULL, &w->handle) != pdPASS) {
+        w->handle = NULL;
+        ESP_LOGE(TAG, "Failed to create %s task", task_layout_get(id)->name);
+        return ESP_ERR_NO_MEM;
+    }
+    task_monitor_register(id, w->handle);
+    return ESP_OK;
+}
+
+/**
+ * @brief Last call of a managed worker: hand over and delete itself
+ */
+static void worker_exit(task_id_t id)
+{
+    worker_slot_t *w = &workers[id];
+    task_monitor_unregister(id);
+    
+    xSemaphoreTake(lifecycle_lock, portMAX_DELAY);
+    w->handle = NULL;
+    bool respawn = w->restart_pending;
+    w->restart_pending = false;
+    if (respawn) {
+        worker_spawn(id);
+    }
+    xSemaphoreGive(lifecycle_lock);
+    
+    ESP_LOGI(TAG, "%s stopped%s", task_layout_get(id)->name, respawn ? " - starting again" : "");
+    if (!respawn) {
+        xSemaphoreGive(w->exited);
+    }
     vTaskDelete(NULL);
 }
 
-// Task handles
-static TaskHandle_t logic_task_handle = NULL;
-static TaskHandle_t storage_task_handle = NULL;
-static TaskHandle_t wifi_task_handle = NULL;
-static TaskHandle_t bg_wifi_init_handle = NULL;
+extern "C" esp_err_t task_coordinator_start(task_id_t id)
+{
+    if (!worker_managed(id)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (lifecycle_lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    esp_err_t err = ESP_OK;
+    xSemaphoreTake(lifecycle_lock, portMAX_DELAY);
+    worker_slot_t *w = &workers[id];
+    if (w->handle == NULL) {
+        err = worker_spawn(id);
+        if (err == ESP_OK) {
+            ESP_LOGI(TAG, "%s started", task_layout_get(id)->name);
+        }
+    } else if (w->stop_requested) {
+        w->restart_pending = true;  // worker_exit() brings it back
+    }
+    xSemaphoreGive(lifecycle_lock);
+    return err;
+}
+
+extern "C" esp_err_t task_coordinator_stop(task_id_t id, uint32_t timeout_ms)
+{
+    if (!worker_managed(id)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (lifecycle_lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    xSemaphoreTake(lifecycle_lock, portMAX_DELAY);
+    worker_slot_t *w = &workers[id];
+    bool running = (w->handle != NULL);
+    if (running) {
+        w->restart_pending = false;
+        w->stop_requested = true;
+    }
+    xSemaphoreGive(lifecycle_lock);
+    
+    if (!running) {
+        return ESP_OK;
+    }
+    ESP_LOGI(TAG, "Stopping %s", task_layout_get(id)->name);
+    if (timeout_ms == 0) {
+        return ESP_OK;
+    }
+    if (xSemaphoreTake(w->exited, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        ESP_LOGW(TAG, "%s did not stop within %lu ms", task_layout_get(id)->name, (unsigned long)timeout_ms);
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+extern "C" esp_err_t task_coordinator_restart(task_id_t id, uint32_t timeout_ms)
+{
+    esp_err_t err = task_coordinator_stop(id, timeout_ms);
+    
+    if (err == ESP_ERR_TIMEOUT) {
+        // Wedged: it never reached a stop point, so take it down from outside
+        xSemaphoreTake(lifecycle_lock, portMAX_DELAY);
+        worker_slot_t *w = &workers[id];
+        if (w->handle != NULL) {
+            ESP_LOGE(TAG, "%s wedged - deleting it (resources it holds are leaked)",
+                     task_layout_get(id)->name);
+            task_monitor_unregister(id);
+            job_watch_end(id);  // Reports the job it was stuck in
+            vTaskDelete(w->handle);
+            w->handle = NULL;
+            w->restart_pending = false;
+        }
+        xSemaphoreGive(lifecycle_lock);
+    } else if (err != ESP_OK) {
+        return err;
+    }
+    return task_coordinator_start(id);
+}
+
+extern "C" bool task_coordinator_is_running(task_id_t id)
+{
+    return worker_managed(id) && workers[id].handle != NULL && !workers[id].stop_requested;
+}
 
 // Queue handles (minimal placeholders)
 QueueHandle_t queue_param_update = NULL;
-QueueHandle_t queue_mood_result = NULL;
 QueueHandle_t queue_anim_frame_request = NULL;
 QueueHandle_t queue_anim_frame_ready = NULL;
+QueueHandle_t queue_anim_frame_free = NULL;
+QueueHandle_t queue_anim_prefetch = NULL;
 QueueHandle_t queue_ai_request = NULL;
-QueueHandle_t queue_ai_result = NULL;
-QueueHandle_t queue_blynk_sync = NULL;
+
+/**
+ * Mood categories the tank is one scoring step away from, as a bitmask
+ * (bit N = category N). Used to prefetch frame 0 of those moods.
+ * 
+ * Factor scores step 2 -> 1/0 -> -1 -> -2, so a factor at 0/1 is one step
+ * from forcing SAD and a factor at -1 is one step from forcing ANGRY.
+ */
+static uint8_t mood_drift_targets(const mood_result_t *r)
+{
+    int scores[6] = { r->ammonia_score, r->nitrite_score, r->nitrate_score,
+                      r->ph_score, r->feed_score, r->clean_score };
+    int min_factor = 2;
+    for (int i = 0; i < 6; i++) {
+        if (scores[i] < min_factor) {
+            min_factor = scores[i];
+        }
+    }
+    
+    uint8_t mask = 0;
+    switch (r->category) {
+        case 0:  // HAPPY: total >= 6, no warnings
+            if (r->total_score <= 7 || min_factor <= 1) mask |= (1 << 1);
+            break;
+        case 1:  // SAD: can recover or get worse
+            if (r->total_score >= 5 && min_factor >= 0) mask |= (1 << 0);
+            if (r->total_score <= 1 || min_factor <= -1) mask |= (1 << 2);
+            break;
+        default: // ANGRY: recovering towards SAD
+            if (r->total_score >= -1 && min_factor >= -1) mask |= (1 << 1);
+            break;
+    }
+    return mask;
+}
+
+// Trend window (mood/mood_trend.h): file scope so history survives a
+// worker restart
+#define MOOD_TREND_RESAMPLE_S   3600   // Unchanged readings count again after this
+#define FORECAST_MOVE_S         900    // Re-publish when a prediction moves this much
+
+static mood_trend_t mood_trend;
+static mood_drift_t mood_drift;          // Scored per trend sample (mood/mood_drift.h)
+static aquarium_params_t trend_last;     // Last sample added, and when
+static uint32_t trend_last_time = 0;
+
+static bool water_changed(const aquarium_params_t *a, const aquarium_params_t *b)
+{
+    return a->ammonia_ppm != b->ammonia_ppm || a->nitrite_ppm != b->nitrite_ppm ||
+           a->nitrate_ppm != b->nitrate_ppm || a->ph_level != b->ph_level;
+}
+
+static bool deadline_moved(uint32_t a_ts, uint32_t a_s, uint32_t b_ts, uint32_t b_s)
+{
+    if ((a_s == MOOD_FORECAST_NONE) != (b_s == MOOD_FORECAST_NONE)) {
+        return true;
+    }
+    if (a_s == MOOD_FORECAST_NONE) {
+        return false;
+    }
+    int64_t a_at = (int64_t)a_ts + a_s;
+    int64_t b_at = (int64_t)b_ts + b_s;
+    return (a_at > b_at ? a_at - b_at : b_at - a_at) > FORECAST_MOVE_S;
+}
+
+/**
+ * @brief Whether a new forecast is worth publishing over the last one
+ */
+static bool forecast_moved(const mood_forecast_t *a, const mood_forecast_t *b)
+{
+    return a->category != b->category || a->sad_factor != b->sad_factor ||
+           a->angry_factor != b->angry_factor || a->drift_mask != b->drift_mask ||
+           deadline_moved(a->timestamp, a->to_sad_s, b->timestamp, b->to_sad_s) ||
+           deadline_moved(a->timestamp, a->to_angry_s, b->timestamp, b->to_angry_s);
+}
+
+// Mood engine instance of each tank (tank_params_msg_t), with the category
+// last published and the moods it was drifting towards. File scope keeps
+// the logic stack independent of CONFIG_GOLDIE_TANK_COUNT; reset whenever
+// the worker starts, so its first pass publishes every tank.
+typedef struct {
+    mood_engine_state_t engine;
+    uint8_t last_category;
+    uint8_t last_drift;
+} tank_mood_t;
+
+static tank_mood_t tank_moods[TANK_MAX];
 
 /**
  * Logic Task - STEP 2 (Mood Calculation)
  * 
  * Receives parameter updates, calculates mood, sends results.
  * Pure computation - no UI, no blocking I/O.
+ *
+ * Incremental: mood_engine_update() rescores only the factors whose inputs
+ * changed, and the task also wakes at the exact second a feed/clean score
+ * crosses a band, so the mood follows the clock without the dashboard
+ * re-sending parameters. Results are published only when they changed.
+ * Each tank has its own engine; a result carries the tank it scores.
+ *
+ * Water tests of the first tank (wired probes, SD history) also go into a
+ * rolling trend window; the predicted time to SAD / ANGRY is published on
+ * MSG_TOPIC_MOOD_FORECAST when it moves, with the factors drifting
+ * unusually fast while still in band (mood_drift.h).
+ *
+ * A timed change that will move the category of the tank on screen is
+ * known in advance: up to CONFIG_GOLDIE_AI_PREFETCH_LEAD_S before it, the
+ * AI worker is asked to prefetch the advice of that state into the cache
+ * (once per change).
  */
 static void logic_task(void *pvParameters)
 {
-    ESP_LOGI(TAG, "Logic task started (mood calculation active)");
+    ESP_LOGI(TAG, "Logic task started (mood calculation active, %d tank(s))", TANK_MAX);
     
-    aquarium_params_t params;
-    mood_result_t result;
+    tank_params_msg_t msg;
+    mood_forecast_t last_forecast = {};
+    bool have_forecast = false;
+    uint8_t active = 0;                 // Tank on screen
+    uint8_t latest_tank = 0xFF;         // Tank mood_engine_set_latest() describes
+    uint32_t prefetched_at = 0;         // next_change already sent to the AI worker
+    memset(tank_moods, 0, sizeof(tank_moods));
+    for (tank_mood_t &tm : tank_moods) {
+        tm.last_category = 0xFF;
+    }
     
-    while (1) {
+    while (!worker_should_stop(TASK_ID_LOGIC)) {
+        // Sleep until new parameters arrive or the next feed/clean band of
+        // any tank is crossed, whichever comes first (bounded by the stop poll)
+        uint32_t next_change = MOOD_ENGINE_NEVER;
+        for (const tank_mood_t &tm : tank_moods) {
+            if (tm.engine.valid && tm.engine.next_change < next_change) {
+                next_change = tm.engine.next_change;
+            }
+        }
+        TickType_t wait = pdMS_TO_TICKS(WORKER_STOP_POLL_MS);
+        if (next_change != MOOD_ENGINE_NEVER) {
+            uint32_t now = time_svc_uptime_s();
+            uint32_t due_s = next_change > now ? next_change - now : 0;
+            if ((uint64_t)due_s * 1000 < WORKER_STOP_POLL_MS) {
+                wait = pdMS_TO_TICKS(due_s * 1000);
+            }
+        }
+        
         // Wait for parameter updates from LVGL task
-        if (xQueueReceive(queue_param_update, &params, portMAX_DELAY) == pdTRUE) {
+        bool have_params = xQueueReceive(queue_param_update, &msg, wait) == pdTRUE;
+        if (have_params) {
+            active = msg.active < TANK_MAX ? msg.active : 0;
+            for (uint8_t t = 0; t < TANK_MAX; t++) {
+                if (msg.dirty & (1 << t)) {
+                    ui_latency_record(UI_LATENCY_PARAM_TO_LOGIC, msg.tank[t].origin_us);
+                }
+            }
+        }
+        uint32_t now = time_svc_uptime_s();
+        
+        // Advice for the mood the clock is about to bring, ahead of time
+        // (not in the saver power profile: the screen asks when it changes)
+        const mood_engine_state_t *shown = &tank_moods[active].engine;
+        if (CONFIG_GOLDIE_AI_PREFETCH_LEAD_S > 0 && power_gov_ai_prefetch() && shown->valid && shown->next_change != MOOD_ENGINE_NEVER &&
+            shown->next_change > now && shown->next_change - now <= CONFIG_GOLDIE_AI_PREFETCH_LEAD_S &&
+            shown->next_change != prefetched_at &&
+            mood_engine_evaluate(&shown->params, shown->next_change).category != shown->result.category) {
+            ai_request_msg_t prefetch = {};
+            prefetch.timestamp = now;
+            prefetch.prefetch_at = shown->next_change;
+            // Never displaces a request for the screen (queue of one); while
+            // the worker is behind, wait for the next pass instead
+            if (!queue_watch_busy(QUEUE_WATCH_AI_REQ) && queue_watch_send(QUEUE_WATCH_AI_REQ, &prefetch) == pdTRUE) {
+                prefetched_at = shown->next_change;
+            }
+        }
+        
+        if (!have_params && now < next_change) {
+            continue;
+        }
+        
+        job_watch_begin(TASK_ID_LOGIC, "mood_eval", JOB_RUN_MOOD_MS);
+        for (uint8_t t = 0; t < TANK_MAX; t++) {
+            tank_mood_t *tm = &tank_moods[t];
+            mood_engine_state_t *engine = &tm->engine;
+            bool fresh = have_params && ((msg.dirty & (1 << t)) || !engine->valid);
+            if (!fresh && !(engine->valid && now >= engine->next_change)) {
+                continue;
+            }
+            const aquarium_params_t *params = fresh ? &msg.tank[t] : NULL;
             
-            uint32_t now = get_current_time_seconds();
+            // Rescore only the factors whose inputs changed (or whose time
+            // band expired); scores match calculate_mood_scores() exactly
+            bool changed = mood_engine_update(engine, params, now);
+            mood_result_t result = engine->result;
+            result.tank = t;
+            result.origin_us = fresh ? params->origin_us : 0;
+            if (t == active) {
+                mood_engine_set_latest(&engine->params, &result, now);  // Reason text is built lazily
+                latest_tank = t;
+            }
+            BLOGD(TAG, "Tank %d mood rescored mask 0x%02x, changed=%d, next change in %ld s",
+                  t, engine->rescored, changed,
+                  engine->next_change == MOOD_ENGINE_NEVER ? -1L : (long)(engine->next_change - now));
             
-            // Call pure function (DO NOT MODIFY - same logic as Step 1)
-            result = calculate_mood_scores(params, now);
+            // New water test of the first tank -> trend window, then re-forecast
+            if (t == 0) {
+                if (fresh && (mood_trend.count == 0 || water_changed(params, &trend_last) ||
+                              now - trend_last_time >= MOOD_TREND_RESAMPLE_S)) {
+                    mood_trend_add(&mood_trend, params, now);
+                    trend_last = *params;
+                    trend_last_time = now;
+                    if (mood_drift_update(&mood_drift, &mood_trend)) {
+                        ESP_LOGW(TAG, "Parameter drift mask 0x%02x (z %.1f %.1f %.1f %.1f)", mood_drift.mask,
+                                 mood_drift.z[0], mood_drift.z[1], mood_drift.z[2], mood_drift.z[3]);
+                    }
+                }
+                mood_forecast_t forecast = mood_trend_forecast(&mood_trend, &engine->params, now);
+                mood_drift_apply(&mood_drift, &forecast);
+                mood_trend_set_latest(&forecast);
+                if (!have_forecast || forecast_moved(&forecast, &last_forecast)) {
+                    have_forecast = true;
+                    last_forecast = forecast;
+                    msg_bus_publish(MSG_TOPIC_MOOD_FORECAST, &forecast, sizeof(forecast));
+                }
+            }
             
-            // Send result back to LVGL task
-            xQueueSend(queue_mood_result, &result, 0);
+            if (!changed) {
+                continue;
+            }
+            
+            // Publish to every mood subscriber (the dashboard wakes via its notify)
+            msg_bus_publish(MSG_TOPIC_MOOD_RESULT, &result, sizeof(result));
+            if (result.category != tm->last_category) {
+                blackbox_record(BLACKBOX_MOOD, TASK_ID_LOGIC, NULL, tm->last_category, result.category);
+                tm->last_category = result.category;
+            }
+            
+            // Speculatively warm frame 0 of the moods we are drifting towards
+            // (nothing to warm when frames are mapped straight from flash)
+            // A warm-up storage is too busy for stays unmarked and is tried
+            // again with the next mood change
+            uint8_t drift = mood_drift_targets(&result);
+            if (drift != tm->last_drift && !frame_map_available()) {
+                uint8_t deferred = 0;
+                for (uint8_t cat = 0; cat < 3; cat++) {
+                    if ((drift & (1 << cat)) && !(tm->last_drift & (1 << cat))) {
+                        anim_frame_request_msg_t prefetch = { .frame_index = (uint8_t)(cat * 8) };
+                        if (queue_watch_busy(QUEUE_WATCH_PREFETCH) ||
+                            queue_watch_send(QUEUE_WATCH_PREFETCH, &prefetch) != pdTRUE) {
+                            deferred |= (uint8_t)(1 << cat);
+                            continue;
+                        }
+                        ESP_LOGI(TAG, "Tank %d drifting towards category %d (total=%d) - prefetching",
+                                 t, cat, result.total_score);
+                    }
+                }
+                tm->last_drift = (uint8_t)(drift & ~deferred);
+            }
         }
+        
+        // Another tank came on screen: the lazy reason follows it at once
+        const mood_engine_state_t *on_screen = &tank_moods[active].engine;
+        if (latest_tank != active && on_screen->valid) {
+            mood_result_t result = on_screen->result;
+            result.tank = active;
+            mood_engine_set_latest(&on_screen->params, &result, now);
+            latest_tank = active;
+        }
+        job_watch_end(TASK_ID_LOGIC);
     }
+    
+    worker_exit(TASK_ID_LOGIC);
+}
+
+/**
+ * Fill one frame buffer, from the PSRAM cache if possible
+ * 
+ * Cache hits are a PSRAM-to-PSRAM copy with no flash I/O. The dirty rects
+ * stored with the cached frame still describe what changed relative to its
+ * base, so partial invalidation keeps working on cached loops.
+ * 
+ * Only rows [*row_from, *row_to) are needed (the part on screen); the rows
+ * filled come back, at least those. Only whole frames go to the cache.
+ * 
+ * Both the buffer and the cache hold raw frames; ref_slot's pixels carry
+ * the baked overlay (anim/frame_overlay.h), undone where a delta on it
+ * left them.
+ */
+static bool fill_frame_buffer(uint8_t frame_index, uint8_t *buffer, uint8_t had,
+                              const uint8_t *ref_buffer, uint8_t ref_frame, uint8_t ref_slot,
+                              uint16_t *row_from, uint16_t *row_to, frame_dirty_t *dirty)
+{
+    const uint8_t *cached = frame_cache_get(frame_index, dirty);
+    if (cached != NULL) {
+        if (had != frame_index) {
+            size_t first = (size_t)*row_from * ANIM_FRAME_ROW_BYTES;
+            memcpy(buffer + first, cached + first, (size_t)(*row_to - *row_from) * ANIM_FRAME_ROW_BYTES);
+        }
+        BLOGD(TAG, "[STORAGE] Frame %d served from PSRAM cache", frame_index);
+        return true;
+    }
+    
+    // Ahead of any log write or maintenance slice waiting for the same device
+    io_sched_dev_t dev = frame_backend_device();
+    io_sched_begin(dev, IO_SCHED_FRAME, portMAX_DELAY);
+    bool loaded = load_frame_rows_from_spiffs(frame_index, buffer, had, ref_buffer, ref_frame,
+                                              row_from, row_to, dirty);
+    io_sched_end(dev, IO_SCHED_FRAME);
+    if (!loaded) {
+        return false;
+    }
+    if (ref_buffer != NULL && ref_frame != had && !dirty->full && dirty->base_frame == ref_frame) {
+        frame_overlay_unbake(ref_slot, buffer, dirty);
+    }
+    if (*row_from == 0 && *row_to == ANIM_FRAME_HEIGHT) {
+        frame_cache_put(frame_index, buffer, dirty);
+    }
+    return true;
 }
 
 /**
@@ -152,36 +719,175 @@ static void logic_task(void *pvParameters)
  * WHY THIS PATTERN PREVENTS LAG:
  * - All SPIFFS access happens ONLY in this task (Core 1)
  * - LVGL task (Core 0) NEVER waits for I/O - just swaps pointers
- * - No mutex locks needed - volatile flags provide lock-free sync
- * - Frame loading is infrequent (every 10s) so no CPU congestion
+ * - Slots change hands through queues, so no mutex and no torn handoff
+ * - Frame loading is infrequent (every 3s) so no CPU congestion
  * 
  * OPERATION:
  * 1. Wait for frame request from LVGL (blocking queue receive is OK here)
- * 2. Load frame from /spiffs/<mood>/frameX.bin into PSRAM buffer
- * 3. Set frame_ready flag to signal LVGL task
- * 4. NEVER call LVGL APIs (lv_* functions) from this task
+ * 2. Take a free pool slot (blocks until LVGL returns one, never drops)
+ * 3. Load /spiffs/frameN.bin (or the PSRAM cache) into the slot, read
+ *    ahead in chunks by the frame_io reader (codec/frame_io.h)
+ * 4. Post anim_frame_ready_msg_t on queue_anim_frame_ready
+ * 5. NEVER call LVGL APIs (lv_* functions) from this task
  * 
  * BLOCKING I/O IS OK HERE - runs on Core 1, isolated from UI.
  */
+static QueueSetHandle_t storage_set = NULL;
+
+// Rows [from, to) of a pool slot that hold its frame
+typedef struct {
+    uint16_t from;
+    uint16_t to;
+} slot_rows_t;
+
+static bool slot_rows_cover(const slot_rows_t *have, const slot_rows_t *want)
+{
+    return have->to != 0 && have->from <= want->from && have->to >= want->to;
+}
+
+/**
+ * @brief Take over a downloaded asset pack (asset_ota.h) at a mood change
+ *
+ * Nothing of the old pack survives: cached frames go, pool contents no
+ * longer count as delta bases, and the timeline is read from the new
+ * headers. LVGL drops frames of the old mood on its own.
+ */
+static void switch_asset_pack(uint8_t *slot_frame)
+{
+    if (!asset_bundle_switch_staged()) {
+        return;
+    }
+    frame_cache_clear();
+    for (uint8_t i = 0; i < FRAME_POOL_SLOTS; i++) {
+        slot_frame[i] = 0xFF;
+    }
+    const frame_backend_t *bundle = frame_backend_get(FRAME_BACKEND_BUNDLE);
+    if (frame_backend_active_id() != FRAME_BACKEND_BUNDLE && bundle->probe()) {
+        frame_backend_set_active(FRAME_BACKEND_BUNDLE);
+    }
+    anim_timeline_scan();
+    ESP_LOGI(TAG, "[STORAGE] Asset pack switched - frames now from %s", frame_backend_active()->name);
+}
+
+// Read-ahead, two-core decode and JPEG for frame_codec (codec/frame_*.h)
+static const frame_codec_accel_t frame_accel = {
+    frame_io_ready, frame_io_stream,
+    frame_split_ready, frame_split_begin, frame_split_feed, frame_split_finish,
+    frame_jpeg_load,
+};
+
 static void storage_task(void *pvParameters)
 {
-    ESP_LOGI(TAG, "[STORAGE] ★ Storage task started on Core %d (SPIFFS handler)", xPortGetCoreID());
+    static bool backend_selected = false;
+    BLOGI(TAG, "[STORAGE] Storage task started on core %d", xPortGetCoreID());
+    
+    frame_cache_init(ANIM_FRAME_BYTES);
+    
+    // Pool slots freed by a previous stop come back before the first request
+    uint8_t restored = frame_pool_restore();
+    if (restored > 0) {
+        ESP_LOGI(TAG, "[STORAGE] Re-allocated %d frame pool slot(s)", restored);
+    }
+    
+    // Read-ahead: chunk N+1 is read while chunk N is decoded into the slot
+    frame_codec_set_accel(&frame_accel);
+    const task_layout_t *io = task_layout_get(TASK_ID_FRAME_IO);
+    TaskHandle_t io_handle = NULL;
+    frame_io_start(io->core, io->prio, io->stack, &io_handle);
+    task_monitor_register(TASK_ID_FRAME_IO, io_handle);
+#if CONFIG_GOLDIE_FRAME_SPLIT_DECODE
+    // Compressed frames: every other band is decoded by the job pool
+    frame_split_start();
+#endif
+    
+    // Pick the fastest medium holding frames (SPIFFS / SD card / raw partition);
+    // the choice holds across restarts
+    uint8_t *bench_buf = backend_selected ? NULL :
+                         (uint8_t *)heap_caps_malloc(ANIM_FRAME_BYTES, MALLOC_CAP_SPIRAM);
+    if (bench_buf != NULL) {
+        frame_backend_select(load_frame_from_spiffs, bench_buf);
+#if CONFIG_GOLDIE_FRAME_BENCHMARK
+        frame_bench_storage(load_frame_from_spiffs, load_frame_patch_from_spiffs, bench_buf, 480, 320);
+        pixel_kernels_bench(bench_buf, ANIM_FRAME_BYTES);
+#endif
+        heap_caps_free(bench_buf);
+        backend_selected = true;
+    } else if (!backend_selected) {
+        ESP_LOGW(TAG, "[STORAGE] No PSRAM for backend benchmark - staying on SPIFFS");
+    }
+    
+    // Per-frame holds and loop points from the frame headers (once)
+    if (!anim_timeline_ready()) {
+        anim_timeline_scan();
+    }
     
     anim_frame_request_msg_t request;
+    frame_cache_stats_t cache_stats;
     uint32_t frame_count = 0;
+    metric_t *m_frames = metrics_counter("goldie_frames_requested_total", NULL, "Animation frame requests taken by storage");
+    
+    // What each pool slot actually holds (0xFF = unknown) and in which rows
+    // (to = 0: none yet). Only this task writes pixels, so it can track
+    // content even for slots LVGL owns.
+    uint8_t slot_frame[FRAME_POOL_SLOTS];
+    slot_rows_t slot_rows[FRAME_POOL_SLOTS];
+    for (uint8_t i = 0; i < FRAME_POOL_SLOTS; i++) {
+        slot_frame[i] = 0xFF;
+        slot_rows[i].from = 0;
+        slot_rows[i].to = 0;
+    }
+    uint8_t last_category = 0xFF;
     
-    while (1) {
+    while (!worker_should_stop(TASK_ID_STORAGE)) {
         // ═══════════════════════════════════════════════════════════════════
         // STEP 1: Wait for frame request (blocking is OK - this is Core 1)
         // ═══════════════════════════════════════════════════════════════════
-        if (xQueueReceive(queue_anim_frame_request, &request, portMAX_DELAY) == pdTRUE) {
+        // storage_set (display requests + prefetches) outlives this task
+        QueueSetMemberHandle_t ready = xQueueSelectFromSet(storage_set, pdMS_TO_TICKS(WORKER_STOP_POLL_MS));
+        if (ready == NULL) {
+            continue;
+        }
+        
+        if (ready == queue_anim_prefetch) {
+            anim_frame_request_msg_t prefetch;
+            if (xQueueReceive(queue_anim_prefetch, &prefetch, 0) != pdTRUE || prefetch.frame_index >= 24) {
+                continue;
+            }
+            // Decode straight into a speculative cache slot; NULL = already resident
+            uint8_t *slot = frame_cache_prefetch_slot(prefetch.frame_index);
+            if (slot != NULL) {
+                job_watch_begin(TASK_ID_STORAGE, "prefetch", JOB_RUN_PREFETCH_MS);
+                // Speculative: after log writes, and not right before the next frame load
+                io_sched_dev_t dev = frame_backend_device();
+                io_sched_begin(dev, IO_SCHED_BACKGROUND, portMAX_DELAY);
+                bool ok = load_frame_from_spiffs(prefetch.frame_index, slot);
+                io_sched_end(dev, IO_SCHED_BACKGROUND);
+                frame_cache_commit_prefetch(prefetch.frame_index, ok);
+                job_watch_end(TASK_ID_STORAGE);
+                ESP_LOGI(TAG, "[STORAGE] Prefetch frame %d %s", prefetch.frame_index, ok ? "cached" : "FAILED");
+                taskYIELD();
+            }
+            continue;
+        }
+        
+        if (xQueueReceive(queue_anim_frame_request, &request, 0) == pdTRUE) {
             
             uint8_t frame_index = request.frame_index;
             uint8_t category = frame_index / 8;
+            EVT_TRACE_INSTANT("frame_take", frame_index);
             uint8_t frame_in_cat = frame_index % 8;
             
-            ESP_LOGI(TAG, "[STORAGE] Frame request #%lu: abs_frame=%d (cat=%d frame=%d)",
-                     ++frame_count, frame_index, category, frame_in_cat);
+            frame_count++;
+            metrics_inc(m_frames, 1);
+            BLOGD(TAG, "[STORAGE] Frame request #%lu: abs_frame=%d (cat=%d frame=%d)",
+                  frame_count, frame_index, category, frame_in_cat);
+            
+            if (frame_count % 24 == 0) {
+                frame_cache_stats_t cs;
+                frame_cache_get_stats(&cs);
+                ESP_LOGI(TAG, "[STORAGE] Cache: %lu hits / %lu misses, %d/%d slots, %lu evictions",
+                         cs.hits, cs.misses, cs.slots_allocated, cs.slots_max, cs.evictions);
+            }
             
             // Validate frame index (0-7 per emotion, 3 emotions = 0-23)
             if (frame_index >= 24) {
@@ -189,78 +895,389 @@ static void storage_task(void *pvParameters)
                 continue;
             }
             
+            // A staged asset pack takes over between moods, never mid-loop
+            if (category != last_category) {
+                switch_asset_pack(slot_frame);
+                last_category = category;
+            }
+            
             // ═══════════════════════════════════════════════════════════════
-            // STEP 2: Choose buffer (double-buffering for safe pointer swap)
+            // STEP 2: Take a free pool slot (waits for LVGL instead of dropping)
             // ═══════════════════════════════════════════════════════════════
-            // Prefer buffer_a if both free, otherwise use whichever is available
-            if (!buffer_a_ready) {
-                ESP_LOGI(TAG, "[STORAGE] Loading frame %d into buffer_a...", frame_index);
-                
-                // BLOCKING SPIFFS READ - This is WHY we isolate from LVGL
-                if (load_frame_from_spiffs(frame_index, frame_buffer_a)) {
-                    buffer_a_frame_index = frame_index;
-                    buffer_a_ready = true;  // Signal to LVGL: frame ready
-                    ESP_LOGI(TAG, "[STORAGE] ✓ Frame %d → buffer_a READY", frame_index);
-                } else {
-                    ESP_LOGE(TAG, "[STORAGE] ✗ Failed to load frame %d (SPIFFS error)", frame_index);
+            uint8_t slot = FRAME_POOL_NO_SLOT;
+            uint32_t waited_s = 0;
+            while (xQueueReceive(queue_anim_frame_free, &slot, pdMS_TO_TICKS(WORKER_STOP_POLL_MS)) != pdTRUE) {
+                if (worker_should_stop(TASK_ID_STORAGE)) {
+                    break;
                 }
-                
-                // Yield after file I/O to prevent watchdog triggers
-                taskYIELD();
-                
-            } else if (!buffer_b_ready) {
-                ESP_LOGI(TAG, "[STORAGE] Loading frame %d into buffer_b...", frame_index);
-                
-                // BLOCKING SPIFFS READ
-                if (load_frame_from_spiffs(frame_index, frame_buffer_b)) {
-                    buffer_b_frame_index = frame_index;
-                    buffer_b_ready = true;  // Signal to LVGL: frame ready
-                    ESP_LOGI(TAG, "[STORAGE] ✓ Frame %d → buffer_b READY", frame_index);
-                } else {
-                    ESP_LOGE(TAG, "[STORAGE] ✗ Failed to load frame %d (SPIFFS error)", frame_index);
+                if (++waited_s % 5 == 0) {
+                    ESP_LOGW(TAG, "[STORAGE] No free frame slot for %lus (frame %d waiting)",
+                             (unsigned long)waited_s, frame_index);
                 }
+            }
+            if (slot == FRAME_POOL_NO_SLOT) {
+                // Stopping: answer the request so LVGL's read-ahead count stays right
+                anim_frame_ready_msg_t fail_msg = { .frame_index = frame_index, .buffer_slot = FRAME_POOL_NO_SLOT };
+                queue_watch_send(QUEUE_WATCH_FRAME_READY, &fail_msg);
+                break;
+            }
+            frame_pool_slot_t *target = frame_pool_slot(slot);
+            
+            // The wait for a free slot is LVGL back-pressure; the job is the load
+            job_watch_begin(TASK_ID_STORAGE, "frame_load", JOB_RUN_FRAME_MS);
+            
+            // Only the rows on screen - except into a slot that never held a
+            // frame, so rows scrolled into view later show an older frame
+            // instead of noise
+            slot_rows_t rows = { 0, ANIM_FRAME_HEIGHT };
+            if (request.row_to != 0 && request.row_from < request.row_to &&
+                request.row_to <= ANIM_FRAME_HEIGHT && slot_rows[slot].to != 0) {
+                rows.from = request.row_from;
+                rows.to = request.row_to;
+            }
+            
+            // Delta frames patch on top of whichever slot holds the previous
+            // frame in those rows
+            uint8_t prev_frame = (frame_in_cat == 0) ? 0xFF : (uint8_t)(frame_index - 1);
+            const uint8_t *ref_buffer = NULL;
+            uint8_t ref_slot = FRAME_POOL_NO_SLOT;
+            for (uint8_t i = 0; i < FRAME_POOL_SLOTS && prev_frame != 0xFF; i++) {
+                if (i != slot && slot_frame[i] == prev_frame && slot_rows_cover(&slot_rows[i], &rows)) {
+                    ref_buffer = frame_pool_slot(i)->pixels;
+                    ref_slot = i;
+                    break;
+                }
+            }
+            
+            BLOGD(TAG, "[STORAGE] Loading frame %d into slot %d", frame_index, slot);
+            
+            // BLOCKING SPIFFS READ - This is WHY we isolate from LVGL
+            uint8_t had = slot_rows_cover(&slot_rows[slot], &rows) ? slot_frame[slot] : 0xFF;
+            slot_frame[slot] = 0xFF;
+            slot_rows[slot].to = 0;
+            frame_overlay_restore(slot, target->pixels);
+            if (fill_frame_buffer(frame_index, target->pixels, had, ref_buffer,
+                                  ref_buffer ? prev_frame : 0xFF, ref_slot, &rows.from, &rows.to,
+                                  &target->dirty)) {
+                slot_frame[slot] = frame_index;
+                slot_rows[slot] = rows;
+                // The date goes into the frame here, not on top of it in LVGL
+                frame_overlay_bake(slot, target->pixels, &target->dirty);
                 
-                // Yield after file I/O
-                taskYIELD();
-                
+                // ═══════════════════════════════════════════════════════════
+                // STEP 3: Publish - the queue orders the pixel writes before
+                // the slot id becomes visible on the LVGL core
+                // ═══════════════════════════════════════════════════════════
+                anim_frame_ready_msg_t ready_msg = { .frame_index = frame_index, .buffer_slot = slot,
+                                                     .row_from = rows.from, .row_to = rows.to };
+                queue_watch_send(QUEUE_WATCH_FRAME_READY, &ready_msg);  // Pool-deep, never full
+                EVT_TRACE_INSTANT("frame_ready", frame_index);
+                BLOGD(TAG, "[STORAGE] Frame %d -> slot %d ready", frame_index, slot);
             } else {
-                // Both buffers occupied - LVGL hasn't consumed previous frame yet
-                // This should be RARE with 10-second frame intervals
-                ESP_LOGW(TAG, "[STORAGE] Both buffers busy, dropping frame %d request", frame_index);
-                vTaskDelay(pdMS_TO_TICKS(10));
+                ESP_LOGE(TAG, "[STORAGE] ✗ Failed to load frame %d (SPIFFS error)", frame_index);
+                frame_pool_release(slot);
+                // Still answer the request so LVGL's read-ahead count stays right
+                anim_frame_ready_msg_t fail_msg = { .frame_index = frame_index, .buffer_slot = FRAME_POOL_NO_SLOT };
+                queue_watch_send(QUEUE_WATCH_FRAME_READY, &fail_msg);
             }
+            job_watch_end(TASK_ID_STORAGE);
             
-            // ═══════════════════════════════════════════════════════════════
-            // NO QUEUE NOTIFICATION - LVGL polls buffer_ready flags directly
-            // This is faster than queue messaging for simple flag checks
-            // ═══════════════════════════════════════════════════════════════
+            // Yield after file I/O to prevent watchdog triggers
+            taskYIELD();
         }
     }
+    
+    // Idle shutdown: hand the PSRAM back. Slots LVGL holds (on screen or
+    // ready) keep their pixels; the free ones are re-allocated on restart
+    frame_cache_get_stats(&cache_stats);
+    frame_cache_clear();
+    task_monitor_unregister(TASK_ID_FRAME_IO);
+    frame_io_stop();
+#if CONFIG_GOLDIE_FRAME_SPLIT_DECODE
+    frame_split_stop();
+#endif
+    uint8_t trimmed = frame_pool_trim();
+    ESP_LOGI(TAG, "[STORAGE] Released %d cached frame(s) and %d pool slot(s) (PSRAM free %zu KB)",
+             cache_stats.slots_allocated, trimmed, heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024);
+    worker_exit(TASK_ID_STORAGE);
 }
 
 /**
- * WiFi Task - STEP 4 + STEP 5 (AI Cloud Query + Blynk Sync)
+ * Network workers - STEP 4 + STEP 5 (AI Cloud Query + Blynk Sync)
  * 
- * Handles network I/O: AI API queries, Blynk sync.
- * Blocking network operations are OK here - runs on Core 1.
+ * Two independent tasks so a slow LLM call (up to 10 s HTTP timeout) never
+ * delays the ~700 ms Blynk push and vice versa. Each job carries a
+ * deadline: a job that waited longer than that is dropped, not run late.
+ * Blocking network operations are OK here - both run on Core 1.
  * 
  * STABILIZATION FIX: Check WiFi/Blynk status before network calls.
  */
-static void wifi_task(void *pvParameters)
+#define AI_JOB_DEADLINE_S         120   // AI request older than this is answered offline
+// Blynk snapshot older than this goes to the backlog (it may wait a radio window)
+#define TELEMETRY_JOB_DEADLINE_S  (60 + CONFIG_GOLDIE_NET_WINDOW_S)
+#define BACKFILL_INTERVAL_S       2     // Between two backlog batches after a reconnect
+#define BACKFILL_RETRY_S          60    // After a failed batch
+#define HTTP_STATS_EVERY          300   // Telemetry passes between pool stats (~5 min)
+
+/**
+ * Streamed AI reply: publish a copy of the text so far. The buffer the
+ * reply is still being written into is never shared, and a partial is
+ * simply skipped when the text pool is empty.
+ */
+static bool ai_chat_turn = false;       // The AI worker is answering a chat turn
+
+static void ai_partial_publish(const char *text, void *arg)
 {
-    ESP_LOGI(TAG, "WiFi task started (AI + Blynk sync - waiting for network)");
+    ai_result_msg_t partial;
+    partial.success = true;
+    partial.partial = true;
+    partial.chat = ai_chat_turn;
+    partial.advice = text_buf_from_str(text);
+    partial.summary = NULL;
+    if (partial.advice) {
+        msg_bus_publish(MSG_TOPIC_AI_RESULT, &partial, sizeof(partial));
+    }
+}
+
+/**
+ * AI Worker - STEP 4 (AI Cloud Query)
+ * 
+ * Sleeps on queue_ai_request; one request at a time (latest wins).
+ *
+ * A prefetch (prefetch_at != 0) is held until a radio window is open and
+ * then run into the advice cache only - nothing is published. It is
+ * dropped once its moment has passed or a request for the screen comes.
+ *
+ * A chat request (chat_seq != 0) answers that "Ask Goldie" turn: the
+ * answer and the model's memo of the conversation go into ai_chat.h and
+ * the result is published with chat set.
+ */
+static void ai_worker_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "AI worker started (waiting for requests)");
     
     ai_request_msg_t ai_request;
     ai_result_msg_t ai_result;
-    blynk_sync_msg_t blynk_sync;
+    ai_result.partial = false;
+    ai_result.chat = false;
+    ai_result.summary = NULL;
+    static char chat_memo[AI_CHAT_MEMO_MAX];    // AI worker only
+    gemini_set_partial_cb(ai_partial_publish, NULL);
+    uint32_t prefetch_at = 0;           // Held prefetch, 0 = none
+    
+    while (!worker_should_stop(TASK_ID_AI)) {
+        bool have_request = xQueueReceive(queue_ai_request, &ai_request,
+                                          pdMS_TO_TICKS(WORKER_STOP_POLL_MS)) == pdTRUE;
+        if (have_request && ai_request.prefetch_at != 0) {
+            prefetch_at = ai_request.prefetch_at;
+            have_request = false;
+        } else if (have_request) {
+            prefetch_at = 0;
+        }
+        if (prefetch_at != 0 && time_svc_uptime_s() >= prefetch_at) {
+            prefetch_at = 0;                 // Too late: the screen asks for itself now
+        }
+        if (prefetch_at != 0 && !power_gov_ai_prefetch()) {
+            prefetch_at = 0;                 // Saver profile since it was queued
+        }
+        if (!have_request) {
+            // Speculative, so only in a window the radio is up for anyway
+            if (prefetch_at != 0 && net_sched_window_open() && gemini_is_wifi_connected()) {
+                char *scratch = NULL;
+                size_t scratch_size = 0;
+                char summary[AI_SUMMARY_MAX];
+                text_buf_t *buf = text_buf_alloc(&scratch, &scratch_size);
+                if (buf) {
+                    job_watch_begin(TASK_ID_AI, "ai_prefetch", JOB_RUN_GROQ_MS);
+                    gemini_prefetch_aquarium(prefetch_at, scratch, scratch_size, summary, sizeof(summary));
+                    job_watch_end(TASK_ID_AI);
+                    text_buf_unref(buf);
+                }
+                prefetch_at = 0;
+            }
+            continue;
+        }
+        ai_result.chat = ai_request.chat_seq != 0;
+        
+        // Deadline: the dashboard has moved on from a request this old
+        uint32_t age = time_svc_uptime_s() - ai_request.timestamp;
+        if (age > AI_JOB_DEADLINE_S) {
+            ESP_LOGW(TAG, "AI request expired (%lus old) - answering offline", (unsigned long)age);
+            ai_result.success = false;
+            ai_result.advice = NULL;
+            msg_bus_publish(MSG_TOPIC_AI_RESULT, &ai_result, sizeof(ai_result));
+            continue;
+        }
+        if (!CONFIG_GOLDIE_AI) {
+            ai_result.success = false;       // No AI client built in: the offline advice
+            ai_result.advice = NULL;
+            msg_bus_publish(MSG_TOPIC_AI_RESULT, &ai_result, sizeof(ai_result));
+            continue;
+        }
+        
+        // STABILIZATION FIX: Check if WiFi is ready (use same check as dashboard)
+        if (!gemini_is_wifi_connected()) {
+            ESP_LOGW(TAG, "AI request received but WiFi not ready - sending offline response");
+            ai_result.success = false;
+            ai_result.advice = text_buf_from_str(
+                    "AI Assistant offline\\n\\nWiFi not connected.\\nCheck network settings.");
+            msg_bus_publish(MSG_TOPIC_AI_RESULT, &ai_result, sizeof(ai_result));
+            continue;
+        }
+        
+        // The reply is written once into a pooled text buffer; the bus
+        // message and the dashboard only pass the handle around
+        char *advice = NULL;
+        size_t advice_size = 0;
+        char summary[AI_SUMMARY_MAX];   // Same completion, short line for Blynk
+        ai_result.advice = text_buf_alloc(&advice, &advice_size);
+        if (!ai_result.advice) {
+            ESP_LOGW(TAG, "AI request dropped - no free text buffer");
+            ai_result.success = false;
+            msg_bus_publish(MSG_TOPIC_AI_RESULT, &ai_result, sizeof(ai_result));
+            continue;
+        }
+        
+        ESP_LOGI(TAG, "AI request received - querying cloud API");
+        
+        // Call AI API (blocking network call - OK on Core 1). Interactive:
+        // opens a radio window now instead of waiting for the next one
+        net_sched_interactive_begin();
+        job_watch_begin(TASK_ID_AI, "groq_query", JOB_RUN_GROQ_MS);
+        if (ai_result.chat) {
+            ai_chat_turn = true;
+            ai_result.success = gemini_chat(ai_request.chat_seq, advice, advice_size,
+                                            chat_memo, sizeof(chat_memo));
+            ai_chat_turn = false;
+            if (ai_result.success) {
+                ai_chat_add(AI_CHAT_GOLDIE, advice);
+                if (chat_memo[0] != '\0') {
+                    ai_chat_set_memo(chat_memo);
+                }
+            }
+            summary[0] = '\0';
+        } else {
+            ai_result.success = gemini_query_aquarium(
+                ai_request.ammonia_ppm,
+                ai_request.nitrite_ppm,
+                ai_request.nitrate_ppm,
+                ai_request.hours_since_feed,
+                ai_request.days_since_clean,
+                ai_request.feeds_per_day,
+                ai_request.water_change_interval,
+                advice,
+                advice_size,
+                summary,
+                sizeof(summary)
+            );
+        }
+        int call_ms = (int)job_watch_end(TASK_ID_AI);
+        net_sched_interactive_end();
+        
+        if (ai_result.success) {
+            ESP_LOGI(TAG, "AI query successful in %d ms - sending result", call_ms);
+            // NULL when the model gave no summary (or the pool is empty):
+            // the advice goes to Blynk instead
+            ai_result.summary = summary[0] != '\0' ? text_buf_from_str(summary) : NULL;
+        } else {
+            ESP_LOGW(TAG, "AI query failed after %d ms - sending error result", call_ms);
+        }
+        
+        // Send result back to LVGL task (latest-only subscription)
+        msg_bus_publish(MSG_TOPIC_AI_RESULT, &ai_result, sizeof(ai_result));
+        ai_result.summary = NULL;
+    }
+    
+    worker_exit(TASK_ID_AI);
+}
+
+/**
+ * Telemetry Worker - STEP 5 (Blynk Sync)
+ * 
+ * Pushes dashboard snapshots to Blynk and watches the WiFi link (status
+ * log, UI_MSG_WIFI_STATE on change). Wakes at least once a second.
+ * 
+ * Cloud pushes only run inside a radio window (net_sched.h); in between,
+ * stats, forecasts and snapshots wait in their latest-only subscriptions,
+ * reminders (every one of them) in theirs.
+ * A snapshot that cannot reach the cloud anyway goes to the backlog at
+ * once, window or not.
+ * 
+ * Its subscriptions are made once in task_coordinator_init() so a restart
+ * (even a forced one) picks up the same queues.
+ */
+static msg_bus_sub_t *blynk_sub = NULL;
+static msg_bus_sub_t *stats_sub = NULL;
+static msg_bus_sub_t *forecast_sub = NULL;
+static msg_bus_sub_t *reminder_sub = NULL;
+static msg_bus_sub_t *alert_sub = NULL;      // Mood results, for the critical alerts
+
+// Backlog values in telemetry_backlog_push() order, as blynk_send_all_data() sends them
+static const struct {
+    int pin;
+    int decimals;
+} backfill_pins[TELEMETRY_BACKLOG_VALUES] = {
+    { BLYNK_PIN_TEMPERATURE, 1 },
+    { BLYNK_PIN_OXYGEN, 1 },
+    { BLYNK_PIN_PH, 2 },
+    { BLYNK_PIN_FEEDING, 1 },
+    { BLYNK_PIN_CLEANING, 1 },
+};
+
+/**
+ * Offline backlog: upload one batch of the oldest kept snapshots as
+ * timestamped writes (one call per pin). Paced by the caller, so the
+ * reconnect burst stays a trickle next to the live syncs.
+ */
+static bool telemetry_backfill(void)
+{
+    static telemetry_point_t points[TELEMETRY_BACKLOG_BATCH];
+    static uint32_t times[TELEMETRY_BACKLOG_BATCH];
+    static float values[TELEMETRY_BACKLOG_BATCH];
+    
+    size_t n = telemetry_backlog_peek(points, TELEMETRY_BACKLOG_BATCH);
+    if (n == 0) {
+        return true;    // Nothing with a wall time yet
+    }
+    job_watch_begin(TASK_ID_TELEMETRY, "blynk_backfill", JOB_RUN_BACKFILL_MS);
+    bool ok = true;
+    for (int v = 0; v < TELEMETRY_BACKLOG_VALUES && ok; v++) {
+        for (size_t i = 0; i < n; i++) {
+            times[i] = points[i].time;
+            values[i] = points[i].value[v];
+        }
+        ok = blynk_send_history(backfill_pins[v].pin, times, values, n, backfill_pins[v].decimals);
+    }
+    job_watch_end(TASK_ID_TELEMETRY);
+    if (ok) {
+        telemetry_backlog_mark_sent();
+        ESP_LOGI(TAG, "Backfilled %u offline snapshot(s), %u waiting", (unsigned)n,
+                 (unsigned)telemetry_backlog_pending());
+    }
+    return ok;
+}
+
+static void telemetry_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "Telemetry worker started (Blynk sync - waiting for network)");
     
     // Diagnostic: Log WiFi status periodically
     uint32_t status_counter = 0;
+    uint32_t http_stats_counter = 0;
+    uint32_t next_backfill_s = 0;
+#if CONFIG_GOLDIE_HISTORY_SYNC
+    uint32_t next_history_sync_s = 0;
+    history_sync_init();
+#endif
+#if CONFIG_GOLDIE_MOOD_ALERTS
+    uint32_t next_alert_s = 0;
+    mood_alerts_init();
+#endif
     
-    while (1) {
+    while (!worker_should_stop(TASK_ID_TELEMETRY)) {
         // Diagnostic: Every 2 seconds, log WiFi status (increased frequency to combat animation log flood)
         // Use actual wifi_connected status from gemini_api, not wifi_initialized
-        extern bool gemini_is_wifi_connected(void);
+        // (Re)connects reach the dashboard from bg_wifi_init (NET_EVENT_CHANGED)
         bool actually_connected = gemini_is_wifi_connected();
         
         if (++status_counter >= 2) {
@@ -270,161 +1287,376 @@ static void wifi_task(void *pvParameters)
                      blynk_initialized ? "ACTIVE" : "INACTIVE",
                      actually_connected ? "READY" : "UNAVAILABLE");
         }
+        if (++http_stats_counter >= HTTP_STATS_EVERY) {
+            http_stats_counter = 0;
+            http_pool_log_stats();
+#if CONFIG_GOLDIE_DNS_CACHE
+            dns_cache_log_stats();
+#endif
+#if CONFIG_GOLDIE_HISTORY_SYNC
+            history_sync_log_stats();
+#endif
+#if CONFIG_GOLDIE_MOOD_ALERTS
+            mood_alerts_log_stats();
+#endif
+        }
         
-        // Priority 1: Wait for AI request (blocking with timeout)
-        if (xQueueReceive(queue_ai_request, &ai_request, pdMS_TO_TICKS(1000)) == pdTRUE) {
-            
-            // STABILIZATION FIX: Check if WiFi is ready (use same check as dashboard)
-            if (!gemini_is_wifi_connected()) {
-                ESP_LOGW(TAG, "AI request received but WiFi not ready - sending offline response");
-                ai_result.success = false;
-                snprintf(ai_result.advice, sizeof(ai_result.advice), 
-                        "AI Assistant offline\\n\\nWiFi not connected.\\nCheck network settings.");
-                xQueueOverwrite(queue_ai_result, &ai_result);
-                continue;
+        net_sched_poll();
+        bool window = net_sched_window_open();
+        bool online = blynk_initialized && actually_connected;
+#if CONFIG_GOLDIE_DNS_CACHE
+        // Cloud hosts re-resolved before their TTL runs out
+        if (window && actually_connected) {
+            dns_cache_refresh();
+        }
+#endif
+        
+#if CONFIG_GOLDIE_MOOD_ALERTS
+        // Critical alerts go out at once, window or not (one short push each)
+        const msg_bus_msg_t *mood_msg;
+        while (alert_sub != NULL && (mood_msg = msg_bus_receive(alert_sub, 0)) != NULL) {
+            mood_alerts_update(MSG_BUS_PAYLOAD(mood_msg, mood_result_t));
+            msg_bus_release(mood_msg);
+        }
+        mood_alert_event_t alert;
+        while (online && time_svc_uptime_s() >= next_alert_s && mood_alerts_next(&alert, (uint32_t)time(NULL))) {
+            char line[80];
+            mood_alerts_format(&alert, line, sizeof(line));
+            net_sched_interactive_begin();
+            job_watch_begin(TASK_ID_TELEMETRY, "blynk_alert", JOB_RUN_BLYNK_ALERT_MS);
+            bool sent = blynk_log_event(mood_alerts_code(&alert), line);
+            job_watch_end(TASK_ID_TELEMETRY);
+            net_sched_interactive_end();
+            if (!sent) {
+                next_alert_s = time_svc_uptime_s() + BACKFILL_RETRY_S;
+                break;
             }
-            
-            ESP_LOGI(TAG, "AI request received - querying cloud API");
-            
-            // Call AI API (blocking network call - OK on Core 1)
-            ai_result.success = gemini_query_aquarium(
-                ai_request.ammonia_ppm,
-                ai_request.nitrite_ppm,
-                ai_request.nitrate_ppm,
-                ai_request.hours_since_feed,
-                ai_request.days_since_clean,
-                ai_request.feeds_per_day,
-                ai_request.water_change_interval,
-                ai_result.advice,
-                sizeof(ai_result.advice)
-            );
-            
-            if (ai_result.success) {
-                ESP_LOGI(TAG, "AI query successful - sending result");
-            } else {
-                ESP_LOGW(TAG, "AI query failed - sending error result");
+            mood_alerts_ack(&alert, (uint32_t)time(NULL));
+        }
+#endif
+        
+        // Task monitor sample (non-blocking, one short push)
+        const msg_bus_msg_t *stats_msg = window ? msg_bus_receive(stats_sub, 0) : NULL;
+        if (stats_msg) {
+            if (blynk_initialized) {
+                job_watch_begin(TASK_ID_TELEMETRY, "blynk_stats", JOB_RUN_BLYNK_STATS_MS);
+                blynk_update_task_stats(text_buf_str(MSG_BUS_PAYLOAD(stats_msg, task_stats_msg_t)->summary));
+                job_watch_end(TASK_ID_TELEMETRY);
+                net_sched_touch();
             }
-            
-            // Send result back to LVGL task (non-blocking with overwrite)
-            xQueueOverwrite(queue_ai_result, &ai_result);
+            msg_bus_release(stats_msg);
         }
         
-        // Priority 2: Check for Blynk sync request (non-blocking)
-        if (xQueueReceive(queue_blynk_sync, &blynk_sync, 0) == pdTRUE) {
-            
-            // STABILIZATION FIX: Check if Blynk is ready
-            if (!blynk_initialized) {
-                ESP_LOGW(TAG, "Blynk sync requested but Blynk not initialized - skipping");
-                continue;
+        // Mood forecast (non-blocking, one short push): early warning pin
+        const msg_bus_msg_t *forecast_msg = window ? msg_bus_receive(forecast_sub, 0) : NULL;
+        if (forecast_msg) {
+            if (blynk_initialized) {
+                char warning[160];
+                if (mood_trend_format_forecast(MSG_BUS_PAYLOAD(forecast_msg, mood_forecast_t),
+                                               warning, sizeof(warning)) == 0) {
+                    snprintf(warning, sizeof(warning), "No mood drop expected");
+                }
+                job_watch_begin(TASK_ID_TELEMETRY, "blynk_forecast", JOB_RUN_BLYNK_FORECAST_MS);
+                blynk_update_forecast(warning);
+                job_watch_end(TASK_ID_TELEMETRY);
+                net_sched_touch();
             }
-            
+            msg_bus_release(forecast_msg);
+        }
+        
+        // Reminders that came due (non-blocking, one short push each)
+        const msg_bus_msg_t *reminder_msg;
+        while (window && (reminder_msg = msg_bus_receive(reminder_sub, 0)) != NULL) {
+            if (blynk_initialized) {
+                char line[80];
+                reminders_format(MSG_BUS_PAYLOAD(reminder_msg, reminder_event_t), line, sizeof(line));
+                job_watch_begin(TASK_ID_TELEMETRY, "blynk_reminder", JOB_RUN_BLYNK_REMINDER_MS);
+                blynk_update_reminder(line);
+                job_watch_end(TASK_ID_TELEMETRY);
+                net_sched_touch();
+            }
+            msg_bus_release(reminder_msg);
+        }
+        
+        // Offline backlog drains in paced batches once the cloud is back
+        if (window && online && telemetry_backlog_pending() > 0 &&
+            time_svc_uptime_s() >= next_backfill_s) {
+            next_backfill_s = time_svc_uptime_s() +
+                              (telemetry_backfill() ? BACKFILL_INTERVAL_S : BACKFILL_RETRY_S);
+            net_sched_touch();
+        }
+        
+#if CONFIG_GOLDIE_HISTORY_SYNC
+        // Recorded series to the backend: a few chunks per pass while
+        // there is a backlog, then a look every interval
+        if (window && actually_connected && time_svc_uptime_s() >= next_history_sync_s) {
+            job_watch_begin(TASK_ID_TELEMETRY, "history_sync", JOB_RUN_HISTORY_SYNC_MS);
+            history_sync_result_t r = history_sync_step();
+            job_watch_end(TASK_ID_TELEMETRY);
+            next_history_sync_s = time_svc_uptime_s() +
+                                  (r == HISTORY_SYNC_MORE ? 0 :
+                                   r == HISTORY_SYNC_IDLE ? HISTORY_SYNC_INTERVAL_S : HISTORY_SYNC_RETRY_S);
+            if (r != HISTORY_SYNC_IDLE) {
+                net_sched_touch();
+            }
+        }
+#endif
+        
+        // Wait for a Blynk sync request (blocking with timeout); online
+        // outside a window the snapshot is left for the next one
+        if (!window && online) {
+            vTaskDelay(pdMS_TO_TICKS(WORKER_STOP_POLL_MS));
+            continue;
+        }
+        const msg_bus_msg_t *blynk_msg = msg_bus_receive(blynk_sub, pdMS_TO_TICKS(WORKER_STOP_POLL_MS));
+        if (!blynk_msg) {
+            continue;
+        }
+        if (!CONFIG_GOLDIE_BLYNK) {
+            msg_bus_release(blynk_msg);     // No cloud to keep a backlog for
+            continue;
+        }
+        const blynk_sync_msg_t &blynk_sync = *MSG_BUS_PAYLOAD(blynk_msg, blynk_sync_msg_t);
+        
+        // STABILIZATION FIX: Check if Blynk is ready. Snapshots that cannot
+        // go out now are kept for the backfill instead of being lost
+        uint32_t age = time_svc_uptime_s() - blynk_sync.timestamp;
+        const float backlog_values[TELEMETRY_BACKLOG_VALUES] = {
+            blynk_sync.ammonia_ppm, blynk_sync.nitrite_ppm, blynk_sync.nitrate_ppm,
+            blynk_sync.feed_hours, blynk_sync.clean_days,
+        };
+        if (!online) {
+            ESP_LOGW(TAG, "Blynk sync requested but cloud unreachable - kept (%u waiting)",
+                     (unsigned)telemetry_backlog_pending() + 1);
+            telemetry_backlog_push(blynk_sync.timestamp, backlog_values);
+        } else if (age > TELEMETRY_JOB_DEADLINE_S) {
+            ESP_LOGW(TAG, "Blynk snapshot expired (%lus old) - kept for backfill", (unsigned long)age);
+            telemetry_backlog_push(blynk_sync.timestamp, backlog_values);
+        } else {
             ESP_LOGI(TAG, "Blynk sync received - sending to cloud (Mood=%s)", blynk_sync.mood);
             
             // Call Blynk API (blocking network call - OK on Core 1)
-            // ~700ms total (7 HTTP calls × 100ms delay)
-            blynk_send_all_data(
+            // One batched request with the changed pins, kept-alive connection
+            job_watch_begin(TASK_ID_TELEMETRY, "blynk_push", JOB_RUN_BLYNK_MS);
+            bool sent = blynk_send_all_data(
                 blynk_sync.ammonia_ppm,
                 blynk_sync.nitrite_ppm,
                 blynk_sync.nitrate_ppm,
                 blynk_sync.feed_hours,
                 blynk_sync.clean_days,
                 blynk_sync.mood,
-                blynk_sync.ai_advice
+                text_buf_str(blynk_sync.ai_advice)
             );
+            job_watch_end(TASK_ID_TELEMETRY);
             
-            ESP_LOGI(TAG, "Blynk sync complete");
+            net_sched_touch();
+            if (sent) {
+                ESP_LOGI(TAG, "Blynk sync complete");
+            } else {
+                telemetry_backlog_push(blynk_sync.timestamp, backlog_values);
+                next_backfill_s = time_svc_uptime_s() + BACKFILL_RETRY_S;
+            }
         }
-        
-        // Yield to prevent starvation
-        taskYIELD();
+        msg_bus_release(blynk_msg);
+    }
+    
+    worker_exit(TASK_ID_TELEMETRY);
+}
+
+/**
+ * SD Logger Worker - CSV log rows queued by the dashboard (sd_logger.h)
+ * 
+ * Sleeps until a batch is full or the oldest row is due; on stop it writes
+ * whatever is queued and closes its files, so nothing is left unsynced.
+ */
+static void sd_logger_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "SD logger started (batch %d rows / %d ms)", SD_LOGGER_BATCH, SD_LOGGER_FLUSH_MS);
+    sd_logger_attach(xTaskGetCurrentTaskHandle());
+    
+    while (!worker_should_stop(TASK_ID_SDLOG)) {
+        sd_logger_run(WORKER_STOP_POLL_MS);
     }
+    
+    sd_logger_attach(NULL);
+    sd_logger_close();
+    worker_exit(TASK_ID_SDLOG);
+}
+
+/**
+ * Message bus release hooks: drop the text reference a message owns
+ */
+static void ai_result_release(const void *payload)
+{
+    text_buf_unref(((const ai_result_msg_t *)payload)->advice);
+    text_buf_unref(((const ai_result_msg_t *)payload)->summary);
+}
+
+static void blynk_sync_release(const void *payload)
+{
+    text_buf_unref(((const blynk_sync_msg_t *)payload)->ai_advice);
+}
+
+/**
+ * Input recorder codec for AI results: flags, then both texts with their
+ * terminators (the handles mean nothing after a reboot)
+ */
+static void ai_result_encode(msg_topic_t topic, const void *payload)
+{
+    const ai_result_msg_t *r = (const ai_result_msg_t *)payload;
+    const uint8_t flags = (r->success ? 0x01 : 0) | (r->partial ? 0x02 : 0) | (r->chat ? 0x04 : 0);
+    const char *advice = text_buf_str(r->advice);
+    const char *summary = text_buf_str(r->summary);
+    const input_rec_part_t parts[] = {
+        {&flags, 1}, {advice, strlen(advice) + 1}, {summary, strlen(summary) + 1},
+    };
+    input_rec_put_parts(INPUT_REC_BUS, (uint8_t)topic, parts, 3);
+}
+
+static size_t ai_result_decode(const uint8_t *data, size_t len, void *payload)
+{
+    if (len < 3 || data[len - 1] != '\0') {
+        return 0;
+    }
+    const char *advice = (const char *)data + 1;
+    size_t advice_len = strnlen(advice, len - 1);
+    if (advice_len + 3 > len) {
+        return 0;
+    }
+    const char *summary = advice + advice_len + 1;
+    ai_result_msg_t *r = (ai_result_msg_t *)payload;
+    memset(r, 0, sizeof(*r));
+    r->success = (data[0] & 0x01) != 0;
+    r->partial = (data[0] & 0x02) != 0;
+    r->chat = (data[0] & 0x04) != 0;
+    r->advice = advice[0] ? text_buf_from_str(advice) : NULL;
+    r->summary = summary[0] ? text_buf_from_str(summary) : NULL;
+    return sizeof(*r);
+}
+
+/**
+ * Reminder sink: each reminder that comes due goes out on the bus
+ */
+static void reminder_publish(const reminder_event_t *ev)
+{
+    msg_bus_publish(MSG_TOPIC_REMINDER, ev, sizeof(*ev));
 }
 
 void task_coordinator_init(void)
 {
-    ESP_LOGI(TAG, "Initializing task coordinator (Step 4 - wifi_task AI active)");
+    ESP_LOGI(TAG, "Initializing task coordinator (Step 4 - AI + telemetry workers)");
     
     // Create queues with correct sizes (updated for Step 4)
-    queue_param_update = xQueueCreate(2, sizeof(aquarium_params_t));
-    queue_mood_result = xQueueCreate(2, sizeof(mood_result_t));
-    queue_anim_frame_request = xQueueCreate(1, sizeof(anim_frame_request_msg_t));
-    queue_anim_frame_ready = xQueueCreate(1, sizeof(anim_frame_ready_msg_t));
+    queue_param_update = xQueueCreate(1, sizeof(tank_params_msg_t));  // Mailbox (queue_watch_overwrite)
+    queue_anim_frame_request = xQueueCreate(FRAME_POOL_SLOTS, sizeof(anim_frame_request_msg_t));
+    queue_anim_frame_ready = xQueueCreate(FRAME_POOL_SLOTS, sizeof(anim_frame_ready_msg_t));
+    queue_anim_frame_free = xQueueCreate(FRAME_POOL_SLOTS, sizeof(uint8_t));
+    queue_anim_prefetch = xQueueCreate(2, sizeof(anim_frame_request_msg_t));
     queue_ai_request = xQueueCreate(1, sizeof(ai_request_msg_t));
-    queue_ai_result = xQueueCreate(1, sizeof(ai_result_msg_t));
-    queue_blynk_sync = xQueueCreate(1, sizeof(blynk_sync_msg_t));
     
-    if (!queue_param_update || !queue_mood_result || !queue_anim_frame_request ||
-        !queue_anim_frame_ready || !queue_ai_request || !queue_ai_result || 
-        !queue_blynk_sync) {
+    if (!queue_param_update || !queue_anim_frame_request ||
+        !queue_anim_frame_ready || !queue_anim_frame_free || !queue_anim_prefetch || !queue_ai_request) {
         ESP_LOGE(TAG, "Failed to create queues");
         return;
     }
+    queue_watch_register(QUEUE_WATCH_PARAM, "param", queue_param_update, 1);
+    queue_watch_register(QUEUE_WATCH_FRAME_REQ, "frame_req", queue_anim_frame_request, FRAME_POOL_SLOTS);
+    queue_watch_register(QUEUE_WATCH_FRAME_READY, "frame_ready", queue_anim_frame_ready, FRAME_POOL_SLOTS);
+    queue_watch_register(QUEUE_WATCH_PREFETCH, "prefetch", queue_anim_prefetch, 2);
+    queue_watch_register(QUEUE_WATCH_AI_REQ, "ai_req", queue_ai_request, 1);
     
-    ESP_LOGI(TAG, "Queues created (7 total)");
+    // Results (mood, AI, Blynk snapshots) fan out through the message bus;
+    // their advice text lives in pooled text buffers
+    if (msg_bus_init() != ESP_OK || text_buf_init() != ESP_OK) {
+        return;
+    }
+#if CONFIG_GOLDIE_AI
+    ai_chat_init();              // Ask Goldie is off without its ring
+#endif
+    msg_bus_set_release_hook(MSG_TOPIC_AI_RESULT, ai_result_release);
+    msg_bus_set_release_hook(MSG_TOPIC_BLYNK_SYNC, blynk_sync_release);
+    msg_bus_set_rec_codec(MSG_TOPIC_AI_RESULT, ai_result_encode, ai_result_decode);
+    job_watch_init();
+    evt_trace_init();
+    bin_log_init();              // BLOGx records go to USB Serial/JTAG from here on
+    telemetry_backlog_init();    // Storage partition is mounted by now
+    net_sched_init();
+    reminders_init(reminder_publish);  // Publishes on MSG_TOPIC_REMINDER once armed
     
-    // Create tasks (pinned to Core 1)
-    BaseType_t ret;
+    // Latest-only: a snapshot that waits behind a Blynk push is replaced
+    blynk_sub = msg_bus_subscribe("telemetry", MSG_TOPIC_BLYNK_SYNC, 1, MSG_SUB_LATEST, NULL, NULL);
+    stats_sub = msg_bus_subscribe("telemetry", MSG_TOPIC_TASK_STATS, 1, MSG_SUB_LATEST, NULL, NULL);
+    forecast_sub = msg_bus_subscribe("telemetry", MSG_TOPIC_MOOD_FORECAST, 1, MSG_SUB_LATEST, NULL, NULL);
+    reminder_sub = msg_bus_subscribe("telemetry", MSG_TOPIC_REMINDER, 4, 0, NULL, NULL);
+#if CONFIG_GOLDIE_MOOD_ALERTS
+    // Latest per tank is enough: alerts follow the scored state, not each result
+    alert_sub = msg_bus_subscribe("telemetry", MSG_TOPIC_MOOD_RESULT, TANK_MAX, MSG_SUB_LATEST, NULL, NULL);
+    if (alert_sub == NULL) {
+        ESP_LOGW(TAG, "No mood subscription for the alerts - alerts off");
+    }
+#endif
     
-    ret = xTaskCreatePinnedToCore(
-        logic_task,
-        "logic_task",
-        4096,           // Stack size
-        NULL,           // Parameters
-        5,              // Priority (medium)
-        &logic_task_handle,
-        1               // Core 1 (APP_CPU)
-    );
-    if (ret != pdPASS) {
-        ESP_LOGE(TAG, "Failed to create logic task");
+    // Storage waits on display requests and speculative prefetches together
+    storage_set = xQueueCreateSet(FRAME_POOL_SLOTS + 2);
+    lifecycle_lock = xSemaphoreCreateMutex();
+    if (!blynk_sub || !stats_sub || !forecast_sub || !reminder_sub || !storage_set || !lifecycle_lock) {
+        ESP_LOGE(TAG, "Failed to create worker subscriptions / queue set / lifecycle lock");
         return;
     }
+    xQueueAddToSet(queue_anim_frame_request, storage_set);
+    xQueueAddToSet(queue_anim_prefetch, storage_set);
     
-    ret = xTaskCreatePinnedToCore(
-        storage_task,
-        "storage_task",
-        8192,           // Larger stack (will handle file I/O)
-        NULL,
-        4,              // Priority (lower than logic)
-        &storage_task_handle,
-        1               // Core 1
-    );
-    if (ret != pdPASS) {
-        ESP_LOGE(TAG, "Failed to create storage task");
-        return;
+    ESP_LOGI(TAG, "Queues created (6 total) + message bus");
+    
+    // Create tasks from the layout table (Kconfig defaults + NVS overrides;
+    // all on Core 1 by default, keeping Core 0 for LVGL). Storage has the
+    // larger stack (file I/O); telemetry outranks the long AI call so a
+    // Groq request in flight never delays a Blynk push
+    task_layout_load();
+    
+    // CPU-bound background jobs on both cores' idle time (before storage,
+    // which feeds it frame bands)
+    TaskHandle_t job_handles[2] = {};
+    if (job_pool_start(job_handles)) {
+        task_monitor_register(TASK_ID_JOBS_0, job_handles[0]);
+        task_monitor_register(TASK_ID_JOBS_1, job_handles[1]);
     }
     
-    ret = xTaskCreatePinnedToCore(
-        wifi_task,
-        "wifi_task",
-        8192,           // Larger stack (will handle network I/O)
-        NULL,
-        3,              // Priority (lowest - network can wait)
-        &wifi_task_handle,
-        1               // Core 1
-    );
-    if (ret != pdPASS) {
-        ESP_LOGE(TAG, "Failed to create wifi task");
-        return;
+    workers[TASK_ID_LOGIC].fn = logic_task;
+    workers[TASK_ID_STORAGE].fn = storage_task;
+    workers[TASK_ID_TELEMETRY].fn = telemetry_task;
+    workers[TASK_ID_AI].fn = ai_worker_task;
+    workers[TASK_ID_SDLOG].fn = sd_logger_task;
+    
+    const task_id_t managed[] = { TASK_ID_LOGIC, TASK_ID_STORAGE, TASK_ID_TELEMETRY, TASK_ID_AI, TASK_ID_SDLOG };
+    for (size_t i = 0; i < sizeof(managed) / sizeof(managed[0]); i++) {
+        workers[managed[i]].exited = xSemaphoreCreateBinary();
+        xSemaphoreTake(lifecycle_lock, portMAX_DELAY);
+        esp_err_t err = workers[managed[i]].exited ? worker_spawn(managed[i]) : ESP_ERR_NO_MEM;
+        xSemaphoreGive(lifecycle_lock);
+        if (err != ESP_OK) {
+            return;
+        }
     }
     
-    // STABILIZATION FIX: Create background WiFi init task
-    // This task initializes WiFi asynchronously without blocking app_main
-    ret = xTaskCreatePinnedToCore(
-        background_wifi_init_task,
-        "bg_wifi_init",
-        8192,           // Larger stack (WiFi + Blynk init)
-        NULL,
-        2,              // Priority (low - runs in background)
-        &bg_wifi_init_handle,
-        1               // Core 1 (keep network off Core 0)
-    );
-    if (ret != pdPASS) {
-        ESP_LOGW(TAG, "Failed to create background WiFi init task - system will stay offline");
+    // STABILIZATION FIX: WiFi starts asynchronously without blocking
+    // app_main, as a coroutine on the shared executor task (the power
+    // monitor joins it later)
+    if (!co_exec_start() || !co_exec_spawn(background_wifi_init())) {
+        ESP_LOGW(TAG, "No coroutine executor for WiFi init - system will stay offline");
         // Don't return - system can run without WiFi
     } else {
-        ESP_LOGI(TAG, "Background WiFi init task created - network will start asynchronously");
+        ESP_LOGI(TAG, "Background WiFi init spawned - network will start asynchronously");
     }
     
-    ESP_LOGI(TAG, "Tasks created: logic (mood calc), storage (frame load), wifi (AI cloud)");
+    // LVGL task (created by lv_port_init before us) + stack/CPU sampling
+    task_monitor_register(TASK_ID_LVGL, xTaskGetHandle(task_layout_get(TASK_ID_LVGL)->name));
+    task_monitor_start();
+    
+#if CONFIG_GOLDIE_SPSC_BENCHMARK
+    spsc_ring_benchmark();
+#endif
+    
+    ESP_LOGI(TAG, "Tasks created: logic (mood calc), storage (frame load), telemetry (Blynk), ai_worker (AI cloud), sd_logger (CSV logs)");
     ESP_LOGI(TAG, "Task coordinator init complete - System starting in OFFLINE mode");
 }
@@ -4,6 +4,9 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "esp_err.h"
+#include "msg_bus.h"
+#include "task_layout.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,17 +29,61 @@ extern "C" {
  */
 void task_coordinator_init(void);
 
+/**
+ * Worker lifecycle - logic, storage, telemetry, AI and SD logger workers
+ * 
+ * Stopping is cooperative: the worker notices the request at its next
+ * wait (at most ~1 s), releases what it owns (storage frees the PSRAM
+ * frame cache and its idle pool slots) and deletes itself. Work already
+ * queued for it stays queued and is served after a restart.
+ * 
+ * LVGL, WiFi init and the task monitor are not managed here
+ * (ESP_ERR_NOT_SUPPORTED).
+ */
+
+/**
+ * @brief Start a stopped worker (no-op if it is running)
+ * 
+ * A worker still shutting down is started again as soon as it has exited.
+ */
+esp_err_t task_coordinator_start(task_id_t id);
+
+/**
+ * @brief Ask a worker to stop
+ * 
+ * @param timeout_ms 0 = request only (safe from the LVGL task); otherwise
+ *                   wait up to this long for the worker to exit
+ * @return ESP_OK, ESP_ERR_TIMEOUT if the worker did not exit in time
+ */
+esp_err_t task_coordinator_stop(task_id_t id, uint32_t timeout_ms);
+
+/**
+ * @brief Stop and start a worker, e.g. to recover one that is wedged
+ * 
+ * A worker that ignores the stop request for timeout_ms is deleted
+ * forcibly; anything it held at that moment (HTTP client, a pool slot,
+ * a bus message) is leaked, which is still better than a reboot.
+ */
+esp_err_t task_coordinator_restart(task_id_t id, uint32_t timeout_ms);
+
+/**
+ * @brief true if the worker exists and has not been asked to stop
+ */
+bool task_coordinator_is_running(task_id_t id);
+
 /**
  * Placeholder queues (minimal - will be expanded in later steps)
  * Currently unused - tasks are idle stubs.
  */
-extern QueueHandle_t queue_param_update;
-extern QueueHandle_t queue_mood_result;
+extern QueueHandle_t queue_param_update;        // tank_params_msg_t mailbox, 1 deep (LVGL -> logic)
 extern QueueHandle_t queue_anim_frame_request;
-extern QueueHandle_t queue_anim_frame_ready;
+extern QueueHandle_t queue_anim_frame_ready;   // anim_frame_ready_msg_t (storage -> LVGL)
+extern QueueHandle_t queue_anim_frame_free;    // uint8_t pool slot ids (LVGL -> storage)
+extern QueueHandle_t queue_anim_prefetch;      // Speculative frame loads (logic -> storage)
 extern QueueHandle_t queue_ai_request;
-extern QueueHandle_t queue_ai_result;
-extern QueueHandle_t queue_blynk_sync;
+
+// Mood/AI results and Blynk snapshots are published on the message bus
+// (msg_bus.h): MSG_TOPIC_MOOD_RESULT, MSG_TOPIC_AI_RESULT, MSG_TOPIC_BLYNK_SYNC
 
 #ifdef __cplusplus
 }
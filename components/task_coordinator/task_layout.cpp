@@ -0,0 +1,358 @@
+#include "task_layout.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include <stdio.h>
+
+static const char *TAG = "task_layout";
+
+#define TASK_LAYOUT_NVS_NS  "task_layout"
+#define TASK_MIN_STACK      2048
+
+// Kconfig defaults (kept in sync with main/Kconfig.projbuild)
+#ifndef CONFIG_GOLDIE_TASK_LVGL_CORE
+#define CONFIG_GOLDIE_TASK_LVGL_CORE 0
+#endif
+#ifndef CONFIG_GOLDIE_TASK_LVGL_PRIO
+#define CONFIG_GOLDIE_TASK_LVGL_PRIO 2
+#endif
+#ifndef CONFIG_GOLDIE_TASK_LVGL_STACK
+#define CONFIG_GOLDIE_TASK_LVGL_STACK 0
+#endif
+#ifndef CONFIG_GOLDIE_TASK_LOGIC_CORE
+#define CONFIG_GOLDIE_TASK_LOGIC_CORE 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_LOGIC_PRIO
+#define CONFIG_GOLDIE_TASK_LOGIC_PRIO 5
+#endif
+#ifndef CONFIG_GOLDIE_TASK_LOGIC_STACK
+#define CONFIG_GOLDIE_TASK_LOGIC_STACK 4096
+#endif
+#ifndef CONFIG_GOLDIE_TASK_STORAGE_CORE
+#define CONFIG_GOLDIE_TASK_STORAGE_CORE 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_STORAGE_PRIO
+#define CONFIG_GOLDIE_TASK_STORAGE_PRIO 4
+#endif
+#ifndef CONFIG_GOLDIE_TASK_STORAGE_STACK
+#define CONFIG_GOLDIE_TASK_STORAGE_STACK 8192
+#endif
+#ifndef CONFIG_GOLDIE_TASK_FRAME_IO_CORE
+#define CONFIG_GOLDIE_TASK_FRAME_IO_CORE 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_FRAME_IO_PRIO
+#define CONFIG_GOLDIE_TASK_FRAME_IO_PRIO 5
+#endif
+#ifndef CONFIG_GOLDIE_TASK_FRAME_IO_STACK
+#define CONFIG_GOLDIE_TASK_FRAME_IO_STACK 3072
+#endif
+#ifndef CONFIG_GOLDIE_TASK_JOBS0_CORE
+#define CONFIG_GOLDIE_TASK_JOBS0_CORE 0
+#endif
+#ifndef CONFIG_GOLDIE_TASK_JOBS0_PRIO
+#define CONFIG_GOLDIE_TASK_JOBS0_PRIO 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_JOBS0_STACK
+#define CONFIG_GOLDIE_TASK_JOBS0_STACK 4096
+#endif
+#ifndef CONFIG_GOLDIE_TASK_JOBS1_CORE
+#define CONFIG_GOLDIE_TASK_JOBS1_CORE 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_JOBS1_PRIO
+#define CONFIG_GOLDIE_TASK_JOBS1_PRIO 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_JOBS1_STACK
+#define CONFIG_GOLDIE_TASK_JOBS1_STACK 4096
+#endif
+#ifndef CONFIG_GOLDIE_TASK_TELEMETRY_CORE
+#define CONFIG_GOLDIE_TASK_TELEMETRY_CORE 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_TELEMETRY_PRIO
+#define CONFIG_GOLDIE_TASK_TELEMETRY_PRIO 3
+#endif
+#ifndef CONFIG_GOLDIE_TASK_TELEMETRY_STACK
+#define CONFIG_GOLDIE_TASK_TELEMETRY_STACK 6144
+#endif
+#ifndef CONFIG_GOLDIE_TASK_AI_CORE
+#define CONFIG_GOLDIE_TASK_AI_CORE 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_AI_PRIO
+#define CONFIG_GOLDIE_TASK_AI_PRIO 2
+#endif
+#ifndef CONFIG_GOLDIE_TASK_AI_STACK
+#define CONFIG_GOLDIE_TASK_AI_STACK 8192
+#endif
+#ifndef CONFIG_GOLDIE_TASK_AI_HEDGE_CORE
+#define CONFIG_GOLDIE_TASK_AI_HEDGE_CORE 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_AI_HEDGE_PRIO
+#define CONFIG_GOLDIE_TASK_AI_HEDGE_PRIO 2
+#endif
+#ifndef CONFIG_GOLDIE_TASK_AI_HEDGE_STACK
+#define CONFIG_GOLDIE_TASK_AI_HEDGE_STACK 8192
+#endif
+#ifndef CONFIG_GOLDIE_TASK_SDLOG_CORE
+#define CONFIG_GOLDIE_TASK_SDLOG_CORE 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_SDLOG_PRIO
+#define CONFIG_GOLDIE_TASK_SDLOG_PRIO 2
+#endif
+#ifndef CONFIG_GOLDIE_TASK_SDLOG_STACK
+#define CONFIG_GOLDIE_TASK_SDLOG_STACK 4096
+#endif
+#ifndef CONFIG_GOLDIE_TASK_HTTPD_CORE
+#define CONFIG_GOLDIE_TASK_HTTPD_CORE 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_HTTPD_PRIO
+#define CONFIG_GOLDIE_TASK_HTTPD_PRIO 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_HTTPD_STACK
+#define CONFIG_GOLDIE_TASK_HTTPD_STACK 4096
+#endif
+#ifndef CONFIG_GOLDIE_TASK_CO_EXEC_CORE
+#define CONFIG_GOLDIE_TASK_CO_EXEC_CORE 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_CO_EXEC_PRIO
+#define CONFIG_GOLDIE_TASK_CO_EXEC_PRIO 2
+#endif
+#ifndef CONFIG_GOLDIE_TASK_CO_EXEC_STACK
+#define CONFIG_GOLDIE_TASK_CO_EXEC_STACK 8192
+#endif
+
+#ifndef CONFIG_GOLDIE_TASK_MONITOR_CORE
+#define CONFIG_GOLDIE_TASK_MONITOR_CORE -1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_MONITOR_PRIO
+#define CONFIG_GOLDIE_TASK_MONITOR_PRIO 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_MONITOR_STACK
+#define CONFIG_GOLDIE_TASK_MONITOR_STACK 3072
+#endif
+
+#ifndef CONFIG_GOLDIE_TASK_SENSOR_CORE
+#define CONFIG_GOLDIE_TASK_SENSOR_CORE -1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_SENSOR_PRIO
+#define CONFIG_GOLDIE_TASK_SENSOR_PRIO 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_SENSOR_STACK
+#define CONFIG_GOLDIE_TASK_SENSOR_STACK 4096
+#endif
+
+#ifndef CONFIG_GOLDIE_TASK_IMU_CORE
+#define CONFIG_GOLDIE_TASK_IMU_CORE -1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_IMU_PRIO
+#define CONFIG_GOLDIE_TASK_IMU_PRIO 2
+#endif
+#ifndef CONFIG_GOLDIE_TASK_IMU_STACK
+#define CONFIG_GOLDIE_TASK_IMU_STACK 3072
+#endif
+
+
+#ifndef CONFIG_GOLDIE_TASK_SNAPSHOT_CORE
+#define CONFIG_GOLDIE_TASK_SNAPSHOT_CORE 0
+#endif
+#ifndef CONFIG_GOLDIE_TASK_SNAPSHOT_PRIO
+#define CONFIG_GOLDIE_TASK_SNAPSHOT_PRIO 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_SNAPSHOT_STACK
+#define CONFIG_GOLDIE_TASK_SNAPSHOT_STACK 6144
+#endif
+
+#ifndef CONFIG_GOLDIE_TASK_AUDIO_CORE
+#define CONFIG_GOLDIE_TASK_AUDIO_CORE 0
+#endif
+#ifndef CONFIG_GOLDIE_TASK_AUDIO_PRIO
+#define CONFIG_GOLDIE_TASK_AUDIO_PRIO 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_AUDIO_STACK
+#define CONFIG_GOLDIE_TASK_AUDIO_STACK 4096
+#endif
+
+#ifndef CONFIG_GOLDIE_TASK_ASSET_OTA_CORE
+#define CONFIG_GOLDIE_TASK_ASSET_OTA_CORE 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_ASSET_OTA_PRIO
+#define CONFIG_GOLDIE_TASK_ASSET_OTA_PRIO 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_ASSET_OTA_STACK
+#define CONFIG_GOLDIE_TASK_ASSET_OTA_STACK 6144
+#endif
+
+#ifndef CONFIG_GOLDIE_TASK_FIRMWARE_OTA_CORE
+#define CONFIG_GOLDIE_TASK_FIRMWARE_OTA_CORE 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_FIRMWARE_OTA_PRIO
+#define CONFIG_GOLDIE_TASK_FIRMWARE_OTA_PRIO 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_FIRMWARE_OTA_STACK
+#define CONFIG_GOLDIE_TASK_FIRMWARE_OTA_STACK 8192
+#endif
+
+#ifndef CONFIG_GOLDIE_TASK_BIN_LOG_CORE
+#define CONFIG_GOLDIE_TASK_BIN_LOG_CORE 0
+#endif
+#ifndef CONFIG_GOLDIE_TASK_BIN_LOG_PRIO
+#define CONFIG_GOLDIE_TASK_BIN_LOG_PRIO 1
+#endif
+#ifndef CONFIG_GOLDIE_TASK_BIN_LOG_STACK
+#define CONFIG_GOLDIE_TASK_BIN_LOG_STACK 2560
+#endif
+
+static task_layout_t layout[TASK_ID_COUNT] = {
+    { "taskLVGL",     "lvgl",    CONFIG_GOLDIE_TASK_LVGL_STACK,      CONFIG_GOLDIE_TASK_LVGL_PRIO,      CONFIG_GOLDIE_TASK_LVGL_CORE,      false },
+    { "logic_task",   "logic",   CONFIG_GOLDIE_TASK_LOGIC_STACK,     CONFIG_GOLDIE_TASK_LOGIC_PRIO,     CONFIG_GOLDIE_TASK_LOGIC_CORE,     false },
+    { "storage_task", "storage", CONFIG_GOLDIE_TASK_STORAGE_STACK,   CONFIG_GOLDIE_TASK_STORAGE_PRIO,   CONFIG_GOLDIE_TASK_STORAGE_CORE,   false },
+    { "frame_io",     "frameio", CONFIG_GOLDIE_TASK_FRAME_IO_STACK,  CONFIG_GOLDIE_TASK_FRAME_IO_PRIO,  CONFIG_GOLDIE_TASK_FRAME_IO_CORE,  false },
+    { "jobs_0",       "job0",    CONFIG_GOLDIE_TASK_JOBS0_STACK,     CONFIG_GOLDIE_TASK_JOBS0_PRIO,     CONFIG_GOLDIE_TASK_JOBS0_CORE,     false },
+    { "jobs_1",       "job1",    CONFIG_GOLDIE_TASK_JOBS1_STACK,     CONFIG_GOLDIE_TASK_JOBS1_PRIO,     CONFIG_GOLDIE_TASK_JOBS1_CORE,     false },
+    { "telemetry",    "telem",   CONFIG_GOLDIE_TASK_TELEMETRY_STACK, CONFIG_GOLDIE_TASK_TELEMETRY_PRIO, CONFIG_GOLDIE_TASK_TELEMETRY_CORE, false },
+    { "ai_worker",    "ai",      CONFIG_GOLDIE_TASK_AI_STACK,        CONFIG_GOLDIE_TASK_AI_PRIO,        CONFIG_GOLDIE_TASK_AI_CORE,        false },
+    { "ai_hedge",     "hedge",   CONFIG_GOLDIE_TASK_AI_HEDGE_STACK,  CONFIG_GOLDIE_TASK_AI_HEDGE_PRIO,  CONFIG_GOLDIE_TASK_AI_HEDGE_CORE,  false },
+    { "sd_logger",    "sdlog",   CONFIG_GOLDIE_TASK_SDLOG_STACK,     CONFIG_GOLDIE_TASK_SDLOG_PRIO,     CONFIG_GOLDIE_TASK_SDLOG_CORE,     false },
+    { "httpd",        "httpd",   CONFIG_GOLDIE_TASK_HTTPD_STACK,     CONFIG_GOLDIE_TASK_HTTPD_PRIO,     CONFIG_GOLDIE_TASK_HTTPD_CORE,     false },
+    { "co_exec",      "coexec",  CONFIG_GOLDIE_TASK_CO_EXEC_STACK,   CONFIG_GOLDIE_TASK_CO_EXEC_PRIO,   CONFIG_GOLDIE_TASK_CO_EXEC_CORE,   false },
+    { "task_monitor", "monitor", CONFIG_GOLDIE_TASK_MONITOR_STACK,   CONFIG_GOLDIE_TASK_MONITOR_PRIO,   CONFIG_GOLDIE_TASK_MONITOR_CORE,   false },
+    { "sensor_acq",   "sensor",  CONFIG_GOLDIE_TASK_SENSOR_STACK,    CONFIG_GOLDIE_TASK_SENSOR_PRIO,    CONFIG_GOLDIE_TASK_SENSOR_CORE,    false },
+    { "imu_gesture",  "imu",     CONFIG_GOLDIE_TASK_IMU_STACK,       CONFIG_GOLDIE_TASK_IMU_PRIO,       CONFIG_GOLDIE_TASK_IMU_CORE,       false },
+    { "snapshot",     "snap",    CONFIG_GOLDIE_TASK_SNAPSHOT_STACK,  CONFIG_GOLDIE_TASK_SNAPSHOT_PRIO,  CONFIG_GOLDIE_TASK_SNAPSHOT_CORE,  false },
+    { "audio_alert",  "audio",   CONFIG_GOLDIE_TASK_AUDIO_STACK,     CONFIG_GOLDIE_TASK_AUDIO_PRIO,     CONFIG_GOLDIE_TASK_AUDIO_CORE,     false },
+    { "asset_ota",    "assetota", CONFIG_GOLDIE_TASK_ASSET_OTA_STACK, CONFIG_GOLDIE_TASK_ASSET_OTA_PRIO, CONFIG_GOLDIE_TASK_ASSET_OTA_CORE, false },
+    { "firmware_ota", "fwota",   CONFIG_GOLDIE_TASK_FIRMWARE_OTA_STACK, CONFIG_GOLDIE_TASK_FIRMWARE_OTA_PRIO, CONFIG_GOLDIE_TASK_FIRMWARE_OTA_CORE, false },
+    { "bin_log",      "binlog",  CONFIG_GOLDIE_TASK_BIN_LOG_STACK,   CONFIG_GOLDIE_TASK_BIN_LOG_PRIO,   CONFIG_GOLDIE_TASK_BIN_LOG_CORE,   false },
+};
+static bool loaded = false;
+
+static void load_overrides(nvs_handle_t nvs, task_layout_t *t)
+{
+    char key[16];
+    uint32_t u32;
+    int8_t i8;
+
+    snprintf(key, sizeof(key), "%s_stack", t->key);
+    if (nvs_get_u32(nvs, key, &u32) == ESP_OK && u32 > 0) {
+        t->stack = u32;
+        t->overridden = true;
+    }
+    snprintf(key, sizeof(key), "%s_prio", t->key);
+    if (nvs_get_u32(nvs, key, &u32) == ESP_OK && u32 > 0) {
+        t->prio = (UBaseType_t)u32;
+        t->overridden = true;
+    }
+    snprintf(key, sizeof(key), "%s_core", t->key);
+    if (nvs_get_i8(nvs, key, &i8) == ESP_OK) {
+        t->core = i8;
+        t->overridden = true;
+    }
+}
+
+static void sanitize(task_layout_t *t, bool is_lvgl)
+{
+    if (t->core < -1 || t->core >= portNUM_PROCESSORS) {
+        ESP_LOGW(TAG, "%s: core %d invalid - no affinity", t->name, t->core);
+        t->core = -1;
+    }
+    if (t->prio < 1 || t->prio >= configMAX_PRIORITIES) {
+        UBaseType_t p = t->prio < 1 ? 1 : configMAX_PRIORITIES - 1;
+        ESP_LOGW(TAG, "%s: priority %u out of range - using %u", t->name, (unsigned)t->prio, (unsigned)p);
+        t->prio = p;
+    }
+    if (t->stack < TASK_MIN_STACK && !(is_lvgl && t->stack == 0)) {
+        ESP_LOGW(TAG, "%s: stack %lu too small - using %d", t->name, (unsigned long)t->stack, TASK_MIN_STACK);
+        t->stack = TASK_MIN_STACK;
+    }
+}
+
+void task_layout_load(void)
+{
+    if (loaded) {
+        return;
+    }
+    loaded = true;
+
+    nvs_handle_t nvs;
+    bool have_nvs = (nvs_open(TASK_LAYOUT_NVS_NS, NVS_READONLY, &nvs) == ESP_OK);
+    for (int i = 0; i < TASK_ID_COUNT; i++) {
+        if (have_nvs) {
+            load_overrides(nvs, &layout[i]);
+        }
+        sanitize(&layout[i], i == TASK_ID_LVGL);
+    }
+    if (have_nvs) {
+        nvs_close(nvs);
+    }
+
+    ESP_LOGI(TAG, "Task layout (%d cores):", portNUM_PROCESSORS);
+    ESP_LOGI(TAG, "  %-13s %-5s %-5s %s", "task", "core", "prio", "stack");
+    for (int i = 0; i < TASK_ID_COUNT; i++) {
+        const task_layout_t *t = &layout[i];
+        char core[6], stack[12];
+        if (t->core < 0) {
+            snprintf(core, sizeof(core), "any");
+        } else {
+            snprintf(core, sizeof(core), "%d", t->core);
+        }
+        if (t->stack == 0) {
+            snprintf(stack, sizeof(stack), "default");
+        } else {
+            snprintf(stack, sizeof(stack), "%lu", (unsigned long)t->stack);
+        }
+        ESP_LOGI(TAG, "  %-13s %-5s %-5u %s%s", t->name, core, (unsigned)t->prio, stack,
+                 t->overridden ? "  (NVS)" : "");
+    }
+}
+
+const task_layout_t *task_layout_get(task_id_t id)
+{
+    task_layout_load();
+    return (id < TASK_ID_COUNT) ? &layout[id] : NULL;
+}
+
+BaseType_t task_layout_create(task_id_t id, TaskFunction_t fn, void *arg, TaskHandle_t *handle)
+{
+    const task_layout_t *t = task_layout_get(id);
+    if (!t || id == TASK_ID_LVGL) {
+        return pdFAIL;
+    }
+    return xTaskCreatePinnedToCore(fn, t->name, t->stack, arg, t->prio, handle,
+                                   t->core < 0 ? tskNO_AFFINITY : t->core);
+}
+
+esp_err_t task_layout_set_override(task_id_t id, uint32_t stack, UBaseType_t prio, int core)
+{
+    if (id >= TASK_ID_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(TASK_LAYOUT_NVS_NS, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "nvs_open failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    char key[16];
+    const char *prefix = layout[id].key;
+    snprintf(key, sizeof(key), "%s_stack", prefix);
+    err = stack ? nvs_set_u32(nvs, key, stack) : nvs_erase_key(nvs, key);
+    snprintf(key, sizeof(key), "%s_prio", prefix);
+    esp_err_t e2 = prio ? nvs_set_u32(nvs, key, (uint32_t)prio) : nvs_erase_key(nvs, key);
+    snprintf(key, sizeof(key), "%s_core", prefix);
+    esp_err_t e3 = (core >= -1) ? nvs_set_i8(nvs, key, (int8_t)core) : nvs_erase_key(nvs, key);
+
+    // Clearing a key that was never set is not an error
+    if (err == ESP_ERR_NVS_NOT_FOUND) err = ESP_OK;
+    if (e2 == ESP_ERR_NVS_NOT_FOUND) e2 = ESP_OK;
+    if (e3 == ESP_ERR_NVS_NOT_FOUND) e3 = ESP_OK;
+    if (err == ESP_OK) err = e2;
+    if (err == ESP_OK) err = e3;
+    if (err == ESP_OK) err = nvs_commit(nvs);
+    nvs_close(nvs);
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "%s override saved - applies at next boot", layout[id].name);
+    } else {
+        ESP_LOGE(TAG, "Failed to save %s override: %s", layout[id].name, esp_err_to_name(err));
+    }
+    return err;
+}
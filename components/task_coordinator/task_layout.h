@@ -0,0 +1,89 @@
+#ifndef TASK_LAYOUT_H
+#define TASK_LAYOUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Task Layout - core, priority and stack of every long-lived task
+ * 
+ * Defaults come from menuconfig (Goldie Dashboard Configuration -> Task
+ * layout). Any field can be overridden per device in NVS namespace
+ * "task_layout" (keys "<task>_core", "<task>_prio", "<task>_stack", e.g.
+ * "ai_prio"); overrides apply at the next boot, so a deployment can be
+ * rebalanced without reflashing.
+ * 
+ * Core -1 means no affinity (tskNO_AFFINITY).
+ */
+
+typedef enum {
+    TASK_ID_LVGL = 0,     // esp_lvgl_port task (created by lv_port_init)
+    TASK_ID_LOGIC,
+    TASK_ID_STORAGE,
+    TASK_ID_FRAME_IO,     // Frame read-ahead, owned by storage (codec/frame_io.h)
+    TASK_ID_JOBS_0,       // Job pool worker, core 0 (job_pool.h)
+    TASK_ID_JOBS_1,       // Job pool worker, core 1
+    TASK_ID_TELEMETRY,
+    TASK_ID_AI,
+    TASK_ID_AI_HEDGE,     // Second AI provider request (main/ai_provider.h)
+    TASK_ID_SDLOG,        // CSV log writer (sd_logger.h)
+    TASK_ID_HTTPD,        // esp_http_server task (history_export.h)
+    TASK_ID_CO_EXEC,      // Coroutine executor: network events, power monitor (co_exec.h)
+    TASK_ID_MONITOR,
+    TASK_ID_SENSOR,       // Probe sampling (main/sensor_acq.h)
+    TASK_ID_IMU,          // IMU FIFO drain and gestures (main/imu_gesture.h)
+    TASK_ID_SNAPSHOT,     // Camera snapshots (main/snapshot.h)
+    TASK_ID_AUDIO,        // Alert sounds (main/audio_alert.h)
+    TASK_ID_ASSET_OTA,    // Asset pack download (main/asset_ota.h)
+    TASK_ID_FIRMWARE_OTA, // Firmware update download (main/firmware_ota.h)
+    TASK_ID_BIN_LOG,      // Binary log drain to USB Serial/JTAG (bin_log.h)
+    TASK_ID_COUNT
+} task_id_t;
+
+typedef struct {
+    const char *name;     // FreeRTOS task name
+    const char *key;      // NVS key prefix
+    uint32_t stack;       // Bytes (LVGL: 0 = esp_lvgl_port default)
+    UBaseType_t prio;
+    int core;             // 0/1, or -1 = any core
+    bool overridden;      // At least one field came from NVS
+} task_layout_t;
+
+/**
+ * @brief Build the table from Kconfig + NVS and log it
+ * 
+ * Safe to call more than once (loads on the first call). Needs NVS
+ * initialised for overrides; without it the Kconfig defaults are used.
+ */
+void task_layout_load(void);
+
+/**
+ * @brief Layout of one task (loads the table on first use)
+ */
+const task_layout_t *task_layout_get(task_id_t id);
+
+/**
+ * @brief Create a task with its configured core, priority and stack
+ */
+BaseType_t task_layout_create(task_id_t id, TaskFunction_t fn, void *arg, TaskHandle_t *handle);
+
+/**
+ * @brief Store an override in NVS (applies at the next boot)
+ * 
+ * @param stack / prio  0 = clear that override
+ * @param core          -2 = clear, -1 = any core, 0/1 = pin
+ */
+esp_err_t task_layout_set_override(task_id_t id, uint32_t stack, UBaseType_t prio, int core);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_LAYOUT_H
@@ -0,0 +1,217 @@
+#include "task_monitor.h"
+#include "msg_bus.h"
+#include "messages.h"
+#include "text_buf.h"
+#include "job_watch.h"
+#include "heap_watch.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "task_monitor";
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY && CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+#define MONITOR_HAS_RUNTIME 1
+#define MONITOR_MAX_SYSTEM_TASKS 32
+#else
+#define MONITOR_HAS_RUNTIME 0
+#endif
+
+static TaskHandle_t handles[TASK_ID_COUNT];
+static task_monitor_snapshot_t latest;
+static portMUX_TYPE monitor_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void task_monitor_register(task_id_t id, TaskHandle_t handle)
+{
+    if (id < TASK_ID_COUNT) {
+        portENTER_CRITICAL(&monitor_lock);
+        handles[id] = handle;
+        portEXIT_CRITICAL(&monitor_lock);
+    }
+}
+
+void task_monitor_unregister(task_id_t id)
+{
+    task_monitor_register(id, NULL);
+}
+
+bool task_monitor_get(task_monitor_snapshot_t *out)
+{
+    portENTER_CRITICAL(&monitor_lock);
+    *out = latest;
+    portEXIT_CRITICAL(&monitor_lock);
+    return out->samples > 0;
+}
+
+#if MONITOR_HAS_RUNTIME
+typedef configRUN_TIME_COUNTER_TYPE runtime_t;
+
+typedef struct {
+    TaskHandle_t handle;
+    runtime_t counter;
+} runtime_prev_t;
+
+static TaskStatus_t system_state[MONITOR_MAX_SYSTEM_TASKS];
+static runtime_prev_t prev[MONITOR_MAX_SYSTEM_TASKS];
+static uint32_t prev_count = 0;
+static runtime_t prev_total = 0;
+
+static runtime_t prev_counter(TaskHandle_t h)
+{
+    for (uint32_t i = 0; i < prev_count; i++) {
+        if (prev[i].handle == h) return prev[i].counter;
+    }
+    return 0;
+}
+
+/**
+ * Fill cpu_pct / core_busy_pct from the run time counters. The total is
+ * wall time, so each share is of one core (IDLEn gives core n's load).
+ */
+static void sample_runtime(task_monitor_snapshot_t *snap)
+{
+    runtime_t total = 0;
+    UBaseType_t n = uxTaskGetSystemState(system_state, MONITOR_MAX_SYSTEM_TASKS, &total);
+    runtime_t elapsed = total - prev_total;
+    bool first = (prev_total == 0);
+
+    for (int c = 0; c < 2; c++) snap->core_busy_pct[c] = -1;
+    for (UBaseType_t i = 0; i < n && !first && elapsed; i++) {
+        const TaskStatus_t *ts = &system_state[i];
+        uint32_t share = (uint32_t)((uint64_t)(ts->ulRunTimeCounter - prev_counter(ts->xHandle)) * 100 / elapsed);
+        if (share > 100) share = 100;
+        if (strncmp(ts->pcTaskName, "IDLE", 4) == 0) {
+            int core = ts->pcTaskName[4] - '0';
+            if (core >= 0 && core < 2) snap->core_busy_pct[core] = (int8_t)(100 - share);
+        }
+        for (int id = 0; id < TASK_ID_COUNT; id++) {
+            if (snap->tasks[id].alive && handles[id] == ts->xHandle) {
+                snap->tasks[id].cpu_pct = (int8_t)share;
+            }
+        }
+    }
+
+    prev_count = n;
+    for (UBaseType_t i = 0; i < n; i++) {
+        prev[i].handle = system_state[i].xHandle;
+        prev[i].counter = system_state[i].ulRunTimeCounter;
+    }
+    prev_total = total;
+}
+#endif
+
+static void stats_release(const void *payload)
+{
+    text_buf_unref(((const task_stats_msg_t *)payload)->summary);
+}
+
+static void publish(const task_monitor_snapshot_t *snap)
+{
+    char *text;
+    size_t cap;
+    task_stats_msg_t msg = {};
+    msg.summary = text_buf_alloc(&text, &cap);
+    if (!msg.summary) {
+        return;
+    }
+
+    // Compact line for the Blynk label: "<task> <stack used>% ..." + core load
+    size_t len = 0;
+    for (int id = 0; id < TASK_ID_COUNT && len < cap; id++) {
+        const task_monitor_entry_t *t = &snap->tasks[id];
+        if (!t->alive) continue;
+        if (t->stack_used_pct > msg.worst_stack_pct) {
+            msg.worst_stack_pct = t->stack_used_pct;
+        }
+        len += snprintf(text + len, cap - len, "%s%s %u%%", len ? " " : "",
+                        t->name, (unsigned)t->stack_used_pct);
+    }
+    for (int c = 0; c < 2 && len < cap; c++) {
+        if (snap->core_busy_pct[c] >= 0) {
+            len += snprintf(text + len, cap - len, " | C%d %d%%", c, snap->core_busy_pct[c]);
+        }
+    }
+    msg_bus_publish(MSG_TOPIC_TASK_STATS, &msg, sizeof(msg));
+}
+
+static void task_monitor_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "Task monitor started (every %d s, CPU stats %s)", CONFIG_GOLDIE_TASK_MONITOR_PERIOD_S,
+             MONITOR_HAS_RUNTIME ? "on" : "off - enable FREERTOS_GENERATE_RUN_TIME_STATS");
+    msg_bus_set_release_hook(MSG_TOPIC_TASK_STATS, stats_release);
+
+    task_monitor_snapshot_t snap = {};
+    while (1) {
+        for (int id = 0; id < TASK_ID_COUNT; id++) {
+            task_monitor_entry_t *t = &snap.tasks[id];
+            const task_layout_t *l = task_layout_get((task_id_t)id);
+            portENTER_CRITICAL(&monitor_lock);
+            TaskHandle_t h = handles[id];
+            portEXIT_CRITICAL(&monitor_lock);
+
+            t->name = l->name;
+            t->alive = (h != NULL);
+            t->cpu_pct = -1;
+            if (!t->alive) continue;
+
+            // ESP-IDF reports the high-water mark in bytes
+            t->stack_free_min = uxTaskGetStackHighWaterMark(h);
+            t->stack_size = l->stack;
+            t->stack_used_pct = (t->stack_size > t->stack_free_min)
+                ? (uint8_t)((t->stack_size - t->stack_free_min) * 100 / t->stack_size) : 0;
+        }
+#if MONITOR_HAS_RUNTIME
+        sample_runtime(&snap);
+#else
+        snap.core_busy_pct[0] = snap.core_busy_pct[1] = -1;
+#endif
+        snap.samples++;
+
+        ESP_LOGI(TAG, "Tasks (sample %lu):", (unsigned long)snap.samples);
+        for (int id = 0; id < TASK_ID_COUNT; id++) {
+            const task_monitor_entry_t *t = &snap.tasks[id];
+            if (!t->alive) continue;
+            char cpu[8] = "-";
+            if (t->cpu_pct >= 0) snprintf(cpu, sizeof(cpu), "%d%%", t->cpu_pct);
+            if (t->stack_size) {
+                ESP_LOGI(TAG, "  %-13s stack %5lu/%5lu used (%3u%%, %4lu free)  cpu %s", t->name,
+                         (unsigned long)(t->stack_size - t->stack_free_min), (unsigned long)t->stack_size,
+                         (unsigned)t->stack_used_pct, (unsigned long)t->stack_free_min, cpu);
+            } else {
+                ESP_LOGI(TAG, "  %-13s stack %4lu free (size: port default)  cpu %s", t->name,
+                         (unsigned long)t->stack_free_min, cpu);
+            }
+            if (t->stack_free_min < TASK_MONITOR_STACK_WARN_BYTES) {
+                ESP_LOGW(TAG, "  %s came within %lu bytes of overflowing its stack",
+                         t->name, (unsigned long)t->stack_free_min);
+            }
+        }
+        if (snap.core_busy_pct[0] >= 0) {
+            ESP_LOGI(TAG, "  Core load: C0 %d%%, C1 %d%%", snap.core_busy_pct[0], snap.core_busy_pct[1]);
+        }
+        job_watch_log_report();  // Job durations vs deadlines, same cadence
+        heap_watch_sample();     // Free memory and fragmentation, same cadence
+
+        portENTER_CRITICAL(&monitor_lock);
+        latest = snap;
+        portEXIT_CRITICAL(&monitor_lock);
+        publish(&snap);
+
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_GOLDIE_TASK_MONITOR_PERIOD_S * 1000));
+    }
+}
+
+void task_monitor_start(void)
+{
+    if (CONFIG_GOLDIE_TASK_MONITOR_PERIOD_S <= 0) {
+        ESP_LOGI(TAG, "Task monitor disabled");
+        return;
+    }
+    TaskHandle_t handle = NULL;
+    if (task_layout_create(TASK_ID_MONITOR, task_monitor_task, NULL, &handle) != pdPASS) {
+        ESP_LOGW(TAG, "Failed to create task monitor");
+        return;
+    }
+    task_monitor_register(TASK_ID_MONITOR, handle);
+}
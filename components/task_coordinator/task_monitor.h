@@ -0,0 +1,75 @@
+#ifndef TASK_MONITOR_H
+#define TASK_MONITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "task_layout.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Task Monitor - stack high-water marks and CPU share of the app tasks
+ * 
+ * A low-priority task samples every CONFIG_GOLDIE_TASK_MONITOR_PERIOD_S:
+ *   - uxTaskGetStackHighWaterMark() of every registered task
+ *   - per-task and per-core CPU share since the previous sample, when
+ *     FreeRTOS run time stats are enabled (CONFIG_FREERTOS_USE_TRACE_FACILITY
+ *     + CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS)
+ * 
+ * Each sample is logged, kept for task_monitor_get() (system tile) and
+ * published on MSG_TOPIC_TASK_STATS for Blynk. Job deadlines
+ * (job_watch.h) and heap fragmentation (heap_watch.h) are reported on
+ * the same cadence.
+ */
+
+#ifndef CONFIG_GOLDIE_TASK_MONITOR_PERIOD_S
+#define CONFIG_GOLDIE_TASK_MONITOR_PERIOD_S 30
+#endif
+
+#define TASK_MONITOR_STACK_WARN_BYTES  512   // Warn when a task came this close to overflowing
+
+typedef struct {
+    const char *name;
+    uint32_t stack_size;       // Bytes (0 = unknown)
+    uint32_t stack_free_min;   // Bytes never used since the task started
+    uint8_t  stack_used_pct;   // 0 if stack_size unknown
+    int8_t   cpu_pct;          // Share of one core since last sample, -1 = unavailable
+    bool     alive;
+} task_monitor_entry_t;
+
+typedef struct {
+    uint32_t samples;
+    int8_t   core_busy_pct[2]; // 100 - idle share per core, -1 = unavailable
+    task_monitor_entry_t tasks[TASK_ID_COUNT];
+} task_monitor_snapshot_t;
+
+/**
+ * @brief Track a task created outside task_layout_create (e.g. LVGL)
+ */
+void task_monitor_register(task_id_t id, TaskHandle_t handle);
+
+/**
+ * @brief Forget a task before it deletes itself
+ */
+void task_monitor_unregister(task_id_t id);
+
+/**
+ * @brief Start the monitor task (no-op if the period is 0)
+ */
+void task_monitor_start(void);
+
+/**
+ * @brief Copy the latest sample
+ * @return false if nothing was sampled yet
+ */
+bool task_monitor_get(task_monitor_snapshot_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_MONITOR_H
@@ -0,0 +1,163 @@
+#include "telemetry_backlog.h"
+#include "storage_fs.h"
+#include "esp_log.h"
+#include "time_svc.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/stat.h>
+
+static const char *TAG = "telemetry_backlog";
+
+// The file outlives firmware versions - pin the record layout
+static_assert(sizeof(telemetry_point_t) == 28, "telemetry_point_t must stay 28 bytes");
+
+#define BACKLOG_PATH            STORAGE_FS_BASE "/telemetry.bin"
+
+static telemetry_point_t ring[TELEMETRY_BACKLOG_RAM];
+static size_t ring_head = 0;       // Oldest point
+static size_t ring_count = 0;
+static size_t file_count = 0;      // Points in the file
+static size_t file_read = 0;       // First point of the file not yet sent
+static uint32_t lost = 0;
+
+// Last telemetry_backlog_peek(): from the file or from the ring
+static size_t picked_file = 0;
+static size_t picked_ring = 0;
+
+/**
+ * @brief Give a point taken before SNTP its wall time, if the clock is set now
+ */
+static bool stamp(telemetry_point_t *p)
+{
+    if (p->wall) {
+        return true;
+    }
+    if (!time_svc_wall_valid()) {
+        return false;
+    }
+    p->time = (uint32_t)time_svc_uptime_to_wall(p->time);
+    p->wall = 1;
+    return true;
+}
+
+static inline telemetry_point_t *ring_at(size_t i)
+{
+    return &ring[(ring_head + i) % TELEMETRY_BACKLOG_RAM];
+}
+
+static void ring_drop(size_t n)
+{
+    ring_head = (ring_head + n) % TELEMETRY_BACKLOG_RAM;
+    ring_count -= n;
+}
+
+/**
+ * @brief Full ring: move its older half to the file (or drop it)
+ */
+static void spill(void)
+{
+    size_t n = TELEMETRY_BACKLOG_RAM / 2;
+    size_t room = file_count < TELEMETRY_BACKLOG_FILE_MAX ? TELEMETRY_BACKLOG_FILE_MAX - file_count : 0;
+    size_t written = 0;
+    FILE *f = room > 0 ? fopen(BACKLOG_PATH, "ab") : NULL;
+    if (f != NULL) {
+        for (size_t i = 0; i < n && written < room; i++) {
+            telemetry_point_t *p = ring_at(i);
+            if (!stamp(p)) {
+                continue;    // No wall time yet: cannot outlive this boot
+            }
+            if (fwrite(p, sizeof(*p), 1, f) != 1) {
+                break;
+            }
+            written++;
+        }
+        if (fclose(f) != 0) {
+            ESP_LOGE(TAG, "Failed to append to %s (errno=%d)", BACKLOG_PATH, errno);
+        }
+    }
+    file_count += written;
+    lost += n - written;
+    ring_drop(n);
+    ESP_LOGW(TAG, "Offline backlog: %u point(s) to flash, %lu dropped so far, %u waiting",
+             (unsigned)written, (unsigned long)lost, (unsigned)telemetry_backlog_pending());
+}
+
+extern "C" void telemetry_backlog_init(void)
+{
+    struct stat st;
+    if (stat(BACKLOG_PATH, &st) == 0) {
+        file_count = (size_t)st.st_size / sizeof(telemetry_point_t);
+        file_read = 0;
+        if (file_count > 0) {
+            ESP_LOGI(TAG, "%u offline point(s) from before the reboot wait for the cloud",
+                     (unsigned)file_count);
+        }
+    }
+}
+
+extern "C" void telemetry_backlog_push(uint32_t boot_s, const float value[TELEMETRY_BACKLOG_VALUES])
+{
+    picked_file = picked_ring = 0;
+    if (ring_count == TELEMETRY_BACKLOG_RAM) {
+        spill();
+    }
+    telemetry_point_t *p = ring_at(ring_count);
+    memset(p, 0, sizeof(*p));
+    p->time = boot_s;
+    memcpy(p->value, value, sizeof(p->value));
+    stamp(p);
+    ring_count++;
+}
+
+extern "C" size_t telemetry_backlog_pending(void)
+{
+    return file_count - file_read + ring_count;
+}
+
+extern "C" size_t telemetry_backlog_peek(telemetry_point_t *out, size_t max)
+{
+    picked_file = picked_ring = 0;
+    if (file_read < file_count) {
+        FILE *f = fopen(BACKLOG_PATH, "rb");
+        if (f == NULL || fseek(f, (long)(file_read * sizeof(telemetry_point_t)), SEEK_SET) != 0) {
+            ESP_LOGE(TAG, "Failed to read %s (errno=%d) - dropping it", BACKLOG_PATH, errno);
+            if (f != NULL) {
+                fclose(f);
+            }
+            remove(BACKLOG_PATH);
+            lost += file_count - file_read;
+            file_count = file_read = 0;
+        } else {
+            size_t want = file_count - file_read < max ? file_count - file_read : max;
+            picked_file = fread(out, sizeof(*out), want, f);
+            fclose(f);
+            if (picked_file < want) {
+                file_count = file_read + picked_file;   // Torn tail of a power cut
+            }
+            if (picked_file > 0) {
+                return picked_file;
+            }
+        }
+    }
+
+    while (picked_ring < max && picked_ring < ring_count && stamp(ring_at(picked_ring))) {
+        out[picked_ring] = *ring_at(picked_ring);
+        picked_ring++;
+    }
+    return picked_ring;
+}
+
+extern "C" void telemetry_backlog_mark_sent(void)
+{
+    if (picked_file > 0) {
+        file_read += picked_file;
+        if (file_read >= file_count) {
+            remove(BACKLOG_PATH);
+            file_count = file_read = 0;
+        }
+    }
+    ring_drop(picked_ring);
+    picked_file = picked_ring = 0;
+}
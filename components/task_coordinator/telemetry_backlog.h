@@ -0,0 +1,86 @@
+#ifndef TELEMETRY_BACKLOG_H
+#define TELEMETRY_BACKLOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Telemetry Backlog - Blynk snapshots the cloud never got
+ *
+ * While Blynk is not initialised, WiFi is down or a push fails, the
+ * telemetry worker keeps each snapshot here instead of dropping it. Points
+ * sit in a RAM ring of TELEMETRY_BACKLOG_RAM; when it fills, its older
+ * half is appended to telemetry.bin on the storage partition, up
+ * to TELEMETRY_BACKLOG_FILE_MAX points (about CONFIG_GOLDIE_TELEMETRY_
+ * BACKLOG_HOURS of 30 s snapshots). Past that, new spills are dropped and
+ * counted - the file keeps the start of the outage. The file survives a
+ * reboot and is drained first.
+ *
+ * A point taken before SNTP set the clock carries seconds since boot and
+ * gets its wall time once the clock is known (same boot only). Such
+ * points never go to the file: RAM overflow drops the oldest of them.
+ *
+ * After a reconnect the worker peeks up to TELEMETRY_BACKLOG_BATCH of the
+ * oldest points, sends them as timestamped writes and marks them sent.
+ * The file read position is not persisted: a reboot while draining sends
+ * that file again, which Blynk stores as the same timestamps.
+ *
+ * Worker side (telemetry task) only.
+ */
+
+#define TELEMETRY_BACKLOG_VALUES    5     // Temperature, oxygen, pH, feed hours, clean days
+#define TELEMETRY_BACKLOG_RAM       120   // One hour of 30 s snapshots
+#define TELEMETRY_BACKLOG_BATCH     30    // Points per drain step
+
+#ifndef CONFIG_GOLDIE_TELEMETRY_BACKLOG_HOURS
+#define CONFIG_GOLDIE_TELEMETRY_BACKLOG_HOURS 24
+#endif
+#define TELEMETRY_BACKLOG_FILE_MAX  (CONFIG_GOLDIE_TELEMETRY_BACKLOG_HOURS * 120)
+
+typedef struct {
+    uint32_t time;         // Unix seconds, or seconds since boot (!wall)
+    uint8_t wall;
+    uint8_t reserved[3];
+    float value[TELEMETRY_BACKLOG_VALUES];
+} telemetry_point_t;
+
+/**
+ * @brief Count the points a previous boot left in the file
+ */
+void telemetry_backlog_init(void);
+
+/**
+ * @brief Keep one snapshot (boot_s: seconds since boot when it was taken)
+ */
+void telemetry_backlog_push(uint32_t boot_s, const float value[TELEMETRY_BACKLOG_VALUES]);
+
+/**
+ * @brief Points waiting (file + RAM)
+ */
+size_t telemetry_backlog_pending(void);
+
+/**
+ * @brief Copy up to `max` of the oldest points, all with wall time, to `out`
+ *
+ * Returns 0 while the oldest point still waits for the clock. They stay
+ * waiting until telemetry_backlog_mark_sent(); peeking again before that
+ * returns the same points.
+ */
+size_t telemetry_backlog_peek(telemetry_point_t *out, size_t max);
+
+/**
+ * @brief The points of the last telemetry_backlog_peek() reached the cloud
+ */
+void telemetry_backlog_mark_sent(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_BACKLOG_H
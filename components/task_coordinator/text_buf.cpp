@@ -0,0 +1,105 @@
+#include "text_buf.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+
+static const char *TAG = "text_buf";
+
+struct text_buf {
+    volatile uint32_t refs;     // 0 = free
+    char *data;
+};
+
+static text_buf_t pool[TEXT_BUF_POOL_SLOTS];
+static char *storage = NULL;
+static uint32_t alloc_count = 0;
+static uint32_t alloc_failures = 0;
+
+esp_err_t text_buf_init(void)
+{
+    if (storage) {
+        return ESP_OK;
+    }
+    // PSRAM: the text is read by LVGL and the network tasks, never by DMA
+    storage = (char *)heap_caps_malloc(TEXT_BUF_POOL_SLOTS * TEXT_BUF_CAPACITY,
+                                       MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!storage) {
+        storage = (char *)heap_caps_malloc(TEXT_BUF_POOL_SLOTS * TEXT_BUF_CAPACITY, MALLOC_CAP_8BIT);
+    }
+    if (!storage) {
+        ESP_LOGE(TAG, "Failed to allocate %d text buffers", TEXT_BUF_POOL_SLOTS);
+        return ESP_ERR_NO_MEM;
+    }
+    for (int i = 0; i < TEXT_BUF_POOL_SLOTS; i++) {
+        pool[i].refs = 0;
+        pool[i].data = storage + i * TEXT_BUF_CAPACITY;
+        pool[i].data[0] = '\0';
+    }
+    ESP_LOGI(TAG, "Text buffer pool ready (%d x %d bytes)", TEXT_BUF_POOL_SLOTS, TEXT_BUF_CAPACITY);
+    return ESP_OK;
+}
+
+text_buf_t *text_buf_alloc(char **data, size_t *capacity)
+{
+    if (!storage) {
+        return NULL;
+    }
+    for (int i = 0; i < TEXT_BUF_POOL_SLOTS; i++) {
+        uint32_t expected = 0;
+        if (__atomic_compare_exchange_n(&pool[i].refs, &expected, 1, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            pool[i].data[0] = '\0';
+            if (data) *data = pool[i].data;
+            if (capacity) *capacity = TEXT_BUF_CAPACITY;
+            __atomic_add_fetch(&alloc_count, 1, __ATOMIC_RELAXED);
+            return &pool[i];
+        }
+    }
+    if ((__atomic_fetch_add(&alloc_failures, 1, __ATOMIC_RELAXED) % 16) == 0) {
+        ESP_LOGW(TAG, "Text buffer pool exhausted (%d in use)", TEXT_BUF_POOL_SLOTS);
+    }
+    return NULL;
+}
+
+text_buf_t *text_buf_from_str(const char *str)
+{
+    char *data;
+    size_t capacity;
+    text_buf_t *t = text_buf_alloc(&data, &capacity);
+    if (t) {
+        snprintf(data, capacity, "%s", str ? str : "");
+    }
+    return t;
+}
+
+text_buf_t *text_buf_ref(text_buf_t *t)
+{
+    if (t) {
+        __atomic_add_fetch(&t->refs, 1, __ATOMIC_RELAXED);
+    }
+    return t;
+}
+
+void text_buf_unref(text_buf_t *t)
+{
+    if (t) {
+        __atomic_sub_fetch(&t->refs, 1, __ATOMIC_ACQ_REL);  // 0 = back in the pool
+    }
+}
+
+const char *text_buf_str(const text_buf_t *t)
+{
+    return t ? t->data : "";
+}
+
+void text_buf_log_stats(void)
+{
+    int in_use = 0;
+    for (int i = 0; i < TEXT_BUF_POOL_SLOTS; i++) {
+        if (pool[i].refs) in_use++;
+    }
+    ESP_LOGI(TAG, "Text buffers: %d/%d in use, %lu allocated, %lu pool-empty",
+             in_use, TEXT_BUF_POOL_SLOTS, (unsigned long)alloc_count, (unsigned long)alloc_failures);
+}
@@ -0,0 +1,81 @@
+#ifndef TEXT_BUF_H
+#define TEXT_BUF_H
+
+#include <stddef.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Text Buffers - reference-counted, immutable strings from a small pool
+ * 
+ * Long strings (AI advice) are written once into a pooled PSRAM buffer and
+ * passed around as a text_buf_t handle. Messages carry the handle, so a
+ * FreeRTOS queue or bus slot copies a pointer instead of the text.
+ * 
+ * Rules:
+ *   - text_buf_alloc() hands out a buffer with one reference that only the
+ *     caller may write to. Once the handle is shared, the text is read-only.
+ *   - Every holder calls text_buf_ref() to keep it and text_buf_unref()
+ *     when done; the buffer returns to the pool at zero.
+ *   - NULL is a valid handle meaning "no text" (text_buf_str -> "").
+ * 
+ * All functions are safe from any task (not ISRs).
+ */
+
+#ifndef CONFIG_GOLDIE_AI_ADVICE_MAX_LEN
+#define CONFIG_GOLDIE_AI_ADVICE_MAX_LEN 1024
+#endif
+
+#define TEXT_BUF_POOL_SLOTS  6
+#define TEXT_BUF_CAPACITY    CONFIG_GOLDIE_AI_ADVICE_MAX_LEN  // Bytes incl. terminator
+
+typedef struct text_buf text_buf_t;
+
+/**
+ * @brief Allocate the pool (called by task_coordinator_init)
+ */
+esp_err_t text_buf_init(void);
+
+/**
+ * @brief Take an empty buffer (one reference, writable by the caller)
+ * 
+ * @param data     Filled with the writable bytes ("" on return)
+ * @param capacity Filled with TEXT_BUF_CAPACITY
+ * @return Handle, or NULL if the pool is exhausted
+ */
+text_buf_t *text_buf_alloc(char **data, size_t *capacity);
+
+/**
+ * @brief Allocate a buffer holding a copy of `str` (truncated to capacity)
+ */
+text_buf_t *text_buf_from_str(const char *str);
+
+/**
+ * @brief Add a reference (returns t, NULL-safe)
+ */
+text_buf_t *text_buf_ref(text_buf_t *t);
+
+/**
+ * @brief Drop a reference (NULL-safe)
+ */
+void text_buf_unref(text_buf_t *t);
+
+/**
+ * @brief The string, or "" for NULL. Valid while a reference is held.
+ */
+const char *text_buf_str(const text_buf_t *t);
+
+/**
+ * @brief Log pool use
+ */
+void text_buf_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEXT_BUF_H
@@ -0,0 +1,184 @@
+#include "ai_cache.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "time_svc.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static const char *TAG = "ai_cache";
+
+#define AI_CACHE_VERSION    1
+#define AI_CACHE_TTL_S      ((uint32_t)CONFIG_GOLDIE_AI_CACHE_TTL_MIN * 60)
+
+// Slot n is two NVS entries: "h<n>" (this header) and "t<n>" (the text)
+typedef struct {
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t key;
+    uint32_t wall;         // Stored at, 0 = empty slot
+} ai_cache_slot_t;
+
+static ai_cache_slot_t slots[AI_CACHE_SLOTS];
+static bool loaded = false;
+static uint32_t hits = 0;
+static uint32_t misses = 0;
+
+extern "C" uint32_t ai_cache_hash(uint32_t h, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint32_t wall_now(void)
+{
+    time_t now = time(NULL);
+    return (now >= (time_t)TIME_SVC_WALL_VALID) ? (uint32_t)now : 0;
+}
+
+static bool slot_live(const ai_cache_slot_t *s, uint32_t now)
+{
+    return s->wall != 0 && now >= s->wall && now - s->wall < AI_CACHE_TTL_S;
+}
+
+/**
+ * @brief Read the slot headers once (the texts stay in flash)
+ */
+static void load_index(void)
+{
+    if (loaded) {
+        return;
+    }
+    loaded = true;
+    memset(slots, 0, sizeof(slots));
+
+    nvs_handle_t nvs;
+    if (nvs_open(AI_CACHE_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+        return;    // Nothing stored yet
+    }
+    int live = 0;
+    uint32_t now = wall_now();
+    for (int i = 0; i < AI_CACHE_SLOTS; i++) {
+        char name[4];
+        snprintf(name, sizeof(name), "h%d", i);
+        ai_cache_slot_t s;
+        size_t len = sizeof(s);
+        if (nvs_get_blob(nvs, name, &s, &len) == ESP_OK && len == sizeof(s) &&
+            s.version == AI_CACHE_VERSION) {
+            slots[i] = s;
+            live += slot_live(&s, now) ? 1 : 0;
+        }
+    }
+    nvs_close(nvs);
+    ESP_LOGI(TAG, "%d cached repl%s still fresh", live, live == 1 ? "y" : "ies");
+}
+
+extern "C" bool ai_cache_get(uint32_t key, char *out, size_t size)
+{
+    if (AI_CACHE_TTL_S == 0 || out == NULL || size == 0) {
+        return false;
+    }
+    uint32_t now = wall_now();
+    if (now == 0) {
+        return false;
+    }
+    load_index();
+
+    for (int i = 0; i < AI_CACHE_SLOTS; i++) {
+        if (slots[i].key != key || !slot_live(&slots[i], now)) {
+            continue;
+        }
+        nvs_handle_t nvs;
+        if (nvs_open(AI_CACHE_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+            return false;
+        }
+        char name[4];
+        snprintf(name, sizeof(name), "t%d", i);
+        size_t len = size;
+        esp_err_t err = nvs_get_str(nvs, name, out, &len);
+        nvs_close(nvs);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Slot %d unreadable: %s", i, esp_err_to_name(err));
+            out[0] = '\0';
+            slots[i].wall = 0;
+            return false;
+        }
+        hits++;
+        ESP_LOGI(TAG, "Hit %08lx (%lu min old) - %lu hits / %lu misses", (unsigned long)key,
+                 (unsigned long)((now - slots[i].wall) / 60), (unsigned long)hits, (unsigned long)misses);
+        return true;
+    }
+    misses++;
+    return false;
+}
+
+extern "C" void ai_cache_put(uint32_t key, const char *text)
+{
+    if (AI_CACHE_TTL_S == 0 || text == NULL || text[0] == '\0') {
+        return;
+    }
+    uint32_t now = wall_now();
+    if (now == 0) {
+        return;
+    }
+    load_index();
+
+    // Same key, else an empty / expired slot, else the oldest
+    int pick = -1;
+    for (int i = 0; i < AI_CACHE_SLOTS && pick < 0; i++) {
+        if (slots[i].key == key && slots[i].wall != 0) {
+            pick = i;
+        }
+    }
+    for (int i = 0; i < AI_CACHE_SLOTS && pick < 0; i++) {
+        if (!slot_live(&slots[i], now)) {
+            pick = i;
+        }
+    }
+    if (pick < 0) {
+        pick = 0;
+        for (int i = 1; i < AI_CACHE_SLOTS; i++) {
+            if (slots[i].wall < slots[pick].wall) {
+                pick = i;
+            }
+        }
+    }
+
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(AI_CACHE_NVS_NS, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "NVS unavailable: %s", esp_err_to_name(err));
+        return;
+    }
+    // Header out first and back last: a write cut short by a reset leaves
+    // an empty slot, never the old key on the new text
+    ai_cache_slot_t s = { AI_CACHE_VERSION, 0, key, now };
+    char head[4];
+    char body[4];
+    snprintf(head, sizeof(head), "h%d", pick);
+    snprintf(body, sizeof(body), "t%d", pick);
+    err = nvs_erase_key(nvs, head);
+    if (err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND) {
+        slots[pick].wall = 0;
+        err = nvs_set_str(nvs, body, text);
+    }
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, head, &s, sizeof(s));
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Storing reply failed: %s", esp_err_to_name(err));
+        slots[pick].wall = 0;
+        return;
+    }
+    slots[pick] = s;
+    ESP_LOGI(TAG, "Stored %08lx in slot %d (%u bytes)", (unsigned long)key, pick, (unsigned)strlen(text));
+}
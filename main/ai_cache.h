@@ -0,0 +1,52 @@
+#ifndef AI_CACHE_H
+#define AI_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// AI advice cache in NVS (namespace "goldie_ai")
+//
+// A reply is stored under a 32-bit key the caller hashes from the
+// quantised tank state that went into the prompt. A later query for the
+// same state within CONFIG_GOLDIE_AI_CACHE_TTL_MIN is answered from flash
+// without touching the network, across reboots too. AI_CACHE_SLOTS
+// replies are kept; a new one replaces an expired or the oldest slot.
+//
+// Ages are wall-clock based, so nothing is stored or served before SNTP
+// has set the clock. AI worker only.
+
+#ifndef CONFIG_GOLDIE_AI_CACHE_TTL_MIN
+#define CONFIG_GOLDIE_AI_CACHE_TTL_MIN 120
+#endif
+
+#define AI_CACHE_NVS_NS     "goldie_ai"
+#define AI_CACHE_SLOTS      4
+#define AI_CACHE_HASH_SEED  2166136261u   // FNV-1a offset basis
+
+/**
+ * @brief Fold bytes into a key (FNV-1a), start from AI_CACHE_HASH_SEED
+ */
+uint32_t ai_cache_hash(uint32_t h, const void *data, size_t len);
+
+/**
+ * @brief Copy the cached reply for key into out
+ * @return false on a miss, an expired entry or a clock that is not set
+ */
+bool ai_cache_get(uint32_t key, char *out, size_t size);
+
+/**
+ * @brief Store a reply for key (written to NVS straight away)
+ */
+void ai_cache_put(uint32_t key, const char *text);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AI_CACHE_H
@@ -0,0 +1,152 @@
+#include "ai_chat.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+static const char *TAG = "ai_chat";
+
+#define RING_BYTES  CONFIG_GOLDIE_AI_CHAT_RING_BYTES
+
+typedef struct {
+    uint32_t pos;          // Ring position of the text, counted since init
+    uint16_t len;
+    uint8_t role;
+} turn_t;
+
+static char *ring = NULL;
+static SemaphoreHandle_t lock = NULL;
+static turn_t turns[AI_CHAT_TURNS];    // Turn seq at turns[seq % AI_CHAT_TURNS]
+static uint32_t first_seq = 1;         // Oldest turn held
+static uint32_t end_seq = 1;           // Next turn
+static uint32_t head = 0;              // Next free ring position
+static char memo[AI_CHAT_MEMO_MAX];
+
+extern "C" esp_err_t ai_chat_init(void)
+{
+    if (ring) {
+        return ESP_OK;
+    }
+    ring = (char *)heap_caps_malloc(RING_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!ring) {
+        ESP_LOGE(TAG, "Failed to allocate the %d-byte chat ring", RING_BYTES);
+        return ESP_ERR_NO_MEM;
+    }
+    lock = xSemaphoreCreateMutex();
+    memo[0] = '\0';
+    return ESP_OK;
+}
+
+/**
+ * @brief Bytes of text that fit size - 1 without splitting a character
+ */
+static size_t utf8_cut(const char *s, size_t len, size_t size)
+{
+    if (len < size) {
+        return len;
+    }
+    len = size - 1;
+    while (len > 0 && ((unsigned char)s[len] & 0xC0) == 0x80) {
+        len--;
+    }
+    return len;
+}
+
+extern "C" uint32_t ai_chat_add(ai_chat_role_t role, const char *text)
+{
+    if (!ring) {
+        return 0;
+    }
+    // Contiguous text: a turn that would run past the end starts at 0
+    size_t len = utf8_cut(text, strlen(text), RING_BYTES / 2);
+    xSemaphoreTake(lock, portMAX_DELAY);
+    uint32_t pos = head;
+    if (pos % RING_BYTES + len > RING_BYTES) {
+        pos += RING_BYTES - pos % RING_BYTES;
+    }
+    head = pos + (uint32_t)len;
+    // The oldest turns whose bytes are about to be overwritten go
+    while (first_seq < end_seq &&
+           (end_seq - first_seq >= AI_CHAT_TURNS ||
+            head - turns[first_seq % AI_CHAT_TURNS].pos > RING_BYTES)) {
+        first_seq++;
+    }
+    memcpy(ring + pos % RING_BYTES, text, len);
+    uint32_t seq = end_seq++;
+    turns[seq % AI_CHAT_TURNS] = { pos, (uint16_t)len, (uint8_t)role };
+    xSemaphoreGive(lock);
+    return seq;
+}
+
+extern "C" void ai_chat_span(uint32_t *first, uint32_t *end)
+{
+    if (!ring) {
+        *first = *end = 0;
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    *first = first_seq;
+    *end = end_seq;
+    xSemaphoreGive(lock);
+}
+
+extern "C" bool ai_chat_get(uint32_t seq, ai_chat_role_t *role, char *buf, size_t size)
+{
+    if (!ring || size == 0) {
+        return false;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    bool held = seq >= first_seq && seq < end_seq;
+    if (held) {
+        const turn_t *t = &turns[seq % AI_CHAT_TURNS];
+        const char *text = ring + t->pos % RING_BYTES;
+        size_t len = utf8_cut(text, t->len, size);
+        memcpy(buf, text, len);
+        buf[len] = '\0';
+        if (role) {
+            *role = (ai_chat_role_t)t->role;
+        }
+    }
+    xSemaphoreGive(lock);
+    return held;
+}
+
+extern "C" void ai_chat_set_memo(const char *text)
+{
+    if (!ring) {
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    size_t len = utf8_cut(text, strlen(text), sizeof(memo));
+    memcpy(memo, text, len);
+    memo[len] = '\0';
+    xSemaphoreGive(lock);
+}
+
+extern "C" void ai_chat_memo(char *buf, size_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    buf[0] = '\0';
+    if (!ring) {
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    size_t len = utf8_cut(memo, strlen(memo), size);
+    memcpy(buf, memo, len);
+    buf[len] = '\0';
+    xSemaphoreGive(lock);
+}
+
+extern "C" void ai_chat_clear(void)
+{
+    if (!ring) {
+        return;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    first_seq = end_seq;
+    memo[0] = '\0';
+    xSemaphoreGive(lock);
+}
@@ -0,0 +1,99 @@
+#ifndef AI_CHAT_H
+#define AI_CHAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// "Ask Goldie" conversation history
+//
+// Turns (the owner's questions, Goldie's answers) are kept in a fixed
+// PSRAM byte ring of CONFIG_GOLDIE_AI_CHAT_RING_BYTES, each under a
+// sequence number that only grows. A new turn that does not fit pushes
+// the oldest ones out, so the ring never allocates after init. Each
+// answer also brings a memo (the reply's "summary" field: the whole
+// conversation in a few words); a prompt sends the newest turns that fit
+// its budget verbatim and the memo for the older ones (gemini_chat()).
+//
+// Written by the dashboard (questions) and the AI worker (answers, memo),
+// read by both: every call takes the ring's mutex.
+
+#ifndef CONFIG_GOLDIE_AI
+#define CONFIG_GOLDIE_AI 0
+#endif
+
+#ifndef CONFIG_GOLDIE_AI_CHAT_RING_BYTES
+#define CONFIG_GOLDIE_AI_CHAT_RING_BYTES 8192
+#endif
+
+#define AI_CHAT_TURNS      32       // Turns kept at most, whatever their length
+#define AI_CHAT_INPUT_MAX  200      // Longest question, terminator included
+#define AI_CHAT_MEMO_MAX   320
+
+typedef enum {
+    AI_CHAT_OWNER = 0,
+    AI_CHAT_GOLDIE,
+} ai_chat_role_t;
+
+#if CONFIG_GOLDIE_AI
+
+/**
+ * @brief Allocate the ring (called by task_coordinator_init)
+ */
+esp_err_t ai_chat_init(void);
+
+/**
+ * @brief Append a turn, evicting the oldest ones it needs room from
+ * @return Its sequence number, 0 if the ring is not allocated
+ */
+uint32_t ai_chat_add(ai_chat_role_t role, const char *text);
+
+/**
+ * @brief Sequence numbers held: [*first, *end), empty when equal
+ */
+void ai_chat_span(uint32_t *first, uint32_t *end);
+
+/**
+ * @brief Copy a turn out (cut to size on a UTF-8 boundary)
+ * @return false if it was evicted or never existed
+ */
+bool ai_chat_get(uint32_t seq, ai_chat_role_t *role, char *buf, size_t size);
+
+/**
+ * @brief Replace the memo of the conversation so far
+ */
+void ai_chat_set_memo(const char *memo);
+
+/**
+ * @brief Copy the memo ("" before the first answer)
+ */
+void ai_chat_memo(char *buf, size_t size);
+
+/**
+ * @brief Forget every turn and the memo (numbers keep growing)
+ */
+void ai_chat_clear(void);
+
+#else
+// Built without the AI client (ai_chat.cpp not compiled): no ring, so the
+// dashboard cannot add a question and Ask Goldie stays empty
+static inline esp_err_t ai_chat_init(void) { return ESP_ERR_NOT_SUPPORTED; }
+static inline uint32_t ai_chat_add(ai_chat_role_t role, const char *text) { return 0; }
+static inline void ai_chat_span(uint32_t *first, uint32_t *end) { *first = *end = 0; }
+static inline bool ai_chat_get(uint32_t seq, ai_chat_role_t *role, char *buf, size_t size) { return false; }
+static inline void ai_chat_set_memo(const char *memo) {}
+static inline void ai_chat_memo(char *buf, size_t size) { if (size > 0) buf[0] = '\0'; }
+static inline void ai_chat_clear(void) {}
+#endif // CONFIG_GOLDIE_AI
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AI_CHAT_H
@@ -0,0 +1,832 @@
+#include "ai_provider.h"
+#include "gemini_api.h"
+#include "wifi_config.h"
+#include "json_stream.h"
+#include "text_buf.h"
+#include "task_layout.h"
+#include "task_monitor.h"
+#include "esp_log.h"
+#include "http_pool.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdio.h>
+#include <string.h>
+#if CONFIG_GOLDIE_SNAPSHOT_AI
+#include "snapshot.h"
+#include "time_svc.h"
+#endif
+
+static const char *TAG = "ai_provider";
+
+#ifndef GEMINI_API_KEY
+#define GEMINI_API_KEY ""          // Define in wifi_config.h to enable Gemini
+#endif
+
+#if CONFIG_GOLDIE_AI_STREAM
+#define AI_STREAM            1
+#else
+#define AI_STREAM            0
+#endif
+
+#define AI_TIMEOUT_MS        10000
+#define AI_ERROR_HEAD        256
+#if CONFIG_GOLDIE_SNAPSHOT_AI
+#define AI_IMAGE_MAX         (SNAPSHOT_AI_B64_MAX + 128)    // Base64 JPEG part of a vision request
+#else
+#define AI_IMAGE_MAX         0
+#endif
+#define AI_BODY_MAX          (AI_PROMPT_JSON_MAX + 256 + AI_IMAGE_MAX)
+#define AI_CONTENT_MAX       (TEXT_BUF_CAPACITY + AI_SUMMARY_MAX + 128)    // Reply object, keys and escapes
+#define AI_COOL_BASE_S       30
+#define AI_COOL_MAX_S        600
+#define AI_MAX_TOKENS        "200"     // 80 words of advice, the summary and the keys
+#define AI_TEMPERATURE       "0.7"
+
+#define GEMINI_URL_BASE      "https://generativelanguage.googleapis.com/v1beta/models/"
+#define SSE_DATA_PREFIX      "data:"
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PROVIDER TABLE
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    const char *name;
+    ai_format_t format;
+    const char *url;
+    const char *model;          // OpenAI format (Gemini has it in the URL)
+    const char *auth_header;    // NULL = no authentication
+    const char *auth_prefix;
+    const char *key;
+    bool vision;                // Takes an image with the prompt
+} ai_provider_def_t;
+
+static char gemini_url[160];
+
+static const ai_provider_def_t provider_defs[] = {
+    { "groq",   AI_FORMAT_OPENAI, GROQ_API_URL, "llama-3.3-70b-versatile",
+      "Authorization", "Bearer ", GROQ_API_KEY, false },
+    { "gemini", AI_FORMAT_GEMINI, gemini_url, NULL,
+      "x-goog-api-key", "", GEMINI_API_KEY, true },
+    { "local",  AI_FORMAT_OPENAI, CONFIG_GOLDIE_AI_LOCAL_URL, CONFIG_GOLDIE_AI_LOCAL_MODEL,
+      NULL, NULL, NULL, false },
+};
+
+#define PROVIDER_COUNT  (sizeof(provider_defs) / sizeof(provider_defs[0]))
+
+typedef struct {
+    const ai_provider_def_t *def;
+    bool enabled;
+
+    // Session (kept-alive connections in the provider's http_pool host)
+    http_pool_host_t *host;
+    volatile bool busy;         // A request (possibly an abandoned hedge) is running
+
+    // Health
+    float latency_ms;           // EWMA of successful requests, 0 = not measured
+    float err_rate;             // EWMA of failures, 0..1
+    uint32_t fails;             // In a row
+    uint32_t cool_until;        // Uptime seconds, skipped before this
+    uint32_t ok_count;
+    uint32_t fail_count;
+    uint32_t hedge_wins;
+} ai_provider_t;
+
+static ai_provider_t providers[PROVIDER_COUNT];
+
+static portMUX_TYPE health_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool table_ready = false;
+
+static void table_init(void)
+{
+    if (table_ready) {
+        return;
+    }
+    table_ready = true;
+    snprintf(gemini_url, sizeof(gemini_url), GEMINI_URL_BASE "%s:%s", CONFIG_GOLDIE_AI_GEMINI_MODEL,
+             AI_STREAM ? "streamGenerateContent?alt=sse" : "generateContent");
+    for (size_t i = 0; i < PROVIDER_COUNT; i++) {
+        ai_provider_t *p = &providers[i];
+        p->def = &provider_defs[i];
+        p->enabled = p->def->url[0] != '\0' && (p->def->auth_header == NULL || p->def->key[0] != '\0');
+        p->host = p->enabled ? http_pool_host(p->def->name, AI_TIMEOUT_MS) : NULL;
+        ESP_LOGI(TAG, "Provider %-6s %s", p->def->name, p->enabled ? "enabled" : "not configured");
+    }
+}
+
+static float score(const ai_provider_t *p)
+{
+    float latency = p->latency_ms > 0.0f ? p->latency_ms : (float)AI_LATENCY_PRIOR_MS;
+    return latency * (1.0f + 4.0f * p->err_rate);
+}
+
+static void health_update(ai_provider_t *p, bool ok, int64_t ms)
+{
+    uint32_t now = time_svc_uptime_s();
+    portENTER_CRITICAL(&health_lock);
+    if (ok) {
+        p->latency_ms = (p->latency_ms > 0.0f) ? p->latency_ms + ((float)ms - p->latency_ms) / 4.0f : (float)ms;
+        p->err_rate -= p->err_rate / 8.0f;
+        p->fails = 0;
+        p->cool_until = 0;
+        p->ok_count++;
+    } else {
+        p->err_rate += (1.0f - p->err_rate) / 8.0f;
+        p->fails++;
+        uint32_t cool = (p->fails <= 5) ? (uint32_t)AI_COOL_BASE_S << (p->fails - 1) : AI_COOL_MAX_S;
+        p->cool_until = now + (cool < AI_COOL_MAX_S ? cool : AI_COOL_MAX_S);
+        p->fail_count++;
+    }
+    portEXIT_CRITICAL(&health_lock);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ONE REQUEST (REPLY SCAN, SSE, FIELDS, PARTIALS)
+// ═══════════════════════════════════════════════════════════════════════════
+// Only the reply content is copied out of the body while it streams in
+// (json_stream). A streamed reply is a series of server-sent events, one
+// "data: {chunk}" line per token group; each line is scanned on its own
+// and its piece is appended to the content so far. Every new piece of
+// content is then fed to the field scans, which decode the fields of the
+// reply object straight into the caller's buffers. The first body bytes
+// are kept raw so an error body can still be logged.
+
+static const char *const field_key[AI_FIELD_COUNT] = { "advice", "summary" };
+
+enum {
+    REPLY_UNKNOWN = 0,     // Only blanks (or a ``` fence) so far
+    REPLY_JSON,            // Object: split into the fields
+    REPLY_TEXT,            // Plain text: all of it is the advice
+};
+
+enum {
+    SSE_LINE_START = 0,    // Matching SSE_DATA_PREFIX (sse_match bytes so far)
+    SSE_LINE_DATA,         // Event payload: fed to the scan
+    SSE_LINE_SKIP,         // Other field, comment or blank line
+};
+
+typedef struct {
+    ai_provider_t *p;
+    ai_reply_t reply;
+    char *content;             // Reply content as sent (AI_CONTENT_MAX)
+    bool on_worker;            // Feeds the rate limiter's header view
+    volatile bool abandoned;   // The other request won: stop posting partials
+
+    json_stream_t scan;
+    char head[AI_ERROR_HEAD];
+    int head_len;
+    int body_len;
+
+    uint8_t sse_line;
+    uint8_t sse_match;
+    size_t content_len;
+    bool content_truncated;
+    size_t sse_posted;         // Advice bytes already passed on
+    int64_t sse_post_us;
+
+    json_stream_t field[AI_FIELD_COUNT];
+    uint8_t reply_mode;        // REPLY_*
+    bool fenced;
+    size_t fed;                // Content bytes the field scans have seen
+
+    // Result
+    bool ok;
+    bool truncated;
+    int status;
+    ai_err_class_t err_class;
+    int64_t done_us;
+} ai_call_t;
+
+static ai_partial_cb_t partial_cb = NULL;
+static void *partial_arg = NULL;
+static ai_call_t *volatile partial_owner = NULL;   // First request with content
+
+static const char *reply_path(const ai_provider_t *p)
+{
+    if (p->def->format == AI_FORMAT_GEMINI) {
+        return "candidates.0.content.parts.0.text";
+    }
+    return AI_STREAM ? "choices.0.delta.content" : "choices.0.message.content";
+}
+
+static void call_reset(ai_call_t *c)
+{
+    c->head_len = 0;
+    c->head[0] = '\0';
+    c->body_len = 0;
+    c->sse_line = SSE_LINE_START;
+    c->sse_match = 0;
+    c->content_len = 0;
+    c->content_truncated = false;
+    c->sse_posted = 0;
+    c->sse_post_us = 0;
+    c->content[0] = '\0';
+    c->reply_mode = REPLY_UNKNOWN;
+    c->fenced = false;
+    c->fed = 0;
+    for (int f = 0; f < AI_FIELD_COUNT; f++) {
+        json_stream_init(&c->field[f], field_key[f], c->reply.text[f], c->reply.text[f] ? c->reply.size[f] : 0);
+    }
+    if (!AI_STREAM) {
+        json_stream_init(&c->scan, reply_path(c->p), c->content, AI_CONTENT_MAX);
+    }
+}
+
+/**
+ * @brief Pass the content added since the last call to the field scans
+ */
+static void fields_feed(ai_call_t *c)
+{
+    size_t i = c->fed;
+    while (c->reply_mode == REPLY_UNKNOWN && i < c->content_len) {
+        char ch = c->content[i];
+        if (ch == '{') {
+            c->reply_mode = REPLY_JSON;
+        } else if (ch == '`') {
+            c->fenced = true;
+            i++;
+        } else if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || c->fenced) {
+            i++;                            // Blanks, or the fence's language tag
+        } else {
+            c->reply_mode = REPLY_TEXT;
+        }
+    }
+    if (c->reply_mode == REPLY_JSON) {
+        for (int f = 0; f < AI_FIELD_COUNT; f++) {
+            if (c->reply.text[f] != NULL) {
+                json_stream_feed(&c->field[f], c->content + i, c->content_len - i);
+            }
+        }
+    }
+    c->fed = c->content_len;
+}
+
+/**
+ * @brief Whole reply in: plain text becomes the advice
+ * @return true if there is advice
+ */
+static bool fields_finish(ai_call_t *c)
+{
+    fields_feed(c);
+    if (c->reply_mode == REPLY_JSON) {
+        for (int f = 0; f < AI_FIELD_COUNT; f++) {
+            c->truncated = c->truncated || c->field[f].truncated;
+        }
+        return c->field[AI_FIELD_ADVICE].out_len > 0;
+    }
+    char *out = c->reply.text[AI_FIELD_ADVICE];
+    size_t size = c->reply.size[AI_FIELD_ADVICE];
+    if (c->reply_mode != REPLY_TEXT || out == NULL || size == 0) {
+        return false;
+    }
+    size_t n = c->content_len;
+    if (n >= size) {
+        // Cut on a character boundary
+        n = size - 1;
+        while (n > 0 && ((unsigned char)c->content[n] & 0xC0) == 0x80) {
+            n--;
+        }
+        c->truncated = true;
+    }
+    memcpy(out, c->content, n);
+    out[n] = '\0';
+    return n > 0;
+}
+
+static void post_partial(ai_call_t *c)
+{
+    const char *text = c->reply_mode == REPLY_JSON ? c->reply.text[AI_FIELD_ADVICE] : c->content;
+    size_t len = c->reply_mode == REPLY_JSON ? c->field[AI_FIELD_ADVICE].out_len : c->content_len;
+    if (partial_cb == NULL || c->abandoned || c->reply_mode == REPLY_UNKNOWN || text == NULL ||
+        len <= c->sse_posted) {
+        return;
+    }
+    // One request drives the screen: a hedge must not interleave its words
+    ai_call_t *expected = NULL;
+    if (partial_owner != c &&
+        !__atomic_compare_exchange_n(&partial_owner, &expected, c, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    if (c->sse_posted == 0 || now - c->sse_post_us >= (int64_t)CONFIG_GOLDIE_AI_STREAM_INTERVAL_MS * 1000) {
+        partial_cb(text, partial_arg);      // First words go out at once
+        c->sse_posted = len;
+        c->sse_post_us = now;
+    }
+}
+
+static void sse_line_end(ai_call_t *c)
+{
+    if (c->sse_line == SSE_LINE_DATA && json_stream_found(&c->scan)) {
+        c->content_len += c->scan.out_len;
+        c->content_truncated = c->content_truncated || c->scan.truncated;
+        fields_feed(c);
+    }
+    c->sse_line = SSE_LINE_START;
+    c->sse_match = 0;
+    post_partial(c);
+}
+
+static void sse_feed(ai_call_t *c, const char *data, int len)
+{
+    int i = 0;
+    while (i < len) {
+        if (c->sse_line == SSE_LINE_DATA || c->sse_line == SSE_LINE_SKIP) {
+            const char *nl = (const char *)memchr(data + i, '\n', len - i);
+            int run = nl ? (int)(nl - (data + i)) : len - i;
+            if (c->sse_line == SSE_LINE_DATA && !c->content_truncated) {
+                json_stream_feed(&c->scan, data + i, run);
+            }
+            i += run;
+            if (nl) {
+                sse_line_end(c);
+                i++;
+            }
+            continue;
+        }
+
+        char ch = data[i++];
+        if (ch == '\n') {
+            sse_line_end(c);
+        } else if (ch != SSE_DATA_PREFIX[c->sse_match]) {
+            c->sse_line = SSE_LINE_SKIP;
+        } else if (++c->sse_match == sizeof(SSE_DATA_PREFIX) - 1) {
+            // The piece lands right after the text so far ("[DONE]" finds nothing)
+            c->sse_line = SSE_LINE_DATA;
+            json_stream_init(&c->scan, reply_path(c->p), c->content + c->content_len,
+                             AI_CONTENT_MAX - c->content_len);
+        }
+    }
+}
+
+static esp_err_t http_event_handler(esp_http_client_event_t *evt)
+{
+    ai_call_t *c = (ai_call_t *)evt->user_data;
+    if (c == NULL) {
+        return ESP_OK;
+    }
+    switch (evt->event_id) {
+        case HTTP_EVENT_ON_HEADER:
+            if (c->on_worker) {
+                ai_rate_header(evt->header_key, evt->header_value);
+            }
+            break;
+        case HTTP_EVENT_ON_DATA:
+            if (c->head_len < AI_ERROR_HEAD - 1) {
+                int n = AI_ERROR_HEAD - 1 - c->head_len;
+                if (n > evt->data_len) {
+                    n = evt->data_len;
+                }
+                memcpy(c->head + c->head_len, evt->data, n);
+                c->head_len += n;
+                c->head[c->head_len] = '\0';
+            }
+            if (AI_STREAM) {
+                sse_feed(c, (const char *)evt->data, evt->data_len);
+            } else {
+                json_stream_feed(&c->scan, (const char *)evt->data, evt->data_len);
+            }
+            c->body_len += evt->data_len;
+            break;
+        default:
+            break;
+    }
+    return ESP_OK;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SESSIONS (KEPT-ALIVE CONNECTIONS FROM THE SHARED HTTP POOL)
+// ═══════════════════════════════════════════════════════════════════════════
+// http_pool.h keeps each provider's handles, headers and TLS connections
+// between queries and owns the idle-close, stale-connection retry and
+// backoff policy. A fresh handle gets the provider's headers here.
+
+static http_pool_conn_t *session_get(ai_provider_t *p)
+{
+    bool fresh;
+    http_pool_conn_t *conn = http_pool_acquire(p->host, p->def->url, HTTP_METHOD_POST, http_event_handler, &fresh);
+    if (conn == NULL || !fresh) {
+        return conn;
+    }
+    esp_http_client_handle_t client = http_pool_client(conn);
+    esp_http_client_set_header(client, "Content-Type", "application/json");
+    if (p->def->auth_header != NULL) {
+        char auth[256];
+        snprintf(auth, sizeof(auth), "%s%s", p->def->auth_prefix, p->def->key);
+        esp_http_client_set_header(client, p->def->auth_header, auth);
+    }
+    return conn;
+}
+
+/**
+ * @brief Before each attempt: forget a reply a dropped connection cut off
+ */
+static void call_attempt(void *arg)
+{
+    ai_call_t *c = (ai_call_t *)arg;
+    call_reset(c);
+    if (c->on_worker) {
+        ai_rate_begin_response();
+    }
+}
+
+/**
+ * @brief Append the latest snapshot as an image part (vision providers)
+ * @return false if there is none: nothing appended
+ */
+static bool put_image(const ai_provider_t *p, char *body, int *head, const char *pre, const char *post)
+{
+#if CONFIG_GOLDIE_SNAPSHOT_AI
+    size_t pre_len = strlen(pre);
+    size_t post_len = strlen(post);
+    if (!p->def->vision || *head < 0 || (size_t)*head + pre_len + SNAPSHOT_AI_B64_MAX + post_len > AI_BODY_MAX) {
+        return false;
+    }
+    size_t n = snapshot_ai_image(body + *head + pre_len, SNAPSHOT_AI_B64_MAX);
+    if (n == 0) {
+        return false;
+    }
+    memcpy(body + *head, pre, pre_len);
+    memcpy(body + *head + pre_len + n, post, post_len + 1);
+    *head += (int)(pre_len + n + post_len);
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Wrap the escaped prompt in the provider's request body
+ */
+static size_t build_body(const ai_provider_t *p, const char *prompt, size_t prompt_len, char *body)
+{
+    if (body == NULL) {
+        return 0;
+    }
+    int head;
+    const char *tail;
+    const char *close = "";
+    if (p->def->format == AI_FORMAT_GEMINI) {
+        head = snprintf(body, AI_BODY_MAX, "{\"contents\":[{\"role\":\"user\",\"parts\":[");
+        put_image(p, body, &head, "{\"inline_data\":{\"mime_type\":\"image/jpeg\",\"data\":\"", "\"}},");
+        head += snprintf(body + head, AI_BODY_MAX - head, "{\"text\":\"");
+        tail = "\"}]}],\"generationConfig\":{\"maxOutputTokens\":" AI_MAX_TOKENS
+               ",\"temperature\":" AI_TEMPERATURE ",\"responseMimeType\":\"application/json\"}}";
+    } else {
+        head = snprintf(body, AI_BODY_MAX, "{\"model\":\"%s\",\"messages\":[{\"role\":\"user\",\"content\":",
+                        p->def->model);
+        if (put_image(p, body, &head, "[{\"type\":\"image_url\",\"image_url\":{\"url\":\"data:image/jpeg;base64,",
+                      "\"}},{\"type\":\"text\",\"text\":\"")) {
+            close = "\"}]";      // Text part and content array, then the tail without its quote
+        } else {
+            head += snprintf(body + head, AI_BODY_MAX - head, "\"");
+        }
+        tail = AI_STREAM ? "\"}],\"max_tokens\":" AI_MAX_TOKENS ",\"temperature\":" AI_TEMPERATURE ",\"stream\":true}"
+                         : "\"}],\"max_tokens\":" AI_MAX_TOKENS ",\"temperature\":" AI_TEMPERATURE "}";
+        tail += close[0] != '\0' ? 1 : 0;
+    }
+    size_t close_len = strlen(close);
+    size_t tail_len = strlen(tail);
+    if (head < 0 || (size_t)head + prompt_len + close_len + tail_len >= AI_BODY_MAX) {
+        return 0;     // Cannot happen with AI_PROMPT_JSON_MAX
+    }
+    memcpy(body + head, prompt, prompt_len);
+    memcpy(body + head + prompt_len, close, close_len);
+    memcpy(body + head + prompt_len + close_len, tail, tail_len + 1);
+    return (size_t)head + prompt_len + close_len + tail_len;
+}
+
+static ai_err_class_t classify(esp_err_t err, int status)
+{
+    if (err != ESP_OK) {
+        return AI_ERR_NETWORK;
+    }
+    if (status == 429) {
+        return AI_ERR_RATE_LIMIT;
+    }
+    if (status == 401 || status == 403) {
+        return AI_ERR_AUTH;
+    }
+    if (status >= 500) {
+        return AI_ERR_SERVER;
+    }
+    return (status == 200) ? AI_ERR_REPLY : AI_ERR_CLIENT;
+}
+
+/**
+ * @brief Send one request to c->p and split the reply into c->reply (blocking)
+ */
+static void call_run(ai_call_t *c, const char *body, size_t body_len)
+{
+    ai_provider_t *p = c->p;
+    c->ok = false;
+    c->truncated = false;
+    c->status = 0;
+    c->err_class = AI_ERR_NETWORK;
+
+    http_pool_conn_t *conn = session_get(p);
+    if (conn == NULL || body_len == 0) {
+        if (conn != NULL) {
+            http_pool_release(conn);
+        }
+        health_update(p, false, 0);
+        c->done_us = esp_timer_get_time();
+        return;
+    }
+    http_pool_set_user_data(conn, c);
+    esp_http_client_set_post_field(http_pool_client(conn), body, body_len);
+
+    int64_t t0 = esp_timer_get_time();
+    esp_err_t err = http_pool_perform(conn, call_attempt, &c->status);
+    http_pool_release(conn);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "%s request: %d ms", p->def->name, (int)((esp_timer_get_time() - t0) / 1000));
+        if (c->status == 200) {
+            if (!AI_STREAM && json_stream_found(&c->scan)) {
+                c->content_len = c->scan.out_len;
+                c->content_truncated = c->scan.truncated;
+            }
+            c->truncated = c->content_truncated;
+            c->ok = fields_finish(c);
+        }
+        if (!c->ok) {
+            ESP_LOGE(TAG, "%s HTTP %d, %s: %s%s", p->def->name, c->status,
+                     c->status == 200 ? "no reply content" : "error", c->head,
+                     c->body_len > c->head_len ? "..." : "");
+        }
+    }
+    c->err_class = classify(err, c->status);
+    c->done_us = esp_timer_get_time();
+    health_update(p, c->ok, (c->done_us - t0) / 1000);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// HEDGE TASK
+// ═══════════════════════════════════════════════════════════════════════════
+// The AI worker arms a one-shot timer before asking the best provider. If
+// that request is still running when it fires, the timer hands the second
+// best to ai_hedge, which asks it into its own buffer. The worker owns the
+// decision: it takes whichever good reply finished first.
+
+enum {
+    HEDGE_IDLE = 0,
+    HEDGE_ARMED,           // Timer running, hedge not started
+    HEDGE_RUNNING,         // ai_hedge is in (or just finished) its request
+};
+
+static ai_call_t calls[2];                      // 0: AI worker, 1: ai_hedge
+static char *contents[2];                       // PSRAM, AI_CONTENT_MAX each (ai_provider_query)
+#if AI_IMAGE_MAX > 0
+static char *bodies[2];                         // PSRAM: room for an image (ai_provider_query)
+#else
+static char bodies[2][AI_BODY_MAX];
+#endif
+static char hedge_advice[TEXT_BUF_CAPACITY];
+static char hedge_summary[AI_SUMMARY_MAX];
+static size_t hedge_len = 0;
+static volatile uint32_t hedge_state = HEDGE_IDLE;
+static SemaphoreHandle_t hedge_go = NULL;
+static SemaphoreHandle_t hedge_done = NULL;
+static esp_timer_handle_t hedge_timer = NULL;
+static bool hedge_ready = false;
+
+static void hedge_timer_cb(void *arg)
+{
+    uint32_t expected = HEDGE_ARMED;
+    if (__atomic_compare_exchange_n(&hedge_state, &expected, HEDGE_RUNNING, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        xSemaphoreGive(hedge_go);
+    }
+}
+
+static void hedge_task(void *arg)
+{
+    while (true) {
+        xSemaphoreTake(hedge_go, portMAX_DELAY);
+        ai_call_t *c = &calls[1];
+        ESP_LOGI(TAG, "Primary slow - hedging with %s", c->p->def->name);
+        call_run(c, bodies[1], hedge_len);
+        c->p->busy = false;
+        __atomic_store_n(&hedge_state, HEDGE_IDLE, __ATOMIC_RELEASE);
+        xSemaphoreGive(hedge_done);
+    }
+}
+
+static bool hedge_start(void)
+{
+    if (hedge_ready) {
+        return true;
+    }
+    if (CONFIG_GOLDIE_AI_HEDGE_MS <= 0) {
+        return false;
+    }
+    if (hedge_go == NULL) {
+        hedge_go = xSemaphoreCreateBinary();
+        hedge_done = xSemaphoreCreateBinary();
+        esp_timer_create_args_t args = {};
+        args.callback = hedge_timer_cb;
+        args.name = "ai_hedge";
+        if (hedge_go == NULL || hedge_done == NULL || esp_timer_create(&args, &hedge_timer) != ESP_OK) {
+            ESP_LOGE(TAG, "No memory for hedging");
+            return false;
+        }
+    }
+    TaskHandle_t handle = NULL;
+    if (task_layout_create(TASK_ID_AI_HEDGE, hedge_task, NULL, &handle) != pdPASS) {
+        ESP_LOGW(TAG, "Hedge task not created - providers are tried in turn");
+        return false;
+    }
+    task_monitor_register(TASK_ID_AI_HEDGE, handle);
+    hedge_ready = true;
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// QUERY
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Usable providers, best score first
+ */
+static size_t rank(ai_provider_t **out)
+{
+    uint32_t now = time_svc_uptime_s();
+    size_t n = 0;
+    ai_provider_t *coolest = NULL;
+    portENTER_CRITICAL(&health_lock);
+    for (size_t i = 0; i < PROVIDER_COUNT; i++) {
+        ai_provider_t *p = &providers[i];
+        if (!p->enabled || p->busy) {
+            continue;
+        }
+        if (p->cool_until > now) {
+            if (coolest == NULL || p->cool_until < coolest->cool_until) {
+                coolest = p;
+            }
+            continue;
+        }
+        size_t j = n++;
+        while (j > 0 && score(out[j - 1]) > score(p)) {
+            out[j] = out[j - 1];
+            j--;
+        }
+        out[j] = p;
+    }
+    portEXIT_CRITICAL(&health_lock);
+    if (n == 0 && coolest != NULL) {
+        out[n++] = coolest;    // Everyone is cooling off: the one closest to ready
+    }
+    return n;
+}
+
+/**
+ * @brief Ask ranked[from..to) on the AI worker until one answers
+ */
+static bool ask_in_turn(ai_provider_t **ranked, size_t from, size_t to, const char *prompt_json,
+                        size_t prompt_len, const ai_reply_t *reply, ai_query_result_t *result)
+{
+    ai_call_t *w = &calls[0];
+    for (size_t i = from; i < to; i++) {
+        w->p = ranked[i];
+        w->reply = *reply;
+        w->content = contents[0];
+        w->on_worker = true;
+        w->abandoned = false;
+        w->p->busy = true;
+        call_run(w, bodies[0], build_body(w->p, prompt_json, prompt_len, bodies[0]));
+        w->p->busy = false;
+        result->provider = w->p->def->name;
+        result->status = w->status;
+        result->err_class = w->err_class;
+        result->truncated = w->truncated;
+        if (w->ok) {
+            return true;
+        }
+        if (i + 1 < to) {
+            ESP_LOGW(TAG, "%s failed - failing over to %s", w->p->def->name, ranked[i + 1]->def->name);
+        }
+    }
+    return false;
+}
+
+extern "C" bool ai_provider_query(const char *prompt_json, size_t prompt_len, const ai_reply_t *reply,
+                                  ai_query_result_t *result)
+{
+    table_init();
+    for (int i = 0; i < 2; i++) {
+#if AI_IMAGE_MAX > 0
+        if (bodies[i] == NULL) {
+            bodies[i] = (char *)heap_caps_malloc(AI_BODY_MAX, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        }
+#endif
+        if (contents[i] == NULL) {
+            contents[i] = (char *)heap_caps_malloc(AI_CONTENT_MAX, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        }
+    }
+    result->provider = NULL;
+    result->status = 0;
+    result->err_class = AI_ERR_NETWORK;
+    result->truncated = false;
+    for (int f = 0; f < AI_FIELD_COUNT; f++) {
+        if (reply->text[f] != NULL && reply->size[f] > 0) {
+            reply->text[f][0] = '\0';
+        }
+    }
+    if (contents[0] == NULL || contents[1] == NULL) {
+        ESP_LOGE(TAG, "Out of PSRAM for AI replies");
+        return false;
+    }
+
+    ai_provider_t *ranked[PROVIDER_COUNT];
+    size_t n = rank(ranked);
+    if (n == 0) {
+        ESP_LOGE(TAG, "No AI provider available");
+        return false;
+    }
+    partial_owner = NULL;
+
+    // Second best goes to ai_hedge if the best is slow (needs a free hedge)
+    bool hedged = n > 1 && hedge_state == HEDGE_IDLE && hedge_start();
+    if (hedged) {
+        xSemaphoreTake(hedge_done, 0);      // Drop a stale "done" of an abandoned hedge
+        ai_call_t *h = &calls[1];
+        h->p = ranked[1];
+        char *const own[AI_FIELD_COUNT] = { hedge_advice, hedge_summary };
+        const size_t own_size[AI_FIELD_COUNT] = { sizeof(hedge_advice), sizeof(hedge_summary) };
+        for (int f = 0; f < AI_FIELD_COUNT; f++) {
+            h->reply.text[f] = reply->text[f] != NULL ? own[f] : NULL;
+            h->reply.size[f] = reply->size[f] < own_size[f] ? reply->size[f] : own_size[f];
+        }
+        h->content = contents[1];
+        h->on_worker = false;
+        h->abandoned = false;
+        h->ok = false;
+        hedge_len = build_body(h->p, prompt_json, prompt_len, bodies[1]);
+        h->p->busy = true;
+        hedge_state = HEDGE_ARMED;
+        esp_timer_start_once(hedge_timer, (uint64_t)CONFIG_GOLDIE_AI_HEDGE_MS * 1000);
+    }
+
+    ai_call_t *w = &calls[0];
+    bool ok = ask_in_turn(ranked, 0, hedged ? 1 : n, prompt_json, prompt_len, reply, result);
+
+    if (hedged) {
+        uint32_t expected = HEDGE_ARMED;
+        if (__atomic_compare_exchange_n(&hedge_state, &expected, HEDGE_IDLE, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            // Answered (or failed) in time: the hedge never started
+            esp_timer_stop(hedge_timer);
+            calls[1].p->busy = false;
+            if (!ok) {
+                ok = ask_in_turn(ranked, 1, n, prompt_json, prompt_len, reply, result);
+            }
+        } else {
+            // Running or done: wait for it only if it can still help
+            ai_call_t *h = &calls[1];
+            bool finished = xSemaphoreTake(hedge_done, ok ? 0 : pdMS_TO_TICKS(2 * AI_TIMEOUT_MS)) == pdTRUE;
+            if (finished && h->ok && (!ok || h->done_us < w->done_us)) {
+                for (int f = 0; f < AI_FIELD_COUNT; f++) {
+                    if (reply->text[f] != NULL && reply->size[f] > 0) {
+                        memcpy(reply->text[f], h->reply.text[f], strlen(h->reply.text[f]) + 1);
+                    }
+                }
+                ok = true;
+                result->provider = h->p->def->name;
+                result->status = h->status;
+                result->truncated = h->truncated;
+                portENTER_CRITICAL(&health_lock);
+                h->p->hedge_wins++;
+                portEXIT_CRITICAL(&health_lock);
+                ESP_LOGI(TAG, "Hedge %s answered first", h->p->def->name);
+            } else if (!finished) {
+                h->abandoned = true;        // Finishes on its own and is dropped
+            }
+        }
+    }
+    if (!ok) {
+        ai_provider_log_health();
+    }
+    return ok;
+}
+
+extern "C" void ai_provider_set_partial_cb(ai_partial_cb_t cb, void *arg)
+{
+    partial_cb = cb;
+    partial_arg = arg;
+}
+
+extern "C" void ai_provider_log_health(void)
+{
+    uint32_t now = time_svc_uptime_s();
+    for (size_t i = 0; i < PROVIDER_COUNT; i++) {
+        const ai_provider_t *p = &providers[i];
+        if (!p->enabled) {
+            continue;
+        }
+        ESP_LOGI(TAG, "%-6s score %5.0f  latency %5.0f ms  errors %3.0f%%  ok %lu  fail %lu  hedge wins %lu%s",
+                 p->def->name, (double)score(p), (double)p->latency_ms, (double)(p->err_rate * 100.0f),
+                 (unsigned long)p->ok_count, (unsigned long)p->fail_count, (unsigned long)p->hedge_wins,
+                 p->cool_until > now ? "  (cooling off)" : "");
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef AI_PROVIDER_H
+#define AI_PROVIDER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+#include "ai_rate.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// AI backends behind one query call
+//
+// Each provider is a table row: a wire format (OpenAI chat completions or
+// Gemini generateContent), an endpoint, a model and how the key is sent.
+// Built in: Groq (GROQ_API_URL / GROQ_API_KEY), Gemini (GEMINI_API_KEY in
+// wifi_config.h, off without it) and a local OpenAI-compatible server on
+// the LAN (CONFIG_GOLDIE_AI_LOCAL_URL, e.g. llama.cpp or Ollama, off when
+// empty). Every provider keeps its own keep-alive HTTPS session. Providers
+// that take images (Gemini) also get the latest camera snapshot with the
+// prompt when CONFIG_GOLDIE_SNAPSHOT_AI is on (snapshot.h).
+//
+// Health: a rolling (EWMA) latency of successful requests and a rolling
+// error rate give each provider a score, lower is better:
+//   score = latency (AI_LATENCY_PRIOR_MS until measured) x (1 + 4 x errors)
+// A failing provider also cools off for a while (30 s doubling, 10 min at
+// most) and is skipped meanwhile.
+//
+// Routing: the best provider is asked on the AI worker. If it has not
+// answered after CONFIG_GOLDIE_AI_HEDGE_MS the second best is asked too,
+// from the "ai_hedge" task, and the first good reply wins (the other one
+// is left to finish and dropped). With hedging off (0) or one provider
+// the others are tried in turn after a failure.
+//
+// Replies: the prompt asks for one JSON object with a field per text the
+// device wants (AI_FIELD_*: the on-screen advice, a one-line summary for
+// Blynk), so one completion serves them all. The reply content is split
+// into the fields while it streams in, by a json_stream scan per field
+// over the same bytes; a partial shows the advice field so far. A model
+// that answers in plain text (or wraps the object in a ``` fence) still
+// works: plain text becomes the advice and the other fields stay empty.
+
+#ifndef CONFIG_GOLDIE_AI_HEDGE_MS
+#define CONFIG_GOLDIE_AI_HEDGE_MS 1500
+#endif
+#ifndef CONFIG_GOLDIE_AI_GEMINI_MODEL
+#define CONFIG_GOLDIE_AI_GEMINI_MODEL "gemini-2.0-flash"
+#endif
+#ifndef CONFIG_GOLDIE_AI_LOCAL_URL
+#define CONFIG_GOLDIE_AI_LOCAL_URL ""
+#endif
+#ifndef CONFIG_GOLDIE_AI_LOCAL_MODEL
+#define CONFIG_GOLDIE_AI_LOCAL_MODEL "llama3.2"
+#endif
+
+#define AI_PROMPT_JSON_MAX   2048   // Escaped prompt, without quotes
+#define AI_LATENCY_PRIOR_MS  2000   // Assumed for a provider not yet measured
+#define AI_SUMMARY_MAX       96     // One-line summary, terminator included
+
+// Reply fields, named by their JSON keys in ai_provider.cpp
+typedef enum {
+    AI_FIELD_ADVICE = 0,   // "advice": the on-screen text
+    AI_FIELD_SUMMARY,      // "summary": one line for BLYNK_PIN_AI_ADVICE
+    AI_FIELD_COUNT
+} ai_field_t;
+
+typedef struct {
+    char *text[AI_FIELD_COUNT];    // Receives each field (NUL-terminated), NULL = not wanted
+    size_t size[AI_FIELD_COUNT];
+} ai_reply_t;
+
+typedef enum {
+    AI_FORMAT_OPENAI = 0,  // POST {model, messages[]} -> choices[0].message
+    AI_FORMAT_GEMINI,      // POST {contents[]} -> candidates[0].content.parts[0]
+} ai_format_t;
+
+/**
+ * @brief Receives the reply so far (see gemini_partial_cb_t)
+ */
+typedef void (*ai_partial_cb_t)(const char *text, void *arg);
+
+typedef struct {
+    const char *provider;      // Who answered (or failed last), NULL = none tried
+    int status;                // HTTP status of that call, 0 = no response
+    ai_err_class_t err_class;  // Valid when the query failed
+    bool truncated;            // A field cut to its buffer
+} ai_query_result_t;
+
+/**
+ * @brief Ask the providers for a reply to an already JSON-escaped prompt
+ *
+ * Blocks the AI worker. Each wanted field of reply receives its text; a
+ * field the model left out is empty.
+ * @return true if a provider answered with advice
+ */
+bool ai_provider_query(const char *prompt_json, size_t prompt_len, const ai_reply_t *reply,
+                       ai_query_result_t *result);
+
+/**
+ * @brief Set the partial reply callback (streamed replies only)
+ */
+void ai_provider_set_partial_cb(ai_partial_cb_t cb, void *arg);
+
+/**
+ * @brief Log score, latency, error rate and counters per provider
+ */
+void ai_provider_log_health(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AI_PROVIDER_H
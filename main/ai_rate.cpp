@@ -0,0 +1,224 @@
+#include "ai_rate.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "time_svc.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static const char *TAG = "ai_rate";
+
+#define RATE_PERIOD_US      (3600LL * 1000000 / CONFIG_GOLDIE_AI_RATE_PER_HOUR)  // One token
+#define SERVER_DELAY_MAX_S  (24 * 3600)    // Sanity cap on header values
+
+static const char *const CLASS_NAMES[AI_ERR_CLASS_COUNT] = {
+    "network", "rate-limit", "auth", "client", "server", "reply",
+};
+
+static float tokens = CONFIG_GOLDIE_AI_RATE_BURST;
+static int64_t refill_us = 0;
+static uint32_t block_until = 0;      // Uptime seconds, no request before this
+static uint32_t fails = 0;            // Consecutive failures
+static uint32_t err_count[AI_ERR_CLASS_COUNT];
+static uint32_t sent = 0;
+static uint32_t refused = 0;
+
+// Headers of the latest response (-1 = not sent)
+static int32_t hdr_retry_after = -1;
+static int32_t hdr_remaining[2] = { -1, -1 };   // Requests, tokens
+static int32_t hdr_reset[2] = { -1, -1 };
+
+static uint32_t now_s(void)
+{
+    return time_svc_uptime_s();
+}
+
+static void refill(void)
+{
+    int64_t now = esp_timer_get_time();
+    if (refill_us == 0) {
+        refill_us = now;
+        return;
+    }
+    tokens += (float)(now - refill_us) / (float)RATE_PERIOD_US;
+    if (tokens > CONFIG_GOLDIE_AI_RATE_BURST) {
+        tokens = CONFIG_GOLDIE_AI_RATE_BURST;
+    }
+    refill_us = now;
+}
+
+static void block_for(uint32_t s, const char *why)
+{
+    uint32_t until = now_s() + s;
+    if (until > block_until) {
+        block_until = until;
+        ESP_LOGW(TAG, "Pausing AI requests for %lu s (%s)", (unsigned long)s, why);
+    }
+}
+
+/**
+ * @brief Seconds in a rate-limit duration: "7.66s", "2m59.56s", "1h2m", "120ms"
+ * @return -1 if it does not parse
+ */
+static int32_t parse_duration(const char *v)
+{
+    float total = 0.0f;
+    bool any = false;
+    while (*v != '\0') {
+        char *end;
+        float x = strtof(v, &end);
+        if (end == v) {
+            return -1;
+        }
+        v = end;
+        if (v[0] == 'h') {
+            total += x * 3600.0f;
+            v++;
+        } else if (v[0] == 'm' && v[1] == 's') {
+            total += x / 1000.0f;
+            v += 2;
+        } else if (v[0] == 'm') {
+            total += x * 60.0f;
+            v++;
+        } else if (v[0] == 's' || v[0] == '\0') {
+            total += x;               // Bare number: seconds (Retry-After)
+            v += (v[0] == 's');
+        } else {
+            return -1;
+        }
+        any = true;
+    }
+    if (!any || total < 0.0f) {
+        return -1;
+    }
+    if (total > SERVER_DELAY_MAX_S) {
+        total = SERVER_DELAY_MAX_S;
+    }
+    int32_t s = (int32_t)total;
+    return ((float)s < total) ? s + 1 : s;    // Round up: never early
+}
+
+/**
+ * @brief An exhausted request / token budget pauses until its reset
+ */
+static void apply_budget_headers(void)
+{
+    static const char *const what[2] = { "request budget used up", "token budget used up" };
+    for (int i = 0; i < 2; i++) {
+        if (hdr_remaining[i] == 0 && hdr_reset[i] > 0) {
+            block_for((uint32_t)hdr_reset[i], what[i]);
+        }
+    }
+}
+
+extern "C" bool ai_rate_acquire(uint32_t *wait_s)
+{
+    uint32_t now = now_s();
+    uint32_t wait = 0;
+    if (block_until > now) {
+        wait = block_until - now;
+    } else {
+        refill();
+        if (tokens < 1.0f) {
+            wait = (uint32_t)((1.0f - tokens) * (float)(RATE_PERIOD_US / 1000000)) + 1;
+        }
+    }
+    if (wait_s != NULL) {
+        *wait_s = wait;
+    }
+    if (wait > 0) {
+        refused++;
+        ESP_LOGW(TAG, "AI request held back - next one in %lu s", (unsigned long)wait);
+        return false;
+    }
+    tokens -= 1.0f;
+    sent++;
+    return true;
+}
+
+extern "C" bool ai_rate_spare(void)
+{
+    if (block_until > now_s()) {
+        return false;
+    }
+    refill();
+    return tokens >= 2.0f;
+}
+
+extern "C" void ai_rate_success(void)
+{
+    if (fails > 0) {
+        ESP_LOGI(TAG, "AI endpoint healthy again after %lu failure(s)", (unsigned long)fails);
+    }
+    fails = 0;
+    apply_budget_headers();
+}
+
+extern "C" void ai_rate_failure(ai_err_class_t cls, uint32_t retry_after_s)
+{
+    if (cls < AI_ERR_CLASS_COUNT) {
+        err_count[cls]++;
+    }
+    fails++;
+
+    // Exponential with up to 50% jitter off; a bad key will not fix itself
+    uint32_t delay = CONFIG_GOLDIE_AI_BACKOFF_MAX_S;
+    if (cls != AI_ERR_AUTH && fails <= 16) {
+        uint32_t exp = (uint32_t)AI_RATE_BACKOFF_BASE_S << (fails - 1);
+        if (exp < delay) {
+            delay = exp;
+        }
+    }
+    delay = delay - (uint32_t)(esp_random() % (delay / 2 + 1));
+
+    if (retry_after_s == 0 && hdr_retry_after > 0) {
+        retry_after_s = (uint32_t)hdr_retry_after;
+    }
+    if (retry_after_s > delay) {
+        delay = retry_after_s;
+    }
+    ESP_LOGW(TAG, "%s error (%lu in a row)", cls < AI_ERR_CLASS_COUNT ? CLASS_NAMES[cls] : "?",
+             (unsigned long)fails);
+    block_for(delay, retry_after_s == delay ? "server asked" : "backoff");
+    apply_budget_headers();
+}
+
+extern "C" void ai_rate_begin_response(void)
+{
+    hdr_retry_after = -1;
+    for (int i = 0; i < 2; i++) {
+        hdr_remaining[i] = -1;
+        hdr_reset[i] = -1;
+    }
+}
+
+extern "C" void ai_rate_header(const char *key, const char *value)
+{
+    if (key == NULL || value == NULL) {
+        return;
+    }
+    if (strcasecmp(key, "retry-after") == 0) {
+        hdr_retry_after = parse_duration(value);    // HTTP dates are ignored (-1)
+    } else if (strcasecmp(key, "x-ratelimit-remaining-requests") == 0) {
+        hdr_remaining[0] = atoi(value);
+    } else if (strcasecmp(key, "x-ratelimit-remaining-tokens") == 0) {
+        hdr_remaining[1] = atoi(value);
+    } else if (strcasecmp(key, "x-ratelimit-reset-requests") == 0) {
+        hdr_reset[0] = parse_duration(value);
+    } else if (strcasecmp(key, "x-ratelimit-reset-tokens") == 0) {
+        hdr_reset[1] = parse_duration(value);
+    }
+}
+
+extern "C" void ai_rate_log_stats(void)
+{
+    refill();
+    uint32_t now = now_s();
+    ESP_LOGI(TAG, "AI requests: %lu sent, %lu held back, %.1f tokens, paused for %lu s", (unsigned long)sent,
+             (unsigned long)refused, (double)tokens, (unsigned long)(block_until > now ? block_until - now : 0));
+    ESP_LOGI(TAG, "AI errors: network %lu, rate-limit %lu, auth %lu, client %lu, server %lu, reply %lu",
+             (unsigned long)err_count[AI_ERR_NETWORK], (unsigned long)err_count[AI_ERR_RATE_LIMIT],
+             (unsigned long)err_count[AI_ERR_AUTH], (unsigned long)err_count[AI_ERR_CLIENT],
+             (unsigned long)err_count[AI_ERR_SERVER], (unsigned long)err_count[AI_ERR_REPLY]);
+}
@@ -0,0 +1,90 @@
+#ifndef AI_RATE_H
+#define AI_RATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Request budget and backoff for the AI client
+//
+// Token bucket: CONFIG_GOLDIE_AI_RATE_BURST requests may go out back to
+// back, then one more per 3600 / CONFIG_GOLDIE_AI_RATE_PER_HOUR seconds.
+// Every failure (whatever its class) doubles a backoff window from
+// AI_RATE_BACKOFF_BASE_S up to CONFIG_GOLDIE_AI_BACKOFF_MAX_S, with random
+// jitter so a fleet does not retry in step; a success clears it. What the
+// server says wins when it asks for longer: Retry-After on 429 / 503 and
+// the x-ratelimit-remaining-* / x-ratelimit-reset-* headers (an exhausted
+// request or token budget pauses until its reset). Seconds since boot;
+// AI worker only.
+
+#ifndef CONFIG_GOLDIE_AI_RATE_PER_HOUR
+#define CONFIG_GOLDIE_AI_RATE_PER_HOUR 30
+#endif
+#ifndef CONFIG_GOLDIE_AI_RATE_BURST
+#define CONFIG_GOLDIE_AI_RATE_BURST 3
+#endif
+#ifndef CONFIG_GOLDIE_AI_BACKOFF_MAX_S
+#define CONFIG_GOLDIE_AI_BACKOFF_MAX_S 3600
+#endif
+
+#define AI_RATE_BACKOFF_BASE_S  15
+
+typedef enum {
+    AI_ERR_NETWORK = 0,    // Connect / TLS / timeout
+    AI_ERR_RATE_LIMIT,     // 429
+    AI_ERR_AUTH,           // 401 / 403
+    AI_ERR_CLIENT,         // Other 4xx
+    AI_ERR_SERVER,         // 5xx
+    AI_ERR_REPLY,          // 200 without usable content
+    AI_ERR_CLASS_COUNT
+} ai_err_class_t;
+
+/**
+ * @brief Take a token for one request
+ * @param wait_s Set when refused: seconds until a request may go out
+ * @return false if backing off or out of tokens (nothing is taken)
+ */
+bool ai_rate_acquire(uint32_t *wait_s);
+
+/**
+ * @brief A request could go out now and still leave a token for the next
+ *        one (speculative requests only take spare budget)
+ */
+bool ai_rate_spare(void);
+
+/**
+ * @brief The request produced a reply - backoff cleared
+ */
+void ai_rate_success(void);
+
+/**
+ * @brief The request failed - extend the backoff
+ * @param retry_after_s Delay the caller knows of, 0 = only the headers'
+ *        Retry-After
+ */
+void ai_rate_failure(ai_err_class_t cls, uint32_t retry_after_s);
+
+/**
+ * @brief Feed one response header (x-ratelimit-*, retry-after)
+ */
+void ai_rate_header(const char *key, const char *value);
+
+/**
+ * @brief Forget the previous response's headers (before each attempt)
+ */
+void ai_rate_begin_response(void);
+
+/**
+ * @brief Log tokens, backoff and the per-class error counters
+ */
+void ai_rate_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AI_RATE_H
@@ -0,0 +1,453 @@
+#include "asset_bundle.h"
+#include "io_sched.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "asset_bundle";
+
+#define ASSET_VERIFY_CHUNK  4096
+
+// The image is written by a host script - pin the layout
+static_assert(sizeof(asset_bundle_header_t) == 32, "asset_bundle_header_t layout changed - update make_asset_bundle.py");
+static_assert(sizeof(asset_entry_t) == 32, "asset_entry_t layout changed - update make_asset_bundle.py");
+
+typedef struct {
+    const asset_entry_t *entries;             // Mapped flash or heap, count entries
+    uint16_t count;
+    uint32_t generation;
+    const char *source;
+    const esp_partition_t *part;              // Partition bundle
+    const uint8_t *mapped;
+    esp_partition_mmap_handle_t map_handle;
+    int fd;                                   // File bundle, open for good
+} bundle_t;
+
+static bundle_t cur = { NULL, 0, 0, NULL, NULL, NULL, 0, -1 };
+static SemaphoreHandle_t fd_lock = NULL;      // Seek + read pairs on cur.fd
+static SemaphoreHandle_t slot_lock = NULL;    // Spare slot choice vs switch
+static const esp_partition_t *staged = NULL;  // Verified slot waiting for the switch
+
+static bool header_valid(const asset_bundle_header_t *hdr, size_t avail)
+{
+    size_t index_end = sizeof(*hdr) + (size_t)hdr->count * sizeof(asset_entry_t);
+    return hdr->magic == ASSET_BUNDLE_MAGIC && hdr->version == ASSET_BUNDLE_VERSION &&
+           hdr->size <= avail && index_end <= hdr->size;
+}
+
+/**
+ * @brief Index CRC and every entry inside the bundle
+ */
+static bool index_valid(const asset_bundle_header_t *hdr, const asset_entry_t *e)
+{
+    if (esp_rom_crc32_le(0, (const uint8_t *)e, hdr->count * sizeof(asset_entry_t)) != hdr->index_crc) {
+        ESP_LOGE(TAG, "Index CRC mismatch");
+        return false;
+    }
+    for (uint16_t i = 0; i < hdr->count; i++) {
+        if (e[i].size > 0 && (e[i].offset > hdr->size || e[i].size > hdr->size - e[i].offset)) {
+            ESP_LOGE(TAG, "Asset %u (%.*s) outside the bundle", i, ASSET_NAME_LEN, e[i].name);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool slot_header(const esp_partition_t *part, asset_bundle_header_t *hdr)
+{
+    return part != NULL && esp_partition_read(part, 0, hdr, sizeof(*hdr)) == ESP_OK &&
+           header_valid(hdr, part->size);
+}
+
+static bool open_partition(const esp_partition_t *part, bundle_t *b)
+{
+    asset_bundle_header_t hdr;
+    if (!slot_header(part, &hdr)) {
+        return false;
+    }
+    const void *ptr = NULL;
+    esp_partition_mmap_handle_t handle;
+    esp_err_t err = esp_partition_mmap(part, 0, hdr.size, ESP_PARTITION_MMAP_DATA, &ptr, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Partition bundle not mapped: %s", esp_err_to_name(err));
+        return false;
+    }
+    const asset_entry_t *e = (const asset_entry_t *)((const uint8_t *)ptr + sizeof(hdr));
+    if (!index_valid(&hdr, e)) {
+        esp_partition_munmap(handle);
+        return false;
+    }
+    *b = { e, hdr.count, hdr.generation, part->label, part, (const uint8_t *)ptr, handle, -1 };
+    return true;
+}
+
+static const esp_partition_t *find_slot(const char *label)
+{
+    return esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+}
+
+/**
+ * @brief The A/B slots, newest generation first; falls back to the other
+ *        slot, then the single "assets" partition
+ */
+static bool init_partition(void)
+{
+    const esp_partition_t *a = find_slot(ASSET_BUNDLE_SLOT_A);
+    const esp_partition_t *b = find_slot(ASSET_BUNDLE_SLOT_B);
+    asset_bundle_header_t ha, hb;
+    bool va = slot_header(a, &ha);
+    bool vb = slot_header(b, &hb);
+    if (vb && (!va || hb.generation > ha.generation)) {
+        const esp_partition_t *t = a;
+        a = b;
+        b = t;
+        va = true;
+    }
+    return (va && open_partition(a, &cur)) || open_partition(b, &cur) ||
+           open_partition(find_slot(ASSET_BUNDLE_PARTITION), &cur);
+}
+
+static bool read_all(int fd, void *dst, size_t len)
+{
+    uint8_t *p = (uint8_t *)dst;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static bool init_file(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    asset_bundle_header_t hdr;
+    off_t file_size = lseek(fd, 0, SEEK_END);
+    asset_entry_t *e = NULL;
+    bool ok = file_size > 0 && lseek(fd, 0, SEEK_SET) == 0 && read_all(fd, &hdr, sizeof(hdr)) &&
+              header_valid(&hdr, (size_t)file_size);
+    if (ok) {
+        e = (asset_entry_t *)malloc((size_t)hdr.count * sizeof(asset_entry_t));
+        ok = e != NULL && read_all(fd, e, (size_t)hdr.count * sizeof(asset_entry_t)) && index_valid(&hdr, e);
+    }
+    if (ok && fd_lock == NULL) {
+        fd_lock = xSemaphoreCreateMutex();
+        ok = fd_lock != NULL;
+    }
+    if (!ok) {
+        ESP_LOGW(TAG, "%s is not a valid bundle", path);
+        free(e);
+        close(fd);
+        return false;
+    }
+    cur = { e, hdr.count, hdr.generation, path, NULL, NULL, 0, fd };
+    return true;
+}
+
+static void log_bundle(const char *what)
+{
+    uint16_t present = 0;
+    for (uint16_t i = 0; i < cur.count; i++) {
+        present += cur.entries[i].size > 0;
+    }
+    ESP_LOGI(TAG, "%s from %s (generation %lu): %u of %u assets", what, cur.source,
+             (unsigned long)cur.generation, present, cur.count);
+}
+
+extern "C" bool asset_bundle_init(void)
+{
+    if (slot_lock == NULL) {
+        slot_lock = xSemaphoreCreateMutex();
+    }
+    if (cur.source != NULL) {
+        return true;
+    }
+    if (!init_partition() && !init_file(ASSET_BUNDLE_FS_PATH) && !init_file(ASSET_BUNDLE_SD_PATH)) {
+        ESP_LOGI(TAG, "No asset bundle - assets load as separate files");
+        return false;
+    }
+    log_bundle("Asset bundle");
+    return true;
+}
+
+extern "C" const char *asset_bundle_source(void)
+{
+    return cur.source;
+}
+
+extern "C" uint32_t asset_bundle_generation(void)
+{
+    return cur.generation;
+}
+
+extern "C" const asset_entry_t *asset_bundle_entry(asset_id_t id)
+{
+    if (cur.entries == NULL || (unsigned)id >= cur.count || cur.entries[id].size == 0) {
+        return NULL;
+    }
+    return &cur.entries[id];
+}
+
+extern "C" const uint8_t *asset_bundle_map(asset_id_t id)
+{
+    const asset_entry_t *e = asset_bundle_entry(id);
+    return (e != NULL && cur.mapped != NULL) ? cur.mapped + e->offset : NULL;
+}
+
+/**
+ * @brief Read from the bundle file at an absolute offset
+ */
+static esp_err_t file_read_at(uint32_t offset, void *dst, size_t len)
+{
+    xSemaphoreTake(fd_lock, portMAX_DELAY);
+    bool ok = lseek(cur.fd, (off_t)offset, SEEK_SET) == (off_t)offset && read_all(cur.fd, dst, len);
+    xSemaphoreGive(fd_lock);
+    return ok ? ESP_OK : ESP_FAIL;
+}
+
+extern "C" esp_err_t asset_bundle_read(asset_id_t id, size_t offset, void *dst, size_t len)
+{
+    const asset_entry_t *e = asset_bundle_entry(id);
+    if (e == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (offset > e->size || len > e->size - offset) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (cur.mapped != NULL) {
+        memcpy(dst, cur.mapped + e->offset + offset, len);
+        return ESP_OK;
+    }
+    return file_read_at(e->offset + (uint32_t)offset, dst, len);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// STDIO VIEW OF ONE ASSET (frame_codec reads FILE *)
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    uint32_t base;
+    uint32_t size;
+    uint32_t pos;
+} asset_view_t;
+
+static ssize_t view_read(void *cookie, char *buf, size_t n)
+{
+    asset_view_t *v = (asset_view_t *)cookie;
+    if (v->pos >= v->size) {
+        return 0;
+    }
+    if (n > v->size - v->pos) {
+        n = v->size - v->pos;
+    }
+    if (file_read_at(v->base + v->pos, buf, n) != ESP_OK) {
+        return -1;
+    }
+    v->pos += n;
+    return (ssize_t)n;
+}
+
+static int view_seek(void *cookie, _off64_t *off, int whence)
+{
+    asset_view_t *v = (asset_view_t *)cookie;
+    _off64_t to = *off;
+    if (whence == SEEK_CUR) {
+        to += v->pos;
+    } else if (whence == SEEK_END) {
+        to += v->size;
+    }
+    if (to < 0 || to > v->size) {
+        return -1;
+    }
+    v->pos = (uint32_t)to;
+    *off = to;
+    return 0;
+}
+
+static int view_close(void *cookie)
+{
+    free(cookie);
+    return 0;
+}
+
+extern "C" FILE *asset_bundle_open(asset_id_t id)
+{
+    const asset_entry_t *e = asset_bundle_entry(id);
+    if (e == NULL) {
+        return NULL;
+    }
+    if (cur.mapped != NULL) {
+        return fmemopen((void *)(cur.mapped + e->offset), e->size, "rb");
+    }
+    asset_view_t *v = (asset_view_t *)malloc(sizeof(*v));
+    if (v == NULL) {
+        return NULL;
+    }
+    *v = { e->offset, e->size, 0 };
+    cookie_io_functions_t fns = { view_read, NULL, view_seek, view_close };
+    FILE *f = fopencookie(v, "rb", fns);
+    if (f == NULL) {
+        free(v);
+        return NULL;
+    }
+    setvbuf(f, NULL, _IONBF, 0);
+    return f;
+}
+
+extern "C" bool asset_bundle_verify(asset_id_t id)
+{
+    const asset_entry_t *e = asset_bundle_entry(id);
+    if (e == NULL) {
+        return false;
+    }
+    uint32_t crc = 0;
+    if (cur.mapped != NULL) {
+        crc = esp_rom_crc32_le(0, cur.mapped + e->offset, e->size);
+    } else {
+        uint8_t *buf = (uint8_t *)malloc(ASSET_VERIFY_CHUNK);
+        if (buf == NULL) {
+            return false;
+        }
+        for (uint32_t done = 0; done < e->size; ) {
+            uint32_t n = e->size - done < ASSET_VERIFY_CHUNK ? e->size - done : ASSET_VERIFY_CHUNK;
+            if (file_read_at(e->offset + done, buf, n) != ESP_OK) {
+                free(buf);
+                return false;
+            }
+            crc = esp_rom_crc32_le(crc, buf, n);
+            done += n;
+        }
+        free(buf);
+    }
+    if (crc != e->crc) {
+        ESP_LOGE(TAG, "Asset %d (%.*s) CRC mismatch", (int)id, ASSET_NAME_LEN, e->name);
+        return false;
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// A/B SLOTS (asset_ota.h writes the spare one)
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" const esp_partition_t *asset_bundle_spare_slot(void)
+{
+    const esp_partition_t *a = find_slot(ASSET_BUNDLE_SLOT_A);
+    const esp_partition_t *b = find_slot(ASSET_BUNDLE_SLOT_B);
+    if (a == NULL || b == NULL || slot_lock == NULL) {
+        return NULL;
+    }
+    xSemaphoreTake(slot_lock, portMAX_DELAY);
+    // About to be overwritten: a staged, not yet switched image is gone
+    __atomic_store_n(&staged, (const esp_partition_t *)NULL, __ATOMIC_RELEASE);
+    const esp_partition_t *spare = (cur.part == a) ? b : a;
+    xSemaphoreGive(slot_lock);
+    return spare;
+}
+
+/**
+ * @brief CRC of len bytes of a partition from offset, read in chunks
+ */
+static bool slot_crc(const esp_partition_t *part, uint32_t offset, uint32_t len, uint8_t *buf, uint32_t *crc)
+{
+    *crc = 0;
+    for (uint32_t done = 0; done < len; ) {
+        uint32_t n = len - done < ASSET_VERIFY_CHUNK ? len - done : ASSET_VERIFY_CHUNK;
+        // A chunk per maintenance slot: frame loads from flash go in between
+        io_sched_begin(IO_SCHED_FLASH, IO_SCHED_BACKGROUND, portMAX_DELAY);
+        esp_err_t err = esp_partition_read(part, offset + done, buf, n);
+        io_sched_end(IO_SCHED_FLASH, IO_SCHED_BACKGROUND);
+        if (err != ESP_OK) {
+            return false;
+        }
+        *crc = esp_rom_crc32_le(*crc, buf, n);
+        done += n;
+    }
+    return true;
+}
+
+extern "C" esp_err_t asset_bundle_commit_slot(const esp_partition_t *slot, const asset_bundle_header_t *hdr)
+{
+    if (!header_valid(hdr, slot->size)) {
+        ESP_LOGE(TAG, "Downloaded image has no valid bundle header");
+        return ESP_ERR_INVALID_VERSION;
+    }
+    size_t index_len = (size_t)hdr->count * sizeof(asset_entry_t);
+    asset_entry_t *e = (asset_entry_t *)malloc(index_len);
+    uint8_t *buf = (uint8_t *)malloc(ASSET_VERIFY_CHUNK);
+    esp_err_t err = (e == NULL || buf == NULL) ? ESP_ERR_NO_MEM : ESP_OK;
+    if (err == ESP_OK && (esp_partition_read(slot, sizeof(*hdr), e, index_len) != ESP_OK || !index_valid(hdr, e))) {
+        err = ESP_ERR_INVALID_CRC;
+    }
+    // Read back from flash: checks the write as well as the download
+    for (uint16_t i = 0; err == ESP_OK && i < hdr->count; i++) {
+        uint32_t crc;
+        if (e[i].size == 0) {
+            continue;
+        }
+        if (!slot_crc(slot, e[i].offset, e[i].size, buf, &crc) || crc != e[i].crc) {
+            ESP_LOGE(TAG, "Asset %u (%.*s) CRC mismatch in %s", i, ASSET_NAME_LEN, e[i].name, slot->label);
+            err = ESP_ERR_INVALID_CRC;
+        }
+        taskYIELD();
+    }
+    free(buf);
+    free(e);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // The header goes last: until it is written the slot does not count as
+    // a bundle, so a download cut short never boots
+    asset_bundle_header_t stamped = *hdr;
+    stamped.generation = cur.generation + 1;
+    io_sched_begin(IO_SCHED_FLASH, IO_SCHED_BACKGROUND, portMAX_DELAY);
+    err = esp_partition_write(slot, 0, &stamped, sizeof(stamped));
+    io_sched_end(IO_SCHED_FLASH, IO_SCHED_BACKGROUND);
+    if (err != ESP_OK) {
+        return err;
+    }
+    __atomic_store_n(&staged, slot, __ATOMIC_RELEASE);
+    ESP_LOGI(TAG, "%s verified: generation %lu, %u assets, %lu bytes - switching at the next mood change",
+             slot->label, (unsigned long)stamped.generation, stamped.count, (unsigned long)stamped.size);
+    return ESP_OK;
+}
+
+extern "C" bool asset_bundle_switch_staged(void)
+{
+    if (__atomic_load_n(&staged, __ATOMIC_ACQUIRE) == NULL) {
+        return false;
+    }
+    xSemaphoreTake(slot_lock, portMAX_DELAY);
+    const esp_partition_t *slot = __atomic_exchange_n(&staged, (const esp_partition_t *)NULL, __ATOMIC_ACQ_REL);
+    bundle_t next;
+    bool ok = slot != NULL && open_partition(slot, &next);
+    if (ok) {
+        if (cur.mapped != NULL) {
+            esp_partition_munmap(cur.map_handle);
+        } else if (cur.fd >= 0) {
+            close(cur.fd);
+            free((void *)cur.entries);
+        }
+        cur = next;
+    }
+    xSemaphoreGive(slot_lock);
+    if (slot != NULL && !ok) {
+        ESP_LOGE(TAG, "Staged %s no longer valid - staying on %s", slot->label, cur.source ? cur.source : "files");
+    }
+    if (ok) {
+        log_bundle("Switched asset bundle");
+    }
+    return ok;
+}
@@ -0,0 +1,161 @@
+#ifndef ASSET_BUNDLE_H
+#define ASSET_BUNDLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "esp_err.h"
+#include "esp_partition.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Asset bundle - every frame (and later the splash, sounds and fonts) in
+// one image with an index at the front, built by tools/make_asset_bundle.py:
+//
+//   asset_bundle_header_t         32 bytes
+//   asset_entry_t[count]          32 bytes each, entry i = asset id i
+//   data                          each asset ASSET_BUNDLE_ALIGN aligned
+//
+// asset_bundle_init() looks for it once at boot, in this order: the A/B
+// slots "assets_a" / "assets_b" (partitions_assets.csv; the valid one with
+// the higher generation), a single data partition labelled "assets" -
+// partitions are mapped, so assets are pointers into flash - then
+// ASSET_BUNDLE_FS_PATH on the storage partition, then ASSET_BUNDLE_SD_PATH. The index is read and CRC-checked there and stays
+// in RAM; a lookup is an array index, and opening an asset is a seek in
+// the one bundle file held open - no per-asset path for SPIFFS to scan its
+// object table for. Asset CRCs are checked on request (asset_bundle_verify).
+//
+// New packs arrive in the spare slot (asset_ota.h) and are checked and
+// staged by asset_bundle_commit_slot(); storage_task switches to them with
+// asset_bundle_switch_staged() between two frame loads. Entry and map
+// pointers stay valid until that switch, so assets are only read on
+// storage_task (the other tasks read through it).
+
+#define ASSET_BUNDLE_MAGIC          0x54534147u   // "GAST"
+#define ASSET_BUNDLE_VERSION        1
+#define ASSET_BUNDLE_PARTITION      "assets"
+#define ASSET_BUNDLE_SLOT_A         "assets_a"
+#define ASSET_BUNDLE_SLOT_B         "assets_b"
+#define ASSET_BUNDLE_FS_PATH        "/spiffs/assets.bin"
+#define ASSET_BUNDLE_SD_PATH        "/sdcard/assets.bin"
+#define ASSET_BUNDLE_ALIGN          4
+#define ASSET_NAME_LEN              16
+
+// Asset ids are index positions: the tool and this list must agree
+typedef enum {
+    ASSET_FRAME_FIRST = 0,              // Animation frames 1-24 (any frame_codec format)
+    ASSET_FRAME_LAST = 23,
+    ASSET_SPLASH,                       // Boot splash (reserved)
+    ASSET_SOUND_AMMONIA,                // Alert sounds, PCM (reserved)
+    ASSET_SOUND_NITRITE,
+    ASSET_FONT_MAIN,                    // LVGL binary font (reserved)
+    ASSET_ID_COUNT
+} asset_id_t;
+
+typedef enum {
+    ASSET_TYPE_NONE = 0,                // Not in this bundle
+    ASSET_TYPE_FRAME,                   // format: FRAME_ENCODING_*, ASSET_FORMAT_LEGACY
+    ASSET_TYPE_IMAGE,
+    ASSET_TYPE_PCM,                     // format: 0 = 16-bit mono at the codec rate
+    ASSET_TYPE_FONT,
+    ASSET_TYPE_BLOB,
+} asset_type_t;
+
+#define ASSET_FORMAT_LEGACY         0xFF          // Frame without a GFRM header
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint8_t  version;
+    uint8_t  reserved0;
+    uint16_t count;                     // Index entries
+    uint32_t index_crc;                 // esp_rom_crc32_le(0, ...) of the entries
+    uint32_t size;                      // Whole bundle, header included
+    uint32_t generation;                // A/B slots: the higher one is current
+    uint8_t  reserved[12];
+} asset_bundle_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t offset;                    // From the start of the bundle
+    uint32_t size;                      // 0 = not in this bundle
+    uint8_t  type;                      // asset_type_t
+    uint8_t  format;                    // Per type, see asset_type_t
+    uint16_t flags;
+    uint32_t crc;                       // esp_rom_crc32_le(0, ...) of the data
+    char     name[ASSET_NAME_LEN];      // Source file name, for logs
+} asset_entry_t;
+
+/**
+ * @brief Find the bundle and load its index (once, at boot)
+ * @return true if a valid bundle was found
+ */
+bool asset_bundle_init(void);
+
+/**
+ * @brief Where the bundle came from ("partition" or its path), NULL if none
+ */
+const char *asset_bundle_source(void);
+
+/**
+ * @brief Generation of the current bundle (0 until a download stamped one)
+ */
+uint32_t asset_bundle_generation(void);
+
+/**
+ * @brief Index entry of an asset
+ * @return NULL if there is no bundle or the asset is not in it
+ */
+const asset_entry_t *asset_bundle_entry(asset_id_t id);
+
+/**
+ * @brief The asset in mapped flash (partition bundles only), else NULL
+ */
+const uint8_t *asset_bundle_map(asset_id_t id);
+
+/**
+ * @brief Copy len bytes of an asset from offset
+ */
+esp_err_t asset_bundle_read(asset_id_t id, size_t offset, void *dst, size_t len);
+
+/**
+ * @brief Read-only stdio view of one asset: offset 0 is the asset's first
+ *        byte, EOF its last. Unbuffered, so reads land in the caller's
+ *        buffer; close with fclose()
+ */
+FILE *asset_bundle_open(asset_id_t id);
+
+/**
+ * @brief Check an asset's data against its index CRC (reads the whole asset)
+ */
+bool asset_bundle_verify(asset_id_t id);
+
+/**
+ * @brief The A/B slot not holding the current bundle, to write a new pack to
+ *
+ * Unstages a pack staged there but not switched to yet.
+ * @return NULL without both slots in the partition table
+ */
+const esp_partition_t *asset_bundle_spare_slot(void);
+
+/**
+ * @brief Check a pack written to the spare slot without its header, then
+ *        write the header with the next generation and stage the slot
+ * @param hdr The pack's header as downloaded
+ * @return ESP_OK once staged; ESP_ERR_INVALID_CRC if the index or an asset
+ *         does not match
+ */
+esp_err_t asset_bundle_commit_slot(const esp_partition_t *slot, const asset_bundle_header_t *hdr);
+
+/**
+ * @brief Switch to the staged slot, if any (storage_task, between loads)
+ * @return true if the bundle changed: cached frames are stale
+ */
+bool asset_bundle_switch_staged(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASSET_BUNDLE_H
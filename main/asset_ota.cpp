@@ -0,0 +1,191 @@
+#include "asset_ota.h"
+#include "asset_bundle.h"
+#include "task_layout.h"
+#include "io_sched.h"
+#include "esp_http_client.h"
+#include "esp_crt_bundle.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+static const char *TAG = "asset_ota";
+
+static bool busy = false;
+static char url_buf[ASSET_OTA_URL_MAX];       // Owned by the task while busy
+static const esp_partition_t *target = NULL;
+static asset_ota_status_t status = { ASSET_OTA_IDLE, 0, -1, ESP_OK };
+
+static void set_state(asset_ota_state_t state)
+{
+    __atomic_store_n(&status.state, state, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Write len bytes at offset, erasing the sectors it reaches first
+ *
+ * Each erase and the write are maintenance slots of their own (io_sched.h):
+ * an erase stalls every flash read, so they stay clear of frame loads.
+ */
+static esp_err_t slot_write(uint32_t offset, const uint8_t *src, size_t len, uint32_t *erased)
+{
+    while (*erased < offset + len) {
+        io_sched_begin(IO_SCHED_FLASH, IO_SCHED_BACKGROUND, portMAX_DELAY);
+        esp_err_t err = esp_partition_erase_range(target, *erased, ASSET_OTA_ERASE_SECTOR);
+        io_sched_end(IO_SCHED_FLASH, IO_SCHED_BACKGROUND);
+        if (err != ESP_OK) {
+            return err;
+        }
+        *erased += ASSET_OTA_ERASE_SECTOR;
+        vTaskDelay(1);                          // The UI runs between flash operations
+    }
+    io_sched_begin(IO_SCHED_FLASH, IO_SCHED_BACKGROUND, portMAX_DELAY);
+    esp_err_t err = esp_partition_write(target, offset, src, len);
+    io_sched_end(IO_SCHED_FLASH, IO_SCHED_BACKGROUND);
+    return err;
+}
+
+/**
+ * @brief Stream the reply body into the slot, all but the header
+ */
+static esp_err_t download(esp_http_client_handle_t client, uint8_t *buf, asset_bundle_header_t *hdr)
+{
+    esp_err_t err = esp_http_client_open(client, 0);
+    if (err != ESP_OK) {
+        return err;
+    }
+    int64_t length = esp_http_client_fetch_headers(client);
+    int code = esp_http_client_get_status_code(client);
+    if (code != 200) {
+        ESP_LOGE(TAG, "HTTP %d", code);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    if (length > (int64_t)target->size) {
+        ESP_LOGE(TAG, "Pack of %lld bytes does not fit %s (%lu bytes)", length, target->label,
+                 (unsigned long)target->size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    __atomic_store_n(&status.total, length > 0 ? (int32_t)length : -1, __ATOMIC_RELAXED);
+
+    uint32_t got = 0;
+    uint32_t erased = 0;
+    while (true) {
+        int n = esp_http_client_read(client, (char *)buf, ASSET_OTA_CHUNK);
+        if (n < 0) {
+            return ESP_FAIL;
+        }
+        if (n == 0) {
+            if (!esp_http_client_is_complete_data_received(client)) {
+                ESP_LOGE(TAG, "Connection ended after %lu bytes", (unsigned long)got);
+                return ESP_ERR_TIMEOUT;
+            }
+            break;
+        }
+        const uint8_t *p = buf;
+        size_t len = (size_t)n;
+        if (got < sizeof(*hdr)) {
+            size_t take = len < sizeof(*hdr) - got ? len : sizeof(*hdr) - got;
+            memcpy((uint8_t *)hdr + got, p, take);
+            p += take;
+            len -= take;
+            got += take;
+        }
+        if (len > 0) {
+            if (got + len > target->size) {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            err = slot_write(got, p, len, &erased);
+            if (err != ESP_OK) {
+                return err;
+            }
+            got += len;
+        }
+        __atomic_store_n(&status.received, got, __ATOMIC_RELAXED);
+    }
+    if (got < sizeof(*hdr) || hdr->size != got) {
+        ESP_LOGE(TAG, "Got %lu bytes, the pack header says %lu", (unsigned long)got,
+                 (unsigned long)(got < sizeof(*hdr) ? 0 : hdr->size));
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return ESP_OK;
+}
+
+static void ota_task(void *arg)
+{
+    ESP_LOGI(TAG, "Downloading %s into %s", url_buf, target->label);
+    esp_http_client_config_t config = {};
+    config.url = url_buf;
+    config.timeout_ms = ASSET_OTA_TIMEOUT_MS;
+    if (strncmp(url_buf, "https:", 6) == 0) {
+        config.crt_bundle_attach = esp_crt_bundle_attach;
+    }
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    uint8_t *buf = (uint8_t *)heap_caps_malloc(ASSET_OTA_CHUNK, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    asset_bundle_header_t hdr;
+
+    esp_err_t err = (client == NULL || buf == NULL) ? ESP_ERR_NO_MEM : download(client, buf, &hdr);
+    heap_caps_free(buf);
+    if (client != NULL) {
+        esp_http_client_cleanup(client);
+    }
+    if (err == ESP_OK) {
+        set_state(ASSET_OTA_VERIFYING);
+        err = asset_bundle_commit_slot(target, &hdr);
+    }
+
+    __atomic_store_n(&status.error, err, __ATOMIC_RELAXED);
+    set_state(err == ESP_OK ? ASSET_OTA_STAGED : ASSET_OTA_FAILED);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Pack download failed (%s) - keeping the current assets", esp_err_to_name(err));
+    }
+    __atomic_store_n(&busy, false, __ATOMIC_RELEASE);
+    vTaskDelete(NULL);
+}
+
+extern "C" esp_err_t asset_ota_start(const char *url)
+{
+    if (url == NULL || strlen(url) >= sizeof(url_buf)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (__atomic_exchange_n(&busy, true, __ATOMIC_ACQ_REL)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    target = asset_bundle_spare_slot();
+    if (target == NULL) {
+        __atomic_store_n(&busy, false, __ATOMIC_RELEASE);
+        return ESP_ERR_NOT_FOUND;
+    }
+    strcpy(url_buf, url);
+    __atomic_store_n(&status.received, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&status.total, -1, __ATOMIC_RELAXED);
+    __atomic_store_n(&status.error, ESP_OK, __ATOMIC_RELAXED);
+    set_state(ASSET_OTA_DOWNLOADING);
+    if (task_layout_create(TASK_ID_ASSET_OTA, ota_task, NULL, NULL) != pdPASS) {
+        set_state(ASSET_OTA_FAILED);
+        __atomic_store_n(&status.error, ESP_ERR_NO_MEM, __ATOMIC_RELAXED);
+        __atomic_store_n(&busy, false, __ATOMIC_RELEASE);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+extern "C" void asset_ota_get_status(asset_ota_status_t *out)
+{
+    out->state = __atomic_load_n(&status.state, __ATOMIC_ACQUIRE);
+    out->received = __atomic_load_n(&status.received, __ATOMIC_RELAXED);
+    out->total = __atomic_load_n(&status.total, __ATOMIC_RELAXED);
+    out->error = __atomic_load_n(&status.error, __ATOMIC_RELAXED);
+}
+
+extern "C" const char *asset_ota_state_name(asset_ota_state_t state)
+{
+    switch (state) {
+        case ASSET_OTA_IDLE:        return "idle";
+        case ASSET_OTA_DOWNLOADING: return "downloading";
+        case ASSET_OTA_VERIFYING:   return "verifying";
+        case ASSET_OTA_STAGED:      return "staged";
+        case ASSET_OTA_FAILED:      return "failed";
+    }
+    return "?";
+}
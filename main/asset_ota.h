@@ -0,0 +1,68 @@
+#ifndef ASSET_OTA_H
+#define ASSET_OTA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Asset pack download - a new bundle (tools/make_asset_bundle.py) over HTTP
+// into the spare A/B slot (asset_bundle.h), without a reflash or a reboot
+//
+// One task (TASK_ID_ASSET_OTA, below LVGL) per download. The reply body is
+// read ASSET_OTA_CHUNK bytes at a time and written straight to flash; the
+// slot is erased one sector ahead of the data with a yield after every
+// erase, so no flash operation runs long and nothing buffers the pack.
+// The pack's header is held back: asset_bundle_commit_slot() reads the
+// slot back, checks the index CRC and every asset CRC, and only then
+// writes the header with the next generation and stages the slot.
+// storage_task switches to it at the next mood change (asset_bundle_
+// switch_staged); a download that fails or is cut short leaves the slot
+// without a header, and the current pack stays in use - also after a
+// reboot.
+
+#define ASSET_OTA_URL_MAX       256
+#define ASSET_OTA_CHUNK         4096    // Read size, internal RAM
+#define ASSET_OTA_TIMEOUT_MS    15000   // Socket timeout per read
+#define ASSET_OTA_ERASE_SECTOR  4096
+
+typedef enum {
+    ASSET_OTA_IDLE = 0,
+    ASSET_OTA_DOWNLOADING,
+    ASSET_OTA_VERIFYING,
+    ASSET_OTA_STAGED,                   // Verified, waiting for a mood change
+    ASSET_OTA_FAILED,
+} asset_ota_state_t;
+
+typedef struct {
+    asset_ota_state_t state;
+    uint32_t received;                  // Bytes of the current / last download
+    int32_t total;                      // Content-Length, -1 if not sent
+    esp_err_t error;                    // Why the last download failed
+} asset_ota_status_t;
+
+/**
+ * @brief Start downloading a pack from url (any task)
+ * @return ESP_ERR_INVALID_STATE while a download runs, ESP_ERR_NOT_FOUND
+ *         without A/B slots in the partition table
+ */
+esp_err_t asset_ota_start(const char *url);
+
+/**
+ * @brief Progress of the current or last download (any task)
+ */
+void asset_ota_get_status(asset_ota_status_t *out);
+
+/**
+ * @brief Name of a state for logs and the device API
+ */
+const char *asset_ota_state_name(asset_ota_state_t state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASSET_OTA_H
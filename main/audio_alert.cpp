@@ -0,0 +1,179 @@
+#include "audio_alert.h"
+#include "esp_es8311_port.h"
+#include "mood/mood_engine.h"
+#include "msg_bus.h"
+#include "messages.h"
+#include "task_layout.h"
+#include "task_monitor.h"
+#include "job_watch.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <limits.h>
+#include <math.h>
+
+static const char *TAG = "audio_alert";
+
+#define TONE_RAMP_MS    5               // Fade in / out: no clicks at the edges
+#define TONE_LEVEL      0.5f            // Of full scale, before the codec volume
+
+typedef struct {
+    uint16_t hz;                        // 0 = rest
+    uint16_t ms;
+} tone_t;
+
+typedef struct {
+    const char *name;
+    const tone_t *tones;
+    uint8_t count;
+    int16_t *pcm;                       // PSRAM, rendered at start
+    size_t samples;
+    int64_t played_us;
+} alert_sound_t;
+
+// Ammonia: three high beeps, twice. Nitrite: a falling two-tone, twice.
+static const tone_t ammonia_tones[] = {
+    { 1760, 110 }, { 0, 60 }, { 1760, 110 }, { 0, 60 }, { 1760, 110 }, { 0, 300 },
+    { 1760, 110 }, { 0, 60 }, { 1760, 110 }, { 0, 60 }, { 1760, 110 },
+};
+static const tone_t nitrite_tones[] = {
+    { 1319, 220 }, { 988, 320 }, { 0, 200 },
+    { 1319, 220 }, { 988, 320 },
+};
+
+static alert_sound_t sounds[AUDIO_ALERT_COUNT] = {
+    { "ammonia", ammonia_tones, sizeof(ammonia_tones) / sizeof(ammonia_tones[0]), NULL, 0, 0 },
+    { "nitrite", nitrite_tones, sizeof(nitrite_tones) / sizeof(nitrite_tones[0]), NULL, 0, 0 },
+};
+
+static i2c_master_bus_handle_t codec_bus = NULL;
+
+/**
+ * @brief Render a tone table into PSRAM PCM
+ */
+static bool render(alert_sound_t *s)
+{
+    size_t total = 0;
+    for (uint8_t i = 0; i < s->count; i++) {
+        total += (size_t)s->tones[i].ms * ES8311_SAMPLE_RATE / 1000;
+    }
+    s->pcm = (int16_t *)heap_caps_malloc(total * sizeof(int16_t), MALLOC_CAP_SPIRAM);
+    if (s->pcm == NULL) {
+        return false;
+    }
+    const size_t ramp = TONE_RAMP_MS * ES8311_SAMPLE_RATE / 1000;
+    int16_t *out = s->pcm;
+    for (uint8_t i = 0; i < s->count; i++) {
+        size_t n = (size_t)s->tones[i].ms * ES8311_SAMPLE_RATE / 1000;
+        float step = 2.0f * (float)M_PI * s->tones[i].hz / ES8311_SAMPLE_RATE;
+        for (size_t k = 0; k < n; k++) {
+            float env = 1.0f;
+            if (k < ramp) {
+                env = (float)k / ramp;
+            } else if (n - k < ramp) {
+                env = (float)(n - k) / ramp;
+            }
+            float v = s->tones[i].hz ? sinf(step * k) * env * TONE_LEVEL : 0.0f;
+            out[k] = (int16_t)(v * 32767.0f);
+        }
+        out += n;
+    }
+    s->samples = total;
+    return true;
+}
+
+static void play(alert_sound_t *s)
+{
+    job_watch_begin(TASK_ID_AUDIO, "alert", AUDIO_ALERT_PLAY_MS);
+    esp_err_t err = esp_es8311_port_play(s->pcm, s->samples, CONFIG_GOLDIE_AUDIO_ALERT_VOLUME);
+    job_watch_end(TASK_ID_AUDIO);
+    s->played_us = esp_timer_get_time();
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "%s alert not played: %s", s->name, esp_err_to_name(err));
+    } else {
+        ESP_LOGI(TAG, "%s alert played", s->name);
+    }
+}
+
+/**
+ * @brief Play a factor's sound while it is critical, once per repeat period
+ */
+static void check(alert_sound_t *s, int score, int worst)
+{
+    const int64_t repeat_us = (int64_t)CONFIG_GOLDIE_AUDIO_ALERT_REPEAT_MIN * 60 * 1000000;
+    if (score > worst) {
+        s->played_us = 0;       // Recovered: the next critical reading sounds at once
+        return;
+    }
+    if (s->pcm != NULL && (s->played_us == 0 || esp_timer_get_time() - s->played_us >= repeat_us)) {
+        play(s);
+    }
+}
+
+static void audio_task(void *arg)
+{
+    if (esp_es8311_port_init(codec_bus) != ESP_OK) {
+        vTaskDelete(NULL);
+        return;
+    }
+    task_monitor_register(TASK_ID_AUDIO, xTaskGetCurrentTaskHandle());
+    size_t bytes = 0;
+    for (int i = 0; i < AUDIO_ALERT_COUNT; i++) {
+        if (!render(&sounds[i])) {
+            ESP_LOGW(TAG, "No PSRAM for the %s sound", sounds[i].name);
+            continue;
+        }
+        bytes += sounds[i].samples * sizeof(int16_t);
+    }
+
+    msg_bus_sub_t *mood_sub = msg_bus_subscribe("audio_alert", MSG_TOPIC_MOOD_RESULT, TANK_MAX, MSG_SUB_LATEST,
+                                                NULL, NULL);
+    if (mood_sub == NULL) {
+        ESP_LOGW(TAG, "No mood subscription - alerts off");
+        vTaskDelete(NULL);
+        return;
+    }
+    ESP_LOGI(TAG, "Alert sounds ready (%u KB PSRAM), repeat every %d min", (unsigned)(bytes / 1024),
+             CONFIG_GOLDIE_AUDIO_ALERT_REPEAT_MIN);
+
+    // Latest scores of each tank: a factor sounds while it is critical in any
+    int ammonia[TANK_MAX];
+    int nitrite[TANK_MAX];
+    for (int t = 0; t < TANK_MAX; t++) {
+        ammonia[t] = nitrite[t] = INT_MAX;
+    }
+    while (true) {
+        const msg_bus_msg_t *msg = msg_bus_receive(mood_sub, portMAX_DELAY);
+        if (msg == NULL) {
+            continue;
+        }
+        mood_result_t result = *MSG_BUS_PAYLOAD(msg, mood_result_t);
+        msg_bus_release(msg);
+        if (result.tank >= TANK_MAX) {
+            continue;
+        }
+        ammonia[result.tank] = result.ammonia_score;
+        nitrite[result.tank] = result.nitrite_score;
+        int worst_ammonia = INT_MAX;
+        int worst_nitrite = INT_MAX;
+        for (int t = 0; t < TANK_MAX; t++) {
+            worst_ammonia = ammonia[t] < worst_ammonia ? ammonia[t] : worst_ammonia;
+            worst_nitrite = nitrite[t] < worst_nitrite ? nitrite[t] : worst_nitrite;
+        }
+        const mood_preset_t *preset = mood_engine_preset();
+        check(&sounds[AUDIO_ALERT_AMMONIA], worst_ammonia,
+              preset->factor[MOOD_FACTOR_AMMONIA].score[MOOD_BANDS]);
+        check(&sounds[AUDIO_ALERT_NITRITE], worst_nitrite,
+              preset->factor[MOOD_FACTOR_NITRITE].score[MOOD_BANDS]);
+    }
+}
+
+void audio_alert_start(i2c_master_bus_handle_t bus)
+{
+    codec_bus = bus;
+    if (task_layout_create(TASK_ID_AUDIO, audio_task, NULL, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create the audio alert task");
+    }
+}
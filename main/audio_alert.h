@@ -0,0 +1,51 @@
+#ifndef AUDIO_ALERT_H
+#define AUDIO_ALERT_H
+
+#include <stdbool.h>
+#include "driver/i2c_master.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Audio alerts - a sound through the ES8311 when ammonia or nitrite is critical
+//
+// One low-priority task (TASK_ID_AUDIO) brings up the codec, then renders
+// every alert sound once into PSRAM as ES8311_SAMPLE_RATE PCM from its
+// tone table; playing one is a DMA copy of ready samples, nothing is
+// synthesised at alert time. The task follows MSG_TOPIC_MOOD_RESULT and
+// plays a factor's sound when its score is in the preset's worst band
+// (outside every band, mood_engine.h).
+//
+// Nobody waits on audio: the mood topic is delivered to the task like to
+// any subscriber, and the task blocks on the I2S DMA for the length of a
+// sound while UI and network tasks run at higher priority. A sound plays
+// at most once per CONFIG_GOLDIE_AUDIO_ALERT_REPEAT_MIN while its factor
+// stays critical.
+
+#ifndef CONFIG_GOLDIE_AUDIO_ALERT_REPEAT_MIN
+#define CONFIG_GOLDIE_AUDIO_ALERT_REPEAT_MIN 10
+#endif
+#ifndef CONFIG_GOLDIE_AUDIO_ALERT_VOLUME
+#define CONFIG_GOLDIE_AUDIO_ALERT_VOLUME 60
+#endif
+
+#define AUDIO_ALERT_PLAY_MS   3000      // job_watch deadline of one sound
+
+typedef enum {
+    AUDIO_ALERT_AMMONIA = 0,
+    AUDIO_ALERT_NITRITE,
+    AUDIO_ALERT_COUNT
+} audio_alert_t;
+
+/**
+ * @brief Start the alert task; the codec probe runs there (after the I2C bus)
+ */
+void audio_alert_start(i2c_master_bus_handle_t bus);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_ALERT_H
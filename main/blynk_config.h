@@ -12,7 +12,23 @@
 #define BLYNK_PIN_FEEDING        3  // V3: Hours since feeding
 #define BLYNK_PIN_CLEANING       4  // V4: Days since cleaning
 #define BLYNK_PIN_MOOD           5  // V5: Fish mood (HAPPY/SAD)
-#define BLYNK_PIN_AI_ADVICE      6  // V6: AI advice text
+#define BLYNK_PIN_AI_ADVICE      6  // V6: AI advice, one-line summary
+#define BLYNK_PIN_TASK_STATS     7  // V7: Task stack/CPU summary (task monitor)
+#define BLYNK_PIN_FORECAST       8  // V8: Predicted mood drop (mood trend)
+#define BLYNK_PIN_REMINDER       9  // V9: Feed / water change / dose / re-test due (reminders)
+
+// Datastream names for the MQTT transport (topic ds/<name>); they must
+// match the datastream names of the template
+#define BLYNK_DS_TEMPERATURE     "Temperature"
+#define BLYNK_DS_OXYGEN          "Oxygen"
+#define BLYNK_DS_PH              "pH"
+#define BLYNK_DS_FEEDING         "Feeding"
+#define BLYNK_DS_CLEANING        "Cleaning"
+#define BLYNK_DS_MOOD            "Mood"
+#define BLYNK_DS_AI_ADVICE       "AI Advice"
+#define BLYNK_DS_TASK_STATS      "Task Stats"
+#define BLYNK_DS_FORECAST        "Forecast"
+#define BLYNK_DS_REMINDER        "Reminder"
 
 // Blynk server
 #define BLYNK_SERVER "blynk.cloud"
@@ -3,11 +3,132 @@
 #include <string.h>
 #include <stdio.h>
 #include "esp_log.h"
-#include "esp_http_client.h"
+#include "http_pool.h"
+#include "esp_timer.h"
+#include <math.h>
+#if CONFIG_GOLDIE_BLYNK_MQTT
+#include "mqtt_client.h"
+#include "esp_crt_bundle.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#endif
 
 static const char *TAG = "blynk";
 static bool blynk_initialized = false;
 
+// ═══════════════════════════════════════════════════════════════════════════
+// BATCHED PIN WRITES (ONE REQUEST, ONE KEPT-ALIVE CONNECTION)
+// ═══════════════════════════════════════════════════════════════════════════
+// Every write goes through batch/update: the pins of one sync are query
+// parameters of a single GET (&V0=..&V1=..), sent on a kept-alive
+// connection of the shared HTTP pool (http_pool.h), which also owns the
+// retry and backoff policy and counts the bytes.
+//
+// With CONFIG_GOLDIE_BLYNK_MQTT the same batch is published instead, one
+// small ds/<datastream> packet per pin on a persistent MQTT session (see
+// BLYNK MQTT TRANSPORT below); the batch URL is then only a buffer.
+//
+// Change-only: the last value the server accepted is kept per pin, and a
+// pin is only sent again when it moved past its deadband (numbers) or
+// changed at all (text). An idle tank costs no request at all. Every
+// CONFIG_GOLDIE_BLYNK_REFRESH_MIN the next sync sends every pin, so the
+// cloud catches up after anything the device could not see (a dashboard
+// reset, a lost reply). Telemetry worker only (blynk_init runs before it).
+
+#ifndef CONFIG_GOLDIE_BLYNK_REFRESH_MIN
+#define CONFIG_GOLDIE_BLYNK_REFRESH_MIN 30
+#endif
+
+#define BLYNK_URL_MAX       2048
+#define BLYNK_TEXT_MAX      600    // Encoded bytes of one free-text pin
+#define BLYNK_PIN_SLOTS     32     // Change tracking for V0..V31
+#define BLYNK_TIMEOUT_MS    5000
+
+// blynk_send_all_data() deadbands, in the units of each pin
+#define BLYNK_DEADBAND_TEMPERATURE  0.05f
+#define BLYNK_DEADBAND_OXYGEN       0.05f
+#define BLYNK_DEADBAND_PH           0.05f
+#define BLYNK_DEADBAND_FEED_HOURS   0.5f
+#define BLYNK_DEADBAND_CLEAN_DAYS   0.25f
+
+typedef struct {
+    char url[BLYNK_URL_MAX];
+    size_t len;
+    size_t base_len;               // Up to and including the token
+    int pins;
+    bool full;                     // Forced refresh: every pin, changed or not
+    int pin[BLYNK_PIN_SLOTS];      // Pins in this request and what they carry
+    uint32_t hash[BLYNK_PIN_SLOTS];
+    float value[BLYNK_PIN_SLOTS];
+    uint16_t val_at[BLYNK_PIN_SLOTS];   // Value of each pin within url
+    uint16_t val_len[BLYNK_PIN_SLOTS];
+} blynk_batch_t;
+
+static blynk_batch_t batch;
+static uint32_t sent_hash[BLYNK_PIN_SLOTS];    // 0 = nothing accepted yet
+static float sent_value[BLYNK_PIN_SLOTS];      // Numeric pins: value accepted
+static int64_t last_full_us = 0;               // 0 = no full refresh yet
+static http_pool_host_t *blynk_host = NULL;   // HTTP API (and history uploads)
+static uint32_t pins_sent = 0;
+static uint32_t pins_suppressed = 0;
+static blynk_write_handler_t write_handler = NULL;
+
+#if CONFIG_GOLDIE_BLYNK_MQTT
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BLYNK MQTT TRANSPORT
+// ═══════════════════════════════════════════════════════════════════════════
+// One TLS session to the Blynk broker (user "device", password = auth
+// token), kept open by esp-mqtt and re-established on its own after a drop.
+// Gauges go out at QoS 0: a lost reading is replaced by the next one. Mood,
+// advice, forecast and reminders are events and go out at QoS 1 so the app
+// does not miss a change. downlink/ds/<datastream> carries writes from the app to
+// the handler set with blynk_set_write_handler(). A new session forces the
+// next sync to send every pin, as the broker keeps nothing for us.
+
+#define BLYNK_MQTT_URI          "mqtts://" BLYNK_SERVER ":8883"
+#define BLYNK_MQTT_KEEPALIVE_S  45
+#define BLYNK_MQTT_CONNECTED    BIT0
+#define BLYNK_MQTT_RESYNC       BIT1     // Session (re)started since last sync
+
+#define BLYNK_TRANSPORT         "MQTT"
+
+typedef struct {
+    int pin;
+    const char *datastream;
+    int qos;
+} blynk_ds_t;
+
+static const blynk_ds_t blynk_ds[] = {
+    { BLYNK_PIN_TEMPERATURE, BLYNK_DS_TEMPERATURE, 0 },
+    { BLYNK_PIN_OXYGEN,      BLYNK_DS_OXYGEN,      0 },
+    { BLYNK_PIN_PH,          BLYNK_DS_PH,          0 },
+    { BLYNK_PIN_FEEDING,     BLYNK_DS_FEEDING,     0 },
+    { BLYNK_PIN_CLEANING,    BLYNK_DS_CLEANING,    0 },
+    { BLYNK_PIN_MOOD,        BLYNK_DS_MOOD,        1 },
+    { BLYNK_PIN_AI_ADVICE,   BLYNK_DS_AI_ADVICE,   1 },
+    { BLYNK_PIN_TASK_STATS,  BLYNK_DS_TASK_STATS,  0 },
+    { BLYNK_PIN_FORECAST,    BLYNK_DS_FORECAST,    1 },
+    { BLYNK_PIN_REMINDER,    BLYNK_DS_REMINDER,    1 },
+};
+
+static esp_mqtt_client_handle_t blynk_mqtt = NULL;
+static EventGroupHandle_t blynk_mqtt_events = NULL;
+
+static const blynk_ds_t *blynk_ds_of_pin(int pin)
+{
+    for (size_t i = 0; i < sizeof(blynk_ds) / sizeof(blynk_ds[0]); i++) {
+        if (blynk_ds[i].pin == pin) {
+            return &blynk_ds[i];
+        }
+    }
+    return NULL;
+}
+
+#else
+
+#define BLYNK_TRANSPORT         "HTTP"
+
 // HTTP event handler for Blynk responses
 static esp_err_t blynk_http_event_handler(esp_http_client_event_t *evt)
 {
@@ -27,51 +148,316 @@ static esp_err_t blynk_http_event_handler(esp_http_client_event_t *evt)
     return ESP_OK;
 }
 
-// Send data to a Blynk virtual pin
-static bool blynk_write_pin(int pin, const char *value)
+#endif // CONFIG_GOLDIE_BLYNK_MQTT
+
+static uint32_t value_hash(const char *v)
 {
-    if (!blynk_initialized) {
-        ESP_LOGW(TAG, "Blynk not initialized");
-        return false;
+    uint32_t h = 2166136261u;
+    for (; *v != '\0'; v++) {
+        h ^= (uint8_t)*v;
+        h *= 16777619u;
+    }
+    return h ? h : 1;
+}
+
+static void batch_begin(void)
+{
+    int n = snprintf(batch.url, sizeof(batch.url), "http://%s/external/api/batch/update?token=%s",
+                     BLYNK_SERVER, BLYNK_AUTH_TOKEN);
+    batch.len = (n > 0 && (size_t)n < sizeof(batch.url)) ? (size_t)n : 0;
+    batch.base_len = batch.len;
+    batch.pins = 0;
+    batch.full = last_full_us == 0 || (CONFIG_GOLDIE_BLYNK_REFRESH_MIN > 0 &&
+                 esp_timer_get_time() - last_full_us >= (int64_t)CONFIG_GOLDIE_BLYNK_REFRESH_MIN * 60000000);
+#if CONFIG_GOLDIE_BLYNK_MQTT
+    if (blynk_mqtt_events != NULL && (xEventGroupGetBits(blynk_mqtt_events) & BLYNK_MQTT_RESYNC)) {
+        batch.full = true;
+    }
+#endif
+}
+
+/**
+ * @brief Queue "&V<pin>=<value>" unless the pin already shows value
+ * @param encode Percent-encode everything but unreserved characters
+ *        (free text); numbers and mood names are sent as they are.
+ *        Ignored over MQTT, where the payload is the raw text
+ * @param force  Skip the unchanged check (the caller already decided)
+ */
+static void batch_put(int pin, const char *value, bool encode, bool force)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    if (batch.len == 0 || value == NULL || pin < 0) {
+        return;
+    }
+    uint32_t h = value_hash(value);
+    if (!force && !batch.full && pin < BLYNK_PIN_SLOTS && sent_hash[pin] == h) {
+        pins_suppressed++;
+        return;    // Unchanged since the last accepted request
+    }
+    if (batch.pins >= BLYNK_PIN_SLOTS) {
+        return;
+    }
+#if CONFIG_GOLDIE_BLYNK_MQTT
+    encode = false;
+#endif
+
+    size_t start = batch.len;
+    int n = snprintf(batch.url + batch.len, sizeof(batch.url) - batch.len, "&V%d=", pin);
+    if (n <= 0 || batch.len + n >= sizeof(batch.url)) {
+        batch.url[start] = '\0';
+        return;
+    }
+    batch.len += n;
+    size_t value_at = batch.len;
+    size_t text_limit = batch.len + BLYNK_TEXT_MAX;
+    for (const char *c = value; *c != '\0'; c++) {
+        unsigned char ch = (unsigned char)*c;
+        bool plain = !encode || (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') ||
+                     (ch >= '0' && ch <= '9') || ch == '-' || ch == '_' || ch == '.' || ch == '~';
+        size_t need = plain ? 1 : 3;
+        // Whole escapes only; text past the limit is cut
+        if (batch.len + need >= sizeof(batch.url) || batch.len + need > text_limit) {
+            break;
+        }
+        if (plain) {
+            batch.url[batch.len++] = (char)ch;
+        } else {
+            batch.url[batch.len++] = '%';
+            batch.url[batch.len++] = hex[ch >> 4];
+            batch.url[batch.len++] = hex[ch & 0xF];
+        }
+    }
+    batch.url[batch.len] = '\0';
+    batch.pin[batch.pins] = pin;
+    batch.hash[batch.pins] = h;
+    batch.value[batch.pins] = NAN;
+    batch.val_at[batch.pins] = (uint16_t)value_at;
+    batch.val_len[batch.pins] = (uint16_t)(batch.len - value_at);
+    batch.pins++;
+}
+
+static void batch_add(int pin, const char *value, bool encode)
+{
+    batch_put(pin, value, encode, false);
+}
+
+/**
+ * @brief Queue a number unless it is within deadband of what the pin shows
+ */
+static void batch_add_num(int pin, float value, int decimals, float deadband)
+{
+    if (!batch.full && pin >= 0 && pin < BLYNK_PIN_SLOTS && sent_hash[pin] != 0 &&
+        fabsf(value - sent_value[pin]) < deadband) {
+        pins_suppressed++;
+        return;
+    }
+    char str[32];
+    snprintf(str, sizeof(str), "%.*f", decimals, value);
+    int before = batch.pins;
+    batch_put(pin, str, false, true);
+    if (batch.pins > before) {
+        batch.value[before] = value;
     }
+}
+
+#if CONFIG_GOLDIE_BLYNK_MQTT
 
-    // Build URL: http://blynk.cloud/external/api/update?token=XXX&V0=value
-    char url[512];
-    snprintf(url, sizeof(url), 
-             "http://%s/external/api/update?token=%s&V%d=%s",
-             BLYNK_SERVER, BLYNK_AUTH_TOKEN, pin, value);
+static void blynk_mqtt_downlink(const char *topic, int topic_len, const char *data, int data_len)
+{
+    static const char prefix[] = "downlink/ds/";
+    const int prefix_len = sizeof(prefix) - 1;
+    if (topic_len <= prefix_len || strncmp(topic, prefix, prefix_len) != 0) {
+        ESP_LOGD(TAG, "Downlink %.*s ignored", topic_len, topic);
+        return;
+    }
+    const char *name = topic + prefix_len;
+    int name_len = topic_len - prefix_len;
+    for (size_t i = 0; i < sizeof(blynk_ds) / sizeof(blynk_ds[0]); i++) {
+        const char *ds = blynk_ds[i].datastream;
+        int pin = blynk_ds[i].pin;
+        if ((int)strlen(ds) == name_len && strncmp(ds, name, name_len) == 0) {
+            char value[BLYNK_TEXT_MAX + 1];
+            int len = data_len < BLYNK_TEXT_MAX ? data_len : BLYNK_TEXT_MAX;
+            memcpy(value, data, len);
+            value[len] = '\0';
+            ESP_LOGI(TAG, "App wrote V%d = %s", pin, value);
+            if (write_handler != NULL) {
+                write_handler(pin, value);
+            }
+            return;
+        }
+    }
+    ESP_LOGW(TAG, "Write to unknown datastream %.*s", name_len, name);
+}
+
+static void blynk_mqtt_event_handler(void *arg, esp_event_base_t base, int32_t event_id, void *event_data)
+{
+    esp_mqtt_event_handle_t evt = (esp_mqtt_event_handle_t)event_data;
+    switch ((esp_mqtt_event_id_t)event_id) {
+        case MQTT_EVENT_CONNECTED:
+            ESP_LOGI(TAG, "MQTT session up");
+            esp_mqtt_client_subscribe(evt->client, "downlink/#", 1);
+            xEventGroupSetBits(blynk_mqtt_events, BLYNK_MQTT_CONNECTED | BLYNK_MQTT_RESYNC);
+            break;
+        case MQTT_EVENT_DISCONNECTED:
+            ESP_LOGW(TAG, "MQTT session down - reconnecting");
+            xEventGroupClearBits(blynk_mqtt_events, BLYNK_MQTT_CONNECTED);
+            break;
+        case MQTT_EVENT_DATA:
+            // Fragments of a long payload arrive as further events; app
+            // writes are short, so only the first one is used
+            if (evt->current_data_offset == 0) {
+                blynk_mqtt_downlink(evt->topic, evt->topic_len, evt->data, evt->data_len);
+            }
+            break;
+        case MQTT_EVENT_ERROR:
+            ESP_LOGD(TAG, "MQTT_EVENT_ERROR");
+            break;
+        default:
+            break;
+    }
+}
 
-    esp_http_client_config_t config = {};
-    config.url = url;
-    config.method = HTTP_METHOD_GET;
-    config.event_handler = blynk_http_event_handler;
-    config.timeout_ms = 5000;
+static bool blynk_transport_start(void)
+{
+    blynk_mqtt_events = xEventGroupCreate();
+    if (blynk_mqtt_events == NULL) {
+        return false;
+    }
+    esp_mqtt_client_config_t config = {};
+    config.broker.address.uri = BLYNK_MQTT_URI;
+    config.broker.verification.crt_bundle_attach = esp_crt_bundle_attach;
+    config.credentials.username = "device";
+    config.credentials.authentication.password = BLYNK_AUTH_TOKEN;
+    config.session.keepalive = BLYNK_MQTT_KEEPALIVE_S;
+    config.network.timeout_ms = BLYNK_TIMEOUT_MS;
+    blynk_mqtt = esp_mqtt_client_init(&config);
+    if (blynk_mqtt == NULL) {
+        ESP_LOGE(TAG, "Failed to initialize MQTT client");
+        return false;
+    }
+    esp_mqtt_client_register_event(blynk_mqtt, MQTT_EVENT_ANY, blynk_mqtt_event_handler, NULL);
+    if (esp_mqtt_client_start(blynk_mqtt) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start MQTT client");
+        return false;
+    }
+    // Give the first session a moment so the "connected" mood goes out now
+    xEventGroupWaitBits(blynk_mqtt_events, BLYNK_MQTT_CONNECTED, pdFALSE, pdFALSE,
+                        pdMS_TO_TICKS(BLYNK_TIMEOUT_MS));
+    return true;
+}
 
-    esp_http_client_handle_t client = esp_http_client_init(&config);
-    if (client == NULL) {
-        ESP_LOGE(TAG, "Failed to initialize HTTP client");
+/**
+ * @brief Publish each queued pin to ds/<datastream> (QoS per datastream)
+ */
+static bool batch_transmit(void)
+{
+    if (!(xEventGroupGetBits(blynk_mqtt_events) & BLYNK_MQTT_CONNECTED)) {
+        ESP_LOGW(TAG, "MQTT session down - %d pin(s) wait for the next sync", batch.pins);
         return false;
     }
+    if (batch.full) {
+        xEventGroupClearBits(blynk_mqtt_events, BLYNK_MQTT_RESYNC);
+    }
+    for (int i = 0; i < batch.pins; i++) {
+        const blynk_ds_t *ds = blynk_ds_of_pin(batch.pin[i]);
+        if (ds == NULL) {
+            ESP_LOGW(TAG, "V%d has no datastream name - not sent", batch.pin[i]);
+            continue;
+        }
+        char topic[64];
+        snprintf(topic, sizeof(topic), "ds/%s", ds->datastream);
+        int id = esp_mqtt_client_publish(blynk_mqtt, topic, batch.url + batch.val_at[i],
+                                         batch.val_len[i], ds->qos, 0);
+        if (id < 0) {
+            ESP_LOGW(TAG, "Failed to publish %s", topic);
+            xEventGroupSetBits(blynk_mqtt_events, BLYNK_MQTT_RESYNC);  // Resend all next time
+            return false;
+        }
+    }
+    ESP_LOGD(TAG, "%d pin(s) published", batch.pins);
+    return true;
+}
+
+#else
 
-    esp_err_t err = esp_http_client_perform(client);
-    int status_code = esp_http_client_get_status_code(client);
-    esp_http_client_cleanup(client);
+static bool blynk_transport_start(void)
+{
+    return true;    // The pool connects on the first request
+}
 
+/**
+ * @brief Send the queued pins as one batch/update request
+ */
+static bool batch_transmit(void)
+{
+    bool fresh;
+    http_pool_conn_t *conn = http_pool_acquire(blynk_host, batch.url, HTTP_METHOD_GET, blynk_http_event_handler, &fresh);
+    if (conn == NULL) {
+        return false;    // Backing off after network failures
+    }
+    int status_code;
+    esp_err_t err = http_pool_perform(conn, NULL, &status_code);
+    http_pool_release(conn);
     if (err == ESP_OK && status_code == 200) {
-        ESP_LOGD(TAG, "Pin V%d updated to: %s", pin, value);
+        ESP_LOGD(TAG, "%d pin(s) updated in one request (%u bytes)", batch.pins, (unsigned)batch.len);
         return true;
-    } else {
-        ESP_LOGW(TAG, "Failed to update pin V%d (status: %d)", pin, status_code);
+    }
+    ESP_LOGW(TAG, "Failed to update %d pin(s) (status: %d, %s)", batch.pins, status_code,
+             esp_err_to_name(err));
+    return false;
+}
+
+#endif // CONFIG_GOLDIE_BLYNK_MQTT
+
+/**
+ * @brief Send the queued pins (nothing queued: nothing sent)
+ */
+static bool batch_send(void)
+{
+    if (!blynk_initialized) {
+        ESP_LOGW(TAG, "Blynk not initialized");
+        return false;
+    }
+    if (batch.pins == 0) {
+        ESP_LOGD(TAG, "No pin changed - nothing to send");
+        return true;    // A full refresh always has pins, so it stays due
+    }
+    if (!batch_transmit()) {
         return false;
     }
+    for (int i = 0; i < batch.pins; i++) {
+        if (batch.pin[i] < BLYNK_PIN_SLOTS) {
+            sent_hash[batch.pin[i]] = batch.hash[i];
+            sent_value[batch.pin[i]] = batch.value[i];
+        }
+    }
+    if (batch.full) {
+        last_full_us = esp_timer_get_time();
+    }
+    pins_sent += batch.pins;
+    return true;
+}
+
+// Send data to a Blynk virtual pin
+static bool blynk_write_pin(int pin, const char *value, bool encode)
+{
+    batch_begin();
+    batch.full = false;    // One pin is not a refresh; the next sync stays due
+    batch_add(pin, value, encode);
+    return batch_send();
 }
 
 bool blynk_init(void)
 {
     ESP_LOGI(TAG, "Initializing Blynk integration");
     ESP_LOGI(TAG, "Template: %s", BLYNK_TEMPLATE_ID);
-    ESP_LOGI(TAG, "Server: %s", BLYNK_SERVER);
-    
+    ESP_LOGI(TAG, "Server: %s (%s)", BLYNK_SERVER, BLYNK_TRANSPORT);
+
+    blynk_host = http_pool_host("blynk", BLYNK_TIMEOUT_MS);
+    if (!blynk_transport_start()) {
+        return false;
+    }
     blynk_initialized = true;
     
     // Send initial "connected" message
@@ -85,97 +471,204 @@ void blynk_update_temperature(float value)
 {
     char str[32];
     snprintf(str, sizeof(str), "%.1f", value);
-    blynk_write_pin(BLYNK_PIN_TEMPERATURE, str);
+    blynk_write_pin(BLYNK_PIN_TEMPERATURE, str, false);
 }
 
 void blynk_update_oxygen(float value)
 {
     char str[32];
     snprintf(str, sizeof(str), "%.1f", value);
-    blynk_write_pin(BLYNK_PIN_OXYGEN, str);
+    blynk_write_pin(BLYNK_PIN_OXYGEN, str, false);
 }
 
 void blynk_update_ph(float value)
 {
     char str[32];
     snprintf(str, sizeof(str), "%.2f", value);
-    blynk_write_pin(BLYNK_PIN_PH, str);
+    blynk_write_pin(BLYNK_PIN_PH, str, false);
 }
 
 void blynk_update_feeding(float hours)
 {
     char str[32];
     snprintf(str, sizeof(str), "%.1f", hours);
-    blynk_write_pin(BLYNK_PIN_FEEDING, str);
+    blynk_write_pin(BLYNK_PIN_FEEDING, str, false);
 }
 
 void blynk_update_cleaning(float days)
 {
     char str[32];
     snprintf(str, sizeof(str), "%.1f", days);
-    blynk_write_pin(BLYNK_PIN_CLEANING, str);
+    blynk_write_pin(BLYNK_PIN_CLEANING, str, false);
 }
 
 void blynk_update_mood(const char *mood)
 {
-    blynk_write_pin(BLYNK_PIN_MOOD, mood);
+    blynk_write_pin(BLYNK_PIN_MOOD, mood, false);
 }
 
 void blynk_update_ai_advice(const char *advice)
 {
-    // URL encode the advice text (simple version - replace spaces with %20)
-    char encoded[512];
-    int j = 0;
-    for (int i = 0; advice[i] != '\0' && j < sizeof(encoded) - 4; i++) {
-        if (advice[i] == ' ') {
-            encoded[j++] = '%';
-            encoded[j++] = '2';
-            encoded[j++] = '0';
-        } else if (advice[i] == '\n') {
-            encoded[j++] = '%';
-            encoded[j++] = '0';
-            encoded[j++] = 'A';
-        } else {
-            encoded[j++] = advice[i];
-        }
-    }
-    encoded[j] = '\0';
-    
-    blynk_write_pin(BLYNK_PIN_AI_ADVICE, encoded);
+    blynk_write_pin(BLYNK_PIN_AI_ADVICE, advice, true);
+}
+
+void blynk_update_task_stats(const char *summary)
+{
+    blynk_write_pin(BLYNK_PIN_TASK_STATS, summary, true);
+}
+
+void blynk_update_forecast(const char *warning)
+{
+    blynk_write_pin(BLYNK_PIN_FORECAST, warning, true);
 }
 
-void blynk_send_all_data(float temp, float oxygen, float ph, 
+void blynk_update_reminder(const char *text)
+{
+    // Always sent: tomorrow's feed reminder reads the same as today's
+    batch_begin();
+    batch.full = false;
+    batch_put(BLYNK_PIN_REMINDER, text, true, true);
+    batch_send();
+}
+
+bool blynk_send_all_data(float temp, float oxygen, float ph, 
                          float feed_hours, float clean_days,
                          const char *mood, const char *ai_advice)
 {
     if (!blynk_initialized) {
         ESP_LOGW(TAG, "Blynk not initialized");
-        return;
+        return false;
     }
 
-    ESP_LOGI(TAG, "Sending all data to Blynk");
-    
-    blynk_update_temperature(temp);
-    vTaskDelay(pdMS_TO_TICKS(100));  // Small delay between requests
-    
-    blynk_update_oxygen(oxygen);
-    vTaskDelay(pdMS_TO_TICKS(100));
-    
-    blynk_update_ph(ph);
-    vTaskDelay(pdMS_TO_TICKS(100));
-    
-    blynk_update_feeding(feed_hours);
-    vTaskDelay(pdMS_TO_TICKS(100));
-    
-    blynk_update_cleaning(clean_days);
-    vTaskDelay(pdMS_TO_TICKS(100));
-    
-    blynk_update_mood(mood);
-    vTaskDelay(pdMS_TO_TICKS(100));
-    
+    // One request for the pins that moved past their deadband (was seven
+    // requests, 100 ms apart, every value every time). The deadbands sit
+    // above test-kit resolution; hours / days only move the pin in steps.
+    batch_begin();
+    bool full = batch.full;
+    batch_add_num(BLYNK_PIN_TEMPERATURE, temp, 1, BLYNK_DEADBAND_TEMPERATURE);
+    batch_add_num(BLYNK_PIN_OXYGEN, oxygen, 1, BLYNK_DEADBAND_OXYGEN);
+    batch_add_num(BLYNK_PIN_PH, ph, 2, BLYNK_DEADBAND_PH);
+    batch_add_num(BLYNK_PIN_FEEDING, feed_hours, 1, BLYNK_DEADBAND_FEED_HOURS);
+    batch_add_num(BLYNK_PIN_CLEANING, clean_days, 1, BLYNK_DEADBAND_CLEAN_DAYS);
+    batch_add(BLYNK_PIN_MOOD, mood, false);
     if (ai_advice != NULL && ai_advice[0] != '\0') {
-        blynk_update_ai_advice(ai_advice);
+        batch_add(BLYNK_PIN_AI_ADVICE, ai_advice, true);
     }
-    
-    ESP_LOGI(TAG, "All data sent to Blynk");
+    int pins = batch.pins;
+    if (pins == 0) {
+        ESP_LOGD(TAG, "Blynk sync: nothing changed");
+        return true;
+    }
+    if (!batch_send()) {
+        return false;
+    }
+    ESP_LOGI(TAG, "Blynk sync: %d pin(s) sent%s (%lu sent / %lu suppressed since boot)", pins,
+             full ? " - full refresh" : "", (unsigned long)pins_sent, (unsigned long)pins_suppressed);
+    return true;
+}
+
+// Timestamped history upload (offline backlog). Rare, so a short-lived
+// client of its own serves both transports.
+#define BLYNK_HISTORY_BODY_MAX  1536
+
+bool blynk_send_history(int pin, const uint32_t *times, const float *values, size_t count, int decimals)
+{
+    static char body[BLYNK_HISTORY_BODY_MAX];
+    if (!blynk_initialized || count == 0) {
+        return false;
+    }
+    size_t len = 0;
+    body[len++] = '[';
+    for (size_t i = 0; i < count; i++) {
+        int n = snprintf(body + len, sizeof(body) - len, "%s[%llu000,%.*f]", i ? "," : "",
+                         (unsigned long long)times[i], decimals, values[i]);
+        if (n <= 0 || len + n + 2 > sizeof(body)) {
+            ESP_LOGE(TAG, "History of V%d too long (%u points)", pin, (unsigned)count);
+            return false;
+        }
+        len += n;
+    }
+    body[len++] = ']';
+    body[len] = '\0';
+
+    char url[160];
+    snprintf(url, sizeof(url), "http://%s/external/api/batch/update/data?token=%s&pin=V%d",
+             BLYNK_SERVER, BLYNK_AUTH_TOKEN, pin);
+    bool fresh;
+    http_pool_conn_t *conn = http_pool_acquire(blynk_host, url, HTTP_METHOD_POST, NULL, &fresh);
+    if (conn == NULL) {
+        return false;
+    }
+    esp_http_client_set_header(http_pool_client(conn), "Content-Type", "application/json");
+    esp_http_client_set_post_field(http_pool_client(conn), body, (int)len);
+    int status_code;
+    esp_err_t err = http_pool_perform(conn, NULL, &status_code);
+    http_pool_release(conn);
+    if (err != ESP_OK || status_code != 200) {
+        ESP_LOGW(TAG, "History upload of V%d failed (status: %d, %s)", pin, status_code, esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+#define BLYNK_EVENT_TEXT_MAX  255   // Blynk's limit for an event description
+
+bool blynk_log_event(const char *code, const char *description)
+{
+    if (!blynk_initialized) {
+        return false;
+    }
+#if CONFIG_GOLDIE_BLYNK_MQTT
+    if (!(xEventGroupGetBits(blynk_mqtt_events) & BLYNK_MQTT_CONNECTED)) {
+        return false;
+    }
+    char topic[64];
+    snprintf(topic, sizeof(topic), "event/%s", code);
+    int len = (int)strnlen(description, BLYNK_EVENT_TEXT_MAX);
+    if (esp_mqtt_client_publish(blynk_mqtt, topic, description, len, 1, 0) < 0) {
+        ESP_LOGW(TAG, "Failed to publish event %s", code);
+        return false;
+    }
+#else
+    static const char hex[] = "0123456789ABCDEF";
+    char url[160 + 3 * BLYNK_EVENT_TEXT_MAX];
+    int n = snprintf(url, sizeof(url), "http://%s/external/api/logEvent?token=%s&code=%s&description=",
+                     BLYNK_SERVER, BLYNK_AUTH_TOKEN, code);
+    if (n <= 0 || (size_t)n >= sizeof(url)) {
+        return false;
+    }
+    size_t len = (size_t)n;
+    for (size_t i = 0; description[i] != '\0' && i < BLYNK_EVENT_TEXT_MAX && len + 3 < sizeof(url); i++) {
+        unsigned char ch = (unsigned char)description[i];
+        if ((ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || (ch >= '0' && ch <= '9') ||
+            ch == '-' || ch == '_' || ch == '.' || ch == '~') {
+            url[len++] = (char)ch;
+        } else {
+            url[len++] = '%';
+            url[len++] = hex[ch >> 4];
+            url[len++] = hex[ch & 0xF];
+        }
+    }
+    url[len] = '\0';
+
+    bool fresh;
+    http_pool_conn_t *conn = http_pool_acquire(blynk_host, url, HTTP_METHOD_GET, blynk_http_event_handler, &fresh);
+    if (conn == NULL) {
+        return false;
+    }
+    int status_code;
+    esp_err_t err = http_pool_perform(conn, NULL, &status_code);
+    http_pool_release(conn);
+    if (err != ESP_OK || status_code != 200) {
+        ESP_LOGW(TAG, "Event %s not logged (status: %d, %s)", code, status_code, esp_err_to_name(err));
+        return false;
+    }
+#endif
+    ESP_LOGI(TAG, "Event %s: %s", code, description);
+    return true;
+}
+
+void blynk_set_write_handler(blynk_write_handler_t handler)
+{
+    write_handler = handler;
 }
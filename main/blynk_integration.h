@@ -2,11 +2,20 @@
 #define BLYNK_INTEGRATION_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#ifndef CONFIG_GOLDIE_BLYNK
+#define CONFIG_GOLDIE_BLYNK 0
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if CONFIG_GOLDIE_BLYNK
+
 // Initialize Blynk (call after WiFi is connected)
 bool blynk_init(void);
 
@@ -18,12 +27,43 @@ void blynk_update_feeding(float hours);
 void blynk_update_cleaning(float days);
 void blynk_update_mood(const char *mood);  // "HAPPY" or "SAD"
 void blynk_update_ai_advice(const char *advice);
+void blynk_update_task_stats(const char *summary);  // Task monitor line
+void blynk_update_forecast(const char *warning);    // Predicted mood drop
+void blynk_update_reminder(const char *text);       // Reminder that came due
 
-// Send all sensor data at once
-void blynk_send_all_data(float temp, float oxygen, float ph, 
+// Send all sensor data at once; false if the cloud did not get it
+bool blynk_send_all_data(float temp, float oxygen, float ph, 
                          float feed_hours, float clean_days,
                          const char *mood, const char *ai_advice);
 
+// Upload past values of one pin (times: Unix seconds, oldest first)
+bool blynk_send_history(int pin, const uint32_t *times, const float *values, size_t count, int decimals);
+
+// Log a template event (the code must exist in the Blynk template; the
+// app notifies as the event is set up there); false if it did not go out
+bool blynk_log_event(const char *code, const char *description);
+
+// Called for each value written from the Blynk app (MQTT transport only,
+// on the MQTT task); value is NUL-terminated text
+typedef void (*blynk_write_handler_t)(int pin, const char *value);
+void blynk_set_write_handler(blynk_write_handler_t handler);
+
+#else
+// Built without Blynk (blynk_integration.cpp not compiled): never
+// initialized, so the telemetry worker treats the cloud as unreachable
+typedef void (*blynk_write_handler_t)(int pin, const char *value);
+static inline bool blynk_init(void) { return false; }
+static inline void blynk_update_task_stats(const char *summary) {}
+static inline void blynk_update_forecast(const char *warning) {}
+static inline void blynk_update_reminder(const char *text) {}
+static inline bool blynk_send_all_data(float temp, float oxygen, float ph, float feed_hours, float clean_days,
+                                       const char *mood, const char *ai_advice) { return false; }
+static inline bool blynk_send_history(int pin, const uint32_t *times, const float *values, size_t count,
+                                      int decimals) { return false; }
+static inline bool blynk_log_event(const char *code, const char *description) { return false; }
+static inline void blynk_set_write_handler(blynk_write_handler_t handler) {}
+#endif // CONFIG_GOLDIE_BLYNK
+
 #ifdef __cplusplus
 }
 #endif
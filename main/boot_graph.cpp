@@ -0,0 +1,141 @@
+#include "boot_graph.h"
+#include "boot_trace.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+
+static const char *TAG = "boot_graph";
+
+// Event group: bits 0..BOOT_GRAPH_MAX-1 = stage done, then one per helper gone
+#define EXITED_BIT(w)  (1u << (BOOT_GRAPH_MAX + (w)))
+
+static_assert(BOOT_GRAPH_MAX + BOOT_GRAPH_WORKERS <= 24, "event groups hold 24 bits");
+
+typedef struct {
+    const boot_stage_t *stages;
+    size_t count;
+    uint32_t all;               // One bit per stage
+    uint32_t claimed;           // Taken by a runner (under graph_lock)
+    EventGroupHandle_t events;
+} boot_graph_t;
+
+static portMUX_TYPE graph_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Take and run ready stages until none is left to take
+ */
+static void graph_drain(boot_graph_t *g)
+{
+    for (;;) {
+        uint32_t done = (uint32_t)xEventGroupGetBits(g->events) & g->all;
+        int pick = -1;
+        portENTER_CRITICAL(&graph_lock);
+        for (size_t i = 0; i < g->count; i++) {
+            uint32_t bit = BOOT_AFTER(i);
+            if (!(g->claimed & bit) && (g->stages[i].after & ~done) == 0) {
+                g->claimed |= bit;
+                pick = (int)i;
+                break;
+            }
+        }
+        bool all_claimed = g->claimed == g->all;
+        portEXIT_CRITICAL(&graph_lock);
+
+        if (pick >= 0) {
+            const boot_stage_t *s = &g->stages[pick];
+            int64_t t0 = esp_timer_get_time();
+            s->run();
+            boot_trace_span(s->name, t0);
+            ESP_LOGD(TAG, "%s done on core %d", s->name, xPortGetCoreID());
+            xEventGroupSetBits(g->events, BOOT_AFTER(pick));
+        } else if (all_claimed) {
+            return;
+        } else {
+            // Wakes on any stage finishing (at once if one did since the read)
+            xEventGroupWaitBits(g->events, g->all & ~done, pdFALSE, pdFALSE, portMAX_DELAY);
+        }
+    }
+}
+
+typedef struct {
+    boot_graph_t *graph;
+    int index;
+} boot_worker_t;
+
+static void boot_worker(void *arg)
+{
+    boot_worker_t *w = (boot_worker_t *)arg;
+    graph_drain(w->graph);
+    xEventGroupSetBits(w->graph->events, EXITED_BIT(w->index));
+    vTaskDelete(NULL);
+}
+
+extern "C" void boot_graph_run(const boot_stage_t *stages, size_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    if (count > BOOT_GRAPH_MAX) {
+        ESP_LOGE(TAG, "%u stages, only %d fit - running the first %d", (unsigned)count, BOOT_GRAPH_MAX,
+                 BOOT_GRAPH_MAX);
+        count = BOOT_GRAPH_MAX;
+    }
+
+    boot_graph_t g = {};
+    g.stages = stages;
+    g.count = count;
+    g.all = BOOT_AFTER(count) - 1;
+    bool ordered = true;
+    for (size_t i = 0; i < count; i++) {
+        if (stages[i].after & ~(BOOT_AFTER(i) - 1)) {
+            ESP_LOGE(TAG, "Stage %s waits for itself or a later stage", stages[i].name);
+            ordered = false;
+        }
+    }
+    g.events = xEventGroupCreate();
+    if (!ordered || g.events == NULL) {
+        // Table order: nothing is run before a stage it might need
+        for (size_t i = 0; i < count; i++) {
+            int64_t t0 = esp_timer_get_time();
+            stages[i].run();
+            boot_trace_span(stages[i].name, t0);
+        }
+        if (g.events != NULL) {
+            vEventGroupDelete(g.events);
+        }
+        return;
+    }
+
+    boot_worker_t workers[BOOT_GRAPH_WORKERS];
+    uint32_t started = 0;
+#if CONFIG_GOLDIE_BOOT_PARALLEL
+    UBaseType_t prio = uxTaskPriorityGet(NULL);
+    for (int i = 0; i < BOOT_GRAPH_WORKERS; i++) {
+        workers[i].graph = &g;
+        workers[i].index = i;
+        // app_main sits on core 0: the first helper takes core 1
+        BaseType_t core = i == 0 && portNUM_PROCESSORS > 1 ? 1 : tskNO_AFFINITY;
+        if (xTaskCreatePinnedToCore(boot_worker, "boot_graph", BOOT_GRAPH_STACK, &workers[i], prio, NULL,
+                                    core) == pdPASS) {
+            started |= EXITED_BIT(i);
+        } else {
+            ESP_LOGW(TAG, "Helper %d not started - fewer stages side by side", i);
+        }
+    }
+#else
+    (void)workers;
+#endif
+
+    int64_t t0 = esp_timer_get_time();
+    graph_drain(&g);
+    // Stages still running on a helper finish before it leaves
+    if (started) {
+        xEventGroupWaitBits(g.events, started, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+    ESP_LOGI(TAG, "%u stages in %d ms (%d helper task(s))", (unsigned)count,
+             (int)((esp_timer_get_time() - t0) / 1000), __builtin_popcount(started));
+    vEventGroupDelete(g.events);
+    vTaskDelay(1);    // Idle tasks free the helpers' stacks
+}
@@ -0,0 +1,53 @@
+#ifndef BOOT_GRAPH_H
+#define BOOT_GRAPH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Boot graph - hardware bring-up as a dependency graph
+//
+// Each stage names the earlier stages it waits for (a bit mask of their
+// indices, BOOT_AFTER()). boot_graph_run() starts BOOT_GRAPH_WORKERS
+// short-lived helper tasks (one pinned to core 1, one free) and, with the
+// calling task, runs every stage as soon as its dependencies are done: the
+// SD card and storage mounts overlap the panel reset delays instead of
+// queueing behind them. Each stage is recorded with boot_trace_span().
+//
+// Returns once every stage has finished and the helpers are gone (their
+// stacks freed again, so a heap-sized allocation afterwards - the LVGL
+// draw buffers - sees the same free RAM as before). Stages only wait for
+// earlier entries, so table order is a valid serial order too; that is
+// what runs with CONFIG_GOLDIE_BOOT_PARALLEL off or if no helper starts.
+
+#ifndef CONFIG_GOLDIE_BOOT_PARALLEL
+#define CONFIG_GOLDIE_BOOT_PARALLEL 0
+#endif
+
+#define BOOT_GRAPH_MAX      16
+#define BOOT_GRAPH_WORKERS  2
+#define BOOT_GRAPH_STACK    6144     // Bytes; SD mount and panel init need the most
+
+#define BOOT_AFTER(stage)   (1u << (stage))
+
+typedef struct {
+    const char *name;       // Boot trace label (static string)
+    void (*run)(void);
+    uint32_t after;         // BOOT_AFTER() of each stage this one needs
+} boot_stage_t;
+
+/**
+ * @brief Run the stages, independent ones concurrently (app_main only)
+ * @param stages Table in dependency order, at most BOOT_GRAPH_MAX entries
+ */
+void boot_graph_run(const boot_stage_t *stages, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BOOT_GRAPH_H
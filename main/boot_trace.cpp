@@ -0,0 +1,69 @@
+#include "boot_trace.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "boot_trace";
+
+typedef struct {
+    const char *stage;
+    int64_t start_us;                    // 0: started at the previous mark
+    int64_t at_us;
+    uint32_t free_internal;
+} boot_trace_entry_t;
+
+static boot_trace_entry_t ring[BOOT_TRACE_MAX];
+static uint32_t marks = 0;               // Ever recorded; ring holds the last BOOT_TRACE_MAX
+static portMUX_TYPE trace_lock = portMUX_INITIALIZER_UNLOCKED;
+
+extern "C" void boot_trace_mark(const char *stage)
+{
+    boot_trace_span(stage, 0);
+}
+
+extern "C" void boot_trace_span(const char *stage, int64_t start_us)
+{
+    int64_t now = esp_timer_get_time();
+    uint32_t free_internal = (uint32_t)heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    portENTER_CRITICAL(&trace_lock);
+    boot_trace_entry_t *e = &ring[marks % BOOT_TRACE_MAX];
+    e->stage = stage;
+    e->start_us = start_us;
+    e->at_us = now;
+    e->free_internal = free_internal;
+    marks++;
+    portEXIT_CRITICAL(&trace_lock);
+}
+
+extern "C" void boot_trace_dump(void)
+{
+    boot_trace_entry_t copy[BOOT_TRACE_MAX];
+    uint32_t count, first;
+    portENTER_CRITICAL(&trace_lock);
+    count = marks < BOOT_TRACE_MAX ? marks : BOOT_TRACE_MAX;
+    first = marks - count;
+    for (uint32_t i = 0; i < count; i++) {
+        copy[i] = ring[(first + i) % BOOT_TRACE_MAX];
+    }
+    portEXIT_CRITICAL(&trace_lock);
+
+    if (count == 0) {
+        ESP_LOGI(TAG, "No boot stages recorded");
+        return;
+    }
+    // Durations: from the previous mark (timer start for the very first),
+    // spans from their own start (they overlap, so the shares add up to more)
+    int64_t start = first == 0 ? 0 : copy[0].at_us;
+    int64_t total = copy[count - 1].at_us - start;
+    ESP_LOGI(TAG, "%-20s %9s %9s %5s %9s", "Stage", "End ms", "Took ms", "%", "Heap KB");
+    for (uint32_t i = 0; i < count; i++) {
+        int64_t took = copy[i].at_us - (copy[i].start_us > 0 ? copy[i].start_us : i > 0 ? copy[i - 1].at_us : start);
+        ESP_LOGI(TAG, "%-20s %9.1f %9.1f %5.1f %9lu", copy[i].stage, copy[i].at_us / 1000.0, took / 1000.0,
+                 total > 0 ? 100.0 * took / total : 0.0, (unsigned long)(copy[i].free_internal / 1024));
+    }
+    if (first > 0) {
+        ESP_LOGI(TAG, "(%lu earlier stage(s) overwritten)", (unsigned long)first);
+    }
+    ESP_LOGI(TAG, "%-20s %9.1f ms", "Total", total / 1000.0);
+}
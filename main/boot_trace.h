@@ -0,0 +1,46 @@
+#ifndef BOOT_TRACE_H
+#define BOOT_TRACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Boot trace - where the time to the first pixel goes
+//
+// Call boot_trace_mark() at the END of each init stage: the entry keeps
+// esp_timer_get_time() and the free internal heap, and the stage took the
+// time since the previous mark (the first one since the timer started, so
+// it holds the bootloader and startup code). Entries sit in a ring of
+// BOOT_TRACE_MAX; later marks (WiFi, first SNTP answer) overwrite the
+// oldest once it is full. Stages that run side by side (boot_graph) use
+// boot_trace_span() with their own start time instead.
+//
+// The table is logged when the first frame of the dashboard reaches the
+// panel and again whenever boot_trace_dump() is called (dashboard logs).
+// Any task; a mark costs a few microseconds.
+
+#define BOOT_TRACE_MAX  32
+
+/**
+ * @brief Record the end of a stage
+ * @param stage Static string (kept by pointer)
+ */
+void boot_trace_mark(const char *stage);
+
+/**
+ * @brief Record a stage that started at start_us (esp_timer_get_time())
+ */
+void boot_trace_span(const char *stage, int64_t start_us);
+
+/**
+ * @brief Log the table: stage, end time, duration, share, free heap
+ */
+void boot_trace_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BOOT_TRACE_H
@@ -0,0 +1,313 @@
+#include "cbor_lite.h"
+#include <string.h>
+
+#define CBOR_MAJOR_UINT    0
+#define CBOR_MAJOR_NINT    1
+#define CBOR_MAJOR_BYTES   2
+#define CBOR_MAJOR_TEXT    3
+#define CBOR_MAJOR_ARRAY   4
+#define CBOR_MAJOR_MAP     5
+#define CBOR_MAJOR_TAG     6
+#define CBOR_MAJOR_SIMPLE  7
+
+#define CBOR_FALSE         20
+#define CBOR_TRUE          21
+#define CBOR_NULL          22
+#define CBOR_FLOAT16       25
+#define CBOR_FLOAT32       26
+#define CBOR_FLOAT64       27
+#define CBOR_INDEFINITE    31
+
+#define CBOR_NEST_MAX      8     // cbor_skip() depth
+
+// ═══════════════════════════════════════════════════════════════════════════
+// WRITER
+// ═══════════════════════════════════════════════════════════════════════════
+
+void cbor_writer_init(cbor_writer_t *w, void *buf, size_t size)
+{
+    w->buf = (uint8_t *)buf;
+    w->size = size;
+    w->len = 0;
+    w->overflow = false;
+}
+
+static bool put_bytes(cbor_writer_t *w, const void *data, size_t n)
+{
+    if (w->len + n > w->size) {
+        w->overflow = true;
+        return false;
+    }
+    memcpy(w->buf + w->len, data, n);
+    w->len += n;
+    return true;
+}
+
+// Head of an item: major type and shortest argument encoding
+static bool put_head(cbor_writer_t *w, uint8_t major, uint64_t v)
+{
+    uint8_t head[9];
+    size_t n;
+    if (v < 24) {
+        head[0] = (uint8_t)(major << 5 | v);
+        n = 1;
+    } else if (v <= 0xFF) {
+        head[0] = (uint8_t)(major << 5 | 24);
+        head[1] = (uint8_t)v;
+        n = 2;
+    } else if (v <= 0xFFFF) {
+        head[0] = (uint8_t)(major << 5 | 25);
+        head[1] = (uint8_t)(v >> 8);
+        head[2] = (uint8_t)v;
+        n = 3;
+    } else if (v <= 0xFFFFFFFFull) {
+        head[0] = (uint8_t)(major << 5 | 26);
+        for (int i = 0; i < 4; i++) {
+            head[1 + i] = (uint8_t)(v >> (24 - 8 * i));
+        }
+        n = 5;
+    } else {
+        head[0] = (uint8_t)(major << 5 | 27);
+        for (int i = 0; i < 8; i++) {
+            head[1 + i] = (uint8_t)(v >> (56 - 8 * i));
+        }
+        n = 9;
+    }
+    return put_bytes(w, head, n);
+}
+
+void cbor_put_uint(cbor_writer_t *w, uint64_t v)
+{
+    put_head(w, CBOR_MAJOR_UINT, v);
+}
+
+void cbor_put_int(cbor_writer_t *w, int64_t v)
+{
+    if (v >= 0) {
+        put_head(w, CBOR_MAJOR_UINT, (uint64_t)v);
+    } else {
+        put_head(w, CBOR_MAJOR_NINT, (uint64_t)(-1 - v));
+    }
+}
+
+void cbor_put_float(cbor_writer_t *w, float v)
+{
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    uint8_t item[5] = {
+        (uint8_t)(CBOR_MAJOR_SIMPLE << 5 | CBOR_FLOAT32),
+        (uint8_t)(bits >> 24), (uint8_t)(bits >> 16), (uint8_t)(bits >> 8), (uint8_t)bits,
+    };
+    put_bytes(w, item, sizeof(item));
+}
+
+void cbor_put_bool(cbor_writer_t *w, bool v)
+{
+    uint8_t item = (uint8_t)(CBOR_MAJOR_SIMPLE << 5 | (v ? CBOR_TRUE : CBOR_FALSE));
+    put_bytes(w, &item, 1);
+}
+
+void cbor_put_text(cbor_writer_t *w, const char *s)
+{
+    cbor_put_text_n(w, s, s ? strlen(s) : 0);
+}
+
+void cbor_put_text_n(cbor_writer_t *w, const char *s, size_t n)
+{
+    size_t start = w->len;
+    if (!put_head(w, CBOR_MAJOR_TEXT, n) || (n > 0 && !put_bytes(w, s, n))) {
+        w->len = start;    // Whole items only
+    }
+}
+
+void cbor_put_array(cbor_writer_t *w, size_t count)
+{
+    put_head(w, CBOR_MAJOR_ARRAY, count);
+}
+
+void cbor_put_map(cbor_writer_t *w, size_t count)
+{
+    put_head(w, CBOR_MAJOR_MAP, count);
+}
+
+void cbor_put_array_open(cbor_writer_t *w)
+{
+    uint8_t item = (uint8_t)(CBOR_MAJOR_ARRAY << 5 | CBOR_INDEFINITE);
+    put_bytes(w, &item, 1);
+}
+
+void cbor_put_break(cbor_writer_t *w)
+{
+    uint8_t item = 0xFF;
+    put_bytes(w, &item, 1);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// READER
+// ═══════════════════════════════════════════════════════════════════════════
+
+void cbor_reader_init(cbor_reader_t *r, const void *buf, size_t len)
+{
+    r->buf = (const uint8_t *)buf;
+    r->len = len;
+    r->pos = 0;
+    r->error = false;
+}
+
+static bool read_be(cbor_reader_t *r, size_t n, uint64_t *v)
+{
+    if (r->pos + n > r->len) {
+        r->error = true;
+        return false;
+    }
+    *v = 0;
+    for (size_t i = 0; i < n; i++) {
+        *v = (*v << 8) | r->buf[r->pos++];
+    }
+    return true;
+}
+
+static double half_to_double(uint16_t h)
+{
+    int exp = (h >> 10) & 0x1F;
+    int mant = h & 0x3FF;
+    double v;
+    if (exp == 0) {
+        v = mant / 16777216.0;                         // mant * 2^-24
+    } else if (exp == 31) {
+        v = mant ? 0.0 / 0.0 : 1.0 / 0.0;
+    } else {
+        v = (1024 + mant) / 1024.0;
+        for (; exp > 15; exp--) v *= 2.0;
+        for (; exp < 15; exp++) v /= 2.0;
+    }
+    return (h & 0x8000) ? -v : v;
+}
+
+bool cbor_next(cbor_reader_t *r, cbor_item_t *item)
+{
+    if (r->error || r->pos >= r->len) {
+        return false;
+    }
+    uint8_t ib = r->buf[r->pos++];
+    uint8_t major = ib >> 5;
+    uint8_t info = ib & 0x1F;
+    uint64_t arg = info;
+    memset(item, 0, sizeof(*item));
+
+    if (major == CBOR_MAJOR_SIMPLE) {
+        switch (info) {
+            case CBOR_FALSE:
+            case CBOR_TRUE:
+                item->type = CBOR_ITEM_BOOL;
+                item->boolean = info == CBOR_TRUE;
+                return true;
+            case CBOR_NULL:
+                item->type = CBOR_ITEM_NULL;
+                return true;
+            case CBOR_FLOAT16:
+                if (!read_be(r, 2, &arg)) return false;
+                item->type = CBOR_ITEM_FLOAT;
+                item->number = half_to_double((uint16_t)arg);
+                return true;
+            case CBOR_FLOAT32: {
+                if (!read_be(r, 4, &arg)) return false;
+                uint32_t bits = (uint32_t)arg;
+                float f;
+                memcpy(&f, &bits, sizeof(f));
+                item->type = CBOR_ITEM_FLOAT;
+                item->number = f;
+                return true;
+            }
+            case CBOR_FLOAT64:
+                if (!read_be(r, 8, &arg)) return false;
+                item->type = CBOR_ITEM_FLOAT;
+                memcpy(&item->number, &arg, sizeof(item->number));
+                return true;
+            default:
+                if (info >= 24) {    // Other simple values, break, reserved
+                    r->error = true;
+                    return false;
+                }
+                item->type = CBOR_ITEM_OTHER;
+                return true;
+        }
+    }
+
+    if (info == CBOR_INDEFINITE || info > 27) {
+        r->error = true;
+        return false;
+    }
+    if (info >= 24 && !read_be(r, (size_t)1 << (info - 24), &arg)) {
+        return false;
+    }
+    item->count = arg;
+    switch (major) {
+        case CBOR_MAJOR_UINT:
+            item->type = CBOR_ITEM_UINT;
+            item->number = (double)arg;
+            return true;
+        case CBOR_MAJOR_NINT:
+            item->type = CBOR_ITEM_NINT;
+            item->number = -1.0 - (double)arg;
+            return true;
+        case CBOR_MAJOR_TEXT:
+            if (arg > r->len - r->pos) {
+                r->error = true;
+                return false;
+            }
+            item->type = CBOR_ITEM_TEXT;
+            item->text = (const char *)r->buf + r->pos;
+            r->pos += (size_t)arg;
+            return true;
+        case CBOR_MAJOR_ARRAY:
+            item->type = CBOR_ITEM_ARRAY;
+            return true;
+        case CBOR_MAJOR_MAP:
+            item->type = CBOR_ITEM_MAP;
+            return true;
+        case CBOR_MAJOR_TAG:
+            item->type = CBOR_ITEM_OTHER;    // The tagged item follows on its own
+            return true;
+        default:                             // Byte strings
+            r->error = true;
+            return false;
+    }
+}
+
+bool cbor_skip(cbor_reader_t *r, const cbor_item_t *item)
+{
+    // Items still to read per open container
+    uint64_t pending[CBOR_NEST_MAX];
+    int depth = 0;
+    if (item->type == CBOR_ITEM_ARRAY || item->type == CBOR_ITEM_MAP) {
+        pending[depth++] = item->type == CBOR_ITEM_MAP ? item->count * 2 : item->count;
+    } else if (item->type == CBOR_ITEM_OTHER && item->count != 0) {
+        pending[depth++] = 1;                // Tag: its item
+    }
+    while (depth > 0) {
+        if (pending[depth - 1] == 0) {
+            depth--;
+            continue;
+        }
+        pending[depth - 1]--;
+        cbor_item_t inner;
+        if (!cbor_next(r, &inner)) {
+            return false;
+        }
+        if (inner.type == CBOR_ITEM_ARRAY || inner.type == CBOR_ITEM_MAP) {
+            if (depth == CBOR_NEST_MAX) {
+                r->error = true;
+                return false;
+            }
+            pending[depth++] = inner.type == CBOR_ITEM_MAP ? inner.count * 2 : inner.count;
+        }
+    }
+    return true;
+}
+
+bool cbor_text_eq(const cbor_item_t *item, const char *s)
+{
+    size_t n = strlen(s);
+    return item->type == CBOR_ITEM_TEXT && item->count == n && memcmp(item->text, s, n) == 0;
+}
@@ -0,0 +1,92 @@
+#ifndef CBOR_LITE_H
+#define CBOR_LITE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Minimal CBOR (RFC 8949) for the device API
+//
+// Writer: appends items to a caller buffer; a write that does not fit sets
+// `overflow` and leaves the buffer as it was before that item, so the
+// caller can flush and retry. Floats go out as float32, which holds every
+// value the dashboard has.
+//
+// Reader: walks one item at a time over a complete buffer. Enough for flat
+// maps of text keys to numbers, text and booleans (configuration writes);
+// anything it cannot represent sets `error`. No heap, no tree.
+
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    size_t len;
+    bool overflow;
+} cbor_writer_t;
+
+typedef struct {
+    const uint8_t *buf;
+    size_t len;
+    size_t pos;
+    bool error;
+} cbor_reader_t;
+
+typedef enum {
+    CBOR_ITEM_UINT,
+    CBOR_ITEM_NINT,
+    CBOR_ITEM_TEXT,
+    CBOR_ITEM_ARRAY,
+    CBOR_ITEM_MAP,
+    CBOR_ITEM_FLOAT,
+    CBOR_ITEM_BOOL,
+    CBOR_ITEM_NULL,
+    CBOR_ITEM_OTHER,
+} cbor_item_type_t;
+
+typedef struct {
+    cbor_item_type_t type;
+    uint64_t count;            // UINT / NINT value, TEXT length, ARRAY / MAP entries
+    double number;             // FLOAT value (and UINT / NINT as a number)
+    bool boolean;
+    const char *text;          // TEXT bytes (not NUL-terminated)
+} cbor_item_t;
+
+void cbor_writer_init(cbor_writer_t *w, void *buf, size_t size);
+void cbor_put_uint(cbor_writer_t *w, uint64_t v);
+void cbor_put_int(cbor_writer_t *w, int64_t v);
+void cbor_put_float(cbor_writer_t *w, float v);
+void cbor_put_bool(cbor_writer_t *w, bool v);
+void cbor_put_text(cbor_writer_t *w, const char *s);
+void cbor_put_text_n(cbor_writer_t *w, const char *s, size_t n);
+void cbor_put_array(cbor_writer_t *w, size_t count);
+void cbor_put_map(cbor_writer_t *w, size_t count);
+void cbor_put_array_open(cbor_writer_t *w);     // Indefinite length
+void cbor_put_break(cbor_writer_t *w);          // Closes it
+
+void cbor_reader_init(cbor_reader_t *r, const void *buf, size_t len);
+
+/**
+ * @brief Read the next item head (and a TEXT / FLOAT / simple value)
+ * @return false at the end of the buffer or on malformed input
+ *         (indefinite lengths and byte strings are not supported)
+ */
+bool cbor_next(cbor_reader_t *r, cbor_item_t *item);
+
+/**
+ * @brief Skip the rest of an item read with cbor_next() (its contents)
+ */
+bool cbor_skip(cbor_reader_t *r, const cbor_item_t *item);
+
+/**
+ * @brief true if a TEXT item equals s
+ */
+bool cbor_text_eq(const cbor_item_t *item, const char *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CBOR_LITE_H
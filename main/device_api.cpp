@@ -0,0 +1,598 @@
+#include "device_api.h"
+#include "web_server.h"
+#include "cbor_lite.h"
+#include "dashboard.h"
+#include "ui/ui_perf.h"
+#include "ui/render_bench.h"
+#include "messages.h"
+#include "msg_bus.h"
+#include "text_buf.h"
+#include "evt_trace.h"
+#include "metrics.h"
+#include "i2c_sched.h"
+#include "io_sched.h"
+#include "gemini_api.h"
+#include "anim/frame_cache.h"
+#include "asset_bundle.h"
+#include "asset_ota.h"
+#include "firmware_ota.h"
+#if CONFIG_GOLDIE_POWER_MONITOR
+#include "power_monitor.h"
+#endif
+#include "esp_wifi.h"
+#include "esp_ota_ops.h"
+#include "esp_heap_caps.h"
+#include "esp_lvgl_port.h"
+#include "mdns.h"
+#include "esp_log.h"
+#include "time_svc.h"
+#include <string.h>
+
+static const char *TAG = "device_api";
+
+#define DEVICE_API_HOSTNAME  "ESP32_Aquarium"   // Same as the station hostname
+#define DEVICE_API_LOCK_MS   200                // Dashboard writes from the server task
+
+static bool registered = false;
+static msg_bus_sub_t *snapshot_sub = NULL;
+
+// Sampled when /metrics is scraped (metrics.h)
+static metric_t *m_uptime = NULL;
+static metric_t *m_wifi_up = NULL;
+static metric_t *m_wifi_rssi = NULL;
+static metric_t *m_heap_internal = NULL;
+static metric_t *m_heap_psram = NULL;
+static metric_t *m_frames_shown = NULL;
+static metric_t *m_frames_skipped = NULL;
+static metric_t *m_cache_hits = NULL;
+static metric_t *m_cache_misses = NULL;
+static metric_t *m_i2c_util = NULL;
+static metric_t *m_i2c_touch_wait = NULL;
+static metric_t *m_io_util[IO_SCHED_DEV_COUNT] = {};
+static metric_t *m_io_frame_wait[IO_SCHED_DEV_COUNT] = {};
+#if CONFIG_GOLDIE_POWER_MONITOR
+static metric_t *m_batt_mv = NULL;
+static metric_t *m_batt_pct = NULL;
+static metric_t *m_vbus = NULL;
+#endif
+
+// Server task only (handlers run there one at a time)
+static blynk_sync_msg_t latest = {};
+static bool have_latest = false;
+static uint8_t reply[DEVICE_API_STATE_MAX];
+
+/**
+ * @brief Take the newest snapshot, if one arrived since the last request
+ */
+static void refresh_latest(void)
+{
+    const msg_bus_msg_t *msg = msg_bus_receive(snapshot_sub, 0);
+    if (msg == NULL) {
+        return;
+    }
+    const blynk_sync_msg_t *s = MSG_BUS_PAYLOAD(msg, blynk_sync_msg_t);
+    text_buf_ref(s->ai_advice);
+    if (have_latest) {
+        text_buf_unref(latest.ai_advice);
+    }
+    latest = *s;
+    have_latest = true;
+    msg_bus_release(msg);
+}
+
+static esp_err_t state_handler(httpd_req_t *req)
+{
+    if (snapshot_sub != NULL) {
+        refresh_latest();
+    }
+    if (!have_latest) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        return httpd_resp_sendstr(req, "No snapshot yet - retry later");
+    }
+
+    cbor_writer_t w;
+    cbor_writer_init(&w, reply, sizeof(reply));
+    cbor_put_map(&w, 9);
+    cbor_put_text(&w, "t");       cbor_put_uint(&w, latest.timestamp);
+    cbor_put_text(&w, "mood");    cbor_put_text(&w, latest.mood);
+    cbor_put_text(&w, "ammonia"); cbor_put_float(&w, latest.ammonia_ppm);
+    cbor_put_text(&w, "nitrite"); cbor_put_float(&w, latest.nitrite_ppm);
+    cbor_put_text(&w, "nitrate"); cbor_put_float(&w, latest.nitrate_ppm);
+    cbor_put_text(&w, "ph");      cbor_put_float(&w, latest.ph_level);
+    cbor_put_text(&w, "feed_h");  cbor_put_float(&w, latest.feed_hours);
+    cbor_put_text(&w, "clean_d"); cbor_put_float(&w, latest.clean_days);
+    cbor_put_text(&w, "advice");
+    if (w.overflow) {
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "State too large");
+    }
+
+    // Advice last: cut it (on a UTF-8 boundary) to what is left
+    const char *advice = text_buf_str(latest.ai_advice);
+    size_t advice_len = advice ? strlen(advice) : 0;
+    size_t room = sizeof(reply) - w.len - 3;       // Text head of up to 3 bytes
+    if (advice_len > room) {
+        advice_len = room;
+        while (advice_len > 0 && ((uint8_t)advice[advice_len] & 0xC0) == 0x80) {
+            advice_len--;
+        }
+    }
+    cbor_put_text_n(&w, advice, advice_len);
+
+    httpd_resp_set_type(req, "application/cbor");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    return httpd_resp_send(req, (const char *)reply, w.len);
+}
+
+static esp_err_t perf_handler(httpd_req_t *req)
+{
+    static uint8_t perf_reply[DEVICE_API_PERF_MAX];
+    ui_perf_stats_t s;
+    if (!ui_perf_get(UI_PERF_SCREEN_ANIMATION, &s)) {
+        return httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "UI counters off (CONFIG_GOLDIE_UI_PERF)");
+    }
+
+    cbor_writer_t w;
+    cbor_writer_init(&w, perf_reply, sizeof(perf_reply));
+    cbor_put_map(&w, 2);
+    cbor_put_text(&w, "overlay");
+    cbor_put_bool(&w, ui_perf_overlay_visible());
+    cbor_put_text(&w, "screens");
+    cbor_put_map(&w, UI_PERF_SCREEN_COUNT);
+    for (int i = 0; i < UI_PERF_SCREEN_COUNT; i++) {
+        ui_perf_get((ui_perf_screen_t)i, &s);
+        uint32_t refr = s.refreshes ? s.refreshes : 1;
+        uint32_t flushes = s.flushes ? s.flushes : 1;
+        cbor_put_text(&w, ui_perf_screen_name((ui_perf_screen_t)i));
+        cbor_put_map(&w, 9);
+        cbor_put_text(&w, "refr");       cbor_put_uint(&w, s.refreshes);
+        cbor_put_text(&w, "slow");       cbor_put_uint(&w, s.slow);
+        cbor_put_text(&w, "px");         cbor_put_uint(&w, s.pixels);
+        cbor_put_text(&w, "render_us");  cbor_put_uint(&w, s.render_us / refr);
+        cbor_put_text(&w, "render_max"); cbor_put_uint(&w, s.render_max_us);
+        cbor_put_text(&w, "wait_us");    cbor_put_uint(&w, s.wait_us / refr);
+        cbor_put_text(&w, "flushes");    cbor_put_uint(&w, s.flushes);
+        cbor_put_text(&w, "flush_us");   cbor_put_uint(&w, s.flush_us / flushes);
+        cbor_put_text(&w, "flush_max");  cbor_put_uint(&w, s.flush_max_us);
+    }
+    if (w.overflow) {
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Counters too large");
+    }
+
+    httpd_resp_set_type(req, "application/cbor");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    return httpd_resp_send(req, (const char *)perf_reply, w.len);
+}
+
+static void metrics_register_sampled(void)
+{
+    m_uptime = metrics_gauge("goldie_uptime_seconds", NULL, "Seconds since boot");
+    m_wifi_up = metrics_gauge("goldie_wifi_connected", NULL, "1 while the station has an IP");
+    m_wifi_rssi = metrics_gauge("goldie_wifi_rssi_dbm", NULL, "Signal of the associated AP (0 = not associated)");
+    m_heap_internal = metrics_gauge("goldie_heap_free_bytes", "region=\"internal\"", "Free heap per region");
+    m_heap_psram = metrics_gauge("goldie_heap_free_bytes", "region=\"psram\"", "Free heap per region");
+    m_frames_shown = metrics_counter("goldie_anim_frames_total", "result=\"shown\"", "Animation frames by pacer outcome");
+    m_frames_skipped = metrics_counter("goldie_anim_frames_total", "result=\"skipped\"", "Animation frames by pacer outcome");
+    m_cache_hits = metrics_counter("goldie_frame_cache_total", "result=\"hit\"", "Frame cache lookups");
+    m_cache_misses = metrics_counter("goldie_frame_cache_total", "result=\"miss\"", "Frame cache lookups");
+    m_i2c_util = metrics_gauge("goldie_i2c_busy_pct", NULL, "Shared I2C bus held, last window (i2c_sched.h)");
+    m_i2c_touch_wait = metrics_gauge("goldie_i2c_touch_wait_max_us", NULL, "Longest touch wait for the I2C bus, last window");
+    m_io_util[IO_SCHED_SD] = metrics_gauge("goldie_io_busy_pct", "device=\"sd\"", "Storage device held, last window (io_sched.h)");
+    m_io_util[IO_SCHED_FLASH] = metrics_gauge("goldie_io_busy_pct", "device=\"flash\"", "Storage device held, last window (io_sched.h)");
+    m_io_frame_wait[IO_SCHED_SD] = metrics_gauge("goldie_io_frame_wait_max_us", "device=\"sd\"", "Longest frame load wait for the device, last window");
+    m_io_frame_wait[IO_SCHED_FLASH] = metrics_gauge("goldie_io_frame_wait_max_us", "device=\"flash\"", "Longest frame load wait for the device, last window");
+#if CONFIG_GOLDIE_POWER_MONITOR
+    m_batt_mv = metrics_gauge("goldie_battery_millivolts", NULL, "Battery voltage (0 = no battery)");
+    m_batt_pct = metrics_gauge("goldie_battery_percent", NULL, "Fuel gauge (-1 = no battery)");
+    m_vbus = metrics_gauge("goldie_usb_power", NULL, "1 while VBUS is present");
+#endif
+}
+
+/**
+ * @brief Bring the sampled metrics up to date before an export
+ */
+static void metrics_sample(void)
+{
+    metrics_set(m_uptime, (int32_t)time_svc_uptime_s());
+    metrics_set(m_wifi_up, gemini_is_wifi_connected() ? 1 : 0);
+    wifi_ap_record_t ap;
+    metrics_set(m_wifi_rssi, esp_wifi_sta_get_ap_info(&ap) == ESP_OK ? ap.rssi : 0);
+    metrics_set(m_heap_internal, (int32_t)heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    metrics_set(m_heap_psram, (int32_t)heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
+    i2c_sched_stats_t i2c;
+    i2c_sched_get_stats(&i2c);
+    metrics_set(m_i2c_util, i2c.util_pct);
+    metrics_set(m_i2c_touch_wait, (int32_t)i2c.wait_max_us[I2C_SCHED_TOUCH]);
+    for (int d = 0; d < IO_SCHED_DEV_COUNT; d++) {
+        io_sched_stats_t io;
+        io_sched_get_stats((io_sched_dev_t)d, &io);
+        metrics_set(m_io_util[d], io.util_pct);
+        metrics_set(m_io_frame_wait[d], (int32_t)io.wait_max_us[IO_SCHED_FRAME]);
+    }
+#if CONFIG_GOLDIE_POWER_MONITOR
+    power_status_t power;
+    if (power_monitor_get(&power)) {
+        metrics_set(m_batt_mv, power.batt_mv);
+        metrics_set(m_batt_pct, power.batt_pct);
+        metrics_set(m_vbus, (power.flags & POWER_FLAG_VBUS) ? 1 : 0);
+    }
+#endif
+    frame_cache_stats_t cs;
+    frame_cache_get_stats(&cs);
+    metrics_set(m_cache_hits, (int32_t)cs.hits);
+    metrics_set(m_cache_misses, (int32_t)cs.misses);
+    uint32_t shown = 0;
+    uint32_t skipped = 0;
+    dashboard_get_anim_counts(&shown, &skipped);
+    metrics_set(m_frames_shown, (int32_t)shown);
+    metrics_set(m_frames_skipped, (int32_t)skipped);
+}
+
+static bool metrics_chunk(void *ctx, const char *data, size_t len)
+{
+    return httpd_resp_send_chunk((httpd_req_t *)ctx, data, (ssize_t)len) == ESP_OK;
+}
+
+static esp_err_t metrics_handler(httpd_req_t *req)
+{
+    metrics_sample();
+    httpd_resp_set_type(req, "text/plain; version=0.0.4");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    if (!metrics_export(metrics_chunk, req)) {
+        httpd_resp_send_chunk(req, NULL, 0);
+        return ESP_FAIL;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+static bool trace_chunk(void *ctx, const char *data, size_t len)
+{
+    return httpd_resp_send_chunk((httpd_req_t *)ctx, data, (ssize_t)len) == ESP_OK;
+}
+
+static esp_err_t trace_handler(httpd_req_t *req)
+{
+    if (!CONFIG_GOLDIE_EVT_TRACE) {
+        return httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Event trace off (CONFIG_GOLDIE_EVT_TRACE)");
+    }
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"trace.json\"");
+    if (!evt_trace_dump(trace_chunk, req)) {
+        // Headers are out already; ending the chunked reply early is all that is left
+        httpd_resp_send_chunk(req, NULL, 0);
+        return ESP_FAIL;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+/**
+ * @brief Receive the whole request body (content_len bytes)
+ */
+static bool recv_body(httpd_req_t *req, uint8_t *body)
+{
+    size_t got = 0;
+    while (got < req->content_len) {
+        int n = httpd_req_recv(req, (char *)body + got, req->content_len - got);
+        if (n == HTTPD_SOCK_ERR_TIMEOUT) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        got += (size_t)n;
+    }
+    return true;
+}
+
+static esp_err_t config_handler(httpd_req_t *req)
+{
+    uint8_t body[DEVICE_API_CONFIG_MAX];
+    if (req->content_len == 0 || req->content_len > sizeof(body)) {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Body must be a CBOR map up to 256 bytes");
+    }
+    if (!recv_body(req, body)) {
+        return ESP_FAIL;
+    }
+    size_t got = req->content_len;
+
+    // Parse everything first, apply only a fully valid request
+    static const char *const PARAMS[] = { "ammonia", "nitrite", "nitrate", "ph" };
+    float value[4];
+    bool set[4] = {};
+    char profile[32] = "";
+    int perf_overlay = -1;                 // -1 = leave as is
+    bool render_bench = false;
+
+    cbor_reader_t r;
+    cbor_item_t map, key, val;
+    cbor_reader_init(&r, body, got);
+    if (!cbor_next(&r, &map) || map.type != CBOR_ITEM_MAP) {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Body must be a CBOR map");
+    }
+    for (uint64_t i = 0; i < map.count; i++) {
+        if (!cbor_next(&r, &key) || key.type != CBOR_ITEM_TEXT || !cbor_next(&r, &val)) {
+            return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Malformed CBOR");
+        }
+        bool numeric = val.type == CBOR_ITEM_FLOAT || val.type == CBOR_ITEM_UINT || val.type == CBOR_ITEM_NINT;
+        bool known = false;
+        for (int p = 0; p < 4; p++) {
+            if (cbor_text_eq(&key, PARAMS[p])) {
+                if (!numeric || val.number < 0 || val.number > (p == 3 ? 14.0 : 1000.0)) {
+                    return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Parameter out of range");
+                }
+                value[p] = (float)val.number;
+                set[p] = true;
+                known = true;
+            }
+        }
+        if (cbor_text_eq(&key, "profile")) {
+            if (val.type != CBOR_ITEM_TEXT || val.count == 0 || val.count >= sizeof(profile)) {
+                return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "profile must be a name");
+            }
+            memcpy(profile, val.text, (size_t)val.count);
+            profile[val.count] = '\0';
+            known = true;
+        }
+        if (cbor_text_eq(&key, "perf_overlay")) {
+            if (val.type != CBOR_ITEM_BOOL) {
+                return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "perf_overlay must be a boolean");
+            }
+            perf_overlay = val.boolean;
+            known = true;
+        }
+        if (cbor_text_eq(&key, "render_bench")) {
+            if (val.type != CBOR_ITEM_BOOL) {
+                return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "render_bench must be a boolean");
+            }
+            render_bench = val.boolean;
+            known = true;
+        }
+        if (!known && !cbor_skip(&r, &val)) {
+            return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Malformed CBOR");
+        }
+    }
+
+    if (!lvgl_port_lock(DEVICE_API_LOCK_MS)) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        return httpd_resp_sendstr(req, "Display busy - retry later");
+    }
+    bool profile_ok = profile[0] == '\0' || dashboard_set_profile(profile);
+    if (set[0]) dashboard_update_ammonia(value[0]);
+    if (set[1]) dashboard_update_nitrite(value[1]);
+    if (set[2]) dashboard_update_nitrate(value[2]);
+    if (set[3]) dashboard_update_ph(value[3]);
+    if (perf_overlay >= 0) ui_perf_overlay_show(perf_overlay != 0);
+    if (render_bench) render_bench_request();
+    lvgl_port_unlock();
+
+    if (!profile_ok) {
+        return httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "No such profile");
+    }
+    ESP_LOGI(TAG, "/api/config applied%s%s", profile[0] ? " - profile " : "", profile);
+    httpd_resp_set_status(req, "204 No Content");
+    return httpd_resp_send(req, NULL, 0);
+}
+
+static esp_err_t assets_get_handler(httpd_req_t *req)
+{
+    asset_ota_status_t st;
+    asset_ota_get_status(&st);
+    const char *source = asset_bundle_source();
+
+    uint8_t out[128];
+    cbor_writer_t w;
+    cbor_writer_init(&w, out, sizeof(out));
+    cbor_put_map(&w, 6);
+    cbor_put_text(&w, "state");      cbor_put_text(&w, asset_ota_state_name(st.state));
+    cbor_put_text(&w, "received");   cbor_put_uint(&w, st.received);
+    cbor_put_text(&w, "total");      cbor_put_int(&w, st.total);
+    cbor_put_text(&w, "error");      cbor_put_text(&w, esp_err_to_name(st.error));
+    cbor_put_text(&w, "source");     cbor_put_text(&w, source ? source : "files");
+    cbor_put_text(&w, "generation"); cbor_put_uint(&w, asset_bundle_generation());
+    if (w.overflow) {
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Status too large");
+    }
+    httpd_resp_set_type(req, "application/cbor");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    return httpd_resp_send(req, (const char *)out, w.len);
+}
+
+/**
+ * @brief The url of a CBOR {url: text} body (replies 400 itself on false)
+ */
+static bool read_url_body(httpd_req_t *req, char *url, size_t url_size)
+{
+    uint8_t body[DEVICE_API_CONFIG_MAX];
+    if (req->content_len == 0 || req->content_len > sizeof(body)) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Body must be a CBOR map up to 256 bytes");
+        return false;
+    }
+    if (!recv_body(req, body)) {
+        return false;
+    }
+
+    url[0] = '\0';
+    cbor_reader_t r;
+    cbor_item_t map, key, val;
+    cbor_reader_init(&r, body, req->content_len);
+    if (!cbor_next(&r, &map) || map.type != CBOR_ITEM_MAP) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Body must be a CBOR map");
+        return false;
+    }
+    for (uint64_t i = 0; i < map.count; i++) {
+        if (!cbor_next(&r, &key) || key.type != CBOR_ITEM_TEXT || !cbor_next(&r, &val)) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Malformed CBOR");
+            return false;
+        }
+        if (cbor_text_eq(&key, "url")) {
+            if (val.type != CBOR_ITEM_TEXT || val.count == 0 || val.count >= url_size) {
+                httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "url must be text");
+                return false;
+            }
+            memcpy(url, val.text, (size_t)val.count);
+            url[val.count] = '\0';
+        } else if (!cbor_skip(&r, &val)) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Malformed CBOR");
+            return false;
+        }
+    }
+    if (url[0] == '\0') {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "url missing");
+        return false;
+    }
+    return true;
+}
+
+static esp_err_t assets_post_handler(httpd_req_t *req)
+{
+    char url[ASSET_OTA_URL_MAX];
+    if (!read_url_body(req, url, sizeof(url))) {
+        return ESP_FAIL;
+    }
+
+    esp_err_t err = asset_ota_start(url);
+    if (err == ESP_ERR_INVALID_STATE) {
+        httpd_resp_set_status(req, "409 Conflict");
+        return httpd_resp_sendstr(req, "A download is running");
+    }
+    if (err == ESP_ERR_NOT_FOUND) {
+        return httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "No assets_a / assets_b partitions");
+    }
+    if (err != ESP_OK) {
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, esp_err_to_name(err));
+    }
+    ESP_LOGI(TAG, "/api/assets: downloading %s", url);
+    httpd_resp_set_status(req, "202 Accepted");
+    return httpd_resp_send(req, NULL, 0);
+}
+
+static esp_err_t firmware_get_handler(httpd_req_t *req)
+{
+    firmware_ota_status_t st;
+    firmware_ota_get_status(&st);
+    const esp_partition_t *running = esp_ota_get_running_partition();
+
+    uint8_t out[192];
+    cbor_writer_t w;
+    cbor_writer_init(&w, out, sizeof(out));
+    cbor_put_map(&w, 7);
+    cbor_put_text(&w, "state");     cbor_put_text(&w, firmware_ota_state_name(st.state));
+    cbor_put_text(&w, "received");  cbor_put_uint(&w, st.received);
+    cbor_put_text(&w, "total");     cbor_put_int(&w, st.total);
+    cbor_put_text(&w, "resumes");   cbor_put_uint(&w, st.resumes);
+    cbor_put_text(&w, "error");     cbor_put_text(&w, esp_err_to_name(st.error));
+    cbor_put_text(&w, "version");   cbor_put_text(&w, firmware_ota_running_version());
+    cbor_put_text(&w, "partition"); cbor_put_text(&w, running ? running->label : "?");
+    if (w.overflow) {
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Status too large");
+    }
+    httpd_resp_set_type(req, "application/cbor");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    return httpd_resp_send(req, (const char *)out, w.len);
+}
+
+static esp_err_t firmware_post_handler(httpd_req_t *req)
+{
+    char url[FIRMWARE_OTA_URL_MAX];
+    if (!read_url_body(req, url, sizeof(url))) {
+        return ESP_FAIL;
+    }
+
+    esp_err_t err = firmware_ota_start(url);
+    if (err == ESP_ERR_INVALID_STATE) {
+        httpd_resp_set_status(req, "409 Conflict");
+        return httpd_resp_sendstr(req, "An update is running");
+    }
+    if (err == ESP_ERR_NOT_FOUND) {
+        return httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "No ota_0 / ota_1 partitions");
+    }
+    if (err != ESP_OK) {
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, esp_err_to_name(err));
+    }
+    ESP_LOGI(TAG, "/api/firmware: updating from %s", url);
+    httpd_resp_set_status(req, "202 Accepted");
+    return httpd_resp_send(req, NULL, 0);
+}
+
+static void mdns_advertise(void)
+{
+    esp_err_t err = mdns_init();
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "mDNS unavailable (%s) - reach the device by IP", esp_err_to_name(err));
+        return;
+    }
+    mdns_hostname_set(DEVICE_API_HOSTNAME);
+    mdns_instance_name_set("Goldie aquarium assistant");
+    mdns_txt_item_t txt[] = {
+        { "api", "/api" },
+        { "enc", "cbor" },
+    };
+    err = mdns_service_add(NULL, "_http", "_tcp", 80, txt, sizeof(txt) / sizeof(txt[0]));
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "mDNS service not added (%s)", esp_err_to_name(err));
+        return;
+    }
+    ESP_LOGI(TAG, "mDNS: %s.local, _http._tcp port 80", DEVICE_API_HOSTNAME);
+}
+
+bool device_api_start(void)
+{
+    if (registered) {
+        return true;
+    }
+    httpd_handle_t server = web_server_start();
+    if (server == NULL) {
+        return false;
+    }
+
+    const httpd_uri_t state_uri = {
+        .uri = "/api/state", .method = HTTP_GET, .handler = state_handler, .user_ctx = NULL,
+    };
+    const httpd_uri_t config_uri = {
+        .uri = "/api/config", .method = HTTP_POST, .handler = config_handler, .user_ctx = NULL,
+    };
+    const httpd_uri_t perf_uri = {
+        .uri = "/api/perf", .method = HTTP_GET, .handler = perf_handler, .user_ctx = NULL,
+    };
+    const httpd_uri_t trace_uri = {
+        .uri = "/api/trace", .method = HTTP_GET, .handler = trace_handler, .user_ctx = NULL,
+    };
+    const httpd_uri_t metrics_uri = {
+        .uri = "/metrics", .method = HTTP_GET, .handler = metrics_handler, .user_ctx = NULL,
+    };
+    const httpd_uri_t assets_get_uri = {
+        .uri = "/api/assets", .method = HTTP_GET, .handler = assets_get_handler, .user_ctx = NULL,
+    };
+    const httpd_uri_t assets_post_uri = {
+        .uri = "/api/assets", .method = HTTP_POST, .handler = assets_post_handler, .user_ctx = NULL,
+    };
+    const httpd_uri_t firmware_get_uri = {
+        .uri = "/api/firmware", .method = HTTP_GET, .handler = firmware_get_handler, .user_ctx = NULL,
+    };
+    const httpd_uri_t firmware_post_uri = {
+        .uri = "/api/firmware", .method = HTTP_POST, .handler = firmware_post_handler, .user_ctx = NULL,
+    };
+    if (httpd_register_uri_handler(server, &state_uri) != ESP_OK ||
+        httpd_register_uri_handler(server, &config_uri) != ESP_OK ||
+        httpd_register_uri_handler(server, &perf_uri) != ESP_OK ||
+        httpd_register_uri_handler(server, &trace_uri) != ESP_OK ||
+        httpd_register_uri_handler(server, &metrics_uri) != ESP_OK ||
+        httpd_register_uri_handler(server, &assets_get_uri) != ESP_OK ||
+        httpd_register_uri_handler(server, &assets_post_uri) != ESP_OK ||
+        httpd_register_uri_handler(server, &firmware_get_uri) != ESP_OK ||
+        httpd_register_uri_handler(server, &firmware_post_uri) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register /api routes");
+        return false;
+    }
+    registered = true;
+    metrics_register_sampled();
+
+    // Latest-only, no notify: a request takes whatever is newest
+    snapshot_sub = msg_bus_subscribe("device_api", MSG_TOPIC_BLYNK_SYNC, 1, MSG_SUB_LATEST, NULL, NULL);
+    if (snapshot_sub == NULL) {
+        ESP_LOGW(TAG, "No snapshot subscription - /api/state stays empty");
+    }
+    mdns_advertise();
+    ESP_LOGI(TAG, "Device API: /api/state, /api/config, /api/perf, /api/assets, /api/firmware (CBOR), /api/trace (JSON), /metrics (Prometheus)");
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef DEVICE_API_H
+#define DEVICE_API_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Device API for the local network (web_server.h, port 80), CBOR-encoded
+//
+//   GET  /api/state     the latest dashboard snapshot as one CBOR map:
+//                       t, mood, ammonia, nitrite, nitrate, ph, feed_h,
+//                       clean_d, advice
+//   POST /api/config    a CBOR map with any of ammonia, nitrite, nitrate,
+//                       ph (numbers), profile (text), perf_overlay
+//                       (bool, ui_perf.h) and render_bench (true: re-run
+//                       the render mode benchmark, render_bench.h);
+//                       unknown keys are skipped, a value of the wrong
+//                       type is a 400
+//   GET  /api/perf      render / flush counters per dashboard screen
+//                       (CONFIG_GOLDIE_UI_PERF, else 404): overlay, and
+//                       screens -> name -> refr, slow, px, render_us,
+//                       render_max, wait_us, flushes, flush_us, flush_max
+//                       (averages per refresh / per flush, µs)
+//   GET  /api/assets    asset pack status: state, received, total, error
+//                       (asset_ota.h), source and generation of the
+//                       bundle in use (asset_bundle.h)
+//   POST /api/assets    a CBOR map with url (text): download that pack
+//                       into the spare A/B slot; 202 once started, 409
+//                       while a download runs, 404 without the slots
+//   GET  /api/firmware  firmware update status: state, received, total,
+//                       resumes, error (firmware_ota.h), version and
+//                       partition of the running image
+//   POST /api/firmware  a CBOR map with url (text): update from that
+//                       image and restart; 202 once started, 409 while an
+//                       update runs, 404 without OTA app slots
+//   GET  /api/trace     the event trace (evt_trace.h) as Trace Event
+//                       Format JSON for ui.perfetto.dev, chunked
+//                       (CONFIG_GOLDIE_EVT_TRACE, else 404)
+//   GET  /metrics       every registered metric (metrics.h) in the
+//                       Prometheus text format, chunked; uptime, WiFi,
+//                       free heap, animation pacing and frame cache
+//                       counts are sampled per scrape
+//   GET  /history/...   format=cbor (history_export.h): an indefinite
+//                       array of one array per record
+//
+// The device advertises itself over mDNS as <hostname>.local with an
+// _http._tcp service whose TXT record points clients at /api, so apps
+// find it without an IP address. Numbers go out as float32 - a state
+// reply is about a third of the lan_live JSON. No authentication -
+// trusted networks only.
+
+#define DEVICE_API_STATE_MAX   768     // Encoded /api/state (advice cut to fit)
+#define DEVICE_API_CONFIG_MAX  256     // Largest accepted /api/config body
+#define DEVICE_API_PERF_MAX    1024    // Encoded /api/perf
+
+// Register the routes, subscribe to snapshots and start mDNS (call after
+// WiFi is connected; safe to call again)
+bool device_api_start(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEVICE_API_H
@@ -0,0 +1,375 @@
+#include "dns_cache.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "esp_netif_ip_addr.h"
+#include "freertos/FreeRTOS.h"
+#include "lwip/api.h"
+#include "lwip/dns.h"
+#include "lwip/sockets.h"
+#include <string.h>
+#include <strings.h>
+
+static const char *TAG = "dns_cache";
+
+#define DNS_PORT          53
+#define DNS_PACKET_MAX    512
+#define DNS_TYPE_A        1
+#define DNS_CLASS_IN      1
+#define DNS_RCODE_NXDOMAIN 3
+
+typedef enum {
+    QUERY_OK = 0,
+    QUERY_NO_ADDRESS,    // NXDOMAIN / no A record: cache as negative
+    QUERY_FAILED,        // No server answered
+} query_result_t;
+
+typedef struct {
+    char name[DNS_CACHE_NAME_MAX];    // "" = free slot
+    ip4_addr_t addr;
+    bool negative;
+    int64_t expires_us;
+    int64_t retry_us;                 // No query before this (after a failed one)
+    int64_t used_us;
+} dns_entry_t;
+
+static dns_entry_t entries[DNS_CACHE_ENTRIES];
+static portMUX_TYPE cache_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t hits = 0;
+static uint32_t misses = 0;
+static uint32_t stale_hits = 0;
+static uint32_t negative_hits = 0;
+static uint32_t query_failures = 0;
+static uint32_t refreshes = 0;
+
+// ── Wire format ────────────────────────────────────────────────────────────
+
+static size_t build_query(uint8_t *buf, const char *name, uint16_t id)
+{
+    size_t n = 0;
+    buf[n++] = (uint8_t)(id >> 8);
+    buf[n++] = (uint8_t)id;
+    buf[n++] = 0x01;    // RD
+    buf[n++] = 0x00;
+    buf[n++] = 0; buf[n++] = 1;    // QDCOUNT
+    memset(buf + n, 0, 6);         // AN / NS / AR
+    n += 6;
+    for (const char *p = name; *p != '\0';) {
+        size_t len = strcspn(p, ".");
+        if (len == 0 || len > 63) {
+            return 0;
+        }
+        buf[n++] = (uint8_t)len;
+        memcpy(buf + n, p, len);
+        n += len;
+        p += len;
+        if (*p == '.') {
+            p++;
+        }
+    }
+    buf[n++] = 0;
+    buf[n++] = 0; buf[n++] = DNS_TYPE_A;
+    buf[n++] = 0; buf[n++] = DNS_CLASS_IN;
+    return n;
+}
+
+/**
+ * @brief Offset past a (possibly compressed) name, 0 if malformed
+ */
+static size_t skip_name(const uint8_t *buf, size_t len, size_t off)
+{
+    while (off < len) {
+        uint8_t l = buf[off];
+        if (l == 0) {
+            return off + 1;
+        }
+        if ((l & 0xC0) == 0xC0) {
+            return off + 2 <= len ? off + 2 : 0;
+        }
+        off += 1 + l;
+    }
+    return 0;
+}
+
+static uint16_t rd16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static query_result_t parse_reply(const uint8_t *buf, size_t len, uint16_t id, ip4_addr_t *addr, uint32_t *ttl_s)
+{
+    if (len < 12 || rd16(buf) != id || (buf[2] & 0x80) == 0) {
+        return QUERY_FAILED;
+    }
+    uint8_t rcode = buf[3] & 0x0F;
+    if (rcode == DNS_RCODE_NXDOMAIN) {
+        return QUERY_NO_ADDRESS;
+    }
+    if (rcode != 0) {
+        return QUERY_FAILED;    // SERVFAIL, REFUSED: the next server may know
+    }
+    uint16_t qd = rd16(buf + 4);
+    uint16_t an = rd16(buf + 6);
+    size_t off = 12;
+    for (uint16_t i = 0; i < qd && off != 0; i++) {
+        off = skip_name(buf, len, off);
+        off = off ? off + 4 : 0;
+    }
+    // CNAMEs come first; the chain lives as long as its shortest TTL
+    uint32_t ttl = UINT32_MAX;
+    for (uint16_t i = 0; i < an && off != 0; i++) {
+        off = skip_name(buf, len, off);
+        if (off == 0 || off + 10 > len) {
+            break;
+        }
+        uint16_t type = rd16(buf + off);
+        uint16_t cls = rd16(buf + off + 2);
+        uint32_t rr_ttl = ((uint32_t)rd16(buf + off + 4) << 16) | rd16(buf + off + 6);
+        uint16_t rdlen = rd16(buf + off + 8);
+        off += 10;
+        if (off + rdlen > len) {
+            break;
+        }
+        ttl = rr_ttl < ttl ? rr_ttl : ttl;
+        if (type == DNS_TYPE_A && cls == DNS_CLASS_IN && rdlen == 4) {
+            memcpy(&addr->addr, buf + off, 4);
+            *ttl_s = ttl;
+            return QUERY_OK;
+        }
+        off += rdlen;
+    }
+    return QUERY_NO_ADDRESS;
+}
+
+/**
+ * @brief Ask each of lwIP's DNS servers in turn (blocking)
+ */
+static query_result_t query(const char *name, ip4_addr_t *addr, uint32_t *ttl_s)
+{
+    uint8_t buf[DNS_PACKET_MAX];
+    uint16_t id = (uint16_t)esp_random();
+    size_t qlen = build_query(buf, name, id);
+    if (qlen == 0) {
+        return QUERY_NO_ADDRESS;
+    }
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        return QUERY_FAILED;
+    }
+    struct timeval tv = { DNS_CACHE_QUERY_MS / 1000, (DNS_CACHE_QUERY_MS % 1000) * 1000 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    query_result_t result = QUERY_FAILED;
+    uint8_t reply[DNS_PACKET_MAX];
+    for (u8_t s = 0; s < DNS_MAX_SERVERS && result == QUERY_FAILED; s++) {
+        const ip_addr_t *server = dns_getserver(s);
+        if (server == NULL || !IP_IS_V4(server) || ip_addr_isany(server)) {
+            continue;
+        }
+        struct sockaddr_in to = {};
+        to.sin_family = AF_INET;
+        to.sin_port = htons(DNS_PORT);
+        to.sin_addr.s_addr = ip_2_ip4(server)->addr;
+        if (sendto(sock, buf, qlen, 0, (struct sockaddr *)&to, sizeof(to)) != (ssize_t)qlen) {
+            continue;
+        }
+        int n = recv(sock, reply, sizeof(reply), 0);
+        if (n > 0) {
+            result = parse_reply(reply, (size_t)n, id, addr, ttl_s);
+        }
+    }
+    close(sock);
+    return result;
+}
+
+// ── Cache ──────────────────────────────────────────────────────────────────
+
+/**
+ * @brief Entry of `name`, or the slot to reuse for it (lock held)
+ */
+static dns_entry_t *entry_find(const char *name, bool *found)
+{
+    dns_entry_t *victim = &entries[0];
+    for (int i = 0; i < DNS_CACHE_ENTRIES; i++) {
+        dns_entry_t *e = &entries[i];
+        if (e->name[0] != '\0' && strcasecmp(e->name, name) == 0) {
+            *found = true;
+            return e;
+        }
+        // A free slot, else the one unused the longest
+        if (victim->name[0] != '\0' && (e->name[0] == '\0' || e->used_us < victim->used_us)) {
+            victim = e;
+        }
+    }
+    *found = false;
+    return victim;
+}
+
+/**
+ * @brief Query `name` and store the outcome
+ * @return QUERY_OK with `addr` set (a stale address if the servers failed),
+ *         QUERY_NO_ADDRESS, or QUERY_FAILED with nothing to serve
+ */
+static query_result_t resolve_and_store(const char *name, ip4_addr_t *addr)
+{
+    ip4_addr_t fresh = {};
+    uint32_t ttl_s = 0;
+    query_result_t r = query(name, &fresh, &ttl_s);
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&cache_lock);
+    bool found;
+    dns_entry_t *e = entry_find(name, &found);
+    if (!found && r != QUERY_FAILED) {
+        memset(e, 0, sizeof(*e));
+        strlcpy(e->name, name, sizeof(e->name));
+        e->used_us = now;
+    }
+    if (r == QUERY_OK) {
+        ttl_s = ttl_s < DNS_CACHE_TTL_MIN_S ? DNS_CACHE_TTL_MIN_S : ttl_s;
+        ttl_s = ttl_s > DNS_CACHE_TTL_MAX_S ? DNS_CACHE_TTL_MAX_S : ttl_s;
+        e->addr = fresh;
+        e->negative = false;
+        e->expires_us = now + (int64_t)ttl_s * 1000000;
+        e->retry_us = 0;
+        *addr = fresh;
+    } else if (r == QUERY_NO_ADDRESS) {
+        e->negative = true;
+        e->expires_us = now + (int64_t)DNS_CACHE_NEG_TTL_S * 1000000;
+        e->retry_us = 0;
+    } else {
+        // Nothing learned: an entry serves its stale address, else lwIP gets its turn
+        query_failures++;
+        if (found) {
+            e->retry_us = now + (int64_t)DNS_CACHE_RETRY_S * 1000000;
+            if (!e->negative && now < e->expires_us + (int64_t)DNS_CACHE_STALE_S * 1000000) {
+                *addr = e->addr;
+                stale_hits++;
+                r = QUERY_OK;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&cache_lock);
+
+    if (r == QUERY_OK && ttl_s != 0) {
+        ESP_LOGD(TAG, "%s -> " IPSTR " for %lus", name, IP2STR(&fresh), (unsigned long)ttl_s);
+    }
+    return r;
+}
+
+/**
+ * @brief lwIP's netconn external resolve hook (any task, before lwIP's own
+ *        resolver)
+ * @return 1 with *err set if the cache answered, 0 to let lwIP resolve
+ */
+extern "C" int lwip_hook_netconn_external_resolve(const char *name, ip_addr_t *addr, u8_t addrtype, err_t *err)
+{
+#if LWIP_IPV6
+    if (addrtype == NETCONN_DNS_IPV6 || addrtype == NETCONN_DNS_IPV6_IPV4) {
+        return 0;
+    }
+#else
+    (void)addrtype;
+#endif
+    ip4_addr_t numeric;
+    size_t len = strlen(name);
+    if (len == 0 || len >= DNS_CACHE_NAME_MAX || strchr(name, '.') == NULL || ip4addr_aton(name, &numeric) ||
+        (len > 6 && strcasecmp(name + len - 6, ".local") == 0)) {
+        return 0;
+    }
+
+    int64_t now = esp_timer_get_time();
+    bool answered = false, negative = false, ask = true;
+    ip4_addr_t a = {};
+    portENTER_CRITICAL(&cache_lock);
+    bool found;
+    dns_entry_t *e = entry_find(name, &found);
+    if (found) {
+        e->used_us = now;
+        if (now < e->expires_us) {
+            answered = true;
+            negative = e->negative;
+            a = e->addr;
+            ask = false;
+            if (negative) {
+                negative_hits++;
+            } else {
+                hits++;
+            }
+        } else if (now < e->retry_us) {
+            // Servers failed a moment ago: stale address or lwIP, no new query
+            ask = false;
+            if (!e->negative && now < e->expires_us + (int64_t)DNS_CACHE_STALE_S * 1000000) {
+                answered = true;
+                a = e->addr;
+                stale_hits++;
+            }
+        }
+    }
+    if (ask) {
+        misses++;
+    }
+    portEXIT_CRITICAL(&cache_lock);
+
+    if (ask) {
+        query_result_t r = resolve_and_store(name, &a);
+        answered = (r != QUERY_FAILED);
+        negative = (r == QUERY_NO_ADDRESS);
+    }
+    if (!answered) {
+        return 0;
+    }
+    if (negative) {
+        *err = ERR_VAL;
+    } else {
+        ip_addr_copy_from_ip4(*addr, a);
+        *err = ERR_OK;
+    }
+    return 1;
+}
+
+extern "C" void dns_cache_refresh(void)
+{
+    for (int i = 0; i < DNS_CACHE_ENTRIES; i++) {
+        char name[DNS_CACHE_NAME_MAX];
+        int64_t now = esp_timer_get_time();
+        portENTER_CRITICAL(&cache_lock);
+        const dns_entry_t *e = &entries[i];
+        bool due = e->name[0] != '\0' && now - e->used_us < (int64_t)DNS_CACHE_IDLE_S * 1000000 &&
+                   now >= e->retry_us && e->expires_us - now < (int64_t)DNS_CACHE_AHEAD_S * 1000000;
+        if (due) {
+            strlcpy(name, e->name, sizeof(name));
+        }
+        portEXIT_CRITICAL(&cache_lock);
+        if (due) {
+            ip4_addr_t a = {};
+            refreshes++;
+            resolve_and_store(name, &a);
+        }
+    }
+}
+
+extern "C" void dns_cache_log_stats(void)
+{
+    int64_t now = esp_timer_get_time();
+    int used = 0;
+    for (int i = 0; i < DNS_CACHE_ENTRIES; i++) {
+        used += entries[i].name[0] != '\0' ? 1 : 0;
+    }
+    ESP_LOGI(TAG, "%d/%d names  hit %lu  miss %lu  stale %lu  negative %lu  failed %lu  refreshed %lu", used,
+             DNS_CACHE_ENTRIES, (unsigned long)hits, (unsigned long)misses, (unsigned long)stale_hits,
+             (unsigned long)negative_hits, (unsigned long)query_failures, (unsigned long)refreshes);
+    for (int i = 0; i < DNS_CACHE_ENTRIES; i++) {
+        const dns_entry_t *e = &entries[i];
+        if (e->name[0] == '\0') {
+            continue;
+        }
+        long ttl = (long)((e->expires_us - now) / 1000000);
+        if (e->negative) {
+            ESP_LOGI(TAG, "  %-28s no address  %lds", e->name, ttl);
+        } else {
+            ESP_LOGI(TAG, "  %-28s " IPSTR "  %lds", e->name, IP2STR(&e->addr), ttl);
+        }
+    }
+}
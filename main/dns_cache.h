@@ -0,0 +1,64 @@
+#ifndef DNS_CACHE_H
+#define DNS_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// DNS cache in front of lwIP's resolver, shared by every client
+//
+// lwIP calls lwip_hook_netconn_external_resolve() for each getaddrinfo /
+// gethostbyname (CONFIG_LWIP_HOOK_NETCONN_EXT_RESOLVE_CUSTOM), so esp-tls,
+// esp_http_client, MQTT and SNTP all resolve through here. The hook answers
+// from the cache, or asks the DNS servers lwIP got from DHCP itself (one UDP
+// query per server, DNS_CACHE_QUERY_MS each) so the record's TTL is known:
+//
+//   - an answer is kept for its TTL, clamped to DNS_CACHE_TTL_MIN_S ..
+//     DNS_CACHE_TTL_MAX_S
+//   - NXDOMAIN or no A record is kept as a negative entry for
+//     DNS_CACHE_NEG_TTL_S; lookups fail at once meanwhile
+//   - when the servers do not answer, an expired address is served for up to
+//     DNS_CACHE_STALE_S more, and the servers are left alone for
+//     DNS_CACHE_RETRY_S before the next try
+//   - dns_cache_refresh() (telemetry worker, inside a network window)
+//     re-resolves names used in the last DNS_CACHE_IDLE_S that expire within
+//     DNS_CACHE_AHEAD_S, so requests rarely wait for a lookup
+//
+// IPv4 only: IPv6-first lookups, numeric addresses and .local names go to
+// lwIP as before. Without CONFIG_GOLDIE_DNS_CACHE lwIP resolves everything.
+
+#ifndef CONFIG_GOLDIE_DNS_CACHE
+#define CONFIG_GOLDIE_DNS_CACHE 0
+#endif
+
+#define DNS_CACHE_ENTRIES     8
+#define DNS_CACHE_NAME_MAX    64
+#define DNS_CACHE_QUERY_MS    1500
+#define DNS_CACHE_TTL_MIN_S   30
+#define DNS_CACHE_TTL_MAX_S   3600
+#define DNS_CACHE_NEG_TTL_S   30
+#define DNS_CACHE_STALE_S     3600
+#define DNS_CACHE_RETRY_S     10
+#define DNS_CACHE_IDLE_S      1800
+#define DNS_CACHE_AHEAD_S     60
+
+/**
+ * @brief Re-resolve names in use that are about to expire (blocking, one
+ *        query per name at most; call with the network up)
+ */
+void dns_cache_refresh(void);
+
+/**
+ * @brief Log entries, hits, misses, stale answers and failed queries
+ */
+void dns_cache_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DNS_CACHE_H
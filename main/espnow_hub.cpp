@@ -0,0 +1,238 @@
+#include "espnow_hub.h"
+#include "esp_now.h"
+#include "esp_wifi.h"
+#include "esp_mac.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "time_svc.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "espnow_hub";
+
+typedef struct {
+    espnow_node_stats_t stats;
+    bool used;
+    bool have_seq;
+    uint16_t seq;
+    uint8_t tokens;
+    int64_t refill_us;         // When the next token is due
+} node_t;
+
+typedef struct {
+    float v[ESPNOW_FIFO_LEN];
+    uint8_t head;              // Next to read
+    uint8_t len;
+} fifo_t;
+
+static node_t nodes[ESPNOW_MAX_NODES];
+static fifo_t fifos[SENSOR_PARAM_COUNT];
+static float tanks[ESPNOW_MAX_TANKS][SENSOR_PARAM_COUNT];
+static bool tank_seen[ESPNOW_MAX_TANKS];
+static bool started = false;
+static portMUX_TYPE hub_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static node_t *node_for(const uint8_t *mac)
+{
+    node_t *free_slot = NULL;
+    for (node_t &n : nodes) {
+        if (n.used && memcmp(n.stats.mac, mac, 6) == 0) {
+            return &n;
+        }
+        if (!n.used && free_slot == NULL) {
+            free_slot = &n;
+        }
+    }
+    if (free_slot != NULL) {
+        memset(free_slot, 0, sizeof(*free_slot));
+        memcpy(free_slot->stats.mac, mac, 6);
+        free_slot->used = true;
+        free_slot->tokens = ESPNOW_NODE_BURST;
+    }
+    return free_slot;
+}
+
+/**
+ * @brief Take a token from the node's bucket
+ */
+static bool rate_ok(node_t *n, int64_t now_us)
+{
+    const int64_t step_us = (int64_t)CONFIG_GOLDIE_ESPNOW_NODE_MIN_MS * 1000;
+    while (n->tokens < ESPNOW_NODE_BURST && now_us >= n->refill_us) {
+        n->tokens++;
+        n->refill_us += step_us;
+    }
+    if (n->tokens == 0) {
+        return false;
+    }
+    if (n->tokens == ESPNOW_NODE_BURST) {
+        n->refill_us = now_us + step_us;    // Full bucket: the refill clock starts now
+    }
+    n->tokens--;
+    return true;
+}
+
+static void fifo_push(fifo_t *f, float v)
+{
+    if (f->len == ESPNOW_FIFO_LEN) {
+        f->head = (uint8_t)((f->head + 1) % ESPNOW_FIFO_LEN);   // Oldest goes
+        f->len--;
+    }
+    f->v[(f->head + f->len) % ESPNOW_FIFO_LEN] = v;
+    f->len++;
+}
+
+/**
+ * @brief One frame from a node (WiFi task): check, dedupe, copy
+ */
+static void on_recv(const esp_now_recv_info_t *info, const uint8_t *data, int len)
+{
+    if (len < (int)sizeof(espnow_frame_hdr_t)) {
+        return;
+    }
+    espnow_frame_hdr_t hdr;
+    memcpy(&hdr, data, sizeof(hdr));
+    if (hdr.magic != ESPNOW_FRAME_MAGIC || hdr.version != ESPNOW_FRAME_VERSION ||
+        hdr.net_id != CONFIG_GOLDIE_ESPNOW_NET_ID || hdr.count > ESPNOW_FRAME_MAX_READINGS ||
+        len < (int)(sizeof(hdr) + hdr.count * sizeof(espnow_reading_t))) {
+        return;
+    }
+    int64_t now_us = esp_timer_get_time();
+    const espnow_reading_t *readings = (const espnow_reading_t *)(data + sizeof(hdr));
+
+    portENTER_CRITICAL(&hub_lock);
+    node_t *n = node_for(info->src_addr);
+    if (n == NULL) {
+        portEXIT_CRITICAL(&hub_lock);
+        return;                                 // Table full: the first nodes keep their slots
+    }
+    if ((hdr.flags & ESPNOW_FLAG_BOOT) != 0 && n->have_seq && hdr.seq != n->seq) {
+        n->have_seq = false;                    // Node restarted: its count starts over
+    }
+    if (n->have_seq && (int16_t)(hdr.seq - n->seq) <= 0) {
+        n->stats.duplicates++;
+        portEXIT_CRITICAL(&hub_lock);
+        return;
+    }
+    if (!rate_ok(n, now_us)) {
+        n->stats.limited++;
+        portEXIT_CRITICAL(&hub_lock);
+        return;
+    }
+    n->have_seq = true;
+    n->seq = hdr.seq;
+    n->stats.frames++;
+    n->stats.tank = hdr.tank;
+    n->stats.battery_mv = hdr.battery_mv;
+    n->stats.rssi = info->rx_ctrl ? (int8_t)info->rx_ctrl->rssi : 0;
+    n->stats.last_seen_s = time_svc_uptime_s();
+
+    for (uint8_t i = 0; i < hdr.count; i++) {
+        espnow_reading_t r;
+        memcpy(&r, &readings[i], sizeof(r));
+        if (r.param >= SENSOR_PARAM_COUNT || !isfinite(r.value)) {
+            continue;
+        }
+        if (hdr.tank < ESPNOW_MAX_TANKS) {
+            tanks[hdr.tank][r.param] = r.value;   // Readings come oldest first
+            tank_seen[hdr.tank] = true;
+        }
+        if (hdr.tank == CONFIG_GOLDIE_ESPNOW_TANK) {
+            fifo_push(&fifos[r.param], r.value);
+        }
+    }
+    portEXIT_CRITICAL(&hub_lock);
+}
+
+static esp_err_t fifo_read(void *ctx, float *value)
+{
+    fifo_t *f = (fifo_t *)ctx;
+    esp_err_t err = ESP_ERR_NOT_FINISHED;
+    portENTER_CRITICAL(&hub_lock);
+    if (f->len > 0) {
+        *value = f->v[f->head];
+        f->head = (uint8_t)((f->head + 1) % ESPNOW_FIFO_LEN);
+        f->len--;
+        err = ESP_OK;
+    }
+    portEXIT_CRITICAL(&hub_lock);
+    return err;
+}
+
+void espnow_hub_register(void)
+{
+    static const char *const names[SENSOR_PARAM_COUNT] = { "node_ammonia", "node_nitrite", "node_nitrate", "node_ph" };
+    static const float deadbands[SENSOR_PARAM_COUNT] = { 0.05f, 0.05f, 2.0f, 0.1f };
+    for (int p = 0; p < SENSOR_PARAM_COUNT; p++) {
+        for (int t = 0; t < ESPNOW_MAX_TANKS; t++) {
+            tanks[t][p] = NAN;
+        }
+        if (sensor_acq_claimed((sensor_param_t)p)) {
+            continue;                           // A wired probe wins
+        }
+        sensor_driver_t drv = {
+            .name = names[p],
+            .param = (sensor_param_t)p,
+            .period_ms = ESPNOW_READ_MS,
+            .deadband = deadbands[p],
+            .init = NULL,
+            .read = fifo_read,
+            .ctx = &fifos[p],
+        };
+        sensor_acq_register(&drv);
+    }
+}
+
+bool espnow_hub_start(void)
+{
+    if (started) {
+        return true;
+    }
+    esp_err_t err = esp_now_init();
+    if (err == ESP_OK) {
+        err = esp_now_register_recv_cb(on_recv);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "ESP-NOW start failed (%s) - no sensor nodes", esp_err_to_name(err));
+        esp_now_deinit();
+        return false;
+    }
+    // Listen between beacons while modem sleep is on
+    esp_now_set_wake_window(ESPNOW_WAKE_WINDOW_MS);
+    esp_wifi_connectionless_module_set_wake_interval(ESPNOW_WAKE_INTERVAL_MS);
+    started = true;
+
+    uint8_t mac[6] = {};
+    uint8_t channel = 0;
+    wifi_second_chan_t second;
+    esp_wifi_get_mac(WIFI_IF_STA, mac);
+    esp_wifi_get_channel(&channel, &second);
+    ESP_LOGI(TAG, "Hub " MACSTR " on channel %u, net 0x%04x, tank %d", MAC2STR(mac), channel,
+             CONFIG_GOLDIE_ESPNOW_NET_ID, CONFIG_GOLDIE_ESPNOW_TANK);
+    return true;
+}
+
+bool espnow_hub_tank(uint8_t tank, float values[SENSOR_PARAM_COUNT])
+{
+    if (tank >= ESPNOW_MAX_TANKS) {
+        return false;
+    }
+    portENTER_CRITICAL(&hub_lock);
+    bool seen = tank_seen[tank];
+    memcpy(values, tanks[tank], sizeof(tanks[tank]));
+    portEXIT_CRITICAL(&hub_lock);
+    return seen;
+}
+
+bool espnow_hub_node(uint8_t index, espnow_node_stats_t *out)
+{
+    if (index >= ESPNOW_MAX_NODES) {
+        return false;
+    }
+    portENTER_CRITICAL(&hub_lock);
+    bool used = nodes[index].used;
+    *out = nodes[index].stats;
+    portEXIT_CRITICAL(&hub_lock);
+    return used;
+}
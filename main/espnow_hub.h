@@ -0,0 +1,124 @@
+#ifndef ESPNOW_HUB_H
+#define ESPNOW_HUB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor_acq.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ESP-NOW hub - water readings from battery-powered sensor nodes
+//
+// Remote tanks and sumps need no wires and the nodes no WiFi association:
+// a node wakes, measures, sends one ESP-NOW frame to this device (on the
+// channel of its AP) and sleeps again. A frame is a header and up to
+// ESPNOW_FRAME_MAX_READINGS readings of 6 bytes, so a node can batch every
+// parameter, or several samples of one, taken since it last sent.
+//
+// Reception runs in the WiFi task's receive callback and does no more than
+// check, dedupe and copy:
+//   - foreign frames are dropped (magic, version, CONFIG_GOLDIE_ESPNOW_NET_ID);
+//   - each node (by MAC, ESPNOW_MAX_NODES) keeps its last sequence number:
+//     a frame at or behind it is a retry of one already taken. A node's
+//     first frame after reset carries ESPNOW_FLAG_BOOT and restarts it;
+//   - each node has a token bucket of ESPNOW_NODE_BURST frames refilled one
+//     per CONFIG_GOLDIE_ESPNOW_NODE_MIN_MS, so a node stuck in a send loop
+//     cannot flood the hub.
+//
+// Readings of CONFIG_GOLDIE_ESPNOW_TANK go into a small FIFO per parameter
+// that a sensor_acq driver drains (one sample per read, ESP_ERR_NOT_FINISHED
+// when empty), so they take the same median / EMA / deadband path to the
+// dashboard as a wired probe. Parameters a wired probe already reads are
+// left to it. Readings of other tanks are kept as their latest values per
+// tank (espnow_hub_tank) - the dashboard shows one tank.
+//
+// Unicast frames are acknowledged at the MAC layer; a node retries an
+// unacknowledged one with the same sequence number. While net_sched has
+// modem sleep on, the radio stays awake ESPNOW_WAKE_WINDOW_MS of every
+// ESPNOW_WAKE_INTERVAL_MS for the nodes, so a retry or two gets through.
+
+#ifndef CONFIG_GOLDIE_ESPNOW_NET_ID
+#define CONFIG_GOLDIE_ESPNOW_NET_ID 0x6F1D
+#endif
+
+#ifndef CONFIG_GOLDIE_ESPNOW_TANK
+#define CONFIG_GOLDIE_ESPNOW_TANK 0
+#endif
+
+#ifndef CONFIG_GOLDIE_ESPNOW_NODE_MIN_MS
+#define CONFIG_GOLDIE_ESPNOW_NODE_MIN_MS 2000
+#endif
+
+#define ESPNOW_FRAME_MAGIC          0xA7
+#define ESPNOW_FRAME_VERSION        1
+#define ESPNOW_FLAG_BOOT            0x01      // First frame since the node reset
+#define ESPNOW_FRAME_MAX_READINGS   39        // (250 - header) / reading
+#define ESPNOW_MAX_NODES            8
+#define ESPNOW_MAX_TANKS            4
+#define ESPNOW_NODE_BURST           3         // Frames a node may send back to back
+#define ESPNOW_FIFO_LEN             8         // Unread samples per parameter
+#define ESPNOW_READ_MS              500       // Driver period: drains a batch within seconds
+#define ESPNOW_WAKE_INTERVAL_MS     100
+#define ESPNOW_WAKE_WINDOW_MS       20
+
+// Wire format (little endian, packed); nodes build the same structs
+typedef struct __attribute__((packed)) {
+    uint8_t magic;             // ESPNOW_FRAME_MAGIC
+    uint8_t version;           // ESPNOW_FRAME_VERSION
+    uint16_t net_id;           // CONFIG_GOLDIE_ESPNOW_NET_ID
+    uint16_t seq;              // +1 per new frame, the same on a retry
+    uint8_t tank;              // Which tank the node sits in
+    uint8_t flags;             // ESPNOW_FLAG_*
+    uint16_t battery_mv;       // 0 = mains powered
+    uint8_t count;             // Readings that follow
+    uint8_t reserved;
+} espnow_frame_hdr_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t param;             // sensor_param_t
+    uint8_t age_s;             // Taken this long before the frame was sent (255 = or more)
+    float value;
+} espnow_reading_t;
+
+typedef struct {
+    uint8_t mac[6];
+    uint8_t tank;
+    int8_t rssi;
+    uint16_t battery_mv;
+    uint32_t frames;           // Taken
+    uint32_t duplicates;       // Retries dropped
+    uint32_t limited;          // Over the rate, dropped
+    uint32_t last_seen_s;      // time_svc_uptime_s
+} espnow_node_stats_t;
+
+/**
+ * @brief Register a sensor_acq driver per parameter no wired probe reads
+ *        (before sensor_acq_start)
+ */
+void espnow_hub_register(void);
+
+/**
+ * @brief Start receiving (after WiFi has started; any later call is a no-op)
+ */
+bool espnow_hub_start(void);
+
+/**
+ * @brief Latest values of a tank (NAN: not received)
+ * @return false if no frame of that tank came yet
+ */
+bool espnow_hub_tank(uint8_t tank, float values[SENSOR_PARAM_COUNT]);
+
+/**
+ * @brief Statistics of node `index` (0 .. ESPNOW_MAX_NODES - 1)
+ * @return false if the slot is empty
+ */
+bool espnow_hub_node(uint8_t index, espnow_node_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ESPNOW_HUB_H
@@ -0,0 +1,290 @@
+#include "firmware_ota.h"
+#include "task_layout.h"
+#include "esp_ota_ops.h"
+#include "esp_app_desc.h"
+#include "esp_app_format.h"
+#include "esp_http_client.h"
+#include "esp_crt_bundle.h"
+#include "esp_heap_caps.h"
+#include "esp_system.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "firmware_ota";
+
+// The app description sits right after the image and first segment headers
+#define APP_DESC_OFFSET  (sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t))
+
+static bool busy = false;
+static char url_buf[FIRMWARE_OTA_URL_MAX];    // Owned by the task while busy
+static const esp_partition_t *target = NULL;
+static firmware_ota_status_t status = { FIRMWARE_OTA_IDLE, 0, -1, 0, ESP_OK };
+
+static void set_state(firmware_ota_state_t state)
+{
+    __atomic_store_n(&status.state, state, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief A failure that a reconnect may get past (socket, timeout, TLS)
+ */
+static bool transient(esp_err_t err)
+{
+    return err == ESP_FAIL || err == ESP_ERR_TIMEOUT || err == ESP_ERR_HTTP_CONNECT ||
+           err == ESP_ERR_HTTP_EAGAIN || err == ESP_ERR_HTTP_FETCH_HEADER;
+}
+
+/**
+ * @brief Refuse an image built from another project before writing it
+ */
+static esp_err_t check_image(const uint8_t *buf, size_t len)
+{
+    if (len < APP_DESC_OFFSET + sizeof(esp_app_desc_t)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    esp_app_desc_t incoming;
+    memcpy(&incoming, buf + APP_DESC_OFFSET, sizeof(incoming));
+    const esp_app_desc_t *running = esp_app_get_description();
+    if (incoming.magic_word != ESP_APP_DESC_MAGIC_WORD ||
+        strncmp(incoming.project_name, running->project_name, sizeof(incoming.project_name)) != 0) {
+        ESP_LOGE(TAG, "Not a %s image", running->project_name);
+        return ESP_ERR_INVALID_VERSION;
+    }
+    ESP_LOGI(TAG, "Image %.32s (%.16s %.16s), running %.32s", incoming.version, incoming.date, incoming.time,
+             running->version);
+    return ESP_OK;
+}
+
+/**
+ * @brief Write one buffer, sector by sector with a yield after each
+ *
+ * Every buffer but the last is FIRMWARE_OTA_CHUNK long, so each write
+ * starts on a sector and esp_ota_write() erases that sector once.
+ */
+static esp_err_t flush(esp_ota_handle_t ota, const uint8_t *buf, size_t len, uint32_t *written)
+{
+    if (*written == 0) {
+        esp_err_t err = check_image(buf, len);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    for (size_t off = 0; off < len; off += FIRMWARE_OTA_SECTOR) {
+        size_t n = len - off < FIRMWARE_OTA_SECTOR ? len - off : FIRMWARE_OTA_SECTOR;
+        esp_err_t err = esp_ota_write(ota, buf + off, n);
+        if (err != ESP_OK) {
+            return err;
+        }
+        vTaskDelay(1);                          // The UI runs between flash operations
+    }
+    *written += len;
+    return ESP_OK;
+}
+
+/**
+ * @brief Open the request for the image from offset on
+ */
+static esp_err_t open_from(esp_http_client_handle_t client, uint32_t offset)
+{
+    if (offset > 0) {
+        char range[32];
+        snprintf(range, sizeof(range), "bytes=%lu-", (unsigned long)offset);
+        esp_http_client_set_header(client, "Range", range);
+    }
+    esp_err_t err = esp_http_client_open(client, 0);
+    if (err != ESP_OK) {
+        return err;
+    }
+    int64_t length = esp_http_client_fetch_headers(client);
+    if (length < 0) {
+        return ESP_ERR_HTTP_FETCH_HEADER;
+    }
+    int code = esp_http_client_get_status_code(client);
+    if (code != (offset > 0 ? 206 : 200)) {
+        ESP_LOGE(TAG, "HTTP %d%s", code, (offset > 0 && code == 200) ? " - the server ignores Range" : "");
+        return code >= 500 ? ESP_FAIL : ESP_ERR_INVALID_RESPONSE;
+    }
+    if (length > 0 && offset == 0) {
+        if (length > (int64_t)target->size) {
+            ESP_LOGE(TAG, "Image of %lld bytes does not fit %s (%lu bytes)", length, target->label,
+                     (unsigned long)target->size);
+            return ESP_ERR_INVALID_SIZE;
+        }
+        __atomic_store_n(&status.total, (int32_t)length, __ATOMIC_RELAXED);
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Download the whole image into the slot, reconnecting after drops
+ */
+static esp_err_t download(esp_http_client_handle_t client, esp_ota_handle_t ota, uint8_t *buf)
+{
+    uint32_t got = 0;               // Received, flushed or still in buf
+    uint32_t written = 0;
+    size_t fill = 0;
+    int failures = 0;
+    while (true) {
+        esp_err_t err = open_from(client, got);
+        bool done = false;
+        while (err == ESP_OK) {
+            int n = esp_http_client_read(client, (char *)buf + fill, FIRMWARE_OTA_CHUNK - fill);
+            if (n < 0) {
+                err = ESP_FAIL;
+            } else if (n == 0) {
+                if (esp_http_client_is_complete_data_received(client)) {
+                    done = true;
+                    break;
+                }
+                err = ESP_ERR_TIMEOUT;
+            } else {
+                fill += (size_t)n;
+                got += (uint32_t)n;
+                failures = 0;
+                __atomic_store_n(&status.received, got, __ATOMIC_RELAXED);
+                if (fill == FIRMWARE_OTA_CHUNK) {
+                    err = flush(ota, buf, fill, &written);
+                    fill = 0;
+                }
+            }
+        }
+        esp_http_client_close(client);
+        if (done) {
+            break;
+        }
+        if (!transient(err) || ++failures > FIRMWARE_OTA_RETRIES) {
+            return err;
+        }
+        uint32_t wait_ms = FIRMWARE_OTA_BACKOFF_MS << (failures - 1);
+        ESP_LOGW(TAG, "Connection lost after %lu bytes (%s) - resuming in %lu ms", (unsigned long)got,
+                 esp_err_to_name(err), (unsigned long)wait_ms);
+        set_state(FIRMWARE_OTA_RESUMING);
+        vTaskDelay(pdMS_TO_TICKS(wait_ms));
+        __atomic_add_fetch(&status.resumes, 1, __ATOMIC_RELAXED);
+        set_state(FIRMWARE_OTA_DOWNLOADING);
+    }
+
+    int32_t total = __atomic_load_n(&status.total, __ATOMIC_RELAXED);
+    if (total >= 0 && got != (uint32_t)total) {
+        ESP_LOGE(TAG, "Got %lu bytes of %ld", (unsigned long)got, (long)total);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return fill > 0 ? flush(ota, buf, fill, &written) : ESP_OK;
+}
+
+static void ota_task(void *arg)
+{
+    ESP_LOGI(TAG, "Updating from %s into %s", url_buf, target->label);
+    esp_http_client_config_t config = {};
+    config.url = url_buf;
+    config.timeout_ms = FIRMWARE_OTA_TIMEOUT_MS;
+    config.keep_alive_enable = true;
+    if (strncmp(url_buf, "https:", 6) == 0) {
+        config.crt_bundle_attach = esp_crt_bundle_attach;
+    }
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    uint8_t *buf = (uint8_t *)heap_caps_malloc(FIRMWARE_OTA_CHUNK, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    esp_ota_handle_t ota = 0;
+
+    esp_err_t err = (client == NULL || buf == NULL) ? ESP_ERR_NO_MEM
+                  : esp_ota_begin(target, OTA_WITH_SEQUENTIAL_WRITES, &ota);
+    if (err == ESP_OK) {
+        err = download(client, ota, buf);
+        if (err == ESP_OK) {
+            set_state(FIRMWARE_OTA_VERIFYING);
+            err = esp_ota_end(ota);             // Checks the image, frees the handle
+        } else {
+            esp_ota_abort(ota);
+        }
+    }
+    heap_caps_free(buf);
+    if (client != NULL) {
+        esp_http_client_cleanup(client);
+    }
+    if (err == ESP_OK) {
+        err = esp_ota_set_boot_partition(target);
+    }
+
+    __atomic_store_n(&status.error, err, __ATOMIC_RELAXED);
+    if (err != ESP_OK) {
+        set_state(FIRMWARE_OTA_FAILED);
+        ESP_LOGE(TAG, "Update failed (%s) - keeping the running firmware", esp_err_to_name(err));
+        __atomic_store_n(&busy, false, __ATOMIC_RELEASE);
+        vTaskDelete(NULL);
+        return;
+    }
+    set_state(FIRMWARE_OTA_REBOOTING);
+    ESP_LOGI(TAG, "Booting %s in %d ms", target->label, FIRMWARE_OTA_REBOOT_MS);
+    vTaskDelay(pdMS_TO_TICKS(FIRMWARE_OTA_REBOOT_MS));
+    esp_restart();
+}
+
+extern "C" esp_err_t firmware_ota_start(const char *url)
+{
+    if (url == NULL || strlen(url) >= sizeof(url_buf)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (__atomic_exchange_n(&busy, true, __ATOMIC_ACQ_REL)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    target = esp_ota_get_next_update_partition(NULL);
+    if (target == NULL) {
+        __atomic_store_n(&busy, false, __ATOMIC_RELEASE);
+        return ESP_ERR_NOT_FOUND;
+    }
+    strcpy(url_buf, url);
+    __atomic_store_n(&status.received, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&status.total, -1, __ATOMIC_RELAXED);
+    __atomic_store_n(&status.resumes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&status.error, ESP_OK, __ATOMIC_RELAXED);
+    set_state(FIRMWARE_OTA_DOWNLOADING);
+    if (task_layout_create(TASK_ID_FIRMWARE_OTA, ota_task, NULL, NULL) != pdPASS) {
+        set_state(FIRMWARE_OTA_FAILED);
+        __atomic_store_n(&status.error, ESP_ERR_NO_MEM, __ATOMIC_RELAXED);
+        __atomic_store_n(&busy, false, __ATOMIC_RELEASE);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+extern "C" void firmware_ota_get_status(firmware_ota_status_t *out)
+{
+    out->state = __atomic_load_n(&status.state, __ATOMIC_ACQUIRE);
+    out->received = __atomic_load_n(&status.received, __ATOMIC_RELAXED);
+    out->total = __atomic_load_n(&status.total, __ATOMIC_RELAXED);
+    out->resumes = __atomic_load_n(&status.resumes, __ATOMIC_RELAXED);
+    out->error = __atomic_load_n(&status.error, __ATOMIC_RELAXED);
+}
+
+extern "C" const char *firmware_ota_state_name(firmware_ota_state_t state)
+{
+    switch (state) {
+        case FIRMWARE_OTA_IDLE:        return "idle";
+        case FIRMWARE_OTA_DOWNLOADING: return "downloading";
+        case FIRMWARE_OTA_RESUMING:    return "resuming";
+        case FIRMWARE_OTA_VERIFYING:   return "verifying";
+        case FIRMWARE_OTA_REBOOTING:   return "rebooting";
+        case FIRMWARE_OTA_FAILED:      return "failed";
+    }
+    return "?";
+}
+
+extern "C" const char *firmware_ota_running_version(void)
+{
+    return esp_app_get_description()->version;
+}
+
+extern "C" void firmware_ota_mark_valid(void)
+{
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    esp_ota_img_states_t state;
+    if (esp_ota_get_state_partition(running, &state) != ESP_OK || state != ESP_OTA_IMG_PENDING_VERIFY) {
+        return;
+    }
+    if (esp_ota_mark_app_valid_cancel_rollback() == ESP_OK) {
+        ESP_LOGI(TAG, "%s (%s) marked valid - rollback cancelled", running->label, firmware_ota_running_version());
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef FIRMWARE_OTA_H
+#define FIRMWARE_OTA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Firmware update over WiFi into the spare app slot (ota_0 / ota_1 in the
+// partition tables), no cable needed
+//
+// One task (TASK_ID_FIRMWARE_OTA, below LVGL and the workers) per update.
+// The image arrives in FIRMWARE_OTA_CHUNK buffers and goes to flash only in
+// whole, sector-aligned chunks, each sector erased right before it is
+// written and followed by a yield, so the UI and telemetry keep running.
+// A dropped connection or short read reconnects after a backoff and asks
+// for the rest with a Range request; FIRMWARE_OTA_RETRIES attempts in a row
+// without progress give up. The image's app description is checked against
+// the running one (same project) before anything is written; esp_ota_end()
+// verifies the whole image, then the slot becomes the boot partition and
+// the device restarts FIRMWARE_OTA_REBOOT_MS later. A failed update leaves
+// the running firmware as the boot partition.
+//
+// With CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE a new image boots once on
+// probation and rolls back on the next reset unless firmware_ota_mark_
+// valid() ran - app_main calls it once the dashboard is up.
+
+#define FIRMWARE_OTA_URL_MAX       256
+#define FIRMWARE_OTA_CHUNK         16384   // Write unit, 4 flash sectors, internal RAM
+#define FIRMWARE_OTA_SECTOR        4096
+#define FIRMWARE_OTA_TIMEOUT_MS    15000   // Socket timeout per read
+#define FIRMWARE_OTA_RETRIES       5       // Reconnects in a row without progress
+#define FIRMWARE_OTA_BACKOFF_MS    2000    // Doubles per retry without progress
+#define FIRMWARE_OTA_REBOOT_MS     3000    // Lets a client read the final status
+
+typedef enum {
+    FIRMWARE_OTA_IDLE = 0,
+    FIRMWARE_OTA_DOWNLOADING,
+    FIRMWARE_OTA_RESUMING,              // Waiting to reconnect after a drop
+    FIRMWARE_OTA_VERIFYING,
+    FIRMWARE_OTA_REBOOTING,             // Boot partition set
+    FIRMWARE_OTA_FAILED,
+} firmware_ota_state_t;
+
+typedef struct {
+    firmware_ota_state_t state;
+    uint32_t received;                  // Image bytes so far
+    int32_t total;                      // Image size, -1 until known
+    uint32_t resumes;                   // Range requests after drops
+    esp_err_t error;                    // Why the last update failed
+} firmware_ota_status_t;
+
+/**
+ * @brief Start updating from url (any task)
+ * @return ESP_ERR_INVALID_STATE while an update runs, ESP_ERR_NOT_FOUND
+ *         without OTA app slots in the partition table
+ */
+esp_err_t firmware_ota_start(const char *url);
+
+/**
+ * @brief Progress of the current or last update (any task)
+ */
+void firmware_ota_get_status(firmware_ota_status_t *out);
+
+/**
+ * @brief Name of a state for logs and the device API
+ */
+const char *firmware_ota_state_name(firmware_ota_state_t state);
+
+/**
+ * @brief Version string of the running image
+ */
+const char *firmware_ota_running_version(void);
+
+/**
+ * @brief Keep a freshly updated image (cancels the pending rollback)
+ *
+ * No-op unless the running image is on probation.
+ */
+void firmware_ota_mark_valid(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIRMWARE_OTA_H
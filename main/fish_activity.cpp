@@ -0,0 +1,95 @@
+#include "fish_activity.h"
+#include "esp_camera_port.h"
+#include "pixel_kernels.h"
+#include "dashboard.h"
+#include "task_layout.h"
+#include "job_watch.h"
+#include "esp_lvgl_port.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <math.h>
+#include <stdlib.h>
+
+static const char *TAG = "fish_activity";
+
+static uint8_t *frames = NULL;            // PSRAM, two CAMERA_GRAY_BYTES frames
+static float level = NAN;                 // EMA of the samples, NAN while there is no reading
+static bool published_valid = false;
+static uint16_t published_pm = 0;
+static uint32_t failures = 0;
+
+/**
+ * @brief One live frame as luma into gray
+ */
+static bool grab_gray(uint8_t *gray, uint8_t *mean)
+{
+    camera_fb_t *fb = esp_camera_port_capture_live();
+    if (fb == NULL) {
+        return false;
+    }
+    bool ok = esp_camera_port_gray(fb, gray, mean);
+    esp_camera_fb_return(fb);
+    return ok;
+}
+
+static void publish(bool valid, uint16_t pm)
+{
+    if (!lvgl_port_lock(FISH_ACTIVITY_LOCK_MS)) {
+        return;                            // Next sample tries again
+    }
+    dashboard_update_activity(valid, pm);
+    lvgl_port_unlock();
+    published_valid = valid;
+    published_pm = pm;
+    if (valid) {
+        ESP_LOGI(TAG, "Activity %u.%u%% of the view", pm / 10, pm % 10);
+    } else {
+        ESP_LOGI(TAG, "Tank dark - no activity reading");
+    }
+}
+
+extern "C" void fish_activity_sample(void)
+{
+    if (frames == NULL) {
+        frames = (uint8_t *)heap_caps_malloc(2 * CAMERA_GRAY_BYTES, MALLOC_CAP_SPIRAM);
+        if (frames == NULL) {
+            ESP_LOGE(TAG, "No memory for the frame pair");
+            return;
+        }
+    }
+
+    job_watch_begin(TASK_ID_SNAPSHOT, "activity", FISH_ACTIVITY_JOB_MS);
+    uint8_t mean_a = 0, mean_b = 0;
+    bool ok = grab_gray(frames, &mean_a);
+    if (ok) {
+        vTaskDelay(pdMS_TO_TICKS(FISH_ACTIVITY_PAIR_MS));
+        ok = grab_gray(frames + CAMERA_GRAY_BYTES, &mean_b);
+    }
+    size_t moved = ok ? pixel_diff_count_u8(frames, frames + CAMERA_GRAY_BYTES, CAMERA_GRAY_BYTES,
+                                            FISH_ACTIVITY_NOISE) : 0;
+    job_watch_end(TASK_ID_SNAPSHOT);
+
+    if (!ok) {
+        if ((++failures % 16) == 1) {
+            ESP_LOGW(TAG, "No frame pair (%lu so far)", (unsigned long)failures);
+        }
+        return;
+    }
+
+    if (mean_a < FISH_ACTIVITY_DARK || mean_b < FISH_ACTIVITY_DARK) {
+        level = NAN;
+        if (published_valid) {
+            publish(false, 0);
+        }
+        return;
+    }
+
+    float sample = (float)moved * 1000.0f / CAMERA_GRAY_BYTES;
+    level = isnan(level) ? sample : level + FISH_ACTIVITY_EMA_ALPHA * (sample - level);
+    uint16_t pm = (uint16_t)lroundf(level);
+    if (!published_valid || abs((int)pm - (int)published_pm) >= FISH_ACTIVITY_DEADBAND_PM) {
+        publish(true, pm);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef FISH_ACTIVITY_H
+#define FISH_ACTIVITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fish activity - how much of the camera view moves, as a mood factor
+//
+// Every CONFIG_GOLDIE_FISH_ACTIVITY_PERIOD_S the snapshot task, which owns
+// the camera (snapshot.h), calls fish_activity_sample(). It grabs two live
+// frames FISH_ACTIVITY_PAIR_MS apart and decodes each at half scale into
+// 160x120 8-bit luma (esp_camera_port_gray) in one fixed PSRAM buffer of
+// two frames, allocated on the first sample. The sample is the share of
+// pixels that changed by more than FISH_ACTIVITY_NOISE (permille,
+// pixel_diff_count_u8: four pixels per word), which JPEG noise and the
+// sensor's own flicker stay under.
+//
+// Samples go through an EMA; the level is pushed to the dashboard
+// (dashboard_update_activity) under the LVGL lock when it moves by
+// FISH_ACTIVITY_DEADBAND_PM, the same path as a probe reading, and the
+// mood engine scores it (mood_engine.h). A dark view (lights off: mean
+// luma under FISH_ACTIVITY_DARK) is no reading at all - a sleeping fish is
+// not a lethargic one.
+
+#ifndef CONFIG_GOLDIE_FISH_ACTIVITY_PERIOD_S
+#define CONFIG_GOLDIE_FISH_ACTIVITY_PERIOD_S 20
+#endif
+
+#define FISH_ACTIVITY_PAIR_MS       250       // Between the two frames of a sample
+#define FISH_ACTIVITY_NOISE         16        // Luma change that counts as movement
+#define FISH_ACTIVITY_DARK          24        // Mean luma below this: lights off
+#define FISH_ACTIVITY_EMA_ALPHA     0.3f      // Weight of each new sample
+#define FISH_ACTIVITY_DEADBAND_PM   2         // Level change worth publishing
+#define FISH_ACTIVITY_JOB_MS        2500      // job_watch deadline: two grabs, the pause, two decodes
+#define FISH_ACTIVITY_LOCK_MS       200       // Waiting for the LVGL lock to publish
+
+/**
+ * @brief Take one sample and publish the level if it moved (snapshot task)
+ */
+void fish_activity_sample(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FISH_ACTIVITY_H
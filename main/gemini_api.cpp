@@ -1,16 +1,32 @@
 #include "gemini_api.h"
 #include "wifi_config.h"
 #include "dashboard.h"
+#include "state/dash_store.h"
+#include "mood/mood_engine.h"
+#include "mood/mood_trend.h"
+#include "history/history_agg.h"
+#include "history/history_trend.h"
+#if CONFIG_GOLDIE_AI
+#include "ai_cache.h"
+#include "ai_rate.h"
+#include "ai_provider.h"
+#include "ai_chat.h"
+#endif
+#include "text_buf.h"
+#include "http_pool.h"
+#include "wifi_scan.h"
+#include "co_exec.h"
 #include "esp_wifi.h"
+#include "esp_mac.h"
 #include "esp_event.h"
 #include "esp_log.h"
 #include "nvs_flash.h"
-#include "esp_http_client.h"
-#include "esp_crt_bundle.h"
+#include "nvs.h"
 #include "esp_sntp.h"
 #include "esp_timer.h"
-#include "cJSON.h"
+#include "time_svc.h"
 #include <string.h>
+#include <math.h>
 #include <time.h>
 #include <sys/time.h>
 
@@ -18,6 +34,229 @@ static const char *TAG = "gemini_api";
 static bool wifi_connected = false;
 static esp_netif_t *sta_netif = NULL;
 
+// ═══════════════════════════════════════════════════════════════════════════
+// CONNECTION STATE (EVENT GROUP, NO POLLING)
+// ═══════════════════════════════════════════════════════════════════════════
+// The WiFi / IP / SNTP callbacks only set and clear NET_EVENT_* bits; the
+// delays around them (reconnect back-off, DHCP restart) are one-shot
+// timers, so neither the event loop nor the caller of gemini_init_wifi()
+// ever sleeps waiting for the network.
+//
+// Fast reconnect: the channel and BSSID of the last AP we associated with
+// are kept in NVS. Boot and the first reconnects go straight to it
+// (WIFI_FAST_SCAN on that one channel, BSSID pinned), which skips the
+// all-channel scan - a router blip costs well under a second. If the AP is
+// not there (moved channel, other AP of the network) a background scan
+// (wifi_scan.h) looks for the network; when it lands, the next try goes
+// straight to the strongest AP of the SSID it saw. Only after that the
+// station falls back to its own full scan, strongest AP first. Retries back
+// off from NET_RECONNECT_FIRST_MS, doubling up to NET_RECONNECT_MAX_MS.
+
+#define NET_RECONNECT_FIRST_MS  100   // A blip: back on the cached AP at once
+#define NET_RECONNECT_MS        500   // Then doubling (hotspots drop a fresh station a few times)
+#define NET_RECONNECT_MAX_MS    30000
+#define NET_FAST_ATTEMPTS       2     // Tries on the cached AP before a full scan
+#define NET_AP_NVS_NS           "goldie_wifi"
+#define NET_AP_NVS_KEY          "ap"
+#define NET_DHCP_RESTART_MS   15000   // Associated but no lease: restart the client
+#define NET_SNTP_FALLBACK_MS  (24 * 3600 * 1000)  // lwIP's own poll; net_sched re-syncs sooner
+
+static EventGroupHandle_t net_events = NULL;
+static esp_timer_handle_t reconnect_timer = NULL;
+static esp_timer_handle_t dhcp_timer = NULL;
+static bool sntp_started = false;
+
+// Last good AP (NVS), for the SSID it was stored with
+typedef struct {
+    uint32_t ssid_hash;
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t reserved;
+} net_ap_cache_t;
+
+static net_ap_cache_t ap_cache;
+static bool ap_cached = false;
+static wifi_config_t sta_config;
+static bool sta_applied = false;
+// What sta_config points the station at
+typedef enum {
+    STA_TARGET_ANY = 0,     // Full scan, any AP of the SSID
+    STA_TARGET_CACHED,      // The AP kept in NVS
+    STA_TARGET_SCANNED,     // The strongest AP a recent wifi_scan saw
+} sta_target_t;
+
+static const char *const sta_target_names[] = { "full scan", "cached AP", "scanned AP" };
+static sta_target_t sta_target = STA_TARGET_ANY;
+static uint32_t reconnect_attempts = 0;  // Since the last lease
+static int64_t link_lost_us = 0;         // 0 = not reconnecting
+
+static uint32_t ssid_hash(const char *ssid)
+{
+    uint32_t h = 2166136261u;
+    for (; *ssid != '\0'; ssid++) {
+        h ^= (uint8_t)*ssid;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void ap_cache_load(void)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(NET_AP_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+        return;
+    }
+    size_t len = sizeof(ap_cache);
+    esp_err_t err = nvs_get_blob(nvs, NET_AP_NVS_KEY, &ap_cache, &len);
+    nvs_close(nvs);
+    ap_cached = err == ESP_OK && len == sizeof(ap_cache) && ap_cache.ssid_hash == ssid_hash(WIFI_SSID) &&
+                ap_cache.channel >= 1 && ap_cache.channel <= 14;
+    if (ap_cached) {
+        ESP_LOGI(TAG, "Cached AP " MACSTR " on channel %u - fast connect", MAC2STR(ap_cache.bssid),
+                 (unsigned)ap_cache.channel);
+    }
+}
+
+/**
+ * @brief Associated: remember the AP (NVS written only when it changed)
+ */
+static void ap_cache_store(const uint8_t bssid[6], uint8_t channel)
+{
+    if (ap_cached && ap_cache.channel == channel && memcmp(ap_cache.bssid, bssid, 6) == 0) {
+        return;
+    }
+    memset(&ap_cache, 0, sizeof(ap_cache));
+    ap_cache.ssid_hash = ssid_hash(WIFI_SSID);
+    memcpy(ap_cache.bssid, bssid, 6);
+    ap_cache.channel = channel;
+    ap_cached = true;
+
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(NET_AP_NVS_NS, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, NET_AP_NVS_KEY, &ap_cache, sizeof(ap_cache));
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Saving the AP failed (%s) - full scan after a reboot", esp_err_to_name(err));
+    }
+}
+
+/**
+ * @brief Target of the next connect: the cached AP for the first tries,
+ *        then an AP a fresh scan saw, then any AP of the SSID
+ */
+static sta_target_t sta_target_pick(wifi_scan_ap_t *scanned)
+{
+    if (reconnect_attempts <= NET_FAST_ATTEMPTS && ap_cached) {
+        return STA_TARGET_CACHED;
+    }
+    if (reconnect_attempts <= NET_FAST_ATTEMPTS + 1 && wifi_scan_find(WIFI_SSID, WIFI_SCAN_FRESH_S, scanned)) {
+        return STA_TARGET_SCANNED;
+    }
+    return STA_TARGET_ANY;
+}
+
+/**
+ * @brief Point the station at one AP (channel and BSSID pinned) or at any
+ *        AP of the SSID
+ */
+static esp_err_t sta_config_apply(sta_target_t target, const wifi_scan_ap_t *scanned)
+{
+    const uint8_t *bssid = NULL;
+    uint8_t channel = 0;
+    if (target == STA_TARGET_CACHED) {
+        bssid = ap_cache.bssid;
+        channel = ap_cache.channel;
+    } else if (target == STA_TARGET_SCANNED) {
+        bssid = scanned->bssid;
+        channel = scanned->channel;
+    }
+    if (sta_applied && target == sta_target && target != STA_TARGET_SCANNED) {
+        return ESP_OK;
+    }
+    sta_target = target;
+    if (bssid != NULL) {
+        sta_config.sta.scan_method = WIFI_FAST_SCAN;          // First match on one channel
+        sta_config.sta.channel = channel;
+        sta_config.sta.bssid_set = true;
+        memcpy(sta_config.sta.bssid, bssid, 6);
+    } else {
+        sta_config.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;   // Scan all channels (more reliable for hotspots)
+        sta_config.sta.channel = 0;
+        sta_config.sta.bssid_set = false;
+    }
+    esp_err_t ret = esp_wifi_set_config(WIFI_IF_STA, &sta_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "WiFi set config failed (%s)", esp_err_to_name(ret));
+    }
+    sta_applied = ret == ESP_OK;
+    return ret;
+}
+
+static void reconnect_timer_cb(void *arg)
+{
+    if (wifi_scan_busy()) {
+        return;    // scan_listener() tries again when it lands
+    }
+    wifi_scan_ap_t scanned;
+    sta_config_apply(sta_target_pick(&scanned), &scanned);
+    esp_err_t ret = esp_wifi_connect();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "WiFi reconnect failed: %s", esp_err_to_name(ret));
+    }
+}
+
+/**
+ * @brief A scan landed (event loop): while reconnecting, try at once - the
+ *        network may be on a new channel or AP
+ */
+static void scan_listener(void)
+{
+    if (link_lost_us != 0 && !wifi_connected) {
+        esp_timer_stop(reconnect_timer);
+        esp_timer_start_once(reconnect_timer, 1000);
+    }
+}
+
+static void dhcp_timer_cb(void *arg)
+{
+    if ((xEventGroupGetBits(net_events) & NET_EVENT_IP) == 0) {
+        ESP_LOGW(TAG, "No IP after %d s, restarting DHCP client...", NET_DHCP_RESTART_MS / 1000);
+        esp_netif_dhcpc_stop(sta_netif);
+        esp_netif_dhcpc_start(sta_netif);
+    }
+}
+
+static void time_sync_cb(struct timeval *tv)
+{
+    xEventGroupSetBits(net_events, NET_EVENT_TIME_SYNCED | NET_EVENT_TIME_FRESH);
+    co_exec_wake();       // The network flow waits on these bits as a coroutine
+}
+
+/**
+ * @brief SNTP for time synchronisation (once, on the first lease)
+ */
+static void sntp_start(void)
+{
+    if (sntp_started) {
+        return;
+    }
+    sntp_started = true;
+    ESP_LOGI(TAG, "Initializing SNTP for time sync...");
+    esp_sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    // Try multiple NTP servers for better reliability with mobile hotspots
+    esp_sntp_setservername(0, "time.google.com");  // Google's NTP (often less blocked)
+    esp_sntp_setservername(1, "pool.ntp.org");     // Public NTP pool
+    esp_sntp_setservername(2, "time.nist.gov");    // NIST (US government)
+    sntp_set_time_sync_notification_cb(time_sync_cb);
+    sntp_set_sync_interval(NET_SNTP_FALLBACK_MS);
+    esp_sntp_init();
+}
+
 // WiFi event handler
 static void wifi_event_handler(void* arg, esp_event_base_t event_base,
                                int32_t event_id, void* event_data)
@@ -26,24 +265,65 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
         ESP_LOGI(TAG, "WiFi STA started, connecting...");
         esp_wifi_connect();
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED) {
-        ESP_LOGI(TAG, "WiFi connected to AP, waiting for IP...");
+        wifi_event_sta_connected_t *connected = (wifi_event_sta_connected_t *)event_data;
+        ESP_LOGI(TAG, "WiFi connected to AP (channel %u, %s), waiting for IP...", (unsigned)connected->channel,
+                 sta_target_names[sta_target]);
+        ap_cache_store(connected->bssid, connected->channel);
+        xEventGroupSetBits(net_events, NET_EVENT_WIFI_UP);
+        esp_timer_stop(dhcp_timer);
+        esp_timer_start_once(dhcp_timer, (uint64_t)NET_DHCP_RESTART_MS * 1000);
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
+        bool was_online = (xEventGroupGetBits(net_events) & NET_EVENT_IP) != 0;
         wifi_connected = false;
+        esp_timer_stop(dhcp_timer);
+        xEventGroupClearBits(net_events, NET_EVENT_WIFI_UP | NET_EVENT_IP);
+        if (was_online) {
+            xEventGroupSetBits(net_events, NET_EVENT_CHANGED);
+            co_exec_wake();
+        }
+        http_pool_drop_all();  // Every cloud connection reconnects before its next request
         wifi_event_sta_disconnected_t* disconnected = (wifi_event_sta_disconnected_t*) event_data;
-        ESP_LOGW(TAG, "WiFi disconnected (reason: %d), retrying immediately...", disconnected->reason);
-        
-        // Immediate retry for hotspot compatibility (hotspots can be unstable during initial connection)
-        vTaskDelay(pdMS_TO_TICKS(500));  // Short delay to avoid storm
-        
-        // Attempt reconnection
-        esp_err_t ret = esp_wifi_connect();
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "WiFi reconnect failed: %s", esp_err_to_name(ret));
+        if (link_lost_us == 0) {
+            link_lost_us = esp_timer_get_time();
+        }
+
+        // The cached AP is not on its channel: no more tries on it
+        reconnect_attempts++;
+        if (sta_target == STA_TARGET_CACHED && disconnected->reason == WIFI_REASON_NO_AP_FOUND) {
+            reconnect_attempts = NET_FAST_ATTEMPTS + 1;
+        }
+        // Past the cached AP: look for the network in the background first
+        wifi_scan_ap_t seen;
+        if (reconnect_attempts == NET_FAST_ATTEMPTS + 1 && !wifi_scan_find(WIFI_SSID, WIFI_SCAN_FRESH_S, &seen)) {
+            wifi_scan_request(false);
         }
+        uint32_t delay_ms = NET_RECONNECT_FIRST_MS;
+        if (reconnect_attempts > 1) {
+            uint32_t shift = reconnect_attempts - 2 < 6 ? reconnect_attempts - 2 : 6;
+            delay_ms = NET_RECONNECT_MS << shift;
+            if (delay_ms > NET_RECONNECT_MAX_MS) {
+                delay_ms = NET_RECONNECT_MAX_MS;
+            }
+        }
+        ESP_LOGW(TAG, "WiFi disconnected (reason: %d), retry %lu in %lu ms (%s)...", disconnected->reason,
+                 (unsigned long)reconnect_attempts, (unsigned long)delay_ms,
+                 wifi_scan_busy() ? "after the scan" : sta_target_names[sta_target_pick(&seen)]);
+        esp_timer_stop(reconnect_timer);
+        esp_timer_start_once(reconnect_timer, (uint64_t)delay_ms * 1000);
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
         ESP_LOGI(TAG, "Got IP: " IPSTR, IP2STR(&event->ip_info.ip));
+        if (link_lost_us != 0) {
+            ESP_LOGI(TAG, "Back online %lld ms after the link dropped (%lu retries)",
+                     (long long)((esp_timer_get_time() - link_lost_us) / 1000), (unsigned long)reconnect_attempts);
+        }
+        link_lost_us = 0;
+        reconnect_attempts = 0;
         wifi_connected = true;
+        esp_timer_stop(dhcp_timer);
+        xEventGroupSetBits(net_events, NET_EVENT_IP | NET_EVENT_CHANGED);
+        co_exec_wake();
+        sntp_start();
     }
 }
 
@@ -66,6 +346,20 @@ bool gemini_init_wifi(void)
         // Continue - WiFi can work without NVS
     }
 
+    // Connection state and its timers (graceful failure)
+    net_events = xEventGroupCreate();
+    esp_timer_create_args_t reconnect_args = {};
+    reconnect_args.callback = reconnect_timer_cb;
+    reconnect_args.name = "wifi_retry";
+    esp_timer_create_args_t dhcp_args = {};
+    dhcp_args.callback = dhcp_timer_cb;
+    dhcp_args.name = "dhcp_retry";
+    if (net_events == NULL || esp_timer_create(&reconnect_args, &reconnect_timer) != ESP_OK ||
+        esp_timer_create(&dhcp_args, &dhcp_timer) != ESP_OK) {
+        ESP_LOGE(TAG, "No memory for the connection state - WiFi unavailable");
+        return false;
+    }
+
     // Initialize network interface (graceful failure)
     ret = esp_netif_init();
     if (ret != ESP_OK) {
@@ -114,15 +408,13 @@ bool gemini_init_wifi(void)
     }
 
     // Configure WiFi for mobile hotspot compatibility
-    wifi_config_t wifi_config = {};
-    strcpy((char*)wifi_config.sta.ssid, WIFI_SSID);
-    strcpy((char*)wifi_config.sta.password, WIFI_PASS);
-    wifi_config.sta.threshold.authmode = WIFI_AUTH_WPA_WPA2_PSK;  // Accept WPA or WPA2 (phone hotspot compatible)
-    wifi_config.sta.pmf_cfg.capable = true;                        // PMF capable but not required
-    wifi_config.sta.pmf_cfg.required = false;                      // Don't require PMF (some phones don't support)
-    wifi_config.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;           // Scan all channels (more reliable for hotspots)
-    wifi_config.sta.sort_method = WIFI_CONNECT_AP_BY_SIGNAL;       // Connect to strongest signal
-    wifi_config.sta.listen_interval = 3;                           // Listen interval for beacon frames
+    strcpy((char*)sta_config.sta.ssid, WIFI_SSID);
+    strcpy((char*)sta_config.sta.password, WIFI_PASS);
+    sta_config.sta.threshold.authmode = WIFI_AUTH_WPA_WPA2_PSK;   // Accept WPA or WPA2 (phone hotspot compatible)
+    sta_config.sta.pmf_cfg.capable = true;                         // PMF capable but not required
+    sta_config.sta.pmf_cfg.required = false;                       // Don't require PMF (some phones don't support)
+    sta_config.sta.sort_method = WIFI_CONNECT_AP_BY_SIGNAL;        // Full scan: strongest signal
+    sta_config.sta.listen_interval = 3;                            // Listen interval for beacon frames
 
     ret = esp_wifi_set_mode(WIFI_MODE_STA);
     if (ret != ESP_OK) {
@@ -130,13 +422,22 @@ bool gemini_init_wifi(void)
         return false;
     }
     
-    ret = esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+    // Scans for the reconnect logic and the WiFi tile
+    ret = wifi_scan_init();
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "WiFi set config failed (%s)", esp_err_to_name(ret));
+        ESP_LOGW(TAG, "WiFi scan service unavailable (%s)", esp_err_to_name(ret));
+    }
+    wifi_scan_add_listener(scan_listener);
+
+    // Boot goes to the cached AP first, like a reconnect
+    ap_cache_load();
+    wifi_scan_ap_t scanned;
+    if (sta_config_apply(sta_target_pick(&scanned), &scanned) != ESP_OK) {
         return false;
     }
     
-    // Disable power save for better connection stability
+    // No power save while associating (hotspot stability); net_sched
+    // switches modem sleep on between its radio windows
     ret = esp_wifi_set_ps(WIFI_PS_NONE);
     if (ret != ESP_OK) {
         ESP_LOGW(TAG, "Failed to disable power save (%s)", esp_err_to_name(ret));
@@ -156,70 +457,20 @@ bool gemini_init_wifi(void)
 
     ESP_LOGI(TAG, "WiFi initialization finished. Connecting to %s...", WIFI_SSID);
 
-    // STABILIZATION FIX: Add yielding to prevent watchdog triggers
-    // Wait for connection (timeout after 30 seconds to avoid long boot delays)
-    int retry = 0;
-    while (!wifi_connected && retry < 300) {  // Wait up to 30 seconds for IP
-        if (retry > 0 && retry % 50 == 0) {  // Log every 5 seconds
-            ESP_LOGI(TAG, "Waiting for IP... (%d seconds)", retry / 10);
-        }
-        
-        // Try restarting DHCP client at 15 seconds if still no IP
-        if (retry == 150) {
-            ESP_LOGW(TAG, "No IP after 15s, restarting DHCP client...");
-            esp_netif_dhcpc_stop(sta_netif);
-            vTaskDelay(pdMS_TO_TICKS(100));
-            esp_netif_dhcpc_start(sta_netif);
-        }
-        
-        // CRITICAL: Yield to prevent watchdog trigger
-        vTaskDelay(pdMS_TO_TICKS(100));
-        taskYIELD();  // Explicitly yield to IDLE task
-        retry++;
-    }
-
-    if (wifi_connected) {
-        ESP_LOGI(TAG, "WiFi connection successful!");
-        
-        // Initialize SNTP for time synchronization
-        ESP_LOGI(TAG, "Initializing SNTP for time sync...");
-        esp_sntp_setoperatingmode(SNTP_OPMODE_POLL);
-        // Try multiple NTP servers for better reliability with mobile hotspots
-        esp_sntp_setservername(0, "time.google.com");  // Google's NTP (often less blocked)
-        esp_sntp_setservername(1, "pool.ntp.org");     // Public NTP pool
-        esp_sntp_setservername(2, "time.nist.gov");    // NIST (US government)
-        esp_sntp_init();
-        
-        // Set timezone (adjust for your location - this is UTC+0)
-        // For other timezones: "EST5EDT" (US East), "PST8PDT" (US West), "CET-1CEST" (Europe), etc.
-        setenv("TZ", "UTC-0", 1);
-        tzset();
-        
-        ESP_LOGI(TAG, "Waiting for time sync from NTP server...");
-        // Wait up to 10 seconds for time sync (hotspots can be slow)
-        time_t now = 0;
-        struct tm timeinfo = {};
-        int retry_time = 0;
-        while (timeinfo.tm_year < (2024 - 1900) && ++retry_time < 100) {  // 100 * 100ms = 10 seconds
-            vTaskDelay(pdMS_TO_TICKS(100));
-            taskYIELD();  // Explicitly yield to IDLE task
-            time(&now);
-            localtime_r(&now, &timeinfo);
-        }
-        
-        if (timeinfo.tm_year >= (2024 - 1900)) {
-            char strftime_buf[64];
-            strftime(strftime_buf, sizeof(strftime_buf), "%c", &timeinfo);
-            ESP_LOGI(TAG, "Time synchronized: %s", strftime_buf);
-        } else {
-            ESP_LOGW(TAG, "NTP sync timeout (hotspot may block UDP/123) - date will be incorrect");
-            ESP_LOGW(TAG, "Time will sync eventually if NTP becomes available");
-        }
-    } else {
-        ESP_LOGE(TAG, "WiFi connection timeout - no IP received after %d seconds", retry / 10);
-    }
+    // Set timezone (adjust for your location - this is UTC+0)
+    // For other timezones: "EST5EDT" (US East), "PST8PDT" (US West), "CET-1CEST" (Europe), etc.
+    setenv("TZ", "UTC-0", 1);
+    tzset();
+    time_svc_tz_changed();
 
-    return wifi_connected;
+    // Connecting continues in the background: NET_EVENT_IP, then
+    // NET_EVENT_TIME_SYNCED once SNTP has answered
+    return true;
+}
+
+EventGroupHandle_t gemini_net_events(void)
+{
+    return net_events;
 }
 
 bool gemini_is_wifi_connected(void)
@@ -227,187 +478,798 @@ bool gemini_is_wifi_connected(void)
     return wifi_connected;
 }
 
+void gemini_wifi_power_save(bool on)
+{
+    esp_err_t ret = esp_wifi_set_ps(on ? WIFI_PS_MIN_MODEM : WIFI_PS_NONE);
+    if (ret != ESP_OK && ret != ESP_ERR_WIFI_NOT_INIT) {
+        ESP_LOGW(TAG, "Failed to set power save %s (%s)", on ? "on" : "off", esp_err_to_name(ret));
+    }
+}
+
+void gemini_time_resync(void)
+{
+    if (sntp_started) {
+        esp_sntp_restart();
+    }
+}
+
 uint32_t gemini_get_current_time(void)
 {
-    time_t now;
-    time(&now);
-    return (uint32_t)now;
+    return (uint32_t)time_svc_wall();
+}
+
+#if CONFIG_GOLDIE_AI
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PROMPT TEMPLATE (NO HEAP, NO cJSON)
+// ═══════════════════════════════════════════════════════════════════════════
+// The prompt is written straight into one static buffer as the inside of
+// a JSON string: the fixed text is string literals already escaped for
+// JSON, the numbers are printed in place and only the free-text slots
+// (species, mood reason, forecast, medication) are escaped while copied.
+// The prompt has a byte budget that always leaves room for the closing
+// instruction, so a long mood reason shortens the prompt but it stays a
+// valid JSON string. Each provider wraps it in its own body (ai_provider).
+//
+// Every part after the persona is a section with a priority. Once all are
+// written, their tokens are estimated (~4 ASCII characters per token, more
+// for emoji) and, while the prompt is over CONFIG_GOLDIE_AI_PROMPT_TOKENS,
+// the least valuable section left is cut out of the buffer; the mood
+// reason is first shortened at a word. A reading goes in on its own line
+// only if its mood score is off or it moved since the last prompt sent;
+// the others are named in one line as fine.
+
+#ifndef CONFIG_GOLDIE_AI_PROMPT_TOKENS
+#define CONFIG_GOLDIE_AI_PROMPT_TOKENS 200
+#endif
+
+#define GROQ_P_INTRO         "You are Goldie, a friendly "
+#define GROQ_P_WHO \
+    " living in this aquarium. Reply in first person, cheerful and bubbly, max 80 words.\\n"
+#define GROQ_P_CLOSING \
+    "\\nAnswer with only a JSON object: {\\\"advice\\\": how you feel in these conditions and " \
+    "friendly advice, \\\"summary\\\": the same in one line of at most 12 words}"
+
+// "Ask Goldie": the same persona answering the owner (gemini_chat)
+#define GROQ_P_CHAT_WHO \
+    " living in this aquarium, chatting with your owner. Reply in first person, cheerful, max 60 words.\\n"
+#define GROQ_P_CHAT_CLOSING \
+    "\\nAnswer the owner's last message with only a JSON object: {\\\"advice\\\": your reply, " \
+    "\\\"summary\\\": the whole conversation so far in at most 40 words}"
+
+#ifndef CONFIG_GOLDIE_AI_CHAT_TOKENS
+#define CONFIG_GOLDIE_AI_CHAT_TOKENS 400
+#endif
+
+#define REQ_SECTIONS         12
+#define REQ_SHORT_MIN_TOKENS 12      // A shortened section keeps at least this much
+
+// Section priority: the lowest goes first, PRIO_KEEP never
+enum {
+    PRIO_LOW = 1,
+    PRIO_MID,
+    PRIO_HIGH,
+    PRIO_KEEP,
+};
+
+static char groq_prompt[AI_PROMPT_JSON_MAX];   // Only the AI worker builds prompts
+
+typedef struct {
+    uint16_t start;
+    uint16_t len;
+    uint16_t tokens;
+    uint8_t prio;
+    bool shorten;          // May be cut at a word instead of dropped
+} req_section_t;
+
+typedef struct {
+    size_t len;
+    size_t limit;          // Prompt budget: the closing text always fits
+    const char *closing;   // Escaped, appended by req_end()
+    req_section_t sec[REQ_SECTIONS];
+    uint8_t count;
+} req_writer_t;
+
+static void req_begin(req_writer_t *w, const char *closing)
+{
+    w->len = 0;
+    w->closing = closing;
+    w->limit = sizeof(groq_prompt) - strlen(closing) - 1;
+    w->count = 0;
 }
 
-// HTTP response buffer
-static char http_response[4096];
-static int response_len = 0;
-static bool quota_exhausted = false;  // Track if API quota is exhausted
-static uint32_t quota_reset_time = 0; // Timestamp when quota might reset (seconds)
+// Whole units only: a literal, a number or one (escaped) character
+static bool req_put(req_writer_t *w, const char *b, size_t n)
+{
+    if (w->len + n > w->limit) {
+        w->limit = w->len;     // Full: nothing later may squeeze in
+        return false;
+    }
+    memcpy(groq_prompt + w->len, b, n);
+    w->len += n;
+    return true;
+}
 
-// HTTP event handler
-static esp_err_t http_event_handler(esp_http_client_event_t *evt)
+static void req_lit(req_writer_t *w, const char *lit)
 {
-    switch(evt->event_id) {
-        case HTTP_EVENT_ON_DATA:
-            if (response_len + evt->data_len < sizeof(http_response)) {
-                memcpy(http_response + response_len, evt->data, evt->data_len);
-                response_len += evt->data_len;
-                http_response[response_len] = '\0';
+    req_put(w, lit, strlen(lit));
+}
+
+static void req_str(req_writer_t *w, const char *s)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t start = w->len;
+    for (; *s != '\0'; s++) {
+        unsigned char c = (unsigned char)*s;
+        char e[6];
+        size_t n = 2;
+        e[0] = '\\';
+        switch (c) {
+            case '"':  e[1] = '"';  break;
+            case '\\': e[1] = '\\'; break;
+            case '\n': e[1] = 'n';  break;
+            case '\r': e[1] = 'r';  break;
+            case '\t': e[1] = 't';  break;
+            default:
+                if (c < 0x20) {
+                    e[1] = 'u'; e[2] = '0'; e[3] = '0';
+                    e[4] = hex[c >> 4]; e[5] = hex[c & 0x0F];
+                    n = 6;
+                } else {
+                    e[0] = (char)c;
+                    n = 1;
+                }
+                break;
+        }
+        if (!req_put(w, e, n)) {
+            // Cut inside a UTF-8 sequence: drop the part already copied
+            if ((c & 0xC0) == 0x80) {
+                while (w->len > start && ((unsigned char)groq_prompt[w->len - 1] & 0xC0) == 0x80) {
+                    w->len--;
+                }
+                if (w->len > start) {
+                    w->len--;      // The lead byte
+                }
             }
+            return;
+        }
+    }
+}
+
+// Fixed-point without printf (the prompt values are small)
+static void req_fixed(req_writer_t *w, float v, int decimals)
+{
+    char b[24];
+    char *p = b + sizeof(b);
+    if (!isfinite(v) || fabsf(v) > 1e9f) {
+        req_lit(w, "?");
+        return;
+    }
+    int scale = 1;
+    for (int i = 0; i < decimals; i++) {
+        scale *= 10;
+    }
+    int64_t x = llroundf(fabsf(v) * (float)scale);
+    bool neg = v < 0.0f && x != 0;
+    for (int i = 0; i < decimals; i++) {
+        *--p = (char)('0' + x % 10);
+        x /= 10;
+    }
+    if (decimals > 0) {
+        *--p = '.';
+    }
+    do {
+        *--p = (char)('0' + x % 10);
+        x /= 10;
+    } while (x != 0);
+    if (neg) {
+        *--p = '-';
+    }
+    req_put(w, p, (size_t)(b + sizeof(b) - p));
+}
+
+/**
+ * @brief Approximate tokens of escaped prompt text
+ *
+ * English is ~4 characters per token; a non-ASCII character is at least
+ * one token of its own and an emoji usually two or more.
+ */
+static size_t req_tokens(const char *s, size_t n)
+{
+    size_t ascii = 0, tokens = 0;
+    for (size_t i = 0; i < n; i++) {
+        unsigned char c = (unsigned char)s[i];
+        if (c < 0x80) {
+            ascii++;
+        } else if (c >= 0xF0) {
+            tokens += 2;
+        } else if (c >= 0xC0) {
+            tokens++;
+        }
+    }
+    return tokens + (ascii + 3) / 4;
+}
+
+static void req_open(req_writer_t *w, uint8_t prio, bool shorten)
+{
+    if (w->count < REQ_SECTIONS) {
+        req_section_t *sec = &w->sec[w->count];
+        sec->start = (uint16_t)w->len;
+        sec->prio = prio;
+        sec->shorten = shorten;
+    }
+}
+
+static void req_close(req_writer_t *w)
+{
+    if (w->count < REQ_SECTIONS) {
+        req_section_t *sec = &w->sec[w->count++];
+        sec->len = (uint16_t)(w->len - sec->start);
+        sec->tokens = (uint16_t)req_tokens(groq_prompt + sec->start, sec->len);
+    }
+}
+
+/**
+ * @brief Cut bytes [at, at + n) out of the prompt
+ */
+static void req_cut(req_writer_t *w, size_t at, size_t n)
+{
+    memmove(groq_prompt + at, groq_prompt + at + n, w->len - at - n);
+    w->len -= n;
+    for (uint8_t i = 0; i < w->count; i++) {
+        if (w->sec[i].start > at) {
+            w->sec[i].start = (uint16_t)(w->sec[i].start - n);
+        }
+    }
+}
+
+/**
+ * @brief Shorten or drop the least valuable sections until the prompt fits
+ * @return Estimated tokens of the prompt, closing included
+ */
+static size_t req_fit(req_writer_t *w, size_t budget)
+{
+    const size_t closing = req_tokens(w->closing, strlen(w->closing));
+    size_t total;
+    while ((total = closing + req_tokens(groq_prompt, w->len)) > budget) {
+        // Least valuable section left; the later one of equals
+        req_section_t *victim = NULL;
+        for (uint8_t i = 0; i < w->count; i++) {
+            req_section_t *sec = &w->sec[i];
+            if (sec->len > 0 && sec->prio < PRIO_KEEP && (victim == NULL || sec->prio <= victim->prio)) {
+                victim = sec;
+            }
+        }
+        if (victim == NULL) {
             break;
-        default:
-            break;
+        }
+        size_t over = total - budget;
+        char *text = groq_prompt + victim->start;
+        if (victim->shorten && victim->tokens >= over + REQ_SHORT_MIN_TOKENS) {
+            // Last space (never inside an escape or a UTF-8 sequence) where
+            // the text and "...\n" fit what is left for it
+            static const char tail[] = "...\\n";
+            size_t target = victim->tokens - over;
+            size_t keep = victim->len;
+            do {
+                keep--;
+            } while (keep > 0 && (text[keep] != ' ' ||
+                                  req_tokens(text, keep) + req_tokens(tail, sizeof(tail) - 1) > target));
+            victim->shorten = false;
+            if (keep > 0) {
+                memcpy(text + keep, tail, sizeof(tail) - 1);
+                keep += sizeof(tail) - 1;
+                req_cut(w, victim->start + keep, victim->len - keep);
+                victim->len = (uint16_t)keep;
+                victim->tokens = (uint16_t)req_tokens(text, keep);
+                continue;
+            }
+        }
+        req_cut(w, victim->start, victim->len);
+        victim->len = 0;
+        victim->tokens = 0;
     }
-    return ESP_OK;
+    return total;
 }
 
-bool gemini_query_aquarium(float ammonia_ppm, float nitrite_ppm, float nitrate_ppm, 
-                          float hours_since_feed, float days_since_clean,
-                          int feeds_per_day, int water_change_interval,
-                          char *response_buffer, size_t buffer_size)
+static size_t req_end(req_writer_t *w)
+{
+    w->limit = sizeof(groq_prompt) - 1;
+    req_lit(w, w->closing);
+    groq_prompt[w->len] = '\0';
+    return w->len;
+}
+
+#define GROQ_HISTORY_DAYS    30      // Window of the test history line
+
+// Readings in the last prompt a reply came back for (AI worker only)
+static float sent_ppm[3];
+static bool sent_valid = false;
+
+/**
+ * @brief Test history from the aggregate index: nitrate over the last
+ * GROQ_HISTORY_DAYS days and how long ammonia has been zero
+ * @return Length written, 0 if nothing was tested in the window
+ */
+static size_t history_line(char *buf, size_t len)
+{
+    int32_t today = history_agg_key(HISTORY_AGG_DAY, time_svc_wall());
+    history_agg_t agg;
+    buf[0] = '\0';
+    if (!time_svc_wall_valid() ||
+        !history_agg_range(HISTORY_AGG_DAY, today - GROQ_HISTORY_DAYS + 1, today, &agg) || agg.tests == 0) {
+        return 0;
+    }
+    int w = snprintf(buf, len, "Last %d days: %lu tests, nitrate avg %.0f ppm (%.0f-%.0f)",
+                     GROQ_HISTORY_DAYS, (unsigned long)agg.tests,
+                     agg.sum[HISTORY_TREND_NITRATE] / agg.tests,
+                     agg.min[HISTORY_TREND_NITRATE], agg.max[HISTORY_TREND_NITRATE]);
+    size_t used = w < 0 ? 0 : ((size_t)w < len ? (size_t)w : len - 1);
+    int32_t day;
+    if (used < len - 1) {
+        if (history_agg_last_above(HISTORY_AGG_DAY, HISTORY_TREND_AMMONIA, 0.0f, today, &day)) {
+            w = snprintf(buf + used, len - used, ", ammonia last above 0 %ld days ago", (long)(today - day));
+        } else {
+            w = snprintf(buf + used, len - used, ", ammonia never above 0");
+        }
+        if (w > 0) {
+            used += ((size_t)w < len - used) ? (size_t)w : len - used - 1;
+        }
+    }
+    return used;
+}
+
+/**
+ * @brief Advice cache key: the prompt inputs, quantised so readings that
+ * would get the same advice share a reply
+ *
+ * The mood reason is keyed by the scores it is rendered from (its text
+ * carries the raw readings, which would defeat the buckets). The forecast
+ * is not keyed: it follows from the readings and care timers above, and a
+ * prefetch made before a transition must find the key the request after
+ * it computes.
+ */
+static uint32_t advice_key(float ammonia_ppm, float nitrite_ppm, float nitrate_ppm,
+                           float hours_since_feed, float days_since_clean,
+                           int feeds_per_day, int water_change_interval, const mood_result_t *mood,
+                           const char *med_calc, const char *history)
 {
+    int32_t q[7] = {
+        (int32_t)lroundf(ammonia_ppm * 20.0f),   // 0.05 ppm
+        (int32_t)lroundf(nitrite_ppm * 20.0f),   // 0.05 ppm
+        (int32_t)lroundf(nitrate_ppm / 5.0f),    // 5 ppm
+        (int32_t)(hours_since_feed / 3.0f),      // 3 h
+        (int32_t)days_since_clean,               // Whole days
+        feeds_per_day,
+        water_change_interval,
+    };
+    uint32_t h = ai_cache_hash(AI_CACHE_HASH_SEED, q, sizeof(q));
+
+    if (mood != NULL) {
+        int8_t m[7] = {
+            (int8_t)mood->ammonia_score, (int8_t)mood->nitrite_score, (int8_t)mood->nitrate_score,
+            (int8_t)mood->ph_score, (int8_t)mood->feed_score, (int8_t)mood->clean_score,
+            (int8_t)mood->category,
+        };
+        h = ai_cache_hash(h, m, sizeof(m));
+    }
+    const mood_preset_t *profile = mood_engine_preset();
+    h = ai_cache_hash(h, profile->species, strlen(profile->species));
+    h = ai_cache_hash(h, med_calc, strlen(med_calc));
+    h = ai_cache_hash(h, history, strlen(history));
+    return h;
+}
+
+// Cached replies keep the summary in front of the advice, split by this
+#define CACHE_FIELD_SEP      '\x1F'
+
+static char cache_text[TEXT_BUF_CAPACITY + AI_SUMMARY_MAX];   // AI worker only
+
+static bool cache_load(uint32_t key, char *advice, size_t advice_size, char *summary, size_t summary_size)
+{
+    if (!ai_cache_get(key, cache_text, sizeof(cache_text))) {
+        return false;
+    }
+    const char *sep = strchr(cache_text, CACHE_FIELD_SEP);
+    const char *text = sep ? sep + 1 : cache_text;      // Stored before summaries: advice only
+    if (summary != NULL && summary_size > 0) {
+        size_t n = sep ? (size_t)(sep - cache_text) : 0;
+        snprintf(summary, summary_size, "%.*s", (int)n, cache_text);
+    }
+    snprintf(advice, advice_size, "%s", text);
+    return true;
+}
+
+static void cache_store(uint32_t key, const char *advice, const char *summary)
+{
+    snprintf(cache_text, sizeof(cache_text), "%s%c%s", summary ? summary : "", CACHE_FIELD_SEP, advice);
+    ai_cache_put(key, cache_text);
+}
+
+// Tank state a prompt is built from: now, or predicted (prefetch)
+typedef struct {
+    float ammonia_ppm;
+    float nitrite_ppm;
+    float nitrate_ppm;
+    float hours_since_feed;
+    float days_since_clean;
+    int feeds_per_day;
+    int water_change_interval;
+    const mood_result_t *mood;     // NULL before the first evaluation
+    const char *mood_reason;
+    const char *forecast_line;     // "" = none
+} advice_state_t;
+
+static gemini_partial_cb_t partial_cb = NULL;
+static void *partial_arg = NULL;
+
+void gemini_set_partial_cb(gemini_partial_cb_t cb, void *arg)
+{
+    partial_cb = cb;
+    partial_arg = arg;
+    ai_provider_set_partial_cb(cb, arg);
+}
+
+/**
+ * @brief Advice for a tank state: from the cache, else one completion
+ * @param prefetch Speculative: only on spare request budget, no partials,
+ *        and a cache hit is all that is needed
+ */
+static bool advice_query(const advice_state_t *st, bool prefetch, char *response_buffer, size_t buffer_size,
+                         char *summary_buffer, size_t summary_size)
+{
+    if (summary_buffer && summary_size > 0) {
+        summary_buffer[0] = '\0';
+    }
+    const float ammonia_ppm = st->ammonia_ppm;
+    const float nitrite_ppm = st->nitrite_ppm;
+    const float nitrate_ppm = st->nitrate_ppm;
+    const float hours_since_feed = st->hours_since_feed;
+    const float days_since_clean = st->days_since_clean;
+    const int feeds_per_day = st->feeds_per_day;
+    const int water_change_interval = st->water_change_interval;
+
+    // Dosage text from the dashboard's published state - never its buffer,
+    // which the LVGL task may be rewriting
+    static dash_live_t live;  // Only the AI worker builds prompts
+    dash_store_read(&live);
+
+    // Range aggregates over the test history (O(log n), no SD)
+    char history[160];
+    history_line(history, sizeof(history));
+
+    // Same tank state as a recent reply: answer from the cache, no network
+    uint32_t cache_key = advice_key(ammonia_ppm, nitrite_ppm, nitrate_ppm, hours_since_feed,
+                                    days_since_clean, feeds_per_day, water_change_interval, st->mood,
+                                    live.med_calc, history);
+    if (response_buffer && buffer_size > 0 &&
+        cache_load(cache_key, response_buffer, buffer_size, summary_buffer, summary_size)) {
+        ESP_LOGI(TAG, "AI Response (cached%s): %s", prefetch ? ", no prefetch needed" : "", response_buffer);
+        return true;
+    }
+
     if (!wifi_connected) {
         ESP_LOGE(TAG, "WiFi not connected");
         return false;
     }
 
-    // Check if quota is exhausted - don't waste network bandwidth
-    if (quota_exhausted) {
-        uint32_t now = (uint32_t)(esp_timer_get_time() / 1000000);
-        if (now < quota_reset_time) {
-            // Still in cooldown period
+    // Request budget and backoff (429 / Retry-After, repeated failures);
+    // a prefetch never takes the last token an interactive request needs
+    uint32_t wait_s = 0;
+    if (prefetch && !ai_rate_spare()) {
+        ESP_LOGI(TAG, "AI prefetch skipped - no spare request budget");
+        return false;
+    }
+    if (!ai_rate_acquire(&wait_s)) {
+        if (response_buffer && buffer_size > 0) {
+            snprintf(response_buffer, buffer_size, "AI is resting. Next try in %lu seconds.",
+                     (unsigned long)wait_s);
+        }
+        return false;
+    }
+
+    const char *mood_reason = st->mood_reason;
+    const char *forecast_line = st->forecast_line;
+
+    // Species and nitrate limits come from the active profile
+    const mood_preset_t *profile = mood_engine_preset();
+    const mood_band_table_t *no3 = &profile->factor[MOOD_FACTOR_NITRATE];
+
+    // Goldie's persona, then the sections by how much they matter now
+    req_writer_t w;
+    req_begin(&w, GROQ_P_CLOSING);
+    req_lit(&w, GROQ_P_INTRO);
+    req_str(&w, profile->species);
+    req_lit(&w, GROQ_P_WHO);
+
+    // Nitrogen cycle: a reading out of its band or moved since the last
+    // prompt gets its own line, the rest one "fine" line
+    static const char *const param_name[3] = { "ammonia", "nitrite", "nitrate" };
+    static const float param_quantum[3] = { 0.05f, 0.05f, 5.0f };
+    const float ppm[3] = { ammonia_ppm, nitrite_ppm, nitrate_ppm };
+    const char *fine[3];
+    int fine_count = 0;
+    for (int p = 0; p < 3; p++) {
+        int decimals = p == 2 ? 0 : 2;
+        int score = mood_engine_score((mood_factor_t)(MOOD_FACTOR_AMMONIA + p), ppm[p], 1.0f);
+        bool moved = sent_valid && fabsf(ppm[p] - sent_ppm[p]) >= param_quantum[p];
+        if (score >= 0 && !moved) {
+            fine[fine_count++] = param_name[p];
+            continue;
+        }
+        req_open(&w, score <= -2 ? PRIO_KEEP : (score < 0 ? PRIO_HIGH : PRIO_MID), false);
+        req_lit(&w, param_name[p]);
+        req_lit(&w, ": ");
+        req_fixed(&w, ppm[p], decimals);
+        req_lit(&w, " ppm");
+        if (moved) {
+            req_lit(&w, " (was ");
+            req_fixed(&w, sent_ppm[p], decimals);
+            req_lit(&w, ")");
+        }
+        if (p == 2) {
+            req_lit(&w, ", safe <");
+            req_fixed(&w, no3->high[0], 0);
+            req_lit(&w, ", stress >");
+            req_fixed(&w, no3->high[1], 0);
+        }
+        req_lit(&w, score < 0 ? ", out of range\\n" : "\\n");
+        req_close(&w);
+    }
+    if (fine_count > 0) {
+        req_open(&w, PRIO_LOW, false);
+        req_lit(&w, "In range: ");
+        for (int i = 0; i < fine_count; i++) {
+            req_lit(&w, i ? ", " : "");
+            req_lit(&w, fine[i]);
+        }
+        req_lit(&w, "\\n");
+        req_close(&w);
+    }
+
+    // Care: only worth the tokens when it is what upsets the fish
+    float feed_every_s = feeds_per_day > 0 ? 86400.0f / feeds_per_day : 86400.0f;
+    int feed_score = mood_engine_score(MOOD_FACTOR_FEED, hours_since_feed * 3600.0f, feed_every_s);
+    int clean_score = mood_engine_score(MOOD_FACTOR_CLEAN, days_since_clean * 86400.0f,
+                                        (float)water_change_interval * 86400.0f);
+    req_open(&w, feed_score < 0 ? PRIO_HIGH : PRIO_LOW, false);
+    req_lit(&w, "Fed ");
+    req_fixed(&w, hours_since_feed, 1);
+    req_lit(&w, " h ago, ");
+    req_fixed(&w, (float)feeds_per_day, 0);
+    req_lit(&w, " feeds/day\\n");
+    req_close(&w);
+    req_open(&w, clean_score < 0 ? PRIO_HIGH : PRIO_LOW, false);
+    req_lit(&w, "Water changed ");
+    req_fixed(&w, days_since_clean, 1);
+    req_lit(&w, " days ago, every ");
+    req_fixed(&w, (float)water_change_interval, 0);
+    req_lit(&w, " days\\n");
+    req_close(&w);
+
+    req_open(&w, PRIO_MID, true);
+    req_lit(&w, "Mood: ");
+    req_str(&w, mood_reason);
+    req_lit(&w, "\\n");
+    req_close(&w);
+    if (forecast_line[0] != '\0') {
+        req_open(&w, PRIO_MID, false);
+        req_str(&w, forecast_line);
+        req_lit(&w, "\\n");
+        req_close(&w);
+    }
+    if (history[0] != '\0') {
+        req_open(&w, PRIO_LOW, false);
+        req_str(&w, history);
+        req_lit(&w, "\\n");
+        req_close(&w);
+    }
+    if (live.med_calc[0] != '\0') {
+        req_open(&w, PRIO_LOW, false);
+        req_str(&w, live.med_calc);
+        req_lit(&w, "\\n");
+        req_close(&w);
+    }
+    size_t before = w.len;
+    size_t tokens = req_fit(&w, CONFIG_GOLDIE_AI_PROMPT_TOKENS);
+    if (w.len < before) {
+        ESP_LOGI(TAG, "Prompt ~%u tokens (%u bytes cut to fit %d)", (unsigned)tokens,
+                 (unsigned)(before - w.len), CONFIG_GOLDIE_AI_PROMPT_TOKENS);
+    } else {
+        ESP_LOGD(TAG, "Prompt ~%u tokens", (unsigned)tokens);
+    }
+    size_t prompt_len = req_end(&w);
+
+    // Fastest healthy provider, hedged with the next one if it is slow; one
+    // completion for the advice and its summary. A prefetch is not shown
+    // while it streams.
+    ai_query_result_t result;
+    ai_reply_t reply = {};
+    reply.text[AI_FIELD_ADVICE] = response_buffer;
+    reply.size[AI_FIELD_ADVICE] = buffer_size;
+    reply.text[AI_FIELD_SUMMARY] = summary_buffer;
+    reply.size[AI_FIELD_SUMMARY] = summary_size;
+    if (prefetch) {
+        ai_provider_set_partial_cb(NULL, NULL);
+    }
+    bool success = ai_provider_query(groq_prompt, prompt_len, &reply, &result);
+    if (prefetch) {
+        ai_provider_set_partial_cb(partial_cb, partial_arg);
+    }
+    if (success) {
+        if (result.truncated) {
+            ESP_LOGW(TAG, "AI reply cut to %u bytes (buffer %u)",
+                     (unsigned)strlen(response_buffer), (unsigned)buffer_size);
+        }
+        ESP_LOGI(TAG, "AI Response (%s%s): %s", result.provider, prefetch ? ", prefetch" : "", response_buffer);
+        ai_rate_success();
+        if (summary_buffer && summary_buffer[0] != '\0') {
+            ESP_LOGI(TAG, "AI summary: %s", summary_buffer);
+        }
+        cache_store(cache_key, response_buffer, summary_buffer);
+        if (!prefetch) {
+            memcpy(sent_ppm, ppm, sizeof(sent_ppm));
+            sent_valid = true;
+        }
+    } else {
+        if (result.status == 429) {
+            ESP_LOGW(TAG, "API rate limit / quota hit - backing off");
             if (response_buffer && buffer_size > 0) {
-                snprintf(response_buffer, buffer_size, 
-                        "API quota exhausted. Resets in %lu seconds.", 
-                        quota_reset_time - now);
+                snprintf(response_buffer, buffer_size, "API quota exhausted. Will retry later.");
             }
-            return false;
-        } else {
-            // Cooldown expired, try again
-            ESP_LOGI(TAG, "Quota cooldown expired, retrying API...");
-            quota_exhausted = false;
         }
+        ai_rate_failure(result.err_class, 0);
+        ai_rate_log_stats();
     }
+    return success;
+}
 
-    // Build the prompt with Goldie personality - focusing on nitrogen cycle
-    char prompt[1024];
-    int prompt_len = snprintf(prompt, sizeof(prompt),
-        "You are Goldie, a friendly and caring goldfish who lives in this aquarium! 🐠\n"
-        "Respond in first-person as Goldie with a cheerful, bubbly personality (max 80 words).\n\n"
-        "Current water quality (Nitrogen Cycle):\n"
-        "⚠️ Ammonia (NH3): %.2f ppm (MUST be 0!)\n"
-        "⚠️ Nitrite (NO2): %.2f ppm (MUST be 0!)\n"
-        "📊 Nitrate (NO3): %.0f ppm (safe <20, warning 20-40)\n\n"
-        "Feeding schedule:\n"
-        "🍽️ Scheduled feeds: %d times per day\n"
-        "⏰ Last fed: %.1f hours ago\n\n"
-        "Water maintenance:\n"
-        "💧 Water change interval: every %d days\n"
-        "🧽 Last cleaned: %.1f days ago\n\n"
-        "MOOD STATUS:\n"
-        "%s\n",
-        ammonia_ppm, nitrite_ppm, nitrate_ppm, feeds_per_day, hours_since_feed, 
-        water_change_interval, days_since_clean, latest_mood_reason);
-    
-    // Append medication context if available
-    if (latest_med_calculation[0] != '\0') {
-        prompt_len += snprintf(prompt + prompt_len, sizeof(prompt) - prompt_len,
-                              "\n%s\n", latest_med_calculation);
+bool gemini_query_aquarium(float ammonia_ppm, float nitrite_ppm, float nitrate_ppm, 
+                          float hours_since_feed, float days_since_clean,
+                          int feeds_per_day, int water_change_interval,
+                          char *response_buffer, size_t buffer_size,
+                          char *summary_buffer, size_t summary_size)
+{
+    // Why the tank is in its current mood, rendered from the latest evaluation
+    static char mood_reason[512];  // Only the AI worker builds prompts
+    mood_engine_latest_reason(mood_reason, sizeof(mood_reason));
+    mood_result_t mood;
+    bool have_mood = mood_engine_latest_result(&mood);
+
+    // Early warning from parameter trends (logic_task forecast)
+    mood_forecast_t forecast;
+    char forecast_line[160];
+    if (!mood_trend_get_latest(&forecast) ||
+        mood_trend_format_forecast(&forecast, forecast_line, sizeof(forecast_line)) <= 0) {
+        forecast_line[0] = '\0';
     }
-    
-    // Add closing instruction
-    snprintf(prompt + prompt_len, sizeof(prompt) - prompt_len,
-             "\nAs Goldie, comment on how you're feeling in these conditions and give friendly advice!");
 
+    advice_state_t st = {
+        ammonia_ppm, nitrite_ppm, nitrate_ppm, hours_since_feed, days_since_clean,
+        feeds_per_day, water_change_interval, have_mood ? &mood : NULL, mood_reason, forecast_line,
+    };
+    return advice_query(&st, false, response_buffer, buffer_size, summary_buffer, summary_size);
+}
 
-    // Build JSON request body for Groq (OpenAI-compatible format)
-    cJSON *root = cJSON_CreateObject();
-    cJSON_AddStringToObject(root, "model", "llama-3.3-70b-versatile");
-    
-    cJSON *messages = cJSON_CreateArray();
-    cJSON *message = cJSON_CreateObject();
-    cJSON_AddStringToObject(message, "role", "user");
-    cJSON_AddStringToObject(message, "content", prompt);
-    cJSON_AddItemToArray(messages, message);
-    cJSON_AddItemToObject(root, "messages", messages);
-    
-    cJSON_AddNumberToObject(root, "max_tokens", 150);
-    cJSON_AddNumberToObject(root, "temperature", 0.7);
-    
-    char *json_str = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-
-    // Configure HTTP client
-    response_len = 0;
-    memset(http_response, 0, sizeof(http_response));
-
-    esp_http_client_config_t config = {};
-    config.url = GROQ_API_URL;
-    config.method = HTTP_METHOD_POST;
-    config.event_handler = http_event_handler;
-    config.timeout_ms = 10000;
-    config.crt_bundle_attach = esp_crt_bundle_attach;
-
-    esp_http_client_handle_t client = esp_http_client_init(&config);
-    esp_http_client_set_header(client, "Content-Type", "application/json");
-    
-    // Groq uses Bearer token authentication
-    char auth_header[256];
-    snprintf(auth_header, sizeof(auth_header), "Bearer %s", GROQ_API_KEY);
-    esp_http_client_set_header(client, "Authorization", auth_header);
-    
-    esp_http_client_set_post_field(client, json_str, strlen(json_str));
+bool gemini_prefetch_aquarium(uint32_t at, char *response_buffer, size_t buffer_size,
+                              char *summary_buffer, size_t summary_size)
+{
+    // The tank as the dashboard will describe it at `at`: same readings,
+    // care timers run on (the request then computes the same cache key)
+    static dash_live_t live;       // AI worker only
+    if (dash_store_read(&live) == 0) {
+        return false;
+    }
+    aquarium_params_t params = {};
+    params.ammonia_ppm = live.ammonia_ppm;
+    params.nitrite_ppm = live.nitrite_ppm;
+    params.nitrate_ppm = live.nitrate_ppm;
+    params.ph_level = live.ph_level;
+    params.last_feed_time = live.last_feed_time;
+    params.last_clean_time = live.last_clean_time;
+    params.planned_feed_interval = live.planned_feed_interval;
+    params.planned_water_change_interval = live.planned_water_change_interval;
+    mood_result_t mood = mood_engine_evaluate(&params, at);
 
-    // Perform request
-    esp_err_t err = esp_http_client_perform(client);
-    free(json_str);
+    static char mood_reason[512];  // AI worker only
+    mood_engine_format_reason(&mood, &params, at, mood_reason, sizeof(mood_reason));
 
-    bool success = false;
-    if (err == ESP_OK) {
-        int status = esp_http_client_get_status_code(client);
-        ESP_LOGI(TAG, "HTTP Status = %d, Response length = %d", status, response_len);
-        
-        // Log error responses for debugging
-        if (status != 200 && response_len > 0) {
-            ESP_LOGE(TAG, "API Error Response: %s", http_response);
-            
-            // Handle 429 (quota exhausted) - stop retrying for 1 hour
-            if (status == 429) {
-                quota_exhausted = true;
-                quota_reset_time = (uint32_t)(esp_timer_get_time() / 1000000) + 3600; // 1 hour cooldown
-                ESP_LOGW(TAG, "API quota exhausted! Disabling API calls for 1 hour to save bandwidth.");
-                if (response_buffer && buffer_size > 0) {
-                    snprintf(response_buffer, buffer_size, 
-                            "API quota exhausted. Will retry in 1 hour.");
-                }
-            }
+    advice_state_t st = {
+        live.ammonia_ppm, live.nitrite_ppm, live.nitrate_ppm,
+        (at - live.last_feed_time) / 3600.0f, (at - live.last_clean_time) / 86400.0f,
+        live.feeds_per_day, (int)live.planned_water_change_interval, &mood, mood_reason, "",
+    };
+    ESP_LOGI(TAG, "Prefetching AI advice for the mood in %lu s (%s)",
+             (unsigned long)(at - time_svc_uptime_s()), mood.category == 2 ? "ANGRY" : (mood.category == 1 ? "SAD" : "HAPPY"));
+    return advice_query(&st, true, response_buffer, buffer_size, summary_buffer, summary_size);
+}
+
+bool gemini_chat(uint32_t seq, char *reply_buffer, size_t reply_size, char *memo_buffer, size_t memo_size)
+{
+    reply_buffer[0] = '\0';
+    memo_buffer[0] = '\0';
+    if (!wifi_connected) {
+        ESP_LOGE(TAG, "WiFi not connected");
+        return false;
+    }
+    uint32_t first, end;
+    ai_chat_span(&first, &end);
+    if (seq < first || seq >= end) {
+        ESP_LOGW(TAG, "Chat turn %lu no longer held", (unsigned long)seq);
+        return false;
+    }
+    uint32_t wait_s = 0;
+    if (!ai_rate_acquire(&wait_s)) {
+        snprintf(reply_buffer, reply_size, "I need a little rest - ask me again in %lu seconds.",
+                 (unsigned long)wait_s);
+        return false;
+    }
+
+    static char mood_reason[512];              // AI worker only
+    static char turn[TEXT_BUF_CAPACITY];
+    static char memo[AI_CHAT_MEMO_MAX];
+    mood_engine_latest_reason(mood_reason, sizeof(mood_reason));
+    ai_chat_memo(memo, sizeof(memo));
+
+    req_writer_t w;
+    req_begin(&w, GROQ_P_CHAT_CLOSING);
+    req_lit(&w, GROQ_P_INTRO);
+    req_str(&w, mood_engine_preset()->species);
+    req_lit(&w, GROQ_P_CHAT_WHO);
+    req_open(&w, PRIO_MID, true);
+    req_lit(&w, "Your mood: ");
+    req_str(&w, mood_reason);
+    req_lit(&w, "\\n");
+    req_close(&w);
+
+    // Newest turns back from the question while they fit the budget; the
+    // memo stands in for the ones left out
+    size_t used = req_tokens(groq_prompt, w.len) + req_tokens(w.closing, strlen(w.closing)) +
+                  (memo[0] != '\0' ? req_tokens(memo, strlen(memo)) + 3 : 0);
+    uint32_t from = seq + 1;
+    ai_chat_role_t role;
+    while (from > first && ai_chat_get(from - 1, &role, turn, sizeof(turn))) {
+        size_t tokens = req_tokens(turn, strlen(turn)) + 2;
+        if (from <= seq && used + tokens > CONFIG_GOLDIE_AI_CHAT_TOKENS) {
+            break;
         }
-        
-        if (status == 200 && response_len > 0) {
-            // Success! Reset quota flag if it was set
-            if (quota_exhausted) {
-                ESP_LOGI(TAG, "API quota restored!");
-                quota_exhausted = false;
-            }
-            
-            // Parse JSON response (OpenAI format)
-            cJSON *resp_json = cJSON_Parse(http_response);
-            if (resp_json) {
-                cJSON *choices = cJSON_GetObjectItem(resp_json, "choices");
-                if (choices && cJSON_GetArraySize(choices) > 0) {
-                    cJSON *choice = cJSON_GetArrayItem(choices, 0);
-                    cJSON *message = cJSON_GetObjectItem(choice, "message");
-                    cJSON *content = cJSON_GetObjectItem(message, "content");
-                    if (content && content->valuestring) {
-                        strncpy(response_buffer, content->valuestring, buffer_size - 1);
-                        response_buffer[buffer_size - 1] = '\0';
-                        success = true;
-                        ESP_LOGI(TAG, "AI Response: %s", response_buffer);
-                    }
-                }
-                cJSON_Delete(resp_json);
-            }
+        used += tokens;
+        from--;
+    }
+    if (from > first && memo[0] != '\0') {
+        req_open(&w, PRIO_LOW, false);
+        req_lit(&w, "Earlier: ");
+        req_str(&w, memo);
+        req_lit(&w, "\\n");
+        req_close(&w);
+    }
+    for (uint32_t s = from; s <= seq; s++) {
+        if (ai_chat_get(s, &role, turn, sizeof(turn))) {
+            req_lit(&w, role == AI_CHAT_OWNER ? "Owner: " : "Goldie: ");
+            req_str(&w, turn);
+            req_lit(&w, "\\n");
         }
-    } else {
-        ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
     }
+    size_t tokens = req_fit(&w, CONFIG_GOLDIE_AI_CHAT_TOKENS);
+    ESP_LOGI(TAG, "Chat prompt ~%u tokens: turns %lu..%lu%s", (unsigned)tokens, (unsigned long)from,
+             (unsigned long)seq, from > first ? " + memo" : "");
+    size_t prompt_len = req_end(&w);
 
-    esp_http_client_cleanup(client);
+    ai_query_result_t result;
+    ai_reply_t reply = {};
+    reply.text[AI_FIELD_ADVICE] = reply_buffer;
+    reply.size[AI_FIELD_ADVICE] = reply_size;
+    reply.text[AI_FIELD_SUMMARY] = memo_buffer;
+    reply.size[AI_FIELD_SUMMARY] = memo_size;
+    bool success = ai_provider_query(groq_prompt, prompt_len, &reply, &result);
+    if (success) {
+        ESP_LOGI(TAG, "Chat reply (%s): %s", result.provider, reply_buffer);
+        ai_rate_success();
+    } else {
+        ai_rate_failure(result.err_class, 0);
+        ai_rate_log_stats();
+    }
     return success;
 }
+
+#endif // CONFIG_GOLDIE_AI
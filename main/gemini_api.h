@@ -4,31 +4,97 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "sdkconfig.h"
+
+#ifndef CONFIG_GOLDIE_AI
+#define CONFIG_GOLDIE_AI 0
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Connection state bits (gemini_net_events). Level bits follow the link;
+// NET_EVENT_CHANGED is an edge for one consumer (task_coordinator), which
+// clears it.
+#define NET_EVENT_WIFI_UP      BIT0   // Associated with the AP
+#define NET_EVENT_IP           BIT1   // DHCP lease: online
+#define NET_EVENT_TIME_SYNCED  BIT2   // SNTP set the clock (stays set)
+#define NET_EVENT_BLYNK_READY  BIT3   // blynk_init() succeeded (set by task_coordinator)
+#define NET_EVENT_CHANGED      BIT4   // NET_EVENT_IP was set or cleared
+#define NET_EVENT_TIME_FRESH   BIT5   // Any SNTP sync, first or periodic (an edge, like CHANGED)
+
 /**
- * @brief Initialize WiFi and connect to network
- * @return true if connected successfully
+ * @brief Initialize WiFi and start connecting (does not wait)
+ * 
+ * Association, DHCP and SNTP carry on in the background and are reported
+ * through gemini_net_events(); a dropped link reconnects by itself.
+ * @return true if WiFi started (connection pending)
  */
 bool gemini_init_wifi(void);
 
+/**
+ * @brief Connection state event group (NULL before gemini_init_wifi())
+ */
+EventGroupHandle_t gemini_net_events(void);
+
 /**
  * @brief Check if WiFi is currently connected
  * @return true if connected, false otherwise
  */
 bool gemini_is_wifi_connected(void);
 
+/**
+ * @brief Modem sleep between DTIM beacons (WIFI_PS_MIN_MODEM) on / off
+ */
+void gemini_wifi_power_save(bool on);
+
+/**
+ * @brief Ask SNTP for the time again now (no-op before the first lease)
+ */
+void gemini_time_resync(void);
+
 /**
  * @brief Get current time in seconds since epoch
  * @return Current Unix timestamp, or 0 if time not synced
  */
 uint32_t gemini_get_current_time(void);
 
+#ifndef CONFIG_GOLDIE_AI_STREAM_INTERVAL_MS
+#define CONFIG_GOLDIE_AI_STREAM_INTERVAL_MS 100
+#endif
+
+// The AI client below is built with CONFIG_GOLDIE_AI; WiFi and time above
+// always are
+
+/**
+ * @brief Receives the reply text so far while a streamed reply arrives
+ * 
+ * Runs on the AI worker inside gemini_query_aquarium(), at most every
+ * CONFIG_GOLDIE_AI_STREAM_INTERVAL_MS. text is the caller's response
+ * buffer (NUL-terminated, still being written): copy what you need.
+ */
+typedef void (*gemini_partial_cb_t)(const char *text, void *arg);
+
+#if CONFIG_GOLDIE_AI
+
+/**
+ * @brief Set the partial reply callback (NULL = none)
+ * 
+ * Only called with CONFIG_GOLDIE_AI_STREAM; the reply is complete only when
+ * gemini_query_aquarium() returns.
+ */
+void gemini_set_partial_cb(gemini_partial_cb_t cb, void *arg);
+
 /**
  * @brief Query Gemini API with aquarium parameters
+ * 
+ * Requests share one long-lived HTTPS client (keep-alive, TLS session
+ * resumption), so only the first pays for a full handshake. AI worker only.
+ * With CONFIG_GOLDIE_AI_STREAM the reply is streamed (server-sent events)
+ * and passed to the partial callback as it grows.
  * @param ammonia_ppm Current ammonia level in ppm (must be 0)
  * @param nitrite_ppm Current nitrite level in ppm (must be 0)
  * @param nitrate_ppm Current nitrate level in ppm (<20 safe)
@@ -38,12 +104,59 @@ uint32_t gemini_get_current_time(void);
  * @param water_change_interval Days between water changes
  * @param response_buffer Buffer to store AI response (min 256 bytes)
  * @param buffer_size Size of response buffer
+ * @param summary_buffer One-line summary from the same reply (Blynk),
+ *        empty if the model gave none; NULL = not wanted
+ * @param summary_size Size of summary_buffer (AI_SUMMARY_MAX is enough)
  * @return true if successful
  */
 bool gemini_query_aquarium(float ammonia_ppm, float nitrite_ppm, float nitrate_ppm, 
                           float hours_since_feed, float days_since_clean,
                           int feeds_per_day, int water_change_interval,
-                          char *response_buffer, size_t buffer_size);
+                          char *response_buffer, size_t buffer_size,
+                          char *summary_buffer, size_t summary_size);
+
+/**
+ * @brief Ask for the advice of a predicted tank state ahead of time
+ *
+ * The state is the dashboard's published one with the feed / water change
+ * timers run on to `at` (uptime seconds), when the mood is about to cross
+ * a band. The reply only goes into the advice cache, under the key the
+ * request made after the crossing computes, so that request is answered
+ * from flash. Spare request budget only (ai_rate_spare()), no partial
+ * replies. AI worker only.
+ * @param response_buffer Scratch for the reply (like gemini_query_aquarium)
+ * @return true if the advice for that state is cached now
+ */
+bool gemini_prefetch_aquarium(uint32_t at, char *response_buffer, size_t buffer_size,
+                              char *summary_buffer, size_t summary_size);
+
+/**
+ * @brief Answer the owner's chat turn `seq` (ai_chat.h), "Ask Goldie"
+ *
+ * The prompt is the persona, the current mood and the newest turns up to
+ * `seq` that fit CONFIG_GOLDIE_AI_CHAT_TOKENS, with the conversation memo
+ * in place of older ones. Streams through the partial callback like
+ * gemini_query_aquarium(). Not cached. AI worker only.
+ * @param reply_buffer Goldie's answer (or a reason on failure)
+ * @param memo_buffer  The model's memo of the conversation, for the next prompt
+ * @return true if a provider answered
+ */
+bool gemini_chat(uint32_t seq, char *reply_buffer, size_t reply_size, char *memo_buffer, size_t memo_size);
+
+#else
+// Built without the AI client: every query fails, so the AI worker answers
+// with the offline advice
+static inline void gemini_set_partial_cb(gemini_partial_cb_t cb, void *arg) {}
+static inline bool gemini_query_aquarium(float ammonia_ppm, float nitrite_ppm, float nitrate_ppm,
+                                         float hours_since_feed, float days_since_clean,
+                                         int feeds_per_day, int water_change_interval,
+                                         char *response_buffer, size_t buffer_size,
+                                         char *summary_buffer, size_t summary_size) { return false; }
+static inline bool gemini_prefetch_aquarium(uint32_t at, char *response_buffer, size_t buffer_size,
+                                            char *summary_buffer, size_t summary_size) { return false; }
+static inline bool gemini_chat(uint32_t seq, char *reply_buffer, size_t reply_size,
+                               char *memo_buffer, size_t memo_size) { return false; }
+#endif // CONFIG_GOLDIE_AI
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,383 @@
+#include "history_export.h"
+#include "history/history_store.h"
+#include "history/param_series.h"
+#include "cbor_lite.h"
+#include "web_server.h"
+#include "esp_lvgl_port.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+
+static const char *TAG = "history_export";
+
+#define HISTORY_EXPORT_LINE     192   // Longest CSV row (daily: 12 values) or CBOR record
+#define HISTORY_EXPORT_LOCK_MS  100   // Index lookup; the range is not clipped without it
+
+static bool registered = false;
+
+// Handlers run one at a time on the server task - one buffer serves all
+static char chunk[HISTORY_EXPORT_CHUNK];
+
+static const char *const MOOD_NAMES[] = { "happy", "sad", "angry" };
+
+typedef enum {
+    FORMAT_CSV,
+    FORMAT_BIN,
+    FORMAT_CBOR,
+} export_format_t;
+
+static const char *const FORMAT_EXT[] = { "csv", "bin", "cbor" };
+static const char *const FORMAT_TYPE[] = { "text/csv", "application/octet-stream", "application/cbor" };
+
+// "YYYY-MM-DD" -> local day number
+static bool parse_day(const char *s, int32_t *day)
+{
+    int y, m, d;
+    if (sscanf(s, "%4d-%2d-%2d", &y, &m, &d) != 3 || m < 1 || m > 12 || d < 1 || d > 31) {
+        return false;
+    }
+    *day = history_civil_day(y, m, d);
+    return true;
+}
+
+static void format_date(int32_t day, char *out, size_t len)
+{
+    time_t t = (time_t)day * 86400;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    strftime(out, len, "%Y-%m-%d", &tm);
+}
+
+static int format_event(char *out, size_t len, const history_store_event_t *e)
+{
+    time_t t = (time_t)e->timestamp;
+    struct tm tm;
+    char when[24];
+    localtime_r(&t, &tm);
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &tm);
+
+    switch (e->kind) {
+        case HISTORY_FEED:
+            return snprintf(out, len, "%s,feed,,,,,,\n", when);
+        case HISTORY_WATER:
+            return snprintf(out, len, "%s,water_change,,,,,,\n", when);
+        case HISTORY_PARAM:
+            return snprintf(out, len, "%s,parameters,%.3f,%.2f,%.3f,%.2f,%.2f,\n", when,
+                            e->value[HISTORY_AMMONIA], e->value[HISTORY_NITRATE], e->value[HISTORY_NITRITE],
+                            e->value[HISTORY_LOW_PH], e->value[HISTORY_HIGH_PH]);
+        default: {
+            unsigned mood = (unsigned)e->value[0];
+            return snprintf(out, len, "%s,mood,,,,,,%s\n", when, mood < 3 ? MOOD_NAMES[mood] : "unknown");
+        }
+    }
+}
+
+static int format_rollup(char *out, size_t len, const history_store_rollup_t *r)
+{
+    char date[12];
+    format_date(r->day, date, sizeof(date));
+    int n = snprintf(out, len, "%s,%u,%u,%u,%s", date, (unsigned)r->count[HISTORY_FEED],
+                     (unsigned)r->count[HISTORY_WATER], (unsigned)r->count[HISTORY_PARAM],
+                     (r->mood >= 1 && r->mood <= 3) ? MOOD_NAMES[r->mood - 1] : "");
+    for (int p = 0; p < HISTORY_STORE_PARAMS && n < (int)len; p++) {
+        if (r->count[HISTORY_PARAM] == 0) {
+            n += snprintf(out + n, len - n, ",,,");
+        } else {
+            n += snprintf(out + n, len - n, ",%.3f,%.3f,%.3f", r->min[p], r->max[p], r->mean[p]);
+        }
+    }
+    if (n < (int)len) {
+        n += snprintf(out + n, len - n, "\n");
+    }
+    return n;
+}
+
+// CBOR: [time, "feed" | "water_change" | "mood", (mood name)] or
+// [time, "parameters", ammonia, nitrate, nitrite, low pH, high pH]
+static int cbor_event(uint8_t *out, size_t len, const history_store_event_t *e)
+{
+    cbor_writer_t w;
+    cbor_writer_init(&w, out, len);
+    switch (e->kind) {
+        case HISTORY_FEED:
+            cbor_put_array(&w, 2);
+            cbor_put_uint(&w, e->timestamp);
+            cbor_put_text(&w, "feed");
+            break;
+        case HISTORY_WATER:
+            cbor_put_array(&w, 2);
+            cbor_put_uint(&w, e->timestamp);
+            cbor_put_text(&w, "water_change");
+            break;
+        case HISTORY_PARAM:
+            cbor_put_array(&w, 7);
+            cbor_put_uint(&w, e->timestamp);
+            cbor_put_text(&w, "parameters");
+            cbor_put_float(&w, e->value[HISTORY_AMMONIA]);
+            cbor_put_float(&w, e->value[HISTORY_NITRATE]);
+            cbor_put_float(&w, e->value[HISTORY_NITRITE]);
+            cbor_put_float(&w, e->value[HISTORY_LOW_PH]);
+            cbor_put_float(&w, e->value[HISTORY_HIGH_PH]);
+            break;
+        default: {
+            unsigned mood = (unsigned)e->value[0];
+            cbor_put_array(&w, 3);
+            cbor_put_uint(&w, e->timestamp);
+            cbor_put_text(&w, "mood");
+            cbor_put_text(&w, mood < 3 ? MOOD_NAMES[mood] : "unknown");
+            break;
+        }
+    }
+    return w.overflow ? 0 : (int)w.len;
+}
+
+// CBOR: ["YYYY-MM-DD", feeds, water changes, tests, worst mood ("" unknown),
+//        [min x4], [max x4], [mean x4]] - parameter arrays empty without tests
+static int cbor_rollup(uint8_t *out, size_t len, const history_store_rollup_t *r)
+{
+    char date[12];
+    format_date(r->day, date, sizeof(date));
+    cbor_writer_t w;
+    cbor_writer_init(&w, out, len);
+    cbor_put_array(&w, 8);
+    cbor_put_text(&w, date);
+    cbor_put_uint(&w, r->count[HISTORY_FEED]);
+    cbor_put_uint(&w, r->count[HISTORY_WATER]);
+    cbor_put_uint(&w, r->count[HISTORY_PARAM]);
+    cbor_put_text(&w, (r->mood >= 1 && r->mood <= 3) ? MOOD_NAMES[r->mood - 1] : "");
+    const float *stats[] = { r->min, r->max, r->mean };
+    for (const float *stat : stats) {
+        bool tested = r->count[HISTORY_PARAM] > 0;
+        cbor_put_array(&w, tested ? HISTORY_STORE_PARAMS : 0);
+        for (int p = 0; tested && p < HISTORY_STORE_PARAMS; p++) {
+            cbor_put_float(&w, stat[p]);
+        }
+    }
+    return w.overflow ? 0 : (int)w.len;
+}
+
+/**
+ * @brief GET /history/events and /history/daily (user_ctx != NULL: daily)
+ */
+static esp_err_t history_get_handler(httpd_req_t *req)
+{
+    bool rollups = req->user_ctx != NULL;
+    export_format_t format = FORMAT_CSV;
+    int32_t from = INT32_MIN, to = INT32_MAX;
+
+    char query[96];
+    char val[16];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+        if (httpd_query_key_value(query, "format", val, sizeof(val)) == ESP_OK) {
+            format = strcmp(val, "bin") == 0 ? FORMAT_BIN
+                   : strcmp(val, "cbor") == 0 ? FORMAT_CBOR : FORMAT_CSV;
+        }
+        if ((httpd_query_key_value(query, "from", val, sizeof(val)) == ESP_OK && !parse_day(val, &from)) ||
+            (httpd_query_key_value(query, "to", val, sizeof(val)) == ESP_OK && !parse_day(val, &to))) {
+            return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Dates are YYYY-MM-DD");
+        }
+    }
+
+    // The index (LVGL-owned) knows which days have anything: clip the range
+    // to them, and answer an empty one without touching the card
+    bool empty = false;
+    if (lvgl_port_lock(HISTORY_EXPORT_LOCK_MS)) {
+        int32_t first, last;
+        if (history_store_span(from, to, &first, &last)) {
+            from = first;
+            to = last;
+        } else {
+            empty = true;
+        }
+        lvgl_port_unlock();
+    }
+
+    history_store_reader_t reader = {};
+    if (!empty) {
+        esp_err_t err = history_store_reader_open(&reader, rollups, from, to);
+        if (err == ESP_ERR_INVALID_STATE) {
+            httpd_resp_set_status(req, "503 Service Unavailable");
+            return httpd_resp_sendstr(req, "History store busy or off - retry later");
+        }
+        empty = (err != ESP_OK);
+    }
+
+    const char *name = rollups ? "daily" : "events";
+    char disposition[64];
+    snprintf(disposition, sizeof(disposition), "attachment; filename=\"%s.%s\"", name, FORMAT_EXT[format]);
+    httpd_resp_set_type(req, FORMAT_TYPE[format]);
+    httpd_resp_set_hdr(req, "Content-Disposition", disposition);
+
+    size_t len = 0;
+    if (format == FORMAT_CBOR) {
+        chunk[len++] = (char)0x9F;    // Indefinite array: the count is not known up front
+    } else if (format == FORMAT_CSV) {
+        len = (size_t)snprintf(chunk, sizeof(chunk), "%s\n", rollups
+            ? "Date,Feeds,WaterChanges,Tests,WorstMood,"
+              "AmmoniaMin,AmmoniaMax,AmmoniaMean,NitrateMin,NitrateMax,NitrateMean,"
+              "NitriteMin,NitriteMax,NitriteMean,pHMin,pHMax,pHMean"
+            : "DateTime,Event,Ammonia_ppm,Nitrate_ppm,Nitrite_ppm,LowPH,HighPH,Mood");
+    }
+
+    union {
+        history_store_event_t event;
+        history_store_rollup_t rollup;
+    } rec;
+    size_t rec_size = rollups ? sizeof(rec.rollup) : sizeof(rec.event);
+    uint32_t rows = 0;
+    esp_err_t err = ESP_OK;
+    while (!empty && history_store_reader_next(&reader, &rec)) {
+        if (sizeof(chunk) - len < (format == FORMAT_BIN ? rec_size : HISTORY_EXPORT_LINE)) {
+            err = httpd_resp_send_chunk(req, chunk, len);
+            len = 0;
+            if (err != ESP_OK) {
+                break;    // Client went away
+            }
+        }
+        if (format == FORMAT_CBOR) {
+            int n = rollups ? cbor_rollup((uint8_t *)chunk + len, sizeof(chunk) - len, &rec.rollup)
+                            : cbor_event((uint8_t *)chunk + len, sizeof(chunk) - len, &rec.event);
+            len += (size_t)n;
+        } else if (format == FORMAT_CSV) {
+            int n = rollups ? format_rollup(chunk + len, sizeof(chunk) - len, &rec.rollup)
+                            : format_event(chunk + len, sizeof(chunk) - len, &rec.event);
+            len += (n > 0 && (size_t)n < sizeof(chunk) - len) ? (size_t)n : 0;
+        } else {
+            memcpy(chunk + len, &rec, rec_size);
+            len += rec_size;
+        }
+        rows++;
+    }
+    history_store_reader_close(&reader);
+    if (format == FORMAT_CBOR && err == ESP_OK) {
+        chunk[len++] = (char)0xFF;    // Break (the flush above always leaves room)
+    }
+
+    if (err == ESP_OK && len > 0) {
+        err = httpd_resp_send_chunk(req, chunk, len);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "/history/%s aborted after %lu records", name, (unsigned long)rows);
+        return err;
+    }
+    ESP_LOGI(TAG, "/history/%s: %lu records (%s)", name, (unsigned long)rows, FORMAT_EXT[format]);
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// Local midnight starting a day number
+static time_t day_start(int32_t day)
+{
+    time_t t = (time_t)day * 86400;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    tm.tm_isdst = -1;
+    return mktime(&tm);
+}
+
+/**
+ * @brief GET /history/series: probe samples, decoded as they are streamed
+ */
+static esp_err_t series_get_handler(httpd_req_t *req)
+{
+    static param_series_reader_t reader;    // ~1 KB: handlers run one at a time
+    bool bin = false;
+    int32_t from = INT32_MIN, to = INT32_MAX;
+
+    char query[96];
+    char val[16];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+        if (httpd_query_key_value(query, "format", val, sizeof(val)) == ESP_OK) {
+            bin = strcmp(val, "bin") == 0;
+        }
+        if ((httpd_query_key_value(query, "from", val, sizeof(val)) == ESP_OK && !parse_day(val, &from)) ||
+            (httpd_query_key_value(query, "to", val, sizeof(val)) == ESP_OK && !parse_day(val, &to))) {
+            return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Dates are YYYY-MM-DD");
+        }
+    }
+
+    time_t t_from = from == INT32_MIN ? 0 : day_start(from);
+    time_t t_to = to == INT32_MAX ? (time_t)UINT32_MAX : day_start(to + 1) - 1;
+    esp_err_t err = param_series_reader_open(&reader, t_from, t_to);
+    if (err == ESP_ERR_INVALID_STATE) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        return httpd_resp_sendstr(req, "No sensor series on this device");
+    }
+    bool empty = (err != ESP_OK);
+
+    httpd_resp_set_type(req, FORMAT_TYPE[bin ? FORMAT_BIN : FORMAT_CSV]);
+    httpd_resp_set_hdr(req, "Content-Disposition",
+                       bin ? "attachment; filename=\"series.bin\"" : "attachment; filename=\"series.csv\"");
+
+    size_t len = bin ? 0 : (size_t)snprintf(chunk, sizeof(chunk), "DateTime,Ammonia_ppm,Nitrite_ppm,Nitrate_ppm,pH\n");
+    param_series_sample_t s;
+    uint32_t rows = 0;
+    err = ESP_OK;
+    while (!empty && param_series_reader_next(&reader, &s)) {
+        if (sizeof(chunk) - len < HISTORY_EXPORT_LINE) {
+            err = httpd_resp_send_chunk(req, chunk, len);
+            len = 0;
+            if (err != ESP_OK) {
+                break;    // Client went away
+            }
+        }
+        if (bin) {
+            memcpy(chunk + len, &s, sizeof(s));
+            len += sizeof(s);
+        } else {
+            time_t t = (time_t)s.t;
+            struct tm tm;
+            localtime_r(&t, &tm);
+            len += strftime(chunk + len, sizeof(chunk) - len, "%Y-%m-%d %H:%M:%S", &tm);
+            for (int p = 0; p < PARAM_SERIES_VALUES; p++) {
+                int n = !isnan(s.value[p])
+                      ? snprintf(chunk + len, sizeof(chunk) - len, ",%.3f", s.value[p])
+                      : snprintf(chunk + len, sizeof(chunk) - len, ",");    // NAN: no probe
+                len += (n > 0 && (size_t)n < sizeof(chunk) - len) ? (size_t)n : 0;
+            }
+            chunk[len++] = '\n';
+        }
+        rows++;
+    }
+    param_series_reader_close(&reader);
+
+    if (err == ESP_OK && len > 0) {
+        err = httpd_resp_send_chunk(req, chunk, len);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "/history/series aborted after %lu samples", (unsigned long)rows);
+        return err;
+    }
+    ESP_LOGI(TAG, "/history/series: %lu samples (%s)", (unsigned long)rows, bin ? "bin" : "csv");
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+bool history_export_start(void)
+{
+    if (registered) {
+        return true;
+    }
+    httpd_handle_t server = web_server_start();
+    if (server == NULL) {
+        return false;
+    }
+
+    const httpd_uri_t events_uri = {
+        .uri = "/history/events", .method = HTTP_GET, .handler = history_get_handler, .user_ctx = NULL,
+    };
+    const httpd_uri_t daily_uri = {
+        .uri = "/history/daily", .method = HTTP_GET, .handler = history_get_handler, .user_ctx = (void *)1,
+    };
+    const httpd_uri_t series_uri = {
+        .uri = "/history/series", .method = HTTP_GET, .handler = series_get_handler, .user_ctx = NULL,
+    };
+    httpd_register_uri_handler(server, &events_uri);
+    httpd_register_uri_handler(server, &daily_uri);
+    httpd_register_uri_handler(server, &series_uri);
+    registered = true;
+
+    ESP_LOGI(TAG, "History export: /history/events, /history/daily, /history/series");
+    return true;
+}
@@ -0,0 +1,35 @@
+#ifndef HISTORY_EXPORT_H
+#define HISTORY_EXPORT_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// History export over HTTP (web_server.h, port 80)
+//
+//   GET /history/events   every feed / water / parameter / mood event
+//   GET /history/daily    one rollup per day older than the raw window
+//   GET /history/series   probe samples (history/param_series.h), csv or
+//                         bin (param_series_sample_t), decoded as streamed
+//
+// Query: format=csv (default), bin (the records as stored, see
+// history/history_store.h) or cbor (an indefinite array of one array per
+// record, device_api.h), from=YYYY-MM-DD, to=YYYY-MM-DD (inclusive).
+// The range is first clipped to the days the history index has activity
+// for; the file is then read from the first record of that day and sent
+// as chunked transfer through one fixed HISTORY_EXPORT_CHUNK buffer, so
+// months of data cost no heap and the LVGL task only for the index lookup.
+// No authentication - trusted networks only.
+
+#define HISTORY_EXPORT_CHUNK  1024
+
+// Start the server (call after WiFi is connected; safe to call again)
+bool history_export_start(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HISTORY_EXPORT_H
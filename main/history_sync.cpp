@@ -0,0 +1,370 @@
+#include "history_sync.h"
+#include "history/param_series.h"
+#include "cbor_lite.h"
+#include "http_pool.h"
+#include "miniz.h"
+#include "esp_heap_caps.h"
+#include "esp_mac.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char *TAG = "history_sync";
+
+#define HISTORY_SYNC_NVS_CURSOR  "cursor"   // u32: last sample the backend holds
+#define HISTORY_SYNC_NVS_BATCH   "batch"    // blob: batch_state_t of the open batch
+
+// CBOR bytes of one sample: array head, dt (up to uint32), four float32
+#define HISTORY_SYNC_SAMPLE_MAX  (1 + 5 + PARAM_SERIES_VALUES * 5)
+#define HISTORY_SYNC_RAW_MAX     (64 + HISTORY_SYNC_BATCH * HISTORY_SYNC_SAMPLE_MAX)
+#define HISTORY_SYNC_OUT_MAX     (HISTORY_SYNC_RAW_MAX + HISTORY_SYNC_RAW_MAX / 64 + 64)
+#define HISTORY_SYNC_PROBES      32         // Deflate match probes: fast, still ~level 4
+#define HISTORY_SYNC_REPLY_MAX   24
+
+typedef struct {
+    uint32_t from;             // First sample of the batch
+    uint32_t to;               // Last sample
+    uint32_t total;            // Compressed bytes
+    uint32_t acked;            // Bytes the backend holds
+} batch_state_t;
+
+static uint32_t cursor = 0;
+static batch_state_t batch = {};
+static bool batch_open = false;            // `batch` is valid (it may not be built yet)
+static uint8_t *batch_buf = NULL;          // Compressed batch, PSRAM
+static uint32_t batch_samples = 0;
+
+static http_pool_host_t *sync_host = NULL;
+static char dev_id[13];
+static char reply[HISTORY_SYNC_REPLY_MAX];
+static size_t reply_len = 0;
+
+static uint32_t stat_batches = 0;
+static uint32_t stat_samples = 0;
+static uint64_t stat_raw_bytes = 0;
+static uint64_t stat_sent_bytes = 0;
+static uint32_t stat_failures = 0;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// STATE (NVS)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void state_store(bool with_cursor)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(HISTORY_SYNC_NVS_NS, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        if (with_cursor) {
+            err = nvs_set_u32(nvs, HISTORY_SYNC_NVS_CURSOR, cursor);
+        }
+        if (err == ESP_OK) {
+            err = batch_open ? nvs_set_blob(nvs, HISTORY_SYNC_NVS_BATCH, &batch, sizeof(batch))
+                             : nvs_erase_key(nvs, HISTORY_SYNC_NVS_BATCH);
+            if (err == ESP_ERR_NVS_NOT_FOUND) {
+                err = ESP_OK;
+            }
+        }
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Sync state not saved: %s", esp_err_to_name(err));
+    }
+}
+
+void history_sync_init(void)
+{
+    uint8_t mac[6] = {};
+    esp_read_mac(mac, ESP_MAC_WIFI_STA);
+    snprintf(dev_id, sizeof(dev_id), "%02x%02x%02x%02x%02x%02x", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+
+    nvs_handle_t nvs;
+    if (nvs_open(HISTORY_SYNC_NVS_NS, NVS_READONLY, &nvs) == ESP_OK) {
+        nvs_get_u32(nvs, HISTORY_SYNC_NVS_CURSOR, &cursor);
+        size_t len = sizeof(batch);
+        batch_open = nvs_get_blob(nvs, HISTORY_SYNC_NVS_BATCH, &batch, &len) == ESP_OK && len == sizeof(batch) &&
+                     batch.from > cursor && batch.to >= batch.from && batch.acked <= batch.total;
+        nvs_close(nvs);
+    }
+    if (strlen(CONFIG_GOLDIE_HISTORY_SYNC_URL) == 0) {
+        ESP_LOGW(TAG, "No backend URL (CONFIG_GOLDIE_HISTORY_SYNC_URL) - sync off");
+    } else if (batch_open) {
+        ESP_LOGI(TAG, "Resuming batch %lu-%lu at %lu/%lu bytes", (unsigned long)batch.from,
+                 (unsigned long)batch.to, (unsigned long)batch.acked, (unsigned long)batch.total);
+    } else {
+        ESP_LOGI(TAG, "Synced up to %lu", (unsigned long)cursor);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// BATCH (SERIES -> CBOR -> DEFLATE)
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * @brief Encode the samples from..to, at most HISTORY_SYNC_BATCH
+ * @param first, last Set to the times of the first and last samples encoded
+ * @return Samples encoded, 0 if none (or the series is off)
+ */
+static uint32_t batch_encode(cbor_writer_t *w, uint32_t from, uint32_t to, uint32_t *first, uint32_t *last)
+{
+    static param_series_reader_t reader;    // ~1 KB, telemetry worker only
+    if (param_series_reader_open(&reader, (time_t)from, (time_t)to) != ESP_OK) {
+        return 0;
+    }
+    uint32_t n = 0;
+    uint32_t prev = 0;
+    param_series_sample_t s;
+    while (n < HISTORY_SYNC_BATCH && param_series_reader_next(&reader, &s)) {
+        if (n == 0) {
+            cbor_put_map(w, 4);
+            cbor_put_text(w, "v");
+            cbor_put_uint(w, 1);
+            cbor_put_text(w, "dev");
+            cbor_put_text(w, dev_id);
+            cbor_put_text(w, "t0");
+            cbor_put_uint(w, s.t);
+            cbor_put_text(w, "s");
+            cbor_put_array_open(w);
+            *first = s.t;
+            prev = s.t;
+        }
+        cbor_put_array(w, 1 + PARAM_SERIES_VALUES);
+        cbor_put_uint(w, s.t - prev);
+        for (int v = 0; v < PARAM_SERIES_VALUES; v++) {
+            cbor_put_float(w, s.value[v]);
+        }
+        prev = s.t;
+        n++;
+    }
+    param_series_reader_close(&reader);
+    if (n > 0) {
+        cbor_put_break(w);
+    }
+    *last = prev;
+    return w->overflow ? 0 : n;
+}
+
+/**
+ * @brief Deflate `len` bytes of raw CBOR into batch_buf
+ * @return Compressed size, 0 on failure
+ */
+static size_t batch_deflate(const uint8_t *raw, size_t len)
+{
+    // ~300 KB of match state, only for the few ms of a compression
+    tdefl_compressor *comp = (tdefl_compressor *)heap_caps_malloc(sizeof(tdefl_compressor), MALLOC_CAP_SPIRAM);
+    if (comp == NULL) {
+        ESP_LOGE(TAG, "No PSRAM for the compressor");
+        return 0;
+    }
+    size_t out_len = HISTORY_SYNC_OUT_MAX;
+    size_t in_len = len;
+    tdefl_status status = tdefl_init(comp, NULL, NULL, TDEFL_WRITE_ZLIB_HEADER | HISTORY_SYNC_PROBES);
+    if (status == TDEFL_STATUS_OKAY) {
+        status = tdefl_compress(comp, raw, &in_len, batch_buf, &out_len, TDEFL_FINISH);
+    }
+    heap_caps_free(comp);
+    if (status != TDEFL_STATUS_DONE || in_len != len) {
+        ESP_LOGE(TAG, "Deflate failed (%d)", (int)status);
+        return 0;
+    }
+    return out_len;
+}
+
+static void batch_free(void)
+{
+    heap_caps_free(batch_buf);
+    batch_buf = NULL;
+}
+
+/**
+ * @brief Build the open batch again (after a reboot) or the next one after
+ *        the cursor
+ * @return false if there is nothing to send (or no memory)
+ */
+static bool batch_build(void)
+{
+    uint8_t *raw = (uint8_t *)heap_caps_malloc(HISTORY_SYNC_RAW_MAX, MALLOC_CAP_SPIRAM);
+    batch_buf = (uint8_t *)heap_caps_malloc(HISTORY_SYNC_OUT_MAX, MALLOC_CAP_SPIRAM);
+    if (raw == NULL || batch_buf == NULL) {
+        ESP_LOGE(TAG, "No PSRAM for a batch");
+        heap_caps_free(raw);
+        batch_free();
+        return false;
+    }
+
+    cbor_writer_t w;
+    cbor_writer_init(&w, raw, HISTORY_SYNC_RAW_MAX);
+    uint32_t first = 0, last = 0;
+    size_t total = 0;
+    if (batch_open) {
+        // Same samples, same bytes: the series only grows after batch.to
+        batch_samples = batch_encode(&w, batch.from, batch.to, &first, &last);
+        total = batch_samples > 0 && first == batch.from && last == batch.to ? batch_deflate(raw, w.len) : 0;
+        if (total != batch.total) {
+            ESP_LOGW(TAG, "Batch %lu-%lu does not rebuild the same (%u of %lu bytes) - starting over",
+                     (unsigned long)batch.from, (unsigned long)batch.to, (unsigned)total,
+                     (unsigned long)batch.total);
+            batch_open = false;
+            state_store(false);
+            cbor_writer_init(&w, raw, HISTORY_SYNC_RAW_MAX);
+        }
+    }
+    if (!batch_open) {
+        uint32_t now = (uint32_t)time(NULL);
+        batch_samples = cursor < now ? batch_encode(&w, cursor + 1, now, &first, &last) : 0;
+        total = batch_samples > 0 ? batch_deflate(raw, w.len) : 0;
+        if (total > 0) {
+            batch.from = first;
+            batch.to = last;
+            batch.total = (uint32_t)total;
+            batch.acked = 0;
+            batch_open = true;
+            state_store(false);
+        }
+    }
+    if (total > 0) {
+        ESP_LOGI(TAG, "Batch %lu-%lu: %lu samples, %u bytes CBOR -> %lu deflated", (unsigned long)batch.from,
+                 (unsigned long)batch.to, (unsigned long)batch_samples, (unsigned)w.len,
+                 (unsigned long)batch.total);
+        stat_raw_bytes += w.len;
+    }
+    heap_caps_free(raw);
+    if (total == 0) {
+        batch_free();
+        return false;
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// UPLOAD (CHUNKS OVER THE HTTP POOL)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static esp_err_t http_event_handler(esp_http_client_event_t *evt)
+{
+    if (evt->event_id == HTTP_EVENT_ON_DATA && reply_len < sizeof(reply) - 1) {
+        size_t n = sizeof(reply) - 1 - reply_len;
+        if (n > (size_t)evt->data_len) {
+            n = evt->data_len;
+        }
+        memcpy(reply + reply_len, evt->data, n);
+        reply_len += n;
+        reply[reply_len] = '\0';
+    }
+    return ESP_OK;
+}
+
+static void chunk_attempt(void *arg)
+{
+    reply_len = 0;
+    reply[0] = '\0';
+}
+
+/**
+ * @brief POST the chunk at batch.acked
+ * @return Bytes the backend holds after it, -1 on failure
+ */
+static int64_t chunk_send(void)
+{
+    uint32_t len = batch.total - batch.acked;
+    if (len > HISTORY_SYNC_CHUNK) {
+        len = HISTORY_SYNC_CHUNK;
+    }
+    char url[256];
+    const char *base = CONFIG_GOLDIE_HISTORY_SYNC_URL;
+    snprintf(url, sizeof(url), "%s%cdev=%s&batch=%lu-%lu&offset=%lu&total=%lu", base,
+             strchr(base, '?') ? '&' : '?', dev_id, (unsigned long)batch.from, (unsigned long)batch.to,
+             (unsigned long)batch.acked, (unsigned long)batch.total);
+
+    bool fresh;
+    http_pool_conn_t *conn = http_pool_acquire(sync_host, url, HTTP_METHOD_POST, http_event_handler, &fresh);
+    if (conn == NULL) {
+        return -1;
+    }
+    esp_http_client_handle_t client = http_pool_client(conn);
+    if (fresh && strlen(CONFIG_GOLDIE_HISTORY_SYNC_TOKEN) > 0) {
+        char auth[160];
+        snprintf(auth, sizeof(auth), "Bearer %s", CONFIG_GOLDIE_HISTORY_SYNC_TOKEN);
+        esp_http_client_set_header(client, "Authorization", auth);
+    }
+    esp_http_client_set_header(client, "Content-Type", "application/octet-stream");
+    esp_http_client_set_post_field(client, (const char *)batch_buf + batch.acked, (int)len);
+    int status = 0;
+    esp_err_t err = http_pool_perform(conn, chunk_attempt, &status);
+    http_pool_release(conn);
+
+    char *end = NULL;
+    unsigned long held = strtoul(reply, &end, 10);
+    if (err != ESP_OK || (status != 200 && status != 409) || end == reply || held > batch.total) {
+        ESP_LOGW(TAG, "Chunk %lu+%lu of batch %lu-%lu failed (status: %d, %s, reply \"%s\")",
+                 (unsigned long)batch.acked, (unsigned long)len, (unsigned long)batch.from,
+                 (unsigned long)batch.to, status, esp_err_to_name(err), reply);
+        return -1;
+    }
+    if (status == 409) {
+        ESP_LOGI(TAG, "Backend holds %lu of batch %lu-%lu - resuming there", held,
+                 (unsigned long)batch.from, (unsigned long)batch.to);
+    } else {
+        stat_sent_bytes += len;
+    }
+    return (int64_t)held;
+}
+
+history_sync_result_t history_sync_step(void)
+{
+    if (strlen(CONFIG_GOLDIE_HISTORY_SYNC_URL) == 0) {
+        return HISTORY_SYNC_IDLE;
+    }
+    if (sync_host == NULL) {
+        sync_host = http_pool_host("hsync", HISTORY_SYNC_TIMEOUT_MS);
+        if (sync_host == NULL) {
+            return HISTORY_SYNC_FAILED;
+        }
+    }
+    if (batch_buf == NULL && !batch_build()) {
+        return HISTORY_SYNC_IDLE;
+    }
+
+    for (int i = 0; i < HISTORY_SYNC_STEP_CHUNKS; i++) {
+        int64_t held = chunk_send();
+        if (held < 0) {
+            stat_failures++;
+            return HISTORY_SYNC_FAILED;
+        }
+        batch.acked = (uint32_t)held;
+        if (batch.acked < batch.total) {
+            state_store(false);
+            continue;
+        }
+
+        cursor = batch.to;
+        batch_open = false;
+        state_store(true);
+        batch_free();
+        stat_batches++;
+        stat_samples += batch_samples;
+        ESP_LOGI(TAG, "Batch of %lu samples stored, synced up to %lu", (unsigned long)batch_samples,
+                 (unsigned long)cursor);
+        return HISTORY_SYNC_MORE;    // The next batch, or nothing left
+    }
+    return HISTORY_SYNC_MORE;
+}
+
+void history_sync_log_stats(void)
+{
+    if (batch_open) {
+        ESP_LOGI(TAG, "Cursor %lu, batch %lu-%lu at %lu/%lu bytes", (unsigned long)cursor,
+                 (unsigned long)batch.from, (unsigned long)batch.to, (unsigned long)batch.acked,
+                 (unsigned long)batch.total);
+    } else {
+        ESP_LOGI(TAG, "Cursor %lu, no batch open", (unsigned long)cursor);
+    }
+    ESP_LOGI(TAG, "Since boot: %lu batches, %lu samples, %llu bytes CBOR, %llu sent, %lu failed chunks",
+             (unsigned long)stat_batches, (unsigned long)stat_samples, (unsigned long long)stat_raw_bytes,
+             (unsigned long long)stat_sent_bytes, (unsigned long)stat_failures);
+}
@@ -0,0 +1,98 @@
+#ifndef HISTORY_SYNC_H
+#define HISTORY_SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// History sync - the probe series (history/param_series.h) to a backend
+//
+// Blynk only sees snapshots; this ships every recorded sample to
+// CONFIG_GOLDIE_HISTORY_SYNC_URL, from the last sample the backend
+// acknowledged (the cursor, NVS) up to now.
+//
+// A batch is up to HISTORY_SYNC_BATCH samples after the cursor, encoded as
+// CBOR and compressed into one zlib stream (ROM miniz deflate):
+//
+//   { "v": 1, "dev": "<station MAC, 12 hex digits>", "t0": <first sample,
+//     Unix s>, "s": [ [dt, ammonia, nitrite, nitrate, pH], ... ] }
+//
+// dt is seconds since the previous sample (0 for the first), the values
+// float32, NaN for a parameter without a probe. It goes out in chunks of
+// CONFIG_GOLDIE_HISTORY_SYNC_CHUNK_KB:
+//
+//   POST <url>?dev=<id>&batch=<t0>-<t_last>&offset=<o>&total=<bytes>
+//   Content-Type: application/octet-stream (a slice of the zlib stream)
+//   Authorization: Bearer <CONFIG_GOLDIE_HISTORY_SYNC_TOKEN> (if set)
+//
+// The backend keys a partial batch by dev, batch and total. It appends the
+// chunk if `offset` is what it holds and answers 200, or 409 if not; either
+// way the body is the byte count it holds, and the next chunk starts there.
+// Once it holds `total` it inflates and stores the batch, and the cursor
+// moves to t_last.
+//
+// Resumable: the batch bounds and the acknowledged offset are kept in NVS
+// after every chunk. A batch interrupted by a closed window or a reboot is
+// rebuilt from the same samples (the series is append-only, the encoding
+// deterministic) and continues at its offset.
+//
+// history_sync_step() runs on the telemetry worker inside net_sched
+// windows, at most HISTORY_SYNC_STEP_CHUNKS chunks per call, so a backlog
+// of several days drains in a few windows without holding the radio for
+// long. Buffers are PSRAM, allocated while a batch is open.
+
+#ifndef CONFIG_GOLDIE_HISTORY_SYNC
+#define CONFIG_GOLDIE_HISTORY_SYNC 0
+#endif
+#ifndef CONFIG_GOLDIE_HISTORY_SYNC_URL
+#define CONFIG_GOLDIE_HISTORY_SYNC_URL ""
+#endif
+#ifndef CONFIG_GOLDIE_HISTORY_SYNC_TOKEN
+#define CONFIG_GOLDIE_HISTORY_SYNC_TOKEN ""
+#endif
+#ifndef CONFIG_GOLDIE_HISTORY_SYNC_CHUNK_KB
+#define CONFIG_GOLDIE_HISTORY_SYNC_CHUNK_KB 4
+#endif
+#ifndef CONFIG_GOLDIE_HISTORY_SYNC_INTERVAL_MIN
+#define CONFIG_GOLDIE_HISTORY_SYNC_INTERVAL_MIN 30
+#endif
+
+#define HISTORY_SYNC_BATCH        1440     // Samples per batch: a day at the default period
+#define HISTORY_SYNC_CHUNK        (CONFIG_GOLDIE_HISTORY_SYNC_CHUNK_KB * 1024)
+#define HISTORY_SYNC_STEP_CHUNKS  4
+#define HISTORY_SYNC_TIMEOUT_MS   10000
+#define HISTORY_SYNC_RETRY_S      300      // After a failed chunk
+#define HISTORY_SYNC_INTERVAL_S   (CONFIG_GOLDIE_HISTORY_SYNC_INTERVAL_MIN * 60)
+#define HISTORY_SYNC_NVS_NS       "goldie_hsync"
+
+typedef enum {
+    HISTORY_SYNC_IDLE = 0,     // Up to date: come back after HISTORY_SYNC_INTERVAL_S
+    HISTORY_SYNC_MORE,         // Chunks or batches left: call again in the next pass
+    HISTORY_SYNC_FAILED,       // Backend unreachable or refused: HISTORY_SYNC_RETRY_S
+} history_sync_result_t;
+
+/**
+ * @brief Load the cursor and any interrupted batch from NVS
+ */
+void history_sync_init(void);
+
+/**
+ * @brief Send up to HISTORY_SYNC_STEP_CHUNKS chunks (telemetry worker,
+ *        network up, inside a window)
+ */
+history_sync_result_t history_sync_step(void);
+
+/**
+ * @brief Log the cursor, the open batch and the totals sent
+ */
+void history_sync_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HISTORY_SYNC_H
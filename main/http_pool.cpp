@@ -0,0 +1,482 @@
+#include "http_pool.h"
+#include "esp_log.h"
+#include "esp_crt_bundle.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "lwip/netdb.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "http_pool";
+
+#define HTTP_POOL_LATENCY_ALPHA  0.2f
+
+static const char *const phase_names[HTTP_POOL_PHASE_COUNT] = { "dns", "connect", "ttfb", "body" };
+
+struct http_pool_conn {
+    http_pool_host_t *host;
+    esp_http_client_handle_t client;
+    bool busy;
+    bool connected;             // A request succeeded on the open connection
+    volatile bool drop;         // WiFi dropped - the socket is dead
+    int64_t last_us;
+    http_event_handle_cb handler;
+    void *user_data;
+    uint32_t rx;                // Bytes of the current attempt
+    char hostname[HTTP_POOL_HOSTNAME_MAX];
+
+    // Phase marks of the current attempt (event handler, 0 = not seen)
+    int64_t connected_us;
+    int64_t first_byte_us;
+};
+
+typedef struct {
+    uint16_t ms[HTTP_POOL_PHASE_SAMPLES];
+    uint8_t next;
+    uint8_t count;
+} phase_ring_t;
+
+struct http_pool_host {
+    const char *name;
+    int timeout_ms;
+    http_pool_conn_t conns[HTTP_POOL_CONNS];
+
+    // Backoff
+    uint32_t fails;             // Transport failures in a row
+    int64_t backoff_until_us;
+
+    // Metrics
+    uint32_t requests;
+    uint32_t failures;
+    uint32_t retries;           // Stale kept-alive connection, sent again
+    uint32_t handshakes;        // New connections
+    uint32_t skipped;           // Refused during backoff or all busy
+    uint64_t bytes_tx;
+    uint64_t bytes_rx;
+    float latency_ms;           // EWMA of successful requests, 0 = not measured
+
+    // Phase timings of the last successful requests
+    phase_ring_t phases[HTTP_POOL_PHASE_COUNT];
+    metric_t *m_p50[HTTP_POOL_PHASE_COUNT];
+    metric_t *m_p90[HTTP_POOL_PHASE_COUNT];
+};
+
+static http_pool_host_t hosts[HTTP_POOL_HOSTS];
+static size_t host_count = 0;
+static portMUX_TYPE pool_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Count the reply bytes, then hand the event to the caller's handler
+ */
+static esp_err_t pool_event_handler(esp_http_client_event_t *evt)
+{
+    http_pool_conn_t *c = (http_pool_conn_t *)evt->user_data;
+    if (c == NULL) {
+        return ESP_OK;
+    }
+    switch (evt->event_id) {
+    case HTTP_EVENT_ON_CONNECTED:
+        c->connected_us = esp_timer_get_time();
+        break;
+    case HTTP_EVENT_ON_HEADER:
+    case HTTP_EVENT_ON_DATA:
+        if (c->first_byte_us == 0) {
+            c->first_byte_us = esp_timer_get_time();
+        }
+        if (evt->event_id == HTTP_EVENT_ON_DATA) {
+            c->rx += (uint32_t)evt->data_len;
+        }
+        break;
+    default:
+        break;
+    }
+    if (c->handler == NULL) {
+        return ESP_OK;
+    }
+    evt->user_data = c->user_data;
+    esp_err_t err = c->handler(evt);
+    evt->user_data = c;
+    return err;
+}
+
+/**
+ * @brief Host part of an http(s) URL
+ */
+static void url_hostname(const char *url, char *out, size_t len)
+{
+    const char *p = strstr(url, "://");
+    p = p ? p + 3 : url;
+    size_t n = strcspn(p, ":/?#");
+    if (n >= len) {
+        n = len - 1;
+    }
+    memcpy(out, p, n);
+    out[n] = '\0';
+}
+
+/**
+ * @brief Resolve the host before esp-tls does, so the lookup is timed on
+ *        its own (esp-tls then hits lwIP's DNS cache)
+ * @return Lookup time, -1 if it failed (the connect will fail and say why)
+ */
+static int64_t resolve_us(const char *hostname)
+{
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *res = NULL;
+    int64_t t0 = esp_timer_get_time();
+    int err = getaddrinfo(hostname, NULL, &hints, &res);
+    int64_t dt = esp_timer_get_time() - t0;
+    if (res != NULL) {
+        freeaddrinfo(res);
+    }
+    return err == 0 ? dt : -1;
+}
+
+static void phase_put(phase_ring_t *r, int64_t us)
+{
+    int64_t ms = us < 0 ? 0 : us / 1000;
+    r->ms[r->next] = (uint16_t)(ms > UINT16_MAX ? UINT16_MAX : ms);
+    r->next = (uint8_t)((r->next + 1) % HTTP_POOL_PHASE_SAMPLES);
+    if (r->count < HTTP_POOL_PHASE_SAMPLES) {
+        r->count++;
+    }
+}
+
+/**
+ * @brief p50 / p90 / p99 of a ring copy (sorts it); false if empty
+ */
+static bool phase_percentiles(phase_ring_t *r, uint16_t pct[3])
+{
+    if (r->count == 0) {
+        return false;
+    }
+    for (int i = 1; i < r->count; i++) {
+        uint16_t v = r->ms[i];
+        int k = i - 1;
+        for (; k >= 0 && r->ms[k] > v; k--) {
+            r->ms[k + 1] = r->ms[k];
+        }
+        r->ms[k + 1] = v;
+    }
+    static const uint8_t q[3] = { 50, 90, 99 };
+    for (int i = 0; i < 3; i++) {
+        pct[i] = r->ms[(r->count - 1) * q[i] / 100];
+    }
+    return true;
+}
+
+static void phase_snapshot(const http_pool_host_t *h, phase_ring_t out[HTTP_POOL_PHASE_COUNT])
+{
+    portENTER_CRITICAL(&pool_lock);
+    memcpy(out, h->phases, sizeof(h->phases));
+    portEXIT_CRITICAL(&pool_lock);
+}
+
+static void phase_metrics_update(http_pool_host_t *h)
+{
+    phase_ring_t rings[HTTP_POOL_PHASE_COUNT];
+    phase_snapshot(h, rings);
+    for (int p = 0; p < HTTP_POOL_PHASE_COUNT; p++) {
+        uint16_t pct[3];
+        if (phase_percentiles(&rings[p], pct)) {
+            metrics_set(h->m_p50[p], pct[0]);
+            metrics_set(h->m_p90[p], pct[1]);
+        }
+    }
+}
+
+static void conn_close(http_pool_conn_t *c, bool destroy)
+{
+    if (c->client == NULL) {
+        return;
+    }
+    if (destroy) {
+        esp_http_client_cleanup(c->client);
+        c->client = NULL;
+    } else {
+        esp_http_client_close(c->client);
+    }
+    c->connected = false;
+}
+
+extern "C" http_pool_host_t *http_pool_host(const char *name, int timeout_ms)
+{
+    http_pool_host_t *h = NULL;
+    portENTER_CRITICAL(&pool_lock);
+    for (size_t i = 0; i < host_count; i++) {
+        if (strcmp(hosts[i].name, name) == 0) {
+            h = &hosts[i];
+            break;
+        }
+    }
+    if (h == NULL && host_count < HTTP_POOL_HOSTS) {
+        h = &hosts[host_count++];
+        h->name = name;
+        h->timeout_ms = timeout_ms;
+        for (int i = 0; i < HTTP_POOL_CONNS; i++) {
+            h->conns[i].host = h;
+        }
+    }
+    bool added = h != NULL && h->m_p50[0] == NULL;
+    portEXIT_CRITICAL(&pool_lock);
+    if (h == NULL) {
+        ESP_LOGE(TAG, "No room for host %s (HTTP_POOL_HOSTS=%d)", name, HTTP_POOL_HOSTS);
+    } else if (added) {
+        for (int p = 0; p < HTTP_POOL_PHASE_COUNT; p++) {
+            char labels[METRICS_LABELS_MAX];
+            snprintf(labels, sizeof(labels), "host=\"%s\",phase=\"%s\"", name, phase_names[p]);
+            h->m_p50[p] = metrics_gauge("goldie_http_phase_p50_ms", labels,
+                                        "Median HTTP request phase time, last requests (ms)");
+            h->m_p90[p] = metrics_gauge("goldie_http_phase_p90_ms", labels,
+                                        "90th percentile HTTP request phase time, last requests (ms)");
+        }
+    }
+    return h;
+}
+
+extern "C" http_pool_conn_t *http_pool_acquire(http_pool_host_t *host, const char *url,
+                                               esp_http_client_method_t method,
+                                               http_event_handle_cb handler, bool *fresh)
+{
+    *fresh = false;
+    if (host == NULL) {
+        return NULL;
+    }
+
+    // A connected handle first, then any handle, then an empty slot
+    http_pool_conn_t *c = NULL;
+    bool backing_off;
+    portENTER_CRITICAL(&pool_lock);
+    backing_off = esp_timer_get_time() < host->backoff_until_us;
+    for (int pass = 0; pass < 3 && c == NULL && !backing_off; pass++) {
+        for (int i = 0; i < HTTP_POOL_CONNS; i++) {
+            http_pool_conn_t *k = &host->conns[i];
+            if (!k->busy && (pass == 2 || (k->client != NULL && (pass == 1 || k->connected)))) {
+                c = k;
+                break;
+            }
+        }
+    }
+    if (c != NULL) {
+        c->busy = true;
+    } else {
+        host->skipped++;
+    }
+    portEXIT_CRITICAL(&pool_lock);
+    if (c == NULL) {
+        ESP_LOGD(TAG, "%s: %s", host->name, backing_off ? "backing off" : "all connections busy");
+        return NULL;
+    }
+
+    if (c->drop) {
+        c->drop = false;
+        conn_close(c, false);
+    }
+    if (c->client != NULL && c->connected &&
+        esp_timer_get_time() - c->last_us > (int64_t)HTTP_POOL_IDLE_CLOSE_S * 1000000) {
+        ESP_LOGD(TAG, "%s connection idle for >%ds - reconnecting", host->name, HTTP_POOL_IDLE_CLOSE_S);
+        conn_close(c, false);
+    }
+
+    if (c->client == NULL) {
+        esp_http_client_config_t config = {};
+        config.url = url;
+        config.method = method;
+        config.event_handler = pool_event_handler;
+        config.user_data = c;
+        config.timeout_ms = host->timeout_ms;
+        if (strncmp(url, "https:", 6) == 0) {
+            config.crt_bundle_attach = esp_crt_bundle_attach;
+        }
+        config.keep_alive_enable = true;       // TCP keep-alive notices a dead peer
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+        config.save_client_session = true;     // Resume TLS after a reconnect
+#endif
+        c->client = esp_http_client_init(&config);
+        if (c->client == NULL) {
+            ESP_LOGE(TAG, "Failed to create a %s HTTP client", host->name);
+            http_pool_release(c);
+            return NULL;
+        }
+        *fresh = true;
+    } else {
+        esp_http_client_set_url(c->client, url);
+        esp_http_client_set_method(c->client, method);
+        char *post = NULL;
+        if (esp_http_client_get_post_field(c->client, &post) > 0) {
+            esp_http_client_set_post_field(c->client, NULL, 0);    // Also drops its Content-Type
+        }
+    }
+    url_hostname(url, c->hostname, sizeof(c->hostname));
+    c->handler = handler;
+    c->user_data = NULL;
+    return c;
+}
+
+extern "C" esp_http_client_handle_t http_pool_client(http_pool_conn_t *conn)
+{
+    return conn->client;
+}
+
+extern "C" void http_pool_set_user_data(http_pool_conn_t *conn, void *user_data)
+{
+    conn->user_data = user_data;
+}
+
+extern "C" esp_err_t http_pool_perform(http_pool_conn_t *conn, http_pool_attempt_cb_t on_attempt, int *status)
+{
+    http_pool_host_t *h = conn->host;
+    char *post = NULL;
+    int tx = esp_http_client_get_post_field(conn->client, &post);
+    *status = 0;
+
+    // A kept-alive connection the server has dropped fails here, so one
+    // retry goes out on a fresh connection
+    esp_err_t err = ESP_FAIL;
+    int64_t dt_us = 0;
+    int64_t phase_us[HTTP_POOL_PHASE_COUNT] = {};
+    uint32_t retried = 0, handshakes = 0;
+    for (int attempt = 0; attempt < 2 && err != ESP_OK; attempt++) {
+        bool reused = conn->connected;
+        handshakes += reused ? 0 : 1;
+        retried += attempt;
+        if (on_attempt != NULL) {
+            on_attempt(conn->user_data);
+        }
+        conn->rx = 0;
+        conn->connected_us = 0;
+        conn->first_byte_us = 0;
+        int64_t t0 = esp_timer_get_time();
+        int64_t dns_us = reused ? 0 : resolve_us(conn->hostname);
+        int64_t t_req = t0 + (dns_us > 0 ? dns_us : 0);
+        err = esp_http_client_perform(conn->client);
+        int64_t t_end = esp_timer_get_time();
+        dt_us = t_end - t0;
+
+        // A kept-alive connection sends at once; no ON_CONNECTED then
+        int64_t t_sent = conn->connected_us ? conn->connected_us : t_req;
+        int64_t t_first = conn->first_byte_us ? conn->first_byte_us : t_end;
+        phase_us[HTTP_POOL_PHASE_DNS] = reused ? -1 : dns_us;
+        phase_us[HTTP_POOL_PHASE_CONNECT] = conn->connected_us ? conn->connected_us - t_req : -1;
+        phase_us[HTTP_POOL_PHASE_TTFB] = t_first - t_sent;
+        phase_us[HTTP_POOL_PHASE_BODY] = t_end - t_first;
+
+        if (err == ESP_OK) {
+            conn->connected = true;
+            conn->last_us = esp_timer_get_time();
+            ESP_LOGD(TAG, "%s: %d ms (%s connection)", h->name, (int)(dt_us / 1000), reused ? "kept-alive" : "new");
+        } else {
+            ESP_LOGW(TAG, "%s request failed after %d ms on a %s connection: %s", h->name, (int)(dt_us / 1000),
+                     reused ? "kept-alive" : "new", esp_err_to_name(err));
+            conn_close(conn, false);
+            if (!reused) {
+                break;    // Already a fresh connection - the network is the problem
+            }
+        }
+    }
+    if (err != ESP_OK) {
+        conn_close(conn, true);    // Rebuilt on the next request
+    } else {
+        *status = esp_http_client_get_status_code(conn->client);
+    }
+
+    portENTER_CRITICAL(&pool_lock);
+    h->requests++;
+    h->retries += retried;
+    h->handshakes += handshakes;
+    h->bytes_tx += (uint64_t)(tx > 0 ? tx : 0) * (1 + retried);
+    h->bytes_rx += conn->rx;
+    if (err == ESP_OK) {
+        float ms = (float)dt_us / 1000.0f;
+        h->latency_ms = h->latency_ms > 0.0f ? h->latency_ms + HTTP_POOL_LATENCY_ALPHA * (ms - h->latency_ms) : ms;
+        h->fails = 0;
+        h->backoff_until_us = 0;
+        for (int p = 0; p < HTTP_POOL_PHASE_COUNT; p++) {
+            if (phase_us[p] >= 0) {    // dns / connect: new connections only
+                phase_put(&h->phases[p], phase_us[p]);
+            }
+        }
+    } else {
+        h->failures++;
+        h->fails++;
+        uint32_t shift = h->fails - 1 < 5 ? h->fails - 1 : 5;
+        int64_t ms = (int64_t)HTTP_POOL_BACKOFF_BASE_MS << shift;
+        if (ms > HTTP_POOL_BACKOFF_MAX_MS) {
+            ms = HTTP_POOL_BACKOFF_MAX_MS;
+        }
+        h->backoff_until_us = esp_timer_get_time() + ms * 1000;
+    }
+    portEXIT_CRITICAL(&pool_lock);
+    if (err == ESP_OK) {
+        phase_metrics_update(h);
+    }
+    return err;
+}
+
+extern "C" void http_pool_release(http_pool_conn_t *conn)
+{
+    conn->handler = NULL;
+    conn->user_data = NULL;
+    portENTER_CRITICAL(&pool_lock);
+    conn->busy = false;
+    portEXIT_CRITICAL(&pool_lock);
+}
+
+extern "C" void http_pool_drop_all(void)
+{
+    for (size_t i = 0; i < host_count; i++) {
+        for (int k = 0; k < HTTP_POOL_CONNS; k++) {
+            hosts[i].conns[k].drop = true;   // Each closes its socket before its next request
+        }
+    }
+}
+
+extern "C" void http_pool_log_stats(void)
+{
+    int64_t now = esp_timer_get_time();
+    for (size_t i = 0; i < host_count; i++) {
+        const http_pool_host_t *h = &hosts[i];
+        int open = 0;
+        for (int k = 0; k < HTTP_POOL_CONNS; k++) {
+            open += h->conns[k].connected ? 1 : 0;
+        }
+        ESP_LOGI(TAG, "%-6s req %lu  fail %lu  retry %lu  handshakes %lu  skipped %lu  "
+                 "tx %lu KB  rx %lu KB  latency %4.0f ms  open %d%s",
+                 h->name, (unsigned long)h->requests, (unsigned long)h->failures, (unsigned long)h->retries,
+                 (unsigned long)h->handshakes, (unsigned long)h->skipped,
+                 (unsigned long)(h->bytes_tx / 1024), (unsigned long)(h->bytes_rx / 1024),
+                 (double)h->latency_ms, open, now < h->backoff_until_us ? "  (backing off)" : "");
+    }
+    char buf[768];
+    http_pool_format_phases(buf, sizeof(buf));
+    for (char *line = strtok(buf, "\n"); line != NULL; line = strtok(NULL, "\n")) {
+        ESP_LOGI(TAG, "%s", line);
+    }
+}
+
+extern "C" size_t http_pool_format_phases(char *buf, size_t len)
+{
+    size_t used = 0;
+    buf[0] = '\0';
+    if (host_count == 0) {
+        return (size_t)snprintf(buf, len, "No requests yet\n");
+    }
+    for (size_t i = 0; i < host_count && used < len; i++) {
+        phase_ring_t rings[HTTP_POOL_PHASE_COUNT];
+        phase_snapshot(&hosts[i], rings);
+        used += snprintf(buf + used, len - used, "%s  (p50 / p90 / p99 ms, samples)\n", hosts[i].name);
+        for (int p = 0; p < HTTP_POOL_PHASE_COUNT && used < len; p++) {
+            uint16_t pct[3];
+            if (phase_percentiles(&rings[p], pct)) {
+                used += snprintf(buf + used, len - used, "  %-8s %5u %5u %5u  %u\n", phase_names[p],
+                                 (unsigned)pct[0], (unsigned)pct[1], (unsigned)pct[2], (unsigned)rings[p].count);
+            } else {
+                used += snprintf(buf + used, len - used, "  %-8s -\n", phase_names[p]);
+            }
+        }
+    }
+    return used < len ? used : len - 1;
+}
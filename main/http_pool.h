@@ -0,0 +1,145 @@
+#ifndef HTTP_POOL_H
+#define HTTP_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_http_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Shared HTTP client layer for the cloud integrations (AI providers, Blynk)
+//
+// Each host keeps up to HTTP_POOL_CONNS long-lived esp_http_client handles.
+// A handle, its headers and its TLS connection outlive a request, so only
+// the first one pays for the handshake (with CONFIG_ESP_TLS_CLIENT_SESSION_
+// TICKETS a reconnect resumes the TLS session). One policy for everyone:
+//
+//   - a connection idle longer than HTTP_POOL_IDLE_CLOSE_S is closed before
+//     the next request (servers drop theirs around 60 s)
+//   - a request that fails on a kept-alive connection is retried once on a
+//     fresh one; a handle that fails on a fresh one is rebuilt next time
+//   - transport failures in a row put the host in backoff (doubling from
+//     HTTP_POOL_BACKOFF_BASE_MS up to HTTP_POOL_BACKOFF_MAX_MS); a request
+//     during backoff fails at once without touching the radio. HTTP status
+//     codes are the caller's business (429, 5xx handling differs per API)
+//   - WiFi dropped (http_pool_drop_all): every connection reconnects
+//
+// Per host the pool counts requests, failures, retries, handshakes, bytes
+// sent / received and a latency EWMA; http_pool_log_stats() prints them.
+//
+// Each successful request is also split into phases, kept for the last
+// HTTP_POOL_PHASE_SAMPLES requests per host:
+//
+//   dns      name lookup (new connections only): the pool resolves the host
+//            itself just before connecting, and esp-tls then finds the
+//            address cached (dns_cache.h, else lwIP's own table)
+//   connect  TCP connect + TLS handshake, up to HTTP_EVENT_ON_CONNECTED (new
+//            connections only; esp-tls has no hook between the two)
+//   ttfb     request sent + server time, up to the first response header
+//   body     first header to the end of the response
+//
+// Their p50 / p90 are the gauges goldie_http_phase_p50_ms and _p90_ms
+// {host, phase} (metrics.h), updated after every request, and
+// http_pool_format_phases() writes them for the diagnostics tile.
+//
+//   bool fresh;
+//   http_pool_conn_t *c = http_pool_acquire(host, url, HTTP_METHOD_POST, handler, &fresh);
+//   if (c) {
+//       if (fresh) esp_http_client_set_header(http_pool_client(c), ...);
+//       esp_http_client_set_post_field(http_pool_client(c), body, len);
+//       err = http_pool_perform(c, NULL, &status);
+//       http_pool_release(c);
+//   }
+
+#define HTTP_POOL_HOSTS            6
+#define HTTP_POOL_CONNS            2        // Per host: a worker and a hedge / history upload
+#define HTTP_POOL_IDLE_CLOSE_S     45       // Under common HTTPS idle timeouts (60 s)
+#define HTTP_POOL_BACKOFF_BASE_MS  2000
+#define HTTP_POOL_BACKOFF_MAX_MS   60000
+#define HTTP_POOL_PHASE_SAMPLES    32       // Rolling window of the phase percentiles
+#define HTTP_POOL_HOSTNAME_MAX     64
+
+typedef enum {
+    HTTP_POOL_PHASE_DNS = 0,
+    HTTP_POOL_PHASE_CONNECT,
+    HTTP_POOL_PHASE_TTFB,
+    HTTP_POOL_PHASE_BODY,
+    HTTP_POOL_PHASE_COUNT
+} http_pool_phase_t;
+
+typedef struct http_pool_host http_pool_host_t;
+typedef struct http_pool_conn http_pool_conn_t;
+
+// Called before each attempt (a stale-connection retry runs it again)
+typedef void (*http_pool_attempt_cb_t)(void *user_data);
+
+/**
+ * @brief Host by name, registered on first use (any task)
+ * @param name Metrics label, also the key (static string)
+ * @param timeout_ms Socket timeout of this host's connections
+ * @return NULL if HTTP_POOL_HOSTS are taken
+ */
+http_pool_host_t *http_pool_host(const char *name, int timeout_ms);
+
+/**
+ * @brief Take an idle connection of the host (a connected one first)
+ *
+ * Sets url and method and clears a previous POST body (and with it the
+ * Content-Type header); other headers set on the handle stay. handler
+ * gets the events with the user data of http_pool_set_user_data() (not
+ * esp_http_client_set_user_data()).
+ * @param fresh Set true if the handle is new (set its headers now)
+ * @return NULL while the host backs off or all its connections are busy
+ */
+http_pool_conn_t *http_pool_acquire(http_pool_host_t *host, const char *url, esp_http_client_method_t method,
+                                    http_event_handle_cb handler, bool *fresh);
+
+/**
+ * @brief The esp_http_client handle of an acquired connection
+ */
+esp_http_client_handle_t http_pool_client(http_pool_conn_t *conn);
+
+/**
+ * @brief User data the event handler and the attempt callback receive
+ */
+void http_pool_set_user_data(http_pool_conn_t *conn, void *user_data);
+
+/**
+ * @brief Perform the request with the pool's retry and backoff policy
+ * @param on_attempt Optional, reset per-attempt state (reply scanners)
+ * @param status HTTP status, 0 if no response
+ * @return ESP_OK if a response arrived (whatever its status)
+ */
+esp_err_t http_pool_perform(http_pool_conn_t *conn, http_pool_attempt_cb_t on_attempt, int *status);
+
+/**
+ * @brief Give the connection back (it stays open for the next request)
+ */
+void http_pool_release(http_pool_conn_t *conn);
+
+/**
+ * @brief WiFi dropped: every open connection is dead (any task)
+ */
+void http_pool_drop_all(void);
+
+/**
+ * @brief Log requests, failures, handshakes, bytes and latency per host,
+ *        and the phase percentiles
+ */
+void http_pool_log_stats(void);
+
+/**
+ * @brief Phase p50 / p90 / p99 per host as text, one block per host
+ *        (any task)
+ * @return Characters written
+ */
+size_t http_pool_format_phases(char *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HTTP_POOL_H
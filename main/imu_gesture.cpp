@@ -0,0 +1,159 @@
+#include "imu_gesture.h"
+#include "esp_qmi8658_port.h"
+#include "power_idle.h"
+#include "dashboard.h"
+#include "task_layout.h"
+#include "task_monitor.h"
+#include "job_watch.h"
+#include "esp_lvgl_port.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <math.h>
+#include <stdlib.h>
+
+static const char *TAG = "imu_gesture";
+
+#define SAMPLES(ms)       ((uint32_t)(ms) * QMI8658_ODR_HZ / 1000)
+#define GRAVITY_SHIFT     3       // Gravity estimate: EMA over 2^3 samples (~60 ms)
+#define REST_ALPHA        0.002f  // Resting angle follows over ~4 s
+// The board's y axis runs across the screen in landscape: tipping the top
+// edge away from the viewer turns gravity about x, which shows up in y
+#define TILT_AXIS         y
+
+typedef struct {
+    IMUdata gravity;
+    bool primed;
+    uint32_t still;               // Consecutive quiet samples
+    uint32_t since_tap;
+    float rest_deg;
+    int tilt_dir;                 // -1 / 0 / +1 beyond IMU_TILT_DEG
+    uint32_t tilt_held;
+} imu_state_t;
+
+typedef struct {
+    uint8_t taps;
+    int8_t scroll;                // Net tilt steps, + = down the page
+} imu_batch_gestures_t;
+
+static i2c_master_bus_handle_t imu_bus = NULL;
+
+/**
+ * @brief Run one sample through the tap and tilt detectors
+ */
+static void detect(imu_state_t *st, const IMUdata *a, imu_batch_gestures_t *out)
+{
+    if (!st->primed) {
+        st->gravity = *a;
+        st->rest_deg = atan2f(a->TILT_AXIS, a->z) * 180.0f / (float)M_PI;
+        st->since_tap = SAMPLES(IMU_TAP_GAP_MS);
+        st->primed = true;
+        return;
+    }
+
+    float dx = a->x - st->gravity.x;
+    float dy = a->y - st->gravity.y;
+    float dz = a->z - st->gravity.z;
+    float dev = sqrtf(dx * dx + dy * dy + dz * dz);
+    if (st->since_tap < UINT32_MAX) {
+        st->since_tap++;
+    }
+    if (dev > IMU_TAP_G && st->still >= SAMPLES(IMU_TAP_QUIET_MS) && st->since_tap >= SAMPLES(IMU_TAP_GAP_MS)) {
+        out->taps++;
+        st->since_tap = 0;
+    }
+    st->still = dev < IMU_QUIET_G ? st->still + 1 : 0;
+
+    // A tap's spike would pull the estimate; it is short enough to wash out
+    st->gravity.x += dx / (1 << GRAVITY_SHIFT);
+    st->gravity.y += dy / (1 << GRAVITY_SHIFT);
+    st->gravity.z += dz / (1 << GRAVITY_SHIFT);
+
+    float deg = atan2f(st->gravity.TILT_AXIS, st->gravity.z) * 180.0f / (float)M_PI;
+    float lean = deg - st->rest_deg;
+    int dir = lean > IMU_TILT_DEG ? 1 : (lean < -IMU_TILT_DEG ? -1 : 0);
+    if (dir == 0) {
+        if (fabsf(lean) < IMU_TILT_DEG / 2) {
+            st->rest_deg += REST_ALPHA * lean;
+        }
+        st->tilt_dir = 0;
+        st->tilt_held = 0;
+        return;
+    }
+    if (dir != st->tilt_dir) {
+        st->tilt_dir = dir;
+        st->tilt_held = 0;
+    }
+    st->tilt_held++;
+    if (st->tilt_held >= SAMPLES(IMU_TILT_REBASE_MS)) {
+        st->rest_deg = deg;       // Set down at a new angle, not a gesture
+        st->tilt_dir = 0;
+        st->tilt_held = 0;
+        return;
+    }
+    uint32_t hold = SAMPLES(IMU_TILT_HOLD_MS);
+    if (st->tilt_held >= hold && (st->tilt_held - hold) % SAMPLES(IMU_TILT_REPEAT_MS) == 0) {
+        out->scroll += dir;
+    }
+}
+
+/**
+ * @brief Act on a batch's gestures under one LVGL lock
+ */
+static void dispatch(const imu_batch_gestures_t *g)
+{
+    if (g->taps == 0 && g->scroll == 0) {
+        return;
+    }
+    if (!lvgl_port_lock(IMU_LOCK_MS)) {
+        return;
+    }
+    if (g->taps > 0) {
+        power_idle_poke();
+    }
+#if CONFIG_GOLDIE_IMU_TILT_SCROLL
+    if (g->scroll != 0 && !power_idle_is_idle()) {
+        for (int i = 0; i < abs(g->scroll); i++) {
+            dashboard_scroll_step(g->scroll);
+        }
+    }
+#endif
+    lvgl_port_unlock();
+    ESP_LOGD(TAG, "Batch gestures: %u tap(s), scroll %d", g->taps, g->scroll);
+}
+
+static void imu_task(void *arg)
+{
+    if (!esp_qmi8658_port_init(imu_bus)) {
+        vTaskDelete(NULL);
+        return;
+    }
+    task_monitor_register(TASK_ID_IMU, xTaskGetCurrentTaskHandle());
+
+    static IMUdata batch[QMI8658_FIFO_SAMPLES];
+    imu_state_t st = {};
+    while (true) {
+        esp_qmi8658_port_wait_batch();
+        job_watch_begin(TASK_ID_IMU, "imu_fifo", IMU_DRAIN_MS);
+        uint16_t n = esp_qmi8658_port_read_batch(batch, QMI8658_FIFO_SAMPLES);
+        job_watch_end(TASK_ID_IMU);
+
+        imu_batch_gestures_t g = {};
+        for (uint16_t i = 0; i < n; i++) {
+            detect(&st, &batch[i], &g);
+        }
+        dispatch(&g);
+    }
+}
+
+void imu_gesture_start(i2c_master_bus_handle_t bus)
+{
+    if (bus == NULL) {
+        ESP_LOGW(TAG, "No I2C bus - IMU gestures off");
+        return;
+    }
+    imu_bus = bus;
+    if (task_layout_create(TASK_ID_IMU, imu_task, NULL, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create the IMU task");
+    }
+}
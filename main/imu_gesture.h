@@ -0,0 +1,54 @@
+#ifndef IMU_GESTURE_H
+#define IMU_GESTURE_H
+
+#include <stdbool.h>
+#include "driver/i2c_master.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// IMU gestures - tap to wake, tilt to scroll, from batched FIFO samples
+//
+// One task (TASK_ID_IMU) probes the QMI8658, then sleeps until a FIFO
+// batch is due (esp_qmi8658_port.h), burst-reads it and runs every sample
+// through two detectors:
+//
+//   tap    the acceleration jumps more than IMU_TAP_G away from the
+//          gravity estimate after at least IMU_TAP_QUIET_MS of stillness
+//          (so carrying or handling the device is not a tap)
+//   tilt   the gravity estimate leans more than IMU_TILT_DEG from the
+//          resting angle for IMU_TILT_HOLD_MS; repeats every
+//          IMU_TILT_REPEAT_MS while held. The resting angle follows slow
+//          changes, and a tilt held past IMU_TILT_REBASE_MS becomes the
+//          new rest (the device was set down differently)
+//
+// A tap wakes the screen from idle mode (power_idle_poke); a tilt scrolls
+// the dashboard (CONFIG_GOLDIE_IMU_TILT_SCROLL, not while idle). The
+// detectors see the samples a batch late, so gestures land up to one
+// batch (250 ms) after the fact.
+
+#define IMU_TAP_G             0.35f   // Jump from the gravity estimate
+#define IMU_QUIET_G           0.06f   // Below this counts as still
+#define IMU_TAP_QUIET_MS      120     // Stillness needed before a tap
+#define IMU_TAP_GAP_MS        400     // Minimum time between taps
+#define IMU_TILT_DEG          20.0f
+#define IMU_TILT_HOLD_MS      300
+#define IMU_TILT_REPEAT_MS    500
+#define IMU_TILT_REBASE_MS    10000
+#define IMU_DRAIN_MS          100     // job_watch deadline of one FIFO drain
+#define IMU_LOCK_MS           100     // Waiting for the LVGL lock to act
+
+/**
+ * @brief Start the IMU task; the probe runs there, so this never blocks
+ *
+ * The task ends itself if no QMI8658 answers.
+ */
+void imu_gesture_start(i2c_master_bus_handle_t bus);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IMU_GESTURE_H
@@ -0,0 +1,356 @@
+#include "json_stream.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+enum {
+    ST_VALUE = 0,    // A value starts here
+    ST_KEY,          // Object: key or '}'
+    ST_COLON,        // After a key
+    ST_AFTER,        // After a value: ',' or a closing bracket
+    ST_STRING,
+    ST_LITERAL,      // Number, true, false, null
+    ST_END,          // Target found, document closed, or malformed
+};
+
+enum {
+    SINK_NONE = 0,
+    SINK_KEY,
+    SINK_OUT,
+};
+
+extern "C" bool json_stream_init(json_stream_t *js, const char *path, char *out, size_t out_size)
+{
+    memset(js, 0, sizeof(*js));
+    js->out = out;
+    js->out_size = out_size;
+    if (out != NULL && out_size > 0) {
+        out[0] = '\0';
+    }
+
+    while (path != NULL && *path != '\0') {
+        const char *dot = strchr(path, '.');
+        size_t len = dot ? (size_t)(dot - path) : strlen(path);
+        if (len == 0 || len >= JSON_STREAM_KEY_LEN || js->path_len >= JSON_STREAM_MAX_PATH) {
+            return false;
+        }
+        uint8_t c = js->path_len++;
+        bool numeric = true;
+        for (size_t i = 0; i < len; i++) {
+            numeric = numeric && isdigit((unsigned char)path[i]);
+        }
+        memcpy(js->key[c], path, len);
+        js->key[c][len] = '\0';
+        js->index[c] = numeric ? (int16_t)atoi(js->key[c]) : -1;
+        path = dot ? dot + 1 : NULL;
+    }
+    return js->path_len > 0 && js->path_len < JSON_STREAM_MAX_DEPTH;
+}
+
+extern "C" bool json_stream_found(const json_stream_t *js)
+{
+    return js->found;
+}
+
+// The value starting now is the next component of the target path
+static bool value_matches(const json_stream_t *js)
+{
+    uint8_t d = js->depth;
+    if (d == 0 || d > js->path_len || js->matched != d - 1) {
+        return false;
+    }
+    uint8_t c = d - 1;
+    if (js->is_array[d - 1]) {
+        return js->index[c] >= 0 && js->count[d - 1] == (uint16_t)js->index[c];
+    }
+    return js->index[c] < 0 && !js->cur_key_long && strcmp(js->cur_key, js->key[c]) == 0;
+}
+
+static void emit_bytes(json_stream_t *js, const char *b, size_t n)
+{
+    if (js->sink == SINK_KEY) {
+        if (js->cur_key_len + n < JSON_STREAM_KEY_LEN) {
+            memcpy(js->cur_key + js->cur_key_len, b, n);
+            js->cur_key_len += n;
+            js->cur_key[js->cur_key_len] = '\0';
+        } else {
+            js->cur_key_long = true;
+        }
+    } else if (js->sink == SINK_OUT) {
+        // Whole characters only: a cut reply stays valid UTF-8
+        if (!js->truncated && js->out_len + n < js->out_size) {
+            memcpy(js->out + js->out_len, b, n);
+            js->out_len += n;
+            js->out[js->out_len] = '\0';
+        } else {
+            js->truncated = true;
+        }
+    }
+}
+
+static void emit_code_point(json_stream_t *js, uint32_t cp)
+{
+    char u[4];
+    if (cp < 0x80) {
+        u[0] = (char)cp;
+        emit_bytes(js, u, 1);
+    } else if (cp < 0x800) {
+        u[0] = (char)(0xC0 | (cp >> 6));
+        u[1] = (char)(0x80 | (cp & 0x3F));
+        emit_bytes(js, u, 2);
+    } else if (cp < 0x10000) {
+        u[0] = (char)(0xE0 | (cp >> 12));
+        u[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        u[2] = (char)(0x80 | (cp & 0x3F));
+        emit_bytes(js, u, 3);
+    } else {
+        u[0] = (char)(0xF0 | (cp >> 18));
+        u[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        u[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        u[3] = (char)(0x80 | (cp & 0x3F));
+        emit_bytes(js, u, 4);
+    }
+}
+
+// A high surrogate not followed by its low half
+static void flush_surrogate(json_stream_t *js)
+{
+    if (js->hi_surrogate != 0) {
+        js->hi_surrogate = 0;
+        emit_code_point(js, 0xFFFD);
+    }
+}
+
+static void unicode_escape(json_stream_t *js, uint32_t u)
+{
+    if (u >= 0xD800 && u < 0xDC00) {
+        flush_surrogate(js);
+        js->hi_surrogate = u;
+    } else if (u >= 0xDC00 && u < 0xE000) {
+        if (js->hi_surrogate != 0) {
+            uint32_t cp = 0x10000 + ((js->hi_surrogate - 0xD800) << 10) + (u - 0xDC00);
+            js->hi_surrogate = 0;
+            emit_code_point(js, cp);
+        } else {
+            emit_code_point(js, 0xFFFD);
+        }
+    } else {
+        flush_surrogate(js);
+        emit_code_point(js, u);
+    }
+}
+
+// Raw UTF-8 is copied a byte at a time; drop a sequence the cut split
+static void trim_partial_utf8(json_stream_t *js)
+{
+    size_t end = js->out_len;
+    size_t lead = end;
+    while (lead > 0 && ((unsigned char)js->out[lead - 1] & 0xC0) == 0x80 && end - lead < 3) {
+        lead--;
+    }
+    if (lead == 0) {
+        return;
+    }
+    unsigned char c = (unsigned char)js->out[lead - 1];
+    size_t need = (c >= 0xF0) ? 4 : (c >= 0xE0) ? 3 : (c >= 0xC0) ? 2 : 1;
+    if (need > 1 && end - (lead - 1) < need) {
+        js->out_len = lead - 1;
+        js->out[js->out_len] = '\0';
+    }
+}
+
+static void end_string(json_stream_t *js)
+{
+    flush_surrogate(js);
+    if (js->sink == SINK_KEY) {
+        js->state = ST_COLON;
+    } else if (js->sink == SINK_OUT) {
+        if (js->truncated) {
+            trim_partial_utf8(js);
+        }
+        js->found = true;
+        js->state = ST_END;     // Nothing else is wanted
+    } else {
+        js->state = ST_AFTER;
+    }
+    js->sink = SINK_NONE;
+}
+
+static void string_char(json_stream_t *js, char ch)
+{
+    if (js->esc == 0) {
+        if (ch == '\\') {
+            js->esc = 1;
+        } else if (ch == '"') {
+            end_string(js);
+        } else {
+            flush_surrogate(js);
+            emit_bytes(js, &ch, 1);
+        }
+        return;
+    }
+
+    if (js->esc == 1) {
+        char c;
+        switch (ch) {
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'n': c = '\n'; break;
+            case 'r': c = '\r'; break;
+            case 't': c = '\t'; break;
+            case 'u':
+                js->esc = 2;
+                js->uni = 0;
+                return;
+            default:  c = ch; break;   // \" \\ \/ (and anything else verbatim)
+        }
+        js->esc = 0;
+        flush_surrogate(js);
+        emit_bytes(js, &c, 1);
+        return;
+    }
+
+    // \uXXXX: esc 2..5 counts the hex digits
+    uint32_t v;
+    if (ch >= '0' && ch <= '9') {
+        v = (uint32_t)(ch - '0');
+    } else if (ch >= 'a' && ch <= 'f') {
+        v = (uint32_t)(ch - 'a' + 10);
+    } else if (ch >= 'A' && ch <= 'F') {
+        v = (uint32_t)(ch - 'A' + 10);
+    } else {
+        js->error = true;
+        js->state = ST_END;
+        return;
+    }
+    js->uni = (js->uni << 4) | v;
+    if (++js->esc == 6) {
+        js->esc = 0;
+        unicode_escape(js, js->uni);
+    }
+}
+
+static void push(json_stream_t *js, bool array, bool matches)
+{
+    if (js->depth >= JSON_STREAM_MAX_DEPTH) {
+        js->error = true;
+        js->state = ST_END;
+        return;
+    }
+    if (matches) {
+        js->matched = js->depth;
+    }
+    js->is_array[js->depth] = array;
+    js->count[js->depth] = 0;
+    js->depth++;
+    js->state = array ? ST_VALUE : ST_KEY;
+}
+
+static void pop(json_stream_t *js, bool array)
+{
+    if (js->depth == 0 || js->is_array[js->depth - 1] != array) {
+        js->error = true;
+        js->state = ST_END;
+        return;
+    }
+    js->depth--;
+    uint8_t limit = js->depth > 0 ? js->depth - 1 : 0;
+    if (js->matched > limit) {
+        js->matched = limit;
+    }
+    js->state = (js->depth == 0) ? ST_END : ST_AFTER;
+}
+
+static void begin_value(json_stream_t *js, char ch)
+{
+    bool m = value_matches(js);
+    switch (ch) {
+        case '{':
+            push(js, false, m);
+            break;
+        case '[':
+            push(js, true, m);
+            break;
+        case '"':
+            js->sink = (m && js->depth == js->path_len) ? SINK_OUT : SINK_NONE;
+            js->esc = 0;
+            js->hi_surrogate = 0;
+            js->state = ST_STRING;
+            break;
+        default:
+            js->state = ST_LITERAL;
+            break;
+    }
+}
+
+extern "C" void json_stream_feed(json_stream_t *js, const char *data, size_t len)
+{
+    for (size_t i = 0; i < len && js->state != ST_END; i++) {
+        char ch = data[i];
+
+        if (js->state == ST_STRING) {
+            string_char(js, ch);
+            continue;
+        }
+        if (js->state == ST_LITERAL) {
+            if (isalnum((unsigned char)ch) || ch == '-' || ch == '+' || ch == '.') {
+                continue;
+            }
+            js->state = ST_AFTER;   // The delimiter is scanned below
+        }
+        if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n') {
+            continue;
+        }
+
+        switch (js->state) {
+            case ST_VALUE:
+                if (ch == ']' && js->depth > 0 && js->is_array[js->depth - 1]) {
+                    pop(js, true);   // Empty array
+                } else {
+                    begin_value(js, ch);
+                }
+                break;
+            case ST_KEY:
+                if (ch == '"') {
+                    js->cur_key_len = 0;
+                    js->cur_key[0] = '\0';
+                    js->cur_key_long = false;
+                    js->sink = SINK_KEY;
+                    js->esc = 0;
+                    js->hi_surrogate = 0;
+                    js->state = ST_STRING;
+                } else if (ch == '}') {
+                    pop(js, false);
+                } else {
+                    js->error = true;
+                    js->state = ST_END;
+                }
+                break;
+            case ST_COLON:
+                if (ch == ':') {
+                    js->state = ST_VALUE;
+                } else {
+                    js->error = true;
+                    js->state = ST_END;
+                }
+                break;
+            case ST_AFTER:
+                if (ch == ',' && js->depth > 0) {
+                    if (js->is_array[js->depth - 1]) {
+                        js->count[js->depth - 1]++;
+                        js->state = ST_VALUE;
+                    } else {
+                        js->state = ST_KEY;
+                    }
+                } else if (ch == '}' || ch == ']') {
+                    pop(js, ch == ']');
+                } else {
+                    js->error = true;
+                    js->state = ST_END;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
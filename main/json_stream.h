@@ -0,0 +1,76 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Streaming extraction of one string value from a JSON document
+//
+// The document is fed in arbitrary chunks (e.g. HTTP_EVENT_ON_DATA) and
+// scanned in a single pass without building a tree: nesting is tracked on
+// a small fixed stack and only the string at `path` is decoded (escapes and
+// \uXXXX, surrogate pairs included, as UTF-8) straight into the caller's
+// buffer. Everything else is skipped. No heap; the state is this struct.
+//
+// Path: dot-separated object keys and array indices, e.g.
+// "choices.0.message.content". The first match wins.
+
+#define JSON_STREAM_MAX_DEPTH  16
+#define JSON_STREAM_MAX_PATH   6
+#define JSON_STREAM_KEY_LEN    24    // Longest path key (and compared key)
+
+typedef struct {
+    // Target
+    char key[JSON_STREAM_MAX_PATH][JSON_STREAM_KEY_LEN];
+    int16_t index[JSON_STREAM_MAX_PATH];   // >= 0: array index, -1: object key
+    uint8_t path_len;
+
+    // Output
+    char *out;
+    size_t out_size;
+    size_t out_len;
+    bool found;                // Target string complete
+    bool truncated;            // It did not fit in out
+    bool error;                // Malformed document (scan stopped)
+
+    // Scanner
+    uint8_t state;
+    uint8_t depth;
+    uint8_t matched;           // Path components matched by the open containers
+    bool is_array[JSON_STREAM_MAX_DEPTH];
+    uint16_t count[JSON_STREAM_MAX_DEPTH];  // Array element being scanned
+    char cur_key[JSON_STREAM_KEY_LEN];
+    uint8_t cur_key_len;
+    bool cur_key_long;
+    uint8_t sink;              // Where string bytes go
+    uint8_t esc;               // Escape progress (0 = none)
+    uint32_t uni;
+    uint32_t hi_surrogate;
+} json_stream_t;
+
+/**
+ * @brief Start a scan for the string at path
+ * @return false if the path is empty or too long / deep
+ */
+bool json_stream_init(json_stream_t *js, const char *path, char *out, size_t out_size);
+
+/**
+ * @brief Scan the next chunk of the document
+ */
+void json_stream_feed(json_stream_t *js, const char *data, size_t len);
+
+/**
+ * @brief The target string was found and terminated (out is NUL-terminated)
+ */
+bool json_stream_found(const json_stream_t *js);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JSON_STREAM_H
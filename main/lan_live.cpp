@@ -0,0 +1,199 @@
+#include "lan_live.h"
+#include "web_server.h"
+#include "messages.h"
+#include "msg_bus.h"
+#include "text_buf.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+
+static const char *TAG = "lan_live";
+
+extern const uint8_t page_gz_start[] asm("_binary_dashboard_html_gz_start");
+extern const uint8_t page_gz_end[] asm("_binary_dashboard_html_gz_end");
+
+static httpd_handle_t server = NULL;
+static msg_bus_sub_t *snapshot_sub = NULL;
+static std::atomic<bool> push_queued(false);
+
+// Server task only (handlers and queued work run there one at a time)
+static int clients[LAN_LIVE_CLIENTS];
+static int client_count = 0;
+static char json[LAN_LIVE_JSON_MAX];
+static size_t json_len = 0;
+
+/**
+ * @brief Append s as a JSON string body (quotes not included), cut to fit
+ */
+static size_t json_escape(char *out, size_t len, const char *s)
+{
+    size_t n = 0;
+    for (; s != NULL && *s != '\0'; s++) {
+        unsigned char c = (unsigned char)*s;
+        char esc[8];
+        size_t need;
+        if (c == '"' || c == '\\') {
+            esc[0] = '\\';
+            esc[1] = (char)c;
+            need = 2;
+        } else if (c == '\n') {
+            memcpy(esc, "\\n", 2);
+            need = 2;
+        } else if (c < 0x20) {
+            need = (size_t)snprintf(esc, sizeof(esc), "\\u%04x", c);
+        } else {
+            esc[0] = (char)c;
+            need = 1;
+        }
+        if (n + need >= len) {
+            break;
+        }
+        memcpy(out + n, esc, need);
+        n += need;
+    }
+    out[n] = '\0';
+    return n;
+}
+
+static void format_snapshot(const blynk_sync_msg_t *s)
+{
+    int n = snprintf(json, sizeof(json),
+                     "{\"t\":%lu,\"mood\":\"%s\",\"ammonia\":%.3f,\"nitrite\":%.3f,\"nitrate\":%.2f,"
+                     "\"ph\":%.2f,\"feed_h\":%.2f,\"clean_d\":%.2f,\"advice\":\"",
+                     (unsigned long)s->timestamp, s->mood, s->ammonia_ppm, s->nitrite_ppm, s->nitrate_ppm,
+                     s->ph_level, s->feed_hours, s->clean_days);
+    if (n <= 0 || (size_t)n >= sizeof(json) - 3) {
+        json_len = 0;
+        return;
+    }
+    size_t len = (size_t)n;
+    len += json_escape(json + len, sizeof(json) - len - 2, text_buf_str(s->ai_advice));
+    json[len++] = '"';
+    json[len++] = '}';
+    json[len] = '\0';
+    json_len = len;
+}
+
+static esp_err_t send_json(int fd)
+{
+    httpd_ws_frame_t frame = {};
+    frame.type = HTTPD_WS_TYPE_TEXT;
+    frame.final = true;
+    frame.payload = (uint8_t *)json;
+    frame.len = json_len;
+    return httpd_ws_send_frame_async(server, fd, &frame);
+}
+
+/**
+ * @brief Server task: format the newest snapshot and send it to every client
+ */
+static void push_work(void *arg)
+{
+    push_queued = false;
+    const msg_bus_msg_t *msg = msg_bus_receive(snapshot_sub, 0);
+    if (msg == NULL) {
+        return;
+    }
+    format_snapshot(MSG_BUS_PAYLOAD(msg, blynk_sync_msg_t));
+    msg_bus_release(msg);
+    if (json_len == 0) {
+        return;
+    }
+
+    int kept = 0;
+    for (int i = 0; i < client_count; i++) {
+        int fd = clients[i];
+        if (httpd_ws_get_fd_info(server, fd) == HTTPD_WS_CLIENT_WEBSOCKET && send_json(fd) == ESP_OK) {
+            clients[kept++] = fd;
+        }
+    }
+    client_count = kept;
+}
+
+/**
+ * @brief Snapshot delivered (publishing task): wake the server task once
+ */
+static void snapshot_notify(void *arg)
+{
+    if (!push_queued.exchange(true) && httpd_queue_work(server, push_work, NULL) != ESP_OK) {
+        push_queued = false;
+    }
+}
+
+static esp_err_t page_handler(httpd_req_t *req)
+{
+    httpd_resp_set_type(req, "text/html");
+    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    httpd_resp_set_hdr(req, "Cache-Control", "max-age=3600");
+    return httpd_resp_send(req, (const char *)page_gz_start, page_gz_end - page_gz_start);
+}
+
+static esp_err_t ws_handler(httpd_req_t *req)
+{
+    int fd = httpd_req_to_sockfd(req);
+    if (req->method == HTTP_GET) {
+        // Handshake done: forget closed sockets, then take the new one
+        int kept = 0;
+        for (int i = 0; i < client_count; i++) {
+            if (httpd_ws_get_fd_info(server, clients[i]) == HTTPD_WS_CLIENT_WEBSOCKET && clients[i] != fd) {
+                clients[kept++] = clients[i];
+            }
+        }
+        client_count = kept;
+        if (client_count == LAN_LIVE_CLIENTS) {
+            ESP_LOGW(TAG, "Client limit (%d) reached - socket %d gets no updates", LAN_LIVE_CLIENTS, fd);
+            return ESP_OK;
+        }
+        clients[client_count++] = fd;
+        ESP_LOGI(TAG, "Live client on socket %d (%d connected)", fd, client_count);
+        return json_len > 0 ? send_json(fd) : ESP_OK;
+    }
+
+    // The page never sends anything; read and drop whatever arrives
+    httpd_ws_frame_t frame = {};
+    esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
+    if (err != ESP_OK) {
+        return err;
+    }
+    uint8_t scratch[64];
+    if (frame.len > 0 && frame.len <= sizeof(scratch)) {
+        frame.payload = scratch;
+        err = httpd_ws_recv_frame(req, &frame, frame.len);
+    }
+    return err;
+}
+
+bool lan_live_start(void)
+{
+    if (server != NULL) {
+        return true;
+    }
+    httpd_handle_t handle = web_server_start();
+    if (handle == NULL) {
+        return false;
+    }
+
+    const httpd_uri_t page_uri = {
+        .uri = "/", .method = HTTP_GET, .handler = page_handler, .user_ctx = NULL,
+    };
+    httpd_uri_t ws_uri = {
+        .uri = "/ws", .method = HTTP_GET, .handler = ws_handler, .user_ctx = NULL,
+    };
+    ws_uri.is_websocket = true;
+    if (httpd_register_uri_handler(handle, &page_uri) != ESP_OK ||
+        httpd_register_uri_handler(handle, &ws_uri) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register / and /ws");
+        return false;
+    }
+    server = handle;
+
+    // Subscribed last: the notify callback needs the server handle
+    snapshot_sub = msg_bus_subscribe("lan_live", MSG_TOPIC_BLYNK_SYNC, 1, MSG_SUB_LATEST,
+                                     snapshot_notify, NULL);
+    if (snapshot_sub == NULL) {
+        ESP_LOGW(TAG, "No snapshot subscription - page served without updates");
+    }
+    ESP_LOGI(TAG, "LAN live dashboard: / (%u bytes gzip), /ws", (unsigned)(page_gz_end - page_gz_start));
+    return true;
+}
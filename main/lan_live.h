@@ -0,0 +1,35 @@
+#ifndef LAN_LIVE_H
+#define LAN_LIVE_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Live dashboard for the local network (web_server.h, port 80)
+//
+//   GET /     a small page (main/web/dashboard.html), stored gzip-compressed
+//             in the firmware and sent as it is (Content-Encoding: gzip)
+//   GET /ws   WebSocket: one JSON text frame per dashboard snapshot
+//
+// The snapshots are the ones the dashboard publishes for Blynk
+// (MSG_TOPIC_BLYNK_SYNC): a second, latest-only subscription hands each
+// one to the server task, which formats it once and sends it to every
+// connected client, so a LAN client sees a mood, parameter or advice
+// change without the round trip through blynk.cloud. A new client gets
+// the latest snapshot straight away. No authentication - trusted
+// networks only.
+
+#define LAN_LIVE_CLIENTS   3
+#define LAN_LIVE_JSON_MAX  1024
+
+// Register the page and the socket and subscribe to snapshots (call after
+// WiFi is connected; safe to call again)
+bool lan_live_start(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LAN_LIVE_H
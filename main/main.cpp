@@ -7,6 +7,7 @@
 #include "freertos/semphr.h"
 
 #include "esp_timer.h"
+#include "esp_heap_caps.h"
 
 #include "driver/gpio.h"
 
@@ -14,7 +15,9 @@
 
 #include "esp_io_expander_tca9554.h"
 
-#include "esp_spiffs.h"
+#include "storage_fs.h"
+#include "asset_bundle.h"
+#include "firmware_ota.h"
 
 #include "lvgl.h"
 #include "demos/lv_demos.h"
@@ -34,13 +37,57 @@
 #include "esp_axp2101_port.h"
 #include "esp_camera_port.h"
 #include "esp_es8311_port.h"
-#include "esp_pcf85063_port.h"
 #include "esp_qmi8658_port.h"
 #include "esp_sdcard_port.h"
+#include "hw_manifest.h"
+#include "i2c_sched.h"
+#include "io_sched.h"
+#include "blackbox.h"
 #include "esp_wifi_port.h"
 #include "esp_3inch5_lcd_port.h"
+#include "esp_lcd_panel_ops.h"
 
 #include "task_coordinator.h"
+#include "input_rec.h"
+#include "anim/boot_splash.h"
+#include "ui/ui_perf.h"
+#include "ui/ui_mirror.h"
+#include "ui/render_bench.h"
+#include "ui/ui_latency.h"
+#include "ui/touch_filter.h"
+#include "ui/touch_rec.h"
+#if CONFIG_GOLDIE_SOAK_TEST
+#include "soak_test.h"
+#endif
+#if CONFIG_GOLDIE_SENSORS
+#include "sensor_acq.h"
+#endif
+#if CONFIG_GOLDIE_PROBE_ADC
+#include "probe_adc.h"
+#endif
+#if CONFIG_GOLDIE_ESPNOW_HUB
+#include "espnow_hub.h"
+#endif
+#if CONFIG_GOLDIE_IMU
+#include "imu_gesture.h"
+#endif
+#if CONFIG_GOLDIE_POWER_MONITOR
+#include "power_monitor.h"
+#endif
+#if CONFIG_GOLDIE_RTC
+#include "rtc_clock.h"
+#endif
+#if CONFIG_GOLDIE_SNAPSHOT
+#include "snapshot.h"
+#endif
+#if CONFIG_GOLDIE_AUDIO_ALERTS
+#include "audio_alert.h"
+#endif
+#include "boot_graph.h"
+#include "boot_trace.h"
+#include "power_idle.h"
+#include "power_gov.h"
+#include "task_layout.h"
 
 #define EXAMPLE_PIN_I2C_SDA GPIO_NUM_8
 #define EXAMPLE_PIN_I2C_SCL GPIO_NUM_7
@@ -59,8 +106,40 @@
 
 #define LCD_BUFFER_SIZE EXAMPLE_LCD_H_RES *EXAMPLE_LCD_V_RES / 8
 
+// Panel scan rotation (ST7796 MADCTL MV/MX/MY)
+#if EXAMPLE_DISPLAY_ROTATION == 90
+#define PANEL_SWAP_XY  1
+#define PANEL_MIRROR_X 1
+#define PANEL_MIRROR_Y 1
+#elif EXAMPLE_DISPLAY_ROTATION == 180
+#define PANEL_SWAP_XY  0
+#define PANEL_MIRROR_X 0
+#define PANEL_MIRROR_Y 1
+#elif EXAMPLE_DISPLAY_ROTATION == 270
+#define PANEL_SWAP_XY  1
+#define PANEL_MIRROR_X 0
+#define PANEL_MIRROR_Y 0
+#else
+#define PANEL_SWAP_XY  0
+#define PANEL_MIRROR_X 1
+#define PANEL_MIRROR_Y 0
+#endif
+
+#ifndef CONFIG_GOLDIE_DISPLAY_DMA_RESERVE_KB
+#define CONFIG_GOLDIE_DISPLAY_DMA_RESERVE_KB 96
+#endif
+#ifndef CONFIG_GOLDIE_DISPLAY_DMA_MAX_LINES
+#define CONFIG_GOLDIE_DISPLAY_DMA_MAX_LINES 40
+#endif
+#define LCD_DMA_MIN_LINES 10   // Below this, flush overhead beats the DMA gain
+#ifndef CONFIG_GOLDIE_LCD_TE_EXPANDER_PIN
+#define CONFIG_GOLDIE_LCD_TE_EXPANDER_PIN -1
+#endif
+
 #define I2C_PORT_NUM 0
 
+#define LCD_BRIGHTNESS 80    // Backlight outside idle mode (%)
+
 static const char *TAG = "lvgl_example";
 
 i2c_master_bus_handle_t i2c_bus_handle;
@@ -80,11 +159,27 @@ bool touch_test_done = false;
 void i2c_bus_init(void);
 void io_expander_init(void);
 void lv_port_init(void);
-void spiffs_init(void);
 
-extern "C" void app_main(void)
+/**
+ * @brief First frame with the dashboard drawn: end of boot
+ */
+static void (*next_monitor)(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px) = NULL;
+
+static void first_frame_monitor(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px)
+{
+    drv->monitor_cb = next_monitor;    // Once
+    boot_trace_mark("first frame");
+    boot_trace_dump();
+    if (next_monitor) {
+        next_monitor(drv, time_ms, px);
+    }
+}
+
+/**
+ * @brief NVS (graceful failure - the system can run without it)
+ */
+static void boot_nvs(void)
 {
-    // Initialize NVS (graceful failure - system can run without NVS)
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND)
     {
@@ -101,42 +196,180 @@ extern "C" void app_main(void)
     } else {
         ESP_LOGI(TAG, "NVS initialized successfully");
     }
-    
-    // Initialize SPIFFS for image storage
-    spiffs_init();
+}
+
+/**
+ * @brief Storage partition (SPIFFS or LittleFS) for image storage
+ */
+static void boot_storage_fs(void)
+{
+    storage_fs_mount();
+#if CONFIG_GOLDIE_STORAGE_FS_BENCHMARK
+    if (!hw_manifest_warm()) {
+        storage_fs_benchmark();
+    }
+#endif
+}
+
+/**
+ * @brief Asset bundle index, from flash, the storage partition or the card
+ */
+static void boot_assets(void)
+{
+    asset_bundle_init();
+}
+
+#if CONFIG_GOLDIE_LCD_TE_EXPANDER_PIN >= 0
+/**
+ * @brief Panel TE level on the IO expander input (esp_3inch5_te_port_wait)
+ */
+static bool te_expander_read(bool *high)
+{
+    uint32_t levels = 0;
+    if (expander_handle == NULL ||
+        esp_io_expander_get_level(expander_handle, 1u << CONFIG_GOLDIE_LCD_TE_EXPANDER_PIN, &levels) != ESP_OK) {
+        return false;
+    }
+    *high = levels != 0;
+    return true;
+}
+#endif
+
+static void boot_display(void)
+{
+    // SPI transfers are sized in bytes; the port caps this at the DMA
+    // transaction limit and esp_lcd chunks bigger flushes. The one part the
+    // firmware cannot do without: no panel, no point in booting on
+    ESP_ERROR_CHECK(esp_3inch5_display_port_init(&io_handle, &panel_handle, LCD_BUFFER_SIZE * sizeof(uint16_t)));
+#if CONFIG_GOLDIE_LCD_TE_EXPANDER_PIN >= 0
+    esp_3inch5_te_port_init(io_handle, expander_handle != NULL ? te_expander_read : NULL);
+#else
+    esp_3inch5_te_port_init(io_handle, NULL);
+#endif
+}
+
+/**
+ * @brief Landscape scan-out, splash, then the backlight (nothing shows before)
+ */
+static void boot_splash(void)
+{
+    // Program the rotation into the panel controller (MADCTL MV/MX/MY) so
+    // the ST7796 scans out landscape by itself and LVGL renders and flushes
+    // 480×320 areas untouched. Touch uses the same rotation table
+    // (esp_3inch5_touch_port_init), so both stay in step.
+    ESP_ERROR_CHECK(esp_lcd_panel_swap_xy(panel_handle, PANEL_SWAP_XY));
+    ESP_ERROR_CHECK(esp_lcd_panel_mirror(panel_handle, PANEL_MIRROR_X, PANEL_MIRROR_Y));
+    boot_splash_show(panel_handle, io_handle, EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES);
+    esp_3inch5_brightness_port_init();
+    esp_3inch5_brightness_port_set(LCD_BRIGHTNESS);
+}
+
+/**
+ * @brief Touch controller (optional: without it the UI shows, input is off)
+ */
+static void boot_touch(void)
+{
+    esp_3inch5_touch_port_init(&touch_handle, i2c_bus_handle, EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES, EXAMPLE_DISPLAY_ROTATION);
+}
+
+static void boot_axp2101(void)
+{
+    bool rails_up = hw_manifest_had(HW_PMU, NULL);    // Kept through a warm reset
+    esp_axp2101_port_init(i2c_bus_handle);
+    if (!rails_up) {
+        vTaskDelay(pdMS_TO_TICKS(100));    // Rails settle before the SD card
+    }
+}
+
+static void boot_rtc(void)
+{
+#if CONFIG_GOLDIE_RTC
+    rtc_clock_restore(i2c_bus_handle);    // Wall-clock time before the first frame
+#endif
+}
+
+/**
+ * @brief Hardware bring-up order (boot_graph.h)
+ *
+ * The I2C bus driver serialises its devices, so the expander, touch and PMU
+ * may talk over it from different helpers. The expander and panel resets
+ * spend ~350 ms in delays; the storage and SD mounts run meanwhile.
+ */
+enum {
+    BOOT_NVS,
+    BOOT_STORAGE_FS,
+    BOOT_I2C,
+    BOOT_IO_EXPANDER,
+    BOOT_DISPLAY,
+    BOOT_SPLASH,
+    BOOT_TOUCH,
+    BOOT_AXP2101,
+    BOOT_SD_CARD,
+    BOOT_RTC,
+    BOOT_ASSETS,
+};
+
+static const boot_stage_t boot_stages[] = {
+    { "nvs",         boot_nvs,             0 },
+    { "storage fs",  boot_storage_fs,      0 },
+    { "i2c",         i2c_bus_init,         0 },
+    { "io expander", io_expander_init,     BOOT_AFTER(BOOT_I2C) },                          // Panel power
+    { "display",     boot_display,         BOOT_AFTER(BOOT_IO_EXPANDER) },
+    { "splash",      boot_splash,          BOOT_AFTER(BOOT_DISPLAY) },
+    { "touch",       boot_touch,           BOOT_AFTER(BOOT_I2C) | BOOT_AFTER(BOOT_DISPLAY) },
+    { "axp2101",     boot_axp2101,         BOOT_AFTER(BOOT_I2C) },
+    { "sd card",     esp_sdcard_port_init, BOOT_AFTER(BOOT_AXP2101) },                      // Card rails
+    { "rtc",         boot_rtc,             BOOT_AFTER(BOOT_I2C) | BOOT_AFTER(BOOT_NVS) },     // Drift state
+    { "assets",      boot_assets,          BOOT_AFTER(BOOT_STORAGE_FS) | BOOT_AFTER(BOOT_SD_CARD) },
+};
+
+extern "C" void app_main(void)
+{
+    boot_trace_mark("startup");
+    hw_manifest_begin();    // Warm reset: skip what the last boot already proved
+    blackbox_begin();       // Keep the last boot's final events for the SD logger
+    io_sched_init();        // Frame loads ahead of log writes and maintenance (io_sched.h)
     
     // WiFi initialization moved to background task (non-blocking)
     // System will start in OFFLINE mode and transition to ONLINE when ready
     ESP_LOGI(TAG, "WiFi will initialize in background - UI starting immediately");
     
-    i2c_bus_init();
-    io_expander_init();
-    esp_3inch5_display_port_init(&io_handle, &panel_handle, LCD_BUFFER_SIZE);
-    esp_3inch5_touch_port_init(&touch_handle, i2c_bus_handle, EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES, EXAMPLE_DISPLAY_ROTATION);
-    esp_axp2101_port_init(i2c_bus_handle);
-    vTaskDelay(pdMS_TO_TICKS(100));
-    // esp_es8311_port_init(i2c_bus_handle);
-    // esp_qmi8658_port_init(i2c_bus_handle);
-    // esp_pcf85063_port_init(i2c_bus_handle);
+    // The UI below needs the panel and touch; the task coordinator needs
+    // NVS and both filesystems, so everything is up before either starts
+    boot_graph_run(boot_stages, sizeof(boot_stages) / sizeof(boot_stages[0]));
+    hw_manifest_log();      // IMU, camera and codec are still probed later, in their own tasks
     
-    // Initialize SD card for animation frames
-    esp_sdcard_port_init();
-    
-    // esp_camera_port_init(I2C_PORT_NUM);
     // esp_wifi_port_init("WSTEST", "waveshare0755");
 
-    esp_3inch5_brightness_port_init();
-    esp_3inch5_brightness_port_set(80);
     lv_port_init();
+    dashboard_set_panel(panel_handle, io_handle);  // Direct animation blits
+    boot_trace_mark("lvgl port");
     
     // Initialize task coordinator (Step 0 - creates idle background tasks)
     // NO BEHAVIORAL CHANGES - tasks are stubs, queues unused
     task_coordinator_init();
+    boot_trace_mark("task coordinator");
     
     if (lvgl_port_lock(0))
     {
         // Initialize IoT Dashboard with gauges and animation
         dashboard_init();
+        boot_trace_mark("dashboard");
+        power_idle_init(lvgl_disp, lvgl_touch_indev, LCD_BRIGHTNESS);
+        power_gov_init();                       // Drives the two above from the power monitor
+        touch_rec_init(lvgl_touch_indev);       // Between the two: records what the filter gets
+        touch_filter_init(lvgl_touch_indev);    // Outside power_idle: sees its swallowed wake touch
+        ui_perf_init(lvgl_disp, io_handle);
+        ui_latency_init(lvgl_disp);
+        ui_mirror_init(lvgl_disp);              // After the other flush wrappers: copies what reaches the panel
+        render_cfg_attach(lvgl_disp);           // Direct mode only; outermost, so the wrappers see its band
+        if (lvgl_disp != NULL) {
+            next_monitor = lvgl_disp->driver->monitor_cb;
+            lvgl_disp->driver->monitor_cb = first_frame_monitor;   // Rendered after the unlock
+        }
+#if CONFIG_GOLDIE_SOAK_TEST
+        soak_test_start(lvgl_disp);
+#endif
         
         // WiFi/Blynk initialization happens in background
         // Calendar and Blynk will activate automatically when WiFi connects
@@ -144,30 +377,50 @@ extern "C" void app_main(void)
         
         lvgl_port_unlock();
     }
+    input_rec_init();                           // Every replay sink is registered by now
+    
+#if CONFIG_GOLDIE_SENSORS
+#if CONFIG_GOLDIE_PROBE_ADC
+    probe_adc_register_config();          // Analog probes on the continuous ADC (probe_adc.h)
+#endif
+#if CONFIG_GOLDIE_ESPNOW_HUB
+    espnow_hub_register();                // Radio nodes for what no wired probe reads (espnow_hub.h)
+#endif
+    sensor_acq_start();     // Probe readings join manual entry (sensor_acq.h)
+#endif
+#if CONFIG_GOLDIE_IMU
+    imu_gesture_start(i2c_bus_handle);    // Probes in its own task (imu_gesture.h)
+#endif
+#if CONFIG_GOLDIE_POWER_MONITOR
+    power_monitor_start();  // After the governor subscribed to its topic
+#endif
+#if CONFIG_GOLDIE_SNAPSHOT
+    snapshot_start();       // Camera probe in its own task (snapshot.h)
+#endif
+#if CONFIG_GOLDIE_AUDIO_ALERTS
+    audio_alert_start(i2c_bus_handle);    // Codec probe in its own task (audio_alert.h)
+#endif
+    firmware_ota_mark_valid();  // Got this far: keep an updated image (firmware_ota.h)
     
-    // Real deployment mode - values come from Parameter Menu or future sensors
+    // Real deployment mode - values come from Parameter Menu or sensors
     ESP_LOGI(TAG, "=== REAL DEPLOYMENT MODE - Use Parameter Menu to set values ===");
     ESP_LOGI(TAG, "To update water parameters:");
     ESP_LOGI(TAG, "  1. Tap 'Parameters' button on dashboard");
     ESP_LOGI(TAG, "  2. Enter Ammonia, Nitrite, Nitrate, pH values");
     ESP_LOGI(TAG, "  3. Values will be used for mood calculation and Blynk updates");
     
-    // STEP 5: Blynk sync moved to wifi_task (via dashboard snapshot publisher)
+    // STEP 5: Blynk sync runs on the telemetry worker (via dashboard snapshot publisher)
     // Blynk updates now occur automatically every 30 seconds from LVGL timer
-    // See: dashboard.cpp - blynk_snapshot_publisher() and task_coordinator.cpp - wifi_task()
-    ESP_LOGI(TAG, "Blynk sync running on wifi_task (30s automatic updates)");
+    // See: dashboard.cpp - blynk_snapshot_publisher() and task_coordinator.cpp - telemetry_task()
+    ESP_LOGI(TAG, "Blynk sync running on telemetry worker (30s automatic updates)");
     
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(30000));  // Keep alive delay
         
-        // In real deployment, integrate sensor readings here:
-        // TODO: Replace manual parameter entry with actual sensor readings:
-        //   - Read ammonia from sensor → dashboard_update_ammonia()
-        //   - Read nitrite from sensor → dashboard_update_nitrite()
-        //   - Read nitrate from sensor → dashboard_update_nitrate()
-        //   - Read pH from sensor → dashboard_update_ph()
+        // Sensor readings arrive through sensor_acq's own task: register a
+        // driver per probe (sensor_acq_register) before sensor_acq_start()
         
-        // Note: Blynk updates are now handled by wifi_task automatically
+        // Note: Blynk updates are now handled by the telemetry worker automatically
         // No need to call blynk_send_all_data() here
     }
 }
@@ -189,6 +442,7 @@ void i2c_bus_init(void)
         i2c_bus_handle = NULL;
     } else {
         ESP_LOGI(TAG, "I2C bus initialized successfully");
+        i2c_sched_init();    // Touch reads ahead of PMU / sensor traffic
     }
 }
 
@@ -205,116 +459,155 @@ void io_expander_init(void)
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "IO expander init failed (%s) - display power control unavailable", esp_err_to_name(ret));
         expander_handle = NULL;
+        hw_manifest_set(HW_IO_EXPANDER, false, 0);
         return;
     }
     
     ret = esp_io_expander_set_dir(expander_handle, IO_EXPANDER_PIN_NUM_1, IO_EXPANDER_OUTPUT);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "IO expander set_dir failed");
+        hw_manifest_set(HW_IO_EXPANDER, false, 0);
         return;
     }
+#if CONFIG_GOLDIE_LCD_TE_EXPANDER_PIN >= 0
+    if (esp_io_expander_set_dir(expander_handle, 1u << CONFIG_GOLDIE_LCD_TE_EXPANDER_PIN, IO_EXPANDER_INPUT) != ESP_OK) {
+        ESP_LOGW(TAG, "IO expander TE pin not set as input");
+    }
+#endif
     
-    ret = esp_io_expander_set_level(expander_handle, IO_EXPANDER_PIN_NUM_1, 0);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "IO expander set_level(0) failed");
+    // The expander is powered with the board: after a warm reset the panel
+    // supply never dropped, so no power cycle (the panel still gets its reset)
+    bool powered = hw_manifest_had(HW_IO_EXPANDER, NULL);
+    if (!powered) {
+        ret = esp_io_expander_set_level(expander_handle, IO_EXPANDER_PIN_NUM_1, 0);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "IO expander set_level(0) failed");
+        }
+        vTaskDelay(pdMS_TO_TICKS(100));
     }
-    vTaskDelay(pdMS_TO_TICKS(100));
     
     ret = esp_io_expander_set_level(expander_handle, IO_EXPANDER_PIN_NUM_1, 1);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "IO expander set_level(1) failed");
     }
-    vTaskDelay(pdMS_TO_TICKS(100));
+    if (!powered) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    hw_manifest_set(HW_IO_EXPANDER, ret == ESP_OK, 0);
     
-    ESP_LOGI(TAG, "IO expander initialized successfully");
+    ESP_LOGI(TAG, "IO expander initialized successfully%s", powered ? " (warm reset, no power cycle)" : "");
+}
+
+/**
+ * @brief Pick the LVGL draw buffer size and tier from the heap free at boot
+ *
+ * Internal DMA-capable buffers let the SPI driver send straight from the
+ * render buffer; PSRAM buffers (the old setup) stay as the fallback when
+ * internal RAM is short. Both buffers together leave at least
+ * CONFIG_GOLDIE_DISPLAY_DMA_RESERVE_KB of internal RAM for WiFi/TLS.
+ *
+ * @param use_dma Set true if the internal DMA tier was chosen
+ * @return Buffer size in pixels (each of the two buffers)
+ */
+static size_t lv_port_draw_buffer_pixels(bool *use_dma)
+{
+    *use_dma = false;
+#if CONFIG_GOLDIE_DISPLAY_DMA_BUFFERS
+    size_t free_dma = heap_caps_get_free_size(MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    size_t reserve = (size_t)CONFIG_GOLDIE_DISPLAY_DMA_RESERVE_KB * 1024;
+    size_t line_bytes = EXAMPLE_LCD_H_RES * sizeof(lv_color_t);
+
+    size_t lines = free_dma > reserve ? (free_dma - reserve) / (2 * line_bytes) : 0;
+    if (lines > largest / line_bytes) {
+        lines = largest / line_bytes;
+    }
+    if (lines > CONFIG_GOLDIE_DISPLAY_DMA_MAX_LINES) {
+        lines = CONFIG_GOLDIE_DISPLAY_DMA_MAX_LINES;
+    }
+
+    if (lines >= LCD_DMA_MIN_LINES) {
+        *use_dma = true;
+        ESP_LOGI(TAG, "Draw buffers: 2 × %d lines in internal DMA RAM (%d KB free, %d KB reserved)",
+                 (int)lines, (int)(free_dma / 1024), CONFIG_GOLDIE_DISPLAY_DMA_RESERVE_KB);
+        return lines * EXAMPLE_LCD_H_RES;
+    }
+    ESP_LOGW(TAG, "Only %d KB internal DMA RAM free - draw buffers fall back to PSRAM",
+             (int)(free_dma / 1024));
+#endif
+    ESP_LOGI(TAG, "Draw buffers: 2 × %d px in PSRAM", LCD_BUFFER_SIZE);
+    return LCD_BUFFER_SIZE;
 }
 
 void lv_port_init(void)
 {
     lvgl_port_cfg_t port_cfg = ESP_LVGL_PORT_INIT_CONFIG();
-    /* Reduce priority from 4 to 2 to prevent IDLE0 starvation
-     * Priority 2 is sufficient for UI responsiveness while ensuring
-     * IDLE task (priority 0) can run and service the task watchdog */
-    port_cfg.task_priority = 2;
-    port_cfg.task_affinity = 0;  // Pin to Core 0 (explicit)
+    /* Placement comes from the task layout (Kconfig + NVS). Default:
+     * priority 2 instead of the port's 4 to prevent IDLE0 starvation -
+     * sufficient for UI responsiveness while ensuring IDLE task
+     * (priority 0) can run and service the task watchdog - pinned to Core 0 */
+    const task_layout_t *lvgl_layout = task_layout_get(TASK_ID_LVGL);
+    port_cfg.task_priority = lvgl_layout->prio;
+    port_cfg.task_affinity = lvgl_layout->core;  // -1 = no affinity
+    if (lvgl_layout->stack) {
+        port_cfg.task_stack = lvgl_layout->stack;
+    }
     lvgl_port_init(&port_cfg);
     ESP_LOGI(TAG, "Adding LCD screen");
+    bool buff_dma = false;
+    size_t buffer_size = lv_port_draw_buffer_pixels(&buff_dma);
+    
+    // A render benchmark's winner (render_bench.h) overrides the sized default
+    render_cfg_t render;
+    bool have_render = render_cfg_load(EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES, &render);
+    if (have_render) {
+        size_t render_size = (size_t)render.lines * EXAMPLE_LCD_H_RES;
+        if (!render.internal) {
+            buffer_size = render_size;
+            buff_dma = false;
+        } else if (buff_dma && render_size <= buffer_size) {
+            buffer_size = render_size;
+        } else {
+            ESP_LOGW(TAG, "Benchmarked %u internal lines do not fit this boot - sized default kept",
+                     (unsigned)render.lines);
+        }
+        ESP_LOGI(TAG, "Render setup from NVS: %s, %s, %d px per buffer", render_mode_name(render.mode),
+                 buff_dma ? "internal DMA" : "PSRAM", (int)buffer_size);
+    }
+    bool full_refresh = have_render && render.mode == RENDER_MODE_FULL;
+    bool direct_mode = have_render && render.mode == RENDER_MODE_DIRECT;
     lvgl_port_display_cfg_t display_cfg = {
         .io_handle = io_handle,
         .panel_handle = panel_handle,
         .control_handle = NULL,
-        .buffer_size = LCD_BUFFER_SIZE,
-        .double_buffer = true,
+        .buffer_size = (uint32_t)buffer_size,
+        .double_buffer = !direct_mode,     // Direct mode: one screen-sized buffer
         .trans_size = 0,
         .hres = EXAMPLE_LCD_H_RES,
         .vres = EXAMPLE_LCD_V_RES,
         .monochrome = false,
         .rotation = {
-            .swap_xy = 0,
-            .mirror_x = 1,
-            .mirror_y = 0,
+            .swap_xy = PANEL_SWAP_XY,
+            .mirror_x = PANEL_MIRROR_X,
+            .mirror_y = PANEL_MIRROR_Y,
         },
         .flags = {
-            .buff_dma = 0,
-            .buff_spiram = 1,
-            .sw_rotate = 1,
-            .full_refresh = 0,
-            .direct_mode = 0,
+            .buff_dma = buff_dma,
+            .buff_spiram = !buff_dma,
+            .sw_rotate = 0,  // Rotation is done by the ST7796 (MADCTL), not by LVGL
+            .full_refresh = full_refresh,
+            .direct_mode = direct_mode,
         },
     };
 
-#if EXAMPLE_DISPLAY_ROTATION == 90
-    display_cfg.rotation.swap_xy = 1;
-    display_cfg.rotation.mirror_x = 1;
-    display_cfg.rotation.mirror_y = 1;
-#elif EXAMPLE_DISPLAY_ROTATION == 180
-    display_cfg.rotation.swap_xy = 0;
-    display_cfg.rotation.mirror_x = 0;
-    display_cfg.rotation.mirror_y = 1;
-
-#elif EXAMPLE_DISPLAY_ROTATION == 270
-    display_cfg.rotation.swap_xy = 1;
-    display_cfg.rotation.mirror_x = 0;
-    display_cfg.rotation.mirror_y = 0;
-#endif
-
+    // The panel already scans out rotated (boot_splash)
     lvgl_disp = lvgl_port_add_disp(&display_cfg);
+    if (touch_handle == NULL) {
+        return;             // No touch controller (hw_manifest): the indev stays NULL
+    }
     const lvgl_port_touch_cfg_t touch_cfg = {
         .disp = lvgl_disp,
         .handle = touch_handle,
     };
     lvgl_touch_indev = lvgl_port_add_touch(&touch_cfg);
 }
-
-void spiffs_init(void)
-{
-    ESP_LOGI(TAG, "Initializing SPIFFS");
-    
-    esp_vfs_spiffs_conf_t conf = {
-        .base_path = "/spiffs",
-        .partition_label = "storage",
-        .max_files = 5,
-        .format_if_mount_failed = false
-    };
-    
-    esp_err_t ret = esp_vfs_spiffs_register(&conf);
-    
-    if (ret != ESP_OK) {
-        if (ret == ESP_FAIL) {
-            ESP_LOGE(TAG, "Failed to mount or format filesystem");
-        } else if (ret == ESP_ERR_NOT_FOUND) {
-            ESP_LOGE(TAG, "Failed to find SPIFFS partition");
-        } else {
-            ESP_LOGE(TAG, "Failed to initialize SPIFFS (%s)", esp_err_to_name(ret));
-        }
-        return;
-    }
-    
-    size_t total = 0, used = 0;
-    ret = esp_spiffs_info("storage", &total, &used);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to get SPIFFS partition information (%s)", esp_err_to_name(ret));
-    } else {
-        ESP_LOGI(TAG, "SPIFFS: %d KB total, %d KB used", total / 1024, used / 1024);
-    }
-}
\ No newline at end of file
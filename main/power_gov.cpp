@@ -0,0 +1,110 @@
+#include "power_gov.h"
+#include "power_idle.h"
+#include "dashboard.h"
+#include "msg_bus.h"
+#include "ui/ui_inbox.h"
+#include "anim/frame_cache.h"
+#include "anim/frame_pacer.h"
+#include "esp_log.h"
+#include <atomic>
+
+static const char *TAG = "power_gov";
+
+#ifndef CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+#define CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ 240
+#endif
+
+#define GOV_CPU_MHZ(cap)   ((cap) < CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ ? (cap) : CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ)
+#define GOV_SAVER_FPS      (CONFIG_GOLDIE_ANIM_FPS > 1 ? CONFIG_GOLDIE_ANIM_FPS / 2 : 1)
+
+static const power_profile_t profiles[POWER_PROFILE_COUNT] = {
+    // name          fps                     cache  blynk  prefetch  light  cpu
+    { "performance", CONFIG_GOLDIE_ANIM_FPS, 100,   30,    true,     100,   CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ },
+    { "balanced",    CONFIG_GOLDIE_ANIM_FPS, 100,   60,    true,     75,    GOV_CPU_MHZ(160) },
+    { "saver",       GOV_SAVER_FPS,          50,    300,   false,    50,    GOV_CPU_MHZ(80) },
+};
+
+static std::atomic<uint8_t> current{POWER_PROFILE_PERFORMANCE};
+static msg_bus_sub_t *power_sub = NULL;   // MSG_TOPIC_POWER_STATUS -> power_status_handler
+
+/**
+ * @brief Profile for a power reading (hysteresis against `now`)
+ */
+static power_profile_id_t gov_select(const power_status_t *st, power_profile_id_t now)
+{
+    bool on_battery = (st->flags & POWER_FLAG_BATTERY) && !(st->flags & POWER_FLAG_VBUS) && st->batt_pct >= 0;
+    if (!on_battery) {
+        return POWER_PROFILE_PERFORMANCE;
+    }
+    int threshold = CONFIG_GOLDIE_POWER_GOV_SAVER_PCT + (now == POWER_PROFILE_SAVER ? POWER_GOV_HYST_PCT : 0);
+    return st->batt_pct < threshold ? POWER_PROFILE_SAVER : POWER_PROFILE_BALANCED;
+}
+
+static void gov_apply(power_profile_id_t id)
+{
+    const power_profile_t *p = &profiles[id];
+    current.store((uint8_t)id, std::memory_order_release);
+    dashboard_set_pacing(p->anim_fps, (uint32_t)p->blynk_period_s * 1000);
+    power_idle_set_limits(p->backlight_pct, p->cpu_max_mhz);
+    frame_cache_set_share(p->cache_pct);    // Trimmed by storage_task on its next put
+}
+
+/**
+ * @brief Power monitor update: switch profile if the supply or charge call for it
+ */
+static void power_status_handler(void)
+{
+    const msg_bus_msg_t *msg;
+    while ((msg = msg_bus_receive(power_sub, 0)) != NULL) {
+        power_status_t st = *MSG_BUS_PAYLOAD(msg, power_status_t);
+        msg_bus_release(msg);
+
+        power_profile_id_t now = power_gov_current();
+        power_profile_id_t next = gov_select(&st, now);
+        if (next == now) {
+            continue;
+        }
+        gov_apply(next);
+        const power_profile_t *p = &profiles[next];
+        ESP_LOGI(TAG, "Battery %d%%%s - %s: %d FPS, cache %d%%, Blynk every %d s, AI prefetch %s, "
+                 "backlight %d%%, CPU <= %d MHz", st.batt_pct, (st.flags & POWER_FLAG_VBUS) ? " on USB" : "",
+                 p->name, p->anim_fps, p->cache_pct, p->blynk_period_s, p->ai_prefetch ? "on" : "off",
+                 p->backlight_pct, p->cpu_max_mhz);
+    }
+}
+
+static void power_bus_notify(void *arg)
+{
+    ui_inbox_post(UI_MSG_POWER_STATUS);
+}
+
+extern "C" void power_gov_init(void)
+{
+    gov_apply(POWER_PROFILE_PERFORMANCE);
+    if (!CONFIG_GOLDIE_POWER_GOV) {
+        ESP_LOGI(TAG, "Power governor off - %s profile", profiles[POWER_PROFILE_PERFORMANCE].name);
+        return;
+    }
+    ui_inbox_subscribe(UI_MSG_POWER_STATUS, power_status_handler);
+    power_sub = msg_bus_subscribe("power_gov", MSG_TOPIC_POWER_STATUS, 1, MSG_SUB_LATEST, power_bus_notify, NULL);
+    if (power_sub == NULL) {
+        ESP_LOGW(TAG, "No power status subscription - %s profile", profiles[POWER_PROFILE_PERFORMANCE].name);
+        return;
+    }
+    ESP_LOGI(TAG, "Power governor: balanced on battery, saver below %d%%", CONFIG_GOLDIE_POWER_GOV_SAVER_PCT);
+}
+
+extern "C" const power_profile_t *power_gov_profile(void)
+{
+    return &profiles[current.load(std::memory_order_acquire)];
+}
+
+extern "C" power_profile_id_t power_gov_current(void)
+{
+    return (power_profile_id_t)current.load(std::memory_order_acquire);
+}
+
+extern "C" bool power_gov_ai_prefetch(void)
+{
+    return power_gov_profile()->ai_prefetch;
+}
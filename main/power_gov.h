@@ -0,0 +1,85 @@
+#ifndef POWER_GOV_H
+#define POWER_GOV_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "messages.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Power governor - one profile for everything that trades runtime for polish
+//
+// Each profile sets the animation rate, the share of the frame cache budget,
+// the Blynk snapshot period, whether the mood's next AI advice is fetched
+// ahead of time, a backlight cap and a CPU clock cap. The governor picks one
+// from the power monitor's MSG_TOPIC_POWER_STATUS:
+//
+//   PERFORMANCE  on USB, or no battery / gauge
+//   BALANCED     on battery
+//   SAVER        on battery below CONFIG_GOLDIE_POWER_GOV_SAVER_PCT, until
+//                USB returns or the charge is POWER_GOV_HYST_PCT above it
+//
+// and pushes a change to the LVGL-side consumers (dashboard_set_pacing,
+// power_idle_set_limits). The storage and logic tasks read theirs when they
+// need it: frame_cache_set_share() is applied on the next put, the AI
+// prefetch is checked before each one is queued.
+//
+// Without CONFIG_GOLDIE_POWER_GOV (or without the power monitor) it stays
+// on PERFORMANCE, which is the configured behaviour with no caps.
+//
+// power_gov_profile() / power_gov_ai_prefetch(): any task. The rest: LVGL
+// context.
+
+#ifndef CONFIG_GOLDIE_POWER_GOV
+#define CONFIG_GOLDIE_POWER_GOV 0
+#endif
+#ifndef CONFIG_GOLDIE_POWER_GOV_SAVER_PCT
+#define CONFIG_GOLDIE_POWER_GOV_SAVER_PCT 20
+#endif
+
+#define POWER_GOV_HYST_PCT    5       // Charge above the saver threshold to leave it
+
+typedef enum {
+    POWER_PROFILE_PERFORMANCE = 0,
+    POWER_PROFILE_BALANCED,
+    POWER_PROFILE_SAVER,
+    POWER_PROFILE_COUNT
+} power_profile_id_t;
+
+typedef struct {
+    const char *name;
+    uint8_t anim_fps;               // Animation frame rate
+    uint8_t cache_pct;              // Share of CONFIG_GOLDIE_FRAME_CACHE_KB
+    uint16_t blynk_period_s;        // Blynk / LAN live snapshot period
+    bool ai_prefetch;               // Fetch the next mood's advice ahead of time
+    uint8_t backlight_pct;          // Share of the configured backlight level
+    uint16_t cpu_max_mhz;           // CPU clock cap (PM locks included)
+} power_profile_t;
+
+/**
+ * @brief Subscribe to the power status and apply the boot profile
+ *
+ * After dashboard_init() and power_idle_init(), LVGL lock held.
+ */
+void power_gov_init(void);
+
+/**
+ * @brief Profile in force (any task)
+ */
+const power_profile_t *power_gov_profile(void);
+
+power_profile_id_t power_gov_current(void);
+
+/**
+ * @brief Whether AI prefetches may be queued now (any task)
+ */
+bool power_gov_ai_prefetch(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POWER_GOV_H
@@ -0,0 +1,252 @@
+#include "power_idle.h"
+#include "dashboard.h"
+#include "esp_3inch5_lcd_port.h"
+#include "i2c_sched.h"
+#include "esp_lvgl_port.h"
+#include "task_layout.h"
+#include "evt_trace.h"
+#include "ui/ui_latency.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#if CONFIG_PM_ENABLE
+#include "esp_pm.h"
+#endif
+
+static const char *TAG = "power_idle";
+
+// All state below is touched with the LVGL lock held
+static lv_disp_t *idle_disp = NULL;
+static void (*touch_read)(lv_indev_drv_t *drv, lv_indev_data_t *data) = NULL;   // The port's reader
+static uint8_t base_brightness = 80;      // power_idle_init()'s level
+static uint8_t active_brightness = 80;    // After the power profile's cap
+static uint16_t cpu_cap_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+static bool idle = false;
+static bool wake_pending = false;
+static bool swallow_press = false;        // The waking touch, until released
+static bool was_pressed = false;          // Last reading, for the trace's press / release events
+#if CONFIG_GOLDIE_PM_DFS
+static esp_pm_lock_handle_t ui_boost = NULL;  // Full CPU clock while touched / scrolling
+static bool ui_boosted = false;
+#endif
+
+/**
+ * @brief Clock floor and light sleep for the current state
+ *
+ * Awake: CONFIG_GOLDIE_PM_MIN_FREQ_MHZ with DFS (PM locks raise it to full
+ * speed for touch and jobs), else full speed. Idle: the crystal clock and,
+ * if enabled, light sleep. Full speed is the power profile's cap.
+ */
+static void idle_pm_configure(bool idle_now)
+{
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t pm = {};
+    pm.max_freq_mhz = cpu_cap_mhz;
+    pm.min_freq_mhz = CONFIG_GOLDIE_PM_DFS ? CONFIG_GOLDIE_PM_MIN_FREQ_MHZ : cpu_cap_mhz;
+    if (pm.min_freq_mhz > pm.max_freq_mhz) {
+        pm.min_freq_mhz = pm.max_freq_mhz;
+    }
+    if (idle_now && (CONFIG_GOLDIE_PM_DFS || CONFIG_GOLDIE_IDLE_LIGHT_SLEEP)) {
+        pm.min_freq_mhz = CONFIG_XTAL_FREQ;
+    }
+    pm.light_sleep_enable = idle_now && CONFIG_GOLDIE_IDLE_LIGHT_SLEEP;
+    esp_err_t err = esp_pm_configure(&pm);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "esp_pm_configure failed (%s) - fixed CPU clock", esp_err_to_name(err));
+    }
+#else
+    (void)idle_now;
+#endif
+}
+
+/**
+ * @brief Hold full CPU speed from a press until the UI has been still for POWER_UI_BOOST_MS
+ */
+static void ui_boost_update(bool pressed)
+{
+#if CONFIG_GOLDIE_PM_DFS
+    if (ui_boost == NULL) {
+        return;
+    }
+    bool want = pressed || lv_disp_get_inactive_time(idle_disp) < POWER_UI_BOOST_MS;
+    if (want && !ui_boosted) {
+        esp_pm_lock_acquire(ui_boost);
+    } else if (!want && ui_boosted) {
+        esp_pm_lock_release(ui_boost);
+    }
+    ui_boosted = want;
+#else
+    (void)pressed;
+#endif
+}
+
+/**
+ * @brief Touch reader wrapper: a press while idle wakes instead of clicking
+ */
+static void idle_touch_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
+{
+    // With the INT line the panel is only read once it signalled a touch,
+    // and then until the release; LVGL keeps the last point otherwise
+    bool has_int = esp_3inch5_touch_port_has_int();
+    if (!has_int || was_pressed || esp_3inch5_touch_port_take_int()) {
+        i2c_sched_begin(I2C_SCHED_TOUCH, portMAX_DELAY);   // Ahead of PMU / sensor reads
+        touch_read(drv, data);
+        i2c_sched_end(I2C_SCHED_TOUCH);
+        if (has_int && data->state != LV_INDEV_STATE_PRESSED) {
+            esp_3inch5_touch_port_rearm_int();
+        }
+    } else {
+        data->state = LV_INDEV_STATE_RELEASED;
+    }
+    bool pressed = data->state == LV_INDEV_STATE_PRESSED;
+    if (pressed != was_pressed) {
+        was_pressed = pressed;
+        EVT_TRACE_INSTANT(pressed ? "touch_down" : "touch_up",
+                          ((uint32_t)data->point.x << 16) | (uint16_t)data->point.y);
+        if (pressed) {
+            ui_latency_arm_screen(UI_LATENCY_TOUCH_TO_SCREEN, esp_timer_get_time());
+        }
+    }
+    ui_boost_update(data->state == LV_INDEV_STATE_PRESSED && !idle);
+    if (data->state != LV_INDEV_STATE_PRESSED) {
+        swallow_press = false;
+        return;
+    }
+    if (idle) {
+        wake_pending = true;
+        swallow_press = true;
+    }
+    if (swallow_press) {
+        data->state = LV_INDEV_STATE_RELEASED;
+    }
+}
+
+static void idle_leave(void)
+{
+    idle = false;
+    wake_pending = false;
+    esp_3inch5_brightness_port_set(active_brightness);
+    dashboard_set_idle(false);
+    lv_disp_trig_activity(idle_disp);
+}
+
+/**
+ * @brief Drives LVGL at the idle rate until a touch wakes the device
+ *
+ * The port's tick is stopped and LVGL's timers are disabled between polls,
+ * so the port task only wakes every task_max_sleep_ms and the chip can
+ * light-sleep in between.
+ */
+static void idle_task(void *arg)
+{
+    int64_t last_us = esp_timer_get_time();
+    bool awake = false;
+    while (!awake) {
+        // A wired touch INT ends the wait (and light sleep) at once
+        esp_3inch5_touch_port_wait_int(pdMS_TO_TICKS(CONFIG_GOLDIE_IDLE_POLL_MS));
+        int64_t now = esp_timer_get_time();
+        uint32_t ms = (uint32_t)((now - last_us) / 1000);
+        last_us += (int64_t)ms * 1000;
+
+        lvgl_port_lock(0);
+        lv_timer_enable(true);
+        lv_tick_inc(ms);
+        lv_timer_handler();    // Touch read (may wake), due timers, dirty areas
+        lv_timer_enable(false);
+        if (wake_pending) {
+            idle_leave();
+            awake = true;
+        }
+        lvgl_port_unlock();
+    }
+
+    idle_pm_configure(false);
+    lvgl_port_resume();    // Tick and timers back
+    ESP_LOGI(TAG, "Touch - awake");
+    vTaskDelete(NULL);
+}
+
+static void idle_check_cb(lv_timer_t *timer)
+{
+    if (idle || lv_disp_get_inactive_time(idle_disp) < (uint32_t)CONFIG_GOLDIE_IDLE_DIM_S * 1000) {
+        return;
+    }
+
+    const task_layout_t *lvgl_layout = task_layout_get(TASK_ID_LVGL);
+    if (xTaskCreatePinnedToCore(idle_task, "power_idle", POWER_IDLE_STACK, NULL, lvgl_layout->prio, NULL,
+                                lvgl_layout->core < 0 ? tskNO_AFFINITY : lvgl_layout->core) != pdPASS) {
+        ESP_LOGW(TAG, "No idle task - staying awake");
+        lv_disp_trig_activity(idle_disp);    // Retry after another idle period
+        return;
+    }
+    // The task waits for the lock, held here until this handler returns
+    idle = true;
+    wake_pending = false;
+    esp_3inch5_brightness_port_set(CONFIG_GOLDIE_IDLE_BRIGHTNESS);
+    dashboard_set_idle(true);
+    lvgl_port_stop();
+    idle_pm_configure(true);
+    ESP_LOGI(TAG, "No touch for %d s - dimmed, polling every %d ms%s", CONFIG_GOLDIE_IDLE_DIM_S,
+             CONFIG_GOLDIE_IDLE_POLL_MS, CONFIG_GOLDIE_IDLE_LIGHT_SLEEP ? ", light sleep" : "");
+}
+
+extern "C" void power_idle_init(lv_disp_t *disp, lv_indev_t *touch, uint8_t brightness)
+{
+    base_brightness = brightness;
+    active_brightness = brightness;
+    idle_pm_configure(false);
+    if (disp == NULL || touch == NULL || touch->driver->read_cb == NULL) {
+        ESP_LOGW(TAG, "No touch input - idle mode and UI clock boost off");
+        return;
+    }
+    idle_disp = disp;
+    touch_read = touch->driver->read_cb;
+    touch->driver->read_cb = idle_touch_read;
+#if CONFIG_GOLDIE_PM_DFS
+    if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "ui", &ui_boost) != ESP_OK) {
+        ui_boost = NULL;
+    }
+    ESP_LOGI(TAG, "CPU %d-%d MHz, full speed for touch, scrolling and jobs", CONFIG_GOLDIE_PM_MIN_FREQ_MHZ,
+             CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+#endif
+
+    if (CONFIG_GOLDIE_IDLE_DIM_S == 0) {
+        ESP_LOGI(TAG, "Idle mode off");
+        return;
+    }
+    lv_timer_create(idle_check_cb, POWER_IDLE_CHECK_MS, NULL);
+    ESP_LOGI(TAG, "Idle after %d s: backlight %d%%, %s %d ms%s", CONFIG_GOLDIE_IDLE_DIM_S,
+             CONFIG_GOLDIE_IDLE_BRIGHTNESS, esp_3inch5_touch_port_has_int() ? "wake on touch INT, redraw" : "touch poll",
+             CONFIG_GOLDIE_IDLE_POLL_MS, CONFIG_GOLDIE_IDLE_LIGHT_SLEEP ? ", light sleep" : "");
+}
+
+extern "C" void power_idle_poke(void)
+{
+    if (idle_disp == NULL) {
+        return;
+    }
+    if (idle) {
+        wake_pending = true;      // The idle task leaves on its next poll
+    } else {
+        lv_disp_trig_activity(idle_disp);
+    }
+}
+
+extern "C" void power_idle_set_limits(uint8_t backlight_pct, uint16_t cpu_max_mhz)
+{
+    active_brightness = (uint8_t)((uint32_t)base_brightness * backlight_pct / 100);
+    if (cpu_max_mhz == 0 || cpu_max_mhz > CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ) {
+        cpu_max_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+    }
+    cpu_cap_mhz = cpu_max_mhz;
+    if (!idle) {                          // Idle has its own level and clock; idle_leave() applies these
+        esp_3inch5_brightness_port_set(active_brightness);
+        idle_pm_configure(false);
+    }
+}
+
+extern "C" bool power_idle_is_idle(void)
+{
+    return idle;
+}
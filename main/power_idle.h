@@ -0,0 +1,88 @@
+#ifndef POWER_IDLE_H
+#define POWER_IDLE_H
+
+#include <stdint.h>
+#include "lvgl.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Power idle - dim, slow down and light-sleep while nobody touches the screen
+//
+// After CONFIG_GOLDIE_IDLE_DIM_S without touch input the backlight drops to
+// CONFIG_GOLDIE_IDLE_BRIGHTNESS, the animation pauses and LVGL stops its
+// own 5 ms tick: a short-lived idle task polls the touch panel and redraws
+// whatever changed every CONFIG_GOLDIE_IDLE_POLL_MS instead. With
+// CONFIG_GOLDIE_IDLE_LIGHT_SLEEP the power manager then light-sleeps the
+// chip between those polls and the storage, logic and network jobs (WiFi
+// is in modem sleep between net_sched windows).
+//
+// With CONFIG_GOLDIE_PM_DFS the clock floor outside idle mode is
+// CONFIG_GOLDIE_PM_MIN_FREQ_MHZ: a touch holds a CPU_FREQ_MAX PM lock
+// until the UI has been still for POWER_UI_BOOST_MS (scroll momentum
+// included), and coordinator jobs hold their own (job_watch.h).
+//
+// The stock board leaves the FT6336 interrupt line unwired, so wake-up is
+// the next touch poll. With the line on CONFIG_GOLDIE_TOUCH_INT_GPIO the
+// touch wakes the idle task (and light sleep) at once, and outside idle the
+// panel is only read over I2C between its interrupt and the release. The
+// waking touch only brings the screen back; it does not reach the widget
+// under the finger.
+
+#ifndef CONFIG_GOLDIE_IDLE_DIM_S
+#define CONFIG_GOLDIE_IDLE_DIM_S 60
+#endif
+#ifndef CONFIG_GOLDIE_IDLE_BRIGHTNESS
+#define CONFIG_GOLDIE_IDLE_BRIGHTNESS 10
+#endif
+#ifndef CONFIG_GOLDIE_IDLE_POLL_MS
+#define CONFIG_GOLDIE_IDLE_POLL_MS 100
+#endif
+#ifndef CONFIG_GOLDIE_IDLE_LIGHT_SLEEP
+#define CONFIG_GOLDIE_IDLE_LIGHT_SLEEP 0
+#endif
+#ifndef CONFIG_GOLDIE_PM_DFS
+#define CONFIG_GOLDIE_PM_DFS 0
+#endif
+#ifndef CONFIG_GOLDIE_PM_MIN_FREQ_MHZ
+#define CONFIG_GOLDIE_PM_MIN_FREQ_MHZ 80
+#endif
+
+#define POWER_IDLE_CHECK_MS  1000
+#define POWER_IDLE_STACK     8192     // Bytes; LVGL renders on it while idle
+#define POWER_UI_BOOST_MS    1000     // Full clock after the last touch
+
+/**
+ * @brief Start watching for inactivity (after lv_port_init, LVGL lock held)
+ * @param disp Display whose inactivity counts
+ * @param touch Touch input that wakes the device
+ * @param brightness Backlight level (0..100) outside idle
+ */
+void power_idle_init(lv_disp_t *disp, lv_indev_t *touch, uint8_t brightness);
+
+/**
+ * @brief Count as user activity: wake from idle mode, or postpone it (LVGL lock held)
+ *
+ * For inputs other than the touch panel, e.g. a tap on the case (imu_gesture.h).
+ */
+void power_idle_poke(void);
+
+/**
+ * @brief Caps of the power profile (power_gov.h), LVGL lock held
+ * @param backlight_pct Share of power_idle_init()'s brightness outside idle
+ * @param cpu_max_mhz Full-speed clock, for touch and job PM locks too
+ */
+void power_idle_set_limits(uint8_t backlight_pct, uint16_t cpu_max_mhz);
+
+/**
+ * @brief true while dimmed (LVGL lock held)
+ */
+bool power_idle_is_idle(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POWER_IDLE_H
@@ -0,0 +1,148 @@
+#include "power_monitor.h"
+#include "esp_axp2101_port.h"
+#include "msg_bus.h"
+#include "task_layout.h"
+#include "co_exec.h"
+#include "job_watch.h"
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "time_svc.h"
+#include <stdlib.h>
+
+static const char *TAG = "power_monitor";
+
+static CoSignal pmu_irq;
+static portMUX_TYPE status_lock = portMUX_INITIALIZER_UNLOCKED;
+static power_status_t status = {};
+static bool status_valid = false;
+
+static void pmu_irq_isr(void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    pmu_irq.give_from_isr(&woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+/**
+ * @brief IRQ line on a GPIO (open drain, low while an event is pending)
+ * @return false: poll the status register instead
+ */
+static bool pmu_irq_init(void)
+{
+    if (CONFIG_GOLDIE_PMU_IRQ_GPIO < 0) {
+        return false;
+    }
+    const gpio_num_t pin = (gpio_num_t)CONFIG_GOLDIE_PMU_IRQ_GPIO;
+    gpio_config_t io_conf = {};
+    io_conf.pin_bit_mask = 1ULL << pin;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
+    io_conf.intr_type = GPIO_INTR_NEGEDGE;
+    esp_err_t err = gpio_config(&io_conf);
+    if (err == ESP_OK) {
+        err = gpio_install_isr_service(0);
+        if (err == ESP_ERR_INVALID_STATE) {
+            err = ESP_OK;         // Already installed by another driver
+        }
+    }
+    if (err == ESP_OK) {
+        err = gpio_isr_handler_add(pin, pmu_irq_isr, NULL);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "PMU IRQ on GPIO %d failed (%s) - polling", (int)pin, esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Read the PMU; publish if the state moved since the last publish
+ */
+static void refresh(bool force)
+{
+    pmu_reading_t r;
+    job_watch_begin(TASK_ID_CO_EXEC, "pmu_read", POWER_MON_READ_MS);
+    esp_err_t err = esp_axp2101_port_read(&r);
+    job_watch_end(TASK_ID_CO_EXEC);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "PMU read failed (%s)", esp_err_to_name(err));
+        return;
+    }
+
+    power_status_t now = {};
+    now.batt_mv = r.batt_mv;
+    now.vbus_mv = r.vbus_mv;
+    now.batt_pct = r.batt_pct;
+    now.flags = (r.batt_present ? POWER_FLAG_BATTERY : 0) | (r.charging ? POWER_FLAG_CHARGING : 0) |
+                (r.vbus_in ? POWER_FLAG_VBUS : 0);
+    now.timestamp = time_svc_uptime_s();
+
+    static power_status_t published = {};
+    bool moved = force || now.flags != published.flags || now.batt_pct != published.batt_pct ||
+                 abs((int)now.batt_mv - (int)published.batt_mv) >= POWER_MON_MV_STEP;
+
+    portENTER_CRITICAL(&status_lock);
+    status = now;
+    status_valid = true;
+    portEXIT_CRITICAL(&status_lock);
+
+    if (!moved) {
+        return;
+    }
+    if (now.flags != published.flags || force) {
+        ESP_LOGI(TAG, "Battery %d%% %u mV%s%s", now.batt_pct, now.batt_mv,
+                 (now.flags & POWER_FLAG_CHARGING) ? ", charging" : "",
+                 (now.flags & POWER_FLAG_VBUS) ? ", on USB" : "");
+    }
+    published = now;
+    msg_bus_publish(MSG_TOPIC_POWER_STATUS, &now, sizeof(now));
+}
+
+static CoTask power_loop(void)
+{
+    bool irq_line = pmu_irq_init();
+    pmu_isr_handler();            // Drop events from before the monitor ran
+    refresh(true);
+    while (true) {
+        bool on_usb = (status.flags & POWER_FLAG_VBUS) != 0;
+        TickType_t period = pdMS_TO_TICKS((on_usb ? CONFIG_GOLDIE_POWER_POLL_USB_S : CONFIG_GOLDIE_POWER_POLL_BATT_S) * 1000);
+        if (irq_line) {
+            co_await pmu_irq.wait(period);
+        } else {
+            co_await CoDelay(period);
+        }
+        // Without the line this still catches what happened in between
+        uint32_t events = pmu_isr_handler();
+        refresh((events & (PMU_EVT_VBUS | PMU_EVT_BATTERY | PMU_EVT_CHARGE)) != 0);
+    }
+}
+
+bool power_monitor_start(void)
+{
+    pmu_reading_t probe;
+    if (esp_axp2101_port_read(&probe) != ESP_OK) {
+        ESP_LOGW(TAG, "No PMU - power monitor off");
+        return false;
+    }
+    if (!co_exec_spawn(power_loop())) {
+        ESP_LOGE(TAG, "Failed to start the power monitor coroutine");
+        return false;
+    }
+    ESP_LOGI(TAG, "Power monitor: %s, re-read every %d s on battery / %d s on USB",
+             CONFIG_GOLDIE_PMU_IRQ_GPIO >= 0 ? "PMU IRQ driven" : "polled", CONFIG_GOLDIE_POWER_POLL_BATT_S,
+             CONFIG_GOLDIE_POWER_POLL_USB_S);
+    return true;
+}
+
+bool power_monitor_get(power_status_t *out)
+{
+    portENTER_CRITICAL(&status_lock);
+    bool valid = status_valid;
+    *out = status;
+    portEXIT_CRITICAL(&status_lock);
+    return valid;
+}
@@ -0,0 +1,58 @@
+#ifndef POWER_MONITOR_H
+#define POWER_MONITOR_H
+
+#include <stdbool.h>
+#include "messages.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Power monitor - battery and supply state, read once and shared
+//
+// One coroutine on the shared executor (co_exec.h) owns the AXP2101's
+// telemetry: it reads battery voltage, fuel gauge, charge state and VBUS,
+// caches the result (power_monitor_get, esp_axp2101_port_latest for the
+// UI) and publishes it on MSG_TOPIC_POWER_STATUS when it moved - a supply or
+// charge change, a gauge step, or POWER_MON_MV_STEP of battery voltage.
+//
+// Updates are driven by the PMU's interrupts (pmu_isr_handler): with its
+// IRQ line on CONFIG_GOLDIE_PMU_IRQ_GPIO a plug, unplug or charge event
+// is read at once. Between events, and without the line, the state is
+// re-read every CONFIG_GOLDIE_POWER_POLL_BATT_S on battery and only every
+// CONFIG_GOLDIE_POWER_POLL_USB_S on USB, where it barely moves.
+//
+// Battery-aware policies subscribe to the topic; the power governor
+// (power_gov.h) turns it into one performance / balanced / saver profile.
+
+#ifndef CONFIG_GOLDIE_PMU_IRQ_GPIO
+#define CONFIG_GOLDIE_PMU_IRQ_GPIO -1
+#endif
+#ifndef CONFIG_GOLDIE_POWER_POLL_BATT_S
+#define CONFIG_GOLDIE_POWER_POLL_BATT_S 30
+#endif
+#ifndef CONFIG_GOLDIE_POWER_POLL_USB_S
+#define CONFIG_GOLDIE_POWER_POLL_USB_S 300
+#endif
+
+#define POWER_MON_MV_STEP     50      // Battery voltage change worth publishing
+#define POWER_MON_READ_MS     200     // job_watch deadline of one read
+
+/**
+ * @brief Start monitoring (after task_coordinator_init and the PMU)
+ * @return false without a PMU
+ */
+bool power_monitor_start(void);
+
+/**
+ * @brief Last reading (any task)
+ * @return false before the first one
+ */
+bool power_monitor_get(power_status_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POWER_MONITOR_H
@@ -0,0 +1,348 @@
+#include "probe_adc.h"
+#include "esp_adc/adc_continuous.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "probe_adc";
+
+#define PROBE_ADC_ATTEN      ADC_ATTEN_DB_12
+#define PROBE_ADC_FULL_MV    3100.0f       // No eFuse calibration: rough 12 dB full scale
+#define PROBE_ADC_RAW_MAX    ((1 << SOC_ADC_DIGI_MAX_BITWIDTH) - 1)
+
+typedef struct {
+    const char *name;
+    sensor_param_t param;
+    adc_channel_t channel;
+    adc_cali_handle_t cali;               // NULL: PROBE_ADC_FULL_MV scale
+    probe_curve_t curve;
+    float last_mv;                        // NAN before the first reading
+    uint32_t blk_sum;                     // Block being summed (ISR)
+    uint32_t blk_n;
+    uint32_t block[PROBE_ADC_BLOCKS];     // Sums of the last whole blocks, a ring (ISR)
+    uint8_t head;                         // Next block[] entry
+    uint8_t blocks;                       // Whole blocks since the last read
+} probe_t;
+
+static probe_t probes[PROBE_ADC_MAX];
+static uint8_t probe_count = 0;
+static int8_t probe_of[SOC_ADC_CHANNEL_NUM(ADC_UNIT_1)];   // Channel -> probe, -1 = none
+static adc_continuous_handle_t unit = NULL;
+static bool running = false;
+static uint32_t block_len = 1;            // Results per block (set before the unit starts)
+static portMUX_TYPE acc_lock = portMUX_INITIALIZER_UNLOCKED;     // Blocks
+static portMUX_TYPE curve_lock = portMUX_INITIALIZER_UNLOCKED;   // curve / last_mv
+
+static bool curve_valid(const probe_curve_t *c)
+{
+    if (c == NULL || c->count < 2 || c->count > PROBE_ADC_CURVE_POINTS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < c->count; i++) {
+        if (!isfinite(c->mv[i]) || !isfinite(c->value[i]) || (i > 0 && c->mv[i] <= c->mv[i - 1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static float curve_eval(const probe_curve_t *c, float mv)
+{
+    // Segment containing mv; the end segments extend past the ends
+    uint8_t i = 1;
+    while (i < c->count - 1 && mv > c->mv[i]) {
+        i++;
+    }
+    float t = (mv - c->mv[i - 1]) / (c->mv[i] - c->mv[i - 1]);
+    return c->value[i - 1] + t * (c->value[i] - c->value[i - 1]);
+}
+
+/**
+ * @brief Mean raw code to millivolts, keeping the oversampled fraction
+ */
+static float raw_to_mv(const probe_t *p, float raw)
+{
+    if (p->cali == NULL) {
+        return raw * PROBE_ADC_FULL_MV / PROBE_ADC_RAW_MAX;
+    }
+    int lo = (int)raw;
+    int hi = lo < PROBE_ADC_RAW_MAX ? lo + 1 : lo;
+    int mv_lo = 0, mv_hi = 0;
+    if (adc_cali_raw_to_voltage(p->cali, lo, &mv_lo) != ESP_OK ||
+        adc_cali_raw_to_voltage(p->cali, hi, &mv_hi) != ESP_OK) {
+        return raw * PROBE_ADC_FULL_MV / PROBE_ADC_RAW_MAX;
+    }
+    return (float)mv_lo + (raw - (float)lo) * (float)(mv_hi - mv_lo);
+}
+
+/**
+ * @brief One DMA frame: add each result to its probe's block (ISR)
+ */
+static bool IRAM_ATTR on_conv_done(adc_continuous_handle_t handle, const adc_continuous_evt_data_t *edata,
+                                   void *user_data)
+{
+    const uint8_t *buf = edata->conv_frame_buffer;
+    portENTER_CRITICAL_ISR(&acc_lock);
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= edata->size; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_output_data_t *d = (const adc_digi_output_data_t *)(buf + i);
+        uint32_t ch = d->type2.channel;
+        if (ch < SOC_ADC_CHANNEL_NUM(ADC_UNIT_1) && probe_of[ch] >= 0) {
+            probe_t *p = &probes[probe_of[ch]];
+            p->blk_sum += d->type2.data;
+            if (++p->blk_n == block_len) {
+                p->block[p->head] = p->blk_sum;
+                p->head = (uint8_t)((p->head + 1) % PROBE_ADC_BLOCKS);
+                if (p->blocks < PROBE_ADC_BLOCKS) {
+                    p->blocks++;
+                }
+                p->blk_sum = 0;
+                p->blk_n = 0;
+            }
+        }
+    }
+    portEXIT_CRITICAL_ISR(&acc_lock);
+    return false;
+}
+
+static void curve_load(probe_t *p)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(PROBE_ADC_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+        return;
+    }
+    probe_curve_t stored;
+    size_t len = sizeof(stored);
+    if (nvs_get_blob(nvs, p->name, &stored, &len) == ESP_OK && len == sizeof(stored)) {
+        if (curve_valid(&stored)) {
+            p->curve = stored;
+            ESP_LOGI(TAG, "%s: stored %u-point curve", p->name, stored.count);
+        } else {
+            ESP_LOGW(TAG, "%s: stored curve invalid - using the default", p->name);
+        }
+    }
+    nvs_close(nvs);
+}
+
+/**
+ * @brief Start ADC1 over every registered channel (first probe's init)
+ */
+static esp_err_t unit_start(void)
+{
+    // The channels share the rate; one read period makes PROBE_ADC_BLOCKS blocks
+    uint32_t per_read = (uint32_t)((uint64_t)CONFIG_GOLDIE_PROBE_ADC_RATE_HZ *
+                                   CONFIG_GOLDIE_PROBE_ADC_PERIOD_MS / 1000 / probe_count);
+    block_len = per_read >= PROBE_ADC_BLOCKS ? per_read / PROBE_ADC_BLOCKS : 1;
+
+    adc_continuous_handle_cfg_t handle_cfg = {};
+    handle_cfg.max_store_buf_size = PROBE_ADC_POOL_BYTES;
+    handle_cfg.conv_frame_size = PROBE_ADC_FRAME_BYTES;
+    handle_cfg.flags.flush_pool = 1;        // Results are taken in the callback
+    esp_err_t err = adc_continuous_new_handle(&handle_cfg, &unit);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    adc_digi_pattern_config_t pattern[PROBE_ADC_MAX] = {};
+    for (uint8_t i = 0; i < probe_count; i++) {
+        pattern[i].atten = PROBE_ADC_ATTEN;
+        pattern[i].channel = probes[i].channel;
+        pattern[i].unit = ADC_UNIT_1;
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+    adc_continuous_config_t dig_cfg = {};
+    dig_cfg.pattern_num = probe_count;
+    dig_cfg.adc_pattern = pattern;
+    dig_cfg.sample_freq_hz = CONFIG_GOLDIE_PROBE_ADC_RATE_HZ;
+    dig_cfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    dig_cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+    adc_continuous_evt_cbs_t cbs = {};
+    cbs.on_conv_done = on_conv_done;
+    err = adc_continuous_config(unit, &dig_cfg);
+    if (err == ESP_OK) {
+        err = adc_continuous_register_event_callbacks(unit, &cbs, NULL);
+    }
+    if (err == ESP_OK) {
+        err = adc_continuous_start(unit);
+    }
+    if (err != ESP_OK) {
+        adc_continuous_deinit(unit);
+        unit = NULL;
+        return err;
+    }
+    ESP_LOGI(TAG, "ADC1 continuous: %u channel(s) at %d Hz, %d-byte DMA frames, %lu-result blocks",
+             probe_count, CONFIG_GOLDIE_PROBE_ADC_RATE_HZ, PROBE_ADC_FRAME_BYTES, (unsigned long)block_len);
+    return ESP_OK;
+}
+
+static esp_err_t probe_init(void *ctx)
+{
+    probe_t *p = (probe_t *)ctx;
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+    adc_cali_curve_fitting_config_t cali_cfg = {};
+    cali_cfg.unit_id = ADC_UNIT_1;
+    cali_cfg.chan = p->channel;
+    cali_cfg.atten = PROBE_ADC_ATTEN;
+    cali_cfg.bitwidth = ADC_BITWIDTH_DEFAULT;
+    if (adc_cali_create_scheme_curve_fitting(&cali_cfg, &p->cali) != ESP_OK) {
+        p->cali = NULL;
+    }
+#endif
+    if (p->cali == NULL) {
+        ESP_LOGW(TAG, "%s: no eFuse calibration - voltages are approximate", p->name);
+    }
+    curve_load(p);
+    if (running) {
+        return ESP_OK;
+    }
+    esp_err_t err = unit_start();
+    running = err == ESP_OK;
+    return err;
+}
+
+/**
+ * @brief Filter the blocks decimated since the last read into one reading
+ *
+ * Interquartile mean: the block sums are sorted and the middle half is
+ * averaged. A pump or heater switching on or off puts a spike into the
+ * one or two blocks it lands in; those sort to the ends and are dropped,
+ * where a plain mean over the period would carry a share of the spike.
+ * A block still being summed waits for the next read.
+ */
+static esp_err_t probe_read(void *ctx, float *value)
+{
+    probe_t *p = (probe_t *)ctx;
+    uint32_t block[PROBE_ADC_BLOCKS];
+    portENTER_CRITICAL(&acc_lock);
+    uint8_t n = p->blocks;
+    for (uint8_t i = 0; i < n; i++) {
+        block[i] = p->block[(p->head + PROBE_ADC_BLOCKS - n + i) % PROBE_ADC_BLOCKS];
+    }
+    p->blocks = 0;
+    portEXIT_CRITICAL(&acc_lock);
+    if (n == 0) {
+        return ESP_ERR_TIMEOUT;             // No whole block since the last read
+    }
+    for (uint8_t i = 1; i < n; i++) {
+        uint32_t v = block[i];
+        uint8_t j = i;
+        for (; j > 0 && block[j - 1] > v; j--) {
+            block[j] = block[j - 1];
+        }
+        block[j] = v;
+    }
+    uint8_t lo = n / 4;
+    uint8_t hi = n - n / 4;
+    uint64_t sum = 0;
+    for (uint8_t i = lo; i < hi; i++) {
+        sum += block[i];
+    }
+    float mv = raw_to_mv(p, (float)((double)sum / ((double)(hi - lo) * block_len)));
+    portENTER_CRITICAL(&curve_lock);
+    p->last_mv = mv;
+    *value = curve_eval(&p->curve, mv);
+    portEXIT_CRITICAL(&curve_lock);
+    return ESP_OK;
+}
+
+static probe_t *find(sensor_param_t param)
+{
+    for (uint8_t i = 0; i < probe_count; i++) {
+        if (probes[i].param == param) {
+            return &probes[i];
+        }
+    }
+    return NULL;
+}
+
+bool probe_adc_register(const char *name, sensor_param_t param, adc_channel_t channel, float deadband,
+                        const probe_curve_t *fallback)
+{
+    if (probe_count == 0) {
+        memset(probe_of, -1, sizeof(probe_of));
+    }
+    if (running || probe_count >= PROBE_ADC_MAX || (int)channel < 0 ||
+        (int)channel >= SOC_ADC_CHANNEL_NUM(ADC_UNIT_1) || probe_of[channel] >= 0 ||
+        find(param) != NULL || !curve_valid(fallback)) {
+        ESP_LOGE(TAG, "Cannot register %s on ADC1 channel %d", name, (int)channel);
+        return false;
+    }
+    probe_t *p = &probes[probe_count];
+    memset(p, 0, sizeof(*p));
+    p->name = name;
+    p->param = param;
+    p->channel = channel;
+    p->curve = *fallback;
+    p->last_mv = NAN;
+
+    sensor_driver_t drv = {
+        .name = name,
+        .param = param,
+        .period_ms = CONFIG_GOLDIE_PROBE_ADC_PERIOD_MS,
+        .deadband = deadband,
+        .init = probe_init,
+        .read = probe_read,
+        .ctx = p,
+    };
+    if (!sensor_acq_register(&drv)) {
+        return false;
+    }
+    probe_of[channel] = (int8_t)probe_count++;
+    return true;
+}
+
+void probe_adc_register_config(void)
+{
+#if CONFIG_GOLDIE_PROBE_ADC_PH_CHANNEL >= 0
+    // Common pH amplifier boards: 1500 mV at pH 7, about 2030 mV at pH 4
+    // (a two-point calibration in NVS replaces it)
+    static const probe_curve_t ph_default = {
+        { 1500.0f, 2032.0f }, { 7.0f, 4.0f }, 2,
+    };
+    probe_adc_register("ph", SENSOR_PH, (adc_channel_t)CONFIG_GOLDIE_PROBE_ADC_PH_CHANNEL, 0.05f, &ph_default);
+#endif
+}
+
+esp_err_t probe_adc_set_curve(sensor_param_t param, const probe_curve_t *curve)
+{
+    probe_t *p = find(param);
+    if (p == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (!curve_valid(curve)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(PROBE_ADC_NVS_NS, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, p->name, curve, sizeof(*curve));
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    // Applies now even if it could not be stored
+    portENTER_CRITICAL(&curve_lock);
+    p->curve = *curve;
+    portEXIT_CRITICAL(&curve_lock);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "%s: curve not stored (%s)", p->name, esp_err_to_name(err));
+    }
+    return err;
+}
+
+bool probe_adc_mv(sensor_param_t param, float *mv)
+{
+    probe_t *p = find(param);
+    if (p == NULL) {
+        return false;
+    }
+    portENTER_CRITICAL(&curve_lock);
+    *mv = p->last_mv;
+    portEXIT_CRITICAL(&curve_lock);
+    return !isnan(*mv);
+}
@@ -0,0 +1,98 @@
+#ifndef PROBE_ADC_H
+#define PROBE_ADC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "hal/adc_types.h"
+#include "sensor_acq.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Analog probes - heavily oversampled readings from the continuous ADC
+//
+// Analog pH (and similar) boards put out a slowly moving voltage buried in
+// noise. Instead of a task polling adc_oneshot, ADC1 runs in continuous
+// mode over every registered probe's channel at CONFIG_GOLDIE_PROBE_ADC_RATE_HZ
+// and DMAs the results in PROBE_ADC_FRAME_BYTES frames. The frame callback
+// (ISR, no copies) decimates: it sums each probe's results in blocks - a
+// boxcar - sized so one period holds PROBE_ADC_BLOCKS of them, and keeps
+// the last PROBE_ADC_BLOCKS block sums. The driver's own pool is flushed
+// rather than read.
+//
+// Each probe is a sensor_acq driver (sensor_acq.h): its read() filters the
+// blocks gathered since the last one. They are sorted and only the middle
+// half is averaged (an interquartile mean), so the pump or heater switching
+// while a block was summed throws that block out instead of shifting the
+// reading, and the rest still average thousands of samples. The reading
+// then goes through the usual median / EMA / deadband path to the
+// dashboard. The filtered raw value is turned into millivolts with the
+// chip's eFuse calibration (interpolated between whole codes, so the
+// oversampled fraction is kept) and then into the parameter's unit with
+// the probe's calibration curve.
+//
+// A curve is up to PROBE_ADC_CURVE_POINTS (mV, value) points, linear
+// between them and extended past the ends. It is kept in NVS per probe
+// (namespace PROBE_ADC_NVS_NS, key = probe name); without one the
+// registered default is used. probe_adc_mv() gives the raw voltage for
+// taking calibration points.
+
+#ifndef CONFIG_GOLDIE_PROBE_ADC_RATE_HZ
+#define CONFIG_GOLDIE_PROBE_ADC_RATE_HZ 2000
+#endif
+
+#ifndef CONFIG_GOLDIE_PROBE_ADC_PERIOD_MS
+#define CONFIG_GOLDIE_PROBE_ADC_PERIOD_MS 2000
+#endif
+
+#ifndef CONFIG_GOLDIE_PROBE_ADC_PH_CHANNEL
+#define CONFIG_GOLDIE_PROBE_ADC_PH_CHANNEL -1
+#endif
+
+#define PROBE_ADC_MAX           4         // Probes (channels) at most
+#define PROBE_ADC_CURVE_POINTS  4
+#define PROBE_ADC_FRAME_BYTES   256       // One DMA frame: 64 results
+#define PROBE_ADC_POOL_BYTES    1024      // Driver pool (flushed, never read)
+#define PROBE_ADC_BLOCKS        32        // Decimated blocks per reading
+#define PROBE_ADC_NVS_NS        "probe_adc"
+
+typedef struct {
+    float mv[PROBE_ADC_CURVE_POINTS];     // Strictly increasing
+    float value[PROBE_ADC_CURVE_POINTS];
+    uint8_t count;                        // Points used, 2 or more
+} probe_curve_t;
+
+/**
+ * @brief Add an analog probe (before sensor_acq_start)
+ * @param name Static; also the NVS key of its curve (15 chars at most)
+ * @param fallback Curve until one is stored
+ * @return false if the table is full, the channel is taken or the curve is bad
+ */
+bool probe_adc_register(const char *name, sensor_param_t param, adc_channel_t channel, float deadband,
+                        const probe_curve_t *fallback);
+
+/**
+ * @brief Register the probes enabled in menuconfig (the pH probe)
+ */
+void probe_adc_register_config(void);
+
+/**
+ * @brief Replace a probe's curve and store it in NVS (any task)
+ * @return ESP_ERR_INVALID_ARG for a bad curve, ESP_ERR_NOT_FOUND without that probe
+ */
+esp_err_t probe_adc_set_curve(sensor_param_t param, const probe_curve_t *curve);
+
+/**
+ * @brief Voltage of the probe's last reading, before its curve
+ * @return false before the first reading
+ */
+bool probe_adc_mv(sensor_param_t param, float *mv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROBE_ADC_H
@@ -0,0 +1,134 @@
+#include "rtc_clock.h"
+#include "esp_pcf85063_port.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include <math.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+static const char *TAG = "rtc_clock";
+
+#define RTC_CLOCK_NVS_SINCE   "since"     // i64: system time of the last RTC write
+#define RTC_CLOCK_NVS_OFFSET  "offset"    // i8: offset register steps
+
+static int64_t load_since(int8_t *offset)
+{
+    int64_t since = 0;
+    *offset = 0;
+    nvs_handle_t nvs;
+    if (nvs_open(RTC_CLOCK_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+        return 0;
+    }
+    nvs_get_i64(nvs, RTC_CLOCK_NVS_SINCE, &since);
+    nvs_get_i8(nvs, RTC_CLOCK_NVS_OFFSET, offset);
+    nvs_close(nvs);
+    return since;
+}
+
+static void store(int64_t since, int8_t offset)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(RTC_CLOCK_NVS_NS, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_i64(nvs, RTC_CLOCK_NVS_SINCE, since);
+        if (err == ESP_OK) {
+            err = nvs_set_i8(nvs, RTC_CLOCK_NVS_OFFSET, offset);
+        }
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Saving the RTC state failed: %s", esp_err_to_name(err));
+    }
+}
+
+bool rtc_clock_restore(i2c_master_bus_handle_t bus)
+{
+    if (bus == NULL || !esp_pcf85063_port_init(bus)) {
+        return false;
+    }
+
+    time_t t;
+    esp_err_t err = esp_pcf85063_port_read(&t);
+    if (err == ESP_ERR_INVALID_STATE) {
+        // Lost its backup supply: the offset register was reset with it
+        int8_t offset;
+        load_since(&offset);
+        if (offset != 0) {
+            esp_pcf85063_port_set_offset(offset);
+        }
+        ESP_LOGW(TAG, "RTC has no valid time - waiting for SNTP");
+        return false;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "RTC read failed (%s) - waiting for SNTP", esp_err_to_name(err));
+        return false;
+    }
+
+    struct timeval tv = { .tv_sec = t, .tv_usec = 0 };
+    settimeofday(&tv, NULL);
+    struct tm tm;
+    char buf[32];
+    gmtime_r(&t, &tm);
+    strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+    ESP_LOGI(TAG, "Clock set from the RTC: %s UTC", buf);
+    return true;
+}
+
+void rtc_clock_sync(void)
+{
+    time_t rtc_t = 0;
+    esp_err_t err = esp_pcf85063_port_read(&rtc_t);
+    bool rtc_valid = (err == ESP_OK);
+    if (err == ESP_ERR_NOT_FOUND) {
+        return;                   // No RTC fitted
+    }
+    if (!rtc_valid && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGW(TAG, "RTC read failed (%s) - not synced", esp_err_to_name(err));
+        return;
+    }
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int8_t offset;
+    int64_t since = load_since(&offset);
+    int64_t elapsed = (int64_t)tv.tv_sec - since;
+    long drift = rtc_valid ? (long)(rtc_t - tv.tv_sec) : 0;    // + = RTC ahead
+
+    bool measured = rtc_valid && since > 0 && elapsed >= RTC_CLOCK_TRIM_MIN_S && labs(drift) >= RTC_CLOCK_STEP_S;
+    if (rtc_valid && since > 0 && labs(drift) < RTC_CLOCK_RESET_S && !measured) {
+        ESP_LOGD(TAG, "RTC within %ld s after %lld s - left running", drift, (long long)elapsed);
+        return;
+    }
+
+    if (measured) {
+        float ppm = drift * 1e6f / (float)elapsed;
+        int steps = (int)lroundf(ppm / PCF85063_OFFSET_PPM);
+        int8_t current;
+        if (fabsf(ppm) <= RTC_CLOCK_PPM_MAX && steps != 0 && esp_pcf85063_port_get_offset(&current) == ESP_OK) {
+            int trimmed = current - steps;
+            trimmed = trimmed < PCF85063_OFFSET_MIN ? PCF85063_OFFSET_MIN : trimmed;
+            trimmed = trimmed > PCF85063_OFFSET_MAX ? PCF85063_OFFSET_MAX : trimmed;
+            if (esp_pcf85063_port_set_offset((int8_t)trimmed) == ESP_OK) {
+                offset = (int8_t)trimmed;
+            }
+            ESP_LOGI(TAG, "RTC drifted %ld s in %.1f h (%.1f ppm) - offset %d -> %d", drift, elapsed / 3600.0f,
+                     ppm, current, offset);
+        }
+    }
+
+    // Write on the next second boundary: the RTC only holds whole seconds
+    usleep(1000000 - tv.tv_usec);
+    time_t now = tv.tv_sec + 1;
+    err = esp_pcf85063_port_write(now);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "RTC write failed: %s", esp_err_to_name(err));
+        return;
+    }
+    store(now, offset);
+    ESP_LOGI(TAG, "RTC set from SNTP time%s", rtc_valid ? "" : " (it had none)");
+}
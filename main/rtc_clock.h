@@ -0,0 +1,53 @@
+#ifndef RTC_CLOCK_H
+#define RTC_CLOCK_H
+
+#include <stdbool.h>
+#include "driver/i2c_master.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// RTC clock - wall-clock time from the PCF85063 until SNTP answers
+//
+// At boot rtc_clock_restore() sets the system clock from the RTC, so the
+// calendar, log timestamps and mood timers are right from the first frame
+// and stay right offline. An RTC that lost its backup supply is left
+// alone and the clock waits for SNTP as before.
+//
+// After every SNTP sync rtc_clock_sync() compares the RTC with the fresh
+// system time. The RTC is rewritten when it was invalid, when it is off by
+// RTC_CLOCK_RESET_S or more, or when RTC_CLOCK_TRIM_MIN_S have passed since
+// the last write and it is off by RTC_CLOCK_STEP_S or more. In that last
+// case the error over the interval is the crystal's drift: it is turned
+// into offset register steps (PCF85063_OFFSET_PPM each) and the register
+// is trimmed, so the next interval drifts less. The last write time and
+// the offset are kept in NVS; the offset is put back if the RTC loses
+// power.
+
+#define RTC_CLOCK_NVS_NS       "rtc_clock"
+#define RTC_CLOCK_STEP_S       2               // Drift worth measuring
+#define RTC_CLOCK_RESET_S      30              // Rewrite at once: not drift
+#define RTC_CLOCK_TRIM_MIN_S   (2 * 86400)     // Shortest interval to trim from
+#define RTC_CLOCK_PPM_MAX      250.0f          // More is a clock that was changed
+
+/**
+ * @brief Probe the RTC and set the system clock from it (boot, after NVS)
+ * @return true if the clock was set
+ */
+bool rtc_clock_restore(i2c_master_bus_handle_t bus);
+
+/**
+ * @brief Bring the RTC in line with an SNTP-synced system clock
+ *
+ * Blocks up to a second to write on a second boundary; call it from a
+ * task, not the SNTP callback.
+ */
+void rtc_clock_sync(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RTC_CLOCK_H
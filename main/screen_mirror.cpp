@@ -0,0 +1,232 @@
+#include "screen_mirror.h"
+#include "web_server.h"
+#include "ui/ui_mirror.h"
+#include "esp_lvgl_port.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+
+static const char *TAG = "screen_mirror";
+
+extern const uint8_t mirror_gz_start[] asm("_binary_mirror_html_gz_start");
+extern const uint8_t mirror_gz_end[] asm("_binary_mirror_html_gz_end");
+
+#define MIRROR_LOCK_MS     100          // LVGL lock for the full redraw of a new viewer
+
+static httpd_handle_t server = NULL;
+static esp_timer_handle_t tick_timer = NULL;
+static std::atomic<bool> send_queued(false);
+static std::atomic<int> viewers(0);
+
+// Server task only (handlers and queued work run there one at a time)
+static int clients[SCREEN_MIRROR_CLIENTS];
+static int client_count = 0;
+static uint8_t *chunk = NULL;           // SCREEN_MIRROR_CHUNK bytes, PSRAM
+
+/**
+ * @brief Drop closed sockets (and `except`, about to be re-added)
+ */
+static void prune_clients(int except)
+{
+    int kept = 0;
+    for (int i = 0; i < client_count; i++) {
+        if (httpd_ws_get_fd_info(server, clients[i]) == HTTPD_WS_CLIENT_WEBSOCKET && clients[i] != except) {
+            clients[kept++] = clients[i];
+        }
+    }
+    client_count = kept;
+    viewers = client_count;
+    ui_mirror_set_active(client_count > 0);
+}
+
+/**
+ * @brief Send one chunk to every viewer; a failed socket is dropped
+ */
+static void send_chunk(size_t len)
+{
+    httpd_ws_frame_t frame = {};
+    frame.type = HTTPD_WS_TYPE_BINARY;
+    frame.final = true;
+    frame.payload = chunk;
+    frame.len = len;
+    bool lost = false;
+    for (int i = 0; i < client_count; i++) {
+        if (httpd_ws_send_frame_async(server, clients[i], &frame) != ESP_OK) {
+            httpd_sess_trigger_close(server, clients[i]);
+            clients[i] = -1;
+            lost = true;
+        }
+    }
+    if (lost) {
+        prune_clients(-1);
+    }
+}
+
+/**
+ * @brief Server task: send the dirty rectangles within this round's byte budget
+ */
+static void send_work(void *arg)
+{
+    send_queued = false;
+    if (client_count == 0) {
+        return;
+    }
+    int32_t budget = (int32_t)CONFIG_GOLDIE_MIRROR_KBPS * 1024 / CONFIG_GOLDIE_MIRROR_FPS;
+    ui_mirror_rect_t rects[UI_MIRROR_RECTS];
+    int n = ui_mirror_take(rects, UI_MIRROR_RECTS);
+    int i = 0;
+    for (; i < n && budget > 0 && client_count > 0; i++) {
+        while (rects[i].h > 0 && budget > 0 && client_count > 0) {
+            size_t len = ui_mirror_encode(&rects[i], chunk, SCREEN_MIRROR_CHUNK);
+            if (len == 0) {
+                rects[i].h = 0;                 // Wider than a chunk row: cannot happen at 480 px
+                break;
+            }
+            send_chunk(len);
+            budget -= (int32_t)len;
+        }
+        if (rects[i].h > 0) {
+            ui_mirror_mark(&rects[i]);          // Rest of it next round
+        }
+    }
+    for (; i < n; i++) {
+        ui_mirror_mark(&rects[i]);
+    }
+}
+
+/**
+ * @brief Send clock (esp_timer task): wake the server task once
+ */
+static void tick_cb(void *arg)
+{
+    if (viewers.load() > 0 && !send_queued.exchange(true) && httpd_queue_work(server, send_work, NULL) != ESP_OK) {
+        send_queued = false;
+    }
+}
+
+static esp_err_t send_hello(int fd)
+{
+    int16_t w = 0;
+    int16_t h = 0;
+    ui_mirror_size(&w, &h);
+    char hello[96];
+    int len = snprintf(hello, sizeof(hello), "{\"w\":%d,\"h\":%d,\"swap\":%d,\"touch\":%s}", w, h,
+                       LV_COLOR_16_SWAP, CONFIG_GOLDIE_MIRROR_TOUCH ? "true" : "false");
+    httpd_ws_frame_t frame = {};
+    frame.type = HTTPD_WS_TYPE_TEXT;
+    frame.final = true;
+    frame.payload = (uint8_t *)hello;
+    frame.len = (size_t)len;
+    return httpd_ws_send_frame_async(server, fd, &frame);
+}
+
+static esp_err_t page_handler(httpd_req_t *req)
+{
+    httpd_resp_set_type(req, "text/html");
+    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    httpd_resp_set_hdr(req, "Cache-Control", "max-age=3600");
+    return httpd_resp_send(req, (const char *)mirror_gz_start, mirror_gz_end - mirror_gz_start);
+}
+
+static esp_err_t ws_handler(httpd_req_t *req)
+{
+    int fd = httpd_req_to_sockfd(req);
+    if (req->method == HTTP_GET) {
+        prune_clients(fd);
+        if (client_count == SCREEN_MIRROR_CLIENTS) {
+            ESP_LOGW(TAG, "Viewer limit (%d) reached - socket %d gets no frames", SCREEN_MIRROR_CLIENTS, fd);
+            return ESP_OK;
+        }
+        esp_err_t err = send_hello(fd);
+        if (err != ESP_OK) {
+            return err;
+        }
+        clients[client_count++] = fd;
+        viewers = client_count;
+        ui_mirror_set_active(true);
+        // The shadow is stale or empty: have LVGL redraw everything once
+        if (lvgl_port_lock(MIRROR_LOCK_MS)) {
+            ui_mirror_invalidate();
+            lvgl_port_unlock();
+        } else {
+            ESP_LOGW(TAG, "LVGL busy - the viewer fills in as the screen changes");
+        }
+        ESP_LOGI(TAG, "Mirror viewer on socket %d (%d connected)", fd, client_count);
+        return ESP_OK;
+    }
+
+    // Touch frames from the page; anything else is read and dropped
+    httpd_ws_frame_t frame = {};
+    esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
+    if (err != ESP_OK) {
+        return err;
+    }
+    uint8_t buf[16];
+    if (frame.len == 0 || frame.len > sizeof(buf)) {
+        return ESP_OK;
+    }
+    frame.payload = buf;
+    err = httpd_ws_recv_frame(req, &frame, frame.len);
+    if (err == ESP_OK && frame.type == HTTPD_WS_TYPE_BINARY && frame.len == 5) {
+        ui_mirror_touch((int16_t)(buf[0] | (buf[1] << 8)), (int16_t)(buf[2] | (buf[3] << 8)), buf[4] != 0);
+    }
+    return err;
+}
+
+bool screen_mirror_start(void)
+{
+    if (server != NULL) {
+        return true;
+    }
+    int16_t w = 0;
+    int16_t h = 0;
+    ui_mirror_size(&w, &h);
+    if (w == 0) {
+        ESP_LOGW(TAG, "No screen shadow (ui_mirror_init) - mirror off");
+        return false;
+    }
+    chunk = (uint8_t *)heap_caps_malloc(SCREEN_MIRROR_CHUNK, MALLOC_CAP_SPIRAM);
+    if (chunk == NULL) {
+        ESP_LOGE(TAG, "No PSRAM for the send buffer");
+        return false;
+    }
+    httpd_handle_t handle = web_server_start();
+    if (handle == NULL) {
+        return false;
+    }
+
+    const httpd_uri_t page_uri = {
+        .uri = "/mirror", .method = HTTP_GET, .handler = page_handler, .user_ctx = NULL,
+    };
+    httpd_uri_t ws_uri = {
+        .uri = "/mirror/ws", .method = HTTP_GET, .handler = ws_handler, .user_ctx = NULL,
+    };
+    ws_uri.is_websocket = true;
+    if (httpd_register_uri_handler(handle, &page_uri) != ESP_OK ||
+        httpd_register_uri_handler(handle, &ws_uri) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register /mirror and /mirror/ws");
+        return false;
+    }
+    server = handle;
+
+    // Started last: the tick needs the server handle
+    const esp_timer_create_args_t args = {
+        .callback = tick_cb,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "mirror",
+        .skip_unhandled_events = true,
+    };
+    if (esp_timer_create(&args, &tick_timer) != ESP_OK ||
+        esp_timer_start_periodic(tick_timer, 1000000 / CONFIG_GOLDIE_MIRROR_FPS) != ESP_OK) {
+        ESP_LOGE(TAG, "No send timer - mirror off");
+        return false;
+    }
+    ESP_LOGI(TAG, "Screen mirror: /mirror (%u bytes gzip), /mirror/ws, %d fps max, %d KB/s%s",
+             (unsigned)(mirror_gz_end - mirror_gz_start), CONFIG_GOLDIE_MIRROR_FPS, CONFIG_GOLDIE_MIRROR_KBPS,
+             CONFIG_GOLDIE_MIRROR_TOUCH ? ", remote touch" : "");
+    return true;
+}
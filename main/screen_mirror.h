@@ -0,0 +1,41 @@
+#ifndef SCREEN_MIRROR_H
+#define SCREEN_MIRROR_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Remote screen mirror for field support (web_server.h, port 80)
+//
+//   GET /mirror     viewer page (main/web/mirror.html, gzip-compressed)
+//   GET /mirror/ws  WebSocket: a JSON hello {"w","h","swap","touch"}, then
+//                   one binary frame per RLE-encoded rectangle chunk
+//                   (ui/ui_mirror.h has the layout)
+//
+// Only what LVGL flushes (and the animation rows blitted past it) is sent:
+// the LVGL task copies each band into a PSRAM shadow, and the server task
+// encodes and sends the dirty rectangles at most CONFIG_GOLDIE_MIRROR_FPS
+// times a second within CONFIG_GOLDIE_MIRROR_KBPS; what does not fit waits
+// for the next round, merged with newer changes, so a slow link drops
+// intermediate states instead of slowing the UI. A new viewer triggers
+// one full redraw. Nothing is copied while no viewer is connected.
+//
+// With CONFIG_GOLDIE_MIRROR_TOUCH the page's mouse / touch events come back
+// as 5-byte binary frames (u16 x, u16 y, u8 pressed, little endian) and
+// drive a virtual pointer, so scripted UI performance runs can tap
+// through the screens. No authentication - trusted networks only.
+
+#define SCREEN_MIRROR_CLIENTS  2
+#define SCREEN_MIRROR_CHUNK    8192     // Largest binary frame (PSRAM send buffer)
+
+// Register the page and the socket (call after WiFi is connected and after
+// ui_mirror_init(); safe to call again)
+bool screen_mirror_start(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SCREEN_MIRROR_H
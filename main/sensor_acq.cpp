@@ -0,0 +1,340 @@
+#include "sensor_acq.h"
+#include "dashboard.h"
+#include "task_layout.h"
+#include "task_monitor.h"
+#include "job_watch.h"
+#include "esp_lvgl_port.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "time_svc.h"
+#include "history/param_series.h"
+#include "state/dash_log.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "sensor_acq";
+
+typedef struct {
+    sensor_driver_t drv;
+    bool up;                               // init succeeded
+    int64_t next_us;                       // Next sample due
+    float window[SENSOR_ACQ_MEDIAN];       // Last raw samples
+    uint8_t window_len;
+    uint8_t window_pos;
+    sensor_acq_stats_t stats;
+} sensor_slot_t;
+
+static sensor_slot_t slots[SENSOR_ACQ_MAX_DRIVERS];
+static uint8_t slot_count = 0;
+static bool started = false;
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;   // stats, read by other tasks
+
+static_assert((int)SENSOR_PARAM_COUNT == (int)DASHBOARD_PARAM_COUNT, "probe and dashboard parameters must line up");
+
+static float median(const float *v, uint8_t n)
+{
+    float sorted[SENSOR_ACQ_MEDIAN];
+    memcpy(sorted, v, n * sizeof(float));
+    for (uint8_t i = 1; i < n; i++) {
+        float x = sorted[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > x) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = x;
+    }
+    return (n & 1) ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0f;
+}
+
+/**
+ * @brief Take one sample and run it through the filters
+ */
+static void sample(sensor_slot_t *s)
+{
+    float raw = NAN;
+    job_watch_begin(TASK_ID_SENSOR, "sensor_read", SENSOR_ACQ_READ_MS);
+    esp_err_t err = s->drv.read(s->drv.ctx, &raw);
+    job_watch_end(TASK_ID_SENSOR);
+
+    if (err == ESP_ERR_NOT_FINISHED) {
+        return;                            // Nothing new from this source yet
+    }
+    if (err != ESP_OK || isnan(raw)) {
+        portENTER_CRITICAL(&stats_lock);
+        uint32_t errors = ++s->stats.errors;
+        portEXIT_CRITICAL(&stats_lock);
+        if ((errors % 16) == 1) {
+            ESP_LOGW(TAG, "%s: read failed (%s, %lu so far)", s->drv.name, esp_err_to_name(err), (unsigned long)errors);
+        }
+        return;
+    }
+
+    s->window[s->window_pos] = raw;
+    s->window_pos = (uint8_t)((s->window_pos + 1) % SENSOR_ACQ_MEDIAN);
+    if (s->window_len < SENSOR_ACQ_MEDIAN) {
+        s->window_len++;
+    }
+
+    portENTER_CRITICAL(&stats_lock);
+    s->stats.samples++;
+    if (s->window_len == SENSOR_ACQ_MEDIAN) {
+        // The EMA starts once the median has a full window to work with
+        float m = median(s->window, s->window_len);
+        s->stats.filtered = isnan(s->stats.filtered) ? m
+                          : s->stats.filtered + SENSOR_ACQ_EMA_ALPHA * (m - s->stats.filtered);
+    }
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+/**
+ * @brief Push every value that moved by its deadband, in one batch
+ */
+static void publish(void)
+{
+    float values[SENSOR_ACQ_MAX_DRIVERS];
+    bool due[SENSOR_ACQ_MAX_DRIVERS] = {};
+    bool any = false;
+    for (uint8_t i = 0; i < slot_count; i++) {
+        sensor_slot_t *s = &slots[i];
+        values[i] = s->stats.filtered;
+        if (!s->up || isnan(values[i])) {
+            continue;
+        }
+        due[i] = isnan(s->stats.published) || fabsf(values[i] - s->stats.published) >= s->drv.deadband;
+        any |= due[i];
+    }
+    if (!any) {
+        return;
+    }
+    if (!lvgl_port_lock(SENSOR_ACQ_LOCK_MS)) {
+        return;                            // Next window tries again
+    }
+    for (uint8_t i = 0; i < slot_count; i++) {
+        if (due[i]) {
+            dashboard_update_tank_param(0, slots[i].drv.param, values[i]);   // Probes are the first tank's
+        }
+    }
+    lvgl_port_unlock();
+
+    portENTER_CRITICAL(&stats_lock);
+    for (uint8_t i = 0; i < slot_count; i++) {
+        if (due[i]) {
+            slots[i].stats.published = values[i];
+            slots[i].stats.publishes++;
+        }
+    }
+    portEXIT_CRITICAL(&stats_lock);
+    for (uint8_t i = 0; i < slot_count; i++) {
+        if (due[i]) {
+            ESP_LOGI(TAG, "%s -> %.2f", slots[i].drv.name, values[i]);
+        }
+    }
+}
+
+/**
+ * @brief Append the filtered values to the SD time series (NAN: no probe yet)
+ */
+static void record(void)
+{
+    if (!time_svc_wall_valid()) {
+        return;
+    }
+    float values[PARAM_SERIES_VALUES];
+    for (int p = 0; p < PARAM_SERIES_VALUES; p++) {
+        values[p] = NAN;
+    }
+    portENTER_CRITICAL(&stats_lock);
+    for (uint8_t i = 0; i < slot_count; i++) {
+        if (slots[i].up) {
+            values[slots[i].drv.param] = slots[i].stats.filtered;
+        }
+    }
+    portEXIT_CRITICAL(&stats_lock);
+    param_series_append(time_svc_wall(), values);
+}
+
+static void sensor_task(void *arg)
+{
+    const int64_t publish_us = (int64_t)CONFIG_GOLDIE_SENSOR_PUBLISH_S * 1000000;
+    const int64_t record_us = (int64_t)CONFIG_GOLDIE_SERIES_PERIOD_S * 1000000;
+    int64_t next_publish = esp_timer_get_time() + publish_us;
+    int64_t next_record = esp_timer_get_time() + record_us;
+
+    while (true) {
+        int64_t now = esp_timer_get_time();
+        int64_t wake = next_publish;
+        for (uint8_t i = 0; i < slot_count; i++) {
+            sensor_slot_t *s = &slots[i];
+            if (!s->up) {
+                continue;
+            }
+            if (now >= s->next_us) {
+                sample(s);
+                // Keep the cadence; a long stall does not replay the missed samples
+                s->next_us += (int64_t)s->drv.period_ms * 1000;
+                if (s->next_us <= now) {
+                    s->next_us = now + (int64_t)s->drv.period_ms * 1000;
+                }
+            }
+            if (s->next_us < wake) {
+                wake = s->next_us;
+            }
+        }
+        if (now >= next_publish) {
+            publish();
+            next_publish = now + publish_us;
+            if (next_publish < wake) {
+                wake = next_publish;
+            }
+        }
+        if (now >= next_record) {
+            record();
+            next_record += record_us;      // Fixed cadence: the timestamps delta-of-delta to 0
+            if (next_record <= now) {
+                next_record = now + record_us;
+            }
+        }
+        if (next_record < wake) {
+            wake = next_record;
+        }
+        now = esp_timer_get_time();
+        if (wake > now) {
+            vTaskDelay(pdMS_TO_TICKS((wake - now) / 1000) + 1);
+        }
+    }
+}
+
+#if CONFIG_GOLDIE_SENSOR_SIM
+// Bench stand-in for real probes: a slow drift around a set point, plus
+// noise and an occasional spike for the median to reject
+typedef struct {
+    float base;
+    float drift;
+    float noise;
+    uint32_t period_s;
+} sim_probe_t;
+
+static sim_probe_t sim_probes[SENSOR_PARAM_COUNT] = {
+    { 0.10f, 0.15f, 0.02f, 1800 },         // Ammonia
+    { 0.05f, 0.10f, 0.02f, 2400 },         // Nitrite
+    { 15.0f, 10.0f, 1.0f,  3600 },         // Nitrate
+    { 7.0f,  0.4f,  0.05f, 1200 },         // pH
+};
+
+static esp_err_t sim_read(void *ctx, float *value)
+{
+    const sim_probe_t *p = (const sim_probe_t *)ctx;
+    float t = (float)time_svc_uptime_s() / (float)p->period_s;
+    float noise = p->noise * ((float)(esp_random() % 2001) / 1000.0f - 1.0f);
+    if (esp_random() % 50 == 0) {
+        noise += p->drift * 4.0f;          // Spike
+    }
+    float v = p->base + p->drift * sinf(2.0f * (float)M_PI * t) + noise;
+    *value = v < 0.0f ? 0.0f : v;
+    return ESP_OK;
+}
+
+static void register_sim_probes(void)
+{
+    static const char *const names[SENSOR_PARAM_COUNT] = { "sim_ammonia", "sim_nitrite", "sim_nitrate", "sim_ph" };
+    static const float deadbands[SENSOR_PARAM_COUNT] = { 0.05f, 0.05f, 2.0f, 0.1f };
+    for (int p = 0; p < SENSOR_PARAM_COUNT; p++) {
+        sensor_driver_t drv = {
+            .name = names[p],
+            .param = (sensor_param_t)p,
+            .period_ms = 2000,
+            .deadband = deadbands[p],
+            .init = NULL,
+            .read = sim_read,
+            .ctx = &sim_probes[p],
+        };
+        sensor_acq_register(&drv);
+    }
+}
+#endif
+
+bool sensor_acq_register(const sensor_driver_t *drv)
+{
+    if (started || drv == NULL || drv->read == NULL || drv->param >= SENSOR_PARAM_COUNT ||
+        drv->period_ms == 0 || slot_count >= SENSOR_ACQ_MAX_DRIVERS) {
+        ESP_LOGE(TAG, "Cannot register %s", drv && drv->name ? drv->name : "driver");
+        return false;
+    }
+    for (uint8_t i = 0; i < slot_count; i++) {
+        if (slots[i].drv.param == drv->param) {
+            ESP_LOGE(TAG, "%s: parameter %d already read by %s", drv->name, (int)drv->param, slots[i].drv.name);
+            return false;
+        }
+    }
+    sensor_slot_t *s = &slots[slot_count++];
+    memset(s, 0, sizeof(*s));
+    s->drv = *drv;
+    s->stats.filtered = NAN;
+    s->stats.published = NAN;
+    return true;
+}
+
+bool sensor_acq_claimed(sensor_param_t param)
+{
+    for (uint8_t i = 0; i < slot_count; i++) {
+        if (slots[i].drv.param == param) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool sensor_acq_start(void)
+{
+    if (started) {
+        return true;
+    }
+#if CONFIG_GOLDIE_SENSOR_SIM
+    register_sim_probes();
+#endif
+    uint8_t up = 0;
+    int64_t now = esp_timer_get_time();
+    for (uint8_t i = 0; i < slot_count; i++) {
+        sensor_slot_t *s = &slots[i];
+        esp_err_t err = s->drv.init ? s->drv.init(s->drv.ctx) : ESP_OK;
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "%s: init failed (%s) - not sampled", s->drv.name, esp_err_to_name(err));
+            continue;
+        }
+        s->up = true;
+        s->next_us = now;
+        up++;
+    }
+    started = true;
+    if (up == 0) {
+        ESP_LOGI(TAG, "No sensors - parameters come from manual entry only");
+        return false;
+    }
+    param_series_init(DASH_LOG_DIR);
+
+    TaskHandle_t handle = NULL;
+    if (task_layout_create(TASK_ID_SENSOR, sensor_task, NULL, &handle) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create the sensor task");
+        return false;
+    }
+    task_monitor_register(TASK_ID_SENSOR, handle);
+    ESP_LOGI(TAG, "%u sensor(s) sampling, changes published every %d s", up, CONFIG_GOLDIE_SENSOR_PUBLISH_S);
+    return true;
+}
+
+bool sensor_acq_get(sensor_param_t param, sensor_acq_stats_t *out)
+{
+    for (uint8_t i = 0; i < slot_count; i++) {
+        if (slots[i].drv.param == param && slots[i].up) {
+            portENTER_CRITICAL(&stats_lock);
+            *out = slots[i].stats;
+            portEXIT_CRITICAL(&stats_lock);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,103 @@
+#ifndef SENSOR_ACQ_H
+#define SENSOR_ACQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sensor acquisition - water parameters from probes instead of the keypad
+//
+// A driver reads one parameter; each is sampled on its own period by one
+// low-priority task (TASK_ID_SENSOR). Raw samples go through a median of
+// the last SENSOR_ACQ_MEDIAN (drops spikes), then an EMA (smooths drift
+// noise). Every CONFIG_GOLDIE_SENSOR_PUBLISH_S the values that moved by
+// at least their driver's deadband since they were last pushed go to the
+// dashboard together, under one LVGL lock - the same path as a keypad
+// Save, so the dashboard settles them into one mood update.
+//
+// Every CONFIG_GOLDIE_SERIES_PERIOD_S the filtered values of all four are
+// also appended to the compressed time series on SD (param_series.h).
+//
+// A driver fed from outside (a radio node) has no sample on every call:
+// read() returns ESP_ERR_NOT_FINISHED then, which is skipped, not counted
+// as an error.
+//
+// Manual entry keeps working: a parameter without a driver is never
+// touched, and a typed-in value stays until the probe's own filtered
+// reading moves by a deadband.
+//
+// A probe on the shared I2C bus brackets its transfers in read() with
+// i2c_sched_begin(I2C_SCHED_SENSOR) / _end, so it only uses the gaps
+// between touch polls (i2c_sched.h).
+
+#ifndef CONFIG_GOLDIE_SENSOR_PUBLISH_S
+#define CONFIG_GOLDIE_SENSOR_PUBLISH_S 10
+#endif
+
+#define SENSOR_ACQ_MAX_DRIVERS  4
+#define SENSOR_ACQ_MEDIAN       5         // Samples in the median window (odd)
+#define SENSOR_ACQ_EMA_ALPHA    0.25f     // Weight of each new median
+#define SENSOR_ACQ_READ_MS      500       // job_watch deadline of one read
+#define SENSOR_ACQ_LOCK_MS      200       // Waiting for the LVGL lock to publish
+
+typedef enum {
+    SENSOR_AMMONIA = 0,
+    SENSOR_NITRITE,
+    SENSOR_NITRATE,
+    SENSOR_PH,
+    SENSOR_PARAM_COUNT
+} sensor_param_t;
+
+typedef struct {
+    const char *name;                         // Static, for logs
+    sensor_param_t param;
+    uint32_t period_ms;                       // Between samples
+    float deadband;                           // Filtered change worth publishing
+    esp_err_t (*init)(void *ctx);             // NULL = nothing to set up
+    esp_err_t (*read)(void *ctx, float *value);
+    void *ctx;
+} sensor_driver_t;
+
+typedef struct {
+    float filtered;                           // NAN until the median window is full
+    float published;                          // NAN until first pushed
+    uint32_t samples;
+    uint32_t errors;
+    uint32_t publishes;
+} sensor_acq_stats_t;
+
+/**
+ * @brief Add a driver (before sensor_acq_start; the struct is copied)
+ * @return false if the table is full or the parameter already has one
+ */
+bool sensor_acq_register(const sensor_driver_t *drv);
+
+/**
+ * @brief Whether a driver is already registered for the parameter
+ */
+bool sensor_acq_claimed(sensor_param_t param);
+
+/**
+ * @brief Init the drivers and start sampling (after dashboard_init)
+ *
+ * With CONFIG_GOLDIE_SENSOR_SIM, simulated probes are registered first.
+ * @return false if no driver came up
+ */
+bool sensor_acq_start(void);
+
+/**
+ * @brief Filter state of one parameter
+ * @return false if no driver reads it
+ */
+bool sensor_acq_get(sensor_param_t param, sensor_acq_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SENSOR_ACQ_H
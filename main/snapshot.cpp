@@ -0,0 +1,303 @@
+#include "snapshot.h"
+#include "esp_camera_port.h"
+#include "img_converters.h"
+#include "msg_bus.h"
+#include "messages.h"
+#include "sd_logger.h"
+#include "task_layout.h"
+#include "task_monitor.h"
+#include "job_watch.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "mbedtls/base64.h"
+#include "time_svc.h"
+#if CONFIG_GOLDIE_FISH_ACTIVITY
+#include "fish_activity.h"
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char *TAG = "snapshot";
+
+static msg_bus_sub_t *mood_sub = NULL;
+static TaskHandle_t snap_task = NULL;
+static volatile bool live_wanted = false;     // Camera tile on screen
+
+#if CONFIG_GOLDIE_SNAPSHOT_AI
+static SemaphoreHandle_t ai_lock = NULL;
+static char *ai_b64 = NULL;               // PSRAM, SNAPSHOT_AI_B64_MAX; published under ai_lock
+static char *ai_next = NULL;              // Encoded into, swapped with ai_b64
+static size_t ai_len = 0;
+static int64_t ai_taken_us = 0;
+
+// Encoder output base64-encoded as it comes, in whole 3-byte groups
+typedef struct {
+    char *out;
+    size_t len;                           // Base64 characters written
+    size_t jpg_len;
+    uint8_t carry[3];                     // Bytes short of a group
+    size_t carried;
+    bool over;                            // Past SNAPSHOT_AI_B64_MAX
+} b64_stream_t;
+
+static void b64_append(b64_stream_t *s, const uint8_t *src, size_t n)
+{
+    size_t olen = 0;
+    if (s->over || n == 0) {
+        return;
+    }
+    if (mbedtls_base64_encode((unsigned char *)s->out + s->len, SNAPSHOT_AI_B64_MAX - s->len, &olen, src, n) != 0) {
+        s->over = true;
+        return;
+    }
+    s->len += olen;
+}
+
+static size_t b64_put(void *arg, size_t index, const void *data, size_t len)
+{
+    (void)index;
+    b64_stream_t *s = (b64_stream_t *)arg;
+    const uint8_t *p = (const uint8_t *)data;
+    size_t left = len;
+    s->jpg_len += len;
+    while (s->carried > 0 && s->carried < 3 && left > 0) {
+        s->carry[s->carried++] = *p++;
+        left--;
+    }
+    if (s->carried == 3) {
+        b64_append(s, s->carry, 3);
+        s->carried = 0;
+    }
+    size_t whole = left - left % 3;
+    b64_append(s, p, whole);
+    if (left > whole) {
+        memcpy(s->carry, p + whole, left - whole);
+        s->carried = left - whole;
+    }
+    return len;
+}
+
+/**
+ * @brief Re-encode the new preview small for the AI request
+ */
+static void ai_image_update(void)
+{
+    static uint8_t *pixels = NULL;
+    static uint32_t seq = 0;
+    if (pixels == NULL) {
+        pixels = (uint8_t *)heap_caps_malloc(CAMERA_PREVIEW_BYTES, MALLOC_CAP_SPIRAM);
+    }
+    if (pixels == NULL || ai_b64 == NULL || ai_next == NULL || !esp_camera_port_preview_copy(pixels, &seq)) {
+        return;
+    }
+    b64_stream_t stream = {};
+    stream.out = ai_next;
+    if (!fmt2jpg_cb(pixels, CAMERA_PREVIEW_BYTES, CAMERA_PREVIEW_W, CAMERA_PREVIEW_H, PIXFORMAT_RGB565,
+                    SNAPSHOT_AI_QUALITY, b64_put, &stream)) {
+        ESP_LOGW(TAG, "AI image encode failed");
+        return;
+    }
+    b64_append(&stream, stream.carry, stream.carried);    // The last group, padded
+    xSemaphoreTake(ai_lock, portMAX_DELAY);
+    if (!stream.over) {
+        char *shown = ai_b64;
+        ai_b64 = ai_next;
+        ai_next = shown;
+        ai_len = stream.len;
+        ai_taken_us = esp_timer_get_time();
+    } else {
+        ai_len = 0;               // Too big for the request budget: send none
+    }
+    xSemaphoreGive(ai_lock);
+    if (stream.over) {
+        ESP_LOGW(TAG, "AI image of %u bytes over budget", (unsigned)stream.jpg_len);
+    }
+}
+#endif
+
+static void capture(const char *reason)
+{
+    job_watch_begin(TASK_ID_SNAPSHOT, "snapshot", SNAPSHOT_CAPTURE_MS);
+    camera_fb_t *fb = esp_camera_port_capture();
+    if (fb == NULL) {
+        job_watch_end(TASK_ID_SNAPSHOT);
+        ESP_LOGW(TAG, "No frame from the camera");
+        return;
+    }
+    bool preview_ok = esp_camera_port_preview_update(fb);
+    job_watch_end(TASK_ID_SNAPSHOT);
+
+    char name[32];
+    struct tm tm;
+    if (time_svc_local(&tm)) {
+        strftime(name, sizeof(name), "%Y%m%d_%H%M%S.jpg", &tm);
+    } else {
+        // No clock yet: sorts first, so the first to go when space runs low
+        snprintf(name, sizeof(name), "00000000_%06lu.jpg", (unsigned long)time_svc_uptime_s());
+    }
+    // Held until the logger has taken it all; the driver has a second buffer
+    size_t len = fb->len;
+    bool queued = sd_logger_file_begin(name);
+    if (queued) {
+        queued = sd_logger_file_write(fb->buf, len, SNAPSHOT_SAVE_MS);
+        sd_logger_file_end(queued);
+    }
+    esp_camera_fb_return(fb);
+#if CONFIG_GOLDIE_SNAPSHOT_AI
+    if (preview_ok) {
+        ai_image_update();
+    }
+#endif
+    ESP_LOGI(TAG, "Snapshot (%s): %u bytes%s%s", reason, (unsigned)len, queued ? ", to SD" : ", not saved",
+             preview_ok ? "" : ", no preview");
+}
+
+/**
+ * @brief One live frame into the preview for the camera tile
+ */
+static void live_frame(void)
+{
+    job_watch_begin(TASK_ID_SNAPSHOT, "live", SNAPSHOT_CAPTURE_MS);
+    camera_fb_t *fb = esp_camera_port_capture_live();
+    if (fb != NULL) {
+        esp_camera_port_preview_update(fb);
+        esp_camera_fb_return(fb);
+    }
+    job_watch_end(TASK_ID_SNAPSHOT);
+}
+
+static void wake_cb(void *arg)
+{
+    xTaskNotifyGive((TaskHandle_t)arg);
+}
+
+static void snapshot_task(void *arg)
+{
+    if (!esp_camera_port_init(I2C_NUM_0)) {
+        snap_task = NULL;
+        vTaskDelete(NULL);
+        return;
+    }
+    task_monitor_register(TASK_ID_SNAPSHOT, xTaskGetCurrentTaskHandle());
+#if CONFIG_GOLDIE_SNAPSHOT_ON_MOOD
+    // Only with a camera: deliveries wake this task
+    mood_sub = msg_bus_subscribe("snapshot", MSG_TOPIC_MOOD_RESULT, TANK_MAX, MSG_SUB_LATEST, wake_cb,
+                                 xTaskGetCurrentTaskHandle());
+    if (mood_sub == NULL) {
+        ESP_LOGW(TAG, "No mood subscription - scheduled snapshots only");
+    }
+#endif
+    ESP_LOGI(TAG, "Snapshots every %d min%s, live preview at %d fps", CONFIG_GOLDIE_SNAPSHOT_PERIOD_MIN,
+             mood_sub != NULL ? " and on mood changes" : "", CONFIG_GOLDIE_SNAPSHOT_LIVE_FPS);
+
+    const TickType_t period = pdMS_TO_TICKS(CONFIG_GOLDIE_SNAPSHOT_PERIOD_MIN * 60 * 1000);
+    const TickType_t live_period = pdMS_TO_TICKS(1000 / CONFIG_GOLDIE_SNAPSHOT_LIVE_FPS);
+    TickType_t next = xTaskGetTickCount() + pdMS_TO_TICKS(SNAPSHOT_SETTLE_MS);
+    TickType_t next_live = xTaskGetTickCount();
+#if CONFIG_GOLDIE_FISH_ACTIVITY
+    const TickType_t activity_period = pdMS_TO_TICKS(CONFIG_GOLDIE_FISH_ACTIVITY_PERIOD_S * 1000);
+    TickType_t next_activity = next;
+#endif
+    int last_category = -1;
+    int64_t last_us = 0;
+    while (true) {
+        // Sleeps to the next capture or live frame; the mood subscription
+        // and snapshot_live() wake it early
+        TickType_t now = xTaskGetTickCount();
+        int32_t left = (int32_t)(next - now);
+        if (live_wanted && (int32_t)(next_live - now) < left) {
+            left = (int32_t)(next_live - now);
+        }
+#if CONFIG_GOLDIE_FISH_ACTIVITY
+        if ((int32_t)(next_activity - now) < left) {
+            left = (int32_t)(next_activity - now);
+        }
+#endif
+        ulTaskNotifyTake(pdTRUE, left > 0 ? (TickType_t)left : 0);
+
+        const char *reason = NULL;
+        const msg_bus_msg_t *msg;
+        while (mood_sub != NULL && (msg = msg_bus_receive(mood_sub, 0)) != NULL) {
+            const mood_result_t *result = MSG_BUS_PAYLOAD(msg, mood_result_t);
+            int category = result->category;
+            bool seen = result->tank == 0;      // The camera watches the first tank
+            msg_bus_release(msg);
+            if (!seen) {
+                continue;
+            }
+            bool changed = last_category >= 0 && category != last_category;
+            last_category = category;
+            if (changed && esp_timer_get_time() - last_us >= (int64_t)SNAPSHOT_MOOD_GAP_S * 1000000) {
+                reason = "mood";
+            }
+        }
+        if (reason == NULL && (int32_t)(next - xTaskGetTickCount()) <= 0) {
+            reason = "scheduled";
+        }
+        if (reason != NULL) {
+            capture(reason);
+            last_us = esp_timer_get_time();
+            next = xTaskGetTickCount() + period;
+#if CONFIG_GOLDIE_FISH_ACTIVITY
+        } else if ((int32_t)(next_activity - xTaskGetTickCount()) <= 0) {
+            fish_activity_sample();
+            next_activity = xTaskGetTickCount() + activity_period;
+#endif
+        } else if (live_wanted && (int32_t)(next_live - xTaskGetTickCount()) <= 0) {
+            live_frame();
+            // Paced from the last frame: a slow decode lowers the rate
+            // instead of running frames back to back
+            next_live = xTaskGetTickCount() + live_period;
+        }
+    }
+}
+
+void snapshot_start(void)
+{
+#if CONFIG_GOLDIE_SNAPSHOT_AI
+    ai_lock = xSemaphoreCreateMutex();
+    ai_b64 = (char *)heap_caps_malloc(SNAPSHOT_AI_B64_MAX, MALLOC_CAP_SPIRAM);
+    ai_next = (char *)heap_caps_malloc(SNAPSHOT_AI_B64_MAX, MALLOC_CAP_SPIRAM);
+#endif
+    if (task_layout_create(TASK_ID_SNAPSHOT, snapshot_task, NULL, &snap_task) != pdPASS) {
+        snap_task = NULL;
+        ESP_LOGE(TAG, "Failed to create the snapshot task");
+    }
+}
+
+void snapshot_live(bool on)
+{
+    live_wanted = on;
+    TaskHandle_t task = snap_task;
+    if (on && task != NULL) {
+        xTaskNotifyGive(task);
+    }
+}
+
+size_t snapshot_ai_image(char *dst, size_t size)
+{
+#if CONFIG_GOLDIE_SNAPSHOT_AI
+    if (ai_lock == NULL) {
+        return 0;
+    }
+    size_t n = 0;
+    xSemaphoreTake(ai_lock, portMAX_DELAY);
+    bool fresh = ai_len > 0 && esp_timer_get_time() - ai_taken_us < (int64_t)SNAPSHOT_AI_MAX_AGE_S * 1000000;
+    if (fresh && ai_len < size) {
+        memcpy(dst, ai_b64, ai_len);
+        dst[ai_len] = '\0';
+        n = ai_len;
+    }
+    xSemaphoreGive(ai_lock);
+    return n;
+#else
+    (void)dst;
+    (void)size;
+    return 0;
+#endif
+}
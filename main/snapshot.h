@@ -0,0 +1,72 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Snapshots - a JPEG of the tank on a schedule and on mood changes
+//
+// One task (TASK_ID_SNAPSHOT) starts the camera in JPEG mode
+// (esp_camera_port.h) and ends itself if there is none. It captures every
+// CONFIG_GOLDIE_SNAPSHOT_PERIOD_MIN minutes and, with
+// CONFIG_GOLDIE_SNAPSHOT_ON_MOOD, when MSG_TOPIC_MOOD_RESULT changes
+// category (at most every SNAPSHOT_MOOD_GAP_S). A mood capture restarts
+// the schedule.
+//
+// Each capture streams the JPEG straight out of the camera's frame buffer
+// into the SD logger (sd_logger_file_begin, "snap/YYYYMMDD_HHMMSS.jpg"),
+// whose worker writes it to the card as it arrives: a few KB of stream
+// buffer instead of a copy of the frame. The driver fills its second
+// frame buffer meanwhile. The frame is also decoded into the preview the
+// camera tile shows. With CONFIG_GOLDIE_SNAPSHOT_AI the preview is
+// re-encoded as a small JPEG for the AI request (snapshot_ai_image); the
+// encoder's output is base64-encoded as it comes (fmt2jpg_cb), so the
+// JPEG itself is never buffered.
+//
+// While the camera tile is on screen (snapshot_live) the same task also
+// grabs small live frames at CONFIG_GOLDIE_SNAPSHOT_LIVE_FPS into the
+// preview; off screen it grabs nothing between snapshots but, with
+// CONFIG_GOLDIE_FISH_ACTIVITY, the activity frame pairs (fish_activity.h).
+
+#ifndef CONFIG_GOLDIE_SNAPSHOT_PERIOD_MIN
+#define CONFIG_GOLDIE_SNAPSHOT_PERIOD_MIN 30
+#endif
+
+#ifndef CONFIG_GOLDIE_SNAPSHOT_LIVE_FPS
+#define CONFIG_GOLDIE_SNAPSHOT_LIVE_FPS 5
+#endif
+
+#define SNAPSHOT_MOOD_GAP_S     120       // Mood captures at most this often
+#define SNAPSHOT_SETTLE_MS      5000      // First capture: exposure and white balance settled
+#define SNAPSHOT_CAPTURE_MS     1500      // job_watch deadline: grab, preview decode
+#define SNAPSHOT_SAVE_MS        3000      // Longest wait for the SD logger to take the JPEG
+#define SNAPSHOT_AI_QUALITY     40        // fmt2jpg_cb quality (1-100) of the AI image
+#define SNAPSHOT_AI_B64_MAX     8192      // Base64 of the AI image, with the NUL
+#define SNAPSHOT_AI_MAX_AGE_S   (2 * 60 * CONFIG_GOLDIE_SNAPSHOT_PERIOD_MIN)  // Older is not "now"
+
+/**
+ * @brief Start the snapshot task; the camera probe runs there
+ */
+void snapshot_start(void);
+
+/**
+ * @brief Start or stop the live preview (the camera tile, LVGL task)
+ */
+void snapshot_live(bool on);
+
+/**
+ * @brief Base64 JPEG of the latest preview for the AI request (any task)
+ * @return Length copied (NUL-terminated), 0 if there is none recent enough
+ */
+size_t snapshot_ai_image(char *dst, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SNAPSHOT_H
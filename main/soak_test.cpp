@@ -0,0 +1,268 @@
+#include "soak_test.h"
+#include "dashboard.h"
+#include "sd_logger.h"
+#include "ui/ui_latency.h"
+#include "ui/ui_perf.h"
+#include "ui/ui_obj_track.h"
+#include "esp_lvgl_port.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <time.h>
+
+static const char *TAG = "soak";
+
+// Water test sets the parameter updates cycle through (ammonia, nitrite,
+// nitrate, pH), jittered per use
+static const float water_sets[3][4] = {
+    { 0.00f, 0.00f,  5.0f, 7.2f },    // Healthy
+    { 0.25f, 0.10f, 30.0f, 6.7f },    // Warning
+    { 1.00f, 0.80f, 60.0f, 6.0f },    // Toxic
+};
+
+typedef struct {
+    uint32_t params;
+    uint32_t care;
+    uint32_t gestures;
+    uint32_t logs;
+    uint32_t log_drops;
+} soak_counts_t;
+
+// Virtual pointer, LVGL task only (set up with the lock held)
+static int16_t gesture_y0 = 0;
+static int16_t gesture_y1 = 0;
+static uint8_t gesture_step = 0;
+static bool gesture_active = false;
+
+// Soak task only
+static soak_counts_t counts;
+static uint32_t start_internal = 0;
+static uint32_t start_psram = 0;
+static uint32_t start_psram_largest = 0;
+static uint32_t prev_presented = 0;
+static uint32_t prev_skipped = 0;
+
+static void soak_pointer_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
+{
+    data->point.x = 240;
+    if (!gesture_active) {
+        data->point.y = gesture_y1;
+        data->state = LV_INDEV_STATE_RELEASED;
+        return;
+    }
+    if (gesture_step <= SOAK_GESTURE_STEPS) {
+        data->point.y = (lv_coord_t)(gesture_y0 + (gesture_y1 - gesture_y0) * gesture_step / SOAK_GESTURE_STEPS);
+        data->state = LV_INDEV_STATE_PRESSED;
+        gesture_step++;
+        return;
+    }
+    data->point.y = gesture_y1;
+    data->state = LV_INDEV_STATE_RELEASED;
+    gesture_active = false;
+}
+
+static uint32_t jitter_s(uint32_t period_s)
+{
+    // 75-125 % of the period, so the drivers drift against each other
+    return period_s * 3 / 4 + esp_random() % (period_s / 2 + 1);
+}
+
+static float jitter(float v, float spread)
+{
+    return v + spread * ((float)(esp_random() % 2001) / 1000.0f - 1.0f);
+}
+
+static void drive_params(void)
+{
+    const float *set = water_sets[esp_random() % 3];
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
+    dashboard_update_ammonia(jitter(set[0], 0.05f));
+    dashboard_update_nitrite(jitter(set[1], 0.05f));
+    dashboard_update_nitrate(jitter(set[2], 3.0f));
+    dashboard_update_ph(jitter(set[3], 0.1f));
+    lvgl_port_unlock();
+    counts.params++;
+}
+
+static void drive_care(void)
+{
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
+    if (esp_random() & 1) {
+        dashboard_simulate_feed_time((float)(esp_random() % 48));
+    } else {
+        dashboard_simulate_clean_time((float)(esp_random() % 21));
+    }
+    lvgl_port_unlock();
+    counts.care++;
+}
+
+static void drive_gesture(bool down)
+{
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
+    if (!gesture_active) {
+        // Finger moves up to scroll down
+        int16_t len = (int16_t)(160 + esp_random() % 120);
+        gesture_y0 = down ? 290 : (int16_t)(290 - len);
+        gesture_y1 = down ? (int16_t)(290 - len) : 290;
+        gesture_step = 0;
+        gesture_active = true;
+        counts.gestures++;
+    }
+    lvgl_port_unlock();
+}
+
+static void drive_log(void)
+{
+    const float *set = water_sets[esp_random() % 3];
+    float values[4] = { jitter(set[0], 0.05f), jitter(set[2], 3.0f), jitter(set[1], 0.05f), jitter(set[3], 0.1f) };
+    // The ring has one producer, the LVGL task: log under its lock
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
+    bool queued = sd_logger_log(SD_LOG_PARAMETERS, time(NULL), 0, values, 4);
+    lvgl_port_unlock();
+    if (queued) {
+        counts.logs++;
+    } else {
+        counts.log_drops++;
+    }
+}
+
+static void report(uint32_t elapsed_s, bool final)
+{
+    uint32_t presented = 0;
+    uint32_t skipped = 0;
+    uint32_t refresh_max_us = 0;
+    dashboard_get_anim_counts(&presented, &skipped);
+    for (int i = 0; i < UI_PERF_SCREEN_COUNT; i++) {
+        ui_perf_stats_t s;
+        if (ui_perf_get((ui_perf_screen_t)i, &s) && s.render_max_us > refresh_max_us) {
+            refresh_max_us = s.render_max_us;
+        }
+    }
+    uint32_t shown = presented - prev_presented;
+    uint32_t dropped = skipped - prev_skipped;
+    prev_presented = presented;
+    prev_skipped = skipped;
+
+    ESP_LOGI(TAG, "%s after %lu min: %lu param sets, %lu care edits, %lu drags, %lu log records (%lu dropped)",
+             final ? "=== SOAK DONE" : "Soak", (unsigned long)(elapsed_s / 60), (unsigned long)counts.params,
+             (unsigned long)counts.care, (unsigned long)counts.gestures, (unsigned long)counts.logs,
+             (unsigned long)counts.log_drops);
+    ESP_LOGI(TAG, "  frames %lu shown, %lu skipped (%lu.%lu%%) this window; slowest refresh %lu us%s",
+             (unsigned long)shown, (unsigned long)dropped,
+             (unsigned long)(shown + dropped ? dropped * 100 / (shown + dropped) : 0),
+             (unsigned long)(shown + dropped ? dropped * 1000 / (shown + dropped) % 10 : 0),
+             (unsigned long)refresh_max_us, refresh_max_us ? "" : " (UI counters off)");
+
+    for (int p = 0; p < UI_LATENCY_PATH_COUNT; p++) {
+        ui_latency_hist_t h;
+        if (ui_latency_get((ui_latency_path_t)p, &h) && h.count > 0) {
+            ESP_LOGI(TAG, "  %-12s n=%lu p50 <%lu p95 <%lu p99 <%lu max %lu ms",
+                     ui_latency_path_name((ui_latency_path_t)p), (unsigned long)h.count,
+                     (unsigned long)ui_latency_percentile_ms(&h, 50), (unsigned long)ui_latency_percentile_ms(&h, 95),
+                     (unsigned long)ui_latency_percentile_ms(&h, 99), (unsigned long)(h.max_us / 1000));
+        }
+    }
+
+    ui_obj_track_stats_t objs;
+    if (ui_obj_track_get(&objs)) {
+        ESP_LOGI(TAG, "  lvgl objects %lu live (idle base %lu), worst %lu, depth %u; %u popup closes / "
+                 "rebuilds left objects, %u creep", (unsigned long)objs.live, (unsigned long)objs.idle_base,
+                 (unsigned long)objs.worst, objs.depth_max, objs.grew, objs.creep);
+    }
+
+    uint32_t internal = (uint32_t)heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    uint32_t psram = (uint32_t)heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    uint32_t psram_largest = (uint32_t)heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+    ESP_LOGI(TAG, "  heap internal %lu KB (%+ld), psram %lu KB (%+ld), psram largest %lu KB (%+ld), "
+             "internal min %lu KB",
+             (unsigned long)(internal / 1024), (long)((int32_t)(internal - start_internal) / 1024),
+             (unsigned long)(psram / 1024), (long)((int32_t)(psram - start_psram) / 1024),
+             (unsigned long)(psram_largest / 1024), (long)((int32_t)(psram_largest - start_psram_largest) / 1024),
+             (unsigned long)(heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT) / 1024));
+
+    sd_logger_stats_t ls;
+    sd_logger_get_stats(&ls);
+    ESP_LOGI(TAG, "  sd logger %lu written, %lu dropped, block write p99 %lu us",
+             (unsigned long)ls.written, (unsigned long)ls.dropped, (unsigned long)ls.write_p99_us);
+}
+
+static void soak_task(void *arg)
+{
+    const uint32_t end_s = (uint32_t)CONFIG_GOLDIE_SOAK_HOURS * 3600;
+    const uint32_t report_s = (uint32_t)CONFIG_GOLDIE_SOAK_REPORT_MIN * 60;
+    start_internal = (uint32_t)heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    start_psram = (uint32_t)heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    start_psram_largest = (uint32_t)heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+
+    uint32_t next_param = jitter_s(SOAK_PARAM_S);
+    uint32_t next_care = jitter_s(SOAK_CARE_S);
+    uint32_t next_scroll = jitter_s(SOAK_SCROLL_S);
+    uint32_t next_log = jitter_s(SOAK_LOG_S);
+    uint32_t next_report = report_s;
+    int depth = 0;                         // Drags down from the top, to come back up
+    int64_t t0 = esp_timer_get_time();
+
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(1000));
+        uint32_t now = (uint32_t)((esp_timer_get_time() - t0) / 1000000);
+        if (end_s != 0 && now >= end_s) {
+            break;
+        }
+        if (now >= next_param) {
+            drive_params();
+            next_param = now + jitter_s(SOAK_PARAM_S);
+        }
+        if (now >= next_care) {
+            drive_care();
+            next_care = now + jitter_s(SOAK_CARE_S);
+        }
+        if (now >= next_scroll) {
+            // Two or three drags reach the panel; then all the way back
+            bool down = depth < 3 && (depth == 0 || (esp_random() & 3) != 0);
+            drive_gesture(down);
+            depth = down ? depth + 1 : (depth > 0 ? depth - 1 : 0);
+            next_scroll = now + jitter_s(SOAK_SCROLL_S);
+        }
+        if (now >= next_log) {
+            drive_log();
+            next_log = now + jitter_s(SOAK_LOG_S);
+        }
+        if (report_s != 0 && now >= next_report) {
+            report(now, false);
+            next_report = now + report_s;
+        }
+    }
+    report(end_s, true);
+    vTaskDelete(NULL);
+}
+
+bool soak_test_start(lv_disp_t *disp)
+{
+    static lv_indev_drv_t pointer_drv;
+    lv_indev_drv_init(&pointer_drv);
+    pointer_drv.type = LV_INDEV_TYPE_POINTER;
+    pointer_drv.read_cb = soak_pointer_read;
+    pointer_drv.disp = disp;
+    if (lv_indev_drv_register(&pointer_drv) == NULL) {
+        ESP_LOGE(TAG, "No virtual pointer - soak test not started");
+        return false;
+    }
+    if (xTaskCreate(soak_task, "soak", SOAK_STACK, NULL, 1, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "No soak task");
+        return false;
+    }
+    ESP_LOGW(TAG, "SOAK TEST: synthetic input for %d h (0 = until reset), report every %d min",
+             CONFIG_GOLDIE_SOAK_HOURS, CONFIG_GOLDIE_SOAK_REPORT_MIN);
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef SOAK_TEST_H
+#define SOAK_TEST_H
+
+#include <stdbool.h>
+#include "lvgl.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Soak test - hours of synthetic load to catch slow regressions
+//
+// Built only with CONFIG_GOLDIE_SOAK_TEST. A low-priority task drives the
+// dashboard the way a busy user would, on a jittered schedule:
+//
+//   every ~SOAK_PARAM_S    new water test values, cycling through healthy,
+//                          warning and toxic sets so the mood flips (each
+//                          update also asks the AI worker for advice, which
+//                          its rate limit thins out)
+//   every ~SOAK_CARE_S     feed / water change times moved, same effect
+//   every ~SOAK_SCROLL_S   a drag gesture from a virtual pointer device
+//                          (an LVGL indev next to the touch panel): down to
+//                          the panel, back up to the animation
+//   every ~SOAK_LOG_S      a parameter record to the SD logger
+//
+// Every CONFIG_GOLDIE_SOAK_REPORT_MIN minutes (and once at the end) it logs
+// the animation frames shown and skipped, the latency percentiles
+// (ui_latency.h), the slowest refresh (ui_perf.h), heap free / largest
+// block against the start (heap_watch.h) and SD logger drops. After
+// CONFIG_GOLDIE_SOAK_HOURS (0 = until reset) the load stops.
+//
+// The synthetic values are real dashboard state: they are saved, logged
+// and pushed like user input. Soak a scratch device.
+
+#ifndef CONFIG_GOLDIE_SOAK_HOURS
+#define CONFIG_GOLDIE_SOAK_HOURS 8
+#endif
+#ifndef CONFIG_GOLDIE_SOAK_REPORT_MIN
+#define CONFIG_GOLDIE_SOAK_REPORT_MIN 15
+#endif
+
+#define SOAK_PARAM_S       20
+#define SOAK_CARE_S        90
+#define SOAK_SCROLL_S      12
+#define SOAK_LOG_S         60
+#define SOAK_GESTURE_STEPS 12      // Pointer reads per drag (LVGL reads every ~30 ms)
+#define SOAK_STACK         4096
+
+// Add the virtual pointer and start the driver task (LVGL lock held,
+// after dashboard_init)
+bool soak_test_start(lv_disp_t *disp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOAK_TEST_H
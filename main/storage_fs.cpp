@@ -0,0 +1,159 @@
+#include "storage_fs.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#if CONFIG_GOLDIE_STORAGE_FS_LITTLEFS
+#include "esp_littlefs.h"
+#else
+#include "esp_spiffs.h"
+#endif
+
+static const char *TAG = "storage_fs";
+
+#define STORAGE_FS_MAX_FILES   5
+#define STORAGE_FS_BENCH_CHUNK 4096
+
+static const char *const MOOD_DIRS[STORAGE_FS_MOODS] = { "happy", "sad", "angry" };
+
+static bool mood_dirs = false;   // <mood>/frameN.bin instead of frameN.bin
+
+extern "C" const char *storage_fs_name(void)
+{
+#if CONFIG_GOLDIE_STORAGE_FS_LITTLEFS
+    return "littlefs";
+#else
+    return "spiffs";
+#endif
+}
+
+extern "C" void storage_fs_frame_path(uint8_t frame_num, char *path, size_t path_len)
+{
+    if (mood_dirs) {
+        unsigned mood = (frame_num / STORAGE_FS_MOOD_FRAMES) % STORAGE_FS_MOODS;
+        snprintf(path, path_len, STORAGE_FS_BASE "/%s/frame%d.bin", MOOD_DIRS[mood],
+                 frame_num % STORAGE_FS_MOOD_FRAMES + 1);
+    } else {
+        snprintf(path, path_len, STORAGE_FS_BASE "/frame%d.bin", frame_num + 1);
+    }
+}
+
+static esp_err_t fs_register(size_t *total, size_t *used)
+{
+#if CONFIG_GOLDIE_STORAGE_FS_LITTLEFS
+    esp_vfs_littlefs_conf_t conf = {};
+    conf.base_path = STORAGE_FS_BASE;
+    conf.partition_label = STORAGE_FS_LABEL;
+    conf.format_if_mount_failed = false;
+    conf.dont_mount = false;
+
+    esp_err_t ret = esp_vfs_littlefs_register(&conf);
+    if (ret == ESP_OK) {
+        ret = esp_littlefs_info(STORAGE_FS_LABEL, total, used);
+    }
+    return ret;
+#else
+    esp_vfs_spiffs_conf_t conf = {
+        .base_path = STORAGE_FS_BASE,
+        .partition_label = STORAGE_FS_LABEL,
+        .max_files = STORAGE_FS_MAX_FILES,
+        .format_if_mount_failed = false
+    };
+
+    esp_err_t ret = esp_vfs_spiffs_register(&conf);
+    if (ret == ESP_OK) {
+        ret = esp_spiffs_info(STORAGE_FS_LABEL, total, used);
+    }
+    return ret;
+#endif
+}
+
+extern "C" esp_err_t storage_fs_mount(void)
+{
+    ESP_LOGI(TAG, "Mounting %s partition \"%s\" at %s", storage_fs_name(), STORAGE_FS_LABEL, STORAGE_FS_BASE);
+
+    size_t total = 0, used = 0;
+    esp_err_t ret = fs_register(&total, &used);
+    if (ret == ESP_ERR_NOT_FOUND) {
+        ESP_LOGE(TAG, "No \"%s\" partition", STORAGE_FS_LABEL);
+        return ret;
+    }
+    if (ret != ESP_OK) {
+        // Usually an image of the other filesystem: flash the one built
+        // for this configuration
+        ESP_LOGE(TAG, "Failed to mount %s (%s)", storage_fs_name(), esp_err_to_name(ret));
+        return ret;
+    }
+    ESP_LOGI(TAG, "%s: %d KB total, %d KB used", storage_fs_name(), (int)(total / 1024), (int)(used / 1024));
+
+    struct stat st;
+    mood_dirs = stat(STORAGE_FS_BASE "/frame1.bin", &st) != 0 &&
+                stat(STORAGE_FS_BASE "/happy/frame1.bin", &st) == 0;
+    if (mood_dirs) {
+        ESP_LOGI(TAG, "Frames in per-mood directories");
+    }
+    return ESP_OK;
+}
+
+extern "C" void storage_fs_benchmark(void)
+{
+    const int frames = STORAGE_FS_MOODS * STORAGE_FS_MOOD_FRAMES;
+    char path[48];
+
+    // Open: every frame file, as the storage task does on a mood cycle
+    int opened = 0;
+    int64_t open_total = 0, open_max = 0;
+    for (int i = 0; i < frames; i++) {
+        storage_fs_frame_path((uint8_t)i, path, sizeof(path));
+        int64_t t0 = esp_timer_get_time();
+        FILE *f = fopen(path, "rb");
+        int64_t dt = esp_timer_get_time() - t0;
+        if (f == NULL) {
+            continue;
+        }
+        fclose(f);
+        opened++;
+        open_total += dt;
+        if (dt > open_max) {
+            open_max = dt;
+        }
+    }
+    if (opened == 0) {
+        ESP_LOGW(TAG, "Benchmark: no frame files on %s", storage_fs_name());
+        return;
+    }
+
+    // Read: STORAGE_FS_BENCH_BYTES of frame data, roughly one raw frame
+    uint8_t *buf = (uint8_t *)heap_caps_malloc(STORAGE_FS_BENCH_CHUNK, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (buf == NULL) {
+        ESP_LOGW(TAG, "Benchmark: no memory for the read buffer");
+        return;
+    }
+    size_t read_bytes = 0;
+    int64_t read_total = 0;
+    for (int i = 0; i < frames && read_bytes < STORAGE_FS_BENCH_BYTES; i++) {
+        storage_fs_frame_path((uint8_t)i, path, sizeof(path));
+        FILE *f = fopen(path, "rb");
+        if (f == NULL) {
+            continue;
+        }
+        int64_t t0 = esp_timer_get_time();
+        size_t n;
+        while (read_bytes < STORAGE_FS_BENCH_BYTES &&
+               (n = fread(buf, 1, STORAGE_FS_BENCH_CHUNK, f)) > 0) {
+            read_bytes += n;
+        }
+        read_total += esp_timer_get_time() - t0;
+        fclose(f);
+    }
+    heap_caps_free(buf);
+
+    ESP_LOGI(TAG, "Benchmark (%s): open avg %d us / max %d us over %d files, "
+             "%u KB read in %d ms (%d KB/s)",
+             storage_fs_name(), (int)(open_total / opened), (int)open_max, opened,
+             (unsigned)(read_bytes / 1024), (int)(read_total / 1000),
+             read_total > 0 ? (int)((int64_t)read_bytes * 1000000 / 1024 / read_total) : 0);
+}
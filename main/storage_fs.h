@@ -0,0 +1,56 @@
+#ifndef STORAGE_FS_H
+#define STORAGE_FS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Storage partition ("storage", built from spiffs_image/) mounted at
+// STORAGE_FS_BASE. The filesystem is picked in menuconfig
+// (GOLDIE_STORAGE_FS): SPIFFS, or LittleFS (joltwallet/littlefs) with
+// fast opens and directories. The mount point is the same for both, so
+// nothing that reads assets needs to know which one is underneath.
+//
+// Frames may be flat (frameN.bin, N = 1..24) or one directory per mood
+// (happy/ sad/ angry/, frame1..8.bin each) - real directories on LittleFS,
+// slash-separated names on SPIFFS. The layout is detected once at mount;
+// storage_fs_frame_path() resolves either.
+
+#define STORAGE_FS_BASE         "/spiffs"
+#define STORAGE_FS_LABEL        "storage"
+#define STORAGE_FS_MOODS        3
+#define STORAGE_FS_MOOD_FRAMES  8
+#define STORAGE_FS_BENCH_BYTES  (300 * 1024)
+
+/**
+ * @brief Mount the storage partition with the configured filesystem
+ */
+esp_err_t storage_fs_mount(void);
+
+/**
+ * @brief "spiffs" or "littlefs"
+ */
+const char *storage_fs_name(void);
+
+/**
+ * @brief Path of animation frame frame_num (0-based) in the detected layout
+ */
+void storage_fs_frame_path(uint8_t frame_num, char *path, size_t path_len);
+
+/**
+ * @brief Log fopen() times of every frame file and the time to read
+ *        STORAGE_FS_BENCH_BYTES of frame data (GOLDIE_STORAGE_FS_BENCHMARK)
+ */
+void storage_fs_benchmark(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STORAGE_FS_H
@@ -0,0 +1,34 @@
+#include "web_server.h"
+#include "task_layout.h"
+#include "task_monitor.h"
+#include "esp_log.h"
+
+static const char *TAG = "web_server";
+
+static httpd_handle_t server = NULL;
+
+httpd_handle_t web_server_start(void)
+{
+    if (server != NULL) {
+        return server;
+    }
+
+    const task_layout_t *t = task_layout_get(TASK_ID_HTTPD);
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.task_priority = t->prio;
+    config.stack_size = t->stack;
+    config.core_id = (t->core < 0) ? tskNO_AFFINITY : t->core;
+    config.max_open_sockets = WEB_SERVER_SOCKETS;
+    config.max_uri_handlers = WEB_SERVER_URIS;
+    config.lru_purge_enable = true;
+
+    esp_err_t err = httpd_start(&server, &config);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start HTTP server: %s", esp_err_to_name(err));
+        server = NULL;
+        return NULL;
+    }
+    task_monitor_register(TASK_ID_HTTPD, xTaskGetHandle(t->name));
+    ESP_LOGI(TAG, "HTTP server on port %d", config.server_port);
+    return server;
+}
@@ -0,0 +1,26 @@
+#ifndef WEB_SERVER_H
+#define WEB_SERVER_H
+
+#include "esp_http_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The one esp_http_server instance (port 80) shared by the history export,
+// the LAN live dashboard and the device API; each registers its own URIs
+// on it. The server task's core / priority / stack come from the task
+// layout (TASK_ID_HTTPD). No authentication - trusted networks only.
+
+#define WEB_SERVER_SOCKETS  5     // An export plus a few live dashboards
+#define WEB_SERVER_URIS     18    // Routes across all users (16 registered today)
+
+// Start the server on first use (call after WiFi is connected)
+// Returns the handle, or NULL if it could not be started
+httpd_handle_t web_server_start(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WEB_SERVER_H
@@ -0,0 +1,245 @@
+#!/usr/bin/env python3
+"""
+Expand the binary log records sent over USB Serial/JTAG
+(components/task_coordinator/bin_log.h) into ESP_LOG-style lines.
+
+Each record is a 16-byte header - sync 0xB7, argument bytes, level | core
+<< 7, reserved, esp_timer µs (u32), format string address, tag address -
+followed by the arguments: 4 bytes per int / pointer / %c, 8 per 64-bit
+integer or floating point value, a length byte and the bytes for %s. The
+format and tag strings are read from the firmware ELF at those addresses,
+so it must be the ELF of the build that is running (the START record
+carries its SHA-256 and a mismatch is reported).
+
+Input is the serial port (needs pyserial) or a capture file, '-' for stdin.
+Bytes that are not a valid record are skipped until the next header.
+
+Usage:
+    python bin_log_decode.py build/goldie.elf /dev/ttyACM0
+    python bin_log_decode.py build/goldie.elf capture.bin [--core]
+"""
+
+import argparse
+import hashlib
+import re
+import struct
+import sys
+
+SYNC = 0xB7
+HDR_FMT = '<BBBBIII'             # Must match bin_log_hdr_t (16 bytes)
+HDR_SIZE = struct.calcsize(HDR_FMT)
+MAX_ARGS = 64                    # BIN_LOG_MAX_ARGS
+CTL_START, CTL_DROPPED = 1, 2    # bin_log_ctl_t
+LEVELS = {1: 'E', 2: 'W', 3: 'I', 4: 'D', 5: 'V'}
+
+SHF_ALLOC = 0x2
+SHT_PROGBITS = 1
+
+CONVERSION = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t|L)?([diouxXcsfFeEgGaAp%])')
+
+
+class Elf:
+    """Loaded sections of a little-endian ELF32, for reading strings by address"""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        self.sha256 = hashlib.sha256(self.data).digest()
+        if self.data[:4] != b'\x7fELF' or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError(f"{path}: not a little-endian ELF32 file")
+        shoff, = struct.unpack_from('<I', self.data, 0x20)
+        shentsize, shnum = struct.unpack_from('<HH', self.data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            _, sh_type, flags, addr, offset, size = struct.unpack_from('<IIIIII', self.data, shoff + i * shentsize)
+            if sh_type == SHT_PROGBITS and flags & SHF_ALLOC and addr and size:
+                self.sections.append((addr, addr + size, offset))
+        self.cache = {}
+
+    def string(self, addr):
+        """NUL-terminated string at a load address, None if no section holds it"""
+        if addr in self.cache:
+            return self.cache[addr]
+        text = None
+        for start, end, offset in self.sections:
+            if start <= addr < end:
+                pos = offset + addr - start
+                stop = self.data.find(b'\0', pos, offset + end - start)
+                if stop >= 0:
+                    text = self.data[pos:stop].decode('utf-8', 'replace')
+                break
+        self.cache[addr] = text
+        return text
+
+
+class Args:
+    def __init__(self, raw):
+        self.raw = raw
+        self.pos = 0
+
+    def take(self, fmt):
+        n = struct.calcsize(fmt)
+        if self.pos + n > len(self.raw):
+            raise IndexError
+        v, = struct.unpack_from(fmt, self.raw, self.pos)
+        self.pos += n
+        return v
+
+    def string(self):
+        n = self.take('<B')
+        if self.pos + n > len(self.raw):
+            raise IndexError
+        s = self.raw[self.pos:self.pos + n].decode('utf-8', 'replace')
+        self.pos += n
+        return s
+
+
+def expand(fmt, raw):
+    """printf on the host, consuming arguments the way BinLogRecord::put() wrote them"""
+    args = Args(raw)
+
+    def one(m):
+        flags, width, prec, length, conv = m.groups()
+        if conv == '%':
+            return '%'
+        try:
+            if width == '*':
+                width = str(args.take('<i'))
+            if prec == '*':
+                prec = str(args.take('<i'))
+            spec = '%' + flags + (width or '') + ('.' + prec if prec is not None else '')
+            wide = length in ('ll', 'j')
+            if conv in 'di':
+                v = args.take('<q' if wide else '<i')
+                if length == 'h':
+                    v = (v + 0x8000 & 0xFFFF) - 0x8000
+                elif length == 'hh':
+                    v = (v + 0x80 & 0xFF) - 0x80
+                return (spec + 'd') % v
+            if conv in 'ouxX':
+                v = args.take('<Q' if wide else '<I')
+                if length == 'h':
+                    v &= 0xFFFF
+                elif length == 'hh':
+                    v &= 0xFF
+                return (spec + ('d' if conv == 'u' else conv)) % v
+            if conv == 'c':
+                return (spec + 'c') % chr(args.take('<I') & 0xFF)
+            if conv == 's':
+                return (spec + 's') % args.string()
+            if conv == 'p':
+                return (spec + 's') % ('0x%x' % args.take('<I'))
+            v = args.take('<d')
+            return (spec + ('e' if conv in 'aA' else conv)) % v
+        except IndexError:
+            return '?'
+
+    return CONVERSION.sub(one, fmt)
+
+
+class Decoder:
+    def __init__(self, elf, show_core):
+        self.elf = elf
+        self.show_core = show_core
+        self.buf = bytearray()
+        self.last_us = None
+        self.high_us = 0
+        self.skipped = 0
+
+    def stamp_ms(self, time_us):
+        """Unwrap the 32-bit µs counter (wraps every 71 minutes)"""
+        if self.last_us is not None and time_us < self.last_us and self.last_us - time_us > 0x80000000:
+            self.high_us += 1 << 32
+        self.last_us = time_us
+        return (self.high_us + time_us) // 1000
+
+    def control(self, raw):
+        kind = raw[0] if raw else 0
+        if kind == CTL_START and len(raw) >= 33:
+            ok = raw[1:33] == self.elf.sha256
+            return '--- device connected' + ('' if ok else ' - WARNING: ELF does not match the running firmware')
+        if kind == CTL_DROPPED and len(raw) >= 5:
+            return '--- %d record(s) dropped (ring full)' % struct.unpack_from('<I', raw, 1)
+        return None
+
+    def feed(self, data):
+        """Lines for every complete record in data plus what was buffered"""
+        self.buf += data
+        out = []
+        while True:
+            start = self.buf.find(bytes([SYNC]))
+            if start < 0:
+                self.skipped += len(self.buf)
+                self.buf.clear()
+                break
+            self.skipped += start
+            del self.buf[:start]
+            if len(self.buf) < HDR_SIZE:
+                break
+            _, n, level, _, time_us, fmt_addr, tag_addr = struct.unpack_from(HDR_FMT, self.buf)
+            valid = n <= MAX_ARGS + 1 and (fmt_addr == 0 or (level & 0x7F) in LEVELS)
+            fmt = self.elf.string(fmt_addr) if valid and fmt_addr else None
+            tag = self.elf.string(tag_addr) if valid and fmt_addr else ''
+            if not valid or (fmt_addr and (fmt is None or tag is None)):
+                self.skipped += 1                  # Not a header: resync from the next byte
+                del self.buf[:1]
+                continue
+            if len(self.buf) < HDR_SIZE + n:
+                break
+            raw = bytes(self.buf[HDR_SIZE:HDR_SIZE + n])
+            del self.buf[:HDR_SIZE + n]
+            if self.skipped:
+                out.append('--- %d byte(s) skipped' % self.skipped)
+                self.skipped = 0
+            if fmt_addr == 0:
+                line = self.control(raw)
+                if line:
+                    out.append(line)
+                continue
+            core = ' [%d]' % (level >> 7) if self.show_core else ''
+            out.append('%s (%d)%s %s: %s' % (LEVELS[level & 0x7F], self.stamp_ms(time_us), core, tag,
+                                            expand(fmt, raw)))
+        return out
+
+
+def open_input(path):
+    if path == '-':
+        return sys.stdin.buffer
+    if path.startswith('/dev/') or path.upper().startswith('COM'):
+        try:
+            import serial
+        except ImportError:
+            sys.exit("Error: reading a serial port needs pyserial (pip install pyserial)")
+        return serial.Serial(path, timeout=0.2)   # USB Serial/JTAG ignores the baud rate
+    return open(path, 'rb')
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the binary log from USB Serial/JTAG")
+    parser.add_argument('elf', help="Firmware ELF of the running build")
+    parser.add_argument('input', help="Serial port, capture file or - for stdin")
+    parser.add_argument('--core', action='store_true', help="Show the core each record was written on")
+    args = parser.parse_args()
+
+    try:
+        decoder = Decoder(Elf(args.elf), args.core)
+    except (OSError, ValueError, struct.error) as e:
+        print(f"Error: {e}")
+        return 1
+    src = open_input(args.input)
+    try:
+        while True:
+            data = src.read(4096)
+            if not data:
+                if hasattr(src, 'in_waiting'):
+                    continue                       # Serial timeout: keep listening
+                break
+            for line in decoder.feed(data):
+                print(line, flush=True)
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
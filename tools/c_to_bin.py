@@ -2,13 +2,63 @@
 """
 Convert LVGL C array image files to raw binary files.
 Extracts RGB565 pixel data from C array declarations and saves as .bin files.
+
+With --format gfrm the frames are written as GFRM containers (see
+components/lvgl_ui/anim/frame_codec.h): a 32-byte header, a band offset
+table and RLE16-compressed row bands. Existing .bin dumps (raw or with a
+4-byte LVGL header) can be re-encoded by pointing the input at them.
+
+With --format indexed each mood's 8 frames share one 256-colour palette
+(exact when the mood uses no more colours, median cut otherwise) and are
+written as INDEXED8 containers: the palette, then RLE8 bands of one-byte
+indices, half the bytes of RGB565 before compression.
+
+With --format jpeg each frame is a baseline JPEG in a one-band container
+(--quality, 4:2:0 subsampling), around a tenth of RGB565. It is lossy, so
+there are no deltas and the frames are never pre-swapped: the firmware
+converts the decoder's RGB888 to whichever order it needs. Needs Pillow.
+
+With --timing FILE (gfrm, indexed, jpeg) each mood gets per-frame hold times and
+a loop point, written into the frame headers (hold_ms, FRAME_FLAG_LOOP_START):
+    {"happy": {"hold_ms": [800, 120, 80, 80, 120, 800, 2000, 0], "loop_start": 2},
+     "sad":   {"hold_ms": [3000]}}
+hold_ms lists frames 1-8 of the mood (missing or 0 = one period at the
+animation frame rate); loop_start is the 0-based frame the mood returns to
+after frame 8, earlier frames play once when the mood is entered.
 """
 
+import argparse
+from array import array
+from collections import Counter
+import json
 import re
+import struct
 import sys
 import os
 from pathlib import Path
 
+FRAME_WIDTH = 480
+FRAME_HEIGHT = 320
+
+GFRM_MAGIC = 0x4D524647  # "GFRM"
+GFRM_VERSION = 1
+GFRM_ENCODING_RAW = 0
+GFRM_ENCODING_RLE16 = 1
+GFRM_ENCODING_DELTA = 2
+GFRM_ENCODING_INDEXED8 = 3
+GFRM_ENCODING_JPEG = 4
+GFRM_PALETTE_SIZE = 256             # FRAME_PALETTE_SIZE in frame_codec.h
+GFRM_BASE_NONE = 0xFFFF
+GFRM_MAX_DIRTY_RECTS = 32           # FRAME_MAX_DIRTY_RECTS in frame_codec.h
+GFRM_RECT_FMT = '<HHHHII'           # frame_delta_rect_t
+FRAMES_PER_CATEGORY = 8
+MOOD_DIRS = ('happy', 'sad', 'angry')  # STORAGE_FS mood layout (main/storage_fs.h)
+GFRM_HEADER_FMT = '<IBBHHHHHIIHHI'  # Must match frame_container_header_t (32 bytes)
+GFRM_FLAG_NATIVE_ORDER = 0x0001     # Pixels already in panel byte order
+GFRM_FLAG_LOOP_START = 0x0002       # The mood loops back to this frame
+GFRM_FLAGS_OFFSET = 6               # frame_container_header_t.flags
+GFRM_HOLD_OFFSET = 26               # frame_container_header_t.hold_ms
+
 def parse_c_array(c_file_path):
     """
     Parse a C file containing LVGL image data and extract the pixel array.
@@ -45,9 +95,258 @@ def parse_c_array(c_file_path):
     print(f"  Extracted {len(pixel_data)} bytes from {c_file_path}")
     return pixel_data
 
-def convert_c_to_bin(c_file_path, output_dir):
+def read_legacy_bin(bin_path, width=FRAME_WIDTH, height=FRAME_HEIGHT):
+    """
+    Read an existing .bin frame dump and return the raw pixel bytes.
+    Strips the 4-byte LVGL image header if present.
+    """
+    data = Path(bin_path).read_bytes()
+    frame_bytes = width * height * 2
+    if len(data) == frame_bytes + 4:
+        hdr = struct.unpack('<I', data[:4])[0]
+        if ((hdr >> 10) & 0x7FF) == width and ((hdr >> 21) & 0x7FF) == height:
+            data = data[4:]
+    if len(data) != frame_bytes:
+        raise ValueError(f"{bin_path}: expected {frame_bytes} pixel bytes, got {len(data)}")
+    return data
+
+def swap_rgb565(data):
+    """
+    Swap the two bytes of every RGB565 pixel (little endian <-> panel order).
+    """
+    out = bytearray(data)
+    out[0::2], out[1::2] = data[1::2], data[0::2]
+    return bytes(out)
+
+def rle16_encode(data, unit=2):
+    """
+    Encode 16-bit pixels as RLE16 packets (unit=1: palette indices as RLE8).
+    ctrl & 0x80: run of (ctrl & 0x7F) + 1 copies of the following pixel
+    otherwise:   literal of (ctrl & 0x7F) + 1 pixels
+    """
+    pixels = [data[i:i + unit] for i in range(0, len(data), unit)]
+    out = bytearray()
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:128]
+            del literal[:128]
+            out.append(len(chunk) - 1)
+            out.extend(b''.join(chunk))
+
+    i = 0
+    n = len(pixels)
+    while i < n:
+        run = 1
+        while i + run < n and run < 128 and pixels[i + run] == pixels[i]:
+            run += 1
+        if run >= 2:
+            flush_literal()
+            out.append(0x80 | (run - 1))
+            out.extend(pixels[i])
+            i += run
+        else:
+            literal.append(pixels[i])
+            i += 1
+    flush_literal()
+    return bytes(out)
+
+def encode_gfrm(pixel_data, width=FRAME_WIDTH, height=FRAME_HEIGHT, band_rows=16,
+                encoding=GFRM_ENCODING_RLE16, flags=0):
+    """
+    Wrap raw RGB565 pixel bytes into a GFRM container.
+    """
+    row_bytes = width * 2
+    if len(pixel_data) != row_bytes * height:
+        raise ValueError(f"Pixel data is {len(pixel_data)} bytes, expected {row_bytes * height}")
+
+    band_count = (height + band_rows - 1) // band_rows
+    bands = []
+    for b in range(band_count):
+        raw = pixel_data[b * band_rows * row_bytes:(b + 1) * band_rows * row_bytes]
+        bands.append(rle16_encode(raw) if encoding == GFRM_ENCODING_RLE16 else raw)
+
+    offsets = [0]
+    for band in bands:
+        offsets.append(offsets[-1] + len(band))
+    payload = b''.join(bands)
+
+    header = struct.pack(GFRM_HEADER_FMT, GFRM_MAGIC, GFRM_VERSION, encoding, flags,
+                         width, height, band_rows, band_count,
+                         max(len(b) for b in bands), len(payload), GFRM_BASE_NONE, 0, 0)
+    table = struct.pack(f'<{band_count + 1}I', *offsets)
+    return header + table + payload
+
+def build_palette(frames):
+    """
+    One palette for a mood's frames (RGB565 bytes, little endian).
+    Returns (palette, {colour: index}); median cut when there are more
+    than GFRM_PALETTE_SIZE colours, each colour mapped to its box's mean.
+    """
+    hist = Counter()
+    for pixels in frames:
+        hist.update(array('H', pixels))
+    if len(hist) <= GFRM_PALETTE_SIZE:
+        palette = sorted(hist)
+        return palette, {c: i for i, c in enumerate(palette)}
+
+    def channels(c):
+        return (c >> 11, (c >> 5) & 0x3F, c & 0x1F)
+
+    boxes = [[(channels(c), c, n) for c, n in hist.items()]]
+    while len(boxes) < GFRM_PALETTE_SIZE:
+        # Split the box with the most pixels that still holds two colours
+        splittable = [b for b in boxes if len(b) > 1]
+        if not splittable:
+            break
+        box = max(splittable, key=lambda b: sum(e[2] for e in b))
+        boxes.remove(box)
+        spans = [max(e[0][k] for e in box) - min(e[0][k] for e in box) for k in range(3)]
+        axis = spans.index(max(spans))
+        box.sort(key=lambda e: e[0][axis])
+        half = sum(e[2] for e in box) / 2
+        acc = 0
+        cut = 1
+        for i, e in enumerate(box[:-1]):
+            acc += e[2]
+            cut = i + 1
+            if acc >= half:
+                break
+        boxes += [box[:cut], box[cut:]]
+
+    palette = []
+    lut = {}
+    for box in boxes:
+        total = sum(e[2] for e in box)
+        r, g, b = (round(sum(e[0][k] * e[2] for e in box) / total) for k in range(3))
+        for e in box:
+            lut[e[1]] = len(palette)
+        palette.append((r << 11) | (g << 5) | b)
+    return palette, lut
+
+def quantize(pixels, palette, lut):
+    """
+    RGB565 bytes -> (palette indices, the RGB565 bytes they stand for)
     """
-    Convert a single C file to BIN file.
+    indices = bytes(lut[c] for c in array('H', pixels))
+    return indices, array('H', (palette[i] for i in indices)).tobytes()
+
+def encode_gfrm_indexed(indices, palette, width=FRAME_WIDTH, height=FRAME_HEIGHT, band_rows=16, flags=0):
+    """
+    Wrap palette indices (one byte per pixel) into an INDEXED8 GFRM container.
+    `palette` is RGB565 little endian; flags NATIVE_ORDER stores it swapped.
+    """
+    if len(indices) != width * height:
+        raise ValueError(f"Index data is {len(indices)} bytes, expected {width * height}")
+
+    band_count = (height + band_rows - 1) // band_rows
+    bands = [rle16_encode(indices[b * band_rows * width:(b + 1) * band_rows * width], unit=1)
+             for b in range(band_count)]
+    offsets = [0]
+    for band in bands:
+        offsets.append(offsets[-1] + len(band))
+    payload = b''.join(bands)
+
+    lut = array('H', palette + [0] * (GFRM_PALETTE_SIZE - len(palette))).tobytes()
+    if flags & GFRM_FLAG_NATIVE_ORDER:
+        lut = swap_rgb565(lut)
+    header = struct.pack(GFRM_HEADER_FMT, GFRM_MAGIC, GFRM_VERSION, GFRM_ENCODING_INDEXED8, flags,
+                         width, height, band_rows, band_count,
+                         max(len(b) for b in bands), len(payload), GFRM_BASE_NONE, 0, 0)
+    table = struct.pack(f'<{band_count + 1}I', *offsets)
+    return header + lut + table + payload
+
+def encode_gfrm_jpeg(pixel_data, width=FRAME_WIDTH, height=FRAME_HEIGHT, quality=85):
+    """
+    Wrap RGB565 pixel bytes (little endian) as a baseline JPEG in a GFRM
+    container: one band of the whole frame, offset table {0, jpeg bytes}.
+    """
+    from io import BytesIO
+    from PIL import Image
+
+    if len(pixel_data) != width * height * 2:
+        raise ValueError(f"Pixel data is {len(pixel_data)} bytes, expected {width * height * 2}")
+    rgb = bytearray(width * height * 3)
+    for i, c in enumerate(array('H', pixel_data)):
+        # 5/6-bit fields back to 8 bits, low bits from the high ones
+        r, g, b = c >> 11, (c >> 5) & 0x3F, c & 0x1F
+        rgb[i * 3:i * 3 + 3] = bytes(((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)))
+    out = BytesIO()
+    # tjpgd decodes baseline only: no progressive, no restart markers needed
+    Image.frombytes('RGB', (width, height), bytes(rgb)).save(out, 'JPEG', quality=quality,
+                                                             subsampling='4:2:0', optimize=True)
+    jpeg = out.getvalue()
+    header = struct.pack(GFRM_HEADER_FMT, GFRM_MAGIC, GFRM_VERSION, GFRM_ENCODING_JPEG, 0,
+                         width, height, height, 1, len(jpeg), len(jpeg), GFRM_BASE_NONE, 0, 0)
+    return header + struct.pack('<2I', 0, len(jpeg)) + jpeg
+
+def dirty_rects(prev, cur, width=FRAME_WIDTH, height=FRAME_HEIGHT, band_rows=16):
+    """
+    Find the changed areas between two frames as (x, y, w, h) rects.
+    One rect per row band (tight column range), vertically merged when
+    neighbouring bands share the same columns.
+    """
+    row_bytes = width * 2
+    rects = []
+    for y0 in range(0, height, band_rows):
+        rows = min(band_rows, height - y0)
+        x_min, x_max = width, -1
+        for y in range(y0, y0 + rows):
+            a = prev[y * row_bytes:(y + 1) * row_bytes]
+            b = cur[y * row_bytes:(y + 1) * row_bytes]
+            if a == b:
+                continue
+            for x in range(width):
+                if a[x * 2:x * 2 + 2] != b[x * 2:x * 2 + 2]:
+                    x_min = min(x_min, x)
+                    break
+            for x in range(width - 1, -1, -1):
+                if a[x * 2:x * 2 + 2] != b[x * 2:x * 2 + 2]:
+                    x_max = max(x_max, x)
+                    break
+        if x_max < 0:
+            continue
+        if rects and rects[-1][0] == x_min and rects[-1][2] == x_max - x_min + 1 \
+                and rects[-1][1] + rects[-1][3] == y0:
+            x, y, w, h = rects[-1]
+            rects[-1] = (x, y, w, h + rows)
+        else:
+            rects.append((x_min, y0, x_max - x_min + 1, rows))
+    return rects
+
+def encode_gfrm_delta(prev, cur, base_frame, width=FRAME_WIDTH, height=FRAME_HEIGHT,
+                      band_rows=16, flags=0):
+    """
+    Encode `cur` as dirty rects on top of `prev` (frame index `base_frame`).
+    Returns None if the frames are too different for a delta to make sense.
+    """
+    rects = dirty_rects(prev, cur, width, height, band_rows)
+    if len(rects) > GFRM_MAX_DIRTY_RECTS:
+        return None
+
+    row_bytes = width * 2
+    blobs = []
+    for x, y, w, h in rects:
+        px = b''.join(cur[(y + r) * row_bytes + x * 2:(y + r) * row_bytes + (x + w) * 2] for r in range(h))
+        blobs.append(rle16_encode(px))
+
+    table = b''
+    offset = 0
+    for (x, y, w, h), blob in zip(rects, blobs):
+        table += struct.pack(GFRM_RECT_FMT, x, y, w, h, offset, len(blob))
+        offset += len(blob)
+    payload = b''.join(blobs)
+
+    header = struct.pack(GFRM_HEADER_FMT, GFRM_MAGIC, GFRM_VERSION, GFRM_ENCODING_DELTA, flags,
+                         width, height, 0, len(rects),
+                         max((len(b) for b in blobs), default=0), len(payload), base_frame, 0, 0)
+    return header + table + payload
+
+def convert_c_to_bin(c_file_path, output_dir, out_format='raw', band_rows=16, native_order=False,
+                     mood_dirs=False, quality=85):
+    """
+    Convert a single C file (or legacy .bin frame) to a BIN file.
     """
     c_path = Path(c_file_path)
     
@@ -56,17 +355,38 @@ def convert_c_to_bin(c_file_path, output_dir):
         return False
     
     try:
-        # Parse the C file
-        pixel_data = parse_c_array(c_path)
+        # Parse the C file, or re-read a legacy .bin dump
+        if c_path.suffix == '.bin':
+            pixel_data = read_legacy_bin(c_path)
+        else:
+            pixel_data = parse_c_array(c_path)
+
+        if native_order:
+            # Store pixels the way the panel wants them so the loader can skip its swap
+            pixel_data = swap_rgb565(pixel_data)
+
+        if out_format == 'gfrm':
+            raw_len = len(pixel_data)
+            flags = GFRM_FLAG_NATIVE_ORDER if native_order else 0
+            pixel_data = encode_gfrm(pixel_data, band_rows=band_rows, flags=flags)
+            print(f"  GFRM/RLE16: {raw_len} -> {len(pixel_data)} bytes "
+                  f"({100.0 * len(pixel_data) / raw_len:.1f}%)")
+        elif out_format == 'jpeg':
+            raw_len = len(pixel_data)
+            pixel_data = encode_gfrm_jpeg(pixel_data, quality=quality)
+            print(f"  GFRM/JPEG q{quality}: {raw_len} -> {len(pixel_data)} bytes "
+                  f"({100.0 * len(pixel_data) / raw_len:.1f}%)")
         
-        # Generate output filename (frame1.c -> frame1.bin)
-        bin_filename = c_path.stem + '.bin'
+        # Generate output filename (frame1.c -> frame1.bin, or happy/frame1.bin)
+        num = frame_number(c_path)
+        bin_filename = frame_file_name(num, mood_dirs) if num > 0 else c_path.stem + '.bin'
+
         bin_path = Path(output_dir) / bin_filename
         
         # Create output directory if needed
         bin_path.parent.mkdir(parents=True, exist_ok=True)
         
-        # Write binary file
+        # Write binary file (in-place re-encode of .bin input is allowed)
         with open(bin_path, 'wb') as f:
             f.write(pixel_data)
         
@@ -77,22 +397,201 @@ def convert_c_to_bin(c_file_path, output_dir):
         print(f"✗ Failed to convert {c_path}: {e}")
         return False
 
+def frame_number(path):
+    """frame12.bin -> 12, sad/frame4.bin -> 12"""
+    path = Path(path)
+    m = re.search(r'(\d+)$', path.stem)
+    num = int(m.group(1)) if m else 0
+    if path.parent.name in MOOD_DIRS:
+        num += MOOD_DIRS.index(path.parent.name) * FRAMES_PER_CATEGORY
+    return num
+
+def find_frames(input_dir, pattern):
+    """Frame files in the flat layout and/or the per-mood directories, frame 1 first"""
+    input_dir = Path(input_dir)
+    files = list(input_dir.glob(pattern))
+    for mood in MOOD_DIRS:
+        files += (input_dir / mood).glob(pattern)
+    return sorted(files, key=frame_number)
+
+def frame_file_name(num, mood_dirs=False):
+    """1-based frame number -> frameN.bin, or <mood>/frameN.bin"""
+    if mood_dirs:
+        return f"{MOOD_DIRS[(num - 1) // FRAMES_PER_CATEGORY]}/frame{(num - 1) % FRAMES_PER_CATEGORY + 1}.bin"
+    return f"frame{num}.bin"
+
+def read_frame(path):
+    """RGB565 bytes of a frame*.c array or a legacy .bin dump"""
+    return read_legacy_bin(path) if Path(path).suffix == '.bin' else parse_c_array(path)
+
+def convert_delta_sequence(files, output_dir, band_rows=16, native_order=False, mood_dirs=False,
+                           indexed=False):
+    """
+    Encode frames as keyframes (first of each mood) plus deltas where smaller.
+    With `indexed` the keyframes are INDEXED8 and the deltas are taken
+    between the quantized frames, so they land on what a keyframe decodes to.
+    Returns the number of frames written.
+    """
+    files = sorted(files, key=frame_number)
+    flags = GFRM_FLAG_NATIVE_ORDER if native_order else 0
+    moods = {}
+    if indexed:
+        for path in files:
+            moods.setdefault((frame_number(path) - 1) // FRAMES_PER_CATEGORY, []).append(path)
+        moods = {m: build_palette([read_frame(p) for p in paths]) for m, paths in moods.items()}
+    prev = None
+    written = 0
+    for path in files:
+        num = frame_number(path)          # 1-based file number
+        pixels = read_frame(path)
+        if indexed:
+            palette, lut = moods[(num - 1) // FRAMES_PER_CATEGORY]
+            indices, pixels = quantize(pixels, palette, lut)
+            key = encode_gfrm_indexed(indices, palette, band_rows=band_rows, flags=flags)
+        if native_order:
+            pixels = swap_rgb565(pixels)
+        if not indexed:
+            key = encode_gfrm(pixels, band_rows=band_rows, flags=flags)
+
+        blob, kind = key, 'key'
+        if prev is not None and (num - 1) % FRAMES_PER_CATEGORY != 0:
+            delta = encode_gfrm_delta(prev, pixels, num - 2, band_rows=band_rows, flags=flags)
+            if delta is not None and len(delta) < len(key):
+                blob, kind = delta, 'delta'
+
+        out_path = Path(output_dir) / frame_file_name(num, mood_dirs)
+        out_path.parent.mkdir(parents=True, exist_ok=True)
+        out_path.write_bytes(blob)
+        print(f"✓ {out_path.name}: {kind} {len(blob)} bytes")
+        prev = pixels
+        written += 1
+    return written
+
+def convert_indexed(files, output_dir, band_rows=16, native_order=False, mood_dirs=False):
+    """
+    Encode every frame as an INDEXED8 keyframe on its mood's shared palette.
+    Returns the number of frames written.
+    """
+    moods = {}
+    for path in sorted(files, key=frame_number):
+        moods.setdefault((frame_number(path) - 1) // FRAMES_PER_CATEGORY, []).append(path)
+    flags = GFRM_FLAG_NATIVE_ORDER if native_order else 0
+    written = 0
+    for mood, paths in moods.items():
+        frames = [read_frame(p) for p in paths]
+        palette, lut = build_palette(frames)
+        print(f"  Mood {mood}: {len(lut)} colours -> {len(palette)}-entry palette"
+              f"{'' if len(lut) <= GFRM_PALETTE_SIZE else ' (median cut)'}")
+        for path, pixels in zip(paths, frames):
+            indices, _ = quantize(pixels, palette, lut)
+            blob = encode_gfrm_indexed(indices, palette, band_rows=band_rows, flags=flags)
+            out_path = Path(output_dir) / frame_file_name(frame_number(path), mood_dirs)
+            out_path.parent.mkdir(parents=True, exist_ok=True)
+            out_path.write_bytes(blob)
+            print(f"✓ {out_path.name}: {len(pixels)} -> {len(blob)} bytes "
+                  f"({100.0 * len(blob) / len(pixels):.1f}%)")
+            written += 1
+    return written
+
+def load_timing(timing_path):
+    """
+    Timing JSON -> {0-based frame number: (hold_ms, loop_start flag)}
+    """
+    spec = json.loads(Path(timing_path).read_text())
+    timing = {}
+    for mood, entry in spec.items():
+        if mood not in MOOD_DIRS:
+            raise ValueError(f"unknown mood '{mood}' (one of {', '.join(MOOD_DIRS)})")
+        holds = entry.get('hold_ms', [])
+        loop_start = entry.get('loop_start', 0)
+        if len(holds) > FRAMES_PER_CATEGORY or not all(0 <= h <= 0xFFFF for h in holds):
+            raise ValueError(f"{mood}: hold_ms needs up to {FRAMES_PER_CATEGORY} values of 0-65535")
+        if not 0 <= loop_start < FRAMES_PER_CATEGORY:
+            raise ValueError(f"{mood}: loop_start must be 0-{FRAMES_PER_CATEGORY - 1}")
+        base = MOOD_DIRS.index(mood) * FRAMES_PER_CATEGORY
+        for i in range(FRAMES_PER_CATEGORY):
+            hold = holds[i] if i < len(holds) else 0
+            timing[base + i] = (hold, i == loop_start and loop_start != 0)
+    return timing
+
+def apply_timing(output_dir, timing, mood_dirs=False):
+    """
+    Patch hold_ms and FRAME_FLAG_LOOP_START into written GFRM headers.
+    Returns the number of frames updated.
+    """
+    updated = 0
+    for frame, (hold, loop_start) in sorted(timing.items()):
+        path = Path(output_dir) / frame_file_name(frame + 1, mood_dirs)
+        if not path.exists():
+            continue
+        data = bytearray(path.read_bytes())
+        if len(data) < struct.calcsize(GFRM_HEADER_FMT) or struct.unpack_from('<I', data)[0] != GFRM_MAGIC:
+            print(f"  ! {path.name}: no GFRM header, timing skipped")
+            continue
+        flags = struct.unpack_from('<H', data, GFRM_FLAGS_OFFSET)[0] & ~GFRM_FLAG_LOOP_START
+        struct.pack_into('<H', data, GFRM_FLAGS_OFFSET, flags | (GFRM_FLAG_LOOP_START if loop_start else 0))
+        struct.pack_into('<H', data, GFRM_HOLD_OFFSET, hold)
+        path.write_bytes(data)
+        updated += 1
+    return updated
+
 def main():
     """
     Main conversion function.
-    Usage: python c_to_bin.py [input_dir] [output_dir]
+    Usage: python c_to_bin.py [input_dir] [output_dir] [--format raw|gfrm|indexed|jpeg] [--band-rows N] [--native-order] [--delta]
+                              [--quality Q] [--mood-dirs] [--timing FILE]
     """
     # Default paths
     script_dir = Path(__file__).parent
     project_dir = script_dir.parent
-    input_dir = project_dir / 'components' / 'lvgl_ui'
-    output_dir = project_dir / 'sd_card_files' / 'frames'
-    
-    # Allow command-line override
-    if len(sys.argv) >= 2:
-        input_dir = Path(sys.argv[1])
-    if len(sys.argv) >= 3:
-        output_dir = Path(sys.argv[2])
+
+    parser = argparse.ArgumentParser(description="Convert LVGL C array frames to .bin files")
+    parser.add_argument('input_dir', nargs='?', default=project_dir / 'components' / 'lvgl_ui', type=Path)
+    parser.add_argument('output_dir', nargs='?', default=project_dir / 'sd_card_files' / 'frames', type=Path)
+    parser.add_argument('--format', choices=['raw', 'gfrm', 'indexed', 'jpeg'], default='raw',
+                        help="raw = plain RGB565 dump, gfrm = compressed GFRM container, "
+                             "indexed = GFRM with a 256-colour palette per mood, "
+                             "jpeg = GFRM holding a baseline JPEG")
+    parser.add_argument('--quality', type=int, default=85,
+                        help="JPEG quality 1-95 (jpeg only)")
+    parser.add_argument('--band-rows', type=int, default=16,
+                        help="Rows per independently decoded band (gfrm only)")
+    parser.add_argument('--from-bin', action='store_true',
+                        help="Read existing frame*.bin dumps instead of frame*.c arrays")
+    parser.add_argument('--delta', action='store_true',
+                        help="Store frames 2-8 of each mood as dirty rects on the previous frame "
+                             "when that is smaller than a keyframe (gfrm, indexed)")
+    parser.add_argument('--native-order', action='store_true',
+                        help="Pre-swap pixels into panel byte order and flag it in the header (gfrm, indexed)")
+    parser.add_argument('--mood-dirs', action='store_true',
+                        help="Write happy/ sad/ angry/ frame1-8.bin instead of flat frame1-24.bin")
+    parser.add_argument('--timing', type=Path,
+                        help="JSON of per-mood frame holds and loop points (gfrm, indexed, jpeg)")
+    args = parser.parse_args()
+
+    if args.native_order and args.format == 'raw':
+        print("Error: --native-order needs --format gfrm or indexed (raw dumps have no header to flag it)")
+        return 1
+    if args.delta and args.format == 'raw':
+        print("Error: --delta needs --format gfrm or indexed")
+        return 1
+    if args.format == 'jpeg' and (args.delta or args.native_order):
+        print("Error: --format jpeg takes neither --delta (lossy keyframes) nor --native-order "
+              "(the firmware converts to panel order itself)")
+        return 1
+    timing = None
+    if args.timing:
+        if args.format == 'raw':
+            print("Error: --timing needs --format gfrm, indexed or jpeg (raw dumps have no header to carry it)")
+            return 1
+        try:
+            timing = load_timing(args.timing)
+        except (OSError, ValueError) as e:
+            print(f"Error: bad --timing file: {e}")
+            return 1
+
+    input_dir = args.input_dir
+    output_dir = args.output_dir
     
     print("=" * 60)
     print("LVGL C Array to BIN Converter")
@@ -101,23 +600,34 @@ def main():
     print(f"Output directory: {output_dir}")
     print()
     
-    # Find all frame*.c files
-    c_files = sorted(input_dir.glob('frame*.c'))
+    # Find all frame*.c (or frame*.bin) files
+    pattern = 'frame*.bin' if args.from_bin else 'frame*.c'
+    c_files = find_frames(input_dir, pattern)
     
     if not c_files:
-        print(f"Error: No frame*.c files found in {input_dir}")
+        print(f"Error: No {pattern} files found in {input_dir}")
         return 1
     
     print(f"Found {len(c_files)} frame files to convert:")
     for f in c_files:
-        print(f"  - {f.name}")
+        print(f"  - {f.relative_to(input_dir)}")
     print()
     
     # Convert each file
     success_count = 0
-    for c_file in c_files:
-        if convert_c_to_bin(c_file, output_dir):
-            success_count += 1
+    if args.delta:
+        success_count = convert_delta_sequence(c_files, output_dir, args.band_rows, args.native_order,
+                                               args.mood_dirs, args.format == 'indexed')
+    elif args.format == 'indexed':
+        success_count = convert_indexed(c_files, output_dir, args.band_rows, args.native_order, args.mood_dirs)
+    else:
+        for c_file in c_files:
+            if convert_c_to_bin(c_file, output_dir, args.format, args.band_rows, args.native_order,
+                                args.mood_dirs, args.quality):
+                success_count += 1
+    
+    if timing:
+        print(f"Timing: hold / loop point set on {apply_timing(output_dir, timing, args.mood_dirs)} frame(s)")
     
     print()
     print("=" * 60)
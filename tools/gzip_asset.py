@@ -0,0 +1,29 @@
+#!/usr/bin/env python3
+"""
+Gzip a web asset for embedding in the firmware (main/CMakeLists.txt).
+
+The output is reproducible (no timestamp or file name in the header), so
+an unchanged page does not change the firmware image.
+
+Usage: gzip_asset.py <input> <output.gz>
+"""
+
+import gzip
+import sys
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__.strip(), file=sys.stderr)
+        return 1
+    with open(sys.argv[1], 'rb') as f:
+        data = f.read()
+    packed = gzip.compress(data, compresslevel=9, mtime=0)
+    with open(sys.argv[2], 'wb') as f:
+        f.write(packed)
+    print(f"{sys.argv[1]}: {len(data)} -> {len(packed)} bytes")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,205 @@
+// Microbenchmarks of the aquarium_core hot paths on the host: the mood
+// engine (single, batch, incremental), the history index, Gorilla blocks
+// and the frame decoders. Host numbers only rank changes against each
+// other; pixel_kernels_bench() and frame_bench time the device itself.
+//
+//   core_bench [iterations scale, default 1]
+
+#include "mood/mood_engine.h"
+#include "history/history_index.h"
+#include "codec/gorilla.h"
+#include "codec/frame_codec.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#define FRAME_W 480                     // The 3.5" panel, landscape
+#define FRAME_H 320
+
+static volatile uint32_t sink;          // Keeps results alive past the optimiser
+
+template <typename F>
+static void bench(const char *name, size_t iterations, size_t items, F fn)
+{
+    fn();                               // Warm the caches and the allocator
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        fn();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    printf("  %-28s %10.1f ns/op  %8.2f ns/item\n", name, ns / iterations, ns / iterations / items);
+}
+
+static aquarium_params_t sample_params(uint32_t now)
+{
+    aquarium_params_t p = {};
+    p.ammonia_ppm = 0.1f;
+    p.nitrite_ppm = 0.0f;
+    p.nitrate_ppm = 30.0f;
+    p.ph_level = 7.1f;
+    p.planned_feed_interval = 8 * 3600;
+    p.planned_water_change_interval = 7;
+    p.last_feed_time = now - 5 * 3600;
+    p.last_clean_time = now - 3 * 86400;
+    return p;
+}
+
+static void bench_mood(size_t scale)
+{
+    const uint32_t now = 1700000000;
+    mood_engine_set_preset(mood_engine_builtin(0));
+    aquarium_params_t p = sample_params(now);
+
+    bench("mood evaluate", 200000 * scale, 1, [&] {
+        p.nitrate_ppm += 0.01f;
+        sink = mood_engine_evaluate(&p, now).total_score;
+    });
+
+    const size_t n = 1024;
+    std::vector<float> nh3(n), no2(n), no3(n), ph(n);
+    std::vector<uint32_t> feed(n), clean(n);
+    for (size_t i = 0; i < n; i++) {
+        nh3[i] = (float)(i % 50) / 100.0f;
+        no2[i] = (float)(i % 30) / 100.0f;
+        no3[i] = (float)(i % 90);
+        ph[i] = 6.0f + (float)(i % 25) / 10.0f;
+        feed[i] = (uint32_t)(i * 97 % (20 * 3600));
+        clean[i] = (uint32_t)(i * 1013 % (12 * 86400));
+    }
+    mood_batch_in_t in = {};
+    in.ammonia_ppm = nh3.data();
+    in.nitrite_ppm = no2.data();
+    in.nitrate_ppm = no3.data();
+    in.ph_level = ph.data();
+    in.since_feed_s = feed.data();
+    in.since_clean_s = clean.data();
+    in.planned_feed_interval = 8 * 3600;
+    in.planned_water_change_interval = 7;
+    in.count = n;
+    std::vector<int8_t> total(n), worst(n);
+    std::vector<uint8_t> category(n);
+    mood_batch_out_t out = { total.data(), worst.data(), category.data() };
+    bench("mood batch x1024", 500 * scale, n, [&] {
+        sink = (uint32_t)mood_engine_evaluate_batch(&in, &out);
+    });
+
+    mood_engine_state_t st = {};
+    mood_engine_update(&st, &p, now);
+    uint32_t t = now;
+    bench("mood update (idle tick)", 1000000 * scale, 1, [&] {
+        sink = mood_engine_update(&st, NULL, ++t);
+    });
+}
+
+static void bench_history(size_t scale)
+{
+    time_t base = (time_t)history_civil_day(2024, 1, 1) * 86400;
+    time_t t = base;
+    int32_t day = history_day_of(base);
+    bench("history add + count", 200000 * scale, 1, [&] {
+        t += 4 * 3600;
+        history_index_add(HISTORY_FEED, t, NULL, 0);
+        sink = history_count(HISTORY_FEED, day + (int32_t)((t - base) / 86400));
+    });
+}
+
+static void bench_gorilla(size_t scale)
+{
+    static gorilla_block_t blk;
+    std::vector<uint32_t> times;
+    std::vector<float> values;
+    uint32_t t = 1700000000;
+    for (int i = 0; i < 4096; i++) {
+        t += 600 + (i % 7 == 0 ? 3 : 0);
+        times.push_back(t);
+        float v[3] = { 0.25f, 20.0f + (float)(i % 5), 7.0f + (float)(i % 3) * 0.1f };
+        values.insert(values.end(), v, v + 3);
+    }
+
+    size_t encoded = 0;
+    bench("gorilla encode block", 2000 * scale, 1, [&] {
+        gorilla_enc_t enc;
+        gorilla_enc_init(&enc, &blk, 3);
+        size_t i = 0;
+        while (i < times.size() && gorilla_enc_add(&enc, times[i], &values[i * 3])) {
+            i++;
+        }
+        gorilla_block_finish(&blk, true);
+        encoded = i;
+    });
+    printf("  %-28s %10zu samples in %zu bytes\n", "", encoded, sizeof(blk.data));
+
+    bench("gorilla decode block", 2000 * scale, encoded, [&] {
+        gorilla_dec_t dec;
+        gorilla_dec_init(&dec, &blk);
+        uint32_t dt;
+        float dv[3];
+        while (gorilla_dec_next(&dec, &dt, dv)) {
+            sink = dt;
+        }
+    });
+}
+
+// One frame's band of RLE16 or RLE8 packets: runs of water and gravel with
+// literal stretches of fish, as the asset tool produces them
+static std::vector<uint8_t> make_band(size_t pixels, size_t px_bytes)
+{
+    std::vector<uint8_t> band;
+    uint32_t seed = 12345;
+    size_t done = 0;
+    while (done < pixels) {
+        seed = seed * 1103515245u + 12345u;
+        size_t count = 1 + (seed >> 16) % 128;
+        count = count > pixels - done ? pixels - done : count;
+        bool run = (seed >> 8) & 3;
+        band.push_back((uint8_t)((run ? 0x80 : 0) | (count - 1)));
+        for (size_t i = 0; i < (run ? 1 : count) * px_bytes; i++) {
+            band.push_back((uint8_t)(seed >> (i % 3 * 8)));
+        }
+        done += count;
+    }
+    return band;
+}
+
+static void bench_frame(size_t scale)
+{
+    const size_t pixels = FRAME_W * FRAME_H;
+    std::vector<uint8_t> frame(pixels * 2);
+
+    std::vector<uint8_t> rle16 = make_band(pixels, 2);
+    bench("rle16 decode frame", 200 * scale, pixels, [&] {
+        sink = (uint32_t)frame_codec_decode_rle16(rle16.data(), rle16.size(), frame.data(), frame.size());
+    });
+
+    static uint16_t lut[FRAME_PALETTE_SIZE];
+    for (int i = 0; i < FRAME_PALETTE_SIZE; i++) {
+        lut[i] = (uint16_t)(i * 0x0101);
+    }
+    std::vector<uint8_t> idx8 = make_band(pixels, 1);
+    bench("idx8 decode frame", 200 * scale, pixels, [&] {
+        sink = (uint32_t)frame_codec_decode_idx8(idx8.data(), idx8.size(), lut, frame.data(), frame.size());
+    });
+
+    bench("swap rgb565 frame", 500 * scale, pixels, [&] {
+        frame_codec_swap_rgb565(frame.data(), frame.size());
+        sink = frame[0];
+    });
+}
+
+int main(int argc, char **argv)
+{
+    size_t scale = argc > 1 ? (size_t)atoi(argv[1]) : 1;
+    scale = scale == 0 ? 1 : scale;
+    setenv("TZ", "UTC0", 1);
+    tzset();
+
+    printf("aquarium_core, host:\n");
+    bench_mood(scale);
+    bench_history(scale);
+    bench_gorilla(scale);
+    bench_frame(scale);
+    return 0;
+}
@@ -0,0 +1,437 @@
+// Unit tests of aquarium_core on the host: mood scoring (single, batch and
+// incremental), the day-indexed history, Gorilla blocks and the GFRM frame
+// codec. Plain asserts with a count, no framework: ctest runs the binary
+// and a non-zero exit is a failure.
+
+#include "mood/mood_engine.h"
+#include "history/history_index.h"
+#include "history/history_store.h"
+#include "codec/gorilla.h"
+#include "codec/frame_codec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+static int checks = 0;
+static int failures = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        checks++;                                                            \
+        if (!(cond)) {                                                       \
+            failures++;                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        }                                                                    \
+    } while (0)
+
+// ───────────────────────────────────────────────────────────────────────────
+// Mood engine
+// ───────────────────────────────────────────────────────────────────────────
+
+static const uint32_t NOW = 1700000000;
+
+static aquarium_params_t ideal_params(void)
+{
+    aquarium_params_t p = {};
+    p.ammonia_ppm = 0.0f;
+    p.nitrite_ppm = 0.0f;
+    p.nitrate_ppm = 10.0f;
+    p.ph_level = 7.0f;
+    p.planned_feed_interval = 8 * 3600;
+    p.planned_water_change_interval = 7;
+    p.last_feed_time = NOW - 3600;
+    p.last_clean_time = NOW - 86400;
+    return p;
+}
+
+static void test_mood_single(void)
+{
+    CHECK(mood_engine_set_preset(mood_engine_builtin(0)));   // community
+
+    aquarium_params_t p = ideal_params();
+    mood_result_t r = mood_engine_evaluate(&p, NOW);
+    CHECK(r.total_score == 12);
+    CHECK(r.category == 0);
+
+    // Any critical factor is ANGRY, whatever the rest adds up to
+    p.ammonia_ppm = 1.0f;
+    r = mood_engine_evaluate(&p, NOW);
+    CHECK(r.ammonia_score == -2);
+    CHECK(r.category == 2);
+
+    // A warning rules out HAPPY
+    p = ideal_params();
+    p.ph_level = 5.8f;
+    r = mood_engine_evaluate(&p, NOW);
+    CHECK(r.ph_score == -1);
+    CHECK(r.category == 1);
+
+    // Band edges: nitrite 0.25 is still acceptable, 0.5 is critical
+    CHECK(mood_engine_score(MOOD_FACTOR_NITRITE, 0.0f, 1.0f) == 2);
+    CHECK(mood_engine_score(MOOD_FACTOR_NITRITE, 0.25f, 1.0f) == -1);
+    CHECK(mood_engine_score(MOOD_FACTOR_NITRITE, 0.5f, 1.0f) == -2);
+
+    // Feeding is scaled by the planned interval
+    CHECK(mood_engine_score(MOOD_FACTOR_FEED, 3600.0f, 8 * 3600.0f) == 2);
+    CHECK(mood_engine_score(MOOD_FACTOR_FEED, 20 * 3600.0f, 8 * 3600.0f) == -2);
+
+    // The compatibility wrapper scores exactly the same
+    p = ideal_params();
+    p.nitrate_ppm = 50.0f;
+    mood_result_t a = mood_engine_evaluate(&p, NOW);
+    mood_result_t b = calculate_mood_scores(p, NOW);
+    CHECK(memcmp(&a, &b, sizeof(a)) == 0);
+}
+
+static void test_mood_batch(void)
+{
+    const size_t n = 200;
+    std::vector<float> nh3(n), no2(n), no3(n), ph(n);
+    std::vector<uint32_t> feed(n), clean(n);
+    srand(1);
+    for (size_t i = 0; i < n; i++) {
+        nh3[i] = (float)(rand() % 100) / 100.0f;
+        no2[i] = (float)(rand() % 100) / 100.0f;
+        no3[i] = (float)(rand() % 120);
+        ph[i] = 5.0f + (float)(rand() % 40) / 10.0f;
+        feed[i] = (uint32_t)(rand() % (24 * 3600));
+        clean[i] = (uint32_t)(rand() % (14 * 86400));
+    }
+    mood_batch_in_t in = {};
+    in.ammonia_ppm = nh3.data();
+    in.nitrite_ppm = no2.data();
+    in.nitrate_ppm = no3.data();
+    in.ph_level = ph.data();
+    in.since_feed_s = feed.data();
+    in.since_clean_s = clean.data();
+    in.planned_feed_interval = 8 * 3600;
+    in.planned_water_change_interval = 7;
+    in.count = n;
+    std::vector<int8_t> total(n), worst(n);
+    std::vector<uint8_t> category(n);
+    mood_batch_out_t out = { total.data(), worst.data(), category.data() };
+    CHECK(mood_engine_evaluate_batch(&in, &out) == n);
+
+    // Every sample as the single evaluation scores it
+    size_t same = 0;
+    for (size_t i = 0; i < n; i++) {
+        aquarium_params_t p = ideal_params();
+        p.ammonia_ppm = nh3[i];
+        p.nitrite_ppm = no2[i];
+        p.nitrate_ppm = no3[i];
+        p.ph_level = ph[i];
+        p.last_feed_time = NOW - feed[i];
+        p.last_clean_time = NOW - clean[i];
+        mood_result_t r = mood_engine_evaluate(&p, NOW);
+        same += r.total_score == total[i] && r.category == category[i];
+    }
+    CHECK(same == n);
+}
+
+static void test_mood_incremental(void)
+{
+    mood_engine_state_t st = {};
+    aquarium_params_t p = ideal_params();
+    CHECK(mood_engine_update(&st, &p, NOW));
+    CHECK(st.rescored == (1 << MOOD_FACTOR_COUNT) - 1);
+    CHECK(st.result.category == 0);
+
+    // Same inputs, same time: nothing rescored, nothing changed
+    CHECK(!mood_engine_update(&st, &p, NOW));
+    CHECK(st.rescored == 0);
+
+    // One parameter: only its factor
+    p.nitrate_ppm = 60.0f;
+    CHECK(mood_engine_update(&st, &p, NOW));
+    CHECK(st.rescored == (1 << MOOD_FACTOR_NITRATE));
+
+    // Feeding crosses its first band 7 h from now (1x of 8 h, fed 1 h ago)
+    CHECK(st.next_change == NOW + 7 * 3600 + 1);
+    mood_result_t before = st.result;
+    CHECK(mood_engine_update(&st, NULL, st.next_change));
+    CHECK(st.result.feed_score < before.feed_score);
+    CHECK(st.rescored & (1 << MOOD_FACTOR_FEED));
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// History index
+// ───────────────────────────────────────────────────────────────────────────
+
+static void test_history_index(void)
+{
+    CHECK(history_civil_day(1970, 1, 1) == 0);
+    CHECK(history_civil_day(2000, 3, 1) == 11017);
+    CHECK(history_month_of(history_civil_day(2024, 2, 29)) == 2024 * 12 + 1);
+
+    time_t base = (time_t)history_civil_day(2024, 5, 1) * 86400 + 12 * 3600;
+    CHECK(history_day_of(base) == history_civil_day(2024, 5, 1));
+
+    // Two feeds a day for five days: the ring keeps the newest HISTORY_DEPTH
+    for (int d = 0; d < 5; d++) {
+        history_index_add(HISTORY_FEED, base + d * 86400, NULL, 0);
+        history_index_add(HISTORY_FEED, base + d * 86400 + 3600, NULL, 0);
+    }
+    int32_t day0 = history_day_of(base);
+    int kept = 0;
+    for (int d = 0; d < 5; d++) {
+        kept += history_count(HISTORY_FEED, day0 + d);
+    }
+    CHECK(kept == HISTORY_DEPTH);
+    CHECK(history_count(HISTORY_FEED, day0 + 4) == 2);
+    CHECK(history_count(HISTORY_FEED, day0 + 5) == 0);
+    CHECK(history_latest(HISTORY_FEED)->timestamp == base + 4 * 86400 + 3600);
+    CHECK(history_latest(HISTORY_FEED)->minute == 13 * 60);
+
+    // Days HISTORY_BUCKETS apart share a bucket but never each other's events
+    history_index_add(HISTORY_WATER, base, NULL, 0);
+    CHECK(history_count(HISTORY_WATER, day0 + HISTORY_BUCKETS) == 0);
+    CHECK(history_count(HISTORY_WATER, day0) == 1);
+    // No SD store on the host: the logged counts are the index's
+    CHECK(history_store_logged(HISTORY_FEED, day0 + 4) == 2);
+    CHECK(history_store_logged(HISTORY_WATER, day0) == 1);
+
+    const float values[HISTORY_VALUES] = { 0.25f, 20.0f, 0.0f, 6.8f, 7.2f };
+    const history_event_t *ev = history_index_add(HISTORY_PARAM, base, values, HISTORY_VALUES);
+    CHECK(ev != NULL && ev->value[HISTORY_HIGH_PH] == 7.2f);
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// Gorilla blocks
+// ───────────────────────────────────────────────────────────────────────────
+
+static void test_gorilla(void)
+{
+    static gorilla_block_t blk;
+    gorilla_enc_t enc;
+    gorilla_enc_init(&enc, &blk, 3);
+
+    std::vector<uint32_t> times;
+    std::vector<float> values;
+    uint32_t t = 1700000000;
+    for (int i = 0; i < 10000; i++) {
+        t += 600 + (i % 7 == 0 ? 3 : 0);
+        float v[3] = { 0.25f, 20.0f + (float)(i % 5), 7.0f + (float)(i % 3) * 0.1f };
+        if (!gorilla_enc_add(&enc, t, v)) {
+            break;
+        }
+        times.push_back(t);
+        values.insert(values.end(), v, v + 3);
+    }
+    gorilla_block_finish(&blk, true);
+    CHECK(blk.count == times.size());
+    CHECK(blk.count > 100);             // Steady series: far below 16 bytes a sample
+    CHECK(gorilla_block_ok(&blk));
+
+    gorilla_dec_t dec;
+    gorilla_dec_init(&dec, &blk);
+    size_t n = 0;
+    uint32_t dt;
+    float dv[3];
+    bool exact = true;
+    while (gorilla_dec_next(&dec, &dt, dv)) {
+        exact = exact && n < times.size() && dt == times[n] && memcmp(dv, &values[n * 3], sizeof(dv)) == 0;
+        n++;
+    }
+    CHECK(exact);
+    CHECK(n == times.size());
+
+    // A flipped bit fails the CRC
+    blk.data[10] ^= 0x04;
+    CHECK(!gorilla_block_ok(&blk));
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// Frame codec
+// ───────────────────────────────────────────────────────────────────────────
+
+static void put_run(std::vector<uint8_t> &out, int count, uint16_t px)
+{
+    out.push_back((uint8_t)(0x80 | (count - 1)));
+    out.push_back((uint8_t)px);
+    out.push_back((uint8_t)(px >> 8));
+}
+
+static void put_literal(std::vector<uint8_t> &out, const uint16_t *px, int count)
+{
+    out.push_back((uint8_t)(count - 1));
+    for (int i = 0; i < count; i++) {
+        out.push_back((uint8_t)px[i]);
+        out.push_back((uint8_t)(px[i] >> 8));
+    }
+}
+
+// GFRM file: header, optional palette, offset table, bands back to back
+static std::vector<uint8_t> container(uint8_t encoding, uint16_t width, uint16_t height, uint16_t band_rows,
+                                      const std::vector<std::vector<uint8_t>> &bands,
+                                      const uint16_t *palette = NULL)
+{
+    frame_container_header_t hdr = {};
+    hdr.magic = FRAME_CONTAINER_MAGIC;
+    hdr.version = FRAME_CONTAINER_VERSION;
+    hdr.encoding = encoding;
+    hdr.flags = FRAME_FLAG_NATIVE_ORDER;
+    hdr.width = width;
+    hdr.height = height;
+    hdr.band_rows = band_rows;
+    hdr.band_count = (uint16_t)bands.size();
+    hdr.base_frame = FRAME_BASE_NONE;
+
+    std::vector<uint32_t> offsets(1, 0);
+    std::vector<uint8_t> payload;
+    for (const std::vector<uint8_t> &b : bands) {
+        payload.insert(payload.end(), b.begin(), b.end());
+        offsets.push_back((uint32_t)payload.size());
+        hdr.max_band_bytes = b.size() > hdr.max_band_bytes ? (uint32_t)b.size() : hdr.max_band_bytes;
+    }
+    hdr.payload_size = (uint32_t)payload.size();
+
+    std::vector<uint8_t> file(sizeof(hdr));
+    memcpy(file.data(), &hdr, sizeof(hdr));
+    if (palette != NULL) {
+        file.insert(file.end(), (const uint8_t *)palette, (const uint8_t *)(palette + FRAME_PALETTE_SIZE));
+    }
+    file.insert(file.end(), (const uint8_t *)offsets.data(), (const uint8_t *)(offsets.data() + offsets.size()));
+    file.insert(file.end(), payload.begin(), payload.end());
+    return file;
+}
+
+static esp_err_t load(std::vector<uint8_t> &file, uint8_t *dst, size_t dst_size, uint16_t width,
+                      uint16_t height, bool swap)
+{
+    FILE *f = fmemopen(file.data(), file.size(), "rb");
+    esp_err_t err = frame_codec_load(f, dst, dst_size, width, height, swap, NULL);
+    fclose(f);
+    return err;
+}
+
+static void test_rle16(void)
+{
+    const uint16_t lit[3] = { 0x1111, 0x2222, 0x3333 };
+    std::vector<uint8_t> band;
+    put_run(band, 5, 0xABCD);
+    put_literal(band, lit, 3);
+
+    uint16_t out[8] = {};
+    CHECK(frame_codec_decode_rle16(band.data(), band.size(), (uint8_t *)out, sizeof(out)) == sizeof(out));
+    CHECK(out[0] == 0xABCD && out[4] == 0xABCD && out[5] == 0x1111 && out[7] == 0x3333);
+
+    // Short input, or more pixels than the output holds: malformed
+    CHECK(frame_codec_decode_rle16(band.data(), band.size() - 1, (uint8_t *)out, sizeof(out)) == 0);
+    CHECK(frame_codec_decode_rle16(band.data(), band.size(), (uint8_t *)out, sizeof(out) - 2) == 0);
+}
+
+static void test_container_rle16(void)
+{
+    // 4x3 in bands of 2 rows: rows 0-1 red, row 2 blue
+    std::vector<std::vector<uint8_t>> bands(2);
+    put_run(bands[0], 8, 0xF800);
+    put_run(bands[1], 4, 0x001F);
+    std::vector<uint8_t> file = container(FRAME_ENCODING_RLE16, 4, 3, 2, bands);
+
+    uint16_t frame[12] = {};
+    CHECK(load(file, (uint8_t *)frame, sizeof(frame), 4, 3, true) == ESP_OK);
+    CHECK(frame[0] == 0xF800 && frame[7] == 0xF800 && frame[8] == 0x001F && frame[11] == 0x001F);
+
+    // Not the size asked for
+    CHECK(load(file, (uint8_t *)frame, sizeof(frame), 3, 4, true) == ESP_ERR_INVALID_SIZE);
+
+    // Only the band holding row 2
+    memset(frame, 0, sizeof(frame));
+    uint16_t from = 2, to = 3;
+    FILE *f = fmemopen(file.data(), file.size(), "rb");
+    CHECK(frame_codec_load_rows(f, (uint8_t *)frame, sizeof(frame), 4, 3, true, &from, &to, NULL) == ESP_OK);
+    fclose(f);
+    CHECK(from == 2 && to == 3);
+    CHECK(frame[0] == 0 && frame[8] == 0x001F);
+}
+
+static void test_container_band_layout(void)
+{
+    // Height 10 in bands of 8 rows needs exactly 2 bands: a third one
+    // would start past the last row
+    std::vector<std::vector<uint8_t>> bands(3);
+    put_run(bands[0], 8 * 2, 0x1234);
+    put_run(bands[1], 2 * 2, 0x1234);
+    put_run(bands[2], 8 * 2, 0x1234);
+    std::vector<uint8_t> file = container(FRAME_ENCODING_RLE16, 2, 10, 8, bands);
+
+    std::vector<uint16_t> frame(2 * 10 + 64, 0x5A5A);
+    CHECK(load(file, (uint8_t *)frame.data(), 2 * 10 * 2, 2, 10, false) == ESP_ERR_INVALID_RESPONSE);
+    CHECK(frame[2 * 10] == 0x5A5A);     // Nothing written past the frame
+
+    bands.pop_back();
+    file = container(FRAME_ENCODING_RLE16, 2, 10, 8, bands);
+    CHECK(load(file, (uint8_t *)frame.data(), 2 * 10 * 2, 2, 10, false) == ESP_OK);
+    CHECK(frame[19] == 0x1234 && frame[20] == 0x5A5A);
+
+    // Too few bands
+    bands.pop_back();
+    file = container(FRAME_ENCODING_RLE16, 2, 10, 8, bands);
+    CHECK(load(file, (uint8_t *)frame.data(), 2 * 10 * 2, 2, 10, false) == ESP_ERR_INVALID_RESPONSE);
+}
+
+static void test_container_indexed8(void)
+{
+    static uint16_t palette[FRAME_PALETTE_SIZE];
+    for (int i = 0; i < FRAME_PALETTE_SIZE; i++) {
+        palette[i] = (uint16_t)(i * 0x0101);
+    }
+    // RLE8: the RLE16 packets with one-byte indices
+    std::vector<std::vector<uint8_t>> bands(1);
+    bands[0] = { 0x80 | 2, 7, 0x01, 9, 200 };
+    std::vector<uint8_t> file = container(FRAME_ENCODING_INDEXED8, 5, 1, 1, bands, palette);
+
+    uint16_t frame[5] = {};
+    CHECK(load(file, (uint8_t *)frame, sizeof(frame), 5, 1, true) == ESP_OK);
+    CHECK(frame[0] == 0x0707 && frame[2] == 0x0707 && frame[3] == 0x0909 && frame[4] == 200 * 0x0101);
+}
+
+static void test_container_jpeg(void)
+{
+    // JPEG decodes through the task coordinator's hook: none installed here
+    std::vector<std::vector<uint8_t>> bands(1, std::vector<uint8_t>(16, 0xFF));
+    std::vector<uint8_t> file = container(FRAME_ENCODING_JPEG, 4, 4, 4, bands);
+    uint16_t frame[16] = {};
+    CHECK(load(file, (uint8_t *)frame, sizeof(frame), 4, 4, false) == ESP_ERR_NOT_SUPPORTED);
+}
+
+static void test_legacy_raw(void)
+{
+    // No magic: raw RGB565, byte-swapped on request
+    std::vector<uint8_t> file;
+    for (int i = 0; i < 16; i++) {
+        file.push_back((uint8_t)i);
+        file.push_back(0xA0);
+    }
+    uint16_t frame[16] = {};
+    CHECK(load(file, (uint8_t *)frame, sizeof(frame), 4, 4, true) == ESP_OK);
+    CHECK(frame[3] == 0x03A0);
+    CHECK(load(file, (uint8_t *)frame, sizeof(frame), 4, 4, false) == ESP_OK);
+    CHECK(frame[3] == 0xA003);
+
+    file.resize(20);
+    CHECK(load(file, (uint8_t *)frame, sizeof(frame), 4, 4, false) == ESP_FAIL);
+}
+
+int main(void)
+{
+    setenv("TZ", "UTC0", 1);
+    tzset();
+
+    test_mood_single();
+    test_mood_batch();
+    test_mood_incremental();
+    test_history_index();
+    test_gorilla();
+    test_rle16();
+    test_container_rle16();
+    test_container_band_layout();
+    test_container_indexed8();
+    test_container_jpeg();
+    test_legacy_raw();
+
+    printf("%d checks, %d failed\n", checks, failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+// Host stand-in for what aquarium_core calls outside itself and the
+// simulator's platform does not cover: the storage devices are always
+// free.
+
+#include "io_sched.h"
+#include <string.h>
+
+extern "C" io_sched_dev_t io_sched_device_of(const char *path)
+{
+    return strncmp(path, "/sdcard", 7) == 0 ? IO_SCHED_SD : IO_SCHED_FLASH;
+}
+
+extern "C" bool io_sched_begin(io_sched_dev_t dev, io_sched_class_t cls, TickType_t wait)
+{
+    return true;
+}
+
+extern "C" void io_sched_end(io_sched_dev_t dev, io_sched_class_t cls)
+{
+}
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""
+Pack the animation frames (and optional extra assets) into one asset
+bundle (see main/asset_bundle.h), for an "assets" partition or as
+assets.bin on the storage partition or the SD card.
+
+Layout: 32-byte GAST header, the index (one 32-byte entry per asset id, in
+asset_id_t order, size 0 = absent), then every asset's bytes, 4-byte
+aligned. Each entry carries offset, size, type, format and the asset's
+CRC32; the header carries the CRC32 of the index.
+
+Frames are packed as they are on disk (raw, GFRM, indexed, JPEG or delta - see
+c_to_bin.py), so the firmware decodes them exactly as it would the
+separate frameN.bin files.
+
+Usage:
+    python make_asset_bundle.py [frames_dir] [output_file] [--asset ID=path ...]
+
+Copy the output to the storage image (spiffs_image/assets.bin) or the SD
+card root, or flash it to a partition labelled "assets":
+    parttool.py write_partition --partition-name assets --input assets.bin
+
+With the A/B slots of partitions_assets.csv, flash the first pack to
+assets_a; later packs are downloaded by the device (POST /api/assets with
+a url, see main/asset_ota.h), which stamps the generation itself.
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+from pathlib import Path
+
+from c_to_bin import find_frames, frame_number, FRAMES_PER_CATEGORY, MOOD_DIRS
+
+GAST_MAGIC = 0x54534147           # "GAST"
+GAST_VERSION = 1
+HEADER_FMT = '<IBBHIII12x'        # Must match asset_bundle_header_t (32 bytes)
+ENTRY_FMT = '<IIBBHI16s'          # Must match asset_entry_t (32 bytes)
+ALIGN = 4                         # ASSET_BUNDLE_ALIGN
+GFRM_MAGIC = 0x4D524647
+FORMAT_LEGACY = 0xFF              # ASSET_FORMAT_LEGACY
+
+# asset_id_t
+FRAME_COUNT = len(MOOD_DIRS) * FRAMES_PER_CATEGORY
+ASSET_IDS = {f'frame{n + 1}': n for n in range(FRAME_COUNT)}
+ASSET_IDS.update({
+    'splash': FRAME_COUNT,
+    'sound_ammonia': FRAME_COUNT + 1,
+    'sound_nitrite': FRAME_COUNT + 2,
+    'font_main': FRAME_COUNT + 3,
+})
+
+# asset_type_t
+TYPE_FRAME, TYPE_IMAGE, TYPE_PCM, TYPE_FONT, TYPE_BLOB = 1, 2, 3, 4, 5
+TYPE_OF = {'splash': TYPE_IMAGE, 'sound_ammonia': TYPE_PCM, 'sound_nitrite': TYPE_PCM,
+           'font_main': TYPE_FONT}
+
+def frame_format(data):
+    """GFRM encoding byte, or FORMAT_LEGACY for raw / LVGL .bin dumps"""
+    if len(data) >= 6 and struct.unpack_from('<I', data)[0] == GFRM_MAGIC:
+        return data[5]
+    return FORMAT_LEGACY
+
+def build_bundle(assets, generation=0):
+    """
+    assets: {asset id: (type, format, name, bytes)}. Returns the image.
+    """
+    count = max(assets) + 1 if assets else 0
+    data_start = struct.calcsize(HEADER_FMT) + count * struct.calcsize(ENTRY_FMT)
+    offset = (data_start + ALIGN - 1) & ~(ALIGN - 1)
+    entries = []
+    blobs = []
+    for i in range(count):
+        if i not in assets:
+            entries.append(struct.pack(ENTRY_FMT, 0, 0, 0, 0, 0, 0, b''))
+            continue
+        kind, fmt, name, data = assets[i]
+        entries.append(struct.pack(ENTRY_FMT, offset, len(data), kind, fmt, 0, zlib.crc32(data),
+                                   name.encode()[:16]))
+        pad = (-len(data)) % ALIGN
+        blobs.append((offset, data + b'\xff' * pad))
+        offset += len(data) + pad
+
+    index = b''.join(entries)
+    header = struct.pack(HEADER_FMT, GAST_MAGIC, GAST_VERSION, 0, count, zlib.crc32(index), offset,
+                         generation)
+    image = bytearray(header + index)
+    image += b'\xff' * (((data_start + ALIGN - 1) & ~(ALIGN - 1)) - len(image))
+    for at, blob in blobs:
+        assert len(image) == at
+        image += blob
+    return bytes(image)
+
+def main():
+    script_dir = Path(__file__).parent
+    project_dir = script_dir.parent
+
+    parser = argparse.ArgumentParser(description="Build the asset bundle (frames + extra assets)")
+    parser.add_argument('frames_dir', nargs='?', default=project_dir / 'spiffs_image', type=Path)
+    parser.add_argument('output_file', nargs='?', default=project_dir / 'assets.bin', type=Path)
+    parser.add_argument('--asset', action='append', default=[], metavar='ID=PATH',
+                        help=f"Extra asset, ID one of: {', '.join(k for k in ASSET_IDS if not k.startswith('frame'))}")
+    parser.add_argument('--generation', type=int, default=0,
+                        help="A/B slot generation (the higher valid slot is used at boot)")
+    args = parser.parse_args()
+
+    assets = {}
+    for path in find_frames(args.frames_dir, 'frame*.bin'):
+        num = frame_number(path)
+        if not 1 <= num <= FRAME_COUNT:
+            continue
+        data = path.read_bytes()
+        assets[num - 1] = (TYPE_FRAME, frame_format(data), path.name, data)
+        print(f"  + frame{num:<3} {len(data):8} bytes  {path.relative_to(args.frames_dir)}")
+
+    for spec in args.asset:
+        key, _, file_name = spec.partition('=')
+        if key not in ASSET_IDS or key.startswith('frame') or not file_name:
+            print(f"Error: bad --asset {spec}")
+            return 1
+        data = Path(file_name).read_bytes()
+        assets[ASSET_IDS[key]] = (TYPE_OF.get(key, TYPE_BLOB), 0, Path(file_name).name, data)
+        print(f"  + {key:<8} {len(data):8} bytes  {file_name}")
+
+    if not assets:
+        print(f"Error: no frame*.bin files in {args.frames_dir} and no --asset")
+        return 1
+
+    image = build_bundle(assets, args.generation)
+    args.output_file.write_bytes(image)
+    print(f"✓ {args.output_file}: {len(assets)} assets, {len(image)} bytes")
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
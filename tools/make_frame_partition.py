@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""
+Pack animation frames into a raw image for the memory-mapped "frames"
+partition (see partitions_frames.csv and components/lvgl_ui/anim/frame_map.h).
+
+Layout: 32-byte GMAP header, padding to DATA_OFFSET, then every frame as raw
+RGB565 in panel byte order (LV_COLOR_16_SWAP), frame1 first. The dashboard
+points LVGL straight at these bytes, so they are never decoded or swapped
+on the device.
+
+Usage:
+    python make_frame_partition.py [input_dir] [output_file] [--from-bin] [--already-native]
+
+Flash with the project (idf.py flash, when partitions_frames.csv is the
+partition table) or on its own:
+    parttool.py write_partition --partition-name frames --input frames_partition.bin
+"""
+
+import argparse
+import struct
+import sys
+from pathlib import Path
+
+from c_to_bin import (FRAME_WIDTH, FRAME_HEIGHT, parse_c_array, read_legacy_bin,
+                      swap_rgb565, find_frames)
+
+GMAP_MAGIC = 0x50414D47         # "GMAP"
+GMAP_VERSION = 1
+GMAP_FLAG_NATIVE = 0x0001
+GMAP_HEADER_FMT = '<IBBHHHHHII8x'  # Must match frame_map_header_t (32 bytes)
+DATA_OFFSET = 4096              # Keep frames sector aligned
+PARTITION_SIZE = 0x780000       # "frames" in partitions_frames.csv
+
+def load_pixels(path, from_bin):
+    frame_bytes = FRAME_WIDTH * FRAME_HEIGHT * 2
+    if from_bin:
+        return read_legacy_bin(path)
+    data = parse_c_array(path)
+    if len(data) != frame_bytes:
+        raise ValueError(f"{path}: expected {frame_bytes} pixel bytes, got {len(data)}")
+    return data
+
+def main():
+    script_dir = Path(__file__).parent
+    project_dir = script_dir.parent
+
+    parser = argparse.ArgumentParser(description="Build the memory-mapped frames partition image")
+    parser.add_argument('input_dir', nargs='?', default=project_dir / 'spiffs_image', type=Path)
+    parser.add_argument('output_file', nargs='?', default=project_dir / 'frames_partition.bin', type=Path)
+    parser.add_argument('--from-c', action='store_true',
+                        help="Read frame*.c arrays instead of frame*.bin dumps")
+    parser.add_argument('--already-native', action='store_true',
+                        help="Input is already in panel byte order (skip the swap)")
+    args = parser.parse_args()
+
+    pattern = 'frame*.c' if args.from_c else 'frame*.bin'
+    files = find_frames(args.input_dir, pattern)
+    if not files:
+        print(f"Error: No {pattern} files found in {args.input_dir}")
+        return 1
+
+    frame_bytes = FRAME_WIDTH * FRAME_HEIGHT * 2
+    stride = (frame_bytes + 3) & ~3
+    total = DATA_OFFSET + len(files) * stride
+    if total > PARTITION_SIZE:
+        print(f"Error: {len(files)} frames need {total} bytes, partition holds {PARTITION_SIZE}")
+        return 1
+
+    header = struct.pack(GMAP_HEADER_FMT, GMAP_MAGIC, GMAP_VERSION, 0, GMAP_FLAG_NATIVE,
+                         FRAME_WIDTH, FRAME_HEIGHT, len(files), 0, stride, DATA_OFFSET)
+    image = bytearray(header)
+    image += b'\xff' * (DATA_OFFSET - len(image))
+
+    for path in files:
+        pixels = load_pixels(path, not args.from_c)
+        if not args.already_native:
+            pixels = swap_rgb565(pixels)
+        image += pixels
+        image += b'\xff' * (stride - len(pixels))
+        print(f"  + {path.relative_to(args.input_dir)}")
+
+    args.output_file.write_bytes(image)
+    print(f"✓ {args.output_file}: {len(files)} frames, {len(image)} bytes")
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""
+Pack a medication product list into a raw image for the memory-mapped
+"meds" partition (see partitions.csv and
+components/aquarium_core/med/med_db.h).
+
+Layout: 96-byte GMED header with the prefix index, then every product as
+a 96-byte record with exactly the layout of med_product_t, sorted by
+case-folded name so the device searches the records in place. The index
+and order are built the way the firmware checks them.
+
+Usage:
+    python make_med_partition.py [output_file] [--json products.json]
+
+Without --json the generic treatments below are packed (the same as the
+firmware's built-ins). A JSON file holds a list of objects shaped like the
+entries of EXAMPLE_PRODUCTS: the label dose is `amount` `unit` per `per`
+`per_unit` of water.
+
+Flash on its own:
+    parttool.py write_partition --partition-name meds --input meds_partition.bin
+"""
+
+import argparse
+import json
+import struct
+import sys
+import zlib
+from pathlib import Path
+
+GMED_MAGIC = 0x44454D47          # "GMED"
+GMED_VERSION = 1
+BUCKETS = 39                     # MED_DB_BUCKETS
+HEADER_FMT = f'<IBBHHHI{BUCKETS + 1}H'  # Must match med_db_header_t (96 bytes)
+NAME_LEN = 36                    # MED_DB_NAME_LEN
+NOTE_LEN = 48                    # MED_DB_NOTE_LEN
+RECORD_FMT = f'<{NAME_LEN}sffBBH{NOTE_LEN}s'  # Must match med_product_t (96 bytes)
+RECORD_SIZE = 96
+PARTITION_SIZE = 64 * 1024       # "meds" in partitions*.csv
+
+# Order of med_unit_t
+UNITS = ['ml', 'tsp', 'tbsp', 'drops', 'fl oz', 'cups', 'g']
+
+EXAMPLE_PRODUCTS = [
+    {'name': 'Anti-parasitic', 'amount': 1.0, 'unit': 'ml', 'per': 1, 'per_unit': 'gal',
+     'note': 'Single dose, repeat after 48 hours if needed'},
+    {'name': 'Antibiotics', 'amount': 250.0, 'unit': 'ml', 'per': 1, 'per_unit': 'gal',
+     'note': 'Dose every 24h for 5 days, remove carbon'},
+    {'name': 'Fungal Treatment', 'amount': 2.5, 'unit': 'ml', 'per': 1, 'per_unit': 'gal',
+     'note': 'Treat every other day for 1 week'},
+    {'name': 'Ich Treatment', 'amount': 5.0, 'unit': 'ml', 'per': 1, 'per_unit': 'gal',
+     'note': 'Daily for 3 days, then 25% water change'},
+    {'name': 'Water Conditioner', 'amount': 2.0, 'unit': 'ml', 'per': 1, 'per_unit': 'gal',
+     'note': 'Use during water changes'},
+]
+
+def fold(raw):
+    return bytes(c + 32 if 65 <= c <= 90 else c for c in raw)
+
+def bucket(c):
+    # Same classes as med_db_bucket()
+    if c < 0x30:
+        return 0
+    if c <= 0x39:
+        return 1 + c - 0x30
+    if c < 0x61:
+        return 11
+    if c <= 0x7A:
+        return 12 + c - 0x61
+    return BUCKETS - 1
+
+def pack_text(text, size, where):
+    raw = text.encode('utf-8')
+    if len(raw) >= size:
+        raise ValueError(f"{where}: at most {size - 1} bytes")
+    return raw
+
+def pack_product(p):
+    name = p['name']
+    raw_name = pack_text(name, NAME_LEN, f"{name}: name")
+    if not raw_name:
+        raise ValueError("a product has no name")
+    note = pack_text(p.get('note', ''), NOTE_LEN, f"{name}: note")
+    if p.get('unit', 'ml') not in UNITS:
+        raise ValueError(f"{name}: unit must be one of {', '.join(UNITS)}")
+    per_unit = p.get('per_unit', 'L')
+    if per_unit not in ('L', 'gal'):
+        raise ValueError(f"{name}: per_unit must be L or gal")
+    amount, per = float(p['amount']), float(p['per'])
+    if amount <= 0 or per <= 0:
+        raise ValueError(f"{name}: amount and per must be positive")
+    record = struct.pack(RECORD_FMT, raw_name, amount, per, UNITS.index(p.get('unit', 'ml')),
+                         1 if per_unit == 'gal' else 0, 0, note)
+    assert len(record) == RECORD_SIZE
+    return fold(raw_name), record
+
+def main():
+    project_dir = Path(__file__).parent.parent
+
+    parser = argparse.ArgumentParser(description="Build the memory-mapped medication products partition image")
+    parser.add_argument('output_file', nargs='?', default=project_dir / 'meds_partition.bin', type=Path)
+    parser.add_argument('--json', type=Path, help="Products to pack (default: generic treatments)")
+    args = parser.parse_args()
+
+    products = json.loads(args.json.read_text()) if args.json else EXAMPLE_PRODUCTS
+    try:
+        packed = sorted(pack_product(p) for p in products)
+    except (KeyError, ValueError) as err:
+        print(f"Error: {err}")
+        return 1
+    for (a, _), (b, _) in zip(packed, packed[1:]):
+        if a == b:
+            print(f"Error: '{a.decode()}' is listed twice (names are case-insensitive)")
+            return 1
+    if len(packed) > 0xFFFF:
+        print("Error: too many products")
+        return 1
+
+    # First record of each leading-character bucket, then the count
+    index = []
+    r = 0
+    for b in range(BUCKETS):
+        while r < len(packed) and bucket(packed[r][0][0]) < b:
+            r += 1
+        index.append(r)
+    index.append(len(packed))
+
+    records = b''.join(record for _, record in packed)
+    header = struct.pack(HEADER_FMT, GMED_MAGIC, GMED_VERSION, 0, len(packed), RECORD_SIZE, 0,
+                         zlib.crc32(records) & 0xFFFFFFFF, *index)
+    image = header + records
+    if len(image) > PARTITION_SIZE:
+        print(f"Error: {len(packed)} products need {len(image)} bytes, partition holds {PARTITION_SIZE}")
+        return 1
+
+    args.output_file.write_bytes(image)
+    print(f"✓ {args.output_file}: {len(packed)} products, {len(image)} bytes")
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""
+Pack per-species mood profiles into a raw image for the memory-mapped
+"profiles" partition (see partitions.csv and
+components/lvgl_ui/mood/mood_profiles.h).
+
+Layout: 16-byte GPRF header, then every profile as a 248-byte record with
+exactly the layout of mood_preset_t, so the device uses the records in
+place. Limits are checked the way the firmware checks them (bands must
+nest) before anything is written.
+
+Usage:
+    python make_profile_partition.py [output_file] [--json profiles.json]
+
+Without --json the example profiles below are packed. A JSON file holds a
+list of objects shaped like the entries of EXAMPLE_PROFILES (null = no
+limit on that side).
+
+Flash on its own:
+    parttool.py write_partition --partition-name profiles --input profiles_partition.bin
+Select one at run time with dashboard_set_profile("<name>").
+"""
+
+import argparse
+import json
+import struct
+import sys
+import zlib
+from pathlib import Path
+
+GPRF_MAGIC = 0x46525047          # "GPRF"
+GPRF_VERSION = 1
+GPRF_HEADER_FMT = '<IBBHHHI'     # Must match mood_profiles_header_t (16 bytes)
+TABLE_FMT = '<3f3fBB4b2x'        # Must match mood_band_table_t (32 bytes)
+NAME_LEN = 24                    # MOOD_PRESET_NAME_LEN
+RECORD_SIZE = 248                # sizeof(mood_preset_t)
+PARTITION_SIZE = 64 * 1024       # "profiles" in partitions*.csv
+NO_LIMIT = 3.0e38                # MOOD_NO_LIMIT
+
+# Order of mood_factor_t
+FACTORS = ('ammonia', 'nitrite', 'nitrate', 'ph', 'feed', 'clean')
+
+# Shared by every profile unless overridden: ammonia / nitrite must be 0,
+# feed / clean limits are multiples of the planned interval
+DEFAULT_FACTORS = {
+    'ammonia': {'high': [0.0, 0.25, 0.5], 'high_incl': 0x6},
+    'nitrite': {'high': [0.0, 0.25, 0.5], 'high_incl': 0x6},
+    'feed':    {'high': [1.0, 1.5, 2.0]},
+    'clean':   {'high': [1.0, 1.2, 1.5]},
+}
+
+EXAMPLE_PROFILES = [
+    {
+        # Coldwater fancy goldfish: alkaline side, heavy waste producers
+        'name': 'goldfish', 'species': 'goldfish',
+        'feed_interval_s': 43200, 'water_change_days': 7,
+        'factors': {
+            'nitrate': {'high': [20, 40, 80], 'high_incl': 0x7},
+            'ph':      {'low': [7.0, 6.5, 6.0], 'high': [8.0, 8.4, 8.8]},
+        },
+    },
+    {
+        # Betta: soft to neutral water, small frequent meals
+        'name': 'betta', 'species': 'betta fish',
+        'feed_interval_s': 28800, 'water_change_days': 5,
+        'factors': {
+            'nitrate': {'high': [10, 20, 40], 'high_incl': 0x7},
+            'ph':      {'low': [6.5, 6.0, 5.5], 'high': [7.5, 8.0, 8.5]},
+        },
+    },
+    {
+        # Discus: warm, soft, very clean water
+        'name': 'discus', 'species': 'discus',
+        'feed_interval_s': 21600, 'water_change_days': 3,
+        'factors': {
+            'nitrate': {'high': [5, 10, 20], 'high_incl': 0x7},
+            'ph':      {'low': [6.0, 5.5, 5.0], 'high': [7.0, 7.4, 7.8]},
+        },
+    },
+]
+
+def limits(values, sign):
+    return [sign * NO_LIMIT if v is None else float(v) for v in values]
+
+def pack_table(spec, where):
+    low = limits(spec.get('low', [None] * 3), -1)
+    high = limits(spec.get('high', [None] * 3), 1)
+    score = spec.get('score', [2, 1, -1, -2])
+    if len(low) != 3 or len(high) != 3 or len(score) != 4:
+        raise ValueError(f"{where}: need 3 low, 3 high limits and 4 scores")
+    for i in range(1, 3):
+        if low[i] > low[i - 1] or high[i] < high[i - 1]:
+            raise ValueError(f"{where}: bands do not nest")
+    if low[0] > high[0] or any(s < -2 or s > 2 for s in score):
+        raise ValueError(f"{where}: empty ideal band or score outside -2..2")
+    return struct.pack(TABLE_FMT, *low, *high, spec.get('low_incl', 0), spec.get('high_incl', 0), *score)
+
+def pack_name(text, where):
+    raw = text.encode('utf-8')
+    if not raw or len(raw) >= NAME_LEN:
+        raise ValueError(f"{where}: must be 1-{NAME_LEN - 1} bytes")
+    return raw + b'\0' * (NAME_LEN - len(raw))
+
+def pack_profile(p):
+    name = p['name']
+    record = pack_name(name, f"{name}: name") + pack_name(p.get('species', name), f"{name}: species")
+    for factor in FACTORS:
+        spec = dict(DEFAULT_FACTORS.get(factor, {}))
+        spec.update(p.get('factors', {}).get(factor, {}))
+        if factor in ('feed', 'clean') and any(v is not None and v > 0 for v in spec.get('low', [])):
+            raise ValueError(f"{name}/{factor}: time factors only take upper limits")
+        record += pack_table(spec, f"{name}/{factor}")
+    record += struct.pack('<IHH', int(p.get('feed_interval_s', 0)), int(p.get('water_change_days', 0)), 0)
+    assert len(record) == RECORD_SIZE
+    return record
+
+def main():
+    project_dir = Path(__file__).parent.parent
+
+    parser = argparse.ArgumentParser(description="Build the memory-mapped species profiles partition image")
+    parser.add_argument('output_file', nargs='?', default=project_dir / 'profiles_partition.bin', type=Path)
+    parser.add_argument('--json', type=Path, help="Profiles to pack (default: built-in examples)")
+    args = parser.parse_args()
+
+    profiles = json.loads(args.json.read_text()) if args.json else EXAMPLE_PROFILES
+    try:
+        records = b''.join(pack_profile(p) for p in profiles)
+    except (KeyError, ValueError) as err:
+        print(f"Error: {err}")
+        return 1
+
+    header = struct.pack(GPRF_HEADER_FMT, GPRF_MAGIC, GPRF_VERSION, 0, len(profiles),
+                         RECORD_SIZE, 0, zlib.crc32(records) & 0xFFFFFFFF)
+    image = header + records
+    if len(image) > PARTITION_SIZE:
+        print(f"Error: {len(profiles)} profiles need {len(image)} bytes, partition holds {PARTITION_SIZE}")
+        return 1
+
+    args.output_file.write_bytes(image)
+    for p in profiles:
+        print(f"  + {p['name']} ({p.get('species', p['name'])})")
+    print(f"✓ {args.output_file}: {len(profiles)} profiles, {len(image)} bytes")
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -2,13 +2,48 @@
 """
 Convert PNG images to LVGL C arrays
 Requires: pip install pillow
+
+Usage:
+  python png_to_c.py                               # convert images/anim_frame_*.png
+  python png_to_c.py in.png out.c name [--swap]    # single image to C array
+  python png_to_c.py in.png out.bin --gfrm         # single frame to GFRM container
+
+--swap writes pixels in panel byte order (matches CONFIG_LV_COLOR_16_SWAP).
+GFRM output is always written in panel order and flagged as such, so the
+frame loader skips its byte swap.
 """
 
 from PIL import Image
+import argparse
 import sys
 import os
 
-def convert_png_to_c(png_path, output_path, var_name):
+def png_to_rgb565(png_path, swap=False):
+    """Return (width, height, bytes) of the image as RGB565"""
+    img = Image.open(png_path).convert('RGB')
+    width, height = img.size
+    out = bytearray()
+    for r, g, b in img.getdata():
+        rgb565 = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+        if swap:
+            out += bytes((rgb565 >> 8, rgb565 & 0xFF))
+        else:
+            out += bytes((rgb565 & 0xFF, rgb565 >> 8))
+    return width, height, bytes(out)
+
+def convert_png_to_gfrm(png_path, output_path, band_rows=16):
+    """Convert PNG to a native-order GFRM frame container"""
+    sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+    from c_to_bin import encode_gfrm, GFRM_FLAG_NATIVE_ORDER
+
+    width, height, data = png_to_rgb565(png_path, swap=True)
+    blob = encode_gfrm(data, width, height, band_rows=band_rows, flags=GFRM_FLAG_NATIVE_ORDER)
+    with open(output_path, 'wb') as f:
+        f.write(blob)
+    print(f"Converted {png_path} -> {output_path}")
+    print(f"  Size: {width}x{height}, GFRM: {len(blob)} bytes (raw {len(data)})")
+
+def convert_png_to_c(png_path, output_path, var_name, swap=False):
     """Convert PNG to LVGL C array format"""
     
     # Open image
@@ -38,9 +73,14 @@ def convert_png_to_c(png_path, output_path, var_name):
                 g6 = (g >> 2) & 0x3F
                 b5 = (b >> 3) & 0x1F
                 rgb565 = (r5 << 11) | (g6 << 5) | b5
-                # Little endian
-                pixel_data.append(f'0x{rgb565 & 0xFF:02x}')
-                pixel_data.append(f'0x{(rgb565 >> 8) & 0xFF:02x}')
+                if swap:
+                    # Panel byte order (LV_COLOR_16_SWAP)
+                    pixel_data.append(f'0x{(rgb565 >> 8) & 0xFF:02x}')
+                    pixel_data.append(f'0x{rgb565 & 0xFF:02x}')
+                else:
+                    # Little endian
+                    pixel_data.append(f'0x{rgb565 & 0xFF:02x}')
+                    pixel_data.append(f'0x{(rgb565 >> 8) & 0xFF:02x}')
         
         # Write data in rows of 16 bytes
         for i in range(0, len(pixel_data), 16):
@@ -67,6 +107,23 @@ def convert_png_to_c(png_path, output_path, var_name):
     print(f"  Size: {width}x{height}, Data: {len(pixel_data)} bytes")
 
 if __name__ == "__main__":
+    if len(sys.argv) > 1:
+        parser = argparse.ArgumentParser(description="Convert a PNG to an LVGL C array or GFRM frame")
+        parser.add_argument('png')
+        parser.add_argument('output')
+        parser.add_argument('var_name', nargs='?', default=None)
+        parser.add_argument('--swap', action='store_true', help="Emit panel byte order")
+        parser.add_argument('--gfrm', action='store_true', help="Write a GFRM .bin instead of C")
+        parser.add_argument('--band-rows', type=int, default=16)
+        args = parser.parse_args()
+
+        if args.gfrm:
+            convert_png_to_gfrm(args.png, args.output, args.band_rows)
+        else:
+            name = args.var_name or os.path.splitext(os.path.basename(args.output))[0]
+            convert_png_to_c(args.png, args.output, name, args.swap)
+        sys.exit(0)
+
     # Convert all 3 frames
     base_dir = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
     img_dir = os.path.join(base_dir, "components", "lvgl_ui", "images")
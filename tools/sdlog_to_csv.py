@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""
+Export the binary activity logs written by the SD logger
+(components/task_coordinator/sd_logger.h) to CSV.
+
+Input: <name>_YYYYMMDD.bin files from /sdcard/logs (medication, parameters,
+water_change, feed). Each is a sequence of 512-byte blocks of 32-byte
+records: timestamp u32, type u8, flags u8, reserved u16, 5 x float,
+CRC32 of the first 28 bytes. Unused slots are zero; a record with a bad
+CRC (torn by a power cut) ends its block.
+
+Output: <name>_YYYYMMDD.csv next to each input (or in --out), with the
+columns the firmware used to write as CSV. Times are printed in UTC,
+the zone the device runs in.
+
+Usage:
+    python sdlog_to_csv.py /path/to/sdcard/logs [more files or dirs] [--out DIR]
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+from datetime import datetime, timezone
+from pathlib import Path
+
+BLOCK_SIZE = 512                 # SD_LOG_BLOCK_SIZE
+RECORD_FMT = '<IBBH5fI'          # Must match sd_log_disk_record_t (32 bytes)
+RECORD_SIZE = struct.calcsize(RECORD_FMT)
+CRC_BYTES = RECORD_SIZE - 4
+
+# sd_log_type_t
+MEDICATION, PARAMETERS, WATER_CHANGE, FEED = 1, 2, 3, 4
+
+# flags of SD_LOG_MEDICATION
+MED_UNIT_MASK = 0x07
+MED_PER_GALLONS = 0x08
+MED_TANK_GALLONS = 0x10
+MED_UNITS = ('ml', 'tsp', 'tbsp', 'drops', 'fl oz', 'cups', 'g', 'g')
+
+
+def fmt_time(ts):
+    return datetime.fromtimestamp(ts, timezone.utc).strftime('%Y-%m-%d %H:%M:%S')
+
+
+def medication_row(ts, flags, v):
+    return '%s,%.2f,%s,%.2f,%s,%.2f,%s,%.2f,%.2f,%.2f' % (
+        fmt_time(ts), v[0], MED_UNITS[flags & MED_UNIT_MASK], v[1],
+        'gal' if flags & MED_PER_GALLONS else 'L', v[2],
+        'gal' if flags & MED_TANK_GALLONS else 'L', v[3], v[3] / 5.0, v[3] / 15.0)
+
+
+def parameters_row(ts, flags, v):
+    return '%s,%.3f,%.2f,%.3f,%.2f' % (fmt_time(ts), v[0], v[1], v[2], v[3])
+
+
+def count_row(ts, flags, v):
+    return '%s,%d' % (fmt_time(ts), int(round(v[0])))
+
+
+LOGS = {
+    MEDICATION: ('DateTime,ProductAmount,Unit,PerVolume,PerUnit,TankSize,TankUnit,DosageML,DosageTsp,DosageTbsp',
+                 medication_row),
+    PARAMETERS: ('DateTime,Ammonia_ppm,Nitrate_ppm,Nitrite_ppm,pH', parameters_row),
+    WATER_CHANGE: ('DateTime,PlannedIntervalDays', count_row),
+    FEED: ('DateTime,FeedsPerDay', count_row),
+}
+
+
+def read_records(path):
+    """Intact records of a file as (timestamp, type, flags, values), and the torn count"""
+    data = path.read_bytes()
+    torn = 0
+    records = []
+    for block in range(0, len(data), BLOCK_SIZE):
+        chunk = data[block:block + BLOCK_SIZE]
+        for off in range(0, len(chunk) - RECORD_SIZE + 1, RECORD_SIZE):
+            raw = chunk[off:off + RECORD_SIZE]
+            ts, rtype, flags, _, *rest = struct.unpack(RECORD_FMT, raw)
+            values, crc = rest[:5], rest[5]
+            if rtype == 0:
+                break
+            if rtype not in LOGS or crc != (zlib.crc32(raw[:CRC_BYTES]) & 0xFFFFFFFF):
+                torn += 1
+                break
+            records.append((ts, rtype, flags, values))
+    return records, torn
+
+
+def export(path, out_dir):
+    records, torn = read_records(path)
+    if not records:
+        print(f"  - {path.name}: no records" + (f" ({torn} torn)" if torn else ""))
+        return 0
+    header, row = LOGS[records[0][1]]
+    target = (out_dir or path.parent) / (path.stem + '.csv')
+    with open(target, 'w', newline='\n') as f:
+        f.write(header + '\n')
+        for ts, rtype, flags, values in records:
+            if rtype == records[0][1]:
+                f.write(row(ts, flags, values) + '\n')
+    print(f"  + {target}: {len(records)} rows" + (f", {torn} torn record(s) skipped" if torn else ""))
+    return len(records)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Export SD logger .bin files to CSV")
+    parser.add_argument('inputs', nargs='+', type=Path, help="Log files or directories holding them")
+    parser.add_argument('--out', type=Path, help="Output directory (default: next to each input)")
+    args = parser.parse_args()
+
+    files = []
+    for p in args.inputs:
+        files.extend(sorted(p.glob('*_????????.bin')) if p.is_dir() else [p])
+    if not files:
+        print("Error: no .bin log files found")
+        return 1
+    if args.out:
+        args.out.mkdir(parents=True, exist_ok=True)
+
+    total = sum(export(f, args.out) for f in files)
+    print(f"✓ {len(files)} file(s), {total} rows")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
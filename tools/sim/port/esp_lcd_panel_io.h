@@ -0,0 +1,39 @@
+#ifndef SIM_ESP_LCD_PANEL_IO_H
+#define SIM_ESP_LCD_PANEL_IO_H
+
+// Host stand-in for esp_lcd_panel_io.h: the simulator's window is the
+// panel, and a flush "leaves the bus" as soon as it has been copied there
+// (sim_panel_io_done)
+
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct sim_panel_io *esp_lcd_panel_io_handle_t;
+
+typedef struct {
+    int unused;
+} esp_lcd_panel_io_event_data_t;
+
+typedef bool (*esp_lcd_panel_io_color_trans_done_cb_t)(esp_lcd_panel_io_handle_t io,
+                                                       esp_lcd_panel_io_event_data_t *edata, void *user_ctx);
+
+typedef struct {
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+} esp_lcd_panel_io_callbacks_t;
+
+esp_err_t esp_lcd_panel_io_register_event_callbacks(esp_lcd_panel_io_handle_t io,
+                                                    const esp_lcd_panel_io_callbacks_t *cbs, void *user_ctx);
+
+// Simulator: the panel IO handle, and "transfer done" for one flush
+esp_lcd_panel_io_handle_t sim_panel_io(void);
+bool sim_panel_io_done(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_ESP_LCD_PANEL_IO_H
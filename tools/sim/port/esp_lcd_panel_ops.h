@@ -0,0 +1,19 @@
+#ifndef SIM_ESP_LCD_PANEL_OPS_H
+#define SIM_ESP_LCD_PANEL_OPS_H
+
+// Host stand-in for esp_lcd_panel_ops.h: no direct panel access (the
+// animation blit is off in the simulator)
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct sim_panel *esp_lcd_panel_handle_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_ESP_LCD_PANEL_OPS_H
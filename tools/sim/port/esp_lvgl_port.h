@@ -0,0 +1,30 @@
+#ifndef SIM_ESP_LVGL_PORT_H
+#define SIM_ESP_LVGL_PORT_H
+
+// Host stand-in for esp_lvgl_port.h: LVGL runs on the simulator's only
+// thread, so the lock is always free and the task never sleeps
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    LVGL_PORT_EVENT_DISPLAY = 1,
+    LVGL_PORT_EVENT_TOUCH = 2,
+    LVGL_PORT_EVENT_USER = 99,
+} lvgl_port_event_type_t;
+
+bool lvgl_port_lock(uint32_t timeout_ms);
+void lvgl_port_unlock(void);
+esp_err_t lvgl_port_task_wake(lvgl_port_event_type_t event, void *param);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_ESP_LVGL_PORT_H
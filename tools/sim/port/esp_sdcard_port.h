@@ -0,0 +1,20 @@
+#ifndef SIM_ESP_SDCARD_PORT_H
+#define SIM_ESP_SDCARD_PORT_H
+
+// Host stand-in for esp_sdcard_port.h: there is no card
+
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t esp_sdcard_port_mount(void);
+bool esp_sdcard_port_is_mounted(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
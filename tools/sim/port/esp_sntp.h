@@ -0,0 +1,6 @@
+#ifndef SIM_ESP_SNTP_H
+#define SIM_ESP_SNTP_H
+
+// Host stand-in for esp_sntp.h: the host clock is already set
+
+#endif // SIM_ESP_SNTP_H
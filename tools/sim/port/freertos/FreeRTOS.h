@@ -0,0 +1,48 @@
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+// Host stand-in for FreeRTOS: the simulator runs the UI on one thread, so
+// critical sections are empty and a tick is one millisecond
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE            0
+#define pdTRUE             1
+#define pdFAIL             pdFALSE
+#define pdPASS             pdTRUE
+#define portMAX_DELAY      ((TickType_t)0xffffffffUL)
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms)  ((TickType_t)(ms))
+#define portNUM_PROCESSORS 1
+
+typedef struct {
+    int unused;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED  {0}
+#define portENTER_CRITICAL(mux)       ((void)(mux))
+#define portEXIT_CRITICAL(mux)        ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux)   ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux)    ((void)(mux))
+#define portYIELD_FROM_ISR(...)       ((void)0)
+
+typedef struct sim_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_FREERTOS_H
@@ -0,0 +1,10 @@
+#ifndef SIM_FREERTOS_EVENT_GROUPS_H
+#define SIM_FREERTOS_EVENT_GROUPS_H
+
+// Host stand-in for FreeRTOS event groups (only the handle type is used)
+
+#include "FreeRTOS.h"
+
+typedef struct sim_event_group *EventGroupHandle_t;
+
+#endif // SIM_FREERTOS_EVENT_GROUPS_H
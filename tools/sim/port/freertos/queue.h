@@ -0,0 +1,29 @@
+#ifndef SIM_FREERTOS_QUEUE_H
+#define SIM_FREERTOS_QUEUE_H
+
+// Host stand-in for FreeRTOS queues: plain FIFOs; nothing else runs, so a
+// receive on an empty queue returns at once whatever the wait
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct sim_queue *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+void vQueueDelete(QueueHandle_t q);
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t wait);
+BaseType_t xQueueSendToBack(QueueHandle_t q, const void *item, TickType_t wait);
+BaseType_t xQueueOverwrite(QueueHandle_t q, const void *item);
+BaseType_t xQueueReceive(QueueHandle_t q, void *out, TickType_t wait);
+BaseType_t xQueuePeek(QueueHandle_t q, void *out, TickType_t wait);
+BaseType_t xQueueReset(QueueHandle_t q);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_FREERTOS_QUEUE_H
@@ -0,0 +1,24 @@
+#ifndef SIM_FREERTOS_TASK_H
+#define SIM_FREERTOS_TASK_H
+
+// Host stand-in for FreeRTOS tasks: no task is ever created (xTaskCreate
+// fails)
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+TickType_t xTaskGetTickCount(void);
+void vTaskDelay(TickType_t ticks);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg, UBaseType_t prio,
+                       TaskHandle_t *handle);
+void vTaskDelete(TaskHandle_t task);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_FREERTOS_TASK_H
@@ -0,0 +1,38 @@
+#ifndef SIM_MULTI_HEAP_H
+#define SIM_MULTI_HEAP_H
+
+// Host stand-in for multi_heap.h: a registered region only counts what is
+// allocated from it; the blocks themselves come from the C heap
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct multi_heap_info *multi_heap_handle_t;
+
+typedef struct {
+    size_t total_free_bytes;
+    size_t total_allocated_bytes;
+    size_t largest_free_block;
+    size_t minimum_free_bytes;
+    size_t allocated_blocks;
+    size_t free_blocks;
+    size_t total_blocks;
+} multi_heap_info_t;
+
+multi_heap_handle_t multi_heap_register(void *start, size_t size);
+void multi_heap_set_lock(multi_heap_handle_t heap, void *lock);
+void *multi_heap_malloc(multi_heap_handle_t heap, size_t size);
+void *multi_heap_realloc(multi_heap_handle_t heap, void *p, size_t size);
+void multi_heap_free(multi_heap_handle_t heap, void *p);
+size_t multi_heap_get_allocated_size(multi_heap_handle_t heap, void *p);
+void multi_heap_get_info(multi_heap_handle_t heap, multi_heap_info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_MULTI_HEAP_H
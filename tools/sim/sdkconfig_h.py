@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""
+Build the sdkconfig.h the PC simulator compiles against
+(tools/sim/CMakeLists.txt).
+
+Sources are applied in order, later ones winning:
+  1. defaults of the project's own Kconfig files (--kconfig; a default
+     with an "if" condition is skipped, choices take their default entry)
+  2. the sdkconfig files given, e.g. sdkconfig then sdkconfig.defaults
+y becomes 1, n or "is not set" leaves the option undefined, anything else
+is copied as is. The generated header includes sim_config.h last for the
+simulator's own overrides.
+
+Usage: sdkconfig_h.py -o <sdkconfig.h> [--kconfig Kconfig.projbuild ...] <sdkconfig> [...]
+"""
+
+import argparse
+import re
+import sys
+from pathlib import Path
+
+SET_RE = re.compile(r'^(CONFIG_[A-Za-z0-9_]+)=(.*)$')
+UNSET_RE = re.compile(r'^# (CONFIG_[A-Za-z0-9_]+) is not set')
+
+
+def value_of(raw):
+    return None if raw == 'n' else ('1' if raw == 'y' else raw)
+
+
+def kconfig_defaults(path, options):
+    name = None
+    choice = None                      # [entries, default] of the open choice
+    for line in Path(path).read_text().splitlines():
+        words = line.split()
+        if not words:
+            continue
+        if words[0] == 'choice':
+            choice = [[], None]
+            name = None
+        elif words[0] == 'endchoice' and choice is not None:
+            for entry in choice[0]:
+                options['CONFIG_' + entry] = '1' if entry == choice[1] else None
+            choice = None
+        elif words[0] in ('config', 'menuconfig') and len(words) > 1:
+            name = words[1]
+            if choice is not None:
+                choice[0].append(name)
+        elif words[0] == 'default' and 'if' not in words[2:]:
+            rest = line.split('default', 1)[1].strip()
+            if choice is not None and name is None:
+                choice[1] = choice[1] or rest
+            elif name is not None and 'CONFIG_' + name not in options:
+                options['CONFIG_' + name] = value_of(rest)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('-o', '--output', required=True)
+    parser.add_argument('--kconfig', action='append', default=[])
+    parser.add_argument('sdkconfig', nargs='+')
+    args = parser.parse_args()
+
+    options = {}
+    for path in args.kconfig:
+        kconfig_defaults(path, options)
+    for path in args.sdkconfig:
+        for line in Path(path).read_text().splitlines():
+            m = SET_RE.match(line)
+            if m:
+                options[m.group(1)] = value_of(m.group(2))
+                continue
+            m = UNSET_RE.match(line)
+            if m:
+                options[m.group(1)] = None
+
+    out = ['// Generated by tools/sim/sdkconfig_h.py - do not edit', '#pragma once', '']
+    out += [f'#define {k} {v}' for k, v in options.items() if v is not None]
+    out += ['', '#include "sim_config.h"', '']
+    text = '\n'.join(out)
+
+    path = Path(args.output)
+    if not path.exists() or path.read_text() != text:
+        path.parent.mkdir(parents=True, exist_ok=True)
+        path.write_text(text)          # Untouched when unchanged: no full rebuild
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,29 @@
+#pragma once
+
+// Simulator overrides, applied after the device configuration
+// (sdkconfig_h.py includes this at the end of the generated sdkconfig.h)
+
+// The per-screen render counters are what the simulator reports
+#undef CONFIG_GOLDIE_UI_PERF
+#define CONFIG_GOLDIE_UI_PERF 1
+#undef CONFIG_GOLDIE_UI_PERF_OVERLAY            // Its own refreshes would be counted
+#undef CONFIG_GOLDIE_UI_PERF_LOG_S
+
+// Nothing to trace to, no run time counters, no web server
+#undef CONFIG_GOLDIE_EVT_TRACE
+#undef CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+#undef CONFIG_GOLDIE_SCREEN_MIRROR
+#undef CONFIG_GOLDIE_MIRROR_TOUCH
+
+// Replays recordings (--replay); input_rec_init() is never called, so
+// nothing is recorded
+#undef CONFIG_GOLDIE_INPUT_REC
+#define CONFIG_GOLDIE_INPUT_REC 1
+
+// Host CPU: the Xtensa PIE kernels (pixel_kernels.h) fall back to C
+#undef CONFIG_IDF_TARGET_ESP32S3
+
+// The dashboard is profiled with its Ask Goldie view (main/ai_chat.cpp is
+// built in)
+#undef CONFIG_GOLDIE_AI
+#define CONFIG_GOLDIE_AI 1
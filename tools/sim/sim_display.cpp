@@ -0,0 +1,54 @@
+// Host panel IO and LVGL port for the simulator (headers in tools/sim/port).
+// Kept apart from sim_port.cpp, which the LVGL-free host tests link too.
+
+#include "esp_lcd_panel_io.h"
+#include "esp_lvgl_port.h"
+
+// ───────────────────────────────────────────────────────────────────────────
+// Panel IO and the LVGL port
+// ───────────────────────────────────────────────────────────────────────────
+
+struct sim_panel_io {
+    esp_lcd_panel_io_callbacks_t cbs;
+    void *user_ctx;
+};
+
+static struct sim_panel_io panel_io;     // sim_panel_io() hides the bare name
+
+extern "C" esp_err_t esp_lcd_panel_io_register_event_callbacks(esp_lcd_panel_io_handle_t io,
+                                                               const esp_lcd_panel_io_callbacks_t *cbs,
+                                                               void *user_ctx)
+{
+    io->cbs = *cbs;
+    io->user_ctx = user_ctx;
+    return ESP_OK;
+}
+
+extern "C" esp_lcd_panel_io_handle_t sim_panel_io(void)
+{
+    return &panel_io;
+}
+
+extern "C" bool sim_panel_io_done(void)
+{
+    if (panel_io.cbs.on_color_trans_done == NULL) {
+        return false;
+    }
+    esp_lcd_panel_io_event_data_t edata = {};
+    panel_io.cbs.on_color_trans_done(&panel_io, &edata, panel_io.user_ctx);
+    return true;
+}
+
+extern "C" bool lvgl_port_lock(uint32_t timeout_ms)
+{
+    return true;
+}
+
+extern "C" void lvgl_port_unlock(void)
+{
+}
+
+extern "C" esp_err_t lvgl_port_task_wake(lvgl_port_event_type_t event, void *param)
+{
+    return ESP_OK;                      // The main loop never sleeps long
+}
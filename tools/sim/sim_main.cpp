@@ -0,0 +1,396 @@
+// PC simulator of the dashboard: runs the real UI code (dashboard.cpp and
+// its widgets) on LVGL with a host display, tours the logical screens and
+// reports per-screen render time and object counts from ui_perf.h.
+//
+//   goldie_sim [--headless] [--redraws N] [--buffer-lines N] [--verbose]
+//              [--replay FILE]
+//
+// Headless (or built without SDL2) it prints the report and exits; with a
+// window it stays open after the tour for manual clicking and prints the
+// counters again when the window is closed. --replay feeds a recording
+// from the device (input_rec.h) through the UI in real time instead of
+// the tour, and reports the counters of that session.
+
+#include "dashboard.h"
+#include "task_coordinator.h"
+#include "input_rec.h"
+#include "ui/ui_perf.h"
+#include "ui/touch_rec.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "lvgl.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+#ifndef SIM_SDL
+#define SIM_SDL 0                       // CMakeLists.txt sets it when SDL2 is found
+#endif
+#if SIM_SDL
+#include <SDL.h>
+#endif
+
+#define SIM_HOR_RES         480         // EXAMPLE_LCD_H_RES on the device
+#define SIM_VER_RES         320
+#define SIM_SETTLE_MS       1500        // After dashboard_init: init timers, first layout
+#define SIM_SCROLL_MS       600         // One animated scroll step
+#define SIM_SCROLL_STEPS    8           // Give up on reaching the next section after this
+
+static const char *TAG = "sim";
+
+static std::vector<uint16_t> fb(SIM_HOR_RES * SIM_VER_RES);   // Native RGB565
+
+#if SIM_SDL
+static SDL_Window *window = NULL;
+static SDL_Renderer *renderer = NULL;
+static SDL_Texture *texture = NULL;
+static bool quit = false;
+static lv_point_t mouse_pt = {0, 0};
+static bool mouse_down = false;
+#endif
+static lv_indev_t *pointer = NULL;     // Touch stand-in: the mouse, or an idle one headless
+
+static void sim_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    int32_t w = lv_area_get_width(area);
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        uint16_t *row = &fb[(size_t)y * SIM_HOR_RES + area->x1];
+        for (int32_t x = 0; x < w; x++, color_p++) {
+            uint16_t c = color_p->full;
+#if LV_COLOR_16_SWAP
+            c = (uint16_t)((c >> 8) | (c << 8));
+#endif
+            row[x] = c;
+        }
+    }
+#if SIM_SDL
+    if (texture != NULL && lv_disp_flush_is_last(drv)) {
+        SDL_UpdateTexture(texture, NULL, fb.data(), SIM_HOR_RES * sizeof(uint16_t));
+        SDL_RenderClear(renderer);
+        SDL_RenderCopy(renderer, texture, NULL, NULL);
+        SDL_RenderPresent(renderer);
+    }
+#endif
+    // The panel IO "transfer" is done at once; ui_perf's callback releases
+    // the buffer as on the device
+    if (!sim_panel_io_done()) {
+        lv_disp_flush_ready(drv);
+    }
+}
+
+#if SIM_SDL
+static void sim_mouse_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
+{
+    data->point = mouse_pt;
+    data->state = mouse_down ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+static void sdl_poll(void)
+{
+    SDL_Event e;
+    while (SDL_PollEvent(&e)) {
+        switch (e.type) {
+        case SDL_QUIT:
+            quit = true;
+            break;
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            mouse_down = e.type == SDL_MOUSEBUTTONDOWN;
+            mouse_pt.x = (lv_coord_t)e.button.x;
+            mouse_pt.y = (lv_coord_t)e.button.y;
+            break;
+        case SDL_MOUSEMOTION:
+            mouse_pt.x = (lv_coord_t)e.motion.x;
+            mouse_pt.y = (lv_coord_t)e.motion.y;
+            break;
+        case SDL_MOUSEWHEEL:
+            dashboard_scroll_step(e.wheel.y < 0 ? 1 : -1);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static bool sdl_init(void)
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        ESP_LOGW(TAG, "SDL: %s - running headless", SDL_GetError());
+        return false;
+    }
+    window = SDL_CreateWindow("Goldie dashboard", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SIM_HOR_RES,
+                              SIM_VER_RES, 0);
+    renderer = window ? SDL_CreateRenderer(window, -1, 0) : NULL;
+    texture = renderer ? SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGB565, SDL_TEXTUREACCESS_STREAMING,
+                                           SIM_HOR_RES, SIM_VER_RES)
+                       : NULL;
+    if (texture == NULL) {
+        ESP_LOGW(TAG, "SDL: %s - running headless", SDL_GetError());
+        return false;
+    }
+    static lv_indev_drv_t indev_drv;
+    lv_indev_drv_init(&indev_drv);
+    indev_drv.type = LV_INDEV_TYPE_POINTER;
+    indev_drv.read_cb = sim_mouse_read;
+    pointer = lv_indev_drv_register(&indev_drv);
+    return true;
+}
+#endif
+
+static void idle_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
+{
+    data->state = LV_INDEV_STATE_RELEASED;
+}
+
+/**
+ * @brief Run LVGL and the esp_timer stand-ins in real time for `ms`
+ */
+static void run_for(uint32_t ms)
+{
+    using clock = std::chrono::steady_clock;
+    auto end = clock::now() + std::chrono::milliseconds(ms);
+    auto last = clock::now();
+    while (clock::now() < end) {
+        auto now = clock::now();
+        uint32_t elapsed = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - last).count();
+        if (elapsed > 0) {
+            lv_tick_inc(elapsed);
+            last += std::chrono::milliseconds(elapsed);
+        }
+#if SIM_SDL
+        if (texture != NULL) {
+            sdl_poll();
+            if (quit) {
+                return;
+            }
+        }
+#endif
+        sim_timers_run();
+        uint32_t next = lv_timer_handler();
+        std::this_thread::sleep_for(std::chrono::milliseconds(next < 5 ? next : 5));
+    }
+}
+
+static uint32_t count_objs(lv_obj_t *obj, bool visible_only)
+{
+    uint32_t n = !visible_only || lv_obj_is_visible(obj) ? 1 : 0;
+    uint32_t children = lv_obj_get_child_cnt(obj);
+    for (uint32_t i = 0; i < children; i++) {
+        n += count_objs(lv_obj_get_child(obj, (int32_t)i), visible_only);
+    }
+    return n;
+}
+
+static uint32_t count_all(bool visible_only)
+{
+    return count_objs(lv_scr_act(), visible_only) + count_objs(lv_layer_top(), visible_only) +
+           count_objs(lv_layer_sys(), visible_only);
+}
+
+typedef struct {
+    bool seen;
+    uint32_t redraws;
+    uint64_t render_us;
+    uint32_t render_max_us;
+    uint64_t pixels;
+    uint32_t objs_visible;
+} sim_result_t;
+
+/**
+ * @brief Full redraws of whatever shows now, counted against its screen
+ */
+static void profile_screen(sim_result_t *res, int redraws)
+{
+    ui_perf_screen_t screen = ui_perf_screen();
+    ui_perf_stats_t before = {};
+    ui_perf_stats_t after = {};
+    ui_perf_get(screen, &before);
+    for (int i = 0; i < redraws; i++) {
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(NULL);
+    }
+    ui_perf_get(screen, &after);
+
+    sim_result_t *r = &res[screen];
+    r->seen = true;
+    r->redraws = after.refreshes - before.refreshes;
+    r->render_us = after.render_us - before.render_us;
+    r->render_max_us = after.render_max_us;            // Since boot: includes the tour's own refreshes
+    r->pixels = after.pixels - before.pixels;
+    r->objs_visible = count_all(true);
+}
+
+/**
+ * @brief Scroll down the page section by section, profiling each one
+ */
+static void tour(sim_result_t *res, int redraws)
+{
+    profile_screen(res, redraws);
+    for (int step = 0; step < SIM_SCROLL_STEPS; step++) {
+        ui_perf_screen_t was = ui_perf_screen();
+        dashboard_scroll_step(1);
+        run_for(SIM_SCROLL_MS);
+        ui_perf_screen_t now = ui_perf_screen();
+        if (now != was && !res[now].seen) {
+            profile_screen(res, redraws);
+        }
+        if (now == UI_PERF_SCREEN_PANEL) {
+            break;
+        }
+    }
+    // Back to the top so an interactive session starts at home
+    for (int step = 0; step < SIM_SCROLL_STEPS && ui_perf_screen() != UI_PERF_SCREEN_ANIMATION; step++) {
+        dashboard_scroll_step(-1);
+        run_for(SIM_SCROLL_MS);
+    }
+}
+
+static void report(const sim_result_t *res)
+{
+    printf("\n%-10s %8s %10s %10s %10s %8s\n", "screen", "redraws", "avg us", "max us", "kpx/redraw", "objects");
+    for (int s = 0; s < UI_PERF_SCREEN_COUNT; s++) {
+        const sim_result_t *r = &res[s];
+        if (!r->seen || r->redraws == 0) {
+            continue;
+        }
+        printf("%-10s %8u %10u %10u %10u %8u\n", ui_perf_screen_name((ui_perf_screen_t)s), (unsigned)r->redraws,
+               (unsigned)(r->render_us / r->redraws), (unsigned)r->render_max_us,
+               (unsigned)(r->pixels / r->redraws / 1000), (unsigned)r->objs_visible);
+    }
+    printf("objects in total: %u (screen, top and system layers)\n\n", (unsigned)count_all(false));
+}
+
+/**
+ * @brief Run a recording through the UI at its recorded pace
+ */
+static bool replay(const char *path)
+{
+    if (pointer == NULL) {
+        static lv_indev_drv_t indev_drv;
+        lv_indev_drv_init(&indev_drv);
+        indev_drv.type = LV_INDEV_TYPE_POINTER;
+        indev_drv.read_cb = idle_read;
+        pointer = lv_indev_drv_register(&indev_drv);
+    }
+    touch_rec_init(pointer);
+    if (!input_rec_replay_open(path)) {
+        return false;
+    }
+    // Bus events have no subscribers here (sim_stubs.cpp): touches,
+    // parameters, activity and inbox posts drive the UI
+    uint32_t wait;
+    while ((wait = input_rec_replay_poll()) != INPUT_REC_DONE) {
+        run_for(wait < 5 ? 5 : (wait > 100 ? 100 : wait));
+#if SIM_SDL
+        if (quit) {
+            break;
+        }
+#endif
+    }
+    run_for(SIM_SETTLE_MS);
+    return true;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [--headless] [--redraws N] [--buffer-lines N] [--verbose] [--replay FILE]\n",
+            argv0);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    bool headless = !SIM_SDL;
+    int redraws = 20;
+    int buffer_lines = SIM_VER_RES / 8;     // LCD_BUFFER_SIZE on the device
+    const char *replay_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (strcmp(argv[i], "--redraws") == 0 && i + 1 < argc) {
+            redraws = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--buffer-lines") == 0 && i + 1 < argc) {
+            buffer_lines = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            sim_set_log_level('I');
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (redraws < 1 || buffer_lines < 1 || buffer_lines > SIM_VER_RES) {
+        usage(argv[0]);
+    }
+
+    lv_init();
+
+    // Two partial buffers, as esp_lvgl_port sets it up on the device
+    static lv_disp_draw_buf_t draw_buf;
+    size_t buf_px = (size_t)SIM_HOR_RES * buffer_lines;
+    lv_color_t *buf1 = (lv_color_t *)malloc(buf_px * sizeof(lv_color_t));
+    lv_color_t *buf2 = (lv_color_t *)malloc(buf_px * sizeof(lv_color_t));
+    if (buf1 == NULL || buf2 == NULL) {
+        ESP_LOGE(TAG, "No memory for the draw buffers");
+        return 1;
+    }
+    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, (uint32_t)buf_px);
+    static lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = SIM_HOR_RES;
+    disp_drv.ver_res = SIM_VER_RES;
+    disp_drv.flush_cb = sim_flush;
+    disp_drv.draw_buf = &draw_buf;
+    lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+
+#if SIM_SDL
+    if (!headless) {
+        headless = !sdl_init();
+    }
+#endif
+
+    // Same order as app_main
+    task_coordinator_init();
+    dashboard_init();
+    ui_perf_init(disp, sim_panel_io());
+    run_for(SIM_SETTLE_MS);
+
+    if (replay_path != NULL) {
+        bool ok = replay(replay_path);
+        sim_set_log_level('I');
+        input_rec_log_stats();
+        ui_perf_log();
+        printf("objects in total: %u (screen, top and system layers)\n", (unsigned)count_all(false));
+#if SIM_SDL
+        if (!headless) {
+            SDL_Quit();
+        }
+#endif
+        return ok ? 0 : 1;
+    }
+
+    static sim_result_t results[UI_PERF_SCREEN_COUNT];
+    tour(results, redraws);
+    printf("%d full redraws per screen, %d-line buffers (%u px)", redraws, buffer_lines, (unsigned)buf_px);
+    report(results);
+
+#if SIM_SDL
+    if (!headless) {
+        printf("Window open - close it to print the counters of the whole session\n");
+        while (!quit) {
+            run_for(100);
+        }
+        sim_set_log_level('I');             // ui_perf_log() logs at info level
+        ui_perf_log();
+        SDL_Quit();
+        return 0;
+    }
+#endif
+    sim_set_log_level('I');
+    ui_perf_log();
+    return 0;
+}
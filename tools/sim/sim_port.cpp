@@ -0,0 +1,530 @@
+// Host implementations of the ESP-IDF / FreeRTOS pieces the UI code uses
+// (headers in tools/sim/port). Single-threaded: the simulator's main loop
+// is the LVGL task, the esp_timer task and every ISR at once. No LVGL here
+// (sim_display.cpp has the panel and LVGL port), so the host tests of
+// aquarium_core link it too (tools/host_test).
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "multi_heap.h"
+#include "esp_rom_crc.h"
+#include "esp_partition.h"
+#include "nvs.h"
+#include "esp_sdcard_port.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#define usable_size(p) malloc_size(p)
+#else
+#include <malloc.h>
+#define usable_size(p) malloc_usable_size(p)
+#endif
+
+// ───────────────────────────────────────────────────────────────────────────
+// Log
+// ───────────────────────────────────────────────────────────────────────────
+
+static char log_level = 'W';            // Shown: this level and more severe
+
+static int severity(char level)
+{
+    switch (level) {
+    case 'E': return 1;
+    case 'W': return 2;
+    case 'I': return 3;
+    case 'D': return 4;
+    default:  return 5;
+    }
+}
+
+extern "C" void sim_set_log_level(char level)
+{
+    log_level = level;
+}
+
+extern "C" void sim_log(char level, const char *tag, const char *fmt, ...)
+{
+    if (severity(level) > severity(log_level)) {
+        return;
+    }
+    printf("%c (%lld) %s: ", level, (long long)(esp_timer_get_time() / 1000), tag);
+    va_list ap;
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    putchar('\n');
+}
+
+extern "C" const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:                      return "ESP_OK";
+    case ESP_FAIL:                    return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:              return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:         return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:       return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:        return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:           return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:       return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:             return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_NVS_NOT_INITIALIZED: return "ESP_ERR_NVS_NOT_INITIALIZED";
+    case ESP_ERR_NVS_NOT_FOUND:       return "ESP_ERR_NVS_NOT_FOUND";
+    default:                          return "ESP_ERR";
+    }
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// esp_timer
+// ───────────────────────────────────────────────────────────────────────────
+
+struct sim_timer {
+    esp_timer_create_args_t args;
+    int64_t due_us;                     // 0 = stopped
+    uint64_t period_us;                 // 0 = one-shot
+};
+
+static std::vector<sim_timer *> timers;
+
+extern "C" int64_t esp_timer_get_time(void)
+{
+    static const auto t0 = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+}
+
+extern "C" esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out)
+{
+    sim_timer *t = new sim_timer();
+    t->args = *args;
+    timers.push_back(t);
+    *out = t;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    if (timer->due_us != 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->due_us = esp_timer_get_time() + (int64_t)timeout_us + 1;
+    timer->period_us = 0;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us)
+{
+    if (timer->due_us != 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->due_us = esp_timer_get_time() + (int64_t)period_us + 1;
+    timer->period_us = period_us;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (timer->due_us == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->due_us = 0;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    for (size_t i = 0; i < timers.size(); i++) {
+        if (timers[i] == timer) {
+            timers.erase(timers.begin() + (long)i);
+            delete timer;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+extern "C" bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+    return timer->due_us != 0;
+}
+
+extern "C" void sim_timers_run(void)
+{
+    int64_t now = esp_timer_get_time();
+    // By index: a callback may create or delete timers
+    for (size_t i = 0; i < timers.size(); i++) {
+        sim_timer *t = timers[i];
+        if (t->due_us == 0 || t->due_us > now) {
+            continue;
+        }
+        t->due_us = t->period_us ? now + (int64_t)t->period_us : 0;
+        t->args.callback(t->args.arg);
+    }
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// Heaps
+// ───────────────────────────────────────────────────────────────────────────
+
+extern "C" void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    return malloc(size);
+}
+
+extern "C" void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    return calloc(n, size);
+}
+
+extern "C" void *heap_caps_realloc(void *p, size_t size, uint32_t caps)
+{
+    return realloc(p, size);
+}
+
+extern "C" void heap_caps_free(void *p)
+{
+    free(p);
+}
+
+extern "C" size_t heap_caps_get_allocated_size(void *p)
+{
+    return p ? usable_size(p) : 0;
+}
+
+extern "C" size_t heap_caps_get_free_size(uint32_t caps)
+{
+    return (caps & MALLOC_CAP_SPIRAM) ? 8 * 1024 * 1024 : 256 * 1024;
+}
+
+extern "C" size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return heap_caps_get_free_size(caps);
+}
+
+struct multi_heap_info {
+    size_t size;
+    size_t used;
+    size_t peak;
+    size_t blocks;
+};
+
+extern "C" multi_heap_handle_t multi_heap_register(void *start, size_t size)
+{
+    multi_heap_info *heap = new multi_heap_info();
+    heap->size = size;
+    return heap;
+}
+
+extern "C" void multi_heap_set_lock(multi_heap_handle_t heap, void *lock)
+{
+}
+
+extern "C" void *multi_heap_malloc(multi_heap_handle_t heap, size_t size)
+{
+    if (heap->used + size > heap->size) {
+        return NULL;                    // Full: the caller spills like on the device
+    }
+    void *p = malloc(size);
+    if (p != NULL) {
+        heap->used += usable_size(p);
+        heap->blocks++;
+        if (heap->used > heap->peak) {
+            heap->peak = heap->used;
+        }
+    }
+    return p;
+}
+
+extern "C" void multi_heap_free(multi_heap_handle_t heap, void *p)
+{
+    if (p == NULL) {
+        return;
+    }
+    heap->used -= usable_size(p);
+    heap->blocks--;
+    free(p);
+}
+
+extern "C" void *multi_heap_realloc(multi_heap_handle_t heap, void *p, size_t size)
+{
+    size_t old = p ? usable_size(p) : 0;
+    if (heap->used - old + size > heap->size) {
+        return NULL;
+    }
+    void *q = realloc(p, size);
+    if (q != NULL) {
+        heap->used = heap->used - old + usable_size(q);
+        heap->blocks += p == NULL;
+        if (heap->used > heap->peak) {
+            heap->peak = heap->used;
+        }
+    }
+    return q;
+}
+
+extern "C" size_t multi_heap_get_allocated_size(multi_heap_handle_t heap, void *p)
+{
+    return usable_size(p);
+}
+
+extern "C" void multi_heap_get_info(multi_heap_handle_t heap, multi_heap_info_t *info)
+{
+    memset(info, 0, sizeof(*info));
+    info->total_allocated_bytes = heap->used;
+    info->total_free_bytes = heap->size - heap->used;
+    info->largest_free_block = info->total_free_bytes;
+    info->minimum_free_bytes = heap->size - heap->peak;
+    info->allocated_blocks = heap->blocks;
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// ROM CRC (reflected polynomials, ~ in and out like the ESP32 ROM)
+// ───────────────────────────────────────────────────────────────────────────
+
+extern "C" uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+extern "C" uint16_t esp_rom_crc16_le(uint16_t crc, const uint8_t *buf, uint32_t len)
+{
+    crc = (uint16_t)~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (uint16_t)((crc >> 1) ^ (0x8408u & (0u - (crc & 1))));
+        }
+    }
+    return (uint16_t)~crc;
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// Flash partitions, NVS and the SD card: none
+// ───────────────────────────────────────────────────────────────────────────
+
+extern "C" const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, int subtype, const char *label)
+{
+    return NULL;
+}
+
+extern "C" esp_err_t esp_partition_read(const esp_partition_t *part, size_t offset, void *dst, size_t size)
+{
+    return ESP_ERR_NOT_FOUND;
+}
+
+extern "C" esp_err_t esp_partition_mmap(const esp_partition_t *part, size_t offset, size_t size,
+                                        esp_partition_mmap_memory_t memory, const void **out_ptr,
+                                        esp_partition_mmap_handle_t *out_handle)
+{
+    return ESP_ERR_NOT_FOUND;
+}
+
+extern "C" void esp_partition_munmap(esp_partition_mmap_handle_t handle)
+{
+}
+
+extern "C" esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *out)
+{
+    return ESP_ERR_NVS_NOT_INITIALIZED;
+}
+
+extern "C" void nvs_close(nvs_handle_t handle)
+{
+}
+
+extern "C" esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    return ESP_ERR_NVS_NOT_INITIALIZED;
+}
+
+extern "C" esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out, size_t *len)
+{
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
+extern "C" esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t len)
+{
+    return ESP_ERR_NVS_NOT_INITIALIZED;
+}
+
+extern "C" esp_err_t nvs_get_str(nvs_handle_t handle, const char *key, char *out, size_t *len)
+{
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
+extern "C" esp_err_t nvs_set_str(nvs_handle_t handle, const char *key, const char *value)
+{
+    return ESP_ERR_NVS_NOT_INITIALIZED;
+}
+
+extern "C" esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
+extern "C" esp_err_t esp_sdcard_port_mount(void)
+{
+    return ESP_ERR_NOT_FOUND;
+}
+
+extern "C" bool esp_sdcard_port_is_mounted(void)
+{
+    return false;
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// FreeRTOS
+// ───────────────────────────────────────────────────────────────────────────
+
+extern "C" TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(esp_timer_get_time() / 1000);
+}
+
+extern "C" void vTaskDelay(TickType_t ticks)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+extern "C" TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    static int main_task;
+    return (TaskHandle_t)&main_task;
+}
+
+extern "C" BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg, UBaseType_t prio,
+                                  TaskHandle_t *handle)
+{
+    return pdFAIL;
+}
+
+extern "C" void vTaskDelete(TaskHandle_t task)
+{
+}
+
+struct sim_queue {
+    size_t item_size;
+    size_t length;
+    size_t head;
+    size_t count;
+    std::vector<uint8_t> items;
+};
+
+extern "C" QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    sim_queue *q = new sim_queue();
+    q->item_size = item_size;
+    q->length = length;
+    q->items.resize((size_t)length * item_size);
+    return q;
+}
+
+extern "C" void vQueueDelete(QueueHandle_t q)
+{
+    delete q;
+}
+
+extern "C" BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t wait)
+{
+    if (q == NULL || q->count == q->length) {
+        return pdFALSE;
+    }
+    size_t tail = (q->head + q->count) % q->length;
+    memcpy(&q->items[tail * q->item_size], item, q->item_size);
+    q->count++;
+    return pdTRUE;
+}
+
+extern "C" BaseType_t xQueueSendToBack(QueueHandle_t q, const void *item, TickType_t wait)
+{
+    return xQueueSend(q, item, wait);
+}
+
+extern "C" BaseType_t xQueueOverwrite(QueueHandle_t q, const void *item)
+{
+    if (q == NULL) {
+        return pdFALSE;
+    }
+    q->head = 0;
+    q->count = 0;
+    return xQueueSend(q, item, 0);
+}
+
+extern "C" BaseType_t xQueuePeek(QueueHandle_t q, void *out, TickType_t wait)
+{
+    if (q == NULL || q->count == 0) {
+        return pdFALSE;
+    }
+    memcpy(out, &q->items[q->head * q->item_size], q->item_size);
+    return pdTRUE;
+}
+
+extern "C" BaseType_t xQueueReceive(QueueHandle_t q, void *out, TickType_t wait)
+{
+    if (xQueuePeek(q, out, 0) != pdTRUE) {
+        return pdFALSE;                 // Nobody else runs: waiting would not help
+    }
+    q->head = (q->head + 1) % q->length;
+    q->count--;
+    return pdTRUE;
+}
+
+extern "C" BaseType_t xQueueReset(QueueHandle_t q)
+{
+    if (q != NULL) {
+        q->head = 0;
+        q->count = 0;
+    }
+    return pdPASS;
+}
+
+extern "C" UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q)
+{
+    return q ? (UBaseType_t)q->count : 0;
+}
+
+struct sim_semaphore {
+    int unused;
+};
+
+extern "C" SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return new sim_semaphore();
+}
+
+extern "C" SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return new sim_semaphore();
+}
+
+extern "C" void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    delete sem;
+}
+
+extern "C" BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait)
+{
+    return pdTRUE;
+}
+
+extern "C" BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    return pdTRUE;
+}
@@ -0,0 +1,294 @@
+// Inert stand-ins for the firmware modules the dashboard calls that need the
+// device: workers and their queues, the SD logger, WiFi, the frame storage
+// pipeline and the direct panel blit. The simulator profiles the widgets,
+// so the animation area stays empty and nothing is saved.
+
+#include "task_coordinator.h"
+#include "msg_bus.h"
+#include "queue_watch.h"
+#include "sd_logger.h"
+#include "gemini_api.h"
+#include "boot_trace.h"
+#include "messages.h"
+#include "codec/frame_codec.h"
+#include "anim/frame_pool.h"
+#include "anim/frame_map.h"
+#include "anim/frame_overlay.h"
+#include "anim/frame_backend.h"
+#include "anim/frame_bench.h"
+#include "anim/panel_blit.h"
+#include "tileview/diag_tile.h"
+#include "esp_log.h"
+
+static const char *TAG = "sim";
+
+// ───────────────────────────────────────────────────────────────────────────
+// Task coordinator: the queues exist, no worker reads them
+// ───────────────────────────────────────────────────────────────────────────
+
+QueueHandle_t queue_param_update = NULL;
+QueueHandle_t queue_anim_frame_request = NULL;
+QueueHandle_t queue_anim_frame_ready = NULL;
+QueueHandle_t queue_anim_frame_free = NULL;
+QueueHandle_t queue_anim_prefetch = NULL;
+QueueHandle_t queue_ai_request = NULL;
+
+extern "C" void task_coordinator_init(void)
+{
+    // Depths as on the device; what the UI sends just stays queued
+    queue_param_update = xQueueCreate(1, sizeof(tank_params_msg_t));
+    queue_anim_frame_request = xQueueCreate(FRAME_POOL_SLOTS, sizeof(anim_frame_request_msg_t));
+    queue_anim_frame_ready = xQueueCreate(FRAME_POOL_SLOTS, sizeof(anim_frame_ready_msg_t));
+    queue_anim_frame_free = xQueueCreate(FRAME_POOL_SLOTS, sizeof(uint8_t));
+    queue_anim_prefetch = xQueueCreate(2, sizeof(anim_frame_request_msg_t));
+    queue_ai_request = xQueueCreate(1, sizeof(ai_request_msg_t));
+}
+
+extern "C" esp_err_t task_coordinator_start(task_id_t id)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+extern "C" esp_err_t task_coordinator_stop(task_id_t id, uint32_t timeout_ms)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// Message bus: subscriptions never receive anything
+// ───────────────────────────────────────────────────────────────────────────
+
+struct msg_bus_sub {
+    const char *name;
+    msg_topic_t topic;
+};
+
+extern "C" msg_bus_sub_t *msg_bus_subscribe(const char *name, msg_topic_t topic, uint8_t depth, uint8_t flags,
+                                            msg_bus_notify_t notify, void *arg)
+{
+    msg_bus_sub_t *sub = new msg_bus_sub();
+    sub->name = name;
+    sub->topic = topic;
+    return sub;
+}
+
+extern "C" esp_err_t msg_bus_publish(msg_topic_t topic, const void *data, size_t len)
+{
+    return ESP_OK;
+}
+
+extern "C" const msg_bus_msg_t *msg_bus_receive(msg_bus_sub_t *sub, TickType_t wait)
+{
+    return NULL;
+}
+
+extern "C" void msg_bus_release(const msg_bus_msg_t *msg)
+{
+}
+
+extern "C" void msg_bus_log_stats(void)
+{
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// Queue watch: plain sends onto the queues above, never under pressure
+// ───────────────────────────────────────────────────────────────────────────
+
+static QueueHandle_t watched_queue(queue_watch_id_t id)
+{
+    switch (id) {
+    case QUEUE_WATCH_PARAM:       return queue_param_update;
+    case QUEUE_WATCH_FRAME_REQ:   return queue_anim_frame_request;
+    case QUEUE_WATCH_FRAME_READY: return queue_anim_frame_ready;
+    case QUEUE_WATCH_PREFETCH:    return queue_anim_prefetch;
+    case QUEUE_WATCH_AI_REQ:      return queue_ai_request;
+    default:                      return NULL;
+    }
+}
+
+extern "C" BaseType_t queue_watch_send(queue_watch_id_t id, const void *item)
+{
+    return xQueueSend(watched_queue(id), item, 0);
+}
+
+extern "C" BaseType_t queue_watch_overwrite(queue_watch_id_t id, const void *item)
+{
+    return xQueueOverwrite(watched_queue(id), item);
+}
+
+extern "C" BaseType_t queue_watch_reclaim(queue_watch_id_t id, void *item)
+{
+    return xQueueReceive(watched_queue(id), item, 0);
+}
+
+extern "C" uint8_t queue_watch_pressure(queue_watch_id_t id)
+{
+    return 0;
+}
+
+extern "C" void queue_watch_log_stats(void)
+{
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// SD logger, WiFi, boot trace
+// ───────────────────────────────────────────────────────────────────────────
+
+extern "C" void sd_logger_init(const char *dir)
+{
+}
+
+extern "C" bool sd_logger_log(sd_log_type_t type, time_t when, uint8_t flags, const float *values, size_t count)
+{
+    return false;
+}
+
+extern "C" bool gemini_is_wifi_connected(void)
+{
+    return false;
+}
+
+extern "C" void boot_trace_dump(void)
+{
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// Animation frames: no storage, no panel
+// ───────────────────────────────────────────────────────────────────────────
+
+static const frame_backend_t no_frames = {"sim", NULL, NULL, NULL};
+
+extern "C" const frame_backend_t *frame_backend_active(void)
+{
+    return &no_frames;
+}
+
+extern "C" bool frame_map_init(uint16_t width, uint16_t height, uint8_t frame_count)
+{
+    return false;
+}
+
+extern "C" bool frame_map_available(void)
+{
+    return false;
+}
+
+extern "C" const uint8_t *frame_map_get(uint8_t frame_index)
+{
+    return NULL;
+}
+
+extern "C" esp_err_t frame_codec_load(FILE *f, uint8_t *dst, size_t dst_size, uint16_t width, uint16_t height,
+                                      bool swap, frame_codec_info_t *info)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+extern "C" esp_err_t frame_codec_load_rows(FILE *f, uint8_t *dst, size_t dst_size, uint16_t width,
+                                           uint16_t height, bool swap, uint16_t *row_from, uint16_t *row_to,
+                                           frame_codec_info_t *info)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+extern "C" esp_err_t frame_codec_apply_delta(FILE *f, uint8_t *dst, size_t dst_size, uint16_t width,
+                                             uint16_t height, frame_dirty_t *dirty)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+extern "C" bool frame_codec_peek(FILE *f, frame_container_header_t *hdr)
+{
+    return false;
+}
+
+extern "C" void frame_codec_swap_rgb565(uint8_t *buf, size_t len)
+{
+    for (size_t i = 0; i + 1 < len; i += 2) {
+        uint8_t t = buf[i];
+        buf[i] = buf[i + 1];
+        buf[i + 1] = t;
+    }
+}
+
+extern "C" bool frame_bench_storage_done(void)
+{
+    return true;
+}
+
+extern "C" void frame_bench_add(frame_bench_series_t *s, int64_t us)
+{
+}
+
+extern "C" void frame_bench_report(const char *backend, const char *format, const char *stage,
+                                   frame_bench_series_t *s)
+{
+}
+
+extern "C" void panel_blit_init(esp_lcd_panel_handle_t panel, esp_lcd_panel_io_handle_t io)
+{
+}
+
+extern "C" bool panel_blit_available(void)
+{
+    return false;
+}
+
+extern "C" bool panel_blit_begin(void)
+{
+    return false;
+}
+
+extern "C" void panel_blit_sync_next_flush(void)
+{
+}
+
+extern "C" bool panel_blit_rows(const uint8_t *frame, int width, int y0, int y1)
+{
+    return false;
+}
+
+extern "C" void panel_blit_end(void)
+{
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// Frame overlay: no storage_task to bake it, the date stays a label
+// ───────────────────────────────────────────────────────────────────────────
+
+extern "C" bool frame_overlay_init(uint16_t frame_width, uint16_t frame_height)
+{
+    return false;
+}
+
+extern "C" bool frame_overlay_active(void)
+{
+    return false;
+}
+
+extern "C" void frame_overlay_set_text(const char *text, const lv_font_t *font, lv_coord_t letter_space,
+                                       lv_coord_t x, lv_coord_t y, lv_color_t color, lv_color_t shadow)
+{
+}
+
+// ───────────────────────────────────────────────────────────────────────────
+// Diagnostics tiles: they read the workers and the I2C bus
+// ───────────────────────────────────────────────────────────────────────────
+
+extern "C" void diag_tile_init(lv_obj_t *parent)
+{
+    lv_obj_t *label = lv_label_create(parent);
+    lv_label_set_text(label, "Diagnostics: device only");
+    lv_obj_center(label);
+    ESP_LOGD(TAG, "diag_tile_init stubbed");
+}
+
+extern "C" void diag_latency_tile_init(lv_obj_t *parent)
+{
+    diag_tile_init(parent);
+}
+
+extern "C" void diag_net_tile_init(lv_obj_t *parent)
+{
+    diag_tile_init(parent);
+}
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""
+Generate subset Montserrat fonts for CONFIG_GOLDIE_UI_SUBSET_FONTS.
+
+Scans the firmware sources for the LV_SYMBOL_* glyphs they actually use and
+runs lv_font_conv (npm i -g lv_font_conv) once per dashboard size, writing
+components/lvgl_ui/fonts/goldie_montserrat_<size>.c. Printable ASCII is
+always kept: AI replies and sensor text are arbitrary strings.
+
+Output is uncompressed 4 bpp so the PSRAM glyph cache (ui/ui_fonts.cpp) can
+copy bitmaps straight out of flash.
+
+Usage:
+    python subset_fonts.py --text-font Montserrat-Medium.ttf \\
+        --symbol-font FontAwesome5-Solid+Brands+Regular.woff [--dry-run]
+
+Both font files ship with LVGL under scripts/built_in_font/.
+"""
+
+import argparse
+import re
+import shutil
+import subprocess
+import sys
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+SCAN_DIRS = [ROOT / 'main', ROOT / 'components']
+OUT_DIR = ROOT / 'components' / 'lvgl_ui' / 'fonts'
+SIZES = [12, 14, 16, 20, 32]        # Must match ui_font_id_t
+ASCII_RANGE = '0x20-0x7E'
+
+# LVGL 8 lv_symbol_def.h code points
+SYMBOLS = {
+    'AUDIO': 0xF001, 'VIDEO': 0xF008, 'LIST': 0xF00B, 'OK': 0xF00C,
+    'CLOSE': 0xF00D, 'POWER': 0xF011, 'SETTINGS': 0xF013, 'HOME': 0xF015,
+    'DOWNLOAD': 0xF019, 'DRIVE': 0xF01C, 'REFRESH': 0xF021, 'MUTE': 0xF026,
+    'VOLUME_MID': 0xF027, 'VOLUME_MAX': 0xF028, 'IMAGE': 0xF03E,
+    'TINT': 0xF043, 'PREV': 0xF048, 'PLAY': 0xF04B, 'PAUSE': 0xF04C,
+    'STOP': 0xF04D, 'NEXT': 0xF051, 'EJECT': 0xF052, 'LEFT': 0xF053,
+    'RIGHT': 0xF054, 'PLUS': 0xF067, 'MINUS': 0xF068, 'EYE_OPEN': 0xF06E,
+    'EYE_CLOSE': 0xF070, 'WARNING': 0xF071, 'SHUFFLE': 0xF074, 'UP': 0xF077,
+    'DOWN': 0xF078, 'LOOP': 0xF079, 'DIRECTORY': 0xF07B, 'UPLOAD': 0xF093,
+    'CALL': 0xF095, 'CUT': 0xF0C4, 'COPY': 0xF0C5, 'SAVE': 0xF0C7,
+    'BARS': 0xF0C9, 'ENVELOPE': 0xF0E0, 'CHARGE': 0xF0E7, 'PASTE': 0xF0EA,
+    'BELL': 0xF0F3, 'KEYBOARD': 0xF11C, 'GPS': 0xF124, 'FILE': 0xF158,
+    'WIFI': 0xF1EB, 'BATTERY_FULL': 0xF240, 'BATTERY_3': 0xF241,
+    'BATTERY_2': 0xF242, 'BATTERY_1': 0xF243, 'BATTERY_EMPTY': 0xF244,
+    'USB': 0xF287, 'BLUETOOTH': 0xF293, 'TRASH': 0xF2ED, 'EDIT': 0xF304,
+    'BACKSPACE': 0xF55A, 'SD_CARD': 0xF7C2, 'NEW_LINE': 0xF8A2,
+}
+
+def used_symbols():
+    names = set()
+    for d in SCAN_DIRS:
+        for path in d.rglob('*'):
+            if path.suffix not in ('.c', '.cpp', '.h') or OUT_DIR in path.parents:
+                continue
+            names.update(re.findall(r'LV_SYMBOL_([A-Z0-9_]+)', path.read_text(errors='ignore')))
+    unknown = sorted(n for n in names if n not in SYMBOLS)
+    for n in unknown:
+        print(f"warning: LV_SYMBOL_{n} not in table, skipped", file=sys.stderr)
+    return sorted(SYMBOLS[n] for n in names if n in SYMBOLS)
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    ap.add_argument('--text-font', required=True, help='Montserrat TTF')
+    ap.add_argument('--symbol-font', required=True, help='FontAwesome WOFF used by LVGL symbols')
+    ap.add_argument('--bpp', type=int, default=4)
+    ap.add_argument('--dry-run', action='store_true', help='print the commands only')
+    args = ap.parse_args()
+
+    symbols = used_symbols()
+    symbol_range = ','.join(f'0x{c:X}' for c in symbols)
+    print(f"{len(symbols)} symbols: {symbol_range or '(none)'}")
+
+    conv = shutil.which('lv_font_conv')
+    if conv is None and not args.dry_run:
+        print("lv_font_conv not found (npm i -g lv_font_conv)", file=sys.stderr)
+        return 1
+
+    if not args.dry_run:
+        OUT_DIR.mkdir(parents=True, exist_ok=True)
+    for size in SIZES:
+        out = OUT_DIR / f'goldie_montserrat_{size}.c'
+        cmd = [conv or 'lv_font_conv', '--no-compress', '--no-prefilter',
+               '--bpp', str(args.bpp), '--size', str(size), '--format', 'lvgl',
+               '--lv-include', 'lvgl.h', '--font', args.text_font, '-r', ASCII_RANGE]
+        if symbols:
+            cmd += ['--font', args.symbol_font, '-r', symbol_range]
+        cmd += ['-o', str(out)]
+        print(' '.join(cmd))
+        if not args.dry_run:
+            subprocess.run(cmd, check=True)
+            # lv_font_conv names the font after the output file
+            print(f"  -> {out.relative_to(ROOT)} ({out.stat().st_size // 1024} KB source)")
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())